@@ -0,0 +1,423 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Micro-benchmarks of the main processing functions of aubio.
+
+   Each function is called repeatedly, doubling the number of calls until
+   the measured time exceeds the minimum duration, for each buffer size. The
+   results are written as a JSON document, so that runs of different builds
+   or releases can be compared.
+
+   usage: aubio-bench [-o output.json] [-t min_seconds] [-f filter]
+                      [-s size] [source_path]
+
+   -o  write the results to this file instead of stdout
+   -t  minimum duration of each measurement, in seconds (default: 0.2)
+   -f  only run the benchmarks whose name contains this string
+   -s  only run this buffer size (default: 256 to 4096)
+
+   The source benchmarks run only when a source_path is given.
+*/
+
+#define AUBIO_UNSTABLE 1
+#include <aubio.h>
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef HAVE_WIN_HACKS
+#include <windows.h>
+#endif
+
+// the version is passed without quotes, since msvc strips them from -D flags
+#define REDEFINESTRING(x) #x
+#define DEFINEDSTRING(x) REDEFINESTRING(x)
+#ifdef AUBIO_BENCH_VERSION
+#define AUBIO_BENCH_VERSION_STRING DEFINEDSTRING(AUBIO_BENCH_VERSION)
+#else
+#define AUBIO_BENCH_VERSION_STRING "unknown"
+#endif
+
+/** maximum number of calls of a single measurement */
+#define BENCH_MAX_CALLS (1 << 24)
+
+typedef struct {
+  FILE *out;              /**< where the results are written */
+  double min_time;        /**< minimum duration of a measurement */
+  const char *filter;     /**< substring of the benchmarks to run, or NULL */
+  uint_t n_results;       /**< number of results written so far */
+  uint_t samplerate;      /**< samplerate of the analysis objects */
+} bench_t;
+
+/* monotonic time in seconds */
+static double bench_now (void)
+{
+#if defined(HAVE_WIN_HACKS)
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency (&freq);
+  QueryPerformanceCounter (&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1.e-9;
+#else
+  return (double)clock () / CLOCKS_PER_SEC;
+#endif
+}
+
+static int bench_enabled (const bench_t *b, const char *name)
+{
+  return b->filter == NULL || strstr (name, b->filter) != NULL;
+}
+
+static void bench_report (bench_t *b, const char *name, const char *method,
+    uint_t win_s, uint_t hop_s, uint_t n_calls, double elapsed)
+{
+  double per_call = elapsed / n_calls;
+  fprintf (b->out, "%s\n    {\"name\": \"%s\", \"method\": \"%s\", "
+      "\"win_s\": %d, \"hop_s\": %d, \"calls\": %d, "
+      "\"ns_per_call\": %.1f, \"samples_per_second\": %.0f}",
+      b->n_results ? "," : "", name, method, win_s, hop_s, n_calls,
+      per_call * 1.e9, hop_s / per_call);
+  b->n_results++;
+}
+
+/* time STMT, doubling the number of calls until min_time is reached */
+#define BENCH_TIME(b, name, method, win_s, hop_s, STMT) { \
+  uint_t i_, n_ = 1; \
+  double t0_, t_; \
+  for (;;) { \
+    t0_ = bench_now (); \
+    for (i_ = 0; i_ < n_; i_++) { \
+      STMT; \
+    } \
+    t_ = bench_now () - t0_; \
+    if (t_ >= (b)->min_time || n_ >= BENCH_MAX_CALLS) break; \
+    n_ *= 2; \
+  } \
+  bench_report (b, name, method, win_s, hop_s, n_, t_); \
+}
+
+/* fill f with a reproducible mix of a sine wave and noise */
+static void bench_fill (fvec_t *f)
+{
+  uint_t i;
+  for (i = 0; i < f->length; i++) {
+    f->data[i] = .5 * sin (2. * 3.14159265358979 * 441. * i / 44100.)
+      + .1 * (2. * rand () / (double)RAND_MAX - 1.);
+  }
+}
+
+static void bench_fft (bench_t *b, uint_t win_s)
+{
+  aubio_fft_t *fft;
+  fvec_t *in, *out;
+  cvec_t *spec;
+  if (!bench_enabled (b, "fft")) return;
+  fft = new_aubio_fft (win_s);
+  if (!fft) return;
+  in = new_fvec (win_s);
+  out = new_fvec (win_s);
+  spec = new_cvec (win_s);
+  bench_fill (in);
+  BENCH_TIME (b, "fft", "do", win_s, win_s, aubio_fft_do (fft, in, spec));
+  BENCH_TIME (b, "fft", "rdo", win_s, win_s, aubio_fft_rdo (fft, spec, out));
+  del_aubio_fft (fft);
+  del_fvec (in);
+  del_fvec (out);
+  del_cvec (spec);
+}
+
+static void bench_pvoc (bench_t *b, uint_t win_s, uint_t hop_s)
+{
+  aubio_pvoc_t *pv;
+  fvec_t *in, *out;
+  cvec_t *spec;
+  if (!bench_enabled (b, "pvoc")) return;
+  pv = new_aubio_pvoc (win_s, hop_s);
+  if (!pv) return;
+  in = new_fvec (hop_s);
+  out = new_fvec (hop_s);
+  spec = new_cvec (win_s);
+  bench_fill (in);
+  BENCH_TIME (b, "pvoc", "do", win_s, hop_s, aubio_pvoc_do (pv, in, spec));
+  BENCH_TIME (b, "pvoc", "rdo", win_s, hop_s, aubio_pvoc_rdo (pv, spec, out));
+  del_aubio_pvoc (pv);
+  del_fvec (in);
+  del_fvec (out);
+  del_cvec (spec);
+}
+
+static void bench_specdesc (bench_t *b, uint_t win_s, uint_t hop_s)
+{
+  const char_t *methods[] = { "energy", "hfc", "complex", "phase", "wphase",
+    "specdiff", "kl", "mkl", "specflux", "centroid", "spread", "skewness",
+    "kurtosis", "slope", "decrease", "rolloff" };
+  uint_t i;
+  aubio_pvoc_t *pv;
+  fvec_t *in, *desc;
+  cvec_t *spec;
+  if (!bench_enabled (b, "specdesc")) return;
+  pv = new_aubio_pvoc (win_s, hop_s);
+  if (!pv) return;
+  in = new_fvec (hop_s);
+  desc = new_fvec (1);
+  spec = new_cvec (win_s);
+  bench_fill (in);
+  aubio_pvoc_do (pv, in, spec);
+  for (i = 0; i < sizeof (methods) / sizeof (methods[0]); i++) {
+    aubio_specdesc_t *sd = new_aubio_specdesc (methods[i], win_s);
+    if (!sd) continue;
+    BENCH_TIME (b, "specdesc", methods[i], win_s, hop_s,
+        aubio_specdesc_do (sd, spec, desc));
+    del_aubio_specdesc (sd);
+  }
+  del_aubio_pvoc (pv);
+  del_fvec (in);
+  del_fvec (desc);
+  del_cvec (spec);
+}
+
+static void bench_pitch (bench_t *b, uint_t win_s, uint_t hop_s)
+{
+  const char_t *methods[] = { "yin", "yinfast", "yinfft", "mcomb", "fcomb",
+    "schmitt", "specacf" };
+  uint_t i;
+  fvec_t *in, *out;
+  if (!bench_enabled (b, "pitch")) return;
+  in = new_fvec (hop_s);
+  out = new_fvec (1);
+  bench_fill (in);
+  for (i = 0; i < sizeof (methods) / sizeof (methods[0]); i++) {
+    aubio_pitch_t *p = new_aubio_pitch (methods[i], win_s, hop_s,
+        b->samplerate);
+    if (!p) continue;
+    BENCH_TIME (b, "pitch", methods[i], win_s, hop_s,
+        aubio_pitch_do (p, in, out));
+    del_aubio_pitch (p);
+  }
+  del_fvec (in);
+  del_fvec (out);
+}
+
+static void bench_onset (bench_t *b, uint_t win_s, uint_t hop_s)
+{
+  aubio_onset_t *o;
+  fvec_t *in, *out;
+  if (!bench_enabled (b, "onset")) return;
+  o = new_aubio_onset ("default", win_s, hop_s, b->samplerate);
+  if (!o) return;
+  in = new_fvec (hop_s);
+  out = new_fvec (1);
+  bench_fill (in);
+  BENCH_TIME (b, "onset", "default", win_s, hop_s,
+      aubio_onset_do (o, in, out));
+  del_aubio_onset (o);
+  del_fvec (in);
+  del_fvec (out);
+}
+
+static void bench_tempo (bench_t *b, uint_t win_s, uint_t hop_s)
+{
+  aubio_tempo_t *t;
+  fvec_t *in, *out;
+  if (!bench_enabled (b, "tempo")) return;
+  t = new_aubio_tempo ("default", win_s, hop_s, b->samplerate);
+  if (!t) return;
+  in = new_fvec (hop_s);
+  out = new_fvec (2);
+  bench_fill (in);
+  BENCH_TIME (b, "tempo", "default", win_s, hop_s,
+      aubio_tempo_do (t, in, out));
+  del_aubio_tempo (t);
+  del_fvec (in);
+  del_fvec (out);
+}
+
+static void bench_mfcc (bench_t *b, uint_t win_s, uint_t hop_s)
+{
+  aubio_pvoc_t *pv;
+  aubio_mfcc_t *mf;
+  fvec_t *in, *coeffs;
+  cvec_t *spec;
+  if (!bench_enabled (b, "mfcc")) return;
+  pv = new_aubio_pvoc (win_s, hop_s);
+  mf = new_aubio_mfcc (win_s, 40, 13, b->samplerate);
+  if (!pv || !mf) goto beach;
+  in = new_fvec (hop_s);
+  coeffs = new_fvec (13);
+  spec = new_cvec (win_s);
+  bench_fill (in);
+  aubio_pvoc_do (pv, in, spec);
+  BENCH_TIME (b, "mfcc", "default", win_s, hop_s,
+      aubio_mfcc_do (mf, spec, coeffs));
+  del_fvec (in);
+  del_fvec (coeffs);
+  del_cvec (spec);
+beach:
+  if (pv) del_aubio_pvoc (pv);
+  if (mf) del_aubio_mfcc (mf);
+}
+
+static void bench_filter (bench_t *b, uint_t hop_s)
+{
+  aubio_filter_t *filters[3];
+  const char_t *methods[] = { "a_weighting", "c_weighting", "biquad" };
+  uint_t i;
+  fvec_t *signal, *in;
+  if (!bench_enabled (b, "filter")) return;
+  filters[0] = new_aubio_filter_a_weighting (b->samplerate);
+  filters[1] = new_aubio_filter_c_weighting (b->samplerate);
+  filters[2] = new_aubio_filter_biquad (0.2, 0.4, 0.2, -0.5, 0.3);
+  signal = new_fvec (hop_s);
+  in = new_fvec (hop_s);
+  bench_fill (signal);
+  for (i = 0; i < 3; i++) {
+    if (!filters[i]) continue;
+    // filter a copy of the input, so that the signal does not vanish
+    BENCH_TIME (b, "filter", methods[i], hop_s, hop_s,
+        fvec_copy (signal, in); aubio_filter_do (filters[i], in));
+    del_aubio_filter (filters[i]);
+  }
+  del_fvec (signal);
+  del_fvec (in);
+}
+
+/* read hop_s frames, rewinding at the end of the file */
+#define BENCH_SOURCE(b, method, hop_s, path, prefix) { \
+  aubio_##prefix##_t *src = new_aubio_##prefix (path, 0, hop_s); \
+  if (src) { \
+    fvec_t *buf = new_fvec (hop_s); \
+    uint_t read = 0; \
+    BENCH_TIME (b, "source", method, hop_s, hop_s, \
+        aubio_##prefix##_do (src, buf, &read); \
+        if (read < hop_s) aubio_##prefix##_seek (src, 0)); \
+    del_fvec (buf); \
+    del_aubio_##prefix (src); \
+  } \
+}
+
+static void bench_source (bench_t *b, uint_t hop_s, const char_t *path)
+{
+  if (!path || !bench_enabled (b, "source")) return;
+  BENCH_SOURCE (b, "default", hop_s, path, source);
+#ifdef HAVE_WAVREAD
+  BENCH_SOURCE (b, "wavread", hop_s, path, source_wavread);
+#endif
+#ifdef HAVE_SNDFILE
+  BENCH_SOURCE (b, "sndfile", hop_s, path, source_sndfile);
+#endif
+#ifdef HAVE_LIBAV
+  BENCH_SOURCE (b, "avcodec", hop_s, path, source_avcodec);
+#endif
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+  BENCH_SOURCE (b, "apple_audio", hop_s, path, source_apple_audio);
+#endif
+}
+
+static const char *bench_fft_backend (void)
+{
+#if defined(HAVE_FFTW3F)
+  return "fftw3f";
+#elif defined(HAVE_FFTW3)
+  return "fftw3";
+#elif defined(HAVE_ACCELERATE)
+  return "accelerate";
+#elif defined(HAVE_INTEL_IPP)
+  return "intelipp";
+#elif defined(HAVE_AUBIO_RFFT)
+  return "rfft";
+#else
+  return "ooura";
+#endif
+}
+
+static int usage (const char *progname)
+{
+  fprintf (stderr, "usage: %s [-o output.json] [-t min_seconds] [-f filter]"
+      " [-s size] [source_path]\n", progname);
+  return 1;
+}
+
+int main (int argc, char **argv)
+{
+  bench_t b;
+  const char_t *source_path = NULL, *output_path = NULL;
+  uint_t win_s, min_size = 256, max_size = 4096;
+  int i;
+
+  b.out = stdout;
+  b.min_time = 0.2;
+  b.filter = NULL;
+  b.n_results = 0;
+  b.samplerate = 44100;
+
+  for (i = 1; i < argc; i++) {
+    if (argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0') {
+      if (i + 1 >= argc) return usage (argv[0]);
+      switch (argv[i][1]) {
+        case 'o': output_path = argv[++i]; break;
+        case 't': b.min_time = atof (argv[++i]); break;
+        case 'f': b.filter = argv[++i]; break;
+        case 's': min_size = max_size = atoi (argv[++i]); break;
+        default: return usage (argv[0]);
+      }
+    } else if (!source_path) {
+      source_path = argv[i];
+    } else {
+      return usage (argv[0]);
+    }
+  }
+  if (output_path) {
+    b.out = fopen (output_path, "w");
+    if (!b.out) {
+      fprintf (stderr, "aubio-bench: could not open %s\n", output_path);
+      return 1;
+    }
+  }
+
+  srand (1);
+  fprintf (b.out, "{\n  \"aubio\": \"%s\",\n  \"precision\": \"%s\",\n"
+      "  \"fft\": \"%s\",\n  \"min_time\": %g,\n  \"results\": [",
+      AUBIO_BENCH_VERSION_STRING, sizeof (smpl_t) == 4 ? "single" : "double",
+      bench_fft_backend (), b.min_time);
+  for (win_s = min_size; win_s >= 2 && win_s <= max_size; win_s *= 2) {
+    uint_t hop_s = win_s / 2;
+    bench_fft (&b, win_s);
+    bench_pvoc (&b, win_s, hop_s);
+    bench_specdesc (&b, win_s, hop_s);
+    bench_pitch (&b, win_s, hop_s);
+    bench_onset (&b, win_s, hop_s);
+    bench_tempo (&b, win_s, hop_s);
+    bench_mfcc (&b, win_s, hop_s);
+    bench_filter (&b, hop_s);
+    bench_source (&b, hop_s, source_path);
+  }
+  fprintf (b.out, "\n  ]\n}\n");
+
+  if (output_path) fclose (b.out);
+  aubio_cleanup ();
+  return 0;
+}
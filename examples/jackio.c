@@ -75,6 +75,10 @@ struct _aubio_jack_t
   fvec_t *obuf;
   uint_t hop_size;
   int pos;
+  /** hops of latency given to the analysis thread, 0 to run in jack's */
+  uint_t latency;
+  /** analysis thread, NULL to call `callback` in the process callback */
+  aubio_rthost_t *host;
 };
 
 /* static memory management */
@@ -160,6 +164,7 @@ new_aubio_jack (uint_t hop_size, uint_t ichan, uint_t ochan,
   jack_setup->ibuf = new_fvec(hop_size);
   jack_setup->obuf = new_fvec(hop_size);
   jack_setup->pos = 0;
+  jack_setup->latency = 1;
   return jack_setup;
 
 beach:
@@ -173,11 +178,37 @@ aubio_jack_get_samplerate (aubio_jack_t * jack_setup) {
   return jack_setup->samplerate;
 }
 
+uint_t
+aubio_jack_set_latency (aubio_jack_t * jack_setup, uint_t latency)
+{
+  if (jack_setup->host) {
+    AUBIO_ERR ("jack latency can not be changed once activated\n");
+    return 1;
+  }
+  jack_setup->latency = latency;
+  return 0;
+}
+
+static void
+aubio_jack_analyse (void *data, fvec_t * input, fvec_t * output)
+{
+  aubio_jack_t *dev = (aubio_jack_t *) data;
+  dev->callback (input, output);
+}
+
 uint_t
 aubio_jack_activate (aubio_jack_t * jack_setup, aubio_process_func_t callback)
 {
   /* set processing callback */
   jack_setup->callback = callback;
+  /* run it on its own thread, so that slow analysis do not cause xruns */
+  if (jack_setup->latency) {
+    jack_setup->host = new_aubio_rthost (jack_setup->hop_size,
+        jack_setup->latency, aubio_jack_analyse, jack_setup);
+    if (!jack_setup->host) {
+      AUBIO_WRN ("failed creating analysis thread, analysing in jack's\n");
+    }
+  }
   /* actual jack process activation */
   if (jack_activate (jack_setup->client)) {
     AUBIO_ERR ("jack client activation failed");
@@ -191,6 +222,16 @@ aubio_jack_close (aubio_jack_t * jack_setup)
 {
   /* bug : should disconnect all ports first */
   jack_client_close (jack_setup->client);
+  if (jack_setup->host) {
+    if (aubio_rthost_get_dropped (jack_setup->host)
+        || aubio_rthost_get_late (jack_setup->host)) {
+      AUBIO_WRN ("analysis missed its deadline: %d hops dropped,"
+          " %d hops late\n", aubio_rthost_get_dropped (jack_setup->host),
+          aubio_rthost_get_late (jack_setup->host));
+    }
+    del_aubio_rthost (jack_setup->host);
+    jack_setup->host = NULL;
+  }
 }
 
 /* memory management */
@@ -228,6 +269,9 @@ del_aubio_jack (aubio_jack_t * jack_setup)
   if (jack_setup->omidichan && jack_setup->midi_out_ring) {
     jack_ringbuffer_free (jack_setup->midi_out_ring);
   }
+  if (jack_setup->host) {
+    del_aubio_rthost (jack_setup->host);
+  }
   del_fvec (jack_setup->ibuf);
   del_fvec (jack_setup->obuf);
   AUBIO_FREE (jack_setup->oports);
@@ -250,6 +294,12 @@ static void process_midi_output (aubio_jack_t * dev, jack_nframes_t nframes);
 static int block_process(aubio_jack_t *dev,
     smpl_t **input, smpl_t **output, int nframes) {
   unsigned int j;       /*frames*/
+  if (dev->host) {
+    fvec_t in = { (uint_t)nframes, input[0] };
+    fvec_t out = { (uint_t)nframes, output[0] };
+    aubio_rthost_do (dev->host, &in, &out);
+    return 1;
+  }
   for (j=0;j<(unsigned)nframes;j++) {
     /* put synthnew in output */
     output[0][j] = fvec_get_sample(dev->obuf, dev->pos);
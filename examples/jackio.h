@@ -44,6 +44,17 @@ typedef struct _aubio_jack_t aubio_jack_t;
 aubio_jack_t *new_aubio_jack (uint_t hop_size,
     uint_t inchannels, uint_t outchannels,
     uint_t imidichan, uint_t omidichan);
+/** set number of hops of latency given to the analysis
+
+  By default, the processing function runs on its own thread, and has one
+  hop to process each hop before its output is due. Slow hops are counted
+  and reported by ::aubio_jack_close instead of causing xruns. With a
+  latency of 0, the processing function runs in the jack process callback.
+
+  This function should be called before ::aubio_jack_activate.
+
+*/
+uint_t aubio_jack_set_latency (aubio_jack_t * jack_setup, uint_t latency);
 /** activate jack client (run jackprocess function) */
 uint_t aubio_jack_activate (aubio_jack_t * jack_setup,
     aubio_process_func_t callback);
@@ -26,6 +26,7 @@
 
 extern int verbose;
 extern int quiet;
+extern int bench;
 // input / output
 extern int usejack;
 extern char_t *source_uri;
@@ -90,8 +91,8 @@ void usage (FILE * stream, int exit_code)
       "                 number of frames to read from source before each analysis\n"
 #ifdef PROG_HAS_ONSET
       "       -O      --onset            select onset detection algorithm\n"
-      "                 <default|energy|hfc|complex|phase|specdiff|kl|mkl|specflux>;\n"
-      "                 default=hfc\n"
+      "                 <default|energy|hfc|complex|phase|specdiff|kl|mkl|specflux|\n"
+      "                 superflux>; default=hfc\n"
       "       -t      --onset-threshold  set onset detection threshold\n"
       "                 a value between 0.1 (more detections) and 1 (less); default=0.3\n"
       "       -M      --minioi           set minimum inter-onset interval\n"
@@ -128,6 +129,8 @@ void usage (FILE * stream, int exit_code)
       "       -V      --miditap-velo     MIDI velocity; default=65.\n"
 #endif /* defined(PROG_HAS_ONSET) && !defined(PROG_HAS_PITCH) */
 #endif /* defined(PROG_HAS_JACK) && defined(HAVE_JACK) */
+      "       -b      --bench            measure the speed of the analysis\n"
+      "                 print the time taken instead of the results\n"
       "       -q      --quiet            be quiet\n"
       "       -v      --verbose          be verbose\n"
       "       -h      --help             display this message\n"
@@ -143,7 +146,7 @@ int
 parse_args (int argc, char **argv)
 {
 #ifdef HAVE_GETOPT_H
-  const char *options = "hvq"
+  const char *options = "hvqb"
     "i:r:B:H:"
 #ifdef PROG_HAS_JACK
     "j"
@@ -176,6 +179,7 @@ parse_args (int argc, char **argv)
     {"help",                  0, NULL, 'h'},
     {"verbose",               0, NULL, 'v'},
     {"quiet",                 0, NULL, 'q'},
+    {"bench",                 0, NULL, 'b'},
     {"input",                 1, NULL, 'i'},
     {"samplerate",            1, NULL, 'r'},
     {"bufsize",               1, NULL, 'B'},
@@ -232,6 +236,9 @@ parse_args (int argc, char **argv)
       case 'q':                /* quiet */
         quiet = 1;
         break;
+      case 'b':                /* bench */
+        bench = 1;
+        break;
       case 'j':
         usejack = 1;
         break;
@@ -30,10 +30,15 @@
 #ifdef HAVE_JACK
 #include "jackio.h"
 #endif /* HAVE_JACK */
+#include <time.h>               // for clock
+#ifdef _WIN32
+#include <windows.h>            // for QueryPerformanceCounter
+#endif
 
 int verbose = 0;
 int quiet = 0;
 int usejack = 0;
+int bench = 0;
 // input / output
 char_t *sink_uri = NULL;
 char_t *source_uri = NULL;
@@ -90,6 +95,52 @@ void examples_common_del (void);
 void examples_common_process (aubio_process_func_t process_func,
     aubio_print_func_t print);
 
+/* wall clock time, in seconds */
+static double bench_clock (void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER count, freq;
+  QueryPerformanceCounter (&count);
+  QueryPerformanceFrequency (&freq);
+  return (double)count.QuadPart / freq.QuadPart;
+#else
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1.e-9 * t.tv_nsec;
+#endif
+}
+
+static int bench_compare (const void *a, const void *b)
+{
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* print the time taken by the hops, sorting them */
+static void bench_report (double *hop_times, uint_t n_hops, double wall,
+    double cpu, uint_t total_read)
+{
+  double duration = total_read / (double)samplerate;
+  double budget = hop_size / (double)samplerate, processing = 0.;
+  uint_t i, late = 0;
+  for (i = 0; i < n_hops; i++) {
+    processing += hop_times[i];
+    if (hop_times[i] > budget) late++;
+  }
+  qsort (hop_times, n_hops, sizeof(double), bench_compare);
+  outmsg ("read %.2fs in %d hops of %d samples at %dHz\n", duration,
+      n_hops, hop_size, samplerate);
+  outmsg ("wall time %.3fs, cpu time %.3fs, processing %.3fs\n", wall, cpu,
+      processing);
+  outmsg ("real-time factor %.4f, %.4f including reading\n",
+      duration > 0. ? processing / duration : 0.,
+      duration > 0. ? wall / duration : 0.);
+  outmsg ("hop time p50 %.1fus, p90 %.1fus, p99 %.1fus, max %.1fus\n",
+      1.e6 * hop_times[n_hops / 2], 1.e6 * hop_times[n_hops * 9 / 10],
+      1.e6 * hop_times[n_hops * 99 / 100], 1.e6 * hop_times[n_hops - 1]);
+  outmsg ("%d hops over the budget of %.1fus\n", late, 1.e6 * budget);
+}
+
 void examples_common_init (int argc, char **argv)
 {
 
@@ -106,7 +157,8 @@ void examples_common_init (int argc, char **argv)
     if (samplerate == 0) {
       samplerate = aubio_source_get_samplerate(this_source);
     }
-    if (sink_uri != NULL) {
+    // nothing is written when measuring the speed of the analysis
+    if (sink_uri != NULL && !bench) {
       uint_t sink_exists = (access(sink_uri, F_OK) == 0 );
       if (!force_overwrite && sink_exists) {
         errmsg ("Error: output file %s already exists, use -f to overwrite.\n",
@@ -164,16 +216,38 @@ void examples_common_process (aubio_process_func_t process_func,
   } else {
 
     uint_t total_read = 0;
+    double *hop_times = NULL, wall = 0., start = 0.;
+    uint_t max_hops = 0;
+    clock_t cpu = 0;
     blocks = 0;
 
+    if (bench) {
+      wall = bench_clock ();
+      cpu = clock ();
+    }
     do {
       aubio_source_do (this_source, input_buffer, &read);
-      process_func (input_buffer, output_buffer);
+      if (bench) {
+        // grow the list of hop times by half
+        if ((uint_t)blocks == max_hops) {
+          max_hops += max_hops / 2 + 1024;
+          hop_times = realloc (hop_times, max_hops * sizeof(double));
+          if (!hop_times) {
+            errmsg ("Error: could not store the time of %d hops\n", max_hops);
+            exit (1);
+          }
+        }
+        start = bench_clock ();
+        process_func (input_buffer, output_buffer);
+        hop_times[blocks] = bench_clock () - start;
+      } else {
+        process_func (input_buffer, output_buffer);
+      }
       // print to console if verbose or no output given
-      if ((verbose || sink_uri == NULL) && !quiet) {
+      if ((verbose || sink_uri == NULL) && !quiet && !bench) {
         print();
       }
-      if (this_sink) {
+      if (this_sink && !bench) {
         aubio_sink_do (this_sink, output_buffer, hop_size);
       }
       blocks++;
@@ -184,6 +258,12 @@ void examples_common_process (aubio_process_func_t process_func,
         total_read * 1. / samplerate,
         total_read, blocks, hop_size, source_uri, samplerate);
 
+    if (bench) {
+      bench_report (hop_times, blocks, bench_clock () - wall,
+          (double)(clock () - cpu) / CLOCKS_PER_SEC, total_read);
+      free (hop_times);
+    }
+
     del_aubio_source (this_source);
     if (this_sink)
       del_aubio_sink   (this_sink);
@@ -210,7 +290,9 @@ send_noteon (smpl_t pitch, smpl_t velo)
     aubio_jack_midi_event_write (jack_setup, (jack_midi_event_t *) & ev);
   } else
 #endif
-  if (velo == 0) {
+  if (bench) {
+    return;
+  } else if (velo == 0) {
     print_time (blocks * hop_size);
     outmsg ("\n");
   } else {
@@ -0,0 +1,39 @@
+#! /usr/bin/env python
+
+"""Print the pitch of each block captured from an audio device.
+
+Usage: demo_capture.py [device]
+
+The device is `alsa:default` by default; other devices are named after
+their scheme, for instance `alsa:hw:1,0`, or `coreaudio:` on macOS.
+"""
+
+import sys
+import aubio
+
+device = sys.argv[1] if len(sys.argv) > 1 else 'alsa:default'
+
+# constants
+samplerate = 44100
+win_s = 2048
+hop_s = win_s // 2
+
+# blocks are returned as soon as the device captured them
+recorder = aubio.source(device, samplerate, hop_s)
+
+pitcher = aubio.pitch("default", win_s, hop_s, samplerate)
+pitcher.set_unit("Hz")
+pitcher.set_silence(-40)
+
+print("Starting to listen to {:s}, press Ctrl+C to stop".format(device))
+
+while True:
+    try:
+        samples, read = recorder()
+        freq = pitcher(samples)[0]
+        energy = (samples**2).sum() / len(samples)
+        print("{:10.4f} {:10.4f}".format(freq, energy))
+    except KeyboardInterrupt:
+        print("Ctrl+C pressed, exiting")
+        break
+recorder.close()
@@ -27,6 +27,39 @@
     "<https://en.wikipedia.org/wiki/Discrete_cosine_transform#DCT-II>`_\n"\
     "on Wikipedia.\n"
 
+#define PYAUBIO_framerate_doc \
+    "framerate(method=\"default\", size=1024, hop_size=512, samplerate=44100, rate=60.)\n"\
+    "\n"\
+    "Pool the features of consecutive hops to a lower frame rate.\n"\
+    "\n"\
+    "`framerate` creates a callable which takes the features of each\n"\
+    "hop, such as the output of :class:`filterbank` or :class:`mfcc`,\n"\
+    "and returns the last frame output. A new frame, the mean or the\n"\
+    "maximum of the features since the previous one, is output about\n"\
+    "`rate` times per second, after which :meth:`get_ready` returns 1.\n"\
+    "\n"\
+    "Parameters\n"\
+    "----------\n"\
+    "method : str\n"\
+    "    pooling of the features, `mean` (or `default`) or `max`\n"\
+    "size : int\n"\
+    "    length of the features\n"\
+    "hop_size : int\n"\
+    "    number of samples between consecutive features\n"\
+    "samplerate : int\n"\
+    "    sampling rate of the signal\n"\
+    "rate : float\n"\
+    "    number of frames per second, at most `samplerate / hop_size`\n"\
+    "\n"\
+    "Example\n"\
+    "-------\n"\
+    ">>> f = aubio.filterbank(40, 512)\n"\
+    ">>> f.set_mel_coeffs_slaney(44100)\n"\
+    ">>> rate = aubio.framerate('max', 40, 256, 44100, 60)\n"\
+    ">>> energies = rate(f(aubio.cvec(512)))\n"\
+    ">>> rate.get_ready()\n"\
+    "0\n"
+
 #define PYAUBIO_mfcc_doc \
     "mfcc(buf_size=1024, n_filters=40, n_coeffs=13, samplerate=44100)\n"\
     "\n"\
@@ -93,7 +126,8 @@
     "- `specdiff`: spectral difference,\n"\
     "- `kl`: Kullback-Liebler,\n"\
     "- `mkl`: modified Kullback-Liebler,\n"\
-    "- `specflux`: spectral flux.\n"\
+    "- `specflux`: spectral flux,\n"\
+    "- `superflux`: spectral flux with vibrato suppression.\n"\
     "\n"\
     "Spectral shape functions:\n"\
     "\n"\
@@ -60,6 +60,54 @@
 #define Py_TYPE(ob) (((PyObject*)(ob))->ob_type)
 #endif
 
+// The wrappers release the GIL while running aubio, and hold a lock per
+// object instead, so that one object is never run by two threads at once.
+// The GIL is released while waiting for the lock, since the thread holding
+// the lock may need the GIL before releasing it.
+#define PyAubio_Lock(lock) \
+  do { \
+    if (!PyThread_acquire_lock ((lock), NOWAIT_LOCK)) { \
+      Py_BEGIN_ALLOW_THREADS \
+      PyThread_acquire_lock ((lock), WAIT_LOCK); \
+      Py_END_ALLOW_THREADS \
+    } \
+  } while (0)
+
+#define PyAubio_Unlock(lock) PyThread_release_lock (lock)
+
+// Same as Py_BEGIN_ALLOW_THREADS and Py_END_ALLOW_THREADS, also keeping the
+// thread state released, so that the errors logged by aubio meanwhile are
+// raised in the interpreter of the calling thread, see aubio_log_function.
+extern PyThreadState *PyAubio_SaveThread (void);
+extern void PyAubio_RestoreThread (PyThreadState *tstate);
+
+#define PyAubio_BEGIN_ALLOW_THREADS \
+  { PyThreadState *_save = PyAubio_SaveThread ();
+#define PyAubio_END_ALLOW_THREADS \
+  PyAubio_RestoreThread (_save); }
+
+// Objects without a lock of their own, such as cvec, guard their fields
+// with a critical section, needed from Python 3.13 when built without the
+// GIL; on older versions the GIL is enough.
+#if PY_VERSION_HEX < 0x030D0000
+#define Py_BEGIN_CRITICAL_SECTION(op) {
+#define Py_END_CRITICAL_SECTION() }
+#endif
+
+// vectorcall is public from Python 3.9, and provisional in 3.8
+#if PY_VERSION_HEX < 0x03090000
+#define Py_TPFLAGS_HAVE_VECTORCALL _Py_TPFLAGS_HAVE_VECTORCALL
+#endif
+
+// 1 if input is a contiguous vector of samples, which the generated wrappers
+// use in place without further checks
+#define PyAubio_IsFastVector(input) \
+  (PyArray_Check (input) \
+   && PyArray_TYPE ((PyArrayObject *)(input)) == AUBIO_NPY_SMPL \
+   && PyArray_NDIM ((PyArrayObject *)(input)) == 1 \
+   && PyArray_IS_C_CONTIGUOUS ((PyArrayObject *)(input)) \
+   && PyArray_SIZE ((PyArrayObject *)(input)) > 0)
+
 extern PyTypeObject Py_cvecType;
 
 PyObject * new_py_fvec(uint_t length);
@@ -72,11 +120,42 @@ extern int PyAubio_IsValidVector (PyObject *input);
 extern PyObject *PyAubio_CFvecToArray (fvec_t * self);
 extern int PyAubio_ArrayToCFvec (PyObject * self, fvec_t *out);
 
+// same as PyAubio_ArrayToCFvec, keeping the buffer of objects other than
+// arrays in view until PyBuffer_Release (view), for use without the GIL
+extern int PyAubio_ArrayToCFvecView (PyObject * self, fvec_t *out,
+    Py_buffer *view);
+
+// same as PyAubio_ArrayToCFvec, also checking that self is a writeable
+// array of the given length, for the `out` parameters of the wrappers
+extern int PyAubio_ArrayToCFvecOut (PyObject * self, uint_t length,
+    fvec_t *out);
+
 extern int PyAubio_PyCvecToCCvec (PyObject *input, cvec_t *i);
+extern int PyAubio_PyCvecToCCvecOut (PyObject *input, uint_t length,
+    cvec_t *i);
+
+// contiguous array of hops of hop_size samples, from an array of shape
+// (n_hops * hop_size,) or (n_hops, hop_size), or NULL on error
+extern PyObject *PyAubio_ArrayToHops (PyObject *input, uint_t hop_size,
+    uint_t *n_hops);
+
+// 1 if kwnames, as given to a vectorcall function, only holds `out`
+extern int PyAubio_IsOutKeyword (PyObject *kwnames);
+
+// call tp_call with the arguments of a vectorcall function, packed in a
+// tuple and a dictionary
+extern PyObject *PyAubio_Vectorcall (PyObject *callable, PyObject *const *args,
+    size_t nargsf, PyObject *kwnames, ternaryfunc call);
 
 extern PyObject *PyAubio_CFmatToArray (fmat_t * self);
 extern int PyAubio_ArrayToCFmat (PyObject *input, fmat_t *out);
 
+// check that input is a contiguous and writeable array of the given shape
+extern int PyAubio_IsValidMatrixOut (PyObject *input, uint_t height,
+    uint_t length);
+extern int PyAubio_ArrayToCFmatOut (PyObject *input, uint_t height,
+    uint_t length, fmat_t *out);
+
 // hand written wrappers
 extern PyTypeObject Py_filterType;
 
@@ -88,4 +167,26 @@ extern PyTypeObject Py_pvocType;
 
 extern PyTypeObject Py_sourceType;
 
+// iterator returned by aubio.source.blocks
+extern PyTypeObject Py_source_blocksType;
+
+// aubio_source_t object wrapped by an aubio.source, or NULL on error; lock
+// should be held while using it
+aubio_source_t * PyAubio_PySourceToCSource (PyObject *input, uint_t *hop_size,
+    PyThread_type_lock *lock);
+
+// add hand written methods to the generated mfcc type
+int add_mfcc_methods (void);
+
 extern PyTypeObject Py_sinkType;
+
+extern PyTypeObject Py_specencType;
+
+// analyse a list of files on a pool of threads, in py-batch.c
+extern char Py_aubio_batch_doc[];
+PyObject * Py_aubio_batch (PyObject *self, PyObject *args, PyObject *kwds);
+
+// write slices of a file in a single pass, in py-slicer.c
+extern char Py_aubio_slice_frames_doc[];
+PyObject * Py_aubio_slice_frames (PyObject *self, PyObject *args,
+    PyObject *kwds);
@@ -199,8 +199,63 @@ static char Py_min_removal_doc[] = ""
 "array([0., 1., 2.], dtype=" AUBIO_NPY_SMPL_STR ")\n"
 "";
 
+static char Py_aubio_stats_doc[] = ""
+"stats(reset=False)\n"
+"\n"
+"Get the number of calls and the time spent in the processing functions.\n"
+"\n"
+"Only available when aubio was built with the `profiling` option,\n"
+"otherwise no function is found.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"reset : bool, optional\n"
+"   if True, set all the counters back to 0 after reading them\n"
+"\n"
+"Returns\n"
+"-------\n"
+"dict\n"
+"   for each function called so far, such as `onset` or `fft forward`,\n"
+"   a tuple with the number of calls, the time spent in all calls and\n"
+"   the time spent in the longest call, in cycles\n"
+"\n"
+"Example\n"
+"-------\n"
+"\n"
+">>> o = aubio.onset('default', 1024, 256, 44100)\n"
+">>> _ = o(aubio.fvec(256))\n"
+">>> aubio.stats()['onset'][0]  # doctest: +SKIP\n"
+"1\n"
+"";
+
 extern void add_ufuncs ( PyObject *m );
-extern int generated_types_ready(void);
+
+static int
+ready_source_blocks (void)
+{
+  // the iterator returned by source.__iter__
+  return PyType_Ready (&Py_source_blocksType);
+}
+
+typedef struct {
+  const char *name;
+  PyTypeObject *type;
+  int (*init) (void);  // called once the type is ready, or NULL
+} aubio_lazy_type_t;
+
+// hand written types, and the generated types needing more setup; the other
+// generated types are listed in aubio_generated_types
+static const aubio_lazy_type_t aubio_lazy_types[] = {
+  {"digital_filter", &Py_filterType, NULL},
+  {"filterbank", &Py_filterbankType, NULL},
+  {"fft", &Py_fftType, NULL},
+  {"pvoc", &Py_pvocType, NULL},
+  {"source", &Py_sourceType, ready_source_blocks},
+  {"sink", &Py_sinkType, NULL},
+  {"specenc", &Py_specencType, NULL},
+  {"mfcc", &Py_mfccType, add_mfcc_methods},
+  {NULL, NULL, NULL}
+};
 
 static PyObject *
 Py_alpha_norm (PyObject * self, PyObject * args)
@@ -357,6 +412,121 @@ Py_min_removal(PyObject * self, PyObject * args)
   //return (PyObject *)vec;
 }
 
+static PyObject *
+Py_aubio_stats (PyObject * self, PyObject * args, PyObject * kwds)
+{
+  static char *kwlist[] = { "reset", NULL };
+  int reset = 0;
+  uint_t i, n;
+  aubio_stats_t *stats = NULL;
+  PyObject *result, *item;
+
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "|p:stats", kwlist, &reset)) {
+    return NULL;
+  }
+  // the list only grows, so the first n entries are always filled
+  n = aubio_stats_get (NULL, 0);
+  if (n) {
+    stats = (aubio_stats_t *)PyMem_Malloc (n * sizeof(aubio_stats_t));
+    if (!stats) return PyErr_NoMemory ();
+    aubio_stats_get (stats, n);
+  }
+  if (reset) aubio_stats_reset ();
+  result = PyDict_New ();
+  for (i = 0; result && i < n; i++) {
+    item = Py_BuildValue ("(KKK)", stats[i].calls, stats[i].cycles,
+        stats[i].max_cycles);
+    if (!item || PyDict_SetItemString (result, stats[i].name, item)) {
+      Py_CLEAR (result);
+    }
+    Py_XDECREF (item);
+  }
+  PyMem_Free (stats);
+  return result;
+}
+
+// module __getattr__ (PEP 562): the types are readied and added to the
+// module the first time they are looked up, so that importing aubio does not
+// pay for the classes a program never uses
+static PyObject *
+Py_aubio_getattr (PyObject * self, PyObject * name)
+{
+  const char *s = PyUnicode_AsUTF8 (name);
+  PyTypeObject *type = NULL;
+  int (*init) (void) = NULL;
+  uint_t i;
+
+  if (s == NULL) {
+    return NULL;
+  }
+  for (i = 0; type == NULL && aubio_lazy_types[i].name; i++) {
+    if (strcmp (s, aubio_lazy_types[i].name) == 0) {
+      type = aubio_lazy_types[i].type;
+      init = aubio_lazy_types[i].init;
+    }
+  }
+  for (i = 0; type == NULL && aubio_generated_types[i].name; i++) {
+    if (strcmp (s, aubio_generated_types[i].name) == 0) {
+      type = aubio_generated_types[i].type;
+    }
+  }
+  if (type == NULL) {
+    PyErr_Format (PyExc_AttributeError,
+        "module '_aubio' has no attribute '%U'", name);
+    return NULL;
+  }
+  // without the GIL, two threads may look up the same type at once, only
+  // one of them should ready it
+  Py_BEGIN_CRITICAL_SECTION(self);
+  if (!(type->tp_flags & Py_TPFLAGS_READY)) {
+    if (PyType_Ready (type) < 0 || (init && init () < 0)) {
+      type = NULL;
+    }
+  }
+  // later lookups find the type in the module dict and do not get here
+  if (type && PyObject_SetAttr (self, name, (PyObject *) type) < 0) {
+    type = NULL;
+  }
+  Py_END_CRITICAL_SECTION();
+  Py_XINCREF (type);
+  return (PyObject *) type;
+}
+
+// append name to the list names if missing, return -1 on failure
+static int
+append_missing_name (PyObject * names, const char *s)
+{
+  PyObject *name = PyUnicode_FromString (s);
+  int err = -1;
+  if (name) {
+    err = PySequence_Contains (names, name);
+    if (err == 0) {
+      err = PyList_Append (names, name);
+    }
+    Py_DECREF (name);
+  }
+  return err < 0 ? -1 : 0;
+}
+
+// module __dir__, also listing the types not looked up yet
+static PyObject *
+Py_aubio_dir (PyObject * self, PyObject * unused)
+{
+  PyObject *names = PyDict_Keys (PyModule_GetDict (self));
+  uint_t i;
+  for (i = 0; names && aubio_lazy_types[i].name; i++) {
+    if (append_missing_name (names, aubio_lazy_types[i].name) < 0) {
+      Py_CLEAR (names);
+    }
+  }
+  for (i = 0; names && aubio_generated_types[i].name; i++) {
+    if (append_missing_name (names, aubio_generated_types[i].name) < 0) {
+      Py_CLEAR (names);
+    }
+  }
+  return names;
+}
+
 static PyMethodDef aubio_methods[] = {
   {"bintomidi", Py_bintomidi, METH_VARARGS, Py_bintomidi_doc},
   {"miditobin", Py_miditobin, METH_VARARGS, Py_miditobin_doc},
@@ -376,68 +546,82 @@ static PyMethodDef aubio_methods[] = {
   {"meltohz", Py_aubio_meltohz, METH_VARARGS|METH_KEYWORDS, Py_aubio_meltohz_doc},
   {"hztomel_htk", Py_aubio_hztomel_htk, METH_VARARGS, Py_aubio_hztomel_htk_doc},
   {"meltohz_htk", Py_aubio_meltohz_htk, METH_VARARGS, Py_aubio_meltohz_htk_doc},
+  {"find_peaks", (PyCFunction)Py_aubio_find_peaks,
+    METH_VARARGS|METH_KEYWORDS, Py_aubio_find_peaks_doc},
+  {"batch", (PyCFunction)Py_aubio_batch, METH_VARARGS|METH_KEYWORDS, Py_aubio_batch_doc},
+  {"slice_frames", (PyCFunction)Py_aubio_slice_frames, METH_VARARGS|METH_KEYWORDS, Py_aubio_slice_frames_doc},
+  {"stats", (PyCFunction)Py_aubio_stats, METH_VARARGS|METH_KEYWORDS, Py_aubio_stats_doc},
+  {"__getattr__", Py_aubio_getattr, METH_O, NULL},
+  {"__dir__", Py_aubio_dir, METH_NOARGS, NULL},
   {NULL, NULL, 0, NULL} /* Sentinel */
 };
 
-#if PY_MAJOR_VERSION >= 3
-// Python3 module definition
-static struct PyModuleDef moduledef = {
-   PyModuleDef_HEAD_INIT,
-   "_aubio",          /* m_name */
-   aubio_module_doc,  /* m_doc */
-   -1,                /* m_size */
-   aubio_methods,     /* m_methods */
-   NULL,              /* m_reload */
-   NULL,              /* m_traverse */
-   NULL,              /* m_clear */
-   NULL,              /* m_free */
-};
+// thread state of the wrapper running aubio on the current thread, if any,
+// see PyAubio_SaveThread
+static Py_tss_t Py_aubio_tstate_key = Py_tss_NEEDS_INIT;
+
+#if PY_VERSION_HEX < 0x030D0000
+#define PyThreadState_GetUnchecked _PyThreadState_UncheckedGet
 #endif
 
+PyThreadState *
+PyAubio_SaveThread (void)
+{
+  PyThreadState *tstate = PyEval_SaveThread ();
+  PyThread_tss_set (&Py_aubio_tstate_key, tstate);
+  return tstate;
+}
+
+void
+PyAubio_RestoreThread (PyThreadState *tstate)
+{
+  PyThread_tss_set (&Py_aubio_tstate_key, NULL);
+  PyEval_RestoreThread (tstate);
+}
+
 void
 aubio_log_function(int level, const char *message, void *data)
 {
+  PyThreadState *tstate = PyThread_tss_get (&Py_aubio_tstate_key);
   // remove trailing \n
   char *pos;
   if ((pos=strchr(message, '\n')) != NULL) {
         *pos = '\0';
   }
+  if (tstate) {
+    // aubio is running without the GIL, raise in the interpreter of the
+    // wrapper that released it
+    PyEval_RestoreThread (tstate);
+  } else if (!PyThreadState_GetUnchecked ()) {
+    // the threads started by aubio, and the calls made without the GIL by
+    // aubio.batch and aubio.slice_frames, have no exception to raise
+    fprintf (stderr, "%s\n", message);
+    return;
+  }
   // warning or error
   if (level == AUBIO_LOG_ERR) {
     PyErr_Format(PyExc_RuntimeError, "%s", message);
   } else {
     PyErr_WarnEx(PyExc_UserWarning, message, 1);
   }
+  if (tstate) {
+    PyEval_SaveThread ();
+  }
 }
 
-static PyObject *
-initaubio (void)
+static int
+aubio_exec (PyObject *m)
 {
-  PyObject *m = NULL;
   int err;
 
-  // fvec is defined in __init__.py
-  if (   (PyType_Ready (&Py_cvecType) < 0)
-      || (PyType_Ready (&Py_filterType) < 0)
-      || (PyType_Ready (&Py_filterbankType) < 0)
-      || (PyType_Ready (&Py_fftType) < 0)
-      || (PyType_Ready (&Py_pvocType) < 0)
-      || (PyType_Ready (&Py_sourceType) < 0)
-      || (PyType_Ready (&Py_sinkType) < 0)
-      // generated objects
-      || (generated_types_ready() < 0 )
-  ) {
-    return m;
+  // fvec is defined in __init__.py; cvec objects are returned by many
+  // types, the other types are readied on first use, see Py_aubio_getattr
+  if (PyType_Ready (&Py_cvecType) < 0) {
+    return -1;
   }
-
-#if PY_MAJOR_VERSION >= 3
-  m = PyModule_Create(&moduledef);
-#else
-  m = Py_InitModule3 ("_aubio", aubio_methods, aubio_module_doc);
-#endif
-
-  if (m == NULL) {
-    return m;
+  if (PyThread_tss_create (&Py_aubio_tstate_key) != 0) {
+    PyErr_NoMemory ();
+    return -1;
   }
 
   err = _import_array ();
@@ -448,43 +632,61 @@ initaubio (void)
 
   Py_INCREF (&Py_cvecType);
   PyModule_AddObject (m, "cvec", (PyObject *) & Py_cvecType);
-  Py_INCREF (&Py_filterType);
-  PyModule_AddObject (m, "digital_filter", (PyObject *) & Py_filterType);
-  Py_INCREF (&Py_filterbankType);
-  PyModule_AddObject (m, "filterbank", (PyObject *) & Py_filterbankType);
-  Py_INCREF (&Py_fftType);
-  PyModule_AddObject (m, "fft", (PyObject *) & Py_fftType);
-  Py_INCREF (&Py_pvocType);
-  PyModule_AddObject (m, "pvoc", (PyObject *) & Py_pvocType);
-  Py_INCREF (&Py_sourceType);
-  PyModule_AddObject (m, "source", (PyObject *) & Py_sourceType);
-  Py_INCREF (&Py_sinkType);
-  PyModule_AddObject (m, "sink", (PyObject *) & Py_sinkType);
 
   PyModule_AddStringConstant(m, "float_type", AUBIO_NPY_SMPL_STR);
   PyModule_AddStringConstant(m, "__version__", DEFINEDSTRING(AUBIO_VERSION));
 
-  // add generated objects
-  add_generated_objects(m);
-
   // add ufunc
   add_ufuncs(m);
 
   aubio_log_set_level_function(AUBIO_LOG_ERR, aubio_log_function, NULL);
   aubio_log_set_level_function(AUBIO_LOG_WRN, aubio_log_function, NULL);
-  return m;
+  return 0;
 }
 
+#if PY_MAJOR_VERSION >= 3
+// Python3 module definition, with multi-phase initialization (PEP 489) so
+// that each interpreter importing aubio gets its own module
+static PyModuleDef_Slot aubio_slots[] = {
+  {Py_mod_exec, aubio_exec},
+#if PY_VERSION_HEX >= 0x030C0000
+  // the types are static and shared by the interpreters, which should then
+  // share the GIL too
+  {Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED},
+#endif
+#if PY_VERSION_HEX >= 0x030D0000
+  // the wrappers hold a lock per object, see PyAubio_Lock, and do not need
+  // the GIL on free-threaded builds
+  {Py_mod_gil, Py_MOD_GIL_NOT_USED},
+#endif
+  {0, NULL}
+};
+
+static struct PyModuleDef moduledef = {
+   PyModuleDef_HEAD_INIT,
+   "_aubio",          /* m_name */
+   aubio_module_doc,  /* m_doc */
+   0,                 /* m_size */
+   aubio_methods,     /* m_methods */
+   aubio_slots,       /* m_slots */
+   NULL,              /* m_traverse */
+   NULL,              /* m_clear */
+   NULL,              /* m_free */
+};
+#endif
+
 #if PY_MAJOR_VERSION >= 3
     // Python3 init
     PyMODINIT_FUNC PyInit__aubio(void)
     {
-        return initaubio();
+        return PyModuleDef_Init (&moduledef);
     }
 #else
     // Python 2 init
     PyMODINIT_FUNC init_aubio(void)
     {
-        initaubio();
+        PyObject *m = Py_InitModule3 ("_aubio", aubio_methods,
+            aubio_module_doc);
+        if (m) aubio_exec (m);
     }
 #endif
@@ -53,6 +53,12 @@ PyAubio_IsValidVector (PyObject * input) {
       return 0;
     }
 
+    // the data is used in place, without copying it
+    if (!PyArray_IS_C_CONTIGUOUS ((PyArrayObject *)input)) {
+      PyErr_SetString (PyExc_ValueError, "input array should be contiguous");
+      return 0;
+    }
+
   } else if (PyObject_TypeCheck (input, &PyList_Type)) {
     PyErr_SetString (PyExc_ValueError, "does not convert from list yet");
     return 0;
@@ -65,6 +71,18 @@ PyAubio_IsValidVector (PyObject * input) {
 
 int
 PyAubio_ArrayToCFvec (PyObject *input, fvec_t *out) {
+  Py_buffer view;
+
+  if (input != NULL && !PyArray_Check (input)
+      && PyObject_CheckBuffer (input)) {
+    if (!PyAubio_ArrayToCFvecView (input, out, &view)) {
+      return 0;
+    }
+    // out is only used while holding the GIL, so that nothing can resize
+    // the buffer meanwhile
+    PyBuffer_Release (&view);
+    return 1;
+  }
 
   if (!PyAubio_IsValidVector(input)){
     return 0;
@@ -75,6 +93,151 @@ PyAubio_ArrayToCFvec (PyObject *input, fvec_t *out) {
   return 1;
 }
 
+int
+PyAubio_ArrayToCFvecView (PyObject *input, fvec_t *out, Py_buffer *view) {
+  const char *format;
+  Py_ssize_t length;
+
+  view->obj = NULL;
+  if (input == NULL || PyArray_Check (input)
+      || !PyObject_CheckBuffer (input)) {
+    return PyAubio_ArrayToCFvec (input, out);
+  }
+
+  if (PyObject_GetBuffer (input, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT)) {
+    PyErr_Clear ();
+    PyErr_SetString (PyExc_ValueError, "input buffer should be contiguous");
+    return 0;
+  }
+  format = view->format ? view->format : "B";
+  if (format[0] == '@' || format[0] == '=') {
+    format++;
+  }
+  if (strcmp (format, AUBIO_NPY_SMPL_CHR) == 0
+      && view->itemsize == sizeof(smpl_t)) {
+    length = view->len / sizeof(smpl_t);
+  } else if (strcmp (format, "B") == 0 || strcmp (format, "b") == 0
+      || strcmp (format, "c") == 0) {
+    // raw bytes, for instance from an audio stream, hold native samples
+    if (view->len % sizeof(smpl_t) != 0) {
+      PyErr_Format (PyExc_ValueError, "input buffer size should be a multiple"
+          " of %d bytes, not %zd", (int)sizeof(smpl_t), view->len);
+      PyBuffer_Release (view);
+      return 0;
+    }
+    length = view->len / sizeof(smpl_t);
+  } else {
+    PyErr_SetString (PyExc_ValueError,
+        "input buffer should hold " AUBIO_NPY_SMPL_STR " samples");
+    PyBuffer_Release (view);
+    return 0;
+  }
+  if (length <= 0) {
+    PyErr_SetString (PyExc_ValueError,
+        "input buffer size should be greater than 0");
+    PyBuffer_Release (view);
+    return 0;
+  }
+  if ((size_t)view->buf % sizeof(smpl_t) != 0) {
+    PyErr_SetString (PyExc_ValueError, "input buffer should be aligned");
+    PyBuffer_Release (view);
+    return 0;
+  }
+
+  out->length = (uint_t)length;
+  out->data = (smpl_t *)view->buf;
+  return 1;
+}
+
+int
+PyAubio_ArrayToCFvecOut (PyObject *output, uint_t length, fvec_t *out) {
+  if (!PyAubio_IsValidVector(output)) {
+    return 0;
+  }
+  if (!PyArray_ISWRITEABLE ((PyArrayObject *)output)) {
+    PyErr_SetString (PyExc_ValueError, "out array should be writeable");
+    return 0;
+  }
+  if (PyArray_SIZE ((PyArrayObject *)output) != length) {
+    PyErr_Format (PyExc_ValueError, "out array should have length %d, not %"
+        NPY_INTP_FMT, length, PyArray_SIZE ((PyArrayObject *)output));
+    return 0;
+  }
+  return PyAubio_ArrayToCFvec (output, out);
+}
+
+PyObject *
+PyAubio_ArrayToHops (PyObject *input, uint_t hop_size, uint_t *n_hops)
+{
+  PyArrayObject *array = (PyArrayObject *)input;
+  npy_intp size;
+  if (!PyArray_Check (input)) {
+    PyErr_SetString (PyExc_ValueError, "input should be an array of float");
+    return NULL;
+  }
+  if (PyArray_TYPE (array) != AUBIO_NPY_SMPL) {
+    PyErr_SetString (PyExc_ValueError, "input array should be " AUBIO_NPY_SMPL_STR);
+    return NULL;
+  }
+  size = PyArray_SIZE (array);
+  if (PyArray_NDIM (array) == 1) {
+    if (size <= 0 || size % hop_size != 0) {
+      PyErr_Format (PyExc_ValueError, "input array size should be a"
+          " multiple of %d, not %" NPY_INTP_FMT, hop_size, size);
+      return NULL;
+    }
+  } else if (PyArray_NDIM (array) == 2) {
+    if (PyArray_DIM (array, 1) != hop_size || PyArray_DIM (array, 0) <= 0) {
+      PyErr_Format (PyExc_ValueError, "input array should have rows of %d"
+          " samples, not %" NPY_INTP_FMT, hop_size, PyArray_DIM (array, 1));
+      return NULL;
+    }
+  } else {
+    PyErr_SetString (PyExc_ValueError,
+        "input array should have one or two dimensions");
+    return NULL;
+  }
+  *n_hops = (uint_t)(size / hop_size);
+  // copies only arrays that are not contiguous
+  return PyArray_FROM_OTF (input, AUBIO_NPY_SMPL, NPY_ARRAY_IN_ARRAY);
+}
+
+int
+PyAubio_IsOutKeyword (PyObject *kwnames)
+{
+  return kwnames != NULL && PyTuple_GET_SIZE (kwnames) == 1
+    && PyUnicode_CompareWithASCIIString (PyTuple_GET_ITEM (kwnames, 0),
+        "out") == 0;
+}
+
+PyObject *
+PyAubio_Vectorcall (PyObject *callable, PyObject *const *args, size_t nargsf,
+    PyObject *kwnames, ternaryfunc call)
+{
+  Py_ssize_t i, nargs = PyVectorcall_NARGS (nargsf);
+  PyObject *tuple, *kwds = NULL, *result = NULL;
+  tuple = PyTuple_New (nargs);
+  if (!tuple) return NULL;
+  for (i = 0; i < nargs; i++) {
+    Py_INCREF (args[i]);
+    PyTuple_SET_ITEM (tuple, i, args[i]);
+  }
+  if (kwnames && PyTuple_GET_SIZE (kwnames) > 0) {
+    kwds = PyDict_New ();
+    if (!kwds) goto beach;
+    for (i = 0; i < PyTuple_GET_SIZE (kwnames); i++) {
+      if (PyDict_SetItem (kwds, PyTuple_GET_ITEM (kwnames, i),
+            args[nargs + i])) goto beach;
+    }
+  }
+  result = call (callable, tuple, kwds);
+
+beach:
+  Py_DECREF (tuple);
+  Py_XDECREF (kwds);
+  return result;
+}
+
 PyObject *
 PyAubio_CFmatToArray (fmat_t * input)
 {
@@ -133,6 +296,12 @@ PyAubio_ArrayToCFmat (PyObject *input, fmat_t *mat) {
       return 0;
     }
 
+    // each row is used in place, without copying it
+    if (PyArray_STRIDE ((PyArrayObject *)input, 1) != sizeof(smpl_t)) {
+      PyErr_SetString (PyExc_ValueError, "input array rows should be contiguous");
+      return 0;
+    }
+
   } else if (PyObject_TypeCheck (input, &PyList_Type)) {
     PyErr_SetString (PyExc_ValueError, "can not convert list to fmat");
     return 0;
@@ -156,3 +325,37 @@ PyAubio_ArrayToCFmat (PyObject *input, fmat_t *mat) {
   }
   return 1;
 }
+
+int
+PyAubio_IsValidMatrixOut (PyObject *output, uint_t height, uint_t length) {
+  PyArrayObject *array = (PyArrayObject *)output;
+  if (!PyArray_Check (output) || PyArray_NDIM (array) != 2) {
+    PyErr_SetString (PyExc_ValueError, "out should be a 2-dimensional array");
+    return 0;
+  }
+  if (PyArray_TYPE (array) != AUBIO_NPY_SMPL) {
+    PyErr_SetString (PyExc_ValueError, "out array should be " AUBIO_NPY_SMPL_STR);
+    return 0;
+  }
+  if (PyArray_DIM (array, 0) != height || PyArray_DIM (array, 1) != length) {
+    PyErr_Format (PyExc_ValueError, "out array should have shape (%d, %d),"
+        " not (%" NPY_INTP_FMT ", %" NPY_INTP_FMT ")", height, length,
+        PyArray_DIM (array, 0), PyArray_DIM (array, 1));
+    return 0;
+  }
+  if (!PyArray_IS_C_CONTIGUOUS (array) || !PyArray_ISWRITEABLE (array)) {
+    PyErr_SetString (PyExc_ValueError,
+        "out array should be contiguous and writeable");
+    return 0;
+  }
+  return 1;
+}
+
+int
+PyAubio_ArrayToCFmatOut (PyObject *output, uint_t height, uint_t length,
+    fmat_t *out) {
+  if (!PyAubio_IsValidMatrixOut (output, height, length)) {
+    return 0;
+  }
+  return PyAubio_ArrayToCFmat (output, out);
+}
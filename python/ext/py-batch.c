@@ -0,0 +1,193 @@
+#include "aubio-types.h"
+
+char Py_aubio_batch_doc[] = ""
+"batch(uris, analysis, callback, method='default', buf_size=512,\n"
+"      hop_size=256, samplerate=0, threads=0, threshold=None,\n"
+"      silence=None, cache=None)\n"
+"\n"
+"Run the same analysis on a list of files, on a pool of threads.\n"
+"\n"
+"Each file is analysed by a single thread, and `callback` is called\n"
+"with its results as soon as it is done. The files may complete in\n"
+"any order, but `callback` is never called by two threads at once.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"uris : list of str\n"
+"   paths of the files to analyse\n"
+"analysis : str\n"
+"   `onset`, `beat`, `tempo`, `notes` or `pitch`\n"
+"callback : callable\n"
+"   called as `callback(index, uri, results)`, where `results` is an\n"
+"   array with one row per event, or `None` if the file could not be\n"
+"   analysed\n"
+"method : str, optional\n"
+"   method of the analysis, for instance `hfc` for `onset`\n"
+"buf_size : int, optional\n"
+"   buffer size of the analysis\n"
+"hop_size : int, optional\n"
+"   hop size of the analysis\n"
+"samplerate : int, optional\n"
+"   samplerate to read the files at, 0 to use their own\n"
+"threads : int, optional\n"
+"   number of threads, 0 to use one per processor\n"
+"threshold : float, optional\n"
+"   peak-picking threshold, or tolerance for `pitch`\n"
+"silence : float, optional\n"
+"   silence threshold, in dB\n"
+"cache : str, optional\n"
+"   existing directory to keep the results in; files analysed again\n"
+"   with the same parameters are then read from it\n"
+"\n"
+"Returns\n"
+"-------\n"
+"int\n"
+"   number of files that could not be analysed\n"
+"\n"
+"Notes\n"
+"-----\n"
+"The rows of `results` hold:\n"
+"\n"
+"- `onset`, `beat`: the time of the event, in seconds\n"
+"- `tempo`: a single row with the tempo, in bpm, and its confidence\n"
+"- `notes`: the midi note, its velocity, start and end, in seconds\n"
+"- `pitch`: the time, in seconds, the frequency, in Hz, and the\n"
+"  confidence of each hop\n"
+"\n"
+"Examples\n"
+"--------\n"
+">>> def show(index, uri, results):\n"
+"...     print(uri, len(results) if results is not None else 'failed')\n"
+">>> aubio.batch(['a.wav', 'b.wav'], 'onset', show)\n"
+"0\n"
+"";
+
+#if PY_VERSION_HEX < 0x03090000
+#define PyInterpreterState_Get _PyInterpreterState_Get
+#endif
+
+typedef struct {
+  PyInterpreterState *interp;   /**< interpreter to call callback in */
+  PyObject *callback;
+  PyObject *exc_type;           /**< first exception raised by callback */
+  PyObject *exc_value;
+  PyObject *exc_traceback;
+} Py_batch_context;
+
+// called by the threads of aubio_batch_run, which have no thread state:
+// one is created in the interpreter that called aubio.batch, which may not
+// be the main one
+static void
+Py_aubio_batch_callback (void *data, uint_t index, const char_t *uri,
+    const fmat_t *results)
+{
+  Py_batch_context *ctx = (Py_batch_context *)data;
+  PyObject *array = NULL, *ret = NULL;
+  PyThreadState *tstate = PyThreadState_New (ctx->interp);
+  uint_t i;
+  PyEval_RestoreThread (tstate);
+  // stop calling back once an exception was raised
+  if (ctx->exc_type) goto beach;
+  if (results) {
+    array = new_py_fmat (results->height, results->length);
+    if (!array) goto beach;
+    for (i = 0; i < results->height; i++) {
+      memcpy (PyArray_GETPTR2 ((PyArrayObject *)array, i, 0),
+          results->data[i], results->length * sizeof(smpl_t));
+    }
+  } else {
+    Py_INCREF (Py_None);
+    array = Py_None;
+  }
+  ret = PyObject_CallFunction (ctx->callback, "IsO", index, uri, array);
+beach:
+  if (!ret && PyErr_Occurred ()) {
+    PyErr_Fetch (&ctx->exc_type, &ctx->exc_value, &ctx->exc_traceback);
+  }
+  Py_XDECREF (ret);
+  Py_XDECREF (array);
+  PyThreadState_Clear (tstate);
+  PyThreadState_DeleteCurrent ();
+}
+
+PyObject *
+Py_aubio_batch (PyObject *self, PyObject *args, PyObject *kwds)
+{
+  static char *kwlist[] = { "uris", "analysis", "callback", "method",
+    "buf_size", "hop_size", "samplerate", "threads", "threshold", "silence",
+    "cache", NULL };
+  PyObject *uris = NULL, *seq = NULL, *threshold = Py_None,
+           *silence = Py_None;
+  char_t *analysis = NULL, *method = "default", *cache = NULL;
+  uint_t buf_size = 512, hop_size = 256, samplerate = 0, threads = 0;
+  uint_t i, n_uris, failed;
+  const char_t **c_uris = NULL;
+  aubio_batch_t *o = NULL;
+  Py_batch_context ctx = { NULL, NULL, NULL, NULL, NULL };
+
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "OsO|sIIIIOOz", kwlist,
+        &uris, &analysis, &ctx.callback, &method, &buf_size, &hop_size,
+        &samplerate, &threads, &threshold, &silence, &cache)) {
+    return NULL;
+  }
+  ctx.interp = PyInterpreterState_Get ();
+  if (!PyCallable_Check (ctx.callback)) {
+    PyErr_SetString (PyExc_TypeError, "callback should be callable");
+    return NULL;
+  }
+  seq = PySequence_Fast (uris, "uris should be a list of paths");
+  if (!seq) return NULL;
+  n_uris = (uint_t)PySequence_Fast_GET_SIZE (seq);
+  c_uris = (const char_t **)calloc (MAX(1, n_uris), sizeof(char_t *));
+  if (!c_uris) {
+    PyErr_NoMemory ();
+    goto beach;
+  }
+  for (i = 0; i < n_uris; i++) {
+    // seq holds the strings until the end of the run
+    c_uris[i] = PyUnicode_AsUTF8 (PySequence_Fast_GET_ITEM (seq, i));
+    if (!c_uris[i]) goto beach;
+  }
+
+  o = new_aubio_batch (analysis, method, buf_size, hop_size, samplerate);
+  if (!o) {
+    // the log function already raised an exception
+    if (!PyErr_Occurred ()) {
+      PyErr_SetString (PyExc_ValueError, "failed creating batch");
+    }
+    goto beach;
+  }
+  aubio_batch_set_threads (o, threads);
+  if ((threshold != Py_None && aubio_batch_set_threshold (o,
+          (smpl_t)PyFloat_AsDouble (threshold)))
+      || (silence != Py_None && aubio_batch_set_silence (o,
+          (smpl_t)PyFloat_AsDouble (silence)))
+      || aubio_batch_set_cache (o, cache)) {
+    if (!PyErr_Occurred ()) {
+      PyErr_SetString (PyExc_ValueError, "failed setting batch parameters");
+    }
+    goto beach;
+  }
+  if (PyErr_Occurred ()) goto beach;
+
+  // the errors logged by the threads are written to stderr, see
+  // aubio_log_function
+  Py_BEGIN_ALLOW_THREADS
+  failed = aubio_batch_run (o, c_uris, n_uris, Py_aubio_batch_callback, &ctx);
+  Py_END_ALLOW_THREADS
+
+  del_aubio_batch (o);
+  free (c_uris);
+  Py_DECREF (seq);
+  if (ctx.exc_type) {
+    PyErr_Restore (ctx.exc_type, ctx.exc_value, ctx.exc_traceback);
+    return NULL;
+  }
+  return PyLong_FromLong (failed);
+
+beach:
+  if (o) del_aubio_batch (o);
+  if (c_uris) free (c_uris);
+  Py_XDECREF (seq);
+  return NULL;
+}
@@ -76,6 +76,26 @@ PyAubio_PyCvecToCCvec (PyObject *input, cvec_t *i) {
   }
 }
 
+int
+PyAubio_PyCvecToCCvecOut (PyObject *output, uint_t length, cvec_t *o) {
+  Py_cvec *out = (Py_cvec *)output;
+  if (!PyObject_TypeCheck (output, &Py_cvecType)) {
+    PyErr_SetString (PyExc_ValueError, "out should be aubio.cvec");
+    return 0;
+  }
+  if (out->length != length) {
+    PyErr_Format (PyExc_ValueError, "out cvec should have length %d, not %d",
+        length, out->length);
+    return 0;
+  }
+  if (!PyArray_ISWRITEABLE ((PyArrayObject *)(out->norm))
+      || !PyArray_ISWRITEABLE ((PyArrayObject *)(out->phas))) {
+    PyErr_SetString (PyExc_ValueError, "out cvec should be writeable");
+    return 0;
+  }
+  return PyAubio_PyCvecToCCvec (output, o);
+}
+
 static PyObject *
 Py_cvec_new (PyTypeObject * type, PyObject * args, PyObject * kwds)
 {
@@ -154,22 +174,33 @@ fail:
 PyObject *
 Py_cvec_get_norm (Py_cvec * self, void *closure)
 {
-  // we want self->norm to still exist after our caller return it
-  Py_INCREF(self->norm);
-  return (PyObject*)(self->norm);
+  PyObject *norm;
+  // we want self->norm to still exist after our caller return it, even if
+  // another thread sets a new one
+  Py_BEGIN_CRITICAL_SECTION(self);
+  norm = self->norm;
+  Py_INCREF(norm);
+  Py_END_CRITICAL_SECTION();
+  return norm;
 }
 
 PyObject *
 Py_cvec_get_phas (Py_cvec * self, void *closure)
 {
-  // we want self->phas to still exist after our caller return it
-  Py_INCREF(self->phas);
-  return (PyObject *)(self->phas);
+  PyObject *phas;
+  // we want self->phas to still exist after our caller return it, even if
+  // another thread sets a new one
+  Py_BEGIN_CRITICAL_SECTION(self);
+  phas = self->phas;
+  Py_INCREF(phas);
+  Py_END_CRITICAL_SECTION();
+  return phas;
 }
 
 static int
 Py_cvec_set_norm (Py_cvec * vec, PyObject *input, void * closure)
 {
+  PyObject *old;
   npy_intp length;
   if (!PyAubio_IsValidVector(input)) {
     return -1;
@@ -182,15 +213,19 @@ Py_cvec_set_norm (Py_cvec * vec, PyObject *input, void * closure)
     return -1;
   }
 
-  Py_XDECREF(vec->norm);
+  Py_INCREF(input);
+  Py_BEGIN_CRITICAL_SECTION(vec);
+  old = vec->norm;
   vec->norm = input;
-  Py_INCREF(vec->norm);
+  Py_END_CRITICAL_SECTION();
+  Py_XDECREF(old);
   return 0;
 }
 
 static int
 Py_cvec_set_phas (Py_cvec * vec, PyObject *input, void * closure)
 {
+  PyObject *old;
   npy_intp length;
   if (!PyAubio_IsValidVector(input)) {
     return -1;
@@ -203,9 +238,12 @@ Py_cvec_set_phas (Py_cvec * vec, PyObject *input, void * closure)
     return -1;
   }
 
-  Py_XDECREF(vec->phas);
+  Py_INCREF(input);
+  Py_BEGIN_CRITICAL_SECTION(vec);
+  old = vec->phas;
   vec->phas = input;
-  Py_INCREF(vec->phas);
+  Py_END_CRITICAL_SECTION();
+  Py_XDECREF(old);
   return 0;
 }
 
@@ -24,6 +24,7 @@ typedef struct
 {
   PyObject_HEAD
   aubio_fft_t * o;
+  PyThread_type_lock lock;
   uint_t win_s;
   // do / rdo input vectors
   fvec_t vecin;
@@ -51,6 +52,12 @@ Py_fft_new (PyTypeObject * type, PyObject * args, PyObject * kwds)
     return NULL;
   }
 
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
   self->win_s = Py_default_vector_length;
 
   if (win_s > 0) {
@@ -88,20 +95,28 @@ Py_fft_del (Py_fft *self, PyObject *unused)
   if (self->o) {
     del_aubio_fft(self->o);
   }
+  if (self->lock) {
+    PyThread_free_lock(self->lock);
+  }
   Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
 static PyObject *
-Py_fft_do(Py_fft * self, PyObject * args)
+Py_fft_do(Py_fft * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *input;
+  static char *kwlist[] = { "input", "out", NULL };
+  PyObject *input, *output = NULL;
+  Py_buffer view;
   cvec_t c_out;
 
-  if (!PyArg_ParseTuple (args, "O", &input)) {
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O", kwlist,
+        &input, &output)) {
     return NULL;
   }
 
-  if (!PyAubio_ArrayToCFvec(input, &(self->vecin))) {
+  PyAubio_Lock(self->lock);
+  if (!PyAubio_ArrayToCFvecView (input, &(self->vecin), &view)) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -109,16 +124,34 @@ Py_fft_do(Py_fft * self, PyObject * args)
     PyErr_Format(PyExc_ValueError,
                  "input array has length %d, but fft expects length %d",
                  self->vecin.length, self->win_s);
+    PyBuffer_Release (&view);
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
-  Py_INCREF(self->doout);
-  if (!PyAubio_PyCvecToCCvec(self->doout, &c_out)) {
-    return NULL;
+  // results go to out if given, to self->doout otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_PyCvecToCCvecOut (output, self->win_s / 2 + 1, &c_out)) {
+      PyBuffer_Release (&view);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->doout;
+    if (!PyAubio_PyCvecToCCvec (output, &c_out)) {
+      PyBuffer_Release (&view);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
   }
   // compute the function
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_fft_do (self->o, &(self->vecin), &c_out);
-  return self->doout;
+  PyAubio_END_ALLOW_THREADS
+  PyBuffer_Release (&view);
+  PyAubio_Unlock(self->lock);
+  Py_INCREF(output);
+  return output;
 }
 
 static PyMemberDef Py_fft_members[] = {
@@ -128,16 +161,20 @@ static PyMemberDef Py_fft_members[] = {
 };
 
 static PyObject *
-Py_fft_rdo(Py_fft * self, PyObject * args)
+Py_fft_rdo(Py_fft * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *input;
+  static char *kwlist[] = { "fftgrain", "out", NULL };
+  PyObject *input, *output = NULL;
   fvec_t out;
 
-  if (!PyArg_ParseTuple (args, "O", &input)) {
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O", kwlist,
+        &input, &output)) {
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   if (!PyAubio_PyCvecToCCvec (input, &(self->cvecin)) ) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -145,21 +182,47 @@ Py_fft_rdo(Py_fft * self, PyObject * args)
     PyErr_Format(PyExc_ValueError,
                  "input cvec has length %d, but fft expects length %d",
                  self->cvecin.length, self->win_s / 2 + 1);
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
-  Py_INCREF(self->rdoout);
-  if (!PyAubio_ArrayToCFvec(self->rdoout, &out) ) {
-    return NULL;
+  // results go to out if given, to self->rdoout otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_ArrayToCFvecOut (output, self->win_s, &out)) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->rdoout;
+    if (!PyAubio_ArrayToCFvec (output, &out)) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
   }
   // compute the function
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_fft_rdo (self->o, &(self->cvecin), &out);
-  return self->rdoout;
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
+  Py_INCREF(output);
+  return output;
+}
+
+static PyObject *
+Py_fft_sizeof (Py_fft * self, PyObject *unused)
+{
+  Py_ssize_t size = Py_TYPE(self)->tp_basicsize;
+  PyAubio_Lock(self->lock);
+  size += aubio_fft_get_memory_usage (self->o);
+  PyAubio_Unlock(self->lock);
+  return PyLong_FromSsize_t (size);
 }
 
 static PyMethodDef Py_fft_methods[] = {
-  {"rdo", (PyCFunction) Py_fft_rdo, METH_VARARGS,
+  {"rdo", (PyCFunction) Py_fft_rdo, METH_VARARGS | METH_KEYWORDS,
     "synthesis of spectral grain"},
+  {"__sizeof__", (PyCFunction) Py_fft_sizeof, METH_NOARGS,
+    "size of the object in memory, in bytes"},
   {NULL}
 };
 
@@ -4,6 +4,7 @@ typedef struct
 {
   PyObject_HEAD
   aubio_filter_t * o;
+  PyThread_type_lock lock;
   uint_t order;
   fvec_t vec;
   PyObject *out;
@@ -21,8 +22,8 @@ static char Py_filter_set_c_weighting_doc[] = ""
 "\n"
 "Set filter coefficients to C-weighting.\n"
 "\n"
-"`samplerate` should be one of 8000, 11025, 16000, 22050, 24000, 32000,\n"
-"44100, 48000, 88200, 96000, or 192000. `order` of the filter should be 5.\n"
+"The coefficients are computed for any `samplerate`, which should\n"
+"normally be higher than 20000. `order` of the filter should be 5.\n"
 "\n"
 "Parameters\n"
 "----------\n"
@@ -35,8 +36,8 @@ static char Py_filter_set_a_weighting_doc[] = ""
 "\n"
 "Set filter coefficients to A-weighting.\n"
 "\n"
-"`samplerate` should be one of 8000, 11025, 16000, 22050, 24000, 32000,\n"
-"44100, 48000, 88200, 96000, or 192000. `order` of the filter should be 7.\n"
+"The coefficients are computed for any `samplerate`, which should\n"
+"normally be higher than 20000. `order` of the filter should be 7.\n"
 "\n"
 "Parameters\n"
 "----------\n"
@@ -81,6 +82,12 @@ Py_filter_new (PyTypeObject * type, PyObject * args, PyObject * kwds)
     return NULL;
   }
 
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
   self->order = 7;
 
   if (order > 0) {
@@ -111,15 +118,21 @@ Py_filter_del (Py_filter * self)
   Py_XDECREF(self->out);
   if (self->o)
     del_aubio_filter (self->o);
+  if (self->lock) {
+    PyThread_free_lock(self->lock);
+  }
   Py_TYPE(self)->tp_free ((PyObject *) self);
 }
 
 static PyObject *
-Py_filter_do(Py_filter * self, PyObject * args)
+Py_filter_do(Py_filter * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *input;
+  static char *kwlist[] = { "input", "out", NULL };
+  PyObject *input, *output = NULL;
+  Py_buffer view;
 
-  if (!PyArg_ParseTuple (args, "O:digital_filter.do", &input)) {
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O:digital_filter.do",
+        kwlist, &input, &output)) {
     return NULL;
   }
 
@@ -127,22 +140,39 @@ Py_filter_do(Py_filter * self, PyObject * args)
     return NULL;
   }
 
-  if (!PyAubio_ArrayToCFvec(input, &(self->vec))) {
+  PyAubio_Lock(self->lock);
+  if (!PyAubio_ArrayToCFvecView (input, &(self->vec), &view)) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
-  // initialize output now
-  if (self->out == NULL) {
-    self->out = new_py_fvec(self->vec.length);
-  }
-
-  Py_INCREF(self->out);
-  if (!PyAubio_ArrayToCFvec(self->out, &(self->c_out)) ) {
-    return NULL;
+  // results go to out if given, to self->out otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_ArrayToCFvecOut (output, self->vec.length, &(self->c_out))) {
+      PyBuffer_Release (&view);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    // initialize output now
+    if (self->out == NULL) {
+      self->out = new_py_fvec(self->vec.length);
+    }
+    output = self->out;
+    if (!PyAubio_ArrayToCFvec (output, &(self->c_out))) {
+      PyBuffer_Release (&view);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
   }
   // compute the function
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_filter_do_outplace (self->o, &(self->vec), &(self->c_out));
-  return self->out;
+  PyAubio_END_ALLOW_THREADS
+  PyBuffer_Release (&view);
+  PyAubio_Unlock(self->lock);
+  Py_INCREF(output);
+  return output;
 }
 
 static PyObject *
@@ -154,6 +184,7 @@ Py_filter_set_c_weighting (Py_filter * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   err = aubio_filter_set_c_weighting (self->o, samplerate);
   if (err > 0) {
     if (PyErr_Occurred() == NULL) {
@@ -168,8 +199,10 @@ Py_filter_set_c_weighting (Py_filter * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -182,6 +215,7 @@ Py_filter_set_a_weighting (Py_filter * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   err = aubio_filter_set_a_weighting (self->o, samplerate);
   if (err > 0) {
     if (PyErr_Occurred() == NULL) {
@@ -196,8 +230,10 @@ Py_filter_set_a_weighting (Py_filter * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -210,6 +246,7 @@ Py_filter_set_biquad(Py_filter * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   err = aubio_filter_set_biquad (self->o, b0, b1, b2, a1, a2);
   if (err > 0) {
     if (PyErr_Occurred() == NULL) {
@@ -224,11 +261,23 @@ Py_filter_set_biquad(Py_filter * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
+static PyObject *
+Py_filter_sizeof (Py_filter * self, PyObject *unused)
+{
+  Py_ssize_t size = Py_TYPE(self)->tp_basicsize;
+  PyAubio_Lock(self->lock);
+  size += aubio_filter_get_memory_usage (self->o);
+  PyAubio_Unlock(self->lock);
+  return PyLong_FromSsize_t (size);
+}
+
 static PyMemberDef Py_filter_members[] = {
   // TODO remove READONLY flag and define getter/setter
   {"order", T_INT, offsetof (Py_filter, order), READONLY,
@@ -243,6 +292,8 @@ static PyMethodDef Py_filter_methods[] = {
       Py_filter_set_a_weighting_doc},
   {"set_biquad", (PyCFunction) Py_filter_set_biquad, METH_VARARGS,
       Py_filter_set_biquad_doc},
+  {"__sizeof__", (PyCFunction) Py_filter_sizeof, METH_NOARGS,
+    "size of the object in memory, in bytes"},
   {NULL}
 };
 
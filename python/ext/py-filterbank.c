@@ -184,10 +184,47 @@ static char Py_filterbank_get_norm_doc[] = ""
 "    Norm parameter.\n"
 "";
 
+static char Py_filterbank_set_history_doc[] = ""
+"set_history(length)\n"
+"\n"
+"Keep the bands computed over the last frames.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"length : int\n"
+"    Number of frames to keep, or `0` to stop keeping them.\n"
+"";
+
+static char Py_filterbank_get_history_doc[] = ""
+"get_history()\n"
+"\n"
+"Get the number of frames kept by :meth:`get_bands_history`.\n"
+"\n"
+"Returns\n"
+"-------\n"
+"int\n"
+"    Length set with :meth:`set_history`, or `0`.\n"
+"";
+
+static char Py_filterbank_get_bands_history_doc[] = ""
+"get_bands_history()\n"
+"\n"
+"Get the bands of the last frames, oldest first.\n"
+"\n"
+"The array is a view of the memory of the filterbank, not a copy; it\n"
+"should be fetched again after each frame.\n"
+"\n"
+"Returns\n"
+"-------\n"
+"fmat\n"
+"    Array of shape (length, n_filters), or `None` if no history is kept.\n"
+"";
+
 typedef struct
 {
   PyObject_HEAD
   aubio_filterbank_t * o;
+  PyThread_type_lock lock;
   uint_t n_filters;
   uint_t win_s;
   cvec_t vec;
@@ -215,6 +252,12 @@ Py_filterbank_new (PyTypeObject * type, PyObject * args, PyObject * kwds)
     return NULL;
   }
 
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
   self->win_s = Py_default_vector_length;
   if (win_s > 0) {
     self->win_s = win_s;
@@ -257,20 +300,27 @@ Py_filterbank_del (Py_filterbank *self, PyObject *unused)
     free(self->coeffs.data);
     del_aubio_filterbank(self->o);
   }
+  if (self->lock) {
+    PyThread_free_lock(self->lock);
+  }
   Py_XDECREF(self->out);
   Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
 static PyObject *
-Py_filterbank_do(Py_filterbank * self, PyObject * args)
+Py_filterbank_do(Py_filterbank * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *input;
+  static char *kwlist[] = { "fftgrain", "out", NULL };
+  PyObject *input, *output = NULL;
 
-  if (!PyArg_ParseTuple (args, "O", &input)) {
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O", kwlist,
+        &input, &output)) {
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   if (!PyAubio_PyCvecToCCvec(input, &(self->vec) )) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -278,16 +328,30 @@ Py_filterbank_do(Py_filterbank * self, PyObject * args)
     PyErr_Format(PyExc_ValueError,
                  "input cvec has length %d, but filterbank expects length %d",
                  self->vec.length, self->win_s / 2 + 1);
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
-  Py_INCREF(self->out);
-  if (!PyAubio_ArrayToCFvec(self->out, &(self->c_out))) {
-    return NULL;
+  // results go to out if given, to self->out otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_ArrayToCFvecOut (output, self->n_filters, &(self->c_out))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->out;
+    if (!PyAubio_ArrayToCFvec (output, &(self->c_out))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
   }
   // compute the function
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_filterbank_do (self->o, &(self->vec), &(self->c_out));
-  return self->out;
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
+  Py_INCREF(output);
+  return output;
 }
 
 static PyMemberDef Py_filterbank_members[] = {
@@ -313,7 +377,9 @@ Py_filterbank_set_triangle_bands (Py_filterbank * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   if (!PyAubio_ArrayToCFvec(input, &(self->freqs) )) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -331,8 +397,10 @@ Py_filterbank_set_triangle_bands (Py_filterbank * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -346,6 +414,7 @@ Py_filterbank_set_mel_coeffs_slaney (Py_filterbank * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   err = aubio_filterbank_set_mel_coeffs_slaney (self->o, samplerate);
   if (err > 0) {
     if (PyErr_Occurred() == NULL) {
@@ -359,8 +428,10 @@ Py_filterbank_set_mel_coeffs_slaney (Py_filterbank * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -377,6 +448,7 @@ Py_filterbank_set_mel_coeffs (Py_filterbank * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   err = aubio_filterbank_set_mel_coeffs (self->o, samplerate,
       freq_min, freq_max);
   if (err > 0) {
@@ -391,8 +463,10 @@ Py_filterbank_set_mel_coeffs (Py_filterbank * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -409,6 +483,7 @@ Py_filterbank_set_mel_coeffs_htk (Py_filterbank * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   err = aubio_filterbank_set_mel_coeffs_htk (self->o, samplerate,
       freq_min, freq_max);
   if (err > 0) {
@@ -423,8 +498,10 @@ Py_filterbank_set_mel_coeffs_htk (Py_filterbank * self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -438,7 +515,9 @@ Py_filterbank_set_coeffs (Py_filterbank * self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   if (!PyAubio_ArrayToCFmat(input, &(self->coeffs))) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -447,16 +526,22 @@ Py_filterbank_set_coeffs (Py_filterbank * self, PyObject *args)
   if (err > 0) {
     PyErr_SetString (PyExc_ValueError,
         "error when setting filter coefficients");
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
 static PyObject *
 Py_filterbank_get_coeffs (Py_filterbank * self, PyObject *unused)
 {
-  return (PyObject *)PyAubio_CFmatToArray(
+  PyObject *coeffs;
+  PyAubio_Lock(self->lock);
+  coeffs = (PyObject *)PyAubio_CFmatToArray(
       aubio_filterbank_get_coeffs (self->o) );
+  PyAubio_Unlock(self->lock);
+  return coeffs;
 }
 
 static PyObject *
@@ -467,6 +552,7 @@ Py_filterbank_set_power(Py_filterbank *self, PyObject *args)
   if (!PyArg_ParseTuple (args, AUBIO_NPY_SMPL_CHR, &power)) {
     return NULL;
   }
+  PyAubio_Lock(self->lock);
   if(aubio_filterbank_set_power (self->o, power)) {
     if (PyErr_Occurred() == NULL) {
       PyErr_SetString (PyExc_ValueError,
@@ -480,15 +566,20 @@ Py_filterbank_set_power(Py_filterbank *self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
 static PyObject *
 Py_filterbank_get_power (Py_filterbank * self, PyObject *unused)
 {
-  smpl_t power = aubio_filterbank_get_power(self->o);
+  smpl_t power;
+  PyAubio_Lock(self->lock);
+  power = aubio_filterbank_get_power(self->o);
+  PyAubio_Unlock(self->lock);
   return (PyObject *)PyFloat_FromDouble (power);
 }
 
@@ -500,6 +591,7 @@ Py_filterbank_set_norm(Py_filterbank *self, PyObject *args)
   if (!PyArg_ParseTuple (args, AUBIO_NPY_SMPL_CHR, &norm)) {
     return NULL;
   }
+  PyAubio_Lock(self->lock);
   if(aubio_filterbank_set_norm (self->o, norm)) {
     if (PyErr_Occurred() == NULL) {
       PyErr_SetString (PyExc_ValueError,
@@ -513,18 +605,90 @@ Py_filterbank_set_norm(Py_filterbank *self, PyObject *args)
       Py_XINCREF(type);
       PyErr_Restore(type, value, traceback);
     }
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
 static PyObject *
 Py_filterbank_get_norm (Py_filterbank * self, PyObject *unused)
 {
-  smpl_t norm = aubio_filterbank_get_norm(self->o);
+  smpl_t norm;
+  PyAubio_Lock(self->lock);
+  norm = aubio_filterbank_get_norm(self->o);
+  PyAubio_Unlock(self->lock);
   return (PyObject *)PyFloat_FromDouble (norm);
 }
 
+static PyObject *
+Py_filterbank_set_history (Py_filterbank * self, PyObject *args)
+{
+  uint_t length;
+  uint_t err;
+  if (!PyArg_ParseTuple (args, "I", &length)) {
+    return NULL;
+  }
+  PyAubio_Lock(self->lock);
+  err = aubio_filterbank_set_history (self->o, length);
+  PyAubio_Unlock(self->lock);
+  if (err) {
+    PyErr_SetString (PyExc_MemoryError, "failed allocating history");
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *
+Py_filterbank_get_history (Py_filterbank * self, PyObject *unused)
+{
+  uint_t length;
+  PyAubio_Lock(self->lock);
+  length = aubio_filterbank_get_history (self->o);
+  PyAubio_Unlock(self->lock);
+  return PyLong_FromLong (length);
+}
+
+static PyObject *
+Py_filterbank_get_bands_history (Py_filterbank * self, PyObject *unused)
+{
+  const fmat_t *history;
+  PyObject *view;
+  npy_intp dims[2];
+  PyAubio_Lock(self->lock);
+  history = aubio_filterbank_get_bands_history (self->o);
+  PyAubio_Unlock(self->lock);
+  if (!history) {
+    Py_RETURN_NONE;
+  }
+  // the rows of the history follow each other in memory
+  dims[0] = history->height;
+  dims[1] = history->length;
+  view = PyArray_SimpleNewFromData (2, dims, AUBIO_NPY_SMPL,
+      history->data[0]);
+  if (!view) {
+    return NULL;
+  }
+  // keep the filterbank alive as long as the view
+  Py_INCREF (self);
+  if (PyArray_SetBaseObject ((PyArrayObject *)view, (PyObject *)self) < 0) {
+    Py_DECREF (view);
+    return NULL;
+  }
+  return view;
+}
+
+static PyObject *
+Py_filterbank_sizeof (Py_filterbank * self, PyObject *unused)
+{
+  Py_ssize_t size = Py_TYPE(self)->tp_basicsize;
+  PyAubio_Lock(self->lock);
+  size += aubio_filterbank_get_memory_usage (self->o);
+  PyAubio_Unlock(self->lock);
+  return PyLong_FromSsize_t (size);
+}
+
 static PyMethodDef Py_filterbank_methods[] = {
   {"set_triangle_bands", (PyCFunction) Py_filterbank_set_triangle_bands,
     METH_VARARGS, Py_filterbank_set_triangle_bands_doc},
@@ -546,6 +710,14 @@ static PyMethodDef Py_filterbank_methods[] = {
     METH_VARARGS, Py_filterbank_set_norm_doc},
   {"get_norm", (PyCFunction) Py_filterbank_get_norm,
     METH_NOARGS, Py_filterbank_get_norm_doc},
+  {"set_history", (PyCFunction) Py_filterbank_set_history,
+    METH_VARARGS, Py_filterbank_set_history_doc},
+  {"get_history", (PyCFunction) Py_filterbank_get_history,
+    METH_NOARGS, Py_filterbank_get_history_doc},
+  {"get_bands_history", (PyCFunction) Py_filterbank_get_bands_history,
+    METH_NOARGS, Py_filterbank_get_bands_history_doc},
+  {"__sizeof__", (PyCFunction) Py_filterbank_sizeof, METH_NOARGS,
+    "size of the object in memory, in bytes"},
   {NULL}
 };
 
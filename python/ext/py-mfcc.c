@@ -0,0 +1,141 @@
+#include "aubio-types.h"
+
+static char Py_mfcc_compute_doc[] = ""
+"compute(source, buf_size=1024, n_filters=40, n_coeffs=13, deltas=0,\n"
+"        delta_width=2)\n"
+"\n"
+"Compute the MFCC coefficients of all the blocks read from a source.\n"
+"\n"
+"The whole loop, reading blocks of `source.hop_size` samples,\n"
+"computing their spectrum and their coefficients, runs without\n"
+"returning to Python, which is much faster than calling\n"
+":class:`pvoc` and :class:`mfcc` on each block.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"source : source\n"
+"    Source to read from, until its end.\n"
+"buf_size : int\n"
+"    Size of the analysis window.\n"
+"n_filters : int\n"
+"    Number of mel filters.\n"
+"n_coeffs : int\n"
+"    Number of coefficients to compute for each block.\n"
+"deltas : int\n"
+"    1 to append the deltas of the coefficients to each row, 2 to append\n"
+"    their deltas and delta-deltas.\n"
+"delta_width : int\n"
+"    Half length of the regression window of the deltas, in blocks.\n"
+"\n"
+"Returns\n"
+"-------\n"
+"numpy.ndarray\n"
+"    Coefficients, one row of length `n_coeffs * (deltas + 1)` per block.\n"
+"    With deltas, the rows are delayed by `deltas * delta_width` blocks,\n"
+"    the first block being repeated before the start of the source.\n"
+"\n"
+"Examples\n"
+"--------\n"
+">>> src = aubio.source('stereo.wav', hop_size=512)\n"
+">>> coeffs = aubio.mfcc.compute(src, buf_size=1024)\n"
+">>> coeffs.shape\n"
+"(170, 13)\n"
+"";
+
+static PyObject *
+Py_mfcc_compute (PyObject *unused, PyObject *args, PyObject *kwds)
+{
+  static char *kwlist[] = { "source", "buf_size", "n_filters", "n_coeffs",
+    "deltas", "delta_width", NULL };
+  PyObject *py_source, *chunks = NULL, *chunk = NULL, *result = NULL;
+  uint_t buf_size = 1024, n_filters = 40, n_coeffs = 13;
+  uint_t deltas = 0, delta_width = 2;
+  uint_t hop_size, n_frames = 0, height;
+  aubio_source_t *source;
+  PyThread_type_lock lock;
+  aubio_mfcc_t *mfcc = NULL;
+  uint_t err;
+  fmat_t frames = { 0, 0, NULL };
+
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|IIIII", kwlist,
+        &py_source, &buf_size, &n_filters, &n_coeffs, &deltas, &delta_width)) {
+    return NULL;
+  }
+  source = PyAubio_PySourceToCSource (py_source, &hop_size, &lock);
+  if (!source) {
+    return NULL;
+  }
+  // keep other threads away from the source until the end
+  PyAubio_Lock (lock);
+  mfcc = new_aubio_mfcc (buf_size, n_filters, n_coeffs,
+      aubio_source_get_samplerate (source));
+  if (!mfcc) {
+    PyErr_SetString (PyExc_ValueError, "failed creating mfcc");
+    goto beach;
+  }
+  if (aubio_mfcc_set_deltas (mfcc, deltas, delta_width)) {
+    PyErr_SetString (PyExc_ValueError, "failed setting mfcc deltas");
+    goto beach;
+  }
+  chunks = PyList_New (0);
+  if (!chunks) goto beach;
+
+  // enough rows for the whole source, unless its duration is unknown
+  height = aubio_source_get_duration (source) / hop_size + 1;
+  if (height < 64) height = 64;
+  do {
+    Py_XDECREF (chunk);
+    chunk = new_py_fmat (height, n_coeffs * (deltas + 1));
+    if (!chunk || !PyAubio_ArrayToCFmat (chunk, &frames)) goto beach;
+    PyAubio_BEGIN_ALLOW_THREADS
+    err = aubio_mfcc_do_batch (mfcc, source, hop_size, &frames, &n_frames);
+    PyAubio_END_ALLOW_THREADS
+    if (err) {
+      PyErr_SetString (PyExc_RuntimeError, "failed computing mfcc");
+      goto beach;
+    }
+    if (n_frames < height) {
+      PyObject *rows = PySequence_GetSlice (chunk, 0, n_frames);
+      Py_DECREF (chunk);
+      chunk = rows;
+      if (!chunk) goto beach;
+    }
+    if (PyList_Append (chunks, chunk) < 0) goto beach;
+  } while (n_frames == height);
+
+  if (PyList_GET_SIZE (chunks) == 1) {
+    result = PyList_GET_ITEM (chunks, 0);
+    Py_INCREF (result);
+  } else {
+    result = PyArray_Concatenate (chunks, 0);
+  }
+
+beach:
+  PyAubio_Unlock (lock);
+  Py_XDECREF (chunk);
+  Py_XDECREF (chunks);
+  if (frames.data) free (frames.data);
+  if (mfcc) del_aubio_mfcc (mfcc);
+  return result;
+}
+
+static PyMethodDef Py_mfcc_compute_def = {
+  "compute", (PyCFunction) Py_mfcc_compute, METH_VARARGS | METH_KEYWORDS,
+  Py_mfcc_compute_doc
+};
+
+int
+add_mfcc_methods (void)
+{
+  int err;
+  PyObject *func, *method;
+  func = PyCFunction_New (&Py_mfcc_compute_def, NULL);
+  if (!func) return -1;
+  method = PyStaticMethod_New (func);
+  Py_DECREF (func);
+  if (!method) return -1;
+  err = PyDict_SetItemString (Py_mfccType.tp_dict, "compute", method);
+  Py_DECREF (method);
+  PyType_Modified (&Py_mfccType);
+  return err;
+}
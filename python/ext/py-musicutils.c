@@ -235,3 +235,30 @@ Py_aubio_meltohz_htk(PyObject *self, PyObject *args)
   }
   return PyFloat_FromDouble(aubio_meltohz_htk(v));
 }
+
+PyObject*
+Py_aubio_find_peaks(PyObject *self, PyObject *args, PyObject *kwds)
+{
+  PyObject *input, *output, *peaks;
+  fvec_t vec, out;
+  smpl_t threshold = 0.;
+  uint_t min_distance = 0, n;
+  static char *kwlist[] = {"x", "threshold", "min_distance", NULL};
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|" AUBIO_NPY_SMPL_CHR "I",
+        kwlist, &input, &threshold, &min_distance)) {
+    return NULL;
+  }
+  if (!PyAubio_ArrayToCFvec(input, &vec)) {
+    return NULL;
+  }
+  // large enough for all the peaks
+  output = new_py_fvec(vec.length / 2 + 1);
+  if (output == NULL || !PyAubio_ArrayToCFvec(output, &out)) {
+    Py_XDECREF(output);
+    return NULL;
+  }
+  n = fvec_find_peaks(&vec, threshold, min_distance, &out);
+  peaks = PySequence_GetSlice(output, 0, n);
+  Py_DECREF(output);
+  return peaks;
+}
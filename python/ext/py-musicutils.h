@@ -368,4 +368,34 @@ static char Py_aubio_meltohz_htk_doc[] = ""
 "";
 PyObject * Py_aubio_meltohz_htk(PyObject *self, PyObject *args);
 
+static char Py_aubio_find_peaks_doc[] = ""
+"find_peaks(x, threshold=0., min_distance=0)\n"
+"\n"
+"Find all the peaks of a vector.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"x : fvec\n"
+"   input vector\n"
+"threshold : float\n"
+"   value the peaks must be above\n"
+"min_distance : int\n"
+"   minimum distance between two peaks, in elements; of the peaks closer\n"
+"   than this, only the highest is kept\n"
+"\n"
+"Returns\n"
+"-------\n"
+"fvec\n"
+"   Position of each element of `x` above both its neighbours and\n"
+"   `threshold`, refined by quadratic interpolation.\n"
+"\n"
+"Example\n"
+"-------\n"
+"\n"
+">>> aubio.find_peaks(aubio.fvec([0, 1, 0, 0, 2, 0]))\n"
+"array([1., 4.], dtype=" AUBIO_NPY_SMPL_STR ")\n"
+"";
+PyObject * Py_aubio_find_peaks(PyObject *self, PyObject *args,
+    PyObject *kwds);
+
 #endif /* PY_AUBIO_MUSICUTILS_H */
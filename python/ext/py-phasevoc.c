@@ -58,6 +58,7 @@ typedef struct
 {
   PyObject_HEAD
   aubio_pvoc_t * o;
+  PyThread_type_lock lock;
   uint_t win_s;
   uint_t hop_s;
   fvec_t vecin;
@@ -87,6 +88,12 @@ Py_pvoc_new (PyTypeObject * type, PyObject * args, PyObject * kwds)
     return NULL;
   }
 
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
   self->win_s = Py_default_vector_length;
   self->hop_s = Py_default_vector_length/2;
 
@@ -134,20 +141,28 @@ Py_pvoc_del (Py_pvoc *self, PyObject *unused)
   if (self->o) {
     del_aubio_pvoc(self->o);
   }
+  if (self->lock) {
+    PyThread_free_lock(self->lock);
+  }
   Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
 
 static PyObject *
-Py_pvoc_do(Py_pvoc * self, PyObject * args)
+Py_pvoc_do(Py_pvoc * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *input;
+  static char *kwlist[] = { "input", "out", NULL };
+  PyObject *input, *output = NULL;
+  Py_buffer view;
 
-  if (!PyArg_ParseTuple (args, "O", &input)) {
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O", kwlist,
+        &input, &output)) {
     return NULL;
   }
 
-  if (!PyAubio_ArrayToCFvec (input, &(self->vecin) )) {
+  PyAubio_Lock(self->lock);
+  if (!PyAubio_ArrayToCFvecView (input, &(self->vecin), &view)) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -155,16 +170,35 @@ Py_pvoc_do(Py_pvoc * self, PyObject * args)
     PyErr_Format(PyExc_ValueError,
                  "input fvec has length %d, but pvoc expects length %d",
                  self->vecin.length, self->hop_s);
+    PyBuffer_Release (&view);
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
-  Py_INCREF(self->output);
-  if (!PyAubio_PyCvecToCCvec (self->output, &(self->c_output))) {
-    return NULL;
+  // results go to out if given, to self->output otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_PyCvecToCCvecOut (output, self->win_s / 2 + 1,
+          &(self->c_output))) {
+      PyBuffer_Release (&view);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->output;
+    if (!PyAubio_PyCvecToCCvec (output, &(self->c_output))) {
+      PyBuffer_Release (&view);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
   }
   // compute the function
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_pvoc_do (self->o, &(self->vecin), &(self->c_output));
-  return self->output;
+  PyAubio_END_ALLOW_THREADS
+  PyBuffer_Release (&view);
+  PyAubio_Unlock(self->lock);
+  Py_INCREF(output);
+  return output;
 }
 
 static PyMemberDef Py_pvoc_members[] = {
@@ -178,14 +212,18 @@ static PyMemberDef Py_pvoc_members[] = {
 };
 
 static PyObject *
-Py_pvoc_rdo(Py_pvoc * self, PyObject * args)
+Py_pvoc_rdo(Py_pvoc * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *input;
-  if (!PyArg_ParseTuple (args, "O", &input)) {
+  static char *kwlist[] = { "fftgrain", "out", NULL };
+  PyObject *input, *output = NULL;
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O", kwlist,
+        &input, &output)) {
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
   if (!PyAubio_PyCvecToCCvec (input, &(self->cvecin) )) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
@@ -193,16 +231,30 @@ Py_pvoc_rdo(Py_pvoc * self, PyObject * args)
     PyErr_Format(PyExc_ValueError,
                  "input cvec has length %d, but pvoc expects length %d",
                  self->cvecin.length, self->win_s / 2 + 1);
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
-  Py_INCREF(self->routput);
-  if (!PyAubio_ArrayToCFvec(self->routput, &(self->c_routput)) ) {
-    return NULL;
+  // results go to out if given, to self->routput otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_ArrayToCFvecOut (output, self->hop_s, &(self->c_routput))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->routput;
+    if (!PyAubio_ArrayToCFvec (output, &(self->c_routput))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
   }
   // compute the function
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_pvoc_rdo (self->o, &(self->cvecin), &(self->c_routput));
-  return self->routput;
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
+  Py_INCREF(output);
+  return output;
 }
 
 static PyObject *
@@ -214,7 +266,9 @@ Pyaubio_pvoc_set_window (Py_pvoc *self, PyObject *args)
   if (!PyArg_ParseTuple (args, "s", &window)) {
     return NULL;
   }
+  PyAubio_Lock(self->lock);
   err = aubio_pvoc_set_window (self->o, window);
+  PyAubio_Unlock(self->lock);
 
   if (err > 0) {
     PyErr_SetString (PyExc_ValueError, "error running aubio_pvoc_set_window");
@@ -223,9 +277,19 @@ Pyaubio_pvoc_set_window (Py_pvoc *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *
+Py_pvoc_sizeof (Py_pvoc * self, PyObject *unused)
+{
+  Py_ssize_t size = Py_TYPE(self)->tp_basicsize;
+  PyAubio_Lock(self->lock);
+  size += aubio_pvoc_get_memory_usage (self->o);
+  PyAubio_Unlock(self->lock);
+  return PyLong_FromSsize_t (size);
+}
+
 static PyMethodDef Py_pvoc_methods[] = {
-  {"rdo", (PyCFunction) Py_pvoc_rdo, METH_VARARGS,
-    "rdo(fftgrain)\n"
+  {"rdo", (PyCFunction) Py_pvoc_rdo, METH_VARARGS | METH_KEYWORDS,
+    "rdo(fftgrain, out=None)\n"
     "\n"
     "Read a new spectral grain and resynthesise the next `hop_s`\n"
     "output samples.\n"
@@ -234,6 +298,8 @@ static PyMethodDef Py_pvoc_methods[] = {
     "----------\n"
     "fftgrain : cvec\n"
     "    new input `cvec` to synthesize from, should be of size `win_s/2+1`\n"
+    "out : fvec, optional\n"
+    "    contiguous array of shape `(hop_s,)` to write the output to\n"
     "\n"
     "Returns\n"
     "-------\n"
@@ -266,6 +332,8 @@ static PyMethodDef Py_pvoc_methods[] = {
     "--------\n"
     "window : create a window.\n"
     ""},
+  {"__sizeof__", (PyCFunction) Py_pvoc_sizeof, METH_NOARGS,
+    "size of the object in memory, in bytes"},
   {NULL}
 };
 
@@ -4,6 +4,7 @@ typedef struct
 {
   PyObject_HEAD
   aubio_sink_t * o;
+  PyThread_type_lock lock;
   char_t* uri;
   uint_t samplerate;
   uint_t channels;
@@ -105,6 +106,12 @@ Py_sink_new (PyTypeObject * pytype, PyObject * args, PyObject * kwds)
     return NULL;
   }
 
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
   self->uri = NULL;
   if (uri != NULL) {
     self->uri = (char_t *)malloc(sizeof(char_t) * (strnlen(uri, PATH_MAX) + 1));
@@ -157,6 +164,9 @@ Py_sink_del (Py_sink *self, PyObject *unused)
   if (self->uri) {
     free(self->uri);
   }
+  if (self->lock) {
+    PyThread_free_lock(self->lock);
+  }
   Py_TYPE(self)->tp_free((PyObject *) self);
 }
 
@@ -166,6 +176,7 @@ Py_sink_do(Py_sink * self, PyObject * args)
 {
   /* input vectors python prototypes */
   PyObject * write_data_obj;
+  Py_buffer view;
 
   /* input vectors prototypes */
   uint_t write;
@@ -176,14 +187,20 @@ Py_sink_do(Py_sink * self, PyObject * args)
   }
 
   /* input vectors parsing */
-  if (!PyAubio_ArrayToCFvec(write_data_obj, &(self->write_data))) {
+  PyAubio_Lock(self->lock);
+  if (!PyAubio_ArrayToCFvecView (write_data_obj, &(self->write_data), &view)) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
 
   /* compute _do function */
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_sink_do (self->o, &(self->write_data), write);
+  PyAubio_END_ALLOW_THREADS
+  PyBuffer_Release (&view);
 
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -204,12 +221,17 @@ Py_sink_do_multi(Py_sink * self, PyObject * args)
 
 
   /* input vectors parsing */
+  PyAubio_Lock(self->lock);
   if (!PyAubio_ArrayToCFmat(write_data_obj, &(self->mwrite_data))) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
   /* compute _do function */
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_sink_do_multi (self->o, &(self->mwrite_data), write);
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
@@ -226,7 +248,11 @@ static PyMemberDef Py_sink_members[] = {
 static PyObject *
 Pyaubio_sink_close (Py_sink *self, PyObject *unused)
 {
+  PyAubio_Lock(self->lock);
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_sink_close (self->o);
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
   Py_RETURN_NONE;
 }
 
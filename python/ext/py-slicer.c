@@ -0,0 +1,147 @@
+#include "aubio-types.h"
+
+char Py_aubio_slice_frames_doc[] = ""
+"slice_frames(source_file, starts, ends, paths, samplerate=0,\n"
+"             hop_size=256)\n"
+"\n"
+"Write slices of a sound file, reading it only once.\n"
+"\n"
+"Each slice is written to a new file while the source is read, on its\n"
+"own thread, so that overlapping slices are written concurrently.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"source_file : str\n"
+"   path of the file to slice\n"
+"starts : list of int\n"
+"   first frame of each slice\n"
+"ends : list of int\n"
+"   frame following the last frame of each slice, or a large number\n"
+"   to stop at the end of the file\n"
+"paths : list of str\n"
+"   path of the file to write each slice to\n"
+"samplerate : int, optional\n"
+"   samplerate to read the file at, 0 to use its own\n"
+"hop_size : int, optional\n"
+"   number of frames read by the source at a time\n"
+"\n"
+"Returns\n"
+"-------\n"
+"int\n"
+"   number of slices that could not be written\n"
+"\n"
+"Notes\n"
+"-----\n"
+"Slices starting after the end of the file are not written. A slice\n"
+"ending before its start is written as an empty file.\n"
+"\n"
+"See Also\n"
+"--------\n"
+"slice_source_at_stamps\n"
+"\n"
+"Examples\n"
+"--------\n"
+"Write the first second and the rest of `loop.wav`:\n"
+"\n"
+">>> aubio.slice_frames('loop.wav', [0, 44100], [44100, 2**32],\n"
+"...     ['start.wav', 'end.wav'])\n"
+"0\n"
+"";
+
+// convert a sequence of frame positions, clipped to the range of uint_t
+static uint_t *
+Py_aubio_slicer_positions (PyObject *seq, Py_ssize_t n, const char *msg)
+{
+  Py_ssize_t i;
+  double pos;
+  uint_t *positions;
+  if (PySequence_Fast_GET_SIZE (seq) != n) {
+    PyErr_SetString (PyExc_ValueError, msg);
+    return NULL;
+  }
+  positions = (uint_t *)calloc (n ? n : 1, sizeof(uint_t));
+  if (!positions) {
+    PyErr_NoMemory ();
+    return NULL;
+  }
+  for (i = 0; i < n; i++) {
+    pos = PyFloat_AsDouble (PySequence_Fast_GET_ITEM (seq, i));
+    if (pos == -1. && PyErr_Occurred ()) {
+      free (positions);
+      return NULL;
+    }
+    positions[i] = (pos <= 0.) ? 0 : (pos >= (double)UINT_MAX) ? UINT_MAX
+      : (uint_t)pos;
+  }
+  return positions;
+}
+
+PyObject *
+Py_aubio_slice_frames (PyObject *self, PyObject *args, PyObject *kwds)
+{
+  static char *kwlist[] = { "source_file", "starts", "ends", "paths",
+    "samplerate", "hop_size", NULL };
+  PyObject *starts = NULL, *ends = NULL, *paths = NULL;
+  PyObject *seq_starts = NULL, *seq_ends = NULL, *seq_paths = NULL;
+  char_t *uri = NULL;
+  uint_t samplerate = 0, hop_size = 256, failed = 0;
+  uint_t *c_starts = NULL, *c_ends = NULL;
+  const char_t **c_paths = NULL;
+  Py_ssize_t i, n_slices;
+  aubio_slicer_t *o = NULL;
+
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "sOOO|II", kwlist,
+        &uri, &starts, &ends, &paths, &samplerate, &hop_size)) {
+    return NULL;
+  }
+  seq_paths = PySequence_Fast (paths, "paths should be a list of paths");
+  if (!seq_paths) goto beach;
+  seq_starts = PySequence_Fast (starts, "starts should be a list");
+  if (!seq_starts) goto beach;
+  seq_ends = PySequence_Fast (ends, "ends should be a list");
+  if (!seq_ends) goto beach;
+  n_slices = PySequence_Fast_GET_SIZE (seq_paths);
+  c_starts = Py_aubio_slicer_positions (seq_starts, n_slices,
+      "starts and paths should have the same length");
+  if (!c_starts) goto beach;
+  c_ends = Py_aubio_slicer_positions (seq_ends, n_slices,
+      "ends and paths should have the same length");
+  if (!c_ends) goto beach;
+  c_paths = (const char_t **)calloc (n_slices ? n_slices : 1,
+      sizeof(char_t *));
+  if (!c_paths) {
+    PyErr_NoMemory ();
+    goto beach;
+  }
+  for (i = 0; i < n_slices; i++) {
+    // seq_paths holds the strings until the end of the call
+    c_paths[i] = PyUnicode_AsUTF8 (PySequence_Fast_GET_ITEM (seq_paths, i));
+    if (!c_paths[i]) goto beach;
+  }
+
+  o = new_aubio_slicer (uri, samplerate, hop_size);
+  if (!o) {
+    // the log function already raised an exception
+    if (!PyErr_Occurred ()) {
+      PyErr_Format (PyExc_RuntimeError, "failed opening %s", uri);
+    }
+    goto beach;
+  }
+
+  // the sinks report their errors from their own threads, the errors logged
+  // meanwhile are written to stderr, see aubio_log_function
+  Py_BEGIN_ALLOW_THREADS
+  failed = aubio_slicer_do (o, c_starts, c_ends, c_paths, (uint_t)n_slices);
+  Py_END_ALLOW_THREADS
+
+beach:
+  if (o) del_aubio_slicer (o);
+  free (c_starts);
+  free (c_ends);
+  free (c_paths);
+  Py_XDECREF (seq_starts);
+  Py_XDECREF (seq_ends);
+  Py_XDECREF (seq_paths);
+  if (PyErr_Occurred ()) return NULL;
+  return PyLong_FromLong (failed);
+}
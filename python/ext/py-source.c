@@ -4,7 +4,9 @@ typedef struct
 {
   PyObject_HEAD
   aubio_source_t * o;
+  PyThread_type_lock lock;
   char_t* uri;
+  char_t* format;
   uint_t samplerate;
   uint_t channels;
   uint_t hop_size;
@@ -16,7 +18,7 @@ typedef struct
 } Py_source;
 
 static char Py_source_doc[] = ""
-"source(path, samplerate=0, hop_size=512, channels=0)\n"
+"source(path, samplerate=0, hop_size=512, channels=0, format=None)\n"
 "\n"
 "Read audio samples from a media file.\n"
 "\n"
@@ -35,6 +37,11 @@ static char Py_source_doc[] = ""
 "If `path` is a URL, a remote connection will be attempted to\n"
 "open the resource and stream data from it.\n"
 "\n"
+"If `format` is given, `path` is read as raw interleaved samples\n"
+"without header, `-` reading them from the standard input. The\n"
+"`samplerate` and the number of `channels` of the samples must\n"
+"then be given too.\n"
+"\n"
 "The parameter `hop_size` determines how many samples should be\n"
 "read at each consecutive calls.\n"
 "\n"
@@ -48,6 +55,9 @@ static char Py_source_doc[] = ""
 "   number of samples to be read per iteration\n"
 "channels : int, optional\n"
 "   number of channels of the file\n"
+"format : str, optional\n"
+"   format of raw samples, one of `u8`, `s16`, `s24`, `s32`, `f32`\n"
+"   or `f64`, all little-endian\n"
 "\n"
 "Examples\n"
 "--------\n"
@@ -238,13 +248,19 @@ static char Py_source_get_channels_doc[] = ""
 "";
 
 static char Py_source_do_doc[] = ""
-"source.do()\n"
+"source.do(out=None)\n"
 "\n"
 "Read vector of audio samples.\n"
 "\n"
 "If the audio stream in the source has more than one channel,\n"
 "the channels will be down-mixed.\n"
 "\n"
+"Parameters\n"
+"----------\n"
+"out : numpy.ndarray, optional\n"
+"    contiguous array of shape `(hop_size,)` to read the samples\n"
+"    into, instead of the array owned by the source\n"
+"\n"
 "Returns\n"
 "-------\n"
 "samples : numpy.ndarray\n"
@@ -267,7 +283,7 @@ static char Py_source_do_doc[] = ""
 "";
 
 static char Py_source_do_multi_doc[] = ""
-"do_multi()\n"
+"do_multi(out=None)\n"
 "\n"
 "Read multiple channels of audio samples.\n"
 "\n"
@@ -281,6 +297,12 @@ static char Py_source_do_multi_doc[] = ""
 "of channel in the original stream, the first channels will\n"
 "be duplicated on the additional output channel.\n"
 "\n"
+"Parameters\n"
+"----------\n"
+"out : numpy.ndarray, optional\n"
+"    contiguous array of shape `(channels, hop_size)` to read the\n"
+"    samples into, instead of the array owned by the source\n"
+"\n"
 "Returns\n"
 "-------\n"
 "samples : numpy.ndarray\n"
@@ -327,18 +349,43 @@ static char Py_source_seek_doc[] = ""
 "   position to seek to, in samples\n"
 "";
 
+static char Py_source_set_range_doc[] = ""
+"set_range(start, end=0)\n"
+"\n"
+"Only read a region of the file.\n"
+"\n"
+"Seeks to `start`, then stops reading at `end`: the block reaching it\n"
+"is truncated, and nothing more is decoded afterwards.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"start : int\n"
+"   first frame to read\n"
+"end : int, optional\n"
+"   frame to stop reading at, or 0 to read up to the end of the file\n"
+"\n"
+"Example\n"
+"-------\n"
+">>> src = aubio.source('track.wav')\n"
+">>> # 30 seconds from the middle of the track\n"
+">>> start = src.duration // 2\n"
+">>> src.set_range(start, start + 30 * src.samplerate)\n"
+"";
+
 static PyObject *
 Py_source_new (PyTypeObject * pytype, PyObject * args, PyObject * kwds)
 {
   Py_source *self;
   char_t* uri = NULL;
+  char_t* format = NULL;
   uint_t samplerate = 0;
   uint_t hop_size = 0;
   uint_t channels = 0;
-  static char *kwlist[] = { "uri", "samplerate", "hop_size", "channels", NULL };
+  static char *kwlist[] = { "uri", "samplerate", "hop_size", "channels",
+    "format", NULL };
 
-  if (!PyArg_ParseTupleAndKeywords (args, kwds, "|sIII", kwlist,
-          &uri, &samplerate, &hop_size, &channels)) {
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "|sIIIz", kwlist,
+          &uri, &samplerate, &hop_size, &channels, &format)) {
     return NULL;
   }
 
@@ -348,12 +395,24 @@ Py_source_new (PyTypeObject * pytype, PyObject * args, PyObject * kwds)
     return NULL;
   }
 
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
   self->uri = NULL;
   if (uri != NULL) {
     self->uri = (char_t *)malloc(sizeof(char_t) * (strnlen(uri, PATH_MAX) + 1));
     strncpy(self->uri, uri, strnlen(uri, PATH_MAX) + 1);
   }
 
+  self->format = NULL;
+  if (format != NULL) {
+    self->format = (char_t *)malloc(sizeof(char_t) * (strlen(format) + 1));
+    strcpy(self->format, format);
+  }
+
   self->samplerate = 0;
   if ((sint_t)samplerate > 0) {
     self->samplerate = samplerate;
@@ -387,7 +446,17 @@ Py_source_new (PyTypeObject * pytype, PyObject * args, PyObject * kwds)
 static int
 Py_source_init (Py_source * self, PyObject * args, PyObject * kwds)
 {
-  self->o = new_aubio_source ( self->uri, self->samplerate, self->hop_size );
+  if (self->format) {
+    if (self->samplerate == 0 || self->channels == 0) {
+      PyErr_SetString (PyExc_ValueError,
+          "samplerate and channels are required to read raw samples");
+      return -1;
+    }
+    self->o = new_aubio_source_raw ( self->uri, self->format,
+        self->samplerate, self->channels, self->hop_size );
+  } else {
+    self->o = new_aubio_source ( self->uri, self->samplerate, self->hop_size );
+  }
   if (self->o == NULL) {
     // PyErr_Format(PyExc_RuntimeError, ...) was set above by new_ which called
     // AUBIO_ERR when failing
@@ -415,6 +484,12 @@ Py_source_del (Py_source *self, PyObject *unused)
   if (self->uri) {
     free(self->uri);
   }
+  if (self->format) {
+    free(self->format);
+  }
+  if (self->lock) {
+    PyThread_free_lock(self->lock);
+  }
   Py_XDECREF(self->read_to);
   Py_XDECREF(self->mread_to);
   Py_TYPE(self)->tp_free((PyObject *) self);
@@ -423,51 +498,96 @@ Py_source_del (Py_source *self, PyObject *unused)
 
 /* function Py_source_do */
 static PyObject *
-Py_source_do(Py_source * self, PyObject * args)
+Py_source_do(Py_source * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *outputs;
+  static char *kwlist[] = { "out", NULL };
+  PyObject *outputs, *output = NULL;
   uint_t read;
   read = 0;
 
-  Py_INCREF(self->read_to);
-  if (!PyAubio_ArrayToCFvec(self->read_to, &(self->c_read_to))) {
+  // also called by Pyaubio_source_iter_next, without arguments
+  if (args && !PyArg_ParseTupleAndKeywords (args, kwds, "|$O", kwlist,
+        &output)) {
     return NULL;
   }
+
+  PyAubio_Lock(self->lock);
+  // samples go to out if given, to self->read_to otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_ArrayToCFvecOut (output, self->hop_size, &(self->c_read_to))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->read_to;
+    if (!PyAubio_ArrayToCFvec (output, &(self->c_read_to))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  }
   /* compute _do function */
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_source_do (self->o, &(self->c_read_to), &read);
+  PyAubio_END_ALLOW_THREADS
 
   if (PyErr_Occurred() != NULL) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
+  Py_INCREF(output);
   outputs = PyTuple_New(2);
-  PyTuple_SetItem( outputs, 0, self->read_to );
+  PyTuple_SetItem( outputs, 0, output );
   PyTuple_SetItem( outputs, 1, (PyObject *)PyLong_FromLong(read));
+  PyAubio_Unlock(self->lock);
   return outputs;
 }
 
 /* function Py_source_do_multi */
 static PyObject *
-Py_source_do_multi(Py_source * self, PyObject * args)
+Py_source_do_multi(Py_source * self, PyObject * args, PyObject * kwds)
 {
-  PyObject *outputs;
+  static char *kwlist[] = { "out", NULL };
+  PyObject *outputs, *output = NULL;
   uint_t read;
   read = 0;
 
-  Py_INCREF(self->mread_to);
-  if (!PyAubio_ArrayToCFmat(self->mread_to,  &(self->c_mread_to))) {
+  // also called by Pyaubio_source_iter_next, without arguments
+  if (args && !PyArg_ParseTupleAndKeywords (args, kwds, "|$O", kwlist,
+        &output)) {
     return NULL;
   }
+
+  PyAubio_Lock(self->lock);
+  // samples go to out if given, to self->mread_to otherwise
+  if (output && output != Py_None) {
+    if (!PyAubio_ArrayToCFmatOut (output, self->channels,
+          self->hop_size, &(self->c_mread_to))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  } else {
+    output = self->mread_to;
+    if (!PyAubio_ArrayToCFmat (output, &(self->c_mread_to))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+  }
   /* compute _do function */
+  PyAubio_BEGIN_ALLOW_THREADS
   aubio_source_do_multi (self->o, &(self->c_mread_to), &read);
+  PyAubio_END_ALLOW_THREADS
 
   if (PyErr_Occurred() != NULL) {
+    PyAubio_Unlock(self->lock);
     return NULL;
   }
 
+  Py_INCREF(output);
   outputs = PyTuple_New(2);
-  PyTuple_SetItem( outputs, 0, self->mread_to);
+  PyTuple_SetItem( outputs, 0, output);
   PyTuple_SetItem( outputs, 1, (PyObject *)PyLong_FromLong(read));
+  PyAubio_Unlock(self->lock);
   return outputs;
 }
 
@@ -502,21 +622,33 @@ static PyMemberDef Py_source_members[] = {
 static PyObject *
 Pyaubio_source_get_samplerate (Py_source *self, PyObject *unused)
 {
-  uint_t tmp = aubio_source_get_samplerate (self->o);
+  uint_t tmp;
+  PyAubio_Lock(self->lock);
+  tmp = aubio_source_get_samplerate (self->o);
+  PyAubio_Unlock(self->lock);
   return (PyObject *)PyLong_FromLong (tmp);
 }
 
 static PyObject *
 Pyaubio_source_get_channels (Py_source *self, PyObject *unused)
 {
-  uint_t tmp = aubio_source_get_channels (self->o);
+  uint_t tmp;
+  PyAubio_Lock(self->lock);
+  tmp = aubio_source_get_channels (self->o);
+  PyAubio_Unlock(self->lock);
   return (PyObject *)PyLong_FromLong (tmp);
 }
 
 static PyObject *
 Pyaubio_source_close (Py_source *self, PyObject *unused)
 {
-  if (aubio_source_close(self->o) != 0) return NULL;
+  uint_t err;
+  PyAubio_Lock(self->lock);
+  PyAubio_BEGIN_ALLOW_THREADS
+  err = aubio_source_close(self->o);
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
+  if (err != 0) return NULL;
   Py_RETURN_NONE;
 }
 
@@ -537,7 +669,11 @@ Pyaubio_source_seek (Py_source *self, PyObject *args)
     return NULL;
   }
 
+  PyAubio_Lock(self->lock);
+  PyAubio_BEGIN_ALLOW_THREADS
   err = aubio_source_seek(self->o, position);
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
   if (err != 0) {
     PyErr_SetString (PyExc_ValueError,
         "error when seeking in source");
@@ -546,6 +682,33 @@ Pyaubio_source_seek (Py_source *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+static PyObject *
+Pyaubio_source_set_range (Py_source *self, PyObject *args)
+{
+  uint_t err = 0;
+  int start, end = 0;
+  if (!PyArg_ParseTuple (args, "i|i", &start, &end)) {
+    return NULL;
+  }
+  if (start < 0 || end < 0 || (end != 0 && end <= start)) {
+    PyErr_Format(PyExc_ValueError,
+        "error when setting range of source: can not read from %d to %d",
+        start, end);
+    return NULL;
+  }
+  PyAubio_Lock(self->lock);
+  PyAubio_BEGIN_ALLOW_THREADS
+  err = aubio_source_set_range(self->o, start, end);
+  PyAubio_END_ALLOW_THREADS
+  PyAubio_Unlock(self->lock);
+  if (err != 0) {
+    PyErr_SetString (PyExc_ValueError,
+        "error when setting range of source");
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
 static char Pyaubio_source_enter_doc[] = "";
 static PyObject* Pyaubio_source_enter(Py_source *self, PyObject *unused) {
   Py_INCREF(self);
@@ -565,9 +728,9 @@ static PyObject* Pyaubio_source_iter(PyObject *self) {
 static PyObject* Pyaubio_source_iter_next(Py_source *self) {
   PyObject *done, *size;
   if (self->channels == 1) {
-    done = Py_source_do(self, NULL);
+    done = Py_source_do(self, NULL, NULL);
   } else {
-    done = Py_source_do_multi(self, NULL);
+    done = Py_source_do_multi(self, NULL, NULL);
   }
   if (!PyTuple_Check(done)) {
     PyErr_Format(PyExc_ValueError,
@@ -609,19 +772,249 @@ static PyObject* Pyaubio_source_iter_next(Py_source *self) {
   }
 }
 
+static char Py_source_read_all_doc[] = ""
+"read_all()\n"
+"\n"
+"Read all the samples left in the source at once.\n"
+"\n"
+"The samples are read in C, directly into the returned array, which is\n"
+"allocated from the :attr:`duration` of the source, and grown if needed.\n"
+"\n"
+"Returns\n"
+"-------\n"
+"numpy.ndarray\n"
+"    array of shape `(channels, n)` holding the `n` frames read, or\n"
+"    `(n,)` if the source was opened with a single channel, in which\n"
+"    case the channels are down-mixed as with :meth:`__call__`.\n"
+"\n"
+"Examples\n"
+"--------\n"
+">>> src = aubio.source('stereo.wav', channels=2)\n"
+">>> src.read_all().shape\n"
+"(2, 86833)\n"
+"";
+
+static char Py_source_blocks_doc[] = ""
+"blocks(block_frames, reuse=False)\n"
+"\n"
+"Iterate over the source by blocks of many frames.\n"
+"\n"
+"Each block is read in C, directly into the array returned.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"block_frames : int\n"
+"    number of frames of each block, a multiple of `hop_size`\n"
+"reuse : bool, optional\n"
+"    if `True`, all the blocks are read into the same array, which\n"
+"    each iteration overwrites\n"
+"\n"
+"Yields\n"
+"------\n"
+"numpy.ndarray\n"
+"    array of shape `(channels, block_frames)`, or `(block_frames,)`\n"
+"    if the source was opened with a single channel. The last block is\n"
+"    shorter if the end of the source is reached.\n"
+"\n"
+"Examples\n"
+"--------\n"
+">>> src = aubio.source('track1.mp3', channels=1)\n"
+">>> for block in src.blocks(src.samplerate * 10, reuse=True):\n"
+"...     print(block.shape)\n"
+"";
+
+// read up to length frames to the columns [pos, pos + length) of data, a
+// (channels, stride) array, or a (stride,) one when reading a single
+// channel, which is down-mixed as in Py_source_do; length and pos should
+// be multiples of hop_size. Called without the GIL, holding the lock.
+static uint_t
+Py_source_read_frames (Py_source * self, smpl_t * data, uint_t stride,
+    uint_t pos, uint_t length, smpl_t ** rows)
+{
+  uint_t j, read = 0, total = 0;
+  if (self->channels == 1) {
+    fvec_t hop;
+    hop.length = self->hop_size;
+    while (total < length) {
+      hop.data = data + pos + total;
+      aubio_source_do (self->o, &hop, &read);
+      total += read;
+      if (read < self->hop_size) break;
+    }
+  } else {
+    fmat_t block;
+    for (j = 0; j < self->channels; j++) {
+      rows[j] = data + j * stride + pos;
+    }
+    block.height = self->channels;
+    block.length = length;
+    block.data = rows;
+    aubio_source_read_into (self->o, &block, length, &total);
+  }
+  return total;
+}
+
+// new array of frames, with one row per channel unless reading one channel
+static PyObject *
+Py_source_new_frames (Py_source * self, uint_t length)
+{
+  if (self->channels == 1) {
+    return new_py_fvec (length);
+  }
+  return new_py_fmat (self->channels, length);
+}
+
+// keep the first length frames of a (channels, stride) array, in place;
+// frames is released on error
+static PyObject *
+Py_source_shrink_frames (Py_source * self, PyObject * frames, uint_t stride,
+    uint_t length)
+{
+  smpl_t *data = (smpl_t *)PyArray_DATA ((PyArrayObject *)frames);
+  npy_intp dims[2] = { self->channels, length };
+  PyArray_Dims shape;
+  PyObject *ret;
+  uint_t j;
+  for (j = 1; j < self->channels; j++) {
+    memmove (data + j * length, data + j * stride, length * sizeof(smpl_t));
+  }
+  shape.ptr = self->channels == 1 ? dims + 1 : dims;
+  shape.len = self->channels == 1 ? 1 : 2;
+  ret = PyArray_Resize ((PyArrayObject *)frames, &shape, 0, NPY_CORDER);
+  if (!ret) {
+    Py_DECREF (frames);
+    return NULL;
+  }
+  Py_DECREF (ret);
+  return frames;
+}
+
+static PyObject *
+Pyaubio_source_read_all (Py_source *self, PyObject *unused)
+{
+  PyObject *frames = NULL, *grown;
+  smpl_t **rows = NULL;
+  uint_t j, pos = 0, read = 0, capacity;
+  if (!self->o) {
+    PyErr_SetString (PyExc_ValueError, "source is not opened");
+    return NULL;
+  }
+  // the duration may be an estimate, leave room for a last short read
+  capacity = (self->duration / self->hop_size + 1) * self->hop_size;
+  rows = (smpl_t **)calloc (self->channels, sizeof(smpl_t *));
+  frames = Py_source_new_frames (self, capacity);
+  if (!rows || !frames) {
+    goto beach;
+  }
+  PyAubio_Lock(self->lock);
+  while (1) {
+    PyAubio_BEGIN_ALLOW_THREADS
+    read = Py_source_read_frames (self,
+        (smpl_t *)PyArray_DATA ((PyArrayObject *)frames), capacity, pos,
+        capacity - pos, rows);
+    PyAubio_END_ALLOW_THREADS
+    pos += read;
+    if (pos < capacity || PyErr_Occurred ()) {
+      break;
+    }
+    // the array is full, copy it to one twice as large
+    grown = Py_source_new_frames (self, 2 * capacity);
+    if (!grown) {
+      break;
+    }
+    for (j = 0; j < self->channels; j++) {
+      memcpy ((smpl_t *)PyArray_DATA ((PyArrayObject *)grown)
+          + j * 2 * capacity, (smpl_t *)PyArray_DATA ((PyArrayObject *)frames)
+          + j * capacity, pos * sizeof(smpl_t));
+    }
+    Py_DECREF (frames);
+    frames = grown;
+    capacity *= 2;
+  }
+  PyAubio_Unlock(self->lock);
+  if (PyErr_Occurred ()) {
+    goto beach;
+  }
+  free (rows);
+  return Py_source_shrink_frames (self, frames, capacity, pos);
+
+beach:
+  if (rows) free (rows);
+  Py_XDECREF (frames);
+  if (!PyErr_Occurred ()) {
+    PyErr_NoMemory ();
+  }
+  return NULL;
+}
+
+typedef struct
+{
+  PyObject_HEAD
+  Py_source *source;
+  uint_t block_frames;
+  int reuse;
+  PyObject *block;              /**< array read into if reuse is set */
+  smpl_t **rows;
+  int done;
+} Py_source_blocks;
+
+static PyObject *
+Pyaubio_source_blocks (Py_source *self, PyObject *args, PyObject *kwds)
+{
+  static char *kwlist[] = { "block_frames", "reuse", NULL };
+  Py_source_blocks *it;
+  uint_t block_frames = 0;
+  int reuse = 0;
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "I|p", kwlist,
+        &block_frames, &reuse)) {
+    return NULL;
+  }
+  if (block_frames == 0 || block_frames % self->hop_size != 0) {
+    PyErr_Format (PyExc_ValueError, "block_frames should be a positive"
+        " multiple of hop_size (%d), not %d", self->hop_size, block_frames);
+    return NULL;
+  }
+  if (!self->o) {
+    PyErr_SetString (PyExc_ValueError, "source is not opened");
+    return NULL;
+  }
+  it = PyObject_New (Py_source_blocks, &Py_source_blocksType);
+  if (!it) {
+    return NULL;
+  }
+  Py_INCREF (self);
+  it->source = self;
+  it->block_frames = block_frames;
+  it->reuse = reuse;
+  it->block = NULL;
+  it->done = 0;
+  it->rows = (smpl_t **)calloc (self->channels, sizeof(smpl_t *));
+  if (!it->rows) {
+    Py_DECREF (it);
+    return PyErr_NoMemory ();
+  }
+  return (PyObject *)it;
+}
+
 static PyMethodDef Py_source_methods[] = {
   {"get_samplerate", (PyCFunction) Pyaubio_source_get_samplerate,
     METH_NOARGS, Py_source_get_samplerate_doc},
   {"get_channels", (PyCFunction) Pyaubio_source_get_channels,
     METH_NOARGS, Py_source_get_channels_doc},
   {"do", (PyCFunction) Py_source_do,
-    METH_NOARGS, Py_source_do_doc},
+    METH_VARARGS | METH_KEYWORDS, Py_source_do_doc},
   {"do_multi", (PyCFunction) Py_source_do_multi,
-    METH_NOARGS, Py_source_do_multi_doc},
+    METH_VARARGS | METH_KEYWORDS, Py_source_do_multi_doc},
   {"close", (PyCFunction) Pyaubio_source_close,
     METH_NOARGS, Py_source_close_doc},
   {"seek", (PyCFunction) Pyaubio_source_seek,
     METH_VARARGS, Py_source_seek_doc},
+  {"set_range", (PyCFunction) Pyaubio_source_set_range,
+    METH_VARARGS, Py_source_set_range_doc},
+  {"read_all", (PyCFunction) Pyaubio_source_read_all,
+    METH_NOARGS, Py_source_read_all_doc},
+  {"blocks", (PyCFunction) Pyaubio_source_blocks,
+    METH_VARARGS | METH_KEYWORDS, Py_source_blocks_doc},
   {"__enter__", (PyCFunction)Pyaubio_source_enter, METH_NOARGS,
     Pyaubio_source_enter_doc},
   {"__exit__",  (PyCFunction)Pyaubio_source_exit, METH_VARARGS,
@@ -678,3 +1071,134 @@ PyTypeObject Py_sourceType = {
   0,
   0,
 };
+
+static void
+Py_source_blocks_del (Py_source_blocks *self)
+{
+  Py_XDECREF (self->block);
+  Py_DECREF (self->source);
+  if (self->rows) {
+    free (self->rows);
+  }
+  PyObject_Del (self);
+}
+
+static PyObject *
+Py_source_blocks_next (Py_source_blocks *self)
+{
+  Py_source *source = self->source;
+  PyObject *block, *last;
+  uint_t j, read = 0;
+
+  // the iterator may be shared by several threads, its fields are also
+  // guarded by the lock of the source
+  PyAubio_Lock(source->lock);
+  if (self->done) {
+    PyAubio_Unlock(source->lock);
+    return NULL;
+  }
+  block = self->block;
+  if (!block) {
+    block = Py_source_new_frames (source, self->block_frames);
+    if (!block) {
+      PyAubio_Unlock(source->lock);
+      return NULL;
+    }
+    if (self->reuse) {
+      self->block = block;
+    }
+  }
+  if (self->reuse) {
+    Py_INCREF (block);
+  }
+
+  if (!source->o) {
+    PyErr_SetString (PyExc_ValueError, "source is not opened");
+  } else {
+    PyAubio_BEGIN_ALLOW_THREADS
+    read = Py_source_read_frames (source,
+        (smpl_t *)PyArray_DATA ((PyArrayObject *)block), self->block_frames,
+        0, self->block_frames, self->rows);
+    PyAubio_END_ALLOW_THREADS
+  }
+  if (PyErr_Occurred ()) {
+    PyAubio_Unlock(source->lock);
+    Py_DECREF (block);
+    return NULL;
+  }
+  if (read < self->block_frames) {
+    // end of the source
+    self->done = 1;
+  }
+  PyAubio_Unlock(source->lock);
+
+  if (read == self->block_frames) {
+    return block;
+  }
+  // return the frames read, if any
+  if (read == 0) {
+    Py_DECREF (block);
+    return NULL;
+  }
+  if (!self->reuse) {
+    return Py_source_shrink_frames (source, block, self->block_frames, read);
+  }
+  // take a copy of the frames, the shared block keeps its size
+  last = Py_source_new_frames (source, read);
+  for (j = 0; last && j < source->channels; j++) {
+    memcpy ((smpl_t *)PyArray_DATA ((PyArrayObject *)last) + j * read,
+        (smpl_t *)PyArray_DATA ((PyArrayObject *)block)
+        + j * self->block_frames, read * sizeof(smpl_t));
+  }
+  Py_DECREF (block);
+  return last;
+}
+
+PyTypeObject Py_source_blocksType = {
+  PyVarObject_HEAD_INIT (NULL, 0)
+  "aubio.source_blocks",
+  sizeof (Py_source_blocks),
+  0,
+  (destructor) Py_source_blocks_del,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  Py_TPFLAGS_DEFAULT,
+  "iterator over the blocks of an aubio.source",
+  0,
+  0,
+  0,
+  0,
+  PyObject_SelfIter,
+  (iternextfunc) Py_source_blocks_next,
+};
+
+aubio_source_t *
+PyAubio_PySourceToCSource (PyObject *input, uint_t *hop_size,
+    PyThread_type_lock *lock)
+{
+  Py_source *self;
+  if (!PyObject_TypeCheck (input, &Py_sourceType)) {
+    PyErr_SetString (PyExc_TypeError, "input should be an aubio.source");
+    return NULL;
+  }
+  self = (Py_source *)input;
+  if (!self->o) {
+    PyErr_SetString (PyExc_ValueError, "source is not opened");
+    return NULL;
+  }
+  *hop_size = self->hop_size;
+  *lock = self->lock;
+  return self->o;
+}
@@ -0,0 +1,319 @@
+#include "aubio-types.h"
+
+typedef struct
+{
+  PyObject_HEAD
+  aubio_specenc_t * o;
+  PyThread_type_lock lock;
+  uint_t input_size;
+  uint_t n_bins;
+  u8_t *frame;
+  fvec_t vec;
+  cvec_t cvec;
+} Py_specenc;
+
+static char Py_specenc_doc[] = ""
+"specenc(input_size, n_bins)\n"
+"\n"
+"Encode spectra into compact frames, for streaming to visualisations.\n"
+"\n"
+"Each call groups the `input_size` bins of its input into `n_bins`\n"
+"bands, encodes the level of each band in dB as one byte, and returns a\n"
+"frame of bytes holding either all these codes (a key frame) or their\n"
+"differences to the previous frame.\n"
+"\n"
+"Parameters\n"
+"----------\n"
+"input_size : int\n"
+"    Number of bins of each input, `win_s // 2 + 1` for a :class:`cvec`\n"
+"    of a window of `win_s` samples, or the number of filters of a\n"
+"    :class:`filterbank`.\n"
+"n_bins : int\n"
+"    Number of bands of each frame, from 1 to `input_size`.\n"
+"\n"
+"Examples\n"
+"--------\n"
+">>> enc = aubio.specenc(513, 64)\n"
+">>> enc.set_log_bins(True)\n"
+">>> frame = enc(pv(samples))  # bytes, send them to the clients\n"
+"\n"
+"A :class:`cvec` is encoded from its norms, in `20 * log10(norm)`, and a\n"
+"vector of energies in `10 * log10(energy)`. See the documentation of\n"
+"`utils/specenc.h` for the format of the frames.\n"
+"";
+
+static PyObject *
+Py_specenc_new (PyTypeObject * type, PyObject * args, PyObject * kwds)
+{
+  uint_t input_size = 0, n_bins = 0;
+  Py_specenc *self;
+  static char *kwlist[] = { "input_size", "n_bins", NULL };
+
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "II", kwlist,
+          &input_size, &n_bins)) {
+    return NULL;
+  }
+
+  if (n_bins == 0 || n_bins > input_size) {
+    PyErr_Format (PyExc_ValueError,
+        "n_bins should be between 1 and input_size (%d), got %d",
+        input_size, n_bins);
+    return NULL;
+  }
+
+  self = (Py_specenc *) type->tp_alloc (type, 0);
+  if (self == NULL) {
+    return NULL;
+  }
+
+  self->lock = PyThread_allocate_lock ();
+  if (self->lock == NULL) {
+    Py_DECREF (self);
+    return PyErr_NoMemory ();
+  }
+
+  self->input_size = input_size;
+  self->n_bins = n_bins;
+
+  return (PyObject *) self;
+}
+
+static int
+Py_specenc_init (Py_specenc * self, PyObject * args, PyObject * kwds)
+{
+  self->o = new_aubio_specenc (self->input_size, self->n_bins);
+  if (self->o == NULL) {
+    PyErr_SetString (PyExc_RuntimeError, "error creating specenc");
+    return -1;
+  }
+  self->frame = (u8_t *) PyMem_Malloc (aubio_specenc_get_max_size (self->o));
+  if (self->frame == NULL) {
+    PyErr_NoMemory ();
+    return -1;
+  }
+  return 0;
+}
+
+static void
+Py_specenc_del (Py_specenc * self)
+{
+  if (self->o)
+    del_aubio_specenc (self->o);
+  if (self->frame)
+    PyMem_Free (self->frame);
+  if (self->lock) {
+    PyThread_free_lock (self->lock);
+  }
+  Py_TYPE(self)->tp_free ((PyObject *) self);
+}
+
+static PyObject *
+Py_specenc_do (Py_specenc * self, PyObject * args, PyObject * kwds)
+{
+  static char *kwlist[] = { "input", NULL };
+  PyObject *input;
+  uint_t size;
+
+  if (!PyArg_ParseTupleAndKeywords (args, kwds, "O:specenc", kwlist,
+        &input)) {
+    return NULL;
+  }
+
+  PyAubio_Lock(self->lock);
+  if (PyObject_TypeCheck (input, &Py_cvecType)) {
+    if (!PyAubio_PyCvecToCCvec (input, &(self->cvec))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+    if (self->cvec.length != self->input_size) {
+      PyErr_Format (PyExc_ValueError, "input cvec has length %d, but"
+          " specenc expects length %d", self->cvec.length, self->input_size);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+    PyAubio_BEGIN_ALLOW_THREADS
+    size = aubio_specenc_do_spectrum (self->o, &(self->cvec), self->frame);
+    PyAubio_END_ALLOW_THREADS
+  } else {
+    if (!PyAubio_ArrayToCFvec (input, &(self->vec))) {
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+    if (self->vec.length != self->input_size) {
+      PyErr_Format (PyExc_ValueError, "input array has length %d, but"
+          " specenc expects length %d", self->vec.length, self->input_size);
+      PyAubio_Unlock(self->lock);
+      return NULL;
+    }
+    PyAubio_BEGIN_ALLOW_THREADS
+    size = aubio_specenc_do (self->o, &(self->vec), self->frame);
+    PyAubio_END_ALLOW_THREADS
+  }
+  PyAubio_Unlock(self->lock);
+  return PyBytes_FromStringAndSize ((const char *) self->frame, size);
+}
+
+static PyObject *
+Py_specenc_set_range (Py_specenc * self, PyObject *args)
+{
+  uint_t err;
+  smpl_t min_db, max_db;
+  if (!PyArg_ParseTuple (args, AUBIO_NPY_SMPL_CHR AUBIO_NPY_SMPL_CHR,
+        &min_db, &max_db)) {
+    return NULL;
+  }
+  PyAubio_Lock(self->lock);
+  err = aubio_specenc_set_range (self->o, min_db, max_db);
+  PyAubio_Unlock(self->lock);
+  if (err) {
+    PyErr_SetString (PyExc_ValueError, "max_db should be greater than min_db");
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *
+Py_specenc_set_log_bins (Py_specenc * self, PyObject *args)
+{
+  uint_t enable;
+  if (!PyArg_ParseTuple (args, "I", &enable)) {
+    return NULL;
+  }
+  PyAubio_Lock(self->lock);
+  aubio_specenc_set_log_bins (self->o, enable ? 1 : 0);
+  PyAubio_Unlock(self->lock);
+  Py_RETURN_NONE;
+}
+
+static PyObject *
+Py_specenc_set_keyframe_interval (Py_specenc * self, PyObject *args)
+{
+  uint_t interval;
+  if (!PyArg_ParseTuple (args, "I", &interval)) {
+    return NULL;
+  }
+  PyAubio_Lock(self->lock);
+  aubio_specenc_set_keyframe_interval (self->o, interval);
+  PyAubio_Unlock(self->lock);
+  Py_RETURN_NONE;
+}
+
+static PyObject *
+Py_specenc_set_tolerance (Py_specenc * self, PyObject *args)
+{
+  uint_t steps, err;
+  if (!PyArg_ParseTuple (args, "I", &steps)) {
+    return NULL;
+  }
+  PyAubio_Lock(self->lock);
+  err = aubio_specenc_set_tolerance (self->o, steps);
+  PyAubio_Unlock(self->lock);
+  if (err) {
+    PyErr_Format (PyExc_ValueError, "tolerance should be <= 255, got %d",
+        steps);
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *
+Py_specenc_get_levels (Py_specenc * self, PyObject *unused)
+{
+  PyObject *levels;
+  PyAubio_Lock(self->lock);
+  levels = PyBytes_FromStringAndSize (
+      (const char *) aubio_specenc_get_levels (self->o), self->n_bins);
+  PyAubio_Unlock(self->lock);
+  return levels;
+}
+
+static PyObject *
+Py_specenc_reset (Py_specenc * self, PyObject *unused)
+{
+  PyAubio_Lock(self->lock);
+  aubio_specenc_reset (self->o);
+  PyAubio_Unlock(self->lock);
+  Py_RETURN_NONE;
+}
+
+static PyMemberDef Py_specenc_members[] = {
+  {"input_size", T_INT, offsetof (Py_specenc, input_size), READONLY,
+    "number of bins of each input"},
+  {"n_bins", T_INT, offsetof (Py_specenc, n_bins), READONLY,
+    "number of bands of each frame"},
+  {NULL} /* sentinel */
+};
+
+static PyMethodDef Py_specenc_methods[] = {
+  {"set_range", (PyCFunction) Py_specenc_set_range, METH_VARARGS,
+    "set_range(min_db, max_db)\n\n"
+    "Set the levels encoded as 0 and 255, -100 and 20 dB by default."},
+  {"set_log_bins", (PyCFunction) Py_specenc_set_log_bins, METH_VARARGS,
+    "set_log_bins(enable)\n\n"
+    "Group the bins in bands of increasing width, on a logarithmic\n"
+    "frequency scale, instead of bands of equal width."},
+  {"set_keyframe_interval", (PyCFunction) Py_specenc_set_keyframe_interval,
+    METH_VARARGS, "set_keyframe_interval(interval)\n\n"
+    "Send a key frame at least every `interval` frames, or only when\n"
+    "needed if `interval` is 0, the default."},
+  {"set_tolerance", (PyCFunction) Py_specenc_set_tolerance, METH_VARARGS,
+    "set_tolerance(steps)\n\n"
+    "Leave out of the delta frames the changes of up to `steps` codes."},
+  {"get_levels", (PyCFunction) Py_specenc_get_levels, METH_NOARGS,
+    "get_levels()\n\n"
+    "Codes held by a client once it decoded the last frame, as bytes."},
+  {"reset", (PyCFunction) Py_specenc_reset, METH_NOARGS,
+    "reset()\n\n"
+    "Send a key frame next, and restart the frame counter."},
+  {NULL} /* sentinel */
+};
+
+PyTypeObject Py_specencType = {
+  PyVarObject_HEAD_INIT (NULL, 0)
+  "aubio.specenc",
+  sizeof (Py_specenc),
+  0,
+  (destructor) Py_specenc_del,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  (ternaryfunc)Py_specenc_do,
+  0,
+  0,
+  0,
+  0,
+  Py_TPFLAGS_DEFAULT,
+  Py_specenc_doc,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  Py_specenc_methods,
+  Py_specenc_members,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  (initproc) Py_specenc_init,
+  0,
+  Py_specenc_new,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+  0,
+};
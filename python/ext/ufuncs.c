@@ -1,51 +1,69 @@
 #define PY_AUBIO_MODULE_UFUNC
 #include "aubio-types.h"
 
-typedef smpl_t (*aubio_unary_func_t)(smpl_t input);
+typedef void (*aubio_unary_func_t)(fvec_t *input);
 
-static void aubio_PyUFunc_d_d(char **args, const npy_intp *dimensions,
-                            const npy_intp* steps, void* data)
+// number of elements converted by each call to the vector function
+#define AUBIO_UFUNC_CHUNK 4096
+
+// numpy releases the GIL around these loops, since they use no python object
+static void aubio_PyUFunc_unary(char **args, npy_intp n,
+    const npy_intp* steps, aubio_unary_func_t func, int is_float)
 {
-    npy_intp i;
-    npy_intp n = dimensions[0];
+    npy_intp i, j, len;
     char *in = args[0], *out = args[1];
     npy_intp in_step = steps[0], out_step = steps[1];
-    aubio_unary_func_t func = (aubio_unary_func_t)(data);
-
-    for (i = 0; i < n; i++) {
-        /*BEGIN main ufunc computation*/
-        *((double *)out) = func(*(double *)in);
-        /*END main ufunc computation*/
-
-        in += in_step;
-        out += out_step;
+    // same element type as smpl_t, in a contiguous output
+    int in_place = (is_float == (sizeof(smpl_t) == sizeof(float)))
+        && out_step == sizeof(smpl_t);
+    smpl_t buf[AUBIO_UFUNC_CHUNK];
+    fvec_t vec;
+
+    for (i = 0; i < n; i += len) {
+        len = (n - i < AUBIO_UFUNC_CHUNK) ? n - i : AUBIO_UFUNC_CHUNK;
+        vec.length = (uint_t)len;
+        vec.data = in_place ? (smpl_t *)out : buf;
+        // gather the chunk, unless the conversion is done in place
+        if (in != out || !in_place) {
+            for (j = 0; j < len; j++) {
+                vec.data[j] = is_float ? *(float *)(in + j * in_step)
+                    : *(double *)(in + j * in_step);
+            }
+        }
+        func(&vec);
+        if (!in_place) {
+            for (j = 0; j < len; j++) {
+                if (is_float) {
+                    *(float *)(out + j * out_step) = vec.data[j];
+                } else {
+                    *(double *)(out + j * out_step) = vec.data[j];
+                }
+            }
+        }
+        in += len * in_step;
+        out += len * out_step;
     }
 }
 
-static void aubio_PyUFunc_f_f_As_d_d(char **args, const npy_intp *dimensions,
+static void aubio_PyUFunc_d_d(char **args, const npy_intp *dimensions,
                             const npy_intp* steps, void* data)
 {
-    npy_intp i;
-    npy_intp n = dimensions[0];
-    char *in = args[0], *out = args[1];
-    npy_intp in_step = steps[0], out_step = steps[1];
-    aubio_unary_func_t func = (aubio_unary_func_t)(data);
-
-    for (i = 0; i < n; i++) {
-        /*BEGIN main ufunc computation*/
-        *((float *)out) = func(*(float *)in);
-        /*END main ufunc computation*/
+    aubio_PyUFunc_unary(args, dimensions[0], steps,
+        (aubio_unary_func_t)(data), 0);
+}
 
-        in += in_step;
-        out += out_step;
-    }
+static void aubio_PyUFunc_f_f(char **args, const npy_intp *dimensions,
+                            const npy_intp* steps, void* data)
+{
+    aubio_PyUFunc_unary(args, dimensions[0], steps,
+        (aubio_unary_func_t)(data), 1);
 }
 
 static int Py_aubio_unary_n_types = 2;
 static int Py_aubio_unary_n_inputs = 1;
 static int Py_aubio_unary_n_outputs = 1;
 PyUFuncGenericFunction Py_aubio_unary_functions[] = {
-  &aubio_PyUFunc_f_f_As_d_d,
+  &aubio_PyUFunc_f_f,
   &aubio_PyUFunc_d_d,
   //PyUFunc_f_f_As_d_d, PyUFunc_d_d,
   //PyUFunc_g_g, PyUFunc_OO_O_method,
@@ -76,8 +94,8 @@ static char Py_unwrap2pi_doc[] = ""
 "";
 
 static void* Py_unwrap2pi_data[] = {
-  (void *)aubio_unwrap2pi,
-  (void *)aubio_unwrap2pi,
+  (void *)fvec_unwrap2pi,
+  (void *)fvec_unwrap2pi,
   //(void *)unwrap2pil,
   //(void *)unwrap2pio,
 };
@@ -98,8 +116,8 @@ static char Py_freqtomidi_doc[] = ""
 "";
 
 static void* Py_freqtomidi_data[] = {
-  (void *)aubio_freqtomidi,
-  (void *)aubio_freqtomidi,
+  (void *)fvec_freqtomidi,
+  (void *)fvec_freqtomidi,
 };
 
 static char Py_miditofreq_doc[] = ""
@@ -118,8 +136,8 @@ static char Py_miditofreq_doc[] = ""
 "";
 
 static void* Py_miditofreq_data[] = {
-  (void *)aubio_miditofreq,
-  (void *)aubio_miditofreq,
+  (void *)fvec_miditofreq,
+  (void *)fvec_miditofreq,
 };
 
 void add_ufuncs ( PyObject *m )
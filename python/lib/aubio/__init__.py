@@ -23,11 +23,31 @@ imported with:
 """
 
 import numpy
+from . import _aubio
 from ._aubio import __version__ as version
 from ._aubio import float_type
 from ._aubio import *
+
+
+def __getattr__(name):
+    # the classes of _aubio are created on first use, see Py_aubio_getattr
+    try:
+        value = getattr(_aubio, name)
+    except AttributeError:
+        raise AttributeError("module 'aubio' has no attribute %r" % name) \
+            from None
+    globals()[name] = value
+    return value
+
+
+def __dir__():
+    return sorted(set(globals()) | set(dir(_aubio)))
+
+
 from .midiconv import *
 from .slicing import *
+from .features import *
+from .workers import *
 
 
 class fvec(numpy.ndarray):
@@ -83,3 +103,8 @@ class fvec(numpy.ndarray):
             if np_input.shape[0] == 0:
                 raise ValueError("vector length of 1 or more expected")
             return np_input
+
+
+# list the classes not created yet, so that `from aubio import *` still
+# imports them
+__all__ = [name for name in __dir__() if not name.startswith('_')]
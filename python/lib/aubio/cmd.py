@@ -9,7 +9,9 @@ the GNU/GPL v3.
 Note: this script is mostly about parsing command line arguments. For more
 readable code examples, check out the `python/demos` folder."""
 
+import os
 import sys
+import json
 import argparse
 import warnings
 import aubio
@@ -35,6 +37,7 @@ def aubio_parser():
     parser_add_subcommand_melbands(subparsers)
     parser_add_subcommand_quiet(subparsers)
     parser_add_subcommand_cut(subparsers)
+    parser_add_subcommand_batch(subparsers)
 
     return parser
 
@@ -52,12 +55,14 @@ def parser_add_subcommand_onset(subparsers):
     subparser.add_input()
     subparser.add_buf_hop_size()
     helpstr = "onset novelty function"
-    helpstr += " <default|energy|hfc|complex|phase|specdiff|kl|mkl|specflux>"
+    helpstr += " <default|energy|hfc|complex|phase|specdiff|kl|mkl|specflux"
+    helpstr += "|superflux>"
     subparser.add_method(helpstr=helpstr)
     subparser.add_threshold()
     subparser.add_silence()
     subparser.add_minioi()
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_onset)
 
@@ -73,6 +78,7 @@ def parser_add_subcommand_pitch(subparsers):
     subparser.add_pitch_unit()
     subparser.add_silence()
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_pitch)
 
@@ -83,6 +89,7 @@ def parser_add_subcommand_beat(subparsers):
     subparser.add_input()
     subparser.add_buf_hop_size(buf_size=1024, hop_size=512)
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_beat)
 
@@ -93,6 +100,7 @@ def parser_add_subcommand_tempo(subparsers):
     subparser.add_input()
     subparser.add_buf_hop_size(buf_size=1024, hop_size=512)
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_tempo)
 
@@ -105,6 +113,7 @@ def parser_add_subcommand_notes(subparsers):
     subparser.add_silence()
     subparser.add_release_drop()
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_notes)
 
@@ -115,6 +124,7 @@ def parser_add_subcommand_mfcc(subparsers):
     subparser.add_input()
     subparser.add_buf_hop_size()
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_mfcc)
 
@@ -125,6 +135,7 @@ def parser_add_subcommand_melbands(subparsers):
     subparser.add_input()
     subparser.add_buf_hop_size()
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_melbands)
 
@@ -136,6 +147,7 @@ def parser_add_subcommand_quiet(subparsers):
     subparser.add_hop_size()
     subparser.add_silence()
     subparser.add_time_format()
+    subparser.add_output_format()
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_quiet)
 
@@ -145,7 +157,8 @@ def parser_add_subcommand_cut(subparsers):
             help='slice at timestamps')
     subparser.add_input()
     helpstr = "onset novelty function"
-    helpstr += " <default|energy|hfc|complex|phase|specdiff|kl|mkl|specflux>"
+    helpstr += " <default|energy|hfc|complex|phase|specdiff|kl|mkl|specflux"
+    helpstr += "|superflux>"
     subparser.add_method(helpstr=helpstr)
     subparser.add_buf_hop_size()
     subparser.add_silence()
@@ -156,17 +169,61 @@ def parser_add_subcommand_cut(subparsers):
     subparser.add_verbose_help()
     subparser.set_defaults(process=process_cut)
 
+def parser_add_subcommand_batch(subparsers):
+    # batch subcommand
+    subparser = subparsers.add_parser('batch',
+            help='run an analysis on many files, on several threads')
+    subparser.add_argument("analysis",
+            choices=['onset', 'beat', 'tempo', 'notes', 'pitch'],
+            help="analysis to run on each file")
+    subparser.add_argument("source_uris", nargs='*', metavar="<source_uri>",
+            help="input sound files to analyse, or - to read their paths"
+            " from stdin, one per line")
+    subparser.add_argument("-r", "--samplerate",
+            metavar = "<freq>", type=int,
+            action="store", dest="samplerate", default=0,
+            help="samplerate at which the files should be represented")
+    subparser.add_argument("-j", "--jobs",
+            metavar = "<threads>", type=int,
+            action="store", dest="threads", default=0,
+            help="number of threads, 0 for one per processor [default=0]")
+    subparser.add_argument("--cache",
+            metavar = "<dir>", type=str,
+            action="store", dest="cache", default=None,
+            help="existing directory to keep the results in, so that files"
+            " analysed again with the same options are read from it")
+    subparser.add_buf_size(buf_size=1024)
+    subparser.add_hop_size(hop_size=512)
+    subparser.add_method()
+    subparser.add_threshold()
+    subparser.add_silence()
+    subparser.add_output_format(formats=['txt', 'csv', 'jsonl', 'feat'])
+    subparser.add_verbose_help()
+    subparser.set_defaults(process=process_batch)
+
 class AubioArgumentParser(argparse.ArgumentParser):
 
     def add_input(self):
         self.add_argument("source_uri", default=None, nargs='?',
-                help="input sound file to analyse", metavar = "<source_uri>")
+                help="input sound file to analyse, or - to read raw samples"
+                " from the standard input", metavar = "<source_uri>")
         self.add_argument("-i", "--input", dest = "source_uri2",
                 help="input sound file to analyse", metavar = "<source_uri>")
         self.add_argument("-r", "--samplerate",
                 metavar = "<freq>", type=int,
                 action="store", dest="samplerate", default=0,
-                help="samplerate at which the file should be represented")
+                help="samplerate at which the file should be represented,"
+                " or of the raw samples")
+        self.add_argument("--raw-format",
+                choices = ['u8', 's16', 's24', 's32', 'f32', 'f64'],
+                action="store", dest="raw_format", default=None,
+                help="read the input as raw little-endian samples"
+                " [default=s16 when reading from -]")
+        self.add_argument("--raw-channels",
+                metavar = "<channels>", type=int,
+                action="store", dest="raw_channels", default=1,
+                help="number of interleaved channels of the raw samples"
+                " [default=1]")
 
     def add_verbose_help(self):
         self.add_argument("-v", "--verbose",
@@ -239,6 +296,21 @@ class AubioArgumentParser(argparse.ArgumentParser):
                  default=None,
                  help=helpstr)
 
+    def add_output_format(self, formats=['txt', 'csv', 'jsonl', 'npy',
+            'feat']):
+        self.add_argument("--output-format",
+                metavar = "<format>", type=str, choices=formats,
+                action="store", dest="output_format", default='txt',
+                help="results format <%s>; except txt, results are"
+                " written once the whole file was analysed [default=txt]"
+                % '|'.join(formats))
+        self.add_argument("--output-file",
+                metavar = "<path>", type=str,
+                action="store", dest="output_file", default=None,
+                help="file to write the results to [default=stdout]; feat"
+                " results are written to <source_uri>.feat by default, and"
+                " aubio batch takes a directory")
+
     def add_slicer_options(self):
         self.add_argument("-o", "--output", type = str,
                 metavar = "<outputdir>",
@@ -284,12 +356,83 @@ def timefunc(mode):
     else:
         raise ValueError("invalid time format '%s'" % mode)
 
+def timeconv(mode):
+    # numeric counterpart of timefunc, also applies to arrays
+    if mode is None or mode == 'seconds' or mode == 's':
+        return lambda n_frames, samplerate: n_frames / float(samplerate)
+    elif mode == 'ms' or mode == 'milliseconds':
+        return lambda n_frames, samplerate: 1000. * n_frames / samplerate
+    elif mode == 'samples':
+        return lambda n_frames, _samplerate: n_frames
+    else:
+        raise ValueError("invalid time format '%s'" % mode)
+
+# writers of the results, formatting all the rows at once
+
+def _rows_template(fmts, output_format, columns, prefix=''):
+    # prefix is an already formatted first value, such as a file name
+    prefix = prefix.replace('%', '%%')
+    if output_format == 'csv':
+        return prefix + ','.join(fmts) + '\n'
+    items = ['"%s": %s' % (name, fmt) for name, fmt in zip(columns, fmts)]
+    return '{' + prefix + ', '.join(items) + '}\n'
+
+def format_results(results, columns, output_format, time_format=None,
+        prefix=''):
+    """Format an array of results, one row per line, as csv or jsonl.
+
+    The first column is formatted as a time if `columns[0]` is `time`.
+    Missing values, stored as `nan`, are written as `null` in jsonl."""
+    fmts = ['%.9g'] * len(columns)
+    if columns[0] == 'time':
+        fmts[0] = '%d' if time_format == 'samples' else '%.6f'
+    template = _rows_template(fmts, output_format, columns, prefix=prefix)
+    text = (template * len(results)) % tuple(results.ravel().tolist())
+    if output_format == 'jsonl':
+        text = text.replace(': nan', ': null')
+    return text
+
+def write_results(args, results, columns):
+    """Write all the results in `args.output_format` to
+    `args.output_file`, or to the standard output. Feature files are written
+    next to the source by default, see :func:`aubio.save_features`."""
+    import numpy as np
+    if args.output_format == 'npy':
+        if args.output_file is None:
+            np.save(getattr(sys.stdout, 'buffer', sys.stdout), results)
+        else:
+            np.save(args.output_file, results)
+        return
+    if args.output_format == 'feat':
+        path = args.output_file
+        if path is None:
+            path = args.source_uri + '.feat'
+        aubio.save_features(path, results, names=columns,
+                samplerate=args.samplerate,
+                hop_size=getattr(args, 'hop_size', 0))
+        return
+    text = format_results(results, columns, args.output_format,
+            time_format=getattr(args, 'time_format', None))
+    if args.output_format == 'csv':
+        text = ','.join(columns) + '\n' + text
+    if args.output_file is None:
+        sys.stdout.write(text)
+    else:
+        with open(args.output_file, 'w') as f:
+            f.write(text)
+
 # definition of processing classes
 
 class default_process(object):
+    # names of the values of each row of results
+    columns = ['time']
     def __init__(self, args):
         if 'time_format' in args:
             self.time2string = timefunc(args.time_format)
+            self.time2value = timeconv(args.time_format)
+        # rows of results, or arrays of rows, for the formats other than txt
+        self.results = []
+        self.result_blocks = []
         if args.verbose > 2 and hasattr(self, 'options'):
             name = type(self).__name__.split('_')[1]
             optstr = ' '.join(['running', name, 'with options',
@@ -299,6 +442,22 @@ class default_process(object):
         # optionally called at the end of process
         pass
 
+    def flush_res(self, frames_read, samplerate):
+        # called instead of flush when not printing txt
+        pass
+
+    def get_results(self):
+        import numpy as np
+        blocks = list(self.result_blocks)
+        if self.results:
+            blocks.append(np.array(self.results, dtype=np.float64))
+        if not blocks:
+            return np.zeros((0, len(self.columns)))
+        return np.concatenate(blocks)
+
+    def get_columns(self, width):
+        return self.columns
+
     def parse_options(self, args, valid_opts):
         # get any valid options found in a dictionnary of arguments
         options = {k: v for k, v in vars(args).items() if k in valid_opts}
@@ -338,6 +497,10 @@ class process_onset(default_process):
         if res[0] != 0:
             outstr = self.time2string(self.onset.get_last(), samplerate)
             sys.stdout.write(outstr + '\n')
+    def add_res(self, res, _frames_read, samplerate):
+        if res[0] != 0:
+            self.results.append(
+                    (self.time2value(self.onset.get_last(), samplerate),))
 
 class process_pitch(default_process):
     valid_opts = ['method', 'hop_size', 'buf_size', 'samplerate']
@@ -353,9 +516,41 @@ class process_pitch(default_process):
         super(process_pitch, self).__init__(args)
     def __call__(self, block):
         return self.pitch(block)
+    columns = ['time', 'pitch']
     def repr_res(self, res, frames_read, samplerate):
         fmt_out = self.time2string(frames_read, samplerate)
         sys.stdout.write(fmt_out + "%.6f\n" % res[0])
+    def add_res(self, res, frames_read, samplerate):
+        self.results.append((self.time2value(frames_read, samplerate),
+            res[0]))
+    def add_blocks(self, a_source, block_hops=1024):
+        # process many hops per call, without a python loop over the hops;
+        # the results are the same as calling add_res after each hop
+        import numpy as np
+        hop_size = a_source.hop_size
+        samplerate = a_source.samplerate
+        frames_read = 0
+        for block in a_source.blocks(hop_size * block_hops):
+            read = block.shape[-1]
+            n_hops = (read + hop_size - 1) // hop_size
+            if read < n_hops * hop_size:
+                # the source pads its last hop with zeros
+                block = np.append(block,
+                        np.zeros(n_hops * hop_size - read, dtype=block.dtype))
+            self.add_block(block, frames_read, samplerate)
+            frames_read += read
+        if frames_read % hop_size == 0:
+            # the hop loop ends with an empty hop after a full one
+            self.add_block(np.zeros(hop_size, dtype=aubio.float_type),
+                    frames_read, samplerate)
+        return frames_read
+    def add_block(self, block, frames_read, samplerate):
+        import numpy as np
+        pitches = self.pitch.process_block(block)[:, 0]
+        times = frames_read + self.options['hop_size'] \
+                * np.arange(len(pitches))
+        self.result_blocks.append(np.column_stack(
+            [self.time2value(times, samplerate), pitches]))
 
 class process_beat(default_process):
     valid_opts = ['method', 'hop_size', 'buf_size', 'samplerate']
@@ -369,26 +564,40 @@ class process_beat(default_process):
         if res[0] != 0:
             outstr = self.time2string(self.tempo.get_last(), samplerate)
             sys.stdout.write(outstr + '\n')
+    def add_res(self, res, _frames_read, samplerate):
+        if res[0] != 0:
+            self.results.append(
+                    (self.time2value(self.tempo.get_last(), samplerate),))
 
 class process_tempo(process_beat):
+    columns = ['bpm', 'beats']
     def __init__(self, args):
         super(process_tempo, self).__init__(args)
         self.beat_locations = []
     def repr_res(self, res, _frames_read, samplerate):
         if res[0] != 0:
             self.beat_locations.append(self.tempo.get_last_s())
-    def flush(self, frames_read, samplerate):
+    add_res = repr_res
+    def get_bpm(self):
+        # mean of the tempo between the beats, or None if unknown
         import numpy as np
         if len(self.beat_locations) < 2:
+            return None
+        return np.mean(60. / np.diff(self.beat_locations))
+    def flush(self, frames_read, samplerate):
+        median_bpm = self.get_bpm()
+        if median_bpm is None:
             outstr = "unknown bpm"
+        elif len(self.beat_locations) < 10:
+            outstr = "%.2f bpm (uncertain)" % median_bpm
         else:
-            bpms = 60. / np.diff(self.beat_locations)
-            median_bpm = np.mean(bpms)
-            if len(self.beat_locations) < 10:
-                outstr = "%.2f bpm (uncertain)" % median_bpm
-            else:
-                outstr = "%.2f bpm" % median_bpm
+            outstr = "%.2f bpm" % median_bpm
         sys.stdout.write(outstr + '\n')
+    def flush_res(self, frames_read, samplerate):
+        median_bpm = self.get_bpm()
+        if median_bpm is None:
+            median_bpm = float('nan')
+        self.results.append((median_bpm, len(self.beat_locations)))
 
 class process_notes(default_process):
     valid_opts = ['method', 'hop_size', 'buf_size', 'samplerate']
@@ -414,6 +623,19 @@ class process_notes(default_process):
     def flush(self, frames_read, samplerate):
         eof = self.time2string(frames_read, samplerate)
         sys.stdout.write(eof + '\n')
+    columns = ['midi', 'velocity', 'start', 'end']
+    def add_res(self, res, frames_read, samplerate):
+        # a note ends at its note off, or at the start of the next note
+        if (res[2] != 0 or res[0] != 0) and self.results \
+                and self.results[-1][3] is None:
+            self.results[-1][3] = self.time2value(frames_read, samplerate)
+        if res[0] != 0:
+            self.results.append([res[0], res[1],
+                self.time2value(frames_read, samplerate), None])
+    def flush_res(self, frames_read, samplerate):
+        # the last note ends at the end of the file
+        if self.results and self.results[-1][3] is None:
+            self.results[-1][3] = self.time2value(frames_read, samplerate)
 
 class process_mfcc(default_process):
     def __init__(self, args):
@@ -438,6 +660,11 @@ class process_mfcc(default_process):
         fmt_out = self.time2string(frames_read, samplerate)
         fmt_out += ' '.join(["% 9.7f" % f for f in res.tolist()])
         sys.stdout.write(fmt_out + '\n')
+    def add_res(self, res, frames_read, samplerate):
+        self.results.append([self.time2value(frames_read, samplerate)]
+                + res.tolist())
+    def get_columns(self, width):
+        return ['time'] + ['mfcc%d' % i for i in range(width - 1)]
 
 class process_melbands(default_process):
     def __init__(self, args):
@@ -461,6 +688,11 @@ class process_melbands(default_process):
         fmt_out = self.time2string(frames_read, samplerate)
         fmt_out += ' '.join(["% 9.7f" % f for f in res.tolist()])
         sys.stdout.write(fmt_out + '\n')
+    def add_res(self, res, frames_read, samplerate):
+        self.results.append([self.time2value(frames_read, samplerate)]
+                + res.tolist())
+    def get_columns(self, width):
+        return ['time'] + ['band%d' % i for i in range(width - 1)]
 
 class process_quiet(default_process):
     def __init__(self, args):
@@ -494,6 +726,12 @@ class process_quiet(default_process):
         if fmt_out is not None:
             fmt_out += self.time2string(frames_read, samplerate)
             sys.stdout.write(fmt_out + '\n')
+    columns = ['time', 'quiet']
+    def add_res(self, res, frames_read, samplerate):
+        # 1 at the start of a quiet region, 0 at the start of a noisy one
+        if res == -1 or res == 2:
+            self.results.append((self.time2value(frames_read, samplerate),
+                1 if res == 2 else 0))
 
 class process_cut(process_onset):
     def __init__(self, args):
@@ -518,6 +756,98 @@ class process_cut(process_onset):
         info += base_info
         sys.stderr.write(info)
 
+class process_batch(object):
+    # names of the values of each row of results, see aubio.batch
+    columns = {'onset': ['time'], 'beat': ['time'],
+            'tempo': ['bpm', 'confidence'],
+            'notes': ['midi', 'velocity', 'start', 'end'],
+            'pitch': ['time', 'pitch', 'confidence']}
+
+    # called from aubio.batch each time a file was analysed
+    def __init__(self, args, output=None):
+        self.analysis = args.analysis
+        self.verbose = args.verbose
+        self.output_format = args.output_format
+        self.output = output or sys.stdout
+        self.failed = []
+        if self.output_format == 'feat':
+            # one feature file per source, next to it or in output_file
+            self.output_dir = args.output_file
+            self.samplerate = args.samplerate
+            self.hop_size = args.hop_size
+        if self.output_format == 'csv':
+            self.output.write(','.join(['uri'] + self.columns[self.analysis])
+                    + '\n')
+
+    def __call__(self, _index, uri, results):
+        if results is None:
+            self.failed.append(uri)
+            return
+        if self.output_format == 'feat':
+            path = uri + '.feat'
+            if self.output_dir is not None:
+                path = os.path.join(self.output_dir,
+                        os.path.basename(path))
+            aubio.save_features(path, results,
+                    names=self.columns[self.analysis],
+                    samplerate=self.samplerate, hop_size=self.hop_size)
+            return
+        if self.output_format != 'txt':
+            # the file name starts each row
+            if self.output_format == 'csv':
+                prefix = '"%s",' % uri.replace('"', '""')
+            else:
+                prefix = '"uri": %s, ' % json.dumps(uri)
+            self.output.write(format_results(results,
+                self.columns[self.analysis], self.output_format,
+                prefix=prefix))
+            return
+        if self.verbose < 1:
+            return
+        lines = []
+        if self.analysis == 'tempo':
+            bpm, confidence = results[0]
+            lines.append("%s\t%.2f bpm\t%.6f" % (uri, bpm, confidence))
+        else:
+            for row in results:
+                values = "\t".join("%f" % value for value in row)
+                lines.append("%s\t%s" % (uri, values))
+        if lines:
+            sys.stdout.write("\n".join(lines) + "\n")
+            sys.stdout.flush()
+
+def _run_batch(args):
+    uris = []
+    for uri in args.source_uris:
+        if uri == '-':
+            uris += [line.strip() for line in sys.stdin if line.strip()]
+        else:
+            uris.append(uri)
+    if not uris:
+        sys.stderr.write("Error: at least one source is required\n")
+        return 1
+    output = None
+    if args.output_file is not None and args.output_format != 'feat':
+        output = open(args.output_file, 'w')
+    elif args.output_file is not None and not os.path.isdir(args.output_file):
+        sys.stderr.write("Error: %s is not a directory\n" % args.output_file)
+        return 1
+    try:
+        processor = args.process(args, output=output)
+        failed = aubio.batch(uris, args.analysis, processor,
+                method=args.method, buf_size=args.buf_size,
+                hop_size=args.hop_size, samplerate=args.samplerate,
+                threads=args.threads, threshold=args.threshold,
+                silence=args.silence, cache=args.cache)
+    finally:
+        if output is not None:
+            output.close()
+    for uri in processor.failed:
+        sys.stderr.write("failed analysing %s\n" % uri)
+    if args.verbose > 1:
+        sys.stderr.write("analysed %d files\n" % (len(uris) - failed))
+    return 1 if failed else 0
+
 def _cut_slice(options, timestamps):
     # cutting pass
     nstamps = len(timestamps)
@@ -577,29 +907,55 @@ def main():
             sys.exit(0)
         else:
             sys.exit(1)
+    elif args.command == 'batch':
+        try:
+            sys.exit(_run_batch(args))
+        except KeyboardInterrupt:
+            sys.exit(1)
     elif not args.source_uri and not args.source_uri2:
         sys.stderr.write("Error: a source is required\n")
         parser.print_help()
         sys.exit(1)
     elif args.source_uri2 is not None:
         args.source_uri = args.source_uri2
+    output_format = getattr(args, 'output_format', 'txt')
+    raw_format = getattr(args, 'raw_format', None)
+    if args.source_uri == '-' and raw_format is None:
+        raw_format = 's16'
+    if raw_format is not None and not args.samplerate:
+        sys.stderr.write("Error: the samplerate of raw samples is required,"
+                " use -r\n")
+        sys.exit(1)
+    if raw_format is not None:
+        # the raw channels are down-mixed by a_source() anyway
+        source_options = {'channels': args.raw_channels,
+                'format': raw_format}
+    else:
+        # open source_uri, down-mixed, as read by a_source() anyway
+        source_options = {'channels': 1}
     try:
-        # open source_uri
         with aubio.source(args.source_uri, hop_size=args.hop_size,
-                samplerate=args.samplerate) as a_source:
+                samplerate=args.samplerate, **source_options) as a_source:
             # always update args.samplerate to native samplerate, in case
             # source was opened with args.samplerate=0
             args.samplerate = a_source.samplerate
             # create the processor for this subcommand
             processor = args.process(args)
             frames_read = 0
-            while True:
+            # analyse many hops per call if the results are kept for later
+            by_blocks = output_format != 'txt' \
+                    and hasattr(processor, 'add_blocks')
+            if by_blocks:
+                frames_read = processor.add_blocks(a_source)
+            while not by_blocks:
                 # read new block from source
                 block, read = a_source()
                 # execute processor on this block
                 res = processor(block)
-                # print results for this block
-                if args.verbose > 0:
+                # print results for this block, or keep them for later
+                if output_format != 'txt':
+                    processor.add_res(res, frames_read, a_source.samplerate)
+                elif args.verbose > 0:
                     processor.repr_res(res, frames_read, a_source.samplerate)
                 # increment total number of frames read
                 frames_read += read
@@ -607,7 +963,13 @@ def main():
                 if read < a_source.hop_size:
                     break
             # flush the processor if needed
-            processor.flush(frames_read, a_source.samplerate)
+            if output_format == 'txt':
+                processor.flush(frames_read, a_source.samplerate)
+            else:
+                processor.flush_res(frames_read, a_source.samplerate)
+                results = processor.get_results()
+                write_results(args, results,
+                        processor.get_columns(results.shape[1]))
             if args.verbose > 1:
                 fmt_string = "read {:.2f}s"
                 fmt_string += " ({:d} samples in {:d} blocks of {:d})"
@@ -0,0 +1,150 @@
+"""utility routines to read and write feature files
+
+A feature file holds frame-level features, one row per frame, stored
+column by column as aligned 32-bit floats, so that it can be mapped in
+memory and each column read in place. The format is described in
+`src/io/features.h`, and the files can also be written and read from C
+with `aubio_feature_sink_t` and `aubio_feature_source_t`.
+"""
+
+import struct
+import numpy
+
+__all__ = ['save_features', 'load_features', 'feature_file']
+
+_magic = b'aubiofea'
+_version = 1
+_header = struct.Struct('<8sIIQIIQQ16x')
+_align = 64
+
+
+def _aligned(size):
+    return (size + _align - 1) // _align * _align
+
+
+def save_features(path, rows, names=None, samplerate=0, hop_size=0):
+    """Write frame-level features to a feature file.
+
+    Parameters
+    ----------
+    path : str
+        path of the file to write
+    rows : array_like
+        features, one row per frame, of shape `(n_rows, n_columns)`
+    names : :obj:`list` of :obj:`str` (optional)
+        name of each column
+    samplerate : int (optional)
+        samplerate of the analysis, 0 if unknown
+    hop_size : int (optional)
+        number of samples between two rows, 0 if unknown
+
+    Examples
+    --------
+    >>> aubio.save_features('loop.feat', pitches, names=['time', 'pitch'],
+    ...         samplerate=44100, hop_size=512)
+    """
+    rows = numpy.asarray(rows, dtype='<f4')
+    if rows.ndim == 1:
+        rows = rows.reshape(-1, 1)
+    if rows.ndim != 2 or rows.shape[1] < 1:
+        raise ValueError("expected rows of shape (n_rows, n_columns), got %s"
+                % (rows.shape,))
+    n_rows, n_columns = rows.shape
+    if names is None:
+        names = [''] * n_columns
+    if len(names) != n_columns:
+        raise ValueError("got %d names for %d columns"
+                % (len(names), n_columns))
+    names = b''.join(name.encode('utf8') + b'\0' for name in names)
+    offset = _aligned(_header.size + len(names))
+    stride = _aligned(4 * n_rows)
+    with open(path, 'wb') as f:
+        f.write(_header.pack(_magic, _version, n_columns, n_rows,
+            samplerate, hop_size, offset, stride))
+        f.write(names.ljust(offset - _header.size, b'\0'))
+        padding = b'\0' * (stride - 4 * n_rows)
+        for i in range(n_columns):
+            f.write(numpy.ascontiguousarray(rows[:, i]).tobytes())
+            f.write(padding)
+
+
+class feature_file(object):
+    """Features read by :func:`load_features`.
+
+    Attributes
+    ----------
+    names : :obj:`list` of :obj:`str`
+        name of each column
+    columns : numpy.ndarray
+        values, of shape `(n_columns, n_rows)`, one column per line
+    samplerate : int
+        samplerate of the analysis, 0 if unknown
+    hop_size : int
+        number of samples between two rows, 0 if unknown
+    """
+
+    def __init__(self, names, columns, samplerate, hop_size):
+        self.names = names
+        self.columns = columns
+        self.samplerate = samplerate
+        self.hop_size = hop_size
+
+    def __getitem__(self, name):
+        """Return the values of the first column called `name`."""
+        return self.columns[self.names.index(name)]
+
+    def __len__(self):
+        return self.columns.shape[1]
+
+    @property
+    def rows(self):
+        """values, of shape `(n_rows, n_columns)`, one row per line"""
+        return self.columns.T
+
+
+def load_features(path, mmap=True):
+    """Read a feature file.
+
+    Parameters
+    ----------
+    path : str
+        path of the file to read
+    mmap : bool (optional)
+        map the file in memory instead of reading it, so that only the parts
+        used are read
+
+    Returns
+    -------
+    feature_file
+        names and values of the columns
+
+    Examples
+    --------
+    >>> features = aubio.load_features('loop.feat')
+    >>> features['pitch'][1000:1010]
+    """
+    with open(path, 'rb') as f:
+        header = f.read(_header.size)
+        if len(header) < _header.size:
+            raise ValueError("%s is not a feature file" % path)
+        magic, version, n_columns, n_rows, samplerate, hop_size, offset, \
+            stride = _header.unpack(header)
+        if magic != _magic or version != _version:
+            raise ValueError("%s is not a feature file" % path)
+        names = f.read(offset - _header.size).split(b'\0')
+        f.seek(0, 2)
+        size = f.tell()
+    if n_columns < 1 or len(names) <= n_columns or stride < 4 * n_rows \
+            or offset + n_columns * stride > size:
+        raise ValueError("%s is truncated or corrupted" % path)
+    names = [name.decode('utf8') for name in names[:n_columns]]
+    if n_rows == 0:
+        columns = numpy.zeros((n_columns, 0), dtype='<f4')
+    elif mmap:
+        columns = numpy.memmap(path, dtype='<f4', mode='r', offset=offset,
+                shape=(n_columns, stride // 4))[:, :n_rows]
+    else:
+        columns = numpy.fromfile(path, dtype='<f4', offset=offset,
+                count=n_columns * stride // 4)
+        columns = columns.reshape(n_columns, stride // 4)[:, :n_rows]
+    return feature_file(names, columns, samplerate, hop_size)
@@ -1,7 +1,7 @@
 """utility routines to slice sound files at given timestamps"""
 
 import os
-from aubio import source, sink
+from ._aubio import slice_frames
 
 _max_timestamp = 1e120
 
@@ -33,6 +33,9 @@ def slice_source_at_stamps(source_file, timestamps, timestamps_end=None,
     The `hopsize` parameter simply tells :class:`source` to use this
     hopsize and does not change the output slices.
 
+    The source is read only once, and all the slices are written in the
+    same pass by :func:`slice_frames`, each on its own thread.
+
     If `create_first` is True and `timestamps` does not start with `0`, the
     first slice from `0` to `timestamps[0] - 1` will be automatically added.
 
@@ -89,8 +92,6 @@ def slice_source_at_stamps(source_file, timestamps, timestamps_end=None,
     else:
         timestamps_end = [t - 1 for t in timestamps[1:]] + [_max_timestamp]
 
-    regions = list(zip(timestamps, timestamps_end))
-
     source_base_name, _ = os.path.splitext(os.path.basename(source_file))
     if output_dir is not None:
         if not os.path.isdir(output_dir):
@@ -102,52 +103,19 @@ def slice_source_at_stamps(source_file, timestamps, timestamps_end=None,
         timestamp_seconds = timestamp / float(samplerate)
         return source_base_name + "_%011.6f" % timestamp_seconds + '.wav'
 
-    # open source file
-    _source = source(source_file, samplerate, hopsize)
-    samplerate = _source.samplerate
-
-    total_frames = 0
-    slices = []
-
-    while True:
-        # get hopsize new samples from source
-        vec, read = _source.do_multi()
-        # if the total number of frames read will exceed the next region start
-        while regions and total_frames + read >= regions[0][0]:
-            # get next region
-            start_stamp, end_stamp = regions.pop(0)
-            # create a name for the sink
-            new_sink_path = _new_sink_name(source_base_name, start_stamp,
-                                           samplerate)
-            # create its sink
-            _sink = sink(new_sink_path, samplerate, _source.channels)
-            # create a dictionary containing all this
-            new_slice = {'start_stamp': start_stamp, 'end_stamp': end_stamp,
-                         'sink': _sink}
-            # append the dictionary to the current list of slices
-            slices.append(new_slice)
-
-        for current_slice in slices:
-            start_stamp = current_slice['start_stamp']
-            end_stamp = current_slice['end_stamp']
-            _sink = current_slice['sink']
-            # sample index to start writing from new source vector
-            start = max(start_stamp - total_frames, 0)
-            # number of samples yet to written be until end of region
-            remaining = end_stamp - total_frames + 1
-            # not enough frames remaining, time to split
-            if remaining < read:
-                if remaining > start:
-                    # write remaining samples from current region
-                    _sink.do_multi(vec[:, start:remaining], remaining - start)
-                    # close this file
-                    _sink.close()
-            elif read > start:
-                # write all the samples
-                _sink.do_multi(vec[:, start:read], read - start)
-        total_frames += read
-        # remove old slices
-        slices = list(filter(lambda s: s['end_stamp'] > total_frames,
-                             slices))
-        if read < hopsize:
-            break
+    # get the samplerate of the slices, to name them
+    if samplerate == 0:
+        from ._aubio import source
+        _source = source(source_file, samplerate, hopsize)
+        samplerate = _source.samplerate
+        _source.close()
+
+    paths = [_new_sink_name(source_base_name, start_stamp, samplerate)
+             for start_stamp in timestamps]
+    # the slices end after the sample at end_stamp
+    ends = [end_stamp + 1 for end_stamp in timestamps_end]
+    failed = slice_frames(source_file, timestamps, ends, paths,
+                          samplerate=samplerate, hop_size=hopsize)
+    if failed:
+        raise RuntimeError("failed writing %d slices of %s"
+                           % (failed, source_file))
@@ -0,0 +1,264 @@
+"""analysis of many audio streams on a pool of processes
+
+The samples and the results of the analysis are exchanged through shared
+memory: each process owns a ring of slots, which the samples are copied into
+and which the results are read from, so that the processes only send each
+other the position of each block, and never pickle the arrays themselves.
+"""
+
+import os
+import queue
+import threading
+import multiprocessing
+from multiprocessing import shared_memory
+from concurrent.futures import Future
+import numpy
+
+from . import _aubio
+from ._aubio import float_type
+
+__all__ = ['pool']
+
+
+def _attach(name):
+    # only the pool unlinks the memory, see pool.close
+    try:
+        return shared_memory.SharedMemory(name, track=False)
+    except TypeError:
+        # track is new in Python 3.13
+        return shared_memory.SharedMemory(name)
+
+
+def _work(index, analysis, args, frames_info, outputs_info, tasks, done):
+    # run by each process of the pool, until it reads None from tasks
+    frames_shm, outputs_shm = _attach(frames_info[0]), _attach(outputs_info[0])
+    frames = numpy.ndarray(frames_info[1], dtype=float_type,
+            buffer=frames_shm.buf)[index]
+    outputs = numpy.ndarray(outputs_info[1], dtype=float_type,
+            buffer=outputs_shm.buf)[index]
+    hop_size = args[2]
+    objects = {}
+    try:
+        while True:
+            task = tasks.get()
+            if task is None:
+                break
+            stream, slot, n_samples = task
+            if slot is None:
+                objects.pop(stream, None)
+                continue
+            error = None
+            try:
+                if stream not in objects:
+                    objects[stream] = getattr(_aubio, analysis)(*args)
+                objects[stream].process_block(frames[slot, :n_samples],
+                        out=outputs[slot, :n_samples // hop_size])
+            except Exception as e:
+                error = e
+            done.put((index, slot, error))
+    finally:
+        # the views should be released before closing the memory
+        del frames, outputs
+        frames_shm.close()
+        outputs_shm.close()
+
+
+class pool(object):
+    """pool(analysis, method='default', buf_size=512, hop_size=256, \
+samplerate=44100, processes=None, block_hops=256, slots=4, context=None)
+
+    Run an analysis on many streams of samples, on a pool of processes.
+
+    Each stream is analysed by a single process, which keeps its own
+    `analysis` object for it, so that consecutive calls with the same
+    stream continue its analysis. Different streams run in parallel.
+
+    The samples are copied into memory shared with the processes, which
+    write their results next to them, so that no array is pickled.
+
+    Parameters
+    ----------
+    analysis : str
+        name of the class to analyse the streams with, for instance
+        `onset`, `pitch`, `tempo` or `notes`
+    method : str (optional)
+        method of the analysis
+    buf_size : int (optional)
+        buffer size of the analysis
+    hop_size : int (optional)
+        hop size of the analysis
+    samplerate : int (optional)
+        samplerate of the streams
+    processes : int (optional)
+        number of processes, one per processor by default
+    block_hops : int (optional)
+        number of hops in each slot of shared memory
+    slots : int (optional)
+        number of slots of each process; a call waits for a free slot
+        when all of them are being analysed
+    context : str or multiprocessing context (optional)
+        how to start the processes, see :mod:`multiprocessing`
+
+    Examples
+    --------
+    >>> with aubio.pool('onset', 'hfc', 1024, 512) as p:
+    ...     results = [p.submit(client, samples) for client, samples in queue]
+    ...     onsets = [r.result() for r in results]
+    """
+
+    def __init__(self, analysis, method='default', buf_size=512,
+            hop_size=256, samplerate=44100, processes=None, block_hops=256,
+            slots=4, context=None):
+        self.args = (method, buf_size, hop_size, samplerate)
+        self.hop_size = hop_size
+        self.block_hops = block_hops
+        create = getattr(_aubio, analysis, None)
+        if not hasattr(create, 'process_block'):
+            raise ValueError("%s can not be run on a pool" % analysis)
+        out = create(*self.args).process_block(
+                numpy.zeros(hop_size, dtype=float_type))
+        if isinstance(out, tuple):
+            raise ValueError("%s has several outputs, and can not be run on"
+                    " a pool" % analysis)
+        self.analysis = analysis
+        self.out_size = out.shape[1]
+        if not isinstance(context, multiprocessing.context.BaseContext):
+            context = multiprocessing.get_context(context)
+        self.processes = processes or os.cpu_count() or 1
+
+        shape = (self.processes, slots, block_hops * hop_size)
+        size = int(numpy.prod(shape)) * numpy.dtype(float_type).itemsize
+        self._frames_shm = shared_memory.SharedMemory(create=True, size=size)
+        self._frames = numpy.ndarray(shape, dtype=float_type,
+                buffer=self._frames_shm.buf)
+        frames_info = (self._frames_shm.name, shape)
+        shape = (self.processes, slots, block_hops, self.out_size)
+        size = int(numpy.prod(shape)) * numpy.dtype(float_type).itemsize
+        self._outputs_shm = shared_memory.SharedMemory(create=True, size=size)
+        self._outputs = numpy.ndarray(shape, dtype=float_type,
+                buffer=self._outputs_shm.buf)
+        outputs_info = (self._outputs_shm.name, shape)
+
+        # free slots of each process, and the blocks being analysed
+        self._free = [queue.Queue() for _ in range(self.processes)]
+        for free in self._free:
+            for slot in range(slots):
+                free.put(slot)
+        self._pending = {}
+        # the blocks of a call are sent one after the other to its process
+        self._locks = [threading.Lock() for _ in range(self.processes)]
+        self._done = context.SimpleQueue()
+        self._tasks = [context.SimpleQueue() for _ in range(self.processes)]
+        self._workers = [context.Process(target=_work, args=(i, analysis,
+            self.args, frames_info, outputs_info, self._tasks[i],
+            self._done), daemon=True) for i in range(self.processes)]
+        for w in self._workers:
+            w.start()
+        self._collector = threading.Thread(target=self._collect, daemon=True)
+        self._collector.start()
+
+    def _process_of(self, stream):
+        return hash(stream) % self.processes
+
+    def submit(self, stream, samples):
+        """Analyse samples of a stream.
+
+        Parameters
+        ----------
+        stream : hashable and picklable object
+            identifies the stream the samples belong to
+        samples : array_like
+            samples to analyse, a multiple of `hop_size` of them
+
+        Returns
+        -------
+        concurrent.futures.Future
+            future array of shape `(n_hops, out_size)`, with one row per
+            hop, as returned by `process_block`
+
+        Notes
+        -----
+        The calls with the same stream are analysed in the order they were
+        made, as long as they are made from a single thread.
+        """
+        samples = numpy.asarray(samples, dtype=float_type).reshape(-1)
+        hop_size, block_hops = self.hop_size, self.block_hops
+        if len(samples) % hop_size != 0:
+            raise ValueError("got %d samples, expected a multiple of"
+                    " hop_size (%d)" % (len(samples), hop_size))
+        n_hops = len(samples) // hop_size
+        future = Future()
+        result = numpy.empty((n_hops, self.out_size), dtype=float_type)
+        if n_hops == 0:
+            future.set_result(result)
+            return future
+        # future, result, blocks left, first error
+        job = [future, result, (n_hops + block_hops - 1) // block_hops, None]
+        index = self._process_of(stream)
+        with self._locks[index]:
+            for start in range(0, n_hops, block_hops):
+                count = min(block_hops, n_hops - start)
+                slot = self._free[index].get()
+                self._frames[index, slot, :count * hop_size] = \
+                        samples[start * hop_size:(start + count) * hop_size]
+                self._pending[index, slot] = (job, start, count)
+                self._tasks[index].put((stream, slot, count * hop_size))
+        return future
+
+    def process(self, stream, samples):
+        """Analyse samples of a stream and wait for the results.
+
+        Same as `submit(stream, samples).result()`.
+        """
+        return self.submit(stream, samples).result()
+
+    def close_stream(self, stream):
+        """Forget the analysis of a stream.
+
+        The next call with this stream starts a new analysis.
+        """
+        index = self._process_of(stream)
+        with self._locks[index]:
+            self._tasks[index].put((stream, None, 0))
+
+    def _collect(self):
+        # read the results of the processes, until close puts None
+        while True:
+            item = self._done.get()
+            if item is None:
+                break
+            index, slot, error = item
+            job, start, count = self._pending.pop((index, slot))
+            if error is None:
+                job[1][start:start + count] = self._outputs[index, slot, :count]
+            elif job[3] is None:
+                job[3] = error
+            self._free[index].put(slot)
+            job[2] -= 1
+            if job[2] == 0:
+                if job[3] is not None:
+                    job[0].set_exception(job[3])
+                else:
+                    job[0].set_result(job[1])
+
+    def close(self):
+        """Wait for the analyses to complete, and stop the processes."""
+        if self._workers is None:
+            return
+        for tasks in self._tasks:
+            tasks.put(None)
+        for w in self._workers:
+            w.join()
+        self._done.put(None)
+        self._collector.join()
+        self._workers = None
+        del self._frames, self._outputs
+        for shm in (self._frames_shm, self._outputs_shm):
+            shm.close()
+            shm.unlink()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
@@ -21,6 +21,10 @@ aubiodefvalue = {
     'method': '"default"',
     'uri': '"none"',
     'transpose': '0.',
+    'fmin': '55.',
+    'fmax': '7040.',
+    'bins_per_octave': '12',
+    'rate': '60.',
     }
 
 member_types = {
@@ -43,6 +47,15 @@ pytoaubio_fn = {
         #'fmat_t*': 'PyAubio_ArrayToCFmat',
         }
 
+pytoaubio_view_fn = {
+        'fvec_t*': 'PyAubio_ArrayToCFvecView',
+        }
+
+pytoaubio_out_fn = {
+        'fvec_t*': 'PyAubio_ArrayToCFvecOut',
+        'cvec_t*': 'PyAubio_PyCvecToCCvecOut',
+        }
+
 newfromtype_fn = {
         'fvec_t*': 'new_py_fvec',
         'fmat_t*': 'new_py_fmat',
@@ -73,6 +86,22 @@ pyargparse_chars = {
         'cvec_t*': 'O',
         }
 
+# conversion of the arguments of METH_FASTCALL methods, as PyArg_ParseTuple
+# would with the format of pyargparse_chars
+pyfastcall_fn = {
+        'smpl_t': '(smpl_t)PyFloat_AsDouble ({arg})',
+        'uint_t': '(uint_t)PyLong_AsUnsignedLongMask ({arg})',
+        'sint_t': '(sint_t)PyLong_AsLong ({arg})',
+        'char_t*': '(char_t *)PyUnicode_AsUTF8 ({arg})',
+        }
+
+pyfastcall_failed = {
+        'smpl_t': '{name} == -1 && PyErr_Occurred ()',
+        'uint_t': '{name} == (uint_t)-1 && PyErr_Occurred ()',
+        'sint_t': '{name} == -1 && PyErr_Occurred ()',
+        'char_t*': '{name} == NULL',
+        }
+
 objoutsize = {
         'onset': '1',
         'pitch': '1',
@@ -84,8 +113,13 @@ objoutsize = {
         'tempo': '1',
         'filterbank': 'self->n_filters',
         'tss': 'self->buf_size',
+        'hpss': 'self->buf_size',
         'pitchshift': 'self->hop_size',
         'dct': 'self->size',
+        'cqt': 'aubio_cqt_get_n_bins(self->o)',
+        'chroma': 'AUBIO_CHROMA_N_CLASSES',
+        'framerate': 'self->size',
+        'loudness': '3',
         }
 
 objinputsize = {
@@ -98,19 +132,31 @@ objinputsize = {
         'tempo': 'self->hop_size',
         'wavetable': 'self->hop_size',
         'tss': 'self->buf_size / 2 + 1',
+        'hpss': 'self->buf_size / 2 + 1',
         'pitchshift': 'self->hop_size',
+        'loudness': 'self->hop_size',
+        'cqt': 'self->hop_size',
+        'chroma': 'self->buf_size / 2 + 1',
+        'framerate': 'self->size',
         }
 
+# objects not writing an output for each of their inputs
+objnoblock = ['framerate']
+
 def get_name(proto):
+    import re
+    proto = re.sub(r'^\s*const\s+', '', proto)
     name = proto.replace(' *', '* ').split()[1].split('(')[0]
     name = name.replace('*','')
     if name == '': raise ValueError(proto + "gave empty name")
     return name
 
 def get_return_type(proto):
+    """ return type, without const: views returned as 'const fvec_t *' are
+    wrapped as 'fvec_t*' """
     import re
     paramregex = re.compile(r'(\w+ ?\*?).*')
-    outputs = paramregex.findall(proto)
+    outputs = paramregex.findall(re.sub(r'^\s*const\s+', '', proto))
     assert len(outputs) == 1
     return outputs[0].replace(' ', '')
 
@@ -199,6 +245,9 @@ class MappedObject(object):
             out += self.gen_init()
             out += self.gen_del()
             out += self.gen_do()
+            if self.has_process_block():
+                out += self.gen_process_block()
+                out += self.gen_do_any()
             if len(self.prototypes['rdo']):
                 self.do_proto = self.prototypes['rdo'][0]
                 self.do_inputs = [get_params_types_names(self.do_proto)[1]]
@@ -221,17 +270,30 @@ typedef struct{{
     PyObject_HEAD
     // pointer to aubio object
     {longname} *o;
+    // entry point of calls, see Pyaubio_{shortname}_vectorcall
+    vectorcallfunc vectorcall;
+    // held while using o, which is run without the GIL
+    PyThread_type_lock lock;
     // input parameters
     {input_params_list};
     // do input vectors
     {do_inputs_list};
     // output results
-    {struct_outputs};
+    {struct_outputs};{hopper_field}
 }} Py_{shortname};
+
+static PyObject *Pyaubio_{shortname}_vectorcall (PyObject * callable,
+    PyObject *const *args, size_t nargsf, PyObject * kwnames);
 """
         # fmat_t* / fvec_t* / cvec_t* inputs -> full fvec_t /.. struct in Py_{shortname}
         do_inputs_list = "; ".join(get_input_params(self.do_proto)).replace('fvec_t *','fvec_t').replace('fmat_t *', 'fmat_t').replace('cvec_t *', 'cvec_t')
-        return out.format(do_inputs_list = do_inputs_list, **self.__dict__)
+        hopper_field = ""
+        if self.has_process_block():
+            hopper_field = """
+    // samples left by do_any, created on first use
+    aubio_hopper_t *hopper;"""
+        return out.format(do_inputs_list = do_inputs_list,
+                hopper_field = hopper_field, **self.__dict__)
 
     def gen_doc(self):
         sig = []
@@ -278,6 +340,12 @@ Py_{shortname}_new (PyTypeObject * pytype, PyObject * args, PyObject * kwds)
     if (self == NULL) {{
         return NULL;
     }}
+    self->vectorcall = Pyaubio_{shortname}_vectorcall;
+    self->lock = PyThread_allocate_lock ();
+    if (self->lock == NULL) {{
+        Py_DECREF (self);
+        return PyErr_NoMemory ();
+    }}
 """.format(**self.__dict__)
         params = self.input_params
         for p in params:
@@ -395,90 +463,453 @@ Py_{shortname}_del  (Py_{shortname} * self, PyObject * unused)
   if (self->{name}) {{
     {del_out}(self->{name});
   }}""".format(del_out = del_out, name = name)
+        if self.has_process_block():
+            out += """
+  if (self->hopper) {
+    del_aubio_hopper(self->hopper);
+  }"""
         del_fn = get_name(self.del_proto)
         out += """
   if (self->o) {{
     {del_fn}(self->o);
   }}
+  if (self->lock) {{
+    PyThread_free_lock(self->lock);
+  }}
   Py_TYPE(self)->tp_free((PyObject *) self);
 }}
 """.format(del_fn = del_fn)
         return out
 
     def gen_do(self, method = 'do'):
-        out = """
-// do {shortname}
-static PyObject*
-Pyaubio_{shortname}_{method}  (Py_{shortname} * self, PyObject * args)
-{{""".format(method = method, **self.__dict__)
         input_params = self.do_inputs
         output_params = self.do_outputs
         #print input_params
         #print output_params
-        out += """
-    PyObject *outputs;"""
-        for input_param in input_params:
+        py_inputs = ", ".join(["PyObject * py_%s" % p['name']
+            for p in input_params])
+        out = """
+// do {shortname}, once its arguments were parsed
+static PyObject*
+Pyaubio_{shortname}_{method}_run (Py_{shortname} * self, {py_inputs},
+    PyObject * py_out)
+{{
+    PyObject *outputs;""".format(method = method, py_inputs = py_inputs,
+            **self.__dict__)
+        # other inputs than arrays stay in view until the end of the call
+        view_params = [p for p in input_params if p['type'] in pytoaubio_view_fn]
+        for input_param in view_params:
             out += """
-    PyObject *py_{0};""".format(input_param['name'])
-        refs = ", ".join(["&py_%s" % p['name'] for p in input_params])
-        pyparamtypes = "".join([pyargparse_chars[p['type']] for p in input_params])
+    Py_buffer view_{0};""".format(input_param['name'])
+        for output_param in output_params:
+            out += """
+    PyObject *out_{0};""".format(output_param['name'])
         out += """
-    if (!PyArg_ParseTuple (args, "{pyparamtypes}", {refs})) {{
-        return NULL;
-    }}""".format(refs = refs, pyparamtypes = pyparamtypes, **self.__dict__)
+    if (py_out == Py_None) {
+        py_out = NULL;
+    }
+
+    // the input and output vectors are stored in self, keep them until done
+    PyAubio_Lock(self->lock);"""
+        release = ""
         for input_param in input_params:
-            out += """
+            if input_param in view_params:
+                out += """
+
+    if (PyAubio_IsFastVector (py_{0[name]})) {{
+        // a contiguous array of samples, used in place
+        self->{0[name]}.length =
+            (uint_t)PyArray_SIZE ((PyArrayObject *)py_{0[name]});
+        self->{0[name]}.data =
+            (smpl_t *)PyArray_DATA ((PyArrayObject *)py_{0[name]});
+        view_{0[name]}.obj = NULL;
+    }} else if (!{pytoaubio}(py_{0[name]}, &(self->{0[name]}),
+                &view_{0[name]})) {{
+        PyAubio_Unlock(self->lock);
+        return NULL;
+    }}""".format(input_param, pytoaubio = pytoaubio_view_fn[input_param['type']])
+                release += """
+    PyBuffer_Release(&view_{0[name]});""".format(input_param)
+            else:
+                out += """
 
     if (!{pytoaubio}(py_{0[name]}, &(self->{0[name]}))) {{
+        PyAubio_Unlock(self->lock);
         return NULL;
     }}""".format(input_param, pytoaubio = pytoaubio_fn[input_param['type']])
+        # release the views on errors, after converting the inputs
+        fail = release.replace("\n", "\n    ") + """
+        PyAubio_Unlock(self->lock);"""
+        fail2 = fail.replace("\n", "\n    ")
         if self.shortname in objinputsize:
             out += """
 
     if (self->{0[name]}.length != {expected_size}) {{
         PyErr_Format (PyExc_ValueError,
             "input size of {shortname} should be %d, not %d",
-            {expected_size}, self->{0[name]}.length);
+            {expected_size}, self->{0[name]}.length);{fail}
         return NULL;
-    }}""".format(input_param, expected_size = objinputsize[self.shortname], **self.__dict__)
+    }}""".format(input_param, expected_size = objinputsize[self.shortname],
+            fail = fail, **self.__dict__)
         else:
             out += """
 
     // TODO: check input sizes"""
-        for output_param in output_params:
-            out += """
+        out += self.gen_out_tuple_check(fail)
+        for i, output_param in enumerate(output_params):
+            if len(output_params) > 1:
+                py_out = "PyTuple_GET_ITEM (py_out, %d)" % i
+            else:
+                py_out = "py_out"
+            if i == 0:
+                out += """
 
-    Py_INCREF(self->{0[name]});
-    if (!{pytoaubio}(self->{0[name]}, &(self->c_{0[name]}))) {{
+    // results go to out if given, to the outputs stored in self otherwise"""
+            out += """
+    if (!{pytoaubio}(self->{0[name]}, &(self->c_{0[name]}))) {{{fail}
         return NULL;
-    }}""".format(output_param, pytoaubio = pytoaubio_fn[output_param['type']])
+    }}
+    out_{0[name]} = self->{0[name]};
+    if (py_out) {{
+        out_{0[name]} = {py_out};
+        if (!{pytoaubio_out}(out_{0[name]}, self->c_{0[name]}.length,
+                    &(self->c_{0[name]}))) {{{fail2}
+            return NULL;
+        }}
+    }}""".format(output_param, py_out = py_out, fail = fail, fail2 = fail2,
+                pytoaubio = pytoaubio_fn[output_param['type']],
+                pytoaubio_out = pytoaubio_out_fn[output_param['type']])
         do_fn = get_name(self.do_proto)
         inputs = ", ".join(['&(self->'+p['name']+')' for p in input_params])
         c_outputs = ", ".join(["&(self->c_%s)" % p['name'] for p in self.do_outputs])
-        outputs = ", ".join(["self->%s" % p['name'] for p in self.do_outputs])
         out += """
 
+    PyAubio_BEGIN_ALLOW_THREADS
     {do_fn}(self->o, {inputs}, {c_outputs});
+    PyAubio_END_ALLOW_THREADS{release}
 """.format(
-        do_fn = do_fn,
+        do_fn = do_fn, release = release,
         inputs = inputs, c_outputs = c_outputs,
         )
+        for p in self.do_outputs:
+            out += """
+    Py_INCREF(out_{p[name]});""".format(p = p)
         if len(self.do_outputs) > 1:
             out += """
     outputs = PyTuple_New({:d});""".format(len(self.do_outputs))
             for i, p in enumerate(self.do_outputs):
                 out += """
-    PyTuple_SetItem( outputs, {i}, self->{p[name]});""".format(i = i, p = p)
+    PyTuple_SetItem( outputs, {i}, out_{p[name]});""".format(i = i, p = p)
         else:
             out += """
-    outputs = self->{p[name]};""".format(p = self.do_outputs[0])
+    outputs = out_{p[name]};""".format(p = self.do_outputs[0])
         out += """
+    PyAubio_Unlock(self->lock);
 
     return outputs;
+}
+"""
+        out += self.gen_do_call(method)
+        if method == 'do':
+            out += self.gen_vectorcall()
+        return out
+
+    def gen_do_call(self, method):
+        # tp_call and keyword arguments go through the argument parser
+        input_params = self.do_inputs
+        kwlist = ", ".join(['"%s"' % p['name'] for p in input_params])
+        decls = ", ".join(["*py_%s" % p['name'] for p in input_params])
+        refs = ", ".join(["&py_%s" % p['name'] for p in input_params])
+        py_inputs = ", ".join(["py_%s" % p['name'] for p in input_params])
+        pyparamtypes = "".join([pyargparse_chars[p['type']] for p in input_params])
+        return """
+// do {shortname}
+static PyObject*
+Pyaubio_{shortname}_{method}  (Py_{shortname} * self, PyObject * args,
+    PyObject * kwds)
+{{
+    static char *kwlist[] = {{ {kwlist}, "out", NULL }};
+    PyObject {decls}, *py_out = NULL;
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "{pyparamtypes}|$O", kwlist,
+                {refs}, &py_out)) {{
+        return NULL;
+    }}
+    return Pyaubio_{shortname}_{method}_run (self, {py_inputs}, py_out);
 }}
-""".format(
-        outputs = outputs,
-        )
+""".format(method = method, kwlist = kwlist, decls = decls, refs = refs,
+        py_inputs = py_inputs, pyparamtypes = pyparamtypes, **self.__dict__)
+
+    def gen_vectorcall(self):
+        # calls with positional arguments, and optionally out, are run without
+        # packing their arguments in a tuple and parsing them again
+        n_inputs = len(self.do_inputs)
+        args = ", ".join(["args[%d]" % i for i in range(n_inputs)])
+        return """
+// do {shortname}, called without a tuple of arguments
+static PyObject*
+Pyaubio_{shortname}_vectorcall (PyObject * callable, PyObject *const *args,
+    size_t nargsf, PyObject * kwnames)
+{{
+    Py_ssize_t nargs = PyVectorcall_NARGS (nargsf);
+    if (nargs == {n_inputs} && kwnames == NULL) {{
+        return Pyaubio_{shortname}_do_run ((Py_{shortname} *)callable,
+            {args}, NULL);
+    }}
+    if (nargs == {n_inputs} && PyAubio_IsOutKeyword (kwnames)) {{
+        return Pyaubio_{shortname}_do_run ((Py_{shortname} *)callable,
+            {args}, args[{n_inputs}]);
+    }}
+    return PyAubio_Vectorcall (callable, args, nargsf, kwnames,
+        (ternaryfunc)Pyaubio_{shortname}_do);
+}}
+""".format(n_inputs = n_inputs, args = args, **self.__dict__)
+
+    def gen_out_tuple_check(self, cleanup):
+        # several outputs are given to out as a tuple
+        if len(self.do_outputs) < 2:
+            return ""
+        return """
+
+    if (py_out && (!PyTuple_Check (py_out)
+                || PyTuple_GET_SIZE (py_out) != {n})) {{
+        PyErr_SetString (PyExc_ValueError,
+            "out should be a tuple of {n} outputs");{cleanup}
+        return NULL;
+    }}""".format(n = len(self.do_outputs), cleanup = cleanup)
+
+    def has_process_block(self):
+        # objects reading hops of samples into fvec outputs of a known size
+        return self.shortname in objinputsize \
+                and self.shortname in objoutsize \
+                and self.shortname not in objnoblock \
+                and len(self.do_inputs) == 1 \
+                and self.do_inputs[0]['type'] == 'fvec_t*' \
+                and all(p['type'] == 'fvec_t*' for p in self.do_outputs)
+
+    def gen_process_block(self):
+        input_param = self.do_inputs[0]
+        output_params = self.do_outputs
+        out = """
+static char Pyaubio_{shortname}_process_block_doc[] = ""
+"process_block(samples, out=None)\\n"
+"\\n"
+"Process consecutive blocks of samples at once.\\n"
+"\\n"
+"`samples` is an array of shape `(n * hop, )` or `(n, hop)`, where\\n"
+"`hop` is the size of the input of each call. The result holds the\\n"
+"`n` outputs of these calls, one per row. It is written to `out`\\n"
+"when given, which should then be a contiguous array of this shape.\\n"
+"";
+
+// process_block {shortname}
+static PyObject*
+Pyaubio_{shortname}_process_block  (Py_{shortname} * self, PyObject * args,
+    PyObject * kwds)
+{{
+    static char *kwlist[] = {{ "{input}", "out", NULL }};
+    PyObject *py_{input}, *hops, *py_out = NULL;""".format(input = input_param['name'],
+                **self.__dict__)
+        for p in output_params:
+            out += """
+    PyObject *{0[name]}_block;
+    fvec_t c_{0[name]}_hop;""".format(p)
+        out += """
+    fvec_t c_{input}_hop;
+    PyObject *outputs;
+    uint_t i, n_hops;
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "O|$O", kwlist,
+                &py_{input}, &py_out)) {{
+        return NULL;
+    }}
+    if (py_out == Py_None) {{
+        py_out = NULL;
+    }}{tuple_check}
+
+    hops = PyAubio_ArrayToHops (py_{input}, {input_size}, &n_hops);
+    if (!hops) {{
+        return NULL;
+    }}
+    c_{input}_hop.length = {input_size};""".format(input = input_param['name'],
+                input_size = objinputsize[self.shortname],
+                tuple_check = self.gen_out_tuple_check(""))
+        for n, p in enumerate(output_params):
+            cleanup = "".join(["\n        Py_DECREF(%s_block);" % q['name']
+                for q in output_params[:n]])
+            if len(output_params) > 1:
+                py_out = "PyTuple_GET_ITEM (py_out, %d)" % n
+            else:
+                py_out = "py_out"
+            out += """
+
+    if (py_out) {{
+        {0[name]}_block = {py_out};
+        if (!PyAubio_IsValidMatrixOut ({0[name]}_block, n_hops,
+                    {output_size})) {{
+            {0[name]}_block = NULL;
+        }} else {{
+            Py_INCREF({0[name]}_block);
+        }}
+    }} else {{
+        {0[name]}_block = new_py_fmat (n_hops, {output_size});
+    }}
+    if (!{0[name]}_block) {{
+        Py_DECREF(hops);{cleanup}
+        return NULL;
+    }}
+    c_{0[name]}_hop.length = {output_size};""".format(p, cleanup = cleanup,
+                py_out = py_out, output_size = objoutsize[self.shortname])
+        do_fn = get_name(self.do_proto)
+        c_outputs = ", ".join(["&c_%s_hop" % p['name'] for p in output_params])
+        out += """
+
+    PyAubio_Lock(self->lock);
+    PyAubio_BEGIN_ALLOW_THREADS
+    for (i = 0; i < n_hops; i++) {{
+        c_{input}_hop.data = (smpl_t *)PyArray_DATA ((PyArrayObject *)hops)
+            + i * c_{input}_hop.length;""".format(input = input_param['name'])
+        for p in output_params:
+            out += """
+        c_{0[name]}_hop.data = (smpl_t *)PyArray_GETPTR2 (
+            (PyArrayObject *){0[name]}_block, i, 0);""".format(p)
+        out += """
+        {do_fn}(self->o, &c_{input}_hop, {c_outputs});
+    }}
+    PyAubio_END_ALLOW_THREADS
+    PyAubio_Unlock(self->lock);
+    Py_DECREF(hops);
+""".format(do_fn = do_fn, input = input_param['name'], c_outputs = c_outputs)
+        if len(output_params) > 1:
+            out += """
+    outputs = PyTuple_New({:d});""".format(len(output_params))
+            for i, p in enumerate(output_params):
+                out += """
+    PyTuple_SetItem( outputs, {i}, {p[name]}_block);""".format(i = i, p = p)
+        else:
+            out += """
+    outputs = {p[name]}_block;""".format(p = output_params[0])
+        out += """
+
+    if (PyErr_Occurred()) {
+        Py_DECREF(outputs);
+        return NULL;
+    }
+    return outputs;
+}
+"""
+        return out
+
+    def gen_do_any(self):
+        input_param = self.do_inputs[0]
+        output_params = self.do_outputs
+        do_fn = get_name(self.do_proto)
+        out = """
+static char Pyaubio_{shortname}_do_any_doc[] = ""
+"do_any(samples)\\n"
+"\\n"
+"Process samples of any length.\\n"
+"\\n"
+"The samples are appended to the ones left by the previous calls, and\\n"
+"each hop they complete is processed, as `process_block` would. The\\n"
+"result holds the outputs of these hops, one per row, and has no row\\n"
+"when no hop was completed.\\n"
+"";
+
+// hops completed by a call to do_any {shortname}
+typedef struct {{
+    Py_{shortname} *self;
+    uint_t i;""".format(**self.__dict__)
+        for p in output_params:
+            out += """
+    PyObject *{0[name]}_block;""".format(p)
+        out += """
+}} Py_{shortname}_do_any_t;
+
+// called by aubio_hopper_do on each hop, without the GIL
+static void
+Pyaubio_{shortname}_do_any_hop (void *data, const fvec_t *hop)
+{{
+    Py_{shortname}_do_any_t *d = (Py_{shortname}_do_any_t *)data;
+    Py_{shortname} *self = d->self;""".format(**self.__dict__)
+        for p in output_params:
+            out += """
+    fvec_t c_{0[name]}_hop;
+    c_{0[name]}_hop.length = {output_size};
+    c_{0[name]}_hop.data = (smpl_t *)PyArray_GETPTR2 (
+        (PyArrayObject *)d->{0[name]}_block, d->i, 0);""".format(p,
+                output_size = objoutsize[self.shortname])
+        c_outputs = ", ".join(["&c_%s_hop" % p['name'] for p in output_params])
+        out += """
+    {do_fn}(self->o, hop, {c_outputs});
+    d->i++;
+}}
+
+// do_any {shortname}
+static PyObject*
+Pyaubio_{shortname}_do_any (Py_{shortname} * self, PyObject * args)
+{{
+    PyObject *py_{input}, *outputs;
+    fvec_t c_{input};
+    Py_buffer view_{input};
+    Py_{shortname}_do_any_t d;
+    uint_t n_hops;
+    if (!PyArg_ParseTuple (args, "O", &py_{input})) {{
+        return NULL;
+    }}
+    if (!PyAubio_ArrayToCFvecView (py_{input}, &c_{input}, &view_{input})) {{
+        return NULL;
+    }}
+
+    PyAubio_Lock(self->lock);
+    if (!self->hopper) {{
+        self->hopper = new_aubio_hopper ({input_size});
+        if (!self->hopper) {{
+            PyAubio_Unlock(self->lock);
+            PyBuffer_Release(&view_{input});
+            return PyErr_NoMemory ();
+        }}
+    }}
+    n_hops = aubio_hopper_get_hops (self->hopper, c_{input}.length);
+    d.self = self;
+    d.i = 0;""".format(do_fn = do_fn, c_outputs = c_outputs,
+                input = input_param['name'],
+                input_size = objinputsize[self.shortname], **self.__dict__)
+        for n, p in enumerate(output_params):
+            cleanup = "".join(["\n        Py_DECREF(d.%s_block);" % q['name']
+                for q in output_params[:n]])
+            out += """
+    d.{0[name]}_block = new_py_fmat (n_hops, {output_size});
+    if (!d.{0[name]}_block) {{
+        PyAubio_Unlock(self->lock);
+        PyBuffer_Release(&view_{input});{cleanup}
+        return NULL;
+    }}""".format(p, cleanup = cleanup, input = input_param['name'],
+                output_size = objoutsize[self.shortname])
+        out += """
+    PyAubio_BEGIN_ALLOW_THREADS
+    aubio_hopper_do (self->hopper, &c_{input}, Pyaubio_{shortname}_do_any_hop,
+        &d);
+    PyAubio_END_ALLOW_THREADS
+    PyAubio_Unlock(self->lock);
+    PyBuffer_Release(&view_{input});
+""".format(input = input_param['name'], **self.__dict__)
+        if len(output_params) > 1:
+            out += """
+    outputs = PyTuple_New({:d});""".format(len(output_params))
+            for i, p in enumerate(output_params):
+                out += """
+    PyTuple_SetItem( outputs, {i}, d.{p[name]}_block);""".format(i = i, p = p)
+        else:
+            out += """
+    outputs = d.{p[name]}_block;""".format(p = output_params[0])
+        out += """
+
+    if (PyErr_Occurred()) {
+        Py_DECREF(outputs);
+        return NULL;
+    }
+    return outputs;
+}
+"""
         return out
 
     def gen_set(self):
@@ -499,22 +930,36 @@ Pyaubio_{shortname}_{method}  (Py_{shortname} * self, PyObject * args)
             pyparamtypes = ''.join([pyargparse_chars[p['type']] for p in params])
             out += """
 static PyObject *
-Pyaubio_{shortname}_set_{param} (Py_{shortname} *self, PyObject *args)
+Pyaubio_{shortname}_set_{param} (Py_{shortname} *self, PyObject *const *args,
+    Py_ssize_t nargs)
 {{
   uint_t err = 0;
   {paramdecls}
 """.format(param = param, paramdecls = paramdecls, **self.__dict__)
 
-            if len(refs) and len(pyparamtypes):
-                out += """
+            out += """
 
-  if (!PyArg_ParseTuple (args, "{pyparamtypes}", {refs})) {{
+  if (nargs != {n}) {{
+    PyErr_Format (PyExc_TypeError,
+        "set_{param}() takes exactly {n} {arguments} (%zd given)", nargs);
     return NULL;
-  }}
-""".format(pyparamtypes = pyparamtypes, refs = refs)
+  }}""".format(n = len(params), param = param,
+        arguments = "argument" if len(params) == 1 else "arguments")
+            for i, p in enumerate(params):
+                out += """
+  {name} = {convert};
+  if ({failed}) {{
+    return NULL;
+  }}""".format(name = p['name'],
+                convert = pyfastcall_fn[p['type']].format(arg = "args[%d]" % i),
+                failed = pyfastcall_failed[p['type']].format(name = p['name']))
+            out += """
+"""
 
             out += """
+  PyAubio_Lock(self->lock);
   err = aubio_{shortname}_set_{param} (self->o {paramlist});
+  PyAubio_Unlock(self->lock);
 
   if (err > 0) {{
     if (PyErr_Occurred() == NULL) {{
@@ -548,17 +993,69 @@ Pyaubio_{shortname}_set_{param} (Py_{shortname} *self, PyObject *args)
             param = method_name.split('aubio_'+self.shortname+'_get_')[-1]
             paramtype = get_return_type(method)
             ptypeconv = pyfromtype_fn[paramtype]
+            if paramtype.endswith('*'):
+                out += self.gen_get_view(param, paramtype, ptypeconv)
+                continue
             out += """
 static PyObject *
 Pyaubio_{shortname}_get_{param} (Py_{shortname} *self, PyObject *unused)
 {{
-  {ptype} {param} = aubio_{shortname}_get_{param} (self->o);
+  {ptype} {param};
+  PyAubio_Lock(self->lock);
+  {param} = aubio_{shortname}_get_{param} (self->o);
+  PyAubio_Unlock(self->lock);
   return (PyObject *){ptypeconv} ({param});
 }}
 """.format(param = param, ptype = paramtype, ptypeconv = ptypeconv,
         **self.__dict__)
+        if self.has_memory_usage():
+            out += """
+static PyObject *
+Pyaubio_{shortname}___sizeof__ (Py_{shortname} *self, PyObject *unused)
+{{
+  Py_ssize_t size = Py_TYPE(self)->tp_basicsize;
+  PyAubio_Lock(self->lock);
+  size += aubio_{shortname}_get_memory_usage (self->o);
+  PyAubio_Unlock(self->lock);
+  return PyLong_FromSsize_t (size);
+}}
+""".format(**self.__dict__)
         return out
 
+    def gen_get_view(self, param, paramtype, ptypeconv):
+        """ getter of a vector owned by the object, returned as an array
+        reading its memory, or None if the getter returned NULL """
+        return """
+static PyObject *
+Pyaubio_{shortname}_get_{param} (Py_{shortname} *self, PyObject *unused)
+{{
+  const {ctype} *{param};
+  PyObject *view;
+  PyAubio_Lock(self->lock);
+  {param} = aubio_{shortname}_get_{param} (self->o);
+  PyAubio_Unlock(self->lock);
+  if (!{param}) {{
+    Py_RETURN_NONE;
+  }}
+  view = (PyObject *){ptypeconv} (({ctype} *){param});
+  if (!view) {{
+    return NULL;
+  }}
+  // keep self->o alive as long as the view
+  Py_INCREF (self);
+  if (PyArray_SetBaseObject ((PyArrayObject *)view, (PyObject *)self) < 0) {{
+    Py_DECREF (view);
+    return NULL;
+  }}
+  return view;
+}}
+""".format(param = param, ctype = paramtype[:-1], ptypeconv = ptypeconv,
+        **self.__dict__)
+
+    def has_memory_usage(self):
+        name = 'aubio_%s_get_memory_usage' % self.shortname
+        return any(get_name(m) == name for m in self.prototypes['get'])
+
     def gen_methodef(self):
         out = """
 static PyMethodDef Py_{shortname}_methods[] = {{""".format(**self.__dict__)
@@ -566,8 +1063,8 @@ static PyMethodDef Py_{shortname}_methods[] = {{""".format(**self.__dict__)
             name = get_name(m)
             shortname = name.replace('aubio_%s_' % self.shortname, '')
             out += """
-  {{"{shortname}", (PyCFunction) Py{name},
-    METH_VARARGS, ""}},""".format(name = name, shortname = shortname)
+  {{"{shortname}", (PyCFunction)(void(*)(void)) Py{name},
+    METH_FASTCALL, ""}},""".format(name = name, shortname = shortname)
         for m in self.prototypes['get']:
             name = get_name(m)
             shortname = name.replace('aubio_%s_' % self.shortname, '')
@@ -579,7 +1076,18 @@ static PyMethodDef Py_{shortname}_methods[] = {{""".format(**self.__dict__)
             shortname = name.replace('aubio_%s_' % self.shortname, '')
             out += """
   {{"{shortname}", (PyCFunction) Py{name},
-    METH_VARARGS, ""}},""".format(name = name, shortname = shortname)
+    METH_VARARGS | METH_KEYWORDS, ""}},""".format(name = name, shortname = shortname)
+        if self.has_memory_usage():
+            out += """
+  {{"__sizeof__", (PyCFunction) Pyaubio_{shortname}___sizeof__,
+    METH_NOARGS, ""}},""".format(shortname = self.shortname)
+        if self.has_process_block():
+            out += """
+  {{"process_block", (PyCFunction) Pyaubio_{shortname}_process_block,
+    METH_VARARGS | METH_KEYWORDS, Pyaubio_{shortname}_process_block_doc}},
+  {{"do_any", (PyCFunction) Pyaubio_{shortname}_do_any,
+    METH_VARARGS, Pyaubio_{shortname}_do_any_doc}},""".format(
+                shortname = self.shortname)
         out += """
   {NULL} /* sentinel */
 };
@@ -596,7 +1104,7 @@ PyTypeObject Py_{shortname}Type = {{
   sizeof (Py_{shortname}),
   0,
   (destructor) Py_{shortname}_del,
-  0,
+  offsetof (Py_{shortname}, vectorcall),
   0,
   0,
   0,
@@ -610,7 +1118,7 @@ PyTypeObject Py_{shortname}Type = {{
   0,
   0,
   0,
-  Py_TPFLAGS_DEFAULT,
+  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_VECTORCALL,
   Py_{shortname}_doc,
   0,
   0,
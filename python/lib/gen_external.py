@@ -17,8 +17,12 @@ default_skip_objects = [
     'pvoc',
     'filter',
     'filterbank',
+    'filterbank_iir', # fmat_t output
+    'decimator', # output length depends on the input
+    'interpolator',
     # AUBIO_UNSTABLE
     'hist',
+    'digest',
     'parameter',
     'scale',
     'beattracking',
@@ -45,6 +49,31 @@ default_skip_objects = [
     'audio_unit',
     'spectral_whitening',
     'timestretch', # TODO fix parsing of uint_t *read in _do
+    'batch', # in ext/py-batch.c
+    'onset_offline', # analyses a file, _do takes its path
+    'pitch_offline', # analyses a file, _do takes its path
+    'feature_sink', # _do_multi takes an fmat_t, see aubio.features
+    'feature_source', # reads rows, see aubio.features
+    'slicer', # in ext/py-slicer.c
+    'rthost', # takes a function pointer, and is meant for C hosts
+    'arena', # allocators are set from C, see utils/allocator.h
+    'workspace', # set from C, like the allocators
+    'specdesc_multi', # output length depends on the methods
+    'waveform', # fmat_t levels, read from files
+    'events', # arrays of aubio_event_t, drained from C
+    'history', # kept by onset, tempo and filterbank, read from them
+    'wavetable_bank', # setters take the index of a voice
+    'clip', # shared through synth/samplecache.h, used by sampler
+    'convolver', # created from an impulse response
+    'sdft', # setters take the index of a bin
+    'hopper', # takes a function pointer, used by do_any
+    'tempo_q15', # reads s16_t samples, meant for microcontrollers
+    'gpu', # device handle, attached with the set_gpu functions
+    'graph', # _do has no output, the outputs are read by index
+    'specenc', # in ext/py-specenc.c, frames of bytes
+    'beatsync', # _do_tempo reads an aubio_tempo_t, meant for C hosts
+    'mrpvoc', # _do has no cvec output, the spectra are read by index
+    'ringbuffer', # shares frames between threads, meant for C hosts
 ]
 
 
@@ -213,6 +242,11 @@ def generate_lib_from_c_declarations(cpp_objects, c_declarations):
     '''
     lib = {}
 
+    # all objects, including skipped ones, so that the functions of
+    # aubio_foo_bar_t are not taken for methods of aubio_foo_t
+    all_objects = [a.split()[3][:-3] for a in c_declarations
+            if a.startswith('typedef struct _aubio')]
+
     for o in cpp_objects:
         shortname = o
         if o[:6] == 'aubio_':
@@ -223,13 +257,20 @@ def generate_lib_from_c_declarations(cpp_objects, c_declarations):
         lib[shortname]['shortname'] = shortname
 
         fullshortname = o[:-2]  # name without _t suffix
+        longer_names = [n for n in all_objects
+                if n.startswith(fullshortname + '_')]
 
         for fn in c_declarations:
             func_name = fn.split('(')[0].strip().split(' ')[-1]
+            if any(func_name.startswith(n + '_') for n in longer_names):
+                continue
             if func_name.startswith(fullshortname + '_') or func_name.endswith(fullshortname):
                 # print "found", shortname, "in", fn
                 if 'typedef struct ' in fn:
                     lib[shortname]['struct'].append(fn)
+                elif '_batch' in fn:
+                    # batches of frames are given as fmat_t, not wrapped
+                    lib[shortname]['other'].append(fn)
                 elif '_do' in fn:
                     lib[shortname]['do'].append(fn)
                 elif '_rdo' in fn:
@@ -238,8 +279,15 @@ def generate_lib_from_c_declarations(cpp_objects, c_declarations):
                     lib[shortname]['new'].append(fn)
                 elif 'del_' in fn:
                     lib[shortname]['del'].append(fn)
+                elif '_get_' in fn and (',' in fn or '_get_events' in fn):
+                    # getters filling an output argument, or returning an
+                    # event queue, are not wrapped
+                    lib[shortname]['other'].append(fn)
                 elif '_get_' in fn:
                     lib[shortname]['get'].append(fn)
+                elif '_set_gpu' in fn or '_set_events' in fn:
+                    # devices and event queues are attached from C
+                    lib[shortname]['other'].append(fn)
                 elif '_set_' in fn:
                     lib[shortname]['set'].append(fn)
                 else:
@@ -293,25 +341,16 @@ def generate_external(header=header, output_path=output_path, usedouble=False, o
 
     out = source_header
     out += "#include \"aubio-generated.h\""
-    check_types = "\n     ||  ".join(["PyType_Ready(&Py_%sType) < 0" % o for o in lib])
+    type_entries = "".join(["""
+  {{"{name}", &Py_{name}Type}},""".format(name=o) for o in lib])
     out += """
 
-int generated_types_ready (void)
-{{
-  return ({pycheck_types});
-}}
-""".format(pycheck_types=check_types)
-
-    add_types = "".join(["""
-  Py_INCREF (&Py_{name}Type);
-  PyModule_AddObject(m, "{name}", (PyObject *) & Py_{name}Type);""".format(name=o) for o in lib])
-    out += """
-
-void add_generated_objects ( PyObject *m )
-{{
-{add_types}
-}}
-""".format(add_types=add_types)
+// the types are readied and added to the module on first use, see
+// Py_aubio_getattr in aubiomodule.c
+const aubio_generated_type_t aubio_generated_types[] = {{{type_entries}
+  {{NULL, NULL}}
+}};
+""".format(type_entries=type_entries)
 
     output_file = os.path.join(output_path, 'aubio-generated.c')
     with open(output_file, 'w') as f:
@@ -332,8 +371,13 @@ void add_generated_objects ( PyObject *m )
 """
     out += """
 {objlist}
-int generated_objects ( void );
-void add_generated_objects( PyObject *m );
+typedef struct {{
+  const char *name;
+  PyTypeObject *type;
+}} aubio_generated_type_t;
+
+// NULL terminated list of the generated types
+extern const aubio_generated_type_t aubio_generated_types[];
 """.format(objlist=objlist)
 
     output_file = os.path.join(output_path, 'aubio-generated.h')
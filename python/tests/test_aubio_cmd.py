@@ -1,7 +1,12 @@
 #! /usr/bin/env python
 
-from numpy.testing import TestCase
+import sys
+import json
+import tempfile
+from numpy.testing import TestCase, assert_equal, assert_almost_equal
+from numpy import array, load, nan
 import aubio.cmd
+from utils import get_default_test_sound
 
 class aubio_cmd(TestCase):
 
@@ -29,6 +34,84 @@ class aubio_cmd_utils(TestCase):
         self.assertEqual(aubio.cmd.samples2samples(3200, 32000),
                 "3200\t")
 
+    def test_format_results_csv(self):
+        results = array([[0.5, 440.], [1., nan]])
+        self.assertEqual(aubio.cmd.format_results(results, ['time', 'pitch'],
+                'csv'), "0.500000,440\n1.000000,nan\n")
+
+    def test_format_results_jsonl(self):
+        results = array([[0.5, 440.], [1., nan]])
+        lines = aubio.cmd.format_results(results, ['time', 'pitch'],
+                'jsonl', prefix='"uri": "a.wav", ').splitlines()
+        self.assertEqual(json.loads(lines[0]),
+                {"uri": "a.wav", "time": 0.5, "pitch": 440.})
+        self.assertEqual(json.loads(lines[1])["pitch"], None)
+
+    def test_format_results_samples(self):
+        results = array([[512., 1.5]])
+        self.assertEqual(aubio.cmd.format_results(results, ['time', 'pitch'],
+                'csv', time_format='samples'), "512,1.5\n")
+
+class aubio_cmd_output_format(TestCase):
+
+    def setUp(self):
+        self.source_file = get_default_test_sound(self)
+
+    def run_cmd(self, *args):
+        output = tempfile.NamedTemporaryFile(suffix='.out')
+        argv = sys.argv
+        stdout = sys.stdout
+        sys.argv = ['aubio'] + list(args)
+        sys.stdout = open(output.name, 'w')
+        try:
+            aubio.cmd.main()
+        finally:
+            sys.stdout.close()
+            sys.argv = argv
+            sys.stdout = stdout
+        with open(output.name) as f:
+            return f.read()
+
+    def test_pitch_csv_same_as_txt(self):
+        txt = self.run_cmd('pitch', self.source_file)
+        expected = array([l.split() for l in txt.splitlines()], dtype=float)
+        csv = self.run_cmd('pitch', self.source_file, '--output-format=csv')
+        lines = csv.splitlines()
+        self.assertEqual(lines[0], 'time,pitch')
+        values = array([l.split(',') for l in lines[1:]], dtype=float)
+        assert_almost_equal(values, expected, decimal=5)
+
+    def test_onset_npy_same_as_txt(self):
+        txt = self.run_cmd('onset', self.source_file, '-T', 'samples')
+        expected = [int(l) for l in txt.split()]
+        with tempfile.NamedTemporaryFile(suffix='.npy') as f:
+            self.run_cmd('onset', self.source_file, '-T', 'samples',
+                    '--output-format=npy', '--output-file', f.name)
+            results = load(f.name)
+        assert_equal(results.shape, (len(expected), 1))
+        assert_equal(results[:, 0], expected)
+
+    def test_pitch_feat_same_as_npy(self):
+        with tempfile.NamedTemporaryFile(suffix='.npy') as f:
+            self.run_cmd('pitch', self.source_file, '--output-format=npy',
+                    '--output-file', f.name)
+            expected = load(f.name)
+        with tempfile.NamedTemporaryFile(suffix='.feat') as f:
+            self.run_cmd('pitch', self.source_file, '--output-format=feat',
+                    '--output-file', f.name)
+            features = aubio.load_features(f.name)
+        self.assertEqual(features.names, ['time', 'pitch'])
+        assert_almost_equal(features.rows, expected, decimal=5)
+
+    def test_notes_jsonl(self):
+        jsonl = self.run_cmd('notes', self.source_file,
+                '--output-format=jsonl')
+        for line in jsonl.splitlines():
+            note = json.loads(line)
+            self.assertEqual(sorted(note.keys()),
+                    ['end', 'midi', 'start', 'velocity'])
+            assert note['start'] <= note['end']
+
 if __name__ == '__main__':
     from unittest import main
     main()
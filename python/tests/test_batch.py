@@ -0,0 +1,88 @@
+#! /usr/bin/env python
+
+import os
+import shutil
+import tempfile
+from numpy.testing import TestCase, assert_equal
+from aubio import batch, onset, source
+from utils import list_all_sounds
+from _tools import assert_raises, skipTest
+
+list_of_sounds = list_all_sounds('sounds')
+default_test_sound = len(list_of_sounds) and list_of_sounds[0] or None
+
+no_sounds_msg = "no test sounds, add some in 'python/tests/sounds/'!"
+
+class aubio_batch(TestCase):
+
+    def setUp(self):
+        if not default_test_sound:
+            skipTest(no_sounds_msg)
+
+    def collect(self, results):
+        def callback(index, uri, res):
+            results[index] = (uri, res)
+        return callback
+
+    def test_onset_same_as_single_file(self):
+        buf_size, hop_size = 1024, 512
+        s = source(default_test_sound, 0, hop_size)
+        o = onset('default', buf_size, hop_size, s.samplerate)
+        expected = []
+        while True:
+            samples, read = s()
+            if o(samples):
+                expected.append(o.get_last_s())
+            if read < hop_size:
+                break
+        results = {}
+        uris = [default_test_sound] * 4
+        failed = batch(uris, 'onset', self.collect(results),
+                buf_size=buf_size, hop_size=hop_size, threads=2)
+        assert_equal(failed, 0)
+        assert_equal(sorted(results.keys()), list(range(len(uris))))
+        for uri, res in results.values():
+            assert_equal(uri, default_test_sound)
+            assert_equal(res.shape, (len(expected), 1))
+            assert_equal(res[:, 0], expected)
+
+    def test_failed_file(self):
+        results = {}
+        uris = [default_test_sound, 'does_not_exist.wav']
+        failed = batch(uris, 'tempo', self.collect(results))
+        assert_equal(failed, 1)
+        assert_equal(results[0][1].shape, (1, 2))
+        assert results[1][1] is None
+
+    def test_callback_raises(self):
+        def callback(index, uri, res):
+            raise ValueError('stop')
+        with assert_raises(ValueError):
+            batch([default_test_sound] * 3, 'pitch', callback)
+
+    def test_cache(self):
+        cache = tempfile.mkdtemp()
+        try:
+            expected, results = {}, {}
+            assert_equal(batch([default_test_sound], 'onset',
+                self.collect(expected)), 0)
+            for _ in range(2):
+                assert_equal(batch([default_test_sound], 'onset',
+                    self.collect(results), cache=cache), 0)
+                assert_equal(results[0][1], expected[0][1])
+            assert_equal(len(os.listdir(cache)), 1)
+        finally:
+            shutil.rmtree(cache)
+
+    def test_cache_not_a_directory(self):
+        with assert_raises(RuntimeError):
+            batch([default_test_sound], 'onset', self.collect({}),
+                    cache='/this/directory/does/not/exist')
+
+    def test_wrong_analysis(self):
+        with assert_raises(RuntimeError):
+            batch([default_test_sound], 'unknown', self.collect({}))
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
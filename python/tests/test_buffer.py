@@ -0,0 +1,72 @@
+#! /usr/bin/env python
+
+import array
+from numpy.testing import TestCase, assert_equal
+from numpy import random, frombuffer
+from aubio import fft, pvoc, onset, digital_filter, float_type
+from aubio import level_lin, zero_crossing_rate
+from _tools import assert_raises, skipTest
+
+win_s, hop_s = 512, 256
+
+class aubio_buffer(TestCase):
+
+    def setUp(self):
+        if float_type != 'float32':
+            skipTest("array.array('f') holds float32 samples")
+        random.seed(42)
+        self.samples = (random.random(win_s) - .5).astype(float_type)
+        self.raw = self.samples.tobytes()
+
+    def check_same_as_array(self, new_object, samples):
+        expected = new_object()(samples)
+        for buf in [array.array('f', samples), memoryview(samples.tobytes()),
+                samples.tobytes(), bytearray(samples.tobytes())]:
+            res = new_object()(buf)
+            assert_equal(res, expected)
+
+    def test_onset(self):
+        self.check_same_as_array(lambda: onset('default', win_s, hop_s),
+                self.samples[:hop_s])
+
+    def test_filter(self):
+        self.check_same_as_array(lambda: digital_filter(7), self.samples)
+
+    def test_fft(self):
+        expected = fft(win_s)(self.samples)
+        res = fft(win_s)(array.array('f', self.samples))
+        assert_equal(res.norm, expected.norm)
+        assert_equal(res.phas, expected.phas)
+
+    def test_pvoc(self):
+        expected = pvoc(win_s, hop_s)(self.samples[:hop_s]).norm.copy()
+        res = pvoc(win_s, hop_s)(self.raw[:hop_s * 4])
+        assert_equal(res.norm, expected)
+
+    def test_musicutils(self):
+        assert_equal(level_lin(self.raw), level_lin(self.samples))
+        assert_equal(zero_crossing_rate(array.array('f', self.samples)),
+                zero_crossing_rate(self.samples))
+
+    def test_read_only_view(self):
+        samples = frombuffer(self.raw, dtype = float_type)
+        assert_equal(onset('default', win_s, hop_s)(self.raw[:hop_s * 4]),
+                onset('default', win_s, hop_s)(samples[:hop_s]))
+
+    def test_wrong_buffers(self):
+        o = onset('default', win_s, hop_s)
+        with assert_raises(ValueError):
+            o(array.array('d', self.samples[:hop_s]))
+        with assert_raises(ValueError):
+            o(self.raw[:hop_s * 4 - 1])
+        with assert_raises(ValueError):
+            o(b'')
+        with assert_raises(ValueError):
+            o(memoryview(array.array('f', self.samples))[::2])
+        with assert_raises(ValueError):
+            # wrong size
+            o(self.raw)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
@@ -0,0 +1,57 @@
+#! /usr/bin/env python
+
+import numpy as np
+from numpy.testing import TestCase
+import aubio
+
+class aubio_chroma(TestCase):
+
+    def test_init(self):
+        """ test that aubio.chroma() is created with the default parameters """
+        c = aubio.chroma()
+        self.assertEqual(c.fmin, 55.)
+        self.assertEqual(c.fmax, 7040.)
+        self.assertEqual(len(c(aubio.cvec(c.buf_size))), 12)
+
+    def test_wrong_input_size(self):
+        """ test that spectra of the wrong size are rejected """
+        c = aubio.chroma(4096, 55., 4000., 44100)
+        with self.assertRaises(ValueError):
+            c(aubio.cvec(1024))
+
+    def test_wrong_frequencies(self):
+        """ test that creation fails above the Nyquist frequency """
+        with self.assertRaises(RuntimeError):
+            aubio.chroma(4096, 100., 30000., 44100)
+
+    def analyse(self, c, freq):
+        pv = aubio.pvoc(4096, 1024)
+        t = np.arange(1024 * 40) / 44100.
+        signal = (.5 * np.sin(2. * np.pi * freq * t)).astype(aubio.float_type)
+        for i in range(40):
+            out = c(pv(signal[i * 1024:(i + 1) * 1024]))
+        return out
+
+    def test_sine(self):
+        """ test that a sine peaks in its pitch class """
+        c = aubio.chroma(4096, 55., 4000., 44100)
+        out = self.analyse(c, 440. * 2 ** (3 / 12.))
+        self.assertEqual(np.argmax(out), 0)
+        self.assertEqual(out[0], 1.)
+
+    def test_tuning_estimation(self):
+        """ test that the tuning of a detuned sine is estimated """
+        c = aubio.chroma(4096, 55., 4000., 44100)
+        c.set_tuning_estimation(1)
+        self.analyse(c, 440. * 2 ** (25 / 1200.))
+        self.assertAlmostEqual(c.get_tuning(), 25., delta=3.)
+
+    def test_wrong_tuning(self):
+        """ test that the tuning is limited to half a semitone """
+        c = aubio.chroma(4096, 55., 4000., 44100)
+        with self.assertRaises(ValueError):
+            c.set_tuning(60.)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
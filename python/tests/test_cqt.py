@@ -0,0 +1,36 @@
+#! /usr/bin/env python
+
+
+import numpy as np
+from numpy.testing import TestCase
+import aubio
+
+class aubio_cqt(TestCase):
+
+    def test_init(self):
+        """ test that aubio.cqt() is created with the default parameters """
+        c = aubio.cqt()
+        self.assertEqual(c.fmin, 55.)
+        self.assertEqual(c.bins_per_octave, 12)
+        self.assertEqual(len(c(np.zeros(c.hop_size, dtype=aubio.float_type))),
+                85)
+
+    def test_sine(self):
+        """ test that a sine peaks in the bin of its frequency """
+        c = aubio.cqt(110., 3520., 12, 512, 44100)
+        freq = 110. * 2 ** (30 / 12.)
+        t = np.arange(512 * 40) / 44100.
+        signal = (.5 * np.sin(2. * np.pi * freq * t)).astype(aubio.float_type)
+        for i in range(40):
+            out = c(signal[i * 512:(i + 1) * 512])
+        self.assertEqual(np.argmax(out), 30)
+        self.assertAlmostEqual(out[30], .5, places=1)
+
+    def test_wrong_frequencies(self):
+        """ test that creation fails above the Nyquist frequency """
+        with self.assertRaises(RuntimeError):
+            aubio.cqt(100., 30000., 12, 512, 44100)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
@@ -0,0 +1,70 @@
+#! /usr/bin/env python
+
+from numpy.testing import TestCase, assert_equal
+from aubio import save_features, load_features
+import numpy as np
+import os
+import tempfile
+
+
+class aubio_features_test_case(TestCase):
+
+    def setUp(self):
+        fd, self.path = tempfile.mkstemp(suffix='.feat')
+        os.close(fd)
+        self.rows = np.random.rand(1000, 3).astype('float32')
+
+    def tearDown(self):
+        os.remove(self.path)
+
+    def test_save_load(self):
+        save_features(self.path, self.rows, names=['time', 'pitch', ''],
+                samplerate=44100, hop_size=512)
+        features = load_features(self.path)
+        self.assertEqual(features.names, ['time', 'pitch', ''])
+        self.assertEqual(features.samplerate, 44100)
+        self.assertEqual(features.hop_size, 512)
+        self.assertEqual(len(features), 1000)
+        assert_equal(features.columns.shape, (3, 1000))
+        assert_equal(features.rows, self.rows)
+        assert_equal(features['pitch'], self.rows[:, 1])
+
+    def test_load_without_mmap(self):
+        save_features(self.path, self.rows)
+        features = load_features(self.path, mmap=False)
+        self.assertEqual(features.names, ['', '', ''])
+        assert_equal(features.rows, self.rows)
+
+    def test_aligned_columns(self):
+        save_features(self.path, self.rows[:10], names=['a', 'b', 'c'])
+        self.assertEqual(os.path.getsize(self.path), 64 + 64 + 3 * 64)
+
+    def test_single_column(self):
+        save_features(self.path, self.rows[:, 0])
+        assert_equal(load_features(self.path).rows, self.rows[:, :1])
+
+    def test_no_rows(self):
+        save_features(self.path, np.zeros((0, 2)))
+        features = load_features(self.path)
+        assert_equal(features.columns.shape, (2, 0))
+
+    def test_wrong_names(self):
+        with self.assertRaises(ValueError):
+            save_features(self.path, self.rows, names=['time'])
+
+    def test_truncated(self):
+        save_features(self.path, self.rows)
+        with open(self.path, 'r+b') as f:
+            f.truncate(1000)
+        with self.assertRaises(ValueError):
+            load_features(self.path)
+
+    def test_not_a_feature_file(self):
+        with open(self.path, 'w') as f:
+            f.write('not a feature file')
+        with self.assertRaises(ValueError):
+            load_features(self.path)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
@@ -19,11 +19,9 @@ class aubio_filter_test_case(TestCase):
         f = digital_filter (8)
         self.assertRaises ( ValueError, f.set_c_weighting, 44100 )
         f = digital_filter (5)
-        self.assertRaises ( ValueError, f.set_c_weighting, 4000 )
-        f = digital_filter (5)
-        self.assertRaises ( ValueError, f.set_c_weighting, 193000 )
+        self.assertRaises ( ValueError, f.set_c_weighting, 0 )
         f = digital_filter (7)
-        self.assertRaises ( ValueError, f.set_a_weighting, 193000 )
+        self.assertRaises ( ValueError, f.set_a_weighting, 0 )
         f = digital_filter (5)
         self.assertRaises ( ValueError, f.set_a_weighting, 192000 )
 
@@ -86,6 +84,14 @@ class aubio_filter_test_case(TestCase):
                 44100, 48000, 88200, 96000, 192000]:
             f.set_c_weighting(sr)
 
+    def test_any_samplerate(self):
+        f = digital_filter(7)
+        for sr in [4000, 12345, 193000, 384000]:
+            f.set_a_weighting(sr)
+        f = digital_filter(5)
+        for sr in [4000, 12345, 193000, 384000]:
+            f.set_c_weighting(sr)
+
 class aubio_filter_wrong_params(TestCase):
 
     def test_negative_order(self):
@@ -68,6 +68,21 @@ class aubio_filterbank_test_case(TestCase):
         assert_equal (coeffs, 0)
         assert_equal (np.shape(coeffs), (40, 512 / 2 + 1))
 
+    def test_bands_history(self):
+        f = filterbank(40, 512)
+        f.set_mel_coeffs_slaney(44100)
+        assert_equal (f.get_bands_history(), None)
+        f.set_history(4)
+        assert_equal (f.get_history(), 4)
+        c = cvec(512)
+        outputs = []
+        for i in range(6):
+            c.norm[:] = np.random.random((int(512 / 2) + 1,)).astype(float_type)
+            outputs.append(np.copy(f(c)))
+        history = f.get_bands_history()
+        assert_equal (np.shape(history), (4, 40))
+        assert_equal (history, outputs[2:])
+
 class aubio_filterbank_wrong_values(TestCase):
 
     def test_negative_window(self):
@@ -0,0 +1,57 @@
+#! /usr/bin/env python
+
+import numpy as np
+from numpy.testing import TestCase, assert_equal
+import aubio
+
+class aubio_framerate(TestCase):
+
+    def test_init(self):
+        """ test that aubio.framerate() is created with its parameters """
+        f = aubio.framerate('max', 40, 256, 44100, 60)
+        self.assertEqual(f.size, 40)
+        self.assertEqual(f.get_rate(), 60)
+
+    def test_mean(self):
+        """ test that the frames of 3 hops are averaged """
+        f = aubio.framerate('mean', 4, 256, 44100, 44100 / 256 / 3)
+        frames = []
+        for i in range(9):
+            out = f(np.full(4, i, dtype=aubio.float_type))
+            if f.get_ready():
+                frames.append(out.copy())
+        assert_equal(np.array(frames)[:, 0], [1, 4, 7])
+
+    def test_max(self):
+        """ test that the frames of 2 hops are pooled to their maximum """
+        f = aubio.framerate('max', 4, 256, 44100, 44100 / 256 / 2)
+        frames = []
+        for i in range(8):
+            out = f(np.full(4, (-1) ** i * i, dtype=aubio.float_type))
+            if f.get_ready():
+                frames.append(out.copy())
+        assert_equal(np.array(frames)[:, 0], [0, 2, 4, 6])
+
+    def test_set_rate(self):
+        f = aubio.framerate('mean', 4, 256, 44100, 30)
+        f.set_rate(60)
+        self.assertEqual(f.get_rate(), 60)
+        with self.assertRaises(ValueError):
+            f.set_rate(44100 / 256 + 1)
+
+    def test_wrong_input_size(self):
+        f = aubio.framerate('mean', 4, 256, 44100, 60)
+        with self.assertRaises(ValueError):
+            f(np.zeros(5, dtype=aubio.float_type))
+
+    def test_wrong_method(self):
+        with self.assertRaises(RuntimeError):
+            aubio.framerate('median', 4, 256, 44100, 60)
+
+    def test_wrong_rate(self):
+        with self.assertRaises(RuntimeError):
+            aubio.framerate('mean', 4, 256, 44100, 1000)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
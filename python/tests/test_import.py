@@ -0,0 +1,56 @@
+#! /usr/bin/env python
+
+import sys
+import subprocess
+from numpy.testing import TestCase
+
+class aubio_import(TestCase):
+
+    def run_python(self, code):
+        # a fresh interpreter, where no class of aubio was used yet
+        return subprocess.check_output([sys.executable, '-c', code]).decode()
+
+    def test_classes_created_on_use(self):
+        code = ("import aubio; "
+                "print('onset' in vars(aubio._aubio)); "
+                "aubio.onset('default', 1024, 256, 44100); "
+                "print('onset' in vars(aubio._aubio))")
+        self.assertEqual(self.run_python(code).split(), ['False', 'True'])
+
+    def test_dir(self):
+        import aubio
+        for name in ['onset', 'pvoc', 'source', 'mfcc', 'cvec', 'fvec']:
+            self.assertIn(name, dir(aubio))
+
+    def test_import_star(self):
+        namespace = {}
+        exec('from aubio import *', namespace)
+        for name in ['onset', 'pvoc', 'source', 'sink', 'digital_filter',
+                     'note2midi', 'fvec']:
+            self.assertIn(name, namespace)
+
+    def test_mfcc_compute(self):
+        # hand written method added when the generated mfcc type is created
+        from aubio import mfcc
+        self.assertTrue(callable(mfcc.compute))
+
+    def test_missing_attribute(self):
+        import aubio
+        with self.assertRaises(AttributeError):
+            aubio.no_such_class
+        with self.assertRaises(ImportError):
+            exec('from aubio import no_such_class', {})
+
+    def test_import_time(self):
+        """ time a fresh import of aubio, once numpy is loaded """
+        code = ("import time, numpy; t = time.perf_counter(); "
+                "import aubio; print(time.perf_counter() - t)")
+        elapsed = min(float(self.run_python(code)) for _ in range(5))
+        print("import aubio: %.2f ms" % (elapsed * 1e3))
+        # only catches gross regressions, such as creating every class
+        # again, on slow machines
+        self.assertLess(elapsed, 2.)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
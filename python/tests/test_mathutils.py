@@ -1,7 +1,7 @@
 #! /usr/bin/env python
 
 from numpy.testing import TestCase, assert_equal
-from numpy import array, arange, isnan, isinf
+from numpy import array, arange, isnan, isinf, zeros
 from aubio import bintomidi, miditobin, freqtobin, bintofreq, freqtomidi, miditofreq
 from aubio import unwrap2pi
 from aubio import fvec
@@ -67,6 +67,22 @@ class aubio_mathutils(TestCase):
         assert_equal ( isinf(b), False )
         assert_equal ( b < 0, False )
 
+    def test_ufuncs_long_arrays(self):
+        # longer than a chunk of the inner loop, in each layout
+        a = arange(-100., 20000., 1.7)
+        for func in [freqtomidi, miditofreq, unwrap2pi]:
+            for dtype in ["float32", "float64"]:
+                x = a.astype(dtype)
+                expected = array([func(v) for v in x[:5000]])
+                assert_equal(func(x)[:5000], expected)
+                assert_equal(func(x[::2]), func(x)[::2])
+                out = zeros(2 * len(x), dtype=dtype)
+                func(x, out=out[::2])
+                assert_equal(out[::2], func(x))
+                y = x.copy()
+                func(y, out=y)
+                assert_equal(y, func(x))
+
     def test_miditobin(self):
         a = list(range(-30, 200)) + [-100000, 10000]
         b = [ miditobin(x, 44100, 512) for x in a ]
@@ -0,0 +1,40 @@
+#! /usr/bin/env python
+
+import sys
+from numpy.testing import TestCase
+import aubio
+
+class aubio_memory_usage(TestCase):
+
+    def test_getsizeof(self):
+        """ test that sys.getsizeof counts the buffers of the objects """
+        for o in [aubio.fft(1024), aubio.pvoc(1024, 512),
+                aubio.filterbank(40, 1024), aubio.digital_filter(7),
+                aubio.onset('default', 1024, 512, 44100),
+                aubio.pitch('yinfft', 2048, 512, 44100),
+                aubio.tempo('default', 1024, 512, 44100)]:
+            self.assertGreater(sys.getsizeof(o), 1024 * 4)
+
+    def test_get_memory_usage(self):
+        """ test that the usage of the C object is part of its size """
+        o = aubio.tempo('default', 1024, 512, 44100)
+        usage = o.get_memory_usage()
+        self.assertGreater(usage, 0)
+        self.assertGreaterEqual(sys.getsizeof(o), usage)
+
+    def test_window_size(self):
+        """ test that larger windows use more memory """
+        small = aubio.pitch('yin', 1024, 512, 44100)
+        large = aubio.pitch('yin', 4096, 512, 44100)
+        self.assertGreater(large.get_memory_usage(), small.get_memory_usage())
+
+    def test_compact(self):
+        """ test that the compact mode of tempo uses less memory """
+        o = aubio.tempo('default', 1024, 512, 44100)
+        usage = o.get_memory_usage()
+        o.set_compact(1)
+        self.assertLess(o.get_memory_usage(), usage)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
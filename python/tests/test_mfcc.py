@@ -2,8 +2,9 @@
 
 from _tools import parametrize, assert_raises
 from numpy import random, count_nonzero
-from numpy.testing import TestCase
-from aubio import mfcc, cvec, float_type
+from numpy.testing import TestCase, assert_almost_equal
+from aubio import mfcc, cvec, float_type, source, pvoc
+from utils import list_all_sounds
 
 buf_size = 2048
 n_filters = 40
@@ -142,6 +143,56 @@ class aubio_mfcc_fb_params(TestCase):
         assert m.get_power() == 1
         assert m.get_scale() == 1
 
+class aubio_mfcc_compute_source(TestCase):
+
+    def test_compute_matches_loop(self):
+        sounds = list_all_sounds('sounds')
+        if not len(sounds):
+            self.skipTest('no sound files found in sounds')
+        buf_size, hop_size = 1024, 512
+        f = source(sounds[0], hop_size=hop_size)
+        p = pvoc(buf_size, hop_size)
+        m = mfcc(buf_size, 40, 13, f.samplerate)
+        expected = []
+        while True:
+            samples, read = f()
+            expected.append(m(p(samples)).copy())
+            if read < hop_size:
+                break
+        g = source(sounds[0], hop_size=hop_size)
+        coeffs = mfcc.compute(g, buf_size=buf_size)
+        assert coeffs.shape == (len(expected), 13)
+        assert_almost_equal(coeffs, expected, decimal=5)
+
+    def test_compute_deltas(self):
+        sounds = list_all_sounds('sounds')
+        if not len(sounds):
+            self.skipTest('no sound files found in sounds')
+        buf_size, hop_size = 1024, 512
+        f = source(sounds[0], hop_size=hop_size)
+        coeffs = mfcc.compute(f, buf_size=buf_size)
+        g = source(sounds[0], hop_size=hop_size)
+        rows = mfcc.compute(g, buf_size=buf_size, deltas=2, delta_width=2)
+        assert rows.shape == (len(coeffs), 39)
+        # delayed by four blocks, the first one repeated before the start
+        assert_almost_equal(rows[4:, :13], coeffs[:-4], decimal=5)
+        assert_almost_equal(rows[:4, :13], [coeffs[0]] * 4, decimal=5)
+        # regression over the blocks 2 before and 2 after, from the third
+        c = coeffs
+        expected = (c[3:-1] - c[1:-3] + 2 * (c[4:] - c[:-4])) / 10.
+        assert_almost_equal(rows[6:, 13:26], expected[:-2], decimal=4)
+
+    def test_compute_wrong_deltas(self):
+        sounds = list_all_sounds('sounds')
+        if not len(sounds):
+            self.skipTest('no sound files found in sounds')
+        with self.assertRaises(ValueError):
+            mfcc.compute(source(sounds[0]), deltas=3)
+
+    def test_compute_wrong_source(self):
+        with self.assertRaises(TypeError):
+            mfcc.compute(cvec(512))
+
 if __name__ == '__main__':
     from _tools import run_module_suite
     run_module_suite()
@@ -4,6 +4,7 @@ import numpy as np
 from numpy.testing import TestCase
 from numpy.testing import assert_equal, assert_almost_equal
 from aubio import window, level_lin, db_spl, silence_detection, level_detection
+from aubio import find_peaks
 from aubio import fvec, float_type
 
 class aubio_window(TestCase):
@@ -83,6 +84,34 @@ class aubio_level_detection(TestCase):
         from numpy import ones
         assert level_detection(ones(1024, dtype = float_type), -70) == 0
 
+class aubio_find_peaks(TestCase):
+    def test_peaks(self):
+        x = fvec([0, 1, 0, 0, 2, 0, 1, 3, 1, 0])
+        assert_equal(find_peaks(x), [1., 4., 7.])
+
+    def test_interpolated(self):
+        x = fvec([0, 1, 2, 1.5, 0])
+        peaks = find_peaks(x)
+        assert len(peaks) == 1
+        assert 2. < peaks[0] < 2.5
+
+    def test_threshold(self):
+        x = fvec([0, 1, 0, 0, 2, 0, 1, 3, 1, 0])
+        assert_equal(find_peaks(x, threshold=1.5), [4., 7.])
+
+    def test_min_distance(self):
+        x = fvec([0, 1, 0, 0, 2, 0, 1, 3, 1, 0])
+        assert_equal(find_peaks(x, min_distance=4), [7.])
+        assert_equal(find_peaks(x, min_distance=3), [1., 4., 7.])
+
+    def test_empty(self):
+        assert len(find_peaks(fvec(1))) == 0
+        assert len(find_peaks(fvec(16))) == 0
+
+    def test_fail_not_fvec(self):
+        with self.assertRaises(ValueError):
+            find_peaks("default")
+
 if __name__ == '__main__':
     from unittest import main
     main()
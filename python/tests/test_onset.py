@@ -10,6 +10,21 @@ class aubio_onset_default(TestCase):
         assert_equal ([o.buf_size, o.hop_size, o.method, o.samplerate],
             [1024,512,'default',44100])
 
+class aubio_onset_history(TestCase):
+
+    def test_descriptor_history(self):
+        o = onset(hop_size = 256, buf_size = 1024)
+        assert_equal (o.get_descriptor_history(), None)
+        o.set_history(8)
+        descriptors = []
+        for i in range(12):
+            o(fvec(256) + .1 * (i % 4 == 0))
+            descriptors.append(o.get_descriptor())
+        history = o.get_descriptor_history()
+        assert_equal (len(history), 8)
+        assert_almost_equal (history, descriptors[4:])
+        assert_equal (len(o.get_thresholded_history()), 8)
+
 class aubio_onset_params(TestCase):
 
     samplerate = 44100
@@ -73,6 +88,13 @@ class aubio_onset_params(TestCase):
         self.o.set_threshold(val)
         assert_almost_equal (self.o.get_threshold(), val)
 
+    def test_set_gating(self):
+        assert_equal (self.o.get_gating(), 0)
+        self.o.set_gating(1)
+        assert_equal (self.o.get_gating(), 1)
+        # a silent hop gives no onset
+        assert_equal (self.o(fvec(self.o.hop_size))[0], 0.)
+
 class aubio_onset_96000(aubio_onset_params):
     samplerate = 96000
 
@@ -87,8 +109,8 @@ class aubio_onset_coverate(TestCase):
 
     def test_all_methods(self):
         for method in ['default', 'energy', 'hfc', 'complexdomain', 'complex',
-                'phase', 'wphase', 'mkl', 'kl', 'specflux', 'specdiff',
-                'old_default']:
+                'phase', 'wphase', 'mkl', 'kl', 'specflux', 'superflux',
+                'specdiff', 'old_default']:
             o = onset(method=method, buf_size=512, hop_size=256)
             o(fvec(256))
 
@@ -0,0 +1,187 @@
+#! /usr/bin/env python
+
+from numpy.testing import TestCase, assert_equal
+from numpy import random, zeros
+from aubio import fvec, cvec, fft, pvoc, filterbank, digital_filter, source
+from aubio import onset, pitch, tss, float_type
+from utils import list_all_sounds
+from _tools import assert_raises, skipTest
+
+list_of_sounds = list_all_sounds('sounds')
+default_test_sound = len(list_of_sounds) and list_of_sounds[0] or None
+
+win_s, hop_s = 512, 256
+
+class aubio_out(TestCase):
+
+    def setUp(self):
+        random.seed(42)
+        self.samples = (random.random(win_s) - .5).astype(float_type)
+
+    def check_fvec_out(self, new_object, samples, length):
+        expected = new_object()(samples).copy()
+        out = fvec(length)
+        res = new_object()(samples, out = out)
+        assert res is out
+        assert_equal(out, expected)
+
+    def check_cvec_out(self, new_object, samples):
+        expected = new_object()(samples)
+        expected = expected.norm.copy(), expected.phas.copy()
+        out = cvec(win_s)
+        res = new_object()(samples, out = out)
+        assert res is out
+        assert_equal(out.norm, expected[0])
+        assert_equal(out.phas, expected[1])
+
+    def test_generated(self):
+        self.check_fvec_out(lambda: onset('default', win_s, hop_s),
+                self.samples[:hop_s], 1)
+        self.check_fvec_out(lambda: pitch('yin', win_s, hop_s),
+                self.samples[:hop_s], 1)
+
+    def test_generated_tuple(self):
+        grain = fft(win_s)(self.samples)
+        trans, stead = tss(win_s, hop_s)(grain)
+        expected = trans.norm.copy(), stead.norm.copy()
+        out = cvec(win_s), cvec(win_s)
+        res = tss(win_s, hop_s)(grain, out = out)
+        assert res[0] is out[0] and res[1] is out[1]
+        assert_equal(out[0].norm, expected[0])
+        assert_equal(out[1].norm, expected[1])
+        with assert_raises(ValueError):
+            tss(win_s, hop_s)(grain, out = out[0])
+
+    def test_fft(self):
+        self.check_cvec_out(lambda: fft(win_s), self.samples)
+        grain = fft(win_s)(self.samples)
+        out = fvec(win_s)
+        res = fft(win_s).rdo(grain, out = out)
+        assert res is out
+        assert_equal(out, fft(win_s).rdo(grain))
+
+    def test_pvoc(self):
+        self.check_cvec_out(lambda: pvoc(win_s, hop_s), self.samples[:hop_s])
+        grain = pvoc(win_s, hop_s)(self.samples[:hop_s])
+        out = fvec(hop_s)
+        res = pvoc(win_s, hop_s).rdo(grain, out = out)
+        assert res is out
+        assert_equal(out, pvoc(win_s, hop_s).rdo(grain))
+
+    def test_filterbank(self):
+        grain = fft(win_s)(self.samples)
+        def new_filterbank():
+            f = filterbank(40, win_s)
+            f.set_mel_coeffs_slaney(16000)
+            return f
+        self.check_fvec_out(new_filterbank, grain, 40)
+
+    def test_filter(self):
+        self.check_fvec_out(lambda: digital_filter(7), self.samples, win_s)
+
+    def test_out_reused(self):
+        o = onset('default', win_s, hop_s)
+        out = fvec(1)
+        for i in range(4):
+            assert o(self.samples[:hop_s], out = out) is out
+
+    def test_out_none(self):
+        o = pvoc(win_s, hop_s)
+        assert_equal(o(self.samples[:hop_s], out = None).length, win_s // 2 + 1)
+
+    def test_wrong_out(self):
+        o = onset('default', win_s, hop_s)
+        with assert_raises(ValueError):
+            o(self.samples[:hop_s], out = fvec(2))
+        with assert_raises(ValueError):
+            o(self.samples[:hop_s], out = zeros(1, dtype = 'float64'))
+        with assert_raises(ValueError):
+            o(self.samples[:hop_s], out = fvec(2)[::2])
+        read_only = fvec(1)
+        read_only.flags.writeable = False
+        with assert_raises(ValueError):
+            o(self.samples[:hop_s], out = read_only)
+        with assert_raises(ValueError):
+            fft(win_s)(self.samples, out = fvec(win_s))
+        with assert_raises(TypeError):
+            # out is a keyword-only argument
+            fft(win_s)(self.samples, cvec(win_s))
+
+    def test_call_arguments(self):
+        samples = self.samples[:hop_s]
+        expected = onset('default', win_s, hop_s)(samples).copy()
+        # positional, keyword, and buffer inputs take different paths
+        assert_equal(onset('default', win_s, hop_s)(samples), expected)
+        assert_equal(onset('default', win_s, hop_s)(input = samples),
+                expected)
+        assert_equal(onset('default', win_s, hop_s)(memoryview(samples)),
+                expected)
+        out = fvec(1)
+        assert onset('default', win_s, hop_s)(input = samples,
+                out = out) is out
+        assert_equal(out, expected)
+        with assert_raises(TypeError):
+            onset('default', win_s, hop_s)()
+        with assert_raises(TypeError):
+            onset('default', win_s, hop_s)(samples, samples)
+        with assert_raises(TypeError):
+            onset('default', win_s, hop_s)(samples, output = out)
+
+    def test_setter_arguments(self):
+        o = onset('default', win_s, hop_s)
+        o.set_threshold(.5)
+        assert_equal(o.get_threshold(), .5)
+        with assert_raises(TypeError):
+            o.set_threshold()
+        with assert_raises(TypeError):
+            o.set_threshold(.5, .5)
+        with assert_raises(TypeError):
+            o.set_threshold('high')
+        with assert_raises(TypeError):
+            o.set_minioi(1.5)
+
+    def test_non_contiguous_input(self):
+        strided = zeros(2 * hop_s, dtype = float_type)[::2]
+        with assert_raises(ValueError):
+            onset('default', win_s, hop_s)(strided)
+        with assert_raises(ValueError):
+            pvoc(win_s, hop_s)(strided)
+
+    def test_process_block(self):
+        samples = (random.random(10 * hop_s) - .5).astype(float_type)
+        expected = onset('default', win_s, hop_s).process_block(samples)
+        out = zeros((10, 1), dtype = float_type)
+        res = onset('default', win_s, hop_s).process_block(samples, out = out)
+        assert res is out
+        assert_equal(out, expected)
+        with assert_raises(ValueError):
+            onset('default', win_s, hop_s).process_block(samples,
+                    out = zeros((9, 1), dtype = float_type))
+
+class aubio_source_out(TestCase):
+
+    def setUp(self):
+        if not default_test_sound:
+            skipTest("no test sounds, add some in 'python/tests/sounds/'!")
+
+    def test_do(self):
+        expected, read = source(default_test_sound, 0, hop_s)()
+        out = fvec(hop_s)
+        res, read_out = source(default_test_sound, 0, hop_s).do(out = out)
+        assert res is out
+        assert_equal(read_out, read)
+        assert_equal(out, expected)
+
+    def test_do_multi(self):
+        s = source(default_test_sound, 0, hop_s)
+        expected, read = s.do_multi()
+        out = zeros((s.channels, hop_s), dtype = float_type)
+        res, _ = source(default_test_sound, 0, hop_s).do_multi(out = out)
+        assert res is out
+        assert_equal(out, expected)
+        with assert_raises(ValueError):
+            source(default_test_sound, 0, hop_s).do_multi(out = out[:, :-1])
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
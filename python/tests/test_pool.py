@@ -0,0 +1,61 @@
+#! /usr/bin/env python
+
+from numpy.testing import TestCase, assert_equal
+from numpy import random, float32
+from aubio import pool, onset, pitch
+from _tools import assert_raises
+
+hop_size = 256
+n_hops = 40
+
+class aubio_pool(TestCase):
+
+    def setUp(self):
+        random.seed(42)
+        self.streams = [((random.random(n_hops * hop_size) - .5) * .5)
+                .astype(float32) for _ in range(3)]
+
+    def test_same_as_process_block(self):
+        half = n_hops // 2 * hop_size
+        with pool('onset', 'default', 512, hop_size, processes=2,
+                block_hops=8, slots=2) as p:
+            # the halves of each stream are analysed by the same object
+            first = [p.submit(i, s[:half]) for i, s in enumerate(self.streams)]
+            second = [p.submit(i, s[half:]) for i, s in enumerate(self.streams)]
+            for i, s in enumerate(self.streams):
+                expected = onset('default', 512, hop_size).process_block(s)
+                assert_equal(first[i].result(), expected[:n_hops // 2])
+                assert_equal(second[i].result(), expected[n_hops // 2:])
+
+    def test_process(self):
+        with pool('pitch', 'yin', 1024, hop_size, processes=2) as p:
+            for i, s in enumerate(self.streams):
+                expected = pitch('yin', 1024, hop_size).process_block(s)
+                assert_equal(p.process(str(i), s), expected)
+
+    def test_close_stream(self):
+        s = self.streams[0]
+        expected = onset('default', 512, hop_size).process_block(s)
+        with pool('onset', 'default', 512, hop_size, processes=1) as p:
+            assert_equal(p.process('a', s), expected)
+            p.close_stream('a')
+            assert_equal(p.process('a', s), expected)
+
+    def test_empty(self):
+        with pool('onset', 'default', 512, hop_size, processes=1) as p:
+            assert_equal(p.process(0, self.streams[0][:0]).shape, (0, 1))
+
+    def test_wrong_size(self):
+        with pool('onset', 'default', 512, hop_size, processes=1) as p:
+            with assert_raises(ValueError):
+                p.submit(0, self.streams[0][:hop_size + 1])
+
+    def test_wrong_analysis(self):
+        with assert_raises(ValueError):
+            pool('fvec_not_an_analysis')
+        with assert_raises(ValueError):
+            pool('fft')
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
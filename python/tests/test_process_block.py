@@ -0,0 +1,99 @@
+#! /usr/bin/env python
+
+from numpy.testing import TestCase, assert_equal
+import numpy as np
+from numpy import random, zeros
+from aubio import onset, pitch, tempo, notes, float_type
+from _tools import assert_raises
+
+hop_size = 256
+n_hops = 40
+
+class aubio_process_block(TestCase):
+
+    def setUp(self):
+        random.seed(42)
+        self.samples = (random.random(n_hops * hop_size) - .5) * .5
+        self.samples = self.samples.astype(float_type)
+
+    def run_hops(self, o):
+        return [o(self.samples[i * hop_size:(i + 1) * hop_size]).copy()
+                for i in range(n_hops)]
+
+    def check_same_as_hops(self, new_object):
+        expected = self.run_hops(new_object())
+        res = new_object().process_block(self.samples)
+        assert_equal(res.shape, (n_hops, len(expected[0])))
+        assert_equal(res, expected)
+        res = new_object().process_block(self.samples.reshape(n_hops, -1))
+        assert_equal(res, expected)
+
+    def test_onset(self):
+        self.check_same_as_hops(lambda: onset('default', 512, hop_size))
+
+    def test_pitch(self):
+        self.check_same_as_hops(lambda: pitch('yin', 1024, hop_size))
+
+    def test_tempo(self):
+        self.check_same_as_hops(lambda: tempo('default', 1024, hop_size))
+
+    def test_notes(self):
+        self.check_same_as_hops(lambda: notes('default', 1024, hop_size))
+
+    def test_strided(self):
+        o = onset('default', 512, hop_size)
+        expected = self.run_hops(o)
+        strided = zeros(2 * n_hops * hop_size, dtype=float_type)
+        strided[::2] = self.samples
+        res = onset('default', 512, hop_size).process_block(strided[::2])
+        assert_equal(res, expected)
+
+    def test_continues_state(self):
+        o = onset('default', 512, hop_size)
+        half = n_hops // 2 * hop_size
+        first = o.process_block(self.samples[:half])
+        second = o.process_block(self.samples[half:])
+        expected = onset('default', 512, hop_size).process_block(self.samples)
+        assert_equal(first, expected[:n_hops // 2])
+        assert_equal(second, expected[n_hops // 2:])
+
+    def test_wrong_size(self):
+        o = onset('default', 512, hop_size)
+        with assert_raises(ValueError):
+            o.process_block(self.samples[:-1])
+        with assert_raises(ValueError):
+            o.process_block(self.samples[:0])
+        with assert_raises(ValueError):
+            o.process_block(self.samples.reshape(2 * n_hops, -1))
+        with assert_raises(ValueError):
+            o.process_block(self.samples.reshape(2, n_hops, -1))
+
+    def test_do_any(self):
+        o = onset('default', 512, hop_size)
+        expected = onset('default', 512, hop_size).process_block(self.samples)
+        res, pos, i = [], 0, 0
+        while pos < len(self.samples):
+            # blocks of audio devices, not a multiple of hop_size
+            size = (480, 441, 1, 1024)[i % 4]
+            res.append(o.do_any(self.samples[pos:pos + size]))
+            pos += size
+            i += 1
+        assert_equal(sum(len(r) for r in res), n_hops)
+        assert_equal(np.concatenate(res), expected)
+
+    def test_do_any_short(self):
+        o = pitch('yin', 1024, hop_size)
+        assert_equal(o.do_any(self.samples[:hop_size - 1]).shape, (0, 1))
+        assert_equal(o.do_any(self.samples[hop_size - 1:hop_size]).shape,
+                (1, 1))
+
+    def test_wrong_type(self):
+        o = onset('default', 512, hop_size)
+        with assert_raises(ValueError):
+            o.process_block(self.samples.astype('int32'))
+        with assert_raises(ValueError):
+            o.process_block(list(self.samples))
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
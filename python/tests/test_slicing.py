@@ -1,10 +1,11 @@
 #! /usr/bin/env python
 
-from numpy.testing import TestCase, assert_equal
-from aubio import slice_source_at_stamps
+from numpy.testing import TestCase, assert_equal, assert_almost_equal
+from aubio import slice_source_at_stamps, slice_frames, source
 from utils import count_files_in_directory, get_default_test_sound
 from utils import count_samples_in_directory, count_samples_in_file
 
+import os
 import tempfile
 import shutil
 
@@ -165,6 +166,41 @@ class aubio_slicing_wrong_ends_test_case(TestCase):
     def tearDown(self):
         shutil.rmtree(self.output_dir)
 
+class aubio_slice_frames_test_case(TestCase):
+
+    def setUp(self):
+        self.source_file = get_default_test_sound(self)
+        self.output_dir = tempfile.mkdtemp(suffix = 'aubio_slicing_test_case')
+
+    def read_all(self, path):
+        return source(path).read_all()
+
+    def test_slice_frames_overlapping(self):
+        # overlapping and unsorted slices, and one until the end of the file
+        starts = [5000, 0, 300]
+        ends = [2**40, 1000, 6000]
+        paths = [os.path.join(self.output_dir, '%d.wav' % i)
+                 for i in range(len(starts))]
+        assert_equal(slice_frames(self.source_file, starts, ends, paths), 0)
+        expected = self.read_all(self.source_file)
+        for start, end, path in zip(starts, ends, paths):
+            assert_almost_equal(self.read_all(path), expected[..., start:end],
+                                decimal=4)
+
+    def test_slice_frames_failed(self):
+        paths = [os.path.join(self.output_dir, 'a.wav'),
+                 os.path.join(self.output_dir, 'missing', 'b.wav')]
+        assert_equal(slice_frames(self.source_file, [0, 0], [10, 10], paths),
+                     1)
+        assert_equal(count_files_in_directory(self.output_dir), 1)
+
+    def test_slice_frames_wrong_lengths(self):
+        with self.assertRaises(ValueError):
+            slice_frames(self.source_file, [0, 10], [10], ['a.wav'])
+
+    def tearDown(self):
+        shutil.rmtree(self.output_dir)
+
 if __name__ == '__main__':
     from unittest import main
     main()
@@ -128,6 +128,16 @@ class Test_aubio_source_read(object):
         b = self.read_from_source(f)
         assert a == b + c
 
+    @parametrize('p', list_of_sounds)
+    def test_set_range(self, p):
+        f = source(p, 0, 0)
+        a = self.read_from_source(f)
+        start = a // 3
+        end = min(a, start + 3 * f.hop_size + 5)
+        f.set_range(start, end)
+        b = self.read_from_source(f)
+        assert_equal(b, end - start)
+
     @parametrize('p', list_of_sounds)
     def test_duration(self, p):
         total_frames = 0
@@ -166,6 +176,13 @@ class Test_aubio_source_wrong_params_with_file(TestCase):
         with assert_raises(ValueError):
             f.seek(-1)
 
+    def test_wrong_range(self):
+        f = source(default_test_sound)
+        with assert_raises(ValueError):
+            f.set_range(100, 100)
+        with assert_raises(ValueError):
+            f.set_range(-1)
+
     def test_wrong_seek_too_large(self):
         f = source(default_test_sound)
         try:
@@ -208,6 +225,27 @@ class Test_aubio_source_with(object):
             # check we read as many samples as we expected
             assert_equal(total_frames, input_source.duration)
 
+class Test_aubio_source_raw(TestCase):
+
+    def test_read_raw(self):
+        import os, tempfile, numpy as np
+        samples = np.linspace(-1, 1, 3000, dtype='<f4').reshape(-1, 2)
+        fd, path = tempfile.mkstemp(suffix='.raw')
+        os.write(fd, samples.tobytes())
+        os.close(fd)
+        try:
+            with source(path, 8000, 256, channels=2, format='f32') as f:
+                assert_equal(f.samplerate, 8000)
+                assert_equal(f.duration, 1500)
+                frames = np.concatenate([b.copy() for b in f], axis=-1)
+                assert_equal(frames, samples.T)
+        finally:
+            os.remove(path)
+
+    def test_raw_without_channels(self):
+        with assert_raises(ValueError):
+            source('-', 8000, 256, format='s16')
+
 if __name__ == '__main__':
     from _tools import run_module_suite
     run_module_suite()
@@ -0,0 +1,73 @@
+#! /usr/bin/env python
+
+from numpy import concatenate, hstack
+from aubio import source
+from utils import list_all_sounds
+from _tools import assert_raises, assert_equal, parametrize
+
+list_of_sounds = list_all_sounds('sounds')
+
+hop_size = 256
+
+all_params = []
+for soundfile in list_of_sounds:
+    for channels in [1, 2]:
+        all_params.append((soundfile, channels))
+
+def read_hops(path, channels):
+    s = source(path, 0, hop_size, channels)
+    hops = [h.copy() for h in s]
+    return hstack(hops) if s.channels > 1 else concatenate(hops)
+
+class Test_aubio_source_read_all(object):
+
+    @parametrize('soundfile, channels', all_params)
+    def test_read_all(self, soundfile, channels):
+        expected = read_hops(soundfile, channels)
+        s = source(soundfile, 0, hop_size, channels)
+        res = s.read_all()
+        assert_equal(res, expected)
+        assert res.flags.c_contiguous
+        # nothing left to read
+        assert_equal(s.read_all().shape[-1], 0)
+
+    @parametrize('soundfile', list_of_sounds)
+    def test_read_all_after_seek(self, soundfile):
+        expected = read_hops(soundfile, 1)
+        s = source(soundfile, 0, hop_size, 1)
+        s.seek(hop_size)
+        assert_equal(s.read_all(), expected[hop_size:])
+
+class Test_aubio_source_blocks(object):
+
+    @parametrize('soundfile, channels', all_params)
+    @parametrize('reuse', [False, True])
+    def test_blocks(self, soundfile, channels, reuse):
+        expected = read_hops(soundfile, channels)
+        s = source(soundfile, 0, hop_size, channels)
+        block_frames = 4 * hop_size
+        blocks = [b.copy() for b in s.blocks(block_frames, reuse = reuse)]
+        for b in blocks[:-1]:
+            assert_equal(b.shape[-1], block_frames)
+        assert 0 < blocks[-1].shape[-1] <= block_frames
+        res = hstack(blocks) if channels > 1 else concatenate(blocks)
+        assert_equal(res, expected)
+
+    @parametrize('soundfile', list_of_sounds)
+    def test_blocks_reuse(self, soundfile):
+        s = source(soundfile, 0, hop_size)
+        it = s.blocks(hop_size, reuse = True)
+        first, second = next(it), next(it)
+        assert first is second
+
+    @parametrize('soundfile', list_of_sounds)
+    def test_blocks_wrong_size(self, soundfile):
+        s = source(soundfile, 0, hop_size)
+        with assert_raises(ValueError):
+            s.blocks(hop_size + 1)
+        with assert_raises(ValueError):
+            s.blocks(0)
+
+if __name__ == '__main__':
+    from _tools import run_module_suite
+    run_module_suite()
@@ -13,6 +13,7 @@ methods = ["default",
      "kl",
      "mkl",
      "specflux",
+     "superflux",
      "centroid",
      "spread",
      "skewness",
@@ -110,6 +111,22 @@ class aubio_specdesc(TestCase):
         c.norm = zeros(c.length, dtype=float_type)
         assert_equal( 0, o(c))
 
+    def test_superflux(self):
+        o = specdesc("superflux")
+        c = cvec()
+        assert_equal( 0., o(c))
+        c.norm = arange(c.length, dtype=float_type)
+        assert o(c) > 0
+        assert_equal( 0, o(c))
+        # a peak moving by one bin is mostly hidden by the maximum filter
+        c.norm = zeros(c.length, dtype=float_type)
+        o(c)
+        c.norm[400] = 1.
+        appearing = o(c)
+        c.norm = zeros(c.length, dtype=float_type)
+        c.norm[401] = 1.
+        assert o(c) < .1 * appearing
+
     def test_centroid(self):
         o = specdesc("centroid")
         c = cvec()
@@ -0,0 +1,69 @@
+#! /usr/bin/env python
+
+from numpy.testing import TestCase, assert_equal
+import numpy as np
+from aubio import specenc, cvec, fvec, float_type
+
+class aubio_specenc_test_case(TestCase):
+
+    def test_members(self):
+        e = specenc(513, 64)
+        assert_equal ([e.input_size, e.n_bins], [513, 64])
+
+    def test_wrong_bins(self):
+        with self.assertRaises(ValueError):
+            specenc(64, 128)
+        with self.assertRaises(ValueError):
+            specenc(64, 0)
+
+    def test_wrong_input_size(self):
+        e = specenc(513, 64)
+        with self.assertRaises(ValueError):
+            e(cvec(512))
+        with self.assertRaises(ValueError):
+            e(fvec(40))
+
+    def test_key_then_deltas(self):
+        e = specenc(513, 64)
+        spec = cvec(1024)
+        spec.norm[100] = 1.
+        frame = e(spec)
+        # header, then one code per band
+        assert_equal (len(frame), 3 + 64)
+        assert_equal (frame[0], 0)
+        assert_equal (bytes(frame[3:]), e.get_levels())
+        # the same spectrum again gives an empty delta frame
+        frame = e(spec)
+        assert_equal (len(frame), 3)
+        assert_equal ([frame[0], frame[1]], [1, 1])
+
+    def test_energies(self):
+        e = specenc(40, 40)
+        e.set_range(-60., 0.)
+        energies = np.zeros(40, dtype=float_type)
+        energies[0] = 1.
+        frame = e(energies)
+        assert_equal (frame[3], 255)
+        assert_equal (frame[4], 0)
+
+    def test_keyframe_interval(self):
+        e = specenc(40, 10)
+        e.set_keyframe_interval(2)
+        energies = np.ones(40, dtype=float_type)
+        types = [e(energies)[0] for _ in range(4)]
+        assert_equal (types, [0, 1, 0, 1])
+        e.reset()
+        assert_equal (e(energies)[0], 0)
+
+    def test_setters(self):
+        e = specenc(40, 10)
+        e.set_log_bins(True)
+        e.set_tolerance(2)
+        with self.assertRaises(ValueError):
+            e.set_tolerance(256)
+        with self.assertRaises(ValueError):
+            e.set_range(0., -10.)
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
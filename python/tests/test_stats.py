@@ -0,0 +1,39 @@
+#! /usr/bin/env python
+
+from numpy.testing import TestCase, assert_equal
+from aubio import stats, onset, fvec
+
+class aubio_stats(TestCase):
+
+    def run_onset(self, n_hops):
+        o = onset('default', 1024, 256, 44100)
+        for _ in range(n_hops):
+            o(fvec(256))
+
+    def test_types(self):
+        self.run_onset(1)
+        for name, counts in stats().items():
+            self.assertIsInstance(name, str)
+            assert_equal(len(counts), 3)
+            calls, cycles, max_cycles = counts
+            self.assertLessEqual(max_cycles, cycles)
+
+    def test_onset_calls(self):
+        stats(reset=True)
+        self.run_onset(10)
+        results = stats(reset=True)
+        if not results:
+            # aubio was built without the profiling option
+            return
+        assert_equal(results['onset'][0], 10)
+        assert_equal(results['pvoc'][0], 10)
+
+    def test_reset(self):
+        self.run_onset(3)
+        stats(reset=True)
+        for calls, cycles, max_cycles in stats().values():
+            assert_equal((calls, cycles, max_cycles), (0, 0, 0))
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
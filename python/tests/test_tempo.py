@@ -67,6 +67,18 @@ class aubio_tempo_params(TestCase):
     def test_get_last_ms(self):
         self.assertEqual(self.o.get_last_ms(), 0.)
 
+    def test_get_next(self):
+        self.assertEqual(self.o.get_next(), 0.)
+
+    def test_get_next_s(self):
+        self.assertEqual(self.o.get_next_s(), 0.)
+
+    def test_get_next_ms(self):
+        self.assertEqual(self.o.get_next_ms(), 0.)
+
+    def test_get_phase(self):
+        self.assertEqual(self.o.get_phase(), 0.)
+
     def test_get_period(self):
         self.assertEqual(self.o.get_period(), 0.)
 
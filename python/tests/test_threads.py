@@ -0,0 +1,98 @@
+#! /usr/bin/env python
+
+from threading import Thread
+from numpy.testing import TestCase, assert_equal
+from numpy import random, float32
+from aubio import fvec, cvec, fft, pvoc, filterbank, digital_filter, onset, pitch
+
+n_threads = 4
+n_blocks = 50
+
+def run_in_threads(target, args_list):
+    errors = []
+    def run(*args):
+        try:
+            target(*args)
+        except Exception as e:
+            errors.append(e)
+    threads = [Thread(target = run, args = args) for args in args_list]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    if errors:
+        raise errors[0]
+
+class aubio_threads(TestCase):
+
+    def setUp(self):
+        random.seed(42)
+        self.blocks = [fvec(random.random(256).astype(float32) - .5)
+                for _ in range(n_blocks)]
+
+    def analyse(self, create, results, index):
+        o = create()
+        out = []
+        for b in self.blocks:
+            r = o(b)
+            # keep a copy, the same output is returned by the next call
+            if hasattr(r, 'norm'):
+                out.append([r.norm.copy(), r.phas.copy()])
+            else:
+                out.append(r.copy())
+        results[index] = out
+
+    def check_same_as_single_thread(self, create):
+        expected = [None]
+        self.analyse(create, expected, 0)
+        results = [None] * n_threads
+        run_in_threads(self.analyse,
+                [(create, results, i) for i in range(n_threads)])
+        for r in results:
+            assert_equal(r, expected[0])
+
+    def test_pvoc(self):
+        self.check_same_as_single_thread(lambda: pvoc(1024, 256))
+
+    def test_digital_filter(self):
+        def create():
+            f = digital_filter(7)
+            f.set_a_weighting(44100)
+            return f
+        self.check_same_as_single_thread(create)
+
+    def test_onset(self):
+        self.check_same_as_single_thread(lambda: onset('hfc', 1024, 256))
+
+    def test_pitch(self):
+        self.check_same_as_single_thread(lambda: pitch('yin', 1024, 256))
+
+    def test_fft_and_filterbank(self):
+        def create():
+            f, fb = fft(256), filterbank(40, 256)
+            fb.set_mel_coeffs_slaney(44100)
+            return lambda x: fb(f(x))
+        self.check_same_as_single_thread(create)
+
+    def test_shared_object(self):
+        # one object used by several threads at once, which run one at a time
+        o = pvoc(1024, 256)
+        def run():
+            for b in self.blocks:
+                o(b)
+        run_in_threads(run, [()] * n_threads)
+
+    def test_shared_cvec(self):
+        # norm is replaced by some threads while others read it
+        c = cvec(512)
+        def run(replace):
+            for b in self.blocks:
+                if replace:
+                    c.norm = fvec(257)
+                else:
+                    assert_equal(c.norm.shape, (257,))
+        run_in_threads(run, [(i % 2,) for i in range(n_threads)])
+
+if __name__ == '__main__':
+    from unittest import main
+    main()
@@ -176,30 +176,64 @@ extern "C"
 #include "fmat.h"
 #include "musicutils.h"
 #include "vecutils.h"
+#include "io/source.h"
+#include "io/sink.h"
+#include "io/slicer.h"
+#include "io/features.h"
 #include "temporal/resampler.h"
 #include "temporal/filter.h"
 #include "temporal/biquad.h"
 #include "temporal/a_weighting.h"
 #include "temporal/c_weighting.h"
+#include "temporal/k_weighting.h"
+#include "temporal/loudness.h"
+#include "temporal/filterbank_iir.h"
+#include "temporal/halfband.h"
+#include "temporal/convolver.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
 #include "spectral/dct.h"
 #include "spectral/phasevoc.h"
+#include "spectral/mrpvoc.h"
 #include "spectral/filterbank.h"
 #include "spectral/filterbank_mel.h"
+#include "spectral/cqt.h"
+#include "spectral/chroma.h"
+#include "spectral/sdft.h"
 #include "spectral/mfcc.h"
 #include "spectral/specdesc.h"
 #include "spectral/awhitening.h"
 #include "spectral/tss.h"
+#include "spectral/hpss.h"
+#include "utils/events.h"
+#include "utils/history.h"
+#include "utils/ringbuffer.h"
+#include "utils/threads.h"
 #include "pitch/pitch.h"
 #include "onset/onset.h"
+#include "onset/onset_offline.h"
 #include "tempo/tempo.h"
+#include "tempo/tempo_q15.h"
+#include "tempo/beatsync.h"
 #include "notes/notes.h"
-#include "io/source.h"
-#include "io/sink.h"
+#include "pitch/pitch_offline.h"
+#include "synth/samplecache.h"
 #include "synth/sampler.h"
 #include "synth/wavetable.h"
 #include "utils/parameter.h"
 #include "utils/log.h"
+#include "utils/batch.h"
+#include "utils/graph.h"
+#include "utils/hopper.h"
+#include "utils/framerate.h"
+#include "utils/rthost.h"
+#include "utils/rtcheck.h"
+#include "utils/denormal.h"
+#include "utils/stats.h"
+#include "utils/allocator.h"
+#include "utils/quantize.h"
+#include "utils/specenc.h"
+#include "utils/waveform.h"
 
 #if AUBIO_UNSTABLE
 #include "mathutils.h"
@@ -0,0 +1,472 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Header-only C++ interface to aubio
+
+  Each object of aubio is owned by a move-only class of the `aubio`
+  namespace, deleted with its `del_aubio_` function when the object goes
+  out of scope. The constructors throw `std::runtime_error` when the `new_`
+  function returned `NULL`.
+
+  Samples are passed as spans of ::smpl_t, `float` unless aubio was built
+  with double precision, such as `std::vector<smpl_t>` or
+  `std::array<smpl_t, N>`. The spans are read and written in place, without
+  copies, through ::fvec_t structures pointing to their data.
+
+  The C objects can still be reached with `get()`, to call the functions
+  not wrapped here.
+
+  @code
+    #include <aubio/aubio.hpp>
+
+    aubio::source src ("loop.wav", 0, 512);
+    aubio::tempo beats ("default", 1024, 512, src.samplerate ());
+    std::vector<smpl_t> hop (512);
+    while (src (hop) == hop.size ()) {
+      if (beats (hop)) std::printf ("%.3f\n", beats.last_s ());
+    }
+  @endcode
+
+  std::span is used with C++20, and a minimal replacement with C++17.
+
+  The classes `fixed_onset`, `fixed_tempo` and `fixed_pitch` take their buffer
+  and hop sizes as template arguments. They only accept spans of exactly
+  `HopSize` samples, so that passing a `std::array` of another length does
+  not compile.
+
+  \example test-aubio_hpp.cpp
+
+*/
+
+#ifndef AUBIO_HPP
+#define AUBIO_HPP
+
+#include "aubio.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L) || __cplusplus >= 202002L
+#if defined(__has_include)
+#if __has_include(<span>)
+#include <span>
+#endif
+#endif
+#endif
+
+namespace aubio {
+
+#if defined(__cpp_lib_span)
+
+using std::span;
+using std::dynamic_extent;
+
+#else /* __cpp_lib_span */
+
+inline constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+/** contiguous elements, the subset of std::span used by this header */
+template <typename T, std::size_t Extent = dynamic_extent>
+class span {
+  template <typename U>
+  using if_convertible = std::enable_if_t<std::is_convertible_v<U (*)[],
+        T (*)[]>, int>;
+  template <std::size_t N>
+  using if_length = std::enable_if_t<Extent == dynamic_extent
+        || Extent == N, int>;
+
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = std::size_t;
+  using pointer = T *;
+  using iterator = T *;
+  static constexpr std::size_t extent = Extent;
+
+  constexpr span () noexcept : data_ (nullptr), size_ (0) {
+    static_assert (Extent == dynamic_extent || Extent == 0,
+        "only spans of no elements can be empty");
+  }
+  constexpr span (T *data, std::size_t size) noexcept
+    : data_ (data), size_ (size) {}
+  template <std::size_t N, if_length<N> = 0>
+  constexpr span (T (&a)[N]) noexcept : data_ (a), size_ (N) {}
+  template <typename U, std::size_t N, if_convertible<U> = 0,
+    if_length<N> = 0>
+  constexpr span (std::array<U, N> &a) noexcept
+    : data_ (a.data ()), size_ (N) {}
+  template <typename U, std::size_t N, if_convertible<const U> = 0,
+    if_length<N> = 0>
+  constexpr span (const std::array<U, N> &a) noexcept
+    : data_ (a.data ()), size_ (N) {}
+  // like std::span, vectors only convert to spans of any length
+  template <typename U, typename A, if_convertible<U> = 0,
+    std::size_t E = Extent, std::enable_if_t<E == dynamic_extent, int> = 0>
+  span (std::vector<U, A> &v) noexcept : data_ (v.data ()), size_ (v.size ()) {}
+  template <typename U, typename A, if_convertible<const U> = 0,
+    std::size_t E = Extent, std::enable_if_t<E == dynamic_extent, int> = 0>
+  span (const std::vector<U, A> &v) noexcept
+    : data_ (v.data ()), size_ (v.size ()) {}
+  template <typename U, std::size_t N, if_convertible<U> = 0,
+    if_length<N> = 0>
+  constexpr span (const span<U, N> &s) noexcept
+    : data_ (s.data ()), size_ (s.size ()) {}
+
+  constexpr T *data () const noexcept { return data_; }
+  constexpr std::size_t size () const noexcept { return size_; }
+  constexpr bool empty () const noexcept { return size_ == 0; }
+  constexpr T *begin () const noexcept { return data_; }
+  constexpr T *end () const noexcept { return data_ + size_; }
+  constexpr T &operator[] (std::size_t i) const noexcept { return data_[i]; }
+
+private:
+  T *data_;
+  std::size_t size_;
+};
+
+#endif /* __cpp_lib_span */
+
+namespace detail {
+
+template <typename T, void (*Delete) (T *)>
+struct deleter {
+  void operator() (T *o) const noexcept { Delete (o); }
+};
+
+/** owner of an object of aubio, moved but never copied */
+template <typename T, void (*Delete) (T *)>
+using handle = std::unique_ptr<T, deleter<T, Delete>>;
+
+template <typename T>
+T *check (T *o, const char *what)
+{
+  if (!o) {
+    throw std::runtime_error (std::string ("aubio: failed creating ") + what);
+  }
+  return o;
+}
+
+inline void check_length (std::size_t length, uint_t expected,
+    const char *what)
+{
+  if (length != expected) {
+    throw std::length_error (std::string ("aubio: ") + what + " expected "
+        + std::to_string (expected) + " samples, got "
+        + std::to_string (length));
+  }
+}
+
+/* a vector pointing to the samples of s; aubio functions taking a const
+   fvec_t never write to it */
+inline fvec_t as_fvec (span<const smpl_t> s) noexcept
+{
+  fvec_t v;
+  v.length = static_cast<uint_t> (s.size ());
+  v.data = const_cast<smpl_t *> (s.data ());
+  return v;
+}
+
+} /* namespace detail */
+
+/** vector of samples allocated by aubio */
+class fvec {
+public:
+  explicit fvec (uint_t length)
+    : o_ (detail::check (new_fvec (length), "fvec")) {}
+
+  fvec_t *get () noexcept { return o_.get (); }
+  const fvec_t *get () const noexcept { return o_.get (); }
+  std::size_t size () const noexcept { return o_->length; }
+  smpl_t *data () noexcept { return o_->data; }
+  const smpl_t *data () const noexcept { return o_->data; }
+  smpl_t &operator[] (std::size_t i) noexcept { return o_->data[i]; }
+  smpl_t operator[] (std::size_t i) const noexcept { return o_->data[i]; }
+  operator span<smpl_t> () noexcept { return { data (), size () }; }
+  operator span<const smpl_t> () const noexcept { return { data (), size () }; }
+
+private:
+  detail::handle<fvec_t, del_fvec> o_;
+};
+
+/** spectrum, as norms and phases, allocated by aubio */
+class cvec {
+public:
+  /** \param length size of the window, holding length / 2 + 1 bins */
+  explicit cvec (uint_t length)
+    : o_ (detail::check (new_cvec (length), "cvec")) {}
+
+  cvec_t *get () noexcept { return o_.get (); }
+  const cvec_t *get () const noexcept { return o_.get (); }
+  std::size_t size () const noexcept { return o_->length; }
+  span<smpl_t> norm () noexcept { return { o_->norm, size () }; }
+  span<const smpl_t> norm () const noexcept { return { o_->norm, size () }; }
+  span<smpl_t> phas () noexcept { return { o_->phas, size () }; }
+  span<const smpl_t> phas () const noexcept { return { o_->phas, size () }; }
+
+private:
+  detail::handle<cvec_t, del_cvec> o_;
+};
+
+/** file, stream or device read block by block, see ::aubio_source_t */
+class source {
+public:
+  source (const char_t *uri, uint_t samplerate, uint_t hop_size)
+    : o_ (detail::check (new_aubio_source (uri, samplerate, hop_size),
+          "source")), hop_size_ (hop_size) {}
+
+  /** read the next hop, downmixed, and return the number of samples read;
+    the end of `out` is zeroed after the last block */
+  uint_t operator() (span<smpl_t> out)
+  {
+    detail::check_length (out.size (), hop_size_, "source");
+    fvec_t v = detail::as_fvec (out);
+    uint_t read = 0;
+    aubio_source_do (o_.get (), &v, &read);
+    return read;
+  }
+
+  uint_t samplerate () const { return aubio_source_get_samplerate (o_.get ()); }
+  uint_t channels () const { return aubio_source_get_channels (o_.get ()); }
+  uint_t duration () const { return aubio_source_get_duration (o_.get ()); }
+  uint_t hop_size () const noexcept { return hop_size_; }
+  /** returns false if the source could not seek to `pos` */
+  bool seek (uint_t pos) { return aubio_source_seek (o_.get (), pos) == 0; }
+  void close () { aubio_source_close (o_.get ()); }
+  aubio_source_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_source_t, del_aubio_source> o_;
+  uint_t hop_size_;
+};
+
+/** file written block by block, see ::aubio_sink_t */
+class sink {
+public:
+  sink (const char_t *uri, uint_t samplerate)
+    : o_ (detail::check (new_aubio_sink (uri, samplerate), "sink")) {}
+
+  /** write all the samples of `in`, as one channel */
+  void operator() (span<const smpl_t> in)
+  {
+    fvec_t v = detail::as_fvec (in);
+    aubio_sink_do (o_.get (), &v, v.length);
+  }
+
+  uint_t samplerate () const { return aubio_sink_get_samplerate (o_.get ()); }
+  void close () { aubio_sink_close (o_.get ()); }
+  aubio_sink_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_sink_t, del_aubio_sink> o_;
+};
+
+/** phase vocoder, see ::aubio_pvoc_t */
+class pvoc {
+public:
+  pvoc (uint_t win_size, uint_t hop_size)
+    : o_ (detail::check (new_aubio_pvoc (win_size, hop_size), "pvoc")),
+      hop_size_ (hop_size) {}
+
+  /** compute the spectrum of the window ending with the `in` hop */
+  void operator() (span<const smpl_t> in, cvec &spectrum)
+  {
+    detail::check_length (in.size (), hop_size_, "pvoc");
+    fvec_t v = detail::as_fvec (in);
+    aubio_pvoc_do (o_.get (), &v, spectrum.get ());
+  }
+
+  /** resynthesize the next hop of `out` from `spectrum` */
+  void inverse (cvec &spectrum, span<smpl_t> out)
+  {
+    detail::check_length (out.size (), hop_size_, "pvoc");
+    fvec_t v = detail::as_fvec (out);
+    aubio_pvoc_rdo (o_.get (), spectrum.get (), &v);
+  }
+
+  aubio_pvoc_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_pvoc_t, del_aubio_pvoc> o_;
+  uint_t hop_size_;
+};
+
+/** onset detection, see ::aubio_onset_t */
+class onset {
+public:
+  onset (const char_t *method, uint_t buf_size, uint_t hop_size,
+      uint_t samplerate)
+    : o_ (detail::check (new_aubio_onset (method, buf_size, hop_size,
+            samplerate), "onset")), out_ (1), hop_size_ (hop_size) {}
+
+  /** analyse the next hop, returns true if it holds an onset */
+  bool operator() (span<const smpl_t> in)
+  {
+    detail::check_length (in.size (), hop_size_, "onset");
+    fvec_t v = detail::as_fvec (in);
+    aubio_onset_do (o_.get (), &v, out_.get ());
+    return out_[0] != 0.;
+  }
+
+  /** time of the last onset, in seconds */
+  smpl_t last_s () const { return aubio_onset_get_last_s (o_.get ()); }
+  smpl_t descriptor () const { return aubio_onset_get_descriptor (o_.get ()); }
+  void set_threshold (smpl_t threshold)
+  {
+    aubio_onset_set_threshold (o_.get (), threshold);
+  }
+  void set_silence (smpl_t silence)
+  {
+    aubio_onset_set_silence (o_.get (), silence);
+  }
+  aubio_onset_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_onset_t, del_aubio_onset> o_;
+  fvec out_;
+  uint_t hop_size_;
+};
+
+/** beat tracking, see ::aubio_tempo_t */
+class tempo {
+public:
+  tempo (const char_t *method, uint_t buf_size, uint_t hop_size,
+      uint_t samplerate)
+    : o_ (detail::check (new_aubio_tempo (method, buf_size, hop_size,
+            samplerate), "tempo")), out_ (2), hop_size_ (hop_size) {}
+
+  /** analyse the next hop, returns true if it holds a beat */
+  bool operator() (span<const smpl_t> in)
+  {
+    detail::check_length (in.size (), hop_size_, "tempo");
+    fvec_t v = detail::as_fvec (in);
+    aubio_tempo_do (o_.get (), &v, out_.get ());
+    return out_[0] != 0.;
+  }
+
+  /** time of the last beat, in seconds */
+  smpl_t last_s () const { return aubio_tempo_get_last_s (o_.get ()); }
+  smpl_t bpm () const { return aubio_tempo_get_bpm (o_.get ()); }
+  smpl_t confidence () const { return aubio_tempo_get_confidence (o_.get ()); }
+  aubio_tempo_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_tempo_t, del_aubio_tempo> o_;
+  fvec out_;
+  uint_t hop_size_;
+};
+
+/** pitch detection, see ::aubio_pitch_t */
+class pitch {
+public:
+  pitch (const char_t *method, uint_t buf_size, uint_t hop_size,
+      uint_t samplerate)
+    : o_ (detail::check (new_aubio_pitch (method, buf_size, hop_size,
+            samplerate), "pitch")), out_ (1), hop_size_ (hop_size) {}
+
+  /** analyse the next hop, returns its pitch in the unit set, Hz by
+    default */
+  smpl_t operator() (span<const smpl_t> in)
+  {
+    detail::check_length (in.size (), hop_size_, "pitch");
+    fvec_t v = detail::as_fvec (in);
+    aubio_pitch_do (o_.get (), &v, out_.get ());
+    return out_[0];
+  }
+
+  smpl_t confidence () const { return aubio_pitch_get_confidence (o_.get ()); }
+  /** returns false if `unit` is unknown */
+  bool set_unit (const char_t *unit)
+  {
+    return aubio_pitch_set_unit (o_.get (), unit) == 0;
+  }
+  void set_silence (smpl_t silence)
+  {
+    aubio_pitch_set_silence (o_.get (), silence);
+  }
+  aubio_pitch_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_pitch_t, del_aubio_pitch> o_;
+  fvec out_;
+  uint_t hop_size_;
+};
+
+/** mel-frequency cepstrum coefficients, see ::aubio_mfcc_t */
+class mfcc {
+public:
+  mfcc (uint_t buf_size, uint_t n_filters, uint_t n_coeffs,
+      uint_t samplerate)
+    : o_ (detail::check (new_aubio_mfcc (buf_size, n_filters, n_coeffs,
+            samplerate), "mfcc")), n_coeffs_ (n_coeffs) {}
+
+  /** compute the coefficients of `spectrum` into `out` */
+  void operator() (const cvec &spectrum, span<smpl_t> out)
+  {
+    detail::check_length (out.size (), n_coeffs_, "mfcc");
+    fvec_t v = detail::as_fvec (out);
+    aubio_mfcc_do (o_.get (), spectrum.get (), &v);
+  }
+
+  aubio_mfcc_t *get () noexcept { return o_.get (); }
+
+private:
+  detail::handle<aubio_mfcc_t, del_aubio_mfcc> o_;
+  uint_t n_coeffs_;
+};
+
+/** analysis object of `BufSize` and `HopSize` samples, fixed at compile
+  time, reading only spans of exactly `HopSize` samples */
+template <typename Analysis, uint_t BufSize, uint_t HopSize>
+class fixed : public Analysis {
+  static_assert (HopSize > 0 && HopSize <= BufSize,
+      "the hop size should be positive and at most the buffer size");
+
+public:
+  static constexpr uint_t buf_size = BufSize;
+  static constexpr uint_t hop_size = HopSize;
+
+  fixed (const char_t *method, uint_t samplerate)
+    : Analysis (method, BufSize, HopSize, samplerate) {}
+
+  auto operator() (span<const smpl_t, HopSize> in)
+  {
+    return Analysis::operator() (span<const smpl_t> (in));
+  }
+};
+
+template <uint_t BufSize, uint_t HopSize>
+using fixed_onset = fixed<onset, BufSize, HopSize>;
+
+template <uint_t BufSize, uint_t HopSize>
+using fixed_tempo = fixed<tempo, BufSize, HopSize>;
+
+template <uint_t BufSize, uint_t HopSize>
+using fixed_pitch = fixed<pitch, BufSize, HopSize>;
+
+} /* namespace aubio */
+
+#endif /* AUBIO_HPP */
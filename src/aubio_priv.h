@@ -110,6 +110,10 @@
 #define aubio_vDSP_minvi      vDSP_minvi
 #define aubio_vDSP_dotpr      vDSP_dotpr
 #define aubio_vDSP_vclr       vDSP_vclr
+#define aubio_vDSP_vthr       vDSP_vthr
+#define aubio_vvexp           vvexpf
+#define aubio_vvlog           vvlogf
+#define aubio_vvlog10         vvlog10f
 #else /* HAVE_AUBIO_DOUBLE */
 #define aubio_vDSP_mmov       vDSP_mmovD
 #define aubio_vDSP_vmul       vDSP_vmulD
@@ -124,6 +128,10 @@
 #define aubio_vDSP_minvi      vDSP_minviD
 #define aubio_vDSP_dotpr      vDSP_dotprD
 #define aubio_vDSP_vclr       vDSP_vclrD
+#define aubio_vDSP_vthr       vDSP_vthrD
+#define aubio_vvexp           vvexp
+#define aubio_vvlog           vvlog
+#define aubio_vvlog10         vvlog10
 #endif /* HAVE_AUBIO_DOUBLE */
 #endif /* HAVE_ACCELERATE */
 
@@ -135,6 +143,7 @@
 #define aubio_cblas_copy      cblas_scopy
 #define aubio_cblas_swap      cblas_sswap
 #define aubio_cblas_dot       cblas_sdot
+#define aubio_cblas_gemm      cblas_sgemm
 #else /* HAVE_AUBIO_DOUBLE */
 #ifdef HAVE_ATLAS
 #define aubio_catlas_set      catlas_dset
@@ -142,6 +151,7 @@
 #define aubio_cblas_copy      cblas_dcopy
 #define aubio_cblas_swap      cblas_dswap
 #define aubio_cblas_dot       cblas_ddot
+#define aubio_cblas_gemm      cblas_dgemm
 #endif /* HAVE_AUBIO_DOUBLE */
 #endif /* HAVE_BLAS */
 
@@ -157,6 +167,10 @@
 #define aubio_ippsMulC        ippsMulC_32f
 #define aubio_ippsAddC        ippsAddC_32f
 #define aubio_ippsLn          ippsLn_32f_A21
+#define aubio_ippsLog10       ippsLog10_32f_A21
+#define aubio_ippsExp         ippsExp_32f_A21
+#define aubio_ippsThreshold_LT ippsThreshold_LT_32f_I
+#define aubio_ippsDotProd     ippsDotProd_32f
 #define aubio_ippsMean(a,b,c) ippsMean_32f(a, b, c, ippAlgHintFast)
 #define aubio_ippsSum(a,b,c)  ippsSum_32f(a, b, c, ippAlgHintFast)
 #define aubio_ippsMax         ippsMax_32f
@@ -169,6 +183,10 @@
 #define aubio_ippsMulC        ippsMulC_64f
 #define aubio_ippsAddC        ippsAddC_64f
 #define aubio_ippsLn          ippsLn_64f_A26
+#define aubio_ippsLog10       ippsLog10_64f_A26
+#define aubio_ippsExp         ippsExp_64f_A26
+#define aubio_ippsThreshold_LT ippsThreshold_LT_64f_I
+#define aubio_ippsDotProd     ippsDotProd_64f
 #define aubio_ippsMean        ippsMean_64f
 #define aubio_ippsSum         ippsSum_64f
 #define aubio_ippsMax         ippsMax_64f
@@ -192,14 +210,77 @@
  *
  */
 
+/* Real-time checks */
+#ifdef HAVE_RT_CHECKS
+/** report a call that may block, if made in a real-time section of the
+  calling thread, see utils/rtcheck.h; defined in utils/rtcheck.c */
+void aubio_rtcheck_report(const char_t *what);
+#define AUBIO_RT_CHECK(_what)        aubio_rtcheck_report(_what)
+#else
+#define AUBIO_RT_CHECK(_what)        ((void)0)
+#endif
+
+/* Profiling */
+#ifdef HAVE_AUBIO_PROFILING
+/** counters of an instrumented function, see utils/stats.h */
+typedef struct _aubio_stats_counter_t aubio_stats_counter_t;
+struct _aubio_stats_counter_t {
+  const char_t *name;
+  unsigned long long calls;
+  unsigned long long cycles;
+  unsigned long long max_cycles;
+  uint_t registered;
+  aubio_stats_counter_t *next;
+};
+/** read the time-stamp counter; defined in utils/stats.c */
+unsigned long long aubio_stats_clock(void);
+/** count a call started at start */
+void aubio_stats_add(aubio_stats_counter_t *c, unsigned long long start);
+/** start timing the rest of a function, after its declarations */
+#define AUBIO_STATS_BEGIN(_name) \
+  static aubio_stats_counter_t aubio_stats_counter = \
+    { _name, 0, 0, 0, 0, NULL }; \
+  const unsigned long long aubio_stats_start = aubio_stats_clock()
+/** count the call, before each return of a function timed with
+  AUBIO_STATS_BEGIN */
+#define AUBIO_STATS_END() \
+  aubio_stats_add(&aubio_stats_counter, aubio_stats_start)
+#else
+#define AUBIO_STATS_BEGIN(_name)     ((void)0)
+#define AUBIO_STATS_END()            ((void)0)
+#endif
+
 /* Memory management */
-#define AUBIO_MALLOC(_n)             malloc(_n)
-#define AUBIO_REALLOC(_p,_n)         realloc(_p,_n)
-#define AUBIO_NEW(_t)                (_t*)calloc(sizeof(_t), 1)
-#define AUBIO_ARRAY(_t,_n)           (_t*)calloc((_n)*sizeof(_t), 1)
+
+/** alignment of the memory returned by the AUBIO_ allocation macros */
+#define AUBIO_ALIGNMENT              64
+/** round a size up to a multiple of AUBIO_ALIGNMENT */
+#define AUBIO_ALIGN_SIZE(_n)         (((_n) + AUBIO_ALIGNMENT - 1) \
+                                      & ~(size_t)(AUBIO_ALIGNMENT - 1))
+
+/** allocate memory with the allocator of the calling thread, see
+  utils/allocator.h; defined in utils/allocator.c */
+void *aubio_malloc (size_t size, uint_t zero);
+/** resize memory allocated by aubio_malloc(), with its own allocator */
+void *aubio_realloc (void *ptr, size_t size);
+/** free memory allocated by aubio_malloc(), with its own allocator */
+void aubio_free (void *ptr);
+/** get the size asked for a block of aubio_malloc(), 0 if ptr is NULL, used
+  by the aubio_*_get_memory_usage functions */
+uint_t aubio_malloc_size (const void *ptr);
+
+#define AUBIO_MALLOC(_n)             (AUBIO_RT_CHECK("malloc"), \
+                                      aubio_malloc(_n, 0))
+#define AUBIO_REALLOC(_p,_n)         (AUBIO_RT_CHECK("realloc"), \
+                                      aubio_realloc(_p,_n))
+#define AUBIO_NEW(_t)                (AUBIO_RT_CHECK("AUBIO_NEW"), \
+                                      (_t*)aubio_malloc(sizeof(_t), 1))
+#define AUBIO_ARRAY(_t,_n)           (AUBIO_RT_CHECK("AUBIO_ARRAY"), \
+                                      (_t*)aubio_malloc((_n)*sizeof(_t), 1))
 #define AUBIO_MEMCPY(_dst,_src,_n)   memcpy(_dst,_src,_n)
 #define AUBIO_MEMSET(_dst,_src,_t)   memset(_dst,_src,_t)
-#define AUBIO_FREE(_p)               free(_p)
+#define AUBIO_FREE(_p)               (AUBIO_RT_CHECK("AUBIO_FREE"), \
+                                      aubio_free(_p))
 
 
 /* file interface */
@@ -214,11 +295,8 @@
 #define AUBIO_STRNCMP(_s,_t,_n)      strncmp(_s,_t,_n)
 #define AUBIO_STRCPY(_dst,_src)      strcpy(_dst,_src)
 #define AUBIO_STRCHR(_s,_c)          strchr(_s,_c)
-#ifdef strdup
-#define AUBIO_STRDUP(s)              strdup(s)
-#else
+/* not strdup, the copy is freed with AUBIO_FREE */
 #define AUBIO_STRDUP(s)              AUBIO_STRCPY(AUBIO_MALLOC(AUBIO_STRLEN(s) + 1), s)
-#endif
 
 
 /* Error reporting */
@@ -279,6 +357,21 @@ uint_t aubio_log(sint_t level, const char_t *fmt, ...);
 #define PATH_MAX 1024
 #endif
 
+/** scale of the ::s16_t samples, mapping them to [-1, 1) */
+#define AUBIO_S16_SCALE (1. / 32768.)
+
+/* Accumulators */
+
+/** type of the long sums of autocorrelations, correlations and spectral
+  moments; double with HAVE_AUBIO_DOUBLE_ACCUMULATORS, so that these sums keep
+  their precision while vectors stay in single precision, smpl_t otherwise.
+  Filter states are always kept in ::lsmp_t. */
+#if defined(HAVE_AUBIO_DOUBLE_ACCUMULATORS) && !HAVE_AUBIO_DOUBLE
+typedef double asmp_t;
+#else
+typedef smpl_t asmp_t;
+#endif
+
 /* aliases to math.h functions */
 #if !HAVE_AUBIO_DOUBLE
 #define EXP        expf
@@ -291,6 +384,7 @@ uint_t aubio_log(sint_t level, const char_t *fmt, ...);
 #define LOG        logf
 #define FLOOR      floorf
 #define CEIL       ceilf
+#define ASIN       asinf
 #define ATAN       atanf
 #define ATAN2      atan2f
 #else
@@ -304,6 +398,7 @@ uint_t aubio_log(sint_t level, const char_t *fmt, ...);
 #define LOG        log
 #define FLOOR      floor
 #define CEIL       ceil
+#define ASIN       asin
 #define ATAN       atan
 #define ATAN2      atan2
 #endif
@@ -396,6 +491,13 @@ uint_t aubio_log(sint_t level, const char_t *fmt, ...);
 #define UNUSED
 #endif
 
+/** storage class of the variables with one instance per thread */
+#if defined(_MSC_VER)
+#define AUBIO_THREAD_LOCAL __declspec(thread)
+#else
+#define AUBIO_THREAD_LOCAL __thread
+#endif
+
 /* are we using gcc -std=c99 ? */
 #if defined(__STRICT_ANSI__)
 #define strnlen(a,b) MIN(strlen(a),b)
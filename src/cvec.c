@@ -20,37 +20,37 @@
 
 #include "aubio_priv.h"
 #include "cvec.h"
+#include "utils/simd_priv.h"
 
 cvec_t * new_cvec(uint_t length) {
   cvec_t * s;
+  uint_t head, size;
   if ((sint_t)length <= 0) {
     return NULL;
   }
-  s = AUBIO_NEW(cvec_t);
+  // a single block: the structure, then the norm and phase, each aligned
+  head = AUBIO_ALIGN_SIZE(sizeof(cvec_t));
+  size = AUBIO_ALIGN_SIZE((length/2 + 1) * sizeof(smpl_t));
+  s = (cvec_t *)AUBIO_ARRAY(char, head + 2 * size);
   if (!s) {
     return NULL;
   }
   s->length = length/2 + 1;
-  s->norm = AUBIO_ARRAY(smpl_t,s->length);
-  if (!s->norm) {
-    AUBIO_FREE(s);
-    return NULL;
-  }
-  s->phas = AUBIO_ARRAY(smpl_t,s->length);
-  if (!s->phas) {
-    AUBIO_FREE(s->norm);
-    AUBIO_FREE(s);
-    return NULL;
-  }
+  s->norm = (smpl_t *)((char *)s + head);
+  s->phas = (smpl_t *)((char *)s + head + size);
   return s;
 }
 
 void del_cvec(cvec_t *s) {
-  AUBIO_FREE(s->norm);
-  AUBIO_FREE(s->phas);
   AUBIO_FREE(s);
 }
 
+uint_t cvec_get_memory_usage(const cvec_t *s) {
+  AUBIO_ASSERT_NOT_NULL(s);
+  return (uint_t)(AUBIO_ALIGN_SIZE(sizeof(cvec_t))
+      + 2 * AUBIO_ALIGN_SIZE(s->length * sizeof(smpl_t)));
+}
+
 void cvec_norm_set_sample (cvec_t *s, smpl_t data, uint_t position) {
   s->norm[position] = data;
 }
@@ -174,6 +174,12 @@ void cvec_logmag(cvec_t *s, smpl_t lambda) {
   aubio_ippsLn(s->norm, s->norm, (int)s->length);
 #else
   uint_t j;
+  if (aubio_simd_fast_math) {
+    AUBIO_SIMD()->mul(s->norm, lambda, s->length);
+    AUBIO_SIMD()->add(s->norm, 1., s->length);
+    AUBIO_SIMD()->vlog(s->norm, s->length);
+    return;
+  }
   for (j=0; j< s->length; j++) {
     s->norm[j] = LOG(lambda * s->norm[j] + 1);
   }
@@ -33,6 +33,10 @@ extern "C" {
   to store complex data. Complex values are stored in terms of ::cvec_t.phas
   and norm, within 2 vectors of ::smpl_t of size (size/2+1) each.
 
+  A vector created by ::new_cvec is a single block of memory: ::cvec_t.phas
+  follows ::cvec_t.norm, each aligned and padded to ::aubio_get_alignment
+  bytes.
+
   \example test-cvec.c
 
 */
@@ -86,6 +90,16 @@ cvec_t * new_cvec(uint_t length);
 */
 void del_cvec(cvec_t *s);
 
+/** get the memory used by a cvec_t buffer
+
+  \param s buffer as returned by new_cvec()
+
+  \return number of bytes of the buffer, including its structure; see
+  utils/allocator.h
+
+*/
+uint_t cvec_get_memory_usage(const cvec_t *s);
+
 /** write norm value in a complex buffer
 
   This is equivalent to:
@@ -0,0 +1,72 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of librubberband used by effects/pitchshift_rubberband.c and
+   effects/timestretch_rubberband.c, loaded on first use with
+   -Dlazy_backends=true, see utils/lazyload_priv.h.
+
+   To be included after <rubberband/rubberband-c.h>. */
+
+#ifndef AUBIO_LAZY_RUBBERBAND_PRIV_H
+#define AUBIO_LAZY_RUBBERBAND_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#define AUBIO_RUBBERBAND_SYMBOLS(X) \
+  X(rubberband_new) X(rubberband_delete) X(rubberband_reset) \
+  X(rubberband_available) X(rubberband_get_latency) X(rubberband_process) \
+  X(rubberband_retrieve) X(rubberband_set_debug_level) \
+  X(rubberband_set_max_process_size) X(rubberband_set_pitch_scale) \
+  X(rubberband_set_time_ratio) X(rubberband_get_time_ratio)
+
+static const char_t *aubio_rubberband_files[] = {
+  AUBIO_LAZY_LIB("rubberband", "2"),
+#ifdef _WIN32
+  "rubberband.dll",
+#endif
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_rubberband, AUBIO_RUBBERBAND_SYMBOLS,
+    "librubberband", aubio_rubberband_files)
+
+#define rubberband_new aubio_rubberband.rubberband_new
+#define rubberband_delete aubio_rubberband.rubberband_delete
+#define rubberband_reset aubio_rubberband.rubberband_reset
+#define rubberband_available aubio_rubberband.rubberband_available
+#define rubberband_get_latency aubio_rubberband.rubberband_get_latency
+#define rubberband_process aubio_rubberband.rubberband_process
+#define rubberband_retrieve aubio_rubberband.rubberband_retrieve
+#define rubberband_set_debug_level aubio_rubberband.rubberband_set_debug_level
+#define rubberband_set_max_process_size \
+  aubio_rubberband.rubberband_set_max_process_size
+#define rubberband_set_pitch_scale aubio_rubberband.rubberband_set_pitch_scale
+#define rubberband_set_time_ratio aubio_rubberband.rubberband_set_time_ratio
+#define rubberband_get_time_ratio aubio_rubberband.rubberband_get_time_ratio
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_rubberband_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_RUBBERBAND_PRIV_H */
@@ -31,6 +31,15 @@ extern "C" {
 
   ::aubio_pitchshift_t can be used to transpose a stream of blocks of frames.
 
+  The blocks do not need to be of `hop_size` frames: each call returns as
+  many frames as it was given, delayed by aubio_pitchshift_get_latency()
+  frames. With rubberband, the shifter runs in its real-time mode; the
+  output it produces is kept in a queue, so that each block is given out as
+  soon as the matching input was processed.
+
+  Several channels can be transposed together, after calling
+  aubio_pitchshift_set_channels(), with aubio_pitchshift_do_multi().
+
   \example effects/test-pitchshift.c
 
 */
@@ -41,13 +50,48 @@ typedef struct _aubio_pitchshift_t aubio_pitchshift_t;
 /** execute pitch shifting on an input signal frame
 
   \param o pitch shifting object as returned by new_aubio_pitchshift()
-  \param in input signal of size [hop_size]
-  \param out output pitch candidates of size [1]
+  \param in input signal, usually of size [hop_size]
+  \param out transposed output signal, of the same size as `in`
 
 */
 void aubio_pitchshift_do (aubio_pitchshift_t * o, const fvec_t * in,
         fvec_t * out);
 
+/** execute pitch shifting on several channels
+
+  \param o pitch shifting object as returned by new_aubio_pitchshift()
+  \param in input signal of size [channels][length]
+  \param out transposed output signal of size [channels][length]
+
+  The height of `in` and `out` should be the number of channels set with
+  aubio_pitchshift_set_channels().
+
+*/
+void aubio_pitchshift_do_multi (aubio_pitchshift_t * o, const fmat_t * in,
+        fmat_t * out);
+
+/** set the number of channels of the pitch shifting object
+
+  \param o pitch shifting object as returned by new_aubio_pitchshift()
+  \param channels number of channels to transpose together, 1 by default
+
+  \return 0 if successful, non-zero otherwise
+
+  The frames buffered so far are dropped, and the latency measured again.
+
+*/
+uint_t aubio_pitchshift_set_channels (aubio_pitchshift_t * o,
+        uint_t channels);
+
+/** get the number of channels of the pitch shifting object
+
+  \param o pitch shifting object as returned by new_aubio_pitchshift()
+
+  \return number of channels, as set with aubio_pitchshift_set_channels()
+
+*/
+uint_t aubio_pitchshift_get_channels (aubio_pitchshift_t * o);
+
 /** deletion of the pitch shifting object
 
   \param o pitch shifting object as returned by new_aubio_pitchshift()
@@ -74,6 +118,10 @@ aubio_pitchshift_t *new_aubio_pitchshift (const char_t * method,
 
   \return latency of the pitch shifting object in samples
 
+  With rubberband, this is the exact delay between an input frame and the
+  matching output frame. It grows if the output ever had to be padded with
+  zeros, for instance after raising the pitch scale.
+
 */
 uint_t aubio_pitchshift_get_latency (aubio_pitchshift_t * o);
 
@@ -0,0 +1,239 @@
+/*
+  Copyright (C) 2016 Paul Brossier <piem@aubio.org>
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+
+#ifndef HAVE_RUBBERBAND
+
+#include "fvec.h"
+#include "fmat.h"
+#include "effects/pitchshift.h"
+#include "effects/pvstretch_priv.h"
+
+/* built-in pitch shifting, with a phase vocoder */
+
+struct _aubio_pitchshift_t
+{
+  uint_t samplerate;              /**< samplerate */
+  uint_t hopsize;                 /**< hop size */
+  smpl_t pitchscale;              /**< pitch scale */
+  uint_t win_s;                   /**< window size of the phase vocoder */
+  uint_t channels;                /**< number of channels */
+  aubio_pvstretch_t **pv;         /**< [channels] phase vocoders */
+  uint_t started;                 /**< 1 once enough output was buffered */
+};
+
+/* number of output samples to buffer before starting, so that the output
+   of each frame, hop_s / pitchscale samples, comes before it is needed */
+static uint_t aubio_pitchshift_get_reserve (const aubio_pitchshift_t *p)
+{
+  return (uint_t)CEIL(p->win_s / 4 / p->pitchscale) + p->hopsize;
+}
+
+aubio_pitchshift_t *
+new_aubio_pitchshift (const char_t * mode,
+    smpl_t transpose, uint_t hopsize, uint_t samplerate)
+{
+  aubio_pitchshift_t *p = AUBIO_NEW (aubio_pitchshift_t);
+  if (!p) {
+    return NULL;
+  }
+  p->pitchscale = 1.;
+
+  if (!mode || (strcmp(mode, "default") && strcmp(mode, "pvoc"))) {
+    AUBIO_ERR("pitchshift: unknown pitch shifting method %s\n", mode);
+    goto beach;
+  }
+
+  if ((sint_t)hopsize <= 0) {
+    AUBIO_ERR("pitchshift: hop_size should be >= 0, got %d\n", hopsize);
+    goto beach;
+  }
+
+  if ((sint_t)samplerate <= 0) {
+    AUBIO_ERR("pitchshift: samplerate should be >= 0, got %d\n", samplerate);
+    goto beach;
+  }
+
+  p->hopsize = hopsize;
+  p->samplerate = samplerate;
+  p->win_s = aubio_pvstretch_get_win_size(samplerate);
+  if (aubio_pitchshift_set_channels(p, 1)) goto beach;
+
+  if (aubio_pitchshift_set_transpose(p, transpose)) goto beach;
+
+  return p;
+
+beach:
+  del_aubio_pitchshift(p);
+  return NULL;
+}
+
+void
+del_aubio_pitchshift (aubio_pitchshift_t * p)
+{
+  uint_t ch;
+  if (p->pv) {
+    for (ch = 0; ch < p->channels; ch++) {
+      if (p->pv[ch]) del_aubio_pvstretch(p->pv[ch]);
+    }
+    AUBIO_FREE(p->pv);
+  }
+  AUBIO_FREE (p);
+}
+
+uint_t aubio_pitchshift_get_latency (aubio_pitchshift_t * p) {
+  return aubio_pvstretch_get_latency(p->pv[0])
+    + aubio_pitchshift_get_reserve(p);
+}
+
+uint_t
+aubio_pitchshift_set_pitchscale (aubio_pitchshift_t * p, smpl_t pitchscale)
+{
+  if (pitchscale >= 0.25  && pitchscale <= 4.) {
+    uint_t ch;
+    p->pitchscale = pitchscale;
+    for (ch = 0; ch < p->channels; ch++) {
+      aubio_pvstretch_set_pitchscale(p->pv[ch], pitchscale);
+    }
+    return AUBIO_OK;
+  } else {
+    AUBIO_ERR("pitchshift: could not set pitchscale to '%f',"
+        " should be in the range [0.25, 4.].\n", pitchscale);
+    return AUBIO_FAIL;
+  }
+}
+
+smpl_t
+aubio_pitchshift_get_pitchscale (aubio_pitchshift_t * p)
+{
+  return p->pitchscale;
+}
+
+uint_t
+aubio_pitchshift_set_transpose(aubio_pitchshift_t * p, smpl_t transpose)
+{
+  if (transpose >= -24. && transpose <= 24.) {
+    smpl_t pitchscale = POW(2., transpose / 12.);
+    return aubio_pitchshift_set_pitchscale(p, pitchscale);
+  } else {
+    AUBIO_ERR("pitchshift: could not set transpose to '%f',"
+        " should be in the range [-24; 24].\n", transpose);
+    return AUBIO_FAIL;
+  }
+}
+
+smpl_t
+aubio_pitchshift_get_transpose(aubio_pitchshift_t * p)
+{
+  return 12. * LOG(p->pitchscale) / LOG(2.0);
+}
+
+uint_t
+aubio_pitchshift_set_channels (aubio_pitchshift_t * p, uint_t channels)
+{
+  aubio_pvstretch_t **pv;
+  uint_t ch;
+  if ((sint_t)channels <= 0) {
+    AUBIO_ERR("pitchshift: channels should be > 0, got %d\n", channels);
+    return AUBIO_FAIL;
+  }
+  if (channels == p->channels) return AUBIO_OK;
+  pv = AUBIO_ARRAY(aubio_pvstretch_t *, channels);
+  if (!pv) return AUBIO_FAIL;
+  for (ch = 0; ch < channels; ch++) {
+    pv[ch] = new_aubio_pvstretch(p->win_s);
+    if (!pv[ch]) break;
+    aubio_pvstretch_set_pitchscale(pv[ch], p->pitchscale);
+  }
+  if (ch < channels) {
+    while (ch-- > 0) del_aubio_pvstretch(pv[ch]);
+    AUBIO_FREE(pv);
+    return AUBIO_FAIL;
+  }
+  // the frames buffered so far are dropped
+  for (ch = 0; ch < p->channels; ch++) {
+    del_aubio_pvstretch(p->pv[ch]);
+  }
+  if (p->pv) AUBIO_FREE(p->pv);
+  p->pv = pv;
+  p->channels = channels;
+  p->started = 0;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_pitchshift_get_channels (aubio_pitchshift_t * p)
+{
+  return p->channels;
+}
+
+/* push in_length frames of each row of in, read out_length frames to the
+   rows of out */
+static void
+aubio_pitchshift_run (aubio_pitchshift_t * p, smpl_t **in, uint_t in_length,
+    smpl_t **out, uint_t out_length)
+{
+  uint_t ch, read = 0;
+  for (ch = 0; ch < p->channels; ch++) {
+    aubio_pvstretch_push(p->pv[ch], in[ch], in_length);
+  }
+  if (!p->started && aubio_pvstretch_get_available(p->pv[0])
+      >= aubio_pitchshift_get_reserve(p)) {
+    p->started = 1;
+  }
+  if (p->started) {
+    for (ch = 0; ch < p->channels; ch++) {
+      read = aubio_pvstretch_read(p->pv[ch], out[ch], out_length);
+    }
+    // buffer again after running short, rather than on each hop
+    if (read < out_length) p->started = 0;
+  }
+  for (ch = 0; ch < p->channels; ch++) {
+    AUBIO_MEMSET(out[ch] + read, 0, (out_length - read) * sizeof(smpl_t));
+  }
+}
+
+void
+aubio_pitchshift_do (aubio_pitchshift_t * p, const fvec_t * in, fvec_t * out)
+{
+  smpl_t *in_data = in->data;
+  if (p->channels != 1) {
+    AUBIO_ERR("pitchshift: got 1 channel, expected %d\n", p->channels);
+    fvec_zeros(out);
+    return;
+  }
+  aubio_pitchshift_run(p, &in_data, in->length, &out->data, out->length);
+}
+
+void
+aubio_pitchshift_do_multi (aubio_pitchshift_t * p, const fmat_t * in,
+    fmat_t * out)
+{
+  if (in->height != p->channels || out->height != p->channels) {
+    AUBIO_ERR("pitchshift: expected %d channels, got %d to %d\n",
+        p->channels, in->height, out->height);
+    fmat_zeros(out);
+    return;
+  }
+  aubio_pitchshift_run(p, in->data, in->length, out->data, out->length);
+}
+
+#endif /* HAVE_RUBBERBAND */
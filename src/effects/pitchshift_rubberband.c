@@ -23,9 +23,14 @@
 #ifdef HAVE_RUBBERBAND
 
 #include "fvec.h"
+#include "fmat.h"
 #include "effects/pitchshift.h"
 
 #include <rubberband/rubberband-c.h>
+#include "effects/lazy_rubberband_priv.h"
+
+/* largest number of frames passed to rubberband at once */
+#define AUBIO_PITCHSHIFT_BLOCK 4096
 
 /** generic pitch shifting structure */
 struct _aubio_pitchshift_t
@@ -33,6 +38,14 @@ struct _aubio_pitchshift_t
   uint_t samplerate;              /**< samplerate */
   uint_t hopsize;                 /**< hop size */
   smpl_t pitchscale;              /**< pitch scale */
+  uint_t channels;                /**< number of channels */
+  uint_t block_size;              /**< max frames per rubberband_process */
+  smpl_t **rows;                  /**< [channels] pointers to the data */
+
+  fmat_t *fifo;                   /**< output retrieved from rubberband */
+  uint_t fifo_start;              /**< first frame not yet given out */
+  uint_t fifo_end;                /**< end of the retrieved frames */
+  uint_t latency;                 /**< frames between input and output */
 
   RubberBandState rb;
   RubberBandOptions rboptions;
@@ -40,6 +53,14 @@ struct _aubio_pitchshift_t
 
 extern RubberBandOptions aubio_get_rubberband_opts(const char_t *mode);
 
+static uint_t aubio_pitchshift_create (aubio_pitchshift_t *p,
+    uint_t channels);
+
+/* pass length frames of each row of data to rubberband, then move the frames
+   it made available to the fifo */
+static void aubio_pitchshift_process (aubio_pitchshift_t *p, smpl_t **data,
+    uint_t pos, uint_t length);
+
 aubio_pitchshift_t *
 new_aubio_pitchshift (const char_t * mode,
     smpl_t transpose, uint_t hopsize, uint_t samplerate)
@@ -49,6 +70,10 @@ new_aubio_pitchshift (const char_t * mode,
   if (!p) {
     return NULL;
   }
+  if (aubio_rubberband_load()) {
+    AUBIO_FREE(p);
+    return NULL;
+  }
   p->samplerate = samplerate;
   p->hopsize = hopsize;
   p->pitchscale = 1.;
@@ -70,24 +95,14 @@ new_aubio_pitchshift (const char_t * mode,
 
   //AUBIO_MSG("pitchshift: using pitch shifting method %s\n", mode);
 
-  p->rb = rubberband_new(samplerate, 1, p->rboptions, 1., p->pitchscale);
-  rubberband_set_max_process_size(p->rb, p->hopsize);
-  //rubberband_set_debug_level(p->rb, 10);
-
-  if (aubio_pitchshift_set_transpose(p, transpose)) goto beach;
-
-#if 1
-  // warm up rubber band
-  unsigned int latency = MAX(p->hopsize, rubberband_get_latency(p->rb));
-  int available = rubberband_available(p->rb);
-  fvec_t *zeros = new_fvec(p->hopsize);
-  while (available <= (int)latency) {
-    rubberband_process(p->rb,
-        (const float* const*)&(zeros->data), p->hopsize, 0);
-    available = rubberband_available(p->rb);
+  if (transpose < -24. || transpose > 24.) {
+    AUBIO_ERR("pitchshift: could not set transpose to '%f',"
+        " should be in the range [-24; 24.].\n", transpose);
+    goto beach;
   }
-  del_fvec(zeros);
-#endif
+  p->pitchscale = POW(2., transpose / 12.);
+  p->block_size = MAX(hopsize, AUBIO_PITCHSHIFT_BLOCK);
+  if (aubio_pitchshift_create(p, 1) != AUBIO_OK) goto beach;
 
   return p;
 
@@ -96,17 +111,64 @@ beach:
   return NULL;
 }
 
+/* (re)create the rubberband instance and its fifo, then feed it silence
+   until a hop of output is ready, so that the output is never short */
+static uint_t
+aubio_pitchshift_create (aubio_pitchshift_t *p, uint_t channels)
+{
+  RubberBandState rb = rubberband_new(p->samplerate, channels, p->rboptions,
+      1., p->pitchscale);
+  smpl_t **rows = AUBIO_ARRAY(smpl_t *, channels);
+  // room for the silence fed below, and the output of a whole block
+  fmat_t *fifo = new_fmat(channels, 2 * p->block_size + p->hopsize);
+  fmat_t *zeros = new_fmat(channels, p->hopsize);
+  uint_t warmup = 0;
+  if (!rb || !rows || !fifo || !zeros) {
+    if (rb) rubberband_delete(rb);
+    if (rows) AUBIO_FREE(rows);
+    if (fifo) del_fmat(fifo);
+    if (zeros) del_fmat(zeros);
+    return AUBIO_FAIL;
+  }
+  rubberband_set_max_process_size(rb, p->block_size);
+  //rubberband_set_debug_level(rb, 10);
+  if (p->rb) rubberband_delete(p->rb);
+  if (p->rows) AUBIO_FREE(p->rows);
+  if (p->fifo) del_fmat(p->fifo);
+  p->rb = rb;
+  p->rows = rows;
+  p->fifo = fifo;
+  p->fifo_start = p->fifo_end = 0;
+  p->channels = channels;
+
+  while (p->fifo_end < p->hopsize) {
+    aubio_pitchshift_process(p, zeros->data, 0, p->hopsize);
+    warmup += p->hopsize;
+  }
+  // the output lags the stream given to rubberband by its own latency, and
+  // that stream starts with the silence
+  p->latency = warmup + rubberband_get_latency(p->rb);
+  del_fmat(zeros);
+  return AUBIO_OK;
+}
+
 void
 del_aubio_pitchshift (aubio_pitchshift_t * p)
 {
   if (p->rb) {
     rubberband_delete(p->rb);
   }
+  if (p->rows) {
+    AUBIO_FREE(p->rows);
+  }
+  if (p->fifo) {
+    del_fmat(p->fifo);
+  }
   AUBIO_FREE (p);
 }
 
 uint_t aubio_pitchshift_get_latency (aubio_pitchshift_t * p) {
-  return rubberband_get_latency(p->rb);
+  return p->latency;
 }
 
 uint_t
@@ -148,19 +210,111 @@ aubio_pitchshift_get_transpose(aubio_pitchshift_t * p)
   return 12. * LOG(p->pitchscale) / LOG(2.0);
 }
 
+uint_t
+aubio_pitchshift_set_channels (aubio_pitchshift_t * p, uint_t channels)
+{
+  if ((sint_t)channels <= 0) {
+    AUBIO_ERR("pitchshift: channels should be > 0, got %d\n", channels);
+    return AUBIO_FAIL;
+  }
+  if (channels == p->channels) return AUBIO_OK;
+  return aubio_pitchshift_create(p, channels);
+}
+
+uint_t
+aubio_pitchshift_get_channels (aubio_pitchshift_t * p)
+{
+  return p->channels;
+}
+
+static void
+aubio_pitchshift_process (aubio_pitchshift_t *p, smpl_t **data,
+    uint_t pos, uint_t length)
+{
+  uint_t ch, room;
+  int available;
+  for (ch = 0; ch < p->channels; ch++) {
+    p->rows[ch] = data[ch] + pos;
+  }
+  // third parameter is always 0 since we are never expecting a final frame
+  rubberband_process(p->rb, (const float* const*)p->rows, length, 0);
+  available = rubberband_available(p->rb);
+  if (available <= 0) return;
+  if (p->fifo_end + available > p->fifo->length && p->fifo_start > 0) {
+    // move the frames left to the start of the fifo
+    for (ch = 0; ch < p->channels; ch++) {
+      memmove(p->fifo->data[ch], p->fifo->data[ch] + p->fifo_start,
+          (p->fifo_end - p->fifo_start) * sizeof(smpl_t));
+    }
+    p->fifo_end -= p->fifo_start;
+    p->fifo_start = 0;
+  }
+  // what does not fit stays in rubberband until the next call
+  room = MIN((uint_t)available, p->fifo->length - p->fifo_end);
+  for (ch = 0; ch < p->channels; ch++) {
+    p->rows[ch] = p->fifo->data[ch] + p->fifo_end;
+  }
+  rubberband_retrieve(p->rb, (float* const*)p->rows, room);
+  p->fifo_end += room;
+}
+
+/* shift length frames of the rows of in to the rows of out, block by block,
+   giving out each frame of output once the matching input was processed */
+static void
+aubio_pitchshift_run (aubio_pitchshift_t *p, smpl_t **in, smpl_t **out,
+    uint_t length)
+{
+  uint_t ch, pos = 0, done = 0, n;
+  while (pos < length) {
+    n = MIN(length - pos, p->block_size);
+    aubio_pitchshift_process(p, in, pos, n);
+    pos += n;
+    n = MIN(p->fifo_end - p->fifo_start, pos - done);
+    for (ch = 0; ch < p->channels; ch++) {
+      AUBIO_MEMCPY(out[ch] + done, p->fifo->data[ch] + p->fifo_start,
+          n * sizeof(smpl_t));
+    }
+    p->fifo_start += n;
+    done += n;
+  }
+  if (done < length) {
+    AUBIO_WRN("pitchshift: catching up with zeros, only %d frames of %d"
+        " available, current pitchscale: %f\n", done, length, p->pitchscale);
+    for (ch = 0; ch < p->channels; ch++) {
+      AUBIO_MEMSET(out[ch] + done, 0, (length - done) * sizeof(smpl_t));
+    }
+    // the next frames come that much later
+    p->latency += length - done;
+  }
+}
+
 void
 aubio_pitchshift_do (aubio_pitchshift_t * p, const fvec_t * in, fvec_t * out)
 {
-  // third parameter is always 0 since we are never expecting a final frame
-  rubberband_process(p->rb, (const float* const*)&(in->data), p->hopsize, 0);
-  if (rubberband_available(p->rb) >= (int)p->hopsize) {
-    rubberband_retrieve(p->rb, (float* const*)&(out->data), p->hopsize);
-  } else {
-    AUBIO_WRN("pitchshift: catching up with zeros"
-        ", only %d available, needed: %d, current pitchscale: %f\n",
-        rubberband_available(p->rb), p->hopsize, p->pitchscale);
+  smpl_t *in_data = in->data;
+  if (p->channels != 1 || in->length != out->length) {
+    AUBIO_ERR("pitchshift: expected as many frames in output as in input,"
+        " and 1 channel, got %d, %d and %d\n", out->length, in->length,
+        p->channels);
     fvec_zeros(out);
+    return;
+  }
+  aubio_pitchshift_run(p, &in_data, &out->data, in->length);
+}
+
+void
+aubio_pitchshift_do_multi (aubio_pitchshift_t * p, const fmat_t * in,
+    fmat_t * out)
+{
+  if (in->height != p->channels || out->height != p->channels
+      || in->length != out->length) {
+    AUBIO_ERR("pitchshift: expected %d channels, got %d by %d frames to"
+        " %d by %d\n", p->channels, in->height, in->length, out->height,
+        out->length);
+    fmat_zeros(out);
+    return;
   }
+  aubio_pitchshift_run(p, in->data, out->data, in->length);
 }
 
 #endif
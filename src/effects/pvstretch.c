@@ -0,0 +1,333 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "mathutils.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "mathutils_priv.h"
+#include "effects/pvstretch_priv.h"
+
+struct _aubio_pvstretch_t {
+  uint_t win_s;             /**< window size */
+  uint_t hop_s;             /**< synthesis hop, win_s / 4 */
+  smpl_t speed;             /**< ratio of input to output durations */
+  smpl_t pitchscale;        /**< frequency ratio */
+  smpl_t scale;             /**< overlap-add normalisation */
+
+  aubio_fft_t *fft;
+  const fvec_t *w;          /**< analysis and synthesis window, shared */
+  fvec_t *compspec;         /**< [win_s] spectrum of the current frame */
+  cvec_t *grain;            /**< polar spectrum of the current frame */
+  fvec_t *frame;            /**< [win_s] synthesised frame, shifted */
+
+  fvec_t *last_phas;        /**< analysis phases of the previous frame */
+  fvec_t *synth_phas;       /**< synthesis phases of the previous frame */
+  fvec_t *advance;          /**< phase advance of each bin */
+  uint_t *peaks;            /**< bins of the spectral peaks */
+  uint_t has_last;          /**< 0 until the first frame */
+
+  fvec_t *in;               /**< [2 * win_s] pending input */
+  uint_t in_len;            /**< number of samples in `in` */
+  double in_pos;            /**< start of the next frame in `in` */
+  uint_t last_hop;          /**< actual analysis hop of the last frame */
+
+  smpl_t *out;              /**< output, then overlap-add of the last frame */
+  uint_t out_size;          /**< size of `out` */
+  uint_t out_ready;         /**< number of finished samples in `out` */
+  double out_pos;           /**< position of the next sample read in `out` */
+};
+
+static void aubio_pvstretch_frame (aubio_pvstretch_t *o);
+static void aubio_pvstretch_lock_phases (aubio_pvstretch_t *o,
+    uint_t hop);
+
+uint_t aubio_pvstretch_get_win_size (uint_t samplerate)
+{
+  // 2048 at 44100 Hz, long enough to resolve the partials of low notes
+  uint_t win_s = aubio_next_power_of_two(samplerate / 32);
+  return MAX(256, win_s);
+}
+
+aubio_pvstretch_t *new_aubio_pvstretch (uint_t win_s)
+{
+  aubio_pvstretch_t *o = AUBIO_NEW(aubio_pvstretch_t);
+  uint_t i;
+  smpl_t sum = 0.;
+  if (!o) return NULL;
+  if ((sint_t)win_s < 16 || aubio_is_power_of_two(win_s) != 1) {
+    AUBIO_ERR("pvstretch: win_s should be a power of 2 >= 16, got %d\n",
+        win_s);
+    goto beach;
+  }
+  o->win_s = win_s;
+  o->hop_s = win_s / 4;
+  o->speed = 1.;
+  o->pitchscale = 1.;
+  o->fft = new_aubio_fft(win_s);
+  o->w = aubio_window_acquire("hanningz", win_s);
+  o->compspec = new_fvec(win_s);
+  o->grain = new_cvec(win_s);
+  o->frame = new_fvec(win_s);
+  o->last_phas = new_fvec(win_s / 2 + 1);
+  o->synth_phas = new_fvec(win_s / 2 + 1);
+  o->advance = new_fvec(win_s / 2 + 1);
+  o->peaks = AUBIO_ARRAY(uint_t, win_s / 2 + 1);
+  o->in = new_fvec(2 * win_s);
+  o->out_size = 4 * win_s;
+  o->out = AUBIO_ARRAY(smpl_t, o->out_size);
+  if (!o->fft || !o->w || !o->compspec || !o->grain || !o->frame
+      || !o->last_phas || !o->synth_phas || !o->advance || !o->peaks
+      || !o->in || !o->out) goto beach;
+  // frames overlap-add to sum(w^2) / hop_s
+  for (i = 0; i < win_s; i++) {
+    sum += SQR(o->w->data[i]);
+  }
+  o->scale = o->hop_s / sum;
+  aubio_pvstretch_reset(o);
+  return o;
+
+beach:
+  del_aubio_pvstretch(o);
+  return NULL;
+}
+
+void aubio_pvstretch_set_speed (aubio_pvstretch_t *o, smpl_t speed)
+{
+  o->speed = speed;
+}
+
+void aubio_pvstretch_set_pitchscale (aubio_pvstretch_t *o, smpl_t pitchscale)
+{
+  o->pitchscale = pitchscale;
+}
+
+void aubio_pvstretch_reset (aubio_pvstretch_t *o)
+{
+  // start with win_s - hop_s zeros, so that the first input samples get all
+  // their overlapping frames
+  fvec_zeros(o->in);
+  o->in_len = o->win_s - o->hop_s;
+  o->in_pos = 0.;
+  o->has_last = 0;
+  AUBIO_MEMSET(o->out, 0, o->out_size * sizeof(smpl_t));
+  o->out_ready = 0;
+  o->out_pos = 0.;
+}
+
+uint_t aubio_pvstretch_get_latency (const aubio_pvstretch_t *o)
+{
+  // the first input sample, win_s / 2 - hop_s after the centre of the first
+  // frame, is synthesised that distance times the stretch after its centre,
+  // then resampled
+  smpl_t stretch = o->pitchscale / o->speed;
+  return (uint_t)ROUND((o->win_s / 2. + (o->win_s / 2. - o->hop_s) * stretch)
+      / o->pitchscale);
+}
+
+/* drop the input samples before the next frame, even if not pushed yet */
+static void aubio_pvstretch_drop (aubio_pvstretch_t *o)
+{
+  uint_t drop = MIN((uint_t)o->in_pos, o->in_len);
+  if (drop == 0) return;
+  o->in_len -= drop;
+  o->in_pos -= drop;
+  memmove(o->in->data, o->in->data + drop, o->in_len * sizeof(smpl_t));
+}
+
+void aubio_pvstretch_push (aubio_pvstretch_t *o, const smpl_t *data,
+    uint_t length)
+{
+  uint_t n;
+  while (length > 0) {
+    // skip input that no frame will read
+    if (o->in_len == 0 && o->in_pos >= 1.) {
+      n = MIN(length, (uint_t)o->in_pos);
+      o->in_pos -= n;
+      if (data) data += n;
+      length -= n;
+      continue;
+    }
+    n = MIN(length, o->in->length - o->in_len);
+    if (data) {
+      AUBIO_MEMCPY(o->in->data + o->in_len, data, n * sizeof(smpl_t));
+      data += n;
+    } else {
+      AUBIO_MEMSET(o->in->data + o->in_len, 0, n * sizeof(smpl_t));
+    }
+    o->in_len += n;
+    length -= n;
+    while (o->in_pos + o->win_s <= o->in_len) {
+      aubio_pvstretch_frame(o);
+    }
+    aubio_pvstretch_drop(o);
+  }
+}
+
+uint_t aubio_pvstretch_get_available (const aubio_pvstretch_t *o)
+{
+  // each output sample interpolates two samples of `out`
+  double span = o->out_ready - 1. - o->out_pos;
+  if (span <= 0.) return 0;
+  return (uint_t)CEIL(span / o->pitchscale);
+}
+
+uint_t aubio_pvstretch_read (aubio_pvstretch_t *o, smpl_t *data,
+    uint_t length)
+{
+  uint_t i, drop, keep;
+  double pos = o->out_pos;
+  length = MIN(length, aubio_pvstretch_get_available(o));
+  // resample by the pitch scale, with a linear interpolation
+  for (i = 0; i < length; i++) {
+    uint_t j = (uint_t)pos;
+    smpl_t frac = pos - j;
+    data[i] = o->out[j] + frac * (o->out[j + 1] - o->out[j]);
+    pos += o->pitchscale;
+  }
+  // drop the samples read, keep the tail of the last frame
+  drop = MIN((uint_t)pos, o->out_ready);
+  o->out_pos = pos - drop;
+  if (drop > 0) {
+    keep = o->out_ready - drop + o->win_s - o->hop_s;
+    memmove(o->out, o->out + drop, keep * sizeof(smpl_t));
+    AUBIO_MEMSET(o->out + keep, 0, drop * sizeof(smpl_t));
+    o->out_ready -= drop;
+  }
+  return length;
+}
+
+/* analyse the frame at in_pos, and add it to the output */
+static void aubio_pvstretch_frame (aubio_pvstretch_t *o)
+{
+  uint_t i, start = (uint_t)o->in_pos, half = o->win_s / 2;
+  fvec_t grain;
+  smpl_t *out;
+
+  fvec_view(&grain, o->in, start, o->win_s);
+  aubio_fft_do_complex_windowed(o->fft, &grain, o->w, o->compspec);
+  aubio_fft_get_spectrum(o->compspec, o->grain);
+  aubio_pvstretch_lock_phases(o, MAX(1, o->last_hop));
+  aubio_fft_rdo(o->fft, o->grain, o->frame);
+
+  // make room for one more frame, if the output was not consumed
+  if (o->out_ready + o->hop_s + o->win_s > o->out_size) {
+    uint_t size = 2 * o->out_size;
+    smpl_t *data = (smpl_t *)AUBIO_REALLOC(o->out, size * sizeof(smpl_t));
+    if (!data) {
+      AUBIO_ERR("pvstretch: failed growing output to %d samples\n", size);
+      return;
+    }
+    AUBIO_MEMSET(data + o->out_size, 0,
+        (size - o->out_size) * sizeof(smpl_t));
+    o->out = data;
+    o->out_size = size;
+  }
+  // unshift, window and overlap-add
+  out = o->out + o->out_ready;
+  for (i = 0; i < half; i++) {
+    out[i] += o->frame->data[i + half] * o->w->data[i] * o->scale;
+  }
+  for (i = half; i < o->win_s; i++) {
+    out[i] += o->frame->data[i - half] * o->w->data[i] * o->scale;
+  }
+  o->out_ready += o->hop_s;
+
+  // move on to the next frame, the analysis hop rounded to a sample; the
+  // output is resampled by pitchscale after synthesis
+  o->in_pos += o->speed * o->hop_s / o->pitchscale;
+  o->last_hop = (uint_t)o->in_pos - start;
+}
+
+/* set the phases of o->grain from those of the previous frame, hop input
+   samples before it and hop_s output samples before it */
+static void aubio_pvstretch_lock_phases (aubio_pvstretch_t *o, uint_t hop)
+{
+  uint_t k, p, n_peaks = 0, length = o->grain->length;
+  smpl_t *phas = o->grain->phas, *norm = o->grain->norm;
+  smpl_t *last = o->last_phas->data, *synth = o->synth_phas->data;
+  smpl_t *advance = o->advance->data;
+  smpl_t bin_advance = TWO_PI * hop / o->win_s;
+  smpl_t hop_ratio = (smpl_t)o->hop_s / hop;
+  if (!o->has_last) {
+    AUBIO_MEMCPY(last, phas, length * sizeof(smpl_t));
+    AUBIO_MEMCPY(synth, phas, length * sizeof(smpl_t));
+    o->has_last = 1;
+    return;
+  }
+  // advance of each bin over the synthesis hop, from the deviation of its
+  // phase to the one expected at its centre frequency; a loop without
+  // branches over contiguous arrays, vectorised by the compiler
+  for (k = 0; k < length; k++) {
+    smpl_t expected = bin_advance * k;
+    smpl_t dev = phas[k] - last[k] - expected;
+    dev -= TWO_PI * FLOOR(dev / TWO_PI + .5);
+    advance[k] = (expected + dev) * hop_ratio;
+    last[k] = phas[k];
+  }
+  // spectral peaks
+  for (k = 1; k + 1 < length; k++) {
+    if (norm[k] > norm[k - 1] && norm[k] >= norm[k + 1]) {
+      o->peaks[n_peaks++] = k;
+    }
+  }
+  if (n_peaks == 0) {
+    for (k = 0; k < length; k++) {
+      synth[k] += advance[k];
+    }
+  } else {
+    // each bin follows the phase of its closest peak
+    uint_t first = 0, end;
+    for (p = 0; p < n_peaks; p++) {
+      uint_t peak = o->peaks[p];
+      smpl_t peak_synth = synth[peak] + advance[peak];
+      smpl_t peak_phas = phas[peak];
+      end = (p + 1 < n_peaks) ? (peak + o->peaks[p + 1] + 1) / 2 : length;
+      for (k = first; k < end; k++) {
+        synth[k] = peak_synth + phas[k] - peak_phas;
+      }
+      first = end;
+    }
+  }
+  // keep the phases small, and use them for synthesis
+  for (k = 0; k < length; k++) {
+    synth[k] -= TWO_PI * FLOOR(synth[k] / TWO_PI);
+    phas[k] = synth[k];
+  }
+}
+
+void del_aubio_pvstretch (aubio_pvstretch_t *o)
+{
+  if (o->fft) del_aubio_fft(o->fft);
+  aubio_window_release(o->w);
+  if (o->compspec) del_fvec(o->compspec);
+  if (o->grain) del_cvec(o->grain);
+  if (o->frame) del_fvec(o->frame);
+  if (o->last_phas) del_fvec(o->last_phas);
+  if (o->synth_phas) del_fvec(o->synth_phas);
+  if (o->advance) del_fvec(o->advance);
+  if (o->peaks) AUBIO_FREE(o->peaks);
+  if (o->in) del_fvec(o->in);
+  if (o->out) AUBIO_FREE(o->out);
+  AUBIO_FREE(o);
+}
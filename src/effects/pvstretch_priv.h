@@ -0,0 +1,118 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Phase vocoder time stretching, with identity phase locking, used by the
+   built-in implementations of effects/timestretch.h and
+   effects/pitchshift.h.
+
+   Frames of win_s samples are analysed every `speed * hop_s / pitchscale`
+   input samples, added back every hop_s samples, with hop_s = win_s / 4,
+   and resampled by pitchscale. The phase of each spectral peak is advanced
+   by its instantaneous frequency, and the bins around it keep their phase
+   relative to the peak [1].
+
+   [1] J. Laroche and M. Dolson, "Improved phase vocoder time-scale
+   modification of audio", IEEE Transactions on Speech and Audio
+   Processing, 7(3), 1999.
+*/
+
+#ifndef AUBIO_PVSTRETCH_PRIV_H
+#define AUBIO_PVSTRETCH_PRIV_H
+
+/** phase vocoder time stretching object */
+typedef struct _aubio_pvstretch_t aubio_pvstretch_t;
+
+/** create a phase vocoder time stretching object
+
+  \param win_s window size, a power of 2 of at least 16
+
+  \return newly created ::aubio_pvstretch_t, or NULL on failure
+
+*/
+aubio_pvstretch_t *new_aubio_pvstretch (uint_t win_s);
+
+/** get a window size for a samplerate
+
+  \param samplerate sampling rate, in Hz
+
+  \return smallest power of 2 of at least `samplerate / 32` and 256
+
+*/
+uint_t aubio_pvstretch_get_win_size (uint_t samplerate);
+
+/** set the speed, the ratio of input samples to output samples
+
+  \param o object as returned by new_aubio_pvstretch()
+  \param speed ratio, larger than 1 to shorten the signal, smaller than 1 to
+  lengthen it
+
+*/
+void aubio_pvstretch_set_speed (aubio_pvstretch_t *o, smpl_t speed);
+
+/** set the pitch scale, the ratio of output to input frequencies
+
+  \param o object as returned by new_aubio_pvstretch()
+  \param pitchscale ratio, larger than 1 to raise the pitch
+
+  The frames are stretched by `pitchscale / speed`, then resampled by
+  `pitchscale`.
+
+*/
+void aubio_pvstretch_set_pitchscale (aubio_pvstretch_t *o,
+    smpl_t pitchscale);
+
+/** push samples, and analyse and synthesise all the frames they complete
+
+  \param o object as returned by new_aubio_pvstretch()
+  \param data samples to push, or NULL to push zeros
+  \param length number of samples to push
+
+  Memory is allocated only if the output grows past 4 windows because it
+  is not read.
+
+*/
+void aubio_pvstretch_push (aubio_pvstretch_t *o, const smpl_t *data,
+    uint_t length);
+
+/** get the number of samples ready to be read */
+uint_t aubio_pvstretch_get_available (const aubio_pvstretch_t *o);
+
+/** read samples
+
+  \param o object as returned by new_aubio_pvstretch()
+  \param data output samples
+  \param length maximum number of samples to read
+
+  \return number of samples read, at most aubio_pvstretch_get_available()
+
+*/
+uint_t aubio_pvstretch_read (aubio_pvstretch_t *o, smpl_t *data,
+    uint_t length);
+
+/** get the delay of an input sample in the output, in output samples */
+uint_t aubio_pvstretch_get_latency (const aubio_pvstretch_t *o);
+
+/** drop all pending input and output */
+void aubio_pvstretch_reset (aubio_pvstretch_t *o);
+
+/** delete a phase vocoder time stretching object */
+void del_aubio_pvstretch (aubio_pvstretch_t *o);
+
+#endif /* AUBIO_PVSTRETCH_PRIV_H */
@@ -51,7 +51,7 @@ char_t** aubio_split_str(const char_t* str, const char_t sep) {
       // make sure we don't got in the wild
       if (idx >= count)
         break;
-      *(result + idx++) = strdup(params);
+      *(result + idx++) = AUBIO_STRDUP(params);
       params = strtok(0, delim);
     }
     // add null string at the end if needed
@@ -131,13 +131,20 @@ RubberBandOptions aubio_get_rubberband_opts(const char_t *mode)
       else if ( strcmp(params[i], "PitchHighConsistency" ) == 0 )  rboptions |= RubberBandOptionPitchHighConsistency;
       else if ( strcmp(params[i], "ChannelsApart" ) == 0 )         rboptions |= RubberBandOptionChannelsApart;
       else if ( strcmp(params[i], "ChannelsTogether" ) == 0 )      rboptions |= RubberBandOptionChannelsTogether;
+#if RUBBERBAND_API_MAJOR_VERSION > 2 || (RUBBERBAND_API_MAJOR_VERSION == 2 \
+    && RUBBERBAND_API_MINOR_VERSION >= 7)
+      // engines of rubberband 3
+      else if ( strcmp(params[i], "EngineFaster" ) == 0 )          rboptions |= RubberBandOptionEngineFaster;
+      else if ( strcmp(params[i], "EngineFiner" ) == 0 )           rboptions |= RubberBandOptionEngineFiner;
+#endif
       else {
         AUBIO_ERR("rubberband_utils: did not understand option '%s', should be one of: "
           "StretchElastic|StretchPrecise, TransientsCrisp|TransientsMixed|TransientsSmooth, "
           "DetectorCompound|DetectorPercussive|DetectorSoft, PhaseLaminar|PhaseIndependent, "
           "ThreadingAuto|ThreadingNever|ThreadingAlways, WindowStandard|WindowLong|WindowShort, "
           "SmoothingOn|SmoothingOff, FormantShifted|FormantPreserved, "
-          "PitchHighSpeed|PitchHighQuality|PitchHighConsistency, ChannelsApart|ChannelsTogether\n"
+          "PitchHighSpeed|PitchHighQuality|PitchHighConsistency, ChannelsApart|ChannelsTogether, "
+          "EngineFaster|EngineFiner (rubberband >= 3)\n"
           , params[i]);
         rboptions = -1;
       }
@@ -38,6 +38,12 @@ extern "C" {
   A transposition can also be applied and changed at any time with
   aubio_timestretch_set_transpose().
 
+  Several channels can be stretched together by a single object, after
+  calling aubio_timestretch_set_channels(), with
+  aubio_timestretch_push_multi() and aubio_timestretch_do_multi(). The
+  frames pushed at once are processed in blocks of up to 4096 frames, or
+  `hop_size` if it is larger, regardless of the hop size.
+
   \example effects/test-timestretch.c
 
 */
@@ -55,6 +61,19 @@ typedef struct _aubio_timestretch_t aubio_timestretch_t;
 void aubio_timestretch_do (aubio_timestretch_t * o, fvec_t * out,
    uint_t * read);
 
+/** execute time stretching, on several channels
+
+  \param o time stretching object as returned by new_aubio_timestretch()
+  \param out timestretched output of size [channels][hop_size]
+  \param read number of frames actually wrote out
+
+  The height of `out` should be the number of channels set with
+  aubio_timestretch_set_channels().
+
+*/
+void aubio_timestretch_do_multi (aubio_timestretch_t * o, fmat_t * out,
+   uint_t * read);
+
 /** deletion of the time stretching object
 
   \param o time stretching object as returned by new_aubio_timestretch()
@@ -81,12 +100,52 @@ aubio_timestretch_t *new_aubio_timestretch (const char_t * method,
   \param in input vector of new samples to push to time stretching object
   \param length number of new samples to push from input vector
 
-  \return number of currently available samples
+  \return number of currently available samples, or a negative value if
+  the object was set to more than one channel
 
  */
 sint_t aubio_timestretch_push(aubio_timestretch_t * o, fvec_t *in,
     uint_t length);
 
+/** push length frames of several channels to time stretching object
+
+  \param o time stretching object as returned by ::new_aubio_timestretch()
+  \param in input matrix of new frames, one row per channel
+  \param length number of new frames to push from each row of `in`
+
+  \return number of currently available frames, or a negative value if `in`
+  does not have as many rows as the channels of `o`
+
+  As with aubio_timestretch_push(), a length shorter than `in->length`
+  marks the end of the input.
+
+ */
+sint_t aubio_timestretch_push_multi(aubio_timestretch_t * o,
+    const fmat_t *in, uint_t length);
+
+/** set the number of channels of the time stretching object
+
+  \param o time stretching object as returned by ::new_aubio_timestretch()
+  \param channels number of channels to stretch together, 1 by default
+
+  \return 0 if successful, non-zero otherwise
+
+  Changing the number of channels drops the frames currently buffered, and
+  allocates memory.
+
+ */
+uint_t aubio_timestretch_set_channels(aubio_timestretch_t * o,
+    uint_t channels);
+
+/** get the number of channels of the time stretching object
+
+  \param o time stretching object as returned by ::new_aubio_timestretch()
+
+  \return number of channels of the time stretching object
+
+ */
+uint_t aubio_timestretch_get_channels(aubio_timestretch_t * o);
+
 /** get number of currently available samples from time stretching object
 
   \param o time stretching object as returned by ::new_aubio_timestretch()
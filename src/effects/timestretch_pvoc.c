@@ -0,0 +1,326 @@
+/*
+  Copyright (C) 2016 Paul Brossier <piem@aubio.org>
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+
+#ifndef HAVE_RUBBERBAND
+
+#include "fvec.h"
+#include "fmat.h"
+#include "mathutils.h"
+#include "effects/timestretch.h"
+#include "effects/pvstretch_priv.h"
+
+/* built-in time stretching, with a phase vocoder */
+
+#define MIN_STRETCH_RATIO 0.025
+#define MAX_STRETCH_RATIO 40.
+
+struct _aubio_timestretch_t
+{
+  uint_t samplerate;              /**< samplerate */
+  uint_t hopsize;                 /**< hop size */
+  smpl_t stretchratio;            /**< time ratio */
+  smpl_t pitchscale;              /**< pitch scale */
+  uint_t win_s;                   /**< window size of the phase vocoders */
+  uint_t channels;                /**< number of channels */
+  aubio_pvstretch_t **pv;         /**< [channels] phase vocoders */
+};
+
+static void aubio_timestretch_free_channels (aubio_timestretch_t * p)
+{
+  uint_t ch;
+  if (!p->pv) return;
+  for (ch = 0; ch < p->channels; ch++) {
+    if (p->pv[ch]) del_aubio_pvstretch(p->pv[ch]);
+  }
+  AUBIO_FREE(p->pv);
+  p->pv = NULL;
+}
+
+uint_t
+aubio_timestretch_set_channels (aubio_timestretch_t * p, uint_t channels)
+{
+  aubio_pvstretch_t **pv;
+  uint_t ch;
+  if ((sint_t)channels <= 0) {
+    AUBIO_ERR("timestretch: channels should be > 0, got %d\n", channels);
+    return AUBIO_FAIL;
+  }
+  if (p->pv && channels == p->channels) return AUBIO_OK;
+  pv = AUBIO_ARRAY(aubio_pvstretch_t *, channels);
+  if (!pv) return AUBIO_FAIL;
+  for (ch = 0; ch < channels; ch++) {
+    pv[ch] = new_aubio_pvstretch(p->win_s);
+    if (!pv[ch]) {
+      while (ch-- > 0) del_aubio_pvstretch(pv[ch]);
+      AUBIO_FREE(pv);
+      return AUBIO_FAIL;
+    }
+    aubio_pvstretch_set_speed(pv[ch], p->stretchratio);
+    aubio_pvstretch_set_pitchscale(pv[ch], p->pitchscale);
+  }
+  aubio_timestretch_free_channels(p);
+  p->pv = pv;
+  p->channels = channels;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_timestretch_get_channels (aubio_timestretch_t * p)
+{
+  return p->channels;
+}
+
+aubio_timestretch_t *
+new_aubio_timestretch (const char_t * mode, smpl_t stretchratio,
+    uint_t hopsize, uint_t samplerate)
+{
+  aubio_timestretch_t *p = AUBIO_NEW (aubio_timestretch_t);
+  if (!p) {
+    return NULL;
+  }
+  p->pitchscale = 1.;
+
+  if (!mode || (strcmp(mode, "default") && strcmp(mode, "pvoc"))) {
+    AUBIO_ERR("timestretch: unknown time stretching method %s\n", mode);
+    goto beach;
+  }
+
+  if ((sint_t)hopsize <= 0) {
+    AUBIO_ERR("timestretch: hopsize should be > 0, got %d\n", hopsize);
+    goto beach;
+  }
+
+  if ((sint_t)samplerate <= 0) {
+    AUBIO_ERR("timestretch: samplerate should be > 0, got %d\n", samplerate);
+    goto beach;
+  }
+
+  if (stretchratio <= MAX_STRETCH_RATIO && stretchratio >= MIN_STRETCH_RATIO) {
+    p->stretchratio = stretchratio;
+  } else {
+    AUBIO_ERR("timestretch: stretchratio should be in the range [%.3f, %.3f], got %f\n",
+        MIN_STRETCH_RATIO, MAX_STRETCH_RATIO, stretchratio);
+    goto beach;
+  }
+
+  p->hopsize = hopsize;
+  p->samplerate = samplerate;
+  p->win_s = aubio_pvstretch_get_win_size(samplerate);
+  if (aubio_timestretch_set_channels(p, 1) != AUBIO_OK) goto beach;
+
+  return p;
+
+beach:
+  del_aubio_timestretch(p);
+  return NULL;
+}
+
+void
+del_aubio_timestretch (aubio_timestretch_t * p)
+{
+  aubio_timestretch_free_channels(p);
+  AUBIO_FREE (p);
+}
+
+uint_t
+aubio_timestretch_get_samplerate (aubio_timestretch_t * p)
+{
+  return p->samplerate;
+}
+
+uint_t aubio_timestretch_get_latency (aubio_timestretch_t * p) {
+  return aubio_pvstretch_get_latency(p->pv[0]);
+}
+
+uint_t
+aubio_timestretch_set_stretch (aubio_timestretch_t * p, smpl_t stretch)
+{
+  uint_t ch;
+  if (stretch >= MIN_STRETCH_RATIO && stretch <= MAX_STRETCH_RATIO) {
+    p->stretchratio = stretch;
+    for (ch = 0; ch < p->channels; ch++) {
+      aubio_pvstretch_set_speed(p->pv[ch], stretch);
+    }
+    return AUBIO_OK;
+  } else {
+    AUBIO_ERR("timestretch: could not set stretch ratio to '%f',"
+        " should be in the range [%.2f, %.2f].\n", stretch,
+        MIN_STRETCH_RATIO, MAX_STRETCH_RATIO);
+    return AUBIO_FAIL;
+  }
+}
+
+smpl_t
+aubio_timestretch_get_stretch (aubio_timestretch_t * p)
+{
+  return p->stretchratio;
+}
+
+uint_t
+aubio_timestretch_set_pitchscale (aubio_timestretch_t * p, smpl_t pitchscale)
+{
+  uint_t ch;
+  if (pitchscale >= 0.0625  && pitchscale <= 4.) {
+    p->pitchscale = pitchscale;
+    for (ch = 0; ch < p->channels; ch++) {
+      aubio_pvstretch_set_pitchscale(p->pv[ch], pitchscale);
+    }
+    return AUBIO_OK;
+  } else {
+    AUBIO_ERR("timestretch: could not set pitchscale to '%f',"
+        " should be in the range [0.0625, 4.].\n", pitchscale);
+    return AUBIO_FAIL;
+  }
+}
+
+smpl_t
+aubio_timestretch_get_pitchscale (aubio_timestretch_t * p)
+{
+  return p->pitchscale;
+}
+
+uint_t
+aubio_timestretch_set_transpose(aubio_timestretch_t * p, smpl_t transpose)
+{
+  if (transpose >= -24. && transpose <= 24.) {
+    smpl_t pitchscale = POW(2., transpose / 12.);
+    return aubio_timestretch_set_pitchscale(p, pitchscale);
+  } else {
+    AUBIO_ERR("timestretch: could not set transpose to '%f',"
+        " should be in the range [-24; 24].\n", transpose);
+    return AUBIO_FAIL;
+  }
+}
+
+smpl_t
+aubio_timestretch_get_transpose(aubio_timestretch_t * p)
+{
+  return 12. * LOG(p->pitchscale) / LOG(2.0);
+}
+
+/* push length frames of each row of data, then flush at the end of file */
+static sint_t
+aubio_timestretch_process (aubio_timestretch_t *p, smpl_t **data,
+    uint_t length, uint_t eof)
+{
+  uint_t ch;
+  for (ch = 0; ch < p->channels; ch++) {
+    aubio_pvstretch_push(p->pv[ch], data[ch], length);
+    // let the last frames through
+    if (eof) aubio_pvstretch_push(p->pv[ch], NULL, p->win_s);
+  }
+  return aubio_timestretch_get_available(p);
+}
+
+sint_t
+aubio_timestretch_push(aubio_timestretch_t *p, fvec_t *input, uint_t length)
+{
+  uint_t eof = (input->length != length) ? 1 : 0;
+  if (p->channels != 1) {
+    AUBIO_ERR("timestretch: got 1 channel, expected %d\n", p->channels);
+    return -1;
+  }
+  if (length > input->length) {
+    AUBIO_ERR("timestretch: can not push %d frames from %d\n", length,
+        input->length);
+    return -1;
+  }
+  return aubio_timestretch_process(p, &input->data, length, eof);
+}
+
+sint_t
+aubio_timestretch_push_multi(aubio_timestretch_t *p, const fmat_t *input,
+    uint_t length)
+{
+  uint_t eof = (input->length != length) ? 1 : 0;
+  if (input->height != p->channels) {
+    AUBIO_ERR("timestretch: got %d channels, expected %d\n", input->height,
+        p->channels);
+    return -1;
+  }
+  if (length > input->length) {
+    AUBIO_ERR("timestretch: can not push %d frames from %d\n", length,
+        input->length);
+    return -1;
+  }
+  return aubio_timestretch_process(p, input->data, length, eof);
+}
+
+sint_t
+aubio_timestretch_get_available(aubio_timestretch_t *p) {
+  return aubio_pvstretch_get_available(p->pv[0]);
+}
+
+/* read up to length frames into the rows of data, zero the rest */
+static uint_t
+aubio_timestretch_retrieve (aubio_timestretch_t *p, smpl_t **data,
+    uint_t length)
+{
+  uint_t ch, got = 0;
+  fvec_t zeros;
+  for (ch = 0; ch < p->channels; ch++) {
+    // all channels have the same number of frames available
+    got = aubio_pvstretch_read(p->pv[ch], data[ch], length);
+    zeros.data = data[ch] + got;
+    zeros.length = length - got;
+    fvec_zeros(&zeros);
+  }
+  return got;
+}
+
+void
+aubio_timestretch_do(aubio_timestretch_t * p, fvec_t * out, uint_t * read)
+{
+  if (p->channels != 1) {
+    AUBIO_ERR("timestretch: got 1 channel, expected %d\n", p->channels);
+    fvec_zeros(out);
+    *read = 0;
+    return;
+  }
+  *read = aubio_timestretch_retrieve(p, &out->data, out->length);
+}
+
+void
+aubio_timestretch_do_multi(aubio_timestretch_t * p, fmat_t * out,
+    uint_t * read)
+{
+  if (out->height != p->channels) {
+    AUBIO_ERR("timestretch: got %d channels, expected %d\n", out->height,
+        p->channels);
+    fmat_zeros(out);
+    *read = 0;
+    return;
+  }
+  *read = aubio_timestretch_retrieve(p, out->data, out->length);
+}
+
+uint_t
+aubio_timestretch_reset(aubio_timestretch_t *p)
+{
+  uint_t ch;
+  for (ch = 0; ch < p->channels; ch++) {
+    aubio_pvstretch_reset(p->pv[ch]);
+  }
+  return AUBIO_OK;
+}
+
+#endif /* HAVE_RUBBERBAND */
@@ -28,10 +28,14 @@
 #include "effects/timestretch.h"
 
 #include <rubberband/rubberband-c.h>
+#include "effects/lazy_rubberband_priv.h"
 
 #define MIN_STRETCH_RATIO 0.025
 #define MAX_STRETCH_RATIO 40.
 
+/* largest number of frames passed to rubberband at once */
+#define AUBIO_TIMESTRETCH_BLOCK 4096
+
 #define HAVE_THREADS 1
 #if 0
 #undef HAVE_THREADS
@@ -48,6 +52,9 @@ struct _aubio_timestretch_t
   uint_t hopsize;                 /**< hop size */
   smpl_t stretchratio;            /**< time ratio */
   smpl_t pitchscale;              /**< pitch scale */
+  uint_t channels;                /**< number of channels */
+  uint_t block_size;              /**< max frames per rubberband_process */
+  smpl_t **rows;                  /**< [channels] pointers to the data */
 
   RubberBandState rb;
   RubberBandOptions rboptions;
@@ -57,6 +64,28 @@ extern RubberBandOptions aubio_get_rubberband_opts(const char_t *mode);
 
 //static void aubio_timestretch_warmup (aubio_timestretch_t * p);
 
+/* (re)create the rubberband instance, with the given number of channels */
+static uint_t
+aubio_timestretch_create (aubio_timestretch_t *p, uint_t channels,
+    double timeratio)
+{
+  RubberBandState rb = rubberband_new(p->samplerate, channels, p->rboptions,
+      timeratio, p->pitchscale);
+  smpl_t **rows = AUBIO_ARRAY(smpl_t *, channels);
+  if (!rb || !rows) {
+    if (rb) rubberband_delete(rb);
+    if (rows) AUBIO_FREE(rows);
+    return AUBIO_FAIL;
+  }
+  rubberband_set_max_process_size(rb, p->block_size);
+  if (p->rb) rubberband_delete(p->rb);
+  if (p->rows) AUBIO_FREE(p->rows);
+  p->rb = rb;
+  p->rows = rows;
+  p->channels = channels;
+  return AUBIO_OK;
+}
+
 aubio_timestretch_t *
 new_aubio_timestretch (const char_t * mode, smpl_t stretchratio, uint_t hopsize,
     uint_t samplerate)
@@ -66,6 +95,10 @@ new_aubio_timestretch (const char_t * mode, smpl_t stretchratio, uint_t hopsize,
   if (!p) {
     return NULL;
   }
+  if (aubio_rubberband_load()) {
+    AUBIO_FREE(p);
+    return NULL;
+  }
   p->hopsize = hopsize;
   p->pitchscale = 1.;
 
@@ -93,10 +126,9 @@ new_aubio_timestretch (const char_t * mode, smpl_t stretchratio, uint_t hopsize,
     goto beach;
   }
 
-  p->rb = rubberband_new(samplerate, 1, p->rboptions, p->stretchratio, p->pitchscale);
-  if (!p->rb) goto beach;
-
   p->samplerate = samplerate;
+  p->block_size = MAX(hopsize, AUBIO_TIMESTRETCH_BLOCK);
+  if (aubio_timestretch_create(p, 1, p->stretchratio) != AUBIO_OK) goto beach;
 
   //aubio_timestretch_warmup(p);
 
@@ -129,6 +161,9 @@ del_aubio_timestretch (aubio_timestretch_t * p)
   if (p->rb) {
     rubberband_delete(p->rb);
   }
+  if (p->rows) {
+    AUBIO_FREE (p->rows);
+  }
   AUBIO_FREE (p);
 }
 
@@ -212,17 +247,77 @@ aubio_timestretch_get_transpose(aubio_timestretch_t * p)
   return 12. * LOG(p->pitchscale) / LOG(2.0);
 }
 
+uint_t
+aubio_timestretch_set_channels (aubio_timestretch_t * p, uint_t channels)
+{
+  if ((sint_t)channels <= 0) {
+    AUBIO_ERR("timestretch: channels should be > 0, got %d\n", channels);
+    return AUBIO_FAIL;
+  }
+  if (channels == p->channels) return AUBIO_OK;
+  // keep the current ratios, the buffered frames are dropped
+  return aubio_timestretch_create(p, channels,
+      rubberband_get_time_ratio(p->rb));
+}
+
+uint_t
+aubio_timestretch_get_channels (aubio_timestretch_t * p)
+{
+  return p->channels;
+}
+
+/* pass length frames of each row of data to rubberband, in blocks of at most
+   p->block_size frames */
+static sint_t
+aubio_timestretch_process (aubio_timestretch_t *p, smpl_t **data,
+    uint_t length, uint_t eof)
+{
+  uint_t pos = 0, n, ch;
+  do {
+    n = MIN(length - pos, p->block_size);
+    for (ch = 0; ch < p->channels; ch++) {
+      p->rows[ch] = data[ch] + pos;
+    }
+    rubberband_process(p->rb, (const float* const*)p->rows, n,
+        eof && pos + n == length);
+    pos += n;
+  } while (pos < length);
+  return rubberband_available(p->rb);
+}
+
 sint_t
 aubio_timestretch_push(aubio_timestretch_t *p, fvec_t *input, uint_t length)
 {
   // push new samples to rubberband, return available
-  int available;
-  int eof = (input->length != length) ? 1 : 0;
-  rubberband_process(p->rb, (const float* const*)&(input->data), length, eof);
-  available = rubberband_available(p->rb);
-  //AUBIO_WRN("timestretch: processed %d, %d available, eof: %d\n",
-  //    length, available, eof);
-  return available;
+  uint_t eof = (input->length != length) ? 1 : 0;
+  if (p->channels != 1) {
+    AUBIO_ERR("timestretch: got 1 channel, expected %d\n", p->channels);
+    return -1;
+  }
+  if (length > input->length) {
+    AUBIO_ERR("timestretch: can not push %d frames from %d\n", length,
+        input->length);
+    return -1;
+  }
+  return aubio_timestretch_process(p, &input->data, length, eof);
+}
+
+sint_t
+aubio_timestretch_push_multi(aubio_timestretch_t *p, const fmat_t *input,
+    uint_t length)
+{
+  uint_t eof = (input->length != length) ? 1 : 0;
+  if (input->height != p->channels) {
+    AUBIO_ERR("timestretch: got %d channels, expected %d\n", input->height,
+        p->channels);
+    return -1;
+  }
+  if (length > input->length) {
+    AUBIO_ERR("timestretch: can not push %d frames from %d\n", length,
+        input->length);
+    return -1;
+  }
+  return aubio_timestretch_process(p, input->data, length, eof);
 }
 
 sint_t
@@ -230,26 +325,51 @@ aubio_timestretch_get_available(aubio_timestretch_t *p) {
   return rubberband_available(p->rb);
 }
 
-void
-aubio_timestretch_do(aubio_timestretch_t * p, fvec_t * out, uint_t * read)
+/* retrieve up to length frames into the rows of data, zero the rest */
+static uint_t
+aubio_timestretch_retrieve (aubio_timestretch_t *p, smpl_t **data,
+    uint_t length)
 {
-  // now retrieve the samples and write them into out->data
+  uint_t ch, got = 0;
   int available = rubberband_available(p->rb);
-  if (available >= (int)out->length) {
-    rubberband_retrieve(p->rb, (float* const*)&(out->data), out->length);
-    *read = out->length;
-  } else if (available > 0) {
-    // this occurs each time the end of file is reached
-    //AUBIO_WRN("timestretch: short read\n");
-    rubberband_retrieve(p->rb, (float* const*)&(out->data), available);
-    fvec_t zeros; zeros.length = out->length - available; zeros.data = out->data + available;
+  fvec_t zeros;
+  if (available > 0) {
+    // this is a short read each time the end of file is reached
+    got = MIN((uint_t)available, length);
+    rubberband_retrieve(p->rb, (float* const*)data, got);
+  }
+  for (ch = 0; ch < p->channels; ch++) {
+    zeros.data = data[ch] + got;
+    zeros.length = length - got;
     fvec_zeros(&zeros);
-    *read = available;
-  } else {
-    // this may occur if the previous was a short read available == hopsize
+  }
+  return got;
+}
+
+void
+aubio_timestretch_do(aubio_timestretch_t * p, fvec_t * out, uint_t * read)
+{
+  if (p->channels != 1) {
+    AUBIO_ERR("timestretch: got 1 channel, expected %d\n", p->channels);
     fvec_zeros(out);
     *read = 0;
+    return;
+  }
+  *read = aubio_timestretch_retrieve(p, &out->data, out->length);
+}
+
+void
+aubio_timestretch_do_multi(aubio_timestretch_t * p, fmat_t * out,
+    uint_t * read)
+{
+  if (out->height != p->channels) {
+    AUBIO_ERR("timestretch: got %d channels, expected %d\n", out->height,
+        p->channels);
+    fmat_zeros(out);
+    *read = 0;
+    return;
   }
+  *read = aubio_timestretch_retrieve(p, out->data, out->length);
 }
 
 uint_t
@@ -20,52 +20,42 @@
 
 #include "aubio_priv.h"
 #include "fmat.h"
+#include "utils/simd_priv.h"
 
 fmat_t * new_fmat (uint_t height, uint_t length) {
   fmat_t * s;
-  uint_t i,j;
+  uint_t i, head, rows, row;
   if ((sint_t)length <= 0 || (sint_t)height <= 0 ) {
     return NULL;
   }
-  s = AUBIO_NEW(fmat_t);
+  // a single block: the structure, the row pointers, then each row aligned
+  head = AUBIO_ALIGN_SIZE(sizeof(fmat_t));
+  rows = AUBIO_ALIGN_SIZE(height * sizeof(smpl_t*));
+  row = AUBIO_ALIGN_SIZE(length * sizeof(smpl_t));
+  s = (fmat_t *)AUBIO_ARRAY(char, head + rows + height * row);
   if (!s) {
     return NULL;
   }
   s->height = height;
   s->length = length;
-  s->data = AUBIO_ARRAY(smpl_t*,s->height);
-  if (!s->data) {
-    AUBIO_FREE(s);
-    return NULL;
-  }
+  s->data = (smpl_t **)((char *)s + head);
   for (i=0; i< s->height; i++) {
-    s->data[i] = AUBIO_ARRAY(smpl_t, s->length);
-    if (!s->data[i]) {
-      /* cleanup previously allocated rows */
-      while (i > 0) {
-        i--;
-        AUBIO_FREE(s->data[i]);
-      }
-      AUBIO_FREE(s->data);
-      AUBIO_FREE(s);
-      return NULL;
-    }
-    for (j=0; j< s->length; j++) {
-      s->data[i][j]=0.;
-    }
+    s->data[i] = (smpl_t *)((char *)s + head + rows + i * row);
   }
   return s;
 }
 
 void del_fmat (fmat_t *s) {
-  uint_t i;
-  for (i=0; i<s->height; i++) {
-    AUBIO_FREE(s->data[i]);
-  }
-  AUBIO_FREE(s->data);
   AUBIO_FREE(s);
 }
 
+uint_t fmat_get_memory_usage(const fmat_t *s) {
+  AUBIO_ASSERT_NOT_NULL(s);
+  return (uint_t)(AUBIO_ALIGN_SIZE(sizeof(fmat_t))
+      + AUBIO_ALIGN_SIZE(s->height * sizeof(smpl_t*))
+      + s->height * AUBIO_ALIGN_SIZE(s->length * sizeof(smpl_t)));
+}
+
 void fmat_set_sample(fmat_t *s, smpl_t data, uint_t channel, uint_t position) {
   s->data[channel][position] = data;
 }
@@ -88,6 +78,34 @@ smpl_t ** fmat_get_data(const fmat_t *s) {
   return s->data;
 }
 
+uint_t fmat_view(fmat_t *view, smpl_t **rows, const fmat_t *s, uint_t start,
+    uint_t length) {
+  uint_t i;
+  if (start > s->length || length > s->length - start) {
+    AUBIO_ERR("trying to view columns %d to %d of %d columns\n",
+        start, start + length, s->length);
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < s->height; i++) {
+    rows[i] = s->data[i] + start;
+  }
+  view->data = rows;
+  view->height = s->height;
+  view->length = length;
+  return AUBIO_OK;
+}
+
+uint_t fmat_get_stride(const fmat_t *s) {
+  uint_t i, stride;
+  if (s->height < 2) return s->length;
+  if (s->data[1] < s->data[0] + s->length) return 0;
+  stride = (uint_t)(s->data[1] - s->data[0]);
+  for (i = 2; i < s->height; i++) {
+    if (s->data[i] != s->data[i - 1] + stride) return 0;
+  }
+  return stride;
+}
+
 /* helper functions */
 
 void fmat_print(const fmat_t *s) {
@@ -172,20 +190,17 @@ void fmat_copy(const fmat_t *s, fmat_t *t) {
 }
 
 void fmat_vecmul(const fmat_t *s, const fvec_t *scale, fvec_t *output) {
+#if defined(HAVE_ACCELERATE) || defined(HAVE_BLAS)
   uint_t k;
+#endif
 #if 0
   assert(s->height == output->length);
   assert(s->length == scale->length);
 #endif
 #if !defined(HAVE_ACCELERATE) && !defined(HAVE_BLAS)
-  uint_t j;
-  fvec_zeros(output);
-  for (j = 0; j < s->length; j++) {
-    for (k = 0; k < s->height; k++) {
-      output->data[k] += scale->data[j]
-          * s->data[k][j];
-    }
-  }
+  /* row by row, several rows at a time, on vector units when available */
+  AUBIO_SIMD()->mvmul((const smpl_t * const *)s->data, scale->data,
+      output->data, s->height, s->length);
 #elif defined(HAVE_BLAS)
   for (k = 0; k < s->height; k++) {
     output->data[k] = aubio_cblas_dot( s->length, scale->data, 1, s->data[k], 1);
@@ -32,6 +32,9 @@ extern "C" {
   This file specifies the fmat_t type, which is used in aubio to store arrays
   of floating point values.
 
+  Each row of a matrix created by ::new_fmat is aligned and padded to
+  ::aubio_get_alignment bytes.
+
   \example test-fmat.c
 
 */
@@ -58,6 +61,16 @@ fmat_t * new_fmat(uint_t height, uint_t length);
 */
 void del_fmat(fmat_t *s);
 
+/** get the memory used by a fmat_t buffer
+
+  \param s buffer as returned by new_fmat()
+
+  \return number of bytes of the buffer, including its structure; see
+  utils/allocator.h
+
+*/
+uint_t fmat_get_memory_usage(const fmat_t *s);
+
 /** read sample value in a buffer
 
   \param s vector to read from
@@ -83,6 +96,8 @@ void  fmat_set_sample(fmat_t *s, smpl_t data, uint_t channel, uint_t position);
   \param channel channel to read from
   \param output ::fvec_t to output to
 
+  `output` is set to point to the row of `s`, without copying it.
+
 */
 void fmat_get_channel (const fmat_t *s, uint_t channel, fvec_t *output);
 
@@ -101,6 +116,39 @@ smpl_t * fmat_get_channel_data (const fmat_t *s, uint_t channel);
 */
 smpl_t ** fmat_get_data(const fmat_t *s);
 
+/** point a matrix to some columns of another matrix, without copying
+
+  \param view matrix to set, typically on the stack; its data is not freed
+  \param rows storage for the row pointers of `view`, of at least
+  `s->height` elements
+  \param s matrix to view
+  \param start index of the first column of `s` to view
+  \param length number of columns to view
+
+  \return 0 on success, non-zero if the columns do not fit in `s`
+
+  `view` shares the data of `s`, and should not be deleted with
+  ::del_fmat. It remains valid as long as `s` and `rows` are.
+
+*/
+uint_t fmat_view(fmat_t *view, smpl_t **rows, const fmat_t *s, uint_t start,
+    uint_t length);
+
+/** get distance between the rows of a matrix
+
+  \param s matrix to read from
+
+  \return number of ::smpl_t from the start of a row to the start of the
+  next one, or 0 if the rows of `s` are not evenly spaced
+
+  The rows of a matrix created by ::new_fmat are evenly spaced in a single
+  block, so that `s->data[0]` can be passed to functions expecting a dense
+  matrix with a leading dimension of the returned stride. Views and
+  matrices whose rows were set by hand may not be.
+
+*/
+uint_t fmat_get_stride(const fmat_t *s);
+
 /** print out fmat data
 
   \param s vector to print out
@@ -20,30 +20,35 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "utils/simd_priv.h"
 
 fvec_t * new_fvec(uint_t length) {
   fvec_t * s;
   if ((sint_t)length <= 0) {
     return NULL;
   }
-  s = AUBIO_NEW(fvec_t);
+  // a single block, with the samples aligned after the structure and
+  // padded to a whole number of AUBIO_ALIGNMENT bytes
+  s = (fvec_t *)AUBIO_ARRAY(char, AUBIO_ALIGN_SIZE(sizeof(fvec_t))
+      + AUBIO_ALIGN_SIZE(length * sizeof(smpl_t)));
   if (!s) {
     return NULL;
   }
   s->length = length;
-  s->data = AUBIO_ARRAY(smpl_t, s->length);
-  if (!s->data) {
-    AUBIO_FREE(s);
-    return NULL;
-  }
+  s->data = (smpl_t *)((char *)s + AUBIO_ALIGN_SIZE(sizeof(fvec_t)));
   return s;
 }
 
 void del_fvec(fvec_t *s) {
-  AUBIO_FREE(s->data);
   AUBIO_FREE(s);
 }
 
+uint_t fvec_get_memory_usage(const fvec_t *s) {
+  AUBIO_ASSERT_NOT_NULL(s);
+  return (uint_t)(AUBIO_ALIGN_SIZE(sizeof(fvec_t))
+      + AUBIO_ALIGN_SIZE(s->length * sizeof(smpl_t)));
+}
+
 void fvec_set_sample(fvec_t *s, smpl_t data, uint_t position) {
   AUBIO_ASSERT_NOT_NULL(s);
   AUBIO_ASSERT_BOUNDS(position, s->length);
@@ -61,6 +66,18 @@ smpl_t * fvec_get_data(const fvec_t *s) {
   return s->data;
 }
 
+uint_t fvec_view(fvec_t *view, const fvec_t *s, uint_t start, uint_t length) {
+  AUBIO_ASSERT_NOT_NULL(s);
+  if (start > s->length || length > s->length - start) {
+    AUBIO_ERR("trying to view elements %d to %d of %d elements\n",
+        start, start + length, s->length);
+    return AUBIO_FAIL;
+  }
+  view->data = s->data + start;
+  view->length = length;
+  return AUBIO_OK;
+}
+
 /* helper functions */
 
 void fvec_print(const fvec_t *s) {
@@ -123,6 +140,8 @@ void fvec_weight(fvec_t *s, const fvec_t *weight) {
   aubio_ippsMul(s->data, weight->data, s->data, (int)length);
 #elif defined(HAVE_ACCELERATE)
   aubio_vDSP_vmul( s->data, 1, weight->data, 1, s->data, 1, length );
+#elif defined(HAVE_AUBIO_SIMD)
+  AUBIO_SIMD()->weight(s->data, weight->data, length);
 #else
   uint_t j;
   for (j = 0; j < length; j++) {
@@ -141,6 +160,8 @@ void fvec_weighted_copy(const fvec_t *in, const fvec_t *weight, fvec_t *out) {
   aubio_ippsMul(in->data, weight->data, out->data, (int)length);
 #elif defined(HAVE_ACCELERATE)
   aubio_vDSP_vmul(in->data, 1, weight->data, 1, out->data, 1, length);
+#elif defined(HAVE_AUBIO_SIMD)
+  AUBIO_SIMD()->weighted_copy(in->data, weight->data, out->data, length);
 #else
   uint_t j;
   for (j = 0; j < length; j++) {
@@ -42,6 +42,9 @@ extern "C" {
 
   ::fvec_t is is the structure used to store vector of real-valued data, ::smpl_t .
 
+  The data of a vector created by ::new_fvec is aligned and padded to
+  ::aubio_get_alignment bytes.
+
   \code
 
   uint_t buffer_size = 1024;
@@ -83,6 +86,16 @@ fvec_t * new_fvec(uint_t length);
 */
 void del_fvec(fvec_t *s);
 
+/** get the memory used by a fvec_t buffer
+
+  \param s buffer as returned by new_fvec()
+
+  \return number of bytes of the buffer, including its structure; see
+  utils/allocator.h
+
+*/
+uint_t fvec_get_memory_usage(const fvec_t *s);
+
 /** read sample value in a buffer
 
   \param s vector to read from
@@ -107,6 +120,21 @@ void  fvec_set_sample(fvec_t *s, smpl_t data, uint_t position);
 */
 smpl_t * fvec_get_data(const fvec_t *s);
 
+/** point a vector to a slice of another vector, without copying
+
+  \param view vector to set, typically on the stack; its data is not freed
+  \param s vector to view
+  \param start index of the first element of `s` to view
+  \param length number of elements to view
+
+  \return 0 on success, non-zero if the slice does not fit in `s`
+
+  `view` shares the data of `s`, and should not be deleted with
+  ::del_fvec. It remains valid as long as `s` is.
+
+*/
+uint_t fvec_view(fvec_t *view, const fvec_t *s, uint_t start, uint_t length);
+
 /** print out fvec data
 
   \param s vector to print out
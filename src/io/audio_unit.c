@@ -24,6 +24,8 @@
 #include "fvec.h"
 #include "fmat.h"
 #include "io/audio_unit.h"
+#include "io/ioutils_priv.h"
+#include "utils/rthost.h"
 
 #include <AudioToolbox/AudioToolbox.h>
 
@@ -32,8 +34,6 @@
 #define PREFERRED_LATENCY 0.010
 #define MAX_FPS 4096
 
-#define INT_TO_FLOAT 3.0517578125e-05 // 1. / 32768.
-
 struct _aubio_audio_unit_t {
   AudioUnit audio_unit;
   uint_t samplerate;
@@ -57,6 +57,13 @@ struct _aubio_audio_unit_t {
   int au_ios_start;
   int au_ios_end;
   AURenderCallbackStruct au_ios_cb_struct;
+  bool initialized;
+  fmat_t *hw_input_frames;   /**< deinterleaved hardware input, one row per
+                               hardware channel */
+  aubio_rthost_t *host;      /**< worker running the callback, or NULL */
+  fmat_t *render_frames;     /**< input of the render callback, in worker
+                               mode, MAX_FPS long */
+  fvec_t *render_output;     /**< output of the worker, MAX_FPS long */
 };
 
 
@@ -67,6 +74,12 @@ aubio_audio_unit_process(void *closure, AudioUnitRenderActionFlags * action_flag
 
 static int aubio_audio_unit_blocking(aubio_audio_unit_t *o);
 
+static OSStatus aubio_audio_unit_handoff(aubio_audio_unit_t *o,
+    AudioBufferList * input_output, UInt32 number_frames);
+
+static void aubio_audio_unit_work(void *closure, fvec_t *input,
+    fvec_t *output);
+
 static void audio_unit_check_audio_route(aubio_audio_unit_t *o);
 
 static void audio_unit_interruption_listener(void *closure, UInt32 inInterruptionState);
@@ -109,6 +122,7 @@ aubio_audio_unit_t * new_aubio_audio_unit(uint_t samplerate,
   /* the floats coming from and to the device callback */
   o->output_frames = new_fmat(sw_output_channels, blocksize);
   o->input_frames = new_fmat(sw_input_channels, blocksize);
+  o->hw_input_frames = new_fmat(o->hw_input_channels, blocksize);
 
   /* check for some sizes */
   if ( o->hw_output_channels != o->output_frames->height ) {
@@ -133,8 +147,59 @@ aubio_audio_unit_t * new_aubio_audio_unit(uint_t samplerate,
 
 sint_t aubio_audio_unit_set_preferred_latency (aubio_audio_unit_t *o, smpl_t latency)
 {
-  o->latency = latency;
-  return 0;
+  OSStatus err = noErr;
+  Float32 duration = (Float32)latency;
+  if (!(latency > 0.)) {
+    AUBIO_ERR("audio_unit: got preferred latency %f, expected > 0\n", latency);
+    return -1;
+  }
+  o->latency = duration;
+  // once initialized, apply it now; the session may choose another duration
+  if (o->initialized) {
+    err = AudioSessionSetProperty(
+        kAudioSessionProperty_PreferredHardwareIOBufferDuration,
+        sizeof(duration), &duration);
+    if (err) {
+      AUBIO_ERR("audio_unit: could not set preferred latency (%d)\n",
+          (int)err);
+    }
+  }
+  return err;
+}
+
+smpl_t aubio_audio_unit_get_latency (aubio_audio_unit_t *o)
+{
+  Float32 latency = o->latency;
+  UInt32 thissize = sizeof(latency);
+  if (o->initialized) {
+    AudioSessionGetProperty(kAudioSessionProperty_CurrentHardwareIOBufferDuration,
+        &thissize, &latency);
+  }
+  return latency;
+}
+
+sint_t aubio_audio_unit_set_worker (aubio_audio_unit_t *o, uint_t latency)
+{
+  if (o->initialized) {
+    AUBIO_ERR("audio_unit: the worker should be set before aubio_audio_unit_init\n");
+    return -1;
+  }
+  if (o->host) del_aubio_rthost(o->host);
+  o->host = NULL;
+  if (latency == 0) return 0;
+  if (!o->render_frames) {
+    o->render_frames = new_fmat(o->hw_input_channels, MAX_FPS);
+    o->render_output = new_fvec(MAX_FPS);
+    if (!o->render_frames || !o->render_output) return -1;
+  }
+  o->host = new_aubio_rthost(o->blocksize, latency, aubio_audio_unit_work, o);
+  return o->host ? 0 : -1;
+}
+
+uint_t aubio_audio_unit_get_dropped (aubio_audio_unit_t *o)
+{
+  if (!o->host) return 0;
+  return aubio_rthost_get_dropped(o->host) + aubio_rthost_get_late(o->host);
 }
 
 sint_t aubio_audio_unit_set_prevent_feedback (aubio_audio_unit_t *o, uint_t prevent_feedback)
@@ -211,8 +276,8 @@ sint_t aubio_audio_unit_init (aubio_audio_unit_t *o)
     goto fail;
   }
 
-  /* set max fps */
-  UInt32 max_fps = MIN(o->blocksize, MAX_FPS);
+  /* set max fps, the worker taking slices of any size */
+  UInt32 max_fps = o->host ? MAX_FPS : MIN(o->blocksize, MAX_FPS);
   err = AudioUnitSetProperty (*audio_unit, kAudioUnitProperty_MaximumFramesPerSlice,
       kAudioUnitScope_Global, 0, &max_fps, sizeof(max_fps));
   if (err) {
@@ -269,6 +334,7 @@ sint_t aubio_audio_unit_init (aubio_audio_unit_t *o)
   err = AudioUnitInitialize(*audio_unit);
   if (err) { AUBIO_ERR("audio_unit: failed initializing audio, err: %d\n", (int)err); goto fail; }
 
+  o->initialized = true;
   return 0;
 
 fail:
@@ -303,6 +369,11 @@ aubio_audio_unit_process(void *closure, AudioUnitRenderActionFlags * action_flag
     return -1;
   }
 
+  // the callback runs on the worker, never blocking this thread
+  if (o->host) {
+    return aubio_audio_unit_handoff(o, input_output, number_frames);
+  }
+
   if (o->total_frames >= (signed)number_frames) {
 
     SInt16 *data;
@@ -361,7 +432,7 @@ int aubio_audio_unit_blocking(aubio_audio_unit_t *o)
 {
   uint_t sw_output_channels, sw_input_channels,
          hw_output_channels, hw_input_channels,
-         i, j, blocksize;
+         i, blocksize;
   if (! o->callback) return -1;
 
   smpl_t ** tbuf;
@@ -383,38 +454,28 @@ int aubio_audio_unit_blocking(aubio_audio_unit_t *o)
     /* copy samples from input buffer */
     tbuf = o->input_frames->data;
     if (o->input_enabled) {
-      for (j = 0; j < blocksize;j++) {
-        for (i = 0; i < sw_input_channels && i < hw_input_channels; i++) {
-          //tbuf[i][j] =
-          //   (smpl_t)(o->au_ios_inbuf[i + (j + o->au_ios_end) * sw_input_channels] / 32768.);
-          // on iphone, input is mono, copy right to left channel
-          tbuf[i][j] =
-            (smpl_t) o->au_ios_inbuf[0 + (j + o->au_ios_end) * hw_input_channels]
-            * INT_TO_FLOAT;
-        }
+      aubio_io_deinterleave(aubio_io_s16,
+          o->au_ios_inbuf + o->au_ios_end * hw_input_channels,
+          hw_input_channels, o->hw_input_frames, 0, blocksize);
+      // on iphone, input is mono, copy left channel to all the others
+      for (i = 0; i < sw_input_channels && i < hw_input_channels; i++) {
+        memcpy(tbuf[i], o->hw_input_frames->data[0],
+            blocksize * sizeof(smpl_t));
       }
     } else {
       // input is disabled, fill with zeroes
-      for (j = 0; j < blocksize; j++) {
-        for (i = 0; i < sw_input_channels && i < hw_input_channels; i++) {
-          tbuf[i][j] = 0;
-        }
+      for (i = 0; i < sw_input_channels && i < hw_input_channels; i++) {
+        memset(tbuf[i], 0, blocksize * sizeof(smpl_t));
       }
     }
   }
 
   o->callback(o->callback_closure, o->input_frames, o->output_frames);
 
-  /* copy samples to output buffer */
-  tbuf = o->output_frames->data;
-  for (i = 0; i < o->output_frames->height; i++)	{
-    for (j = 0; j < o->output_frames->length; j++) {
-      smpl_t val = tbuf[i][j];
-      if (val < -1.0) val = -1.0;
-      if (val > 1.0) val = 1.0;
-      o->au_ios_outbuf[i + (j + o->au_ios_end) * hw_output_channels ] = (SInt16)(val * 32767);
-    }
-  }
+  /* copy samples to output buffer, clipped to [-1, 1] */
+  aubio_io_interleave(aubio_io_s16, o->output_frames,
+      o->au_ios_outbuf + o->au_ios_end * hw_output_channels,
+      hw_output_channels, blocksize);
 
   o->au_ios_end += blocksize;
   o->au_ios_end %= AU_IOS_MAX_FRAMES;
@@ -428,6 +489,59 @@ fail:
   return 1;
 }
 
+/* pass the samples of the render callback to the worker, and play the
+   output it computed `latency` blocks earlier */
+OSStatus aubio_audio_unit_handoff(aubio_audio_unit_t *o,
+    AudioBufferList * input_output, UInt32 number_frames)
+{
+  UInt32 b, done, n;
+  fvec_t in, out;
+  fmat_t mono;
+  SInt16 *data = (SInt16 *)(input_output->mBuffers[0].mData);
+  mono.height = 1;
+  mono.data = &out.data;
+  for (done = 0; done < number_frames; done += n) {
+    n = MIN(number_frames - done, MAX_FPS);
+    in.length = out.length = mono.length = n;
+    in.data = o->render_frames->data[0];
+    out.data = o->render_output->data;
+    if (o->input_enabled) {
+      aubio_io_deinterleave(aubio_io_s16, data + done * 2, 2,
+          o->render_frames, 0, n);
+    } else {
+      memset(in.data, 0, n * sizeof(smpl_t));
+    }
+    aubio_rthost_do(o->host, &in, &out);
+    aubio_io_interleave(aubio_io_s16, &mono, data + done * 2, 2, n);
+  }
+  // the other buffers, if any, play the same samples
+  for (b = 1; b < input_output->mNumberBuffers; b++) {
+    memcpy(input_output->mBuffers[b].mData, data,
+        MIN(input_output->mBuffers[b].mDataByteSize,
+          input_output->mBuffers[0].mDataByteSize));
+  }
+  return noErr;
+}
+
+/* run the callback on a block, from the worker thread */
+void aubio_audio_unit_work(void *closure, fvec_t *input, fvec_t *output)
+{
+  aubio_audio_unit_t *o = (aubio_audio_unit_t *)closure;
+  uint_t i;
+  if (!o->callback) return;
+  for (i = 0; i < o->input_frames->height; i++) {
+    memcpy(o->input_frames->data[i], input->data,
+        o->blocksize * sizeof(smpl_t));
+  }
+  fmat_zeros(o->output_frames);
+  o->callback(o->callback_closure, o->input_frames, o->output_frames);
+  // the first output channel is played on all the speakers
+  if (o->output_frames->height) {
+    memcpy(output->data, o->output_frames->data[0],
+        o->blocksize * sizeof(smpl_t));
+  }
+}
+
 sint_t aubio_audio_unit_get_info (aubio_audio_unit_t *o)
 {
   UInt32 thissize, input_hw_channels, output_hw_channels, max_fps;
@@ -511,6 +625,11 @@ sint_t aubio_audio_unit_get_info (aubio_audio_unit_t *o)
       input_latency*1000., (sint_t)ROUND(input_latency*samplerate),
       output_latency*1000., (sint_t)ROUND(output_latency*samplerate));
 
+  if (o->host) {
+    AUBIO_MSG("audio_unit: worker %d frames behind, %d blocks dropped\n",
+        aubio_rthost_get_delay(o->host), aubio_audio_unit_get_dropped(o));
+  }
+
 fail:
   return err;
 }
@@ -535,6 +654,7 @@ sint_t aubio_audio_unit_stop(aubio_audio_unit_t *o)
   OSStatus err = AudioOutputUnitStop (o->audio_unit);
   if (err) { AUBIO_WRN("audio_unit: failed stopping audio unit (%d)\n", (int)err); }
   err = AudioUnitUninitialize (o->audio_unit);
+  o->initialized = false;
   if (err) { AUBIO_WRN("audio_unit: failed unitializing audio unit (%d)\n", (int)err); }
   err = AudioSessionSetActive(false);
   if (err) { AUBIO_WRN("audio_unit: failed stopping audio session (%d)\n", (int)err); }
@@ -767,9 +887,15 @@ uint_t del_aubio_audio_unit(aubio_audio_unit_t *o)
 {
   int err = 0;
   err = aubio_audio_unit_stop(o);
-  if (o->au_ios_inbuf) free(o->au_ios_inbuf);
+  // the render callback is stopped, the worker can be joined
+  if (o->host) del_aubio_rthost(o->host);
+  o->host = NULL;
+  if (o->render_frames) del_fmat(o->render_frames);
+  if (o->render_output) del_fvec(o->render_output);
+  if (o->hw_input_frames) del_fmat(o->hw_input_frames);
+  if (o->au_ios_inbuf) AUBIO_FREE(o->au_ios_inbuf);
   o->au_ios_inbuf = NULL;
-  if (o->au_ios_outbuf) free(o->au_ios_outbuf);
+  if (o->au_ios_outbuf) AUBIO_FREE(o->au_ios_outbuf);
   o->au_ios_outbuf = NULL;
   del_fmat (o->input_frames);
   del_fmat (o->output_frames);
@@ -45,6 +45,35 @@ sint_t aubio_audio_unit_set_preferred_latency (aubio_audio_unit_t *o, smpl_t
 sint_t aubio_audio_unit_set_prevent_feedback (aubio_audio_unit_t *o, uint_t
     prevent_feedback);
 
+/** get the duration of the hardware I/O buffers, in seconds
+
+  Once the unit is initialized, returns the duration chosen by the audio
+  session, which may differ from the one set with
+  aubio_audio_unit_set_preferred_latency().
+
+*/
+smpl_t aubio_audio_unit_get_latency (aubio_audio_unit_t *o);
+
+/** run the callback on a worker thread
+
+  \param o audio unit, created with new_aubio_audio_unit()
+  \param latency number of blocks the worker has to process each block, or
+  `0` to run the callback in the render callback (default)
+
+  \return 0 on success, non-zero otherwise
+
+  The render callback passes its samples to the worker through a lock-free
+  ring, see ::aubio_rthost_t, and never waits for it: blocks are dropped
+  when the worker is late. The output is delayed by `latency` blocks, and the
+  first output channel is played on all the speakers. Should be called
+  before aubio_audio_unit_init().
+
+*/
+sint_t aubio_audio_unit_set_worker (aubio_audio_unit_t *o, uint_t latency);
+
+/** get number of blocks dropped by the worker, or played late */
+uint_t aubio_audio_unit_get_dropped (aubio_audio_unit_t *o);
+
 sint_t aubio_audio_unit_get_info (aubio_audio_unit_t *o);
 
 sint_t aubio_audio_unit_init (aubio_audio_unit_t *o);
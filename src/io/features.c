@@ -0,0 +1,501 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/features.h"
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#define AUBIO_FEATURES_MAGIC "aubiofea"
+#define AUBIO_FEATURES_VERSION 1
+#define AUBIO_FEATURES_HEADER 64
+#define AUBIO_FEATURES_ALIGN 64
+
+/* number of values converted at once when writing a column */
+#define AUBIO_FEATURES_BLOCK 1024
+
+static void aubio_features_write_le (unsigned char *p, unsigned long long v,
+    uint_t length)
+{
+  uint_t i;
+  for (i = 0; i < length; i++) {
+    p[i] = (unsigned char)(v >> (i * 8));
+  }
+}
+
+static unsigned long long aubio_features_read_le (const unsigned char *p,
+    uint_t length)
+{
+  unsigned long long v = 0;
+  uint_t i;
+  for (i = 0; i < length; i++) {
+    v |= (unsigned long long)p[i] << (i * 8);
+  }
+  return v;
+}
+
+static unsigned long long aubio_features_align (unsigned long long size)
+{
+  return (size + AUBIO_FEATURES_ALIGN - 1) / AUBIO_FEATURES_ALIGN
+    * AUBIO_FEATURES_ALIGN;
+}
+
+/* 1 if floats are stored little-endian, and can be read in place */
+static uint_t aubio_features_little_endian (void)
+{
+  const float one = 1.f;
+  unsigned char bytes[sizeof(float)];
+  memcpy(bytes, &one, sizeof(float));
+  return sizeof(float) == 4 && bytes[3] == 0x3f && bytes[2] == 0x80;
+}
+
+struct _aubio_feature_sink_t {
+  char_t *path;
+  uint_t n_columns;
+  char_t **names;               /**< name of each column, or NULL */
+  uint_t samplerate;
+  uint_t hop_size;
+  float *rows;                  /**< rows written so far, one after the other */
+  uint_t n_rows;
+  uint_t size;                  /**< number of rows allocated */
+  uint_t closed;
+};
+
+aubio_feature_sink_t *new_aubio_feature_sink (const char_t *uri,
+    uint_t n_columns)
+{
+  aubio_feature_sink_t *s = AUBIO_NEW(aubio_feature_sink_t);
+  if (!s) return NULL;
+  if (!uri) {
+    AUBIO_ERR("feature_sink: Aborted opening null path\n");
+    goto beach;
+  }
+  if ((sint_t)n_columns < 1) {
+    AUBIO_ERR("feature_sink: got %d columns, expected at least 1\n",
+        n_columns);
+    goto beach;
+  }
+  s->path = AUBIO_ARRAY(char_t, strnlen(uri, PATH_MAX) + 1);
+  s->names = AUBIO_ARRAY(char_t *, n_columns);
+  if (!s->path || !s->names) goto beach;
+  strncpy(s->path, uri, strnlen(uri, PATH_MAX) + 1);
+  s->n_columns = n_columns;
+  return s;
+
+beach:
+  del_aubio_feature_sink(s);
+  return NULL;
+}
+
+uint_t aubio_feature_sink_set_name (aubio_feature_sink_t *s, uint_t column,
+    const char_t *name)
+{
+  char_t *copy;
+  if (column >= s->n_columns || !name) {
+    AUBIO_ERR("feature_sink: can not name column %d of %d\n", column,
+        s->n_columns);
+    return AUBIO_FAIL;
+  }
+  copy = AUBIO_ARRAY(char_t, strnlen(name, PATH_MAX) + 1);
+  if (!copy) return AUBIO_FAIL;
+  strncpy(copy, name, strnlen(name, PATH_MAX) + 1);
+  if (s->names[column]) AUBIO_FREE(s->names[column]);
+  s->names[column] = copy;
+  return AUBIO_OK;
+}
+
+uint_t aubio_feature_sink_set_timing (aubio_feature_sink_t *s,
+    uint_t samplerate, uint_t hop_size)
+{
+  if ((sint_t)samplerate < 0 || (sint_t)hop_size < 0) {
+    AUBIO_ERR("feature_sink: got samplerate %d and hop_size %d, expected"
+        " >= 0\n", samplerate, hop_size);
+    return AUBIO_FAIL;
+  }
+  s->samplerate = samplerate;
+  s->hop_size = hop_size;
+  return AUBIO_OK;
+}
+
+/* room for one more row, or NULL if it could not be allocated */
+static float *aubio_feature_sink_add (aubio_feature_sink_t *s)
+{
+  if (s->closed) {
+    AUBIO_ERR("feature_sink: %s was already closed\n", s->path);
+    return NULL;
+  }
+  if (s->n_rows == s->size) {
+    uint_t size = MAX(64, 2 * s->size);
+    float *rows;
+    if (size <= s->size || size > UINT_MAX / s->n_columns) return NULL;
+    rows = (float *)AUBIO_REALLOC(s->rows,
+        (size_t)size * s->n_columns * sizeof(float));
+    if (!rows) return NULL;
+    s->rows = rows;
+    s->size = size;
+  }
+  return s->rows + (size_t)s->n_columns * s->n_rows++;
+}
+
+uint_t aubio_feature_sink_do (aubio_feature_sink_t *s, const fvec_t *row)
+{
+  uint_t i;
+  float *dst;
+  if (row->length < s->n_columns) {
+    AUBIO_ERR("feature_sink: got a row of %d values, expected %d\n",
+        row->length, s->n_columns);
+    return AUBIO_FAIL;
+  }
+  if (!(dst = aubio_feature_sink_add(s))) return AUBIO_FAIL;
+  for (i = 0; i < s->n_columns; i++) {
+    dst[i] = (float)row->data[i];
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_feature_sink_do_multi (aubio_feature_sink_t *s,
+    const fmat_t *rows)
+{
+  uint_t i, j;
+  float *dst;
+  if (rows->height > 0 && rows->length < s->n_columns) {
+    AUBIO_ERR("feature_sink: got rows of %d values, expected %d\n",
+        rows->length, s->n_columns);
+    return AUBIO_FAIL;
+  }
+  for (j = 0; j < rows->height; j++) {
+    if (!(dst = aubio_feature_sink_add(s))) return AUBIO_FAIL;
+    for (i = 0; i < s->n_columns; i++) {
+      dst[i] = (float)rows->data[j][i];
+    }
+  }
+  return AUBIO_OK;
+}
+
+/* write column i of the rows of s to f */
+static uint_t aubio_feature_sink_write_column (const aubio_feature_sink_t *s,
+    uint_t i, unsigned long long stride, FILE *f)
+{
+  unsigned char block[4 * AUBIO_FEATURES_BLOCK];
+  unsigned char zeros[AUBIO_FEATURES_ALIGN] = { 0 };
+  uint_t j, k, n;
+  unsigned int u;
+  for (j = 0; j < s->n_rows; j += n) {
+    n = MIN(AUBIO_FEATURES_BLOCK, s->n_rows - j);
+    for (k = 0; k < n; k++) {
+      float v = s->rows[(size_t)(j + k) * s->n_columns + i];
+      memcpy(&u, &v, sizeof(float));
+      aubio_features_write_le(block + 4 * k, u, 4);
+    }
+    if (fwrite(block, 4, n, f) != n) return AUBIO_FAIL;
+  }
+  n = (uint_t)(stride - 4ULL * s->n_rows);
+  if (n > 0 && fwrite(zeros, 1, n, f) != n) return AUBIO_FAIL;
+  return AUBIO_OK;
+}
+
+uint_t aubio_feature_sink_close (aubio_feature_sink_t *s)
+{
+  unsigned char header[AUBIO_FEATURES_HEADER] = { 0 };
+  unsigned char zeros[AUBIO_FEATURES_ALIGN] = { 0 };
+  unsigned long long names = 0, offset, stride;
+  uint_t i, n;
+  FILE *f;
+  if (s->closed) return AUBIO_OK;
+  s->closed = 1;
+  for (i = 0; i < s->n_columns; i++) {
+    names += (s->names[i] ? strlen(s->names[i]) : 0) + 1;
+  }
+  offset = aubio_features_align(AUBIO_FEATURES_HEADER + names);
+  stride = aubio_features_align(4ULL * s->n_rows);
+  memcpy(header, AUBIO_FEATURES_MAGIC, 8);
+  aubio_features_write_le(header + 8, AUBIO_FEATURES_VERSION, 4);
+  aubio_features_write_le(header + 12, s->n_columns, 4);
+  aubio_features_write_le(header + 16, s->n_rows, 8);
+  aubio_features_write_le(header + 24, s->samplerate, 4);
+  aubio_features_write_le(header + 28, s->hop_size, 4);
+  aubio_features_write_le(header + 32, offset, 8);
+  aubio_features_write_le(header + 40, stride, 8);
+  f = fopen(s->path, "wb");
+  if (!f) {
+    AUBIO_ERR("feature_sink: failed opening %s (%s)\n", s->path,
+        strerror(errno));
+    return AUBIO_FAIL;
+  }
+  if (fwrite(header, 1, sizeof(header), f) != sizeof(header)) goto fail;
+  for (i = 0; i < s->n_columns; i++) {
+    const char_t *name = s->names[i] ? s->names[i] : "";
+    if (fwrite(name, 1, strlen(name) + 1, f) != strlen(name) + 1) goto fail;
+  }
+  n = (uint_t)(offset - AUBIO_FEATURES_HEADER - names);
+  if (n > 0 && fwrite(zeros, 1, n, f) != n) goto fail;
+  for (i = 0; i < s->n_columns; i++) {
+    if (aubio_feature_sink_write_column(s, i, stride, f)) goto fail;
+  }
+  if (fclose(f) != 0) {
+    f = NULL;
+    goto fail;
+  }
+  return AUBIO_OK;
+
+fail:
+  if (f) fclose(f);
+  AUBIO_ERR("feature_sink: failed writing %s\n", s->path);
+  return AUBIO_FAIL;
+}
+
+void del_aubio_feature_sink (aubio_feature_sink_t *s)
+{
+  uint_t i;
+  AUBIO_ASSERT(s);
+  if (s->path && s->names && !s->closed) aubio_feature_sink_close(s);
+  if (s->names) {
+    for (i = 0; i < s->n_columns; i++) {
+      if (s->names[i]) AUBIO_FREE(s->names[i]);
+    }
+    AUBIO_FREE(s->names);
+  }
+  if (s->rows)
+    AUBIO_FREE(s->rows);
+  if (s->path)
+    AUBIO_FREE(s->path);
+  AUBIO_FREE(s);
+}
+
+struct _aubio_feature_source_t {
+  char_t *path;
+  uint_t n_columns;
+  uint_t n_rows;
+  uint_t samplerate;
+  uint_t hop_size;
+  const char_t **names;         /**< names of the columns, inside data */
+  const float **columns;        /**< values of the columns */
+  const unsigned char *data;    /**< content of the file */
+  size_t size;
+  void *map;                    /**< mapped file, or NULL */
+  unsigned char *buffer;        /**< file read in memory, or NULL */
+  float *converted;             /**< columns, on big-endian platforms */
+};
+
+/* map or read the file at s->path into s->data */
+static uint_t aubio_feature_source_load (aubio_feature_source_t *s)
+{
+  long size;
+  FILE *f = fopen(s->path, "rb");
+#ifdef HAVE_MMAP
+  struct stat st;
+  void *map;
+#endif
+  if (!f) {
+    AUBIO_ERR("feature_source: failed opening %s (%s)\n", s->path,
+        strerror(errno));
+    return AUBIO_FAIL;
+  }
+#ifdef HAVE_MMAP
+  if (fstat(fileno(f), &st) == 0 && st.st_size > 0) {
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(f),
+        0);
+    if (map != MAP_FAILED) {
+      fclose(f);
+      s->map = map;
+      s->size = (size_t)st.st_size;
+      s->data = (const unsigned char *)map;
+      return AUBIO_OK;
+    }
+  }
+#endif
+  // fall back to reading the whole file
+  if (fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) < 0
+      || fseek(f, 0, SEEK_SET) != 0) {
+    fclose(f);
+    return AUBIO_FAIL;
+  }
+  s->buffer = AUBIO_ARRAY(unsigned char, MAX(size, 1));
+  if (!s->buffer || fread(s->buffer, 1, size, f) != (size_t)size) {
+    fclose(f);
+    return AUBIO_FAIL;
+  }
+  fclose(f);
+  s->size = (size_t)size;
+  s->data = s->buffer;
+  return AUBIO_OK;
+}
+
+aubio_feature_source_t *new_aubio_feature_source (const char_t *uri)
+{
+  aubio_feature_source_t *s = AUBIO_NEW(aubio_feature_source_t);
+  unsigned long long n_rows, offset, stride, pos;
+  const unsigned char *h;
+  const char_t *end;
+  uint_t i, j, u;
+  if (!s) return NULL;
+  if (!uri) {
+    AUBIO_ERR("feature_source: Aborted opening null path\n");
+    goto beach;
+  }
+  s->path = AUBIO_ARRAY(char_t, strnlen(uri, PATH_MAX) + 1);
+  if (!s->path) goto beach;
+  strncpy(s->path, uri, strnlen(uri, PATH_MAX) + 1);
+  if (aubio_feature_source_load(s)) goto beach;
+
+  h = s->data;
+  if (s->size < AUBIO_FEATURES_HEADER
+      || memcmp(h, AUBIO_FEATURES_MAGIC, 8) != 0
+      || aubio_features_read_le(h + 8, 4) != AUBIO_FEATURES_VERSION) {
+    AUBIO_ERR("feature_source: %s is not a feature file\n", s->path);
+    goto beach;
+  }
+  s->n_columns = (uint_t)aubio_features_read_le(h + 12, 4);
+  n_rows = aubio_features_read_le(h + 16, 8);
+  s->samplerate = (uint_t)aubio_features_read_le(h + 24, 4);
+  s->hop_size = (uint_t)aubio_features_read_le(h + 28, 4);
+  offset = aubio_features_read_le(h + 32, 8);
+  stride = aubio_features_read_le(h + 40, 8);
+  if (s->n_columns == 0 || n_rows > UINT_MAX
+      || offset < AUBIO_FEATURES_HEADER || offset % AUBIO_FEATURES_ALIGN
+      || stride % AUBIO_FEATURES_ALIGN || stride < 4 * n_rows
+      || offset > s->size
+      || (stride > 0 && s->n_columns > (s->size - offset) / stride)) {
+    AUBIO_ERR("feature_source: %s is truncated or corrupted\n", s->path);
+    goto beach;
+  }
+  s->n_rows = (uint_t)n_rows;
+  s->names = AUBIO_ARRAY(const char_t *, s->n_columns);
+  s->columns = AUBIO_ARRAY(const float *, s->n_columns);
+  if (!s->names || !s->columns) goto beach;
+  // the names are null terminated strings between the header and offset
+  pos = AUBIO_FEATURES_HEADER;
+  for (i = 0; i < s->n_columns; i++) {
+    if (pos >= offset) break;
+    s->names[i] = (const char_t *)h + pos;
+    end = (const char_t *)memchr(s->names[i], 0, offset - pos);
+    if (!end) break;
+    pos += end - s->names[i] + 1;
+  }
+  if (i < s->n_columns) {
+    AUBIO_ERR("feature_source: %s has corrupted column names\n", s->path);
+    goto beach;
+  }
+  if (aubio_features_little_endian()) {
+    for (i = 0; i < s->n_columns; i++) {
+      s->columns[i] = (const float *)(h + offset + i * stride);
+    }
+  } else {
+    s->converted = AUBIO_ARRAY(float, MAX(1, (size_t)s->n_columns
+          * s->n_rows));
+    if (!s->converted) goto beach;
+    for (i = 0; i < s->n_columns; i++) {
+      for (j = 0; j < s->n_rows; j++) {
+        u = (uint_t)aubio_features_read_le(h + offset + i * stride + 4 * j,
+            4);
+        memcpy(&s->converted[(size_t)i * s->n_rows + j], &u, sizeof(float));
+      }
+      s->columns[i] = s->converted + (size_t)i * s->n_rows;
+    }
+  }
+  return s;
+
+beach:
+  del_aubio_feature_source(s);
+  return NULL;
+}
+
+uint_t aubio_feature_source_get_n_columns (const aubio_feature_source_t *s)
+{
+  return s->n_columns;
+}
+
+uint_t aubio_feature_source_get_n_rows (const aubio_feature_source_t *s)
+{
+  return s->n_rows;
+}
+
+uint_t aubio_feature_source_get_samplerate (const aubio_feature_source_t *s)
+{
+  return s->samplerate;
+}
+
+uint_t aubio_feature_source_get_hop_size (const aubio_feature_source_t *s)
+{
+  return s->hop_size;
+}
+
+const char_t *aubio_feature_source_get_name (const aubio_feature_source_t *s,
+    uint_t column)
+{
+  return column < s->n_columns ? s->names[column] : NULL;
+}
+
+sint_t aubio_feature_source_find (const aubio_feature_source_t *s,
+    const char_t *name)
+{
+  uint_t i;
+  if (!name) return -1;
+  for (i = 0; i < s->n_columns; i++) {
+    if (strcmp(s->names[i], name) == 0) return (sint_t)i;
+  }
+  return -1;
+}
+
+const float *aubio_feature_source_get_column (const aubio_feature_source_t *s,
+    uint_t column)
+{
+  return column < s->n_columns ? s->columns[column] : NULL;
+}
+
+uint_t aubio_feature_source_do (const aubio_feature_source_t *s, uint_t row,
+    fvec_t *out)
+{
+  uint_t i;
+  if (row >= s->n_rows || out->length < s->n_columns) {
+    AUBIO_ERR("feature_source: can not read row %d of %d into %d values\n",
+        row, s->n_rows, out->length);
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < s->n_columns; i++) {
+    out->data[i] = s->columns[i][row];
+  }
+  return AUBIO_OK;
+}
+
+void del_aubio_feature_source (aubio_feature_source_t *s)
+{
+  AUBIO_ASSERT(s);
+#ifdef HAVE_MMAP
+  if (s->map)
+    munmap(s->map, s->size);
+#endif
+  if (s->buffer)
+    AUBIO_FREE(s->buffer);
+  if (s->converted)
+    AUBIO_FREE(s->converted);
+  if (s->names)
+    AUBIO_FREE(s->names);
+  if (s->columns)
+    AUBIO_FREE(s->columns);
+  if (s->path)
+    AUBIO_FREE(s->path);
+  AUBIO_FREE(s);
+}
@@ -0,0 +1,252 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_FEATURES_H
+#define AUBIO_FEATURES_H
+
+/** \file
+
+  Feature files, to store frame-level features in columns
+
+  A feature file holds a table of rows, for instance one per hop, of a fixed
+  number of columns, for instance the onset detection function, the
+  coefficients of ::aubio_mfcc_t or the pitch and its confidence. Each
+  column is stored as a contiguous array of 32-bit floats, aligned on 64
+  bytes, so that the file can be mapped in memory and each column read in
+  place, without parsing.
+
+  All the integers and floats are little-endian. The file starts with a
+  header of 64 bytes:
+
+    - 0: the magic `aubiofea`
+    - 8: version, 32 bits, 1
+    - 12: number of columns, 32 bits
+    - 16: number of rows, 64 bits
+    - 24: samplerate of the analysis, 32 bits, 0 if unknown
+    - 28: hop size of the analysis, 32 bits, 0 if unknown
+    - 32: offset of the first column, 64 bits, a multiple of 64
+    - 40: stride between two columns, in bytes, 64 bits, a multiple of 64
+    - 48: 16 bytes set to 0
+
+  The header is followed by the names of the columns, each terminated by a
+  null byte, then by the columns, column `i` starting at `offset + i *
+  stride`.
+
+  ::aubio_feature_sink_t writes feature files, one row at a time, or one
+  matrix at a time with ::aubio_feature_sink_do_multi, for instance from the
+  callback of ::aubio_batch_run. ::aubio_feature_source_t reads them, from a
+  memory mapping where available.
+
+  \example io/test-features.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** feature file writer */
+typedef struct _aubio_feature_sink_t aubio_feature_sink_t;
+
+/** create feature file writer
+
+  \param uri path of the file to write
+  \param n_columns number of values in each row
+
+  \return newly created ::aubio_feature_sink_t, or NULL on failure
+
+  The rows are kept in memory, and written to `uri` by
+  ::aubio_feature_sink_close.
+
+*/
+aubio_feature_sink_t *new_aubio_feature_sink (const char_t *uri,
+    uint_t n_columns);
+
+/** set name of a column
+
+  \param s feature sink, created by ::new_aubio_feature_sink
+  \param column index of the column
+  \param name name of the column, for instance `pitch`
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_feature_sink_set_name (aubio_feature_sink_t *s, uint_t column,
+    const char_t *name);
+
+/** set samplerate and hop size of the analysis, stored in the header
+
+  \param s feature sink, created by ::new_aubio_feature_sink
+  \param samplerate samplerate of the analysed signal
+  \param hop_size number of samples between two rows
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_feature_sink_set_timing (aubio_feature_sink_t *s,
+    uint_t samplerate, uint_t hop_size);
+
+/** append a row
+
+  \param s feature sink, created by ::new_aubio_feature_sink
+  \param row values of the row, of length at least the number of columns
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_feature_sink_do (aubio_feature_sink_t *s, const fvec_t *row);
+
+/** append several rows
+
+  \param s feature sink, created by ::new_aubio_feature_sink
+  \param rows one row per line, of length at least the number of columns,
+  as passed to ::aubio_batch_callback_t
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_feature_sink_do_multi (aubio_feature_sink_t *s,
+    const fmat_t *rows);
+
+/** write the file
+
+  \param s feature sink, created by ::new_aubio_feature_sink
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_feature_sink_close (aubio_feature_sink_t *s);
+
+/** delete feature file writer, closing it if needed
+
+  \param s feature sink, created by ::new_aubio_feature_sink
+
+*/
+void del_aubio_feature_sink (aubio_feature_sink_t *s);
+
+/** feature file reader */
+typedef struct _aubio_feature_source_t aubio_feature_source_t;
+
+/** open feature file
+
+  \param uri path of the file to read
+
+  \return newly created ::aubio_feature_source_t, or NULL if the file could
+  not be read
+
+*/
+aubio_feature_source_t *new_aubio_feature_source (const char_t *uri);
+
+/** get number of columns
+
+  \param s feature source, created by ::new_aubio_feature_source
+
+  \return number of values in each row
+
+*/
+uint_t aubio_feature_source_get_n_columns (const aubio_feature_source_t *s);
+
+/** get number of rows
+
+  \param s feature source, created by ::new_aubio_feature_source
+
+  \return number of rows in the file
+
+*/
+uint_t aubio_feature_source_get_n_rows (const aubio_feature_source_t *s);
+
+/** get samplerate of the analysis
+
+  \param s feature source, created by ::new_aubio_feature_source
+
+  \return samplerate stored in the header, 0 if unknown
+
+*/
+uint_t aubio_feature_source_get_samplerate (const aubio_feature_source_t *s);
+
+/** get hop size of the analysis
+
+  \param s feature source, created by ::new_aubio_feature_source
+
+  \return hop size stored in the header, 0 if unknown
+
+*/
+uint_t aubio_feature_source_get_hop_size (const aubio_feature_source_t *s);
+
+/** get name of a column
+
+  \param s feature source, created by ::new_aubio_feature_source
+  \param column index of the column
+
+  \return name of the column, or NULL if `column` is out of range
+
+*/
+const char_t *aubio_feature_source_get_name (const aubio_feature_source_t *s,
+    uint_t column);
+
+/** find a column by name
+
+  \param s feature source, created by ::new_aubio_feature_source
+  \param name name of the column
+
+  \return index of the first column called `name`, or -1 if none is
+
+*/
+sint_t aubio_feature_source_find (const aubio_feature_source_t *s,
+    const char_t *name);
+
+/** get values of a column
+
+  \param s feature source, created by ::new_aubio_feature_source
+  \param column index of the column
+
+  \return the values of the column, one per row, or NULL if `column` is out
+  of range. On little-endian platforms, they are read in place from the
+  mapped file. The array belongs to `s`.
+
+*/
+const float *aubio_feature_source_get_column (const aubio_feature_source_t *s,
+    uint_t column);
+
+/** read a row
+
+  \param s feature source, created by ::new_aubio_feature_source
+  \param row index of the row
+  \param out vector to store the values of the row in, of length at least
+  the number of columns
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_feature_source_do (const aubio_feature_source_t *s, uint_t row,
+    fvec_t *out);
+
+/** close feature file
+
+  \param s feature source, created by ::new_aubio_feature_source
+
+*/
+void del_aubio_feature_source (aubio_feature_source_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_FEATURES_H */
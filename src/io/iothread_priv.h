@@ -0,0 +1,110 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Thread, mutex and condition variable used by io/source_prefetch.c,
+   io/sink_async.c, io/source_capture.c, utils/batch.c, utils/rthost.c and
+   onset/onset_offline.c.
+
+   The macros operate on an object `s` with `mutex`, `cond` and `thread`
+   fields of the types below. The thread runs `AUBIO_IO_THREAD_FUNC(name)`,
+   which gets `s` as its `arg` argument, with the settings of its role, one
+   of the AUBIO_THREAD_ roles of utils/threads.h.
+*/
+
+#ifndef AUBIO_IOTHREAD_PRIV_H
+#define AUBIO_IOTHREAD_PRIV_H
+
+#include "utils/threads.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef HANDLE aubio_io_thread_t;
+typedef SRWLOCK aubio_io_mutex_t;
+typedef CONDITION_VARIABLE aubio_io_cond_t;
+#define AUBIO_IO_THREAD_FUNC(name) static DWORD WINAPI name (LPVOID arg)
+#define AUBIO_IO_THREAD_RETURN return 0
+#define AUBIO_IO_THREAD_INIT(s) do { InitializeSRWLock(&(s)->mutex); \
+  InitializeConditionVariable(&(s)->cond); } while (0)
+#define AUBIO_IO_THREAD_DESTROY(s)
+typedef LPTHREAD_START_ROUTINE aubio_io_thread_func_t;
+/* evaluates to 1 if the thread was started */
+#define AUBIO_IO_THREAD_START(s, func, role) \
+  (aubio_io_thread_create(&(s)->thread, role, func, s) == AUBIO_OK)
+#define AUBIO_IO_THREAD_JOIN(s) do { \
+  WaitForSingleObject((s)->thread, INFINITE); CloseHandle((s)->thread); \
+} while (0)
+#define AUBIO_IO_LOCK(s)   do { AUBIO_RT_CHECK("io mutex"); \
+  AcquireSRWLockExclusive(&(s)->mutex); } while (0)
+#define AUBIO_IO_UNLOCK(s) ReleaseSRWLockExclusive(&(s)->mutex)
+/* evaluates to 1 if the mutex was locked, without ever waiting for it */
+#define AUBIO_IO_TRYLOCK(s) (TryAcquireSRWLockExclusive(&(s)->mutex) != 0)
+#define AUBIO_IO_WAIT(s) \
+  SleepConditionVariableSRW(&(s)->cond, &(s)->mutex, INFINITE, 0)
+#define AUBIO_IO_WAKE(s)   WakeAllConditionVariable(&(s)->cond)
+#else
+#include <pthread.h>
+typedef pthread_t aubio_io_thread_t;
+typedef pthread_mutex_t aubio_io_mutex_t;
+typedef pthread_cond_t aubio_io_cond_t;
+#define AUBIO_IO_THREAD_FUNC(name) static void *name (void *arg)
+#define AUBIO_IO_THREAD_RETURN return NULL
+#define AUBIO_IO_THREAD_INIT(s) do { pthread_mutex_init(&(s)->mutex, NULL); \
+  pthread_cond_init(&(s)->cond, NULL); } while (0)
+#define AUBIO_IO_THREAD_DESTROY(s) do { pthread_mutex_destroy(&(s)->mutex); \
+  pthread_cond_destroy(&(s)->cond); } while (0)
+typedef void *(*aubio_io_thread_func_t)(void *);
+/* evaluates to 1 if the thread was started */
+#define AUBIO_IO_THREAD_START(s, func, role) \
+  (aubio_io_thread_create(&(s)->thread, role, func, s) == AUBIO_OK)
+#define AUBIO_IO_THREAD_JOIN(s) pthread_join((s)->thread, NULL)
+#define AUBIO_IO_LOCK(s)   do { AUBIO_RT_CHECK("io mutex"); \
+  pthread_mutex_lock(&(s)->mutex); } while (0)
+#define AUBIO_IO_UNLOCK(s) pthread_mutex_unlock(&(s)->mutex)
+/* evaluates to 1 if the mutex was locked, without ever waiting for it */
+#define AUBIO_IO_TRYLOCK(s) (pthread_mutex_trylock(&(s)->mutex) == 0)
+#define AUBIO_IO_WAIT(s)   pthread_cond_wait(&(s)->cond, &(s)->mutex)
+#define AUBIO_IO_WAKE(s)   pthread_cond_broadcast(&(s)->cond)
+#endif
+
+/* start func(arg) in a new thread, with the affinity and priority of role;
+   defined in utils/threads.c */
+uint_t aubio_io_thread_create (aubio_io_thread_t *thread, uint_t role,
+    aubio_io_thread_func_t func, void *arg);
+
+#if !defined(_WIN32) && defined(HAVE_UNISTD_H)
+#include <unistd.h>
+#endif
+
+/* number of processors available, used as the default number of threads */
+static inline uint_t aubio_io_get_processors (void)
+{
+#if defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return MAX(1, info.dwNumberOfProcessors);
+#elif defined(HAVE_UNISTD_H) && defined(_SC_NPROCESSORS_ONLN)
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (uint_t)n : 1;
+#else
+  return 1;
+#endif
+}
+
+#endif /* AUBIO_IOTHREAD_PRIV_H */
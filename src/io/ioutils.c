@@ -20,6 +20,9 @@
 
 #include "aubio_priv.h"
 #include "fmat.h"
+#include "io/ioutils_priv.h"
+
+#include <stdint.h>
 
 uint_t
 aubio_io_validate_samplerate(const char_t *kind, const char_t *path, uint_t samplerate)
@@ -157,3 +160,252 @@ aubio_sink_validate_input_channels(const char_t *kind, const char_t *path,
   }
   return channels;
 }
+
+uint_t
+aubio_io_format_size (aubio_io_format_t format)
+{
+  switch (format) {
+    case aubio_io_u8: return 1;
+    case aubio_io_s16: return 2;
+    case aubio_io_s24: return 3;
+    case aubio_io_s32: return 4;
+    case aubio_io_f32: return 4;
+    case aubio_io_f64: return 8;
+    case aubio_io_smpl: return sizeof(smpl_t);
+  }
+  return 0;
+}
+
+/* read one little-endian sample */
+
+static inline smpl_t aubio_io_read_u8 (const unsigned char *p)
+{
+  // FIXME why does 8 bit conversion maps [0;255] to [-128;127]
+  // instead of [0;127] to [0;127] and [128;255] to [-128;-1]
+  return (smpl_t)(((sint_t)p[0] - 128) * (1. / 128.));
+}
+
+static inline smpl_t aubio_io_read_s16 (const unsigned char *p)
+{
+  return (smpl_t)((int16_t)(uint16_t)(p[0] | p[1] << 8) * (1. / 32768.));
+}
+
+static inline smpl_t aubio_io_read_s24 (const unsigned char *p)
+{
+  return (smpl_t)(((int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16
+          | (uint32_t)p[2] << 24) >> 8) * (1. / 8388608.));
+}
+
+static inline smpl_t aubio_io_read_s32 (const unsigned char *p)
+{
+  return (smpl_t)((int32_t)((uint32_t)p[0] | (uint32_t)p[1] << 8
+        | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24) * (1. / 2147483648.));
+}
+
+static inline smpl_t aubio_io_read_f32 (const unsigned char *p)
+{
+  uint32_t u = (uint32_t)p[0] | (uint32_t)p[1] << 8
+    | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+  float f;
+  memcpy(&f, &u, sizeof(f));
+  return (smpl_t)f;
+}
+
+static inline smpl_t aubio_io_read_f64 (const unsigned char *p)
+{
+  uint64_t u = 0;
+  uint_t b;
+  double d;
+  for (b = 0; b < 8; b++) {
+    u |= (uint64_t)p[b] << (b * 8);
+  }
+  memcpy(&d, &u, sizeof(d));
+  return (smpl_t)d;
+}
+
+/* write one little-endian sample */
+
+static inline sint_t aubio_io_quantize (smpl_t v, lsmp_t scale)
+{
+  lsmp_t x = v * scale;
+  if (x > scale - 1.) x = scale - 1.;
+  else if (x < -scale) x = -scale;
+  return (sint_t)x;
+}
+
+static inline void aubio_io_write_u8 (unsigned char *p, smpl_t v)
+{
+  p[0] = (unsigned char)(aubio_io_quantize(v, 128.) + 128);
+}
+
+static inline void aubio_io_write_s16 (unsigned char *p, smpl_t v)
+{
+  uint32_t u = (uint32_t)aubio_io_quantize(v, 32768.);
+  p[0] = u; p[1] = u >> 8;
+}
+
+static inline void aubio_io_write_s24 (unsigned char *p, smpl_t v)
+{
+  uint32_t u = (uint32_t)aubio_io_quantize(v, 8388608.);
+  p[0] = u; p[1] = u >> 8; p[2] = u >> 16;
+}
+
+static inline void aubio_io_write_s32 (unsigned char *p, smpl_t v)
+{
+  uint32_t u = (uint32_t)aubio_io_quantize(v, 2147483648.);
+  p[0] = u; p[1] = u >> 8; p[2] = u >> 16; p[3] = u >> 24;
+}
+
+static inline void aubio_io_write_f32 (unsigned char *p, smpl_t v)
+{
+  float f = (float)v;
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  p[0] = u; p[1] = u >> 8; p[2] = u >> 16; p[3] = u >> 24;
+}
+
+static inline void aubio_io_write_f64 (unsigned char *p, smpl_t v)
+{
+  double d = (double)v;
+  uint64_t u;
+  uint_t b;
+  memcpy(&u, &d, sizeof(u));
+  for (b = 0; b < 8; b++) {
+    p[b] = (unsigned char)(u >> (b * 8));
+  }
+}
+
+/* loops over the frames of one channel; mono and stereo buffers get their
+   own copy with a constant stride, which compilers can vectorize */
+#define AUBIO_IO_FRAMES(size, stride, body) \
+  if ((stride) == size) { \
+    for (j = 0; j < length; j++) { body(p + j * size, j); } \
+  } else if ((stride) == 2 * size) { \
+    for (j = 0; j < length; j++) { body(p + j * 2 * size, j); } \
+  } else { \
+    for (j = 0; j < length; j++) { body(p + j * (stride), j); } \
+  }
+
+#define AUBIO_IO_FORMATS(macro) \
+  switch (format) { \
+    case aubio_io_u8: macro(u8, 1); break; \
+    case aubio_io_s16: macro(s16, 2); break; \
+    case aubio_io_s24: macro(s24, 3); break; \
+    case aubio_io_s32: macro(s32, 4); break; \
+    case aubio_io_f32: macro(f32, 4); break; \
+    case aubio_io_f64: macro(f64, 8); break; \
+    case aubio_io_smpl: break; \
+  }
+
+void
+aubio_io_deinterleave (aubio_io_format_t format, const void *in,
+    uint_t in_channels, fmat_t *out, uint_t offset, uint_t length)
+{
+  uint_t c, j, channels = MIN(in_channels, out->height);
+  if (format == aubio_io_smpl) {
+    const smpl_t *samples = (const smpl_t *)in;
+    for (c = 0; c < channels; c++) {
+      smpl_t *o = out->data[c] + offset;
+      for (j = 0; j < length; j++) {
+        o[j] = samples[j * in_channels + c];
+      }
+    }
+    return;
+  }
+#define AUBIO_IO_DEINTERLEAVE(name, size) \
+  for (c = 0; c < channels; c++) { \
+    const unsigned char *p = (const unsigned char *)in + c * size; \
+    smpl_t *o = out->data[c] + offset; \
+    AUBIO_IO_FRAMES(size, in_channels * size, AUBIO_IO_ASSIGN_##name) \
+  }
+#define AUBIO_IO_ASSIGN_u8(q, j) o[j] = aubio_io_read_u8(q)
+#define AUBIO_IO_ASSIGN_s16(q, j) o[j] = aubio_io_read_s16(q)
+#define AUBIO_IO_ASSIGN_s24(q, j) o[j] = aubio_io_read_s24(q)
+#define AUBIO_IO_ASSIGN_s32(q, j) o[j] = aubio_io_read_s32(q)
+#define AUBIO_IO_ASSIGN_f32(q, j) o[j] = aubio_io_read_f32(q)
+#define AUBIO_IO_ASSIGN_f64(q, j) o[j] = aubio_io_read_f64(q)
+  AUBIO_IO_FORMATS(AUBIO_IO_DEINTERLEAVE)
+}
+
+void
+aubio_io_downmix (aubio_io_format_t format, const void *in,
+    uint_t in_channels, smpl_t *out, uint_t length)
+{
+  uint_t c, j;
+  if (format == aubio_io_smpl) {
+    const smpl_t *samples = (const smpl_t *)in;
+    for (j = 0; j < length; j++) {
+      out[j] = samples[j * in_channels];
+    }
+    for (c = 1; c < in_channels; c++) {
+      for (j = 0; j < length; j++) {
+        out[j] += samples[j * in_channels + c];
+      }
+    }
+  } else {
+    /* first channel assigned, the others added */
+#define AUBIO_IO_DOWNMIX(name, size) \
+    for (c = 0; c < in_channels; c++) { \
+      const unsigned char *p = (const unsigned char *)in + c * size; \
+      smpl_t *o = out; \
+      if (c == 0) { \
+        AUBIO_IO_FRAMES(size, in_channels * size, AUBIO_IO_ASSIGN_##name) \
+      } else { \
+        AUBIO_IO_FRAMES(size, in_channels * size, AUBIO_IO_ADD_##name) \
+      } \
+    }
+#define AUBIO_IO_ADD_u8(q, j) o[j] += aubio_io_read_u8(q)
+#define AUBIO_IO_ADD_s16(q, j) o[j] += aubio_io_read_s16(q)
+#define AUBIO_IO_ADD_s24(q, j) o[j] += aubio_io_read_s24(q)
+#define AUBIO_IO_ADD_s32(q, j) o[j] += aubio_io_read_s32(q)
+#define AUBIO_IO_ADD_f32(q, j) o[j] += aubio_io_read_f32(q)
+#define AUBIO_IO_ADD_f64(q, j) o[j] += aubio_io_read_f64(q)
+    AUBIO_IO_FORMATS(AUBIO_IO_DOWNMIX)
+  }
+  if (in_channels > 1) {
+    for (j = 0; j < length; j++) {
+      out[j] /= (smpl_t)in_channels;
+    }
+  }
+}
+
+void
+aubio_io_interleave (aubio_io_format_t format, const fmat_t *in,
+    void *out, uint_t out_channels, uint_t length)
+{
+  uint_t c, j;
+  for (c = 0; c < out_channels; c++) {
+    const smpl_t *row = NULL;
+    if (in->height == 1) row = in->data[0];
+    else if (c < in->height) row = in->data[c];
+    if (format == aubio_io_smpl) {
+      smpl_t *samples = (smpl_t *)out;
+      for (j = 0; j < length; j++) {
+        samples[j * out_channels + c] = row ? row[j] : 0.;
+      }
+      continue;
+    }
+#define AUBIO_IO_INTERLEAVE(name, size) \
+    { \
+      unsigned char *p = (unsigned char *)out + c * size; \
+      if (row) { \
+        AUBIO_IO_FRAMES(size, out_channels * size, AUBIO_IO_WRITE_##name) \
+      } else { \
+        AUBIO_IO_FRAMES(size, out_channels * size, AUBIO_IO_ZERO_##name) \
+      } \
+    }
+#define AUBIO_IO_WRITE_u8(q, j) aubio_io_write_u8(q, row[j])
+#define AUBIO_IO_WRITE_s16(q, j) aubio_io_write_s16(q, row[j])
+#define AUBIO_IO_WRITE_s24(q, j) aubio_io_write_s24(q, row[j])
+#define AUBIO_IO_WRITE_s32(q, j) aubio_io_write_s32(q, row[j])
+#define AUBIO_IO_WRITE_f32(q, j) aubio_io_write_f32(q, row[j])
+#define AUBIO_IO_WRITE_f64(q, j) aubio_io_write_f64(q, row[j])
+#define AUBIO_IO_ZERO_u8(q, j) aubio_io_write_u8(q, 0.)
+#define AUBIO_IO_ZERO_s16(q, j) aubio_io_write_s16(q, 0.)
+#define AUBIO_IO_ZERO_s24(q, j) aubio_io_write_s24(q, 0.)
+#define AUBIO_IO_ZERO_s32(q, j) aubio_io_write_s32(q, 0.)
+#define AUBIO_IO_ZERO_f32(q, j) aubio_io_write_f32(q, 0.)
+#define AUBIO_IO_ZERO_f64(q, j) aubio_io_write_f64(q, 0.)
+    AUBIO_IO_FORMATS(AUBIO_IO_INTERLEAVE)
+  }
+}
@@ -0,0 +1,87 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Sample conversion routines shared by sources and sinks.
+
+   Interleaved buffers hold either little-endian integer or float samples, as
+   stored in wav files, or native smpl_t samples, as exchanged with libsndfile
+   and libavcodec. Each routine converts and (de)interleaves in a single pass,
+   with one loop per format that compilers can vectorize.
+*/
+
+#ifndef AUBIO_IOUTILS_PRIV_H
+#define AUBIO_IOUTILS_PRIV_H
+
+/** formats of the samples in an interleaved buffer */
+typedef enum {
+  aubio_io_u8,      /**< unsigned 8-bit integer */
+  aubio_io_s16,     /**< signed 16-bit little-endian integer */
+  aubio_io_s24,     /**< signed 24-bit little-endian integer */
+  aubio_io_s32,     /**< signed 32-bit little-endian integer */
+  aubio_io_f32,     /**< 32-bit little-endian IEEE float */
+  aubio_io_f64,     /**< 64-bit little-endian IEEE float */
+  aubio_io_smpl,    /**< native smpl_t */
+} aubio_io_format_t;
+
+/** size of one sample of format, in bytes */
+uint_t aubio_io_format_size (aubio_io_format_t format);
+
+/** convert interleaved frames to one row per channel
+
+  \param format format of the samples in `in`
+  \param in interleaved frames
+  \param in_channels number of channels in each frame of `in`
+  \param out output matrix, only its first `in_channels` rows are written
+  \param offset index of the first column of `out` to write to
+  \param length number of frames to convert
+
+*/
+void aubio_io_deinterleave (aubio_io_format_t format, const void *in,
+    uint_t in_channels, fmat_t *out, uint_t offset, uint_t length);
+
+/** convert interleaved frames to their average over all channels
+
+  \param format format of the samples in `in`
+  \param in interleaved frames
+  \param in_channels number of channels in each frame of `in`
+  \param out output samples, `length` long
+  \param length number of frames to convert
+
+*/
+void aubio_io_downmix (aubio_io_format_t format, const void *in,
+    uint_t in_channels, smpl_t *out, uint_t length);
+
+/** convert rows of samples to interleaved frames
+
+  \param format format of the samples to write to `out`
+  \param in input matrix, one row per channel, at least `length` long
+  \param out interleaved frames
+  \param out_channels number of channels in each frame of `out`
+  \param length number of frames to convert
+
+  A single row is copied to all the channels. Otherwise, channels without a
+  matching row in `in` are set to zero. Samples written to integer formats
+  are clipped to [-1, 1].
+
+*/
+void aubio_io_interleave (aubio_io_format_t format, const fmat_t *in,
+    void *out, uint_t out_channels, uint_t length);
+
+#endif /* AUBIO_IOUTILS_PRIV_H */
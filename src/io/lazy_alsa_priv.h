@@ -0,0 +1,79 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of libasound used by io/source_capture.c, loaded on first use
+   with -Dlazy_backends=true, see utils/lazyload_priv.h.
+
+   To be included after <alsa/asoundlib.h>. */
+
+#ifndef AUBIO_LAZY_ALSA_PRIV_H
+#define AUBIO_LAZY_ALSA_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#define AUBIO_ALSA_SYMBOLS(X) \
+  X(snd_pcm_open) X(snd_pcm_close) X(snd_pcm_start) X(snd_pcm_wait) \
+  X(snd_pcm_readi) X(snd_pcm_recover) X(snd_strerror) \
+  X(snd_pcm_hw_params_malloc) X(snd_pcm_hw_params_free) \
+  X(snd_pcm_hw_params_any) X(snd_pcm_hw_params_set_access) \
+  X(snd_pcm_hw_params_set_format) X(snd_pcm_hw_params_set_channels_near) \
+  X(snd_pcm_hw_params_set_rate_near) \
+  X(snd_pcm_hw_params_set_period_size_near) \
+  X(snd_pcm_hw_params_set_buffer_size_near) X(snd_pcm_hw_params)
+
+static const char_t *aubio_alsa_files[] = {
+  AUBIO_LAZY_LIB("asound", "2"),
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_alsa, AUBIO_ALSA_SYMBOLS, "libasound",
+    aubio_alsa_files)
+
+#define snd_pcm_open aubio_alsa.snd_pcm_open
+#define snd_pcm_close aubio_alsa.snd_pcm_close
+#define snd_pcm_start aubio_alsa.snd_pcm_start
+#define snd_pcm_wait aubio_alsa.snd_pcm_wait
+#define snd_pcm_readi aubio_alsa.snd_pcm_readi
+#define snd_pcm_recover aubio_alsa.snd_pcm_recover
+#define snd_strerror aubio_alsa.snd_strerror
+#define snd_pcm_hw_params_malloc aubio_alsa.snd_pcm_hw_params_malloc
+#define snd_pcm_hw_params_free aubio_alsa.snd_pcm_hw_params_free
+#define snd_pcm_hw_params_any aubio_alsa.snd_pcm_hw_params_any
+#define snd_pcm_hw_params_set_access aubio_alsa.snd_pcm_hw_params_set_access
+#define snd_pcm_hw_params_set_format aubio_alsa.snd_pcm_hw_params_set_format
+#define snd_pcm_hw_params_set_channels_near \
+  aubio_alsa.snd_pcm_hw_params_set_channels_near
+#define snd_pcm_hw_params_set_rate_near \
+  aubio_alsa.snd_pcm_hw_params_set_rate_near
+#define snd_pcm_hw_params_set_period_size_near \
+  aubio_alsa.snd_pcm_hw_params_set_period_size_near
+#define snd_pcm_hw_params_set_buffer_size_near \
+  aubio_alsa.snd_pcm_hw_params_set_buffer_size_near
+#define snd_pcm_hw_params aubio_alsa.snd_pcm_hw_params
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_alsa_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_ALSA_PRIV_H */
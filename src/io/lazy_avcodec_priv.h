@@ -0,0 +1,140 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of libavformat, libavcodec, libavutil and libswresample used by
+   io/source_avcodec.c, loaded on first use with -Dlazy_backends=true, see
+   utils/lazyload_priv.h.
+
+   To be included after the headers of the libraries, and after the version
+   macros of io/source_avcodec.c, which select the functions it calls. */
+
+#ifndef AUBIO_LAZY_AVCODEC_PRIV_H
+#define AUBIO_LAZY_AVCODEC_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#if LIBAVCODEC_VERSION_MAJOR < 58 || LIBAVFORMAT_VERSION_MAJOR < 58
+#error "lazy_backends requires libavcodec 58 and libavformat 58 or later"
+#endif
+
+#if HAVE_AUBIO_LIBAVCODEC_TIMEBASE_FIX
+#define AUBIO_AVCODEC_TIMEBASE_SYMBOLS(X) X(av_codec_set_pkt_timebase)
+#else
+#define AUBIO_AVCODEC_TIMEBASE_SYMBOLS(X)
+#endif
+
+#if FF_API_INIT_PACKET
+#define AUBIO_AVCODEC_PACKET_SYMBOLS(X) X(av_packet_alloc) X(av_packet_free)
+#elif !defined(FF_API_INIT_PACKET)
+#define AUBIO_AVCODEC_PACKET_SYMBOLS(X) X(av_init_packet)
+#else
+#define AUBIO_AVCODEC_PACKET_SYMBOLS(X)
+#endif
+
+#ifdef LIBAVUTIL_HAS_CH_LAYOUT
+#define AUBIO_AVCODEC_LAYOUT_SYMBOLS(X) \
+  X(av_channel_layout_default) X(av_opt_set_chlayout)
+#else
+#define AUBIO_AVCODEC_LAYOUT_SYMBOLS(X) X(av_get_default_channel_layout)
+#endif
+
+#define AUBIO_AVCODEC_SYMBOLS(X) \
+  X(av_frame_alloc) X(av_frame_free) X(av_free) X(av_freep) \
+  X(av_get_media_type_string) X(av_gettime_relative) X(av_malloc) \
+  X(av_opt_set_int) X(av_packet_unref) X(av_read_frame) X(av_rescale_q) \
+  X(av_seek_frame) X(av_strerror) X(av_url_split) X(avcodec_alloc_context3) \
+  X(avcodec_find_decoder) X(avcodec_flush_buffers) X(avcodec_free_context) \
+  X(avcodec_open2) X(avcodec_parameters_to_context) \
+  X(avcodec_receive_frame) X(avcodec_send_packet) X(avformat_alloc_context) \
+  X(avformat_close_input) X(avformat_find_stream_info) \
+  X(avformat_network_init) X(avformat_open_input) X(avformat_seek_file) \
+  X(avio_alloc_context) X(avio_context_free) X(avio_size) X(swr_alloc) \
+  X(swr_close) X(swr_convert) X(swr_drop_output) X(swr_free) X(swr_init) \
+  AUBIO_AVCODEC_TIMEBASE_SYMBOLS(X) AUBIO_AVCODEC_PACKET_SYMBOLS(X) \
+  AUBIO_AVCODEC_LAYOUT_SYMBOLS(X)
+
+// the major versions of the libraries found at build time
+static const char_t *aubio_avcodec_files[] = {
+  AUBIO_LAZY_LIB("avutil", AV_STRINGIFY(LIBAVUTIL_VERSION_MAJOR)),
+  AUBIO_LAZY_LIB("avcodec", AV_STRINGIFY(LIBAVCODEC_VERSION_MAJOR)),
+  AUBIO_LAZY_LIB("avformat", AV_STRINGIFY(LIBAVFORMAT_VERSION_MAJOR)),
+  AUBIO_LAZY_LIB("swresample", AV_STRINGIFY(LIBSWRESAMPLE_VERSION_MAJOR)),
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_avcodec, AUBIO_AVCODEC_SYMBOLS, "libavcodec",
+    aubio_avcodec_files)
+
+#define av_frame_alloc aubio_avcodec.av_frame_alloc
+#define av_frame_free aubio_avcodec.av_frame_free
+#define av_free aubio_avcodec.av_free
+#define av_freep aubio_avcodec.av_freep
+#define av_get_media_type_string aubio_avcodec.av_get_media_type_string
+#define av_gettime_relative aubio_avcodec.av_gettime_relative
+#define av_malloc aubio_avcodec.av_malloc
+#define av_opt_set_int aubio_avcodec.av_opt_set_int
+#define av_packet_unref aubio_avcodec.av_packet_unref
+#define av_read_frame aubio_avcodec.av_read_frame
+#define av_rescale_q aubio_avcodec.av_rescale_q
+#define av_seek_frame aubio_avcodec.av_seek_frame
+#define av_strerror aubio_avcodec.av_strerror
+#define av_url_split aubio_avcodec.av_url_split
+#define avcodec_alloc_context3 aubio_avcodec.avcodec_alloc_context3
+#define avcodec_find_decoder aubio_avcodec.avcodec_find_decoder
+#define avcodec_flush_buffers aubio_avcodec.avcodec_flush_buffers
+#define avcodec_free_context aubio_avcodec.avcodec_free_context
+#define avcodec_open2 aubio_avcodec.avcodec_open2
+#define avcodec_parameters_to_context \
+  aubio_avcodec.avcodec_parameters_to_context
+#define avcodec_receive_frame aubio_avcodec.avcodec_receive_frame
+#define avcodec_send_packet aubio_avcodec.avcodec_send_packet
+#define avformat_alloc_context aubio_avcodec.avformat_alloc_context
+#define avformat_close_input aubio_avcodec.avformat_close_input
+#define avformat_find_stream_info aubio_avcodec.avformat_find_stream_info
+#define avformat_network_init aubio_avcodec.avformat_network_init
+#define avformat_open_input aubio_avcodec.avformat_open_input
+#define avformat_seek_file aubio_avcodec.avformat_seek_file
+#define avio_alloc_context aubio_avcodec.avio_alloc_context
+#define avio_context_free aubio_avcodec.avio_context_free
+#define avio_size aubio_avcodec.avio_size
+#define swr_alloc aubio_avcodec.swr_alloc
+#define swr_close aubio_avcodec.swr_close
+#define swr_convert aubio_avcodec.swr_convert
+#define swr_drop_output aubio_avcodec.swr_drop_output
+#define swr_free aubio_avcodec.swr_free
+#define swr_init aubio_avcodec.swr_init
+#define av_codec_set_pkt_timebase aubio_avcodec.av_codec_set_pkt_timebase
+#define av_packet_alloc aubio_avcodec.av_packet_alloc
+#define av_packet_free aubio_avcodec.av_packet_free
+#define av_init_packet aubio_avcodec.av_init_packet
+#define av_channel_layout_default aubio_avcodec.av_channel_layout_default
+#define av_opt_set_chlayout aubio_avcodec.av_opt_set_chlayout
+#define av_get_default_channel_layout \
+  aubio_avcodec.av_get_default_channel_layout
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_avcodec_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_AVCODEC_PRIV_H */
@@ -0,0 +1,101 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of libFLAC used by io/sink_flac.c, loaded on first use with
+   -Dlazy_backends=true, see utils/lazyload_priv.h.
+
+   To be included after <FLAC/stream_encoder.h> and <FLAC/metadata.h>. */
+
+#ifndef AUBIO_LAZY_FLAC_PRIV_H
+#define AUBIO_LAZY_FLAC_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#ifdef HAVE_FLAC_THREADS
+#define AUBIO_FLAC_THREADS_SYMBOLS(X) X(FLAC__stream_encoder_set_num_threads)
+#else
+#define AUBIO_FLAC_THREADS_SYMBOLS(X)
+#endif
+
+#define AUBIO_FLAC_SYMBOLS(X) \
+  X(FLAC__metadata_object_delete) X(FLAC__metadata_object_new) \
+  X(FLAC__metadata_object_vorbiscomment_append_comment) \
+  X(FLAC__metadata_object_vorbiscomment_entry_from_name_value_pair) \
+  X(FLAC__stream_encoder_delete) X(FLAC__stream_encoder_finish) \
+  X(FLAC__stream_encoder_get_state) X(FLAC__stream_encoder_init_file) \
+  X(FLAC__stream_encoder_new) X(FLAC__stream_encoder_process_interleaved) \
+  X(FLAC__stream_encoder_set_bits_per_sample) \
+  X(FLAC__stream_encoder_set_channels) \
+  X(FLAC__stream_encoder_set_compression_level) \
+  X(FLAC__stream_encoder_set_metadata) \
+  X(FLAC__stream_encoder_set_sample_rate) X(FLAC__stream_encoder_set_verify) \
+  X(FLAC__StreamEncoderStateString) AUBIO_FLAC_THREADS_SYMBOLS(X)
+
+// the ABI of these functions did not change since libFLAC 1.3
+static const char_t *aubio_flac_files[] = {
+  AUBIO_LAZY_LIB("FLAC", "14"),
+  AUBIO_LAZY_LIB("FLAC", "12"),
+  AUBIO_LAZY_LIB("FLAC", "8"),
+#ifdef _WIN32
+  "FLAC.dll", "libFLAC.dll",
+#endif
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_flac, AUBIO_FLAC_SYMBOLS, "libFLAC", aubio_flac_files)
+
+#define FLAC__metadata_object_delete aubio_flac.FLAC__metadata_object_delete
+#define FLAC__metadata_object_new aubio_flac.FLAC__metadata_object_new
+#define FLAC__metadata_object_vorbiscomment_append_comment \
+  aubio_flac.FLAC__metadata_object_vorbiscomment_append_comment
+#define FLAC__metadata_object_vorbiscomment_entry_from_name_value_pair \
+  aubio_flac.FLAC__metadata_object_vorbiscomment_entry_from_name_value_pair
+#define FLAC__stream_encoder_delete aubio_flac.FLAC__stream_encoder_delete
+#define FLAC__stream_encoder_finish aubio_flac.FLAC__stream_encoder_finish
+#define FLAC__stream_encoder_get_state aubio_flac.FLAC__stream_encoder_get_state
+#define FLAC__stream_encoder_init_file aubio_flac.FLAC__stream_encoder_init_file
+#define FLAC__stream_encoder_new aubio_flac.FLAC__stream_encoder_new
+#define FLAC__stream_encoder_process_interleaved \
+  aubio_flac.FLAC__stream_encoder_process_interleaved
+#define FLAC__stream_encoder_set_bits_per_sample \
+  aubio_flac.FLAC__stream_encoder_set_bits_per_sample
+#define FLAC__stream_encoder_set_channels \
+  aubio_flac.FLAC__stream_encoder_set_channels
+#define FLAC__stream_encoder_set_compression_level \
+  aubio_flac.FLAC__stream_encoder_set_compression_level
+#define FLAC__stream_encoder_set_metadata \
+  aubio_flac.FLAC__stream_encoder_set_metadata
+#define FLAC__stream_encoder_set_num_threads \
+  aubio_flac.FLAC__stream_encoder_set_num_threads
+#define FLAC__stream_encoder_set_sample_rate \
+  aubio_flac.FLAC__stream_encoder_set_sample_rate
+#define FLAC__stream_encoder_set_verify aubio_flac.FLAC__stream_encoder_set_verify
+// an array, the table holds its address
+#define FLAC__StreamEncoderStateString (*aubio_flac.FLAC__StreamEncoderStateString)
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_flac_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_FLAC_PRIV_H */
@@ -0,0 +1,64 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of libsndfile used by io/source_sndfile.c and io/sink_sndfile.c,
+   loaded on first use with -Dlazy_backends=true, see utils/lazyload_priv.h.
+
+   To be included after <sndfile.h>. */
+
+#ifndef AUBIO_LAZY_SNDFILE_PRIV_H
+#define AUBIO_LAZY_SNDFILE_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#define AUBIO_SNDFILE_SYMBOLS(X) \
+  X(sf_open) X(sf_open_virtual) X(sf_close) X(sf_seek) X(sf_strerror) \
+  X(sf_read_float) X(sf_read_double) X(sf_write_float) X(sf_write_double)
+
+static const char_t *aubio_sndfile_files[] = {
+  AUBIO_LAZY_LIB("sndfile", "1"),
+#ifdef _WIN32
+  "sndfile.dll",
+#endif
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_sndfile, AUBIO_SNDFILE_SYMBOLS, "libsndfile",
+    aubio_sndfile_files)
+
+#define sf_open aubio_sndfile.sf_open
+#define sf_open_virtual aubio_sndfile.sf_open_virtual
+#define sf_close aubio_sndfile.sf_close
+#define sf_seek aubio_sndfile.sf_seek
+#define sf_strerror aubio_sndfile.sf_strerror
+#define sf_read_float aubio_sndfile.sf_read_float
+#define sf_read_double aubio_sndfile.sf_read_double
+#define sf_write_float aubio_sndfile.sf_write_float
+#define sf_write_double aubio_sndfile.sf_write_double
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_sndfile_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_SNDFILE_PRIV_H */
@@ -0,0 +1,87 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of libvorbisenc, libvorbis and libogg used by io/sink_vorbis.c,
+   loaded on first use with -Dlazy_backends=true, see utils/lazyload_priv.h.
+
+   To be included after <vorbis/vorbisenc.h>. */
+
+#ifndef AUBIO_LAZY_VORBIS_PRIV_H
+#define AUBIO_LAZY_VORBIS_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#define AUBIO_VORBIS_SYMBOLS(X) \
+  X(ogg_page_eos) X(ogg_stream_clear) X(ogg_stream_flush) \
+  X(ogg_stream_init) X(ogg_stream_packetin) X(ogg_stream_pageout) \
+  X(vorbis_analysis) X(vorbis_analysis_blockout) X(vorbis_analysis_buffer) \
+  X(vorbis_analysis_headerout) X(vorbis_analysis_init) \
+  X(vorbis_analysis_wrote) X(vorbis_bitrate_addblock) \
+  X(vorbis_bitrate_flushpacket) X(vorbis_block_clear) X(vorbis_block_init) \
+  X(vorbis_comment_add_tag) X(vorbis_comment_clear) X(vorbis_comment_init) \
+  X(vorbis_dsp_clear) X(vorbis_encode_init_vbr) X(vorbis_info_clear) \
+  X(vorbis_info_init)
+
+static const char_t *aubio_vorbis_files[] = {
+  AUBIO_LAZY_LIB("vorbisenc", "2"),
+  AUBIO_LAZY_LIB("vorbis", "0"),
+  AUBIO_LAZY_LIB("ogg", "0"),
+#ifdef _WIN32
+  "vorbisenc.dll", "vorbis.dll", "ogg.dll",
+#endif
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_vorbis, AUBIO_VORBIS_SYMBOLS, "libvorbisenc",
+    aubio_vorbis_files)
+
+#define ogg_page_eos aubio_vorbis.ogg_page_eos
+#define ogg_stream_clear aubio_vorbis.ogg_stream_clear
+#define ogg_stream_flush aubio_vorbis.ogg_stream_flush
+#define ogg_stream_init aubio_vorbis.ogg_stream_init
+#define ogg_stream_packetin aubio_vorbis.ogg_stream_packetin
+#define ogg_stream_pageout aubio_vorbis.ogg_stream_pageout
+#define vorbis_analysis aubio_vorbis.vorbis_analysis
+#define vorbis_analysis_blockout aubio_vorbis.vorbis_analysis_blockout
+#define vorbis_analysis_buffer aubio_vorbis.vorbis_analysis_buffer
+#define vorbis_analysis_headerout aubio_vorbis.vorbis_analysis_headerout
+#define vorbis_analysis_init aubio_vorbis.vorbis_analysis_init
+#define vorbis_analysis_wrote aubio_vorbis.vorbis_analysis_wrote
+#define vorbis_bitrate_addblock aubio_vorbis.vorbis_bitrate_addblock
+#define vorbis_bitrate_flushpacket aubio_vorbis.vorbis_bitrate_flushpacket
+#define vorbis_block_clear aubio_vorbis.vorbis_block_clear
+#define vorbis_block_init aubio_vorbis.vorbis_block_init
+#define vorbis_comment_add_tag aubio_vorbis.vorbis_comment_add_tag
+#define vorbis_comment_clear aubio_vorbis.vorbis_comment_clear
+#define vorbis_comment_init aubio_vorbis.vorbis_comment_init
+#define vorbis_dsp_clear aubio_vorbis.vorbis_dsp_clear
+#define vorbis_encode_init_vbr aubio_vorbis.vorbis_encode_init_vbr
+#define vorbis_info_clear aubio_vorbis.vorbis_info_clear
+#define vorbis_info_init aubio_vorbis.vorbis_info_init
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_vorbis_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_VORBIS_PRIV_H */
@@ -22,6 +22,8 @@
 #include "fvec.h"
 #include "fmat.h"
 #include "io/sink.h"
+#include "io/sink_async_priv.h"
+#include "io/sink_io_priv.h"
 #ifdef HAVE_SINK_APPLE_AUDIO
 #include "io/sink_apple_audio.h"
 #endif /* HAVE_SINK_APPLE_AUDIO */
@@ -36,6 +38,8 @@ typedef void (*aubio_sink_do_t)(aubio_sink_t * s, fvec_t * data, uint_t write);
 typedef void (*aubio_sink_do_multi_t)(aubio_sink_t * s, fmat_t * data, uint_t write);
 typedef uint_t (*aubio_sink_preset_samplerate_t)(aubio_sink_t * s, uint_t samplerate);
 typedef uint_t (*aubio_sink_preset_channels_t)(aubio_sink_t * s, uint_t channels);
+typedef uint_t (*aubio_sink_preset_compression_t)(aubio_sink_t * s, uint_t level);
+typedef uint_t (*aubio_sink_preset_threads_t)(aubio_sink_t * s, uint_t threads);
 typedef uint_t (*aubio_sink_get_samplerate_t)(aubio_sink_t * s);
 typedef uint_t (*aubio_sink_get_channels_t)(aubio_sink_t * s);
 typedef uint_t (*aubio_sink_close_t)(aubio_sink_t * s);
@@ -47,10 +51,13 @@ struct _aubio_sink_t {
   aubio_sink_do_multi_t s_do_multi;
   aubio_sink_preset_samplerate_t s_preset_samplerate;
   aubio_sink_preset_channels_t s_preset_channels;
+  aubio_sink_preset_compression_t s_preset_compression; // NULL if unsupported
+  aubio_sink_preset_threads_t s_preset_threads;         // NULL if unsupported
   aubio_sink_get_samplerate_t s_get_samplerate;
   aubio_sink_get_channels_t s_get_channels;
   aubio_sink_close_t s_close;
   del_aubio_sink_t s_del;
+  aubio_sink_io_t *io;          // stream written to, or NULL
 };
 
 extern uint_t aubio_str_path_has_extension(const char_t *filename,
@@ -86,6 +93,10 @@ extern uint_t aubio_sink_flac_preset_channels(aubio_sink_flac_t *s,
     uint_t channels);
 extern uint_t aubio_sink_flac_preset_samplerate(aubio_sink_flac_t *s,
     uint_t samplerate);
+extern uint_t aubio_sink_flac_preset_compression(aubio_sink_flac_t *s,
+    uint_t level);
+extern uint_t aubio_sink_flac_preset_threads(aubio_sink_flac_t *s,
+    uint_t threads);
 extern uint_t aubio_sink_flac_get_channels(aubio_sink_flac_t *s);
 extern uint_t aubio_sink_flac_get_samplerate(aubio_sink_flac_t *s);
 extern void aubio_sink_flac_do(aubio_sink_flac_t *s, fvec_t*
@@ -128,6 +139,8 @@ aubio_sink_t * new_aubio_sink(const char_t * uri, uint_t samplerate) {
       s->s_do_multi = (aubio_sink_do_multi_t)(aubio_sink_flac_do_multi);
       s->s_preset_samplerate = (aubio_sink_preset_samplerate_t)(aubio_sink_flac_preset_samplerate);
       s->s_preset_channels = (aubio_sink_preset_channels_t)(aubio_sink_flac_preset_channels);
+      s->s_preset_compression = (aubio_sink_preset_compression_t)(aubio_sink_flac_preset_compression);
+      s->s_preset_threads = (aubio_sink_preset_threads_t)(aubio_sink_flac_preset_threads);
       s->s_get_samplerate = (aubio_sink_get_samplerate_t)(aubio_sink_flac_get_samplerate);
       s->s_get_channels = (aubio_sink_get_channels_t)(aubio_sink_flac_get_channels);
       s->s_close = (aubio_sink_close_t)(aubio_sink_flac_close);
@@ -190,8 +203,88 @@ aubio_sink_t * new_aubio_sink(const char_t * uri, uint_t samplerate) {
   return NULL;
 }
 
+aubio_sink_t * new_aubio_sink_async(const char_t * uri, uint_t samplerate,
+    uint_t queue_frames) {
+  aubio_sink_t * s;
+  aubio_sink_t * sink = new_aubio_sink(uri, samplerate);
+  if (!sink) {
+    return NULL;
+  }
+  s = AUBIO_NEW(aubio_sink_t);
+  s->sink = (void *)new_aubio_sink_async_from(sink, uri, queue_frames);
+  if (!s->sink) {
+    del_aubio_sink(sink);
+    AUBIO_FREE(s);
+    return NULL;
+  }
+  s->s_do = (aubio_sink_do_t)(aubio_sink_async_do);
+  s->s_do_multi = (aubio_sink_do_multi_t)(aubio_sink_async_do_multi);
+  s->s_preset_samplerate = (aubio_sink_preset_samplerate_t)(aubio_sink_async_preset_samplerate);
+  s->s_preset_channels = (aubio_sink_preset_channels_t)(aubio_sink_async_preset_channels);
+  s->s_preset_compression = (aubio_sink_preset_compression_t)(aubio_sink_async_preset_compression);
+  s->s_preset_threads = (aubio_sink_preset_threads_t)(aubio_sink_async_preset_threads);
+  s->s_get_samplerate = (aubio_sink_get_samplerate_t)(aubio_sink_async_get_samplerate);
+  s->s_get_channels = (aubio_sink_get_channels_t)(aubio_sink_async_get_channels);
+  s->s_close = (aubio_sink_close_t)(aubio_sink_async_close);
+  s->s_del = (del_aubio_sink_t)(del_aubio_sink_async);
+  return s;
+}
+
+static aubio_sink_t * aubio_sink_open_io(aubio_sink_io_t * io,
+    const char_t * format, uint_t samplerate) {
+  aubio_sink_t * s = AUBIO_NEW(aubio_sink_t);
+
+  if (!s || !io) {
+    if (io) del_aubio_sink_io(io);
+    if (s) AUBIO_FREE(s);
+    return NULL;
+  }
+  // deleted with s
+  s->io = io;
+#ifdef HAVE_WAVWRITE
+  s->sink = (void *)new_aubio_sink_wavwrite_io(io, format, samplerate);
+  if (s->sink) {
+    s->s_do = (aubio_sink_do_t)(aubio_sink_wavwrite_do);
+    s->s_do_multi = (aubio_sink_do_multi_t)(aubio_sink_wavwrite_do_multi);
+    s->s_preset_samplerate = (aubio_sink_preset_samplerate_t)(aubio_sink_wavwrite_preset_samplerate);
+    s->s_preset_channels = (aubio_sink_preset_channels_t)(aubio_sink_wavwrite_preset_channels);
+    s->s_get_samplerate = (aubio_sink_get_samplerate_t)(aubio_sink_wavwrite_get_samplerate);
+    s->s_get_channels = (aubio_sink_get_channels_t)(aubio_sink_wavwrite_get_channels);
+    s->s_close = (aubio_sink_close_t)(aubio_sink_wavwrite_close);
+    s->s_del = (del_aubio_sink_t)(del_aubio_sink_wavwrite);
+    return s;
+  }
+#else
+  AUBIO_ERROR("sink: failed creating %s with format %s at %dHz"
+     " (no sink built-in writes to streams)\n",
+     aubio_sink_io_get_name(io), format ? format : "wav", samplerate);
+#endif /* HAVE_WAVWRITE */
+  del_aubio_sink(s);
+  return NULL;
+}
+
+aubio_sink_t * new_aubio_sink_memory(void * data, uint_t size,
+    const char_t * format, uint_t samplerate) {
+  return aubio_sink_open_io(new_aubio_sink_io_memory(data, size), format,
+      samplerate);
+}
+
+aubio_sink_t * new_aubio_sink_callbacks(
+    const aubio_sink_callbacks_t * callbacks, void * user_data,
+    const char_t * format, uint_t samplerate) {
+  return aubio_sink_open_io(new_aubio_sink_io(callbacks, user_data), format,
+      samplerate);
+}
+
+const void * aubio_sink_get_memory(const aubio_sink_t * s, uint_t * size) {
+  if (!s->io) return NULL;
+  return aubio_sink_io_get_data(s->io, size);
+}
+
 void aubio_sink_do(aubio_sink_t * s, fvec_t * write_data, uint_t write) {
+  AUBIO_STATS_BEGIN ("sink");
   s->s_do((void *)s->sink, write_data, write);
+  AUBIO_STATS_END ();
 }
 
 void aubio_sink_do_multi(aubio_sink_t * s, fmat_t * write_data, uint_t write) {
@@ -206,6 +299,24 @@ uint_t aubio_sink_preset_channels(aubio_sink_t * s, uint_t channels) {
   return s->s_preset_channels((void *)s->sink, channels);
 }
 
+uint_t aubio_sink_preset_compression(aubio_sink_t * s, uint_t level) {
+  if (!s->s_preset_compression) {
+    AUBIO_ERR("sink: this sink does not support compression levels\n");
+    return AUBIO_FAIL;
+  }
+  return s->s_preset_compression((void *)s->sink, level);
+}
+
+uint_t aubio_sink_preset_threads(aubio_sink_t * s, uint_t threads) {
+  if (!s->s_preset_threads) {
+    // encoding on the calling thread is always supported
+    if (threads == 1) return AUBIO_OK;
+    AUBIO_ERR("sink: this sink can not encode on %d threads\n", threads);
+    return AUBIO_FAIL;
+  }
+  return s->s_preset_threads((void *)s->sink, threads);
+}
+
 uint_t aubio_sink_get_samplerate(const aubio_sink_t * s) {
   return s->s_get_samplerate((void *)s->sink);
 }
@@ -222,5 +333,7 @@ void del_aubio_sink(aubio_sink_t * s) {
   //AUBIO_ASSERT(s);
   if (s && s->s_del && s->sink)
     s->s_del((void *)s->sink);
+  if (s && s->io)
+    del_aubio_sink_io(s->io);
   AUBIO_FREE(s);
 }
@@ -78,6 +78,106 @@ typedef struct _aubio_sink_t aubio_sink_t;
 */
 aubio_sink_t * new_aubio_sink(const char_t * uri, uint_t samplerate);
 
+/**
+
+  create new ::aubio_sink_t writing on a background thread
+
+  \param uri the file path or uri to write to
+  \param samplerate sample rate to write the file at
+  \param queue_frames number of frames to queue, or `0` to queue 16 blocks
+
+  \return newly created ::aubio_sink_t
+
+  Creates a sink as ::new_aubio_sink does, then starts a thread encoding and
+  writing the blocks passed to ::aubio_sink_do and ::aubio_sink_do_multi.
+  These functions only copy the block to a queue, and wait for the thread
+  when the queue is full.
+
+  Queued blocks are written before ::aubio_sink_preset_samplerate,
+  ::aubio_sink_preset_channels, ::aubio_sink_preset_compression,
+  ::aubio_sink_preset_threads and ::aubio_sink_close reach the sink, and
+  when the sink is deleted. Errors occurring while writing are reported by
+  the thread.
+
+*/
+aubio_sink_t * new_aubio_sink_async(const char_t * uri, uint_t samplerate,
+    uint_t queue_frames);
+
+/** functions to write the bytes of a media file to, see
+  ::new_aubio_sink_callbacks */
+typedef struct {
+  /** write `size` bytes from `buf`, returns the number of bytes written, or
+    a negative value on error */
+  sint_t (*write) (void *user_data, const void *buf, uint_t size);
+  /** move to `offset` bytes from `whence`, one of `SEEK_SET`, `SEEK_CUR` or
+    `SEEK_END`, returns the new position in bytes, or a negative value on
+    error; can be `NULL` if the stream can not seek */
+  long long (*seek) (void *user_data, long long offset, sint_t whence);
+} aubio_sink_callbacks_t;
+
+/**
+
+  create new ::aubio_sink_t writing to memory
+
+  \param data buffer to write to, or `NULL` to write to a buffer allocated by
+  the sink, grown as needed
+  \param size number of bytes in `data`, or `0`
+  \param format format of the samples, `wav` or `NULL` for 16 bit WAV,
+  `s24` or `f32` for 24 bit integer or 32 bit float WAV, `raw` for 32 bit
+  float samples without header
+  \param samplerate sample rate to write the file at, or `0` to wait for
+  ::aubio_sink_preset_samplerate and ::aubio_sink_preset_channels
+
+  \return newly created ::aubio_sink_t
+
+  Creates a sink writing the same bytes as a file written by the native WAV
+  sink, without touching the disk. Once the sink is closed, the bytes are
+  obtained with ::aubio_sink_get_memory. When `data` is given, it should not
+  be freed until the sink is deleted, and the samples which would not fit in
+  it are dropped, with an error message.
+
+  Only the native WAV sink can write to memory; compressed formats are not
+  supported.
+
+*/
+aubio_sink_t * new_aubio_sink_memory(void * data, uint_t size,
+    const char_t * format, uint_t samplerate);
+
+/**
+
+  create new ::aubio_sink_t writing through callbacks
+
+  \param callbacks functions to write to, copied by the new sink
+  \param user_data pointer passed to the callbacks
+  \param format format of the samples, as for ::new_aubio_sink_memory
+  \param samplerate sample rate to write the file at
+
+  \return newly created ::aubio_sink_t
+
+  When `callbacks` has no seek function, the sizes in the header of a WAV
+  file can not be updated once the samples have been written; they are set
+  to `0xFFFFFFFF`, which most readers take as "until the end of the stream".
+
+*/
+aubio_sink_t * new_aubio_sink_callbacks(
+    const aubio_sink_callbacks_t * callbacks, void * user_data,
+    const char_t * format, uint_t samplerate);
+
+/**
+
+  get bytes written by a sink created with ::new_aubio_sink_memory
+
+  \param s sink, created with ::new_aubio_sink_memory
+  \param size pointer set to the number of bytes written, can be `NULL`
+
+  \return the bytes written, or `NULL` if `s` does not write to memory
+
+  The header of a WAV file is only complete after ::aubio_sink_close. The
+  returned buffer belongs to the sink, and is freed with it.
+
+*/
+const void * aubio_sink_get_memory(const aubio_sink_t * s, uint_t * size);
+
 /**
 
   preset sink samplerate
@@ -112,6 +212,48 @@ uint_t aubio_sink_preset_samplerate(aubio_sink_t *s, uint_t samplerate);
 */
 uint_t aubio_sink_preset_channels(aubio_sink_t *s, uint_t channels);
 
+/**
+
+  preset sink compression level
+
+  \param s sink, created with ::new_aubio_sink or ::new_aubio_sink_async
+  \param level compression level, from `0` (fastest) to `8` (smallest
+  files)
+
+  \return 0 on success, 1 on error, including when the sink does not support
+  compression levels
+
+  Only supported by the FLAC sink, which uses level `5` by default. Lower
+  levels encode several times faster, for files a few percent larger.
+
+  The file should have been created using a samplerate of 0, and this
+  function called before ::aubio_sink_preset_samplerate and
+  ::aubio_sink_preset_channels.
+
+*/
+uint_t aubio_sink_preset_compression(aubio_sink_t *s, uint_t level);
+
+/**
+
+  preset the number of threads encoding the file
+
+  \param s sink, created with ::new_aubio_sink or ::new_aubio_sink_async
+  \param threads number of encoder threads, `1` by default
+
+  \return 0 on success, 1 on error, including when the sink can not use more
+  than one thread
+
+  Only supported by the FLAC sink, when libFLAC was built with
+  multithreading support. The encoder threads run in addition to the one of
+  ::new_aubio_sink_async, if any.
+
+  The file should have been created using a samplerate of 0, and this
+  function called before ::aubio_sink_preset_samplerate and
+  ::aubio_sink_preset_channels.
+
+*/
+uint_t aubio_sink_preset_threads(aubio_sink_t *s, uint_t threads);
+
 /**
 
   get samplerate of sink object
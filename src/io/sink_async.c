@@ -0,0 +1,335 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/sink.h"
+#include "io/ioutils.h"
+#include "io/sink_async_priv.h"
+#include "io/iothread_priv.h"
+
+/** largest block accepted by the sinks, see MAX_SIZE in io/sink_*.c */
+#define AUBIO_SINK_ASYNC_MAX_SIZE 4096
+
+/** number of blocks queued when queue_frames is 0 */
+#define AUBIO_SINK_ASYNC_DEFAULT_BLOCKS 16
+
+struct _aubio_sink_async_t {
+  aubio_sink_t *sink;           /**< wrapped sink, only used by the thread
+                                     while blocks are queued */
+  char_t *path;                 /**< uri, for error messages */
+  uint_t queue_frames;
+
+  fmat_t **slots;               /**< ring of blocks */
+  uint_t *slot_write;           /**< number of frames to write from each slot */
+  uint_t *slot_height;          /**< number of channels in each slot, 0 for a
+                                     mono block written with aubio_sink_do */
+  uint_t n_slots;
+
+  /* all the fields below are protected by mutex */
+  uint_t head;                  /**< next slot to be filled by the caller */
+  uint_t tail;                  /**< next slot to be written by the thread */
+  uint_t count;                 /**< number of filled slots */
+  uint_t quit;                  /**< 1 once the thread was asked to stop */
+
+  uint_t started;               /**< 1 if mutex and cond were initialised */
+  uint_t running;               /**< 1 until the thread was joined */
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  aubio_io_thread_t thread;
+};
+
+static void aubio_sink_async_write (aubio_sink_async_t * s, uint_t slot)
+{
+  uint_t write = s->slot_write[slot];
+  if (s->slot_height[slot] == 0) {
+    fvec_t block;
+    block.length = write;
+    block.data = s->slots[slot]->data[0];
+    aubio_sink_do(s->sink, &block, write);
+  } else {
+    fmat_t block;
+    block.height = s->slot_height[slot];
+    block.length = write;
+    block.data = s->slots[slot]->data;
+    aubio_sink_do_multi(s->sink, &block, write);
+  }
+}
+
+static void aubio_sink_async_run (aubio_sink_async_t * s)
+{
+  uint_t slot;
+  AUBIO_IO_LOCK(s);
+  for (;;) {
+    if (s->count == 0) {
+      // stop only once all the queued blocks were written
+      if (s->quit) break;
+      AUBIO_IO_WAIT(s);
+      continue;
+    }
+    slot = s->tail;
+    AUBIO_IO_UNLOCK(s);
+    // the caller does not touch this slot, nor the sink, until count is
+    // decremented
+    aubio_sink_async_write(s, slot);
+    AUBIO_IO_LOCK(s);
+    s->tail = (s->tail + 1) % s->n_slots;
+    s->count--;
+    AUBIO_IO_WAKE(s);
+  }
+  AUBIO_IO_UNLOCK(s);
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_sink_async_thread)
+{
+  aubio_sink_async_run((aubio_sink_async_t *)arg);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+/* wait until the thread wrote all the queued blocks */
+static void aubio_sink_async_flush (aubio_sink_async_t * s)
+{
+  if (!s->running) return;
+  AUBIO_IO_LOCK(s);
+  while (s->count > 0) {
+    AUBIO_IO_WAIT(s);
+  }
+  AUBIO_IO_UNLOCK(s);
+}
+
+static void aubio_sink_async_free_slots (aubio_sink_async_t * s)
+{
+  uint_t i;
+  if (s->slots) {
+    for (i = 0; i < s->n_slots; i++) {
+      if (s->slots[i])
+        del_fmat(s->slots[i]);
+    }
+    AUBIO_FREE(s->slots);
+  }
+  if (s->slot_write)
+    AUBIO_FREE(s->slot_write);
+  if (s->slot_height)
+    AUBIO_FREE(s->slot_height);
+  s->slots = NULL;
+  s->slot_write = NULL;
+  s->slot_height = NULL;
+  s->n_slots = 0;
+}
+
+/* make sure the slots can hold blocks of height x length */
+static uint_t aubio_sink_async_reserve (aubio_sink_async_t * s,
+    uint_t height, uint_t length)
+{
+  uint_t i;
+  if (s->slots && s->slots[0]->height >= height
+      && s->slots[0]->length >= length) {
+    return AUBIO_OK;
+  }
+  if (s->slots) {
+    height = MAX(height, s->slots[0]->height);
+    length = MAX(length, s->slots[0]->length);
+  }
+  // the thread does not access the slots while the ring is empty
+  aubio_sink_async_flush(s);
+  AUBIO_IO_LOCK(s);
+  aubio_sink_async_free_slots(s);
+  if (s->queue_frames == 0) {
+    s->n_slots = AUBIO_SINK_ASYNC_DEFAULT_BLOCKS;
+  } else {
+    s->n_slots = MAX(2, (s->queue_frames + length - 1) / length);
+  }
+  s->slots = AUBIO_ARRAY(fmat_t *, s->n_slots);
+  s->slot_write = AUBIO_ARRAY(uint_t, s->n_slots);
+  s->slot_height = AUBIO_ARRAY(uint_t, s->n_slots);
+  for (i = 0; i < s->n_slots; i++) {
+    s->slots[i] = new_fmat(height, length);
+    if (!s->slots[i]) {
+      aubio_sink_async_free_slots(s);
+      break;
+    }
+  }
+  s->head = s->tail = 0;
+  AUBIO_IO_UNLOCK(s);
+  if (!s->slots) {
+    AUBIO_ERR("sink_async: failed allocating %d frames for %s\n",
+        length, s->path);
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+/* wait for a free slot, or return NULL if blocks can not be queued */
+static fmat_t *aubio_sink_async_next (aubio_sink_async_t * s, uint_t height,
+    uint_t length)
+{
+  fmat_t *block;
+  if (!s->running || aubio_sink_async_reserve(s, height, length)) {
+    return NULL;
+  }
+  AUBIO_IO_LOCK(s);
+  while (s->count == s->n_slots) {
+    AUBIO_IO_WAIT(s);
+  }
+  block = s->slots[s->head];
+  AUBIO_IO_UNLOCK(s);
+  return block;
+}
+
+/* queue the slot returned by aubio_sink_async_next */
+static void aubio_sink_async_queue (aubio_sink_async_t * s, uint_t height,
+    uint_t write)
+{
+  AUBIO_IO_LOCK(s);
+  s->slot_height[s->head] = height;
+  s->slot_write[s->head] = write;
+  s->head = (s->head + 1) % s->n_slots;
+  s->count++;
+  AUBIO_IO_WAKE(s);
+  AUBIO_IO_UNLOCK(s);
+}
+
+aubio_sink_async_t *new_aubio_sink_async_from (aubio_sink_t * sink,
+    const char_t * uri, uint_t queue_frames)
+{
+  aubio_sink_async_t *s = AUBIO_NEW(aubio_sink_async_t);
+
+  s->sink = sink;
+  s->path = AUBIO_ARRAY(char_t, strnlen(uri, PATH_MAX) + 1);
+  strncpy(s->path, uri, strnlen(uri, PATH_MAX) + 1);
+  s->queue_frames = queue_frames;
+
+  AUBIO_IO_THREAD_INIT(s);
+  s->running = AUBIO_IO_THREAD_START(s, aubio_sink_async_thread,
+      AUBIO_THREAD_IO);
+  s->started = 1;
+  if (!s->running) {
+    AUBIO_ERR("sink_async: failed starting thread for %s\n", uri);
+    // the caller still owns sink
+    s->sink = NULL;
+    del_aubio_sink_async(s);
+    return NULL;
+  }
+  return s;
+}
+
+void aubio_sink_async_do (aubio_sink_async_t * s, fvec_t * write_data,
+    uint_t write)
+{
+  uint_t length = aubio_sink_validate_input_length("sink_async", s->path,
+      AUBIO_SINK_ASYNC_MAX_SIZE, write_data->length, write);
+  fmat_t *block = length ? aubio_sink_async_next(s, 1, length) : NULL;
+  if (!block) {
+    // keep the blocks in order
+    aubio_sink_async_flush(s);
+    aubio_sink_do(s->sink, write_data, write);
+    return;
+  }
+  AUBIO_MEMCPY(block->data[0], write_data->data, length * sizeof(smpl_t));
+  aubio_sink_async_queue(s, 0, length);
+}
+
+void aubio_sink_async_do_multi (aubio_sink_async_t * s, fmat_t * write_data,
+    uint_t write)
+{
+  uint_t j, length = aubio_sink_validate_input_length("sink_async", s->path,
+      AUBIO_SINK_ASYNC_MAX_SIZE, write_data->length, write);
+  // only copy the channels the sink can write, the sink warns about the rest
+  uint_t height = MIN(write_data->height,
+      MAX(1, aubio_sink_get_channels(s->sink)));
+  fmat_t *block = (height && length) ?
+    aubio_sink_async_next(s, height, length) : NULL;
+  if (!block) {
+    aubio_sink_async_flush(s);
+    aubio_sink_do_multi(s->sink, write_data, write);
+    return;
+  }
+  for (j = 0; j < height; j++) {
+    AUBIO_MEMCPY(block->data[j], write_data->data[j], length * sizeof(smpl_t));
+  }
+  aubio_sink_async_queue(s, height, length);
+}
+
+uint_t aubio_sink_async_preset_samplerate (aubio_sink_async_t * s,
+    uint_t samplerate)
+{
+  aubio_sink_async_flush(s);
+  return aubio_sink_preset_samplerate(s->sink, samplerate);
+}
+
+uint_t aubio_sink_async_preset_channels (aubio_sink_async_t * s,
+    uint_t channels)
+{
+  aubio_sink_async_flush(s);
+  return aubio_sink_preset_channels(s->sink, channels);
+}
+
+uint_t aubio_sink_async_preset_compression (aubio_sink_async_t * s,
+    uint_t level)
+{
+  aubio_sink_async_flush(s);
+  return aubio_sink_preset_compression(s->sink, level);
+}
+
+uint_t aubio_sink_async_preset_threads (aubio_sink_async_t * s,
+    uint_t threads)
+{
+  aubio_sink_async_flush(s);
+  return aubio_sink_preset_threads(s->sink, threads);
+}
+
+uint_t aubio_sink_async_get_samplerate (const aubio_sink_async_t * s)
+{
+  return aubio_sink_get_samplerate(s->sink);
+}
+
+uint_t aubio_sink_async_get_channels (const aubio_sink_async_t * s)
+{
+  return aubio_sink_get_channels(s->sink);
+}
+
+uint_t aubio_sink_async_close (aubio_sink_async_t * s)
+{
+  aubio_sink_async_flush(s);
+  return aubio_sink_close(s->sink);
+}
+
+void del_aubio_sink_async (aubio_sink_async_t * s)
+{
+  AUBIO_ASSERT(s);
+  if (s->running) {
+    // the thread writes the remaining blocks before returning
+    AUBIO_IO_LOCK(s);
+    s->quit = 1;
+    AUBIO_IO_WAKE(s);
+    AUBIO_IO_UNLOCK(s);
+    AUBIO_IO_THREAD_JOIN(s);
+    s->running = 0;
+  }
+  if (s->started)
+    AUBIO_IO_THREAD_DESTROY(s);
+  if (s->sink)
+    del_aubio_sink(s->sink);
+  aubio_sink_async_free_slots(s);
+  if (s->path)
+    AUBIO_FREE(s->path);
+  AUBIO_FREE(s);
+}
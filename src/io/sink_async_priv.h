@@ -0,0 +1,75 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Write-behind wrapper used by new_aubio_sink_async() in io/sink.c.
+
+   aubio_sink_async_do() copies each block into a ring, which a background
+   thread empties by passing the blocks to the wrapped sink. The caller waits
+   when the ring is full, and before any call that reaches the wrapped sink
+   directly, such as presets and close, until the thread wrote all the
+   queued blocks.
+*/
+
+#ifndef AUBIO_SINK_ASYNC_PRIV_H
+#define AUBIO_SINK_ASYNC_PRIV_H
+
+/** write-behind wrapper around a sink */
+typedef struct _aubio_sink_async_t aubio_sink_async_t;
+
+/** start writing to sink on a background thread
+
+  \param sink sink to write to, owned by the new object
+  \param uri path of the sink, for error messages
+  \param queue_frames number of frames to queue, 0 for a default
+
+  \return the new object, or NULL if the thread could not be started, in
+  which case `sink` is left untouched
+
+*/
+aubio_sink_async_t *new_aubio_sink_async_from (aubio_sink_t * sink,
+    const char_t * uri, uint_t queue_frames);
+
+void aubio_sink_async_do (aubio_sink_async_t * s, fvec_t * write_data,
+    uint_t write);
+
+void aubio_sink_async_do_multi (aubio_sink_async_t * s, fmat_t * write_data,
+    uint_t write);
+
+uint_t aubio_sink_async_preset_samplerate (aubio_sink_async_t * s,
+    uint_t samplerate);
+
+uint_t aubio_sink_async_preset_channels (aubio_sink_async_t * s,
+    uint_t channels);
+
+uint_t aubio_sink_async_preset_compression (aubio_sink_async_t * s,
+    uint_t level);
+
+uint_t aubio_sink_async_preset_threads (aubio_sink_async_t * s,
+    uint_t threads);
+
+uint_t aubio_sink_async_get_samplerate (const aubio_sink_async_t * s);
+
+uint_t aubio_sink_async_get_channels (const aubio_sink_async_t * s);
+
+uint_t aubio_sink_async_close (aubio_sink_async_t * s);
+
+void del_aubio_sink_async (aubio_sink_async_t * s);
+
+#endif /* AUBIO_SINK_ASYNC_PRIV_H */
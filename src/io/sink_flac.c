@@ -33,9 +33,21 @@
 
 #include <FLAC/metadata.h>
 #include <FLAC/stream_encoder.h>
+#include "io/lazy_flac_priv.h"
 
 #define MAX_WRITE_SIZE 4096
 
+/** number of frames buffered before being passed to the encoder, per encoder
+ * thread, so that each call gives several blocks to encode */
+#define AUBIO_SINK_FLAC_BUFFER_FRAMES (4 * MAX_WRITE_SIZE)
+
+/** compression level used unless aubio_sink_flac_preset_compression() was
+ * called, the default of the flac command line tool */
+#define AUBIO_SINK_FLAC_DEFAULT_COMPRESSION 5
+
+/** highest compression level of libFLAC */
+#define AUBIO_SINK_FLAC_MAX_COMPRESSION 8
+
 // swap endian of a short
 #define SWAPS(x) ((x & 0xff) << 8) | ((x & 0xff00) >> 8)
 
@@ -64,6 +76,11 @@ struct _aubio_sink_flac_t {
   FLAC__StreamEncoder* encoder;
   FLAC__int32 *buffer;
   FLAC__StreamMetadata **metadata;
+
+  uint_t compression;   // compression level, from 0 to 8
+  uint_t threads;       // number of encoder threads
+  uint_t buffer_frames; // number of frames the buffer can hold
+  uint_t buffered;      // number of frames in the buffer
 };
 
 typedef struct _aubio_sink_flac_t aubio_sink_flac_t;
@@ -72,6 +89,9 @@ uint_t aubio_sink_flac_preset_channels(aubio_sink_flac_t *s,
     uint_t channels);
 uint_t aubio_sink_flac_preset_samplerate(aubio_sink_flac_t *s,
     uint_t samplerate);
+uint_t aubio_sink_flac_preset_compression(aubio_sink_flac_t *s,
+    uint_t level);
+uint_t aubio_sink_flac_preset_threads(aubio_sink_flac_t *s, uint_t threads);
 uint_t aubio_sink_flac_open(aubio_sink_flac_t *s);
 uint_t aubio_sink_flac_close (aubio_sink_flac_t *s);
 void del_aubio_sink_flac (aubio_sink_flac_t *s);
@@ -91,6 +111,10 @@ aubio_sink_flac_t * new_aubio_sink_flac (const char_t *uri,
   if (!s) {
     return NULL;
   }
+  if (aubio_flac_load()) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
 
   if (!uri) {
     AUBIO_ERROR("sink_flac: Aborted opening null path\n");
@@ -103,6 +127,8 @@ aubio_sink_flac_t * new_aubio_sink_flac (const char_t *uri,
 
   s->channels = 0;
   s->samplerate = 0;
+  s->compression = AUBIO_SINK_FLAC_DEFAULT_COMPRESSION;
+  s->threads = 1;
 
   if ((sint_t)samplerate == 0)
     return s;
@@ -137,12 +163,15 @@ uint_t aubio_sink_flac_open(aubio_sink_flac_t *s)
   FLAC__bool ok = true;
   FLAC__StreamEncoderInitStatus init_status;
   FLAC__StreamMetadata_VorbisComment_Entry entry;
-  const unsigned comp_level = 5;
   const unsigned bps = 16;
 
   if (s->samplerate == 0 || s->channels == 0) return AUBIO_FAIL;
 
-  s->buffer = AUBIO_ARRAY(FLAC__int32, s->channels * MAX_WRITE_SIZE);
+  if (s->buffer)
+    AUBIO_FREE(s->buffer);
+  s->buffer_frames = AUBIO_SINK_FLAC_BUFFER_FRAMES * s->threads;
+  s->buffered = 0;
+  s->buffer = AUBIO_ARRAY(FLAC__int32, s->channels * s->buffer_frames);
   if (!s->buffer) {
     AUBIO_ERR("sink_flac: failed allocating buffer for %s\n", s->path);
     return AUBIO_FAIL;
@@ -159,7 +188,8 @@ uint_t aubio_sink_flac_open(aubio_sink_flac_t *s)
     goto failure;
   }
   ok &= FLAC__stream_encoder_set_verify(s->encoder, true);
-  ok &= FLAC__stream_encoder_set_compression_level(s->encoder, comp_level);
+  ok &= FLAC__stream_encoder_set_compression_level(s->encoder,
+      s->compression);
   ok &= FLAC__stream_encoder_set_channels(s->encoder, s->channels);
   ok &= FLAC__stream_encoder_set_bits_per_sample(s->encoder, bps);
   ok &= FLAC__stream_encoder_set_sample_rate(s->encoder, s->samplerate);
@@ -172,6 +202,18 @@ uint_t aubio_sink_flac_open(aubio_sink_flac_t *s)
     goto failure;
   }
 
+#ifdef HAVE_FLAC_THREADS
+  if (s->threads > 1) {
+    uint32_t status = FLAC__stream_encoder_set_num_threads(s->encoder,
+        s->threads);
+    // libFLAC may have been built without threads, encode on a single one
+    if (status != FLAC__STREAM_ENCODER_SET_NUM_THREADS_OK) {
+      AUBIO_WRN("sink_flac: failed setting %d encoder threads for %s (%d),"
+          " using one\n", s->threads, s->path, (int)status);
+    }
+  }
+#endif /* HAVE_FLAC_THREADS */
+
   s->metadata = AUBIO_ARRAY(FLAC__StreamMetadata*, 2);
   if (!s->metadata) {
     AUBIO_ERR("sink_flac: failed allocating memory for %s\n", s->path);
@@ -258,6 +300,45 @@ uint_t aubio_sink_flac_preset_channels(aubio_sink_flac_t *s,
   return AUBIO_OK;
 }
 
+uint_t aubio_sink_flac_preset_compression(aubio_sink_flac_t *s,
+    uint_t level)
+{
+  if (s->fid) {
+    AUBIO_ERR("sink_flac: can not change the compression of %s once"
+        " opened\n", s->path);
+    return AUBIO_FAIL;
+  }
+  if (level > AUBIO_SINK_FLAC_MAX_COMPRESSION) {
+    AUBIO_ERR("sink_flac: compression level %d should be between 0 and %d\n",
+        level, AUBIO_SINK_FLAC_MAX_COMPRESSION);
+    return AUBIO_FAIL;
+  }
+  s->compression = level;
+  return AUBIO_OK;
+}
+
+uint_t aubio_sink_flac_preset_threads(aubio_sink_flac_t *s, uint_t threads)
+{
+  if (s->fid) {
+    AUBIO_ERR("sink_flac: can not change the threads of %s once opened\n",
+        s->path);
+    return AUBIO_FAIL;
+  }
+  if ((sint_t)threads < 1) {
+    AUBIO_ERR("sink_flac: got %d threads, but can not be < 1\n", threads);
+    return AUBIO_FAIL;
+  }
+#ifndef HAVE_FLAC_THREADS
+  if (threads > 1) {
+    AUBIO_ERR("sink_flac: can not use %d threads, libFLAC was found without"
+        " multithreading support\n", threads);
+    return AUBIO_FAIL;
+  }
+#endif /* HAVE_FLAC_THREADS */
+  s->threads = threads;
+  return AUBIO_OK;
+}
+
 uint_t aubio_sink_flac_get_samplerate(const aubio_sink_flac_t *s)
 {
   return s->samplerate;
@@ -268,58 +349,72 @@ uint_t aubio_sink_flac_get_channels(const aubio_sink_flac_t *s)
   return s->channels;
 }
 
-static void aubio_sink_write_frames(aubio_sink_flac_t *s, uint_t length)
+static void aubio_sink_flac_flush(aubio_sink_flac_t *s)
 {
+  if (s->buffered == 0) return;
   // send to encoder
   if (!FLAC__stream_encoder_process_interleaved(s->encoder,
-        (const FLAC__int32*)s->buffer, length)) {
+        (const FLAC__int32*)s->buffer, s->buffered)) {
     FLAC__StreamEncoderState state =
       FLAC__stream_encoder_get_state(s->encoder);
     AUBIO_WRN("sink_flac: error writing to %s (%s)\n",
         s->path, FLAC__StreamEncoderStateString[state]);
   }
+  s->buffered = 0;
+}
+
+/* return the first frame of the buffer where length frames can be stored,
+   passing the buffered frames to the encoder if needed */
+static FLAC__int32 *aubio_sink_flac_reserve(aubio_sink_flac_t *s,
+    uint_t length)
+{
+  if (s->buffered + length > s->buffer_frames)
+    aubio_sink_flac_flush(s);
+  return s->buffer + s->buffered * s->channels;
 }
 
 void aubio_sink_flac_do(aubio_sink_flac_t *s, fvec_t *write_data,
     uint_t write)
 {
   uint_t c, v;
+  FLAC__int32 *buffer;
   uint_t length = aubio_sink_validate_input_length("sink_flac", s->path,
       MAX_WRITE_SIZE, write_data->length, write);
   // fill buffer
-  if (!write) {
+  if (!write || !s->fid) {
     return;
   } else {
+    buffer = aubio_sink_flac_reserve(s, length);
     for (c = 0; c < s->channels; c++) {
       for (v = 0; v < length; v++) {
-        s->buffer[v * s->channels + c] = FLOAT_TO_SHORT(write_data->data[v]);
+        buffer[v * s->channels + c] = FLOAT_TO_SHORT(write_data->data[v]);
       }
     }
   }
-  // send to encoder
-  aubio_sink_write_frames(s, length);
+  s->buffered += length;
 }
 
 void aubio_sink_flac_do_multi(aubio_sink_flac_t *s, fmat_t *write_data,
     uint_t write)
 {
   uint_t c, v;
+  FLAC__int32 *buffer;
   uint_t channels = aubio_sink_validate_input_channels("sink_flac", s->path,
       s->channels, write_data->height);
   uint_t length = aubio_sink_validate_input_length("sink_flac", s->path,
       MAX_WRITE_SIZE, write_data->length, write);
   // fill buffer
-  if (!write) {
+  if (!write || !s->fid) {
     return;
   } else {
+    buffer = aubio_sink_flac_reserve(s, length);
     for (c = 0; c < channels; c++) {
       for (v = 0; v < length; v++) {
-        s->buffer[v * s->channels + c] = FLOAT_TO_SHORT(write_data->data[c][v]);
+        buffer[v * s->channels + c] = FLOAT_TO_SHORT(write_data->data[c][v]);
       }
     }
   }
-  // send to encoder
-  aubio_sink_write_frames(s, length);
+  s->buffered += length;
 }
 
 uint_t aubio_sink_flac_close (aubio_sink_flac_t *s)
@@ -329,6 +424,7 @@ uint_t aubio_sink_flac_close (aubio_sink_flac_t *s)
   if (!s->fid) return AUBIO_FAIL;
 
   if (s->encoder) {
+    aubio_sink_flac_flush(s);
     // mark the end of stream
     if (!FLAC__stream_encoder_finish(s->encoder)) {
       FLAC__StreamEncoderState state =
@@ -0,0 +1,196 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/sink.h"
+#include "io/sink_io_priv.h"
+
+/* growable buffers start with this many bytes, then double */
+#define AUBIO_SINK_IO_MIN_ALLOC 4096
+
+struct _aubio_sink_io_t {
+  aubio_sink_callbacks_t callbacks;
+  void *user_data;
+  FILE *fid;                    /**< file of a file stream, or NULL */
+  char_t *path;                 /**< path of a file stream */
+  uint_t is_memory;
+  uint_t growable;              /**< 1 if data was allocated by the stream */
+  unsigned char *data;          /**< bytes of a memory stream */
+  long long capacity;           /**< number of bytes allocated in data */
+  long long size;               /**< number of bytes written to data */
+  long long pos;                /**< current position, in bytes */
+};
+
+aubio_sink_io_t *new_aubio_sink_io_file (const char_t * path)
+{
+  aubio_sink_io_t *io = AUBIO_NEW(aubio_sink_io_t);
+  size_t len;
+  if (!io) return NULL;
+  len = strnlen(path, PATH_MAX);
+  io->path = AUBIO_ARRAY(char_t, len + 1);
+  if (!io->path) goto beach;
+  strncpy(io->path, path, len + 1);
+  io->fid = fopen((const char *)path, "wb");
+  if (!io->fid) goto beach;
+  return io;
+beach:
+  del_aubio_sink_io(io);
+  return NULL;
+}
+
+aubio_sink_io_t *new_aubio_sink_io_memory (void *data, uint_t size)
+{
+  aubio_sink_io_t *io;
+  io = AUBIO_NEW(aubio_sink_io_t);
+  if (!io) return NULL;
+  io->is_memory = 1;
+  if (data) {
+    io->data = (unsigned char *)data;
+  } else {
+    io->growable = 1;
+    size = MAX(size, AUBIO_SINK_IO_MIN_ALLOC);
+    io->data = AUBIO_ARRAY(unsigned char, size);
+    if (!io->data) {
+      AUBIO_FREE(io);
+      return NULL;
+    }
+  }
+  io->capacity = size;
+  return io;
+}
+
+aubio_sink_io_t *new_aubio_sink_io (const aubio_sink_callbacks_t
+    * callbacks, void *user_data)
+{
+  aubio_sink_io_t *io;
+  if (!callbacks || !callbacks->write) {
+    AUBIO_ERR("sink: can not write through callbacks without a write"
+        " function\n");
+    return NULL;
+  }
+  io = AUBIO_NEW(aubio_sink_io_t);
+  if (!io) return NULL;
+  io->callbacks = *callbacks;
+  io->user_data = user_data;
+  return io;
+}
+
+/* make room for end bytes in a growable buffer, returns 0 on success */
+static uint_t aubio_sink_io_reserve (aubio_sink_io_t * io, long long end)
+{
+  long long capacity = io->capacity;
+  unsigned char *data;
+  // the size of the buffer is returned as a uint_t
+  if (end > (long long)UINT_MAX) return AUBIO_FAIL;
+  while (capacity < end) capacity *= 2;
+  capacity = MIN(capacity, (long long)UINT_MAX);
+  data = (unsigned char *)AUBIO_REALLOC(io->data, (size_t)capacity);
+  if (!data) return AUBIO_FAIL;
+  io->data = data;
+  io->capacity = capacity;
+  return AUBIO_OK;
+}
+
+size_t aubio_sink_io_write (aubio_sink_io_t * io, const void *buf,
+    size_t size)
+{
+  size_t total = 0;
+  sint_t written;
+  if (io->fid) {
+    total = fwrite(buf, 1, size, io->fid);
+  } else if (io->is_memory) {
+    if (io->growable && io->pos + (long long)size > io->capacity) {
+      aubio_sink_io_reserve(io, io->pos + size);
+    }
+    total = (size_t)MIN((long long)size, MAX(0, io->capacity - io->pos));
+    if (total) AUBIO_MEMCPY(io->data + io->pos, buf, total);
+    io->size = MAX(io->size, io->pos + (long long)total);
+  } else {
+    // callbacks may write fewer bytes than asked for
+    while (total < size) {
+      written = io->callbacks.write(io->user_data,
+          (const unsigned char *)buf + total,
+          (uint_t)MIN(size - total, UINT_MAX / 2));
+      if (written <= 0) break;
+      total += written;
+    }
+  }
+  io->pos += total;
+  return total;
+}
+
+uint_t aubio_sink_io_seek (aubio_sink_io_t * io, long long offset)
+{
+  if (offset < 0) return AUBIO_FAIL;
+  if (io->fid) {
+    if (fseek(io->fid, (long)offset, SEEK_SET)) return AUBIO_FAIL;
+  } else if (io->is_memory) {
+    // no gaps, bytes past the end have not been written yet
+    if (offset > io->size) return AUBIO_FAIL;
+  } else if (!io->callbacks.seek
+      || io->callbacks.seek(io->user_data, offset, SEEK_SET) != offset) {
+    return AUBIO_FAIL;
+  }
+  io->pos = offset;
+  return AUBIO_OK;
+}
+
+uint_t aubio_sink_io_can_seek (const aubio_sink_io_t * io)
+{
+  return io->fid || io->is_memory || io->callbacks.seek;
+}
+
+uint_t aubio_sink_io_close (aubio_sink_io_t * io)
+{
+  uint_t err = AUBIO_OK;
+  if (io->fid) {
+    if (fclose(io->fid)) err = AUBIO_FAIL;
+    io->fid = NULL;
+  }
+  return err;
+}
+
+const void *aubio_sink_io_get_data (const aubio_sink_io_t * io,
+    uint_t * size)
+{
+  if (!io->is_memory) return NULL;
+  if (size) *size = (uint_t)io->size;
+  return io->data;
+}
+
+const char_t *aubio_sink_io_get_name (const aubio_sink_io_t * io)
+{
+  if (io->path) return io->path;
+  return io->is_memory ? "memory buffer" : "callbacks";
+}
+
+void del_aubio_sink_io (aubio_sink_io_t * io)
+{
+  AUBIO_ASSERT(io);
+  if (io->fid)
+    fclose(io->fid);
+  if (io->path)
+    AUBIO_FREE(io->path);
+  if (io->growable && io->data)
+    AUBIO_FREE(io->data);
+  AUBIO_FREE(io);
+}
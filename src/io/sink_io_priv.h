@@ -0,0 +1,102 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Byte streams written by new_aubio_sink_memory() and
+   new_aubio_sink_callbacks() in io/sink.c, and by the native WAV writer when
+   it writes to a path.
+
+   A sink writing to a stream borrows it; the aubio_sink_t wrapping the sink
+   deletes it once the sink is deleted, so that the bytes of a memory stream
+   can still be read after aubio_sink_close().
+*/
+
+#ifndef AUBIO_SINK_IO_PRIV_H
+#define AUBIO_SINK_IO_PRIV_H
+
+/** byte stream to write to */
+typedef struct _aubio_sink_io_t aubio_sink_io_t;
+
+/** create a stream writing to a file, truncated if it exists
+
+  \param path path of the file to create
+
+  \return the new stream, or NULL if the file could not be opened, with errno
+  set by fopen()
+
+*/
+aubio_sink_io_t *new_aubio_sink_io_file (const char_t * path);
+
+/** create a stream writing to memory
+
+  \param data buffer to write to, not copied, or NULL to write to a buffer
+  allocated and grown by the stream
+  \param size number of bytes in data, or the number of bytes to allocate
+  first when data is NULL
+
+  \return the new stream
+
+  Writes past the end of a buffer given by the caller are cut short.
+
+*/
+aubio_sink_io_t *new_aubio_sink_io_memory (void *data, uint_t size);
+
+/** create a stream writing through callbacks
+
+  \param callbacks functions to write to, copied
+  \param user_data pointer passed to the callbacks
+
+  \return the new stream, or NULL if callbacks has no write function
+
+*/
+aubio_sink_io_t *new_aubio_sink_io (const aubio_sink_callbacks_t
+    * callbacks, void *user_data);
+
+/** write size bytes, returns the number of bytes written, less than size
+  after an error */
+size_t aubio_sink_io_write (aubio_sink_io_t * io, const void *buf,
+    size_t size);
+
+/** move to offset bytes from the start of the stream, returns 0 on success */
+uint_t aubio_sink_io_seek (aubio_sink_io_t * io, long long offset);
+
+/** returns 1 if bytes already written can be written again */
+uint_t aubio_sink_io_can_seek (const aubio_sink_io_t * io);
+
+/** close the file of a stream, returns 0 on success */
+uint_t aubio_sink_io_close (aubio_sink_io_t * io);
+
+/** get the bytes written to a memory stream and their number, or NULL for
+  other streams */
+const void *aubio_sink_io_get_data (const aubio_sink_io_t * io,
+    uint_t * size);
+
+/** get a name for the stream, to use in place of a path in messages */
+const char_t *aubio_sink_io_get_name (const aubio_sink_io_t * io);
+
+void del_aubio_sink_io (aubio_sink_io_t * io);
+
+/* sinks writing to a stream, see the constructors taking a path */
+
+#ifdef HAVE_WAVWRITE
+struct _aubio_sink_wavwrite_t *new_aubio_sink_wavwrite_io (
+    aubio_sink_io_t * io, const char_t * format, uint_t samplerate);
+#endif /* HAVE_WAVWRITE */
+
+#endif /* AUBIO_SINK_IO_PRIV_H */
@@ -24,11 +24,13 @@
 #ifdef HAVE_SNDFILE
 
 #include <sndfile.h>
+#include "io/lazy_sndfile_priv.h"
 
 #include "fvec.h"
 #include "fmat.h"
 #include "io/sink_sndfile.h"
 #include "io/ioutils.h"
+#include "io/ioutils_priv.h"
 
 #define MAX_SIZE 4096
 
@@ -63,6 +65,10 @@ aubio_sink_sndfile_t * new_aubio_sink_sndfile(const char_t * path, uint_t sample
   if (!s) {
     return NULL;
   }
+  if (aubio_sndfile_load()) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
   s->max_size = MAX_SIZE;
 
   if (path == NULL) {
@@ -191,19 +197,19 @@ uint_t aubio_sink_sndfile_open(aubio_sink_sndfile_t *s) {
 }
 
 void aubio_sink_sndfile_do(aubio_sink_sndfile_t *s, fvec_t * write_data, uint_t write){
-  uint_t i, j;
   sf_count_t written_frames;
   uint_t channels = s->channels;
   uint_t length = aubio_sink_validate_input_length("sink_sndfile", s->path,
       s->max_size, write_data->length, write);
   int nsamples = channels * length;
+  // view write_data as a single row, copied to all channels
+  fmat_t mono;
+  mono.height = 1;
+  mono.length = write_data->length;
+  mono.data = &write_data->data;
 
   /* interleaving data  */
-  for ( i = 0; i < channels; i++) {
-    for (j = 0; j < length; j++) {
-      s->scratch_data[channels*j+i] = write_data->data[j];
-    }
-  }
+  aubio_io_interleave (aubio_io_smpl, &mono, s->scratch_data, channels, length);
 
   written_frames = aubio_sf_write_smpl (s->handle, s->scratch_data, nsamples);
   if (written_frames/channels != write) {
@@ -214,20 +220,19 @@ void aubio_sink_sndfile_do(aubio_sink_sndfile_t *s, fvec_t * write_data, uint_t
 }
 
 void aubio_sink_sndfile_do_multi(aubio_sink_sndfile_t *s, fmat_t * write_data, uint_t write){
-  uint_t i, j;
   sf_count_t written_frames;
-  uint_t channels = aubio_sink_validate_input_channels("sink_sndfile", s->path,
-      s->channels, write_data->height);
+  uint_t channels = s->channels;
   uint_t length = aubio_sink_validate_input_length("sink_sndfile", s->path,
       s->max_size, write_data->length, write);
   int nsamples = channels * length;
 
+  // only warns, rows beyond s->channels are ignored by aubio_io_interleave
+  aubio_sink_validate_input_channels("sink_sndfile", s->path, s->channels,
+      write_data->height);
+
   /* interleaving data  */
-  for ( i = 0; i < channels; i++) {
-    for (j = 0; j < length; j++) {
-      s->scratch_data[channels*j+i] = write_data->data[i][j];
-    }
-  }
+  aubio_io_interleave (aubio_io_smpl, write_data, s->scratch_data, channels,
+      length);
 
   written_frames = aubio_sf_write_smpl (s->handle, s->scratch_data, nsamples);
   if (written_frames/channels != write) {
@@ -32,6 +32,7 @@
 #include "io/ioutils.h"
 
 #include <vorbis/vorbisenc.h>
+#include "io/lazy_vorbis_priv.h"
 #include <string.h> // strerror
 #include <errno.h> // errno
 #include <time.h> // time
@@ -73,6 +74,10 @@ aubio_sink_vorbis_t * new_aubio_sink_vorbis (const char_t *uri,
   if (!s) {
     return NULL;
   }
+  if (aubio_vorbis_load()) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
 
   if (!uri) {
     AUBIO_ERROR("sink_vorbis: Aborted opening null path\n");
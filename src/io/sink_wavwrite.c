@@ -25,28 +25,21 @@
 
 #include "fvec.h"
 #include "fmat.h"
+#include "io/sink.h"
 #include "io/sink_wavwrite.h"
+#include "io/sink_io_priv.h"
 #include "io/ioutils.h"
+#include "io/ioutils_priv.h"
 
 #define MAX_SIZE 4096
 
-#define FLOAT_TO_SHORT(x) (short)(x * 32768)
+/** frames are converted into a buffer of this many bytes, written to the
+  file once full, so that long recordings are written in large blocks */
+#define AUBIO_WAVWRITE_BUFFER 65536
 
-// swap endian of a short
-#define SWAPS(x) ((x & 0xff) << 8) | ((x & 0xff00) >> 8)
-
-// swap host to little endian
-#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
-#define HTOLES(x) SWAPS(x)
-#elif defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
-#define HTOLES(x) x
-#else
-#ifdef HAVE_WIN_HACKS
-#define HTOLES(x) x
-#else
-#define HTOLES(x) SWAPS(htons(x))
-#endif
-#endif
+// AudioFormat codes
+#define AUBIO_WAVWRITE_PCM   1
+#define AUBIO_WAVWRITE_FLOAT 3
 
 uint_t aubio_sink_wavwrite_open(aubio_sink_wavwrite_t *s);
 
@@ -57,12 +50,21 @@ struct _aubio_sink_wavwrite_t {
   uint_t bitspersample;
   uint_t total_frames_written;
 
-  FILE *fid;
+  aubio_sink_io_t *io;           /**< stream the file is written to */
+  uint_t owns_io;               /**< 1 if io was opened from path */
+  uint_t opened;
+  uint_t raw;                   /**< 1 to write the samples without header */
 
   uint_t max_size;
-
-  uint_t scratch_size;
-  unsigned short *scratch_data;
+  aubio_io_format_t format;     /**< format of the samples in the file */
+  uint_t dither;                /**< 1 to dither integer samples */
+  uint_t seed;                  /**< state of the dither noise generator */
+  fmat_t *dithered;             /**< input samples with dither noise */
+
+  uint_t frame_size;            /**< bytes per frame */
+  uint_t buffer_frames;         /**< number of frames scratch_data holds */
+  uint_t buffered;              /**< frames in scratch_data, not written yet */
+  unsigned char *scratch_data;
 };
 
 static unsigned char *write_little_endian (unsigned int s, unsigned char *str,
@@ -78,7 +80,8 @@ static unsigned char *write_little_endian (unsigned int s, unsigned char *str,
   return str;
 }
 
-aubio_sink_wavwrite_t * new_aubio_sink_wavwrite(const char_t * path, uint_t samplerate) {
+static aubio_sink_wavwrite_t * aubio_sink_wavwrite_create(const char_t * path,
+    aubio_sink_io_t * io, const char_t * format, uint_t samplerate) {
   aubio_sink_wavwrite_t * s = AUBIO_NEW(aubio_sink_wavwrite_t);
   
   if (!s) {
@@ -94,12 +97,19 @@ aubio_sink_wavwrite_t * new_aubio_sink_wavwrite(const char_t * path, uint_t samp
   strncpy(s->path, path, strnlen(path, PATH_MAX) + 1);
 
   s->max_size = MAX_SIZE;
+  s->format = aubio_io_s16;
   s->bitspersample = 16;
   s->total_frames_written = 0;
+  s->seed = 1;
 
   s->samplerate = 0;
   s->channels = 0;
 
+  s->io = io;
+  if (format && aubio_sink_wavwrite_preset_format(s, format)) {
+    goto beach;
+  }
+
   // zero samplerate given. do not open yet
   if ((sint_t)samplerate == 0) {
     return s;
@@ -125,6 +135,17 @@ beach:
   return NULL;
 }
 
+aubio_sink_wavwrite_t * new_aubio_sink_wavwrite(const char_t * path, uint_t samplerate) {
+  return aubio_sink_wavwrite_create(path, NULL, NULL, samplerate);
+}
+
+aubio_sink_wavwrite_t * new_aubio_sink_wavwrite_io(aubio_sink_io_t * io,
+    const char_t * format, uint_t samplerate) {
+  if (!io) return NULL;
+  return aubio_sink_wavwrite_create(aubio_sink_io_get_name(io), io, format,
+      samplerate);
+}
+
 uint_t aubio_sink_wavwrite_preset_samplerate(aubio_sink_wavwrite_t *s, uint_t samplerate)
 {
   if (aubio_io_validate_samplerate("sink_wavwrite", s->path, samplerate)) {
@@ -151,6 +172,54 @@ uint_t aubio_sink_wavwrite_preset_channels(aubio_sink_wavwrite_t *s, uint_t chan
   return AUBIO_OK;
 }
 
+uint_t aubio_sink_wavwrite_preset_format(aubio_sink_wavwrite_t *s,
+    const char_t *fmt)
+{
+  if (s->opened) {
+    AUBIO_ERR("sink_wavwrite: can not change the format of %s once opened\n",
+        s->path);
+    return AUBIO_FAIL;
+  }
+  if (!fmt) {
+    return AUBIO_FAIL;
+  } else if (strcmp(fmt, "s16") == 0 || strcmp(fmt, "wav") == 0) {
+    s->format = aubio_io_s16;
+    s->raw = 0;
+  } else if (strcmp(fmt, "s24") == 0) {
+    s->format = aubio_io_s24;
+    s->raw = 0;
+  } else if (strcmp(fmt, "f32") == 0) {
+    s->format = aubio_io_f32;
+    s->raw = 0;
+  } else if (strcmp(fmt, "raw") == 0) {
+    s->format = aubio_io_f32;
+    s->raw = 1;
+  } else {
+    AUBIO_ERR("sink_wavwrite: unknown format '%s' for %s\n", fmt, s->path);
+    return AUBIO_FAIL;
+  }
+  s->bitspersample = 8 * aubio_io_format_size(s->format);
+  return AUBIO_OK;
+}
+
+uint_t aubio_sink_wavwrite_set_dither(aubio_sink_wavwrite_t *s, uint_t dither)
+{
+  if (dither > 1) {
+    AUBIO_ERR("sink_wavwrite: dither should be 0 or 1, got %d\n", dither);
+    return AUBIO_FAIL;
+  }
+  s->dither = dither;
+  // once opened, allocate the noisy copy of the input now
+  if (s->opened && dither && !s->dithered) {
+    s->dithered = new_fmat(s->channels, s->max_size);
+    if (!s->dithered) {
+      s->dither = 0;
+      return AUBIO_FAIL;
+    }
+  }
+  return AUBIO_OK;
+}
+
 uint_t aubio_sink_wavwrite_get_samplerate(const aubio_sink_wavwrite_t *s)
 {
   return s->samplerate;
@@ -161,76 +230,85 @@ uint_t aubio_sink_wavwrite_get_channels(const aubio_sink_wavwrite_t *s)
   return s->channels;
 }
 
-uint_t aubio_sink_wavwrite_open(aubio_sink_wavwrite_t *s) {
-  unsigned char buf[5];
-  uint_t byterate, blockalign;
-  size_t written = 0;
-
-  /* open output file */
-  s->fid = fopen((const char *)s->path, "wb");
-  if (!s->fid) {
-    AUBIO_STRERR("sink_wavwrite: could not open %s (%s)\n", s->path, errorstr);
-    goto beach;
+/* close the file opened from the path, streams given by the caller are
+  left as they are */
+static void aubio_sink_wavwrite_close_io(aubio_sink_wavwrite_t *s)
+{
+  if (!s->owns_io) return;
+  if (aubio_sink_io_close(s->io)) {
+    AUBIO_STRERR("sink_wavwrite: Error closing file %s (%s)\n", s->path,
+        errorstr);
   }
+  del_aubio_sink_io(s->io);
+  s->io = NULL;
+  s->owns_io = 0;
+}
 
-  // ChunkID
-  written += fwrite("RIFF", 4, 1, s->fid);
-
-  // ChunkSize (0 for now, actual size will be written in _close)
-  written += fwrite(write_little_endian(0, buf, 4), 4, 1, s->fid);
-
-  // Format
-  written += fwrite("WAVE", 4, 1, s->fid);
-
-  // Subchunk1ID
-  written += fwrite("fmt ", 4, 1, s->fid);
-
-  // Subchunk1Size
-  written += fwrite(write_little_endian(16, buf, 4), 4, 1, s->fid);
-
-  // AudioFormat
-  written += fwrite(write_little_endian(1, buf, 2), 2, 1, s->fid);
-
-  // NumChannels
-  written += fwrite(write_little_endian(s->channels, buf, 2), 2, 1, s->fid);
-
-  // SampleRate
-  written += fwrite(write_little_endian(s->samplerate, buf, 4), 4, 1, s->fid);
+uint_t aubio_sink_wavwrite_open(aubio_sink_wavwrite_t *s) {
+  unsigned char header[44];
+  uint_t byterate, blockalign, unknown_size;
+  uint_t format = (s->format == aubio_io_f32) ? AUBIO_WAVWRITE_FLOAT
+    : AUBIO_WAVWRITE_PCM;
+
+  /* open output file, unless a stream was given */
+  if (!s->io) {
+    s->io = new_aubio_sink_io_file(s->path);
+    if (!s->io) {
+      AUBIO_STRERR("sink_wavwrite: could not open %s (%s)\n", s->path,
+          errorstr);
+      goto beach;
+    }
+    s->owns_io = 1;
+  }
+  // sizes written in _close, or set to the largest value if the stream can
+  // not go back to the header
+  unknown_size = aubio_sink_io_can_seek(s->io) ? 0 : 0xFFFFFFFF;
 
-  // ByteRate
   byterate = s->samplerate * s->channels * s->bitspersample / 8;
-  written += fwrite(write_little_endian(byterate, buf, 4), 4, 1, s->fid);
-
-  // BlockAlign
   blockalign = s->channels * s->bitspersample / 8;
-  written += fwrite(write_little_endian(blockalign, buf, 2), 2, 1, s->fid);
-
-  // BitsPerSample
-  written += fwrite(write_little_endian(s->bitspersample, buf, 2), 2, 1, s->fid);
-
-  // Subchunk2ID
-  written += fwrite("data", 4, 1, s->fid);
-
-  // Subchunk1Size (0 for now, actual size will be written in _close)
-  written += fwrite(write_little_endian(0, buf, 4), 4, 1, s->fid);
 
-  // fwrite(*, *, 1, s->fid) was called 13 times, check success
-  if (written != 13 || fflush(s->fid)) {
-    AUBIO_STRERR("sink_wavwrite: writing header to %s failed"
-        " (wrote %d/%d, %s)\n", s->path, written, 13, errorstr);
-    fclose(s->fid);
-    s->fid = NULL;
+  // ChunkID, then ChunkSize, 0 for now, actual size will be written in _close
+  memcpy(header, "RIFF", 4);
+  write_little_endian(unknown_size, header + 4, 4);
+  // Format, then Subchunk1ID and Subchunk1Size
+  memcpy(header + 8, "WAVEfmt ", 8);
+  write_little_endian(16, header + 16, 4);
+  // AudioFormat, NumChannels, SampleRate, ByteRate, BlockAlign, BitsPerSample
+  write_little_endian(format, header + 20, 2);
+  write_little_endian(s->channels, header + 22, 2);
+  write_little_endian(s->samplerate, header + 24, 4);
+  write_little_endian(byterate, header + 28, 4);
+  write_little_endian(blockalign, header + 32, 2);
+  write_little_endian(s->bitspersample, header + 34, 2);
+  // Subchunk2ID, then Subchunk2Size, 0 for now, written in _close
+  memcpy(header + 36, "data", 4);
+  write_little_endian(unknown_size, header + 40, 4);
+
+  if (!s->raw && aubio_sink_io_write(s->io, header, sizeof(header))
+      != sizeof(header)) {
+    AUBIO_STRERR("sink_wavwrite: writing header to %s failed (%s)\n",
+        s->path, errorstr);
+    aubio_sink_wavwrite_close_io(s);
     return AUBIO_FAIL;
   }
+  s->opened = 1;
 
-  s->scratch_size = s->max_size * s->channels;
-  /* allocate data for de/interleaving reallocated when needed. */
-  if (s->scratch_size >= MAX_SIZE * AUBIO_MAX_CHANNELS) {
+  if (s->max_size * s->channels >= MAX_SIZE * AUBIO_MAX_CHANNELS) {
     AUBIO_ERR("sink_wavwrite: %d x %d exceeds SIZE maximum buffer size %d\n",
         s->max_size, s->channels, MAX_SIZE * AUBIO_MAX_CHANNELS);
     goto beach;
   }
-  s->scratch_data = AUBIO_ARRAY(unsigned short,s->scratch_size);
+  /* allocate the write buffer, holding at least one block of max_size */
+  s->frame_size = blockalign;
+  s->buffer_frames = MAX(AUBIO_WAVWRITE_BUFFER / s->frame_size, s->max_size);
+  s->buffered = 0;
+  s->scratch_data = AUBIO_ARRAY(unsigned char,
+      s->buffer_frames * s->frame_size);
+  if (!s->scratch_data) goto beach;
+  if (s->dither && !s->dithered) {
+    s->dithered = new_fmat(s->channels, s->max_size);
+    if (!s->dithered) goto beach;
+  }
 
   return AUBIO_OK;
 
@@ -238,82 +316,125 @@ beach:
   return AUBIO_FAIL;
 }
 
-static
-void aubio_sink_wavwrite_write_frames(aubio_sink_wavwrite_t *s, uint_t write)
+/* write the buffered frames to the file */
+static void aubio_sink_wavwrite_flush(aubio_sink_wavwrite_t *s)
 {
-  uint_t written_frames = 0;
-
-  written_frames = fwrite(s->scratch_data, 2 * s->channels, write, s->fid);
-
-  if (written_frames != write) {
+  uint_t written_frames;
+  if (!s->buffered) return;
+  written_frames = aubio_sink_io_write(s->io, s->scratch_data,
+      s->frame_size * s->buffered) / s->frame_size;
+  if (written_frames != s->buffered) {
     AUBIO_STRERR("sink_wavwrite: trying to write %d frames to %s, but only %d"
-        " could be written (%s)\n", write, s->path, written_frames, errorstr);
+        " could be written (%s)\n", s->buffered, s->path, written_frames,
+        errorstr);
   }
   s->total_frames_written += written_frames;
+  s->buffered = 0;
 }
 
-void aubio_sink_wavwrite_do(aubio_sink_wavwrite_t *s, fvec_t * write_data, uint_t write){
-  uint_t c = 0, i = 0;
-  uint_t length = aubio_sink_validate_input_length("sink_wavwrite", s->path,
-      s->max_size, write_data->length, write);
+/* TPDF dither of 1 LSB, from the difference of two uniform values */
+static void aubio_sink_wavwrite_add_dither(aubio_sink_wavwrite_t *s,
+    const smpl_t *in, smpl_t *out, uint_t length)
+{
+  smpl_t lsb = 1. / (1 << (s->bitspersample - 1));
+  smpl_t scale = lsb / 4294967296.;
+  uint_t j, x = s->seed;
+  for (j = 0; j < length; j++) {
+    uint_t r1, r2;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    r1 = x;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    r2 = x;
+    out[j] = in[j] + ((smpl_t)r1 - (smpl_t)r2) * scale;
+  }
+  s->seed = x;
+}
 
-  for (c = 0; c < s->channels; c++) {
-    for (i = 0; i < length; i++) {
-      s->scratch_data[i * s->channels + c] = HTOLES(FLOAT_TO_SHORT(write_data->data[i]));
+/* convert length frames of in to the buffer, written once full */
+static void aubio_sink_wavwrite_write_frames(aubio_sink_wavwrite_t *s,
+    const fmat_t *in, uint_t length)
+{
+  fmat_t dithered;
+  if (s->buffered + length > s->buffer_frames) {
+    aubio_sink_wavwrite_flush(s);
+  }
+  if (s->dither && s->format != aubio_io_f32) {
+    uint_t c;
+    dithered.height = (in->height == 1) ? 1 : MIN(in->height, s->channels);
+    dithered.length = length;
+    dithered.data = s->dithered->data;
+    for (c = 0; c < dithered.height; c++) {
+      aubio_sink_wavwrite_add_dither(s, in->data[c], dithered.data[c],
+          length);
     }
+    in = &dithered;
   }
+  aubio_io_interleave(s->format, in,
+      s->scratch_data + s->buffered * s->frame_size, s->channels, length);
+  s->buffered += length;
+}
 
-  aubio_sink_wavwrite_write_frames(s, length);
+void aubio_sink_wavwrite_do(aubio_sink_wavwrite_t *s, fvec_t * write_data, uint_t write){
+  uint_t length = aubio_sink_validate_input_length("sink_wavwrite", s->path,
+      s->max_size, write_data->length, write);
+  // view write_data as a single row, copied to all channels
+  fmat_t mono;
+  mono.height = 1;
+  mono.length = write_data->length;
+  mono.data = &write_data->data;
+
+  aubio_sink_wavwrite_write_frames(s, &mono, length);
 }
 
 void aubio_sink_wavwrite_do_multi(aubio_sink_wavwrite_t *s, fmat_t * write_data, uint_t write){
-  uint_t c = 0, i = 0;
-
-  uint_t channels = aubio_sink_validate_input_channels("sink_wavwrite", s->path,
-      s->channels, write_data->height);
   uint_t length = aubio_sink_validate_input_length("sink_wavwrite", s->path,
       s->max_size, write_data->length, write);
 
-  for (c = 0; c < channels; c++) {
-    for (i = 0; i < length; i++) {
-      s->scratch_data[i * s->channels + c] = HTOLES(FLOAT_TO_SHORT(write_data->data[c][i]));
-    }
-  }
+  // only warns, rows beyond s->channels are ignored by aubio_io_interleave
+  aubio_sink_validate_input_channels("sink_wavwrite", s->path, s->channels,
+      write_data->height);
 
-  aubio_sink_wavwrite_write_frames(s, length);
+  aubio_sink_wavwrite_write_frames(s, write_data, length);
 }
 
 uint_t aubio_sink_wavwrite_close(aubio_sink_wavwrite_t * s) {
-  uint_t data_size = s->total_frames_written * s->bitspersample * s->channels / 8;
+  uint_t data_size;
   unsigned char buf[5];
   size_t written = 0, err = 0;
-  if (!s->fid) return AUBIO_FAIL;
-  // ChunkSize
-  err += fseek(s->fid, 4, SEEK_SET);
-  written += fwrite(write_little_endian(data_size + 36, buf, 4), 4, 1, s->fid);
-  // Subchunk2Size
-  err += fseek(s->fid, 40, SEEK_SET);
-  written += fwrite(write_little_endian(data_size, buf, 4), 4, 1, s->fid);
-  if (written != 2 || err != 0) {
-    AUBIO_STRERR("sink_wavwrite: updating header of %s failed, expected %d"
-        " write but got only %d (%s)\n", s->path, 2, written, errorstr);
-  }
-  // close file
-  if (fclose(s->fid)) {
-    AUBIO_STRERR("sink_wavwrite: Error closing file %s (%s)\n", s->path, errorstr);
+  if (!s->opened) return AUBIO_FAIL;
+  aubio_sink_wavwrite_flush(s);
+  data_size = s->total_frames_written * s->bitspersample * s->channels / 8;
+  if (!s->raw && aubio_sink_io_can_seek(s->io)) {
+    // ChunkSize
+    err += aubio_sink_io_seek(s->io, 4);
+    written += aubio_sink_io_write(s->io,
+        write_little_endian(data_size + 36, buf, 4), 4) / 4;
+    // Subchunk2Size
+    err += aubio_sink_io_seek(s->io, 40);
+    written += aubio_sink_io_write(s->io,
+        write_little_endian(data_size, buf, 4), 4) / 4;
+    if (written != 2 || err != 0) {
+      AUBIO_STRERR("sink_wavwrite: updating header of %s failed, expected %d"
+          " write but got only %d (%s)\n", s->path, 2, written, errorstr);
+    }
   }
-  s->fid = NULL;
+  s->opened = 0;
+  aubio_sink_wavwrite_close_io(s);
   return AUBIO_OK;
 }
 
 void del_aubio_sink_wavwrite(aubio_sink_wavwrite_t * s){
   AUBIO_ASSERT(s);
-  if (s->fid)
+  if (s->opened)
     aubio_sink_wavwrite_close(s);
+  if (s->io && s->owns_io)
+    del_aubio_sink_io(s->io);
   if (s->path)
     AUBIO_FREE(s->path);
   if (s->scratch_data)
     AUBIO_FREE(s->scratch_data);
+  if (s->dithered)
+    del_fmat(s->dithered);
   AUBIO_FREE(s);
 }
 
@@ -93,6 +93,47 @@ uint_t aubio_sink_wavwrite_preset_samplerate(aubio_sink_wavwrite_t *s, uint_t sa
 */
 uint_t aubio_sink_wavwrite_preset_channels(aubio_sink_wavwrite_t *s, uint_t channels);
 
+/**
+
+  preset sink format
+
+  \param s sink, created with ::new_aubio_sink_wavwrite
+  \param fmt format of the samples to write
+
+  \return 0 on success, 1 on error
+
+  Preset the format of the samples written to the file. Supported format
+  strings:
+   - "s16" or "wav": 16 bit integer (default)
+   - "s24": 24 bit integer
+   - "f32": 32 bit float, which keeps samples beyond [-1, 1]
+   - "raw": 32 bit float, without the WAV header
+
+  The file should have been created using a samplerate of 0, and this
+  function called before aubio_sink_wavwrite_preset_samplerate() and
+  aubio_sink_wavwrite_preset_channels().
+
+*/
+uint_t aubio_sink_wavwrite_preset_format(aubio_sink_wavwrite_t *s,
+    const char_t *fmt);
+
+/**
+
+  enable dithering of integer samples
+
+  \param s sink, created with ::new_aubio_sink_wavwrite
+  \param dither `1` to add a triangular noise of one least significant bit to
+  the samples before rounding them, `0` to round them directly (default)
+
+  \return 0 on success, 1 on error
+
+  Dithering replaces the distortion of rounding quiet signals by a constant
+  noise floor. It has no effect on "f32" files.
+
+*/
+uint_t aubio_sink_wavwrite_set_dither(aubio_sink_wavwrite_t *s,
+    uint_t dither);
+
 /**
 
   get samplerate of sink object
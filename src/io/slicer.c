@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "io/sink.h"
+#include "io/slicer.h"
+
+/** largest block accepted by the sinks, see MAX_SIZE in io/sink_*.c */
+#define AUBIO_SLICER_BLOCK 4096
+
+typedef struct {
+  uint_t start;
+  uint_t end;
+  const char_t *uri;
+  aubio_sink_t *sink;           /**< NULL before opening and once closed */
+} aubio_slice_t;
+
+struct _aubio_slicer_t {
+  aubio_source_t *source;
+  uint_t samplerate;
+  uint_t channels;
+  uint_t rewind;                /**< 1 once the source was read */
+  fmat_t *block;                /**< frames read from the source */
+  fmat_t view;                  /**< part of block written to a slice */
+};
+
+aubio_slicer_t *new_aubio_slicer (const char_t *uri, uint_t samplerate,
+    uint_t hop_size)
+{
+  aubio_slicer_t *o = AUBIO_NEW(aubio_slicer_t);
+  o->source = new_aubio_source(uri, samplerate, hop_size);
+  if (!o->source) goto beach;
+  o->samplerate = aubio_source_get_samplerate(o->source);
+  o->channels = aubio_source_get_channels(o->source);
+  o->block = new_fmat(o->channels, AUBIO_SLICER_BLOCK);
+  if (!o->block) goto beach;
+  o->view.height = o->channels;
+  o->view.data = AUBIO_ARRAY(smpl_t *, o->channels);
+  if (!o->view.data) goto beach;
+  return o;
+
+beach:
+  del_aubio_slicer(o);
+  return NULL;
+}
+
+uint_t aubio_slicer_get_samplerate (const aubio_slicer_t *o)
+{
+  return o->samplerate;
+}
+
+uint_t aubio_slicer_get_channels (const aubio_slicer_t *o)
+{
+  return o->channels;
+}
+
+static uint_t aubio_slicer_open (aubio_slicer_t *o, aubio_slice_t *slice)
+{
+  // write on a background thread, or directly if no thread could be started
+  slice->sink = new_aubio_sink_async(slice->uri, 0, 0);
+  if (!slice->sink) slice->sink = new_aubio_sink(slice->uri, 0);
+  if (!slice->sink) return AUBIO_FAIL;
+  if (aubio_sink_preset_samplerate(slice->sink, o->samplerate)
+      || aubio_sink_preset_channels(slice->sink, o->channels)) {
+    del_aubio_sink(slice->sink);
+    slice->sink = NULL;
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+static uint_t aubio_slicer_close (aubio_slice_t *slice)
+{
+  uint_t err = aubio_sink_close(slice->sink);
+  del_aubio_sink(slice->sink);
+  slice->sink = NULL;
+  return err;
+}
+
+// write the frames of the current block that belong to slice
+static void aubio_slicer_write (aubio_slicer_t *o, aubio_slice_t *slice,
+    uint_t pos, uint_t read)
+{
+  uint_t start = slice->start > pos ? slice->start - pos : 0;
+  uint_t end = slice->end > pos ? MIN(slice->end - pos, read) : 0;
+  if (end <= start) return;
+  fmat_view(&o->view, o->view.data, o->block, start, end - start);
+  aubio_sink_do_multi(slice->sink, &o->view, end - start);
+}
+
+uint_t aubio_slicer_do (aubio_slicer_t *o, const uint_t *starts,
+    const uint_t *ends, const char_t **uris, uint_t n_slices)
+{
+  aubio_slice_t *slices, tmp;
+  uint_t i, j, read = 0, pos = 0, failed = 0;
+  // next slice to open, and first slice not closed yet
+  uint_t next = 0, first = 0;
+  if (!n_slices) return 0;
+  slices = AUBIO_ARRAY(aubio_slice_t, n_slices);
+  if (!slices) return n_slices;
+  // sort the slices by start, usually already in order
+  for (i = 0; i < n_slices; i++) {
+    tmp.start = starts[i];
+    tmp.end = ends[i];
+    tmp.uri = uris[i];
+    tmp.sink = NULL;
+    for (j = i; j > 0 && slices[j - 1].start > tmp.start; j--) {
+      slices[j] = slices[j - 1];
+    }
+    slices[j] = tmp;
+  }
+  if (o->rewind && aubio_source_seek(o->source, 0)) {
+    AUBIO_ERR("slicer: failed rewinding source\n");
+    AUBIO_FREE(slices);
+    return n_slices;
+  }
+  o->rewind = 1;
+
+  do {
+    aubio_source_read_into(o->source, o->block, AUBIO_SLICER_BLOCK, &read);
+    // open the slices starting within this block, or right after it
+    while (next < n_slices && slices[next].start <= pos + read) {
+      if (aubio_slicer_open(o, &slices[next])) {
+        AUBIO_ERR("slicer: failed opening %s\n", slices[next].uri);
+        failed++;
+      }
+      next++;
+    }
+    for (i = first; i < next; i++) {
+      if (!slices[i].sink) continue;
+      aubio_slicer_write(o, &slices[i], pos, read);
+      if (slices[i].end <= pos + read && aubio_slicer_close(&slices[i])) {
+        failed++;
+      }
+    }
+    while (first < next && !slices[first].sink) first++;
+    pos += read;
+    // stop early once all the slices were written
+  } while (read == AUBIO_SLICER_BLOCK && (next < n_slices || first < next));
+
+  // close the slices ending after the end of the source
+  for (i = first; i < next; i++) {
+    if (slices[i].sink && aubio_slicer_close(&slices[i])) failed++;
+  }
+  AUBIO_FREE(slices);
+  return failed;
+}
+
+void del_aubio_slicer (aubio_slicer_t *o)
+{
+  if (o->source) del_aubio_source(o->source);
+  if (o->block) del_fmat(o->block);
+  if (o->view.data) AUBIO_FREE(o->view.data);
+  AUBIO_FREE(o);
+}
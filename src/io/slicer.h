@@ -0,0 +1,105 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_SLICER_H
+#define AUBIO_SLICER_H
+
+/** \file
+
+  Slicing of a sound file at given timestamps
+
+  This object reads a source once, and writes each slice, a range of its
+  frames, to a new file. The slices may overlap; all the slices covering the
+  current block are open at once, each one writing on its own thread, so
+  that slicing a long file is mostly bound by reading and writing the files.
+
+  \example io/test-slicer.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** slicer object */
+typedef struct _aubio_slicer_t aubio_slicer_t;
+
+/** create slicer object
+
+  \param uri path of the file to slice
+  \param samplerate samplerate to read the file at, or 0 to use its own
+  \param hop_size number of frames read by the source at a time
+
+  \return newly created ::aubio_slicer_t, or NULL if the file could not be
+  opened
+
+*/
+aubio_slicer_t *new_aubio_slicer (const char_t *uri, uint_t samplerate,
+    uint_t hop_size);
+
+/** get samplerate of the slices
+
+  \param o slicer object, created by ::new_aubio_slicer
+
+  \return samplerate the source is read at, and the slices are written at
+
+*/
+uint_t aubio_slicer_get_samplerate (const aubio_slicer_t *o);
+
+/** get number of channels of the slices
+
+  \param o slicer object, created by ::new_aubio_slicer
+
+  \return number of channels of the source, and of the slices
+
+*/
+uint_t aubio_slicer_get_channels (const aubio_slicer_t *o);
+
+/** write slices of the source to new files
+
+  \param o slicer object, created by ::new_aubio_slicer
+  \param starts first frame of each slice
+  \param ends frame following the last frame of each slice; a slice ending
+  before its start is written as an empty file
+  \param uris path of the file to write each slice to
+  \param n_slices number of slices
+
+  \return number of slices that could not be written
+
+  The source is read from its start. A slice is written only if it starts
+  before the end of the source, or right at its end, and stops at the end of
+  the source.
+
+*/
+uint_t aubio_slicer_do (aubio_slicer_t *o, const uint_t *starts,
+    const uint_t *ends, const char_t **uris, uint_t n_slices);
+
+/** delete slicer object
+
+  \param o slicer object, created by ::new_aubio_slicer
+
+*/
+void del_aubio_slicer (aubio_slicer_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_SLICER_H */
@@ -22,6 +22,10 @@
 #include "fvec.h"
 #include "fmat.h"
 #include "io/source.h"
+#include "io/source_prefetch_priv.h"
+#include "io/source_io_priv.h"
+#include "io/source_probe_priv.h"
+#include "io/source_capture_priv.h"
 #ifdef HAVE_LIBAV
 #include "io/source_avcodec.h"
 #endif /* HAVE_LIBAV */
@@ -37,6 +41,7 @@
 
 typedef void (*aubio_source_do_t)(aubio_source_t * s, fvec_t * data, uint_t * read);
 typedef void (*aubio_source_do_multi_t)(aubio_source_t * s, fmat_t * data, uint_t * read);
+typedef void (*aubio_source_read_into_t)(aubio_source_t * s, fmat_t * data, uint_t max_frames, uint_t * read);
 typedef uint_t (*aubio_source_get_samplerate_t)(aubio_source_t * s);
 typedef uint_t (*aubio_source_get_channels_t)(aubio_source_t * s);
 typedef uint_t (*aubio_source_get_duration_t)(aubio_source_t * s);
@@ -48,25 +53,356 @@ struct _aubio_source_t {
   void *source;
   aubio_source_do_t s_do;
   aubio_source_do_multi_t s_do_multi;
+  aubio_source_read_into_t s_read_into;   /**< NULL to read hop by hop */
   aubio_source_get_samplerate_t s_get_samplerate;
   aubio_source_get_channels_t s_get_channels;
   aubio_source_get_duration_t s_get_duration;
   aubio_source_seek_t s_seek;
   aubio_source_close_t s_close;
   del_aubio_source_t s_del;
+  uint_t hop_size;
+  aubio_source_io_t *io;        /**< stream read by the source, or NULL */
+  uint_t position;              /**< next frame to read */
+  uint_t end;                   /**< frame to stop reading at, 0 for none */
 };
 
+/** backends reading from files, in the order they are tried */
+typedef enum {
+  aubio_source_backend_avcodec,
+  aubio_source_backend_apple_audio,
+  aubio_source_backend_sndfile,
+  aubio_source_backend_wavread,
+  aubio_source_backend_count,
+  aubio_source_backend_auto = aubio_source_backend_count
+} aubio_source_backend_t;
+
+static const char_t *aubio_source_backend_names[] = {
+  "avcodec", "apple_audio", "sndfile", "wavread"
+};
+
+/* open uri with a backend, returns 1 if it succeeded */
+static uint_t aubio_source_open_backend(aubio_source_t * s,
+    aubio_source_backend_t backend, const char_t * uri, uint_t samplerate,
+    uint_t hop_size) {
+  switch (backend) {
+#ifdef HAVE_LIBAV
+    case aubio_source_backend_avcodec:
+      s->source = (void *)new_aubio_source_avcodec(uri, samplerate, hop_size);
+      if (!s->source) break;
+      s->s_do = (aubio_source_do_t)(aubio_source_avcodec_do);
+      s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_avcodec_do_multi);
+      s->s_read_into = (aubio_source_read_into_t)(aubio_source_avcodec_read_into);
+      s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_avcodec_get_channels);
+      s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_avcodec_get_samplerate);
+      s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_avcodec_get_duration);
+      s->s_seek = (aubio_source_seek_t)(aubio_source_avcodec_seek);
+      s->s_close = (aubio_source_close_t)(aubio_source_avcodec_close);
+      s->s_del = (del_aubio_source_t)(del_aubio_source_avcodec);
+      return 1;
+#endif /* HAVE_LIBAV */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+    case aubio_source_backend_apple_audio:
+      s->source = (void *)new_aubio_source_apple_audio(uri, samplerate, hop_size);
+      if (!s->source) break;
+      s->s_do = (aubio_source_do_t)(aubio_source_apple_audio_do);
+      s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_apple_audio_do_multi);
+      s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_apple_audio_get_channels);
+      s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_apple_audio_get_samplerate);
+      s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_apple_audio_get_duration);
+      s->s_seek = (aubio_source_seek_t)(aubio_source_apple_audio_seek);
+      s->s_close = (aubio_source_close_t)(aubio_source_apple_audio_close);
+      s->s_del = (del_aubio_source_t)(del_aubio_source_apple_audio);
+      return 1;
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+#ifdef HAVE_SNDFILE
+    case aubio_source_backend_sndfile:
+      s->source = (void *)new_aubio_source_sndfile(uri, samplerate, hop_size);
+      if (!s->source) break;
+      s->s_do = (aubio_source_do_t)(aubio_source_sndfile_do);
+      s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_sndfile_do_multi);
+      s->s_read_into = (aubio_source_read_into_t)(aubio_source_sndfile_read_into);
+      s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_sndfile_get_channels);
+      s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_sndfile_get_samplerate);
+      s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_sndfile_get_duration);
+      s->s_seek = (aubio_source_seek_t)(aubio_source_sndfile_seek);
+      s->s_close = (aubio_source_close_t)(aubio_source_sndfile_close);
+      s->s_del = (del_aubio_source_t)(del_aubio_source_sndfile);
+      return 1;
+#endif /* HAVE_SNDFILE */
+#ifdef HAVE_WAVREAD
+    case aubio_source_backend_wavread:
+      s->source = (void *)new_aubio_source_wavread(uri, samplerate, hop_size);
+      if (!s->source) break;
+      s->s_do = (aubio_source_do_t)(aubio_source_wavread_do);
+      s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_wavread_do_multi);
+      s->s_read_into = (aubio_source_read_into_t)(aubio_source_wavread_read_into);
+      s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_wavread_get_channels);
+      s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_wavread_get_samplerate);
+      s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_wavread_get_duration);
+      s->s_seek = (aubio_source_seek_t)(aubio_source_wavread_seek);
+      s->s_close = (aubio_source_close_t)(aubio_source_wavread_close);
+      s->s_del = (del_aubio_source_t)(del_aubio_source_wavread);
+      return 1;
+#endif /* HAVE_WAVREAD */
+    default:
+      break;
+  }
+  return 0;
+}
+
+/* 1 if the backend was built in */
+static uint_t aubio_source_has_backend(aubio_source_backend_t backend) {
+  switch (backend) {
+#ifdef HAVE_LIBAV
+    case aubio_source_backend_avcodec: return 1;
+#endif /* HAVE_LIBAV */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+    case aubio_source_backend_apple_audio: return 1;
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+#ifdef HAVE_SNDFILE
+    case aubio_source_backend_sndfile: return 1;
+#endif /* HAVE_SNDFILE */
+#ifdef HAVE_WAVREAD
+    case aubio_source_backend_wavread: return 1;
+#endif /* HAVE_WAVREAD */
+    default: return 0;
+  }
+}
+
+/* guess the backend able to open uri from the first bytes of the file:
+   integer or float PCM WAV files that need no resampling go to wavread,
+   FLAC and Ogg files to sndfile, anything else to the first backend */
+static aubio_source_backend_t aubio_source_sniff(const char_t * uri,
+    uint_t samplerate) {
+  unsigned char h[48];
+  size_t n;
+  uint_t format, sr;
+  FILE *f = fopen(uri, "rb");
+  if (!f) return aubio_source_backend_auto;
+  n = fread(h, 1, sizeof(h), f);
+  fclose(f);
+  if (n >= 4 && (memcmp(h, "fLaC", 4) == 0 || memcmp(h, "OggS", 4) == 0)) {
+    return aubio_source_backend_sndfile;
+  }
+  // a RIFF WAVE header starting with its fmt chunk
+  if (n < 28 || memcmp(h, "RIFF", 4) != 0 || memcmp(h + 8, "WAVEfmt ", 8)) {
+    return aubio_source_backend_auto;
+  }
+  format = h[20] | h[21] << 8;
+  sr = h[24] | h[25] << 8 | h[26] << 16 | (uint_t)h[27] << 24;
+  // the SubFormat GUID of WAVE_FORMAT_EXTENSIBLE starts with the format
+  if (format == 0xFFFE && n >= 46) {
+    format = h[44] | h[45] << 8;
+  }
+  if ((format == 1 || format == 3) && (samplerate == 0 || samplerate == sr)) {
+    return aubio_source_backend_wavread;
+  }
+  return aubio_source_backend_auto;
+}
+
+/* read the header of uri with a backend, returns 0 if it succeeded */
+static uint_t aubio_source_probe_backend(aubio_source_backend_t backend,
+    const char_t * uri, aubio_source_info_t * info) {
+  switch (backend) {
+#ifdef HAVE_LIBAV
+    case aubio_source_backend_avcodec:
+      return aubio_source_avcodec_probe(uri, info);
+#endif /* HAVE_LIBAV */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+    case aubio_source_backend_apple_audio:
+      return aubio_source_apple_audio_probe(uri, info);
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+#ifdef HAVE_SNDFILE
+    case aubio_source_backend_sndfile:
+      return aubio_source_sndfile_probe(uri, info);
+#endif /* HAVE_SNDFILE */
+#ifdef HAVE_WAVREAD
+    case aubio_source_backend_wavread:
+      return aubio_source_wavread_probe(uri, info);
+#endif /* HAVE_WAVREAD */
+    default:
+      return AUBIO_FAIL;
+  }
+}
+
+uint_t aubio_source_probe(const char_t * uri, aubio_source_info_t * info) {
+  aubio_source_backend_t first;
+  uint_t i;
+  if (!info) {
+    return AUBIO_FAIL;
+  }
+  AUBIO_MEMSET(info, 0, sizeof(aubio_source_info_t));
+  if (!uri) {
+    AUBIO_ERROR("source: Aborted probing null path\n");
+    return AUBIO_FAIL;
+  }
+  first = aubio_source_sniff(uri, 0);
+  if (aubio_source_has_backend(first)
+      && aubio_source_probe_backend(first, uri, info) == AUBIO_OK) {
+    return AUBIO_OK;
+  }
+  for (i = 0; i < aubio_source_backend_count; i++) {
+    if ((aubio_source_backend_t)i == first) continue;
+    if (aubio_source_probe_backend((aubio_source_backend_t)i, uri, info)
+        == AUBIO_OK) {
+      return AUBIO_OK;
+    }
+  }
+  AUBIO_MEMSET(info, 0, sizeof(aubio_source_info_t));
+  AUBIO_ERROR("source: failed probing %s (no built-in source could read"
+      " its header)\n", uri);
+  return AUBIO_FAIL;
+}
+
 aubio_source_t * new_aubio_source(const char_t * uri, uint_t samplerate, uint_t hop_size) {
+  return new_aubio_source_with_backend(uri, samplerate, hop_size, NULL);
+}
+
+aubio_source_t * new_aubio_source_with_backend(const char_t * uri,
+    uint_t samplerate, uint_t hop_size, const char_t * backend) {
+  aubio_source_t * s = AUBIO_NEW(aubio_source_t);
+  aubio_source_backend_t first = aubio_source_backend_auto;
+  uint_t i;
+
+  if (!s) {
+    return NULL;
+  }
+  s->hop_size = hop_size;
+  if (uri && aubio_source_capture_is_device(uri)) {
+    // a device, read as it captures
+    s->source = (void *)new_aubio_source_capture(uri, samplerate, hop_size);
+    if (!s->source) {
+      del_aubio_source(s);
+      return NULL;
+    }
+    s->s_do = (aubio_source_do_t)(aubio_source_capture_do);
+    s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_capture_do_multi);
+    s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_capture_get_channels);
+    s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_capture_get_samplerate);
+    s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_capture_get_duration);
+    s->s_seek = (aubio_source_seek_t)(aubio_source_capture_seek);
+    s->s_close = (aubio_source_close_t)(aubio_source_capture_close);
+    s->s_del = (del_aubio_source_t)(del_aubio_source_capture);
+    return s;
+  }
+  if (backend && *backend && strcmp(backend, "auto") != 0) {
+    // only open uri with the requested backend
+    for (i = 0; i < aubio_source_backend_count; i++) {
+      if (strcmp(backend, aubio_source_backend_names[i]) == 0) break;
+    }
+    if (!aubio_source_has_backend((aubio_source_backend_t)i)) {
+      AUBIO_ERROR("source: failed creating '%s' (unknown backend '%s' or"
+          " not built-in)\n", uri, backend);
+    } else if (aubio_source_open_backend(s, (aubio_source_backend_t)i, uri,
+          samplerate, hop_size)) {
+      return s;
+    }
+    del_aubio_source(s);
+    return NULL;
+  }
+  if (uri) {
+    first = aubio_source_sniff(uri, samplerate);
+  }
+  if (aubio_source_has_backend(first)
+      && aubio_source_open_backend(s, first, uri, samplerate, hop_size)) {
+    return s;
+  }
+  for (i = 0; i < aubio_source_backend_count; i++) {
+    if ((aubio_source_backend_t)i == first) continue;
+    if (aubio_source_open_backend(s, (aubio_source_backend_t)i, uri,
+          samplerate, hop_size)) {
+      return s;
+    }
+  }
+#if !defined(HAVE_WAVREAD) && \
+  !defined(HAVE_LIBAV) && \
+  !defined(HAVE_SOURCE_APPLE_AUDIO) && \
+  !defined(HAVE_SNDFILE)
+  AUBIO_ERROR("source: failed creating with %s at %dHz with hop size %d"
+     " (no source built-in)\n", uri, samplerate, hop_size);
+#endif
+  del_aubio_source(s);
+  return NULL;
+}
+
+aubio_source_t * new_aubio_source_prefetch(const char_t * uri,
+    uint_t samplerate, uint_t hop_size, uint_t queue_frames) {
+  aubio_source_t * s;
+  aubio_source_t * source = new_aubio_source(uri, samplerate, hop_size);
+  if (!source) {
+    return NULL;
+  }
+  s = AUBIO_NEW(aubio_source_t);
+  s->hop_size = hop_size;
+  s->source = (void *)new_aubio_source_prefetch_from(source, uri, hop_size,
+      queue_frames);
+  if (!s->source) {
+    del_aubio_source(source);
+    AUBIO_FREE(s);
+    return NULL;
+  }
+  s->s_do = (aubio_source_do_t)(aubio_source_prefetch_do);
+  s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_prefetch_do_multi);
+  s->s_read_into = (aubio_source_read_into_t)(aubio_source_prefetch_read_into);
+  s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_prefetch_get_channels);
+  s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_prefetch_get_samplerate);
+  s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_prefetch_get_duration);
+  s->s_seek = (aubio_source_seek_t)(aubio_source_prefetch_seek);
+  s->s_close = (aubio_source_close_t)(aubio_source_prefetch_close);
+  s->s_del = (del_aubio_source_t)(del_aubio_source_prefetch);
+  return s;
+}
+
+aubio_source_t * new_aubio_source_raw(const char_t * uri,
+    const char_t * format, uint_t samplerate, uint_t channels,
+    uint_t hop_size) {
+#ifdef HAVE_WAVREAD
   aubio_source_t * s = AUBIO_NEW(aubio_source_t);
-  
   if (!s) {
     return NULL;
   }
+  s->hop_size = hop_size;
+  s->source = (void *)new_aubio_source_wavread_raw(uri, format, samplerate,
+      channels, hop_size);
+  if (!s->source) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
+  s->s_do = (aubio_source_do_t)(aubio_source_wavread_do);
+  s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_wavread_do_multi);
+  s->s_read_into = (aubio_source_read_into_t)(aubio_source_wavread_read_into);
+  s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_wavread_get_channels);
+  s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_wavread_get_samplerate);
+  s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_wavread_get_duration);
+  s->s_seek = (aubio_source_seek_t)(aubio_source_wavread_seek);
+  s->s_close = (aubio_source_close_t)(aubio_source_wavread_close);
+  s->s_del = (del_aubio_source_t)(del_aubio_source_wavread);
+  return s;
+#else
+  AUBIO_ERROR("source: failed creating raw source from %s (native WAV reader"
+      " not built-in)\n", uri);
+  return NULL;
+#endif /* HAVE_WAVREAD */
+}
+
+static aubio_source_t * aubio_source_open_io(aubio_source_io_t * io,
+    uint_t samplerate, uint_t hop_size) {
+  aubio_source_t * s = AUBIO_NEW(aubio_source_t);
+
+  if (!s || !io) {
+    if (io) del_aubio_source_io(io);
+    if (s) AUBIO_FREE(s);
+    return NULL;
+  }
+  // deleted with s
+  s->io = io;
+  s->hop_size = hop_size;
 #ifdef HAVE_LIBAV
-  s->source = (void *)new_aubio_source_avcodec(uri, samplerate, hop_size);
+  s->source = (void *)new_aubio_source_avcodec_io(io, samplerate, hop_size);
   if (s->source) {
     s->s_do = (aubio_source_do_t)(aubio_source_avcodec_do);
     s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_avcodec_do_multi);
+    s->s_read_into = (aubio_source_read_into_t)(aubio_source_avcodec_read_into);
     s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_avcodec_get_channels);
     s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_avcodec_get_samplerate);
     s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_avcodec_get_duration);
@@ -76,25 +412,12 @@ aubio_source_t * new_aubio_source(const char_t * uri, uint_t samplerate, uint_t
     return s;
   }
 #endif /* HAVE_LIBAV */
-#ifdef HAVE_SOURCE_APPLE_AUDIO
-  s->source = (void *)new_aubio_source_apple_audio(uri, samplerate, hop_size);
-  if (s->source) {
-    s->s_do = (aubio_source_do_t)(aubio_source_apple_audio_do);
-    s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_apple_audio_do_multi);
-    s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_apple_audio_get_channels);
-    s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_apple_audio_get_samplerate);
-    s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_apple_audio_get_duration);
-    s->s_seek = (aubio_source_seek_t)(aubio_source_apple_audio_seek);
-    s->s_close = (aubio_source_close_t)(aubio_source_apple_audio_close);
-    s->s_del = (del_aubio_source_t)(del_aubio_source_apple_audio);
-    return s;
-  }
-#endif /* HAVE_SOURCE_APPLE_AUDIO */
 #ifdef HAVE_SNDFILE
-  s->source = (void *)new_aubio_source_sndfile(uri, samplerate, hop_size);
+  s->source = (void *)new_aubio_source_sndfile_io(io, samplerate, hop_size);
   if (s->source) {
     s->s_do = (aubio_source_do_t)(aubio_source_sndfile_do);
     s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_sndfile_do_multi);
+    s->s_read_into = (aubio_source_read_into_t)(aubio_source_sndfile_read_into);
     s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_sndfile_get_channels);
     s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_sndfile_get_samplerate);
     s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_sndfile_get_duration);
@@ -105,10 +428,11 @@ aubio_source_t * new_aubio_source(const char_t * uri, uint_t samplerate, uint_t
   }
 #endif /* HAVE_SNDFILE */
 #ifdef HAVE_WAVREAD
-  s->source = (void *)new_aubio_source_wavread(uri, samplerate, hop_size);
+  s->source = (void *)new_aubio_source_wavread_io(io, samplerate, hop_size);
   if (s->source) {
     s->s_do = (aubio_source_do_t)(aubio_source_wavread_do);
     s->s_do_multi = (aubio_source_do_multi_t)(aubio_source_wavread_do_multi);
+    s->s_read_into = (aubio_source_read_into_t)(aubio_source_wavread_read_into);
     s->s_get_channels = (aubio_source_get_channels_t)(aubio_source_wavread_get_channels);
     s->s_get_samplerate = (aubio_source_get_samplerate_t)(aubio_source_wavread_get_samplerate);
     s->s_get_duration = (aubio_source_get_duration_t)(aubio_source_wavread_get_duration);
@@ -120,21 +444,120 @@ aubio_source_t * new_aubio_source(const char_t * uri, uint_t samplerate, uint_t
 #endif /* HAVE_WAVREAD */
 #if !defined(HAVE_WAVREAD) && \
   !defined(HAVE_LIBAV) && \
-  !defined(HAVE_SOURCE_APPLE_AUDIO) && \
   !defined(HAVE_SNDFILE)
-  AUBIO_ERROR("source: failed creating with %s at %dHz with hop size %d"
-     " (no source built-in)\n", uri, samplerate, hop_size);
+  AUBIO_ERROR("source: failed creating from %s at %dHz with hop size %d"
+     " (no source built-in reads from streams)\n",
+     aubio_source_io_get_name(io), samplerate, hop_size);
 #endif
   del_aubio_source(s);
   return NULL;
 }
 
+aubio_source_t * new_aubio_source_memory(const void * data, uint_t size,
+    uint_t samplerate, uint_t hop_size) {
+  return aubio_source_open_io(new_aubio_source_io_memory(data, size),
+      samplerate, hop_size);
+}
+
+aubio_source_t * new_aubio_source_callbacks(
+    const aubio_source_callbacks_t * callbacks, void * user_data,
+    uint_t samplerate, uint_t hop_size) {
+  return aubio_source_open_io(new_aubio_source_io(callbacks, user_data),
+      samplerate, hop_size);
+}
+
+/* frames left before the end of the range, at most length */
+static uint_t aubio_source_get_remaining(const aubio_source_t * s,
+    uint_t length) {
+  if (!s->end) return length;
+  if (s->position >= s->end) return 0;
+  return MIN(length, s->end - s->position);
+}
+
 void aubio_source_do(aubio_source_t * s, fvec_t * data, uint_t * read) {
-  s->s_do((void *)s->source, data, read);
+  uint_t remaining = aubio_source_get_remaining(s, s->hop_size);
+  AUBIO_STATS_BEGIN ("source");
+  if (remaining) {
+    s->s_do((void *)s->source, data, read);
+  } else {
+    // past the end of the range, nothing more is decoded
+    fvec_zeros(data);
+    *read = 0;
+  }
+  if (*read > remaining) {
+    // silence the frames decoded past the end of the range
+    AUBIO_MEMSET(data->data + remaining, 0,
+        (*read - remaining) * sizeof(smpl_t));
+    *read = remaining;
+  }
+  s->position += *read;
+  AUBIO_STATS_END ();
 }
 
 void aubio_source_do_multi(aubio_source_t * s, fmat_t * data, uint_t * read) {
-  s->s_do_multi((void *)s->source, data, read);
+  uint_t j, remaining = aubio_source_get_remaining(s, s->hop_size);
+  if (remaining) {
+    s->s_do_multi((void *)s->source, data, read);
+  } else {
+    fmat_zeros(data);
+    *read = 0;
+  }
+  if (*read > remaining) {
+    for (j = 0; j < data->height; j++) {
+      AUBIO_MEMSET(data->data[j] + remaining, 0,
+          (*read - remaining) * sizeof(smpl_t));
+    }
+    *read = remaining;
+  }
+  s->position += *read;
+}
+
+/* read length frames, without looking at the end of the range */
+static void aubio_source_read_frames(aubio_source_t * s, fmat_t * data,
+    uint_t length, uint_t * read) {
+  uint_t j, block_read = 0, total = 0;
+  fmat_t block;
+  if (s->s_read_into) {
+    s->s_read_into((void *)s->source, data, length, read);
+    return;
+  }
+  // read hop_size frames at a time, in place
+  block.height = data->height;
+  block.data = AUBIO_ARRAY(smpl_t *, data->height);
+  if (!block.data) {
+    *read = 0;
+    return;
+  }
+  while (total < length) {
+    for (j = 0; j < data->height; j++) {
+      block.data[j] = data->data[j] + total;
+    }
+    block.length = MIN(s->hop_size, length - total);
+    s->s_do_multi((void *)s->source, &block, &block_read);
+    total += block_read;
+    if (block_read < block.length) break;
+  }
+  AUBIO_FREE(block.data);
+  for (j = 0; total < length && j < data->height; j++) {
+    AUBIO_MEMSET(data->data[j] + total, 0, (length - total) * sizeof(smpl_t));
+  }
+  *read = total;
+}
+
+void aubio_source_read_into(aubio_source_t * s, fmat_t * data,
+    uint_t max_frames, uint_t * read) {
+  uint_t j, length = MIN(max_frames, data->length);
+  // only decode up to the end of the range
+  uint_t remaining = aubio_source_get_remaining(s, length);
+  if (remaining) {
+    aubio_source_read_frames(s, data, remaining, read);
+  } else {
+    *read = 0;
+  }
+  for (j = 0; *read < length && j < data->height; j++) {
+    AUBIO_MEMSET(data->data[j] + *read, 0, (length - *read) * sizeof(smpl_t));
+  }
+  s->position += *read;
 }
 
 uint_t aubio_source_close(aubio_source_t * s) {
@@ -145,6 +568,8 @@ void del_aubio_source(aubio_source_t * s) {
   //AUBIO_ASSERT(s);
   if (s && s->s_del && s->source)
     s->s_del((void *)s->source);
+  if (s && s->io)
+    del_aubio_source_io(s->io);
   AUBIO_FREE(s);
 }
 
@@ -161,5 +586,26 @@ uint_t aubio_source_get_duration(aubio_source_t *s) {
 }
 
 uint_t aubio_source_seek (aubio_source_t * s, uint_t seek ) {
-  return s->s_seek((void *)s->source, seek);
+  uint_t err = s->s_seek((void *)s->source, seek);
+  if (err == AUBIO_OK) {
+    s->position = seek;
+  }
+  return err;
+}
+
+uint_t aubio_source_set_range (aubio_source_t * s, uint_t start, uint_t end) {
+  if (end != 0 && end <= start) {
+    AUBIO_ERR("source: can not read from frame %d to frame %d\n", start, end);
+    return AUBIO_FAIL;
+  }
+  // the backends seek with the index of the container when there is one
+  if (aubio_source_seek(s, start) != AUBIO_OK) {
+    return AUBIO_FAIL;
+  }
+  s->end = end;
+  return AUBIO_OK;
+}
+
+uint_t aubio_source_get_position (const aubio_source_t * s) {
+  return s->position;
 }
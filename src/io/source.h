@@ -58,6 +58,13 @@
 
   A simple source to read from 16-bits PCM RIFF encoded WAV files.
 
+  \b \p source_capture : audio devices
+
+  Uris starting with `alsa:` or `coreaudio:` are not read from files, but
+  captured from a device, for instance `alsa:default`, `alsa:hw:1,0`, or
+  `coreaudio:` for the default input of macOS. Each block is returned as soon
+  as it was captured. Such sources have no duration and can not seek.
+
   \example io/test-source.c
 
 */
@@ -86,6 +93,166 @@ typedef struct _aubio_source_t aubio_source_t;
 */
 aubio_source_t * new_aubio_source(const char_t * uri, uint_t samplerate, uint_t hop_size);
 
+/**
+
+  create new ::aubio_source_t with a given backend
+
+  \param uri the file path or uri to read from
+  \param samplerate sampling rate to view the file at
+  \param hop_size the size of the blocks to read from
+  \param backend name of the backend to open `uri` with, one of
+  `"avcodec"`, `"apple_audio"`, `"sndfile"` or `"wavread"`, or `NULL`,
+  `""` or `"auto"` to choose one as ::new_aubio_source does
+
+  \return newly created ::aubio_source_t, or `NULL` if the backend was not
+  built-in or failed opening `uri`
+
+  ::new_aubio_source reads the first bytes of `uri` to try the most likely
+  backend first: PCM and float WAV files go to the native reader, unless
+  they need resampling, FLAC and Ogg files to libsndfile. Other files are
+  tried with each backend in turn, libavcodec first, each printing an error
+  when it fails. Giving the backend skips both steps when the format of the
+  files is already known.
+
+*/
+aubio_source_t * new_aubio_source_with_backend(const char_t * uri,
+    uint_t samplerate, uint_t hop_size, const char_t * backend);
+
+/**
+
+  create new ::aubio_source_t reading ahead on a background thread
+
+  \param uri the file path or uri to read from
+  \param samplerate sampling rate to view the fie at
+  \param hop_size the size of the blocks to read from
+  \param queue_frames number of frames to read ahead, or `0` to read ahead
+  16 blocks of `hop_size` frames
+
+  Creates a source as ::new_aubio_source does, then starts a thread reading
+  from it into a queue of blocks, so that decoding the file overlaps with
+  processing the blocks already read. The returned object is used and
+  deleted like any other ::aubio_source_t.
+
+  Reading ahead stops once the queue is full or the end of the source was
+  reached. ::aubio_source_seek drops the queued blocks. ::aubio_source_close
+  stops the thread; no more frames can be read after it.
+
+*/
+aubio_source_t * new_aubio_source_prefetch(const char_t * uri,
+    uint_t samplerate, uint_t hop_size, uint_t queue_frames);
+
+/**
+
+  create new ::aubio_source_t reading raw interleaved samples
+
+  \param uri the file path to read from, or `-` to read from the standard
+  input, for instance samples piped from another program
+  \param format format of the samples, one of `u8`, `s16`, `s24`, `s32`,
+  `f32` or `f64`, all little-endian
+  \param samplerate sampling rate of the samples, in Hz
+  \param channels number of interleaved channels
+  \param hop_size the size of the blocks to read from
+
+  \return newly created ::aubio_source_t, or `NULL` if `uri` could not be
+  opened or the native WAV reader was not built in
+
+  No resampling is done. ::aubio_source_get_duration is 0 and
+  ::aubio_source_seek fails when reading from a pipe.
+
+  For example, to analyse the samples decoded by ffmpeg:
+
+  \code
+  // ffmpeg -i song.mp3 -f s16le -ac 2 -ar 44100 - | ./program
+  aubio_source_t *s = new_aubio_source_raw ("-", "s16", 44100, 2, 512);
+  \endcode
+
+*/
+aubio_source_t * new_aubio_source_raw(const char_t * uri,
+    const char_t * format, uint_t samplerate, uint_t channels,
+    uint_t hop_size);
+
+/** functions to read the bytes of a media file from, see
+  ::new_aubio_source_callbacks */
+typedef struct {
+  /** read up to `size` bytes to `buf`, returns the number of bytes read, `0`
+    at the end of the stream, or a negative value on error */
+  sint_t (*read) (void *user_data, void *buf, uint_t size);
+  /** move to `offset` bytes from `whence`, one of `SEEK_SET`, `SEEK_CUR` or
+    `SEEK_END`, returns the new position in bytes, or a negative value on
+    error; can be `NULL` if the stream can not seek */
+  long long (*seek) (void *user_data, long long offset, sint_t whence);
+} aubio_source_callbacks_t;
+
+/**
+
+  create new ::aubio_source_t reading from a buffer in memory
+
+  \param data encoded media file, as it would be stored on disk
+  \param size number of bytes in `data`
+  \param samplerate sampling rate to view the file at
+  \param hop_size the size of the blocks to read from
+
+  Creates a source as ::new_aubio_source does, without writing the file to
+  disk first. The buffer is not copied; it should not be modified nor freed
+  until the source is deleted.
+
+  Only the sources built with libavcodec, libsndfile, or the native WAV
+  reader can read from memory.
+
+*/
+aubio_source_t * new_aubio_source_memory(const void * data, uint_t size,
+    uint_t samplerate, uint_t hop_size);
+
+/**
+
+  create new ::aubio_source_t reading through callbacks
+
+  \param callbacks functions to read from, copied by the new source
+  \param user_data pointer passed to the callbacks
+  \param samplerate sampling rate to view the file at
+  \param hop_size the size of the blocks to read from
+
+  Creates a source as ::new_aubio_source does, reading the bytes of the file
+  with `callbacks->read`. The callbacks are called from the thread using the
+  source, until it is deleted.
+
+  Without `callbacks->seek`, ::aubio_source_seek fails, and only the first
+  source able to read from a stream is tried.
+
+*/
+aubio_source_t * new_aubio_source_callbacks(
+    const aubio_source_callbacks_t * callbacks, void * user_data,
+    uint_t samplerate, uint_t hop_size);
+
+/** properties of a media file, see ::aubio_source_probe */
+typedef struct {
+  uint_t samplerate;    /**< sampling rate of the file, in Hz */
+  uint_t channels;      /**< number of channels */
+  uint_t duration;      /**< number of frames in the file, `0` if unknown */
+} aubio_source_info_t;
+
+/**
+
+  read the samplerate, channels and duration of a file
+
+  \param uri the file path or uri to read from
+  \param[out] info properties of `uri`, set to `0` if it could not be read
+
+  \return 0 if sucessful, non-zero if no backend could read `uri`
+
+  Only the header of the file is read: no decoder, resampler nor buffer is
+  created, so that a large collection of files can be listed much faster
+  than by creating a ::aubio_source_t for each of them. The values are the
+  ones ::aubio_source_get_samplerate, ::aubio_source_get_channels and
+  ::aubio_source_get_duration give for a source opened at the samplerate of
+  the file, except for some compressed formats, whose duration libavformat
+  estimates from the header or the first packets.
+
+  The backends are tried in the order ::new_aubio_source uses.
+
+*/
+uint_t aubio_source_probe(const char_t * uri, aubio_source_info_t * info);
+
 /**
 
   read monophonic vector of length hop_size from source object
@@ -114,6 +281,27 @@ void aubio_source_do(aubio_source_t * s, fvec_t * read_to, uint_t * read);
 */
 void aubio_source_do_multi(aubio_source_t * s, fmat_t * read_to, uint_t * read);
 
+/**
+
+  read up to max_frames frames from source object
+
+  \param s source object, created with ::new_aubio_source
+  \param read_to ::fmat_t of data to read to
+  \param max_frames maximum number of frames to read, at most the length of
+  `read_to`
+  \param[out] read upon returns, equals to number of frames actually read
+
+  Same as ::aubio_source_do_multi, without limiting the number of frames to
+  the `hop_size` the source was created with, so that a long block, for
+  instance several seconds, can be read at once, and then processed hop by
+  hop. `read` is less than `max_frames` only at the end of the source.
+
+  This can be mixed with calls to ::aubio_source_do_multi.
+
+*/
+void aubio_source_read_into(aubio_source_t * s, fmat_t * read_to,
+    uint_t max_frames, uint_t * read);
+
 /**
 
   get samplerate of source object
@@ -146,6 +334,42 @@ uint_t aubio_source_get_channels (aubio_source_t * s);
 */
 uint_t aubio_source_seek (aubio_source_t * s, uint_t pos);
 
+/**
+
+  only read a region of the source
+
+  \param s source object, created with ::new_aubio_source
+  \param start first frame to read
+  \param end frame to stop reading at, or `0` to read up to the end of the
+  file
+
+  \return 0 if sucessful, non-zero if `end` is not after `start` or the
+  source could not seek to `start`
+
+  Seeks to `start`, then stops the reads at `end`: the block reaching it is
+  truncated, `read` giving the number of frames before `end` and the rest of
+  the block being silent, and nothing more is decoded afterwards. Analysing
+  a few seconds of a long file then costs about as much as the region.
+
+  ::aubio_source_seek can still move within the file; the reads stop at
+  `end` as long as the range is set. ::aubio_source_get_duration still gives
+  the duration of the whole file.
+
+  Positions are counted at the samplerate of the source.
+
+*/
+uint_t aubio_source_set_range (aubio_source_t * s, uint_t start, uint_t end);
+
+/**
+
+  get the position of the next frame read from source object
+
+  \param s source object, created with ::new_aubio_source
+  \return position, in frames, at the samplerate of the source
+
+*/
+uint_t aubio_source_get_position (const aubio_source_t * s);
+
 /**
 
   get the duration of source object, in frames
@@ -26,6 +26,8 @@
 #include "fmat.h"
 #include "ioutils.h"
 #include "io/source_apple_audio.h"
+#include "io/source.h"
+#include "io/source_probe_priv.h"
 
 // ExtAudioFileRef, AudioStreamBasicDescription, AudioBufferList, ...
 #include <AudioToolbox/AudioToolbox.h>
@@ -35,6 +37,9 @@
 #define RT_BYTE3( a )      ( ((a) >> 16) & 0xff )
 #define RT_BYTE4( a )      ( ((a) >> 24) & 0xff )
 
+/** frames decoded by each call to ExtAudioFileRead, at least block_size */
+#define AUBIO_APPLE_AUDIO_READ_FRAMES 16384
+
 struct _aubio_source_apple_audio_t {
   uint_t channels;
   uint_t samplerate;          //< requested samplerate
@@ -44,11 +49,12 @@ struct _aubio_source_apple_audio_t {
   char_t *path;
 
   ExtAudioFileRef audioFile;
-  AudioBufferList bufferList;
+  AudioBufferList *bufferList;  //< one buffer per channel, pointing to fifo
+  fmat_t *fifo;                 //< decoded frames, one row per channel
+  uint_t fifo_start;            //< first frame of fifo not read yet
+  uint_t fifo_end;              //< number of frames decoded in fifo
 };
 
-extern int createAudioBufferList(AudioBufferList *bufferList, int channels, int max_source_samples);
-extern void freeAudioBufferList(AudioBufferList *bufferList);
 extern CFURLRef createURLFromPath(const char * path);
 char_t *getPrintableOSStatusError(char_t *str, OSStatus error);
 
@@ -145,11 +151,15 @@ uint_t aubio_source_apple_audio_open (aubio_source_apple_audio_t *s, const char_
   memset(&clientFormat, 0, sizeof(AudioStreamBasicDescription));
   clientFormat.mFormatID         = kAudioFormatLinearPCM;
   clientFormat.mSampleRate       = (Float64)(s->samplerate);
-  clientFormat.mFormatFlags      = kAudioFormatFlagIsFloat;
+  // native smpl_t, one buffer per channel, copied as is to fvec and fmat
+  clientFormat.mFormatFlags      = kAudioFormatFlagIsFloat
+    | kAudioFormatFlagsNativeEndian | kAudioFormatFlagIsPacked
+    | kAudioFormatFlagIsNonInterleaved;
   clientFormat.mChannelsPerFrame = s->channels;
   clientFormat.mBitsPerChannel   = sizeof(smpl_t) * 8;
   clientFormat.mFramesPerPacket  = 1;
-  clientFormat.mBytesPerFrame    = clientFormat.mBitsPerChannel * clientFormat.mChannelsPerFrame / 8;
+  // with non-interleaved formats, sizes are those of a single channel
+  clientFormat.mBytesPerFrame    = sizeof(smpl_t);
   clientFormat.mBytesPerPacket   = clientFormat.mFramesPerPacket * clientFormat.mBytesPerFrame;
 
   // set the client format description
@@ -186,73 +196,120 @@ uint_t aubio_source_apple_audio_open (aubio_source_apple_audio_t *s, const char_
         s->path, s->source_samplerate, s->samplerate);
   }
 
-  // allocate the AudioBufferList
-  freeAudioBufferList(&s->bufferList);
-  if (createAudioBufferList(&s->bufferList, s->channels, s->block_size * s->channels)) {
+  // allocate the fifo and the AudioBufferList pointing to its rows
+  if (s->fifo) del_fmat(s->fifo);
+  if (s->bufferList) AUBIO_FREE(s->bufferList);
+  s->fifo = new_fmat(s->channels, MAX(s->block_size,
+        AUBIO_APPLE_AUDIO_READ_FRAMES));
+  s->bufferList = (AudioBufferList *)AUBIO_ARRAY(char_t,
+      sizeof(AudioBufferList) + (s->channels - 1) * sizeof(AudioBuffer));
+  if (!s->fifo || !s->bufferList) {
     AUBIO_ERR("source_apple_audio: failed creating bufferList\n");
+    err = -1;
     goto beach;
   }
+  s->bufferList->mNumberBuffers = s->channels;
+  s->fifo_start = s->fifo_end = 0;
 
 beach:
   return err;
 }
 
-static UInt32 aubio_source_apple_audio_read_frame(aubio_source_apple_audio_t *s)
+/* decode the next frames into the fifo, returns the number of frames */
+static uint_t aubio_source_apple_audio_fill(aubio_source_apple_audio_t *s)
 {
-  UInt32 loadedPackets = s->block_size;
-  OSStatus err = ExtAudioFileRead(s->audioFile, &loadedPackets, &s->bufferList);
+  UInt32 c, loadedPackets = s->fifo->length;
+  OSStatus err;
+  // reset the sizes, ExtAudioFileRead sets them to the bytes it wrote
+  for (c = 0; c < s->channels; c++) {
+    s->bufferList->mBuffers[c].mNumberChannels = 1;
+    s->bufferList->mBuffers[c].mData = s->fifo->data[c];
+    s->bufferList->mBuffers[c].mDataByteSize =
+      s->fifo->length * sizeof(smpl_t);
+  }
+  err = ExtAudioFileRead(s->audioFile, &loadedPackets, s->bufferList);
   if (err) {
     char_t errorstr[20];
     AUBIO_ERROR("source_apple_audio: error while reading %s "
         "with ExtAudioFileRead (%s)\n", s->path,
         getPrintableOSStatusError(errorstr, err));
+    loadedPackets = 0;
   }
+  s->fifo_start = 0;
+  s->fifo_end = loadedPackets;
   return loadedPackets;
 }
 
+/* copy up to length frames of the first n_rows channels from the fifo to
+   rows, returns the number of frames copied, less than length at the end of
+   the file */
+static uint_t aubio_source_apple_audio_read_rows(aubio_source_apple_audio_t *s,
+    smpl_t **rows, uint_t n_rows, uint_t length)
+{
+  uint_t c, n, total = 0;
+  while (total < length) {
+    if (s->fifo_start == s->fifo_end
+        && aubio_source_apple_audio_fill(s) == 0) {
+      break;
+    }
+    n = MIN(length - total, s->fifo_end - s->fifo_start);
+    for (c = 0; c < n_rows; c++) {
+      memcpy(rows[c] + total, s->fifo->data[c] + s->fifo_start,
+          n * sizeof(smpl_t));
+    }
+    s->fifo_start += n;
+    total += n;
+  }
+  return total;
+}
+
 void aubio_source_apple_audio_do(aubio_source_apple_audio_t *s, fvec_t * read_to,
     uint_t * read) {
-  uint_t c, v;
-  UInt32 loadedPackets = aubio_source_apple_audio_read_frame(s);
+  uint_t c, v, n, total = 0;
   uint_t length = aubio_source_validate_input_length("source_apple_audio",
       s->path, s->block_size, read_to->length);
-  smpl_t *data = (smpl_t*)s->bufferList.mBuffers[0].mData;
+  smpl_t *out = read_to->data;
 
-  length = MIN(loadedPackets, length);
-
-  for (v = 0; v < length; v++) {
-    read_to->data[v] = 0.;
-    for (c = 0; c < s->channels; c++) {
-      read_to->data[v] += data[ v * s->channels + c];
+  // average the channels, in chunks of the fifo
+  while (total < length) {
+    if (s->fifo_start == s->fifo_end
+        && aubio_source_apple_audio_fill(s) == 0) {
+      break;
+    }
+    n = MIN(length - total, s->fifo_end - s->fifo_start);
+    memcpy(out + total, s->fifo->data[0] + s->fifo_start, n * sizeof(smpl_t));
+    for (c = 1; c < s->channels; c++) {
+      const smpl_t *in = s->fifo->data[c] + s->fifo_start;
+      for (v = 0; v < n; v++) {
+        out[total + v] += in[v];
+      }
     }
-    read_to->data[v] /= (smpl_t)s->channels;
+    if (s->channels > 1) {
+      for (v = 0; v < n; v++) {
+        out[total + v] /= (smpl_t)s->channels;
+      }
+    }
+    s->fifo_start += n;
+    total += n;
   }
   // short read, fill with zeros
-  aubio_source_pad_output(read_to, length);
+  aubio_source_pad_output(read_to, total);
 
-  *read = (uint_t)length;
+  *read = total;
 }
 
 void aubio_source_apple_audio_do_multi(aubio_source_apple_audio_t *s, fmat_t * read_to, uint_t * read) {
-  uint_t c, v;
   uint_t length = aubio_source_validate_input_length("source_apple_audio",
       s->path, s->block_size, read_to->length);
   uint_t channels = aubio_source_validate_input_channels("source_apple_audio",
       s->path, s->channels, read_to->height);
-  UInt32 loadedPackets = aubio_source_apple_audio_read_frame(s);
-  smpl_t *data = (smpl_t*)s->bufferList.mBuffers[0].mData;
 
-  length = MIN(loadedPackets, length);
+  length = aubio_source_apple_audio_read_rows(s, read_to->data, channels,
+      length);
 
-  for (v = 0; v < length; v++) {
-    for (c = 0; c < channels; c++) {
-      read_to->data[c][v] = data[ v * s->channels + c];
-    }
-  }
+  aubio_source_pad_multi_output(read_to, s->channels, length);
 
-  aubio_source_pad_multi_output(read_to, s->channels, (uint_t)length);
-
-  *read = (uint_t)length;
+  *read = length;
 }
 
 uint_t aubio_source_apple_audio_close (aubio_source_apple_audio_t *s)
@@ -275,7 +332,8 @@ void del_aubio_source_apple_audio(aubio_source_apple_audio_t * s){
   AUBIO_ASSERT(s);
   aubio_source_apple_audio_close (s);
   if (s->path) AUBIO_FREE(s->path);
-  freeAudioBufferList(&s->bufferList);
+  if (s->bufferList) AUBIO_FREE(s->bufferList);
+  if (s->fifo) del_fmat(s->fifo);
   AUBIO_FREE(s);
 }
 
@@ -300,9 +358,8 @@ uint_t aubio_source_apple_audio_seek (aubio_source_apple_audio_t * s, uint_t pos
     err = -1;
     goto beach;
   }
-  // after a short read, the bufferList size needs to resetted to prepare for a full read
-  AudioBufferList *bufferList = &s->bufferList;
-  bufferList->mBuffers[0].mDataByteSize = s->block_size * s->channels * sizeof (smpl_t);
+  // drop the frames decoded before the seek
+  s->fifo_start = s->fifo_end = 0;
   // do the actual seek
   err = ExtAudioFileSeek(s->audioFile, resampled_pos);
   if (err) {
@@ -353,4 +410,34 @@ uint_t aubio_source_apple_audio_get_duration(const aubio_source_apple_audio_t *
   return (uint_t)fileLengthFrames;
 }
 
+
+uint_t aubio_source_apple_audio_probe (const char_t * path,
+    aubio_source_info_t * info)
+{
+  ExtAudioFileRef audioFile;
+  AudioStreamBasicDescription fileFormat;
+  SInt64 fileLengthFrames = 0;
+  UInt32 propSize = sizeof(fileFormat);
+  OSStatus err;
+  CFURLRef fileURL = createURLFromPath(path);
+  err = ExtAudioFileOpenURL(fileURL, &audioFile);
+  CFRelease(fileURL);
+  if (err) return AUBIO_FAIL;
+  // without a client format, no converter is created
+  memset(&fileFormat, 0, sizeof(AudioStreamBasicDescription));
+  err = ExtAudioFileGetProperty(audioFile,
+      kExtAudioFileProperty_FileDataFormat, &propSize, &fileFormat);
+  if (!err) {
+    propSize = sizeof(fileLengthFrames);
+    err = ExtAudioFileGetProperty(audioFile,
+        kExtAudioFileProperty_FileLengthFrames, &propSize, &fileLengthFrames);
+  }
+  ExtAudioFileDispose(audioFile);
+  if (err || fileFormat.mSampleRate <= 0) return AUBIO_FAIL;
+  info->samplerate = fileFormat.mSampleRate;
+  info->channels = fileFormat.mChannelsPerFrame;
+  info->duration = (uint_t)fileLengthFrames;
+  return AUBIO_OK;
+}
+
 #endif /* HAVE_SOURCE_APPLE_AUDIO */
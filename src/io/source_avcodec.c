@@ -26,6 +26,7 @@
 #include <libavformat/avformat.h>
 #include <libswresample/swresample.h>
 #include <libavutil/opt.h>
+#include <libavutil/time.h>
 
 // determine whether we use libavformat from ffmpeg or from libav
 #define FFMPEG_LIBAVFORMAT (LIBAVFORMAT_VERSION_MICRO > 99 )
@@ -52,6 +53,11 @@
 #define av_packet_unref av_free_packet
 #endif
 
+// avio_context_free was added in libavformat 57.80.100
+#if LIBAVFORMAT_VERSION_INT < AV_VERSION_INT(57,80,100)
+#define avio_context_free av_freep
+#endif
+
 #if LIBAVUTIL_VERSION_INT < AV_VERSION_INT(57,28,100)
 //#warning "libavutil < 57.28.100 is deprecated"
 #else
@@ -63,21 +69,44 @@
 #include "fmat.h"
 #include "ioutils.h"
 #include "source_avcodec.h"
-
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(56, 56, 0)
-#define AUBIO_AVCODEC_MAX_BUFFER_SIZE FF_MIN_BUFFER_SIZE
-#else
-#if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(60, 40, 100)
-#define AUBIO_AVCODEC_MAX_BUFFER_SIZE AV_INPUT_BUFFER_MIN_SIZE
-#else
-#define AUBIO_AVCODEC_MAX_BUFFER_SIZE 16384
-#endif
-#endif
+#include "source.h"
+#include "source_io_priv.h"
+#include "source_probe_priv.h"
 
 #if LIBAVCODEC_VERSION_MAJOR >= 59
 #define FF_API_LAVF_AVCTX 1
 #endif
 
+#include "io/lazy_avcodec_priv.h"
+
+/** number of frames, at the samplerate of the file, between two entries of
+  the seek index */
+#define AUBIO_AVCODEC_INDEX_SPACING 4096
+
+/** size of the buffer used to read from streams */
+#define AUBIO_AVCODEC_IO_BUFSIZE 32768
+
+/** version of the seek index files read and written by
+  aubio_source_avcodec_build_seek_index */
+#define AUBIO_AVCODEC_INDEX_VERSION 1
+
+/** longest time, in microseconds, to wait for a stream to open */
+#define AUBIO_AVCODEC_OPEN_TIMEOUT 10000000
+
+/** bytes probed to find the format of a live stream */
+#define AUBIO_AVCODEC_STREAM_PROBESIZE 4096
+
+// settings of new_aubio_source_avcodec_stream
+typedef struct {
+  uint_t max_delay;       // longest buffering, in milliseconds
+  uint_t timeout;         // longest wait for a packet, in milliseconds
+} aubio_source_avcodec_live_t;
+
+typedef struct {
+  int64_t pts;            // timestamp of the packet, in the stream time base
+  int64_t pos;            // byte offset of the packet in the file
+} aubio_source_avcodec_index_t;
+
 struct _aubio_source_avcodec_t {
   uint_t hop_size;
   uint_t samplerate;
@@ -89,6 +118,7 @@ struct _aubio_source_avcodec_t {
   uint_t input_channels;
 
   // avcodec stuff
+  AVIOContext *avio;      // context reading from a stream, or NULL
   AVFormatContext *avFormatCtx;
   AVCodecContext *avCodecCtx;
   AVFrame *avFrame;
@@ -98,18 +128,29 @@ struct _aubio_source_avcodec_t {
   AVPacket avPacket;
 #endif
   SwrContext *avr;
-  smpl_t *output;
-  uint_t read_samples;
-  uint_t read_index;
+  uint_t filter_size;     // length of the resampling filter, 0 for default
+  uint8_t **out_planes;   // one output pointer per channel, for swr_convert
+  fmat_t *scratch;        // planes for channels that can not be written to
+                          // the output directly
   sint_t selected_stream;
-  uint_t eof;
+  uint_t eof;             // no more frames from the decoder
+  uint_t draining;        // no more packets to send to the decoder
+  uint_t flushed;         // no more samples in the resampler
+
+  aubio_source_avcodec_index_t *index;  // positions of some of the packets
+  uint_t index_size;
+  uint_t seek_skip;       // frames to drop from the decoder after seeking
+
+  int64_t timeout;        // longest wait for each read, in microseconds
+  int64_t deadline;       // time at which reads are interrupted, or 0
+  uint_t stalled;         // the last read was interrupted
+  uint_t underruns;       // hops padded while waiting for the stream
 };
 
 // create or re-create the context when _do or _do_multi is called
 void aubio_source_avcodec_reset_resampler(aubio_source_avcodec_t * s);
-// actually read a frame
-void aubio_source_avcodec_readframe(aubio_source_avcodec_t *s,
-    uint_t * read_samples);
+// actually read a frame, returns 1 if avFrame holds a new frame
+uint_t aubio_source_avcodec_readframe(aubio_source_avcodec_t *s);
 
 uint_t aubio_source_avcodec_has_network_url(aubio_source_avcodec_t *s);
 
@@ -126,13 +167,67 @@ uint_t aubio_source_avcodec_has_network_url(aubio_source_avcodec_t *s) {
 }
 
 
+static int aubio_source_avcodec_io_read (void *io, uint8_t *buf, int size)
+{
+  size_t read = aubio_source_io_read((aubio_source_io_t *)io, buf, size);
+  return read > 0 ? (int)read : AVERROR_EOF;
+}
+
+static int64_t aubio_source_avcodec_io_seek (void *io, int64_t offset,
+    int whence)
+{
+  if (whence & AVSEEK_SIZE) {
+    return aubio_source_io_get_size((aubio_source_io_t *)io);
+  }
+  if (aubio_source_io_seek((aubio_source_io_t *)io, offset,
+        whence & ~AVSEEK_FORCE) != 0) {
+    return -1;
+  }
+  return aubio_source_io_tell((aubio_source_io_t *)io);
+}
+
+// called by libavformat while blocking, a non-zero value aborts the call
+static int aubio_source_avcodec_interrupt (void *data)
+{
+  aubio_source_avcodec_t *s = (aubio_source_avcodec_t *)data;
+  return s->deadline != 0 && av_gettime_relative() > s->deadline;
+}
+
+static aubio_source_avcodec_t * aubio_source_avcodec_open (const char_t * path,
+    aubio_source_io_t * io, const aubio_source_avcodec_live_t * live,
+    uint_t samplerate, uint_t hop_size);
+
 aubio_source_avcodec_t * new_aubio_source_avcodec(const char_t * path,
     uint_t samplerate, uint_t hop_size) {
+  return aubio_source_avcodec_open(path, NULL, NULL, samplerate, hop_size);
+}
+
+aubio_source_avcodec_t * new_aubio_source_avcodec_io (aubio_source_io_t * io,
+    uint_t samplerate, uint_t hop_size) {
+  return aubio_source_avcodec_open(aubio_source_io_get_name(io), io, NULL,
+      samplerate, hop_size);
+}
+
+aubio_source_avcodec_t * new_aubio_source_avcodec_stream (const char_t * uri,
+    uint_t samplerate, uint_t hop_size, uint_t max_delay, uint_t timeout) {
+  aubio_source_avcodec_live_t live;
+  live.max_delay = max_delay;
+  live.timeout = timeout;
+  return aubio_source_avcodec_open(uri, NULL, &live, samplerate, hop_size);
+}
+
+static aubio_source_avcodec_t * aubio_source_avcodec_open (const char_t * path,
+    aubio_source_io_t * io, const aubio_source_avcodec_live_t * live,
+    uint_t samplerate, uint_t hop_size) {
   aubio_source_avcodec_t * s = AUBIO_NEW(aubio_source_avcodec_t);
   
   if (!s) {
     return NULL;
   }
+  if (aubio_avcodec_load()) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
   AVFormatContext *avFormatCtx = NULL;
   AVCodecContext *avCodecCtx = NULL;
   AVFrame *avFrame = NULL;
@@ -173,25 +268,76 @@ aubio_source_avcodec_t * new_aubio_source_avcodec(const char_t * path,
   av_register_all();
 #endif
 
-  if (aubio_source_avcodec_has_network_url(s)) {
+  if (!io && aubio_source_avcodec_has_network_url(s)) {
     avformat_network_init();
   }
 
   // try opening the file and get some info about it
   avFormatCtx = NULL;
-  if ( (err = avformat_open_input(&avFormatCtx, s->path, NULL, NULL) ) < 0 ) {
+  if (io) {
+    unsigned char *buffer;
+    if (aubio_source_io_seek(io, 0, SEEK_SET) != 0) {
+      AUBIO_ERR("source_avcodec: Failed rewinding %s\n", s->path);
+      goto beach;
+    }
+    buffer = (unsigned char *)av_malloc(AUBIO_AVCODEC_IO_BUFSIZE);
+    if (buffer) {
+      s->avio = avio_alloc_context(buffer, AUBIO_AVCODEC_IO_BUFSIZE, 0, io,
+          aubio_source_avcodec_io_read, NULL, aubio_source_avcodec_io_seek);
+    }
+    if (!s->avio) {
+      if (buffer) av_free(buffer);
+      AUBIO_ERR("source_avcodec: Failed allocating buffer for %s\n",
+          s->path);
+      goto beach;
+    }
+    avFormatCtx = avformat_alloc_context();
+    if (!avFormatCtx) {
+      AUBIO_ERR("source_avcodec: Failed allocating context for %s\n",
+          s->path);
+      goto beach;
+    }
+    // the context does not free pb, see aubio_source_avcodec_close
+    avFormatCtx->pb = s->avio;
+    avFormatCtx->flags |= AVFMT_FLAG_CUSTOM_IO;
+  }
+  if (live) {
+    // probe as little of the stream as possible, and do not buffer more
+    // packets than max_delay
+    avFormatCtx = avformat_alloc_context();
+    if (!avFormatCtx) {
+      AUBIO_ERR("source_avcodec: Failed allocating context for %s\n",
+          s->path);
+      goto beach;
+    }
+    avFormatCtx->interrupt_callback.callback = aubio_source_avcodec_interrupt;
+    avFormatCtx->interrupt_callback.opaque = s;
+    avFormatCtx->flags |= AVFMT_FLAG_NOBUFFER;
+    av_opt_set_int(avFormatCtx, "probesize", AUBIO_AVCODEC_STREAM_PROBESIZE,
+        0);
+    av_opt_set_int(avFormatCtx, "analyzeduration",
+        (int64_t)live->max_delay * 1000, 0);
+    av_opt_set_int(avFormatCtx, "max_delay", (int64_t)live->max_delay * 1000,
+        0);
+    s->timeout = (int64_t)live->timeout * 1000;
+    s->deadline = av_gettime_relative() + AUBIO_AVCODEC_OPEN_TIMEOUT;
+  }
+  if ( (err = avformat_open_input(&avFormatCtx, io ? "" : s->path, NULL,
+          NULL) ) < 0 ) {
     char errorstr[256];
     av_strerror (err, errorstr, sizeof(errorstr));
     AUBIO_ERR("source_avcodec: Failed opening %s (%s)\n", s->path, errorstr);
     goto beach;
   }
 
-  // try to make sure max_analyze_duration is big enough for most songs
+  if (!live) {
+    // try to make sure max_analyze_duration is big enough for most songs
 #if FFMPEG_LIBAVFORMAT_MAX_DUR2
-  avFormatCtx->max_analyze_duration2 *= 100;
+    avFormatCtx->max_analyze_duration2 *= 100;
 #else
-  avFormatCtx->max_analyze_duration *= 100;
+    avFormatCtx->max_analyze_duration *= 100;
 #endif
+  }
 
   // retrieve stream information
   if ( (err = avformat_find_stream_info(avFormatCtx, NULL)) < 0 ) {
@@ -267,6 +413,17 @@ aubio_source_avcodec_t * new_aubio_source_avcodec(const char_t * path,
 #endif
 #endif
 
+#if FF_API_LAVF_AVCTX
+  // let the decoder use as many threads as there are cores; frame threads
+  // each hold back a frame, so live streams only use slice threads
+  avCodecCtx->thread_count = 0;
+  avCodecCtx->thread_type = live ? FF_THREAD_SLICE
+    : FF_THREAD_FRAME | FF_THREAD_SLICE;
+#endif
+  if (live) {
+    avCodecCtx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+  }
+
   if ( ( err = avcodec_open2(avCodecCtx, codec, NULL) ) < 0) {
     char errorstr[256];
     av_strerror (err, errorstr, sizeof(errorstr));
@@ -310,12 +467,15 @@ aubio_source_avcodec_t * new_aubio_source_avcodec(const char_t * path,
   }
 #endif
 
-  /* allocate output for avr */
-  s->output = (smpl_t *)av_malloc(AUBIO_AVCODEC_MAX_BUFFER_SIZE
-      * sizeof(smpl_t));
-
-  s->read_samples = 0;
-  s->read_index = 0;
+  /* the resampler writes planar samples, straight to the caller's vectors
+     when the number of channels allows it */
+  s->out_planes = AUBIO_ARRAY(uint8_t *, s->input_channels);
+  s->scratch = new_fmat(s->input_channels, s->hop_size);
+  if (!s->out_planes || !s->scratch) {
+    AUBIO_ERR("source_avcodec: Could not allocate buffers for (%s)\n",
+        s->path);
+    goto beach;
+  }
 
   s->avFormatCtx = avFormatCtx;
   s->avCodecCtx = avCodecCtx;
@@ -329,6 +489,7 @@ aubio_source_avcodec_t * new_aubio_source_avcodec(const char_t * path,
   if (s->avr == NULL) goto beach;
 
   s->eof = 0;
+  s->deadline = 0;
 
   //av_log_set_level(AV_LOG_QUIET);
 
@@ -366,26 +527,27 @@ void aubio_source_avcodec_reset_resampler(aubio_source_avcodec_t * s)
     av_opt_set_int(avr, "out_sample_rate",    s->samplerate,             0);
     av_opt_set_int(avr, "in_sample_fmt",      s->avCodecCtx->sample_fmt, 0);
 #if HAVE_AUBIO_DOUBLE
-    av_opt_set_int(avr, "out_sample_fmt",     AV_SAMPLE_FMT_DBL,         0);
+    av_opt_set_int(avr, "out_sample_fmt",     AV_SAMPLE_FMT_DBLP,        0);
 #else
-    av_opt_set_int(avr, "out_sample_fmt",     AV_SAMPLE_FMT_FLT,         0);
+    av_opt_set_int(avr, "out_sample_fmt",     AV_SAMPLE_FMT_FLTP,        0);
 #endif
-    // TODO: use planar?
-    //av_opt_set_int(avr, "out_sample_fmt",     AV_SAMPLE_FMT_FLTP,      0);
+    if (s->filter_size) {
+      av_opt_set_int(avr, "filter_size",      s->filter_size,            0);
+    }
     if ( ( err = swr_init(avr) ) < 0)
     {
       char errorstr[256];
       av_strerror (err, errorstr, sizeof(errorstr));
       AUBIO_ERR("source_avcodec: Could not open resampling context"
          " for %s (%s)\n", s->path, errorstr);
+      swr_free(&avr);
       return;
     }
     s->avr = avr;
   }
 }
 
-void aubio_source_avcodec_readframe(aubio_source_avcodec_t *s,
-    uint_t * read_samples)
+uint_t aubio_source_avcodec_readframe(aubio_source_avcodec_t *s)
 {
   AVFormatContext *avFormatCtx = s->avFormatCtx;
   AVCodecContext *avCodecCtx = s->avCodecCtx;
@@ -395,119 +557,171 @@ void aubio_source_avcodec_readframe(aubio_source_avcodec_t *s,
 #else
   AVPacket *avPacket = &s->avPacket;
 #endif
-  SwrContext *avr = s->avr;
-  int got_frame = 0;
-  int in_samples = avFrame->nb_samples;
-#ifdef LIBAVUTIL_HAS_CH_LAYOUT
-  int max_out_samples = AUBIO_AVCODEC_MAX_BUFFER_SIZE / avCodecCtx->ch_layout.nb_channels;
-#else
-  int max_out_samples = AUBIO_AVCODEC_MAX_BUFFER_SIZE / avCodecCtx->channels;
-#endif
-  int out_samples = 0;
-  smpl_t *output = s->output;
+  int err;
 #ifndef FF_API_LAVF_AVCTX
+  int got_frame = 0;
   int len = 0;
-#else
-  int ret = 0;
 #endif
 #ifndef FF_API_INIT_PACKET
   av_init_packet (avPacket);
 #endif
-  *read_samples = 0;
 
-  do
-  {
-    int err = av_read_frame (avFormatCtx, avPacket);
+  while (!s->eof) {
+#if FF_API_LAVF_AVCTX
+    err = avcodec_receive_frame(avCodecCtx, avFrame);
     if (err == AVERROR_EOF) {
+      // the decoder has been fully flushed
       s->eof = 1;
-      goto beach;
-    }
-    if (err != 0) {
-      char errorstr[256];
-      av_strerror (err, errorstr, sizeof(errorstr));
-      AUBIO_ERR("source_avcodec: could not read frame in %s (%s)\n",
-          s->path, errorstr);
-      s->eof = 1;
-      goto beach;
-    }
-  } while (avPacket->stream_index != s->selected_stream);
-
-#if FF_API_LAVF_AVCTX
-  ret = avcodec_send_packet(avCodecCtx, avPacket);
-  if (ret < 0 && ret != AVERROR_EOF) {
-    AUBIO_ERR("source_avcodec: error when sending packet for %s\n", s->path);
-    goto beach;
-  }
-  ret = avcodec_receive_frame(avCodecCtx, avFrame);
-  if (ret >= 0) {
-    got_frame = 1;
-  }
-  if (ret < 0) {
-    if (ret == AVERROR(EAGAIN)) {
-      //AUBIO_WRN("source_avcodec: output is not available right now - "
-      //    "user must try to send new input\n");
-      goto beach;
-    } else if (ret == AVERROR_EOF) {
-      AUBIO_WRN("source_avcodec: the decoder has been fully flushed, "
-          "and there will be no more output frames\n");
-    } else {
-      AUBIO_ERR("source_avcodec: decoding errors on %s\n", s->path);
-      goto beach;
+      break;
+    } else if (err < 0) {
+      if (err != AVERROR(EAGAIN)) {
+        AUBIO_ERR("source_avcodec: decoding errors on %s\n", s->path);
+      }
+      if (s->draining) {
+        // no more packets to send
+        s->eof = 1;
+        break;
+      }
+      // the decoder needs more input
+      for (;;) {
+        err = av_read_frame (avFormatCtx, avPacket);
+        if (err < 0 || avPacket->stream_index == s->selected_stream) break;
+        av_packet_unref(avPacket);
+      }
+      if (err == AVERROR_EXIT && s->timeout) {
+        // no packet came in time, try again on the next read
+        s->stalled = 1;
+        return 0;
+      }
+      if (err < 0) {
+        if (err != AVERROR_EOF) {
+          char errorstr[256];
+          av_strerror (err, errorstr, sizeof(errorstr));
+          AUBIO_ERR("source_avcodec: could not read frame in %s (%s)\n",
+              s->path, errorstr);
+        }
+        // enter draining mode to get the frames still in the decoder
+        avcodec_send_packet(avCodecCtx, NULL);
+        s->draining = 1;
+        continue;
+      }
+      err = avcodec_send_packet(avCodecCtx, avPacket);
+      av_packet_unref(avPacket);
+      if (err < 0 && err != AVERROR_EOF) {
+        AUBIO_ERR("source_avcodec: error when sending packet for %s\n",
+            s->path);
+      }
+      continue;
     }
-  }
 #else
-  len = avcodec_decode_audio4(avCodecCtx, avFrame, &got_frame, avPacket);
+    do
+    {
+      err = av_read_frame (avFormatCtx, avPacket);
+      if (err == AVERROR_EOF) {
+        s->eof = 1;
+        return 0;
+      }
+      if (err != 0) {
+        char errorstr[256];
+        av_strerror (err, errorstr, sizeof(errorstr));
+        AUBIO_ERR("source_avcodec: could not read frame in %s (%s)\n",
+            s->path, errorstr);
+        s->eof = 1;
+        return 0;
+      }
+    } while (avPacket->stream_index != s->selected_stream);
 
-  if (len < 0) {
-    AUBIO_ERR("source_avcodec: error while decoding %s\n", s->path);
-    goto beach;
-  }
+    len = avcodec_decode_audio4(avCodecCtx, avFrame, &got_frame, avPacket);
+    av_packet_unref(avPacket);
+
+    if (len < 0) {
+      AUBIO_ERR("source_avcodec: error while decoding %s\n", s->path);
+      continue;
+    }
+    if (got_frame == 0) {
+      continue;
+    }
 #endif
-  if (got_frame == 0) {
-    AUBIO_WRN("source_avcodec: did not get a frame when reading %s\n",
-        s->path);
-    goto beach;
-  }
 
 #if LIBAVUTIL_VERSION_MAJOR > 52
 #ifdef LIBAVUTIL_HAS_CH_LAYOUT
-  int frame_channels = avFrame->ch_layout.nb_channels;
+    int frame_channels = avFrame->ch_layout.nb_channels;
 #else
-  int frame_channels = avFrame->channels;
+    int frame_channels = avFrame->channels;
 #endif
-  if (frame_channels != (sint_t)s->input_channels) {
-    AUBIO_WRN ("source_avcodec: trying to read from %d channel(s),"
-        "but configured for %d; is '%s' corrupt?\n",
-        frame_channels, s->input_channels, s->path);
-    goto beach;
-  }
+    if (frame_channels != (sint_t)s->input_channels) {
+      AUBIO_WRN ("source_avcodec: trying to read from %d channel(s),"
+          "but configured for %d; is '%s' corrupt?\n",
+          frame_channels, s->input_channels, s->path);
+      continue;
+    }
 #else
 #warning "avutil < 53 is deprecated, crashes might occur on corrupt files"
 #endif
-
-  in_samples = avFrame->nb_samples;
-  max_out_samples = AUBIO_AVCODEC_MAX_BUFFER_SIZE;
-  if (frame_channels > 0) max_out_samples /= frame_channels;
-  out_samples = swr_convert( avr,
-      (uint8_t **)&output, max_out_samples,
-      (const uint8_t **)avFrame->data, in_samples);
-  if (out_samples < 0) {
-    AUBIO_WRN("source_avcodec: error while resampling %s (%d)\n",
-        s->path, out_samples);
-    goto beach;
+    if (s->seek_skip > 0) {
+      // drop the frames before the position passed to seek
+      if (s->seek_skip >= (uint_t)avFrame->nb_samples) {
+        s->seek_skip -= avFrame->nb_samples;
+        continue;
+      }
+      swr_drop_output(s->avr, (int)ROUND(s->seek_skip
+            * (s->samplerate * 1. / s->input_samplerate)));
+      s->seek_skip = 0;
+    }
+    return 1;
   }
+  return 0;
+}
 
-  *read_samples = out_samples;
-
-beach:
-  av_packet_unref(avPacket);
+// resample up to length frames to one plane per channel, decoding new frames
+// once the resampler is empty
+static uint_t aubio_source_avcodec_pull(aubio_source_avcodec_t * s,
+    smpl_t ** planes, uint_t length)
+{
+  uint_t i, total = 0;
+  int out;
+  s->stalled = 0;
+  if (s->timeout) {
+    s->deadline = av_gettime_relative() + s->timeout;
+  }
+  for (i = 0; i < s->input_channels; i++) {
+    s->out_planes[i] = (uint8_t *)planes[i];
+  }
+  // get the samples kept in the resampler by the previous call; the input
+  // pointers are not read when the input count is 0
+  out = swr_convert(s->avr, s->out_planes, length,
+      (const uint8_t **)s->out_planes, 0);
+  if (out > 0) total = out;
+  while (total < length && !s->flushed) {
+    for (i = 0; i < s->input_channels; i++) {
+      s->out_planes[i] = (uint8_t *)(planes[i] + total);
+    }
+    if (aubio_source_avcodec_readframe(s)) {
+      // the samples that do not fit are kept for the next call
+      out = swr_convert(s->avr, s->out_planes, length - total,
+          (const uint8_t **)s->avFrame->data, s->avFrame->nb_samples);
+    } else if (s->stalled) {
+      // the stream is late, the resampler keeps its samples
+      break;
+    } else {
+      // end of file, get the samples delayed in the resampler
+      out = swr_convert(s->avr, s->out_planes, length - total, NULL, 0);
+      s->flushed = 1;
+    }
+    if (out < 0) {
+      AUBIO_WRN("source_avcodec: error while resampling %s (%d)\n",
+          s->path, out);
+      break;
+    }
+    total += out;
+  }
+  s->deadline = 0;
+  return total;
 }
 
 void aubio_source_avcodec_do(aubio_source_avcodec_t * s, fvec_t * read_data,
     uint_t * read) {
-  uint_t i, j;
-  uint_t end = 0;
-  uint_t total_wrote = 0;
+  uint_t i, j, total_wrote = 0;
   uint_t length = aubio_source_validate_input_length("source_avcodec", s->path,
       s->hop_size, read_data->length);
   if (!s->avr || !s->avFormatCtx || !s->avCodecCtx) {
@@ -516,39 +730,54 @@ void aubio_source_avcodec_do(aubio_source_avcodec_t * s, fvec_t * read_data,
     *read= 0;
     return;
   }
-  while (total_wrote < length) {
-    end = MIN(s->read_samples - s->read_index, length - total_wrote);
-    for (i = 0; i < end; i++) {
-      read_data->data[i + total_wrote] = 0.;
-      for (j = 0; j < s->input_channels; j++) {
-        read_data->data[i + total_wrote] +=
-          s->output[(i + s->read_index) * s->input_channels + j];
-      }
-      read_data->data[i + total_wrote] *= 1./s->input_channels;
-    }
-    total_wrote += end;
-    if (total_wrote < length) {
-      uint_t avcodec_read = 0;
-      aubio_source_avcodec_readframe(s, &avcodec_read);
-      s->read_samples = avcodec_read;
-      s->read_index = 0;
-      if (s->eof) {
-        break;
+  if (s->input_channels == 1) {
+    total_wrote = aubio_source_avcodec_pull(s, &read_data->data, length);
+  } else {
+    // down-mix the channels
+    smpl_t **planes = s->scratch->data;
+    total_wrote = aubio_source_avcodec_pull(s, planes, length);
+    for (i = 0; i < total_wrote; i++) {
+      smpl_t sum = planes[0][i];
+      for (j = 1; j < s->input_channels; j++) {
+        sum += planes[j][i];
       }
-    } else {
-      s->read_index += end;
+      read_data->data[i] = sum / s->input_channels;
     }
   }
 
   aubio_source_pad_output(read_data, total_wrote);
 
+  if (s->stalled) {
+    // keep the hops coming at a steady rate, padded with silence
+    s->underruns++;
+    total_wrote = length;
+  }
   *read = total_wrote;
 }
 
+// read up to length frames to the first channels rows of read_data
+static uint_t aubio_source_avcodec_read_multi(aubio_source_avcodec_t * s,
+    fmat_t * read_data, uint_t channels, uint_t length) {
+  uint_t j, read, block, total_wrote = 0;
+  if (channels == s->input_channels) {
+    return aubio_source_avcodec_pull(s, read_data->data, length);
+  }
+  // read_data has fewer channels than the file, drop the others
+  while (total_wrote < length) {
+    block = MIN(length - total_wrote, s->hop_size);
+    read = aubio_source_avcodec_pull(s, s->scratch->data, block);
+    for (j = 0; j < channels; j++) {
+      AUBIO_MEMCPY(read_data->data[j] + total_wrote, s->scratch->data[j],
+          read * sizeof(smpl_t));
+    }
+    total_wrote += read;
+    if (read < block) break;
+  }
+  return total_wrote;
+}
+
 void aubio_source_avcodec_do_multi(aubio_source_avcodec_t * s,
     fmat_t * read_data, uint_t * read) {
-  uint_t i,j;
-  uint_t end = 0;
   uint_t total_wrote = 0;
   uint_t length = aubio_source_validate_input_length("source_avcodec", s->path,
       s->hop_size, read_data->length);
@@ -560,33 +789,36 @@ void aubio_source_avcodec_do_multi(aubio_source_avcodec_t * s,
     *read= 0;
     return;
   }
-  while (total_wrote < length) {
-    end = MIN(s->read_samples - s->read_index, length - total_wrote);
-    for (j = 0; j < channels; j++) {
-      for (i = 0; i < end; i++) {
-        read_data->data[j][i + total_wrote] =
-          s->output[(i + s->read_index) * s->input_channels + j];
-      }
-    }
-    total_wrote += end;
-    if (total_wrote < length) {
-      uint_t avcodec_read = 0;
-      aubio_source_avcodec_readframe(s, &avcodec_read);
-      s->read_samples = avcodec_read;
-      s->read_index = 0;
-      if (s->eof) {
-        break;
-      }
-    } else {
-      s->read_index += end;
-    }
-  }
+  total_wrote = aubio_source_avcodec_read_multi(s, read_data, channels, length);
 
   aubio_source_pad_multi_output(read_data, s->input_channels, total_wrote);
 
+  if (s->stalled) {
+    s->underruns++;
+    total_wrote = length;
+  }
   *read = total_wrote;
 }
 
+void aubio_source_avcodec_read_into(aubio_source_avcodec_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read) {
+  fmat_t block = *read_to;
+  uint_t channels = MIN(s->input_channels, read_to->height);
+  block.length = MIN(max_frames, read_to->length);
+  if (!s->avr || !s->avFormatCtx || !s->avCodecCtx) {
+    AUBIO_ERR("source_avcodec: could not read from %s (file was closed)\n",
+        s->path);
+    *read= 0;
+    return;
+  }
+  *read = aubio_source_avcodec_read_multi(s, &block, channels, block.length);
+  aubio_source_pad_multi_output(&block, s->input_channels, *read);
+  if (s->stalled) {
+    s->underruns++;
+    *read = block.length;
+  }
+}
+
 uint_t aubio_source_avcodec_get_samplerate(const aubio_source_avcodec_t * s) {
   return s->samplerate;
 }
@@ -595,6 +827,48 @@ uint_t aubio_source_avcodec_get_channels(const aubio_source_avcodec_t * s) {
   return s->input_channels;
 }
 
+// seek to the last indexed packet before pos, then count the frames to drop
+static uint_t aubio_source_avcodec_seek_index (aubio_source_avcodec_t * s,
+    uint_t pos) {
+  AVRational time_base = s->avFormatCtx->streams[s->selected_stream]->time_base;
+  AVRational frame_base = { 1, (int)s->input_samplerate };
+  int64_t first_pts = s->index[0].pts;
+  int64_t target = (int64_t)ROUND(pos
+      * (s->input_samplerate * 1. / s->samplerate));
+  int64_t target_pts = first_pts + av_rescale_q(target, frame_base, time_base);
+  uint_t lo = 0, hi = s->index_size, mid;
+  int64_t entry_frame;
+  int err;
+  // find the last entry starting at or before target_pts
+  while (hi - lo > 1) {
+    mid = lo + (hi - lo) / 2;
+    if (s->index[mid].pts <= target_pts) lo = mid;
+    else hi = mid;
+  }
+  entry_frame = av_rescale_q(s->index[lo].pts - first_pts, time_base,
+      frame_base);
+  err = av_seek_frame(s->avFormatCtx, s->selected_stream, s->index[lo].pos,
+      AVSEEK_FLAG_BYTE);
+  if (err < 0) {
+    char errorstr[256];
+    av_strerror (err, errorstr, sizeof(errorstr));
+    AUBIO_ERR("source_avcodec: failed seeking to %d in file %s (%s)\n",
+        pos, s->path, errorstr);
+    return AUBIO_FAIL;
+  }
+#if FF_API_LAVF_AVCTX
+  avcodec_flush_buffers(s->avCodecCtx);
+#endif
+  // start from an empty resampler, so that the dropped frames can be counted
+  swr_close(s->avr);
+  swr_init(s->avr);
+  s->seek_skip = target > entry_frame ? (uint_t)(target - entry_frame) : 0;
+  s->eof = 0;
+  s->draining = 0;
+  s->flushed = 0;
+  return AUBIO_OK;
+}
+
 uint_t aubio_source_avcodec_seek (aubio_source_avcodec_t * s, uint_t pos) {
   int64_t resampled_pos =
     (uint_t)ROUND(pos * (s->input_samplerate * 1. / s->samplerate));
@@ -614,21 +888,228 @@ uint_t aubio_source_avcodec_seek (aubio_source_avcodec_t * s, uint_t pos) {
        " should be >= 0)\n", s->path, pos);
     return AUBIO_FAIL;
   }
+  if (s->index) {
+    return aubio_source_avcodec_seek_index(s, pos);
+  }
   ret = avformat_seek_file(s->avFormatCtx, s->selected_stream,
       min_ts, resampled_pos, max_ts, seek_flags);
   if (ret < 0) {
     AUBIO_ERR("source_avcodec: failed seeking to %d in file %s",
         pos, s->path);
   }
+#if FF_API_LAVF_AVCTX
+  // drop the frames decoded before seeking
+  avcodec_flush_buffers(s->avCodecCtx);
+#endif
+  if (s->flushed) {
+    // the resampler was flushed at the end of the file, start it again
+    swr_close(s->avr);
+    swr_init(s->avr);
+  } else {
+    // drop the samples read before seeking, keeping the resampler alive
+    int out;
+    uint_t i;
+    do {
+      for (i = 0; i < s->input_channels; i++) {
+        s->out_planes[i] = (uint8_t *)s->scratch->data[i];
+      }
+      out = swr_convert(s->avr, s->out_planes, s->hop_size,
+          (const uint8_t **)s->out_planes, 0);
+    } while (out > 0);
+  }
   // reset read status
   s->eof = 0;
-  s->read_index = 0;
-  s->read_samples = 0;
-  swr_close(s->avr);
-  swr_init(s->avr);
+  s->draining = 0;
+  s->flushed = 0;
+  s->seek_skip = 0;
   return ret;
 }
 
+// read an index written by aubio_source_avcodec_save_index, checking it
+// was made for this file
+static uint_t aubio_source_avcodec_load_index (aubio_source_avcodec_t * s,
+    const char_t * index_path, int64_t file_size) {
+  AVRational time_base = s->avFormatCtx->streams[s->selected_stream]->time_base;
+  aubio_source_avcodec_index_t *index = NULL;
+  long long size, count, pts, pos;
+  int version, stream, num, den;
+  uint_t i;
+  FILE *f = fopen(index_path, "r");
+  if (!f) return AUBIO_FAIL;
+  if (fscanf(f, "aubio-seek-index %d %lld %d %d %d %lld", &version, &size,
+        &stream, &num, &den, &count) != 6
+      || version != AUBIO_AVCODEC_INDEX_VERSION || size != file_size
+      || stream != s->selected_stream
+      || num != time_base.num || den != time_base.den
+      || count <= 0 || count > size) {
+    goto beach;
+  }
+  index = AUBIO_ARRAY(aubio_source_avcodec_index_t, count);
+  if (!index) goto beach;
+  for (i = 0; i < (uint_t)count; i++) {
+    if (fscanf(f, "%lld %lld", &pts, &pos) != 2
+        || pos < 0 || pos >= size || (i > 0 && pts <= index[i-1].pts)) {
+      goto beach;
+    }
+    index[i].pts = pts;
+    index[i].pos = pos;
+  }
+  fclose(f);
+  if (s->index) AUBIO_FREE(s->index);
+  s->index = index;
+  s->index_size = count;
+  return AUBIO_OK;
+beach:
+  if (index) AUBIO_FREE(index);
+  fclose(f);
+  return AUBIO_FAIL;
+}
+
+static void aubio_source_avcodec_save_index (aubio_source_avcodec_t * s,
+    const char_t * index_path, int64_t file_size) {
+  AVRational time_base = s->avFormatCtx->streams[s->selected_stream]->time_base;
+  uint_t i;
+  int err = 0;
+  FILE *f = fopen(index_path, "w");
+  if (!f) {
+    AUBIO_WRN("source_avcodec: could not write seek index of %s to %s\n",
+        s->path, index_path);
+    return;
+  }
+  if (fprintf(f, "aubio-seek-index %d %lld %d %d %d %lld\n",
+      AUBIO_AVCODEC_INDEX_VERSION, (long long)file_size, s->selected_stream,
+      time_base.num, time_base.den, (long long)s->index_size) < 0) err = 1;
+  for (i = 0; i < s->index_size && !err; i++) {
+    if (fprintf(f, "%lld %lld\n", (long long)s->index[i].pts,
+          (long long)s->index[i].pos) < 0) err = 1;
+  }
+  if (fclose(f) != 0 || err) {
+    AUBIO_WRN("source_avcodec: could not write seek index of %s to %s\n",
+        s->path, index_path);
+  }
+}
+
+// read all the packets, keeping the position of a key packet every
+// AUBIO_AVCODEC_INDEX_SPACING frames
+static uint_t aubio_source_avcodec_scan_index (aubio_source_avcodec_t * s) {
+  AVStream *stream = s->avFormatCtx->streams[s->selected_stream];
+  AVRational frame_base = { 1, (int)s->input_samplerate };
+  int64_t spacing = av_rescale_q(AUBIO_AVCODEC_INDEX_SPACING, frame_base,
+      stream->time_base);
+  int64_t start = stream->start_time != AV_NOPTS_VALUE ?
+    stream->start_time : 0;
+  int64_t last = AV_NOPTS_VALUE, pts;
+  aubio_source_avcodec_index_t *index = NULL, *grown;
+  uint_t count = 0, allocated = 0;
+#if FF_API_INIT_PACKET
+  AVPacket *avPacket = s->avPacket;
+#else
+  AVPacket *avPacket = &s->avPacket;
+#endif
+  if (spacing < 1) spacing = 1;
+  if (av_seek_frame(s->avFormatCtx, s->selected_stream, start,
+        AVSEEK_FLAG_BACKWARD) < 0) {
+    AUBIO_ERR("source_avcodec: could not rewind %s to index it\n", s->path);
+    return AUBIO_FAIL;
+  }
+  while (av_read_frame(s->avFormatCtx, avPacket) >= 0) {
+    pts = avPacket->pts != AV_NOPTS_VALUE ? avPacket->pts : avPacket->dts;
+    if (avPacket->stream_index == s->selected_stream
+        && pts != AV_NOPTS_VALUE && avPacket->pos >= 0
+        && (avPacket->flags & AV_PKT_FLAG_KEY)
+        && (last == AV_NOPTS_VALUE || pts >= last + spacing)) {
+      if (count == allocated) {
+        allocated = allocated ? 2 * allocated : 256;
+        grown = (aubio_source_avcodec_index_t *)AUBIO_REALLOC(index,
+            allocated * sizeof(aubio_source_avcodec_index_t));
+        if (!grown) {
+          av_packet_unref(avPacket);
+          count = 0;
+          break;
+        }
+        index = grown;
+      }
+      index[count].pts = pts;
+      index[count].pos = avPacket->pos;
+      last = pts;
+      count++;
+    }
+    av_packet_unref(avPacket);
+  }
+  if (count == 0) {
+    AUBIO_ERR("source_avcodec: could not index %s\n", s->path);
+    if (index) AUBIO_FREE(index);
+    return AUBIO_FAIL;
+  }
+  if (s->index) AUBIO_FREE(s->index);
+  s->index = index;
+  s->index_size = count;
+  return AUBIO_OK;
+}
+
+uint_t aubio_source_avcodec_build_seek_index (aubio_source_avcodec_t * s,
+    const char_t * index_path) {
+  int64_t file_size;
+  if (!s->avFormatCtx || !s->avr) {
+    AUBIO_ERR("source_avcodec: could not index %s (file was closed)\n",
+        s->path);
+    return AUBIO_FAIL;
+  }
+  if (s->avFormatCtx->iformat->flags & AVFMT_NO_BYTE_SEEK) {
+    AUBIO_WRN("source_avcodec: not indexing %s, its format can not seek to "
+        "byte offsets\n", s->path);
+    return AUBIO_FAIL;
+  }
+  file_size = s->avFormatCtx->pb ? avio_size(s->avFormatCtx->pb) : -1;
+  if (index_path && file_size > 0
+      && aubio_source_avcodec_load_index(s, index_path, file_size)
+      == AUBIO_OK) {
+    return aubio_source_avcodec_seek(s, 0);
+  }
+  if (aubio_source_avcodec_scan_index(s) != AUBIO_OK) {
+    // the packets were read, go back to the start with the usual seek
+    aubio_source_avcodec_seek(s, 0);
+    return AUBIO_FAIL;
+  }
+  if (index_path && file_size > 0) {
+    aubio_source_avcodec_save_index(s, index_path, file_size);
+  }
+  return aubio_source_avcodec_seek(s, 0);
+}
+
+uint_t aubio_source_avcodec_set_filter_size (aubio_source_avcodec_t * s,
+    uint_t filter_size) {
+  int err;
+  if (!s->avr) {
+    AUBIO_ERR("source_avcodec: could not set filter size of %s "
+        "(file was closed)\n", s->path);
+    return AUBIO_FAIL;
+  }
+  // swr options only apply after re-initialising the context
+  if ((err = av_opt_set_int(s->avr, "filter_size",
+          filter_size ? filter_size : 32, 0)) < 0
+      || (err = swr_init(s->avr)) < 0) {
+    char errorstr[256];
+    av_strerror (err, errorstr, sizeof(errorstr));
+    AUBIO_ERR("source_avcodec: could not set filter size of %s to %d (%s)\n",
+        s->path, filter_size, errorstr);
+    return AUBIO_FAIL;
+  }
+  s->filter_size = filter_size;
+  s->flushed = 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_source_avcodec_get_filter_size (const aubio_source_avcodec_t * s)
+{
+  return s->filter_size ? s->filter_size : 32;
+}
+
+uint_t aubio_source_avcodec_get_underruns (const aubio_source_avcodec_t * s)
+{
+  return s->underruns;
+}
+
 uint_t aubio_source_avcodec_get_duration (aubio_source_avcodec_t * s) {
   if (s && &(s->avFormatCtx) != NULL) {
     int64_t duration = s->avFormatCtx->duration;
@@ -655,6 +1136,11 @@ uint_t aubio_source_avcodec_close(aubio_source_avcodec_t * s) {
     avformat_close_input(&s->avFormatCtx);
     s->avFormatCtx = NULL;
   }
+  if (s->avio != NULL) {
+    av_freep(&s->avio->buffer);
+    avio_context_free(&s->avio);
+  }
+  s->avio = NULL;
 #if FF_API_INIT_PACKET
   if (s->avPacket) {
     av_packet_unref(s->avPacket);
@@ -668,10 +1154,18 @@ uint_t aubio_source_avcodec_close(aubio_source_avcodec_t * s) {
 void del_aubio_source_avcodec(aubio_source_avcodec_t * s){
   AUBIO_ASSERT(s);
   aubio_source_avcodec_close(s);
-  if (s->output != NULL) {
-    av_free(s->output);
+  if (s->out_planes != NULL) {
+    AUBIO_FREE(s->out_planes);
+  }
+  s->out_planes = NULL;
+  if (s->index != NULL) {
+    AUBIO_FREE(s->index);
   }
-  s->output = NULL;
+  s->index = NULL;
+  if (s->scratch != NULL) {
+    del_fmat(s->scratch);
+  }
+  s->scratch = NULL;
   if (s->avFrame != NULL) {
     av_frame_free( &(s->avFrame) );
   }
@@ -689,4 +1183,56 @@ void del_aubio_source_avcodec(aubio_source_avcodec_t * s){
   AUBIO_FREE(s);
 }
 
+
+/* read the parameters of the first audio stream, as the source would,
+   returns 1 if its samplerate and channels are known */
+static uint_t aubio_source_avcodec_probe_stream (AVFormatContext *ctx,
+    aubio_source_info_t * info)
+{
+  uint_t i;
+  for (i = 0; i < ctx->nb_streams; i++) {
+#if FF_API_LAVF_AVCTX
+    const AVCodecParameters *par = ctx->streams[i]->codecpar;
+#else
+    const AVCodecContext *par = ctx->streams[i]->codec;
+#endif
+    if (par->codec_type != AVMEDIA_TYPE_AUDIO) continue;
+    if (par->sample_rate <= 0) return 0;
+    info->samplerate = par->sample_rate;
+#ifdef LIBAVUTIL_HAS_CH_LAYOUT
+    info->channels = par->ch_layout.nb_channels;
+#else
+    info->channels = par->channels;
+#endif
+    info->duration = 0;
+    if (ctx->duration != AV_NOPTS_VALUE && ctx->duration > 0) {
+      // same rounding as aubio_source_avcodec_get_duration
+      info->duration = info->samplerate * ((uint_t)ctx->duration / 1e6);
+    }
+    return info->channels > 0;
+  }
+  return 0;
+}
+
+uint_t aubio_source_avcodec_probe (const char_t * path,
+    aubio_source_info_t * info)
+{
+  AVFormatContext *ctx = NULL;
+  uint_t found;
+  if (aubio_avcodec_load()) return AUBIO_FAIL;
+#if LIBAVFORMAT_VERSION_INT < AV_VERSION_INT(58,0,0)
+  av_register_all();
+#endif
+  if (avformat_open_input(&ctx, path, NULL, NULL) < 0) return AUBIO_FAIL;
+  // most containers give the parameters and the duration in their header,
+  // only look at the first packets when they do not
+  found = aubio_source_avcodec_probe_stream(ctx, info);
+  if ((!found || !info->duration)
+      && avformat_find_stream_info(ctx, NULL) >= 0) {
+    found = aubio_source_avcodec_probe_stream(ctx, info);
+  }
+  avformat_close_input(&ctx);
+  return found ? AUBIO_OK : AUBIO_FAIL;
+}
+
 #endif /* HAVE_LIBAV */
@@ -58,6 +58,34 @@ typedef struct _aubio_source_avcodec_t aubio_source_avcodec_t;
 */
 aubio_source_avcodec_t * new_aubio_source_avcodec(const char_t * uri, uint_t samplerate, uint_t hop_size);
 
+/**
+
+  create new ::aubio_source_avcodec_t reading from a live stream
+
+  \param uri url of the stream, for instance `http://`, `rtp://` or `udp://`
+  \param samplerate sampling rate to view the stream at, or `0`
+  \param hop_size the size of the blocks to read from
+  \param max_delay longest time the demuxer may buffer the stream, in
+  milliseconds, both to find its format and to reorder the packets coming
+  late over rtp or udp
+  \param timeout longest time a read may wait for new packets, in
+  milliseconds, or `0` to wait as long as the stream takes
+
+  Unlike ::new_aubio_source_avcodec, which probes a large part of its input
+  to find the format and buffers packets to interleave them, only a few
+  kilobytes of the stream are probed, and the demuxer and the decoder are
+  asked not to hold back packets or frames.
+
+  When no packet came within `timeout`, the hop is padded with silence and
+  still counts as `hop_size` frames read, so that an analysis keeps running
+  at the rate of the hops, and ::aubio_source_avcodec_get_underruns is
+  incremented. The next read carries on with the packets received in the
+  meantime.
+
+*/
+aubio_source_avcodec_t * new_aubio_source_avcodec_stream (const char_t * uri,
+    uint_t samplerate, uint_t hop_size, uint_t max_delay, uint_t timeout);
+
 /**
 
   read monophonic vector of length hop_size from source object
@@ -86,6 +114,23 @@ void aubio_source_avcodec_do(aubio_source_avcodec_t * s, fvec_t * read_to, uint_
 */
 void aubio_source_avcodec_do_multi(aubio_source_avcodec_t * s, fmat_t * read_to, uint_t * read);
 
+/**
+
+  read up to max_frames frames from source object
+
+  \param s source object, created with ::new_aubio_source_avcodec
+  \param read_to ::fmat_t of data to read to
+  \param max_frames maximum number of frames to read, at most the length of
+  `read_to`
+  \param read upon returns, equals to number of frames actually read
+
+  Same as ::aubio_source_avcodec_do_multi, without limiting the number of
+  frames to `hop_size`.
+
+*/
+void aubio_source_avcodec_read_into(aubio_source_avcodec_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read);
+
 /**
 
   get samplerate of source object
@@ -118,6 +163,69 @@ uint_t aubio_source_avcodec_get_channels (const aubio_source_avcodec_t * s);
 */
 uint_t aubio_source_avcodec_seek (aubio_source_avcodec_t *s, uint_t pos);
 
+/**
+
+  set the length of the resampling filter
+
+  \param s source object, created with ::new_aubio_source_avcodec
+  \param filter_size length of the filter used by libswresample, or `0` for
+  the default of 32
+
+  \return 0 if sucessful, non-zero on failure
+
+  Shorter filters resample faster, at the cost of more aliasing. This has no
+  effect when the file is read at its original samplerate.
+
+*/
+uint_t aubio_source_avcodec_set_filter_size (aubio_source_avcodec_t * s,
+    uint_t filter_size);
+
+/**
+
+  get the length of the resampling filter
+
+  \param s source object, created with ::new_aubio_source_avcodec
+  \return length of the filter used by libswresample
+
+*/
+uint_t aubio_source_avcodec_get_filter_size (const aubio_source_avcodec_t * s);
+
+/**
+
+  index the packets of the file to seek faster
+
+  \param s source object, created with ::new_aubio_source_avcodec
+  \param index_path path of a file to load the index from, or to save it to
+  if it does not match the source, or `NULL` to always read the whole file
+
+  \return 0 if sucessful, non-zero on failure
+
+  Reads the whole file once, keeping the byte offset of one packet every 4096
+  frames. ::aubio_source_avcodec_seek then jumps straight to the last indexed
+  packet before the requested position, and only decodes the frames up to it,
+  instead of relying on the seeking of the demuxer, which may have to decode
+  from far before the position, or land away from it, in formats without a
+  table of contents such as mp3 or adts.
+
+  The index file is rebuilt when it was written for a file of a different
+  size. Formats which can not seek to byte offsets are not indexed.
+
+  The source is rewound to its first frame.
+
+*/
+uint_t aubio_source_avcodec_build_seek_index (aubio_source_avcodec_t * s,
+    const char_t * index_path);
+
+/**
+
+  get the number of reads interrupted while waiting for a stream
+
+  \param s source object, created with ::new_aubio_source_avcodec_stream
+  \return number of hops padded with silence since the source was opened
+
+*/
+uint_t aubio_source_avcodec_get_underruns (const aubio_source_avcodec_t * s);
+
 /**
 
   get the duration of source object, in frames
@@ -0,0 +1,580 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "ioutils.h"
+#include "io/source.h"
+#include "io/ioutils_priv.h"
+#include "io/iothread_priv.h"
+#include "io/source_capture_priv.h"
+#include "utils/atomic_priv.h"
+
+#ifdef HAVE_ALSA
+#include <alsa/asoundlib.h>
+#include "io/lazy_alsa_priv.h"
+#endif /* HAVE_ALSA */
+
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+#include <AudioToolbox/AudioToolbox.h>
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+
+/** sampling rate of the devices opened with samplerate 0 */
+#define AUBIO_CAPTURE_SAMPLERATE 44100
+
+/** channels asked to the devices, which may give fewer */
+#define AUBIO_CAPTURE_CHANNELS 2
+
+/** hops, or device periods if longer, held by the ring */
+#define AUBIO_CAPTURE_RING_HOPS 16
+
+/** periods in the buffer of ALSA devices */
+#define AUBIO_CAPTURE_ALSA_PERIODS 4
+
+/** longest wait for frames before checking if the capture was closed, in
+  milliseconds */
+#define AUBIO_CAPTURE_ALSA_POLL 100
+
+/** buffers queued to CoreAudio, each one hop long */
+#define AUBIO_CAPTURE_QUEUE_BUFFERS 3
+
+typedef enum {
+  aubio_capture_alsa,
+  aubio_capture_coreaudio,
+  aubio_capture_none
+} aubio_capture_api_t;
+
+static const char_t *aubio_capture_schemes[] = { "alsa:", "coreaudio:" };
+
+/* Each counter has a single writer, the device side or the reader; loads
+   with acquire and stores with release semantics hand the frames over. */
+struct _aubio_source_capture_t {
+  uint_t hop_size;
+  uint_t samplerate;
+  uint_t channels;
+  char_t *uri;
+
+  aubio_io_format_t format;     /**< format of the frames in the ring */
+  uint_t frame_size;            /**< bytes in each frame */
+  unsigned char *ring;
+  uint_t capacity;              /**< frames in the ring, a power of 2 */
+
+  // written by the device side
+  uint_t written;               /**< frames captured */
+  uint_t dropped;               /**< frames dropped with the ring full */
+  uint_t stopped;               /**< 1 once no more frames will come */
+  uint_t wake_pending;          /**< 1 if the reader was not woken up yet */
+  // written by the reader
+  uint_t read;                  /**< frames read */
+  uint_t quit;                  /**< 1 once the capture was closed */
+
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  aubio_io_thread_t thread;
+  uint_t running;               /**< 1 while the thread runs */
+
+#ifdef HAVE_ALSA
+  snd_pcm_t *pcm;
+  unsigned char *period;        /**< frames returned by snd_pcm_readi */
+  uint_t period_size;
+#endif /* HAVE_ALSA */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+  AudioQueueRef queue;
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+};
+
+static aubio_capture_api_t aubio_source_capture_get_api (const char_t * uri)
+{
+  uint_t i;
+  for (i = 0; i < aubio_capture_none; i++) {
+    const char_t *scheme = aubio_capture_schemes[i];
+    if (strncmp(uri, scheme, strlen(scheme)) == 0) {
+      return (aubio_capture_api_t)i;
+    }
+  }
+  return aubio_capture_none;
+}
+
+uint_t aubio_source_capture_is_device (const char_t * uri)
+{
+  return uri && aubio_source_capture_get_api(uri) != aubio_capture_none;
+}
+
+#if defined(HAVE_ALSA) || defined(HAVE_SOURCE_APPLE_AUDIO)
+
+/* wake up the reader, without ever waiting for it: if it holds the mutex,
+   it is about to check for new frames or to sleep, and the next push will
+   try again */
+static void aubio_source_capture_wake (aubio_source_capture_t * s)
+{
+  if (AUBIO_IO_TRYLOCK(s)) {
+    AUBIO_IO_WAKE(s);
+    AUBIO_IO_UNLOCK(s);
+    s->wake_pending = 0;
+  } else {
+    s->wake_pending = 1;
+  }
+}
+
+/* copy interleaved frames from the device to the ring */
+static void aubio_source_capture_push (aubio_source_capture_t * s,
+    const unsigned char * data, uint_t frames)
+{
+  uint_t written = s->written;
+  uint_t room = s->capacity - (written - AUBIO_ATOMIC_LOAD(s->read));
+  uint_t pos = written & (s->capacity - 1), n;
+  if (frames > room) {
+    // the reader is late, keep the frames it has not read yet
+    AUBIO_ATOMIC_STORE(s->dropped, s->dropped + frames - room);
+    frames = room;
+  }
+  n = MIN(frames, s->capacity - pos);
+  memcpy(s->ring + pos * s->frame_size, data, n * s->frame_size);
+  memcpy(s->ring, data + n * s->frame_size, (frames - n) * s->frame_size);
+  AUBIO_ATOMIC_STORE(s->written, written + frames);
+  if (frames || s->wake_pending) {
+    aubio_source_capture_wake(s);
+  }
+}
+
+#endif /* HAVE_ALSA || HAVE_SOURCE_APPLE_AUDIO */
+
+#ifdef HAVE_ALSA
+
+/* called once no more frames will be pushed, not from real-time callbacks */
+static void aubio_source_capture_end (aubio_source_capture_t * s)
+{
+  AUBIO_IO_LOCK(s);
+  AUBIO_ATOMIC_STORE(s->stopped, 1);
+  AUBIO_IO_WAKE(s);
+  AUBIO_IO_UNLOCK(s);
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_source_capture_alsa_thread)
+{
+  aubio_source_capture_t *s = (aubio_source_capture_t *)arg;
+  snd_pcm_sframes_t n;
+  while (!AUBIO_ATOMIC_LOAD(s->quit)) {
+    if (snd_pcm_wait(s->pcm, AUBIO_CAPTURE_ALSA_POLL) == 0) {
+      continue;
+    }
+    n = snd_pcm_readi(s->pcm, s->period, s->period_size);
+    if (n < 0) {
+      // restart after an overrun or a suspend
+      n = snd_pcm_recover(s->pcm, n, 1);
+    }
+    if (n < 0) {
+      AUBIO_ERR("source_capture: failed reading from %s (%s)\n", s->uri,
+          snd_strerror(n));
+      break;
+    }
+    aubio_source_capture_push(s, s->period, n);
+  }
+  aubio_source_capture_end(s);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+static uint_t aubio_source_capture_open_alsa (aubio_source_capture_t * s,
+    const char_t * device)
+{
+  snd_pcm_hw_params_t *params = NULL;
+  snd_pcm_uframes_t period = s->hop_size, buffer;
+  unsigned int rate = s->samplerate, channels = AUBIO_CAPTURE_CHANNELS;
+  int err;
+  if (aubio_alsa_load()) return AUBIO_FAIL;
+  if ((err = snd_pcm_open(&s->pcm, *device ? device : "default",
+          SND_PCM_STREAM_CAPTURE, 0)) < 0) {
+    AUBIO_ERR("source_capture: Failed opening %s (%s)\n", s->uri,
+        snd_strerror(err));
+    s->pcm = NULL;
+    return AUBIO_FAIL;
+  }
+  if ((err = snd_pcm_hw_params_malloc(&params)) < 0
+      || (err = snd_pcm_hw_params_any(s->pcm, params)) < 0
+      || (err = snd_pcm_hw_params_set_access(s->pcm, params,
+          SND_PCM_ACCESS_RW_INTERLEAVED)) < 0) {
+    goto beach;
+  }
+  // float frames are copied to the ring as they are
+  if (snd_pcm_hw_params_set_format(s->pcm, params,
+        SND_PCM_FORMAT_FLOAT_LE) == 0) {
+    s->format = aubio_io_f32;
+  } else if ((err = snd_pcm_hw_params_set_format(s->pcm, params,
+          SND_PCM_FORMAT_S16_LE)) == 0) {
+    s->format = aubio_io_s16;
+  } else {
+    goto beach;
+  }
+  if ((err = snd_pcm_hw_params_set_channels_near(s->pcm, params,
+          &channels)) < 0
+      || (err = snd_pcm_hw_params_set_rate_near(s->pcm, params, &rate,
+          NULL)) < 0) {
+    goto beach;
+  }
+  if (rate != s->samplerate) {
+    AUBIO_ERR("source_capture: can not capture %s at %dHz, the device"
+        " runs at %dHz\n", s->uri, s->samplerate, rate);
+    err = 0;
+    goto beach;
+  }
+  // a period per hop, so that each hop is read as soon as it was captured
+  if ((err = snd_pcm_hw_params_set_period_size_near(s->pcm, params,
+          &period, NULL)) < 0) {
+    goto beach;
+  }
+  buffer = AUBIO_CAPTURE_ALSA_PERIODS * period;
+  if ((err = snd_pcm_hw_params_set_buffer_size_near(s->pcm, params,
+          &buffer)) < 0
+      || (err = snd_pcm_hw_params(s->pcm, params)) < 0) {
+    goto beach;
+  }
+  snd_pcm_hw_params_free(params);
+  s->channels = channels;
+  s->period_size = period;
+  return AUBIO_OK;
+
+beach:
+  if (err < 0) {
+    AUBIO_ERR("source_capture: Failed configuring %s (%s)\n", s->uri,
+        snd_strerror(err));
+  }
+  if (params) snd_pcm_hw_params_free(params);
+  snd_pcm_close(s->pcm);
+  s->pcm = NULL;
+  return AUBIO_FAIL;
+}
+
+static uint_t aubio_source_capture_start_alsa (aubio_source_capture_t * s)
+{
+  int err;
+  s->period = AUBIO_ARRAY(unsigned char, s->period_size * s->frame_size);
+  if (!s->period) return AUBIO_FAIL;
+  if ((err = snd_pcm_start(s->pcm)) < 0) {
+    AUBIO_ERR("source_capture: Failed starting %s (%s)\n", s->uri,
+        snd_strerror(err));
+    return AUBIO_FAIL;
+  }
+  s->running = AUBIO_IO_THREAD_START(s, aubio_source_capture_alsa_thread,
+      AUBIO_THREAD_STREAM);
+  if (!s->running) {
+    AUBIO_ERR("source_capture: failed starting thread for %s\n", s->uri);
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+#endif /* HAVE_ALSA */
+
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+
+static void aubio_source_capture_queue_callback (void *data,
+    AudioQueueRef queue, AudioQueueBufferRef buffer,
+    const AudioTimeStamp *start, UInt32 n_packets,
+    const AudioStreamPacketDescription *desc)
+{
+  aubio_source_capture_t *s = (aubio_source_capture_t *)data;
+  aubio_source_capture_push(s, (const unsigned char *)buffer->mAudioData,
+      buffer->mAudioDataByteSize / s->frame_size);
+  if (!AUBIO_ATOMIC_LOAD(s->quit)) {
+    AudioQueueEnqueueBuffer(queue, buffer, 0, NULL);
+  }
+}
+
+static uint_t aubio_source_capture_open_coreaudio (aubio_source_capture_t * s,
+    const char_t * device)
+{
+  AudioStreamBasicDescription format;
+  OSStatus err;
+  memset(&format, 0, sizeof(format));
+  format.mSampleRate = s->samplerate;
+  format.mFormatID = kAudioFormatLinearPCM;
+  // native, hence little-endian, floats, as aubio_io_f32 expects
+  format.mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked;
+  format.mChannelsPerFrame = AUBIO_CAPTURE_CHANNELS;
+  format.mBitsPerChannel = 32;
+  format.mFramesPerPacket = 1;
+  format.mBytesPerFrame = format.mChannelsPerFrame * sizeof(float);
+  format.mBytesPerPacket = format.mBytesPerFrame;
+  // the callback runs on a thread of the queue
+  err = AudioQueueNewInput(&format, aubio_source_capture_queue_callback, s,
+      NULL, NULL, 0, &s->queue);
+  if (err) {
+    AUBIO_ERR("source_capture: Failed opening %s (AudioQueueNewInput"
+        " returned %d)\n", s->uri, (int)err);
+    s->queue = NULL;
+    return AUBIO_FAIL;
+  }
+  if (*device) {
+    // the unique identifier of the device, otherwise the default input
+    CFStringRef uid = CFStringCreateWithCString(NULL, device,
+        kCFStringEncodingUTF8);
+    err = AudioQueueSetProperty(s->queue, kAudioQueueProperty_CurrentDevice,
+        &uid, sizeof(uid));
+    CFRelease(uid);
+    if (err) {
+      AUBIO_ERR("source_capture: Failed opening %s (no such device)\n",
+          s->uri);
+      AudioQueueDispose(s->queue, true);
+      s->queue = NULL;
+      return AUBIO_FAIL;
+    }
+  }
+  s->format = aubio_io_f32;
+  s->channels = AUBIO_CAPTURE_CHANNELS;
+  return AUBIO_OK;
+}
+
+static uint_t aubio_source_capture_start_coreaudio (aubio_source_capture_t * s)
+{
+  AudioQueueBufferRef buffer;
+  OSStatus err;
+  uint_t i;
+  for (i = 0; i < AUBIO_CAPTURE_QUEUE_BUFFERS; i++) {
+    err = AudioQueueAllocateBuffer(s->queue, s->hop_size * s->frame_size,
+        &buffer);
+    if (!err) err = AudioQueueEnqueueBuffer(s->queue, buffer, 0, NULL);
+    if (err) return AUBIO_FAIL;
+  }
+  err = AudioQueueStart(s->queue, NULL);
+  if (err) {
+    AUBIO_ERR("source_capture: Failed starting %s (AudioQueueStart returned"
+        " %d)\n", s->uri, (int)err);
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+
+aubio_source_capture_t *new_aubio_source_capture (const char_t * uri,
+    uint_t samplerate, uint_t hop_size)
+{
+  aubio_source_capture_t *s;
+  aubio_capture_api_t api;
+  const char_t *device;
+  uint_t longest, err = AUBIO_FAIL;
+  if (!aubio_source_capture_is_device(uri)) {
+    AUBIO_ERR("source_capture: Aborted opening null or unknown device\n");
+    return NULL;
+  }
+  if ((sint_t)samplerate < 0) {
+    AUBIO_ERR("source_capture: Can not open %s with samplerate %d\n", uri,
+        samplerate);
+    return NULL;
+  }
+  if ((sint_t)hop_size <= 0) {
+    AUBIO_ERR("source_capture: Can not open %s with hop_size %d\n", uri,
+        hop_size);
+    return NULL;
+  }
+  s = AUBIO_NEW(aubio_source_capture_t);
+  if (!s) return NULL;
+  AUBIO_IO_THREAD_INIT(s);
+  s->hop_size = hop_size;
+  s->samplerate = samplerate ? samplerate : AUBIO_CAPTURE_SAMPLERATE;
+  s->uri = AUBIO_ARRAY(char_t, strnlen(uri, PATH_MAX) + 1);
+  if (!s->uri) goto beach;
+  strncpy(s->uri, uri, strnlen(uri, PATH_MAX) + 1);
+  api = aubio_source_capture_get_api(s->uri);
+  device = s->uri + strlen(aubio_capture_schemes[api]);
+
+  switch (api) {
+#ifdef HAVE_ALSA
+    case aubio_capture_alsa:
+      err = aubio_source_capture_open_alsa(s, device);
+      break;
+#endif /* HAVE_ALSA */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+    case aubio_capture_coreaudio:
+      err = aubio_source_capture_open_coreaudio(s, device);
+      break;
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+    default:
+      AUBIO_ERR("source_capture: Failed opening %s (%.*s devices not"
+          " built-in)\n", s->uri, (int)(device - s->uri - 1), s->uri);
+      break;
+  }
+  if (err != AUBIO_OK) goto beach;
+
+  // the ring holds a few hops, or device periods when they are longer
+  s->frame_size = s->channels * aubio_io_format_size(s->format);
+  longest = hop_size;
+#ifdef HAVE_ALSA
+  longest = MAX(longest, s->period_size);
+#endif /* HAVE_ALSA */
+  s->capacity = 1;
+  while (s->capacity < AUBIO_CAPTURE_RING_HOPS * longest) {
+    s->capacity <<= 1;
+  }
+  s->ring = AUBIO_ARRAY(unsigned char, s->capacity * s->frame_size);
+  if (!s->ring) goto beach;
+
+  switch (api) {
+#ifdef HAVE_ALSA
+    case aubio_capture_alsa:
+      err = aubio_source_capture_start_alsa(s);
+      break;
+#endif /* HAVE_ALSA */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+    case aubio_capture_coreaudio:
+      err = aubio_source_capture_start_coreaudio(s);
+      break;
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+    default:
+      break;
+  }
+  if (err != AUBIO_OK) goto beach;
+  return s;
+
+beach:
+  del_aubio_source_capture(s);
+  return NULL;
+}
+
+/* wait for length frames, or for the end of the capture, and return the
+   number of frames that can be read, at most length */
+static uint_t aubio_source_capture_wait (aubio_source_capture_t * s,
+    uint_t length)
+{
+  uint_t available = AUBIO_ATOMIC_LOAD(s->written) - s->read;
+  if (available < length && !AUBIO_ATOMIC_LOAD(s->stopped)) {
+    AUBIO_IO_LOCK(s);
+    while ((available = AUBIO_ATOMIC_LOAD(s->written) - s->read) < length
+        && !AUBIO_ATOMIC_LOAD(s->stopped)) {
+      AUBIO_IO_WAIT(s);
+    }
+    AUBIO_IO_UNLOCK(s);
+  }
+  return MIN(available, length);
+}
+
+/* frames at the read position, and the number of them before the end of
+   the ring */
+static const unsigned char *aubio_source_capture_peek (
+    const aubio_source_capture_t * s, uint_t length, uint_t * contiguous)
+{
+  uint_t pos = s->read & (s->capacity - 1);
+  *contiguous = MIN(length, s->capacity - pos);
+  return s->ring + pos * s->frame_size;
+}
+
+void aubio_source_capture_do (aubio_source_capture_t * s, fvec_t * read_to,
+    uint_t * read)
+{
+  uint_t length = aubio_source_validate_input_length("source_capture",
+      s->uri, s->hop_size, read_to->length);
+  uint_t n, available = aubio_source_capture_wait(s, length);
+  const unsigned char *frames = aubio_source_capture_peek(s, available, &n);
+  aubio_io_downmix(s->format, frames, s->channels, read_to->data, n);
+  aubio_io_downmix(s->format, s->ring, s->channels, read_to->data + n,
+      available - n);
+  AUBIO_ATOMIC_STORE(s->read, s->read + available);
+  aubio_source_pad_output(read_to, available);
+  *read = available;
+}
+
+void aubio_source_capture_do_multi (aubio_source_capture_t * s,
+    fmat_t * read_to, uint_t * read)
+{
+  uint_t length = aubio_source_validate_input_length("source_capture",
+      s->uri, s->hop_size, read_to->length);
+  uint_t n, available;
+  const unsigned char *frames;
+  // only warns, aubio_io_deinterleave writes at most read_to->height rows
+  aubio_source_validate_input_channels("source_capture", s->uri,
+      s->channels, read_to->height);
+  available = aubio_source_capture_wait(s, length);
+  frames = aubio_source_capture_peek(s, available, &n);
+  aubio_io_deinterleave(s->format, frames, s->channels, read_to, 0, n);
+  aubio_io_deinterleave(s->format, s->ring, s->channels, read_to, n,
+      available - n);
+  AUBIO_ATOMIC_STORE(s->read, s->read + available);
+  aubio_source_pad_multi_output(read_to, s->channels, available);
+  *read = available;
+}
+
+uint_t aubio_source_capture_get_samplerate (aubio_source_capture_t * s)
+{
+  return s->samplerate;
+}
+
+uint_t aubio_source_capture_get_channels (aubio_source_capture_t * s)
+{
+  return s->channels;
+}
+
+uint_t aubio_source_capture_get_duration (aubio_source_capture_t * s)
+{
+  (void)s;
+  return 0;
+}
+
+uint_t aubio_source_capture_seek (aubio_source_capture_t * s, uint_t pos)
+{
+  (void)pos;
+  AUBIO_ERR("source_capture: can not seek in %s\n", s->uri);
+  return AUBIO_FAIL;
+}
+
+uint_t aubio_source_capture_close (aubio_source_capture_t * s)
+{
+  uint_t dropped;
+  AUBIO_ATOMIC_STORE(s->quit, 1);
+  if (s->running) {
+    AUBIO_IO_THREAD_JOIN(s);
+    s->running = 0;
+  }
+#ifdef HAVE_ALSA
+  if (s->pcm) {
+    snd_pcm_close(s->pcm);
+    s->pcm = NULL;
+  }
+#endif /* HAVE_ALSA */
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+  if (s->queue) {
+    // stops at once, and waits for the callback to return
+    AudioQueueStop(s->queue, true);
+    AudioQueueDispose(s->queue, true);
+    s->queue = NULL;
+  }
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+  AUBIO_ATOMIC_STORE(s->stopped, 1);
+  dropped = AUBIO_ATOMIC_LOAD(s->dropped);
+  if (dropped) {
+    AUBIO_WRN("source_capture: %d frames captured from %s were dropped,"
+        " hops were read too late\n", dropped, s->uri);
+    AUBIO_ATOMIC_STORE(s->dropped, 0);
+  }
+  return AUBIO_OK;
+}
+
+void del_aubio_source_capture (aubio_source_capture_t * s)
+{
+  AUBIO_ASSERT(s);
+  aubio_source_capture_close(s);
+  AUBIO_IO_THREAD_DESTROY(s);
+#ifdef HAVE_ALSA
+  if (s->period) AUBIO_FREE(s->period);
+#endif /* HAVE_ALSA */
+  if (s->ring) AUBIO_FREE(s->ring);
+  if (s->uri) AUBIO_FREE(s->uri);
+  AUBIO_FREE(s);
+}
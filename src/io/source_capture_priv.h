@@ -0,0 +1,76 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Sources capturing from an audio device, used by new_aubio_source() in
+   io/source.c for uris starting with a device scheme, such as `alsa:hw:0`.
+
+   The device thread or callback copies the frames it gets, as they are, to
+   a ring of interleaved frames, and publishes them by incrementing a
+   counter. aubio_source_capture_do() waits for a hop of frames, then
+   converts them. Neither side locks the ring: the device side never waits,
+   and frames arriving while the ring is full are dropped and counted.
+*/
+
+#ifndef AUBIO_SOURCE_CAPTURE_PRIV_H
+#define AUBIO_SOURCE_CAPTURE_PRIV_H
+
+/** capture source object */
+typedef struct _aubio_source_capture_t aubio_source_capture_t;
+
+/** returns 1 if uri starts with a device scheme, for instance `alsa:hw:0`,
+  even if the devices of this scheme were not built in */
+uint_t aubio_source_capture_is_device (const char_t * uri);
+
+/** open a capture device and start capturing
+
+  \param uri scheme of the device, followed by its name, for instance
+  `alsa:default`, `alsa:hw:1,0` or `coreaudio:`
+  \param samplerate sampling rate to open the device at, or 0 for 44100 Hz
+  \param hop_size number of frames read by each call to `do`
+
+  \return the new object, or NULL if the device could not be opened at
+  `samplerate`
+
+*/
+aubio_source_capture_t *new_aubio_source_capture (const char_t * uri,
+    uint_t samplerate, uint_t hop_size);
+
+void aubio_source_capture_do (aubio_source_capture_t * s, fvec_t * read_to,
+    uint_t * read);
+
+void aubio_source_capture_do_multi (aubio_source_capture_t * s,
+    fmat_t * read_to, uint_t * read);
+
+uint_t aubio_source_capture_get_samplerate (aubio_source_capture_t * s);
+
+uint_t aubio_source_capture_get_channels (aubio_source_capture_t * s);
+
+/** always 0, a capture has no end */
+uint_t aubio_source_capture_get_duration (aubio_source_capture_t * s);
+
+/** always fails */
+uint_t aubio_source_capture_seek (aubio_source_capture_t * s, uint_t pos);
+
+/** stop capturing; the frames already captured can still be read */
+uint_t aubio_source_capture_close (aubio_source_capture_t * s);
+
+void del_aubio_source_capture (aubio_source_capture_t * s);
+
+#endif /* AUBIO_SOURCE_CAPTURE_PRIV_H */
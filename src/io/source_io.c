@@ -0,0 +1,144 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "io/source_io_priv.h"
+
+struct _aubio_source_io_t {
+  aubio_source_callbacks_t callbacks;
+  void *user_data;
+  const unsigned char *data;    /**< bytes of a memory stream, or NULL */
+  long long size;               /**< size in bytes, -1 until known */
+  long long pos;                /**< current position, in bytes */
+  uint_t at_end;
+};
+
+aubio_source_io_t *new_aubio_source_io (const aubio_source_callbacks_t
+    * callbacks, void *user_data)
+{
+  aubio_source_io_t *io;
+  if (!callbacks || !callbacks->read) {
+    AUBIO_ERR("source: can not read from callbacks without a read function\n");
+    return NULL;
+  }
+  io = AUBIO_NEW(aubio_source_io_t);
+  if (!io) return NULL;
+  io->callbacks = *callbacks;
+  io->user_data = user_data;
+  io->size = -1;
+  return io;
+}
+
+aubio_source_io_t *new_aubio_source_io_memory (const void *data, uint_t size)
+{
+  aubio_source_io_t *io;
+  if (!data && size) {
+    AUBIO_ERR("source: can not read %d bytes from a null buffer\n", size);
+    return NULL;
+  }
+  io = AUBIO_NEW(aubio_source_io_t);
+  if (!io) return NULL;
+  io->data = (const unsigned char *)data;
+  io->size = size;
+  return io;
+}
+
+size_t aubio_source_io_read (aubio_source_io_t * io, void *buf, size_t size)
+{
+  size_t total = 0;
+  sint_t read;
+  if (io->data) {
+    total = (size_t)MIN((long long)size, MAX(0, io->size - io->pos));
+    if (total) AUBIO_MEMCPY(buf, io->data + io->pos, total);
+  } else {
+    // callbacks may return fewer bytes than asked for before the end
+    while (total < size) {
+      read = io->callbacks.read(io->user_data, (unsigned char *)buf + total,
+          (uint_t)MIN(size - total, UINT_MAX / 2));
+      if (read <= 0) break;
+      total += read;
+    }
+  }
+  io->pos += total;
+  if (total < size) io->at_end = 1;
+  return total;
+}
+
+uint_t aubio_source_io_seek (aubio_source_io_t * io, long long offset,
+    int whence)
+{
+  long long pos;
+  if (io->data) {
+    if (whence == SEEK_CUR) offset += io->pos;
+    else if (whence == SEEK_END) offset += io->size;
+    pos = offset;
+  } else if (io->callbacks.seek) {
+    pos = io->callbacks.seek(io->user_data, offset, whence);
+  } else if (whence == SEEK_SET && offset == io->pos) {
+    // streams which can not seek can still stay where they are
+    pos = offset;
+  } else {
+    return AUBIO_FAIL;
+  }
+  if (pos < 0) return AUBIO_FAIL;
+  io->pos = pos;
+  io->at_end = 0;
+  return AUBIO_OK;
+}
+
+long long aubio_source_io_tell (const aubio_source_io_t * io)
+{
+  return io->pos;
+}
+
+long long aubio_source_io_get_size (aubio_source_io_t * io)
+{
+  long long pos = io->pos, size;
+  if (io->size >= 0 || !io->callbacks.seek) return io->size;
+  size = io->callbacks.seek(io->user_data, 0, SEEK_END);
+  // go back to where the stream was
+  if (io->callbacks.seek(io->user_data, pos, SEEK_SET) != pos) return -1;
+  if (size >= 0) io->size = size;
+  return io->size;
+}
+
+uint_t aubio_source_io_at_end (const aubio_source_io_t * io)
+{
+  return io->at_end;
+}
+
+const unsigned char *aubio_source_io_get_data (const aubio_source_io_t * io)
+{
+  return io->data;
+}
+
+const char_t *aubio_source_io_get_name (const aubio_source_io_t * io)
+{
+  return io->data ? "memory buffer" : "callbacks";
+}
+
+void del_aubio_source_io (aubio_source_io_t * io)
+{
+  AUBIO_ASSERT(io);
+  AUBIO_FREE(io);
+}
@@ -0,0 +1,100 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Byte streams read by new_aubio_source_memory() and
+   new_aubio_source_callbacks() in io/source.c.
+
+   The sources which can read from a stream have a constructor taking an
+   aubio_source_io_t instead of a path, declared below. They only borrow the
+   stream, which is deleted with the aubio_source_t wrapping them, and start
+   by rewinding it, so that the next backend can be tried if one fails.
+*/
+
+#ifndef AUBIO_SOURCE_IO_PRIV_H
+#define AUBIO_SOURCE_IO_PRIV_H
+
+/** byte stream */
+typedef struct _aubio_source_io_t aubio_source_io_t;
+
+/** create a stream reading through callbacks
+
+  \param callbacks functions to read from, copied
+  \param user_data pointer passed to the callbacks
+
+  \return the new stream, or NULL if callbacks has no read function
+
+*/
+aubio_source_io_t *new_aubio_source_io (const aubio_source_callbacks_t
+    * callbacks, void *user_data);
+
+/** create a stream reading from memory
+
+  \param data bytes to read from, not copied
+  \param size number of bytes in data
+
+  \return the new stream
+
+*/
+aubio_source_io_t *new_aubio_source_io_memory (const void *data, uint_t size);
+
+/** read up to size bytes, returns less than size only at the end of the
+  stream or after an error */
+size_t aubio_source_io_read (aubio_source_io_t * io, void *buf, size_t size);
+
+/** move to offset bytes relative to whence, one of SEEK_SET, SEEK_CUR or
+  SEEK_END, returns 0 on success */
+uint_t aubio_source_io_seek (aubio_source_io_t * io, long long offset,
+    int whence);
+
+/** get the current position, in bytes */
+long long aubio_source_io_tell (const aubio_source_io_t * io);
+
+/** get the size of the stream in bytes, or -1 if it is unknown */
+long long aubio_source_io_get_size (aubio_source_io_t * io);
+
+/** returns 1 once a read stopped before the end of its buffer */
+uint_t aubio_source_io_at_end (const aubio_source_io_t * io);
+
+/** get the bytes of a memory stream, or NULL for other streams */
+const unsigned char *aubio_source_io_get_data (const aubio_source_io_t * io);
+
+/** get a name for the stream, to use in place of a path in messages */
+const char_t *aubio_source_io_get_name (const aubio_source_io_t * io);
+
+void del_aubio_source_io (aubio_source_io_t * io);
+
+/* sources reading from a stream, see the constructors taking a path */
+
+#ifdef HAVE_LIBAV
+struct _aubio_source_avcodec_t *new_aubio_source_avcodec_io (
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size);
+#endif /* HAVE_LIBAV */
+
+#ifdef HAVE_SNDFILE
+struct _aubio_source_sndfile_t *new_aubio_source_sndfile_io (
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size);
+#endif /* HAVE_SNDFILE */
+
+#ifdef HAVE_WAVREAD
+struct _aubio_source_wavread_t *new_aubio_source_wavread_io (
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size);
+#endif /* HAVE_WAVREAD */
+
+#endif /* AUBIO_SOURCE_IO_PRIV_H */
@@ -0,0 +1,323 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "io/ioutils.h"
+#include "io/source_prefetch_priv.h"
+#include "io/iothread_priv.h"
+
+/** number of hops read ahead when queue_frames is 0 */
+#define AUBIO_PREFETCH_DEFAULT_HOPS 16
+
+struct _aubio_source_prefetch_t {
+  aubio_source_t *source;       /**< wrapped source, only used by the thread
+                                     while it is running */
+  char_t *path;                 /**< uri, for error messages */
+  uint_t hop_size;
+  uint_t samplerate;
+  uint_t channels;
+  uint_t duration;
+
+  fmat_t **slots;               /**< ring of hops, channels x hop_size */
+  uint_t *slot_read;            /**< number of frames read in each slot */
+  uint_t n_slots;
+  uint_t slot_offset;           /**< frames of the tail slot already read */
+
+  /* all the fields below are protected by mutex */
+  uint_t head;                  /**< next slot to be filled by the thread */
+  uint_t tail;                  /**< next slot to be read by the caller */
+  uint_t count;                 /**< number of filled slots */
+  uint_t eof;                   /**< 1 once the thread got a short read */
+  uint_t seeking;               /**< 1 while the caller waits to seek */
+  uint_t paused;                /**< 1 once the thread stopped for seeking */
+  uint_t quit;                  /**< 1 once the thread was asked to stop */
+
+  uint_t started;               /**< 1 if mutex and cond were initialised */
+  uint_t running;               /**< 1 until the thread was joined */
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  aubio_io_thread_t thread;
+};
+
+static void aubio_source_prefetch_run (aubio_source_prefetch_t * s)
+{
+  uint_t slot, read;
+  AUBIO_IO_LOCK(s);
+  while (!s->quit) {
+    if (s->seeking) {
+      // let the caller access the source
+      s->paused = 1;
+      AUBIO_IO_WAKE(s);
+      AUBIO_IO_WAIT(s);
+      continue;
+    }
+    if (s->eof || s->count == s->n_slots) {
+      AUBIO_IO_WAIT(s);
+      continue;
+    }
+    slot = s->head;
+    AUBIO_IO_UNLOCK(s);
+    // the caller does not touch this slot until count is incremented
+    read = 0;
+    aubio_source_do_multi(s->source, s->slots[slot], &read);
+    AUBIO_IO_LOCK(s);
+    s->slot_read[slot] = read;
+    s->head = (s->head + 1) % s->n_slots;
+    s->count++;
+    if (read < s->hop_size) s->eof = 1;
+    AUBIO_IO_WAKE(s);
+  }
+  AUBIO_IO_UNLOCK(s);
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_source_prefetch_thread)
+{
+  aubio_source_prefetch_run((aubio_source_prefetch_t *)arg);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+static void aubio_source_prefetch_stop (aubio_source_prefetch_t * s)
+{
+  if (!s->running) return;
+  AUBIO_IO_LOCK(s);
+  s->quit = 1;
+  AUBIO_IO_WAKE(s);
+  AUBIO_IO_UNLOCK(s);
+  AUBIO_IO_THREAD_JOIN(s);
+  s->running = 0;
+}
+
+aubio_source_prefetch_t *new_aubio_source_prefetch_from (
+    aubio_source_t * source, const char_t * uri, uint_t hop_size,
+    uint_t queue_frames)
+{
+  aubio_source_prefetch_t *s = AUBIO_NEW(aubio_source_prefetch_t);
+  uint_t i;
+
+  s->source = source;
+  s->path = AUBIO_ARRAY(char_t, strnlen(uri, PATH_MAX) + 1);
+  strncpy(s->path, uri, strnlen(uri, PATH_MAX) + 1);
+  s->hop_size = hop_size;
+  s->samplerate = aubio_source_get_samplerate(source);
+  s->channels = aubio_source_get_channels(source);
+  s->duration = aubio_source_get_duration(source);
+
+  if (queue_frames == 0) {
+    s->n_slots = AUBIO_PREFETCH_DEFAULT_HOPS;
+  } else {
+    s->n_slots = MAX(2, (queue_frames + hop_size - 1) / hop_size);
+  }
+  // no need for more slots than hops in the source
+  if (s->duration > 0) {
+    s->n_slots = MIN(s->n_slots, MAX(2, s->duration / hop_size + 1));
+  }
+  s->slots = AUBIO_ARRAY(fmat_t *, s->n_slots);
+  s->slot_read = AUBIO_ARRAY(uint_t, s->n_slots);
+  for (i = 0; i < s->n_slots; i++) {
+    s->slots[i] = new_fmat(s->channels, hop_size);
+    if (!s->slots[i]) goto beach;
+  }
+
+  AUBIO_IO_THREAD_INIT(s);
+  s->running = AUBIO_IO_THREAD_START(s, aubio_source_prefetch_thread,
+      AUBIO_THREAD_IO);
+  s->started = 1;
+  if (!s->running) {
+    AUBIO_ERR("source_prefetch: failed starting thread for %s\n", uri);
+    goto beach;
+  }
+  return s;
+
+beach:
+  // the caller still owns source
+  s->source = NULL;
+  del_aubio_source_prefetch(s);
+  return NULL;
+}
+
+/* wait for the next hop, or return NULL at the end of the source */
+static const fmat_t *aubio_source_prefetch_next (aubio_source_prefetch_t * s,
+    uint_t * read)
+{
+  const fmat_t *block = NULL;
+  *read = 0;
+  if (!s->running) return NULL;
+  AUBIO_IO_LOCK(s);
+  while (s->count == 0 && !s->eof) {
+    AUBIO_IO_WAIT(s);
+  }
+  if (s->count > 0) {
+    block = s->slots[s->tail];
+    *read = s->slot_read[s->tail];
+  }
+  AUBIO_IO_UNLOCK(s);
+  return block;
+}
+
+/* give the slot returned by aubio_source_prefetch_next back to the thread */
+static void aubio_source_prefetch_release (aubio_source_prefetch_t * s)
+{
+  AUBIO_IO_LOCK(s);
+  s->tail = (s->tail + 1) % s->n_slots;
+  s->count--;
+  AUBIO_IO_WAKE(s);
+  AUBIO_IO_UNLOCK(s);
+}
+
+/* copy up to length frames from the queued hops, to a single row holding the
+   average of all channels if mono is set, or to the first height rows */
+static uint_t aubio_source_prefetch_copy (aubio_source_prefetch_t * s,
+    smpl_t ** rows, uint_t height, uint_t length, uint_t mono)
+{
+  uint_t i, j, n, block_read, total = 0;
+  const fmat_t *block;
+  while (total < length) {
+    block = aubio_source_prefetch_next(s, &block_read);
+    if (!block) break;
+    n = MIN(block_read - s->slot_offset, length - total);
+    if (mono) {
+      for (i = 0; i < n; i++) {
+        smpl_t sum = block->data[0][s->slot_offset + i];
+        for (j = 1; j < s->channels; j++) {
+          sum += block->data[j][s->slot_offset + i];
+        }
+        rows[0][total + i] = sum / (smpl_t)s->channels;
+      }
+    } else {
+      for (j = 0; j < height; j++) {
+        AUBIO_MEMCPY(rows[j] + total, block->data[j] + s->slot_offset,
+            n * sizeof(smpl_t));
+      }
+    }
+    total += n;
+    s->slot_offset += n;
+    if (s->slot_offset >= block_read) {
+      s->slot_offset = 0;
+      aubio_source_prefetch_release(s);
+    }
+  }
+  return total;
+}
+
+void aubio_source_prefetch_do (aubio_source_prefetch_t * s, fvec_t * read_to,
+    uint_t * read)
+{
+  uint_t length = aubio_source_validate_input_length("source_prefetch",
+      s->path, s->hop_size, read_to->length);
+  uint_t block_read = aubio_source_prefetch_copy(s, &read_to->data, 1,
+      length, 1);
+  aubio_source_pad_output(read_to, block_read);
+  *read = block_read;
+}
+
+void aubio_source_prefetch_do_multi (aubio_source_prefetch_t * s,
+    fmat_t * read_to, uint_t * read)
+{
+  uint_t length = aubio_source_validate_input_length("source_prefetch",
+      s->path, s->hop_size, read_to->length);
+  uint_t channels = aubio_source_validate_input_channels("source_prefetch",
+      s->path, s->channels, read_to->height);
+  uint_t block_read = aubio_source_prefetch_copy(s, read_to->data, channels,
+      length, 0);
+  aubio_source_pad_multi_output(read_to, s->channels, block_read);
+  *read = block_read;
+}
+
+void aubio_source_prefetch_read_into (aubio_source_prefetch_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read)
+{
+  fmat_t block = *read_to;
+  block.length = MIN(max_frames, read_to->length);
+  *read = aubio_source_prefetch_copy(s, read_to->data,
+      MIN(s->channels, read_to->height), block.length, 0);
+  aubio_source_pad_multi_output(&block, s->channels, *read);
+}
+
+uint_t aubio_source_prefetch_get_samplerate (aubio_source_prefetch_t * s)
+{
+  return s->samplerate;
+}
+
+uint_t aubio_source_prefetch_get_channels (aubio_source_prefetch_t * s)
+{
+  return s->channels;
+}
+
+uint_t aubio_source_prefetch_get_duration (aubio_source_prefetch_t * s)
+{
+  return s->duration;
+}
+
+uint_t aubio_source_prefetch_seek (aubio_source_prefetch_t * s, uint_t pos)
+{
+  uint_t ret;
+  if (!s->running) return aubio_source_seek(s->source, pos);
+  // wait for the thread to finish its current read
+  AUBIO_IO_LOCK(s);
+  s->seeking = 1;
+  AUBIO_IO_WAKE(s);
+  while (!s->paused) {
+    AUBIO_IO_WAIT(s);
+  }
+  AUBIO_IO_UNLOCK(s);
+  ret = aubio_source_seek(s->source, pos);
+  // drop the hops read before seeking and resume reading ahead
+  AUBIO_IO_LOCK(s);
+  s->head = s->tail = s->count = 0;
+  s->slot_offset = 0;
+  s->eof = 0;
+  s->seeking = 0;
+  s->paused = 0;
+  AUBIO_IO_WAKE(s);
+  AUBIO_IO_UNLOCK(s);
+  return ret;
+}
+
+uint_t aubio_source_prefetch_close (aubio_source_prefetch_t * s)
+{
+  aubio_source_prefetch_stop(s);
+  return aubio_source_close(s->source);
+}
+
+void del_aubio_source_prefetch (aubio_source_prefetch_t * s)
+{
+  uint_t i;
+  AUBIO_ASSERT(s);
+  aubio_source_prefetch_stop(s);
+  if (s->started)
+    AUBIO_IO_THREAD_DESTROY(s);
+  if (s->source)
+    del_aubio_source(s->source);
+  if (s->slots) {
+    for (i = 0; i < s->n_slots; i++) {
+      if (s->slots[i])
+        del_fmat(s->slots[i]);
+    }
+    AUBIO_FREE(s->slots);
+  }
+  if (s->slot_read)
+    AUBIO_FREE(s->slot_read);
+  if (s->path)
+    AUBIO_FREE(s->path);
+  AUBIO_FREE(s);
+}
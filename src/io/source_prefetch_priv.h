@@ -0,0 +1,71 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Read-ahead wrapper used by new_aubio_source_prefetch() in io/source.c.
+
+   A background thread reads consecutive hops from the wrapped source into a
+   ring with one producer, the thread, and one consumer, the caller of
+   aubio_source_prefetch_do(). The lock is only held to update the ring
+   indices, never while decoding or copying samples.
+*/
+
+#ifndef AUBIO_SOURCE_PREFETCH_PRIV_H
+#define AUBIO_SOURCE_PREFETCH_PRIV_H
+
+/** read-ahead wrapper around a source */
+typedef struct _aubio_source_prefetch_t aubio_source_prefetch_t;
+
+/** start reading ahead from source
+
+  \param source source to read from, owned by the new object
+  \param uri path of the source, for error messages
+  \param hop_size number of frames read by each call to `source`
+  \param queue_frames number of frames to read ahead, 0 for a default
+
+  \return the new object, or NULL if the thread could not be started, in
+  which case `source` is left untouched
+
+*/
+aubio_source_prefetch_t *new_aubio_source_prefetch_from (
+    aubio_source_t * source, const char_t * uri, uint_t hop_size,
+    uint_t queue_frames);
+
+void aubio_source_prefetch_do (aubio_source_prefetch_t * s, fvec_t * read_to,
+    uint_t * read);
+
+void aubio_source_prefetch_do_multi (aubio_source_prefetch_t * s,
+    fmat_t * read_to, uint_t * read);
+
+void aubio_source_prefetch_read_into (aubio_source_prefetch_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read);
+
+uint_t aubio_source_prefetch_get_samplerate (aubio_source_prefetch_t * s);
+
+uint_t aubio_source_prefetch_get_channels (aubio_source_prefetch_t * s);
+
+uint_t aubio_source_prefetch_get_duration (aubio_source_prefetch_t * s);
+
+uint_t aubio_source_prefetch_seek (aubio_source_prefetch_t * s, uint_t pos);
+
+uint_t aubio_source_prefetch_close (aubio_source_prefetch_t * s);
+
+void del_aubio_source_prefetch (aubio_source_prefetch_t * s);
+
+#endif /* AUBIO_SOURCE_PREFETCH_PRIV_H */
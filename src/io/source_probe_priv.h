@@ -0,0 +1,51 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Header readers used by aubio_source_probe() in io/source.c.
+
+   Each built-in backend reads the samplerate, channels and duration of a file
+   without creating its decoder or buffers. They return 0 on success, and fail
+   without printing anything, so that the next backend can be tried.
+*/
+
+#ifndef AUBIO_SOURCE_PROBE_PRIV_H
+#define AUBIO_SOURCE_PROBE_PRIV_H
+
+#ifdef HAVE_LIBAV
+uint_t aubio_source_avcodec_probe (const char_t * path,
+    aubio_source_info_t * info);
+#endif /* HAVE_LIBAV */
+
+#ifdef HAVE_SOURCE_APPLE_AUDIO
+uint_t aubio_source_apple_audio_probe (const char_t * path,
+    aubio_source_info_t * info);
+#endif /* HAVE_SOURCE_APPLE_AUDIO */
+
+#ifdef HAVE_SNDFILE
+uint_t aubio_source_sndfile_probe (const char_t * path,
+    aubio_source_info_t * info);
+#endif /* HAVE_SNDFILE */
+
+#ifdef HAVE_WAVREAD
+uint_t aubio_source_wavread_probe (const char_t * path,
+    aubio_source_info_t * info);
+#endif /* HAVE_WAVREAD */
+
+#endif /* AUBIO_SOURCE_PROBE_PRIV_H */
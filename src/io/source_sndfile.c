@@ -23,17 +23,25 @@
 #ifdef HAVE_SNDFILE
 
 #include <sndfile.h>
+#include "io/lazy_sndfile_priv.h"
 
 #include "fvec.h"
 #include "fmat.h"
 #include "ioutils.h"
+#include "ioutils_priv.h"
 #include "source_sndfile.h"
+#include "source.h"
+#include "source_io_priv.h"
+#include "source_probe_priv.h"
 
 #include "temporal/resampler.h"
 
 #define MAX_SIZE 4096
 #define MAX_SAMPLES AUBIO_MAX_CHANNELS * MAX_SIZE
 
+/** frames read from libsndfile at once, at least input_hop_size */
+#define AUBIO_SNDFILE_READ_FRAMES 8192
+
 #if !HAVE_AUBIO_DOUBLE
 #define aubio_sf_read_smpl sf_read_float
 #else /* HAVE_AUBIO_DOUBLE */
@@ -56,23 +64,83 @@ struct _aubio_source_sndfile_t {
   // resampling stuff
   smpl_t ratio;
   uint_t input_hop_size;
-#ifdef HAVE_SAMPLERATE
-  aubio_resampler_t **resamplers;
+  aubio_resampler_t *resampler;
   fvec_t *input_data;
   fmat_t *input_mat;
-#endif /* HAVE_SAMPLERATE */
+  sf_count_t read_frames;       // frames read since the last seek
+  sf_count_t resampled_frames;  // frames resampled since the last seek
 
-  // some temporary memory for sndfile to write at
-  uint_t scratch_size;
+  // interleaved frames read ahead from sndfile, used as a fifo
+  uint_t scratch_size;          // number of frames scratch_data holds
   smpl_t *scratch_data;
+  uint_t scratch_start;         // first frame not consumed yet
+  uint_t scratch_end;           // number of frames read in scratch_data
 };
 
+static sf_count_t aubio_source_sndfile_vio_get_filelen (void *io)
+{
+  return aubio_source_io_get_size((aubio_source_io_t *)io);
+}
+
+static sf_count_t aubio_source_sndfile_vio_seek (sf_count_t offset,
+    int whence, void *io)
+{
+  if (aubio_source_io_seek((aubio_source_io_t *)io, offset, whence) != 0) {
+    return -1;
+  }
+  return aubio_source_io_tell((aubio_source_io_t *)io);
+}
+
+static sf_count_t aubio_source_sndfile_vio_read (void *ptr, sf_count_t count,
+    void *io)
+{
+  return aubio_source_io_read((aubio_source_io_t *)io, ptr, count);
+}
+
+static sf_count_t aubio_source_sndfile_vio_write (const void *ptr,
+    sf_count_t count, void *io)
+{
+  (void)ptr; (void)count; (void)io;
+  return 0;
+}
+
+static sf_count_t aubio_source_sndfile_vio_tell (void *io)
+{
+  return aubio_source_io_tell((aubio_source_io_t *)io);
+}
+
+static SF_VIRTUAL_IO aubio_source_sndfile_vio = {
+  aubio_source_sndfile_vio_get_filelen,
+  aubio_source_sndfile_vio_seek,
+  aubio_source_sndfile_vio_read,
+  aubio_source_sndfile_vio_write,
+  aubio_source_sndfile_vio_tell
+};
+
+static aubio_source_sndfile_t * aubio_source_sndfile_open (const char_t * path,
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size);
+
 aubio_source_sndfile_t * new_aubio_source_sndfile(const char_t * path, uint_t samplerate, uint_t hop_size) {
+  return aubio_source_sndfile_open(path, NULL, samplerate, hop_size);
+}
+
+aubio_source_sndfile_t * new_aubio_source_sndfile_io (aubio_source_io_t * io,
+    uint_t samplerate, uint_t hop_size) {
+  return aubio_source_sndfile_open(aubio_source_io_get_name(io), io,
+      samplerate, hop_size);
+}
+
+static aubio_source_sndfile_t * aubio_source_sndfile_open (const char_t * path,
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size) {
   aubio_source_sndfile_t * s = AUBIO_NEW(aubio_source_sndfile_t);
   
   if (!s) {
     return NULL;
   }
+  if (aubio_sndfile_load()) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
   SF_INFO sfinfo;
 
   if (path == NULL) {
@@ -96,7 +164,16 @@ aubio_source_sndfile_t * new_aubio_source_sndfile(const char_t * path, uint_t sa
 
   // try opening the file, getting the info in sfinfo
   AUBIO_MEMSET(&sfinfo, 0, sizeof (sfinfo));
-  s->handle = sf_open (s->path, SFM_READ, &sfinfo);
+  if (io) {
+    if (aubio_source_io_seek(io, 0, SEEK_SET) != 0) {
+      AUBIO_ERR("source_sndfile: Failed rewinding %s\n", s->path);
+      goto beach;
+    }
+    s->handle = sf_open_virtual (&aubio_source_sndfile_vio, SFM_READ, &sfinfo,
+        io);
+  } else {
+    s->handle = sf_open (s->path, SFM_READ, &sfinfo);
+  }
 
   if (s->handle == NULL) {
     /* show libsndfile err msg */
@@ -119,7 +196,11 @@ aubio_source_sndfile_t * new_aubio_source_sndfile(const char_t * path, uint_t sa
   }
   /* compute input block size required before resampling */
   s->ratio = s->samplerate/(smpl_t)s->input_samplerate;
-  s->input_hop_size = (uint_t)FLOOR(s->hop_size / s->ratio + .5);
+  s->input_hop_size = s->hop_size;
+  if (s->ratio != 1) {
+    // the most frames read for one block of hop_size resampled frames
+    s->input_hop_size = (uint_t)CEIL(s->hop_size / s->ratio) + 1;
+  }
 
   if (s->input_hop_size * s->input_channels > MAX_SAMPLES) {
     AUBIO_ERR("source_sndfile: Not able to process more than %d frames of %d channels\n",
@@ -127,40 +208,27 @@ aubio_source_sndfile_t * new_aubio_source_sndfile(const char_t * path, uint_t sa
     goto beach;
   }
 
-#ifdef HAVE_SAMPLERATE
-  s->input_data = NULL;
-  s->input_mat = NULL;
-  s->resamplers = NULL;
   if (s->ratio != 1) {
-    uint_t i;
-    s->resamplers = AUBIO_ARRAY(aubio_resampler_t*, s->input_channels);
+    // a single resampler for all the channels
+    s->resampler = new_aubio_resampler(s->ratio, 4);
+    if (!s->resampler) {
+      AUBIO_ERR("source_sndfile: can not resample %s from %d to %d\n", s->path,
+          s->input_samplerate, s->samplerate);
+      goto beach;
+    }
     s->input_data = new_fvec(s->input_hop_size);
     s->input_mat = new_fmat(s->input_channels, s->input_hop_size);
-    for (i = 0; i < (uint_t)s->input_channels; i++) {
-      s->resamplers[i] = new_aubio_resampler(s->ratio, 4);
-    }
     if (s->ratio > 1) {
-      // we would need to add a ring buffer for these
-      if ( (uint_t)FLOOR(s->input_hop_size * s->ratio + .5)  != s->hop_size ) {
-        AUBIO_ERR("source_sndfile: can not upsample %s from %d to %d\n", s->path,
-            s->input_samplerate, s->samplerate);
-        goto beach;
-      }
       AUBIO_WRN("source_sndfile: upsampling %s from %d to %d\n", s->path,
           s->input_samplerate, s->samplerate);
     }
     s->duration = (uint_t)FLOOR(s->duration * s->ratio);
   }
-#else
-  if (s->ratio != 1) {
-    AUBIO_ERR("source_sndfile: aubio was compiled without aubio_resampler\n");
-    goto beach;
-  }
-#endif /* HAVE_SAMPLERATE */
 
-  /* allocate data for de/interleaving reallocated when needed. */
-  s->scratch_size = s->input_hop_size * s->input_channels;
-  s->scratch_data = AUBIO_ARRAY(smpl_t, s->scratch_size);
+  /* allocate the frames read ahead, deinterleaved a block at a time */
+  s->scratch_size = MAX(s->input_hop_size, AUBIO_SNDFILE_READ_FRAMES);
+  s->scratch_data = AUBIO_ARRAY(smpl_t, s->scratch_size * s->input_channels);
+  if (!s->scratch_data) goto beach;
 
   return s;
 
@@ -171,14 +239,67 @@ beach:
   return NULL;
 }
 
+/* get up to frames interleaved frames, reading a large block from the file
+   when fewer are left in scratch_data; returns the first of them, and sets
+   read to their number, less than frames only at the end of the file */
+static const smpl_t *aubio_source_sndfile_read_frames(aubio_source_sndfile_t * s,
+    uint_t frames, uint_t * read) {
+  uint_t channels = s->input_channels;
+  const smpl_t *start;
+  frames = MIN(frames, s->scratch_size);
+  if (s->scratch_end - s->scratch_start < frames) {
+    sf_count_t read_samples;
+    uint_t left = s->scratch_end - s->scratch_start;
+    // move the frames left to the start, then fill the rest of the buffer
+    if (left && s->scratch_start) {
+      memmove(s->scratch_data, s->scratch_data + s->scratch_start * channels,
+          left * channels * sizeof(smpl_t));
+    }
+    read_samples = aubio_sf_read_smpl (s->handle,
+        s->scratch_data + left * channels,
+        (sf_count_t)(s->scratch_size - left) * channels);
+    s->scratch_start = 0;
+    s->scratch_end = left + (uint_t)(MAX(0, read_samples) / channels);
+  }
+  *read = MIN(frames, s->scratch_end - s->scratch_start);
+  start = s->scratch_data + s->scratch_start * channels;
+  s->scratch_start += *read;
+  return start;
+}
+
+/* number of frames to read from the file for the next length resampled frames,
+   so that the resampler gets as much input as its output needs */
+static uint_t aubio_source_sndfile_input_length(aubio_source_sndfile_t * s,
+    uint_t length) {
+  sf_count_t end = ((s->resampled_frames + length) * s->input_samplerate
+      + s->samplerate - 1) / s->samplerate;
+  return (uint_t)MIN(end - s->read_frames, (sf_count_t)s->input_hop_size);
+}
+
+/* number of valid resampled frames, once read_length of the frames requested
+   were read from the file */
+static uint_t aubio_source_sndfile_resampled_length(aubio_source_sndfile_t * s,
+    uint_t frames, uint_t read_length, uint_t length) {
+  sf_count_t end;
+  s->read_frames += frames;
+  s->resampled_frames += length;
+  if (read_length == frames) return length;
+  // end of file, count the frames of output covered by the input
+  end = ((s->read_frames - frames + read_length) * s->samplerate
+      + s->input_samplerate / 2) / s->input_samplerate;
+  end -= s->resampled_frames - length;
+  return (uint_t)MAX(0, MIN(end, (sf_count_t)length));
+}
+
 void aubio_source_sndfile_do(aubio_source_sndfile_t * s, fvec_t * read_data, uint_t * read){
-  uint_t i,j, input_channels = s->input_channels;
+  uint_t input_channels = s->input_channels;
   /* read from file into scratch_data */
   uint_t length = aubio_source_validate_input_length("source_sndfile", s->path,
       s->hop_size, read_data->length);
-  sf_count_t read_samples = aubio_sf_read_smpl (s->handle, s->scratch_data,
-      s->scratch_size);
-  uint_t read_length = read_samples / s->input_channels;
+  uint_t frames = s->resampler ? aubio_source_sndfile_input_length(s, length)
+    : length;
+  uint_t read_length;
+  const smpl_t *frames_data;
 
   /* where to store de-interleaved data */
   smpl_t *ptr_data;
@@ -189,51 +310,56 @@ void aubio_source_sndfile_do(aubio_source_sndfile_t * s, fvec_t * read_data, uin
     *read = 0;
     return;
   }
+  frames_data = aubio_source_sndfile_read_frames(s, frames, &read_length);
 
-#ifdef HAVE_SAMPLERATE
-  if (s->ratio != 1) {
+  if (s->resampler) {
     ptr_data = s->input_data->data;
-  } else
-#endif /* HAVE_SAMPLERATE */
-  {
-    read_length = MIN(length, read_length);
+  } else {
     ptr_data = read_data->data;
   }
 
   /* de-interleaving and down-mixing data  */
-  for (j = 0; j < read_length; j++) {
-    ptr_data[j] = 0;
-    for (i = 0; i < input_channels; i++) {
-      ptr_data[j] += s->scratch_data[input_channels*j+i];
+  aubio_io_downmix (aubio_io_smpl, frames_data, input_channels, ptr_data,
+      read_length);
+
+  if (s->resampler) {
+    fvec_t input, output;
+    uint_t j;
+    // silence after the end of the file
+    for (j = read_length; j < frames; j++) {
+      ptr_data[j] = 0.;
     }
-    ptr_data[j] /= (smpl_t)input_channels;
-  }
-
-#ifdef HAVE_SAMPLERATE
-  if (s->resamplers) {
-    aubio_resampler_do(s->resamplers[0], s->input_data, read_data);
+    input.data = ptr_data;
+    input.length = frames;
+    output.data = read_data->data;
+    output.length = length;
+    aubio_resampler_do(s->resampler, &input, &output);
+    *read = aubio_source_sndfile_resampled_length(s, frames, read_length,
+        length);
+  } else {
+    *read = read_length;
   }
-#endif /* HAVE_SAMPLERATE */
-
-  *read = MIN(length, (uint_t)FLOOR(s->ratio * read_length + .5));
 
   aubio_source_pad_output (read_data, *read);
 
 }
 
 void aubio_source_sndfile_do_multi(aubio_source_sndfile_t * s, fmat_t * read_data, uint_t * read){
-  uint_t i,j, input_channels = s->input_channels;
+  uint_t input_channels = s->input_channels;
   /* do actual reading */
   uint_t length = aubio_source_validate_input_length("source_sndfile", s->path,
       s->hop_size, read_data->length);
-  uint_t channels = aubio_source_validate_input_channels("source_sndfile",
-      s->path, s->input_channels, read_data->height);
-  sf_count_t read_samples = aubio_sf_read_smpl (s->handle, s->scratch_data,
-      s->scratch_size);
-  uint_t read_length = read_samples / s->input_channels;
+  uint_t frames = s->resampler ? aubio_source_sndfile_input_length(s, length)
+    : length;
+  uint_t read_length;
+  const smpl_t *frames_data;
 
   /* where to store de-interleaved data */
-  smpl_t **ptr_data;
+  fmat_t *ptr_data;
+
+  // only warns, aubio_io_deinterleave writes at most read_data->height rows
+  aubio_source_validate_input_channels("source_sndfile", s->path,
+      s->input_channels, read_data->height);
 
   if (!s->handle) {
     AUBIO_ERR("source_sndfile: could not read from %s (file was closed)\n",
@@ -241,39 +367,92 @@ void aubio_source_sndfile_do_multi(aubio_source_sndfile_t * s, fmat_t * read_dat
     *read = 0;
     return;
   }
+  frames_data = aubio_source_sndfile_read_frames(s, frames, &read_length);
 
-#ifdef HAVE_SAMPLERATE
-  if (s->ratio != 1) {
-    ptr_data = s->input_mat->data;
-  } else
-#endif /* HAVE_SAMPLERATE */
-  {
-    read_length = MIN(read_length, length);
-    ptr_data = read_data->data;
+  if (s->resampler) {
+    ptr_data = s->input_mat;
+  } else {
+    ptr_data = read_data;
   }
 
-  for (j = 0; j < read_length; j++) {
-    for (i = 0; i < channels; i++) {
-      ptr_data[i][j] = s->scratch_data[j * input_channels + i];
+  aubio_io_deinterleave (aubio_io_smpl, frames_data, input_channels,
+      ptr_data, 0, read_length);
+
+  if (s->resampler) {
+    fmat_t input, output;
+    uint_t i, j;
+    // silence after the end of the file
+    for (i = 0; i < input_channels; i++) {
+      for (j = read_length; j < frames; j++) {
+        ptr_data->data[i][j] = 0.;
+      }
     }
+    // resample the channels of the file, those missing in read_data are
+    // padded below
+    input = *s->input_mat;
+    input.length = frames;
+    input.height = MIN(input_channels, read_data->height);
+    output = *read_data;
+    output.length = length;
+    output.height = input.height;
+    aubio_resampler_do_multi(s->resampler, &input, &output);
+    *read = aubio_source_sndfile_resampled_length(s, frames, read_length,
+        length);
+  } else {
+    *read = read_length;
   }
 
-#ifdef HAVE_SAMPLERATE
-  if (s->resamplers) {
-    for (i = 0; i < input_channels; i++) {
-      fvec_t input_chan, read_chan;
-      input_chan.data = s->input_mat->data[i];
-      input_chan.length = s->input_mat->length;
-      read_chan.data = read_data->data[i];
-      read_chan.length = read_data->length;
-      aubio_resampler_do(s->resamplers[i], &input_chan, &read_chan);
+  aubio_source_pad_multi_output(read_data, input_channels, *read);
+}
+
+void aubio_source_sndfile_read_into(aubio_source_sndfile_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read){
+  uint_t block_read = 0, total = 0;
+  uint_t length = MIN(max_frames, read_to->length);
+  fmat_t block = *read_to;
+
+  *read = 0;
+  if (!s->handle) {
+    AUBIO_ERR("source_sndfile: could not read from %s (file was closed)\n",
+        s->path);
+    return;
+  }
+
+  if (s->resampler) {
+    // resample blocks of at most hop_size frames, read them in place
+    uint_t j;
+    block.data = AUBIO_ARRAY(smpl_t *, read_to->height);
+    if (!block.data) return;
+    while (total < length) {
+      for (j = 0; j < read_to->height; j++) {
+        block.data[j] = read_to->data[j] + total;
+      }
+      block.length = MIN(s->hop_size, length - total);
+      aubio_source_sndfile_do_multi(s, &block, &block_read);
+      total += block_read;
+      if (block_read < block.length) break;
     }
+    AUBIO_FREE(block.data);
+    block = *read_to;
+    block.length = length;
+    aubio_source_pad_multi_output(&block, s->input_channels, total);
+    *read = total;
+    return;
   }
-#endif /* HAVE_SAMPLERATE */
 
-  *read = MIN(length, (uint_t)FLOOR(s->ratio * read_length + .5));
+  block.length = length;
+  while (total < length) {
+    uint_t chunk = MIN(length - total, s->scratch_size);
+    const smpl_t *frames_data = aubio_source_sndfile_read_frames(s, chunk,
+        &block_read);
+    aubio_io_deinterleave (aubio_io_smpl, frames_data, s->input_channels,
+        &block, total, block_read);
+    total += block_read;
+    if (block_read < chunk) break;
+  }
 
-  aubio_source_pad_multi_output(read_data, input_channels, *read);
+  aubio_source_pad_multi_output(&block, s->input_channels, total);
+  *read = total;
 }
 
 uint_t aubio_source_sndfile_get_samplerate(aubio_source_sndfile_t * s) {
@@ -314,6 +493,14 @@ uint_t aubio_source_sndfile_seek (aubio_source_sndfile_t * s, uint_t pos) {
         s->path, resampled_pos, (uint_t)sf_ret, sf_strerror (NULL));
     return AUBIO_FAIL;
   }
+  // drop the frames read ahead
+  s->scratch_start = s->scratch_end = 0;
+  if (s->resampler) {
+    // start resampling again from the new position
+    s->read_frames = 0;
+    s->resampled_frames = 0;
+    if (aubio_resampler_reset(s->resampler)) return AUBIO_FAIL;
+  }
   return AUBIO_OK;
 }
 
@@ -332,15 +519,8 @@ uint_t aubio_source_sndfile_close (aubio_source_sndfile_t *s) {
 void del_aubio_source_sndfile(aubio_source_sndfile_t * s){
   AUBIO_ASSERT(s);
   aubio_source_sndfile_close(s);
-#ifdef HAVE_SAMPLERATE
-  if (s->resamplers != NULL) {
-    uint_t i = 0, input_channels = s->input_channels;
-    for (i = 0; i < input_channels; i ++) {
-      if (s->resamplers[i] != NULL) {
-        del_aubio_resampler(s->resamplers[i]);
-      }
-    }
-    AUBIO_FREE(s->resamplers);
+  if (s->resampler) {
+    del_aubio_resampler(s->resampler);
   }
   if (s->input_data) {
     del_fvec(s->input_data);
@@ -348,10 +528,28 @@ void del_aubio_source_sndfile(aubio_source_sndfile_t * s){
   if (s->input_mat) {
     del_fmat(s->input_mat);
   }
-#endif /* HAVE_SAMPLERATE */
   if (s->path) AUBIO_FREE(s->path);
-  AUBIO_FREE(s->scratch_data);
+  if (s->scratch_data) AUBIO_FREE(s->scratch_data);
   AUBIO_FREE(s);
 }
 
+
+uint_t aubio_source_sndfile_probe (const char_t * path,
+    aubio_source_info_t * info)
+{
+  SF_INFO sfinfo;
+  SNDFILE *handle;
+  if (aubio_sndfile_load()) return AUBIO_FAIL;
+  AUBIO_MEMSET(&sfinfo, 0, sizeof (sfinfo));
+  // sf_open only parses the header
+  handle = sf_open (path, SFM_READ, &sfinfo);
+  if (handle == NULL) return AUBIO_FAIL;
+  sf_close (handle);
+  if (sfinfo.samplerate <= 0 || sfinfo.channels <= 0) return AUBIO_FAIL;
+  info->samplerate = sfinfo.samplerate;
+  info->channels = sfinfo.channels;
+  info->duration = sfinfo.frames > 0 ? MIN(sfinfo.frames, UINT_MAX) : 0;
+  return AUBIO_OK;
+}
+
 #endif /* HAVE_SNDFILE */
@@ -86,6 +86,24 @@ void aubio_source_sndfile_do(aubio_source_sndfile_t * s, fvec_t * read_to, uint_
 */
 void aubio_source_sndfile_do_multi(aubio_source_sndfile_t * s, fmat_t * read_to, uint_t * read);
 
+/**
+
+  read up to max_frames frames from source object
+
+  \param s source object, created with ::new_aubio_source_sndfile
+  \param read_to ::fmat_t of data to read to
+  \param max_frames maximum number of frames to read, at most the length of
+  `read_to`
+  \param read upon returns, equals to number of frames actually read
+
+  Same as ::aubio_source_sndfile_do_multi, without limiting the number of
+  frames to `hop_size`. When resampling, frames are still resampled
+  `hop_size` at a time.
+
+*/
+void aubio_source_sndfile_read_into(aubio_source_sndfile_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read);
+
 /**
 
   get samplerate of source object
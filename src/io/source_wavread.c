@@ -25,11 +25,26 @@
 #include "fvec.h"
 #include "fmat.h"
 #include "ioutils.h"
+#include "ioutils_priv.h"
 #include "source_wavread.h"
+#include "source.h"
+#include "source_io_priv.h"
+#include "source_probe_priv.h"
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #define AUBIO_WAVREAD_BUFSIZE 1024
 
-//#define SHORT_TO_FLOAT(x) (smpl_t)(x * 3.0517578125e-05)
+// frames read at once from raw streams, often pipes
+#define AUBIO_WAVREAD_RAW_BUFSIZE 8192
+
+// AudioFormat codes
+#define AUBIO_WAVREAD_PCM 1
+#define AUBIO_WAVREAD_FLOAT 3
+#define AUBIO_WAVREAD_EXTENSIBLE 0xFFFE
 
 struct _aubio_source_wavread_t {
   uint_t hop_size;
@@ -43,6 +58,7 @@ struct _aubio_source_wavread_t {
 
   // internal stuff
   FILE *fid;
+  aubio_source_io_t *io;            /**< stream read instead of fid, or NULL */
 
   uint_t read_samples;
   uint_t blockalign;
@@ -55,7 +71,13 @@ struct _aubio_source_wavread_t {
   size_t seek_start;
 
   unsigned char *short_output;
-  fmat_t *output;
+  uint_t bufsize;                   /**< frames in short_output */
+  const unsigned char *frames;      /**< frames to decode, read_samples long */
+  aubio_io_format_t format;         /**< format of the samples */
+
+  void *map;                        /**< mapped file, or NULL */
+  size_t map_size;
+  uint_t mapped;                    /**< 1 if frames holds all the frames */
 };
 
 static unsigned int read_little_endian (unsigned char *buf,
@@ -71,7 +93,129 @@ static unsigned int read_little_endian (unsigned char *buf,
   return ret;
 }
 
+/* map the file in memory, so that frames are decoded from the mapped data */
+static void aubio_source_wavread_map (aubio_source_wavread_t *s);
+
+/* read count items of size bytes from the file or the stream */
+static size_t aubio_source_wavread_read (aubio_source_wavread_t *s, void *buf,
+    size_t size, size_t count)
+{
+  if (s->io) return aubio_source_io_read(s->io, buf, size * count) / size;
+  return fread(buf, size, count, s->fid);
+}
+
+static int aubio_source_wavread_fseek (aubio_source_wavread_t *s, size_t pos)
+{
+  if (s->io) return aubio_source_io_seek(s->io, pos, SEEK_SET);
+  return fseek(s->fid, pos, SEEK_SET);
+}
+
+static uint_t aubio_source_wavread_at_end (aubio_source_wavread_t *s)
+{
+  if (s->io) return aubio_source_io_at_end(s->io);
+  return feof(s->fid) || ferror(s->fid);
+}
+
+static aubio_source_wavread_t * aubio_source_wavread_open (const char_t * path,
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size);
+
 aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t samplerate, uint_t hop_size) {
+  return aubio_source_wavread_open(path, NULL, samplerate, hop_size);
+}
+
+aubio_source_wavread_t * new_aubio_source_wavread_io (aubio_source_io_t * io,
+    uint_t samplerate, uint_t hop_size) {
+  return aubio_source_wavread_open(aubio_source_io_get_name(io), io,
+      samplerate, hop_size);
+}
+
+/* make the next frames available, returns 0 at the end of the file */
+static uint_t aubio_source_wavread_refill (aubio_source_wavread_t *s);
+
+aubio_source_wavread_t * new_aubio_source_wavread_raw (const char_t * path,
+    const char_t * format, uint_t samplerate, uint_t channels,
+    uint_t hop_size)
+{
+  aubio_source_wavread_t * s = AUBIO_NEW(aubio_source_wavread_t);
+  if (!s) {
+    return NULL;
+  }
+  if (path == NULL || format == NULL) {
+    AUBIO_ERR("source_wavread: Aborted opening null path or format\n");
+    goto beach;
+  }
+  if ((sint_t)samplerate <= 0) {
+    AUBIO_ERR("source_wavread: Can not open %s with samplerate %d\n", path,
+        samplerate);
+    goto beach;
+  }
+  if ((sint_t)channels <= 0) {
+    AUBIO_ERR("source_wavread: Can not open %s with %d channels\n", path,
+        channels);
+    goto beach;
+  }
+  if ((sint_t)hop_size <= 0) {
+    AUBIO_ERR("source_wavread: Can not open %s with hop_size %d\n", path,
+        hop_size);
+    goto beach;
+  }
+  if (strcmp(format, "u8") == 0) {
+    s->format = aubio_io_u8;
+  } else if (strcmp(format, "s16") == 0) {
+    s->format = aubio_io_s16;
+  } else if (strcmp(format, "s24") == 0) {
+    s->format = aubio_io_s24;
+  } else if (strcmp(format, "s32") == 0) {
+    s->format = aubio_io_s32;
+  } else if (strcmp(format, "f32") == 0) {
+    s->format = aubio_io_f32;
+  } else if (strcmp(format, "f64") == 0) {
+    s->format = aubio_io_f64;
+  } else {
+    AUBIO_ERR("source_wavread: Can not open %s with unknown format '%s'\n",
+        path, format);
+    goto beach;
+  }
+
+  s->path = AUBIO_ARRAY(char_t, strnlen(path, PATH_MAX) + 1);
+  strncpy(s->path, path, strnlen(path, PATH_MAX) + 1);
+
+  if (strcmp(path, "-") == 0) {
+    s->fid = stdin;
+  } else {
+    s->fid = fopen((const char *)path, "rb");
+  }
+  if (!s->fid) {
+    AUBIO_STRERR("source_wavread: Failed opening %s (%s)\n", s->path, errorstr);
+    goto beach;
+  }
+
+  s->samplerate = s->input_samplerate = samplerate;
+  s->input_channels = channels;
+  s->hop_size = hop_size;
+  s->blockalign = channels * aubio_io_format_size(s->format);
+  s->bitspersample = 8 * aubio_io_format_size(s->format);
+  s->seek_start = 0;
+
+  // regular files are mapped, pipes read in large blocks
+  aubio_source_wavread_map(s);
+  if (s->mapped) {
+    s->duration = s->read_samples;
+  } else {
+    s->bufsize = AUBIO_WAVREAD_RAW_BUFSIZE;
+    s->short_output = AUBIO_ARRAY(unsigned char, s->blockalign * s->bufsize);
+    if (!s->short_output) goto beach;
+    s->frames = s->short_output;
+  }
+  return s;
+
+beach:
+  del_aubio_source_wavread(s);
+  return NULL;
+}
+
+static aubio_source_wavread_t * aubio_source_wavread_open (const char_t * path,
+    aubio_source_io_t * io, uint_t samplerate, uint_t hop_size) {
   aubio_source_wavread_t * s = AUBIO_NEW(aubio_source_wavread_t);
   
   if (!s) {
@@ -79,7 +223,8 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   }
   size_t bytes_read = 0, bytes_junk = 0, bytes_expected = 44;
   unsigned char buf[5] = "\0";
-  unsigned int format, channels, sr, byterate, blockalign, duration, bitspersample;//, data_size;
+  unsigned char ext[22];
+  unsigned int format, fmt_size, channels, sr, byterate, blockalign, duration, bitspersample;//, data_size;
 
   if (path == NULL) {
     AUBIO_ERR("source_wavread: Aborted opening null path\n");
@@ -100,14 +245,22 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   s->samplerate = samplerate;
   s->hop_size = hop_size;
 
-  s->fid = fopen((const char *)path, "rb");
-  if (!s->fid) {
-    AUBIO_STRERR("source_wavread: Failed opening %s (%s)\n", s->path, errorstr);
-    goto beach;
+  if (io) {
+    s->io = io;
+    if (aubio_source_io_seek(io, 0, SEEK_SET) != 0) {
+      AUBIO_ERR("source_wavread: Failed rewinding %s\n", s->path);
+      goto beach;
+    }
+  } else {
+    s->fid = fopen((const char *)path, "rb");
+    if (!s->fid) {
+      AUBIO_STRERR("source_wavread: Failed opening %s (%s)\n", s->path, errorstr);
+      goto beach;
+    }
   }
 
   // ChunkID
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   buf[4] = '\0';
   if ( strcmp((const char *)buf, "RIFF") != 0 ) {
     AUBIO_ERR("source_wavread: Failed opening %s (could not find RIFF header)\n", s->path);
@@ -115,10 +268,10 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   }
 
   // ChunkSize
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
 
   // Format
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   buf[4] = '\0';
   if ( strcmp((const char *)buf, "WAVE") != 0 ) {
     AUBIO_ERR("source_wavread: Failed opening %s (wrong format in RIFF header)\n", s->path);
@@ -126,15 +279,15 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   }
 
   // Subchunk1ID
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   buf[4] = '\0';
 
   // check if we have a JUNK Chunk
   if ( strcmp((const char *)buf, "JUNK") == 0 ) {
-    bytes_junk = fread(buf, 1, 4, s->fid);
+    bytes_junk = aubio_source_wavread_read(s, buf, 1, 4);
     buf[4] = '\0';
     bytes_junk += read_little_endian(buf, 4);
-    if (fseek(s->fid, bytes_read + bytes_junk, SEEK_SET) != 0) {
+    if (aubio_source_wavread_fseek(s, bytes_read + bytes_junk) != 0) {
       AUBIO_STRERR("source_wavread: Failed opening %s (could not seek past JUNK Chunk: %s)\n",
           s->path, errorstr);
       goto beach;
@@ -142,7 +295,7 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
     bytes_read += bytes_junk;
     bytes_expected += bytes_junk + 4;
     // now really read the fmt chunk
-    bytes_read += fread(buf, 1, 4, s->fid);
+    bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
     buf[4] = '\0';
   }
 
@@ -153,45 +306,55 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   }
 
   // Subchunk1Size
-  bytes_read += fread(buf, 1, 4, s->fid);
-  format = read_little_endian(buf, 4);
-  if ( format != 16 ) {
-    // TODO accept format 18
-    AUBIO_ERR("source_wavread: Failed opening %s (not encoded with PCM)\n", s->path);
-    goto beach;
-  }
-  if ( buf[1] || buf[2] | buf[3] ) {
-    AUBIO_ERR("source_wavread: Failed opening %s (Subchunk1Size should be 0)\n", s->path);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
+  fmt_size = read_little_endian(buf, 4);
+  if ( fmt_size != 16 && fmt_size != 18 && fmt_size != 40 ) {
+    AUBIO_ERR("source_wavread: Failed opening %s (unexpected Subchunk1Size %d)\n",
+        s->path, fmt_size);
     goto beach;
   }
+  bytes_expected += fmt_size - 16;
 
   // AudioFormat
-  bytes_read += fread(buf, 1, 2, s->fid);
-  if ( buf[0] != 1 || buf[1] != 0) {
-    AUBIO_ERR("source_wavread: Failed opening %s (AudioFormat should be PCM)\n", s->path);
-    goto beach;
-  }
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 2);
+  format = read_little_endian(buf, 2);
 
   // NumChannels
-  bytes_read += fread(buf, 1, 2, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 2);
   channels = read_little_endian(buf, 2);
 
   // SampleRate
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   sr = read_little_endian(buf, 4);
 
   // ByteRate
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   byterate = read_little_endian(buf, 4);
 
   // BlockAlign
-  bytes_read += fread(buf, 1, 2, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 2);
   blockalign = read_little_endian(buf, 2);
 
   // BitsPerSample
-  bytes_read += fread(buf, 1, 2, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 2);
   bitspersample = read_little_endian(buf, 2);
 
+  if ( fmt_size > 16 ) {
+    // cbSize, followed by the extension, if any
+    bytes_read += aubio_source_wavread_read(s, buf, 1, 2);
+    bytes_read += aubio_source_wavread_read(s, ext, 1, fmt_size - 18);
+    // the SubFormat GUID of WAVE_FORMAT_EXTENSIBLE starts with the format
+    if ( format == AUBIO_WAVREAD_EXTENSIBLE && fmt_size == 40 ) {
+      format = read_little_endian(ext + 6, 2);
+    }
+  }
+
+  if ( format != AUBIO_WAVREAD_PCM && format != AUBIO_WAVREAD_FLOAT ) {
+    AUBIO_ERR("source_wavread: Failed opening %s (AudioFormat should be PCM"
+        " or IEEE float)\n", s->path);
+    goto beach;
+  }
+
   if ( channels == 0 ) {
     AUBIO_ERR("source_wavread: Failed opening %s (number of channels can not be 0)\n", s->path);
     goto beach;
@@ -212,9 +375,21 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
     goto beach;
   }
 
-  if ( bitspersample != 8 && bitspersample != 16 ) {
-    AUBIO_ERR("source_wavread: can not process %d-bit file %s\n",
-        bitspersample, s->path);
+  if ( format == AUBIO_WAVREAD_PCM && bitspersample == 8 ) {
+    s->format = aubio_io_u8;
+  } else if ( format == AUBIO_WAVREAD_PCM && bitspersample == 16 ) {
+    s->format = aubio_io_s16;
+  } else if ( format == AUBIO_WAVREAD_PCM && bitspersample == 24 ) {
+    s->format = aubio_io_s24;
+  } else if ( format == AUBIO_WAVREAD_PCM && bitspersample == 32 ) {
+    s->format = aubio_io_s32;
+  } else if ( format == AUBIO_WAVREAD_FLOAT && bitspersample == 32 ) {
+    s->format = aubio_io_f32;
+  } else if ( format == AUBIO_WAVREAD_FLOAT && bitspersample == 64 ) {
+    s->format = aubio_io_f64;
+  } else {
+    AUBIO_ERR("source_wavread: can not process %d-bit %s file %s\n",
+        bitspersample, format == AUBIO_WAVREAD_PCM ? "PCM" : "float", s->path);
     goto beach;
   }
 
@@ -251,29 +426,29 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   }
 
   // Subchunk2ID
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   buf[4] = '\0';
   while ( strcmp((const char *)buf, "data") != 0 ) {
-    if (feof(s->fid) || ferror(s->fid)) {
+    if (aubio_source_wavread_at_end(s)) {
       AUBIO_ERR("source_wavread: no data RIFF header found in %s\n", s->path);
       goto beach;
     }
-    bytes_junk = fread(buf, 1, 4, s->fid);
+    bytes_junk = aubio_source_wavread_read(s, buf, 1, 4);
     buf[4] = '\0';
     bytes_junk += read_little_endian(buf, 4);
-    if (fseek(s->fid, bytes_read + bytes_junk, SEEK_SET) != 0) {
+    if (aubio_source_wavread_fseek(s, bytes_read + bytes_junk) != 0) {
       AUBIO_STRERR("source_wavread: could not seek past unknown chunk in %s (%s)\n",
           s->path, errorstr);
       goto beach;
     }
     bytes_read += bytes_junk;
     bytes_expected += bytes_junk+ 4;
-    bytes_read += fread(buf, 1, 4, s->fid);
+    bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
     buf[4] = '\0';
   }
 
   // Subchunk2Size
-  bytes_read += fread(buf, 1, 4, s->fid);
+  bytes_read += aubio_source_wavread_read(s, buf, 1, 4);
   duration = read_little_endian(buf, 4) / blockalign;
 
   //data_size = buf[0] + (buf[1] << 8) + (buf[2] << 16) + (buf[3] << 24);
@@ -292,17 +467,24 @@ aubio_source_wavread_t * new_aubio_source_wavread(const char_t * path, uint_t sa
   }
   s->seek_start = bytes_read;
 
-  s->output = new_fmat(s->input_channels, AUBIO_WAVREAD_BUFSIZE);
   s->blockalign= blockalign;
   s->bitspersample = bitspersample;
 
   s->duration = duration;
 
-  s->short_output = (unsigned char *)calloc(s->blockalign, AUBIO_WAVREAD_BUFSIZE);
   s->read_index = 0;
   s->read_samples = 0;
   s->eof = 0;
 
+  aubio_source_wavread_map(s);
+  if (!s->mapped) {
+    s->bufsize = AUBIO_WAVREAD_BUFSIZE;
+    s->short_output = AUBIO_ARRAY(unsigned char,
+        s->blockalign * s->bufsize);
+    if (!s->short_output) goto beach;
+    s->frames = s->short_output;
+  }
+
   return s;
 
 beach:
@@ -312,70 +494,87 @@ beach:
   return NULL;
 }
 
-void aubio_source_wavread_readframe(aubio_source_wavread_t *s, uint_t *wavread_read);
-
-void aubio_source_wavread_readframe(aubio_source_wavread_t *s, uint_t *wavread_read) {
-  unsigned char *short_ptr = s->short_output;
-  size_t read = fread(short_ptr, s->blockalign, AUBIO_WAVREAD_BUFSIZE, s->fid);
-  uint_t i, j, b, bitspersample = s->bitspersample;
-  uint_t wrap_at = (1 << ( bitspersample - 1 ) );
-  uint_t wrap_with = (1 << bitspersample);
-  smpl_t scaler = 1. / wrap_at;
-  int signed_val = 0;
-  unsigned int unsigned_val = 0;
-
-  for (j = 0; j < read; j++) {
-    for (i = 0; i < s->input_channels; i++) {
-      unsigned_val = 0;
-      for (b = 0; b < bitspersample; b+=8 ) {
-        unsigned_val += *(short_ptr) << b;
-        short_ptr++;
-      }
-      signed_val = unsigned_val;
-      // FIXME why does 8 bit conversion maps [0;255] to [-128;127]
-      // instead of [0;127] to [0;127] and [128;255] to [-128;-1]
-      if (bitspersample == 8) signed_val -= wrap_at;
-      else if (unsigned_val >= wrap_at) signed_val = unsigned_val - wrap_with;
-      s->output->data[i][j] = signed_val * scaler;
-    }
+static void aubio_source_wavread_map (aubio_source_wavread_t *s)
+{
+  size_t frames;
+#ifdef HAVE_MMAP
+  struct stat st;
+  void *map;
+#endif
+  if (s->io) {
+    // memory streams are read in place
+    const unsigned char *data = aubio_source_io_get_data(s->io);
+    long long size = aubio_source_io_get_size(s->io);
+    if (!data || size <= (long long)s->seek_start) return;
+    s->frames = data + s->seek_start;
+    frames = (size - s->seek_start) / s->blockalign;
+    if (s->duration && s->duration < frames) frames = s->duration;
+    s->read_samples = MIN(frames, UINT_MAX);
+    s->mapped = 1;
+    return;
   }
+#ifdef HAVE_MMAP
+  if (fstat(fileno(s->fid), &st) != 0 || (size_t)st.st_size <= s->seek_start) {
+    return;
+  }
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE,
+      fileno(s->fid), 0);
+  if (map == MAP_FAILED) {
+    // fall back to buffered reads
+    return;
+  }
+#ifdef POSIX_MADV_SEQUENTIAL
+  // frames are mostly read in order, let the kernel read ahead
+  posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#endif
+  s->map = map;
+  s->map_size = (size_t)st.st_size;
+  s->frames = (const unsigned char *)map + s->seek_start;
+  // stop at the end of the data chunk, or of the file if it was truncated
+  frames = (s->map_size - s->seek_start) / s->blockalign;
+  if (s->duration && s->duration < frames) frames = s->duration;
+  s->read_samples = MIN(frames, UINT_MAX);
+  s->mapped = 1;
+#endif
+}
 
-  *wavread_read = read;
-
+static uint_t aubio_source_wavread_refill (aubio_source_wavread_t *s)
+{
+  size_t read;
+  if (s->mapped) {
+    // all the frames are always available
+    s->eof = 1;
+    return 0;
+  }
+  read = aubio_source_wavread_read(s, s->short_output, s->blockalign,
+      s->bufsize);
+  s->read_samples = read;
+  s->read_index = 0;
   if (read == 0) s->eof = 1;
+  return read;
 }
 
 void aubio_source_wavread_do(aubio_source_wavread_t * s, fvec_t * read_data, uint_t * read){
-  uint_t i, j;
   uint_t end = 0;
   uint_t total_wrote = 0;
   uint_t length = aubio_source_validate_input_length("source_wavread", s->path,
       s->hop_size, read_data->length);
-  if (s->fid == NULL) {
+  if (s->fid == NULL && s->io == NULL) {
     AUBIO_ERR("source_wavread: could not read from %s (file not opened)\n",
         s->path);
     return;
   }
   while (total_wrote < length) {
     end = MIN(s->read_samples - s->read_index, length - total_wrote);
-    for (i = 0; i < end; i++) {
-      read_data->data[i + total_wrote] = 0;
-      for (j = 0; j < s->input_channels; j++ ) {
-        read_data->data[i + total_wrote] += s->output->data[j][i + s->read_index];
-      }
-      read_data->data[i + total_wrote] /= (smpl_t)(s->input_channels);
-    }
-    total_wrote += end;
-    if (total_wrote < length) {
-      uint_t wavread_read = 0;
-      aubio_source_wavread_readframe(s, &wavread_read);
-      s->read_samples = wavread_read;
-      s->read_index = 0;
-      if (s->eof) {
-        break;
-      }
-    } else {
+    if (end > 0) {
+      const unsigned char *frames = s->frames + s->read_index * s->blockalign;
+      aubio_io_downmix(s->format, frames, s->input_channels,
+          read_data->data + total_wrote, end);
       s->read_index += end;
+      total_wrote += end;
+    }
+    if (total_wrote < length && !aubio_source_wavread_refill(s)) {
+      break;
     }
   }
 
@@ -384,45 +583,61 @@ void aubio_source_wavread_do(aubio_source_wavread_t * s, fvec_t * read_data, uin
   *read = total_wrote;
 }
 
-void aubio_source_wavread_do_multi(aubio_source_wavread_t * s, fmat_t * read_data, uint_t * read){
-  uint_t i,j;
+/* read up to length frames, refilling the buffer as needed */
+static uint_t aubio_source_wavread_read_multi (aubio_source_wavread_t * s,
+    fmat_t * read_data, uint_t length)
+{
   uint_t end = 0;
+  uint_t total_wrote = 0;
+  while (total_wrote < length) {
+    end = MIN(s->read_samples - s->read_index, length - total_wrote);
+    if (end > 0) {
+      const unsigned char *frames = s->frames + s->read_index * s->blockalign;
+      aubio_io_deinterleave(s->format, frames, s->input_channels,
+          read_data, total_wrote, end);
+      s->read_index += end;
+      total_wrote += end;
+    }
+    if (total_wrote < length && !aubio_source_wavread_refill(s)) {
+      break;
+    }
+  }
+  return total_wrote;
+}
+
+void aubio_source_wavread_do_multi(aubio_source_wavread_t * s, fmat_t * read_data, uint_t * read){
   uint_t total_wrote = 0;
   uint_t length = aubio_source_validate_input_length("source_wavread", s->path,
       s->hop_size, read_data->length);
-  uint_t channels = aubio_source_validate_input_channels("source_wavread",
-      s->path, s->input_channels, read_data->height);
-  if (s->fid == NULL) {
+  // only warns, aubio_io_deinterleave writes at most read_data->height rows
+  aubio_source_validate_input_channels("source_wavread", s->path,
+      s->input_channels, read_data->height);
+  if (s->fid == NULL && s->io == NULL) {
     AUBIO_ERR("source_wavread: could not read from %s (file not opened)\n",
         s->path);
     return;
   }
-  while (total_wrote < length) {
-    end = MIN(s->read_samples - s->read_index, length - total_wrote);
-    for (j = 0; j < channels; j++) {
-      for (i = 0; i < end; i++) {
-        read_data->data[j][i + total_wrote] = s->output->data[j][i];
-      }
-    }
-    total_wrote += end;
-    if (total_wrote < length) {
-      uint_t wavread_read = 0;
-      aubio_source_wavread_readframe(s, &wavread_read);
-      s->read_samples = wavread_read;
-      s->read_index = 0;
-      if (s->eof) {
-        break;
-      }
-    } else {
-      s->read_index += end;
-    }
-  }
+  total_wrote = aubio_source_wavread_read_multi(s, read_data, length);
 
   aubio_source_pad_multi_output(read_data, s->input_channels, total_wrote);
 
   *read = total_wrote;
 }
 
+void aubio_source_wavread_read_into (aubio_source_wavread_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read) {
+  fmat_t block = *read_to;
+  block.length = MIN(max_frames, read_to->length);
+  *read = 0;
+  if (s->fid == NULL && s->io == NULL) {
+    AUBIO_ERR("source_wavread: could not read from %s (file not opened)\n",
+        s->path);
+    return;
+  }
+  *read = aubio_source_wavread_read_multi(s, &block, block.length);
+  aubio_source_pad_multi_output(&block, s->input_channels, *read);
+}
+
 uint_t aubio_source_wavread_get_samplerate(aubio_source_wavread_t * s) {
   return s->samplerate;
 }
@@ -433,7 +648,7 @@ uint_t aubio_source_wavread_get_channels(aubio_source_wavread_t * s) {
 
 uint_t aubio_source_wavread_seek (aubio_source_wavread_t * s, uint_t pos) {
   uint_t ret = 0;
-  if (s->fid == NULL) {
+  if (s->fid == NULL && s->io == NULL) {
     AUBIO_ERR("source_wavread: could not seek %s (file not opened?)\n", s->path, pos);
     return AUBIO_FAIL;
   }
@@ -441,7 +656,13 @@ uint_t aubio_source_wavread_seek (aubio_source_wavread_t * s, uint_t pos) {
     AUBIO_ERR("source_wavread: could not seek %s at %d (seeking position should be >= 0)\n", s->path, pos);
     return AUBIO_FAIL;
   }
-  ret = fseek(s->fid, s->seek_start + pos * s->blockalign, SEEK_SET);
+  if (s->mapped) {
+    // read_samples holds the number of frames in the mapped data
+    s->read_index = MIN(pos, s->read_samples);
+    s->eof = 0;
+    return AUBIO_OK;
+  }
+  ret = aubio_source_wavread_fseek(s, s->seek_start + pos * s->blockalign);
   if (ret != 0) {
     AUBIO_STRERR("source_wavread: could not seek %s at %d (%s)\n", s->path, pos, errorstr);
     return AUBIO_FAIL;
@@ -449,6 +670,7 @@ uint_t aubio_source_wavread_seek (aubio_source_wavread_t * s, uint_t pos) {
   // reset some values
   s->eof = 0;
   s->read_index = 0;
+  s->read_samples = 0;
   return AUBIO_OK;
 }
 
@@ -460,10 +682,23 @@ uint_t aubio_source_wavread_get_duration (const aubio_source_wavread_t * s) {
 }
 
 uint_t aubio_source_wavread_close (aubio_source_wavread_t * s) {
-  if (s->fid == NULL) {
+  if (s->fid == NULL && s->io == NULL) {
     return AUBIO_OK;
   }
-  if (fclose(s->fid)) {
+#ifdef HAVE_MMAP
+  if (s->map) {
+    munmap(s->map, s->map_size);
+    s->map = NULL;
+    s->frames = NULL;
+  }
+#endif
+  s->mapped = 0;
+  if (s->io) {
+    // the stream is deleted with the aubio_source_t reading it
+    s->io = NULL;
+    return AUBIO_OK;
+  }
+  if (s->fid != stdin && fclose(s->fid)) {
     AUBIO_STRERR("source_wavread: could not close %s (%s)\n", s->path, errorstr);
     return AUBIO_FAIL;
   }
@@ -475,9 +710,54 @@ void del_aubio_source_wavread(aubio_source_wavread_t * s) {
   AUBIO_ASSERT(s);
   aubio_source_wavread_close(s);
   if (s->short_output) AUBIO_FREE(s->short_output);
-  if (s->output) del_fmat(s->output);
   if (s->path) AUBIO_FREE(s->path);
   AUBIO_FREE(s);
 }
 
+
+uint_t aubio_source_wavread_probe (const char_t * path,
+    aubio_source_info_t * info)
+{
+  unsigned char h[40];
+  uint_t size, format = 0, channels = 0, sr = 0, blockalign = 0;
+  FILE *fid = fopen((const char *)path, "rb");
+  if (!fid) return AUBIO_FAIL;
+  if (fread(h, 1, 12, fid) != 12 || memcmp(h, "RIFF", 4) != 0
+      || memcmp(h + 8, "WAVE", 4) != 0) {
+    goto beach;
+  }
+  // walk the chunks up to the data one, skipping JUNK, LIST and the others
+  while (fread(h, 1, 8, fid) == 8) {
+    size = read_little_endian(h + 4, 4);
+    if (memcmp(h, "data", 4) == 0) {
+      // only the samples of PCM and float files are counted from their size
+      if ((format != AUBIO_WAVREAD_PCM && format != AUBIO_WAVREAD_FLOAT)
+          || channels == 0 || (sint_t)sr <= 0 || blockalign == 0) break;
+      fclose(fid);
+      info->samplerate = sr;
+      info->channels = channels;
+      info->duration = size / blockalign;
+      return AUBIO_OK;
+    }
+    if (memcmp(h, "fmt ", 4) == 0) {
+      uint_t n = MIN(size, sizeof(h));
+      if (size < 16 || fread(h, 1, n, fid) != n) break;
+      format = read_little_endian(h, 2);
+      channels = read_little_endian(h + 2, 2);
+      sr = read_little_endian(h + 4, 4);
+      blockalign = read_little_endian(h + 12, 2);
+      // the SubFormat GUID of WAVE_FORMAT_EXTENSIBLE starts with the format
+      if (format == AUBIO_WAVREAD_EXTENSIBLE && n == 40) {
+        format = read_little_endian(h + 24, 2);
+      }
+      size -= n;
+    }
+    // chunks are padded to an even number of bytes
+    if (fseek(fid, (long)size + (size & 1), SEEK_CUR) != 0) break;
+  }
+beach:
+  fclose(fid);
+  return AUBIO_FAIL;
+}
+
 #endif /* HAVE_WAVREAD */
@@ -30,6 +30,12 @@
 
   To write to file, use ::aubio_sink_t.
 
+  Integer PCM files of 8, 16, 24 and 32 bits per sample, and IEEE float files
+  of 32 and 64 bits per sample, are supported, including files using the
+  WAVE_FORMAT_EXTENSIBLE header. When available, the file is mapped in memory
+  and samples are decoded from the mapped data directly into the output
+  vectors.
+
   References:
 
     - http://netghost.narod.ru/gff/graphics/summary/micriff.htm
@@ -63,6 +69,26 @@ typedef struct _aubio_source_wavread_t aubio_source_wavread_t;
 */
 aubio_source_wavread_t * new_aubio_source_wavread(const char_t * uri, uint_t samplerate, uint_t hop_size);
 
+/**
+
+  create new ::aubio_source_wavread_t reading raw interleaved samples
+
+  \param uri the file path to read from, or `-` for the standard input
+  \param format format of the samples, one of `u8`, `s16`, `s24`, `s32`
+  (little-endian integers), `f32` or `f64` (little-endian floats)
+  \param samplerate sampling rate of the samples
+  \param channels number of interleaved channels
+  \param hop_size the size of the blocks to read from
+
+  The stream has no header; it is read from its first byte until its end.
+  Regular files are mapped in memory when possible. Other files, such as
+  pipes, are read in blocks of 8192 frames, and can not seek.
+
+*/
+aubio_source_wavread_t * new_aubio_source_wavread_raw (const char_t * uri,
+    const char_t * format, uint_t samplerate, uint_t channels,
+    uint_t hop_size);
+
 /**
 
   read monophonic vector of length hop_size from source object
@@ -91,6 +117,23 @@ void aubio_source_wavread_do(aubio_source_wavread_t * s, fvec_t * read_to, uint_
 */
 void aubio_source_wavread_do_multi(aubio_source_wavread_t * s, fmat_t * read_to, uint_t * read);
 
+/**
+
+  read up to max_frames frames from source object
+
+  \param s source object, created with ::new_aubio_source_wavread
+  \param read_to ::fmat_t of data to read to
+  \param max_frames maximum number of frames to read, at most the length of
+  `read_to`
+  \param read upon returns, equals to number of frames actually read
+
+  Same as ::aubio_source_wavread_do_multi, without limiting the number of
+  frames to `hop_size`.
+
+*/
+void aubio_source_wavread_read_into(aubio_source_wavread_t * s,
+    fmat_t * read_to, uint_t max_frames, uint_t * read);
+
 /**
 
   get samplerate of source object
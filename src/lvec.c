@@ -26,24 +26,28 @@ lvec_t * new_lvec(uint_t length) {
   if ((sint_t)length <= 0) {
     return NULL;
   }
-  s = AUBIO_NEW(lvec_t);
+  // a single block, with the samples aligned after the structure and
+  // padded to a whole number of AUBIO_ALIGNMENT bytes
+  s = (lvec_t *)AUBIO_ARRAY(char, AUBIO_ALIGN_SIZE(sizeof(lvec_t))
+      + AUBIO_ALIGN_SIZE(length * sizeof(lsmp_t)));
   if (!s) {
     return NULL;
   }
   s->length = length;
-  s->data = AUBIO_ARRAY(lsmp_t, s->length);
-  if (!s->data) {
-    AUBIO_FREE(s);
-    return NULL;
-  }
+  s->data = (lsmp_t *)((char *)s + AUBIO_ALIGN_SIZE(sizeof(lvec_t)));
   return s;
 }
 
 void del_lvec(lvec_t *s) {
-  AUBIO_FREE(s->data);
   AUBIO_FREE(s);
 }
 
+uint_t lvec_get_memory_usage(const lvec_t *s) {
+  AUBIO_ASSERT_NOT_NULL(s);
+  return (uint_t)(AUBIO_ALIGN_SIZE(sizeof(lvec_t))
+      + AUBIO_ALIGN_SIZE(s->length * sizeof(lsmp_t)));
+}
+
 void lvec_set_sample(lvec_t *s, lsmp_t data, uint_t position) {
   s->data[position] = data;
 }
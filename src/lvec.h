@@ -35,6 +35,9 @@ extern "C" {
   Note: the lvec_t data type is required in some algorithms such as IIR filters
   (see temporal/filter.h).
 
+  The data of a vector created by ::new_lvec is aligned and padded to
+  ::aubio_get_alignment bytes.
+
   \example test-lvec.c
 
 */
@@ -58,6 +61,16 @@ lvec_t * new_lvec(uint_t length);
 */
 void del_lvec(lvec_t *s);
 
+/** get the memory used by a lvec_t buffer
+
+  \param s buffer as returned by new_lvec()
+
+  \return number of bytes of the buffer, including its structure; see
+  utils/allocator.h
+
+*/
+uint_t lvec_get_memory_usage(const lvec_t *s);
+
 /** read sample value in a buffer
 
   \param s vector to read from
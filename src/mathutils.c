@@ -22,8 +22,16 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
 #include "mathutils.h"
 #include "musicutils.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "synth/samplecache.h"
+#include "temporal/resampler_priv.h"
+#include "utils/simd_priv.h"
+#include "mathutils_priv.h"
 
 /** Window types */
 typedef enum
@@ -41,6 +49,34 @@ typedef enum
   aubio_win_default = aubio_win_hanningz,
 } aubio_window_type;
 
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_window_lock = SRWLOCK_INIT;
+#define AUBIO_WINDOW_LOCK()   AcquireSRWLockExclusive(&aubio_window_lock)
+#define AUBIO_WINDOW_UNLOCK() ReleaseSRWLockExclusive(&aubio_window_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t aubio_window_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_WINDOW_LOCK()   pthread_mutex_lock(&aubio_window_mutex)
+#define AUBIO_WINDOW_UNLOCK() pthread_mutex_unlock(&aubio_window_mutex)
+#endif
+
+/** one window shared by all the objects using the same type and length */
+typedef struct _aubio_window_shared_t
+{
+  aubio_window_type type;       /**< type of the window */
+  fvec_t *win;                  /**< read-only coefficients */
+  uint_t refcount;              /**< number of objects using win */
+  struct _aubio_window_shared_t *next;
+} aubio_window_shared_t;
+
+/** list of shared windows, protected by aubio_window_lock */
+static aubio_window_shared_t *aubio_window_shared = NULL;
+
+static uint_t aubio_window_parse (const char_t *window_type,
+    aubio_window_type *wintype);
+static void aubio_window_fill (fvec_t *win, aubio_window_type wintype);
+
 fvec_t *
 new_aubio_window (char_t * window_type, uint_t length)
 {
@@ -57,39 +93,117 @@ new_aubio_window (char_t * window_type, uint_t length)
   return win;
 }
 
+const fvec_t *
+aubio_window_acquire (const char_t * window_type, uint_t length)
+{
+  aubio_window_shared_t *shared;
+  aubio_window_type wintype;
+  fvec_t *win;
+  if (aubio_window_parse (window_type, &wintype)) return NULL;
+  AUBIO_WINDOW_LOCK();
+  for (shared = aubio_window_shared; shared; shared = shared->next) {
+    if (shared->type == wintype && shared->win->length == length) {
+      shared->refcount++;
+      AUBIO_WINDOW_UNLOCK();
+      return shared->win;
+    }
+  }
+  AUBIO_WINDOW_UNLOCK();
+  /* computed outside the lock, another object may store it meanwhile */
+  win = new_fvec (length);
+  if (!win) return NULL;
+  aubio_window_fill (win, wintype);
+  AUBIO_WINDOW_LOCK();
+  for (shared = aubio_window_shared; shared; shared = shared->next) {
+    if (shared->type == wintype && shared->win->length == length) {
+      shared->refcount++;
+      AUBIO_WINDOW_UNLOCK();
+      del_fvec (win);
+      return shared->win;
+    }
+  }
+  shared = AUBIO_NEW (aubio_window_shared_t);
+  if (!shared) {
+    AUBIO_WINDOW_UNLOCK();
+    del_fvec (win);
+    return NULL;
+  }
+  shared->type = wintype;
+  shared->win = win;
+  shared->refcount = 1;
+  shared->next = aubio_window_shared;
+  aubio_window_shared = shared;
+  AUBIO_WINDOW_UNLOCK();
+  return win;
+}
+
+void
+aubio_window_release (const fvec_t * win)
+{
+  aubio_window_shared_t **p, *shared;
+  if (!win) return;
+  AUBIO_WINDOW_LOCK();
+  for (p = &aubio_window_shared; *p; p = &(*p)->next) {
+    if ((*p)->win == win) {
+      shared = *p;
+      if (--shared->refcount == 0) {
+        *p = shared->next;
+        del_fvec (shared->win);
+        AUBIO_FREE (shared);
+      }
+      break;
+    }
+  }
+  AUBIO_WINDOW_UNLOCK();
+}
+
 uint_t fvec_set_window (fvec_t *win, char_t *window_type) {
-  smpl_t * w = win->data;
-  uint_t i, size = win->length;
   aubio_window_type wintype;
+  if (aubio_window_parse (window_type, &wintype)) return 1;
+  aubio_window_fill (win, wintype);
+  return 0;
+}
+
+static uint_t
+aubio_window_parse (const char_t *window_type, aubio_window_type *wintype)
+{
   if (window_type == NULL) {
       AUBIO_ERR ("window type can not be null.\n");
       return 1;
   } else if (strcmp (window_type, "ones") == 0)
-      wintype = aubio_win_ones;
+      *wintype = aubio_win_ones;
   else if (strcmp (window_type, "rectangle") == 0)
-      wintype = aubio_win_rectangle;
+      *wintype = aubio_win_rectangle;
   else if (strcmp (window_type, "hamming") == 0)
-      wintype = aubio_win_hamming;
+      *wintype = aubio_win_hamming;
   else if (strcmp (window_type, "hanning") == 0)
-      wintype = aubio_win_hanning;
+      *wintype = aubio_win_hanning;
   else if (strcmp (window_type, "hanningz") == 0)
-      wintype = aubio_win_hanningz;
+      *wintype = aubio_win_hanningz;
   else if (strcmp (window_type, "blackman") == 0)
-      wintype = aubio_win_blackman;
+      *wintype = aubio_win_blackman;
   else if (strcmp (window_type, "blackman_harris") == 0)
-      wintype = aubio_win_blackman_harris;
+      *wintype = aubio_win_blackman_harris;
   else if (strcmp (window_type, "gaussian") == 0)
-      wintype = aubio_win_gaussian;
+      *wintype = aubio_win_gaussian;
   else if (strcmp (window_type, "welch") == 0)
-      wintype = aubio_win_welch;
+      *wintype = aubio_win_welch;
   else if (strcmp (window_type, "parzen") == 0)
-      wintype = aubio_win_parzen;
+      *wintype = aubio_win_parzen;
   else if (strcmp (window_type, "default") == 0)
-      wintype = aubio_win_default;
+      *wintype = aubio_win_default;
   else {
       AUBIO_ERR ("unknown window type `%s`.\n", window_type);
       return 1;
   }
+  return 0;
+}
+
+static void
+aubio_window_fill (fvec_t *win, aubio_window_type wintype)
+{
+  smpl_t * w = win->data;
+  uint_t i, size = win->length;
   switch(wintype) {
     case aubio_win_ones:
       fvec_ones(win);
@@ -145,7 +259,6 @@ uint_t fvec_set_window (fvec_t *win, char_t *window_type) {
     default:
       break;
   }
-  return 0;
 }
 
 smpl_t
@@ -165,6 +278,9 @@ fvec_mean (fvec_t * s)
 #elif defined(HAVE_ACCELERATE)
   aubio_vDSP_meanv(s->data, 1, &tmp, s->length);
   return tmp;
+#elif defined(HAVE_AUBIO_SIMD)
+  tmp = AUBIO_SIMD()->sum(s->data, s->length);
+  return tmp / (smpl_t)(s->length);
 #else
   uint_t j;
   for (j = 0; j < s->length; j++) {
@@ -182,6 +298,8 @@ fvec_sum (fvec_t * s)
   aubio_ippsSum(s->data, (int)s->length, &tmp);
 #elif defined(HAVE_ACCELERATE)
   aubio_vDSP_sve(s->data, 1, &tmp, s->length);
+#elif defined(HAVE_AUBIO_SIMD)
+  tmp = AUBIO_SIMD()->sum(s->data, s->length);
 #else
   uint_t j;
   for (j = 0; j < s->length; j++) {
@@ -200,6 +318,8 @@ fvec_max (fvec_t * s)
 #elif defined(HAVE_ACCELERATE)
   smpl_t tmp = 0.;
   aubio_vDSP_maxv( s->data, 1, &tmp, s->length );
+#elif defined(HAVE_AUBIO_SIMD)
+  smpl_t tmp = AUBIO_SIMD()->vmax(s->data, s->length);
 #else
   uint_t j;
   smpl_t tmp = s->data[0];
@@ -219,6 +339,8 @@ fvec_min (fvec_t * s)
 #elif defined(HAVE_ACCELERATE)
   smpl_t tmp = 0.;
   aubio_vDSP_minv(s->data, 1, &tmp, s->length);
+#elif defined(HAVE_AUBIO_SIMD)
+  smpl_t tmp = AUBIO_SIMD()->vmin(s->data, s->length);
 #else
   uint_t j;
   smpl_t tmp = s->data[0];
@@ -328,13 +450,15 @@ smpl_t
 aubio_level_lin (const fvec_t * f)
 {
   smpl_t energy = 0.;
-#ifndef HAVE_BLAS
+#if defined(HAVE_BLAS)
+  energy = aubio_cblas_dot(f->length, f->data, 1, f->data, 1);
+#elif defined(HAVE_AUBIO_SIMD)
+  energy = AUBIO_SIMD()->dot(f->data, f->data, f->length);
+#else
   uint_t j;
   for (j = 0; j < f->length; j++) {
     energy += SQR (f->data[j]);
   }
-#else
-  energy = aubio_cblas_dot(f->length, f->data, 1, f->data, 1);
 #endif
   return energy / f->length;
 }
@@ -381,27 +505,151 @@ fvec_alpha_normalise (fvec_t * o, smpl_t alpha)
 void
 fvec_add (fvec_t * o, smpl_t val)
 {
+#if defined(HAVE_AUBIO_SIMD)
+  AUBIO_SIMD()->add(o->data, val, o->length);
+#else
   uint_t j;
   for (j = 0; j < o->length; j++) {
     o->data[j] += val;
   }
+#endif
 }
 
 void
 fvec_mul (fvec_t *o, smpl_t val)
 {
+#if defined(HAVE_AUBIO_SIMD)
+  AUBIO_SIMD()->mul(o->data, val, o->length);
+#else
   uint_t j;
   for (j = 0; j < o->length; j++) {
     o->data[j] *= val;
   }
+#endif
+}
+
+/* key of the element at index i of the heap starting at base, the lower
+ * half is a max-heap of the values, the upper half a max-heap of their
+ * opposites */
+#define HEAP_KEY(h, base, i) \
+  (((base) == 0) ? (h)->ring[(h)->heap[i]] : -(h)->ring[(h)->heap[(base) + (i)]])
+
+static void
+aubio_median_heap_swap (aubio_median_heap_t * h, uint_t a, uint_t b)
+{
+  uint_t tmp = h->heap[a];
+  h->heap[a] = h->heap[b];
+  h->heap[b] = tmp;
+  h->where[h->heap[a]] = a;
+  h->where[h->heap[b]] = b;
+}
+
+/* move element i of the heap at base towards its root, returns 1 if moved */
+static uint_t
+aubio_median_heap_up (aubio_median_heap_t * h, uint_t base, uint_t i)
+{
+  uint_t moved = 0;
+  while (i > 0 && HEAP_KEY(h, base, (i - 1) / 2) < HEAP_KEY(h, base, i)) {
+    aubio_median_heap_swap (h, base + i, base + (i - 1) / 2);
+    i = (i - 1) / 2;
+    moved = 1;
+  }
+  return moved;
+}
+
+/* move element i of the heap at base, of size n, towards its leaves */
+static void
+aubio_median_heap_down (aubio_median_heap_t * h, uint_t base, uint_t n,
+    uint_t i)
+{
+  for (;;) {
+    uint_t l = 2 * i + 1, r = 2 * i + 2, m = i;
+    if (l < n && HEAP_KEY(h, base, l) > HEAP_KEY(h, base, m)) m = l;
+    if (r < n && HEAP_KEY(h, base, r) > HEAP_KEY(h, base, m)) m = r;
+    if (m == i) break;
+    aubio_median_heap_swap (h, base + i, base + m);
+    i = m;
+  }
+}
+
+void
+aubio_median_heap_init (aubio_median_heap_t * h, smpl_t * ring,
+    uint_t * heap, uint_t * where, uint_t length)
+{
+  uint_t j;
+  h->ring = ring;
+  h->heap = heap;
+  h->where = where;
+  h->length = length;
+  h->n_low = (length - 1) / 2 + 1;
+  for (j = 0; j < length; j++) {
+    ring[j] = 0.;
+    heap[j] = j;
+    where[j] = j;
+  }
+}
+
+smpl_t
+aubio_median_heap_set (aubio_median_heap_t * h, uint_t pos, smpl_t value)
+{
+  uint_t n_low = h->n_low, n_high = h->length - n_low;
+  uint_t i = h->where[pos];
+  h->ring[pos] = value;
+  /* restore the heap property where the value changed */
+  if (i < n_low) {
+    if (!aubio_median_heap_up (h, 0, i)) {
+      aubio_median_heap_down (h, 0, n_low, i);
+    }
+  } else {
+    if (!aubio_median_heap_up (h, n_low, i - n_low)) {
+      aubio_median_heap_down (h, n_low, n_high, i - n_low);
+    }
+  }
+  /* exchange the tops if the halves are no longer ordered */
+  if (n_high > 0 && h->ring[h->heap[0]] > h->ring[h->heap[n_low]]) {
+    aubio_median_heap_swap (h, 0, n_low);
+    aubio_median_heap_down (h, 0, n_low, 0);
+    aubio_median_heap_down (h, n_low, n_high, 0);
+  }
+  return h->ring[h->heap[0]];
 }
 
+/** shortest window of fvec_adapt_thres worth a running median */
+#define AUBIO_ADAPT_THRES_MIN 8
+/** longest window of fvec_adapt_thres for which the heaps are on the stack */
+#define AUBIO_ADAPT_THRES_STACK 64
+
 void fvec_adapt_thres(fvec_t * vec, fvec_t * tmp,
     uint_t post, uint_t pre) {
-  uint_t length = vec->length, j;
-  for (j=0;j<length;j++) {
-    vec->data[j] -= fvec_moving_thres(vec, tmp, post, pre, j);
+  uint_t length = vec->length, win_length = post + pre + 1, j;
+  uint_t stack[2 * AUBIO_ADAPT_THRES_STACK], *heap = stack;
+  aubio_median_heap_t h;
+  smpl_t median = 0.;
+  if (win_length > AUBIO_ADAPT_THRES_STACK) {
+    heap = AUBIO_ARRAY (uint_t, 2 * win_length);
+  }
+  if (win_length < AUBIO_ADAPT_THRES_MIN || !heap) {
+    for (j = 0; j < length; j++) {
+      vec->data[j] -= fvec_moving_thres(vec, tmp, post, pre, j);
+    }
+    return;
   }
+  /* the window around j is kept in tmp, element i at (i + post) % win_length.
+   * as in fvec_moving_thres, the thresholded values are used once computed,
+   * and the first element is replaced with a 0, like the padding */
+  aubio_median_heap_init (&h, tmp->data, heap, heap + win_length, win_length);
+  for (j = 1; j <= pre && j < length; j++) {
+    median = aubio_median_heap_set (&h, j + post, vec->data[j]);
+  }
+  for (j = 0; j < length; j++) {
+    vec->data[j] -= median;
+    if (j > 0) aubio_median_heap_set (&h, (j + post) % win_length,
+        vec->data[j]);
+    /* slide the window, replacing j - post with j + pre + 1 */
+    median = aubio_median_heap_set (&h, j % win_length,
+        (j + pre + 1 < length) ? vec->data[j + pre + 1] : 0.);
+  }
+  if (heap != stack) AUBIO_FREE (heap);
 }
 
 smpl_t
@@ -518,6 +766,63 @@ uint_t fvec_peakpick(const fvec_t * onset, uint_t pos) {
   return tmp;
 }
 
+#if !defined(HAVE_AUBIO_SIMD)
+/* same as aubio_simd_ops_t.peaks */
+static uint_t
+aubio_find_peaks_scan (const smpl_t *x, uint_t start, uint_t n,
+    smpl_t threshold, smpl_t *pos, uint_t max)
+{
+  uint_t j, count = 0;
+  for (j = (start > 1) ? start : 1; j + 1 < n && count < max; j++) {
+    if (x[j] > x[j - 1] && x[j] > x[j + 1] && x[j] > threshold) {
+      pos[count++] = (smpl_t)j;
+    }
+  }
+  return count;
+}
+#endif
+
+uint_t
+fvec_find_peaks (const fvec_t * v, smpl_t threshold, uint_t min_distance,
+    fvec_t * peaks)
+{
+  uint_t n = 0, start = 1, found, max, j, p, last = 0, full = 0;
+  smpl_t next, *out;
+  do {
+    /* once the output is full, the next peak may still replace the last */
+    max = peaks->length - n;
+    out = max ? peaks->data + n : &next;
+    max = max ? max : 1;
+#if defined(HAVE_AUBIO_SIMD)
+    found = AUBIO_SIMD()->peaks (v->data, start, v->length, threshold, out,
+        max);
+#else
+    found = aubio_find_peaks_scan (v->data, start, v->length, threshold, out,
+        max);
+#endif
+    if (found == 0) break;
+    /* if out was filled, scan again after the last peak found */
+    start = (uint_t)out[found - 1] + 1;
+    /* of the peaks closer than min_distance, keep the highest */
+    for (j = 0; j < found && !full; j++) {
+      p = (uint_t)out[j];
+      if (n > 0 && p - last < min_distance) {
+        if (v->data[p] <= v->data[last]) continue;
+        n--;
+      } else if (n == peaks->length) {
+        full = 1;
+        continue;
+      }
+      peaks->data[n++] = p;
+      last = p;
+    }
+  } while (!full && found == max);
+  for (j = 0; j < n; j++) {
+    peaks->data[j] = fvec_quadratic_peak_pos (v, (uint_t)peaks->data[j]);
+  }
+  return n;
+}
+
 smpl_t
 aubio_quadfrac (smpl_t s0, smpl_t s1, smpl_t s2, smpl_t pf)
 {
@@ -550,6 +855,36 @@ aubio_miditofreq (smpl_t midi)
   return freq;
 }
 
+/* The vector versions below give the same results as the scalar functions,
+   which the compiler inlines in their loops. */
+
+void
+fvec_unwrap2pi (fvec_t * s)
+{
+  uint_t j;
+  for (j = 0; j < s->length; j++) {
+    s->data[j] = aubio_unwrap2pi (s->data[j]);
+  }
+}
+
+void
+fvec_freqtomidi (fvec_t * s)
+{
+  uint_t j;
+  for (j = 0; j < s->length; j++) {
+    s->data[j] = aubio_freqtomidi (s->data[j]);
+  }
+}
+
+void
+fvec_miditofreq (fvec_t * s)
+{
+  uint_t j;
+  for (j = 0; j < s->length; j++) {
+    s->data[j] = aubio_miditofreq (s->data[j]);
+  }
+}
+
 smpl_t
 aubio_bintofreq (smpl_t bin, smpl_t samplerate, smpl_t fftsize)
 {
@@ -630,6 +965,33 @@ aubio_level_detection (const fvec_t * o, smpl_t threshold)
   }
 }
 
+void
+aubio_frame_stats_do (const fvec_t * v, smpl_t threshold,
+    aubio_frame_stats_t * stats)
+{
+  smpl_t energy, peak;
+  uint_t crossings;
+#if defined(HAVE_AUBIO_SIMD)
+  AUBIO_SIMD()->stats (v->data, v->length, &energy, &peak, &crossings);
+#else
+  uint_t j;
+  energy = 0.;
+  peak = 0.;
+  crossings = 0;
+  for (j = 0; j < v->length; j++) {
+    energy += SQR (v->data[j]);
+    peak = MAX (peak, ABS (v->data[j]));
+    if (j > 0 && (v->data[j - 1] < 0.) != (v->data[j] < 0.)) crossings++;
+  }
+#endif
+  stats->level = energy / v->length;
+  stats->rms = SQRT (stats->level);
+  stats->peak = peak;
+  stats->db_spl = 10. * LOG10 (stats->level);
+  stats->zcr = crossings / (smpl_t) v->length;
+  stats->silent = stats->db_spl < threshold;
+}
+
 smpl_t
 aubio_zero_crossing_rate (fvec_t * input)
 {
@@ -653,14 +1015,65 @@ aubio_zero_crossing_rate (fvec_t * input)
   return zcr / (smpl_t) input->length;
 }
 
+/* compute the autocorrelation of input from its power spectrum, zero padded
+ * to avoid circular overlap */
+void
+aubio_autocorr_fft_do (aubio_fft_t * fft, fvec_t * padded, fvec_t * spec,
+    const fvec_t * input, fvec_t * output)
+{
+  uint_t i, length = input->length, size = padded->length;
+  for (i = 0; i < length; i++) {
+    padded->data[i] = input->data[i];
+  }
+  for (i = length; i < size; i++) {
+    padded->data[i] = 0.;
+  }
+  aubio_fft_do_complex (fft, padded, spec);
+  /* squared magnitude in the real parts, zero imaginary parts */
+  spec->data[0] = SQR (spec->data[0]);
+  spec->data[size / 2] = SQR (spec->data[size / 2]);
+  for (i = 1; i < size / 2; i++) {
+    spec->data[i] = SQR (spec->data[i]) + SQR (spec->data[size - i]);
+    spec->data[size - i] = 0.;
+  }
+  aubio_fft_rdo_complex (fft, spec, padded);
+  for (i = 0; i < length; i++) {
+    output->data[i] = padded->data[i] / (smpl_t) (length - i);
+  }
+}
+
+/* returns AUBIO_FAIL if no fft could be created */
+static uint_t
+aubio_autocorr_fft (const fvec_t * input, fvec_t * output)
+{
+  uint_t size = aubio_next_power_of_two (2 * input->length);
+  uint_t err = AUBIO_FAIL;
+  aubio_fft_t *fft = new_aubio_fft (size);
+  fvec_t *padded = new_fvec (size);
+  fvec_t *spec = new_fvec (size);
+  if (!fft || !padded || !spec) goto beach;
+  aubio_autocorr_fft_do (fft, padded, spec, input, output);
+  err = AUBIO_OK;
+beach:
+  if (fft) del_aubio_fft (fft);
+  if (padded) del_fvec (padded);
+  if (spec) del_fvec (spec);
+  return err;
+}
+
 void
 aubio_autocorr (const fvec_t * input, fvec_t * output)
 {
   uint_t i, j, length = input->length;
   smpl_t *data, *acf;
-  smpl_t tmp = 0;
+  asmp_t tmp = 0;
   data = input->data;
   acf = output->data;
+  /* on long inputs, the fft is much faster than the direct sums */
+  if (length >= AUBIO_AUTOCORR_FFT_MIN
+      && aubio_autocorr_fft (input, output) == AUBIO_OK) {
+    return;
+  }
   for (i = 0; i < length; i++) {
     tmp = 0.;
     for (j = i; j < length; j++) {
@@ -673,6 +1086,8 @@ aubio_autocorr (const fvec_t * input, fvec_t * output)
 void
 aubio_cleanup (void)
 {
+  aubio_resampler_cleanup ();
+  aubio_samplecache_clear ();
 #ifdef HAVE_FFTW3F
   fftwf_cleanup ();
 #else
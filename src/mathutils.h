@@ -231,6 +231,9 @@ smpl_t fvec_moving_thres (fvec_t * v, fvec_t * tmp, uint_t post, uint_t pre,
   For each points at position p of an input vector, this function remove the
 moving median threshold computed at p.
 
+  The median is updated from one position to the next, for a cost in
+O(log(post+1+pre)) per element instead of O(post+1+pre).
+
   \param v input vector
   \param tmp temporary vector of length post+1+pre
   \param post length of causal part to take before pos
@@ -317,6 +320,28 @@ peak is defined as follows:
 */
 uint_t fvec_peakpick (const fvec_t * v, uint_t p);
 
+/** find all the peaks of a vector
+
+  A peak is found at each position p where v[p] is above the threshold and
+  above v[p-1] and v[p+1], as in fvec_peakpick() with a threshold of 0.
+
+  \param v input vector
+  \param threshold value the peaks must be above
+  \param min_distance minimum distance between two peaks, in elements; of
+  the peaks closer than this, only the highest is kept, each peak being
+  compared to the last one kept
+  \param peaks output vector, filled with the position of each peak, refined
+  with fvec_quadratic_peak_pos(), in increasing order
+
+  \return number of peaks found, at most `peaks->length`, the first ones
+
+  A vector of length `(v->length - 1) / 2` is large enough for all the peaks.
+  The vector is scanned with the vector units, several elements at a time.
+
+*/
+uint_t fvec_find_peaks (const fvec_t * v, smpl_t threshold,
+    uint_t min_distance, fvec_t * peaks);
+
 /** return 1 if a is a power of 2, 0 otherwise */
 uint_t aubio_is_power_of_two(uint_t a);
 
@@ -331,6 +356,9 @@ uint_t aubio_power_of_two_order(uint_t a);
   \param input vector to compute autocorrelation from
   \param output vector to store autocorrelation function to
 
+  Long inputs, from 128 samples or 1024 with fftw3, are processed with an
+  FFT, in O(n log n) instead of O(n^2).
+
 */
 void aubio_autocorr (const fvec_t * input, fvec_t * output);
 
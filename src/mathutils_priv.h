@@ -0,0 +1,116 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Autocorrelation with preallocated buffers, shared by mathutils.c and
+   tempo/beattracking.c, windows shared between objects, and the running
+   median of fvec_adapt_thres and onset/peakpicker.c.
+*/
+
+#ifndef AUBIO_MATHUTILS_PRIV_H
+#define AUBIO_MATHUTILS_PRIV_H
+
+/** length from which aubio_autocorr uses an fft */
+#ifndef AUBIO_AUTOCORR_FFT_MIN
+#ifdef HAVE_FFTW3
+/* each call plans a new transform, only worth it for longer inputs */
+#define AUBIO_AUTOCORR_FFT_MIN 1024
+#else
+#define AUBIO_AUTOCORR_FFT_MIN 128
+#endif
+#endif
+
+/** compute the autocorrelation of input through an fft
+
+  \param fft fft object of size `aubio_next_power_of_two(2 * input->length)`
+  \param padded scratch vector of the size of `fft`
+  \param spec scratch vector of the size of `fft`
+  \param input vector to compute autocorrelation from
+  \param output vector to store autocorrelation function to, as computed by
+  aubio_autocorr()
+
+*/
+void aubio_autocorr_fft_do (aubio_fft_t * fft, fvec_t * padded,
+    fvec_t * spec, const fvec_t * input, fvec_t * output);
+
+/** get a read-only window, shared with the other objects using the same type
+  and length
+
+  \param window_type type of the window, see fvec_set_window()
+  \param length length of the window
+
+  \return the shared window, or NULL on failure
+
+  The window is computed once, the first time it is acquired, and deleted
+  when the last object using it releases it with aubio_window_release().
+
+*/
+const fvec_t *aubio_window_acquire (const char_t * window_type,
+    uint_t length);
+
+/** release a window acquired with aubio_window_acquire()
+
+  \param win window to release, may be NULL
+
+*/
+void aubio_window_release (const fvec_t * win);
+
+/** running median of a window of values, updated one value at a time
+
+  The positions of the window are kept in two heaps, a max-heap of the lower
+  half and a min-heap of the upper half, so that changing a value costs
+  O(log n) and the median is at the top of the lower half.
+
+*/
+typedef struct {
+  smpl_t *ring;   /**< values of the window, in any order */
+  uint_t *heap;   /**< positions in ring, lower half then upper half */
+  uint_t *where;  /**< index in heap of each position of ring */
+  uint_t length;  /**< length of the window */
+  uint_t n_low;   /**< size of the lower half, its top is the median */
+} aubio_median_heap_t;
+
+/** set the window of a running median to zeros
+
+  \param h running median to initialise
+  \param ring values of the window, `length` elements, set to 0
+  \param heap scratch space of `length` elements
+  \param where scratch space of `length` elements
+  \param length length of the window, at least 1
+
+  As in fvec_median(), the median of an even number of values is the lower
+  one.
+
+*/
+void aubio_median_heap_init (aubio_median_heap_t * h, smpl_t * ring,
+    uint_t * heap, uint_t * where, uint_t length);
+
+/** change a value of the window of a running median
+
+  \param h running median, see aubio_median_heap_init()
+  \param pos position of the value in `h->ring`
+  \param value new value
+
+  eturn median of the window after the change
+
+*/
+smpl_t aubio_median_heap_set (aubio_median_heap_t * h, uint_t pos,
+    smpl_t value);
+
+#endif /* AUBIO_MATHUTILS_PRIV_H */
@@ -194,7 +194,8 @@ smpl_t aubio_miditofreq (smpl_t midi);
 /** clean up cached memory at the end of program
 
   This function should be used at the end of programs to purge all cached
-  memory. So far it is only useful to clean FFTW's cache.
+  memory, such as FFTW's cache, the filter tables of the resampler and the
+  samples of the cache that are no longer used.
 
 */
 void aubio_cleanup (void);
@@ -255,6 +256,32 @@ uint_t aubio_silence_detection (const fvec_t * v, smpl_t threshold);
 */
 smpl_t aubio_level_detection (const fvec_t * v, smpl_t threshold);
 
+/** level, peak and zero-crossing rate of a buffer, see aubio_frame_stats_do()
+*/
+typedef struct
+{
+  smpl_t level;   /**< average of the square amplitudes, see aubio_level_lin() */
+  smpl_t rms;     /**< square root of level */
+  smpl_t peak;    /**< largest absolute amplitude */
+  smpl_t db_spl;  /**< level in dB SPL, see aubio_db_spl() */
+  smpl_t zcr;     /**< zero-crossing rate, see aubio_zero_crossing_rate() */
+  uint_t silent;  /**< 1 if db_spl is under the threshold, 0 otherwise */
+} aubio_frame_stats_t;
+
+/** compute the level, peak and zero-crossing rate of a buffer in one pass
+
+  \param v vector to compute the statistics of
+  \param threshold silence threshold in dB SPL, see aubio_silence_detection()
+  \param stats statistics of v
+
+  The result can be given to aubio_onset_do_stats(), aubio_pitch_do_stats()
+  and aubio_tempo_do_stats(), so that the detectors running on the same
+  buffer do not compute its level again.
+
+*/
+void aubio_frame_stats_do (const fvec_t * v, smpl_t threshold,
+    aubio_frame_stats_t * stats);
+
 /** clamp the values of a vector within the range [-abs(max), abs(max)]
 
   \param in vector to clamp
@@ -263,6 +290,27 @@ smpl_t aubio_level_detection (const fvec_t * v, smpl_t threshold);
 */
 void fvec_clamp(fvec_t *in, smpl_t absmax);
 
+/** map each element of a vector to the unit circle, in place
+
+  \param s vector of phases, see aubio_unwrap2pi()
+
+*/
+void fvec_unwrap2pi (fvec_t * s);
+
+/** convert each element of a vector from frequency (Hz) to midi, in place
+
+  \param s vector of frequencies, see aubio_freqtomidi()
+
+*/
+void fvec_freqtomidi (fvec_t * s);
+
+/** convert each element of a vector from midi to frequency (Hz), in place
+
+  \param s vector of midi values, see aubio_miditofreq()
+
+*/
+void fvec_miditofreq (fvec_t * s);
+
 #ifdef __cplusplus
 }
 #endif
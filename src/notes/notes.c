@@ -20,7 +20,10 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
 #include "pitch/pitch.h"
+#include "utils/events.h"
 #include "onset/onset.h"
 #include "notes/notes.h"
 
@@ -40,8 +43,9 @@ struct _aubio_notes_t {
   uint_t samplerate;
 
   uint_t median;
-  fvec_t *note_buffer;
-  fvec_t *note_buffer2;
+  fvec_t *note_buffer;    /**< last candidates, in order of arrival */
+  fvec_t *note_sorted;    /**< the same candidates, sorted */
+  uint_t note_pos;        /**< position of the oldest one in note_buffer */
 
   aubio_pitch_t *pitch;
   fvec_t *pitch_output;
@@ -60,6 +64,13 @@ struct _aubio_notes_t {
 
   smpl_t last_onset_level;
   smpl_t release_drop_level;
+
+  smpl_t sustain_interval_ms;
+  uint_t sustain_interval;  /**< hops between two pitch checks of a held
+                                 note, 0 to never check */
+  uint_t sustain_count;     /**< hops since the last check */
+  uint_t retrigger;         /**< 1 if the median is read after a change of
+                                 pitch, rather than after an onset */
 };
 
 aubio_notes_t * new_aubio_notes (const char_t * method,
@@ -103,10 +114,11 @@ aubio_notes_t * new_aubio_notes (const char_t * method,
     goto fail;
   }
   o->note_buffer = new_fvec(o->median);
-  o->note_buffer2 = new_fvec(o->median);
+  o->note_sorted = new_fvec(o->median);
+  o->note_pos = 0;
 
   if (!o->onset_output || !o->pitch_output ||
-      !o->note_buffer || !o->note_buffer2) goto fail;
+      !o->note_buffer || !o->note_sorted) goto fail;
 
   o->curnote = -1.;
   o->newnote = 0.;
@@ -142,6 +154,23 @@ smpl_t aubio_notes_get_silence(const aubio_notes_t *o)
   return aubio_pitch_get_silence(o->pitch);
 }
 
+uint_t aubio_notes_set_gating(aubio_notes_t *o, uint_t gating)
+{
+  uint_t err = AUBIO_OK;
+  if (aubio_pitch_set_gating(o->pitch, gating) != AUBIO_OK) {
+    err = AUBIO_FAIL;
+  }
+  if (aubio_onset_set_gating(o->onset, gating) != AUBIO_OK) {
+    err = AUBIO_FAIL;
+  }
+  return err;
+}
+
+uint_t aubio_notes_get_gating(const aubio_notes_t *o)
+{
+  return aubio_onset_get_gating(o->onset);
+}
+
 uint_t aubio_notes_set_minioi_ms (aubio_notes_t *o, smpl_t minioi_ms)
 {
   uint_t err = AUBIO_OK;
@@ -173,42 +202,127 @@ smpl_t aubio_notes_get_release_drop(const aubio_notes_t *o)
   return o->release_drop_level;
 }
 
-/** append new note candidate to the note_buffer and return filtered value. we
- * need to copy the input array as fvec_median destroy its input data.*/
+uint_t aubio_notes_set_sustain_interval_ms (aubio_notes_t *o,
+    smpl_t interval_ms)
+{
+  if (interval_ms < 0.) {
+    AUBIO_ERR("notes: sustain_interval_ms should be >= 0, got %f\n",
+        interval_ms);
+    return AUBIO_FAIL;
+  }
+  o->sustain_interval_ms = interval_ms;
+  o->sustain_interval = 0;
+  if (interval_ms > 0.) {
+    o->sustain_interval = MAX(1, ROUND(interval_ms * o->samplerate
+          / (1000. * o->hop_size)));
+  }
+  o->sustain_count = 0;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_notes_get_sustain_interval_ms (const aubio_notes_t *o)
+{
+  return o->sustain_interval_ms;
+}
+
+/* blocks between an onset and its note-on, to read the median of the pitch */
+static uint_t aubio_notes_get_wait (const aubio_notes_t *o)
+{
+  return o->median ? (o->median - 1) * o->hop_size : 0;
+}
+
+uint_t aubio_notes_get_latency(const aubio_notes_t *o)
+{
+  return aubio_onset_get_latency(o->onset) + aubio_notes_get_wait(o);
+}
+
+uint_t aubio_notes_set_latency(aubio_notes_t *o, uint_t latency)
+{
+  uint_t wait = aubio_notes_get_wait(o);
+  if (latency < wait) {
+    AUBIO_ERR("notes: latency should be at least %d samples, got %d\n",
+        wait, latency);
+    return AUBIO_FAIL;
+  }
+  return aubio_onset_set_latency(o->onset, latency - wait);
+}
+
+/** append new note candidate to the note_buffer, replacing the oldest one,
+ * and move it to its place in note_sorted, so that the median can be read
+ * without copying nor sorting the buffer. */
 static void
-note_append (fvec_t * note_buffer, smpl_t curnote)
+note_append (aubio_notes_t *o, smpl_t curnote)
 {
-  uint_t i = 0;
-  for (i = 0; i < note_buffer->length - 1; i++) {
-    note_buffer->data[i] = note_buffer->data[i + 1];
+  uint_t i, n = o->median;
+  smpl_t *sorted = o->note_sorted->data;
+  smpl_t old = o->note_buffer->data[o->note_pos];
+  //smpl_t new = ROUND(10.*curnote)/10.;
+  smpl_t new = ROUND(AUBIO_DEFAULT_CENT_PRECISION*curnote);
+  o->note_buffer->data[o->note_pos] = new;
+  o->note_pos = (o->note_pos + 1) % n;
+  // remove the oldest candidate, then shift the values between its position
+  // and that of the new one
+  for (i = 0; i < n - 1 && sorted[i] != old; i++);
+  while (i > 0 && sorted[i - 1] > new) {
+    sorted[i] = sorted[i - 1];
+    i--;
   }
-  //note_buffer->data[note_buffer->length - 1] = ROUND(10.*curnote)/10.;
-  note_buffer->data[note_buffer->length - 1] = ROUND(AUBIO_DEFAULT_CENT_PRECISION*curnote);
-  return;
+  while (i < n - 1 && sorted[i + 1] < new) {
+    sorted[i] = sorted[i + 1];
+    i++;
+  }
+  sorted[i] = new;
 }
 
 static smpl_t
 aubio_notes_get_latest_note (aubio_notes_t *o)
 {
-  fvec_copy(o->note_buffer, o->note_buffer2);
-  return fvec_median (o->note_buffer2) / AUBIO_DEFAULT_CENT_PRECISION;
+  // the element fvec_median would return
+  return o->note_sorted->data[(o->median - 1) / 2]
+    / AUBIO_DEFAULT_CENT_PRECISION;
 }
 
 
 void aubio_notes_do (aubio_notes_t *o, const fvec_t * input, fvec_t * notes)
 {
   smpl_t new_pitch, curlevel;
+  aubio_frame_stats_t stats;
+  uint_t check = 0;
+  AUBIO_STATS_BEGIN ("notes");
   fvec_zeros(notes);
-  aubio_onset_do(o->onset, input, o->onset_output);
+  // the level of the input, shared by the onset and pitch objects
+  aubio_frame_stats_do (input, o->silence_threshold, &stats);
+  aubio_onset_do_stats (o->onset, input, &stats, o->onset_output);
+
+  // a held note is checked every sustain_interval hops, in case its pitch
+  // changed without an onset
+  if (o->sustain_interval && o->curnote > 0 && !stats.silent
+      && o->onset_output->data[0] == 0
+      && (o->isready == 0 || o->isready >= o->median)) {
+    if (++o->sustain_count >= o->sustain_interval) {
+      o->sustain_count = 0;
+      check = 1;
+    }
+  } else {
+    o->sustain_count = 0;
+  }
 
-  aubio_pitch_do (o->pitch, input, o->pitch_output);
+  // the pitch is only read at onsets, on the next median - 1 frames, and
+  // at the checks of held notes
+  if (o->onset_output->data[0] != 0 || check
+      || (o->isready > 0 && o->isready < o->median)) {
+    aubio_pitch_do_stats (o->pitch, input, &stats, o->pitch_output);
+  } else {
+    aubio_pitch_skip (o->pitch, input);
+    o->pitch_output->data[0] = 0.;
+  }
   new_pitch = o->pitch_output->data[0];
   if(o->median){
-    note_append(o->note_buffer, new_pitch);
+    note_append(o, new_pitch);
   }
 
   /* curlevel is negatif or 1 if silence */
-  curlevel = aubio_level_detection(input, o->silence_threshold);
+  curlevel = stats.silent ? 1. : stats.db_spl;
   if (o->onset_output->data[0] != 0) {
     /* test for silence */
     if (curlevel == 1.) {
@@ -220,6 +334,7 @@ void aubio_notes_do (aubio_notes_t *o, const fvec_t * input, fvec_t * notes)
       //AUBIO_WRN("notes: sending note-off at onset, not enough level\n");
       notes->data[2] = o->curnote;
     } else {
+      o->retrigger = 0;
       if (o->median) {
         o->isready = 1;
       } else {
@@ -249,36 +364,58 @@ void aubio_notes_do (aubio_notes_t *o, const fvec_t * input, fvec_t * notes)
     }
     else if (o->median)
     {
-      if (o->isready > 0)
+      if (check && new_pitch > 0. && ROUND(AUBIO_DEFAULT_CENT_PRECISION
+            * new_pitch) / AUBIO_DEFAULT_CENT_PRECISION != o->curnote) {
+        /* the pitch moved away from the held note, read the median of the
+           next frames as after an onset */
+        o->isready = 1;
+        o->retrigger = 1;
+        o->last_onset_level = curlevel;
+      } else if (o->isready > 0)
         o->isready++;
       if (o->isready == o->median)
       {
-        /* kill old note */
-        //send_noteon(curnote,0);
-        if (o->curnote != 0)
-        {
-          //AUBIO_WRN("notes: sending note-off, new note detected\n");
-          notes->data[2] = o->curnote;
-        }
         o->newnote = aubio_notes_get_latest_note(o);
-        o->curnote = o->newnote;
-        /* get and send new one */
-        if (o->curnote>45){
-          //send_noteon(curnote,127+(int)floor(curlevel));
-          notes->data[0] = o->curnote;
-          notes->data[1] = 127 + (int) floor(curlevel);
+        /* after a change of pitch, keep the held note if the median did not
+           confirm it */
+        if (!o->retrigger || o->newnote != o->curnote) {
+          /* kill old note */
+          //send_noteon(curnote,0);
+          if (o->curnote != 0)
+          {
+            //AUBIO_WRN("notes: sending note-off, new note detected\n");
+            notes->data[2] = o->curnote;
+          }
+          o->curnote = o->newnote;
+          /* get and send new one */
+          if (o->curnote>45){
+            //send_noteon(curnote,127+(int)floor(curlevel));
+            notes->data[0] = o->curnote;
+            notes->data[1] = 127 + (int) floor(curlevel);
+          }
         }
+        o->retrigger = 0;
       }
     } // if median
   }
+  AUBIO_STATS_END ();
 }
 
 void del_aubio_notes (aubio_notes_t *o) {
   if (o->note_buffer) del_fvec(o->note_buffer);
-  if (o->note_buffer2) del_fvec(o->note_buffer2);
+  if (o->note_sorted) del_fvec(o->note_sorted);
   if (o->pitch_output) del_fvec(o->pitch_output);
   if (o->pitch) del_aubio_pitch(o->pitch);
   if (o->onset_output) del_fvec(o->onset_output);
   if (o->onset) del_aubio_onset(o->onset);
   AUBIO_FREE(o);
 }
+
+uint_t aubio_notes_get_memory_usage (const aubio_notes_t *o) {
+  uint_t n = aubio_malloc_size(o) + aubio_malloc_size(o->note_buffer)
+    + aubio_malloc_size(o->note_sorted) + aubio_malloc_size(o->pitch_output)
+    + aubio_malloc_size(o->onset_output);
+  if (o->pitch) n += aubio_pitch_get_memory_usage(o->pitch);
+  if (o->onset) n += aubio_onset_get_memory_usage(o->onset);
+  return n;
+}
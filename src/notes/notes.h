@@ -47,6 +47,16 @@ typedef struct _aubio_notes_t aubio_notes_t;
 aubio_notes_t * new_aubio_notes (const char_t * method,
     uint_t buf_size, uint_t hop_size, uint_t samplerate);
 
+/** get the memory used by a notes detection object
+
+  \param o notes detection object as returned by new_aubio_notes()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_notes_get_memory_usage (const aubio_notes_t * o);
+
 /** delete notes detection object
 
   \param o notes detection object to delete
@@ -87,6 +97,29 @@ uint_t aubio_notes_set_silence(aubio_notes_t * o, smpl_t silence);
 */
 smpl_t aubio_notes_get_silence(const aubio_notes_t * o);
 
+/** enable or disable silence gating
+
+  \param o notes detection object as returned by new_aubio_notes()
+  \param gating 1 to enable, 0 to disable [0]
+
+  \return 0 on success, non-zero otherwise
+
+  Enables the silence gating of the onset and pitch objects, see
+  aubio_onset_set_gating() and aubio_pitch_set_gating(), so that silent hops
+  cost little more than the computation of their level.
+
+*/
+uint_t aubio_notes_set_gating(aubio_notes_t * o, uint_t gating);
+
+/** get silence gating mode
+
+  \param o notes detection object as returned by new_aubio_notes()
+
+  \return 1 if silence gating is enabled, 0 otherwise
+
+*/
+uint_t aubio_notes_get_gating(const aubio_notes_t * o);
+
 /** get notes detection minimum inter-onset interval, in millisecond
 
   \param o notes detection object as returned by new_aubio_notes()
@@ -115,6 +148,27 @@ uint_t aubio_notes_set_minioi_ms (aubio_notes_t *o, smpl_t minioi_ms);
  */
 smpl_t aubio_notes_get_release_drop (const aubio_notes_t *o);
 
+/** get the latency of the notes detection, in samples
+
+  \param o notes detection object as returned by new_aubio_notes()
+
+  \return time between an onset and the end of the block where its note-on
+  is reported, in samples: the latency of the onset detection, and the
+  blocks needed to read the median of the pitch
+
+*/
+uint_t aubio_notes_get_latency (const aubio_notes_t *o);
+
+/** set the maximum latency of the notes detection, in samples
+
+  \param o notes detection object as returned by new_aubio_notes()
+  \param latency target latency, see aubio_onset_set_latency()
+
+  \return 0 on success, non-zero otherwise
+
+*/
+uint_t aubio_notes_set_latency (aubio_notes_t *o, uint_t latency);
+
 /** set note release drop level, in dB
 
   This function sets the release_drop_level parameter, in dB. When a new note
@@ -136,6 +190,37 @@ smpl_t aubio_notes_get_release_drop (const aubio_notes_t *o);
 */
 uint_t aubio_notes_set_release_drop (aubio_notes_t *o, smpl_t release_drop);
 
+/** set the interval between the pitch checks of held notes, in ms
+
+  The pitch is only computed on the blocks following an onset, long enough
+  to read its median. A note whose pitch changes without a new onset, for
+  instance a legato or slurred note, is then missed. With a positive
+  interval, the pitch of a held note is also computed every `interval_ms`;
+  when it moved to another note, the median is read again on the following
+  blocks, and the new note is reported if the median confirms it.
+
+  Smaller intervals find these notes sooner, at the cost of more pitch
+  computations. The blocks in between still skip the pitch detection.
+
+  \param o notes detection object as returned by new_aubio_notes()
+  \param interval_ms time between two checks, in ms, or `0` to never check
+  held notes [0]
+
+  \return 0 on success, non-zero if `interval_ms` is negative
+
+*/
+uint_t aubio_notes_set_sustain_interval_ms (aubio_notes_t *o,
+    smpl_t interval_ms);
+
+/** get the interval between the pitch checks of held notes, in ms
+
+  \param o notes detection object as returned by new_aubio_notes()
+
+  \return current interval, in ms, `0` if held notes are not checked
+
+*/
+smpl_t aubio_notes_get_sustain_interval_ms (const aubio_notes_t *o);
+
 #ifdef __cplusplus
 }
 #endif
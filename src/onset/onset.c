@@ -21,15 +21,29 @@
 #include "aubio_priv.h"
 #include "fvec.h"
 #include "cvec.h"
+#include "fmat.h"
 #include "spectral/specdesc.h"
 #include "spectral/phasevoc.h"
 #include "spectral/awhitening.h"
 #include "onset/peakpicker.h"
 #include "mathutils.h"
+#include "utils/pending_priv.h"
+#include "utils/events.h"
+#include "utils/history.h"
 #include "onset/onset.h"
 
 void aubio_onset_default_parameters (aubio_onset_t *o, const char_t * method);
 
+/** other peak picking parameters applied to the same description, see
+  aubio_onset_add_variant() */
+typedef struct {
+  smpl_t threshold;             /**< peak picking threshold */
+  uint_t minioi;                /**< minimum inter onset interval */
+  uint_t last_onset;            /**< last detected onset location, in frames */
+  smpl_t peek[3];               /**< last three thresholded values */
+  smpl_t onset;                 /**< output at the last hop */
+} aubio_onset_variant_t;
+
 /** structure to store object state */
 struct _aubio_onset_t {
   aubio_pvoc_t * pv;            /**< phase vocoder */
@@ -50,41 +64,437 @@ struct _aubio_onset_t {
   smpl_t lambda_compression;
   uint_t apply_awhitening;      /**< apply adaptive spectral whitening */
   aubio_spectral_whitening_t *spectral_whitening;
+
+  char_t *method;               /**< onset method, to create channel objects */
+  uint_t buf_size;              /**< buffer size, to create channel objects */
+  aubio_onset_t **channels;     /**< objects analysing channels 1 and up */
+  uint_t n_channels;            /**< number of objects in channels */
+
+  uint_t lowlatency;            /**< pick peaks in the short window */
+  uint_t short_size;            /**< size of the short window */
+  aubio_pvoc_t * short_pv;      /**< phase vocoder of the short window */
+  aubio_specdesc_t * short_od;  /**< spectral descriptor of the short window */
+  cvec_t * short_grain;         /**< spectrum of the short window */
+  fvec_t * short_desc;          /**< description of the short window */
+  smpl_t desc_mean;             /**< running mean of the long description */
+  uint_t gating;                /**< skip the spectral analysis of silent hops */
+  uint_t gated;                 /**< number of silent hops skipped in a row,
+                                     up to AUBIO_ONSET_GATED_HOPS */
+  aubio_onset_variant_t *variants; /**< other thresholds and minioi */
+  uint_t n_variants;            /**< number of elements in variants */
+  uint_t deferred;              /**< post parameters to pending */
+  aubio_pending_t pending;      /**< parameters posted by other threads */
+  aubio_events_t *events;       /**< queue receiving the onsets, or NULL */
+  uint_t events_channel;        /**< channel of the pushed events */
+  u64_t frames;                 /**< total_frames, without wrapping around */
+  aubio_history_t *desc_history;  /**< last values of desc, or NULL */
+  aubio_history_t *thresholded_history; /**< last thresholded values */
+};
+
+/** ids of the parameters posted when deferred */
+enum {
+  AUBIO_ONSET_THRESHOLD,
+  AUBIO_ONSET_SILENCE,
+  AUBIO_ONSET_MINIOI,
+  AUBIO_ONSET_DELAY,
+  AUBIO_ONSET_COMPRESSION
 };
 
+/** number of silent hops given to the descriptors as empty spectra when
+  gating, so that their past spectra are those of a silence */
+#define AUBIO_ONSET_GATED_HOPS 2
+
+/* make sure o->channels holds at least n_channels - 1 objects */
+static uint_t aubio_onset_alloc_channels (aubio_onset_t *o, uint_t n_channels);
+
+/* copy the parameters of o to the channel object c */
+static void aubio_onset_sync_channel (const aubio_onset_t *o, aubio_onset_t *c);
+
+/* detect onsets from the spectrum stored in o->fftgrain, reading the level
+   of input from stats if it is not NULL */
+static void aubio_onset_do_fftgrain (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * onset);
+
+/* 1 if input is under the silence threshold, reading its level from stats if
+   it is not NULL */
+static uint_t aubio_onset_is_silent (const aubio_onset_t *o,
+    const fvec_t * input, const aubio_frame_stats_t * stats);
+
+/* store a silent hop without analysing it, as if its description was 0 */
+static void aubio_onset_do_silent (aubio_onset_t *o, const fvec_t * input,
+    fvec_t * onset);
+
+/* mark onsets from the output of the peak picker, stored in onset, checking
+   the silence, the minimum inter-onset interval and the delay */
+static void aubio_onset_mark (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * onset);
+
+/* return isonset if it is marked as an onset, given minioi and the last
+   onset, which is updated, 0 otherwise */
+static smpl_t aubio_onset_mark_with (const aubio_onset_t *o,
+    const fvec_t * input, const aubio_frame_stats_t * stats, smpl_t isonset,
+    uint_t minioi, uint_t *last_onset);
+
+/* pick the peaks of the variants from the last value thresholded by o->pp,
+   or only push the value if pick is 0 */
+static void aubio_onset_pick_variants (aubio_onset_t *o, uint_t pick);
+
+/* mark the peaks of the variants, as aubio_onset_mark() */
+static void aubio_onset_mark_variants (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats);
+
+/* apply the parameters posted since the last hop */
+static void aubio_onset_apply_pending (aubio_onset_t *o);
+
+/* push the descriptor of this hop to the histories, if any */
+static void aubio_onset_record (aubio_onset_t *o);
+
 /* execute onset detection function on iput buffer */
 void aubio_onset_do (aubio_onset_t *o, const fvec_t * input, fvec_t * onset)
 {
-  smpl_t isonset = 0;
-  aubio_pvoc_do (o->pv,input, o->fftgrain);
+  aubio_onset_do_stats (o, input, NULL, onset);
+}
+
+void aubio_onset_do_stats (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * onset)
+{
+  AUBIO_STATS_BEGIN ("onset");
+  aubio_onset_apply_pending (o);
+  if (o->gating && aubio_onset_is_silent (o, input, stats)) {
+    aubio_onset_do_silent (o, input, onset);
+  } else {
+    aubio_pvoc_do (o->pv,input, o->fftgrain);
+    aubio_onset_do_fftgrain (o, input, stats, onset);
+    o->gated = 0;
+  }
+  AUBIO_STATS_END ();
+}
+
+void aubio_onset_do_s16 (aubio_onset_t *o, const s16_t * input,
+    fvec_t * onset)
+{
+  fvec_t converted;
+  AUBIO_STATS_BEGIN ("onset");
+  aubio_onset_apply_pending (o);
+  aubio_pvoc_do_s16 (o->pv, input, o->fftgrain);
+  // the converted samples, as stored by the phase vocoder
+  aubio_pvoc_get_input (o->pv, &converted);
+  aubio_onset_do_fftgrain (o, &converted, NULL, onset);
+  AUBIO_STATS_END ();
+}
+
+void aubio_onset_do_spectrum (aubio_onset_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, fvec_t * onset)
+{
+  aubio_onset_do_spectrum_stats (o, input, fftgrain, NULL, onset);
+}
+
+void aubio_onset_do_spectrum_stats (aubio_onset_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, const aubio_frame_stats_t * stats,
+    fvec_t * onset)
+{
+  if (fftgrain->length != o->fftgrain->length) {
+    AUBIO_ERR ("onset: expected a spectrum of length %d, got %d\n",
+        o->fftgrain->length, fftgrain->length);
+    aubio_onset_do_stats (o, input, stats, onset);
+    return;
+  }
+  aubio_onset_apply_pending (o);
+  // whitening and compression modify the spectrum, work on a copy
+  cvec_copy (fftgrain, o->fftgrain);
+  aubio_onset_do_fftgrain (o, input, stats, onset);
+}
+
+void aubio_onset_do_multi (aubio_onset_t *o, const fmat_t * input,
+    fvec_t * onset)
+{
+  uint_t ch;
+  fvec_t input_ch, onset_ch;
+  if (input->length != o->hop_size) {
+    AUBIO_ERR ("onset: expected input frames of length %d, got %d\n",
+        o->hop_size, input->length);
+    return;
+  }
+  if (onset->length < input->height) {
+    AUBIO_ERR ("onset: output of length %d is too short for %d channels\n",
+        onset->length, input->height);
+    return;
+  }
+  if (aubio_onset_alloc_channels (o, input->height) != AUBIO_OK) {
+    return;
+  }
+  for (ch = 0; ch < input->height; ch++) {
+    aubio_onset_t *c = o;
+    fmat_get_channel (input, ch, &input_ch);
+    fvec_view (&onset_ch, onset, ch, 1);
+    if (ch > 0) {
+      c = o->channels[ch - 1];
+      aubio_onset_sync_channel (o, c);
+      c->events_channel = ch;
+    }
+    aubio_onset_do (c, &input_ch, &onset_ch);
+  }
+}
+
+static void aubio_onset_apply_pending (aubio_onset_t *o)
+{
+  smpl_t values[AUBIO_PENDING_MAX];
+  uint_t posted = aubio_pending_take (&o->pending, values);
+  if (!posted) return;
+  if (posted & (1u << AUBIO_ONSET_THRESHOLD))
+    aubio_peakpicker_set_threshold (o->pp, values[AUBIO_ONSET_THRESHOLD]);
+  if (posted & (1u << AUBIO_ONSET_SILENCE))
+    o->silence = values[AUBIO_ONSET_SILENCE];
+  if (posted & (1u << AUBIO_ONSET_MINIOI))
+    o->minioi = (uint_t)values[AUBIO_ONSET_MINIOI];
+  if (posted & (1u << AUBIO_ONSET_DELAY))
+    o->delay = (uint_t)values[AUBIO_ONSET_DELAY];
+  if (posted & (1u << AUBIO_ONSET_COMPRESSION)) {
+    o->lambda_compression = values[AUBIO_ONSET_COMPRESSION];
+    o->apply_compression = (o->lambda_compression > 0.) ? 1 : 0;
+  }
+}
+
+void aubio_onset_do_block (aubio_onset_t *o, const fvec_t * input)
+{
+  uint_t i;
+  smpl_t isonset;
+  fvec_t hop, onset;
+  if (input->length % o->hop_size != 0) {
+    AUBIO_ERR ("onset: expected a block of a multiple of %d frames, got %d\n",
+        o->hop_size, input->length);
+    return;
+  }
+  hop.length = o->hop_size;
+  onset.length = 1;
+  onset.data = &isonset;
+  for (i = 0; i < input->length; i += o->hop_size) {
+    hop.data = input->data + i;
+    aubio_onset_do (o, &hop, &onset);
+  }
+}
+
+uint_t aubio_onset_set_events (aubio_onset_t *o, aubio_events_t *events)
+{
+  o->events = events;
+  o->events_channel = 0;
+  return AUBIO_OK;
+}
+
+aubio_events_t *aubio_onset_get_events (const aubio_onset_t *o)
+{
+  return o->events;
+}
+
+static uint_t aubio_onset_alloc_channels (aubio_onset_t *o, uint_t n_channels)
+{
+  uint_t i;
+  aubio_onset_t **channels;
+  if (n_channels <= o->n_channels + 1) {
+    return AUBIO_OK;
+  }
+  channels = AUBIO_ARRAY(aubio_onset_t *, n_channels - 1);
+  for (i = 0; i < o->n_channels; i++) {
+    channels[i] = o->channels[i];
+  }
+  if (o->channels) {
+    AUBIO_FREE(o->channels);
+  }
+  o->channels = channels;
+  for (i = o->n_channels; i < n_channels - 1; i++) {
+    channels[i] = new_aubio_onset (o->method, o->buf_size, o->hop_size,
+        o->samplerate);
+    if (!channels[i]) {
+      AUBIO_ERR ("onset: failed creating the object of channel %d\n", i + 1);
+      return AUBIO_FAIL;
+    }
+    // start counting frames along with the first channel
+    channels[i]->total_frames = o->total_frames;
+    channels[i]->frames = o->frames;
+    o->n_channels = i + 1;
+  }
+  return AUBIO_OK;
+}
+
+static void aubio_onset_sync_channel (const aubio_onset_t *o, aubio_onset_t *c)
+{
+  aubio_spectral_whitening_t *w = o->spectral_whitening;
+  // before copying the delay, which aubio_onset_set_lowlatency moves
+  if (c->lowlatency != o->lowlatency) {
+    aubio_onset_set_lowlatency (c, o->lowlatency);
+  }
+  c->silence = o->silence;
+  c->gating = o->gating;
+  c->minioi = o->minioi;
+  c->delay = o->delay;
+  c->apply_compression = o->apply_compression;
+  c->lambda_compression = o->lambda_compression;
+  c->apply_awhitening = o->apply_awhitening;
+  c->events = o->events;
+  aubio_peakpicker_set_threshold (c->pp, aubio_peakpicker_get_threshold (o->pp));
+  if (aubio_peakpicker_get_win_pre (c->pp)
+      != aubio_peakpicker_get_win_pre (o->pp)) {
+    aubio_peakpicker_set_window (c->pp, aubio_peakpicker_get_win_pre (o->pp),
+        aubio_peakpicker_get_win_post (o->pp));
+  }
+  if (aubio_spectral_whitening_get_relax_time (c->spectral_whitening)
+      != aubio_spectral_whitening_get_relax_time (w)) {
+    aubio_spectral_whitening_set_relax_time (c->spectral_whitening,
+        aubio_spectral_whitening_get_relax_time (w));
+  }
+  if (aubio_spectral_whitening_get_floor (c->spectral_whitening)
+      != aubio_spectral_whitening_get_floor (w)) {
+    aubio_spectral_whitening_set_floor (c->spectral_whitening,
+        aubio_spectral_whitening_get_floor (w));
+  }
+}
+
+static uint_t aubio_onset_is_silent (const aubio_onset_t *o,
+    const fvec_t * input, const aubio_frame_stats_t * stats)
+{
+  if (stats) return stats->db_spl < o->silence;
+  return aubio_silence_detection (input, o->silence);
+}
+
+static void aubio_onset_do_silent (aubio_onset_t *o, const fvec_t * input,
+    fvec_t * onset)
+{
+  aubio_pvoc_skip (o->pv, input);
+  if (o->gated < AUBIO_ONSET_GATED_HOPS) {
+    cvec_zeros (o->fftgrain);
+    aubio_specdesc_do (o->od, o->fftgrain, o->desc);
+    if (o->lowlatency) {
+      cvec_zeros (o->short_grain);
+      aubio_specdesc_do (o->short_od, o->short_grain, o->short_desc);
+    }
+    o->gated++;
+  }
+  fvec_zeros (o->desc);
+  if (o->lowlatency) {
+    o->desc_mean = .9 * o->desc_mean;
+    aubio_pvoc_skip (o->short_pv, input);
+    fvec_zeros (o->short_desc);
+    aubio_peakpicker_do (o->pp, o->short_desc, onset);
+  } else {
+    aubio_peakpicker_do (o->pp, o->desc, onset);
+  }
+  // silent onsets are never marked
+  onset->data[0] = 0.;
+  aubio_onset_pick_variants (o, 0);
+  aubio_onset_record (o);
+  o->total_frames += o->hop_size;
+  o->frames += o->hop_size;
+}
+
+static void aubio_onset_do_fftgrain (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * onset)
+{
   /*
   if (apply_filtering) {
   }
   */
   if (o->apply_awhitening) {
-    aubio_spectral_whitening_do(o->spectral_whitening, o->fftgrain);
-  }
-  if (o->apply_compression) {
+    // whiten and compress in a single pass
+    aubio_spectral_whitening_do_logmag(o->spectral_whitening, o->fftgrain,
+        o->apply_compression ? o->lambda_compression : 0.);
+  } else if (o->apply_compression) {
     cvec_logmag(o->fftgrain, o->lambda_compression);
   }
   aubio_specdesc_do (o->od, o->fftgrain, o->desc);
-  aubio_peakpicker_do(o->pp, o->desc, onset);
-  isonset = onset->data[0];
+  if (o->lowlatency) {
+    // pick the peaks of the short window, which reacts to a new onset in
+    // the first hop it enters, and keep those where the description of the
+    // long window stands above its running mean
+    uint_t rising = o->desc->data[0] > 1.2 * o->desc_mean;
+    o->desc_mean = .9 * o->desc_mean + .1 * o->desc->data[0];
+    aubio_pvoc_do (o->short_pv, input, o->short_grain);
+    if (o->apply_compression) {
+      cvec_logmag (o->short_grain, o->lambda_compression);
+    }
+    aubio_specdesc_do (o->short_od, o->short_grain, o->short_desc);
+    aubio_peakpicker_do (o->pp, o->short_desc, onset);
+    if (!rising) onset->data[0] = 0.;
+    aubio_onset_pick_variants (o, rising);
+  } else {
+    aubio_peakpicker_do(o->pp, o->desc, onset);
+    aubio_onset_pick_variants (o, 1);
+  }
+  aubio_onset_mark_variants (o, input, stats);
+  aubio_onset_mark (o, input, stats, onset);
+}
+
+void aubio_onset_do_descriptor (aubio_onset_t *o, smpl_t descriptor,
+    smpl_t db_spl, fvec_t * onset)
+{
+  aubio_frame_stats_t stats;
+  uint_t i;
+  aubio_onset_apply_pending (o);
+  if (o->lowlatency) {
+    AUBIO_ERR ("onset: can not pick onsets from a stored descriptor in low"
+        " latency mode\n");
+    onset->data[0] = 0.;
+    for (i = 0; i < o->n_variants; i++) o->variants[i].onset = 0.;
+    o->total_frames += o->hop_size;
+    o->frames += o->hop_size;
+    return;
+  }
+  // only the level is read by the silence test
+  memset (&stats, 0, sizeof (stats));
+  stats.db_spl = db_spl;
+  o->desc->data[0] = descriptor;
+  aubio_peakpicker_do (o->pp, o->desc, onset);
+  aubio_onset_pick_variants (o, 1);
+  aubio_onset_mark_variants (o, NULL, &stats);
+  aubio_onset_mark (o, NULL, &stats, onset);
+}
+
+static void aubio_onset_mark (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * onset)
+{
+  onset->data[0] = aubio_onset_mark_with (o, input, stats, onset->data[0],
+      o->minioi, &o->last_onset);
+  if (o->events && onset->data[0] != 0.) {
+    aubio_event_t event;
+    event.type = aubio_event_onset;
+    event.channel = o->events_channel;
+    // last_onset is within a few hops of total_frames, even once wrapped
+    event.position = (u64_t)((long long)o->frames
+        + (sint_t)(aubio_onset_get_last (o) - o->total_frames));
+    event.strength = o->desc->data[0];
+    aubio_events_push (o->events, &event);
+  }
+  aubio_onset_record (o);
+  o->total_frames += o->hop_size;
+  o->frames += o->hop_size;
+}
+
+static void aubio_onset_record (aubio_onset_t *o)
+{
+  if (!o->desc_history) return;
+  aubio_history_push_value (o->desc_history, o->desc->data[0]);
+  aubio_history_push_value (o->thresholded_history,
+      aubio_onset_get_thresholded_descriptor (o));
+}
+
+static smpl_t aubio_onset_mark_with (const aubio_onset_t *o,
+    const fvec_t * input, const aubio_frame_stats_t * stats, smpl_t isonset,
+    uint_t minioi, uint_t *last_onset)
+{
   if (isonset > 0.) {
-    if (aubio_silence_detection(input, o->silence)==1) {
+    if (aubio_onset_is_silent (o, input, stats)) {
       //AUBIO_DBG ("silent onset, not marking as onset\n");
       isonset  = 0;
     } else {
       // we have an onset
       uint_t new_onset = o->total_frames + (uint_t)ROUND(isonset * o->hop_size);
       // check if last onset time was more than minioi ago
-      if (o->last_onset + o->minioi < new_onset) {
+      if (*last_onset + minioi < new_onset) {
         // start of file: make sure (new_onset - delay) >= 0
-        if (o->last_onset > 0 && o->delay > new_onset) {
+        if (*last_onset > 0 && o->delay > new_onset) {
           isonset = 0;
         } else {
           //AUBIO_DBG ("accepted detection, marking as onset\n");
-          o->last_onset = MAX(o->delay, new_onset);
+          *last_onset = MAX(o->delay, new_onset);
         }
       } else {
         //AUBIO_DBG ("doubled onset, not marking as onset\n");
@@ -95,18 +505,49 @@ void aubio_onset_do (aubio_onset_t *o, const fvec_t * input, fvec_t * onset)
     // we are at the beginning of the file
     if (o->total_frames <= o->delay) {
       // and we don't find silence
-      if (aubio_silence_detection(input, o->silence) == 0) {
+      if (!aubio_onset_is_silent (o, input, stats)) {
         uint_t new_onset = o->total_frames;
-        if (o->total_frames == 0 || o->last_onset + o->minioi < new_onset) {
+        if (o->total_frames == 0 || *last_onset + minioi < new_onset) {
           isonset = o->delay / o->hop_size;
-          o->last_onset = o->total_frames + o->delay;
+          *last_onset = o->total_frames + o->delay;
         }
       }
     }
   }
-  onset->data[0] = isonset;
-  o->total_frames += o->hop_size;
-  return;
+  return isonset;
+}
+
+static void aubio_onset_pick_variants (aubio_onset_t *o, uint_t pick)
+{
+  smpl_t thresholded = aubio_peakpicker_get_thresholded_input (o->pp)->data[0];
+  smpl_t mean = aubio_peakpicker_get_mean (o->pp);
+  smpl_t threshold = aubio_peakpicker_get_threshold (o->pp);
+  fvec_t peek;
+  uint_t i;
+  peek.length = 3;
+  for (i = 0; i < o->n_variants; i++) {
+    aubio_onset_variant_t *v = &o->variants[i];
+    // the same value, with the threshold of the variant
+    v->peek[0] = v->peek[1];
+    v->peek[1] = v->peek[2];
+    v->peek[2] = thresholded + mean * (threshold - v->threshold);
+    peek.data = v->peek;
+    v->onset = 0.;
+    if (pick && fvec_peakpick (&peek, 1)) {
+      v->onset = fvec_quadratic_peak_pos (&peek, 1);
+    }
+  }
+}
+
+static void aubio_onset_mark_variants (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats)
+{
+  uint_t i;
+  for (i = 0; i < o->n_variants; i++) {
+    aubio_onset_variant_t *v = &o->variants[i];
+    v->onset = aubio_onset_mark_with (o, input, stats, v->onset, v->minioi,
+        &v->last_onset);
+  }
 }
 
 uint_t aubio_onset_get_last (const aubio_onset_t *o)
@@ -140,6 +581,10 @@ uint_t aubio_onset_set_compression (aubio_onset_t *o, smpl_t lambda)
   if (lambda < 0.) {
     return AUBIO_FAIL;
   }
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_ONSET_COMPRESSION, lambda);
+    return AUBIO_OK;
+  }
   o->lambda_compression = lambda;
   o->apply_compression = (o->lambda_compression > 0.) ? 1 : 0;
   return AUBIO_OK;
@@ -151,6 +596,10 @@ smpl_t aubio_onset_get_compression (aubio_onset_t *o)
 }
 
 uint_t aubio_onset_set_silence(aubio_onset_t * o, smpl_t silence) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_ONSET_SILENCE, silence);
+    return AUBIO_OK;
+  }
   o->silence = silence;
   return AUBIO_OK;
 }
@@ -159,7 +608,20 @@ smpl_t aubio_onset_get_silence(const aubio_onset_t * o) {
   return o->silence;
 }
 
+uint_t aubio_onset_set_gating(aubio_onset_t * o, uint_t gating) {
+  o->gating = gating ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_get_gating(const aubio_onset_t * o) {
+  return o->gating;
+}
+
 uint_t aubio_onset_set_threshold(aubio_onset_t * o, smpl_t threshold) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_ONSET_THRESHOLD, threshold);
+    return AUBIO_OK;
+  }
   aubio_peakpicker_set_threshold(o->pp, threshold);
   return AUBIO_OK;
 }
@@ -169,6 +631,10 @@ smpl_t aubio_onset_get_threshold(const aubio_onset_t * o) {
 }
 
 uint_t aubio_onset_set_minioi(aubio_onset_t * o, uint_t minioi) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_ONSET_MINIOI, minioi);
+    return AUBIO_OK;
+  }
   o->minioi = minioi;
   return AUBIO_OK;
 }
@@ -193,7 +659,74 @@ smpl_t aubio_onset_get_minioi_ms(const aubio_onset_t * o) {
   return aubio_onset_get_minioi_s (o) * 1000.;
 }
 
+uint_t aubio_onset_get_latency(const aubio_onset_t * o) {
+  uint_t size = o->lowlatency ? o->short_size : o->buf_size;
+  return size / 2 + aubio_peakpicker_get_latency (o->pp) * o->hop_size;
+}
+
+uint_t aubio_onset_set_latency(aubio_onset_t * o, uint_t latency) {
+  uint_t size = o->lowlatency ? o->short_size : o->buf_size;
+  uint_t min_latency = size / 2 + o->hop_size;
+  uint_t previous = aubio_onset_get_latency (o), win_pre;
+  if (latency < min_latency) {
+    AUBIO_ERR ("onset: latency should be at least %d samples, got %d\n",
+        min_latency, latency);
+    return AUBIO_FAIL;
+  }
+  win_pre = (latency - min_latency) / o->hop_size;
+  if (win_pre == aubio_peakpicker_get_win_pre (o->pp)) return AUBIO_OK;
+  if (aubio_peakpicker_set_window (o->pp, win_pre,
+        aubio_peakpicker_get_win_post (o->pp))) {
+    return AUBIO_FAIL;
+  }
+  // detections come later or earlier by as much, move the delay with them
+  latency = aubio_onset_get_latency (o);
+  o->delay = (o->delay + latency > previous) ? o->delay + latency - previous : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_set_lowlatency(aubio_onset_t * o, uint_t lowlatency) {
+  uint_t previous = aubio_onset_get_latency (o), latency;
+  lowlatency = lowlatency ? 1 : 0;
+  if (lowlatency == o->lowlatency) return AUBIO_OK;
+  if (lowlatency && !o->short_pv) {
+    o->short_pv = new_aubio_pvoc (o->short_size, o->hop_size);
+    o->short_od = new_aubio_specdesc (o->method, o->short_size);
+    o->short_grain = new_cvec (o->short_size);
+    o->short_desc = new_fvec (1);
+    if (!o->short_pv || !o->short_od || !o->short_grain || !o->short_desc) {
+      AUBIO_ERR ("onset: failed creating the short window of %d samples\n",
+          o->short_size);
+      return AUBIO_FAIL;
+    }
+    aubio_pvoc_set_magnitude_only (o->short_pv,
+        !aubio_specdesc_uses_phase (o->short_od));
+  }
+  o->lowlatency = lowlatency;
+  // causal running median, no smoothing, and a peak confirmed by the next
+  // value only
+  aubio_peakpicker_set_smoothing (o->pp, !lowlatency);
+  if (aubio_peakpicker_set_incremental (o->pp, lowlatency)
+      || aubio_peakpicker_set_window (o->pp, lowlatency ? 0 : 1,
+        aubio_peakpicker_get_win_post (o->pp))) {
+    return AUBIO_FAIL;
+  }
+  o->desc_mean = 0.;
+  // detections come earlier or later by as much, move the delay with them
+  latency = aubio_onset_get_latency (o);
+  o->delay = (o->delay + latency > previous) ? o->delay + latency - previous : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_get_lowlatency(const aubio_onset_t * o) {
+  return o->lowlatency;
+}
+
 uint_t aubio_onset_set_delay(aubio_onset_t * o, uint_t delay) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_ONSET_DELAY, delay);
+    return AUBIO_OK;
+  }
   o->delay = delay;
   return AUBIO_OK;
 }
@@ -218,6 +751,15 @@ smpl_t aubio_onset_get_delay_ms(const aubio_onset_t * o) {
   return aubio_onset_get_delay_s (o) * 1000.;
 }
 
+uint_t aubio_onset_set_deferred(aubio_onset_t * o, uint_t deferred) {
+  o->deferred = deferred ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_get_deferred(const aubio_onset_t * o) {
+  return o->deferred;
+}
+
 smpl_t aubio_onset_get_descriptor(const aubio_onset_t * o) {
   return o->desc->data[0];
 }
@@ -227,6 +769,99 @@ smpl_t aubio_onset_get_thresholded_descriptor(const aubio_onset_t * o) {
   return thresholded->data[0];
 }
 
+uint_t aubio_onset_set_history(aubio_onset_t * o, uint_t length) {
+  aubio_history_t *desc = NULL, *thresholded = NULL;
+  if (length > 0) {
+    desc = new_aubio_history (length, 1);
+    thresholded = new_aubio_history (length, 1);
+    if (!desc || !thresholded) {
+      if (desc) del_aubio_history (desc);
+      if (thresholded) del_aubio_history (thresholded);
+      return AUBIO_FAIL;
+    }
+  }
+  if (o->desc_history) {
+    del_aubio_history (o->desc_history);
+    del_aubio_history (o->thresholded_history);
+  }
+  o->desc_history = desc;
+  o->thresholded_history = thresholded;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_get_history(const aubio_onset_t * o) {
+  if (!o->desc_history) return 0;
+  return aubio_history_get_frames (o->desc_history)->height;
+}
+
+const fvec_t *aubio_onset_get_descriptor_history(const aubio_onset_t * o) {
+  if (!o->desc_history) return NULL;
+  return aubio_history_get_data (o->desc_history);
+}
+
+const fvec_t *aubio_onset_get_thresholded_history(const aubio_onset_t * o) {
+  if (!o->thresholded_history) return NULL;
+  return aubio_history_get_data (o->thresholded_history);
+}
+
+uint_t aubio_onset_add_variant (aubio_onset_t * o, smpl_t threshold,
+    uint_t minioi)
+{
+  aubio_onset_variant_t *variants;
+  uint_t i;
+  variants = AUBIO_ARRAY(aubio_onset_variant_t, o->n_variants + 1);
+  if (!variants) {
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < o->n_variants; i++) {
+    variants[i] = o->variants[i];
+  }
+  if (o->variants) {
+    AUBIO_FREE(o->variants);
+  }
+  o->variants = variants;
+  // start from the state of o, as if it had been running all along
+  variants[i].threshold = threshold;
+  variants[i].minioi = minioi;
+  variants[i].last_onset = o->last_onset;
+  variants[i].peek[0] = variants[i].peek[1] = variants[i].peek[2] = 0.;
+  variants[i].onset = 0.;
+  o->n_variants++;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_get_n_variants (const aubio_onset_t * o)
+{
+  return o->n_variants;
+}
+
+uint_t aubio_onset_get_variant_last (const aubio_onset_t * o, uint_t variant)
+{
+  if (variant >= o->n_variants) {
+    AUBIO_ERR ("onset: variant %d does not exist, %d were added\n", variant,
+        o->n_variants);
+    return 0;
+  }
+  return o->variants[variant].last_onset - o->delay;
+}
+
+void aubio_onset_do_variants (aubio_onset_t * o, const fvec_t * input,
+    fvec_t * onsets)
+{
+  fvec_t onset;
+  uint_t i;
+  if (onsets->length < o->n_variants + 1) {
+    AUBIO_ERR ("onset: output of length %d is too short for %d variants\n",
+        onsets->length, o->n_variants);
+    return;
+  }
+  fvec_view (&onset, onsets, 0, 1);
+  aubio_onset_do (o, input, &onset);
+  for (i = 0; i < o->n_variants; i++) {
+    onsets->data[i + 1] = o->variants[i].onset;
+  }
+}
+
 /* Allocate memory for an onset detection */
 aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
     uint_t buf_size, uint_t hop_size, uint_t samplerate)
@@ -256,6 +891,14 @@ aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
   /* store creation parameters */
   o->samplerate = samplerate;
   o->hop_size = hop_size;
+  o->buf_size = buf_size;
+  o->method = AUBIO_ARRAY(char_t, strnlen(onset_mode, PATH_MAX) + 1);
+  strncpy(o->method, onset_mode, strnlen(onset_mode, PATH_MAX));
+  /* a quarter of the buffer, but not shorter than a hop */
+  o->short_size = buf_size;
+  while (o->short_size > buf_size / 4 && o->short_size / 2 >= hop_size) {
+    o->short_size /= 2;
+  }
 
   /* allocate memory */
   o->pv = new_aubio_pvoc(buf_size, o->hop_size);
@@ -269,6 +912,9 @@ aubio_onset_t * new_aubio_onset (const char_t * onset_mode,
       || !o->desc || !o->spectral_whitening)
     goto beach;
 
+  /* only compute the phase if the onset function needs it */
+  aubio_pvoc_set_magnitude_only (o->pv, !aubio_specdesc_uses_phase (o->od));
+
   /* initialize internal variables */
   aubio_onset_set_default_parameters (o, onset_mode);
 
@@ -281,8 +927,76 @@ beach:
 }
 
 void aubio_onset_reset (aubio_onset_t *o) {
+  uint_t i;
   o->last_onset = 0;
   o->total_frames = 0;
+  o->frames = 0;
+  o->desc_mean = 0.;
+  if (o->desc_history) {
+    aubio_history_reset (o->desc_history);
+    aubio_history_reset (o->thresholded_history);
+  }
+  for (i = 0; i < o->n_variants; i++) {
+    o->variants[i].last_onset = 0;
+    o->variants[i].onset = 0.;
+  }
+  for (i = 0; i < o->n_channels; i++) {
+    aubio_onset_reset (o->channels[i]);
+  }
+}
+
+aubio_onset_t * aubio_onset_clone (const aubio_onset_t *o)
+{
+  // created while o holds the windows and plans, so found in their caches
+  aubio_onset_t *c = new_aubio_onset (o->method, o->buf_size, o->hop_size,
+      o->samplerate);
+  uint_t i;
+  if (!c) {
+    return NULL;
+  }
+  aubio_onset_sync_channel (o, c);
+  c->deferred = o->deferred;
+  // a queue is only fed from a single thread
+  c->events = NULL;
+  if (aubio_onset_set_history (c, aubio_onset_get_history (o)) != AUBIO_OK) {
+    del_aubio_onset (c);
+    return NULL;
+  }
+  for (i = 0; i < o->n_variants; i++) {
+    if (aubio_onset_add_variant (c, o->variants[i].threshold,
+          o->variants[i].minioi) != AUBIO_OK) {
+      del_aubio_onset (c);
+      return NULL;
+    }
+  }
+  return c;
+}
+
+uint_t aubio_onset_reconfigure (aubio_onset_t *o, const char_t * onset_mode,
+    uint_t buf_size, uint_t hop_size)
+{
+  aubio_onset_t *n = new_aubio_onset (onset_mode, buf_size, hop_size,
+      o->samplerate);
+  aubio_onset_t previous;
+  if (!n) {
+    return AUBIO_FAIL;
+  }
+  // move the new objects to o, and delete the previous ones with n
+  previous = *o;
+  *o = *n;
+  *n = previous;
+  // keep the queue and the histories of o
+  o->events = previous.events;
+  o->desc_history = previous.desc_history;
+  o->thresholded_history = previous.thresholded_history;
+  n->desc_history = NULL;
+  n->thresholded_history = NULL;
+  if (o->desc_history) {
+    aubio_history_reset (o->desc_history);
+    aubio_history_reset (o->thresholded_history);
+  }
+  del_aubio_onset (n);
+  return AUBIO_OK;
 }
 
 uint_t aubio_onset_set_default_parameters (aubio_onset_t * o, const char_t * onset_mode)
@@ -328,6 +1042,9 @@ uint_t aubio_onset_set_default_parameters (aubio_onset_t * o, const char_t * ons
     aubio_spectral_whitening_set_relax_time(o->spectral_whitening, 100);
     aubio_spectral_whitening_set_floor(o->spectral_whitening, 1.);
     aubio_onset_set_compression (o, 10.);
+  } else if (strcmp (onset_mode, "superflux") == 0) {
+    // the method takes the log of its bands itself
+    aubio_onset_set_threshold (o, 1.5);
   } else if (strcmp (onset_mode, "specdiff") == 0) {
   } else if (strcmp (onset_mode, "old_default") == 0) {
     // used to reproduce results obtained with the previous version
@@ -344,6 +1061,16 @@ uint_t aubio_onset_set_default_parameters (aubio_onset_t * o, const char_t * ons
 
 void del_aubio_onset (aubio_onset_t *o)
 {
+  uint_t i;
+  for (i = 0; i < o->n_channels; i++) {
+    del_aubio_onset(o->channels[i]);
+  }
+  if (o->channels)
+    AUBIO_FREE(o->channels);
+  if (o->variants)
+    AUBIO_FREE(o->variants);
+  if (o->method)
+    AUBIO_FREE(o->method);
   if (o->spectral_whitening)
     del_aubio_spectral_whitening(o->spectral_whitening);
   if (o->od)
@@ -356,5 +1083,41 @@ void del_aubio_onset (aubio_onset_t *o)
     del_fvec(o->desc);
   if (o->fftgrain)
     del_cvec(o->fftgrain);
+  if (o->short_pv)
+    del_aubio_pvoc(o->short_pv);
+  if (o->short_od)
+    del_aubio_specdesc(o->short_od);
+  if (o->short_grain)
+    del_cvec(o->short_grain);
+  if (o->short_desc)
+    del_fvec(o->short_desc);
+  if (o->desc_history) {
+    del_aubio_history(o->desc_history);
+    del_aubio_history(o->thresholded_history);
+  }
   AUBIO_FREE(o);
 }
+
+uint_t aubio_onset_get_memory_usage (const aubio_onset_t *o)
+{
+  uint_t i, n = aubio_malloc_size(o) + aubio_malloc_size(o->method)
+    + aubio_malloc_size(o->channels) + aubio_malloc_size(o->fftgrain)
+    + aubio_malloc_size(o->desc) + aubio_malloc_size(o->short_grain)
+    + aubio_malloc_size(o->short_desc) + aubio_malloc_size(o->variants);
+  for (i = 0; i < o->n_channels; i++) {
+    n += aubio_onset_get_memory_usage(o->channels[i]);
+  }
+  if (o->pv) n += aubio_pvoc_get_memory_usage(o->pv);
+  if (o->od) n += aubio_specdesc_get_memory_usage(o->od);
+  if (o->pp) n += aubio_peakpicker_get_memory_usage(o->pp);
+  if (o->spectral_whitening) {
+    n += aubio_spectral_whitening_get_memory_usage(o->spectral_whitening);
+  }
+  if (o->short_pv) n += aubio_pvoc_get_memory_usage(o->short_pv);
+  if (o->short_od) n += aubio_specdesc_get_memory_usage(o->short_od);
+  if (o->desc_history) {
+    n += aubio_history_get_memory_usage(o->desc_history)
+      + aubio_history_get_memory_usage(o->thresholded_history);
+  }
+  return n;
+}
@@ -90,6 +90,219 @@ aubio_onset_t * new_aubio_onset (const char_t * method,
 */
 void aubio_onset_do (aubio_onset_t *o, const fvec_t * input, fvec_t * onset);
 
+/** execute onset detection with the level of the input already computed
+
+  Same as aubio_onset_do(), but the silence test reads the level from
+  `stats`, so that the detectors running on the same input can share it.
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio vector of length hop_size
+  \param stats statistics of `input`, as computed by aubio_frame_stats_do(),
+  or NULL to compute the level of `input`
+  \param onset output vector of length 1, see aubio_onset_do()
+
+*/
+void aubio_onset_do_stats (aubio_onset_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * onset);
+
+/** execute onset detection on a precomputed spectrum
+
+  Same as aubio_onset_do(), but the spectrum of the current frame is read
+  from `fftgrain` instead of being computed by the onset object, so that
+  several analysis objects can share a single phase vocoder.
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio vector of length hop_size
+  \param fftgrain spectrum of the current frame, as computed by
+  aubio_pvoc_do() on a phase vocoder of the same buffer and hop sizes, with
+  its default window
+  \param onset output vector of length 1, as in aubio_onset_do()
+
+  The `complex`, `phase` and `wphase` methods read the phase of `fftgrain`,
+  which is not computed when the phase vocoder is in magnitude-only mode.
+
+*/
+void aubio_onset_do_spectrum (aubio_onset_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, fvec_t * onset);
+
+/** execute onset detection on a precomputed spectrum and level
+
+  Combines aubio_onset_do_spectrum() and aubio_onset_do_stats(): both the
+  spectrum and the level of the current frame are computed once for all the
+  detectors reading them.
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio vector of length hop_size
+  \param fftgrain spectrum of the current frame, see
+  aubio_onset_do_spectrum()
+  \param stats statistics of `input`, as computed by aubio_frame_stats_do(),
+  or NULL to compute the level of `input`
+  \param onset output vector of length 1, as in aubio_onset_do()
+
+*/
+void aubio_onset_do_spectrum_stats (aubio_onset_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, const aubio_frame_stats_t * stats,
+    fvec_t * onset);
+
+/** execute onset detection on 16 bit integer samples
+
+  Same as aubio_onset_do(), with the samples scaled by 1 / 32768. They are
+  converted as they are written to the phase vocoder, see
+  aubio_pvoc_do_s16().
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio samples, hop_size of them
+  \param onset output vector of length 1, as in aubio_onset_do()
+
+*/
+void aubio_onset_do_s16 (aubio_onset_t *o, const s16_t * input,
+    fvec_t * onset);
+
+/** pick onsets from a stored onset detection function
+
+  Same as aubio_onset_do(), but the description of the current hop is given
+  instead of being computed from its samples. The spectral analysis is
+  skipped, only the peak picking, the silence test, the minimum inter-onset
+  interval and the delay are applied, so that the onsets of a file can be
+  found again with other parameters for a tiny fraction of the cost of a full
+  analysis.
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param descriptor description of the hop, as returned by
+  aubio_onset_get_descriptor() after aubio_onset_do() on this hop
+  \param db_spl level of the hop, in dB SPL, see aubio_db_spl()
+  \param onset output vector of length 1, as in aubio_onset_do()
+
+  Given the descriptions and the levels of all the hops of a file, from its
+  start, this function finds the onsets aubio_onset_do() would have found
+  with the same parameters. The low latency mode, which reads the
+  description of a second window, is not supported.
+
+  \sa aubio_onset_offline_pick()
+
+*/
+void aubio_onset_do_descriptor (aubio_onset_t *o, smpl_t descriptor,
+    smpl_t db_spl, fvec_t * onset);
+
+/** execute onset detection on several channels
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio frames, one row of length hop_size per channel
+  \param onset output vector of length at least `input->height`
+
+  Each channel is analysed as if it was given to its own onset object: the
+  value written in `onset->data[ch]` is the one aubio_onset_do() would have
+  returned for channel `ch`. Channel 0 is analysed by `o` itself, so that
+  aubio_onset_get_last() and the other getters report on it. The objects of
+  the other channels are created on the first call that needs them, and use
+  the parameters of `o` as set at the time of each call.
+
+*/
+void aubio_onset_do_multi (aubio_onset_t *o, const fmat_t * input,
+    fvec_t * onset);
+
+/** execute onset detection on a block of several hops
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio frames, a multiple of hop_size long
+
+  The block is cut into hops, each one given to aubio_onset_do(). The onsets
+  found are only reported through the queue attached with
+  aubio_onset_set_events(), so that a client can process many hops and read
+  their onsets with a single call each.
+
+*/
+void aubio_onset_do_block (aubio_onset_t *o, const fvec_t * input);
+
+/** attach an event queue
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param events queue receiving an ::aubio_event_onset for each onset
+  found, or NULL to detach it
+
+  \return 0 if successful, non-zero otherwise
+
+  The position of each event is that of aubio_onset_get_last(), counted on
+  64 bits, and its strength the value of the onset descriptor. With
+  aubio_onset_do_multi(), the events of all the channels go to the same
+  queue, each with its channel. See utils/events.h.
+
+*/
+uint_t aubio_onset_set_events (aubio_onset_t *o, aubio_events_t *events);
+
+/** get the attached event queue
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return the queue set with aubio_onset_set_events(), or NULL
+
+*/
+aubio_events_t *aubio_onset_get_events (const aubio_onset_t *o);
+
+/** add a threshold and a minimum inter-onset interval to try on the same
+  description
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param threshold peak picking threshold, as in aubio_onset_set_threshold()
+  \param minioi minimum inter-onset interval, in samples, as in
+  aubio_onset_set_minioi()
+
+  \return 0 if successful, non-zero otherwise
+
+  Each variant picks the peaks of the description computed for `o`, with its
+  own threshold and minimum inter-onset interval, and marks its own onsets.
+  Their outputs are read with aubio_onset_do_variants(). Since the spectral
+  analysis, the smoothing of the description and its median and mean over
+  the window of the peak picker are shared, each variant only costs a few
+  operations per hop, so that several sensitivities can be compared on the
+  same stream for about the cost of one. The other parameters, such as the
+  silence threshold, the delay and the low latency mode, are those of `o`.
+
+  The variants are numbered from 0 in the order they are added, and start
+  with the last onset of `o`.
+
+*/
+uint_t aubio_onset_add_variant (aubio_onset_t * o, smpl_t threshold,
+    uint_t minioi);
+
+/** get the number of variants added with aubio_onset_add_variant()
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return number of variants
+
+*/
+uint_t aubio_onset_get_n_variants (const aubio_onset_t * o);
+
+/** get the time of the latest onset of a variant, in samples
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param variant index of the variant, from 0
+
+  \return time of the latest onset marked by the variant, as
+  aubio_onset_get_last() for `o`, or 0 if the variant does not exist
+
+*/
+uint_t aubio_onset_get_variant_last (const aubio_onset_t * o,
+    uint_t variant);
+
+/** execute onset detection, with the parameters of `o` and its variants
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param input new audio vector of length hop_size
+  \param onsets output vector of length at least 1 + the number of variants
+
+  `onsets->data[0]` is the output of aubio_onset_do() for `o`, and
+  `onsets->data[1 + i]` the output of variant `i`, with the same meaning.
+
+  The variants are also updated by aubio_onset_do() and the other functions
+  analysing a hop, including aubio_onset_do_descriptor(), whose callers can
+  follow the onsets of each variant with aubio_onset_get_variant_last().
+
+*/
+void aubio_onset_do_variants (aubio_onset_t * o, const fvec_t * input,
+    fvec_t * onsets);
+
 /** get the time of the latest onset detected, in samples
 
   \param o onset detection object as returned by new_aubio_onset()
@@ -172,6 +385,62 @@ uint_t aubio_onset_set_silence(aubio_onset_t * o, smpl_t silence);
 */
 smpl_t aubio_onset_get_silence(const aubio_onset_t * o);
 
+/** enable or disable silence gating
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param gating 1 to enable, 0 to disable [0]
+
+  \return 0 if successful, non-zero otherwise
+
+  When enabled, the level of each hop is checked first. Hops under the
+  silence threshold, where no onset can be marked, are stored without
+  computing their spectrum and their description, which is taken as 0. This
+  saves most of the cost of aubio_onset_do() between songs. The description
+  of the first hop after a silence may differ, since the spectra of the
+  silent hops were not seen by the spectral descriptor.
+
+*/
+uint_t aubio_onset_set_gating(aubio_onset_t * o, uint_t gating);
+
+/** get silence gating mode
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return 1 if silence gating is enabled, 0 otherwise
+
+*/
+uint_t aubio_onset_get_gating(const aubio_onset_t * o);
+
+/** enable or disable deferred parameter updates
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param deferred 1 to enable, 0 to disable [0]
+
+  \return 0 if successful, non-zero otherwise
+
+  When enabled, aubio_onset_set_threshold(), aubio_onset_set_silence(),
+  aubio_onset_set_minioi(), aubio_onset_set_delay(),
+  aubio_onset_set_compression() and their variants in seconds and
+  milliseconds can be called from any thread while another one runs
+  aubio_onset_do(). The new values are posted without locking, and applied
+  at the start of the next hop; until then, the getters return the previous
+  ones. The getters and the other setters are still meant for the thread
+  processing the object.
+
+  This mode should be set before the object is shared with another thread.
+
+*/
+uint_t aubio_onset_set_deferred(aubio_onset_t * o, uint_t deferred);
+
+/** get deferred parameter updates mode
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return 1 if parameter updates are deferred, 0 otherwise
+
+*/
+uint_t aubio_onset_get_deferred(const aubio_onset_t * o);
+
 /** get onset detection function
 
   \param o onset detection object as returned by new_aubio_onset()
@@ -188,6 +457,55 @@ smpl_t aubio_onset_get_descriptor (const aubio_onset_t *o);
 */
 smpl_t aubio_onset_get_thresholded_descriptor (const aubio_onset_t *o);
 
+/** keep the last values of the onset detection function
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param length number of hops to keep, or 0 to stop keeping them
+
+  \return 0 if successful, non-zero otherwise
+
+  Once set, the descriptor and the thresholded descriptor of each hop are
+  pushed to two histories of `length` values, read with
+  aubio_onset_get_descriptor_history() and
+  aubio_onset_get_thresholded_history(). Hops skipped as silent push zeros.
+  With aubio_onset_do_multi(), only the first channel is kept. See
+  utils/history.h.
+
+*/
+uint_t aubio_onset_set_history (aubio_onset_t *o, uint_t length);
+
+/** get the number of hops kept by the histories
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return length given to aubio_onset_set_history(), or 0 if none are kept
+
+*/
+uint_t aubio_onset_get_history (const aubio_onset_t *o);
+
+/** get the last values of the onset detection function
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return view of the values of aubio_onset_get_descriptor() over the last
+  hops, oldest first, or NULL if aubio_onset_set_history() was not called.
+  The view is not a copy: it belongs to `o`, and should be read again after
+  each hop.
+
+*/
+const fvec_t *aubio_onset_get_descriptor_history (const aubio_onset_t *o);
+
+/** get the last values of the thresholded onset detection function
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return view of the values of aubio_onset_get_thresholded_descriptor()
+  over the last hops, oldest first, or NULL if no history is kept, valid
+  until the next hop
+
+*/
+const fvec_t *aubio_onset_get_thresholded_history (const aubio_onset_t *o);
+
 /** set onset detection peak picking threshold
 
   \param o onset detection object as returned by new_aubio_onset()
@@ -250,6 +568,66 @@ uint_t aubio_onset_set_delay_s(aubio_onset_t * o, smpl_t delay);
 */
 uint_t aubio_onset_set_delay_ms(aubio_onset_t * o, smpl_t delay);
 
+/** get the latency of the onset detection, in samples
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \return time between an onset at the centre of the analysis window and the
+  end of the block where it is detected, in samples
+
+  The latency is the sum of half the buffer size, and of `win_pre + 1` hops
+  of the peak picker: the peak of the detection function is confirmed only
+  once the following values are known. It does not include the delay set with
+  aubio_onset_set_delay(), which is taken back from the onset times returned
+  by aubio_onset_get_last().
+
+*/
+uint_t aubio_onset_get_latency(const aubio_onset_t * o);
+
+/** set the maximum latency of the onset detection, in samples
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param latency target latency, at least half the buffer size plus one hop
+  \return 0 if successful, non-zero otherwise
+
+  The peak picker looks ahead of each value by as many hops as fit in the
+  target. A shorter look ahead reports onsets earlier, but can also pick a
+  value before it has reached its peak. The delay is moved by the change of
+  latency, so that the times returned by aubio_onset_get_last() stay aligned.
+
+*/
+uint_t aubio_onset_set_latency(aubio_onset_t * o, uint_t latency);
+
+/** enable or disable low latency onset detection
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param lowlatency 1 to enable, 0 to disable [0]
+  \return 0 if successful, non-zero otherwise
+
+  In low latency mode, the peaks are picked in the description of a short
+  window, a quarter of the buffer size but not shorter than a hop, with a
+  causal running median and without smoothing, and confirmed by the next
+  value only. A peak is kept when the description of the full buffer also
+  stands above its running mean, so that the long window still rejects the
+  peaks of the short one that do not stand out of the spectrum. With a
+  buffer of 512 and a hop of 128 samples, the latency drops from 512 to 192
+  samples, 4 ms at 48 kHz.
+
+  The adaptive whitening is not applied to the short window. The window of
+  the peak picker is cleared, and set back to its default when disabling the
+  mode. The delay is moved by the change of latency, see
+  aubio_onset_set_latency().
+
+*/
+uint_t aubio_onset_set_lowlatency(aubio_onset_t * o, uint_t lowlatency);
+
+/** get low latency onset detection mode
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \return 1 if enabled, 0 otherwise
+
+*/
+uint_t aubio_onset_get_lowlatency(const aubio_onset_t * o);
+
 /** get minimum inter onset interval in samples
 
   \param o onset detection object as returned by new_aubio_onset()
@@ -333,6 +711,59 @@ uint_t aubio_onset_set_default_parameters (aubio_onset_t * o, const char_t * ons
  */
 void aubio_onset_reset(aubio_onset_t * o);
 
+/** create a copy of an onset detection object
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return new onset detection object, with the method, sizes,
+  parameters and variants of `o`, or NULL on failure
+
+  The copy starts from the state of a newly created object, without the
+  samples, spectra and peak picker history of `o`, which
+  aubio_onset_reset() keeps. Its windows and FFT plans are those of `o`, taken
+  from the caches shared by all objects, so that creating it does not
+  compute them again.
+
+*/
+aubio_onset_t * aubio_onset_clone (const aubio_onset_t * o);
+
+/** change the method and sizes of an onset detection object
+
+  \param o onset detection object as returned by new_aubio_onset()
+  \param onset_mode new detection method
+  \param buf_size new buffer size for phase vocoder
+  \param hop_size new hop size for phase vocoder
+
+  \return 0 if successful, non-zero otherwise, in which case `o` is left
+  unchanged
+
+  After this call, `o` is the object new_aubio_onset() would have created
+  with these arguments and the samplerate of `o`, including its default
+  parameters, without the variants of aubio_onset_add_variant(). The new
+  objects are created before the previous ones are deleted, so that the
+  windows and FFT plans of the sizes still used are taken from their caches
+  rather than computed again. The objects of the channels of
+  aubio_onset_do_multi() are deleted, and created again on its next call.
+  The queue of aubio_onset_set_events() is kept, and so are the histories
+  of aubio_onset_set_history(), cleared.
+
+*/
+uint_t aubio_onset_reconfigure (aubio_onset_t * o, const char_t * onset_mode,
+    uint_t buf_size, uint_t hop_size);
+
+/** get the memory used by an onset detection object
+
+  \param o onset detection object as returned by new_aubio_onset()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  The objects analysing the channels of aubio_onset_do_multi() are included,
+  the windows and the tables shared with other objects are not.
+
+*/
+uint_t aubio_onset_get_memory_usage (const aubio_onset_t * o);
+
 /** delete onset detection object
 
   \param o onset detection object to delete
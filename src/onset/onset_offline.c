@@ -0,0 +1,358 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "utils/events.h"
+#include "onset/onset.h"
+#include "onset/onset_offline.h"
+#include "musicutils.h"
+#include "utils/offline_priv.h"
+#include "io/iothread_priv.h"
+
+/** default length of the chunks, in seconds */
+#define AUBIO_ONSET_OFFLINE_CHUNK_S 30.
+
+/** hops analysed before the start of a chunk, on top of the window, the
+  delay and the minimum inter-onset interval; more than the 1 + 5 + 1 hops
+  seen by the peak picker, and enough for the running mean of the low
+  latency mode to settle */
+#define AUBIO_ONSET_OFFLINE_CONTEXT 32
+
+struct _aubio_onset_offline_t {
+  char_t *method;
+  uint_t buf_size;
+  uint_t hop_size;
+  uint_t samplerate;
+  uint_t threads;
+  smpl_t chunk_s;
+  smpl_t threshold;             /**< only set if has_threshold */
+  uint_t has_threshold;
+  smpl_t silence;               /**< only set if has_silence */
+  uint_t has_silence;
+  smpl_t minioi;                /**< only set if has_minioi, in seconds */
+  uint_t has_minioi;
+
+  smpl_t *onsets;               /**< results of the last run, in seconds */
+  uint_t size;                  /**< number of onsets allocated */
+  fvec_t view;                  /**< onsets, as returned by get_onsets */
+  uint_t run_samplerate;        /**< samplerate the file is read at */
+
+  smpl_t *desc[2];              /**< description and level of each hop */
+  uint_t n_hops;                /**< number of hops of the last run */
+  uint_t hops_size;             /**< number of hops allocated */
+  fmat_t desc_view;             /**< desc, as returned by get_descriptor */
+};
+
+/** values of each row of the chunks: position of the hop, its description,
+  its level, and the position of the onset it reported, or -1 */
+#define AUBIO_ONSET_OFFLINE_WIDTH 4
+
+aubio_onset_offline_t *new_aubio_onset_offline (const char_t *method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate)
+{
+  aubio_onset_offline_t *o = AUBIO_NEW(aubio_onset_offline_t);
+  if (!o) return NULL;
+  if ((sint_t)hop_size < 1 || (sint_t)buf_size < (sint_t)hop_size) {
+    AUBIO_ERR("onset_offline: got buf_size %d and hop_size %d, expected"
+        " buf_size >= hop_size > 0\n", buf_size, hop_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 0) {
+    AUBIO_ERR("onset_offline: got samplerate %d, expected >= 0\n",
+        samplerate);
+    goto beach;
+  }
+  if (!method) method = "default";
+  o->method = AUBIO_ARRAY(char_t, strnlen(method, PATH_MAX) + 1);
+  if (!o->method) goto beach;
+  strncpy(o->method, method, strnlen(method, PATH_MAX) + 1);
+  o->buf_size = buf_size;
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+  o->threads = aubio_threads_get_pool_size();
+  o->chunk_s = AUBIO_ONSET_OFFLINE_CHUNK_S;
+  return o;
+
+beach:
+  del_aubio_onset_offline(o);
+  return NULL;
+}
+
+uint_t aubio_onset_offline_set_threads (aubio_onset_offline_t *o,
+    uint_t threads)
+{
+  o->threads = threads ? threads : aubio_threads_get_pool_size();
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_offline_get_threads (const aubio_onset_offline_t *o)
+{
+  return o->threads;
+}
+
+uint_t aubio_onset_offline_set_chunk_s (aubio_onset_offline_t *o,
+    smpl_t chunk)
+{
+  if (!(chunk > 0.)) {
+    AUBIO_ERR("onset_offline: chunks of %.3fs should be longer than 0s\n",
+        chunk);
+    return AUBIO_FAIL;
+  }
+  o->chunk_s = chunk;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_onset_offline_get_chunk_s (const aubio_onset_offline_t *o)
+{
+  return o->chunk_s;
+}
+
+uint_t aubio_onset_offline_set_threshold (aubio_onset_offline_t *o,
+    smpl_t threshold)
+{
+  o->threshold = threshold;
+  o->has_threshold = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_offline_set_silence (aubio_onset_offline_t *o,
+    smpl_t silence)
+{
+  o->silence = silence;
+  o->has_silence = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_offline_set_minioi_s (aubio_onset_offline_t *o,
+    smpl_t minioi)
+{
+  if (!(minioi >= 0.)) {
+    AUBIO_ERR("onset_offline: minioi %.3fs should be >= 0\n", minioi);
+    return AUBIO_FAIL;
+  }
+  o->minioi = minioi;
+  o->has_minioi = 1;
+  return AUBIO_OK;
+}
+
+/* onset object with the parameters of o */
+static aubio_onset_t *aubio_onset_offline_new_onset (
+    const aubio_onset_offline_t *o, uint_t samplerate)
+{
+  aubio_onset_t *onset = new_aubio_onset(o->method, o->buf_size, o->hop_size,
+      samplerate);
+  if (!onset) return NULL;
+  if (o->has_threshold) aubio_onset_set_threshold(onset, o->threshold);
+  if (o->has_silence) aubio_onset_set_silence(onset, o->silence);
+  if (o->has_minioi) aubio_onset_set_minioi_s(onset, o->minioi);
+  return onset;
+}
+
+/* analyse a chunk of the file, from a little before its start to a little
+   after its end, and keep the hops and the onsets placed inside it */
+static uint_t aubio_onset_offline_analyse (void *data, aubio_source_t *source,
+    fvec_t *in, aubio_offline_chunk_t *c)
+{
+  aubio_onset_offline_t *o = (aubio_onset_offline_t *)data;
+  aubio_onset_t *onset = aubio_onset_offline_new_onset(o, o->run_samplerate);
+  fvec_t *out = new_fvec(1);
+  uint_t read = 0, onset_pos, inside, err = AUBIO_FAIL;
+  aubio_frame_stats_t stats;
+  lsmp_t *row;
+  if (!onset || !out) goto beach;
+  do {
+    aubio_source_do(source, in, &read);
+    aubio_frame_stats_do(in, aubio_onset_get_silence(onset), &stats);
+    aubio_onset_do_stats(onset, in, &stats, out);
+    onset_pos = c->pos + aubio_onset_get_last(onset);
+    inside = out->data[0] != 0 && onset_pos >= c->start && onset_pos < c->end;
+    if (inside || (c->total >= c->start && c->total < c->end)) {
+      if (!(row = aubio_offline_chunk_add(c))) goto beach;
+      row[0] = c->total;
+      row[1] = aubio_onset_get_descriptor(onset);
+      row[2] = stats.db_spl;
+      row[3] = inside ? (lsmp_t)onset_pos : -1.;
+    }
+    c->total += read;
+  } while (read == o->hop_size && c->total < c->stop);
+  err = AUBIO_OK;
+
+beach:
+  if (onset) del_aubio_onset(onset);
+  if (out) del_fvec(out);
+  return err;
+}
+
+/* make sure o->onsets holds at least n onsets */
+static uint_t aubio_onset_offline_alloc_onsets (aubio_onset_offline_t *o,
+    uint_t n)
+{
+  if (n > o->size) {
+    smpl_t *onsets = (smpl_t *)AUBIO_REALLOC(o->onsets, n * sizeof(smpl_t));
+    if (!onsets) return AUBIO_FAIL;
+    o->onsets = onsets;
+    o->size = n;
+  }
+  return AUBIO_OK;
+}
+
+/* make sure o->desc holds at least n hops */
+static uint_t aubio_onset_offline_alloc_hops (aubio_onset_offline_t *o,
+    uint_t n)
+{
+  uint_t j;
+  if (n > o->hops_size) {
+    for (j = 0; j < 2; j++) {
+      smpl_t *desc = (smpl_t *)AUBIO_REALLOC(o->desc[j], n * sizeof(smpl_t));
+      if (!desc) return AUBIO_FAIL;
+      o->desc[j] = desc;
+    }
+    o->hops_size = n;
+  }
+  return AUBIO_OK;
+}
+
+/* join the hops and the onsets of the chunks, dropping the onsets too close
+   to the previous one at the boundaries, as a single pass would */
+static uint_t aubio_onset_offline_join (aubio_onset_offline_t *o,
+    const aubio_offline_t *offline, uint_t minioi)
+{
+  const aubio_offline_chunk_t *c;
+  const lsmp_t *row;
+  uint_t k, i, n = 0, n_hops = 0;
+  uint_t n_chunks = aubio_offline_get_n_chunks(offline);
+  lsmp_t last = 0;
+  for (k = 0; k < n_chunks; k++) {
+    n += aubio_offline_get_chunk(offline, k)->n_rows;
+  }
+  if (aubio_onset_offline_alloc_onsets(o, n)
+      || aubio_onset_offline_alloc_hops(o, n)) return AUBIO_FAIL;
+  n = 0;
+  for (k = 0; k < n_chunks; k++) {
+    c = aubio_offline_get_chunk(offline, k);
+    for (i = 0; i < c->n_rows; i++) {
+      row = c->rows + i * AUBIO_ONSET_OFFLINE_WIDTH;
+      if (row[0] >= c->start && row[0] < c->end) {
+        o->desc[0][n_hops] = row[1];
+        o->desc[1][n_hops] = row[2];
+        n_hops++;
+      }
+      if (row[3] < 0 || (n > 0 && last + minioi >= row[3])) continue;
+      last = row[3];
+      o->onsets[n++] = last / o->run_samplerate;
+    }
+  }
+  o->view.data = o->onsets;
+  o->view.length = n;
+  o->n_hops = n_hops;
+  o->desc_view.height = n_hops > 0 ? 2 : 0;
+  o->desc_view.length = n_hops;
+  o->desc_view.data = o->desc;
+  return AUBIO_OK;
+}
+
+uint_t aubio_onset_offline_do (aubio_onset_offline_t *o, const char_t *uri)
+{
+  aubio_offline_t *offline;
+  aubio_onset_t *onset = NULL;
+  uint_t warmup, tail, minioi, err = AUBIO_FAIL;
+  o->view.length = 0;
+  o->n_hops = 0;
+  o->desc_view.height = 0;
+  o->desc_view.length = 0;
+  offline = new_aubio_offline("onset_offline", uri, o->samplerate,
+      o->hop_size, AUBIO_ONSET_OFFLINE_WIDTH);
+  if (!offline) return AUBIO_FAIL;
+  o->run_samplerate = aubio_offline_get_samplerate(offline);
+  onset = aubio_onset_offline_new_onset(o, o->run_samplerate);
+  if (!onset) goto beach;
+  minioi = aubio_onset_get_minioi(onset);
+  warmup = o->buf_size + aubio_onset_get_delay(onset) + minioi
+    + AUBIO_ONSET_OFFLINE_CONTEXT * o->hop_size;
+  // onsets are reported up to delay samples after their position
+  tail = aubio_onset_get_delay(onset) + 2 * o->hop_size;
+  del_aubio_onset(onset);
+  if (aubio_offline_run(offline, o->chunk_s, o->threads, warmup, tail,
+        aubio_onset_offline_analyse, o)) goto beach;
+  err = aubio_onset_offline_join(o, offline, minioi);
+
+beach:
+  del_aubio_offline(offline);
+  return err;
+}
+
+const fvec_t *aubio_onset_offline_get_onsets (const aubio_onset_offline_t *o)
+{
+  return &o->view;
+}
+
+const fmat_t *aubio_onset_offline_get_descriptor (
+    const aubio_onset_offline_t *o)
+{
+  return &o->desc_view;
+}
+
+uint_t aubio_onset_offline_pick (aubio_onset_offline_t *o)
+{
+  aubio_onset_t *onset;
+  fvec_t *out;
+  uint_t j, n = 0, err = AUBIO_FAIL;
+  if (o->n_hops == 0) {
+    o->view.length = 0;
+    return AUBIO_OK;
+  }
+  if (aubio_onset_offline_alloc_onsets(o, o->n_hops)) return AUBIO_FAIL;
+  onset = aubio_onset_offline_new_onset(o, o->run_samplerate);
+  out = new_fvec(1);
+  if (!onset || !out) goto beach;
+  for (j = 0; j < o->n_hops; j++) {
+    aubio_onset_do_descriptor(onset, o->desc[0][j], o->desc[1][j], out);
+    if (out->data[0] != 0) {
+      o->onsets[n++] = aubio_onset_get_last(onset)
+        / (lsmp_t)o->run_samplerate;
+    }
+  }
+  o->view.data = o->onsets;
+  o->view.length = n;
+  err = AUBIO_OK;
+
+beach:
+  if (onset) del_aubio_onset(onset);
+  if (out) del_fvec(out);
+  return err;
+}
+
+void del_aubio_onset_offline (aubio_onset_offline_t *o)
+{
+  AUBIO_ASSERT(o);
+  if (o->method)
+    AUBIO_FREE(o->method);
+  if (o->onsets)
+    AUBIO_FREE(o->onsets);
+  if (o->desc[0])
+    AUBIO_FREE(o->desc[0]);
+  if (o->desc[1])
+    AUBIO_FREE(o->desc[1]);
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,217 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_ONSET_OFFLINE_H
+#define AUBIO_ONSET_OFFLINE_H
+
+/** \file
+
+  Onset detection of a whole file on a pool of threads
+
+  This object detects the onsets of a single file, as a loop over
+  ::aubio_onset_do would, but splits the file into chunks analysed in
+  parallel, one ::aubio_onset_t per chunk.
+
+  Onset detection only depends on the recent past of the signal. Each chunk
+  is analysed from a little before its start, long enough for the phase
+  vocoder, the peak picker, the minimum inter-onset interval and the delay
+  to reach the state they would have in a single pass, and a little after
+  its end, until the onsets placed before the end were reported. The onsets
+  of each chunk are then kept between its start and its end, and the lists
+  are joined in order.
+
+  The chunks do not depend on the number of threads, so that the onsets
+  found are the same whatever the number of threads. They match those of a
+  single pass for the methods without adaptive whitening, and are very close
+  for the others (`complex`, `mkl`, `kl` and `specflux`), since the whitening
+  keeps a slowly decaying memory of the past spectra.
+
+  The description of each hop is also stored, so that the onsets can be
+  picked again with other parameters by ::aubio_onset_offline_pick, without
+  analysing the file again.
+
+  \example onset/test-onset_offline.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** offline onset detection object */
+typedef struct _aubio_onset_offline_t aubio_onset_offline_t;
+
+/** create offline onset detection object
+
+  \param method onset detection method, see ::new_aubio_onset
+  \param buf_size buffer size of the analysis
+  \param hop_size hop size of the analysis
+  \param samplerate samplerate to read the files at, or 0 to read each file
+  at its own samplerate
+
+  \return newly created ::aubio_onset_offline_t, or NULL on failure
+
+*/
+aubio_onset_offline_t *new_aubio_onset_offline (const char_t *method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate);
+
+/** set number of threads
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+  \param threads number of threads, or 0 for aubio_threads_get_pool_size()
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_onset_offline_set_threads (aubio_onset_offline_t *o,
+    uint_t threads);
+
+/** get number of threads
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+
+  \return number of threads used by ::aubio_onset_offline_do
+
+*/
+uint_t aubio_onset_offline_get_threads (const aubio_onset_offline_t *o);
+
+/** set length of the chunks
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+  \param chunk length of each chunk, in seconds, 30 by default
+
+  \return 0 if successful, non-zero otherwise
+
+  Shorter chunks spread the work more evenly over the threads, but each
+  chunk is analysed from a little before its start.
+
+*/
+uint_t aubio_onset_offline_set_chunk_s (aubio_onset_offline_t *o,
+    smpl_t chunk);
+
+/** get length of the chunks
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+
+  \return length of each chunk, in seconds
+
+*/
+smpl_t aubio_onset_offline_get_chunk_s (const aubio_onset_offline_t *o);
+
+/** set peak-picking threshold, see ::aubio_onset_set_threshold
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+  \param threshold threshold of the peak picker
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_onset_offline_set_threshold (aubio_onset_offline_t *o,
+    smpl_t threshold);
+
+/** set silence threshold, see ::aubio_onset_set_silence
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+  \param silence silence threshold, in dB
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_onset_offline_set_silence (aubio_onset_offline_t *o,
+    smpl_t silence);
+
+/** set minimum inter-onset interval, see ::aubio_onset_set_minioi_s
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+  \param minioi minimum interval between two onsets, in seconds
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_onset_offline_set_minioi_s (aubio_onset_offline_t *o,
+    smpl_t minioi);
+
+/** detect the onsets of a file
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+  \param uri path of the file to analyse
+
+  \return 0 if successful, non-zero otherwise
+
+  This function returns once the whole file was analysed. The onsets are
+  then available from ::aubio_onset_offline_get_onsets.
+
+*/
+uint_t aubio_onset_offline_do (aubio_onset_offline_t *o, const char_t *uri);
+
+/** get the onsets found by the last call to ::aubio_onset_offline_do
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+
+  \return vector of the onset times, in seconds, in increasing order; its
+  length is the number of onsets, and may be 0. The vector belongs to `o`
+  and is valid until the next call to ::aubio_onset_offline_do.
+
+*/
+const fvec_t *aubio_onset_offline_get_onsets (const aubio_onset_offline_t *o);
+
+/** get the onset detection function of the last call to
+  ::aubio_onset_offline_do
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+
+  \return matrix of 2 rows and one column per hop of the file: the first row
+  holds the description of each hop, as returned by
+  ::aubio_onset_get_descriptor, the second one its level in dB SPL. Its
+  height is 0 if no file was analysed. The matrix belongs to `o` and is valid
+  until the next call to ::aubio_onset_offline_do.
+
+*/
+const fmat_t *aubio_onset_offline_get_descriptor (
+    const aubio_onset_offline_t *o);
+
+/** pick the onsets again from the stored onset detection function
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+
+  \return 0 if successful, non-zero otherwise
+
+  This function finds the onsets of the file analysed by the last call to
+  ::aubio_onset_offline_do, with the current threshold, silence and minimum
+  inter-onset interval, from the description stored for each hop, see
+  ::aubio_onset_do_descriptor. It takes a few milliseconds for a song, so
+  that the parameters can be tuned without analysing the file again. The
+  onsets are then available from ::aubio_onset_offline_get_onsets.
+
+*/
+uint_t aubio_onset_offline_pick (aubio_onset_offline_t *o);
+
+/** delete offline onset detection object
+
+  \param o offline onset object, created by ::new_aubio_onset_offline
+
+*/
+void del_aubio_onset_offline (aubio_onset_offline_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_ONSET_OFFLINE_H */
@@ -20,11 +20,17 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
 #include "mathutils.h"
 #include "lvec.h"
 #include "temporal/filter.h"
 #include "temporal/biquad.h"
 #include "onset/peakpicker.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "mathutils_priv.h"
+#include "utils/workspace_priv.h"
 
 /** function pointer to thresholding function */
 typedef smpl_t (*aubio_thresholdfn_t)(fvec_t *input);
@@ -67,6 +73,27 @@ struct _aubio_peakpicker_t
   fvec_t *thresholded;
         /** scratch pad for biquad and median */
   fvec_t *scratch;
+        /** mean of the window at the last call, scaled by the threshold */
+  smpl_t mean;
+
+        /** incremental mode: causal smoothing, running mean and median */
+  uint_t incremental;
+        /** smoothed onsets, oldest at ring_pos [win_pre + win_post + 1] */
+  smpl_t *ring;
+        /** next position to overwrite in ring */
+  uint_t ring_pos;
+        /** positions in ring, max-heap of the lower half then min-heap */
+  uint_t *heap;
+        /** index in heap of each position of ring */
+  uint_t *where;
+        /** running median of ring */
+  aubio_median_heap_t median;
+        /** sum of the elements of ring */
+  double sum;
+        /** single sample buffer for the causal filter */
+  fvec_t *sample;
+        /** smooth the input of the incremental mode [1] */
+  uint_t smoothing;
 
         /** \bug should be used to calculate filter coefficients */
   /* cutoff: low-pass filter cutoff [0.34, 1] */
@@ -80,6 +107,9 @@ struct _aubio_peakpicker_t
 };
 
 
+static void aubio_peakpicker_do_incremental (aubio_peakpicker_t * p,
+    smpl_t input);
+
 /** modified version for real time, moving mean adaptive threshold this method
  * is slightly more permissive than the offline one, and yelds to an increase
  * of false positives. best  */
@@ -93,33 +123,170 @@ aubio_peakpicker_do (aubio_peakpicker_t * p, fvec_t * onset, fvec_t * out)
   fvec_t *scratch = p->scratch;
   smpl_t mean = 0., median = 0.;
   uint_t j = 0;
+  AUBIO_STATS_BEGIN ("peakpicker");
 
-  /* push new novelty to the end */
-  fvec_push(onset_keep, onset->data[0]);
-  /* store a copy */
-  fvec_copy(onset_keep, onset_proc);
+  if (p->incremental) {
+    aubio_peakpicker_do_incremental (p, onset->data[0]);
+  } else {
+    /* push new novelty to the end */
+    fvec_push(onset_keep, onset->data[0]);
+    /* store a copy */
+    fvec_copy(onset_keep, onset_proc);
 
-  /* filter this copy */
-  aubio_filter_do_filtfilt (p->biquad, onset_proc, scratch);
+    /* filter this copy */
+    aubio_filter_do_filtfilt (p->biquad, onset_proc, scratch);
 
-  /* calculate mean and median for onset_proc */
-  mean = fvec_mean (onset_proc);
+    /* calculate mean and median for onset_proc */
+    mean = fvec_mean (onset_proc);
 
-  /* copy to scratch and compute its median */
-  fvec_copy(onset_proc, scratch);
-  median = p->thresholdfn (scratch);
+    /* copy to scratch and compute its median */
+    fvec_copy(onset_proc, scratch);
+    median = p->thresholdfn (scratch);
+
+    /* calculate new tresholded value */
+    thresholded->data[0] =
+        onset_proc->data[p->win_post] - median - mean * p->threshold;
+    p->mean = mean;
+  }
 
   /* shift peek array */
   for (j = 0; j < 3 - 1; j++)
     onset_peek->data[j] = onset_peek->data[j + 1];
-  /* calculate new tresholded value */
-  thresholded->data[0] =
-      onset_proc->data[p->win_post] - median - mean * p->threshold;
   onset_peek->data[2] = thresholded->data[0];
   out->data[0] = (p->pickerfn) (onset_peek, 1);
   if (out->data[0]) {
     out->data[0] = fvec_quadratic_peak_pos (onset_peek, 1);
   }
+  AUBIO_STATS_END ();
+}
+
+/* smooth the new input with the causal filter, replace the oldest element
+ * of the window with it, and update the running sum and median */
+static void
+aubio_peakpicker_do_incremental (aubio_peakpicker_t * p, smpl_t input)
+{
+  uint_t length = p->onset_keep->length;
+  uint_t slot = p->ring_pos, j;
+  smpl_t value, median, mean;
+
+  p->sample->data[0] = input;
+  if (p->smoothing) aubio_filter_do (p->biquad, p->sample);
+  value = p->sample->data[0];
+
+  p->sum += value - p->ring[slot];
+  median = aubio_median_heap_set (&p->median, slot, value);
+  p->ring_pos = (slot + 1 == length) ? 0 : slot + 1;
+  /* recompute the sum once per turn, to avoid accumulating errors */
+  if (p->ring_pos == 0) {
+    p->sum = 0.;
+    for (j = 0; j < length; j++) p->sum += p->ring[j];
+  }
+
+  mean = p->sum / length;
+  p->mean = mean;
+  p->thresholded->data[0] =
+      p->ring[(p->ring_pos + p->win_post) % length] - median
+      - mean * p->threshold;
+}
+
+/* reset the window and the state of the incremental mode */
+static void
+aubio_peakpicker_reset (aubio_peakpicker_t * p)
+{
+  uint_t length = p->onset_keep->length;
+  fvec_zeros (p->onset_keep);
+  fvec_zeros (p->onset_peek);
+  fvec_zeros (p->thresholded);
+  aubio_filter_do_reset (p->biquad);
+  aubio_median_heap_init (&p->median, p->ring, p->heap, p->where, length);
+  p->ring_pos = 0;
+  p->sum = 0.;
+  p->mean = 0.;
+}
+
+/* (re)allocate the buffers for the current window lengths */
+static uint_t
+aubio_peakpicker_alloc (aubio_peakpicker_t * p)
+{
+  uint_t length = p->win_post + p->win_pre + 1;
+  size_t offset = 0;
+  if (p->scratch) del_fvec (p->scratch);
+  if (p->onset_keep) del_fvec (p->onset_keep);
+  if (p->onset_proc) del_fvec (p->onset_proc);
+  if (p->ring) AUBIO_FREE (p->ring);
+  if (p->heap) AUBIO_FREE (p->heap);
+  if (p->where) AUBIO_FREE (p->where);
+  p->scratch = new_aubio_scratch (length, &offset);
+  p->onset_keep = new_fvec (length);
+  p->onset_proc = new_fvec (length);
+  p->ring = AUBIO_ARRAY (smpl_t, length);
+  p->heap = AUBIO_ARRAY (uint_t, length);
+  p->where = AUBIO_ARRAY (uint_t, length);
+  if (!p->scratch || !p->onset_keep || !p->onset_proc || !p->ring
+      || !p->heap || !p->where) {
+    return AUBIO_FAIL;
+  }
+  aubio_peakpicker_reset (p);
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_peakpicker_set_window (aubio_peakpicker_t * p, uint_t win_pre,
+    uint_t win_post)
+{
+  if ((sint_t)win_pre < 0 || (sint_t)win_post < 0) {
+    AUBIO_ERR ("peakpicker: can not set window lengths %d and %d\n",
+        win_pre, win_post);
+    return AUBIO_FAIL;
+  }
+  p->win_pre = win_pre;
+  p->win_post = win_post;
+  return aubio_peakpicker_alloc (p);
+}
+
+uint_t
+aubio_peakpicker_get_win_pre (const aubio_peakpicker_t * p)
+{
+  return p->win_pre;
+}
+
+uint_t
+aubio_peakpicker_get_win_post (const aubio_peakpicker_t * p)
+{
+  return p->win_post;
+}
+
+uint_t
+aubio_peakpicker_get_latency (const aubio_peakpicker_t * p)
+{
+  return p->win_pre + 1;
+}
+
+uint_t
+aubio_peakpicker_set_incremental (aubio_peakpicker_t * p, uint_t incremental)
+{
+  p->incremental = incremental ? 1 : 0;
+  aubio_peakpicker_reset (p);
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_peakpicker_get_incremental (const aubio_peakpicker_t * p)
+{
+  return p->incremental;
+}
+
+uint_t
+aubio_peakpicker_set_smoothing (aubio_peakpicker_t * p, uint_t smoothing)
+{
+  p->smoothing = smoothing ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_peakpicker_get_smoothing (const aubio_peakpicker_t * p)
+{
+  return p->smoothing;
 }
 
 /** this method returns the current value in the pick peaking buffer
@@ -144,6 +311,12 @@ aubio_peakpicker_get_threshold (aubio_peakpicker_t * p)
   return p->threshold;
 }
 
+smpl_t
+aubio_peakpicker_get_mean (const aubio_peakpicker_t * p)
+{
+  return p->mean;
+}
+
 uint_t
 aubio_peakpicker_set_thresholdfn (aubio_peakpicker_t * p,
     aubio_thresholdfn_t thresholdfn)
@@ -170,15 +343,14 @@ new_aubio_peakpicker (void)
   t->threshold = 0.1;           /* 0.0668; 0.33; 0.082; 0.033; */
   t->win_post = 5;
   t->win_pre = 1;
+  t->smoothing = 1;
 
   t->thresholdfn = (aubio_thresholdfn_t) (fvec_median); /* (fvec_mean); */
   t->pickerfn = (aubio_pickerfn_t) (fvec_peakpick);
 
-  t->scratch = new_fvec (t->win_post + t->win_pre + 1);
-  t->onset_keep = new_fvec (t->win_post + t->win_pre + 1);
-  t->onset_proc = new_fvec (t->win_post + t->win_pre + 1);
   t->onset_peek = new_fvec (3);
   t->thresholded = new_fvec (1);
+  t->sample = new_fvec (1);
 
   /* cutoff: low-pass filter with cutoff reduced frequency at 0.34
      generated with octave butter function: [b,a] = butter(2, 0.34);
@@ -188,17 +360,38 @@ new_aubio_peakpicker (void)
       //-0.59488894, 0.23484048);
       0.23484048, 0);
 
+  if (aubio_peakpicker_alloc (t) != AUBIO_OK) {
+    del_aubio_peakpicker (t);
+    return NULL;
+  }
+
   return t;
 }
 
 void
 del_aubio_peakpicker (aubio_peakpicker_t * p)
 {
-  del_aubio_filter (p->biquad);
-  del_fvec (p->onset_keep);
-  del_fvec (p->onset_proc);
-  del_fvec (p->onset_peek);
-  del_fvec (p->thresholded);
-  del_fvec (p->scratch);
+  if (p->biquad) del_aubio_filter (p->biquad);
+  if (p->onset_keep) del_fvec (p->onset_keep);
+  if (p->onset_proc) del_fvec (p->onset_proc);
+  if (p->onset_peek) del_fvec (p->onset_peek);
+  if (p->thresholded) del_fvec (p->thresholded);
+  if (p->scratch) del_fvec (p->scratch);
+  if (p->sample) del_fvec (p->sample);
+  if (p->ring) AUBIO_FREE (p->ring);
+  if (p->heap) AUBIO_FREE (p->heap);
+  if (p->where) AUBIO_FREE (p->where);
   AUBIO_FREE (p);
 }
+
+uint_t
+aubio_peakpicker_get_memory_usage (const aubio_peakpicker_t * p)
+{
+  uint_t n = aubio_malloc_size (p) + aubio_malloc_size (p->onset_keep)
+    + aubio_malloc_size (p->onset_proc) + aubio_malloc_size (p->onset_peek)
+    + aubio_malloc_size (p->thresholded) + aubio_malloc_size (p->scratch)
+    + aubio_malloc_size (p->sample) + aubio_malloc_size (p->ring)
+    + aubio_malloc_size (p->heap) + aubio_malloc_size (p->where);
+  if (p->biquad) n += aubio_filter_get_memory_usage (p->biquad);
+  return n;
+}
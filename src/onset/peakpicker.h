@@ -42,6 +42,9 @@ aubio_peakpicker_t * new_aubio_peakpicker(void);
 void aubio_peakpicker_do(aubio_peakpicker_t * p, fvec_t * in, fvec_t * out);
 /** destroy peak picker structure */
 void del_aubio_peakpicker(aubio_peakpicker_t * p);
+/** get the number of bytes allocated by a peak picker, see
+  utils/allocator.h */
+uint_t aubio_peakpicker_get_memory_usage (const aubio_peakpicker_t * p);
 
 /** get current peak value */
 fvec_t *aubio_peakpicker_get_thresholded_input (aubio_peakpicker_t * p);
@@ -49,6 +52,75 @@ fvec_t *aubio_peakpicker_get_thresholded_input (aubio_peakpicker_t * p);
 uint_t aubio_peakpicker_set_threshold(aubio_peakpicker_t * p, smpl_t threshold);
 /** get peak picking threshold */
 smpl_t aubio_peakpicker_get_threshold(aubio_peakpicker_t * p);
+/** get the mean of the window at the last call to aubio_peakpicker_do()
+
+  The thresholded value is the smoothed input minus the median of the window
+  minus this mean times the threshold, so that the value with another
+  threshold `t` is the thresholded value plus `mean * (threshold - t)`.
+
+*/
+smpl_t aubio_peakpicker_get_mean(const aubio_peakpicker_t * p);
+
+/** set the lengths of the window around the current value
+
+  \param p peak picker object
+  \param win_pre number of values after the current one [1]
+  \param win_post number of values before the current one [5]
+  \return 0 if successful, non-zero otherwise
+
+  The window is cleared. Each value is picked `win_pre` hops after it was
+  pushed.
+
+*/
+uint_t aubio_peakpicker_set_window(aubio_peakpicker_t * p, uint_t win_pre,
+    uint_t win_post);
+/** get the number of values after the current one */
+uint_t aubio_peakpicker_get_win_pre(const aubio_peakpicker_t * p);
+/** get the number of values before the current one */
+uint_t aubio_peakpicker_get_win_post(const aubio_peakpicker_t * p);
+/** get the latency of the peak picker
+
+  \param p peak picker object
+  \return number of values pushed between a peak and its detection,
+  `win_pre + 1`: the thresholded value lags `win_pre` values behind the input,
+  and a peak is only known once the next value is thresholded
+
+*/
+uint_t aubio_peakpicker_get_latency(const aubio_peakpicker_t * p);
+
+/** enable or disable incremental peak picking
+
+  \param p peak picker object
+  \param incremental 1 to enable, 0 to disable [0]
+  \return 0 if successful, non-zero otherwise
+
+  In incremental mode, each new value is smoothed by a causal filter instead
+  of filtering the whole window forward and backward, and the mean and
+  median of the window are updated in place, so that each hop costs O(log n)
+  for a window of n values instead of O(n). The median is always used as
+  threshold. The window is cleared.
+
+*/
+uint_t aubio_peakpicker_set_incremental(aubio_peakpicker_t * p,
+    uint_t incremental);
+/** get incremental peak picking mode, 1 if enabled, 0 otherwise */
+uint_t aubio_peakpicker_get_incremental(const aubio_peakpicker_t * p);
+
+/** enable or disable the smoothing of the incremental mode
+
+  \param p peak picker object
+  \param smoothing 1 to enable, 0 to disable [1]
+  \return 0 if successful, non-zero otherwise
+
+  The causal low-pass filter of the incremental mode delays each peak by
+  about one value. Without it, the peaks are picked as soon as they can be,
+  at the cost of a noisier threshold.
+
+*/
+uint_t aubio_peakpicker_set_smoothing(aubio_peakpicker_t * p,
+    uint_t smoothing);
+/** get smoothing of the incremental mode, 1 if enabled, 0 otherwise */
+uint_t aubio_peakpicker_get_smoothing(const aubio_peakpicker_t * p);
 
 #ifdef __cplusplus
 }
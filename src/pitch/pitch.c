@@ -22,6 +22,7 @@
 #include "fvec.h"
 #include "cvec.h"
 #include "lvec.h"
+#include "fmat.h"
 #include "mathutils.h"
 #include "musicutils.h"
 #include "spectral/phasevoc.h"
@@ -35,9 +36,14 @@
 #include "pitch/pitchyinfast.h"
 #include "pitch/pitchspecacf.h"
 #include "pitch/pitch.h"
+#include "pitch/pitchyin_priv.h"
+#include "utils/pending_priv.h"
 
 #define DEFAULT_PITCH_SILENCE -50.
 
+/** number of candidates followed by the pitch tracker */
+#define AUBIO_PITCH_TRACK_STATES 5
+
 /** pitch detection algorithms */
 typedef enum
 {
@@ -71,6 +77,12 @@ typedef smpl_t(*aubio_pitch_convert_t) (smpl_t value, uint_t samplerate, uint_t
 /** callback to fetch the confidence of the algorithm */
 typedef smpl_t (*aubio_pitch_get_conf_t) (void * p);
 
+/** callback to fetch the minima of the YIN function */
+typedef uint_t (*aubio_pitch_get_cand_t) (void * p, fmat_t * candidates);
+
+/** do function of a yin object, to run it on the decimated input */
+typedef void (*aubio_pitch_run_t) (void * p, const fvec_t * ibuf, fvec_t * obuf);
+
 /** generic pitch detection structure */
 struct _aubio_pitch_t
 {
@@ -84,10 +96,35 @@ struct _aubio_pitch_t
   aubio_pvoc_t *pv;               /**< phase vocoder for mcomb */
   cvec_t *fftgrain;               /**< spectral frame for mcomb */
   fvec_t *buf;                    /**< temporary buffer for yin */
+  fvec_t *converted;              /**< input of aubio_pitch_do_s16 */
   aubio_pitch_detect_t detect_cb; /**< callback to get the pitch candidates */
   aubio_pitch_convert_t conv_cb;  /**< callback to convert it to the desired unit */
   aubio_pitch_get_conf_t conf_cb; /**< pointer to the current confidence callback */
+  aubio_pitch_get_cand_t cand_cb; /**< callback to get the candidates, or NULL */
   smpl_t silence;                 /**< silence threshold */
+  uint_t hopsize;                 /**< hop size, to create channel objects */
+  char_t *method;                 /**< method, to create channel objects */
+  aubio_pitch_t **channels;       /**< objects analysing channels 1 and up */
+  uint_t n_channels;              /**< number of objects in channels */
+  uint_t decimation;              /**< decimation factor of the yin methods */
+  aubio_pitch_run_t dec_cb;       /**< do function of the decimated object */
+  fvec_t *dec_filter;             /**< anti-aliasing low-pass filter */
+  fvec_t *dec_mem;                /**< filter memory, followed by the new hop */
+  fvec_t *dec_buf;                /**< decimated input buffer */
+  smpl_t track_cost;              /**< tracker cost of a semitone jump, 0 if off */
+  fmat_t *track_cands;            /**< candidates of the current frame */
+  smpl_t track_midi[AUBIO_PITCH_TRACK_STATES];  /**< last states, in midi */
+  smpl_t track_score[AUBIO_PITCH_TRACK_STATES]; /**< cost of the paths to them */
+  uint_t track_n;                 /**< number of states, 0 to restart */
+  uint_t gating;                  /**< skip the detection on silent hops */
+  uint_t deferred;                /**< post parameters to pending */
+  aubio_pending_t pending;        /**< parameters posted by other threads */
+};
+
+/** ids of the parameters posted when deferred */
+enum {
+  AUBIO_PITCH_TOLERANCE,
+  AUBIO_PITCH_SILENCE
 };
 
 /* callback functions for pitch detection */
@@ -98,6 +135,7 @@ static void aubio_pitch_do_fcomb (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t
 static void aubio_pitch_do_yinfft (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
 static void aubio_pitch_do_yinfast (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
 static void aubio_pitch_do_specacf (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
+static void aubio_pitch_do_decimated (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf);
 
 /* internal functions for frequency conversion */
 static smpl_t freqconvbin (smpl_t f, uint_t samplerate, uint_t bufsize);
@@ -107,6 +145,31 @@ static smpl_t freqconvpass (smpl_t f, uint_t samplerate, uint_t bufsize);
 /* adapter to stack ibuf new samples at the end of buf, and trim `buf` to `bufsize` */
 void aubio_pitch_slideblock (aubio_pitch_t * p, const fvec_t * ibuf);
 
+/* low-pass ibuf and stack every p->decimation-th sample at the end of dec_buf */
+static void aubio_pitch_decimate (aubio_pitch_t * p, const fvec_t * ibuf);
+
+/* refine a period at full rate, searching `radius` lags around it */
+static smpl_t aubio_pitch_refine_period (const fvec_t * buf, smpl_t period,
+    uint_t radius);
+
+/* make the yin object of p list all the minima of its function */
+static void aubio_pitch_set_complete (aubio_pitch_t * p, uint_t complete);
+
+/* choose among the candidates of the last frame the end of the best path */
+static void aubio_pitch_track (aubio_pitch_t * p, fvec_t * obuf);
+
+/* make sure p->channels holds at least n_channels - 1 objects */
+static uint_t aubio_pitch_alloc_channels (aubio_pitch_t * p, uint_t n_channels);
+
+/* copy the parameters of p to the channel object c */
+static void aubio_pitch_sync_channel (aubio_pitch_t * p, aubio_pitch_t * c);
+
+/* set the tolerance of the detection object of p, if it has one */
+static void aubio_pitch_store_tolerance (aubio_pitch_t * p, smpl_t tol);
+
+/* apply the parameters posted since the last hop */
+static void aubio_pitch_apply_pending (aubio_pitch_t * p);
+
 
 aubio_pitch_t *
 new_aubio_pitch (const char_t * pitch_mode,
@@ -163,8 +226,15 @@ new_aubio_pitch (const char_t * pitch_mode,
   p->type = pitch_type;
   aubio_pitch_set_unit (p, "default");
   p->bufsize = bufsize;
+  p->hopsize = hopsize;
+  p->method = AUBIO_ARRAY(char_t, strnlen(pitch_mode, PATH_MAX) + 1);
+  strncpy(p->method, pitch_mode, strnlen(pitch_mode, PATH_MAX));
   p->silence = DEFAULT_PITCH_SILENCE;
   p->conf_cb = NULL;
+  p->cand_cb = NULL;
+  p->decimation = 1;
+  p->converted = new_fvec (hopsize);
+  if (!p->converted) goto beach;
   switch (p->type) {
     case aubio_pitcht_yin:
       p->buf = new_fvec (bufsize);
@@ -172,6 +242,7 @@ new_aubio_pitch (const char_t * pitch_mode,
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_yin;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchyin_get_confidence;
+      p->cand_cb = (aubio_pitch_get_cand_t)aubio_pitchyin_get_candidates;
       aubio_pitchyin_set_tolerance (p->p_object, 0.15);
       break;
     case aubio_pitcht_mcomb:
@@ -200,6 +271,7 @@ new_aubio_pitch (const char_t * pitch_mode,
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_yinfft;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchyinfft_get_confidence;
+      p->cand_cb = (aubio_pitch_get_cand_t)aubio_pitchyinfft_get_candidates;
       aubio_pitchyinfft_set_tolerance (p->p_object, 0.85);
       break;
     case aubio_pitcht_yinfast:
@@ -208,6 +280,7 @@ new_aubio_pitch (const char_t * pitch_mode,
       if (!p->p_object) goto beach;
       p->detect_cb = aubio_pitch_do_yinfast;
       p->conf_cb = (aubio_pitch_get_conf_t)aubio_pitchyinfast_get_confidence;
+      p->cand_cb = (aubio_pitch_get_cand_t)aubio_pitchyinfast_get_candidates;
       aubio_pitchyinfast_set_tolerance (p->p_object, 0.15);
       break;
     case aubio_pitcht_specacf:
@@ -224,15 +297,63 @@ new_aubio_pitch (const char_t * pitch_mode,
   return p;
 
 beach:
+  if (p->converted) del_fvec(p->converted);
   if (p->filtered) del_fvec(p->filtered);
   if (p->buf) del_fvec(p->buf);
+  if (p->method) AUBIO_FREE(p->method);
   AUBIO_FREE(p);
   return NULL;
 }
 
+aubio_pitch_t *
+aubio_pitch_clone (aubio_pitch_t * p)
+{
+  // created while p holds the windows and plans, so found in their caches
+  aubio_pitch_t *c = new_aubio_pitch (p->method, p->bufsize, p->hopsize,
+      p->samplerate);
+  if (!c) {
+    return NULL;
+  }
+  aubio_pitch_sync_channel (p, c);
+  c->deferred = p->deferred;
+  return c;
+}
+
+uint_t
+aubio_pitch_reconfigure (aubio_pitch_t * p, const char_t * method,
+    uint_t bufsize, uint_t hopsize)
+{
+  aubio_pitch_t *n = new_aubio_pitch (method, bufsize, hopsize,
+      p->samplerate);
+  aubio_pitch_t previous;
+  if (!n) {
+    return AUBIO_FAIL;
+  }
+  // move the new objects to p, and delete the previous ones with n
+  previous = *p;
+  *p = *n;
+  *n = previous;
+  del_aubio_pitch (n);
+  return AUBIO_OK;
+}
+
 void
 del_aubio_pitch (aubio_pitch_t * p)
 {
+  uint_t i;
+  for (i = 0; i < p->n_channels; i++) {
+    del_aubio_pitch (p->channels[i]);
+  }
+  if (p->channels)
+    AUBIO_FREE (p->channels);
+  if (p->dec_filter) {
+    del_fvec (p->dec_filter);
+    del_fvec (p->dec_mem);
+    del_fvec (p->dec_buf);
+  }
+  if (p->track_cands)
+    del_fmat (p->track_cands);
+  del_fvec (p->converted);
   switch (p->type) {
     case aubio_pitcht_yin:
       del_fvec (p->buf);
@@ -268,9 +389,54 @@ del_aubio_pitch (aubio_pitch_t * p)
     default:
       break;
   }
+  AUBIO_FREE (p->method);
   AUBIO_FREE (p);
 }
 
+uint_t
+aubio_pitch_get_memory_usage (const aubio_pitch_t * p)
+{
+  uint_t i, n = aubio_malloc_size (p) + aubio_malloc_size (p->method)
+    + aubio_malloc_size (p->channels) + aubio_malloc_size (p->filtered)
+    + aubio_malloc_size (p->fftgrain) + aubio_malloc_size (p->buf)
+    + aubio_malloc_size (p->converted) + aubio_malloc_size (p->dec_filter)
+    + aubio_malloc_size (p->dec_mem) + aubio_malloc_size (p->dec_buf)
+    + aubio_malloc_size (p->track_cands);
+  for (i = 0; i < p->n_channels; i++) {
+    n += aubio_pitch_get_memory_usage (p->channels[i]);
+  }
+  if (p->filter)
+    n += aubio_filter_get_memory_usage (p->filter);
+  if (p->pv)
+    n += aubio_pvoc_get_memory_usage (p->pv);
+  switch (p->type) {
+    case aubio_pitcht_yin:
+      n += aubio_pitchyin_get_memory_usage (p->p_object);
+      break;
+    case aubio_pitcht_mcomb:
+      n += aubio_pitchmcomb_get_memory_usage (p->p_object);
+      break;
+    case aubio_pitcht_schmitt:
+      n += aubio_pitchschmitt_get_memory_usage (p->p_object);
+      break;
+    case aubio_pitcht_fcomb:
+      n += aubio_pitchfcomb_get_memory_usage (p->p_object);
+      break;
+    case aubio_pitcht_yinfft:
+      n += aubio_pitchyinfft_get_memory_usage (p->p_object);
+      break;
+    case aubio_pitcht_yinfast:
+      n += aubio_pitchyinfast_get_memory_usage (p->p_object);
+      break;
+    case aubio_pitcht_specacf:
+      n += aubio_pitchspecacf_get_memory_usage (p->p_object);
+      break;
+    default:
+      break;
+  }
+  return n;
+}
+
 void
 aubio_pitch_slideblock (aubio_pitch_t * p, const fvec_t * ibuf)
 {
@@ -343,6 +509,17 @@ aubio_pitch_set_unit (aubio_pitch_t * p, const char_t * pitch_unit)
 
 uint_t
 aubio_pitch_set_tolerance (aubio_pitch_t * p, smpl_t tol)
+{
+  if (p->deferred) {
+    aubio_pending_post (&p->pending, AUBIO_PITCH_TOLERANCE, tol);
+    return AUBIO_OK;
+  }
+  aubio_pitch_store_tolerance (p, tol);
+  return AUBIO_OK;
+}
+
+static void
+aubio_pitch_store_tolerance (aubio_pitch_t * p, smpl_t tol)
 {
   switch (p->type) {
     case aubio_pitcht_yin:
@@ -357,7 +534,6 @@ aubio_pitch_set_tolerance (aubio_pitch_t * p, smpl_t tol)
     default:
       break;
   }
-  return AUBIO_OK;
 }
 
 smpl_t
@@ -380,11 +556,165 @@ aubio_pitch_get_tolerance (aubio_pitch_t * p)
   return tolerance;
 }
 
+uint_t
+aubio_pitch_set_decimation (aubio_pitch_t * p, uint_t factor)
+{
+  void *o = NULL;
+  smpl_t tol, t, sum = 0.;
+  uint_t i, n_taps;
+  if (factor == p->decimation) {
+    return AUBIO_OK;
+  }
+  if (p->type != aubio_pitcht_yin && p->type != aubio_pitcht_yinfast
+      && p->type != aubio_pitcht_yinfft) {
+    AUBIO_ERR ("pitch: decimation is only available with yin, yinfast and"
+        " yinfft\n");
+    return AUBIO_FAIL;
+  }
+  if (factor < 1 || factor > 4) {
+    AUBIO_ERR ("pitch: decimation factor should be in [1, 4], got %d\n",
+        factor);
+    return AUBIO_FAIL;
+  }
+  if (p->bufsize % factor != 0 || p->hopsize % factor != 0) {
+    AUBIO_ERR ("pitch: buffer size (%d) and hop size (%d) should be"
+        " multiples of the decimation factor (%d)\n", p->bufsize, p->hopsize,
+        factor);
+    return AUBIO_FAIL;
+  }
+  tol = aubio_pitch_get_tolerance (p);
+  // create the new object first, to leave p untouched if it fails
+  switch (p->type) {
+    case aubio_pitcht_yin:
+      o = new_aubio_pitchyin (p->bufsize / factor);
+      if (!o) return AUBIO_FAIL;
+      del_aubio_pitchyin (p->p_object);
+      p->detect_cb = factor > 1 ? aubio_pitch_do_decimated : aubio_pitch_do_yin;
+      p->dec_cb = (aubio_pitch_run_t)aubio_pitchyin_do;
+      break;
+    case aubio_pitcht_yinfast:
+      o = new_aubio_pitchyinfast (p->bufsize / factor);
+      if (!o) return AUBIO_FAIL;
+      del_aubio_pitchyinfast (p->p_object);
+      p->detect_cb = factor > 1 ? aubio_pitch_do_decimated
+        : aubio_pitch_do_yinfast;
+      p->dec_cb = (aubio_pitch_run_t)aubio_pitchyinfast_do;
+      break;
+    case aubio_pitcht_yinfft:
+      o = new_aubio_pitchyinfft (p->samplerate / factor, p->bufsize / factor);
+      if (!o) return AUBIO_FAIL;
+      del_aubio_pitchyinfft (p->p_object);
+      p->detect_cb = factor > 1 ? aubio_pitch_do_decimated
+        : aubio_pitch_do_yinfft;
+      p->dec_cb = (aubio_pitch_run_t)aubio_pitchyinfft_do;
+      break;
+    default:
+      break;
+  }
+  p->p_object = o;
+  aubio_pitch_store_tolerance (p, tol);
+  aubio_pitch_set_complete (p, p->track_cost > 0.);
+  if (p->dec_filter) {
+    del_fvec (p->dec_filter);
+    del_fvec (p->dec_mem);
+    del_fvec (p->dec_buf);
+    p->dec_filter = NULL;
+    p->dec_mem = NULL;
+    p->dec_buf = NULL;
+  }
+  p->decimation = factor;
+  if (factor == 1) {
+    return AUBIO_OK;
+  }
+  // hamming windowed sinc, cut at 0.8 times the decimated nyquist frequency
+  n_taps = 16 * factor + 1;
+  p->dec_filter = new_fvec (n_taps);
+  p->dec_mem = new_fvec (n_taps - 1 + p->hopsize);
+  p->dec_buf = new_fvec (p->bufsize / factor);
+  for (i = 0; i < n_taps; i++) {
+    t = i - (n_taps - 1) / 2.;
+    p->dec_filter->data[i] = (t == 0.) ? .8 / factor
+      : SIN (PI * .8 / factor * t) / (PI * t);
+    p->dec_filter->data[i] *= .54 - .46 * COS (TWO_PI * i / (n_taps - 1.));
+    sum += p->dec_filter->data[i];
+  }
+  for (i = 0; i < n_taps; i++) {
+    p->dec_filter->data[i] /= sum;
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_pitch_get_decimation (aubio_pitch_t * p)
+{
+  return p->decimation;
+}
+
+uint_t
+aubio_pitch_get_latency (aubio_pitch_t * p)
+{
+  uint_t latency = p->bufsize / 2;
+  // group delay of the anti-aliasing filter, in samples of the input
+  if (p->dec_filter) latency += (p->dec_filter->length - 1) / 2;
+  return latency;
+}
+
+uint_t
+aubio_pitch_set_tracking (aubio_pitch_t * p, smpl_t cost)
+{
+  if (cost == p->track_cost) {
+    return AUBIO_OK;
+  }
+  if (cost < 0.) {
+    AUBIO_ERR ("pitch: tracking cost should be >= 0, got %.3f\n", cost);
+    return AUBIO_FAIL;
+  }
+  if (cost > 0. && !p->cand_cb) {
+    AUBIO_ERR ("pitch: tracking is only available with yin, yinfast and"
+        " yinfft\n");
+    return AUBIO_FAIL;
+  }
+  if (cost > 0. && !p->track_cands) {
+    p->track_cands = new_fmat (2, AUBIO_PITCH_TRACK_STATES);
+    if (!p->track_cands) return AUBIO_FAIL;
+  }
+  p->track_cost = cost;
+  p->track_n = 0;
+  aubio_pitch_set_complete (p, cost > 0.);
+  return AUBIO_OK;
+}
+
+static void
+aubio_pitch_set_complete (aubio_pitch_t * p, uint_t complete)
+{
+  switch (p->type) {
+    case aubio_pitcht_yin:
+      aubio_pitchyin_set_complete (p->p_object, complete);
+      break;
+    case aubio_pitcht_yinfast:
+      aubio_pitchyinfast_set_complete (p->p_object, complete);
+      break;
+    default:
+      // yinfft always computes all of its function
+      break;
+  }
+}
+
+smpl_t
+aubio_pitch_get_tracking (aubio_pitch_t * p)
+{
+  return p->track_cost;
+}
+
 uint_t
 aubio_pitch_set_silence (aubio_pitch_t * p, smpl_t silence)
 {
   if (silence <= 0 && silence >= -200) {
-    p->silence = silence;
+    if (p->deferred) {
+      aubio_pending_post (&p->pending, AUBIO_PITCH_SILENCE, silence);
+    } else {
+      p->silence = silence;
+    }
     return AUBIO_OK;
   } else {
     AUBIO_WRN("pitch: could not set silence to %.2f\n", silence);
@@ -398,18 +728,244 @@ aubio_pitch_get_silence (aubio_pitch_t * p)
   return p->silence;
 }
 
+uint_t
+aubio_pitch_set_gating (aubio_pitch_t * p, uint_t gating)
+{
+  p->gating = gating ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_pitch_get_gating (const aubio_pitch_t * p)
+{
+  return p->gating;
+}
+
+uint_t
+aubio_pitch_set_deferred (aubio_pitch_t * p, uint_t deferred)
+{
+  p->deferred = deferred ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_pitch_get_deferred (const aubio_pitch_t * p)
+{
+  return p->deferred;
+}
+
+static void
+aubio_pitch_apply_pending (aubio_pitch_t * p)
+{
+  smpl_t values[AUBIO_PENDING_MAX];
+  uint_t posted = aubio_pending_take (&p->pending, values);
+  if (!posted) return;
+  if (posted & (1u << AUBIO_PITCH_TOLERANCE))
+    aubio_pitch_store_tolerance (p, values[AUBIO_PITCH_TOLERANCE]);
+  if (posted & (1u << AUBIO_PITCH_SILENCE))
+    p->silence = values[AUBIO_PITCH_SILENCE];
+}
+
 
 /* do method, calling the detection callback, then the conversion callback */
 void
 aubio_pitch_do (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
 {
-  p->detect_cb (p, ibuf, obuf);
-  if (aubio_silence_detection(ibuf, p->silence) == 1) {
+  aubio_pitch_do_stats (p, ibuf, NULL, obuf);
+}
+
+void
+aubio_pitch_do_stats (aubio_pitch_t * p, const fvec_t * ibuf,
+    const aubio_frame_stats_t * stats, fvec_t * obuf)
+{
+  uint_t silent;
+  AUBIO_STATS_BEGIN ("pitch");
+  aubio_pitch_apply_pending (p);
+  if (p->gating) {
+    silent = stats ? stats->db_spl < p->silence
+      : aubio_silence_detection(ibuf, p->silence);
+    if (silent) {
+      // only store the new hop, the output would be 0 anyway
+      aubio_pitch_skip (p, ibuf);
+      obuf->data[0] = 0.;
+    } else {
+      p->detect_cb (p, ibuf, obuf);
+      aubio_pitch_track (p, obuf);
+    }
+  } else {
+    p->detect_cb (p, ibuf, obuf);
+    aubio_pitch_track (p, obuf);
+    if (stats ? stats->db_spl < p->silence
+        : aubio_silence_detection(ibuf, p->silence)) {
+      obuf->data[0] = 0.;
+      p->track_n = 0;
+    }
+  }
+  obuf->data[0] = p->conv_cb (obuf->data[0], p->samplerate, p->bufsize);
+  AUBIO_STATS_END ();
+}
+
+void
+aubio_pitch_do_s16 (aubio_pitch_t * p, const s16_t * ibuf, fvec_t * obuf)
+{
+  uint_t j;
+  for (j = 0; j < p->converted->length; j++) {
+    p->converted->data[j] = ibuf[j] * AUBIO_S16_SCALE;
+  }
+  aubio_pitch_do (p, p->converted, obuf);
+}
+
+void
+aubio_pitch_do_spectrum (aubio_pitch_t * p, const fvec_t * ibuf,
+    const cvec_t * fftgrain, fvec_t * obuf)
+{
+  aubio_pitch_do_spectrum_stats (p, ibuf, fftgrain, NULL, obuf);
+}
+
+void
+aubio_pitch_do_spectrum_stats (aubio_pitch_t * p, const fvec_t * ibuf,
+    const cvec_t * fftgrain, const aubio_frame_stats_t * stats,
+    fvec_t * obuf)
+{
+  if (fftgrain->length != p->bufsize / 2 + 1) {
+    AUBIO_ERR ("pitch: expected a spectrum of length %d, got %d\n",
+        p->bufsize / 2 + 1, fftgrain->length);
+    aubio_pitch_do_stats (p, ibuf, stats, obuf);
+    return;
+  }
+  aubio_pitch_apply_pending (p);
+  switch (p->type) {
+    case aubio_pitcht_mcomb:
+      aubio_pitchmcomb_do (p->p_object, fftgrain, obuf);
+      obuf->data[0] = aubio_bintofreq (obuf->data[0], p->samplerate,
+          p->bufsize);
+      break;
+    case aubio_pitcht_fcomb:
+      aubio_pitch_slideblock (p, ibuf);
+      aubio_pitchfcomb_do_spectrum (p->p_object, fftgrain, obuf);
+      obuf->data[0] = aubio_bintofreq (obuf->data[0], p->samplerate,
+          p->bufsize);
+      break;
+    case aubio_pitcht_yinfft:
+      if (p->decimation > 1) {
+        // the spectrum is that of the full rate input
+        p->detect_cb (p, ibuf, obuf);
+        break;
+      }
+      aubio_pitch_slideblock (p, ibuf);
+      aubio_pitchyinfft_do_spectrum (p->p_object, fftgrain, obuf);
+      if (obuf->data[0] > 0) {
+        obuf->data[0] = p->samplerate / (obuf->data[0] + 0.);
+      } else {
+        obuf->data[0] = 0.;
+      }
+      break;
+    default:
+      // time domain methods do not use the spectrum
+      p->detect_cb (p, ibuf, obuf);
+      break;
+  }
+  aubio_pitch_track (p, obuf);
+  if (stats ? stats->db_spl < p->silence
+      : aubio_silence_detection(ibuf, p->silence) == 1) {
     obuf->data[0] = 0.;
+    p->track_n = 0;
   }
   obuf->data[0] = p->conv_cb (obuf->data[0], p->samplerate, p->bufsize);
 }
 
+void
+aubio_pitch_skip (aubio_pitch_t * p, const fvec_t * ibuf)
+{
+  smpl_t out_data = 0.;
+  fvec_t out;
+  out.length = 1;
+  out.data = &out_data;
+  switch (p->type) {
+    case aubio_pitcht_mcomb:
+    case aubio_pitcht_schmitt:
+      p->detect_cb (p, ibuf, &out);
+      break;
+    default:
+      aubio_pitch_slideblock (p, ibuf);
+      if (p->decimation > 1) {
+        aubio_pitch_decimate (p, ibuf);
+      }
+      break;
+  }
+  p->track_n = 0;
+}
+
+void
+aubio_pitch_do_multi (aubio_pitch_t * p, const fmat_t * ibuf, fvec_t * obuf)
+{
+  uint_t ch;
+  fvec_t ibuf_ch, obuf_ch;
+  if (ibuf->length != p->hopsize) {
+    AUBIO_ERR ("pitch: expected input frames of length %d, got %d\n",
+        p->hopsize, ibuf->length);
+    return;
+  }
+  if (obuf->length < ibuf->height) {
+    AUBIO_ERR ("pitch: output of length %d is too short for %d channels\n",
+        obuf->length, ibuf->height);
+    return;
+  }
+  if (aubio_pitch_alloc_channels (p, ibuf->height) != AUBIO_OK) {
+    return;
+  }
+  for (ch = 0; ch < ibuf->height; ch++) {
+    aubio_pitch_t *c = p;
+    fmat_get_channel (ibuf, ch, &ibuf_ch);
+    fvec_view (&obuf_ch, obuf, ch, 1);
+    if (ch > 0) {
+      c = p->channels[ch - 1];
+      aubio_pitch_sync_channel (p, c);
+    }
+    aubio_pitch_do (c, &ibuf_ch, &obuf_ch);
+  }
+}
+
+static uint_t
+aubio_pitch_alloc_channels (aubio_pitch_t * p, uint_t n_channels)
+{
+  uint_t i;
+  aubio_pitch_t **channels;
+  if (n_channels <= p->n_channels + 1) {
+    return AUBIO_OK;
+  }
+  channels = AUBIO_ARRAY (aubio_pitch_t *, n_channels - 1);
+  for (i = 0; i < p->n_channels; i++) {
+    channels[i] = p->channels[i];
+  }
+  if (p->channels) {
+    AUBIO_FREE (p->channels);
+  }
+  p->channels = channels;
+  for (i = p->n_channels; i < n_channels - 1; i++) {
+    channels[i] = new_aubio_pitch (p->method, p->bufsize, p->hopsize,
+        p->samplerate);
+    if (!channels[i]) {
+      AUBIO_ERR ("pitch: failed creating the object of channel %d\n", i + 1);
+      return AUBIO_FAIL;
+    }
+    p->n_channels = i + 1;
+  }
+  return AUBIO_OK;
+}
+
+static void
+aubio_pitch_sync_channel (aubio_pitch_t * p, aubio_pitch_t * c)
+{
+  c->mode = p->mode;
+  c->conv_cb = p->conv_cb;
+  c->silence = p->silence;
+  c->gating = p->gating;
+  aubio_pitch_set_decimation (c, p->decimation);
+  aubio_pitch_set_tracking (c, p->track_cost);
+  aubio_pitch_set_tolerance (c, aubio_pitch_get_tolerance (p));
+}
+
 /* do method for each algorithm */
 void
 aubio_pitch_do_mcomb (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
@@ -505,6 +1061,122 @@ aubio_pitch_do_schmitt (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * out)
   out->data[0] = pitch;
 }
 
+void
+aubio_pitch_do_decimated (aubio_pitch_t * p, const fvec_t * ibuf, fvec_t * obuf)
+{
+  smpl_t period;
+  // keep the full rate buffer to refine the period
+  aubio_pitch_slideblock (p, ibuf);
+  aubio_pitch_decimate (p, ibuf);
+  p->dec_cb (p->p_object, p->dec_buf, obuf);
+  period = obuf->data[0];
+  if (period > 0) {
+    period = aubio_pitch_refine_period (p->buf, period * p->decimation,
+        p->decimation);
+    obuf->data[0] = p->samplerate / period;
+  } else {
+    obuf->data[0] = 0.;
+  }
+}
+
+static void
+aubio_pitch_decimate (aubio_pitch_t * p, const fvec_t * ibuf)
+{
+  uint_t i, k;
+  uint_t n_taps = p->dec_filter->length, n_mem = n_taps - 1;
+  uint_t n_out = ibuf->length / p->decimation;
+  uint_t overlap = p->dec_buf->length - n_out;
+  smpl_t *mem = p->dec_mem->data, *h = p->dec_filter->data;
+  smpl_t *out = p->dec_buf->data, *x, acc;
+  AUBIO_MEMCPY (mem + n_mem, ibuf->data, ibuf->length * sizeof(smpl_t));
+  memmove (out, out + n_out, overlap * sizeof(smpl_t));
+  // only compute the samples that are kept
+  for (i = 0; i < n_out; i++) {
+    x = mem + i * p->decimation;
+    acc = 0.;
+    for (k = 0; k < n_taps; k++) {
+      acc += h[k] * x[k];
+    }
+    out[overlap + i] = acc;
+  }
+  memmove (mem, mem + ibuf->length, n_mem * sizeof(smpl_t));
+}
+
+static smpl_t
+aubio_pitch_refine_period (const fvec_t * buf, smpl_t period, uint_t radius)
+{
+  // squared difference at full rate, on the window used by yin
+  smpl_t diff[9], tmp, s0, s2, den;
+  uint_t n = buf->length / 2, center = (uint_t)ROUND (period);
+  uint_t lo = center > radius + 1 ? center - radius : 1;
+  uint_t hi = MIN (center + radius, n - 1);
+  uint_t tau, j, best = 0;
+  if (hi < lo || hi - lo >= 9) {
+    return period;
+  }
+  for (tau = lo; tau <= hi; tau++) {
+    diff[tau - lo] = 0.;
+    for (j = 0; j < n; j++) {
+      tmp = buf->data[j] - buf->data[j + tau];
+      diff[tau - lo] += tmp * tmp;
+    }
+    if (diff[tau - lo] < diff[best]) {
+      best = tau - lo;
+    }
+  }
+  // keep the coarse estimate if the minimum is outside the searched lags
+  if (best == 0 || best == hi - lo) {
+    return period;
+  }
+  s0 = diff[best - 1];
+  s2 = diff[best + 1];
+  den = s0 - 2. * diff[best] + s2;
+  return lo + best + (den != 0. ? .5 * (s0 - s2) / den : 0.);
+}
+
+/* online viterbi: each candidate costs the depth of its minimum and half its
+ * distance to the pitch detected in the frame, plus the cheapest path from
+ * the last states, a jump of one semitone costing track_cost; the output is
+ * the end of the cheapest path. A detection away from the path for a single
+ * frame costs less to ignore than to jump to and back from, while the
+ * distance keeps paths from drifting towards the deeper minima of lower
+ * octaves. */
+static void
+aubio_pitch_track (aubio_pitch_t * p, fvec_t * obuf)
+{
+  uint_t i, j, n, best = 0;
+  smpl_t midi[AUBIO_PITCH_TRACK_STATES], score[AUBIO_PITCH_TRACK_STATES];
+  smpl_t path, best_path, detected;
+  if (p->track_cost <= 0.) return;
+  n = p->cand_cb (p->p_object, p->track_cands);
+  if (n == 0 || obuf->data[0] <= 0.) {
+    p->track_n = 0;
+    return;
+  }
+  detected = aubio_freqtomidi (obuf->data[0]);
+  for (i = 0; i < n; i++) {
+    midi[i] = aubio_freqtomidi (p->samplerate
+        / (p->track_cands->data[0][i] * p->decimation));
+    best_path = 0.;
+    for (j = 0; j < p->track_n; j++) {
+      path = p->track_score[j]
+        + p->track_cost * ABS (midi[i] - p->track_midi[j]);
+      if (j == 0 || path < best_path) best_path = path;
+    }
+    score[i] = p->track_cands->data[1][i] + best_path
+      + .5 * p->track_cost * ABS (midi[i] - detected);
+    if (score[i] < score[best]) best = i;
+  }
+  // keep the scores small
+  for (i = 0; i < n; i++) {
+    p->track_score[i] = score[i] - score[best];
+    p->track_midi[i] = midi[i];
+  }
+  p->track_n = n;
+  obuf->data[0] = p->samplerate / (p->track_cands->data[0][best]
+      * p->decimation);
+}
+
 /* conversion callbacks */
 smpl_t
 freqconvbin(smpl_t f, uint_t samplerate, uint_t bufsize)
@@ -533,3 +1205,25 @@ aubio_pitch_get_confidence (aubio_pitch_t * p)
   }
   return 0.;
 }
+
+uint_t
+aubio_pitch_get_candidates (aubio_pitch_t * p, fmat_t * candidates)
+{
+  uint_t i, n;
+  smpl_t period;
+  if (candidates->height < 2 || candidates->length < 1) {
+    AUBIO_ERR("pitch: candidates should have 2 rows and at least 1 column,"
+        " got %d rows and %d columns\n", candidates->height,
+        candidates->length);
+    return 0;
+  }
+  if (!p->cand_cb) return 0;
+  n = p->cand_cb(p->p_object, candidates);
+  for (i = 0; i < n; i++) {
+    period = candidates->data[0][i] * p->decimation;
+    candidates->data[0][i] = p->conv_cb(p->samplerate / period,
+        p->samplerate, p->bufsize);
+    candidates->data[1][i] = MAX(0., 1. - candidates->data[1][i]);
+  }
+  return n;
+}
@@ -114,6 +114,102 @@ typedef struct _aubio_pitch_t aubio_pitch_t;
 */
 void aubio_pitch_do (aubio_pitch_t * o, const fvec_t * in, fvec_t * out);
 
+/** execute pitch detection with the level of the input already computed
+
+  Same as aubio_pitch_do(), but the silence test reads the level from
+  `stats`, so that the detectors running on the same input can share it.
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param in input signal of size [hop_size]
+  \param stats statistics of `in`, as computed by aubio_frame_stats_do(), or
+  NULL to compute the level of `in`
+  \param out output pitch candidates of size [1]
+
+*/
+void aubio_pitch_do_stats (aubio_pitch_t * o, const fvec_t * in,
+    const aubio_frame_stats_t * stats, fvec_t * out);
+
+/** execute pitch detection on a precomputed spectrum
+
+  This function lets several analysis objects share a single phase vocoder.
+  The `mcomb`, `fcomb` and `yinfft` methods read `fftgrain` instead of
+  computing their own spectrum; other methods only use `in`, as
+  aubio_pitch_do() does. Since `mcomb` and `fcomb` read the phase, the phase
+  vocoder should then not be in magnitude-only mode.
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param in input signal of size [hop_size]
+  \param fftgrain spectrum of the last [buf_size] samples, as computed by
+  aubio_pvoc_do() on a phase vocoder of the same buffer and hop sizes, with
+  its default window
+  \param out output pitch candidates of size [1]
+
+*/
+void aubio_pitch_do_spectrum (aubio_pitch_t * o, const fvec_t * in,
+    const cvec_t * fftgrain, fvec_t * out);
+
+/** execute pitch detection on a precomputed spectrum and level
+
+  Same as aubio_pitch_do_spectrum(), but the silence test reads the level
+  from `stats`, as aubio_pitch_do_stats() does.
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param in input signal of size [hop_size]
+  \param fftgrain spectrum of the last [buf_size] samples, see
+  aubio_pitch_do_spectrum()
+  \param stats statistics of `in`, as computed by aubio_frame_stats_do(), or
+  NULL to compute the level of `in`
+  \param out output pitch candidates of size [1]
+
+*/
+void aubio_pitch_do_spectrum_stats (aubio_pitch_t * o, const fvec_t * in,
+    const cvec_t * fftgrain, const aubio_frame_stats_t * stats,
+    fvec_t * out);
+
+/** execute pitch detection on 16 bit integer samples
+
+  Same as aubio_pitch_do(), with the samples scaled by 1 / 32768 into a
+  buffer of the pitch object.
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param in input samples, hop_size of them
+  \param out output pitch candidates of size [1]
+
+*/
+void aubio_pitch_do_s16 (aubio_pitch_t * o, const s16_t * in, fvec_t * out);
+
+/** execute pitch detection on several channels
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param in input signal, one row of size [hop_size] per channel
+  \param out output pitch candidates, of size [in->height] or more
+
+  Each channel is analysed as if it was given to its own pitch object: the
+  value written in `out->data[ch]` is the one aubio_pitch_do() would have
+  returned for channel `ch`. Channel 0 is analysed by `o` itself, so that
+  aubio_pitch_get_confidence() reports on it. The objects of the other
+  channels are created on the first call that needs them, and use the unit,
+  tolerance and silence threshold of `o` as set at the time of each call.
+
+*/
+void aubio_pitch_do_multi (aubio_pitch_t * o, const fmat_t * in,
+    fvec_t * out);
+
+/** feed a hop of input without running the detection
+
+  Keeps the internal buffers of `o` up to date, so that a later call to
+  aubio_pitch_do() returns what it would have returned had all previous hops
+  been analysed, at a fraction of the cost. This lets callers only analyse
+  the frames they need. The `mcomb` and `schmitt` methods, whose state
+  depends on every frame, still run their detection. The tracker, if any,
+  restarts on the next analysed frame.
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param in input signal of size [hop_size]
+
+*/
+void aubio_pitch_skip (aubio_pitch_t * o, const fvec_t * in);
+
 /** change yin or yinfft tolerance threshold
 
   \param o pitch detection object as returned by new_aubio_pitch()
@@ -130,6 +226,120 @@ uint_t aubio_pitch_set_tolerance (aubio_pitch_t * o, smpl_t tol);
 */
 smpl_t aubio_pitch_get_tolerance (aubio_pitch_t * o);
 
+/** set the decimation factor of yin, yinfast or yinfft
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param factor decimation factor, from 1 to 4; 1, the default, analyses
+  the input at full rate
+
+  \return 0 if successful, non-zero otherwise, for instance if the buffer
+  size or the hop size of `o` are not multiples of `factor`, or if its method
+  is not one of `yin`, `yinfast` and `yinfft`
+
+  The input is low-passed and decimated before running the YIN analysis on
+  buffers `factor` times shorter, and the period found is then refined at
+  full rate. This divides the cost of `yin` by about `factor` squared, for
+  long buffers meant to track low pitches. Frequencies above about 0.3 times
+  the samplerate divided by `factor` are filtered out.
+
+*/
+uint_t aubio_pitch_set_decimation (aubio_pitch_t * o, uint_t factor);
+
+/** get the decimation factor of the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return decimation factor, 1 if the input is analysed at full rate
+
+*/
+uint_t aubio_pitch_get_decimation (aubio_pitch_t * o);
+
+/** get the latency of the pitch detection, in samples
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return time between the centre of the buffer a pitch is estimated on and
+  the end of the last block, in samples, including the delay of the
+  decimation filter if any
+
+*/
+uint_t aubio_pitch_get_latency (aubio_pitch_t * o);
+
+/** enable the pitch tracker of yin, yinfast or yinfft
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param cost cost of a jump of one semitone between consecutive frames,
+  compared to the values of the YIN function at the candidates; 0, the
+  default, disables the tracker, and with 0.05 an octave jump costs 0.6
+
+  \return 0 if successful, non-zero otherwise, for instance if the method
+  of `o` is not one of `yin`, `yinfast` and `yinfft`
+
+  Instead of keeping the best candidate of each frame, the tracker keeps the
+  end of the cheapest path through the candidates of the past frames, as
+  listed by aubio_pitch_get_candidates(), so that octave errors and short
+  jumps get smoothed out without adding latency. Paths restart after silent
+  or unvoiced frames.
+
+*/
+uint_t aubio_pitch_set_tracking (aubio_pitch_t * o, smpl_t cost);
+
+/** get the pitch tracker jump cost
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return cost of a jump of one semitone, 0 if the tracker is disabled
+
+*/
+smpl_t aubio_pitch_get_tracking (aubio_pitch_t * o);
+
+/** create a copy of a pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return new pitch detection object, with the method, sizes, unit and
+  parameters of `o`, or NULL on failure
+
+  The copy starts from the state of a new object. As it is created while
+  `o` holds its windows and FFT plans, they are taken from the caches
+  shared by all objects instead of being computed again.
+
+*/
+aubio_pitch_t *aubio_pitch_clone (aubio_pitch_t * o);
+
+/** change the method and sizes of a pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param method new pitch detection algorithm
+  \param buf_size new size of the input buffer to analyse
+  \param hop_size new step size between two consecutive analysis instant
+
+  \return 0 if successful, non-zero otherwise, in which case `o` is left
+  unchanged
+
+  After this call, `o` is the object new_aubio_pitch() would have created
+  with these arguments and the samplerate of `o`, in its default unit and
+  with the default parameters of `method`. The previous objects are only
+  deleted once the new ones are created, so that the windows and FFT plans
+  of the same sizes are reused. The objects of the other channels of
+  aubio_pitch_do_multi() are created again on its next call.
+
+*/
+uint_t aubio_pitch_reconfigure (aubio_pitch_t * o, const char_t * method,
+    uint_t buf_size, uint_t hop_size);
+
+/** get the memory used by a pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  The objects analysing the channels of aubio_pitch_do_multi() are included.
+
+*/
+uint_t aubio_pitch_get_memory_usage (const aubio_pitch_t * o);
+
 /** deletion of the pitch detection object
 
   \param o pitch detection object as returned by new_aubio_pitch()
@@ -181,6 +391,57 @@ uint_t aubio_pitch_set_silence (aubio_pitch_t * o, smpl_t silence);
 */
 smpl_t aubio_pitch_get_silence (aubio_pitch_t * o);
 
+/** enable or disable silence gating
+
+  \param o pitch detection object as returned by ::new_aubio_pitch()
+  \param gating 1 to enable, 0 to disable [0]
+
+  \return 0 if successful, non-zero otherwise
+
+  When enabled, the level of each hop is checked first. Hops under the
+  silence threshold, for which the pitch would be 0, are given to
+  aubio_pitch_skip() instead of running the detection. The confidence then
+  keeps the value of the last analysed hop.
+
+*/
+uint_t aubio_pitch_set_gating (aubio_pitch_t * o, uint_t gating);
+
+/** get silence gating mode
+
+  \param o pitch detection object as returned by ::new_aubio_pitch()
+
+  \return 1 if silence gating is enabled, 0 otherwise
+
+*/
+uint_t aubio_pitch_get_gating (const aubio_pitch_t * o);
+
+/** enable or disable deferred parameter updates
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param deferred 1 to enable, 0 to disable [0]
+
+  \return 0 if successful, non-zero otherwise
+
+  In this mode, aubio_pitch_set_tolerance() and aubio_pitch_set_silence()
+  can be called from another thread than the one running aubio_pitch_do().
+  They check and post their value, which aubio_pitch_do() applies before
+  processing its next hop, without taking any lock. Set the mode before the
+  object is used from several threads.
+
+  \sa aubio_onset_set_deferred()
+
+*/
+uint_t aubio_pitch_set_deferred (aubio_pitch_t * o, uint_t deferred);
+
+/** get deferred parameter updates mode
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+
+  \return 1 if parameter updates are deferred, 0 otherwise
+
+*/
+uint_t aubio_pitch_get_deferred (const aubio_pitch_t * o);
+
 /** get the current confidence
 
   \param o pitch detection object as returned by new_aubio_pitch()
@@ -190,6 +451,27 @@ smpl_t aubio_pitch_get_silence (aubio_pitch_t * o);
 */
 smpl_t aubio_pitch_get_confidence (aubio_pitch_t * o);
 
+/** get the best pitch candidates of the last analysed frame
+
+  \param o pitch detection object as returned by new_aubio_pitch()
+  \param candidates output, 2 rows of at least 1 column; for each candidate,
+  best first, row 0 gets its pitch in the unit set with
+  aubio_pitch_set_unit(), and row 1 its confidence
+
+  \return number of candidates written, at most `candidates->length`, or 0
+  if the method is not one of `yin`, `yinfast` and `yinfft`
+
+  The candidates are the deepest local minima of the YIN function of the
+  last frame, interpolated, so that an ambiguous frame, for instance one
+  with an octave error, lists the other periods it could have picked. They
+  are not affected by the silence threshold. With `yin` and `yinfast`, the
+  YIN function is only computed up to the first period found under the
+  tolerance, so that no longer period gets listed, unless the tracker is
+  enabled with aubio_pitch_set_tracking().
+
+*/
+uint_t aubio_pitch_get_candidates (aubio_pitch_t * o, fmat_t * candidates);
+
 #ifdef __cplusplus
 }
 #endif
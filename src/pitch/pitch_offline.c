@@ -0,0 +1,341 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "pitch/pitch.h"
+#include "notes/notes.h"
+#include "pitch/pitch_offline.h"
+#include "utils/offline_priv.h"
+#include "io/iothread_priv.h"
+
+/** default length of the chunks, in seconds */
+#define AUBIO_PITCH_OFFLINE_CHUNK_S 30.
+
+/** hops analysed before the start of a chunk, on top of the window, for the
+  filters and the tracker to settle */
+#define AUBIO_PITCH_OFFLINE_CONTEXT 32
+
+/** seconds analysed before the start of a chunk for `notes`, so that the
+  level and the pitch of the note being played are known */
+#define AUBIO_PITCH_OFFLINE_NOTES_CONTEXT_S 2.
+
+typedef enum {
+  aubio_pitch_offline_pitch,
+  aubio_pitch_offline_notes,
+} aubio_pitch_offline_analysis_t;
+
+struct _aubio_pitch_offline_t {
+  aubio_pitch_offline_analysis_t analysis;
+  char_t *method;
+  uint_t buf_size;
+  uint_t hop_size;
+  uint_t samplerate;
+  uint_t threads;
+  smpl_t chunk_s;
+  smpl_t tolerance;             /**< only set if has_tolerance */
+  uint_t has_tolerance;
+  smpl_t silence;               /**< only set if has_silence */
+  uint_t has_silence;
+
+  smpl_t *data;                 /**< results of the last run */
+  smpl_t **rows;                /**< pointers to the rows of data */
+  uint_t size;                  /**< number of rows allocated in data */
+  fmat_t view;                  /**< results, as returned by get_results */
+  uint_t run_samplerate;        /**< samplerate the file is read at */
+};
+
+aubio_pitch_offline_t *new_aubio_pitch_offline (const char_t *analysis,
+    const char_t *method, uint_t buf_size, uint_t hop_size,
+    uint_t samplerate)
+{
+  aubio_pitch_offline_t *o = AUBIO_NEW(aubio_pitch_offline_t);
+  if (!o) return NULL;
+  if (!analysis) {
+    AUBIO_ERR("pitch_offline: analysis should not be NULL\n");
+    goto beach;
+  } else if (strcmp(analysis, "pitch") == 0) {
+    o->analysis = aubio_pitch_offline_pitch;
+  } else if (strcmp(analysis, "notes") == 0) {
+    o->analysis = aubio_pitch_offline_notes;
+  } else {
+    AUBIO_ERR("pitch_offline: unknown analysis %s\n", analysis);
+    goto beach;
+  }
+  if ((sint_t)hop_size < 1 || (sint_t)buf_size < (sint_t)hop_size) {
+    AUBIO_ERR("pitch_offline: got buf_size %d and hop_size %d, expected"
+        " buf_size >= hop_size > 0\n", buf_size, hop_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 0) {
+    AUBIO_ERR("pitch_offline: got samplerate %d, expected >= 0\n",
+        samplerate);
+    goto beach;
+  }
+  if (!method) method = "default";
+  o->method = AUBIO_ARRAY(char_t, strnlen(method, PATH_MAX) + 1);
+  if (!o->method) goto beach;
+  strncpy(o->method, method, strnlen(method, PATH_MAX) + 1);
+  o->buf_size = buf_size;
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+  o->threads = aubio_threads_get_pool_size();
+  o->chunk_s = AUBIO_PITCH_OFFLINE_CHUNK_S;
+  o->view.length = o->analysis == aubio_pitch_offline_notes ? 4 : 3;
+  return o;
+
+beach:
+  del_aubio_pitch_offline(o);
+  return NULL;
+}
+
+uint_t aubio_pitch_offline_set_threads (aubio_pitch_offline_t *o,
+    uint_t threads)
+{
+  o->threads = threads ? threads : aubio_threads_get_pool_size();
+  return AUBIO_OK;
+}
+
+uint_t aubio_pitch_offline_get_threads (const aubio_pitch_offline_t *o)
+{
+  return o->threads;
+}
+
+uint_t aubio_pitch_offline_set_chunk_s (aubio_pitch_offline_t *o,
+    smpl_t chunk)
+{
+  if (!(chunk > 0.)) {
+    AUBIO_ERR("pitch_offline: chunks of %.3fs should be longer than 0s\n",
+        chunk);
+    return AUBIO_FAIL;
+  }
+  o->chunk_s = chunk;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_pitch_offline_get_chunk_s (const aubio_pitch_offline_t *o)
+{
+  return o->chunk_s;
+}
+
+uint_t aubio_pitch_offline_set_tolerance (aubio_pitch_offline_t *o,
+    smpl_t tolerance)
+{
+  if (o->analysis == aubio_pitch_offline_notes) {
+    AUBIO_ERR("pitch_offline: notes have no tolerance\n");
+    return AUBIO_FAIL;
+  }
+  o->tolerance = tolerance;
+  o->has_tolerance = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_pitch_offline_set_silence (aubio_pitch_offline_t *o,
+    smpl_t silence)
+{
+  o->silence = silence;
+  o->has_silence = 1;
+  return AUBIO_OK;
+}
+
+/* pitch object with the parameters of o */
+static aubio_pitch_t *aubio_pitch_offline_new_pitch (
+    const aubio_pitch_offline_t *o)
+{
+  aubio_pitch_t *pitch = new_aubio_pitch(o->method, o->buf_size, o->hop_size,
+      o->run_samplerate);
+  if (!pitch) return NULL;
+  if (o->has_tolerance) aubio_pitch_set_tolerance(pitch, o->tolerance);
+  if (o->has_silence) aubio_pitch_set_silence(pitch, o->silence);
+  return pitch;
+}
+
+/* notes object with the parameters of o */
+static aubio_notes_t *aubio_pitch_offline_new_notes (
+    const aubio_pitch_offline_t *o)
+{
+  aubio_notes_t *notes = new_aubio_notes(o->method, o->buf_size, o->hop_size,
+      o->run_samplerate);
+  if (!notes) return NULL;
+  if (o->has_silence) aubio_notes_set_silence(notes, o->silence);
+  return notes;
+}
+
+/* analyse a chunk of the file, from a little before its start to its end,
+   keeping one row per hop of the chunk for pitch, and the note-on and
+   note-off events of the chunk for notes */
+static uint_t aubio_pitch_offline_analyse (void *data, aubio_source_t *source,
+    fvec_t *in, aubio_offline_chunk_t *c)
+{
+  aubio_pitch_offline_t *o = (aubio_pitch_offline_t *)data;
+  aubio_pitch_t *pitch = NULL;
+  aubio_notes_t *notes = NULL;
+  fvec_t *out = new_fvec(3);
+  uint_t read = 0, err = AUBIO_FAIL;
+  lsmp_t *row;
+  if (!out) goto beach;
+  if (o->analysis == aubio_pitch_offline_notes) {
+    if (!(notes = aubio_pitch_offline_new_notes(o))) goto beach;
+  } else {
+    if (!(pitch = aubio_pitch_offline_new_pitch(o))) goto beach;
+  }
+  do {
+    aubio_source_do(source, in, &read);
+    if (notes) {
+      aubio_notes_do(notes, in, out);
+      if ((out->data[0] != 0 || out->data[2] != 0) && c->total >= c->start) {
+        // time, note-on, velocity and note-off of the event
+        if (!(row = aubio_offline_chunk_add(c))) goto beach;
+        row[0] = c->total;
+        row[1] = out->data[0];
+        row[2] = out->data[1];
+        row[3] = out->data[2];
+      }
+    } else {
+      aubio_pitch_do(pitch, in, out);
+      if (c->total >= c->start) {
+        if (!(row = aubio_offline_chunk_add(c))) goto beach;
+        row[0] = c->total;
+        row[1] = out->data[0];
+        row[2] = aubio_pitch_get_confidence(pitch);
+      }
+    }
+    c->total += read;
+  } while (read == o->hop_size && c->total < c->stop);
+  err = AUBIO_OK;
+
+beach:
+  if (pitch) del_aubio_pitch(pitch);
+  if (notes) del_aubio_notes(notes);
+  if (out) del_fvec(out);
+  return err;
+}
+
+/* append a row to the results, or return NULL if it failed */
+static smpl_t *aubio_pitch_offline_add (aubio_pitch_offline_t *o)
+{
+  uint_t width = o->view.length;
+  if (o->view.height == o->size) {
+    uint_t size = MAX(16, 2 * o->size);
+    smpl_t *results = (smpl_t *)AUBIO_REALLOC(o->data,
+        size * width * sizeof(smpl_t));
+    if (!results) return NULL;
+    o->data = results;
+    o->size = size;
+  }
+  return o->data + width * o->view.height++;
+}
+
+/* join the rows of the chunks; for notes, turn the events into notes as a
+   single pass would, a note ending at the next note-off or at the end of
+   the file */
+static uint_t aubio_pitch_offline_join (aubio_pitch_offline_t *o,
+    const aubio_offline_t *offline)
+{
+  const aubio_offline_chunk_t *c = NULL;
+  uint_t k, i, width = o->view.length;
+  uint_t n_chunks = aubio_offline_get_n_chunks(offline);
+  sint_t note = -1;             /**< row of the note being played, if any */
+  smpl_t sr = (smpl_t)o->run_samplerate, *row, **rows;
+  const lsmp_t *event;
+  for (k = 0; k < n_chunks; k++) {
+    c = aubio_offline_get_chunk(offline, k);
+    for (i = 0; i < c->n_rows; i++) {
+      event = c->rows + i * c->width;
+      if (o->analysis == aubio_pitch_offline_pitch) {
+        if (!(row = aubio_pitch_offline_add(o))) return AUBIO_FAIL;
+        row[0] = event[0] / sr;
+        row[1] = event[1];
+        row[2] = event[2];
+        continue;
+      }
+      if (event[3] != 0 && note >= 0) {
+        // end of the current note
+        o->data[width * note + 3] = event[0] / sr;
+        note = -1;
+      }
+      if (event[1] != 0) {
+        if (!(row = aubio_pitch_offline_add(o))) return AUBIO_FAIL;
+        row[0] = event[1];
+        row[1] = event[2];
+        row[2] = event[0] / sr;
+        row[3] = row[2];
+        note = o->view.height - 1;
+      }
+    }
+  }
+  if (note >= 0) {
+    o->data[width * note + 3] = c->total / sr;
+  }
+  rows = (smpl_t **)AUBIO_REALLOC(o->rows, MAX(1, o->view.height)
+      * sizeof(smpl_t *));
+  if (!rows) return AUBIO_FAIL;
+  o->rows = rows;
+  for (i = 0; i < o->view.height; i++) {
+    o->rows[i] = o->data + i * width;
+  }
+  o->view.data = o->rows;
+  return AUBIO_OK;
+}
+
+uint_t aubio_pitch_offline_do (aubio_pitch_offline_t *o, const char_t *uri)
+{
+  aubio_offline_t *offline;
+  uint_t warmup, err = AUBIO_FAIL;
+  o->view.height = 0;
+  offline = new_aubio_offline("pitch_offline", uri, o->samplerate,
+      o->hop_size, o->view.length);
+  if (!offline) return AUBIO_FAIL;
+  o->run_samplerate = aubio_offline_get_samplerate(offline);
+  warmup = o->buf_size + AUBIO_PITCH_OFFLINE_CONTEXT * o->hop_size;
+  if (o->analysis == aubio_pitch_offline_notes) {
+    warmup += (uint_t)(AUBIO_PITCH_OFFLINE_NOTES_CONTEXT_S
+        * o->run_samplerate);
+  }
+  // the frames are reported at their own hop, nothing is read after a chunk
+  if (aubio_offline_run(offline, o->chunk_s, o->threads, warmup, 0,
+        aubio_pitch_offline_analyse, o)) goto beach;
+  err = aubio_pitch_offline_join(o, offline);
+
+beach:
+  if (err) o->view.height = 0;
+  del_aubio_offline(offline);
+  return err;
+}
+
+const fmat_t *aubio_pitch_offline_get_results (const aubio_pitch_offline_t *o)
+{
+  return &o->view;
+}
+
+void del_aubio_pitch_offline (aubio_pitch_offline_t *o)
+{
+  AUBIO_ASSERT(o);
+  if (o->method)
+    AUBIO_FREE(o->method);
+  if (o->data)
+    AUBIO_FREE(o->data);
+  if (o->rows)
+    AUBIO_FREE(o->rows);
+  AUBIO_FREE(o);
+}
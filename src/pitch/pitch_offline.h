@@ -0,0 +1,174 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_PITCH_OFFLINE_H
+#define AUBIO_PITCH_OFFLINE_H
+
+/** \file
+
+  Pitch and notes extraction of a whole file on a pool of threads
+
+  This object extracts the pitch track or the notes of a single file, as a
+  loop over ::aubio_pitch_do or ::aubio_notes_do would, but splits the file
+  into chunks analysed in parallel, as ::aubio_onset_offline_t does.
+
+  The following analysis are available, with the rows of ::aubio_batch_t:
+
+    - `pitch`: one row per hop, holding its time in seconds, the fundamental
+      frequency in Hz, and its confidence
+    - `notes`: one row per note, holding its midi value, velocity, start and
+      end time in seconds
+
+  Each chunk is analysed from a little before its start. For `pitch`, this
+  is long enough for the window and the filters to reach the state they would
+  have in a single pass, and the rows of each chunk are those of a single
+  pass. For `notes`, the chunks are analysed from a couple of seconds before
+  their start, so that the level and the pitch of the note being played are
+  known, and the notes of the chunks are joined in order, a note ending in
+  the chunk after the one it starts in. They match those of a single pass,
+  unless a note is held through the whole context.
+
+  \example pitch/test-pitch_offline.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** offline pitch and notes extraction object */
+typedef struct _aubio_pitch_offline_t aubio_pitch_offline_t;
+
+/** create offline pitch and notes extraction object
+
+  \param analysis `pitch` or `notes`
+  \param method pitch detection method, see ::new_aubio_pitch and
+  ::new_aubio_notes
+  \param buf_size buffer size of the analysis
+  \param hop_size hop size of the analysis
+  \param samplerate samplerate to read the files at, or 0 to read each file
+  at its own samplerate
+
+  \return newly created ::aubio_pitch_offline_t, or NULL on failure
+
+*/
+aubio_pitch_offline_t *new_aubio_pitch_offline (const char_t *analysis,
+    const char_t *method, uint_t buf_size, uint_t hop_size,
+    uint_t samplerate);
+
+/** set number of threads
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+  \param threads number of threads, or 0 for aubio_threads_get_pool_size()
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitch_offline_set_threads (aubio_pitch_offline_t *o,
+    uint_t threads);
+
+/** get number of threads
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+
+  \return number of threads used by ::aubio_pitch_offline_do
+
+*/
+uint_t aubio_pitch_offline_get_threads (const aubio_pitch_offline_t *o);
+
+/** set length of the chunks
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+  \param chunk length of each chunk, in seconds, 30 by default
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitch_offline_set_chunk_s (aubio_pitch_offline_t *o,
+    smpl_t chunk);
+
+/** get length of the chunks
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+
+  \return length of each chunk, in seconds
+
+*/
+smpl_t aubio_pitch_offline_get_chunk_s (const aubio_pitch_offline_t *o);
+
+/** set tolerance of the pitch detection, see ::aubio_pitch_set_tolerance
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+  \param tolerance tolerance of the pitch detection, for `pitch` only
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitch_offline_set_tolerance (aubio_pitch_offline_t *o,
+    smpl_t tolerance);
+
+/** set silence threshold, see ::aubio_pitch_set_silence and
+  ::aubio_notes_set_silence
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+  \param silence silence threshold, in dB
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pitch_offline_set_silence (aubio_pitch_offline_t *o,
+    smpl_t silence);
+
+/** extract the pitch track or the notes of a file
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+  \param uri path of the file to analyse
+
+  \return 0 if successful, non-zero otherwise
+
+  This function returns once the whole file was analysed. The results are
+  then available from ::aubio_pitch_offline_get_results.
+
+*/
+uint_t aubio_pitch_offline_do (aubio_pitch_offline_t *o, const char_t *uri);
+
+/** get the results of the last call to ::aubio_pitch_offline_do
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+
+  \return one row per hop or per note, in increasing time; `height` is the
+  number of rows, and may be 0. The matrix belongs to `o` and is valid until
+  the next call to ::aubio_pitch_offline_do.
+
+*/
+const fmat_t *aubio_pitch_offline_get_results (const aubio_pitch_offline_t *o);
+
+/** delete offline pitch and notes extraction object
+
+  \param o offline pitch object, created by ::new_aubio_pitch_offline
+
+*/
+void del_aubio_pitch_offline (aubio_pitch_offline_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_PITCH_OFFLINE_H */
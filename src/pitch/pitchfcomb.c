@@ -24,7 +24,10 @@
 #include "cvec.h"
 #include "mathutils.h"
 #include "musicutils.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
+#include "mathutils_priv.h"
 #include "pitch/pitchfcomb.h"
 
 #define MAX_PEAKS 8
@@ -32,6 +35,7 @@
 typedef struct
 {
   smpl_t bin;
+  smpl_t norm;
   smpl_t db;
 } aubio_fpeak_t;
 
@@ -41,9 +45,10 @@ struct _aubio_pitchfcomb_t
   uint_t stepSize;
   uint_t rate;
   fvec_t *winput;
-  fvec_t *win;
+  const fvec_t *win;
   cvec_t *fftOut;
   fvec_t *fftLastPhase;
+  fvec_t *phaseAdvance;   /**< expected phase advance of each bin, in [0, 2pi) */
   aubio_fft_t *fft;
 };
 
@@ -51,6 +56,7 @@ aubio_pitchfcomb_t *
 new_aubio_pitchfcomb (uint_t bufsize, uint_t hopsize)
 {
   aubio_pitchfcomb_t *p = AUBIO_NEW (aubio_pitchfcomb_t);
+  uint_t k;
   
   if (!p) {
     return NULL;
@@ -62,7 +68,12 @@ new_aubio_pitchfcomb (uint_t bufsize, uint_t hopsize)
   p->winput = new_fvec (bufsize);
   p->fftOut = new_cvec (bufsize);
   p->fftLastPhase = new_fvec (bufsize);
-  p->win = new_aubio_window ("hanning", bufsize);
+  p->phaseAdvance = new_fvec (bufsize / 2 + 1);
+  for (k = 0; k < p->phaseAdvance->length; k++) {
+    // reduce k * hopsize modulo bufsize first to keep the precision
+    p->phaseAdvance->data[k] = TWO_PI * ((k * hopsize) % bufsize) / bufsize;
+  }
+  p->win = aubio_window_acquire ("hanning", bufsize);
   return p;
 
 beach:
@@ -73,49 +84,58 @@ beach:
 /* input must be stepsize long */
 void
 aubio_pitchfcomb_do (aubio_pitchfcomb_t * p, const fvec_t * input, fvec_t * output)
+{
+  uint_t k;
+  for (k = 0; k < input->length; k++) {
+    p->winput->data[k] = p->win->data[k] * input->data[k];
+  }
+  aubio_fft_do (p->fft, p->winput, p->fftOut);
+  aubio_pitchfcomb_do_spectrum (p, p->fftOut, output);
+}
+
+void
+aubio_pitchfcomb_do_spectrum (aubio_pitchfcomb_t * p, const cvec_t * fftgrain,
+    fvec_t * output)
 {
   uint_t k, l, maxharm = 0;
-  smpl_t phaseDifference = TWO_PI * (smpl_t) p->stepSize / (smpl_t) p->fftSize;
+  const uint_t length = p->fftSize / 2 + 1;
+  const smpl_t *norm = fftgrain->norm, *phas = fftgrain->phas;
+  const smpl_t *lastPhase = p->fftLastPhase->data;
+  const smpl_t *phaseAdvance = p->phaseAdvance->data;
+  const smpl_t devScale = p->fftSize / (smpl_t) p->stepSize / TWO_PI;
   aubio_fpeak_t peaks[MAX_PEAKS];
 
+  // magnitudes are compared before conversion to dB, from -200 dB
   for (k = 0; k < MAX_PEAKS; k++) {
-    peaks[k].db = -200.;
+    peaks[k].norm = 1.e-10 * p->fftSize / 2.;
     peaks[k].bin = 0.;
   }
 
-  for (k = 0; k < input->length; k++) {
-    p->winput->data[k] = p->win->data[k] * input->data[k];
-  }
-  aubio_fft_do (p->fft, p->winput, p->fftOut);
-
-  for (k = 0; k <= p->fftSize / 2; k++) {
-    smpl_t
-        magnitude =
-        20. * LOG10 (2. * p->fftOut->norm[k] / (smpl_t) p->fftSize),
-        phase = p->fftOut->phas[k], tmp, bin;
+  for (k = 0; k < length; k++) {
+    smpl_t tmp, bin;
+    // only bins louder than the current peak need their true frequency
+    if (!(norm[k] > peaks[0].norm)) continue;
 
-    /* compute phase difference */
-    tmp = phase - p->fftLastPhase->data[k];
-    p->fftLastPhase->data[k] = phase;
-
-    /* subtract expected phase difference */
-    tmp -= (smpl_t) k *phaseDifference;
+    /* compute phase difference, minus the expected one */
+    tmp = phas[k] - lastPhase[k] - phaseAdvance[k];
 
     /* map delta phase into +/- Pi interval */
     tmp = aubio_unwrap2pi (tmp);
 
-    /* get deviation from bin frequency from the +/- Pi interval */
-    tmp = p->fftSize / (smpl_t) p->stepSize * tmp / (TWO_PI);
-
-    /* compute the k-th partials' true bin */
-    bin = (smpl_t) k + tmp;
+    /* compute the k-th partials' true bin, from its deviation */
+    bin = (smpl_t) k + devScale * tmp;
 
-    if (bin > 0.0 && magnitude > peaks[0].db) {       // && magnitude < 0) {
+    if (bin > 0.0) {
       memmove (peaks + 1, peaks, sizeof (aubio_fpeak_t) * (MAX_PEAKS - 1));
       peaks[0].bin = bin;
-      peaks[0].db = magnitude;
+      peaks[0].norm = norm[k];
     }
   }
+  AUBIO_MEMCPY (p->fftLastPhase->data, phas, length * sizeof(smpl_t));
+
+  for (k = 0; k < MAX_PEAKS; k++) {
+    peaks[k].db = 20. * LOG10 (2. * peaks[k].norm / (smpl_t) p->fftSize);
+  }
 
   k = 0;
   for (l = 1; l < MAX_PEAKS && peaks[l].bin > 0.0; l++) {
@@ -141,8 +161,18 @@ del_aubio_pitchfcomb (aubio_pitchfcomb_t * p)
 {
   del_cvec (p->fftOut);
   del_fvec (p->fftLastPhase);
-  del_fvec (p->win);
+  del_fvec (p->phaseAdvance);
+  aubio_window_release (p->win);
   del_fvec (p->winput);
   del_aubio_fft (p->fft);
   AUBIO_FREE (p);
 }
+
+uint_t
+aubio_pitchfcomb_get_memory_usage (const aubio_pitchfcomb_t * p)
+{
+  /* the window is shared */
+  return aubio_malloc_size (p) + aubio_malloc_size (p->fftOut)
+    + aubio_malloc_size (p->fftLastPhase) + aubio_malloc_size (p->phaseAdvance)
+    + aubio_malloc_size (p->winput) + aubio_fft_get_memory_usage (p->fft);
+}
@@ -54,6 +54,20 @@ typedef struct _aubio_pitchfcomb_t aubio_pitchfcomb_t;
 void aubio_pitchfcomb_do (aubio_pitchfcomb_t * p, const fvec_t * input,
     fvec_t * output);
 
+/** execute pitch detection on a precomputed spectrum
+
+  \param p pitch detection object as returned by new_aubio_pitchfcomb
+  \param fftgrain spectrum of the input buffer, as computed by aubio_pvoc_do()
+  with a window of the same length
+  \param output pitch candidates in bins
+
+  Only phase differences between consecutive spectra are used, so the
+  circular shift applied by the phase vocoder does not change the result.
+
+*/
+void aubio_pitchfcomb_do_spectrum (aubio_pitchfcomb_t * p,
+    const cvec_t * fftgrain, fvec_t * output);
+
 /** creation of the pitch detection object
 
   \param buf_size size of the input buffer to analyse
@@ -62,6 +76,16 @@ void aubio_pitchfcomb_do (aubio_pitchfcomb_t * p, const fvec_t * input,
 */
 aubio_pitchfcomb_t *new_aubio_pitchfcomb (uint_t buf_size, uint_t hop_size);
 
+/** get the memory used by the pitch detection object
+
+  \param p pitch detection object as returned by new_aubio_pitchfcomb
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_pitchfcomb_get_memory_usage (const aubio_pitchfcomb_t * p);
+
 /** deletion of the pitch detection object
 
   \param p pitch detection object as returned by new_aubio_pitchfcomb
@@ -24,37 +24,16 @@
 #include "mathutils.h"
 #include "pitch/pitchmcomb.h"
 
-#define CAND_SWAP(a,b) { register aubio_spectralcandidate_t *t=(a);(a)=(b);(b)=t; }
-
 typedef struct _aubio_spectralpeak_t aubio_spectralpeak_t;
 typedef struct _aubio_spectralcandidate_t aubio_spectralcandidate_t;
 uint_t aubio_pitchmcomb_get_root_peak (aubio_spectralpeak_t * peaks,
     uint_t length);
 uint_t aubio_pitchmcomb_quadpick (aubio_spectralpeak_t * spectral_peaks,
     const fvec_t * X);
+uint_t aubio_pitchmcomb_get_closest_peak (aubio_spectralpeak_t * peaks,
+    uint_t length, smpl_t ebin);
 void aubio_pitchmcomb_spectral_pp (aubio_pitchmcomb_t * p, const fvec_t * oldmag);
 void aubio_pitchmcomb_combdet (aubio_pitchmcomb_t * p, const fvec_t * newmag);
-/* not used but useful : sort by amplitudes (or anything else)
- * sort_pitchpeak(peaks, length);
- */
-#if 0
-/** spectral_peak comparison function (must return signed int) */
-static sint_t aubio_pitchmcomb_sort_peak_comp (const void *x, const void *y);
-/** sort spectral_peak against their mag */
-void aubio_pitchmcomb_sort_peak (aubio_spectralpeak_t * peaks, uint_t nbins);
-/** select the best candidates */
-uint_t aubio_pitch_cands (aubio_pitchmcomb_t * p, const cvec_t * fftgrain,
-    smpl_t * cands);
-#endif
-
-/** sort spectral_candidate against their comb ene */
-void aubio_pitchmcomb_sort_cand_ene (aubio_spectralcandidate_t ** candidates,
-    uint_t nbins);
-#if 0
-/** sort spectral_candidate against their frequency */
-void aubio_pitchmcomb_sort_cand_freq (aubio_spectralcandidate_t ** candidates,
-    uint_t nbins);
-#endif
 
 struct _aubio_pitchmcomb_t
 {
@@ -71,7 +50,8 @@ struct _aubio_pitchmcomb_t
   uint_t goodcandidate;                    /**< best candidate                       */
   uint_t spec_partition;                   /**< spectrum partition to consider       */
   aubio_spectralpeak_t *peaks;             /**< up to length win/spec_partition      */
-  aubio_spectralcandidate_t **candidates;  /** up to five candidates                 */
+  aubio_spectralcandidate_t *candidates;   /** up to five candidates                 */
+  smpl_t *combs;                           /**< ncand combs of npartials each        */
   /* some scratch pads */
   /** \bug  (unnecessary copied from fftgrain?) */
   fvec_t *newmag;                          /**< vec to store mag                     */
@@ -98,7 +78,7 @@ struct _aubio_spectralpeak_t
 struct _aubio_spectralcandidate_t
 {
   smpl_t ebin;    /**< interpolated bin */
-  smpl_t *ecomb;  /**< comb */
+  smpl_t *ecomb;  /**< comb, npartials long, in p->combs */
   smpl_t ene;     /**< candidate energy */
   smpl_t len;     /**< length */
 };
@@ -121,7 +101,7 @@ aubio_pitchmcomb_do (aubio_pitchmcomb_t * p, const cvec_t * fftgrain, fvec_t * o
   aubio_pitchmcomb_combdet (p, newmag);
   //aubio_pitchmcomb_sort_cand_freq(p->candidates,p->ncand);
   //return p->candidates[p->goodcandidate]->ebin;
-  j = (uint_t) FLOOR (p->candidates[p->goodcandidate]->ebin + .5);
+  j = (uint_t) FLOOR (p->candidates[p->goodcandidate].ebin + .5);
   instfreq = aubio_unwrap2pi (fftgrain->phas[j]
       - p->theta->data[j] - j * p->phasediff);
   instfreq *= p->phasefreq;
@@ -131,45 +111,12 @@ aubio_pitchmcomb_do (aubio_pitchmcomb_t * p, const cvec_t * fftgrain, fvec_t * o
   }
   //return p->candidates[p->goodcandidate]->ebin;
   output->data[0] =
-      FLOOR (p->candidates[p->goodcandidate]->ebin + .5) + instfreq;
+      FLOOR (p->candidates[p->goodcandidate].ebin + .5) + instfreq;
   /*} else {
      return -1.;
      } */
 }
 
-#if 0
-uint_t
-aubio_pitch_cands (aubio_pitchmcomb_t * p, const cvec_t * fftgrain, smpl_t * cands)
-{
-  uint_t j;
-  uint_t k;
-  fvec_t *newmag = (fvec_t *) p->newmag;
-  aubio_spectralcandidate_t **scands =
-      (aubio_spectralcandidate_t **) (p->candidates);
-  //smpl_t hfc; //fe=instfreq(theta1,theta,ops); //theta1=theta;
-  /* copy incoming grain to newmag */
-  for (j = 0; j < newmag->length; j++)
-    newmag->data[j] = fftgrain->norm[j];
-  /* detect only if local energy > 10. */
-  if (aubio_level_lin (newmag) * newmag->length > 10.) {
-    /* hfc = fvec_local_hfc(newmag); do not use */
-    aubio_pitchmcomb_spectral_pp (p, newmag);
-    aubio_pitchmcomb_combdet (p, newmag);
-    aubio_pitchmcomb_sort_cand_freq (scands, p->ncand);
-    /* store ncand comb energies in cands[1:ncand] */
-    for (k = 0; k < p->ncand; k++)
-      cands[k] = p->candidates[k]->ene;
-    /* store ncand[end] freq in cands[end] */
-    cands[p->ncand] = p->candidates[p->ncand - 1]->ebin;
-    return 1;
-  } else {
-    for (k = 0; k < p->ncand; k++)
-      cands[k] = 0;
-    return 0;
-  }
-}
-#endif
-
 void
 aubio_pitchmcomb_spectral_pp (aubio_pitchmcomb_t * p, const fvec_t * newmag)
 {
@@ -194,9 +141,6 @@ aubio_pitchmcomb_spectral_pp (aubio_pitchmcomb_t * p, const fvec_t * newmag)
     count = aubio_pitchmcomb_quadpick (peaks, mag);
     for (j = 0; j < count; j++)
       peaks[j].mag = newmag->data[peaks[j].bin];
-    /* reset non peaks */
-    for (j = count; j < length; j++)
-      peaks[j].mag = 0.;
     p->peaks = peaks;
     p->count = count;
   }
@@ -206,8 +150,7 @@ void
 aubio_pitchmcomb_combdet (aubio_pitchmcomb_t * p, const fvec_t * newmag)
 {
   aubio_spectralpeak_t *peaks = (aubio_spectralpeak_t *) p->peaks;
-  aubio_spectralcandidate_t **candidate =
-      (aubio_spectralcandidate_t **) p->candidates;
+  aubio_spectralcandidate_t *candidate = p->candidates;
 
   /* parms */
   uint_t N = p->npartials;      /* maximum number of partials to be considered 10 */
@@ -216,10 +159,8 @@ aubio_pitchmcomb_combdet (aubio_pitchmcomb_t * p, const fvec_t * newmag)
   uint_t count = p->count;
   uint_t k;
   uint_t l;
-  uint_t d;
   uint_t curlen = 0;
 
-  smpl_t delta2;
   smpl_t xx;
   uint_t position = 0;
 
@@ -235,49 +176,49 @@ aubio_pitchmcomb_combdet (aubio_pitchmcomb_t * p, const fvec_t * newmag)
   /* now calculate the energy of each of the 5 combs */
   for (l = 0; l < M; l++) {
     smpl_t scaler = (1. / (l + 1.));
-    candidate[l]->ene = 0.;     /* reset ene and len sums */
-    candidate[l]->len = 0.;
-    candidate[l]->ebin = scaler * peaks[root_peak].ebin;
+    aubio_spectralcandidate_t *c = candidate + l;
+    c->ene = 0.;     /* reset ene and len sums */
+    c->len = 0.;
+    c->ebin = scaler * peaks[root_peak].ebin;
     /* if less than N peaks available, curlen < N */
-    if (candidate[l]->ebin != 0.)
-      curlen = (uint_t) FLOOR (length / (candidate[l]->ebin));
+    if (c->ebin != 0.)
+      curlen = (uint_t) FLOOR (length / (c->ebin));
     curlen = (N < curlen) ? N : curlen;
-    /* fill candidate[l]->ecomb[k] with (k+1)*candidate[l]->ebin */
+    /* fill c->ecomb[k] with (k+1)*c->ebin */
     for (k = 0; k < curlen; k++)
-      candidate[l]->ecomb[k] = (candidate[l]->ebin) * (k + 1.);
-    for (k = curlen; k < length; k++)
-      candidate[l]->ecomb[k] = 0.;
-    /* for each in candidate[l]->ecomb[k] */
+      c->ecomb[k] = (c->ebin) * (k + 1.);
+    for (k = curlen; k < N; k++)
+      c->ecomb[k] = 0.;
+    /* for each in c->ecomb[k] */
     for (k = 0; k < curlen; k++) {
-      xx = 100000.;
-      /** get the candidate->ecomb the closer to peaks.ebin
+      /** get the c->ecomb the closer to peaks.ebin
        * (to cope with the inharmonicity)*/
-      for (d = 0; d < count; d++) {
-        delta2 = ABS (candidate[l]->ecomb[k] - peaks[d].ebin);
-        if (delta2 <= xx) {
-          position = d;
-          xx = delta2;
-        }
+      if (count > 0) {
+        position = aubio_pitchmcomb_get_closest_peak (peaks, count,
+            c->ecomb[k]);
+        xx = ABS (c->ecomb[k] - peaks[position].ebin);
+      } else {
+        xx = 100000.;
       }
       /* for a Q factor of 17, maintaining "constant Q filtering",
        * and sum energy and length over non null combs */
-      if (17. * xx < candidate[l]->ecomb[k]) {
-        candidate[l]->ecomb[k] = peaks[position].ebin;
-        candidate[l]->ene +=    /* ecomb rounded to nearest int */
-            POW (newmag->data[(uint_t) FLOOR (candidate[l]->ecomb[k] + .5)],
+      if (17. * xx < c->ecomb[k]) {
+        c->ecomb[k] = peaks[position].ebin;
+        c->ene +=    /* ecomb rounded to nearest int */
+            POW (newmag->data[(uint_t) FLOOR (c->ecomb[k] + .5)],
             0.25);
-        candidate[l]->len += 1. / curlen;
+        c->len += 1. / curlen;
       } else
-        candidate[l]->ecomb[k] = 0.;
+        c->ecomb[k] = 0.;
     }
     /* punishment */
-    /*if (candidate[l]->len<0.6)
-       candidate[l]->ene=0.; */
+    /*if (c->len<0.6)
+       c->ene=0.; */
     /* remember best candidate energy (in polyphonic, could check for
      * tmpene*1.1 < candidate->ene to reduce jumps towards low frequencies) */
-    if (tmpene < candidate[l]->ene) {
+    if (tmpene < c->ene) {
       tmpl = l;
-      tmpene = candidate[l]->ene;
+      tmpene = c->ene;
     }
   }
   //p->candidates=candidate;
@@ -319,50 +260,27 @@ aubio_pitchmcomb_get_root_peak (aubio_spectralpeak_t * peaks, uint_t length)
   return pos;
 }
 
-#if 0
-void
-aubio_pitchmcomb_sort_peak (aubio_spectralpeak_t * peaks, uint_t nbins)
-{
-  qsort (peaks, nbins, sizeof (aubio_spectralpeak_t),
-      aubio_pitchmcomb_sort_peak_comp);
-}
-
-static sint_t
-aubio_pitchmcomb_sort_peak_comp (const void *x, const void *y)
-{
-  return (((aubio_spectralpeak_t *) y)->mag -
-      ((aubio_spectralpeak_t *) x)->mag);
-}
-
-
-void
-aubio_pitchmcomb_sort_cand_ene (aubio_spectralcandidate_t ** candidates,
-    uint_t nbins)
-{
-  uint_t cur = 0;
-  uint_t run = 0;
-  for (cur = 0; cur < nbins; cur++) {
-    for (run = cur + 1; run < nbins; run++) {
-      if (candidates[run]->ene > candidates[cur]->ene)
-        CAND_SWAP (candidates[run], candidates[cur]);
-    }
-  }
-}
-
-void
-aubio_pitchmcomb_sort_cand_freq (aubio_spectralcandidate_t ** candidates,
-    uint_t nbins)
+/* get the peak closest to ebin, the last one on ties; peaks are at least two
+ * bins apart and sorted by bin, so their interpolated bins are sorted too */
+uint_t
+aubio_pitchmcomb_get_closest_peak (aubio_spectralpeak_t * peaks,
+    uint_t length, smpl_t ebin)
 {
-  uint_t cur = 0;
-  uint_t run = 0;
-  for (cur = 0; cur < nbins; cur++) {
-    for (run = cur + 1; run < nbins; run++) {
-      if (candidates[run]->ebin < candidates[cur]->ebin)
-        CAND_SWAP (candidates[run], candidates[cur]);
-    }
+  uint_t lo = 0, hi = length, mid;
+  /* first peak with peaks[lo].ebin >= ebin */
+  while (lo < hi) {
+    mid = (lo + hi) / 2;
+    if (peaks[mid].ebin < ebin)
+      lo = mid + 1;
+    else
+      hi = mid;
   }
+  if (lo == length)
+    return length - 1;
+  if (lo > 0 && ebin - peaks[lo - 1].ebin < peaks[lo].ebin - ebin)
+    return lo - 1;
+  return lo;
 }
-#endif
 
 aubio_pitchmcomb_t *
 new_aubio_pitchmcomb (uint_t bufsize, uint_t hopsize)
@@ -405,17 +323,17 @@ new_aubio_pitchmcomb (uint_t bufsize, uint_t hopsize)
     p->peaks[i].ebin = 0.;
     p->peaks[i].mag = 0.;
   }
-  /* array of pointers to spectral candidates */
-  p->candidates = AUBIO_ARRAY (aubio_spectralcandidate_t *, p->ncand);
+  /* array of spectral candidates, their combs in a single block */
+  p->candidates = AUBIO_ARRAY (aubio_spectralcandidate_t, p->ncand);
+  p->combs = AUBIO_ARRAY (smpl_t, p->ncand * p->npartials);
+  for (j = 0; j < p->ncand * p->npartials; j++) {
+    p->combs[j] = 0.;
+  }
   for (i = 0; i < p->ncand; i++) {
-    p->candidates[i] = AUBIO_NEW (aubio_spectralcandidate_t);
-    p->candidates[i]->ecomb = AUBIO_ARRAY (smpl_t, spec_size);
-    for (j = 0; j < spec_size; j++) {
-      p->candidates[i]->ecomb[j] = 0.;
-    }
-    p->candidates[i]->ene = 0.;
-    p->candidates[i]->ebin = 0.;
-    p->candidates[i]->len = 0.;
+    p->candidates[i].ecomb = p->combs + i * p->npartials;
+    p->candidates[i].ene = 0.;
+    p->candidates[i].ebin = 0.;
+    p->candidates[i].len = 0.;
   }
   return p;
 }
@@ -424,16 +342,21 @@ new_aubio_pitchmcomb (uint_t bufsize, uint_t hopsize)
 void
 del_aubio_pitchmcomb (aubio_pitchmcomb_t * p)
 {
-  uint_t i;
   del_fvec (p->newmag);
   del_fvec (p->scratch);
   del_fvec (p->theta);
   del_fvec (p->scratch2);
   AUBIO_FREE (p->peaks);
-  for (i = 0; i < p->ncand; i++) {
-    AUBIO_FREE (p->candidates[i]->ecomb);
-    AUBIO_FREE (p->candidates[i]);
-  }
+  AUBIO_FREE (p->combs);
   AUBIO_FREE (p->candidates);
   AUBIO_FREE (p);
 }
+
+uint_t
+aubio_pitchmcomb_get_memory_usage (const aubio_pitchmcomb_t * p)
+{
+  return aubio_malloc_size (p) + aubio_malloc_size (p->newmag)
+    + aubio_malloc_size (p->scratch) + aubio_malloc_size (p->theta)
+    + aubio_malloc_size (p->scratch2) + aubio_malloc_size (p->peaks)
+    + aubio_malloc_size (p->combs) + aubio_malloc_size (p->candidates);
+}
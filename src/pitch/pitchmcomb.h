@@ -63,6 +63,16 @@ void aubio_pitchmcomb_do (aubio_pitchmcomb_t * p, const cvec_t * in_fftgrain,
 */
 aubio_pitchmcomb_t *new_aubio_pitchmcomb (uint_t buf_size, uint_t hop_size);
 
+/** get the memory used by the pitch detection object
+
+  \param p pitch detection object as returned by new_aubio_pitchmcomb
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_pitchmcomb_get_memory_usage (const aubio_pitchmcomb_t * p);
+
 /** deletion of the pitch detection object
 
   \param p pitch detection object as returned by new_aubio_pitchfcomb
@@ -23,16 +23,15 @@
 #include "fvec.h"
 #include "pitch/pitchschmitt.h"
 
-smpl_t aubio_schmittS16LE (aubio_pitchschmitt_t * p, uint_t nframes,
-    signed short int *indata);
+static smpl_t aubio_pitchschmitt_period (aubio_pitchschmitt_t * p);
 
 struct _aubio_pitchschmitt_t
 {
   uint_t blockSize;
   uint_t rate;
-  signed short int *schmittBuffer;
-  signed short int *schmittPointer;
-  signed short int *buf;
+  smpl_t *schmittBuffer;      /**< block being filled */
+  uint_t schmittPos;          /**< number of samples in schmittBuffer */
+  smpl_t period;              /**< period found in the last complete block */
 };
 
 aubio_pitchschmitt_t *
@@ -44,9 +43,9 @@ new_aubio_pitchschmitt (uint_t size)
     return NULL;
   }
   p->blockSize = size;
-  p->schmittBuffer = AUBIO_ARRAY (signed short int, p->blockSize);
-  p->buf = AUBIO_ARRAY (signed short int, p->blockSize);
-  p->schmittPointer = p->schmittBuffer;
+  p->schmittBuffer = AUBIO_ARRAY (smpl_t, p->blockSize);
+  p->schmittPos = 0;
+  p->period = 0.;
   return p;
 }
 
@@ -54,70 +53,69 @@ void
 aubio_pitchschmitt_do (aubio_pitchschmitt_t * p, const fvec_t * input,
     fvec_t * output)
 {
-  uint_t j;
-  for (j = 0; j < input->length; j++) {
-    p->buf[j] = input->data[j] * 32768.;
+  uint_t i = 0, n;
+  // fill the block, and analyse it each time it is complete
+  while (i < input->length) {
+    n = MIN (input->length - i, p->blockSize - p->schmittPos);
+    AUBIO_MEMCPY (p->schmittBuffer + p->schmittPos, input->data + i,
+        n * sizeof(smpl_t));
+    p->schmittPos += n;
+    i += n;
+    if (p->schmittPos == p->blockSize) {
+      p->period = aubio_pitchschmitt_period (p);
+      p->schmittPos = 0;
+    }
   }
-  output->data[0] = aubio_schmittS16LE (p, input->length, p->buf);
+  output->data[0] = p->period;
 }
 
-smpl_t
-aubio_schmittS16LE (aubio_pitchschmitt_t * p, uint_t nframes,
-    signed short int *indata)
+static smpl_t
+aubio_pitchschmitt_period (aubio_pitchschmitt_t * p)
 {
-  uint_t i, j;
+  uint_t j;
   uint_t blockSize = p->blockSize;
-  signed short int *schmittBuffer = p->schmittBuffer;
-  signed short int *schmittPointer = p->schmittPointer;
-
-  smpl_t period = 0., trigfact = 0.6;
-
-  for (i = 0; i < nframes; i++) {
-    *schmittPointer++ = indata[i];
-    if (schmittPointer - schmittBuffer >= (sint_t) blockSize) {
-      sint_t endpoint, startpoint, t1, t2, A1, A2, tc, schmittTriggered;
-
-      schmittPointer = schmittBuffer;
-
-      for (j = 0, A1 = 0, A2 = 0; j < blockSize; j++) {
-        if (schmittBuffer[j] > 0 && A1 < schmittBuffer[j])
-          A1 = schmittBuffer[j];
-        if (schmittBuffer[j] < 0 && A2 < -schmittBuffer[j])
-          A2 = -schmittBuffer[j];
-      }
-      t1 = (sint_t) (A1 * trigfact + 0.5);
-      t2 = -(sint_t) (A2 * trigfact + 0.5);
-      startpoint = 0;
-      for (j = 1; j < blockSize && schmittBuffer[j] <= t1; j++);
-      for (     ; j < blockSize - 1 && !(schmittBuffer[j] >= t2 &&
-             schmittBuffer[j + 1] < t2); j++);
-      startpoint = j;
+  const smpl_t *schmittBuffer = p->schmittBuffer;
+  smpl_t trigfact = 0.6, A1 = 0., A2 = 0., t1, t2;
+  uint_t endpoint, startpoint, tc, schmittTriggered;
+
+  for (j = 0; j < blockSize; j++) {
+    if (A1 < schmittBuffer[j])
+      A1 = schmittBuffer[j];
+    if (A2 < -schmittBuffer[j])
+      A2 = -schmittBuffer[j];
+  }
+  t1 = A1 * trigfact;
+  t2 = -A2 * trigfact;
+  for (j = 1; j < blockSize && schmittBuffer[j] <= t1; j++);
+  for (     ; j + 1 < blockSize && !(schmittBuffer[j] >= t2 &&
+         schmittBuffer[j + 1] < t2); j++);
+  startpoint = j;
+  schmittTriggered = 0;
+  endpoint = startpoint + 1;
+  for (j = startpoint, tc = 0; j + 1 < blockSize; j++) {
+    if (!schmittTriggered) {
+      schmittTriggered = (schmittBuffer[j] >= t1);
+    } else if (schmittBuffer[j] >= t2 && schmittBuffer[j + 1] < t2) {
+      endpoint = j;
+      tc++;
       schmittTriggered = 0;
-      endpoint = startpoint + 1;
-      for (j = startpoint, tc = 0; j < blockSize - 1; j++) {
-        if (!schmittTriggered) {
-          schmittTriggered = (schmittBuffer[j] >= t1);
-        } else if (schmittBuffer[j] >= t2 && schmittBuffer[j + 1] < t2) {
-          endpoint = j;
-          tc++;
-          schmittTriggered = 0;
-        }
-      }
-      if ((endpoint > startpoint) && (tc > 0)) {
-        period = (smpl_t) (endpoint - startpoint) / tc;
-      }
     }
   }
-
-  p->schmittBuffer = schmittBuffer;
-  p->schmittPointer = schmittPointer;
-  return period;
+  if ((endpoint > startpoint) && (tc > 0)) {
+    return (smpl_t) (endpoint - startpoint) / tc;
+  }
+  return 0.;
 }
 
 void
 del_aubio_pitchschmitt (aubio_pitchschmitt_t * p)
 {
   AUBIO_FREE (p->schmittBuffer);
-  AUBIO_FREE (p->buf);
   AUBIO_FREE (p);
 }
+
+uint_t
+aubio_pitchschmitt_get_memory_usage (const aubio_pitchschmitt_t * p)
+{
+  return aubio_malloc_size (p) + aubio_malloc_size (p->schmittBuffer);
+}
@@ -47,9 +47,14 @@ typedef struct _aubio_pitchschmitt_t aubio_pitchschmitt_t;
 /** execute pitch detection on an input buffer
 
   \param p pitch detection object as returned by new_aubio_pitchschmitt
-  \param samples_in input signal vector (length as specified at creation time)
+  \param samples_in input signal vector, of any length
   \param cands_out pitch period estimates, in samples
 
+  The samples are appended to a block of the size given at creation time,
+  which is analysed each time it gets complete, so that `samples_in` can be
+  shorter or longer than a block. `cands_out` holds the period found in the
+  last complete block, or 0 if none was found yet.
+
 */
 void aubio_pitchschmitt_do (aubio_pitchschmitt_t * p, const fvec_t * samples_in,
     fvec_t * cands_out);
@@ -61,6 +66,16 @@ void aubio_pitchschmitt_do (aubio_pitchschmitt_t * p, const fvec_t * samples_in,
 */
 aubio_pitchschmitt_t *new_aubio_pitchschmitt (uint_t buf_size);
 
+/** get the memory used by the pitch detection object
+
+  \param p pitch detection object as returned by new_aubio_pitchschmitt
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_pitchschmitt_get_memory_usage (const aubio_pitchschmitt_t * p);
+
 /** deletion of the pitch detection object
 
   \param p pitch detection object as returned by new_aubio_pitchschmitt
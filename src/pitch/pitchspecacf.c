@@ -22,13 +22,16 @@
 #include "fvec.h"
 #include "cvec.h"
 #include "mathutils.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
+#include "mathutils_priv.h"
 #include "pitch/pitchspecacf.h"
 
 /** pitch specacf structure */
 struct _aubio_pitchspecacf_t
 {
-  fvec_t *win;        /**< temporal weighting window */
+  const fvec_t *win;  /**< temporal weighting window, shared */
   fvec_t *winput;     /**< windowed spectrum */
   aubio_fft_t *fft;   /**< fft object to compute*/
   fvec_t *fftout;     /**< Fourier transform output */
@@ -48,7 +51,7 @@ new_aubio_pitchspecacf (uint_t bufsize)
   }
   p->fft = new_aubio_fft (bufsize);
   if (!p->fft) goto beach;
-  p->win = new_aubio_window ("hanningz", bufsize);
+  p->win = aubio_window_acquire ("hanningz", bufsize);
   p->winput = new_fvec (bufsize);
   p->fftout = new_fvec (bufsize);
   p->sqrmag = new_fvec (bufsize);
@@ -91,7 +94,7 @@ aubio_pitchspecacf_do (aubio_pitchspecacf_t * p, const fvec_t * input, fvec_t *
 void
 del_aubio_pitchspecacf (aubio_pitchspecacf_t * p)
 {
-  del_fvec (p->win);
+  aubio_window_release (p->win);
   del_fvec (p->winput);
   del_aubio_fft (p->fft);
   del_fvec (p->sqrmag);
@@ -100,6 +103,15 @@ del_aubio_pitchspecacf (aubio_pitchspecacf_t * p)
   AUBIO_FREE (p);
 }
 
+uint_t
+aubio_pitchspecacf_get_memory_usage (const aubio_pitchspecacf_t * p)
+{
+  /* the window is shared */
+  return aubio_malloc_size (p) + aubio_malloc_size (p->winput)
+    + aubio_fft_get_memory_usage (p->fft) + aubio_malloc_size (p->sqrmag)
+    + aubio_malloc_size (p->fftout) + aubio_malloc_size (p->acf);
+}
+
 smpl_t
 aubio_pitchspecacf_get_confidence (const aubio_pitchspecacf_t * o) {
   // no confidence for now
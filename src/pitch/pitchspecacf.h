@@ -62,6 +62,17 @@ void aubio_pitchspecacf_do (aubio_pitchspecacf_t * o, const fvec_t * samples_in,
 
 */
 aubio_pitchspecacf_t *new_aubio_pitchspecacf (uint_t buf_size);
+
+/** get the memory used by the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitchspecacf()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_pitchspecacf_get_memory_usage (const aubio_pitchspecacf_t * o);
+
 /** deletion of the pitch detection object
 
   \param o pitch detection object as returned by new_aubio_pitchspecacf()
@@ -29,14 +29,22 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "mathutils.h"
 #include "pitch/pitchyin.h"
+#include "pitch/pitchyin_priv.h"
+#include "utils/simd_priv.h"
+
+/** number of lags of the difference function computed at once */
+#define AUBIO_PITCHYIN_LAGS 8
 
 struct _aubio_pitchyin_t
 {
   fvec_t *yin;
   smpl_t tol;
   uint_t peak_pos;
+  uint_t yin_length;  /**< number of values of yin computed in the last frame */
+  uint_t complete;    /**< whether to compute yin past the period found */
 };
 
 #if 0
@@ -84,6 +92,12 @@ del_aubio_pitchyin (aubio_pitchyin_t * o)
   AUBIO_FREE (o);
 }
 
+uint_t
+aubio_pitchyin_get_memory_usage (const aubio_pitchyin_t * o)
+{
+  return aubio_malloc_size (o) + aubio_malloc_size (o->yin);
+}
+
 #if 0
 /* outputs the difference function */
 void
@@ -141,20 +155,23 @@ void
 aubio_pitchyin_do (aubio_pitchyin_t * o, const fvec_t * input, fvec_t * out)
 {
   const smpl_t tol = o->tol;
+  const aubio_simd_ops_t *simd = AUBIO_SIMD();
   fvec_t* yin = o->yin;
   const smpl_t *input_data = input->data;
   const uint_t length = yin->length;
   smpl_t *yin_data = yin->data;
-  uint_t j, tau;
+  uint_t tau;
   sint_t period;
-  smpl_t tmp, tmp2 = 0.;
+  uint_t found = 0;
+  smpl_t tmp2 = 0.;
 
   yin_data[0] = 1.;
   for (tau = 1; tau < length; tau++) {
-    yin_data[tau] = 0.;
-    for (j = 0; j < length; j++) {
-      tmp = input_data[j] - input_data[j + tau];
-      yin_data[tau] += SQR (tmp);
+    // difference function of the next few lags, at most LAGS - 1 of them are
+    // wasted when the search stops early
+    if ((tau - 1) % AUBIO_PITCHYIN_LAGS == 0) {
+      simd->sqdiff (input_data, yin_data + tau, tau,
+          MIN (AUBIO_PITCHYIN_LAGS, length - tau), length);
     }
     tmp2 += yin_data[tau];
     if (tmp2 != 0) {
@@ -163,13 +180,17 @@ aubio_pitchyin_do (aubio_pitchyin_t * o, const fvec_t * input, fvec_t * out)
       yin->data[tau] = 1.;
     }
     period = tau - 3;
-    if (tau > 4 && (yin_data[period] < tol) &&
+    if (!found && tau > 4 && (yin_data[period] < tol) &&
         (yin_data[period] < yin_data[period + 1])) {
       o->peak_pos = (uint_t)period;
+      o->yin_length = tau + 1;
       out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
-      return;
+      if (!o->complete) return;
+      found = 1;
     }
   }
+  o->yin_length = length;
+  if (found) return;
   o->peak_pos = (uint_t)fvec_min_elem (yin);
   out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
 }
@@ -179,6 +200,48 @@ aubio_pitchyin_get_confidence (aubio_pitchyin_t * o) {
   return 1. - o->yin->data[o->peak_pos];
 }
 
+uint_t
+aubio_pitchyin_get_candidates (aubio_pitchyin_t * o, fmat_t * candidates)
+{
+  return aubio_pitchyin_find_minima (o->yin, o->yin_length, candidates);
+}
+
+void
+aubio_pitchyin_set_complete (aubio_pitchyin_t * o, uint_t complete)
+{
+  o->complete = complete;
+}
+
+uint_t
+aubio_pitchyin_find_minima (const fvec_t * yin, uint_t end,
+    fmat_t * candidates)
+{
+  uint_t tau, k, n = 0, max_n = candidates->length;
+  smpl_t s0, s1, s2, den, pos, depth;
+  smpl_t *periods = candidates->data[0], *depths = candidates->data[1];
+  end = MIN (end, yin->length);
+  for (tau = 2; tau + 1 < end; tau++) {
+    s0 = yin->data[tau - 1];
+    s1 = yin->data[tau];
+    s2 = yin->data[tau + 1];
+    if (!(s1 < s0 && s1 <= s2)) continue;
+    // 3 point quadratic interpolation of the position and depth
+    den = s0 - 2. * s1 + s2;
+    pos = den != 0. ? .5 * (s0 - s2) / den : 0.;
+    depth = s1 - .25 * (s0 - s2) * pos;
+    if (n == max_n && depth >= depths[n - 1]) continue;
+    // insert, deepest first
+    k = n < max_n ? n++ : n - 1;
+    for (; k > 0 && depths[k - 1] > depth; k--) {
+      periods[k] = periods[k - 1];
+      depths[k] = depths[k - 1];
+    }
+    periods[k] = tau + pos;
+    depths[k] = depth;
+  }
+  return n;
+}
+
 uint_t
 aubio_pitchyin_set_tolerance (aubio_pitchyin_t * o, smpl_t tol)
 {
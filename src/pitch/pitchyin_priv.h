@@ -0,0 +1,59 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Search of the minima of a YIN function, shared by pitch/pitchyin.c,
+   pitch/pitchyinfast.c and pitch/pitchyinfft.c.
+*/
+
+#ifndef AUBIO_PITCHYIN_PRIV_H
+#define AUBIO_PITCHYIN_PRIV_H
+
+/** find the deepest local minima of a YIN function
+
+  \param yin cumulative mean normalized difference function
+  \param end number of values of `yin` to search, the others being stale
+  \param candidates output, 2 rows of at least 1 column; for each minimum,
+  deepest first, row 0 gets its interpolated period in samples and row 1 the
+  interpolated value of `yin` at that period
+
+  \return number of minima written, at most `candidates->length`
+
+*/
+uint_t aubio_pitchyin_find_minima (const fvec_t * yin, uint_t end,
+    fmat_t * candidates);
+
+struct _aubio_pitchyin_t;
+struct _aubio_pitchyinfast_t;
+
+/** compute the whole YIN function, even after finding a period early
+
+  \param o yin or yinfast object
+  \param complete 1 to compute all of the YIN function, so that its
+  candidates list all of its minima, 0 to stop at the first period found
+
+  The period found is the same either way.
+
+*/
+void aubio_pitchyin_set_complete (struct _aubio_pitchyin_t * o,
+    uint_t complete);
+void aubio_pitchyinfast_set_complete (struct _aubio_pitchyinfast_t * o,
+    uint_t complete);
+
+#endif /* AUBIO_PITCHYIN_PRIV_H */
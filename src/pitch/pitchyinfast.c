@@ -31,19 +31,29 @@
 #include "fvec.h"
 #include "mathutils.h"
 #include "cvec.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
 #include "pitch/pitchyinfast.h"
+#include "pitch/pitchyin_priv.h"
+#include "utils/workspace_priv.h"
 
 struct _aubio_pitchyinfast_t
 {
   fvec_t *yin;
   smpl_t tol;
   uint_t peak_pos;
+  uint_t yin_length;  /**< number of values of yin normalized in the last frame */
+  uint_t complete;    /**< whether to compute yin past the period found */
   fvec_t *tmpdata;
   fvec_t *sqdiff;
-  fvec_t *kernel;
+  fvec_t *kernel;       /**< half of the input, zero padded */
   fvec_t *samples_fft;
-  fvec_t *kernel_fft;
+  fvec_t *kernel_fft;   /**< spectrum of the first half of the input */
+  fvec_t *half_fft;     /**< spectrum of the second half of the input */
+  fvec_t *last_half;    /**< second half of the last input */
+  smpl_t last_energy;   /**< sum of the squares of last_half */
+  uint_t has_last;      /**< whether last_half holds a previous input */
   aubio_fft_t *fft;
 };
 
@@ -51,19 +61,22 @@ aubio_pitchyinfast_t *
 new_aubio_pitchyinfast (uint_t bufsize)
 {
   aubio_pitchyinfast_t *o = AUBIO_NEW (aubio_pitchyinfast_t);
+  size_t offset = 0;
   
   if (!o) {
     return NULL;
   }
   o->yin = new_fvec (bufsize / 2);
-  o->tmpdata = new_fvec (bufsize);
-  o->sqdiff = new_fvec (bufsize / 2);
+  o->tmpdata = new_aubio_scratch (bufsize, &offset);
+  o->sqdiff = new_aubio_scratch (bufsize / 2, &offset);
   o->kernel = new_fvec (bufsize);
-  o->samples_fft = new_fvec (bufsize);
+  o->samples_fft = new_aubio_scratch (bufsize, &offset);
   o->kernel_fft = new_fvec (bufsize);
+  o->half_fft = new_fvec (bufsize);
+  o->last_half = new_fvec (bufsize / 2);
   o->fft = new_aubio_fft (bufsize);
-  if (!o->yin || !o->tmpdata || !o->tmpdata || !o->sqdiff
-      || !o->kernel || !o->samples_fft || !o->kernel || !o->fft)
+  if (!o->yin || !o->tmpdata || !o->sqdiff || !o->kernel || !o->samples_fft
+      || !o->kernel_fft || !o->half_fft || !o->last_half || !o->fft)
   {
     del_aubio_pitchyinfast(o);
     return NULL;
@@ -88,11 +101,28 @@ del_aubio_pitchyinfast (aubio_pitchyinfast_t * o)
     del_fvec (o->samples_fft);
   if (o->kernel_fft)
     del_fvec (o->kernel_fft);
+  if (o->half_fft)
+    del_fvec (o->half_fft);
+  if (o->last_half)
+    del_fvec (o->last_half);
   if (o->fft)
     del_aubio_fft (o->fft);
   AUBIO_FREE (o);
 }
 
+uint_t
+aubio_pitchyinfast_get_memory_usage (const aubio_pitchyinfast_t * o)
+{
+  uint_t n = aubio_malloc_size (o) + aubio_malloc_size (o->yin)
+    + aubio_malloc_size (o->tmpdata) + aubio_malloc_size (o->sqdiff)
+    + aubio_malloc_size (o->kernel) + aubio_malloc_size (o->samples_fft)
+    + aubio_malloc_size (o->kernel_fft) + aubio_malloc_size (o->half_fft)
+    + aubio_malloc_size (o->last_half);
+  if (o->fft)
+    n += aubio_fft_get_memory_usage (o->fft);
+  return n;
+}
+
 /* all the above in one */
 void
 aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t * out)
@@ -102,64 +132,80 @@ aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t *
   const uint_t length = yin->length;
   uint_t B = o->tmpdata->length;
   uint_t W = o->yin->length; // B / 2
-  fvec_t tmp_slice, kernel_ptr;
+  const smpl_t *x = input->data;
+  fvec_t *swap;
   uint_t tau;
   sint_t period;
-  smpl_t tmp2 = 0.;
+  uint_t found = 0;
+  smpl_t tmp2 = 0., energy = 0., sign;
+  // when hop_size is B / 2, the first half of input is the second half of
+  // the last one, and so are its spectrum and energy
+  uint_t reuse = o->has_last
+    && memcmp (x, o->last_half->data, W * sizeof(smpl_t)) == 0;
 
-  // compute r_t(0) + r_t+tau(0)
+  // compute r_t(0) + r_t+tau(0), with a running sum of the squares
   {
-    fvec_t *squares = o->tmpdata;
-    fvec_weighted_copy(input, input, squares);
-#if 0
-    for (tau = 0; tau < W; tau++) {
-      tmp_slice.data = squares->data + tau;
-      tmp_slice.length = W;
-      o->sqdiff->data[tau] = fvec_sum(&tmp_slice);
+    if (reuse) {
+      energy = o->last_energy;
+    } else {
+      for (tau = 0; tau < W; tau++) {
+        energy += x[tau] * x[tau];
+      }
     }
-#else
-    tmp_slice.data = squares->data;
-    tmp_slice.length = W;
-    o->sqdiff->data[0] = fvec_sum(&tmp_slice);
+    o->sqdiff->data[0] = energy;
     for (tau = 1; tau < W; tau++) {
-      o->sqdiff->data[tau] = o->sqdiff->data[tau-1];
-      o->sqdiff->data[tau] -= squares->data[tau-1];
-      o->sqdiff->data[tau] += squares->data[W+tau-1];
+      o->sqdiff->data[tau] = o->sqdiff->data[tau-1]
+        - x[tau-1] * x[tau-1] + x[W+tau-1] * x[W+tau-1];
+    }
+    o->last_energy = 0.;
+    for (tau = W; tau < B; tau++) {
+      o->last_energy += x[tau] * x[tau];
     }
-#endif
-    fvec_add(o->sqdiff, o->sqdiff->data[0]);
+    fvec_add(o->sqdiff, energy);
   }
-  // compute r_t(tau) = -2.*ifft(fft(samples)*fft(samples[W-1::-1]))
+  // compute r_t(tau) = ifft(conj(fft(samples[:W])) * fft(samples))
   {
     fvec_t *compmul = o->tmpdata;
     fvec_t *rt_of_tau = o->samples_fft;
-    aubio_fft_do_complex(o->fft, input, o->samples_fft);
-    // build kernel, take a copy of first half of samples
-    tmp_slice.data = input->data;
-    tmp_slice.length = W;
-    kernel_ptr.data = o->kernel->data + 1;
-    kernel_ptr.length = W;
-    fvec_copy(&tmp_slice, &kernel_ptr);
-    // reverse them
-    fvec_rev(&kernel_ptr);
-    // compute fft(kernel)
-    aubio_fft_do_complex(o->fft, o->kernel, o->kernel_fft);
-    // compute complex product
-    compmul->data[0]  = o->kernel_fft->data[0] * o->samples_fft->data[0];
-    for (tau = 1; tau < W; tau++) {
-      compmul->data[tau]    = o->kernel_fft->data[tau] * o->samples_fft->data[tau];
-      compmul->data[tau]   -= o->kernel_fft->data[B-tau] * o->samples_fft->data[B-tau];
+    const smpl_t *K, *H;
+    smpl_t *X;
+    // spectrum of the first half, zero padded
+    if (reuse) {
+      swap = o->kernel_fft;
+      o->kernel_fft = o->half_fft;
+      o->half_fft = swap;
+    } else {
+      AUBIO_MEMCPY (o->kernel->data, x, W * sizeof(smpl_t));
+      aubio_fft_do_complex(o->fft, o->kernel, o->kernel_fft);
     }
-    compmul->data[W]    = o->kernel_fft->data[W] * o->samples_fft->data[W];
+    // spectrum of the second half, zero padded, kept for the next call
+    AUBIO_MEMCPY (o->kernel->data, x + W, W * sizeof(smpl_t));
+    aubio_fft_do_complex(o->fft, o->kernel, o->half_fft);
+    AUBIO_MEMCPY (o->last_half->data, x + W, W * sizeof(smpl_t));
+    o->has_last = 1;
+    // spectrum of samples, delaying the second half by W: bin k of its
+    // spectrum gets multiplied by exp(-i pi k) = (-1)^k
+    K = o->kernel_fft->data;
+    H = o->half_fft->data;
+    X = o->samples_fft->data;
+    X[0] = K[0] + H[0];
+    X[W] = K[W] + ((W & 1) ? -H[W] : H[W]);
+    for (tau = 1, sign = -1.; tau < W; tau++, sign = -sign) {
+      X[tau] = K[tau] + sign * H[tau];
+      X[B-tau] = K[B-tau] + sign * H[B-tau];
+    }
+    // compute complex product, the first half being conjugated
+    compmul->data[0] = K[0] * X[0];
+    compmul->data[W] = K[W] * X[W];
     for (tau = 1; tau < W; tau++) {
-      compmul->data[B-tau]  = o->kernel_fft->data[B-tau] * o->samples_fft->data[tau];
-      compmul->data[B-tau] += o->kernel_fft->data[tau] * o->samples_fft->data[B-tau];
+      compmul->data[tau] = K[tau] * X[tau] + K[B-tau] * X[B-tau];
+      compmul->data[B-tau] = K[tau] * X[B-tau] - K[B-tau] * X[tau];
     }
     // compute inverse fft
     aubio_fft_rdo_complex(o->fft, compmul, rt_of_tau);
-    // compute square difference r_t(tau) = sqdiff - 2 * r_t_tau[W-1:-1]
+    // compute square difference r_t(tau) = sqdiff - 2 * r_t_tau[:W]
     for (tau = 0; tau < W; tau++) {
-      yin->data[tau] = o->sqdiff->data[tau] - 2. * rt_of_tau->data[tau+W];
+      yin->data[tau] = o->sqdiff->data[tau] - 2. * rt_of_tau->data[tau];
     }
   }
 
@@ -174,13 +220,17 @@ aubio_pitchyinfast_do (aubio_pitchyinfast_t * o, const fvec_t * input, fvec_t *
       yin->data[tau] = 1.;
     }
     period = tau - 3;
-    if (tau > 4 && (yin->data[period] < tol) &&
+    if (!found && tau > 4 && (yin->data[period] < tol) &&
         (yin->data[period] < yin->data[period + 1])) {
       o->peak_pos = (uint_t)period;
+      o->yin_length = tau + 1;
       out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
-      return;
+      if (!o->complete) return;
+      found = 1;
     }
   }
+  o->yin_length = length;
+  if (found) return;
   // use global minimum 
   o->peak_pos = (uint_t)fvec_min_elem (yin);
   out->data[0] = fvec_quadratic_peak_pos (yin, o->peak_pos);
@@ -191,6 +241,19 @@ aubio_pitchyinfast_get_confidence (aubio_pitchyinfast_t * o) {
   return 1. - o->yin->data[o->peak_pos];
 }
 
+uint_t
+aubio_pitchyinfast_get_candidates (aubio_pitchyinfast_t * o,
+    fmat_t * candidates)
+{
+  return aubio_pitchyin_find_minima (o->yin, o->yin_length, candidates);
+}
+
+void
+aubio_pitchyinfast_set_complete (aubio_pitchyinfast_t * o, uint_t complete)
+{
+  o->complete = complete;
+}
+
 uint_t
 aubio_pitchyinfast_set_tolerance (aubio_pitchyinfast_t * o, smpl_t tol)
 {
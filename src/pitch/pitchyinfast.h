@@ -53,6 +53,16 @@ typedef struct _aubio_pitchyinfast_t aubio_pitchyinfast_t;
 */
 aubio_pitchyinfast_t *new_aubio_pitchyinfast (uint_t buf_size);
 
+/** get the memory used by the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitchyinfast()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_pitchyinfast_get_memory_usage (const aubio_pitchyinfast_t * o);
+
 /** deletion of the pitch detection object
 
   \param o pitch detection object as returned by new_aubio_pitchyin()
@@ -94,6 +104,18 @@ smpl_t aubio_pitchyinfast_get_tolerance (aubio_pitchyinfast_t * o);
 */
 smpl_t aubio_pitchyinfast_get_confidence (aubio_pitchyinfast_t * o);
 
+/** get the deepest minima of the YIN function of the last analysed frame
+
+  \param o YIN pitch detection object
+  \param candidates output, 2 rows of at least 1 column; for each minimum,
+  deepest first, row 0 gets its interpolated period in samples and row 1 the
+  interpolated value of the YIN function at that period
+
+  \return number of candidates written, at most `candidates->length`
+
+*/
+uint_t aubio_pitchyinfast_get_candidates (aubio_pitchyinfast_t * o, fmat_t * candidates);
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,13 +22,17 @@
 #include "fvec.h"
 #include "cvec.h"
 #include "mathutils.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
+#include "mathutils_priv.h"
 #include "pitch/pitchyinfft.h"
+#include "pitch/pitchyin_priv.h"
 
 /** pitch yinfft structure */
 struct _aubio_pitchyinfft_t
 {
-  fvec_t *win;        /**< temporal weighting window */
+  const fvec_t *win;  /**< temporal weighting window, shared */
   fvec_t *winput;     /**< windowed spectrum */
   fvec_t *sqrmag;     /**< square difference function */
   fvec_t *weight;     /**< spectral weighting window (psychoacoustic model) */
@@ -72,7 +76,7 @@ new_aubio_pitchyinfft (uint_t samplerate, uint_t bufsize)
   p->yinfft = new_fvec (bufsize / 2 + 1);
   p->tol = 0.85;
   p->peak_pos = 0;
-  p->win = new_aubio_window ("hanningz", bufsize);
+  p->win = aubio_window_acquire ("hanningz", bufsize);
   p->weight = new_fvec (bufsize / 2 + 1);
   for (i = 0; i < p->weight->length; i++) {
     freq = (smpl_t) i / (smpl_t) bufsize *(smpl_t) samplerate;
@@ -111,15 +115,16 @@ beach:
   return NULL;
 }
 
+/* compute the yin function from the weighted squared magnitudes in sqrmag */
+static void aubio_pitchyinfft_do_sqrmag (aubio_pitchyinfft_t * p,
+    fvec_t * output);
+
 void
 aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * output)
 {
-  uint_t tau, l;
+  uint_t l;
   uint_t length = p->fftout->length;
-  uint_t halfperiod;
   fvec_t *fftout = p->fftout;
-  fvec_t *yin = p->yinfft;
-  smpl_t tmp = 0., sum = 0.;
   // window the input
   fvec_weighted_copy(input, p->win, p->winput);
   // get the real / imag parts of its fft
@@ -134,6 +139,34 @@ aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * ou
   }
   p->sqrmag->data[length / 2] = SQR(fftout->data[length / 2]);
   p->sqrmag->data[length / 2] *= p->weight->data[length / 2];
+  aubio_pitchyinfft_do_sqrmag (p, output);
+}
+
+void
+aubio_pitchyinfft_do_spectrum (aubio_pitchyinfft_t * p,
+    const cvec_t * fftgrain, fvec_t * output)
+{
+  uint_t l;
+  uint_t length = p->fftout->length;
+  // the magnitude spectrum does not depend on the fftshift applied by pvoc
+  for (l = 0; l < length / 2 + 1; l++) {
+    p->sqrmag->data[l] = SQR(fftgrain->norm[l]) * p->weight->data[l];
+  }
+  for (l = 1; l < length / 2; l++) {
+    p->sqrmag->data[length - l] = p->sqrmag->data[l];
+  }
+  aubio_pitchyinfft_do_sqrmag (p, output);
+}
+
+static void
+aubio_pitchyinfft_do_sqrmag (aubio_pitchyinfft_t * p, fvec_t * output)
+{
+  uint_t tau, l;
+  uint_t length = p->fftout->length;
+  uint_t halfperiod;
+  fvec_t *fftout = p->fftout;
+  fvec_t *yin = p->yinfft;
+  smpl_t tmp = 0., sum = 0.;
   // get sum of weighted squared mags
   for (l = 0; l < length / 2 + 1; l++) {
     sum += p->sqrmag->data[l];
@@ -183,7 +216,7 @@ aubio_pitchyinfft_do (aubio_pitchyinfft_t * p, const fvec_t * input, fvec_t * ou
 void
 del_aubio_pitchyinfft (aubio_pitchyinfft_t * p)
 {
-  del_fvec (p->win);
+  aubio_window_release (p->win);
   del_aubio_fft (p->fft);
   del_fvec (p->yinfft);
   del_fvec (p->sqrmag);
@@ -193,11 +226,28 @@ del_aubio_pitchyinfft (aubio_pitchyinfft_t * p)
   AUBIO_FREE (p);
 }
 
+uint_t
+aubio_pitchyinfft_get_memory_usage (const aubio_pitchyinfft_t * p)
+{
+  /* the window is shared */
+  return aubio_malloc_size (p) + aubio_fft_get_memory_usage (p->fft)
+    + aubio_malloc_size (p->yinfft) + aubio_malloc_size (p->sqrmag)
+    + aubio_malloc_size (p->fftout) + aubio_malloc_size (p->winput)
+    + aubio_malloc_size (p->weight);
+}
+
 smpl_t
 aubio_pitchyinfft_get_confidence (aubio_pitchyinfft_t * o) {
   return 1. - o->yinfft->data[o->peak_pos];
 }
 
+uint_t
+aubio_pitchyinfft_get_candidates (aubio_pitchyinfft_t * o,
+    fmat_t * candidates)
+{
+  return aubio_pitchyin_find_minima (o->yinfft, o->yinfft->length, candidates);
+}
+
 uint_t
 aubio_pitchyinfft_set_tolerance (aubio_pitchyinfft_t * p, smpl_t tol)
 {
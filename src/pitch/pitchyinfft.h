@@ -53,6 +53,16 @@ typedef struct _aubio_pitchyinfft_t aubio_pitchyinfft_t;
 
 */
 void aubio_pitchyinfft_do (aubio_pitchyinfft_t * o, const fvec_t * samples_in, fvec_t * cands_out);
+/** execute pitch detection on a precomputed spectrum
+
+  \param o pitch detection object as returned by new_aubio_pitchyinfft
+  \param fftgrain spectrum of the input buffer, as computed by aubio_pvoc_do()
+  with a `hanningz` window of the same length
+  \param cands_out pitch period candidates, in samples
+
+*/
+void aubio_pitchyinfft_do_spectrum (aubio_pitchyinfft_t * o,
+    const cvec_t * fftgrain, fvec_t * cands_out);
 /** creation of the pitch detection object
 
   \param samplerate samplerate of the input signal
@@ -60,6 +70,17 @@ void aubio_pitchyinfft_do (aubio_pitchyinfft_t * o, const fvec_t * samples_in, f
 
 */
 aubio_pitchyinfft_t *new_aubio_pitchyinfft (uint_t samplerate, uint_t buf_size);
+
+/** get the memory used by the pitch detection object
+
+  \param o pitch detection object as returned by new_aubio_pitchyinfft()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_pitchyinfft_get_memory_usage (const aubio_pitchyinfft_t * o);
+
 /** deletion of the pitch detection object
 
   \param o pitch detection object as returned by new_aubio_pitchyinfft()
@@ -92,6 +113,18 @@ uint_t aubio_pitchyinfft_set_tolerance (aubio_pitchyinfft_t * o, smpl_t tol);
 */
 smpl_t aubio_pitchyinfft_get_confidence (aubio_pitchyinfft_t * o);
 
+/** get the deepest minima of the YIN function of the last analysed frame
+
+  \param o Yinfft pitch detection object
+  \param candidates output, 2 rows of at least 1 column; for each minimum,
+  deepest first, row 0 gets its interpolated period in samples and row 1 the
+  interpolated value of the YIN function at that period
+
+  \return number of candidates written, at most `candidates->length`
+
+*/
+uint_t aubio_pitchyinfft_get_candidates (aubio_pitchyinfft_t * o, fmat_t * candidates);
+
 #ifdef __cplusplus
 }
 #endif
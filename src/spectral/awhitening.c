@@ -23,6 +23,8 @@
 #include "cvec.h"
 #include "mathutils.h"
 #include "spectral/awhitening.h"
+#include "utils/simd_priv.h"
+#include "utils/denormal_priv.h"
 
 #define aubio_spectral_whitening_default_relax_time   250   // in seconds, between 22 and 446
 #define aubio_spectral_whitening_default_decay        0.001 // -60dB attenuation
@@ -42,13 +44,19 @@ struct _aubio_spectral_whitening_t {
 void
 aubio_spectral_whitening_do (aubio_spectral_whitening_t * o, cvec_t * fftgrain)
 {
-  uint_t i = 0;
+  aubio_spectral_whitening_do_logmag (o, fftgrain, 0.);
+}
+
+void
+aubio_spectral_whitening_do_logmag (aubio_spectral_whitening_t * o,
+    cvec_t * fftgrain, smpl_t lambda)
+{
   uint_t length = MIN(fftgrain->length, o->peak_values->length);
-  for (i = 0; i < length; i++) {
-    smpl_t tmp = MAX(o->r_decay * o->peak_values->data[i], o->floor);
-    o->peak_values->data[i] = MAX(fftgrain->norm[i], tmp);
-    fftgrain->norm[i] /= o->peak_values->data[i];
-  }
+  aubio_denormal_guard_t guard;
+  aubio_denormal_enter (&guard);
+  AUBIO_SIMD()->whiten (fftgrain->norm, o->peak_values->data, o->r_decay,
+      o->floor, lambda, length);
+  aubio_denormal_leave (&guard);
 }
 
 aubio_spectral_whitening_t *
@@ -123,3 +131,10 @@ del_aubio_spectral_whitening (aubio_spectral_whitening_t * o)
   del_fvec (o->peak_values);
   AUBIO_FREE (o);
 }
+
+uint_t
+aubio_spectral_whitening_get_memory_usage (
+    const aubio_spectral_whitening_t * o)
+{
+  return aubio_malloc_size (o) + aubio_malloc_size (o->peak_values);
+}
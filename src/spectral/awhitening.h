@@ -59,6 +59,22 @@ typedef struct _aubio_spectral_whitening_t aubio_spectral_whitening_t;
 void aubio_spectral_whitening_do (aubio_spectral_whitening_t * o,
                                   cvec_t * fftgrain);
 
+/** execute spectral adaptive whitening and log compression, in-place
+
+  \param o spectral whitening object as returned by new_aubio_spectral_whitening()
+  \param fftgrain input signal spectrum as computed by aubio_pvoc_do() or aubio_fft_do()
+  \param lambda compression factor, or 0. to only whiten the spectrum
+
+  This function whitens and compresses the spectrum in a single pass. With
+  a positive `lambda`, its result is that of aubio_spectral_whitening_do()
+  followed by cvec_logmag(), except that the log is approximated, with an
+  absolute error below 1.e-6 * (1 + log(1 + lambda * norm)) in single
+  precision.
+
+*/
+void aubio_spectral_whitening_do_logmag (aubio_spectral_whitening_t * o,
+    cvec_t * fftgrain, smpl_t lambda);
+
 /** creation of a spectral whitening object
 
   \param buf_size window size of input grains
@@ -111,6 +127,18 @@ uint_t aubio_spectral_whitening_set_floor (aubio_spectral_whitening_t * o,
 */
 smpl_t aubio_spectral_whitening_get_floor (aubio_spectral_whitening_t * o);
 
+/** get the memory used by a spectral whitening
+
+  \param o spectral whitening object as returned by
+  new_aubio_spectral_whitening()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_spectral_whitening_get_memory_usage (
+    const aubio_spectral_whitening_t * o);
+
 /** deletion of a spectral whitening
 
   \param o spectral whitening object as returned by new_aubio_spectral_whitening()
@@ -0,0 +1,266 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
+#include "spectral/filterbank.h"
+#include "spectral/chroma.h"
+
+/** semitones per octave, over log(2) */
+#define AUBIO_CHROMA_SEMITONES_PER_LOG (12. / 0.69314718055994530942)
+
+/** weight of the previous estimates of the tuning at each new spectrum */
+#define AUBIO_CHROMA_TUNING_DECAY .99
+
+/** spectral peaks below this magnitude are left out of the estimation */
+#define AUBIO_CHROMA_PEAK_FLOOR 1.e-4
+
+struct _aubio_chroma_t
+{
+  uint_t win_s;
+  uint_t samplerate;
+  sint_t s_lo;              /**< MIDI number of the lowest semitone */
+  uint_t n_semitones;
+  uint_t k_lo;              /**< first bin of the peak search */
+  uint_t k_hi;              /**< last bin of the peak search */
+  aubio_filterbank_t *fb;   /**< one filter per semitone */
+  fvec_t *energy;           /**< squared magnitudes of the input */
+  fvec_t *bands;            /**< energy of each semitone */
+  smpl_t tuning;            /**< tuning of the filters, in cents */
+  uint_t estimate;
+  uint_t normalize;
+  smpl_t acc_re;            /**< sum of the deviations of the peaks, as */
+  smpl_t acc_im;            /**< phasors weighted by their energy */
+};
+
+/* the energy of each bin goes to the semitones within half its bandwidth,
+   or half a semitone, with weights summing to 1 before the semitones out of
+   range are dropped */
+static void
+aubio_chroma_set_filters (aubio_chroma_t * o)
+{
+  fmat_t *coeffs = aubio_filterbank_get_coeffs (o->fb);
+  smpl_t bin_freq = (smpl_t)o->samplerate / o->win_s;
+  smpl_t ref = 440. * POW (2., o->tuning / 1200.);
+  sint_t s_hi = o->s_lo + (sint_t)o->n_semitones - 1;
+  uint_t k;
+  fmat_zeros (coeffs);
+  for (k = 1; k < coeffs->length; k++) {
+    smpl_t pitch = 69. + AUBIO_CHROMA_SEMITONES_PER_LOG
+      * LOG (k * bin_freq / ref);
+    smpl_t width = MAX (.5, AUBIO_CHROMA_SEMITONES_PER_LOG
+        * LOG ((k + .5) / (k - .5)));
+    sint_t lo = (sint_t)CEIL (pitch - width);
+    sint_t hi = (sint_t)FLOOR (pitch + width);
+    smpl_t total = 0.;
+    sint_t s;
+    if (hi < o->s_lo || lo > s_hi) continue;
+    for (s = lo; s <= hi; s++) {
+      total += 1. - ABS (pitch - s) / width;
+    }
+    if (total <= 0.) continue;
+    for (s = MAX (lo, o->s_lo); s <= MIN (hi, s_hi); s++) {
+      coeffs->data[s - o->s_lo][k] = (1. - ABS (pitch - s) / width) / total;
+    }
+  }
+}
+
+aubio_chroma_t *
+new_aubio_chroma (uint_t buf_size, smpl_t fmin, smpl_t fmax,
+    uint_t samplerate)
+{
+  aubio_chroma_t *o = AUBIO_NEW (aubio_chroma_t);
+  smpl_t lo, hi;
+  if (!o) return NULL;
+  if ((sint_t)buf_size < 2) {
+    AUBIO_ERR ("chroma: buf_size should be >= 2, got %d\n", buf_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate <= 0) {
+    AUBIO_ERR ("chroma: samplerate should be > 0, got %d\n", samplerate);
+    goto beach;
+  }
+  if (fmin < 20. || fmax <= fmin || fmax > samplerate / 2.) {
+    AUBIO_ERR ("chroma: frequencies should be from 20Hz to %.1fHz, got %.2fHz"
+        " to %.2fHz\n", samplerate / 2., fmin, fmax);
+    goto beach;
+  }
+  lo = CEIL (69. + AUBIO_CHROMA_SEMITONES_PER_LOG * LOG (fmin / 440.));
+  hi = FLOOR (69. + AUBIO_CHROMA_SEMITONES_PER_LOG * LOG (fmax / 440.));
+  if (hi < lo) {
+    AUBIO_ERR ("chroma: no semitone between %.2fHz and %.2fHz\n", fmin, fmax);
+    goto beach;
+  }
+  o->win_s = buf_size;
+  o->samplerate = samplerate;
+  o->s_lo = (sint_t)lo;
+  o->n_semitones = (uint_t)(hi - lo) + 1;
+  o->k_lo = MAX (1, (uint_t)FLOOR (fmin * buf_size / samplerate));
+  o->k_hi = MIN (buf_size / 2 - 1,
+      (uint_t)CEIL (fmax * buf_size / samplerate));
+  o->normalize = 1;
+  o->fb = new_aubio_filterbank (o->n_semitones, buf_size);
+  o->energy = new_fvec (buf_size / 2 + 1);
+  o->bands = new_fvec (o->n_semitones);
+  if (!o->fb || !o->energy || !o->bands) goto beach;
+  aubio_chroma_set_filters (o);
+  return o;
+
+beach:
+  del_aubio_chroma (o);
+  return NULL;
+}
+
+void
+aubio_chroma_do (aubio_chroma_t * o, const cvec_t * fftgrain, fvec_t * out)
+{
+  const smpl_t *norm = fftgrain->norm;
+  smpl_t *energy = o->energy->data;
+  cvec_t view;
+  uint_t k, i, length = MIN (fftgrain->length, o->energy->length);
+  smpl_t re = 0., im = 0., max = 0.;
+  AUBIO_STATS_BEGIN ("chroma");
+
+  for (k = 0; k < length; k++) {
+    energy[k] = norm[k] * norm[k];
+  }
+  if (o->estimate) {
+    smpl_t bin_freq = (smpl_t)o->samplerate / o->win_s;
+    for (k = o->k_lo; k <= o->k_hi && k + 1 < length; k++) {
+      smpl_t a = norm[k - 1], b = norm[k], c = norm[k + 1], den, dev;
+      if (b <= a || b < c || b < AUBIO_CHROMA_PEAK_FLOOR) continue;
+      // parabola through the log magnitudes, closer to the main lobe of the
+      // window than through the magnitudes
+      a = LOG (a + AUBIO_CHROMA_PEAK_FLOOR);
+      b = LOG (b + AUBIO_CHROMA_PEAK_FLOOR);
+      c = LOG (c + AUBIO_CHROMA_PEAK_FLOOR);
+      den = a - 2. * b + c;
+      // distance to the nearest semitone of A440, from -.5 to .5
+      dev = AUBIO_CHROMA_SEMITONES_PER_LOG * LOG ((k + (den != 0. ?
+              .5 * (a - c) / den : 0.)) * bin_freq / 440.);
+      dev -= ROUND (dev);
+      re += energy[k] * COS (2. * PI * dev);
+      im += energy[k] * SIN (2. * PI * dev);
+    }
+    o->acc_re = AUBIO_CHROMA_TUNING_DECAY * o->acc_re + re;
+    o->acc_im = AUBIO_CHROMA_TUNING_DECAY * o->acc_im + im;
+    if (o->acc_re != 0. || o->acc_im != 0.) {
+      smpl_t tuning = ROUND (100. * ATAN2 (o->acc_im, o->acc_re) / (2. * PI));
+      if (tuning != o->tuning) {
+        o->tuning = tuning;
+        aubio_chroma_set_filters (o);
+      }
+    }
+  }
+
+  view.length = o->energy->length;
+  view.norm = energy;
+  view.phas = NULL;
+  aubio_filterbank_do (o->fb, &view, o->bands);
+
+  fvec_zeros (out);
+  for (i = 0; i < o->n_semitones; i++) {
+    sint_t s = o->s_lo + (sint_t)i;
+    uint_t pc = (uint_t)(((s % 12) + 12) % 12);
+    if (pc < out->length) out->data[pc] += o->bands->data[i];
+  }
+  if (o->normalize) {
+    for (i = 0; i < out->length; i++) {
+      max = MAX (max, out->data[i]);
+    }
+    if (max > 0.) fvec_mul (out, 1. / max);
+  }
+  AUBIO_STATS_END ();
+}
+
+uint_t
+aubio_chroma_set_tuning (aubio_chroma_t * o, smpl_t tuning)
+{
+  if (!(ABS (tuning) <= 50.)) {
+    AUBIO_ERR ("chroma: tuning should be from -50 to 50 cents, got %.2f\n",
+        tuning);
+    return AUBIO_FAIL;
+  }
+  o->tuning = tuning;
+  aubio_chroma_set_filters (o);
+  aubio_chroma_reset (o);
+  return AUBIO_OK;
+}
+
+smpl_t
+aubio_chroma_get_tuning (const aubio_chroma_t * o)
+{
+  return o->tuning;
+}
+
+uint_t
+aubio_chroma_set_tuning_estimation (aubio_chroma_t * o, uint_t enable)
+{
+  o->estimate = enable ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_chroma_get_tuning_estimation (const aubio_chroma_t * o)
+{
+  return o->estimate;
+}
+
+uint_t
+aubio_chroma_set_normalize (aubio_chroma_t * o, uint_t normalize)
+{
+  o->normalize = normalize ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_chroma_get_normalize (const aubio_chroma_t * o)
+{
+  return o->normalize;
+}
+
+uint_t
+aubio_chroma_get_memory_usage (const aubio_chroma_t * o)
+{
+  return aubio_malloc_size (o) + aubio_malloc_size (o->energy)
+    + aubio_malloc_size (o->bands) + aubio_filterbank_get_memory_usage (o->fb);
+}
+
+void
+aubio_chroma_reset (aubio_chroma_t * o)
+{
+  o->acc_re = 0.;
+  o->acc_im = 0.;
+}
+
+void
+del_aubio_chroma (aubio_chroma_t * o)
+{
+  if (o->fb)
+    del_aubio_filterbank (o->fb);
+  if (o->energy)
+    del_fvec (o->energy);
+  if (o->bands)
+    del_fvec (o->bands);
+  AUBIO_FREE (o);
+}
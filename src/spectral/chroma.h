@@ -0,0 +1,184 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Chromagram
+
+  This object folds the energy of a spectrum onto the 12 pitch classes of
+  the equal tempered scale, from C to B, whatever their octave, for instance
+  to map the harmony of a song to colours.
+
+  The energy of each bin of the spectrum, as computed by aubio_pvoc_t, goes
+  to its nearest semitone, or, for the low bins wider than a semitone, is
+  spread over the semitones they cover, with triangular weights. The
+  weights are kept in an aubio_filterbank_t, one filter per semitone between
+  `fmin` and `fmax`, of which only the few non-zero bins are visited. The
+  energy of the semitones of each class is then summed.
+
+  The semitones are centred on A4 at 440Hz by default. The reference can be
+  moved by up to half a semitone, either with aubio_chroma_set_tuning(), or
+  estimated from the peaks of the spectra with
+  aubio_chroma_set_tuning_estimation(), for recordings tuned away from
+  440Hz.
+
+  \example spectral/test-chroma.c
+
+*/
+
+#ifndef AUBIO_CHROMA_H
+#define AUBIO_CHROMA_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** number of pitch classes computed by aubio_chroma_do() */
+#define AUBIO_CHROMA_N_CLASSES 12
+
+/** chromagram object */
+typedef struct _aubio_chroma_t aubio_chroma_t;
+
+/** create a chromagram object
+
+  \param buf_size size of the spectra, as given to new_aubio_pvoc()
+  \param fmin lowest frequency, in Hz
+  \param fmax highest frequency, in Hz, at most half the samplerate
+  \param samplerate samplerate of the signal
+
+  \return the newly created object, or NULL on failure
+
+  The semitones between `fmin` and `fmax` are taken into account. The lowest
+  octaves are only resolved with large values of `buf_size`: the spectra of
+  4096 points at 44100Hz separate the semitones above 180Hz or so, the bins
+  below being spread over several of them.
+
+*/
+aubio_chroma_t *new_aubio_chroma (uint_t buf_size, smpl_t fmin, smpl_t fmax,
+    uint_t samplerate);
+
+/** compute the chroma vector of a spectrum
+
+  \param o chromagram object as returned by new_aubio_chroma()
+  \param fftgrain input spectrum, of length `buf_size / 2 + 1`
+  \param out energy of each pitch class, from C to B, of length
+  ::AUBIO_CHROMA_N_CLASSES
+
+  The energies are scaled so that the largest one is 1, unless disabled with
+  aubio_chroma_set_normalize(). The input spectrum is left untouched.
+
+*/
+void aubio_chroma_do (aubio_chroma_t * o, const cvec_t * fftgrain,
+    fvec_t * out);
+
+/** set the tuning of the semitones
+
+  \param o chromagram object as returned by new_aubio_chroma()
+  \param tuning deviation of A4 from 440Hz, in cents, from -50 to 50
+
+  \return 0 if successful, 1 otherwise
+
+*/
+uint_t aubio_chroma_set_tuning (aubio_chroma_t * o, smpl_t tuning);
+
+/** get the tuning of the semitones
+
+  \param o chromagram object as returned by new_aubio_chroma()
+
+  \return deviation of A4 from 440Hz, in cents, as set by
+  aubio_chroma_set_tuning() or estimated
+
+*/
+smpl_t aubio_chroma_get_tuning (const aubio_chroma_t * o);
+
+/** enable or disable the estimation of the tuning
+
+  \param o chromagram object as returned by new_aubio_chroma()
+  \param enable 1 to estimate the tuning, 0 to keep the current one
+
+  \return 0 if successful, 1 otherwise
+
+  When enabled, the deviation of the spectral peaks from the semitones is
+  averaged over the last hundred spectra or so, weighted by their energy.
+  The semitones are moved to the average, to the nearest cent, within the
+  same call to aubio_chroma_do().
+
+*/
+uint_t aubio_chroma_set_tuning_estimation (aubio_chroma_t * o, uint_t enable);
+
+/** get whether the tuning is estimated
+
+  \param o chromagram object as returned by new_aubio_chroma()
+
+  \return 1 if the tuning is estimated, 0 otherwise
+
+*/
+uint_t aubio_chroma_get_tuning_estimation (const aubio_chroma_t * o);
+
+/** enable or disable the normalisation of the output
+
+  \param o chromagram object as returned by new_aubio_chroma()
+  \param normalize 1 to scale the largest class to 1 (default), 0 to output
+  the energies
+
+  \return 0 if successful, 1 otherwise
+
+*/
+uint_t aubio_chroma_set_normalize (aubio_chroma_t * o, uint_t normalize);
+
+/** get whether the output is normalised
+
+  \param o chromagram object as returned by new_aubio_chroma()
+
+  \return 1 if the largest class is scaled to 1, 0 otherwise
+
+*/
+uint_t aubio_chroma_get_normalize (const aubio_chroma_t * o);
+
+/** get the memory used by a chromagram object
+
+  \param o chromagram object as returned by new_aubio_chroma()
+
+  \return number of bytes allocated by the object and its filterbank
+
+*/
+uint_t aubio_chroma_get_memory_usage (const aubio_chroma_t * o);
+
+/** forget the estimated tuning
+
+  \param o chromagram object as returned by new_aubio_chroma()
+
+  The semitones are kept at their current tuning until the next estimate.
+
+*/
+void aubio_chroma_reset (aubio_chroma_t * o);
+
+/** delete a chromagram object
+
+  \param o chromagram object as returned by new_aubio_chroma()
+
+*/
+void del_aubio_chroma (aubio_chroma_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_CHROMA_H */
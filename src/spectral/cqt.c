@@ -0,0 +1,363 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "mathutils.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "spectral/cqt.h"
+#include "temporal/halfband.h"
+#include "utils/simd_priv.h"
+
+/** highest frequency left untouched by a half-band decimator, relative to its
+ * input samplerate: .42 times the Nyquist frequency of its output */
+#define AUBIO_CQT_PASSBAND .21
+
+/** spectral kernel values below this fraction of their peak are dropped */
+#define AUBIO_CQT_THRESHOLD .0054
+
+/** bins of one octave, computed at one samplerate */
+typedef struct
+{
+  uint_t stage;         /**< decimation stage, the samplerate being divided
+                             by 2^stage */
+  uint_t first;         /**< index of the lowest bin of the octave */
+  uint_t n_bins;        /**< number of bins in the octave */
+  uint_t size;          /**< length of the transforms */
+  aubio_fft_t *fft;
+  fvec_t *frame;        /**< last size samples at the octave samplerate */
+  fvec_t *compspec;     /**< spectrum in the layout of aubio_fft_t */
+  fvec_t *spec;         /**< size / 2 + 1 real parts, then as many
+                             imaginary parts */
+  uint_t *start;        /**< first spectrum bin of each kernel */
+  fvec_t **kernels;     /**< conjugated spectral kernel of each bin, its
+                             real parts followed by its imaginary parts */
+} aubio_cqt_octave_t;
+
+struct _aubio_cqt_t
+{
+  smpl_t fmin;
+  uint_t bins_per_octave;
+  uint_t n_bins;
+  uint_t hop_size;
+  uint_t samplerate;
+  uint_t n_octaves;
+  aubio_cqt_octave_t *octaves;  /**< from the highest octave */
+  uint_t n_stages;              /**< number of decimation stages */
+  aubio_decimator_t **decimators;
+  fvec_t **signals;             /**< output of each decimator */
+};
+
+/* to real parts followed by imaginary parts, as in temporal/convolver.c */
+static void
+aubio_cqt_split (const smpl_t * compspec, smpl_t * spec, uint_t size)
+{
+  uint_t i, bins = size / 2 + 1;
+  smpl_t *imag = spec + bins;
+  AUBIO_MEMCPY (spec, compspec, bins * sizeof(smpl_t));
+  imag[0] = 0.;
+  imag[size / 2] = 0.;
+  for (i = 1; i < size / 2; i++) {
+    imag[i] = compspec[size - i];
+  }
+}
+
+/* spectral kernel of the bin at freq, relative to the samplerate of the
+   octave, over the positive frequencies only */
+static uint_t
+aubio_cqt_octave_kernel (aubio_cqt_octave_t * oct, uint_t b, lsmp_t freq,
+    lsmp_t q, fvec_t * tmp)
+{
+  uint_t n, k, len, first, last, size = oct->size, bins = size / 2 + 1;
+  uint_t width = (uint_t) ROUND (q / freq);
+  lsmp_t sum = 0., peak = 0.;
+  smpl_t *sre, *sim, *re = tmp->data, *im = tmp->data + 2 * bins;
+  fvec_t *kernel;
+  width = MAX (1, MIN (width, size));
+  // a Hann window, ending on the last sample of the frame, its real and
+  // imaginary parts transformed separately
+  for (k = 0; k < 2; k++) {
+    fvec_zeros (oct->frame);
+    for (n = 0; n < width; n++) {
+      lsmp_t w = .5 - .5 * COS (2. * PI * (n + .5) / width);
+      lsmp_t phase = 2. * PI * freq * n;
+      oct->frame->data[size - width + n] = w * (k ? SIN (phase) : COS (phase));
+      if (k == 0) sum += w;
+    }
+    aubio_fft_do_complex (oct->fft, oct->frame, oct->compspec);
+    aubio_cqt_split (oct->compspec->data, k ? im : re, size);
+  }
+  fvec_zeros (oct->frame);
+  // spectrum of re + i im, conjugated, scaled so that a sine of amplitude 1
+  // gives 1, and kept where it is above the threshold
+  sre = oct->spec->data;
+  sim = oct->spec->data + bins;
+  for (k = 0; k < bins; k++) {
+    lsmp_t kr = re[k] - im[bins + k];
+    lsmp_t ki = re[bins + k] + im[k];
+    sre[k] = kr * 2. / (sum * size);
+    sim[k] = - ki * 2. / (sum * size);
+    peak = MAX (peak, SQRT (sre[k] * sre[k] + sim[k] * sim[k]));
+  }
+  first = bins;
+  last = 0;
+  for (k = 0; k < bins; k++) {
+    smpl_t mag = SQRT (sre[k] * sre[k] + sim[k] * sim[k]);
+    if (mag >= AUBIO_CQT_THRESHOLD * peak) {
+      first = MIN (first, k);
+      last = k;
+    }
+  }
+  len = last + 1 - first;
+  kernel = new_fvec (2 * len);
+  if (!kernel) return AUBIO_FAIL;
+  AUBIO_MEMCPY (kernel->data, sre + first, len * sizeof(smpl_t));
+  AUBIO_MEMCPY (kernel->data + len, sim + first, len * sizeof(smpl_t));
+  oct->start[b] = first;
+  oct->kernels[b] = kernel;
+  return AUBIO_OK;
+}
+
+static uint_t
+aubio_cqt_octave_init (aubio_cqt_t * o, aubio_cqt_octave_t * oct)
+{
+  lsmp_t q = 1. / (POW (2., 1. / o->bins_per_octave) - 1.);
+  lsmp_t sr = (lsmp_t) o->samplerate / (1 << oct->stage);
+  lsmp_t flow = aubio_cqt_get_freq (o, oct->first);
+  uint_t b, err = AUBIO_OK;
+  fvec_t *tmp;
+  // long enough for the window of the lowest bin
+  oct->size = aubio_next_power_of_two ((uint_t) CEIL (q * sr / flow));
+  oct->size = MAX (oct->size, 4);
+  oct->fft = new_aubio_fft (oct->size);
+  oct->frame = new_fvec (oct->size);
+  oct->compspec = new_fvec (oct->size);
+  oct->spec = new_fvec (2 * (oct->size / 2 + 1));
+  oct->start = AUBIO_ARRAY (uint_t, oct->n_bins);
+  oct->kernels = AUBIO_ARRAY (fvec_t *, oct->n_bins);
+  tmp = new_fvec (4 * (oct->size / 2 + 1));
+  if (!oct->fft || !oct->frame || !oct->compspec || !oct->spec
+      || !oct->start || !oct->kernels || !tmp) {
+    err = AUBIO_FAIL;
+  }
+  for (b = 0; b < oct->n_bins && !err; b++) {
+    lsmp_t freq = aubio_cqt_get_freq (o, oct->first + b) / sr;
+    err = aubio_cqt_octave_kernel (oct, b, freq, q, tmp);
+  }
+  if (tmp) del_fvec (tmp);
+  return err;
+}
+
+static void
+aubio_cqt_octave_free (aubio_cqt_octave_t * oct)
+{
+  uint_t b;
+  if (oct->kernels) {
+    for (b = 0; b < oct->n_bins; b++) {
+      if (oct->kernels[b]) del_fvec (oct->kernels[b]);
+    }
+    AUBIO_FREE (oct->kernels);
+  }
+  if (oct->start) AUBIO_FREE (oct->start);
+  if (oct->fft) del_aubio_fft (oct->fft);
+  if (oct->frame) del_fvec (oct->frame);
+  if (oct->compspec) del_fvec (oct->compspec);
+  if (oct->spec) del_fvec (oct->spec);
+}
+
+static void
+aubio_cqt_octave_do (aubio_cqt_octave_t * oct, const fvec_t * signal,
+    smpl_t * output)
+{
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  uint_t b, n = signal->length, size = oct->size, bins = size / 2 + 1;
+  const smpl_t *sre = oct->spec->data, *sim = oct->spec->data + bins;
+  // slide the frame
+  if (n < size) {
+    memmove (oct->frame->data, oct->frame->data + n,
+        (size - n) * sizeof(smpl_t));
+    AUBIO_MEMCPY (oct->frame->data + size - n, signal->data,
+        n * sizeof(smpl_t));
+  } else {
+    AUBIO_MEMCPY (oct->frame->data, signal->data + n - size,
+        size * sizeof(smpl_t));
+  }
+  aubio_fft_do_complex (oct->fft, oct->frame, oct->compspec);
+  aubio_cqt_split (oct->compspec->data, oct->spec->data, size);
+  // complex products with the non-zero part of each kernel
+  for (b = 0; b < oct->n_bins; b++) {
+    const fvec_t *kernel = oct->kernels[b];
+    uint_t s = oct->start[b], len = kernel->length / 2;
+    const smpl_t *kr = kernel->data, *ki = kernel->data + len;
+    smpl_t re = ops->dot (sre + s, kr, len) - ops->dot (sim + s, ki, len);
+    smpl_t im = ops->dot (sre + s, ki, len) + ops->dot (sim + s, kr, len);
+    output[oct->first + b] = SQRT (re * re + im * im);
+  }
+}
+
+aubio_cqt_t *
+new_aubio_cqt (smpl_t fmin, smpl_t fmax, uint_t bins_per_octave,
+    uint_t hop_size, uint_t samplerate)
+{
+  aubio_cqt_t *o = AUBIO_NEW (aubio_cqt_t);
+  uint_t k, s;
+  lsmp_t q;
+  if (!o) return NULL;
+  if ((sint_t)bins_per_octave < 1) {
+    AUBIO_ERR ("cqt: got %d bins per octave, but can not be < 1\n",
+        bins_per_octave);
+    goto beach;
+  }
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR ("cqt: got hop_size %d, but can not be < 1\n", hop_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 1) {
+    AUBIO_ERR ("cqt: samplerate (%d) can not be < 1\n", samplerate);
+    goto beach;
+  }
+  if (fmin <= 0. || fmax < fmin || fmax >= samplerate / 2.) {
+    AUBIO_ERR ("cqt: expected 0 < fmin <= fmax < %.1f, got %f and %f\n",
+        samplerate / 2., fmin, fmax);
+    goto beach;
+  }
+  o->fmin = fmin;
+  o->bins_per_octave = bins_per_octave;
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+  // rounded, so that fmax is included when it is on a bin
+  o->n_bins = (uint_t) FLOOR (bins_per_octave * LOG (fmax / fmin) / LOG (2.)
+      + 1.e-3) + 1;
+  o->n_octaves = (o->n_bins + bins_per_octave - 1) / bins_per_octave;
+  o->octaves = AUBIO_ARRAY (aubio_cqt_octave_t, o->n_octaves);
+  if (!o->octaves) goto beach;
+  // each octave on the most decimated signal leaving its bins untouched,
+  // including the bandwidth of its highest bin
+  q = 1. / (POW (2., 1. / bins_per_octave) - 1.);
+  for (k = 0; k < o->n_octaves; k++) {
+    aubio_cqt_octave_t *oct = &o->octaves[k];
+    lsmp_t ftop;
+    uint_t last = o->n_bins - 1 - k * bins_per_octave;
+    oct->first = (last + 1 > bins_per_octave) ? last + 1 - bins_per_octave : 0;
+    oct->n_bins = last + 1 - oct->first;
+    ftop = aubio_cqt_get_freq (o, last) * (1. + 1. / q);
+    while (ftop * (2 << oct->stage) <= AUBIO_CQT_PASSBAND * samplerate
+        && oct->stage < 16) {
+      oct->stage++;
+    }
+  }
+  o->n_stages = o->octaves[o->n_octaves - 1].stage;
+  if (hop_size % (1 << o->n_stages) != 0) {
+    AUBIO_ERR ("cqt: hop_size should be a multiple of %d, got %d\n",
+        1 << o->n_stages, hop_size);
+    goto beach;
+  }
+  for (k = 0; k < o->n_octaves; k++) {
+    if (aubio_cqt_octave_init (o, &o->octaves[k])) goto beach;
+  }
+  if (o->n_stages > 0) {
+    o->decimators = AUBIO_ARRAY (aubio_decimator_t *, o->n_stages);
+    o->signals = AUBIO_ARRAY (fvec_t *, o->n_stages);
+    if (!o->decimators || !o->signals) goto beach;
+    for (s = 0; s < o->n_stages; s++) {
+      o->decimators[s] = new_aubio_decimator (2);
+      o->signals[s] = new_fvec (hop_size >> (s + 1));
+      if (!o->decimators[s] || !o->signals[s]) goto beach;
+    }
+  }
+  return o;
+beach:
+  del_aubio_cqt (o);
+  return NULL;
+}
+
+void
+aubio_cqt_do (aubio_cqt_t * o, const fvec_t * input, fvec_t * output)
+{
+  uint_t k, s;
+  if (input->length != o->hop_size || output->length != o->n_bins) {
+    AUBIO_ERR ("cqt: expected an input of %d samples and an output of %d"
+        " bins, got %d and %d\n", o->hop_size, o->n_bins, input->length,
+        output->length);
+    return;
+  }
+  for (s = 0; s < o->n_stages; s++) {
+    aubio_decimator_do (o->decimators[s], s ? o->signals[s - 1] : input,
+        o->signals[s]);
+  }
+  for (k = 0; k < o->n_octaves; k++) {
+    aubio_cqt_octave_t *oct = &o->octaves[k];
+    const fvec_t *signal = oct->stage ? o->signals[oct->stage - 1] : input;
+    aubio_cqt_octave_do (oct, signal, output->data);
+  }
+}
+
+uint_t
+aubio_cqt_get_n_bins (const aubio_cqt_t * o)
+{
+  return o->n_bins;
+}
+
+smpl_t
+aubio_cqt_get_freq (const aubio_cqt_t * o, uint_t bin)
+{
+  if (bin >= o->n_bins) return 0.;
+  return o->fmin * POW (2., (smpl_t) bin / o->bins_per_octave);
+}
+
+void
+aubio_cqt_reset (aubio_cqt_t * o)
+{
+  uint_t k, s;
+  for (k = 0; k < o->n_octaves; k++) {
+    fvec_zeros (o->octaves[k].frame);
+  }
+  for (s = 0; s < o->n_stages; s++) {
+    aubio_decimator_reset (o->decimators[s]);
+  }
+}
+
+void
+del_aubio_cqt (aubio_cqt_t * o)
+{
+  uint_t k, s;
+  if (o->octaves) {
+    for (k = 0; k < o->n_octaves; k++) {
+      aubio_cqt_octave_free (&o->octaves[k]);
+    }
+    AUBIO_FREE (o->octaves);
+  }
+  if (o->decimators) {
+    for (s = 0; s < o->n_stages; s++) {
+      if (o->decimators[s]) del_aubio_decimator (o->decimators[s]);
+    }
+    AUBIO_FREE (o->decimators);
+  }
+  if (o->signals) {
+    for (s = 0; s < o->n_stages; s++) {
+      if (o->signals[s]) del_fvec (o->signals[s]);
+    }
+    AUBIO_FREE (o->signals);
+  }
+  AUBIO_FREE (o);
+}
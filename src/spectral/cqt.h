@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Constant-Q transform
+
+  This object computes the magnitude of a spectrum with logarithmically
+  spaced bins, a fixed number per octave, each bin having a bandwidth
+  proportional to its frequency. This matches musical pitch and hearing
+  better than the linear bins of aubio_fft_t, for instance to map a spectrum
+  to a strip of LEDs.
+
+  The bins are grouped by octave. The bins of each octave are computed from
+  the FFT of the signal, multiplied with the sparse spectra of their
+  windowed complex exponentials (Brown and Puckette, 1992). The lower
+  octaves are computed on the signal decimated with aubio_decimator_t, as
+  far as the half-band filters leave their bins untouched, so that all
+  octaves use short transforms and the cost grows with the number of
+  octaves, not with the length of the longest window.
+
+  The window of each bin ends on the last input sample. The windows of the
+  decimated octaves are delayed by the decimators, of about 30 samples of
+  input for the first one, and twice more for each next one.
+
+  \example spectral/test-cqt.c
+
+*/
+
+#ifndef AUBIO_CQT_H
+#define AUBIO_CQT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** constant-Q transform object */
+typedef struct _aubio_cqt_t aubio_cqt_t;
+
+/** create a constant-Q transform object
+
+  \param fmin frequency of the lowest bin, in Hz
+  \param fmax highest frequency, in Hz, below half the samplerate
+  \param bins_per_octave number of bins in each octave
+  \param hop_size number of new samples at each call, a multiple of the
+  decimation factor of the lowest octave
+  \param samplerate samplerate of the signal
+
+  \return the newly created object, or NULL on failure
+
+  The bins are at `fmin * 2^(k / bins_per_octave)`, up to `fmax`.
+
+*/
+aubio_cqt_t *new_aubio_cqt (smpl_t fmin, smpl_t fmax, uint_t bins_per_octave,
+    uint_t hop_size, uint_t samplerate);
+
+/** compute the constant-Q spectrum of the last input
+
+  \param o constant-Q object as returned by new_aubio_cqt()
+  \param input new input samples, of length `hop_size`
+  \param output magnitude of each bin, from the lowest, of length
+  aubio_cqt_get_n_bins()
+
+  A sine of amplitude 1 at the frequency of a bin gives a magnitude of
+  about 1 in that bin.
+
+*/
+void aubio_cqt_do (aubio_cqt_t * o, const fvec_t * input, fvec_t * output);
+
+/** get the number of bins of the constant-Q spectrum
+
+  \param o constant-Q object as returned by new_aubio_cqt()
+
+  \return number of bins
+
+*/
+uint_t aubio_cqt_get_n_bins (const aubio_cqt_t * o);
+
+/** get the frequency of a bin
+
+  \param o constant-Q object as returned by new_aubio_cqt()
+  \param bin bin index, from 0 to aubio_cqt_get_n_bins() - 1
+
+  \return frequency of the bin, in Hz, or 0 if bin is out of range
+
+*/
+smpl_t aubio_cqt_get_freq (const aubio_cqt_t * o, uint_t bin);
+
+/** clear the past input of the constant-Q transform
+
+  \param o constant-Q object as returned by new_aubio_cqt()
+
+*/
+void aubio_cqt_reset (aubio_cqt_t * o);
+
+/** delete a constant-Q transform object
+
+  \param o constant-Q object as returned by new_aubio_cqt()
+
+*/
+void del_aubio_cqt (aubio_cqt_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_CQT_H */
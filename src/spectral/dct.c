@@ -32,12 +32,15 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "spectral/dct.h"
 
 // function pointers prototypes
 typedef void (*aubio_dct_do_t)(aubio_dct_t * s, const fvec_t * input, fvec_t * output);
 typedef void (*aubio_dct_rdo_t)(aubio_dct_t * s, const fvec_t * input, fvec_t * output);
+typedef void (*aubio_dct_do_batch_t)(aubio_dct_t * s, const fmat_t * input, fmat_t * output);
 typedef void (*del_aubio_dct_t)(aubio_dct_t * s);
+typedef uint_t (*aubio_dct_get_memory_usage_t)(const aubio_dct_t * s);
 
 #if defined(HAVE_ACCELERATE)
 typedef struct _aubio_dct_accelerate_t aubio_dct_accelerate_t;
@@ -45,24 +48,32 @@ extern aubio_dct_accelerate_t * new_aubio_dct_accelerate (uint_t size);
 extern void aubio_dct_accelerate_do(aubio_dct_accelerate_t *s, const fvec_t *input, fvec_t *output);
 extern void aubio_dct_accelerate_rdo(aubio_dct_accelerate_t *s, const fvec_t *input, fvec_t *output);
 extern void del_aubio_dct_accelerate (aubio_dct_accelerate_t *s);
+extern uint_t aubio_dct_accelerate_get_memory_usage (const aubio_dct_accelerate_t *s);
 #elif defined(HAVE_FFTW3)
 typedef struct _aubio_dct_fftw_t aubio_dct_fftw_t;
 extern aubio_dct_fftw_t * new_aubio_dct_fftw (uint_t size);
 extern void aubio_dct_fftw_do(aubio_dct_fftw_t *s, const fvec_t *input, fvec_t *output);
 extern void aubio_dct_fftw_rdo(aubio_dct_fftw_t *s, const fvec_t *input, fvec_t *output);
+extern void aubio_dct_fftw_do_batch(aubio_dct_fftw_t *s, const fmat_t *input, fmat_t *output);
+extern void aubio_dct_fftw_rdo_batch(aubio_dct_fftw_t *s, const fmat_t *input, fmat_t *output);
 extern void del_aubio_dct_fftw (aubio_dct_fftw_t *s);
+extern uint_t aubio_dct_fftw_get_memory_usage (const aubio_dct_fftw_t *s);
 #elif defined(HAVE_INTEL_IPP)
 typedef struct _aubio_dct_ipp_t aubio_dct_ipp_t;
 extern aubio_dct_ipp_t * new_aubio_dct_ipp (uint_t size);
 extern void aubio_dct_ipp_do(aubio_dct_ipp_t *s, const fvec_t *input, fvec_t *output);
 extern void aubio_dct_ipp_rdo(aubio_dct_ipp_t *s, const fvec_t *input, fvec_t *output);
 extern void del_aubio_dct_ipp (aubio_dct_ipp_t *s);
+extern uint_t aubio_dct_ipp_get_memory_usage (const aubio_dct_ipp_t *s);
 #else
 typedef struct _aubio_dct_ooura_t aubio_dct_ooura_t;
 extern aubio_dct_ooura_t * new_aubio_dct_ooura (uint_t size);
 extern void aubio_dct_ooura_do(aubio_dct_ooura_t *s, const fvec_t *input, fvec_t *output);
 extern void aubio_dct_ooura_rdo(aubio_dct_ooura_t *s, const fvec_t *input, fvec_t *output);
+extern void aubio_dct_ooura_do_batch(aubio_dct_ooura_t *s, const fmat_t *input, fmat_t *output);
+extern void aubio_dct_ooura_rdo_batch(aubio_dct_ooura_t *s, const fmat_t *input, fmat_t *output);
 extern void del_aubio_dct_ooura (aubio_dct_ooura_t *s);
+extern uint_t aubio_dct_ooura_get_memory_usage (const aubio_dct_ooura_t *s);
 #endif
 
 // plain mode
@@ -70,13 +81,20 @@ typedef struct _aubio_dct_plain_t aubio_dct_plain_t;
 extern aubio_dct_plain_t * new_aubio_dct_plain (uint_t size);
 extern void aubio_dct_plain_do(aubio_dct_plain_t *s, const fvec_t *input, fvec_t *output);
 extern void aubio_dct_plain_rdo(aubio_dct_plain_t *s, const fvec_t *input, fvec_t *output);
+extern void aubio_dct_plain_do_batch(aubio_dct_plain_t *s, const fmat_t *input, fmat_t *output);
+extern void aubio_dct_plain_rdo_batch(aubio_dct_plain_t *s, const fmat_t *input, fmat_t *output);
 extern void del_aubio_dct_plain (aubio_dct_plain_t *s);
+extern uint_t aubio_dct_plain_get_memory_usage (const aubio_dct_plain_t *s);
 
 struct _aubio_dct_t {
   void *dct;
   aubio_dct_do_t dct_do;
   aubio_dct_rdo_t dct_rdo;
+  aubio_dct_do_batch_t dct_do_batch;   // NULL to transform each row
+  aubio_dct_do_batch_t dct_rdo_batch;  // NULL to transform each row
+  uint_t size;
   del_aubio_dct_t del_dct;
+  aubio_dct_get_memory_usage_t get_memory_usage;
 };
 
 aubio_dct_t* new_aubio_dct (uint_t size) {
@@ -85,6 +103,7 @@ aubio_dct_t* new_aubio_dct (uint_t size) {
   if (!s) {
     return NULL;
   }
+  s->size = size;
 #if defined(HAVE_ACCELERATE)
   // vDSP supports sizes = f * 2 ** n, where n >= 4 and f in [1, 3, 5, 15]
   // see https://developer.apple.com/documentation/accelerate/1449930-vdsp_dct_createsetup
@@ -104,6 +123,8 @@ aubio_dct_t* new_aubio_dct (uint_t size) {
     s->dct_do = (aubio_dct_do_t)aubio_dct_accelerate_do;
     s->dct_rdo = (aubio_dct_rdo_t)aubio_dct_accelerate_rdo;
     s->del_dct = (del_aubio_dct_t)del_aubio_dct_accelerate;
+    s->get_memory_usage =
+      (aubio_dct_get_memory_usage_t)aubio_dct_accelerate_get_memory_usage;
     return s;
   }
 #elif defined(HAVE_FFTW3)
@@ -112,7 +133,11 @@ aubio_dct_t* new_aubio_dct (uint_t size) {
   if (s->dct) {
     s->dct_do = (aubio_dct_do_t)aubio_dct_fftw_do;
     s->dct_rdo = (aubio_dct_rdo_t)aubio_dct_fftw_rdo;
+    s->dct_do_batch = (aubio_dct_do_batch_t)aubio_dct_fftw_do_batch;
+    s->dct_rdo_batch = (aubio_dct_do_batch_t)aubio_dct_fftw_rdo_batch;
     s->del_dct = (del_aubio_dct_t)del_aubio_dct_fftw;
+    s->get_memory_usage =
+      (aubio_dct_get_memory_usage_t)aubio_dct_fftw_get_memory_usage;
     return s;
   } else {
     AUBIO_WRN("dct: unexpected error while creating dct_fftw with size %d\n",
@@ -126,6 +151,8 @@ aubio_dct_t* new_aubio_dct (uint_t size) {
     s->dct_do = (aubio_dct_do_t)aubio_dct_ipp_do;
     s->dct_rdo = (aubio_dct_rdo_t)aubio_dct_ipp_rdo;
     s->del_dct = (del_aubio_dct_t)del_aubio_dct_ipp;
+    s->get_memory_usage =
+      (aubio_dct_get_memory_usage_t)aubio_dct_ipp_get_memory_usage;
     return s;
   } else {
     AUBIO_WRN("dct: unexpected error while creating dct_ipp with size %d\n",
@@ -141,7 +168,11 @@ aubio_dct_t* new_aubio_dct (uint_t size) {
   if (s->dct) {
     s->dct_do = (aubio_dct_do_t)aubio_dct_ooura_do;
     s->dct_rdo = (aubio_dct_rdo_t)aubio_dct_ooura_rdo;
+    s->dct_do_batch = (aubio_dct_do_batch_t)aubio_dct_ooura_do_batch;
+    s->dct_rdo_batch = (aubio_dct_do_batch_t)aubio_dct_ooura_rdo_batch;
     s->del_dct = (del_aubio_dct_t)del_aubio_dct_ooura;
+    s->get_memory_usage =
+      (aubio_dct_get_memory_usage_t)aubio_dct_ooura_get_memory_usage;
     return s;
   }
 #endif
@@ -153,7 +184,11 @@ plain:
   if (s->dct) {
     s->dct_do = (aubio_dct_do_t)aubio_dct_plain_do;
     s->dct_rdo = (aubio_dct_rdo_t)aubio_dct_plain_rdo;
+    s->dct_do_batch = (aubio_dct_do_batch_t)aubio_dct_plain_do_batch;
+    s->dct_rdo_batch = (aubio_dct_do_batch_t)aubio_dct_plain_rdo_batch;
     s->del_dct = (del_aubio_dct_t)del_aubio_dct_plain;
+    s->get_memory_usage =
+      (aubio_dct_get_memory_usage_t)aubio_dct_plain_get_memory_usage;
     return s;
   } else {
     goto beach;
@@ -169,6 +204,10 @@ void del_aubio_dct(aubio_dct_t *s) {
   AUBIO_FREE (s);
 }
 
+uint_t aubio_dct_get_memory_usage(const aubio_dct_t *s) {
+  return aubio_malloc_size(s) + s->get_memory_usage ((const void *)s->dct);
+}
+
 void aubio_dct_do(aubio_dct_t *s, const fvec_t *input, fvec_t *output) {
   s->dct_do ((void *)s->dct, input, output);
 }
@@ -176,3 +215,51 @@ void aubio_dct_do(aubio_dct_t *s, const fvec_t *input, fvec_t *output) {
 void aubio_dct_rdo(aubio_dct_t *s, const fvec_t *input, fvec_t *output) {
   s->dct_rdo ((void *)s->dct, input, output);
 }
+
+static uint_t aubio_dct_check_batch(const aubio_dct_t *s, const fmat_t *input,
+    const fmat_t *output) {
+  if (input->length != s->size || output->length != s->size
+      || output->height < input->height) {
+    AUBIO_ERR("dct: batch of %dx%d frames does not fit dct of size %d"
+        " and %dx%d output\n", input->height, input->length, s->size,
+        output->height, output->length);
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_dct_do_batch(aubio_dct_t *s, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i;
+  fvec_t in, out;
+  if (aubio_dct_check_batch(s, input, output)) return AUBIO_FAIL;
+  if (s->dct_do_batch) {
+    s->dct_do_batch ((void *)s->dct, input, output);
+    return AUBIO_OK;
+  }
+  in.length = out.length = s->size;
+  for (i = 0; i < input->height; i++) {
+    in.data = input->data[i];
+    out.data = output->data[i];
+    s->dct_do ((void *)s->dct, &in, &out);
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_dct_rdo_batch(aubio_dct_t *s, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i;
+  fvec_t in, out;
+  if (aubio_dct_check_batch(s, input, output)) return AUBIO_FAIL;
+  if (s->dct_rdo_batch) {
+    s->dct_rdo_batch ((void *)s->dct, input, output);
+    return AUBIO_OK;
+  }
+  in.length = out.length = s->size;
+  for (i = 0; i < input->height; i++) {
+    in.data = input->data[i];
+    out.data = output->data[i];
+    s->dct_rdo ((void *)s->dct, &in, &out);
+  }
+  return AUBIO_OK;
+}
@@ -42,6 +42,10 @@ extern "C" {
   This object computes forward and backward DCT type 2 with orthonormal
   scaling.
 
+  The tables of a transform, its coefficient matrices, twiddle factors or
+  plans, are computed once for each size, and shared by all the objects of
+  that size.
+
 */
 typedef struct _aubio_dct_t aubio_dct_t;
 
@@ -71,6 +75,44 @@ void aubio_dct_do (aubio_dct_t *s, const fvec_t * input, fvec_t * dct_output);
 void aubio_dct_rdo (aubio_dct_t *s, const fvec_t * input, fvec_t * idct_output);
 
 
+/** compute forward DCT of several frames
+
+  \param s dct object as returned by new_aubio_dct
+  \param input one frame per row, each of the size of the DCT
+  \param dct_output transformed frames, with at least as many rows as input
+
+  \return 0 if successful, non-zero if the matrices do not fit the DCT
+
+  Row `i` of `dct_output` is the same as the output of aubio_dct_do() on row
+  `i` of `input`, for instance to compute the cepstrum of the log-mel bands of
+  a whole file at once.
+
+*/
+uint_t aubio_dct_do_batch (aubio_dct_t *s, const fmat_t * input,
+    fmat_t * dct_output);
+
+/** compute backward DCT of several frames
+
+  \param s dct object as returned by new_aubio_dct
+  \param input one transformed frame per row, each of the size of the DCT
+  \param idct_output frames, with at least as many rows as input
+
+  \return 0 if successful, non-zero if the matrices do not fit the DCT
+
+*/
+uint_t aubio_dct_rdo_batch (aubio_dct_t *s, const fmat_t * input,
+    fmat_t * idct_output);
+
+/** get the memory used by a DCT object
+
+  \param s dct object as returned by new_aubio_dct
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_dct_get_memory_usage (const aubio_dct_t * s);
+
 /** delete DCT object
 
   \param s dct object as returned by new_aubio_dct
@@ -20,6 +20,7 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "spectral/dct.h"
 
 #if defined(HAVE_ACCELERATE)
@@ -73,6 +74,11 @@ void del_aubio_dct_accelerate(aubio_dct_accelerate_t *s) {
   AUBIO_FREE(s);
 }
 
+uint_t aubio_dct_accelerate_get_memory_usage(const aubio_dct_accelerate_t *s) {
+  // the setups are allocated by vDSP
+  return aubio_malloc_size(s) + aubio_malloc_size(s->tmp);
+}
+
 void aubio_dct_accelerate_do(aubio_dct_accelerate_t *s, const fvec_t *input, fvec_t *output) {
 
   vDSP_DCT_Execute(s->setup, (const float *)input->data, (float *)output->data);
@@ -20,6 +20,7 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "spectral/dct.h"
 
 #ifdef HAVE_FFTW3
@@ -41,6 +42,7 @@
 #define fftw_malloc            fftwf_malloc
 #define fftw_free              fftwf_free
 #define fftw_execute           fftwf_execute
+#define fftw_execute_r2r       fftwf_execute_r2r
 #define fftw_plan_dft_r2c_1d   fftwf_plan_dft_r2c_1d
 #define fftw_plan_dft_c2r_1d   fftwf_plan_dft_c2r_1d
 #define fftw_plan_r2r_1d       fftwf_plan_r2r_1d
@@ -53,14 +55,91 @@ extern pthread_mutex_t aubio_fftw_mutex;
 
 typedef struct _aubio_dct_fftw_t aubio_dct_fftw_t;
 
-struct _aubio_dct_fftw_t {
+/** forward and backward plans of one size, shared by all the fftw dcts
+
+  The plans are executed with fftw_execute_r2r on the arrays of each dct,
+  allocated with fftw_malloc like the ones they were planned on.
+
+*/
+typedef struct _aubio_dct_fftw_plans_t {
   uint_t size;
-  fvec_t *in, *out;
-  smpl_t *data;
+  uint_t refcount;
   fftw_plan pfw, pbw;
+  struct _aubio_dct_fftw_plans_t *next;
+} aubio_dct_fftw_plans_t;
+
+/** list of shared plans, protected by aubio_fftw_mutex */
+static aubio_dct_fftw_plans_t *aubio_dct_fftw_plans = NULL;
+
+struct _aubio_dct_fftw_t {
+  uint_t size;
+  smpl_t *in, *data, *out;
+  aubio_dct_fftw_plans_t *plans;
   smpl_t scalers[5];
 };
 
+static aubio_dct_fftw_plans_t *aubio_dct_fftw_plans_acquire (uint_t size)
+{
+  aubio_dct_fftw_plans_t *plans;
+  smpl_t *in, *data;
+  AUBIO_RT_CHECK("fftw mutex");
+  pthread_mutex_lock(&aubio_fftw_mutex);
+  for (plans = aubio_dct_fftw_plans; plans; plans = plans->next) {
+    if (plans->size == size) {
+      plans->refcount++;
+      pthread_mutex_unlock(&aubio_fftw_mutex);
+      return plans;
+    }
+  }
+  plans = AUBIO_NEW(aubio_dct_fftw_plans_t);
+  /* scratch arrays, only used during planning */
+  in = (smpl_t *)fftw_malloc(sizeof(smpl_t) * size);
+  data = (smpl_t *)fftw_malloc(sizeof(smpl_t) * size);
+  if (plans && in && data) {
+    plans->pfw = fftw_plan_r2r_1d(size, in, data, FFTW_REDFT10,
+        FFTW_ESTIMATE);
+    plans->pbw = fftw_plan_r2r_1d(size, data, in, FFTW_REDFT01,
+        FFTW_ESTIMATE);
+  }
+  if (in) fftw_free(in);
+  if (data) fftw_free(data);
+  if (plans && (!plans->pfw || !plans->pbw)) {
+    if (plans->pfw) fftw_destroy_plan(plans->pfw);
+    if (plans->pbw) fftw_destroy_plan(plans->pbw);
+    AUBIO_FREE(plans);
+    plans = NULL;
+  }
+  if (plans) {
+    plans->size = size;
+    plans->refcount = 1;
+    plans->next = aubio_dct_fftw_plans;
+    aubio_dct_fftw_plans = plans;
+  }
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return plans;
+}
+
+static void aubio_dct_fftw_plans_release (aubio_dct_fftw_plans_t *plans)
+{
+  aubio_dct_fftw_plans_t **p;
+  AUBIO_RT_CHECK("fftw mutex");
+  pthread_mutex_lock(&aubio_fftw_mutex);
+  if (--plans->refcount == 0) {
+    for (p = &aubio_dct_fftw_plans; *p; p = &(*p)->next) {
+      if (*p == plans) {
+        *p = plans->next;
+        break;
+      }
+    }
+    fftw_destroy_plan(plans->pfw);
+    fftw_destroy_plan(plans->pbw);
+    AUBIO_FREE(plans);
+  }
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+}
+
+void del_aubio_dct_fftw(aubio_dct_fftw_t *s);
+
 aubio_dct_fftw_t * new_aubio_dct_fftw (uint_t size) {
   aubio_dct_fftw_t * s = AUBIO_NEW(aubio_dct_fftw_t);
   
@@ -73,15 +152,13 @@ aubio_dct_fftw_t * new_aubio_dct_fftw (uint_t size) {
     goto beach;
   }
   s->size = size;
-  s->in = new_fvec(size);
-  s->out = new_fvec(size);
-  pthread_mutex_lock(&aubio_fftw_mutex);
+  s->in = (smpl_t *)fftw_malloc(sizeof(smpl_t) * size);
   s->data = (smpl_t *)fftw_malloc(sizeof(smpl_t) * size);
-  s->pfw = fftw_plan_r2r_1d(size, s->in->data,  s->data, FFTW_REDFT10,
-      FFTW_ESTIMATE);
-  s->pbw = fftw_plan_r2r_1d(size, s->data, s->out->data, FFTW_REDFT01,
-      FFTW_ESTIMATE);
-  pthread_mutex_unlock(&aubio_fftw_mutex);
+  s->out = (smpl_t *)fftw_malloc(sizeof(smpl_t) * size);
+  s->plans = aubio_dct_fftw_plans_acquire(size);
+  if (!s->in || !s->data || !s->out || !s->plans) {
+    goto beach;
+  }
   s->scalers[0] = SQRT(1./(4.*s->size));
   s->scalers[1] = SQRT(1./(2.*s->size));
   s->scalers[2] = 1. / s->scalers[0];
@@ -89,46 +166,81 @@ aubio_dct_fftw_t * new_aubio_dct_fftw (uint_t size) {
   s->scalers[4] = .5 / s->size;
   return s;
 beach:
-  AUBIO_FREE(s);
+  del_aubio_dct_fftw(s);
   return NULL;
 }
 
 void del_aubio_dct_fftw(aubio_dct_fftw_t *s) {
-  pthread_mutex_lock(&aubio_fftw_mutex);
-  fftw_destroy_plan(s->pfw);
-  fftw_destroy_plan(s->pbw);
-  fftw_free(s->data);
-  pthread_mutex_unlock(&aubio_fftw_mutex);
-  del_fvec(s->in);
-  del_fvec(s->out);
+  if (s->plans) aubio_dct_fftw_plans_release(s->plans);
+  if (s->in) fftw_free(s->in);
+  if (s->data) fftw_free(s->data);
+  if (s->out) fftw_free(s->out);
   AUBIO_FREE(s);
 }
 
-void aubio_dct_fftw_do(aubio_dct_fftw_t *s, const fvec_t *input, fvec_t *output) {
+uint_t aubio_dct_fftw_get_memory_usage(const aubio_dct_fftw_t *s) {
+  // the shared plans are not counted
+  return aubio_malloc_size(s) + 3 * sizeof(smpl_t) * s->size;
+}
+
+/* transform s->size samples of input into output, which may be the same */
+static void aubio_dct_fftw_forward(aubio_dct_fftw_t *s, const smpl_t *input,
+    smpl_t *output, uint_t length) {
   uint_t i;
-  fvec_copy(input, s->in);
-  fftw_execute(s->pfw);
-  //fvec_copy(s->out, output);
+  memcpy(s->in, input, s->size * sizeof(smpl_t));
+  fftw_execute_r2r(s->plans->pfw, s->in, s->data);
   s->data[0] *= s->scalers[0];
   for (i = 1; i < s->size; i++) {
     s->data[i] *= s->scalers[1];
   }
-  memcpy(output->data, s->data, output->length * sizeof(smpl_t));
+  memcpy(output, s->data, length * sizeof(smpl_t));
 }
 
-void aubio_dct_fftw_rdo(aubio_dct_fftw_t *s, const fvec_t *input, fvec_t *output) {
+static void aubio_dct_fftw_backward(aubio_dct_fftw_t *s, const smpl_t *input,
+    smpl_t *output, uint_t length) {
   uint_t i;
-  memcpy(s->data, input->data, input->length * sizeof(smpl_t));
-  //s->data[0] *= .5;
-  s->data[0] *= s->scalers[2];
+  s->data[0] = input[0] * s->scalers[2];
   for (i = 1; i < s->size; i++) {
-    s->data[i] *= s->scalers[3];
+    s->data[i] = input[i] * s->scalers[3];
+  }
+  fftw_execute_r2r(s->plans->pbw, s->data, s->out);
+  for (i = 0; i < length; i++) {
+    output[i] = s->out[i] * s->scalers[4];
+  }
+}
+
+void aubio_dct_fftw_do(aubio_dct_fftw_t *s, const fvec_t *input, fvec_t *output) {
+  if (input->length != s->size || output->length > s->size) {
+    AUBIO_ERR("dct_fftw: can not transform %d elements to %d elements"
+        " with size %d\n", input->length, output->length, s->size);
+    return;
+  }
+  aubio_dct_fftw_forward(s, input->data, output->data, output->length);
+}
+
+void aubio_dct_fftw_rdo(aubio_dct_fftw_t *s, const fvec_t *input, fvec_t *output) {
+  if (input->length != s->size || output->length > s->size) {
+    AUBIO_ERR("dct_fftw: can not transform %d elements to %d elements"
+        " with size %d\n", input->length, output->length, s->size);
+    return;
+  }
+  aubio_dct_fftw_backward(s, input->data, output->data, output->length);
+}
+
+void aubio_dct_fftw_do_batch(aubio_dct_fftw_t *s, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i;
+  for (i = 0; i < input->height; i++) {
+    aubio_dct_fftw_forward(s, input->data[i], output->data[i], s->size);
   }
-  fftw_execute(s->pbw);
-  for (i = 0; i < s->size; i++) {
-    s->out->data[i] *= s->scalers[4];
+}
+
+void aubio_dct_fftw_rdo_batch(aubio_dct_fftw_t *s, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i;
+  for (i = 0; i < input->height; i++) {
+    aubio_dct_fftw_backward(s, input->data[i], output->data[i], s->size);
   }
-  fvec_copy(s->out, output);
 }
 
 #endif //HAVE_FFTW3
@@ -20,6 +20,7 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "spectral/dct.h"
 
 #if defined(HAVE_INTEL_IPP)
@@ -137,6 +138,11 @@ void del_aubio_dct_ipp(aubio_dct_ipp_t *s) {
   AUBIO_FREE(s);
 }
 
+uint_t aubio_dct_ipp_get_memory_usage(const aubio_dct_ipp_t *s) {
+  // the buffers of ippsMalloc are not counted
+  return aubio_malloc_size(s);
+}
+
 void aubio_dct_ipp_do(aubio_dct_ipp_t *s, const fvec_t *input, fvec_t *output) {
 
   aubio_ippsDCTFwd((const aubio_IppFloat*)input->data,
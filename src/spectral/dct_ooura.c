@@ -20,22 +20,109 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "spectral/dct.h"
 
 #if !defined(HAVE_ACCELERATE) && !defined(HAVE_FFTW3) && !defined(HAVE_INTEL_IPP)
 
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_dct_ooura_lock = SRWLOCK_INIT;
+#define AUBIO_DCT_OOURA_LOCK()   AcquireSRWLockExclusive(&aubio_dct_ooura_lock)
+#define AUBIO_DCT_OOURA_UNLOCK() ReleaseSRWLockExclusive(&aubio_dct_ooura_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t aubio_dct_ooura_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_DCT_OOURA_LOCK()   pthread_mutex_lock(&aubio_dct_ooura_mutex)
+#define AUBIO_DCT_OOURA_UNLOCK() pthread_mutex_unlock(&aubio_dct_ooura_mutex)
+#endif
+
 typedef struct _aubio_dct_ooura_t aubio_dct_ooura_t;
 
 extern void aubio_ooura_ddct(int, int, smpl_t *, int *, smpl_t *);
 
-struct _aubio_dct_ooura_t {
+/** tables of one size, shared by all the ooura dcts
+
+  aubio_ooura_ddct fills w and ip on its first call, made once when the
+  tables are created; after that, it only reads them.
+
+*/
+typedef struct _aubio_dct_ooura_tables_t {
   uint_t size;
-  fvec_t *input;
   smpl_t *w;
   int *ip;
+  uint_t refcount;
+  struct _aubio_dct_ooura_tables_t *next;
+} aubio_dct_ooura_tables_t;
+
+/** list of shared tables, protected by aubio_dct_ooura_lock */
+static aubio_dct_ooura_tables_t *aubio_dct_ooura_tables = NULL;
+
+struct _aubio_dct_ooura_t {
+  uint_t size;
+  fvec_t *input;
+  aubio_dct_ooura_tables_t *tables;
   smpl_t scalers[5];
 };
 
+static aubio_dct_ooura_tables_t *aubio_dct_ooura_tables_acquire (uint_t size)
+{
+  aubio_dct_ooura_tables_t *t;
+  smpl_t *zeros;
+  AUBIO_DCT_OOURA_LOCK();
+  for (t = aubio_dct_ooura_tables; t; t = t->next) {
+    if (t->size == size) {
+      t->refcount++;
+      AUBIO_DCT_OOURA_UNLOCK();
+      return t;
+    }
+  }
+  t = AUBIO_NEW(aubio_dct_ooura_tables_t);
+  zeros = AUBIO_ARRAY(smpl_t, size);
+  if (t && zeros) {
+    t->w = AUBIO_ARRAY(smpl_t, size * 5 / 4);
+    t->ip = AUBIO_ARRAY(int, 3 + (1 << (int)FLOOR(LOG(size/2) / LOG(2))) / 2);
+  }
+  if (t && zeros && t->w && t->ip) {
+    t->ip[0] = 0;
+    aubio_ooura_ddct(size, -1, zeros, t->ip, t->w);
+    t->size = size;
+    t->refcount = 1;
+    t->next = aubio_dct_ooura_tables;
+    aubio_dct_ooura_tables = t;
+  } else if (t) {
+    if (t->w) AUBIO_FREE(t->w);
+    if (t->ip) AUBIO_FREE(t->ip);
+    AUBIO_FREE(t);
+    t = NULL;
+  }
+  AUBIO_DCT_OOURA_UNLOCK();
+  if (zeros) AUBIO_FREE(zeros);
+  return t;
+}
+
+static void aubio_dct_ooura_tables_release (aubio_dct_ooura_tables_t *t)
+{
+  aubio_dct_ooura_tables_t **p;
+  AUBIO_DCT_OOURA_LOCK();
+  if (--t->refcount == 0) {
+    for (p = &aubio_dct_ooura_tables; *p; p = &(*p)->next) {
+      if (*p == t) {
+        *p = t->next;
+        break;
+      }
+    }
+  } else {
+    t = NULL;
+  }
+  AUBIO_DCT_OOURA_UNLOCK();
+  if (t) {
+    AUBIO_FREE(t->w);
+    AUBIO_FREE(t->ip);
+    AUBIO_FREE(t);
+  }
+}
+
 aubio_dct_ooura_t * new_aubio_dct_ooura (uint_t size) {
   aubio_dct_ooura_t * s = AUBIO_NEW(aubio_dct_ooura_t);
   
@@ -49,9 +136,12 @@ aubio_dct_ooura_t * new_aubio_dct_ooura (uint_t size) {
   }
   s->size = size;
   s->input = new_fvec(s->size);
-  s->w = AUBIO_ARRAY(smpl_t, s->size * 5 / 4);
-  s->ip = AUBIO_ARRAY(int, 3 + (1 << (int)FLOOR(LOG(s->size/2) / LOG(2))) / 2);
-  s->ip[0] = 0;
+  s->tables = aubio_dct_ooura_tables_acquire(s->size);
+  if (!s->input || !s->tables) {
+    if (s->input) del_fvec(s->input);
+    if (s->tables) aubio_dct_ooura_tables_release(s->tables);
+    goto beach;
+  }
   s->scalers[0] = 2. * SQRT(1./(4.*s->size));
   s->scalers[1] = 2. * SQRT(1./(2.*s->size));
   s->scalers[2] = 1. / s->scalers[0];
@@ -65,15 +155,20 @@ beach:
 
 void del_aubio_dct_ooura(aubio_dct_ooura_t *s) {
   del_fvec(s->input);
-  AUBIO_FREE(s->ip);
-  AUBIO_FREE(s->w);
+  aubio_dct_ooura_tables_release(s->tables);
   AUBIO_FREE(s);
 }
 
+uint_t aubio_dct_ooura_get_memory_usage(const aubio_dct_ooura_t *s) {
+  // the shared tables are not counted
+  return aubio_malloc_size(s) + aubio_malloc_size(s->input);
+}
+
 void aubio_dct_ooura_do(aubio_dct_ooura_t *s, const fvec_t *input, fvec_t *output) {
   uint_t i = 0;
   fvec_copy(input, s->input);
-  aubio_ooura_ddct(s->size, -1, s->input->data, s->ip, s->w);
+  aubio_ooura_ddct(s->size, -1, s->input->data, s->tables->ip,
+      s->tables->w);
   // apply orthonormal scaling
   s->input->data[0] *= s->scalers[0];
   for (i = 1; i < s->input->length; i++) {
@@ -90,11 +185,47 @@ void aubio_dct_ooura_rdo(aubio_dct_ooura_t *s, const fvec_t *input, fvec_t *outp
     s->input->data[i] *= s->scalers[3];
   }
   s->input->data[0] *= .5;
-  aubio_ooura_ddct(s->size, 1, s->input->data, s->ip, s->w);
+  aubio_ooura_ddct(s->size, 1, s->input->data, s->tables->ip,
+      s->tables->w);
   for (i = 0; i < s->input->length; i++) {
     s->input->data[i] *= s->scalers[4];
   }
   fvec_copy(s->input, output);
 }
 
+/* the rows are transformed in place, in the output matrix */
+void aubio_dct_ooura_do_batch(aubio_dct_ooura_t *s, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i, j;
+  for (i = 0; i < input->height; i++) {
+    smpl_t *row = output->data[i];
+    if (row != input->data[i]) {
+      memcpy(row, input->data[i], s->size * sizeof(smpl_t));
+    }
+    aubio_ooura_ddct(s->size, -1, row, s->tables->ip, s->tables->w);
+    row[0] *= s->scalers[0];
+    for (j = 1; j < s->size; j++) {
+      row[j] *= s->scalers[1];
+    }
+  }
+}
+
+void aubio_dct_ooura_rdo_batch(aubio_dct_ooura_t *s, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i, j;
+  for (i = 0; i < input->height; i++) {
+    const smpl_t *in = input->data[i];
+    smpl_t *row = output->data[i];
+    // scaled while copied, as in aubio_dct_ooura_rdo
+    row[0] = in[0] * s->scalers[2] * .5;
+    for (j = 1; j < s->size; j++) {
+      row[j] = in[j] * s->scalers[3];
+    }
+    aubio_ooura_ddct(s->size, 1, row, s->tables->ip, s->tables->w);
+    for (j = 0; j < s->size; j++) {
+      row[j] *= s->scalers[4];
+    }
+  }
+}
+
 #endif //!defined(HAVE_ACCELERATE) && !defined(HAVE_FFTW3)
@@ -22,17 +22,62 @@
 #include "fvec.h"
 #include "fmat.h"
 #include "spectral/dct.h"
+#include "utils/simd_priv.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_dct_plain_lock = SRWLOCK_INIT;
+#define AUBIO_DCT_PLAIN_LOCK()   AcquireSRWLockExclusive(&aubio_dct_plain_lock)
+#define AUBIO_DCT_PLAIN_UNLOCK() ReleaseSRWLockExclusive(&aubio_dct_plain_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t aubio_dct_plain_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_DCT_PLAIN_LOCK()   pthread_mutex_lock(&aubio_dct_plain_mutex)
+#define AUBIO_DCT_PLAIN_UNLOCK() pthread_mutex_unlock(&aubio_dct_plain_mutex)
+#endif
 
 typedef struct _aubio_dct_plain_t aubio_dct_plain_t;
 
-struct _aubio_dct_plain_t {
+/** transformation matrices of one size, shared by all the plain dcts */
+typedef struct _aubio_dct_plain_shared_t {
   uint_t size;
   fmat_t *dct_coeffs;       /** DCT type II orthonormal transform, size * size */
   fmat_t *idct_coeffs;      /** DCT type III orthonormal transform, size * size */
+  uint_t refcount;
+  struct _aubio_dct_plain_shared_t *next;
+} aubio_dct_plain_shared_t;
+
+/** list of shared matrices, protected by aubio_dct_plain_lock */
+static aubio_dct_plain_shared_t *aubio_dct_plain_shared = NULL;
+
+struct _aubio_dct_plain_t {
+  uint_t size;
+  aubio_dct_plain_shared_t *shared; /** read-only matrices of this size */
 };
 
 void del_aubio_dct_plain (aubio_dct_plain_t *s);
 
+static aubio_dct_plain_shared_t *aubio_dct_plain_find_shared (uint_t size)
+{
+  aubio_dct_plain_shared_t *shared;
+  for (shared = aubio_dct_plain_shared; shared; shared = shared->next) {
+    if (shared->size == size) {
+      shared->refcount++;
+      return shared;
+    }
+  }
+  return NULL;
+}
+
+static void aubio_dct_plain_free_shared (aubio_dct_plain_shared_t *shared)
+{
+  if (shared->dct_coeffs)
+    del_fmat(shared->dct_coeffs);
+  if (shared->idct_coeffs)
+    del_fmat(shared->idct_coeffs);
+  AUBIO_FREE(shared);
+}
+
 aubio_dct_plain_t * new_aubio_dct_plain (uint_t size) {
   aubio_dct_plain_t * s = AUBIO_NEW(aubio_dct_plain_t);
   
@@ -41,6 +86,7 @@ aubio_dct_plain_t * new_aubio_dct_plain (uint_t size) {
   }
   uint_t i, j;
   smpl_t scaling;
+  aubio_dct_plain_shared_t *shared;
   if (aubio_is_power_of_two (size) == 1 && size > 16) {
     AUBIO_WRN("dct_plain: using plain dct but size %d is a power of two\n", size);
   }
@@ -52,8 +98,21 @@ aubio_dct_plain_t * new_aubio_dct_plain (uint_t size) {
 
   s->size = size;
 
-  s->dct_coeffs = new_fmat (size, size);
-  s->idct_coeffs = new_fmat (size, size);
+  AUBIO_DCT_PLAIN_LOCK();
+  s->shared = aubio_dct_plain_find_shared (size);
+  AUBIO_DCT_PLAIN_UNLOCK();
+  if (s->shared) return s;
+
+  /* computed outside the lock, another dct may store them meanwhile */
+  shared = AUBIO_NEW(aubio_dct_plain_shared_t);
+  if (!shared) goto failure;
+  shared->size = size;
+  shared->dct_coeffs = new_fmat (size, size);
+  shared->idct_coeffs = new_fmat (size, size);
+  if (!shared->dct_coeffs || !shared->idct_coeffs) {
+    aubio_dct_plain_free_shared (shared);
+    goto failure;
+  }
 
   /* compute DCT type-II transformation matrix
      dct_coeffs[j][i] = cos ( j * (i+.5) * PI / n_filters )
@@ -61,10 +120,10 @@ aubio_dct_plain_t * new_aubio_dct_plain (uint_t size) {
   scaling = SQRT (2. / size);
   for (i = 0; i < size; i++) {
     for (j = 1; j < size; j++) {
-      s->dct_coeffs->data[j][i] =
+      shared->dct_coeffs->data[j][i] =
           scaling * COS (j * (i + 0.5) * PI / size );
     }
-    s->dct_coeffs->data[0][i] = 1. / SQRT (size);
+    shared->dct_coeffs->data[0][i] = 1. / SQRT (size);
   }
 
   /* compute DCT type-III transformation matrix
@@ -73,11 +132,23 @@ aubio_dct_plain_t * new_aubio_dct_plain (uint_t size) {
   scaling = SQRT (2. / size);
   for (j = 0; j < size; j++) {
     for (i = 1; i < size; i++) {
-      s->idct_coeffs->data[j][i] =
+      shared->idct_coeffs->data[j][i] =
           scaling * COS (i * (j + 0.5) * PI / size );
     }
-    s->idct_coeffs->data[j][0] = 1. / SQRT (size);
+    shared->idct_coeffs->data[j][0] = 1. / SQRT (size);
   }
+
+  AUBIO_DCT_PLAIN_LOCK();
+  s->shared = aubio_dct_plain_find_shared (size);
+  if (!s->shared) {
+    shared->refcount = 1;
+    shared->next = aubio_dct_plain_shared;
+    aubio_dct_plain_shared = shared;
+    s->shared = shared;
+    shared = NULL;
+  }
+  AUBIO_DCT_PLAIN_UNLOCK();
+  if (shared) aubio_dct_plain_free_shared (shared);
   return s;
 failure:
   del_aubio_dct_plain(s);
@@ -85,19 +156,36 @@ failure:
 }
 
 void del_aubio_dct_plain (aubio_dct_plain_t *s) {
-  if (s->dct_coeffs)
-    del_fmat(s->dct_coeffs);
-  if (s->idct_coeffs)
-    del_fmat(s->idct_coeffs);
+  aubio_dct_plain_shared_t **p, *shared = s->shared;
+  if (shared) {
+    AUBIO_DCT_PLAIN_LOCK();
+    if (--shared->refcount == 0) {
+      for (p = &aubio_dct_plain_shared; *p; p = &(*p)->next) {
+        if (*p == shared) {
+          *p = shared->next;
+          break;
+        }
+      }
+    } else {
+      shared = NULL;
+    }
+    AUBIO_DCT_PLAIN_UNLOCK();
+    if (shared) aubio_dct_plain_free_shared (shared);
+  }
   AUBIO_FREE(s);
 }
 
+uint_t aubio_dct_plain_get_memory_usage(const aubio_dct_plain_t *s) {
+  // the shared matrices are not counted
+  return aubio_malloc_size(s);
+}
+
 void aubio_dct_plain_do(aubio_dct_plain_t *s, const fvec_t *input, fvec_t *output) {
   if (input->length != output->length || input->length != s->size) {
     AUBIO_WRN("dct_plain: using input length %d, but output length = %d and size = %d\n",
         input->length, output->length, s->size);
   }
-  fmat_vecmul(s->dct_coeffs, input, output);
+  fmat_vecmul(s->shared->dct_coeffs, input, output);
 }
 
 void aubio_dct_plain_rdo(aubio_dct_plain_t *s, const fvec_t *input, fvec_t *output) {
@@ -105,5 +193,25 @@ void aubio_dct_plain_rdo(aubio_dct_plain_t *s, const fvec_t *input, fvec_t *outp
     AUBIO_WRN("dct_plain: using input length %d, but output length = %d and size = %d\n",
         input->length, output->length, s->size);
   }
-  fmat_vecmul(s->idct_coeffs, input, output);
+  fmat_vecmul(s->shared->idct_coeffs, input, output);
+}
+
+/* multiply each row of input by coeffs, the matrix staying in cache */
+static void aubio_dct_plain_batch(const fmat_t *coeffs, const fmat_t *input,
+    fmat_t *output) {
+  uint_t i;
+  for (i = 0; i < input->height; i++) {
+    AUBIO_SIMD()->mvmul ((const smpl_t * const *)coeffs->data,
+        input->data[i], output->data[i], coeffs->height, coeffs->length);
+  }
+}
+
+void aubio_dct_plain_do_batch(aubio_dct_plain_t *s, const fmat_t *input,
+    fmat_t *output) {
+  aubio_dct_plain_batch(s->shared->dct_coeffs, input, output);
+}
+
+void aubio_dct_plain_rdo_batch(aubio_dct_plain_t *s, const fmat_t *input,
+    fmat_t *output) {
+  aubio_dct_plain_batch(s->shared->idct_coeffs, input, output);
 }
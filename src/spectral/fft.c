@@ -21,8 +21,16 @@
 #include "aubio_priv.h"
 #include "fvec.h"
 #include "cvec.h"
+#include "fmat.h"
 #include "mathutils.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
+#include "spectral/gpu_priv.h"
+#include "utils/simd_priv.h"
+
+/* number of bins converted at once by the vector kernels, their imaginary
+ * parts gathered in order next to the real parts */
+#define AUBIO_FFT_PHAS_BLOCK 64
 
 #ifdef HAVE_FFTW3             // using FFTW3
 /* note that <complex.h> is not included here but only in aubio_priv.h, so that
@@ -30,36 +38,19 @@
 #include <fftw3.h>
 #include <pthread.h>
 
-#ifdef HAVE_COMPLEX_H
-#ifdef HAVE_FFTW3F
-/** fft data type with complex.h and fftw3f */
-#define FFTW_TYPE fftwf_complex
-#else
-/** fft data type with complex.h and fftw3 */
-#define FFTW_TYPE fftw_complex
-#endif
-#else
-#ifdef HAVE_FFTW3F
-/** fft data type without complex.h and with fftw3f */
-#define FFTW_TYPE float
-#else
-/** fft data type without complex.h and with fftw */
-#define FFTW_TYPE double
-#endif
-#endif
-
-/** fft data type */
-typedef FFTW_TYPE fft_data_t;
-
 #ifdef HAVE_FFTW3F
 #define fftw_malloc            fftwf_malloc
 #define fftw_free              fftwf_free
 #define fftw_execute           fftwf_execute
-#define fftw_plan_dft_r2c_1d   fftwf_plan_dft_r2c_1d
-#define fftw_plan_dft_c2r_1d   fftwf_plan_dft_c2r_1d
 #define fftw_plan_r2r_1d       fftwf_plan_r2r_1d
+#define fftw_plan_many_r2r     fftwf_plan_many_r2r
+#define fftw_execute_r2r       fftwf_execute_r2r
+#define fftw_import_wisdom_from_filename fftwf_import_wisdom_from_filename
+#define fftw_export_wisdom_to_filename   fftwf_export_wisdom_to_filename
 #define fftw_plan              fftwf_plan
 #define fftw_destroy_plan      fftwf_destroy_plan
+#define fftw_init_threads      fftwf_init_threads
+#define fftw_plan_with_nthreads fftwf_plan_with_nthreads
 #endif
 
 #ifdef HAVE_FFTW3F
@@ -74,8 +65,54 @@ typedef FFTW_TYPE fft_data_t;
 #define real_t double
 #endif /* HAVE_FFTW3F */
 
-// a global mutex for FFTW thread safety
+/* The plans are halfcomplex transforms (FFTW_R2HC and FFTW_HC2R), whose
+   output is already [ r0, r1, ..., rN, iN-1, .., i2, i1], so that they can
+   write the spectrum and read the signal of the caller directly. */
+
+/** 1 if p is aligned enough to execute the plans on it, that is as much as
+  the arrays of fftw_malloc */
+#define AUBIO_FFTW_ALIGNED(p) (((size_t)(p) & (AUBIO_ALIGNMENT - 1)) == 0)
+
+// a global mutex for FFTW thread safety, only held while planning
 pthread_mutex_t aubio_fftw_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_FFTW_LOCK() do { AUBIO_RT_CHECK("fftw mutex"); \
+  pthread_mutex_lock(&aubio_fftw_mutex); } while (0)
+
+/** pair of forward and backward plans, shared by all ffts of the same size
+
+  The plans are executed with the new-array interface (fftw_execute_r2r),
+  which is thread-safe, on the buffers of each aubio_fft_t or on the vectors
+  of the caller. These must be aligned like the arrays of fftw_malloc the
+  plans were created with, see AUBIO_FFTW_ALIGNED.
+
+*/
+typedef struct _aubio_fftw_plans_t {
+  uint_t winsize;
+  uint_t refcount;
+  fftw_plan pfw, pbw;
+  struct _aubio_fftw_plans_t *next;
+} aubio_fftw_plans_t;
+
+/** list of cached plans, protected by aubio_fftw_mutex */
+static aubio_fftw_plans_t *aubio_fftw_plans = NULL;
+/** planner flags used for new plans, see aubio_fft_set_planner */
+static unsigned aubio_fftw_flags = FFTW_ESTIMATE;
+#ifdef HAVE_FFTW3_THREADS
+/** number of threads of new plans of large transforms, see
+  aubio_fft_set_threads */
+static uint_t aubio_fftw_threads = 1;
+#endif
+
+/** transforms of fewer samples are planned on a single thread, for which
+  starting threads would cost more than it saves */
+#ifndef AUBIO_FFTW_THREADS_MIN
+#define AUBIO_FFTW_THREADS_MIN 16384
+#endif
+
+static void aubio_fftw_set_plan_threads (uint_t n_samples);
+
+static aubio_fftw_plans_t *aubio_fftw_plans_acquire (uint_t winsize);
+static void aubio_fftw_plans_release (aubio_fftw_plans_t *plans);
 
 #elif defined HAVE_ACCELERATE        // using ACCELERATE
 // https://developer.apple.com/library/mac/#documentation/Accelerate/Reference/vDSPRef/Reference/reference.html
@@ -142,6 +179,15 @@ pthread_mutex_t aubio_fftw_mutex = PTHREAD_MUTEX_INITIALIZER;
 // let's use ooura instead
 extern void aubio_ooura_rdft(int, int, smpl_t *, int *, smpl_t *);
 
+typedef void (*aubio_fft_ooura_forward_t) (aubio_fft_t * s, smpl_t * compspec);
+typedef void (*aubio_fft_ooura_backward_t) (aubio_fft_t * s,
+    const smpl_t * compspec, smpl_t * output);
+
+#endif
+
+#ifndef HAVE_FFTW3
+// built-in real fft, for sizes the backend does not support
+#include "spectral/rfft_priv.h"
 #endif
 
 struct _aubio_fft_t {
@@ -150,8 +196,15 @@ struct _aubio_fft_t {
 
 #ifdef HAVE_FFTW3             // using FFTW3
   real_t *in, *out;
-  fftw_plan pfw, pbw;
-  fft_data_t * specdata; /* complex spectral data */
+  aubio_fftw_plans_t *plans; /* shared forward and backward plans */
+  real_t *specdata;         /* spectrum, when the one of the caller can not
+                               be used */
+  fftw_plan pbatch;         /* many-plan used by aubio_fft_do_batch */
+  fftw_plan pbatch_bw;      /* inverse many-plan, from batch_spec to
+                               batch_in, used by aubio_fft_rdo_batch */
+  uint_t batch_size;        /* number of frames pbatch was planned for */
+  real_t *batch_in;         /* contiguous input frames of pbatch */
+  real_t *batch_spec;       /* contiguous output spectra of pbatch */
 
 #elif defined HAVE_ACCELERATE  // using ACCELERATE
   aubio_vDSP_DFT_Setup fftSetupFwd;
@@ -170,11 +223,143 @@ struct _aubio_fft_t {
   smpl_t *in, *out;
   smpl_t *w;
   int *ip;
+  aubio_fft_ooura_forward_t forward;   /* forward transform of s->in */
+  aubio_fft_ooura_backward_t backward; /* backward transform into output */
 #endif /* using OOURA */
 
+#ifndef HAVE_FFTW3
+  aubio_rfft_t *rfft;       /* built-in fft, used instead of the backend */
+#endif
   fvec_t * compspec;
+  aubio_gpu_t *gpu;         /* device of aubio_fft_do_batch, or NULL */
 };
 
+#ifndef HAVE_FFTW3
+/* check whether the backend can compute transforms of size winsize */
+static uint_t aubio_fft_backend_supports (uint_t winsize) {
+#ifdef HAVE_AUBIO_RFFT
+  // the built-in fft was requested for all sizes
+  (void)winsize;
+  return 0;
+#elif defined HAVE_ACCELERATE
+  // vDSP supports sizes f * 2 ** n, where n >= 4 and f in [1, 3, 5, 15]
+  uint_t radix = winsize;
+  uint_t order = 0;
+  while ((radix / 2) * 2 == radix) {
+    radix /= 2;
+    order++;
+  }
+  return order >= 4 && (radix == 1 || radix == 3 || radix == 5 || radix == 15);
+#elif defined HAVE_INTEL_IPP
+  return winsize > 4 && aubio_is_power_of_two(winsize) == 1;
+#else
+  return aubio_is_power_of_two(winsize) == 1;
+#endif
+}
+
+/* set up s to use the built-in fft, for sizes 2 ** a * 3 ** b * 5 ** c */
+static uint_t aubio_fft_init_rfft (aubio_fft_t * s, uint_t winsize) {
+  s->rfft = new_aubio_rfft(winsize);
+  if (!s->rfft) {
+    AUBIO_ERR("fft: failed creating fft of size %d, try recompiling aubio"
+        " with --enable-fftw3\n", winsize);
+    return AUBIO_FAIL;
+  }
+  s->winsize = winsize;
+  s->fft_size = winsize / 2 + 1;
+  s->compspec = new_fvec(winsize);
+  s->in    = AUBIO_ARRAY(smpl_t, s->winsize);
+  s->out   = AUBIO_ARRAY(smpl_t, s->winsize);
+  return AUBIO_OK;
+}
+#endif /* HAVE_FFTW3 */
+
+#if !defined HAVE_FFTW3 && !defined HAVE_ACCELERATE && !defined HAVE_INTEL_IPP
+/* transform s->in with ooura, and move its output, [ r0, rN, r1, -i1, ...,
+ * rN-1, -iN-1 ], to [ r0, r1, ..., rN, iN-1, .., i2, i1] */
+static inline void aubio_fft_ooura_do_forward (aubio_fft_t * s,
+    smpl_t * compspec, uint_t size) {
+  uint_t i;
+  aubio_ooura_rdft(size, 1, s->in, s->ip, s->w);
+  compspec[0] = s->in[0];
+  compspec[size / 2] = s->in[1];
+  for (i = 1; i < size / 2; i++) {
+    compspec[i] = s->in[2 * i];
+    compspec[size - i] = - s->in[2 * i + 1];
+  }
+}
+
+/* move compspec to the layout of ooura, transform it, and scale it */
+static inline void aubio_fft_ooura_do_backward (aubio_fft_t * s,
+    const smpl_t * compspec, smpl_t * output, uint_t size) {
+  uint_t i;
+  const smpl_t scale = 2.0 / size;
+  s->out[0] = compspec[0];
+  s->out[1] = compspec[size / 2];
+  for (i = 1; i < size / 2; i++) {
+    s->out[2 * i] = compspec[i];
+    s->out[2 * i + 1] = - compspec[size - i];
+  }
+  aubio_ooura_rdft(size, -1, s->out, s->ip, s->w);
+  for (i = 0; i < size; i++) {
+    output[i] = s->out[i] * scale;
+  }
+}
+
+static void aubio_fft_ooura_forward (aubio_fft_t * s, smpl_t * compspec) {
+  aubio_fft_ooura_do_forward (s, compspec, s->winsize);
+}
+
+static void aubio_fft_ooura_backward (aubio_fft_t * s, const smpl_t * compspec,
+    smpl_t * output) {
+  aubio_fft_ooura_do_backward (s, compspec, output, s->winsize);
+}
+
+/* copies of the functions above for a constant size, so that the compiler
+ * can unroll and vectorise their loops */
+#define AUBIO_FFT_OOURA_SIZE(size) \
+static void aubio_fft_ooura_forward_##size (aubio_fft_t * s, \
+    smpl_t * compspec) { \
+  aubio_fft_ooura_do_forward (s, compspec, size); \
+} \
+static void aubio_fft_ooura_backward_##size (aubio_fft_t * s, \
+    const smpl_t * compspec, smpl_t * output) { \
+  aubio_fft_ooura_do_backward (s, compspec, output, size); \
+}
+
+AUBIO_FFT_OOURA_SIZE(256)
+AUBIO_FFT_OOURA_SIZE(512)
+AUBIO_FFT_OOURA_SIZE(1024)
+AUBIO_FFT_OOURA_SIZE(2048)
+AUBIO_FFT_OOURA_SIZE(4096)
+
+static const struct {
+  uint_t size;
+  aubio_fft_ooura_forward_t forward;
+  aubio_fft_ooura_backward_t backward;
+} aubio_fft_ooura_sizes[] = {
+  { 256, aubio_fft_ooura_forward_256, aubio_fft_ooura_backward_256 },
+  { 512, aubio_fft_ooura_forward_512, aubio_fft_ooura_backward_512 },
+  { 1024, aubio_fft_ooura_forward_1024, aubio_fft_ooura_backward_1024 },
+  { 2048, aubio_fft_ooura_forward_2048, aubio_fft_ooura_backward_2048 },
+  { 4096, aubio_fft_ooura_forward_4096, aubio_fft_ooura_backward_4096 },
+};
+
+/* pick the functions of s->winsize, or the generic ones */
+static void aubio_fft_ooura_select (aubio_fft_t * s) {
+  uint_t i;
+  s->forward = aubio_fft_ooura_forward;
+  s->backward = aubio_fft_ooura_backward;
+  for (i = 0; i < sizeof(aubio_fft_ooura_sizes)
+      / sizeof(aubio_fft_ooura_sizes[0]); i++) {
+    if (aubio_fft_ooura_sizes[i].size == s->winsize) {
+      s->forward = aubio_fft_ooura_sizes[i].forward;
+      s->backward = aubio_fft_ooura_sizes[i].backward;
+    }
+  }
+}
+#endif /* using OOURA */
+
 aubio_fft_t * new_aubio_fft (uint_t winsize) {
   aubio_fft_t * s = AUBIO_NEW(aubio_fft_t);
   
@@ -186,27 +371,30 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
     goto beach;
   }
 
+#ifndef HAVE_FFTW3
+  if (!aubio_fft_backend_supports(winsize)) {
+    if (aubio_fft_init_rfft(s, winsize) != AUBIO_OK) {
+      goto beach;
+    }
+    return s;
+  }
+#endif
+
 #ifdef HAVE_FFTW3
   uint_t i;
   s->winsize  = winsize;
+  s->fft_size = winsize;
+  /* get shared plans for this size */
+  s->plans = aubio_fftw_plans_acquire(winsize);
+  if (!s->plans) {
+    AUBIO_ERR("fft: failed creating plans of size %d\n", winsize);
+    goto beach;
+  }
   /* allocate memory */
-  s->in       = AUBIO_ARRAY(real_t,winsize);
-  s->out      = AUBIO_ARRAY(real_t,winsize);
+  s->in       = (real_t*)fftw_malloc(sizeof(real_t)*winsize);
+  s->out      = (real_t*)fftw_malloc(sizeof(real_t)*winsize);
+  s->specdata = (real_t*)fftw_malloc(sizeof(real_t)*s->fft_size);
   s->compspec = new_fvec(winsize);
-  /* create plans */
-  pthread_mutex_lock(&aubio_fftw_mutex);
-#ifdef HAVE_COMPLEX_H
-  s->fft_size = winsize/2 + 1;
-  s->specdata = (fft_data_t*)fftw_malloc(sizeof(fft_data_t)*s->fft_size);
-  s->pfw = fftw_plan_dft_r2c_1d(winsize, s->in,  s->specdata, FFTW_ESTIMATE);
-  s->pbw = fftw_plan_dft_c2r_1d(winsize, s->specdata, s->out, FFTW_ESTIMATE);
-#else
-  s->fft_size = winsize;
-  s->specdata = (fft_data_t*)fftw_malloc(sizeof(fft_data_t)*s->fft_size);
-  s->pfw = fftw_plan_r2r_1d(winsize, s->in,  s->specdata, FFTW_R2HC, FFTW_ESTIMATE);
-  s->pbw = fftw_plan_r2r_1d(winsize, s->specdata, s->out, FFTW_HC2R, FFTW_ESTIMATE);
-#endif
-  pthread_mutex_unlock(&aubio_fftw_mutex);
   for (i = 0; i < s->winsize; i++) {
     s->in[i] = 0.;
     s->out[i] = 0.;
@@ -216,21 +404,6 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
   }
 
 #elif defined HAVE_ACCELERATE  // using ACCELERATE
-  {
-    uint_t radix = winsize;
-    uint_t order = 0;
-    while ((radix / 2) * 2 == radix) {
-      radix /= 2;
-      order++;
-    }
-    if (order < 4 || (radix != 1 && radix != 3 && radix != 5 && radix != 15)) {
-      AUBIO_ERR("fft: vDSP/Accelerate supports FFT with sizes = "
-          "f * 2 ** n, where n > 4 and f in [1, 3, 5, 15], but requested %d. "
-          "Use the closest power of two, or try recompiling aubio with "
-          "--enable-fftw3.\n", winsize);
-      goto beach;
-    }
-  }
   s->winsize = winsize;
   s->fft_size = winsize;
   s->compspec = new_fvec(winsize);
@@ -250,13 +423,6 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
   int sizeSpec, sizeInit, sizeBuffer;
   IppStatus status;
 
-  if (winsize <= 4 || aubio_is_power_of_two(winsize) != 1)
-  {
-    AUBIO_ERR("intel IPP fft: can only create with sizes > 4 and power of two, requested %d,"
-      " try recompiling aubio with --enable-fftw3\n", winsize);
-    goto beach;
-  }
-
   status = aubio_ippsFFTGetSize_R(order, flags, qualityHint,
       &sizeSpec, &sizeInit, &sizeBuffer);
   if (status != ippStsNoErr) {
@@ -281,11 +447,6 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
   }
 
 #else                         // using OOURA
-  if (aubio_is_power_of_two(winsize) != 1) {
-    AUBIO_ERR("fft: can only create with sizes power of two, requested %d,"
-        " try recompiling aubio with --enable-fftw3\n", winsize);
-    goto beach;
-  }
   s->winsize = winsize;
   s->fft_size = winsize / 2 + 1;
   s->compspec = new_fvec(winsize);
@@ -294,6 +455,7 @@ aubio_fft_t * new_aubio_fft (uint_t winsize) {
   s->ip    = AUBIO_ARRAY(int   , s->fft_size);
   s->w     = AUBIO_ARRAY(smpl_t, s->fft_size);
   s->ip[0] = 0;
+  aubio_fft_ooura_select(s);
 #endif /* using OOURA */
 
   return s;
@@ -306,13 +468,22 @@ beach:
 void del_aubio_fft(aubio_fft_t * s) {
   /* destroy data */
 #ifdef HAVE_FFTW3             // using FFTW3
-  pthread_mutex_lock(&aubio_fftw_mutex);
-  fftw_destroy_plan(s->pfw);
-  fftw_destroy_plan(s->pbw);
+  aubio_fftw_plans_release(s->plans);
   fftw_free(s->specdata);
+  AUBIO_FFTW_LOCK();
+  if (s->pbatch) fftw_destroy_plan(s->pbatch);
+  if (s->pbatch_bw) fftw_destroy_plan(s->pbatch_bw);
   pthread_mutex_unlock(&aubio_fftw_mutex);
+  if (s->batch_in) fftw_free(s->batch_in);
+  if (s->batch_spec) fftw_free(s->batch_spec);
+  fftw_free(s->in);
+  fftw_free(s->out);
 
-#elif defined HAVE_ACCELERATE // using ACCELERATE
+#else
+  if (s->rfft) {
+    del_aubio_rfft(s->rfft);
+  } else {
+#if defined HAVE_ACCELERATE   // using ACCELERATE
   AUBIO_FREE(s->spec.realp);
   AUBIO_FREE(s->spec.imagp);
   aubio_vDSP_DFT_DestroySetup(s->fftSetupBwd);
@@ -328,47 +499,85 @@ void del_aubio_fft(aubio_fft_t * s) {
   AUBIO_FREE(s->w);
   AUBIO_FREE(s->ip);
 #endif
+  }
+#endif
 
   del_fvec(s->compspec);
+#ifndef HAVE_FFTW3
   AUBIO_FREE(s->in);
   AUBIO_FREE(s->out);
+#endif
   AUBIO_FREE(s);
 }
 
+uint_t aubio_fft_get_memory_usage(const aubio_fft_t * s) {
+  uint_t n = aubio_malloc_size(s) + aubio_malloc_size(s->compspec);
+#ifdef HAVE_FFTW3             // using FFTW3
+  // the plans are shared, only count the arrays of this object
+  n += (2 * s->winsize + s->fft_size) * sizeof(real_t);
+  n += s->batch_size * (s->winsize + s->fft_size) * sizeof(real_t);
+#else
+  n += aubio_malloc_size(s->in) + aubio_malloc_size(s->out);
+  if (s->rfft) {
+    n += aubio_rfft_get_memory_usage(s->rfft);
+  }
+#if defined HAVE_ACCELERATE   // using ACCELERATE
+  n += aubio_malloc_size(s->spec.realp) + aubio_malloc_size(s->spec.imagp);
+#elif defined HAVE_INTEL_IPP  // using Intel IPP
+  // the buffers of ippsMalloc are not counted, but for the spectrum
+  if (s->complexOut) {
+    n += (s->fft_size / 2 + 1) * sizeof(aubio_IppComplex);
+  }
+#else                         // using OOURA
+  n += aubio_malloc_size(s->w) + aubio_malloc_size(s->ip);
+#endif
+#endif
+  return n;
+}
+
 void aubio_fft_do(aubio_fft_t * s, const fvec_t * input, cvec_t * spectrum) {
   aubio_fft_do_complex(s, input, s->compspec);
   aubio_fft_get_spectrum(s->compspec, spectrum);
 }
 
+void aubio_fft_do_norm(aubio_fft_t * s, const fvec_t * input, cvec_t * spectrum) {
+  aubio_fft_do_complex(s, input, s->compspec);
+  aubio_fft_get_norm(s->compspec, spectrum);
+}
+
 void aubio_fft_rdo(aubio_fft_t * s, const cvec_t * spectrum, fvec_t * output) {
   aubio_fft_get_realimag(spectrum, s->compspec);
   aubio_fft_rdo_complex(s, s->compspec, output);
 }
 
-void aubio_fft_do_complex(aubio_fft_t * s, const fvec_t * input, fvec_t * compspec) {
-  uint_t i;
-#ifndef HAVE_MEMCPY_HACKS
-  for (i=0; i < s->winsize; i++) {
-    s->in[i] = input->data[i];
+#ifdef HAVE_FFTW3
+/* forward transform of in into compspec, through s->specdata if compspec
+   can not be written directly */
+static void aubio_fft_fftw_forward(aubio_fft_t * s, const real_t * in,
+    smpl_t * compspec) {
+  if (AUBIO_FFTW_ALIGNED(compspec) && compspec != in) {
+    fftw_execute_r2r(s->plans->pfw, (real_t *)in, compspec);
+  } else {
+    fftw_execute_r2r(s->plans->pfw, (real_t *)in, s->specdata);
+    memcpy(compspec, s->specdata, s->winsize * sizeof(smpl_t));
   }
-#else
-  memcpy(s->in, input->data, s->winsize * sizeof(smpl_t));
-#endif /* HAVE_MEMCPY_HACKS */
+}
+#endif /* HAVE_FFTW3 */
 
-#ifdef HAVE_FFTW3             // using FFTW3
-  fftw_execute(s->pfw);
-#ifdef HAVE_COMPLEX_H
-  compspec->data[0] = REAL(s->specdata[0]);
-  for (i = 1; i < s->fft_size -1 ; i++) {
-    compspec->data[i] = REAL(s->specdata[i]);
-    compspec->data[compspec->length - i] = IMAG(s->specdata[i]);
-  }
-  compspec->data[s->fft_size-1] = REAL(s->specdata[s->fft_size-1]);
-#else /* HAVE_COMPLEX_H  */
-  for (i = 0; i < s->fft_size; i++) {
-    compspec->data[i] = s->specdata[i];
+/* forward transform of the s->winsize samples already in s->in */
+static void aubio_fft_do_complex_in(aubio_fft_t * s, smpl_t * compspec) {
+  uint_t i;
+  AUBIO_STATS_BEGIN ("fft forward");
+#ifndef HAVE_FFTW3
+  if (s->rfft) {
+    aubio_rfft_forward(s->rfft, s->in, compspec);
+    AUBIO_STATS_END ();
+    return;
   }
-#endif /* HAVE_COMPLEX_H */
+#endif
+#ifdef HAVE_FFTW3             // using FFTW3
+  aubio_fft_fftw_forward(s, s->in, compspec);
+  (void)i;
 
 #elif defined HAVE_ACCELERATE // using ACCELERATE
   // convert real data to even/odd format used in vDSP
@@ -377,58 +586,327 @@ void aubio_fft_do_complex(aubio_fft_t * s, const fvec_t * input, fvec_t * compsp
   aubio_vDSP_DFT_Execute(s->fftSetupFwd, s->spec.realp, s->spec.imagp,
       s->spec.realp, s->spec.imagp);
   // convert from vDSP complex split to [ r0, r1, ..., rN, iN-1, .., i2, i1]
-  compspec->data[0] = s->spec.realp[0];
-  compspec->data[s->fft_size / 2] = s->spec.imagp[0];
+  compspec[0] = s->spec.realp[0];
+  compspec[s->fft_size / 2] = s->spec.imagp[0];
   for (i = 1; i < s->fft_size / 2; i++) {
-    compspec->data[i] = s->spec.realp[i];
-    compspec->data[s->fft_size - i] = s->spec.imagp[i];
+    compspec[i] = s->spec.realp[i];
+    compspec[s->fft_size - i] = s->spec.imagp[i];
   }
   // apply scaling
   smpl_t scale = 1./2.;
-  aubio_vDSP_vsmul(compspec->data, 1, &scale, compspec->data, 1, s->fft_size);
+  aubio_vDSP_vsmul(compspec, 1, &scale, compspec, 1, s->fft_size);
 
 #elif defined HAVE_INTEL_IPP  // using Intel IPP
 
   // apply fft
   aubio_ippsFFTFwd_RToCCS(s->in, (aubio_IppFloat*)s->complexOut, s->fftSpec, s->memBuffer);
   // convert complex buffer to [ r0, r1, ..., rN, iN-1, .., i2, i1]
-  compspec->data[0] = s->complexOut[0].re;
-  compspec->data[s->fft_size / 2] = s->complexOut[s->fft_size / 2].re;
+  compspec[0] = s->complexOut[0].re;
+  compspec[s->fft_size / 2] = s->complexOut[s->fft_size / 2].re;
   for (i = 1; i < s->fft_size / 2; i++) {
-    compspec->data[i] = s->complexOut[i].re;
-    compspec->data[s->fft_size - i] = s->complexOut[i].im;
+    compspec[i] = s->complexOut[i].re;
+    compspec[s->fft_size - i] = s->complexOut[i].im;
   }
 
 #else                         // using OOURA
-  aubio_ooura_rdft(s->winsize, 1, s->in, s->ip, s->w);
-  compspec->data[0] = s->in[0];
-  compspec->data[s->winsize / 2] = s->in[1];
-  for (i = 1; i < s->fft_size - 1; i++) {
-    compspec->data[i] = s->in[2 * i];
-    compspec->data[s->winsize - i] = - s->in[2 * i + 1];
-  }
+  s->forward(s, compspec);
+  (void)i;
 #endif /* using OOURA */
+  AUBIO_STATS_END ();
 }
 
-void aubio_fft_rdo_complex(aubio_fft_t * s, const fvec_t * compspec, fvec_t * output) {
+/* forward transform of s->winsize samples of input into compspec */
+static void aubio_fft_do_complex_data(aubio_fft_t * s, const smpl_t * input,
+    smpl_t * compspec) {
+#ifndef HAVE_MEMCPY_HACKS
+  uint_t i;
+#endif
+#ifdef HAVE_FFTW3
+  // R2HC plans do not overwrite their input, read it where it is
+  if (AUBIO_FFTW_ALIGNED(input)) {
+    AUBIO_STATS_BEGIN ("fft forward");
+    aubio_fft_fftw_forward(s, input, compspec);
+    AUBIO_STATS_END ();
+    return;
+  }
+#endif
+#ifndef HAVE_MEMCPY_HACKS
+  for (i=0; i < s->winsize; i++) {
+    s->in[i] = input[i];
+  }
+#else
+  memcpy(s->in, input, s->winsize * sizeof(smpl_t));
+#endif /* HAVE_MEMCPY_HACKS */
+  aubio_fft_do_complex_in(s, compspec);
+}
+
+void aubio_fft_do_complex(aubio_fft_t * s, const fvec_t * input, fvec_t * compspec) {
+  aubio_fft_do_complex_data(s, input->data, compspec->data);
+}
+
+void aubio_fft_do_complex_windowed(aubio_fft_t * s, const fvec_t * input,
+    const fvec_t * window, fvec_t * compspec) {
+  // rotate by the same amount as fvec_shift: when length is odd, the middle
+  // element ends up last
+  uint_t start = s->winsize - s->winsize / 2;
+  uint_t tail = s->winsize - start;
+  fvec_t src, win, dst;
+  // second part of the grain goes to the start of the transform input
+  src.length = win.length = dst.length = tail;
+  src.data = input->data + start;
+  win.data = window->data + start;
+  dst.data = (smpl_t *)s->in;
+  fvec_weighted_copy(&src, &win, &dst);
+  // first part of the grain goes to its end
+  src.length = win.length = dst.length = start;
+  src.data = input->data;
+  win.data = window->data;
+  dst.data = (smpl_t *)s->in + tail;
+  fvec_weighted_copy(&src, &win, &dst);
+  aubio_fft_do_complex_in(s, compspec->data);
+}
+
+#ifdef HAVE_FFTW3
+/* (re)plan the many-transform used for batches of n_frames frames */
+static uint_t aubio_fft_fftw_batch_setup(aubio_fft_t * s, uint_t n_frames) {
+  int n = (int)s->winsize;
+  if (s->pbatch && s->batch_size == n_frames) return AUBIO_OK;
+  AUBIO_FFTW_LOCK();
+  if (s->pbatch) fftw_destroy_plan(s->pbatch);
+  if (s->pbatch_bw) fftw_destroy_plan(s->pbatch_bw);
+  if (s->batch_in) fftw_free(s->batch_in);
+  if (s->batch_spec) fftw_free(s->batch_spec);
+  s->pbatch = NULL;
+  s->pbatch_bw = NULL;
+  s->batch_size = 0;
+  s->batch_in = (real_t*)fftw_malloc(sizeof(real_t) * s->winsize * n_frames);
+  s->batch_spec = (real_t*)fftw_malloc(sizeof(real_t)
+      * s->fft_size * n_frames);
+  if (s->batch_in && s->batch_spec) {
+    fftw_r2r_kind kind = FFTW_R2HC, kind_bw = FFTW_HC2R;
+    aubio_fftw_set_plan_threads(s->winsize * n_frames);
+    s->pbatch = fftw_plan_many_r2r(1, &n, (int)n_frames,
+        s->batch_in, NULL, 1, n, s->batch_spec, NULL, 1, n,
+        &kind, aubio_fftw_flags);
+    // same arrays the other way round, batch_spec being overwritten
+    s->pbatch_bw = fftw_plan_many_r2r(1, &n, (int)n_frames,
+        s->batch_spec, NULL, 1, n, s->batch_in, NULL, 1, n,
+        &kind_bw, aubio_fftw_flags);
+  }
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  if (!s->pbatch || !s->pbatch_bw) {
+    AUBIO_WRN("fft: failed creating plan for %d frames\n", n_frames);
+    return AUBIO_FAIL;
+  }
+  s->batch_size = n_frames;
+  return AUBIO_OK;
+}
+#endif /* HAVE_FFTW3 */
+
+/* transform all frames, then call aubio_fft_batch_unpack for each of them */
+static uint_t aubio_fft_batch_execute(aubio_fft_t * s, const fmat_t * frames) {
+#ifdef HAVE_FFTW3
   uint_t i;
+  if (frames->height > 1
+      && aubio_fft_fftw_batch_setup(s, frames->height) == AUBIO_OK) {
+    for (i = 0; i < frames->height; i++) {
+      memcpy(s->batch_in + i * s->winsize, frames->data[i],
+          s->winsize * sizeof(smpl_t));
+    }
+    fftw_execute(s->pbatch);
+    return 1;
+  }
+#endif /* HAVE_FFTW3 */
+  (void)s; (void)frames;
+  return 0;
+}
+
+/* write the complex spectrum of frame i into compspec */
+static void aubio_fft_batch_unpack(aubio_fft_t * s, const fmat_t * frames,
+    uint_t batched, uint_t i, smpl_t * compspec) {
+#ifdef HAVE_FFTW3
+  if (batched) {
+    memcpy(compspec, s->batch_spec + i * s->fft_size,
+        s->winsize * sizeof(smpl_t));
+    return;
+  }
+#endif /* HAVE_FFTW3 */
+  (void)batched;
+  // the twiddle tables and work buffers of s stay hot across frames
+  aubio_fft_do_complex_data(s, frames->data[i], compspec);
+}
+
+uint_t aubio_fft_do_complex_batch(aubio_fft_t * s, const fmat_t * frames,
+    fmat_t * compspecs) {
+  uint_t i, batched;
+  if (frames->length != s->winsize || compspecs->length != s->winsize
+      || compspecs->height < frames->height) {
+    AUBIO_ERR("fft: batch of %dx%d frames does not fit fft of size %d"
+        " and %dx%d output\n", frames->height, frames->length, s->winsize,
+        compspecs->height, compspecs->length);
+    return AUBIO_FAIL;
+  }
+  batched = aubio_fft_batch_execute(s, frames);
+  for (i = 0; i < frames->height; i++) {
+    aubio_fft_batch_unpack(s, frames, batched, i, compspecs->data[i]);
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_fft_do_batch(aubio_fft_t * s, const fmat_t * frames,
+    fmat_t * norms, fmat_t * phases) {
+  uint_t i, batched;
+  cvec_t spectrum;
+  if (frames->length != s->winsize || norms->length != s->winsize / 2 + 1
+      || phases->length != norms->length
+      || norms->height < frames->height || phases->height < frames->height) {
+    AUBIO_ERR("fft: batch of %dx%d frames does not fit fft of size %d"
+        " and %dx%d output\n", frames->height, frames->length, s->winsize,
+        norms->height, norms->length);
+    return AUBIO_FAIL;
+  }
+  if (s->gpu && aubio_gpu_fft_batch(s->gpu, frames, frames->height, NULL,
+        norms, phases) == AUBIO_OK) {
+    return AUBIO_OK;
+  }
+  batched = aubio_fft_batch_execute(s, frames);
+  spectrum.length = norms->length;
+  for (i = 0; i < frames->height; i++) {
+    aubio_fft_batch_unpack(s, frames, batched, i, s->compspec->data);
+    spectrum.norm = norms->data[i];
+    spectrum.phas = phases->data[i];
+    aubio_fft_get_spectrum(s->compspec, &spectrum);
+  }
+  return AUBIO_OK;
+}
+
+/* inverse transform of the n_frames spectra already written in the rows of
+   batch_spec into the rows of frames */
+static uint_t aubio_fft_batch_rexecute(aubio_fft_t * s, uint_t n_frames,
+    fmat_t * frames) {
 #ifdef HAVE_FFTW3
   const smpl_t renorm = 1./(smpl_t)s->winsize;
-#ifdef HAVE_COMPLEX_H
-  s->specdata[0] = compspec->data[0];
-  for (i=1; i < s->fft_size - 1; i++) {
-    s->specdata[i] = compspec->data[i] +
-      I * compspec->data[compspec->length - i];
+  uint_t i, j;
+  const real_t *out;
+  fftw_execute(s->pbatch_bw);
+  for (i = 0; i < n_frames; i++) {
+    out = s->batch_in + i * s->winsize;
+    for (j = 0; j < s->winsize; j++) {
+      frames->data[i][j] = out[j] * renorm;
+    }
   }
-  s->specdata[s->fft_size - 1] = compspec->data[s->fft_size - 1];
+  return AUBIO_OK;
 #else
-  for (i=0; i < s->fft_size; i++) {
-    s->specdata[i] = compspec->data[i];
+  (void)s; (void)n_frames; (void)frames;
+  return AUBIO_FAIL;
+#endif /* HAVE_FFTW3 */
+}
+
+/* row i of batch_spec, or NULL when the frames are transformed one by one */
+static smpl_t *aubio_fft_batch_spec_row(aubio_fft_t * s, uint_t n_frames,
+    uint_t i) {
+#ifdef HAVE_FFTW3
+  if (n_frames > 1
+      && (i > 0 || aubio_fft_fftw_batch_setup(s, n_frames) == AUBIO_OK)) {
+    return s->batch_spec + i * s->fft_size;
+  }
+#endif /* HAVE_FFTW3 */
+  (void)s; (void)n_frames; (void)i;
+  return NULL;
+}
+
+uint_t aubio_fft_rdo_complex_batch(aubio_fft_t * s, const fmat_t * compspecs,
+    fmat_t * frames) {
+  uint_t i;
+  smpl_t *row;
+  fvec_t compspec, frame;
+  if (compspecs->length != s->winsize || frames->length != s->winsize
+      || frames->height < compspecs->height) {
+    AUBIO_ERR("fft: batch of %dx%d spectra does not fit fft of size %d"
+        " and %dx%d output\n", compspecs->height, compspecs->length,
+        s->winsize, frames->height, frames->length);
+    return AUBIO_FAIL;
+  }
+  if (aubio_fft_batch_spec_row(s, compspecs->height, 0)) {
+    for (i = 0; i < compspecs->height; i++) {
+      row = aubio_fft_batch_spec_row(s, compspecs->height, i);
+      memcpy(row, compspecs->data[i], s->winsize * sizeof(smpl_t));
+    }
+    return aubio_fft_batch_rexecute(s, compspecs->height, frames);
+  }
+  compspec.length = frame.length = s->winsize;
+  for (i = 0; i < compspecs->height; i++) {
+    compspec.data = compspecs->data[i];
+    frame.data = frames->data[i];
+    aubio_fft_rdo_complex(s, &compspec, &frame);
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_fft_rdo_batch(aubio_fft_t * s, const fmat_t * norms,
+    const fmat_t * phases, fmat_t * frames) {
+  uint_t i, batched;
+  cvec_t spectrum;
+  fvec_t compspec, frame;
+  if (frames->length != s->winsize || norms->length != s->winsize / 2 + 1
+      || phases->length != norms->length || phases->height < norms->height
+      || frames->height < norms->height) {
+    AUBIO_ERR("fft: batch of %dx%d spectra does not fit fft of size %d"
+        " and %dx%d output\n", norms->height, norms->length, s->winsize,
+        frames->height, frames->length);
+    return AUBIO_FAIL;
+  }
+  batched = aubio_fft_batch_spec_row(s, norms->height, 0) != NULL;
+  spectrum.length = norms->length;
+  compspec.length = frame.length = s->winsize;
+  for (i = 0; i < norms->height; i++) {
+    spectrum.norm = norms->data[i];
+    spectrum.phas = phases->data[i];
+    if (batched) {
+      // straight into the input of the many-plan
+      compspec.data = aubio_fft_batch_spec_row(s, norms->height, i);
+      aubio_fft_get_realimag(&spectrum, &compspec);
+    } else {
+      aubio_fft_get_realimag(&spectrum, s->compspec);
+      frame.data = frames->data[i];
+      aubio_fft_rdo_complex(s, s->compspec, &frame);
+    }
+  }
+  if (batched) {
+    return aubio_fft_batch_rexecute(s, norms->height, frames);
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_fft_set_gpu(aubio_fft_t * s, aubio_gpu_t * gpu) {
+  s->gpu = gpu;
+  return AUBIO_OK;
+}
+
+void aubio_fft_rdo_complex(aubio_fft_t * s, const fvec_t * compspec, fvec_t * output) {
+  uint_t i;
+  AUBIO_STATS_BEGIN ("fft backward");
+#ifndef HAVE_FFTW3
+  if (s->rfft) {
+    aubio_rfft_backward(s->rfft, compspec->data, output->data);
+    AUBIO_STATS_END ();
+    return;
   }
 #endif
-  fftw_execute(s->pbw);
-  for (i = 0; i < output->length; i++) {
-    output->data[i] = s->out[i]*renorm;
+#ifdef HAVE_FFTW3
+  const smpl_t renorm = 1./(smpl_t)s->winsize;
+  // HC2R plans overwrite their input, which must be copied
+  memcpy(s->specdata, compspec->data, s->winsize * sizeof(smpl_t));
+  if (AUBIO_FFTW_ALIGNED(output->data) && output->length == s->winsize) {
+    fftw_execute_r2r(s->plans->pbw, s->specdata, output->data);
+    for (i = 0; i < output->length; i++) {
+      output->data[i] *= renorm;
+    }
+  } else {
+    fftw_execute_r2r(s->plans->pbw, s->specdata, s->out);
+    for (i = 0; i < output->length; i++) {
+      output->data[i] = s->out[i]*renorm;
+    }
   }
 
 #elif defined HAVE_ACCELERATE // using ACCELERATE
@@ -468,18 +946,10 @@ void aubio_fft_rdo_complex(aubio_fft_t * s, const fvec_t * compspec, fvec_t * ou
   aubio_ippsMulC(output->data, 1.0 / s->winsize, output->data, s->fft_size);
 
 #else                         // using OOURA
-  smpl_t scale = 2.0 / s->winsize;
-  s->out[0] = compspec->data[0];
-  s->out[1] = compspec->data[s->winsize / 2];
-  for (i = 1; i < s->fft_size - 1; i++) {
-    s->out[2 * i] = compspec->data[i];
-    s->out[2 * i + 1] = - compspec->data[s->winsize - i];
-  }
-  aubio_ooura_rdft(s->winsize, -1, s->out, s->ip, s->w);
-  for (i=0; i < s->winsize; i++) {
-    output->data[i] = s->out[i] * scale;
-  }
+  s->backward(s, compspec->data, output->data);
+  (void)i;
 #endif
+  AUBIO_STATS_END ();
 }
 
 void aubio_fft_get_spectrum(const fvec_t * compspec, cvec_t * spectrum) {
@@ -487,7 +957,33 @@ void aubio_fft_get_spectrum(const fvec_t * compspec, cvec_t * spectrum) {
   aubio_fft_get_norm(compspec, spectrum);
 }
 
+/* real parts, if parts & 2, and imaginary parts, if parts & 1, of the bins
+ * of spectrum, using the sin and cos approximations of the kernels */
+static void aubio_fft_get_rect(const cvec_t * spectrum, fvec_t * compspec,
+    uint_t parts) {
+  smpl_t re[AUBIO_FFT_PHAS_BLOCK], im[AUBIO_FFT_PHAS_BLOCK];
+  uint_t n_real = compspec->length / 2 + 1;
+  uint_t n_imag = (compspec->length + 1) / 2;
+  uint_t i, j, n;
+  for (i = 0; i < n_real; i += n) {
+    n = MIN(AUBIO_FFT_PHAS_BLOCK, n_real - i);
+    AUBIO_SIMD()->rect(spectrum->norm + i, spectrum->phas + i, re, im, n);
+    if (parts & 2) {
+      memcpy(compspec->data + i, re, n * sizeof(smpl_t));
+    }
+    if (parts & 1) {
+      for (j = (i == 0) ? 1 : 0; j < n && i + j < n_imag; j++) {
+        compspec->data[compspec->length - i - j] = im[j];
+      }
+    }
+  }
+}
+
 void aubio_fft_get_realimag(const cvec_t * spectrum, fvec_t * compspec) {
+  if (aubio_simd_fast_math) {
+    aubio_fft_get_rect(spectrum, compspec, 3);
+    return;
+  }
   aubio_fft_get_imag(spectrum, compspec);
   aubio_fft_get_real(spectrum, compspec);
 }
@@ -514,9 +1010,22 @@ void aubio_fft_get_phas(const fvec_t * compspec, cvec_t * spectrum) {
         compspec->data[compspec->length - i]);
   }
 #else
-  for (i=1; i < spectrum->length - 1; i++) {
-    spectrum->phas[i] = ATAN2(compspec->data[compspec->length-i],
-        compspec->data[i]);
+  if (aubio_simd_fast_math) {
+    // gather the reversed imaginary parts by blocks, next to the real parts
+    smpl_t imag[AUBIO_FFT_PHAS_BLOCK];
+    uint_t j, n;
+    for (i = 1; i < spectrum->length - 1; i += n) {
+      n = MIN(AUBIO_FFT_PHAS_BLOCK, spectrum->length - 1 - i);
+      for (j = 0; j < n; j++) {
+        imag[j] = compspec->data[compspec->length - i - j];
+      }
+      AUBIO_SIMD()->vatan2(imag, compspec->data + i, spectrum->phas + i, n);
+    }
+  } else {
+    for (i=1; i < spectrum->length - 1; i++) {
+      spectrum->phas[i] = ATAN2(compspec->data[compspec->length-i],
+          compspec->data[i]);
+    }
   }
 #endif
 #ifdef HAVE_FFTW3
@@ -538,11 +1047,15 @@ void aubio_fft_get_phas(const fvec_t * compspec, cvec_t * spectrum) {
 }
 
 void aubio_fft_get_norm(const fvec_t * compspec, cvec_t * spectrum) {
-  uint_t i = 0;
+  smpl_t imag[AUBIO_FFT_PHAS_BLOCK];
+  uint_t i, j, n;
   spectrum->norm[0] = ABS(compspec->data[0]);
-  for (i=1; i < spectrum->length - 1; i++) {
-    spectrum->norm[i] = SQRT(SQR(compspec->data[i])
-        + SQR(compspec->data[compspec->length - i]) );
+  for (i = 1; i < spectrum->length - 1; i += n) {
+    n = MIN(AUBIO_FFT_PHAS_BLOCK, spectrum->length - 1 - i);
+    for (j = 0; j < n; j++) {
+      imag[j] = compspec->data[compspec->length - i - j];
+    }
+    AUBIO_SIMD()->vhypot(compspec->data + i, imag, spectrum->norm + i, n);
   }
 #ifdef HAVE_FFTW3
   // for even length, make sure last element is > 0
@@ -561,6 +1074,10 @@ void aubio_fft_get_norm(const fvec_t * compspec, cvec_t * spectrum) {
 
 void aubio_fft_get_imag(const cvec_t * spectrum, fvec_t * compspec) {
   uint_t i;
+  if (aubio_simd_fast_math) {
+    aubio_fft_get_rect(spectrum, compspec, 1);
+    return;
+  }
   for (i = 1; i < ( compspec->length + 1 ) / 2 /*- 1 + 1*/; i++) {
     compspec->data[compspec->length - i] =
       spectrum->norm[i]*SIN(spectrum->phas[i]);
@@ -569,8 +1086,175 @@ void aubio_fft_get_imag(const cvec_t * spectrum, fvec_t * compspec) {
 
 void aubio_fft_get_real(const cvec_t * spectrum, fvec_t * compspec) {
   uint_t i;
+  if (aubio_simd_fast_math) {
+    aubio_fft_get_rect(spectrum, compspec, 2);
+    return;
+  }
   for (i = 0; i < compspec->length / 2 + 1; i++) {
     compspec->data[i] =
       spectrum->norm[i]*COS(spectrum->phas[i]);
   }
 }
+
+#ifdef HAVE_FFTW3
+static aubio_fftw_plans_t *aubio_fftw_plans_acquire (uint_t winsize)
+{
+  aubio_fftw_plans_t *plans;
+  real_t *in, *out;
+  real_t *spec;
+  AUBIO_FFTW_LOCK();
+  for (plans = aubio_fftw_plans; plans; plans = plans->next) {
+    if (plans->winsize == winsize) {
+      plans->refcount++;
+      pthread_mutex_unlock(&aubio_fftw_mutex);
+      return plans;
+    }
+  }
+  plans = AUBIO_NEW(aubio_fftw_plans_t);
+  /* scratch arrays, only used during planning */
+  in = (real_t*)fftw_malloc(sizeof(real_t)*winsize);
+  out = (real_t*)fftw_malloc(sizeof(real_t)*winsize);
+  spec = (real_t*)fftw_malloc(sizeof(real_t)*winsize);
+  if (plans && in && out && spec) {
+    aubio_fftw_set_plan_threads(winsize);
+    plans->pfw = fftw_plan_r2r_1d(winsize, in, spec, FFTW_R2HC,
+        aubio_fftw_flags);
+    plans->pbw = fftw_plan_r2r_1d(winsize, spec, out, FFTW_HC2R,
+        aubio_fftw_flags);
+  }
+  if (in) fftw_free(in);
+  if (out) fftw_free(out);
+  if (spec) fftw_free(spec);
+  if (plans && (!plans->pfw || !plans->pbw)) {
+    if (plans->pfw) fftw_destroy_plan(plans->pfw);
+    if (plans->pbw) fftw_destroy_plan(plans->pbw);
+    AUBIO_FREE(plans);
+    plans = NULL;
+  }
+  if (plans) {
+    plans->winsize = winsize;
+    plans->refcount = 1;
+    plans->next = aubio_fftw_plans;
+    aubio_fftw_plans = plans;
+  }
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return plans;
+}
+
+/* choose the number of threads of the next plan, for a transform of
+   n_samples in total; called with aubio_fftw_mutex held */
+static void aubio_fftw_set_plan_threads (uint_t n_samples)
+{
+#ifdef HAVE_FFTW3_THREADS
+  static uint_t initialised = 0;
+  if (!initialised) {
+    if (!fftw_init_threads()) {
+      AUBIO_WRN("fft: failed initialising threads\n");
+      return;
+    }
+    initialised = 1;
+  }
+  fftw_plan_with_nthreads(n_samples >= AUBIO_FFTW_THREADS_MIN ?
+      (int)aubio_fftw_threads : 1);
+#else
+  (void)n_samples;
+#endif
+}
+
+static void aubio_fftw_plans_release (aubio_fftw_plans_t *plans)
+{
+  aubio_fftw_plans_t **p;
+  AUBIO_FFTW_LOCK();
+  if (--plans->refcount == 0) {
+    for (p = &aubio_fftw_plans; *p; p = &(*p)->next) {
+      if (*p == plans) {
+        *p = plans->next;
+        break;
+      }
+    }
+    fftw_destroy_plan(plans->pfw);
+    fftw_destroy_plan(plans->pbw);
+    AUBIO_FREE(plans);
+  }
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+}
+#endif /* HAVE_FFTW3 */
+
+uint_t aubio_fft_set_planner (const char_t *mode)
+{
+#ifdef HAVE_FFTW3
+  unsigned flags;
+  if (!mode) return AUBIO_FAIL;
+  if (strcmp(mode, "estimate") == 0) flags = FFTW_ESTIMATE;
+  else if (strcmp(mode, "measure") == 0) flags = FFTW_MEASURE;
+  else if (strcmp(mode, "patient") == 0) flags = FFTW_PATIENT;
+  else {
+    AUBIO_ERR("fft: unknown planner mode '%s'\n", mode);
+    return AUBIO_FAIL;
+  }
+  AUBIO_FFTW_LOCK();
+  aubio_fftw_flags = flags;
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return AUBIO_OK;
+#else
+  // other implementations have no planner, accept the default mode only
+  if (mode && strcmp(mode, "estimate") == 0) return AUBIO_OK;
+  return AUBIO_FAIL;
+#endif
+}
+
+uint_t aubio_fft_set_threads (uint_t threads)
+{
+  if ((sint_t)threads < 1) {
+    AUBIO_ERR("fft: can not use %d threads\n", threads);
+    return AUBIO_FAIL;
+  }
+#ifdef HAVE_FFTW3_THREADS
+  AUBIO_FFTW_LOCK();
+  aubio_fftw_threads = threads;
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return AUBIO_OK;
+#else
+  // without threaded fftw, transforms always run on the calling thread
+  return (threads == 1) ? AUBIO_OK : AUBIO_FAIL;
+#endif
+}
+
+uint_t aubio_fft_get_threads (void)
+{
+#ifdef HAVE_FFTW3_THREADS
+  return aubio_fftw_threads;
+#else
+  return 1;
+#endif
+}
+
+uint_t aubio_fft_load_wisdom (const char_t *path)
+{
+#ifdef HAVE_FFTW3
+  int ok;
+  if (!path) return AUBIO_FAIL;
+  AUBIO_FFTW_LOCK();
+  ok = fftw_import_wisdom_from_filename(path);
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return ok ? AUBIO_OK : AUBIO_FAIL;
+#else
+  (void)path;
+  return AUBIO_FAIL;
+#endif
+}
+
+uint_t aubio_fft_save_wisdom (const char_t *path)
+{
+#ifdef HAVE_FFTW3
+  int ok;
+  if (!path) return AUBIO_FAIL;
+  AUBIO_FFTW_LOCK();
+  ok = fftw_export_wisdom_to_filename(path);
+  pthread_mutex_unlock(&aubio_fftw_mutex);
+  return ok ? AUBIO_OK : AUBIO_FAIL;
+#else
+  (void)path;
+  return AUBIO_FAIL;
+#endif
+}
@@ -58,6 +58,17 @@ aubio_fft_t * new_aubio_fft (uint_t size);
 */
 void del_aubio_fft(aubio_fft_t * s);
 
+/** get the memory used by an FFT object
+
+  \param s fft object as returned by new_aubio_fft
+
+  \return number of bytes allocated by the object; the plans FFTW shares
+  between the objects of the same size are not counted, see
+  utils/allocator.h
+
+*/
+uint_t aubio_fft_get_memory_usage(const aubio_fft_t * s);
+
 /** compute forward FFT
 
   \param s fft object as returned by new_aubio_fft
@@ -66,6 +77,17 @@ void del_aubio_fft(aubio_fft_t * s);
 
 */
 void aubio_fft_do (aubio_fft_t *s, const fvec_t * input, cvec_t * spectrum);
+/** compute forward FFT, magnitudes only
+
+  Same as aubio_fft_do(), but only the norm of `spectrum` is computed. Its
+  phas array is left untouched.
+
+  \param s fft object as returned by new_aubio_fft
+  \param input input signal
+  \param spectrum output spectrum
+
+*/
+void aubio_fft_do_norm (aubio_fft_t *s, const fvec_t * input, cvec_t * spectrum);
 /** compute backward (inverse) FFT
 
   \param s fft object as returned by new_aubio_fft
@@ -83,6 +105,20 @@ void aubio_fft_rdo (aubio_fft_t *s, const cvec_t * spectrum, fvec_t * output);
 
 */
 void aubio_fft_do_complex (aubio_fft_t *s, const fvec_t * input, fvec_t * compspec);
+/** compute forward FFT of a windowed and shifted grain
+
+  Equivalent to weighting `input` by `window`, applying fvec_shift() and
+  calling aubio_fft_do_complex(), but done in a single pass over the grain,
+  directly into the transform input buffer. `input` is left untouched.
+
+  \param s fft object as returned by new_aubio_fft
+  \param input real input signal
+  \param window analysis window, same length as `input`
+  \param compspec complex output fft real/imag
+
+*/
+void aubio_fft_do_complex_windowed (aubio_fft_t *s, const fvec_t * input,
+    const fvec_t * window, fvec_t * compspec);
 /** compute backward (inverse) FFT from real/imag
 
   \param s fft object as returned by new_aubio_fft
@@ -92,6 +128,79 @@ void aubio_fft_do_complex (aubio_fft_t *s, const fvec_t * input, fvec_t * compsp
 */
 void aubio_fft_rdo_complex (aubio_fft_t *s, const fvec_t * compspec, fvec_t * output);
 
+/** compute forward FFT of several frames at once
+
+  \param s fft object as returned by new_aubio_fft
+  \param frames input signal, one frame of `size` samples per row
+  \param compspecs complex output, one real/imag fft array per row
+
+  \return 0 on success, non-zero if the matrices do not fit the fft size
+
+  With FFTW3, all the frames are transformed with a single plan. With other
+  implementations, the frames are processed in one loop sharing the same
+  twiddle tables and work buffers.
+
+*/
+uint_t aubio_fft_do_complex_batch (aubio_fft_t *s, const fmat_t * frames,
+    fmat_t * compspecs);
+
+/** compute forward FFT of several frames at once, as norm and phase
+
+  \param s fft object as returned by new_aubio_fft
+  \param frames input signal, one frame of `size` samples per row
+  \param norms output norms, `size / 2 + 1` bins per row
+  \param phases output phases, `size / 2 + 1` bins per row
+
+  \return 0 on success, non-zero if the matrices do not fit the fft size
+
+*/
+uint_t aubio_fft_do_batch (aubio_fft_t *s, const fmat_t * frames,
+    fmat_t * norms, fmat_t * phases);
+
+/** compute backward (inverse) FFT of several spectra at once
+
+  \param s fft object as returned by new_aubio_fft
+  \param compspecs real/imag input fft arrays, one per row
+  \param frames real output, one frame of `size` samples per row
+
+  \return 0 on success, non-zero if the matrices do not fit the fft size
+
+  As with aubio_fft_do_complex_batch(), FFTW3 runs a single plan over all the
+  spectra; the other implementations call aubio_fft_rdo_complex() on each
+  row in turn.
+
+*/
+uint_t aubio_fft_rdo_complex_batch (aubio_fft_t *s, const fmat_t * compspecs,
+    fmat_t * frames);
+
+/** compute backward (inverse) FFT of several spectra given as norm and phase
+
+  \param s fft object as returned by new_aubio_fft
+  \param norms input norms, `size / 2 + 1` bins per row
+  \param phases input phases, `size / 2 + 1` bins per row
+  \param frames real output, one frame of `size` samples per row
+
+  \return 0 on success, non-zero if the matrices do not fit the fft size
+
+*/
+uint_t aubio_fft_rdo_batch (aubio_fft_t *s, const fmat_t * norms,
+    const fmat_t * phases, fmat_t * frames);
+
+/** run aubio_fft_do_batch() on a GPU
+
+  \param s fft object as returned by new_aubio_fft
+  \param gpu device, as returned by new_aubio_gpu(), or `NULL` to compute
+  the next batches on the processor again
+
+  \return 0 on success
+
+  The device is only used for sizes that are powers of 2. It is not owned by
+  the fft object, and must stay alive until it is detached or the object is
+  deleted. See spectral/gpu.h.
+
+*/
+uint_t aubio_fft_set_gpu (aubio_fft_t *s, aubio_gpu_t *gpu);
+
 /** convert real/imag spectrum to norm/phas spectrum
 
   \param compspec real/imag input fft array
@@ -137,6 +246,60 @@ void aubio_fft_get_norm(const fvec_t * compspec, cvec_t * spectrum);
 */
 void aubio_fft_get_real(const cvec_t * spectrum, fvec_t * compspec);
 
+/** select how FFTW3 plans are created
+
+  \param mode one of `estimate` (default), `measure` or `patient`
+
+  \return 0 on success, non-zero otherwise
+
+  All fft objects of the same size share a single pair of plans, created with
+  the current mode when the first of them is created. Slower modes produce
+  faster plans; use aubio_fft_load_wisdom() to avoid measuring again at each
+  start. With other implementations, only `estimate` is accepted.
+
+*/
+uint_t aubio_fft_set_planner (const char_t *mode);
+
+/** set the number of threads used by large FFTW3 transforms
+
+  \param threads number of threads, 1 by default
+
+  \return 0 on success, non-zero otherwise
+
+  Only the plans of transforms of at least 16384 samples use several
+  threads, those of shorter ones, such as the ones of real-time analysis,
+  stay on the calling thread. As for aubio_fft_set_planner(), the number of
+  threads is fixed when the plans of a size are first created. Without a
+  threaded FFTW3 library, only 1 is accepted.
+
+*/
+uint_t aubio_fft_set_threads (uint_t threads);
+
+/** get the number of threads used by large FFTW3 transforms
+
+  \return number of threads set with aubio_fft_set_threads()
+
+*/
+uint_t aubio_fft_get_threads (void);
+
+/** import FFTW3 wisdom from a file
+
+  \param path path to a wisdom file written by aubio_fft_save_wisdom()
+
+  \return 0 on success, non-zero on failure or without FFTW3
+
+*/
+uint_t aubio_fft_load_wisdom (const char_t *path);
+
+/** export FFTW3 wisdom accumulated by planning to a file
+
+  \param path path to the wisdom file to write
+
+  \return 0 on success, non-zero on failure or without FFTW3
+
+*/
+uint_t aubio_fft_save_wisdom (const char_t *path);
+
 #ifdef __cplusplus
 }
 #endif
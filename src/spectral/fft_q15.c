@@ -0,0 +1,197 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "spectral/fft_q15_priv.h"
+
+/* the block is halved before a pass when one of its values reaches this, so
+ * that the values of a pass, at most 1 + sqrt(2) times larger, fit 31 bits */
+#define AUBIO_FFT_Q15_LIMIT (1 << 29)
+
+struct _aubio_fft_q15_t {
+  uint_t size;                  /**< size of the real transform */
+  s16_t *window;                /**< Hann window, in Q15 [size] */
+  s16_t *cos;                   /**< cos (2 pi k / size), in Q15 [size / 2] */
+  s16_t *sin;                   /**< sin (2 pi k / size), in Q15 [size / 2] */
+  sint_t *data;                 /**< interleaved complex block [size] */
+};
+
+aubio_fft_q15_t *new_aubio_fft_q15 (uint_t size)
+{
+  aubio_fft_q15_t *s = AUBIO_NEW (aubio_fft_q15_t);
+  uint_t i;
+  if (!s) return NULL;
+  if (size < 16 || size > 8192 || (size & (size - 1)) != 0) {
+    AUBIO_ERR ("fft_q15: got size %d, expected a power of 2 from 16 to 8192\n",
+        size);
+    goto beach;
+  }
+  s->size = size;
+  s->window = AUBIO_ARRAY (s16_t, size);
+  s->cos = AUBIO_ARRAY (s16_t, size / 2);
+  s->sin = AUBIO_ARRAY (s16_t, size / 2);
+  s->data = AUBIO_ARRAY (sint_t, size);
+  if (!s->window || !s->cos || !s->sin || !s->data) goto beach;
+  for (i = 0; i < size; i++) {
+    s->window[i] = (s16_t) ROUND (16383.5 * (1. - COS (TWO_PI * i / size)));
+  }
+  for (i = 0; i < size / 2; i++) {
+    s->cos[i] = (s16_t) ROUND (32767. * COS (TWO_PI * i / size));
+    s->sin[i] = (s16_t) ROUND (32767. * SIN (TWO_PI * i / size));
+  }
+  return s;
+
+beach:
+  del_aubio_fft_q15 (s);
+  return NULL;
+}
+
+void del_aubio_fft_q15 (aubio_fft_q15_t *s)
+{
+  AUBIO_ASSERT (s);
+  if (s->window) AUBIO_FREE (s->window);
+  if (s->cos) AUBIO_FREE (s->cos);
+  if (s->sin) AUBIO_FREE (s->sin);
+  if (s->data) AUBIO_FREE (s->data);
+  AUBIO_FREE (s);
+}
+
+uint_t aubio_fft_q15_get_memory_usage (const aubio_fft_q15_t *s)
+{
+  return aubio_malloc_size (s) + aubio_malloc_size (s->window)
+    + aubio_malloc_size (s->cos) + aubio_malloc_size (s->sin)
+    + aubio_malloc_size (s->data);
+}
+
+/* halve the block while its largest value reaches the limit, and return the
+ * number of halvings */
+static uint_t aubio_fft_q15_rescale (sint_t *data, uint_t length)
+{
+  uint_t i, shift = 0;
+  sint_t max = 0;
+  for (i = 0; i < length; i++) {
+    sint_t v = data[i] < 0 ? -data[i] : data[i];
+    if (v > max) max = v;
+  }
+  while ((max >> shift) >= AUBIO_FFT_Q15_LIMIT) shift++;
+  if (shift) {
+    for (i = 0; i < length; i++) data[i] >>= shift;
+  }
+  return shift;
+}
+
+/* integer square root of a 32 bit value */
+static uint_t aubio_fft_q15_isqrt32 (uint_t v)
+{
+  uint_t root = 0, bit = 1u << 30;
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+/* square root of a 64 bit value, to 16 significant bits */
+static uint_t aubio_fft_q15_isqrt (unsigned long long v)
+{
+  uint_t shift = 0;
+  while (v >> 32) {
+    v >>= 2;
+    shift++;
+  }
+  return aubio_fft_q15_isqrt32 ((uint_t) v) << shift;
+}
+
+void aubio_fft_q15_norm (aubio_fft_q15_t *s, const s16_t *frame, uint_t *norm)
+{
+  uint_t size = s->size, half = size / 2, i, j, k, len;
+  sint_t *data = s->data;
+  // the block holds the transform times 2^(14 - halvings)
+  sint_t exponent = 14;
+
+  // window the frame: x * w / 2 is the windowed sample in Q15 times 2^14
+  for (i = 0; i < size; i++) {
+    data[i] = ((sint_t) frame[i] * s->window[i]) >> 1;
+  }
+
+  // bit reversal of the half size complex block
+  for (i = 0, j = 0; i < half; i++) {
+    if (i < j) {
+      sint_t re = data[2 * i], im = data[2 * i + 1];
+      data[2 * i] = data[2 * j];
+      data[2 * i + 1] = data[2 * j + 1];
+      data[2 * j] = re;
+      data[2 * j + 1] = im;
+    }
+    k = half >> 1;
+    while (k && (j & k)) {
+      j ^= k;
+      k >>= 1;
+    }
+    j |= k;
+  }
+
+  // radix 2 passes, the twiddles of pass len are every size / len
+  for (len = 2; len <= half; len <<= 1) {
+    uint_t step = size / len;
+    exponent -= aubio_fft_q15_rescale (data, size);
+    for (i = 0; i < half; i += len) {
+      for (k = 0; k < len / 2; k++) {
+        sint_t *a = data + 2 * (i + k), *b = a + len;
+        long long wr = s->cos[k * step], wi = -s->sin[k * step];
+        sint_t tr = (sint_t) ((b[0] * wr - b[1] * wi) >> 15);
+        sint_t ti = (sint_t) ((b[0] * wi + b[1] * wr) >> 15);
+        b[0] = a[0] - tr;
+        b[1] = a[1] - ti;
+        a[0] += tr;
+        a[1] += ti;
+      }
+    }
+  }
+  exponent -= aubio_fft_q15_rescale (data, size);
+
+  // split step, X[k] = (Z[k] + conj(Z[n-k])) / 2
+  //   - i W^k (Z[k] - conj(Z[n-k])) / 2, with n = size / 2 and Z[n] = Z[0]
+  for (k = 0; k <= half; k++) {
+    uint_t m = (k == 0 || k == half) ? 0 : half - k;
+    uint_t z = (k == half) ? 0 : k;
+    long long ar = data[2 * z], ai = data[2 * z + 1];
+    long long br = data[2 * m], bi = -data[2 * m + 1];
+    long long er = ar + br, ei = ai + bi;
+    long long fr = ai - bi, fi = br - ar;
+    long long wr = (k == half) ? -32767 : s->cos[k];
+    long long wi = (k == half) ? 0 : -s->sin[k];
+    long long xr = (er + ((fr * wr - fi * wi) >> 15)) >> 1;
+    long long xi = (ei + ((fr * wi + fi * wr) >> 15)) >> 1;
+    uint_t mag = aubio_fft_q15_isqrt ((unsigned long long) (xr * xr)
+        + (unsigned long long) (xi * xi));
+    if (exponent > 0) {
+      norm[k] = (mag + (1u << (exponent - 1))) >> exponent;
+    } else {
+      norm[k] = mag << -exponent;
+    }
+  }
+}
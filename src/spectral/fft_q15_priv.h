@@ -0,0 +1,55 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Fixed-point real FFT, used by tempo/tempo_q15.c.
+
+   The frame of 16 bit samples is windowed with a Hann window, and its real
+   transform of size N computed as a complex transform of size N/2 on the
+   even/odd samples, followed by a split step, as in spectral/rfft.c. The
+   samples are held on 32 bits, with a block exponent: before each pass, the
+   whole block is halved if its largest value could overflow, so that loud
+   frames keep their range and quiet ones their precision.
+
+   Only integer operations are used once the object is created, with 64 bit
+   products and sums, so that the transform runs on processors without a
+   floating point unit.
+*/
+
+#ifndef AUBIO_FFT_Q15_PRIV_H
+#define AUBIO_FFT_Q15_PRIV_H
+
+/** fixed-point real fft object */
+typedef struct _aubio_fft_q15_t aubio_fft_q15_t;
+
+/** create a fixed-point fft object of size a power of 2, from 16 to 8192 */
+aubio_fft_q15_t *new_aubio_fft_q15 (uint_t size);
+
+/** delete a fixed-point fft object */
+void del_aubio_fft_q15 (aubio_fft_q15_t *s);
+
+/** get the number of bytes allocated by a fixed-point fft object */
+uint_t aubio_fft_q15_get_memory_usage (const aubio_fft_q15_t *s);
+
+/** compute the size/2+1 magnitudes of the Hann windowed frame of size
+  samples, as ::aubio_fft_t would on samples scaled to [-1, 1], times 32768 */
+void aubio_fft_q15_norm (aubio_fft_q15_t *s, const s16_t *frame,
+    uint_t *norm);
+
+#endif /* AUBIO_FFT_Q15_PRIV_H */
@@ -24,8 +24,49 @@
 #include "fmat.h"
 #include "cvec.h"
 #include "vecutils.h"
+#include "spectral/gpu.h"
 #include "spectral/filterbank.h"
+#include "spectral/filterbank_priv.h"
+#include "spectral/gpu_priv.h"
 #include "mathutils.h"
+#include "utils/simd_priv.h"
+#include "utils/quantize.h"
+#include "utils/history.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_filterbank_lock = SRWLOCK_INIT;
+#define AUBIO_FILTERBANK_LOCK()   AcquireSRWLockExclusive(&aubio_filterbank_lock)
+#define AUBIO_FILTERBANK_UNLOCK() ReleaseSRWLockExclusive(&aubio_filterbank_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t aubio_filterbank_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_FILTERBANK_LOCK()   pthread_mutex_lock(&aubio_filterbank_mutex)
+#define AUBIO_FILTERBANK_UNLOCK() pthread_mutex_unlock(&aubio_filterbank_mutex)
+#endif
+
+/** coefficients shared by all the filterbanks that computed them */
+typedef struct _aubio_filterbank_shared_t
+{
+  smpl_t *key;                  /**< parameters the coefficients depend on */
+  uint_t key_length;            /**< number of elements in key */
+  fmat_t *coeffs;               /**< read-only coefficients */
+  uint_t refcount;              /**< number of filterbanks using coeffs */
+  struct _aubio_filterbank_shared_t *next;
+} aubio_filterbank_shared_t;
+
+/** list of shared coefficients, protected by aubio_filterbank_lock */
+static aubio_filterbank_shared_t *aubio_filterbank_shared = NULL;
+
+/** range of non-zero coefficients of each filter */
+typedef struct
+{
+  uint_t *start;        /**< index of the first non-zero coefficient */
+  uint_t *length;       /**< number of coefficients from start to the last
+                             non-zero one */
+  uint_t sparse;        /**< 1 if the ranges are used to compute the bands */
+  uint_t stale;         /**< 1 if the coefficients may have changed */
+} aubio_filterbank_spans_t;
 
 /** \brief A structure to store a set of n_filters filters of lenghts win_s */
 struct _aubio_filterbank_t
@@ -35,8 +76,27 @@ struct _aubio_filterbank_t
   fmat_t *filters;
   smpl_t norm;
   smpl_t power;
+  aubio_filterbank_spans_t *spans;
+  aubio_filterbank_shared_t *shared; /**< shared filters, or NULL */
+  fmat_t *batch;        /**< spectra raised to power, for do_batch */
+  fvec_t *bands;        /**< energies before quantization */
+  aubio_gpu_t *gpu;     /**< device running do_batch, or NULL */
+  aubio_history_t *history; /**< last bands computed, or NULL */
 };
 
+/** number of frames aubio_filterbank_do_batch() computes at once, small
+  enough for their spectra to stay in cache while each filter is applied */
+#define AUBIO_FILTERBANK_BATCH 64
+
+/* find the range of non-zero coefficients of each filter */
+static void aubio_filterbank_update_spans (aubio_filterbank_t * f);
+
+/* stop using shared coefficients, without changing f->filters */
+static void aubio_filterbank_release_shared (aubio_filterbank_t * f);
+
+/* replace shared coefficients with a private copy */
+static void aubio_filterbank_detach (aubio_filterbank_t * f);
+
 aubio_filterbank_t *
 new_aubio_filterbank (uint_t n_filters, uint_t win_s)
 {
@@ -60,6 +120,12 @@ new_aubio_filterbank (uint_t n_filters, uint_t win_s)
 
   /* allocate filter tables, a matrix of length win_s and of height n_filters */
   fb->filters = new_fmat (n_filters, win_s / 2 + 1);
+  fb->bands = new_fvec (n_filters);
+
+  fb->spans = AUBIO_NEW (aubio_filterbank_spans_t);
+  fb->spans->start = AUBIO_ARRAY (uint_t, n_filters);
+  fb->spans->length = AUBIO_ARRAY (uint_t, n_filters);
+  fb->spans->stale = 1;
 
   fb->norm = 1;
 
@@ -74,10 +140,35 @@ fail:
 void
 del_aubio_filterbank (aubio_filterbank_t * fb)
 {
-  del_fmat (fb->filters);
+  if (fb->shared) {
+    aubio_filterbank_release_shared (fb);
+  } else {
+    del_fmat (fb->filters);
+  }
+  if (fb->batch) del_fmat (fb->batch);
+  if (fb->bands) del_fvec (fb->bands);
+  if (fb->history) del_aubio_history (fb->history);
+  AUBIO_FREE (fb->spans->start);
+  AUBIO_FREE (fb->spans->length);
+  AUBIO_FREE (fb->spans);
   AUBIO_FREE (fb);
 }
 
+uint_t
+aubio_filterbank_get_memory_usage (const aubio_filterbank_t * fb)
+{
+  uint_t n = aubio_malloc_size (fb) + aubio_malloc_size (fb->batch)
+    + aubio_malloc_size (fb->bands)
+    + aubio_malloc_size (fb->spans) + aubio_malloc_size (fb->spans->start)
+    + aubio_malloc_size (fb->spans->length);
+  if (fb->history) n += aubio_history_get_memory_usage (fb->history);
+  /* shared coefficients are not counted */
+  if (!fb->shared) {
+    n += aubio_malloc_size (fb->filters);
+  }
+  return n;
+}
+
 void
 aubio_filterbank_do (aubio_filterbank_t * f, const cvec_t * in, fvec_t * out)
 {
@@ -87,18 +178,239 @@ aubio_filterbank_do (aubio_filterbank_t * f, const cvec_t * in, fvec_t * out)
 
   // view cvec->norm as fvec->data
   fvec_t tmp;
+  AUBIO_STATS_BEGIN ("filterbank");
   tmp.length = in->length;
   tmp.data = in->norm;
 
   if (f->power != 1.) fvec_pow(&tmp, f->power);
 
-  fmat_vecmul(f->filters, &tmp, out);
+  if (f->spans->stale) aubio_filterbank_update_spans (f);
 
+  if (f->spans->sparse) {
+    uint_t i;
+    for (i = 0; i < f->n_filters; i++) {
+      const smpl_t *coeffs = f->filters->data[i] + f->spans->start[i];
+      const smpl_t *norm = tmp.data + f->spans->start[i];
+#if defined(HAVE_INTEL_IPP)
+      aubio_ippsDotProd(coeffs, norm, (int)f->spans->length[i],
+          &out->data[i]);
+#elif defined(HAVE_ACCELERATE)
+      aubio_vDSP_dotpr(coeffs, 1, norm, 1, &out->data[i],
+          f->spans->length[i]);
+#else
+      out->data[i] = AUBIO_SIMD()->dot(coeffs, norm, f->spans->length[i]);
+#endif
+    }
+  } else {
+    fmat_vecmul(f->filters, &tmp, out);
+  }
+  if (f->history) {
+    fvec_t bands = { f->n_filters, out->data };
+    aubio_history_push (f->history, &bands);
+  }
+
+  AUBIO_STATS_END ();
   return;
 }
 
+#if defined(HAVE_BLAS)
+/* distance between successive rows of length samples if it is constant,
+   0 otherwise */
+static uint_t
+aubio_filterbank_row_stride (smpl_t ** rows, uint_t height, uint_t length)
+{
+  uint_t i;
+  sint_t stride = height > 1 ? (sint_t)(rows[1] - rows[0]) : (sint_t)length;
+  if (stride < (sint_t)length) return 0;
+  for (i = 2; i < height; i++) {
+    if (rows[i] - rows[i - 1] != stride) return 0;
+  }
+  return (uint_t)stride;
+}
+#endif
+
+/* bands of n_frames spectra, from the frame at rows[0] */
+static void
+aubio_filterbank_do_frames (aubio_filterbank_t * f, smpl_t ** rows,
+    smpl_t ** out, uint_t n_frames)
+{
+  const smpl_t *frames[AUBIO_FILTERBANK_BATCH];
+  smpl_t *bands[AUBIO_FILTERBANK_BATCH];
+  uint_t i, t;
+  if (!f->spans->sparse) {
+#if defined(HAVE_BLAS)
+    uint_t ld_in = aubio_filterbank_row_stride (rows, n_frames,
+        f->filters->length);
+    uint_t ld_out = aubio_filterbank_row_stride (out, n_frames, f->n_filters);
+    uint_t ld_filters = aubio_filterbank_row_stride (f->filters->data,
+        f->n_filters, f->filters->length);
+    if (ld_in && ld_out && ld_filters) {
+      // out = rows . filters^T, in a single product
+      aubio_cblas_gemm (CblasRowMajor, CblasNoTrans, CblasTrans, n_frames,
+          f->n_filters, f->filters->length, 1., rows[0], ld_in,
+          f->filters->data[0], ld_filters, 0., out[0], ld_out);
+      return;
+    }
+#endif
+    AUBIO_SIMD()->mmul ((const smpl_t * const *)rows,
+        (const smpl_t * const *)f->filters->data, out, n_frames,
+        f->n_filters, f->filters->length);
+    return;
+  }
+  /* filter by filter, on the non-zero coefficients only, each of them
+     loaded once for several frames */
+  for (i = 0; i < f->n_filters; i++) {
+    const smpl_t *coeffs = f->filters->data[i] + f->spans->start[i];
+    for (t = 0; t < n_frames; t++) {
+      frames[t] = rows[t] + f->spans->start[i];
+      bands[t] = out[t] + i;
+    }
+    AUBIO_SIMD()->mmul (frames, &coeffs, bands, n_frames, 1,
+        f->spans->length[i]);
+  }
+}
+
+void
+aubio_filterbank_do_log_u8 (aubio_filterbank_t * f, const cvec_t * in,
+    smpl_t min_db, smpl_t max_db, u8_t * out)
+{
+  uint_t i;
+  smpl_t *bands = f->bands->data;
+  aubio_filterbank_do (f, in, f->bands);
+  for (i = 0; i < f->n_filters; i++) {
+    bands[i] = 10. * SAFE_LOG10 (bands[i]);
+  }
+  aubio_quantize_u8 (f->bands, min_db, max_db, out);
+}
+
+void
+aubio_filterbank_do_f16 (aubio_filterbank_t * f, const cvec_t * in,
+    f16_t * out)
+{
+  aubio_filterbank_do (f, in, f->bands);
+  aubio_quantize_f16 (f->bands, out);
+}
+
+/* push the first n_frames rows of out to the history, if any */
+static void
+aubio_filterbank_record_batch (aubio_filterbank_t * f, const fmat_t * out,
+    uint_t n_frames)
+{
+  uint_t t;
+  if (!f->history) return;
+  for (t = 0; t < n_frames; t++) {
+    fvec_t row = { f->n_filters, out->data[t] };
+    aubio_history_push (f->history, &row);
+  }
+}
+
+uint_t
+aubio_filterbank_do_batch (aubio_filterbank_t * f, const fmat_t * spectra,
+    fmat_t * out)
+{
+  uint_t t, n;
+  if (spectra->length != f->filters->length || out->length != f->n_filters
+      || out->height < spectra->height) {
+    AUBIO_ERR ("filterbank: batch of %dx%d spectra does not fit %d filters"
+        " of %d bins and %dx%d output\n", spectra->height, spectra->length,
+        f->n_filters, f->filters->length, out->height, out->length);
+    return AUBIO_FAIL;
+  }
+  if (f->gpu && aubio_gpu_filterbank_batch (f->gpu, f->filters, f->power,
+        spectra, spectra->height, out) == AUBIO_OK) {
+    aubio_filterbank_record_batch (f, out, spectra->height);
+    return AUBIO_OK;
+  }
+  if (f->power != 1. && !f->batch) {
+    f->batch = new_fmat (AUBIO_FILTERBANK_BATCH, f->filters->length);
+    if (!f->batch) return AUBIO_FAIL;
+  }
+  AUBIO_STATS_BEGIN ("filterbank");
+  if (f->spans->stale) aubio_filterbank_update_spans (f);
+  for (t = 0; t < spectra->height; t += n) {
+    smpl_t **rows = spectra->data + t;
+    n = MIN (spectra->height - t, AUBIO_FILTERBANK_BATCH);
+    if (f->power != 1.) {
+      uint_t k;
+      for (k = 0; k < n; k++) {
+        fvec_t row = { f->batch->length, f->batch->data[k] };
+        AUBIO_MEMCPY (row.data, rows[k], row.length * sizeof(smpl_t));
+        fvec_pow (&row, f->power);
+      }
+      rows = f->batch->data;
+    }
+    aubio_filterbank_do_frames (f, rows, out->data + t, n);
+  }
+  aubio_filterbank_record_batch (f, out, spectra->height);
+  AUBIO_STATS_END ();
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_filterbank_set_history (aubio_filterbank_t * f, uint_t length)
+{
+  aubio_history_t *history = NULL;
+  if (length > 0) {
+    history = new_aubio_history (length, f->n_filters);
+    if (!history) return AUBIO_FAIL;
+  }
+  if (f->history) del_aubio_history (f->history);
+  f->history = history;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_filterbank_get_history (const aubio_filterbank_t * f)
+{
+  if (!f->history) return 0;
+  return aubio_history_get_frames (f->history)->height;
+}
+
+const fmat_t *
+aubio_filterbank_get_bands_history (const aubio_filterbank_t * f)
+{
+  if (!f->history) return NULL;
+  return aubio_history_get_frames (f->history);
+}
+
+uint_t
+aubio_filterbank_set_gpu (aubio_filterbank_t * f, aubio_gpu_t * gpu)
+{
+  f->gpu = gpu;
+  return AUBIO_OK;
+}
+
+static void
+aubio_filterbank_update_spans (aubio_filterbank_t * f)
+{
+  uint_t i, total = 0;
+  uint_t length = f->filters->length;
+  for (i = 0; i < f->n_filters; i++) {
+    const smpl_t *coeffs = f->filters->data[i];
+    uint_t start = 0, end = length;
+    while (start < length && coeffs[start] == 0.) start++;
+    while (end > start && coeffs[end - 1] == 0.) end--;
+    f->spans->start[i] = start;
+    f->spans->length[i] = end - start;
+    total += end - start;
+  }
+  /* only skip the dense product when most coefficients are zero */
+  f->spans->sparse = 2 * total < f->n_filters * length;
+  f->spans->stale = 0;
+}
+
 fmat_t *
 aubio_filterbank_get_coeffs (const aubio_filterbank_t * f)
+{
+  /* the caller may write to the coefficients, which can not be shared; f is
+     only const for the caller, the object itself is always writable */
+  aubio_filterbank_detach ((aubio_filterbank_t *) f);
+  f->spans->stale = 1;
+  return f->filters;
+}
+
+const fmat_t *
+aubio_filterbank_peek_coeffs (const aubio_filterbank_t * f)
 {
   return f->filters;
 }
@@ -106,7 +418,9 @@ aubio_filterbank_get_coeffs (const aubio_filterbank_t * f)
 uint_t
 aubio_filterbank_set_coeffs (aubio_filterbank_t * f, const fmat_t * filter_coeffs)
 {
+  aubio_filterbank_detach (f);
   fmat_copy(filter_coeffs, f->filters);
+  f->spans->stale = 1;
   return 0;
 }
 
@@ -136,3 +450,112 @@ aubio_filterbank_get_power (aubio_filterbank_t *f)
 {
   return f->power;
 }
+
+static aubio_filterbank_shared_t *
+aubio_filterbank_find_shared (const aubio_filterbank_t * f,
+    const smpl_t * key, uint_t key_length)
+{
+  aubio_filterbank_shared_t *shared;
+  for (shared = aubio_filterbank_shared; shared; shared = shared->next) {
+    if (shared->key_length == key_length
+        && shared->coeffs->height == f->filters->height
+        && shared->coeffs->length == f->filters->length
+        && memcmp (shared->key, key, key_length * sizeof(smpl_t)) == 0) {
+      return shared;
+    }
+  }
+  return NULL;
+}
+
+/* use the coefficients of shared, on which the caller holds a reference */
+static void
+aubio_filterbank_use_shared (aubio_filterbank_t * f,
+    aubio_filterbank_shared_t * shared)
+{
+  if (f->shared) {
+    aubio_filterbank_release_shared (f);
+  } else {
+    del_fmat (f->filters);
+  }
+  f->filters = shared->coeffs;
+  f->shared = shared;
+  f->spans->stale = 1;
+}
+
+uint_t
+aubio_filterbank_load_shared (aubio_filterbank_t * f, const smpl_t * key,
+    uint_t key_length)
+{
+  aubio_filterbank_shared_t *shared;
+  AUBIO_FILTERBANK_LOCK();
+  shared = aubio_filterbank_find_shared (f, key, key_length);
+  if (shared) shared->refcount++;
+  AUBIO_FILTERBANK_UNLOCK();
+  if (!shared) return AUBIO_FAIL;
+  aubio_filterbank_use_shared (f, shared);
+  return AUBIO_OK;
+}
+
+void
+aubio_filterbank_store_shared (aubio_filterbank_t * f, const smpl_t * key,
+    uint_t key_length)
+{
+  aubio_filterbank_shared_t *shared;
+  if (f->shared) return;
+  AUBIO_FILTERBANK_LOCK();
+  /* another filterbank may have stored the same coefficients meanwhile */
+  shared = aubio_filterbank_find_shared (f, key, key_length);
+  if (shared) {
+    shared->refcount++;
+    AUBIO_FILTERBANK_UNLOCK();
+    aubio_filterbank_use_shared (f, shared);
+    return;
+  }
+  shared = AUBIO_NEW (aubio_filterbank_shared_t);
+  shared->key = AUBIO_ARRAY (smpl_t, key_length);
+  if (!shared->key) {
+    AUBIO_FREE (shared);
+    AUBIO_FILTERBANK_UNLOCK();
+    return;
+  }
+  memcpy (shared->key, key, key_length * sizeof(smpl_t));
+  shared->key_length = key_length;
+  shared->coeffs = f->filters;
+  shared->refcount = 1;
+  shared->next = aubio_filterbank_shared;
+  aubio_filterbank_shared = shared;
+  f->shared = shared;
+  AUBIO_FILTERBANK_UNLOCK();
+}
+
+static void
+aubio_filterbank_release_shared (aubio_filterbank_t * f)
+{
+  aubio_filterbank_shared_t **p, *shared = f->shared;
+  AUBIO_FILTERBANK_LOCK();
+  if (--shared->refcount == 0) {
+    for (p = &aubio_filterbank_shared; *p; p = &(*p)->next) {
+      if (*p == shared) {
+        *p = shared->next;
+        break;
+      }
+    }
+    del_fmat (shared->coeffs);
+    AUBIO_FREE (shared->key);
+    AUBIO_FREE (shared);
+  }
+  AUBIO_FILTERBANK_UNLOCK();
+  f->shared = NULL;
+}
+
+static void
+aubio_filterbank_detach (aubio_filterbank_t * f)
+{
+  fmat_t *filters;
+  if (!f->shared) return;
+  filters = new_fmat (f->filters->height, f->filters->length);
+  fmat_copy (f->filters, filters);
+  aubio_filterbank_release_shared (f);
+  f->filters = filters;
+  f->spans->stale = 1;
+}
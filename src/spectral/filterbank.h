@@ -52,6 +52,19 @@ typedef struct _aubio_filterbank_t aubio_filterbank_t;
 */
 aubio_filterbank_t *new_aubio_filterbank (uint_t n_filters, uint_t win_s);
 
+/** get the memory used by a filterbank
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  Coefficients shared with other filterbanks, for instance by
+  aubio_filterbank_set_mel_coeffs(), are not counted.
+
+*/
+uint_t aubio_filterbank_get_memory_usage (const aubio_filterbank_t * f);
+
 /** destroy filterbank object
 
   \param f filterbank object, as returned by new_aubio_filterbank()
@@ -68,10 +81,115 @@ void del_aubio_filterbank (aubio_filterbank_t * f);
 */
 void aubio_filterbank_do (aubio_filterbank_t * f, const cvec_t * in, fvec_t * out);
 
+/** compute filterbank and encode the energies in dB as bytes
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+  \param in input spectrum, as given to aubio_filterbank_do()
+  \param min_db level encoded as 0, for instance -100.
+  \param max_db level encoded as 255, for instance 20.
+  \param out `n_filters` codes, one byte per band
+
+  The energy of each band is converted to `10 * log10(energy)`, then encoded
+  with aubio_quantize_u8(), a quarter of the size of the output of
+  aubio_filterbank_do() in single precision.
+
+*/
+void aubio_filterbank_do_log_u8 (aubio_filterbank_t * f, const cvec_t * in,
+    smpl_t min_db, smpl_t max_db, u8_t * out);
+
+/** compute filterbank and encode the energies as half-precision floats
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+  \param in input spectrum, as given to aubio_filterbank_do()
+  \param out `n_filters` half-precision floats, see aubio_quantize_f16()
+
+*/
+void aubio_filterbank_do_f16 (aubio_filterbank_t * f, const cvec_t * in,
+    f16_t * out);
+
+/** compute filterbank of several spectra at once
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+  \param spectra input norms, one spectrum of `win_s / 2 + 1` bins per row,
+  for instance the norms of aubio_fft_do_batch()
+  \param out output energies, `n_filters` bands per row, with at least as
+  many rows as `spectra`
+
+  \return 0 on success, non-zero if the matrices do not fit the filterbank
+
+  Each row of `out` is the output of aubio_filterbank_do() on the
+  corresponding row of `spectra`, but the frames are computed together, each
+  filter being applied to several frames at once. With BLAS, dense filters
+  are applied in a single matrix product. Unlike aubio_filterbank_do(),
+  `spectra` is left untouched when the power parameter is not `1`.
+
+*/
+uint_t aubio_filterbank_do_batch (aubio_filterbank_t * f,
+    const fmat_t * spectra, fmat_t * out);
+
+/** compute the batches of aubio_filterbank_do_batch() on a GPU
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+  \param gpu device, as returned by new_aubio_gpu(), or `NULL` to detach the
+  current one
+
+  \return 0 on success
+
+  The coefficients are sent to the device with each batch, so that changes
+  made through aubio_filterbank_get_coeffs() are always taken into account.
+  The filterbank does not own the device, which must outlive it or be
+  detached first.
+
+*/
+uint_t aubio_filterbank_set_gpu (aubio_filterbank_t * f, aubio_gpu_t * gpu);
+
+/** keep the bands computed over the last frames
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+  \param length number of frames to keep, or 0 to stop keeping them
+
+  \return 0 on success
+
+  The bands of each frame given to aubio_filterbank_do(),
+  aubio_filterbank_do_log_u8(), aubio_filterbank_do_f16() and
+  aubio_filterbank_do_batch() are then pushed to a history of `length`
+  frames, before any conversion to decibels or quantization. See
+  utils/history.h.
+
+*/
+uint_t aubio_filterbank_set_history (aubio_filterbank_t * f, uint_t length);
+
+/** get the number of frames kept by the history
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+
+  \return length given to aubio_filterbank_set_history(), or 0
+
+*/
+uint_t aubio_filterbank_get_history (const aubio_filterbank_t * f);
+
+/** get the bands of the last frames
+
+  \param f filterbank object, as returned by new_aubio_filterbank()
+
+  \return view of one row of `n_filters` bands per frame, oldest first, or
+  `NULL` if no history is kept. The rows follow each other in memory. The
+  view is not a copy, and is only valid until the next frame is computed.
+
+*/
+const fmat_t *aubio_filterbank_get_bands_history (
+    const aubio_filterbank_t * f);
+
 /** return a pointer to the matrix object containing all filter coefficients
 
   \param f filterbank object, as returned by new_aubio_filterbank()
 
+  The coefficients can be modified through the returned matrix. The range of
+  non-zero coefficients of each filter, used by aubio_filterbank_do() to skip
+  the zeros of sparse filters such as mel bands, is computed again on the
+  next call to aubio_filterbank_do(), so the changes should be made before
+  that call.
+
  */
 fmat_t *aubio_filterbank_get_coeffs (const aubio_filterbank_t * f);
 
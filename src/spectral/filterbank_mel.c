@@ -23,8 +23,10 @@
 #include "fmat.h"
 #include "fvec.h"
 #include "cvec.h"
+#include "spectral/gpu.h"
 #include "spectral/filterbank.h"
 #include "spectral/filterbank_mel.h"
+#include "spectral/filterbank_priv.h"
 #include "mathutils.h"
 
 uint_t
@@ -32,10 +34,13 @@ aubio_filterbank_set_triangle_bands (aubio_filterbank_t * fb,
     const fvec_t * freqs, smpl_t samplerate)
 {
 
-  fmat_t *filters = aubio_filterbank_get_coeffs (fb);
-  uint_t n_filters = filters->height, win_s = filters->length;
+  const fmat_t *coeffs = aubio_filterbank_peek_coeffs (fb);
+  uint_t n_filters = coeffs->height, win_s = coeffs->length;
+  fmat_t *filters;
   fvec_t *lower_freqs, *upper_freqs, *center_freqs;
   fvec_t *triangle_heights, *fft_freqs;
+  smpl_t *key;
+  uint_t key_length = freqs->length + 4;
 
   uint_t fn;                    /* filter counter */
   uint_t bin;                   /* bin counter */
@@ -71,6 +76,21 @@ aubio_filterbank_set_triangle_bands (aubio_filterbank_t * fb,
     }
   }
 
+  /* filters computed from the same parameters are shared */
+  key = AUBIO_ARRAY (smpl_t, key_length);
+  key[0] = samplerate;
+  key[1] = aubio_filterbank_get_norm (fb);
+  key[2] = n_filters;
+  key[3] = win_s;
+  for (fn = 0; fn < freqs->length; fn++) {
+    key[fn + 4] = freqs->data[fn];
+  }
+  if (aubio_filterbank_load_shared (fb, key, key_length) == AUBIO_OK) {
+    AUBIO_FREE (key);
+    return AUBIO_OK;
+  }
+  filters = aubio_filterbank_get_coeffs (fb);
+
   /* convenience reference to lower/center/upper frequency for each triangle */
   lower_freqs = new_fvec (n_filters);
   upper_freqs = new_fvec (n_filters);
@@ -163,6 +183,9 @@ aubio_filterbank_set_triangle_bands (aubio_filterbank_t * fb,
   del_fvec (triangle_heights);
   del_fvec (fft_freqs);
 
+  aubio_filterbank_store_shared (fb, key, key_length);
+  AUBIO_FREE (key);
+
   return AUBIO_OK;
 }
 
@@ -240,7 +263,7 @@ aubio_filterbank_set_mel_coeffs (aubio_filterbank_t * fb, smpl_t samplerate,
   uint_t m, retval;
   smpl_t start = freq_min, end = freq_max, step;
   fvec_t *freqs;
-  fmat_t *coeffs = aubio_filterbank_get_coeffs(fb);
+  const fmat_t *coeffs = aubio_filterbank_peek_coeffs(fb);
   uint_t n_bands = coeffs->height;
 
   if (aubio_filterbank_check_freqs(fb, samplerate, &start, &end)) {
@@ -272,7 +295,7 @@ aubio_filterbank_set_mel_coeffs_htk (aubio_filterbank_t * fb, smpl_t samplerate,
   uint_t m, retval;
   smpl_t start = freq_min, end = freq_max, step;
   fvec_t *freqs;
-  fmat_t *coeffs = aubio_filterbank_get_coeffs(fb);
+  const fmat_t *coeffs = aubio_filterbank_peek_coeffs(fb);
   uint_t n_bands = coeffs->height;
 
   if (aubio_filterbank_check_freqs(fb, samplerate, &start, &end)) {
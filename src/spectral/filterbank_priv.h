@@ -0,0 +1,50 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Shared filterbank coefficients, used by spectral/filterbank_mel.c.
+
+   Filterbanks computing the same coefficients, for instance many mfcc
+   objects with the same parameters, can share a single read-only matrix.
+   Matrices are stored in a process-wide list under a key describing how they
+   were computed, and released once the last filterbank using them is
+   deleted or gets new coefficients. aubio_filterbank_get_coeffs() and
+   aubio_filterbank_set_coeffs() give the filterbank its own copy first, so
+   that shared coefficients are never modified.
+*/
+
+#ifndef AUBIO_FILTERBANK_PRIV_H
+#define AUBIO_FILTERBANK_PRIV_H
+
+/** read-only access to the coefficients, without making a private copy */
+const fmat_t *aubio_filterbank_peek_coeffs (const aubio_filterbank_t * f);
+
+/** use the shared coefficients stored under key, if any
+
+  \return 0 if coefficients were found, non-zero otherwise
+
+*/
+uint_t aubio_filterbank_load_shared (aubio_filterbank_t * f,
+    const smpl_t * key, uint_t key_length);
+
+/** share the current coefficients of f under key */
+void aubio_filterbank_store_shared (aubio_filterbank_t * f,
+    const smpl_t * key, uint_t key_length);
+
+#endif /* AUBIO_FILTERBANK_PRIV_H */
@@ -0,0 +1,617 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
+#include "spectral/gpu_priv.h"
+
+#ifdef HAVE_OPENCL
+
+#if defined(__APPLE__)
+#include <OpenCL/opencl.h>
+#else
+#define CL_TARGET_OPENCL_VERSION 120
+#include <CL/cl.h>
+#endif
+
+/* OpenCL C kernels, one work item per output value. The FFT is a radix 2
+ * Stockham transform, in place of the bit reversal each pass writes its
+ * butterflies in the order the next pass reads them, so that the spectra
+ * come out of the last pass in natural order. One launch runs a pass on all
+ * the frames of the batch. The complex values are only accessed through
+ * their components, without vector arithmetic. */
+static const char *aubio_gpu_source =
+"__kernel void aubio_gpu_pack (__global const float *frames,\n"
+"    __global const float *window, __global float2 *spec, const uint size,\n"
+"    const uint windowed)\n"
+"{\n"
+"  uint i = get_global_id (0);\n"
+"  spec[i].x = windowed ? frames[i] * window[i % size] : frames[i];\n"
+"  spec[i].y = 0.f;\n"
+"}\n"
+"\n"
+"__kernel void aubio_gpu_pass (__global const float2 *src,\n"
+"    __global float2 *dst, __global const float2 *twiddles, const uint size,\n"
+"    const uint span)\n"
+"{\n"
+"  uint half_size = size / 2, i = get_global_id (0);\n"
+"  uint j = i % half_size, k = j & (span - 1);\n"
+"  __global const float2 *in = src + (i / half_size) * size;\n"
+"  __global float2 *out = dst + (i / half_size) * size + 2 * j - k;\n"
+"  float2 a = in[j], b = in[j + half_size];\n"
+"  float2 w = twiddles[k * (half_size / span)];\n"
+"  float tr = b.x * w.x - b.y * w.y, ti = b.x * w.y + b.y * w.x;\n"
+"  out[0].x = a.x + tr;\n"
+"  out[0].y = a.y + ti;\n"
+"  out[span].x = a.x - tr;\n"
+"  out[span].y = a.y - ti;\n"
+"}\n"
+"\n"
+"__kernel void aubio_gpu_norm (__global const float2 *spec,\n"
+"    __global float *norms, __global float *phases, const uint size,\n"
+"    const uint with_phases)\n"
+"{\n"
+"  uint bins = size / 2 + 1, i = get_global_id (0), k = i % bins;\n"
+"  float2 x = spec[(i / bins) * size + k];\n"
+"  norms[i] = hypot (x.x, x.y);\n"
+"  if (with_phases) {\n"
+"    phases[i] = (k == 0 || k == bins - 1) ? (x.x < 0.f ? M_PI_F : 0.f)\n"
+"      : atan2 (x.y, x.x);\n"
+"  }\n"
+"}\n"
+"\n"
+"__kernel void aubio_gpu_filterbank (__global const float *spectra,\n"
+"    __global const float *filters, __global const uint *spans,\n"
+"    __global float *bands, const uint bins, const uint n_filters,\n"
+"    const float power)\n"
+"{\n"
+"  uint i = get_global_id (0), f = i % n_filters, j;\n"
+"  __global const float *s = spectra + (i / n_filters) * bins;\n"
+"  __global const float *c = filters + f * bins;\n"
+"  uint end = spans[2 * f] + spans[2 * f + 1];\n"
+"  float sum = 0.f;\n"
+"  for (j = spans[2 * f]; j < end; j++) {\n"
+"    sum += c[j] * (power == 1.f ? s[j] : pow (s[j], power));\n"
+"  }\n"
+"  bands[i] = sum;\n"
+"}\n"
+"\n"
+"__kernel void aubio_gpu_dct (__global const float *bands,\n"
+"    __global const float *dct, __global float *coefs, const uint n_filters,\n"
+"    const uint n_coefs, const float scale, const float floor_log)\n"
+"{\n"
+"  uint i = get_global_id (0), k = i % n_coefs, j;\n"
+"  __global const float *b = bands + (i / n_coefs) * n_filters;\n"
+"  float sum = 0.f;\n"
+"  for (j = 0; j < n_filters; j++) {\n"
+"    float l = b[j] >= 1.17549435e-38f ? log10 (b[j]) : floor_log;\n"
+"    sum += dct[k * n_filters + j] * scale * l;\n"
+"  }\n"
+"  coefs[i] = sum;\n"
+"}\n";
+
+/** device buffers, allocated on first use and grown when needed */
+enum {
+  AUBIO_GPU_FRAMES,     /**< input frames, or input spectra */
+  AUBIO_GPU_WINDOW,     /**< analysis window */
+  AUBIO_GPU_TWIDDLES,   /**< exp(-2 i pi k / size), for k < size / 2 */
+  AUBIO_GPU_SPEC_A,     /**< complex spectra, even passes */
+  AUBIO_GPU_SPEC_B,     /**< complex spectra, odd passes */
+  AUBIO_GPU_NORMS,
+  AUBIO_GPU_PHASES,
+  AUBIO_GPU_FILTERS,
+  AUBIO_GPU_SPANS,      /**< first non-zero coefficient and their count */
+  AUBIO_GPU_BANDS,
+  AUBIO_GPU_DCT,
+  AUBIO_GPU_COEFS,
+  AUBIO_GPU_N_BUFFERS
+};
+
+struct _aubio_gpu_t {
+  cl_context context;
+  cl_command_queue queue;
+  cl_program program;
+  cl_kernel pack;
+  cl_kernel pass;
+  cl_kernel norm;
+  cl_kernel filterbank;
+  cl_kernel dct;
+  size_t max_alloc;                     /**< largest buffer of the device */
+  cl_mem mem[AUBIO_GPU_N_BUFFERS];
+  size_t mem_size[AUBIO_GPU_N_BUFFERS]; /**< size of each buffer, in bytes */
+  cl_float *host;                       /**< staging area of the transfers */
+  size_t host_size;                     /**< number of floats in host */
+  cl_uint *spans;                       /**< staging area of the spans */
+  uint_t spans_size;                    /**< number of values in spans */
+  uint_t twiddles_size;                 /**< fft size of the twiddles */
+  char_t name[256];
+};
+
+static uint_t aubio_gpu_check (cl_int err, const char_t *what)
+{
+  if (err == CL_SUCCESS) return AUBIO_OK;
+  AUBIO_ERR ("gpu: %s failed with error %d\n", what, err);
+  return AUBIO_FAIL;
+}
+
+/* pick the device matching name, or the first gpu if name is NULL, or the
+ * first device of any type if there is no gpu */
+static cl_device_id aubio_gpu_find (const char_t *name, char_t *found,
+    size_t found_size)
+{
+  cl_platform_id *platforms = NULL;
+  cl_device_id *devices = NULL, device = NULL;
+  cl_uint n_platforms = 0, n_devices, p, d, pass;
+  if (clGetPlatformIDs (0, NULL, &n_platforms) != CL_SUCCESS
+      || n_platforms == 0) {
+    return NULL;
+  }
+  platforms = AUBIO_ARRAY (cl_platform_id, n_platforms);
+  if (!platforms
+      || clGetPlatformIDs (n_platforms, platforms, NULL) != CL_SUCCESS) {
+    goto beach;
+  }
+  for (pass = name ? 1 : 0; pass < 2 && !device; pass++) {
+    cl_device_type type = pass == 0 ? CL_DEVICE_TYPE_GPU : CL_DEVICE_TYPE_ALL;
+    for (p = 0; p < n_platforms && !device; p++) {
+      char_t platform_name[128] = "";
+      n_devices = 0;
+      if (clGetDeviceIDs (platforms[p], type, 0, NULL, &n_devices)
+          != CL_SUCCESS || n_devices == 0) {
+        continue;
+      }
+      devices = AUBIO_ARRAY (cl_device_id, n_devices);
+      if (!devices) goto beach;
+      clGetPlatformInfo (platforms[p], CL_PLATFORM_NAME,
+          sizeof (platform_name) - 1, platform_name, NULL);
+      if (clGetDeviceIDs (platforms[p], type, n_devices, devices, NULL)
+          == CL_SUCCESS) {
+        for (d = 0; d < n_devices && !device; d++) {
+          char_t device_name[128] = "";
+          clGetDeviceInfo (devices[d], CL_DEVICE_NAME,
+              sizeof (device_name) - 1, device_name, NULL);
+          snprintf (found, found_size, "%s: %s", platform_name, device_name);
+          if (!name || strstr (found, name)) device = devices[d];
+        }
+      }
+      AUBIO_FREE (devices);
+      devices = NULL;
+    }
+  }
+
+beach:
+  if (platforms) AUBIO_FREE (platforms);
+  return device;
+}
+
+aubio_gpu_t *new_aubio_gpu (const char_t *device)
+{
+  aubio_gpu_t *o = AUBIO_NEW (aubio_gpu_t);
+  cl_device_id id;
+  cl_ulong max_alloc = 0;
+  cl_int err;
+  if (!o) return NULL;
+  if (device && (device[0] == '\0' || strcmp (device, "default") == 0)) {
+    device = NULL;
+  }
+  id = aubio_gpu_find (device, o->name, sizeof (o->name));
+  if (!id) {
+    AUBIO_ERR ("gpu: no OpenCL device found%s%s\n", device ? " matching " : "",
+        device ? device : "");
+    goto beach;
+  }
+  o->context = clCreateContext (NULL, 1, &id, NULL, NULL, &err);
+  if (aubio_gpu_check (err, "creating context")) goto beach;
+  o->queue = clCreateCommandQueue (o->context, id, 0, &err);
+  if (aubio_gpu_check (err, "creating queue")) goto beach;
+  o->program = clCreateProgramWithSource (o->context, 1, &aubio_gpu_source,
+      NULL, &err);
+  if (aubio_gpu_check (err, "creating program")) goto beach;
+  err = clBuildProgram (o->program, 1, &id, NULL, NULL, NULL);
+  if (err != CL_SUCCESS) {
+    char_t log[1024] = "";
+    clGetProgramBuildInfo (o->program, id, CL_PROGRAM_BUILD_LOG,
+        sizeof (log) - 1, log, NULL);
+    AUBIO_ERR ("gpu: building kernels for %s failed with error %d\n%s\n",
+        o->name, err, log);
+    goto beach;
+  }
+  o->pack = clCreateKernel (o->program, "aubio_gpu_pack", &err);
+  if (err == CL_SUCCESS) o->pass = clCreateKernel (o->program,
+      "aubio_gpu_pass", &err);
+  if (err == CL_SUCCESS) o->norm = clCreateKernel (o->program,
+      "aubio_gpu_norm", &err);
+  if (err == CL_SUCCESS) o->filterbank = clCreateKernel (o->program,
+      "aubio_gpu_filterbank", &err);
+  if (err == CL_SUCCESS) o->dct = clCreateKernel (o->program,
+      "aubio_gpu_dct", &err);
+  if (aubio_gpu_check (err, "creating kernels")) goto beach;
+  clGetDeviceInfo (id, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof (max_alloc),
+      &max_alloc, NULL);
+  // the specification guarantees at least 128 MiB
+  o->max_alloc = max_alloc ? (size_t) max_alloc : (size_t) 128 << 20;
+  return o;
+
+beach:
+  del_aubio_gpu (o);
+  return NULL;
+}
+
+const char_t *aubio_gpu_get_name (const aubio_gpu_t *o)
+{
+  return o->name;
+}
+
+void del_aubio_gpu (aubio_gpu_t *o)
+{
+  uint_t i;
+  for (i = 0; i < AUBIO_GPU_N_BUFFERS; i++) {
+    if (o->mem[i]) clReleaseMemObject (o->mem[i]);
+  }
+  if (o->dct) clReleaseKernel (o->dct);
+  if (o->filterbank) clReleaseKernel (o->filterbank);
+  if (o->norm) clReleaseKernel (o->norm);
+  if (o->pass) clReleaseKernel (o->pass);
+  if (o->pack) clReleaseKernel (o->pack);
+  if (o->program) clReleaseProgram (o->program);
+  if (o->queue) clReleaseCommandQueue (o->queue);
+  if (o->context) clReleaseContext (o->context);
+  if (o->host) AUBIO_FREE (o->host);
+  if (o->spans) AUBIO_FREE (o->spans);
+  AUBIO_FREE (o);
+}
+
+/* device buffer which of at least size bytes */
+static cl_mem aubio_gpu_mem (aubio_gpu_t *o, uint_t which, size_t size)
+{
+  cl_int err;
+  if (o->mem_size[which] >= size) return o->mem[which];
+  if (o->mem[which]) clReleaseMemObject (o->mem[which]);
+  o->mem_size[which] = 0;
+  o->mem[which] = clCreateBuffer (o->context, CL_MEM_READ_WRITE, size, NULL,
+      &err);
+  if (aubio_gpu_check (err, "allocating device memory")) {
+    o->mem[which] = NULL;
+    return NULL;
+  }
+  o->mem_size[which] = size;
+  return o->mem[which];
+}
+
+/* staging area of at least size floats */
+static cl_float *aubio_gpu_host (aubio_gpu_t *o, size_t size)
+{
+  if (o->host_size >= size) return o->host;
+  if (o->host) AUBIO_FREE (o->host);
+  o->host = AUBIO_ARRAY (cl_float, size);
+  o->host_size = o->host ? size : 0;
+  return o->host;
+}
+
+/* copy length values of n rows, from row first of m, to buffer which */
+static cl_mem aubio_gpu_write (aubio_gpu_t *o, uint_t which,
+    smpl_t * const *rows, uint_t n, uint_t length)
+{
+  size_t size = (size_t) n * length;
+  cl_float *host = aubio_gpu_host (o, size);
+  cl_mem mem = aubio_gpu_mem (o, which, size * sizeof (cl_float));
+  uint_t i, j;
+  if (!host || !mem) return NULL;
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < length; j++) {
+      host[i * length + j] = (cl_float) rows[i][j];
+    }
+  }
+  if (aubio_gpu_check (clEnqueueWriteBuffer (o->queue, mem, CL_TRUE, 0,
+          size * sizeof (cl_float), host, 0, NULL, NULL), "writing")) {
+    return NULL;
+  }
+  return mem;
+}
+
+/* copy length values of n rows, from buffer which to rows */
+static uint_t aubio_gpu_read (aubio_gpu_t *o, uint_t which,
+    smpl_t * const *rows, uint_t n, uint_t length)
+{
+  size_t size = (size_t) n * length;
+  cl_float *host = aubio_gpu_host (o, size);
+  uint_t i, j;
+  if (!host) return AUBIO_FAIL;
+  if (aubio_gpu_check (clEnqueueReadBuffer (o->queue, o->mem[which], CL_TRUE,
+          0, size * sizeof (cl_float), host, 0, NULL, NULL), "reading")) {
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < n; i++) {
+    for (j = 0; j < length; j++) {
+      rows[i][j] = (smpl_t) host[i * length + j];
+    }
+  }
+  return AUBIO_OK;
+}
+
+static uint_t aubio_gpu_run (aubio_gpu_t *o, cl_kernel kernel, size_t size,
+    cl_int err)
+{
+  if (aubio_gpu_check (err, "setting kernel arguments")) return AUBIO_FAIL;
+  return aubio_gpu_check (clEnqueueNDRangeKernel (o->queue, kernel, 1, NULL,
+        &size, NULL, 0, NULL, NULL), "running kernel");
+}
+
+/* number of frames of size bins processed at once, for their complex spectra
+ * to fit a single buffer */
+static uint_t aubio_gpu_chunk (const aubio_gpu_t *o, uint_t size,
+    uint_t n_frames)
+{
+  size_t chunk = o->max_alloc / ((size_t) size * 2 * sizeof (cl_float));
+  if (chunk < 1) chunk = 1;
+  return chunk < n_frames ? (uint_t) chunk : n_frames;
+}
+
+/* complex spectra of n frames, windowed unless window is NULL, left in the
+ * returned buffer */
+static cl_mem aubio_gpu_fft (aubio_gpu_t *o, smpl_t * const *rows, uint_t n,
+    uint_t size, const fvec_t *window)
+{
+  cl_mem frames, win, src, dst, tw, tmp;
+  cl_uint cl_size = size, windowed = window != NULL, span;
+  cl_int err = CL_SUCCESS;
+  if (size < 2 || (size & (size - 1)) != 0) return NULL;
+  frames = aubio_gpu_write (o, AUBIO_GPU_FRAMES, rows, n, size);
+  win = window ? aubio_gpu_write (o, AUBIO_GPU_WINDOW, &window->data, 1, size)
+    : frames;
+  src = aubio_gpu_mem (o, AUBIO_GPU_SPEC_A, (size_t) n * size * 2
+      * sizeof (cl_float));
+  dst = aubio_gpu_mem (o, AUBIO_GPU_SPEC_B, (size_t) n * size * 2
+      * sizeof (cl_float));
+  if (!frames || !win || !src || !dst) return NULL;
+  if (o->twiddles_size != size) {
+    cl_float *host = aubio_gpu_host (o, size);
+    uint_t k;
+    if (!host || !aubio_gpu_mem (o, AUBIO_GPU_TWIDDLES,
+          size * sizeof (cl_float))) {
+      return NULL;
+    }
+    for (k = 0; k < size / 2; k++) {
+      host[2 * k] = (cl_float) cos (2. * M_PI * k / size);
+      host[2 * k + 1] = (cl_float) -sin (2. * M_PI * k / size);
+    }
+    if (aubio_gpu_check (clEnqueueWriteBuffer (o->queue,
+            o->mem[AUBIO_GPU_TWIDDLES], CL_TRUE, 0, size * sizeof (cl_float),
+            host, 0, NULL, NULL), "writing")) {
+      return NULL;
+    }
+    o->twiddles_size = size;
+  }
+  tw = o->mem[AUBIO_GPU_TWIDDLES];
+
+  err |= clSetKernelArg (o->pack, 0, sizeof (cl_mem), &frames);
+  err |= clSetKernelArg (o->pack, 1, sizeof (cl_mem), &win);
+  err |= clSetKernelArg (o->pack, 2, sizeof (cl_mem), &src);
+  err |= clSetKernelArg (o->pack, 3, sizeof (cl_uint), &cl_size);
+  err |= clSetKernelArg (o->pack, 4, sizeof (cl_uint), &windowed);
+  if (aubio_gpu_run (o, o->pack, (size_t) n * size, err)) return NULL;
+
+  for (span = 1; span < cl_size; span *= 2) {
+    err = clSetKernelArg (o->pass, 0, sizeof (cl_mem), &src);
+    err |= clSetKernelArg (o->pass, 1, sizeof (cl_mem), &dst);
+    err |= clSetKernelArg (o->pass, 2, sizeof (cl_mem), &tw);
+    err |= clSetKernelArg (o->pass, 3, sizeof (cl_uint), &cl_size);
+    err |= clSetKernelArg (o->pass, 4, sizeof (cl_uint), &span);
+    if (aubio_gpu_run (o, o->pass, (size_t) n * size / 2, err)) return NULL;
+    tmp = src;
+    src = dst;
+    dst = tmp;
+  }
+  return src;
+}
+
+/* norms, and phases unless NULL, of the complex spectra in spec */
+static uint_t aubio_gpu_norm (aubio_gpu_t *o, cl_mem spec, uint_t n,
+    uint_t size, uint_t with_phases)
+{
+  size_t bytes = (size_t) n * (size / 2 + 1) * sizeof (cl_float);
+  cl_mem norms = aubio_gpu_mem (o, AUBIO_GPU_NORMS, bytes);
+  cl_mem phases = with_phases ? aubio_gpu_mem (o, AUBIO_GPU_PHASES, bytes)
+    : norms;
+  cl_uint cl_size = size, cl_phases = with_phases;
+  cl_int err = CL_SUCCESS;
+  if (!norms || !phases) return AUBIO_FAIL;
+  err |= clSetKernelArg (o->norm, 0, sizeof (cl_mem), &spec);
+  err |= clSetKernelArg (o->norm, 1, sizeof (cl_mem), &norms);
+  err |= clSetKernelArg (o->norm, 2, sizeof (cl_mem), &phases);
+  err |= clSetKernelArg (o->norm, 3, sizeof (cl_uint), &cl_size);
+  err |= clSetKernelArg (o->norm, 4, sizeof (cl_uint), &cl_phases);
+  return aubio_gpu_run (o, o->norm, (size_t) n * (size / 2 + 1), err);
+}
+
+/* bands of the n spectra in buffer spectra */
+static uint_t aubio_gpu_bands (aubio_gpu_t *o, const fmat_t *filters,
+    smpl_t power, cl_mem spectra, uint_t n)
+{
+  cl_uint bins = filters->length, n_filters = filters->height;
+  cl_float cl_power = (cl_float) power;
+  cl_mem coeffs, spans, bands;
+  cl_int err = CL_SUCCESS;
+  uint_t i;
+  // skip the zeros at both ends of each filter, as in filterbank.c
+  if (o->spans_size < 2 * n_filters) {
+    if (o->spans) AUBIO_FREE (o->spans);
+    o->spans = AUBIO_ARRAY (cl_uint, 2 * n_filters);
+    o->spans_size = o->spans ? 2 * n_filters : 0;
+    if (!o->spans) return AUBIO_FAIL;
+  }
+  for (i = 0; i < n_filters; i++) {
+    const smpl_t *c = filters->data[i];
+    uint_t start = 0, end = bins;
+    while (start < bins && c[start] == 0.) start++;
+    while (end > start && c[end - 1] == 0.) end--;
+    o->spans[2 * i] = start;
+    o->spans[2 * i + 1] = end - start;
+  }
+  coeffs = aubio_gpu_write (o, AUBIO_GPU_FILTERS, filters->data, n_filters,
+      bins);
+  spans = aubio_gpu_mem (o, AUBIO_GPU_SPANS, 2 * n_filters * sizeof (cl_uint));
+  bands = aubio_gpu_mem (o, AUBIO_GPU_BANDS, (size_t) n * n_filters
+      * sizeof (cl_float));
+  if (!coeffs || !spans || !bands) return AUBIO_FAIL;
+  if (aubio_gpu_check (clEnqueueWriteBuffer (o->queue, spans, CL_TRUE, 0,
+          2 * n_filters * sizeof (cl_uint), o->spans, 0, NULL, NULL),
+        "writing")) {
+    return AUBIO_FAIL;
+  }
+  err |= clSetKernelArg (o->filterbank, 0, sizeof (cl_mem), &spectra);
+  err |= clSetKernelArg (o->filterbank, 1, sizeof (cl_mem), &coeffs);
+  err |= clSetKernelArg (o->filterbank, 2, sizeof (cl_mem), &spans);
+  err |= clSetKernelArg (o->filterbank, 3, sizeof (cl_mem), &bands);
+  err |= clSetKernelArg (o->filterbank, 4, sizeof (cl_uint), &bins);
+  err |= clSetKernelArg (o->filterbank, 5, sizeof (cl_uint), &n_filters);
+  err |= clSetKernelArg (o->filterbank, 6, sizeof (cl_float), &cl_power);
+  return aubio_gpu_run (o, o->filterbank, (size_t) n * n_filters, err);
+}
+
+uint_t aubio_gpu_fft_batch (aubio_gpu_t *o, const fmat_t *frames,
+    uint_t n_frames, const fvec_t *window, fmat_t *norms, fmat_t *phases)
+{
+  uint_t size = frames->length, bins = size / 2 + 1, t, n;
+  uint_t chunk = aubio_gpu_chunk (o, size, n_frames);
+  for (t = 0; t < n_frames; t += n) {
+    cl_mem spec;
+    n = MIN (chunk, n_frames - t);
+    spec = aubio_gpu_fft (o, frames->data + t, n, size, window);
+    if (!spec || aubio_gpu_norm (o, spec, n, size, phases != NULL)
+        || aubio_gpu_read (o, AUBIO_GPU_NORMS, norms->data + t, n, bins)
+        || (phases && aubio_gpu_read (o, AUBIO_GPU_PHASES, phases->data + t,
+            n, bins))) {
+      return AUBIO_FAIL;
+    }
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_gpu_filterbank_batch (aubio_gpu_t *o, const fmat_t *filters,
+    smpl_t power, const fmat_t *spectra, uint_t n_frames, fmat_t *out)
+{
+  uint_t bins = filters->length, t, n;
+  uint_t chunk = aubio_gpu_chunk (o, bins, n_frames);
+  for (t = 0; t < n_frames; t += n) {
+    cl_mem in;
+    n = MIN (chunk, n_frames - t);
+    in = aubio_gpu_write (o, AUBIO_GPU_FRAMES, spectra->data + t, n, bins);
+    if (!in || aubio_gpu_bands (o, filters, power, in, n)
+        || aubio_gpu_read (o, AUBIO_GPU_BANDS, out->data + t, n,
+          filters->height)) {
+      return AUBIO_FAIL;
+    }
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_gpu_mfcc_batch (aubio_gpu_t *o, const fmat_t *frames,
+    uint_t n_frames, const fvec_t *window, const fmat_t *filters,
+    smpl_t power, const fmat_t *dct, smpl_t scale, fmat_t *out)
+{
+  uint_t size = frames->length, t, n;
+  uint_t chunk = aubio_gpu_chunk (o, size, n_frames);
+  cl_uint n_filters = filters->height;
+  cl_uint n_coefs = MIN (out->length, filters->height);
+  cl_float cl_scale = (cl_float) scale;
+  // log10 of the bands below the smallest float, as SAFE_LOG10 on the host
+  cl_float floor_log = (cl_float) LOG10 (VERY_SMALL_NUMBER);
+  cl_mem coeffs = aubio_gpu_write (o, AUBIO_GPU_DCT, dct->data, n_coefs,
+      n_filters);
+  if (!coeffs) return AUBIO_FAIL;
+  for (t = 0; t < n_frames; t += n) {
+    cl_mem spec, coefs;
+    cl_int err = CL_SUCCESS;
+    n = MIN (chunk, n_frames - t);
+    spec = aubio_gpu_fft (o, frames->data + t, n, size, window);
+    if (!spec || aubio_gpu_norm (o, spec, n, size, 0)
+        || aubio_gpu_bands (o, filters, power, o->mem[AUBIO_GPU_NORMS], n)) {
+      return AUBIO_FAIL;
+    }
+    coefs = aubio_gpu_mem (o, AUBIO_GPU_COEFS, (size_t) n * n_coefs
+        * sizeof (cl_float));
+    if (!coefs) return AUBIO_FAIL;
+    err |= clSetKernelArg (o->dct, 0, sizeof (cl_mem),
+        &o->mem[AUBIO_GPU_BANDS]);
+    err |= clSetKernelArg (o->dct, 1, sizeof (cl_mem), &coeffs);
+    err |= clSetKernelArg (o->dct, 2, sizeof (cl_mem), &coefs);
+    err |= clSetKernelArg (o->dct, 3, sizeof (cl_uint), &n_filters);
+    err |= clSetKernelArg (o->dct, 4, sizeof (cl_uint), &n_coefs);
+    err |= clSetKernelArg (o->dct, 5, sizeof (cl_float), &cl_scale);
+    err |= clSetKernelArg (o->dct, 6, sizeof (cl_float), &floor_log);
+    if (aubio_gpu_run (o, o->dct, (size_t) n * n_coefs, err)
+        || aubio_gpu_read (o, AUBIO_GPU_COEFS, out->data + t, n, n_coefs)) {
+      return AUBIO_FAIL;
+    }
+  }
+  return AUBIO_OK;
+}
+
+#else /* HAVE_OPENCL */
+
+struct _aubio_gpu_t {
+  char_t name[1];
+};
+
+aubio_gpu_t *new_aubio_gpu (const char_t *device UNUSED)
+{
+  AUBIO_ERR ("gpu: aubio was built without OpenCL\n");
+  return NULL;
+}
+
+const char_t *aubio_gpu_get_name (const aubio_gpu_t *o)
+{
+  return o->name;
+}
+
+void del_aubio_gpu (aubio_gpu_t *o)
+{
+  AUBIO_FREE (o);
+}
+
+uint_t aubio_gpu_fft_batch (aubio_gpu_t *o UNUSED,
+    const fmat_t *frames UNUSED, uint_t n_frames UNUSED,
+    const fvec_t *window UNUSED, fmat_t *norms UNUSED,
+    fmat_t *phases UNUSED)
+{
+  return AUBIO_FAIL;
+}
+
+uint_t aubio_gpu_filterbank_batch (aubio_gpu_t *o UNUSED,
+    const fmat_t *filters UNUSED, smpl_t power UNUSED,
+    const fmat_t *spectra UNUSED, uint_t n_frames UNUSED,
+    fmat_t *out UNUSED)
+{
+  return AUBIO_FAIL;
+}
+
+uint_t aubio_gpu_mfcc_batch (aubio_gpu_t *o UNUSED,
+    const fmat_t *frames UNUSED, uint_t n_frames UNUSED,
+    const fvec_t *window UNUSED, const fmat_t *filters UNUSED,
+    smpl_t power UNUSED, const fmat_t *dct UNUSED, smpl_t scale UNUSED,
+    fmat_t *out UNUSED)
+{
+  return AUBIO_FAIL;
+}
+
+#endif /* HAVE_OPENCL */
@@ -0,0 +1,102 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_GPU_H
+#define AUBIO_GPU_H
+
+/** \file
+
+  Offload of the batch spectral analysis to a GPU
+
+  An ::aubio_gpu_t holds an OpenCL device, its compiled kernels and its
+  memory. Once attached to an object with ::aubio_fft_set_gpu,
+  ::aubio_filterbank_set_gpu or ::aubio_mfcc_set_gpu, the batch functions of
+  that object, ::aubio_fft_do_batch, ::aubio_filterbank_do_batch and
+  ::aubio_mfcc_do_batch, run on the device:
+
+  \code
+  aubio_gpu_t *gpu = new_aubio_gpu ("default");
+  aubio_mfcc_t *mfcc = new_aubio_mfcc (1024, 40, 13, 44100);
+  fmat_t *coefs = new_fmat (4096, 13);
+  if (gpu) aubio_mfcc_set_gpu (mfcc, gpu);
+  do {
+    aubio_mfcc_do_batch (mfcc, source, 512, coefs, &n_frames);
+    // use the first n_frames rows of coefs
+  } while (n_frames == coefs->height);
+  \endcode
+
+  Each call moves its whole batch to the device and back, so that batches of
+  a few thousand frames are needed to make up for the transfers; the real
+  time functions, such as ::aubio_fft_do, always run on the processor. The
+  device computes in single precision, with the same results as the
+  processor up to rounding. When the device fails, or for FFT sizes other
+  than powers of 2, the batch is computed on the processor instead.
+
+  Devices are only available when aubio was built with `-Dopencl=enabled`;
+  ::new_aubio_gpu returns `NULL` otherwise.
+
+  \example spectral/test-gpu.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** GPU device object */
+typedef struct _aubio_gpu_t aubio_gpu_t;
+
+/** open a GPU device
+
+  \param device `default` or `NULL` for the first GPU found, or the first
+  OpenCL device of any type if no GPU is present, or a part of the name of
+  the device, as returned by ::aubio_gpu_get_name, for instance `NVIDIA`
+
+  \return newly created ::aubio_gpu_t, or `NULL` if no device matched or
+  aubio was built without OpenCL
+
+  The device can be attached to any number of objects, but should be used by
+  one thread at a time. It must be deleted after the objects it is attached
+  to.
+
+*/
+aubio_gpu_t *new_aubio_gpu (const char_t *device);
+
+/** get the name of the device
+
+  \param o device, as returned by ::new_aubio_gpu
+
+  \return name of the OpenCL platform and device, separated by `: `
+
+*/
+const char_t *aubio_gpu_get_name (const aubio_gpu_t *o);
+
+/** close the device
+
+  \param o device, as returned by ::new_aubio_gpu
+
+*/
+void del_aubio_gpu (aubio_gpu_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_GPU_H */
@@ -0,0 +1,48 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Batch kernels of spectral/gpu.c, called by the batch functions of fft.c,
+   filterbank.c and mfcc.c when a device is attached to their object.
+
+   Each function returns AUBIO_OK once the whole output was computed, or
+   AUBIO_FAIL, after printing the reason, in which case the caller computes
+   the batch on the processor. Only the first `n_frames` rows of the inputs
+   are read and of the outputs written. */
+
+#ifndef AUBIO_GPU_PRIV_H
+#define AUBIO_GPU_PRIV_H
+
+/** norms, and phases unless NULL, of the FFT of each row of frames, windowed
+  by window unless NULL; the size of the rows must be a power of 2 */
+uint_t aubio_gpu_fft_batch (aubio_gpu_t *o, const fmat_t *frames,
+    uint_t n_frames, const fvec_t *window, fmat_t *norms, fmat_t *phases);
+
+/** out[t][i] = sum of filters[i][j] * spectra[t][j]^power; the zeros at
+  both ends of each filter are skipped */
+uint_t aubio_gpu_filterbank_batch (aubio_gpu_t *o, const fmat_t *filters,
+    smpl_t power, const fmat_t *spectra, uint_t n_frames, fmat_t *out);
+
+/** mfcc of the windowed frames: filterbank of the norms of their FFT, scaled
+  log10 of the bands, and product with the first out->length rows of dct */
+uint_t aubio_gpu_mfcc_batch (aubio_gpu_t *o, const fmat_t *frames,
+    uint_t n_frames, const fvec_t *window, const fmat_t *filters,
+    smpl_t power, const fmat_t *dct, smpl_t scale, fmat_t *out);
+
+#endif /* AUBIO_GPU_PRIV_H */
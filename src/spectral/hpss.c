@@ -0,0 +1,277 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* default values : time_width=17, freq_width=17, power=2 */
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "mathutils.h"
+#include "spectral/hpss.h"
+#include "utils/simd_priv.h"
+#include "utils/denormal_priv.h"
+
+#define AUBIO_HPSS_WIDTH 17
+
+struct _aubio_hpss_t
+{
+  uint_t nbins;
+  uint_t time_width;
+  uint_t freq_width;
+  smpl_t power;
+  fmat_t *frames;   /**< past norms, time_width rows of nbins */
+  fmat_t *sorted;   /**< the same norms sorted, nbins rows of time_width */
+  uint_t pos;       /**< row of frames to overwrite next */
+  uint_t count;     /**< number of rows of frames filled */
+  fvec_t *window;   /**< sorted norms around the current bin */
+  fvec_t *hmask;
+  fvec_t *pmask;
+};
+
+/* replace `old` with `value` in the `n` sorted values of `row`, keeping the
+ * values sorted */
+static void aubio_hpss_replace (smpl_t *row, uint_t n, smpl_t old, smpl_t value)
+{
+  uint_t lo = 0, hi = n - 1, i;
+  while (lo < hi) {
+    uint_t mid = (lo + hi) / 2;
+    if (row[mid] < old) lo = mid + 1;
+    else hi = mid;
+  }
+  i = lo;
+  while (i > 0 && row[i - 1] > value) {
+    row[i] = row[i - 1];
+    i--;
+  }
+  while (i + 1 < n && row[i + 1] < value) {
+    row[i] = row[i + 1];
+    i++;
+  }
+  row[i] = value;
+}
+
+/* insert `value` in the `n` sorted values of `row`, one more value fitting */
+static void aubio_hpss_insert (smpl_t *row, uint_t n, smpl_t value)
+{
+  uint_t i = n;
+  while (i > 0 && row[i - 1] > value) {
+    row[i] = row[i - 1];
+    i--;
+  }
+  row[i] = value;
+}
+
+void aubio_hpss_do_masks (aubio_hpss_t * o, const cvec_t * input,
+    fvec_t * harm_mask, fvec_t * perc_mask)
+{
+  uint_t nbins = o->nbins, k, j;
+  uint_t half = o->freq_width / 2, last = nbins - 1;
+  smpl_t *norm = input->norm, *past = o->frames->data[o->pos];
+  smpl_t *window = o->window->data;
+  aubio_denormal_guard_t guard;
+  if (input->length != nbins || harm_mask->length < nbins
+      || perc_mask->length < nbins) {
+    AUBIO_ERR("hpss: expected %d bins, got an input of %d bins and masks of"
+        " %d and %d bins\n", nbins, input->length, harm_mask->length,
+        perc_mask->length);
+    return;
+  }
+  aubio_denormal_enter(&guard);
+  /* median along time, the current frame replacing the oldest one */
+  for (k = 0; k < nbins; k++) {
+    smpl_t *row = o->sorted->data[k];
+    if (o->count < o->time_width) {
+      aubio_hpss_insert(row, o->count, norm[k]);
+    } else {
+      aubio_hpss_replace(row, o->count, past[k], norm[k]);
+    }
+    past[k] = norm[k];
+    harm_mask->data[k] = row[(o->count + (o->count < o->time_width)) / 2];
+  }
+  if (o->count < o->time_width) o->count++;
+  o->pos = (o->pos + 1) % o->time_width;
+  /* median along frequency, sliding over the bins, repeating the edges */
+  for (j = 0; j < o->freq_width; j++) {
+    uint_t b = (j > half) ? j - half : 0;
+    aubio_hpss_insert(window, j, norm[MIN(b, last)]);
+  }
+  for (k = 0; k < nbins; k++) {
+    perc_mask->data[k] = window[half];
+    if (k + 1 < nbins) {
+      uint_t out = (k > half) ? k - half : 0;
+      aubio_hpss_replace(window, o->freq_width, norm[out],
+          norm[MIN(k + 1 + half, last)]);
+    }
+  }
+  /* soft masks, from the two medians */
+  for (k = 0; k < nbins; k++) {
+    smpl_t h = harm_mask->data[k], p = perc_mask->data[k], sum;
+    if (o->power == 2.) {
+      h *= h;
+      p *= p;
+    } else {
+      h = POW(h, o->power);
+      p = POW(p, o->power);
+    }
+    sum = h + p;
+    harm_mask->data[k] = (sum > 0.) ? h / sum : .5;
+    perc_mask->data[k] = 1. - harm_mask->data[k];
+  }
+  aubio_denormal_leave(&guard);
+}
+
+void aubio_hpss_do (aubio_hpss_t * o, const cvec_t * input,
+    cvec_t * harmonic, cvec_t * percussive)
+{
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  uint_t nbins = o->nbins;
+  if (harmonic->length != nbins || percussive->length != nbins) {
+    AUBIO_ERR("hpss: expected outputs of %d bins, got %d and %d bins\n",
+        nbins, harmonic->length, percussive->length);
+    return;
+  }
+  aubio_hpss_do_masks(o, input, o->hmask, o->pmask);
+  ops->weighted_copy(input->norm, o->hmask->data, harmonic->norm, nbins);
+  ops->weighted_copy(input->norm, o->pmask->data, percussive->norm, nbins);
+  if (harmonic->phas != input->phas) {
+    memcpy(harmonic->phas, input->phas, nbins * sizeof(smpl_t));
+  }
+  if (percussive->phas != input->phas) {
+    memcpy(percussive->phas, input->phas, nbins * sizeof(smpl_t));
+  }
+}
+
+uint_t aubio_hpss_set_time_width (aubio_hpss_t * o, uint_t width)
+{
+  fmat_t *frames, *sorted;
+  if (width == 0 || width % 2 == 0) {
+    AUBIO_ERR("hpss: time width should be odd, got %d\n", width);
+    return AUBIO_FAIL;
+  }
+  frames = new_fmat(width, o->nbins);
+  sorted = new_fmat(o->nbins, width);
+  if (!frames || !sorted) {
+    if (frames) del_fmat(frames);
+    if (sorted) del_fmat(sorted);
+    return AUBIO_FAIL;
+  }
+  if (o->frames) del_fmat(o->frames);
+  if (o->sorted) del_fmat(o->sorted);
+  o->frames = frames;
+  o->sorted = sorted;
+  o->time_width = width;
+  aubio_hpss_reset(o);
+  return AUBIO_OK;
+}
+
+uint_t aubio_hpss_get_time_width (const aubio_hpss_t * o)
+{
+  return o->time_width;
+}
+
+uint_t aubio_hpss_set_freq_width (aubio_hpss_t * o, uint_t width)
+{
+  fvec_t *window;
+  if (width == 0 || width % 2 == 0) {
+    AUBIO_ERR("hpss: frequency width should be odd, got %d\n", width);
+    return AUBIO_FAIL;
+  }
+  window = new_fvec(width);
+  if (!window) return AUBIO_FAIL;
+  if (o->window) del_fvec(o->window);
+  o->window = window;
+  o->freq_width = width;
+  return AUBIO_OK;
+}
+
+uint_t aubio_hpss_get_freq_width (const aubio_hpss_t * o)
+{
+  return o->freq_width;
+}
+
+uint_t aubio_hpss_set_power (aubio_hpss_t * o, smpl_t power)
+{
+  if (!(power > 0.)) {
+    AUBIO_ERR("hpss: power should be strictly positive, got %f\n", power);
+    return AUBIO_FAIL;
+  }
+  o->power = power;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_hpss_get_power (const aubio_hpss_t * o)
+{
+  return o->power;
+}
+
+void aubio_hpss_reset (aubio_hpss_t * o)
+{
+  fmat_zeros(o->frames);
+  fmat_zeros(o->sorted);
+  o->pos = 0;
+  o->count = 0;
+}
+
+aubio_hpss_t * new_aubio_hpss (uint_t buf_size, uint_t hop_size)
+{
+  aubio_hpss_t * o;
+  if ((sint_t)buf_size < 2) {
+    AUBIO_ERR("hpss: got buffer_size %d, but can not be < 2\n", buf_size);
+    return NULL;
+  }
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR("hpss: got hop_size %d, but can not be < 1\n", hop_size);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_hpss_t);
+  if (!o) return NULL;
+  o->nbins = buf_size / 2 + 1;
+  o->power = 2.;
+  o->hmask = new_fvec(o->nbins);
+  o->pmask = new_fvec(o->nbins);
+  if (!o->hmask || !o->pmask
+      || aubio_hpss_set_time_width(o, AUBIO_HPSS_WIDTH) != AUBIO_OK
+      || aubio_hpss_set_freq_width(o, AUBIO_HPSS_WIDTH) != AUBIO_OK) {
+    goto beach;
+  }
+  return o;
+
+beach:
+  del_aubio_hpss(o);
+  return NULL;
+}
+
+void del_aubio_hpss (aubio_hpss_t * o)
+{
+  if (o->frames) del_fmat(o->frames);
+  if (o->sorted) del_fmat(o->sorted);
+  if (o->window) del_fvec(o->window);
+  if (o->hmask) del_fvec(o->hmask);
+  if (o->pmask) del_fvec(o->pmask);
+  AUBIO_FREE(o);
+}
+
+uint_t aubio_hpss_get_memory_usage (const aubio_hpss_t * o)
+{
+  return aubio_malloc_size(o) + fmat_get_memory_usage(o->frames)
+    + fmat_get_memory_usage(o->sorted) + aubio_malloc_size(o->window)
+    + aubio_malloc_size(o->hmask) + aubio_malloc_size(o->pmask);
+}
@@ -0,0 +1,188 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+/** \file
+
+  Harmonic / Percussive Source Separation (HPSS)
+
+  This file implements a streaming version of the median filtering
+  separation described in:
+
+  Derry FitzGerald. Harmonic/percussive separation using median filtering. In
+  Proceedings of the 13th International Conference on Digital Audio Effects,
+  DAFx-10, Graz, Austria, 2010.
+
+  Each spectral frame is compared to the median of the last frames in each bin,
+  which follows the harmonic partials, and to the median of the neighbouring
+  bins in the same frame, which follows broadband percussive events. The two
+  medians are turned into soft masks, the harmonic and percussive outputs
+  adding up to the input spectrum.
+
+  The median along time only looks at past frames, so that the separation adds
+  no latency to the phase vocoder. Both medians are updated incrementally, and
+  aubio_hpss_do() allocates no memory: its percussive output can be passed to
+  aubio_onset_do_spectrum() or aubio_tempo_do_spectrum() to follow the drums of
+  a mix in real time.
+
+  \example spectral/test-hpss.c
+
+*/
+
+#ifndef AUBIO_HPSS_H
+#define AUBIO_HPSS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Harmonic / Percussive Source Separation object */
+typedef struct _aubio_hpss_t aubio_hpss_t;
+
+/** create hpss object
+
+  \param buf_size buffer size of the phase vocoder
+  \param hop_size step size of the phase vocoder
+
+  Both medians are computed over 17 values by default, see
+  aubio_hpss_set_time_width() and aubio_hpss_set_freq_width().
+
+*/
+aubio_hpss_t *new_aubio_hpss (uint_t buf_size, uint_t hop_size);
+
+/** split a spectral frame into its harmonic and percussive components
+
+  \param o hpss object as returned by new_aubio_hpss()
+  \param input input spectral frame, of `buf_size / 2 + 1` bins
+  \param harmonic output harmonic components
+  \param percussive output percussive components
+
+  The norms of `input` are weighted by the masks computed with
+  aubio_hpss_do_masks(), its phases copied to both outputs.
+
+*/
+void aubio_hpss_do (aubio_hpss_t * o, const cvec_t * input,
+    cvec_t * harmonic, cvec_t * percussive);
+
+/** compute the harmonic and percussive masks of a spectral frame
+
+  \param o hpss object as returned by new_aubio_hpss()
+  \param input input spectral frame
+  \param harm_mask output, weight of the harmonic components in each bin
+  \param perc_mask output, weight of the percussive components in each bin
+
+  The masks, between 0 and 1, add up to 1 in each bin. They should be at least
+  as long as `input`. This function updates `o` like aubio_hpss_do().
+
+*/
+void aubio_hpss_do_masks (aubio_hpss_t * o, const cvec_t * input,
+    fvec_t * harm_mask, fvec_t * perc_mask);
+
+/** set the number of frames of the median along time
+
+  \param o hpss object as returned by new_aubio_hpss()
+  \param width odd number of frames, including the current one, defaults to 17
+
+  \return 0 on success, non-zero if `width` is even or could not be allocated
+
+  The longer the median, the steadier the partials found harmonic. This
+  function allocates memory and clears the past frames.
+
+*/
+uint_t aubio_hpss_set_time_width (aubio_hpss_t * o, uint_t width);
+
+/** get the number of frames of the median along time
+
+  \param o hpss object as returned by new_aubio_hpss()
+
+  \return number of frames
+
+*/
+uint_t aubio_hpss_get_time_width (const aubio_hpss_t * o);
+
+/** set the number of bins of the median along frequency
+
+  \param o hpss object as returned by new_aubio_hpss()
+  \param width odd number of bins, centered on each bin, defaults to 17
+
+  \return 0 on success, non-zero if `width` is even or could not be allocated
+
+  This function allocates memory.
+
+*/
+uint_t aubio_hpss_set_freq_width (aubio_hpss_t * o, uint_t width);
+
+/** get the number of bins of the median along frequency
+
+  \param o hpss object as returned by new_aubio_hpss()
+
+  \return number of bins
+
+*/
+uint_t aubio_hpss_get_freq_width (const aubio_hpss_t * o);
+
+/** set the exponent of the masks
+
+  \param o hpss object as returned by new_aubio_hpss()
+  \param power exponent applied to both medians, defaults to 2
+
+  \return 0 on success, non-zero if `power` is not strictly positive
+
+  Higher values make the masks closer to binary ones.
+
+*/
+uint_t aubio_hpss_set_power (aubio_hpss_t * o, smpl_t power);
+
+/** get the exponent of the masks
+
+  \param o hpss object as returned by new_aubio_hpss()
+
+  \return current exponent
+
+*/
+smpl_t aubio_hpss_get_power (const aubio_hpss_t * o);
+
+/** forget the past frames
+
+  \param o hpss object as returned by new_aubio_hpss()
+
+*/
+void aubio_hpss_reset (aubio_hpss_t * o);
+
+/** get the memory used by a hpss object
+
+  \param o hpss object as returned by new_aubio_hpss()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_hpss_get_memory_usage (const aubio_hpss_t * o);
+
+/** delete hpss object
+
+  \param o hpss object as returned by new_aubio_hpss()
+
+*/
+void del_aubio_hpss (aubio_hpss_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_HPSS_H */
@@ -25,11 +25,19 @@
 #include "cvec.h"
 #include "mathutils.h"
 #include "vecutils.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
+#include "spectral/phasevoc.h"
 #include "spectral/filterbank.h"
+#include "spectral/filterbank_priv.h"
 #include "spectral/filterbank_mel.h"
-#include "spectral/dct.h"
+#include "io/source.h"
 #include "spectral/mfcc.h"
+#include "utils/simd_priv.h"
+#include "utils/quantize.h"
+#include "spectral/gpu_priv.h"
+#include "mathutils_priv.h"
+#include "utils/workspace_priv.h"
 
 /** Internal structure for mfcc object */
 
@@ -41,9 +49,24 @@ struct _aubio_mfcc_t
   uint_t n_coefs;           /** number of coefficients (<= n_filters/2 +1) */
   aubio_filterbank_t *fb;   /** filter bank */
   fvec_t *in_dct;           /** input buffer for dct * [fb->n_filters] */
-  aubio_dct_t *dct;         /** dct object */
-  fvec_t *output;           /** dct output */
+  fmat_t *dct_coeffs;       /** DCT type II orthonormal transform */
   smpl_t scale;
+  aubio_pvoc_t *pv;         /** phase vocoder used by aubio_mfcc_do_batch */
+  fvec_t *hop;              /** block read from the source */
+  cvec_t *fftgrain;         /** spectrum of pv */
+  uint_t finished;          /** 1 once the last block was read */
+  aubio_gpu_t *gpu;         /** device running aubio_mfcc_do_batch */
+  fmat_t *grains;           /** frames of the batch sent to gpu */
+  fvec_t *ring;             /** last win_s samples read, in gpu mode */
+  const fvec_t *window;     /** analysis window of the grains */
+  aubio_fft_t *fft;         /** fft of the grains, if gpu failed */
+  uint_t delta_order;       /** 0, 1 for deltas, 2 for delta-deltas */
+  uint_t delta_width;       /** half length of the regression window */
+  fmat_t *history;          /** coefficients of the last frames, circular */
+  uint_t history_pos;       /** row of history for the next frame */
+  uint_t history_filled;    /** 0 until the first frame was stored */
+  fmat_t *delta_kernels;    /** regression filter of each order */
+  fvec_t *coefs;            /** coefficients and deltas before quantization */
 };
 
 
@@ -54,7 +77,10 @@ new_aubio_mfcc (uint_t win_s, uint_t n_filters, uint_t n_coefs,
 
   /* allocate space for mfcc object */
   aubio_mfcc_t *mfcc = AUBIO_NEW (aubio_mfcc_t);
-  
+  uint_t i, j;
+  smpl_t scaling;
+  size_t offset = 0;
+
   if (!mfcc) {
     goto failure;
   }
@@ -86,14 +112,26 @@ new_aubio_mfcc (uint_t win_s, uint_t n_filters, uint_t n_coefs,
         0, samplerate/2.);
 
   /* allocating buffers */
-  mfcc->in_dct = new_fvec (n_filters);
-
-  mfcc->dct = new_aubio_dct (n_filters);
-  mfcc->output = new_fvec (n_filters);
+  mfcc->in_dct = new_aubio_scratch (n_filters, &offset);
+  mfcc->dct_coeffs = new_fmat (n_filters, n_filters);
+  /* room for the deltas of order 2 */
+  mfcc->coefs = new_fvec (3 * MIN (n_coefs, n_filters));
 
-  if (!mfcc->in_dct || !mfcc->dct || !mfcc->output)
+  if (!mfcc->in_dct || !mfcc->dct_coeffs || !mfcc->coefs)
     goto failure;
 
+  /* compute DCT type-II transformation matrix, as in spectral/dct_plain.c
+     dct_coeffs[j][i] = cos ( j * (i+.5) * PI / n_filters )
+  */
+  scaling = SQRT (2. / n_filters);
+  for (i = 0; i < n_filters; i++) {
+    for (j = 1; j < n_filters; j++) {
+      mfcc->dct_coeffs->data[j][i] =
+          scaling * COS (j * (i + 0.5) * PI / n_filters);
+    }
+    mfcc->dct_coeffs->data[0][i] = 1. / SQRT (n_filters);
+  }
+
   mfcc->scale = 1.;
 
   return mfcc;
@@ -110,38 +148,309 @@ del_aubio_mfcc (aubio_mfcc_t * mf)
     del_aubio_filterbank (mf->fb);
   if (mf->in_dct)
     del_fvec (mf->in_dct);
-  if (mf->dct)
-    del_aubio_dct (mf->dct);
-  if (mf->output)
-    del_fvec (mf->output);
+  if (mf->dct_coeffs)
+    del_fmat (mf->dct_coeffs);
+  if (mf->pv)
+    del_aubio_pvoc (mf->pv);
+  if (mf->hop)
+    del_fvec (mf->hop);
+  if (mf->fftgrain)
+    del_cvec (mf->fftgrain);
+  if (mf->grains)
+    del_fmat (mf->grains);
+  if (mf->ring)
+    del_fvec (mf->ring);
+  aubio_window_release (mf->window);
+  if (mf->fft)
+    del_aubio_fft (mf->fft);
+  if (mf->history)
+    del_fmat (mf->history);
+  if (mf->delta_kernels)
+    del_fmat (mf->delta_kernels);
+  if (mf->coefs)
+    del_fvec (mf->coefs);
   AUBIO_FREE (mf);
 }
 
+uint_t
+aubio_mfcc_get_memory_usage (const aubio_mfcc_t * mf)
+{
+  uint_t n = aubio_malloc_size (mf) + aubio_malloc_size (mf->in_dct)
+    + aubio_malloc_size (mf->dct_coeffs) + aubio_malloc_size (mf->hop)
+    + aubio_malloc_size (mf->fftgrain) + aubio_malloc_size (mf->grains)
+    + aubio_malloc_size (mf->ring) + aubio_malloc_size (mf->history)
+    + aubio_malloc_size (mf->delta_kernels) + aubio_malloc_size (mf->coefs);
+  n += aubio_filterbank_get_memory_usage (mf->fb);
+  if (mf->pv)
+    n += aubio_pvoc_get_memory_usage (mf->pv);
+  if (mf->fft)
+    n += aubio_fft_get_memory_usage (mf->fft);
+  return n;
+}
+
+
+/* store the coefficients of the new frame, at mf->history_pos, and write
+   those of the frame delay hops earlier, followed by their derivatives */
+static void
+aubio_mfcc_do_deltas (aubio_mfcc_t * mf, fvec_t * out)
+{
+  fmat_t *h = mf->history;
+  uint_t len = h->height, n = h->length, last = mf->history_pos;
+  uint_t delay = mf->delta_order * mf->delta_width, o, i, j;
+
+  /* repeat the first frame, so that the stream starts without a step */
+  if (!mf->history_filled) {
+    for (j = 0; j < len; j++) {
+      if (j != last) AUBIO_MEMCPY (h->data[j], h->data[last],
+          n * sizeof(smpl_t));
+    }
+    mf->history_filled = 1;
+  }
+
+  for (o = 0; o <= mf->delta_order && (o + 1) * n <= out->length; o++) {
+    const smpl_t *kernel = mf->delta_kernels->data[o];
+    uint_t taps = 2 * o * mf->delta_width + 1;
+    uint_t first = (last + 2 * len - delay - o * mf->delta_width) % len;
+    smpl_t *dst = out->data + o * n;
+    for (i = 0; i < n; i++) dst[i] = 0.;
+    for (j = 0; j < taps; j++) {
+      const smpl_t *row = h->data[(first + j) % len];
+      if (kernel[j] == 0.) continue;
+      for (i = 0; i < n; i++) dst[i] += kernel[j] * row[i];
+    }
+  }
+  mf->history_pos = (last + 1) % len;
+}
 
 void
 aubio_mfcc_do (aubio_mfcc_t * mf, const cvec_t * in, fvec_t * out)
 {
-  fvec_t tmp;
+  uint_t i, n_coefs = MIN (out->length, mf->n_filters);
+  smpl_t *bands = mf->in_dct->data;
+  AUBIO_STATS_BEGIN ("mfcc");
 
   /* compute filterbank */
   aubio_filterbank_do (mf->fb, in, mf->in_dct);
 
-  /* compute log10 */
-  fvec_log10 (mf->in_dct);
-
-  if (mf->scale != 1) fvec_mul (mf->in_dct, mf->scale);
+  if (aubio_simd_fast_math) {
+    /* approximated natural log, scaled to log10 */
+    for (i = 0; i < mf->n_filters; i++) {
+      bands[i] = CEIL_DENORMAL (bands[i]);
+    }
+    AUBIO_SIMD()->vlog (bands, mf->n_filters);
+    AUBIO_SIMD()->mul (bands, mf->scale / LOG (10.), mf->n_filters);
+  } else {
+    /* compute scaled log10 in a single pass */
+    for (i = 0; i < mf->n_filters; i++) {
+      bands[i] = mf->scale * SAFE_LOG10 (bands[i]);
+    }
+  }
 
-  /* compute mfccs */
-  aubio_dct_do(mf->dct, mf->in_dct, mf->output);
-  // copy only first n_coeffs elements
-  // TODO assert mf->output->length == n_coeffs
-  tmp.data = mf->output->data;
-  tmp.length = out->length;
-  fvec_copy(&tmp, out);
+  if (mf->delta_order) {
+    AUBIO_SIMD()->mvmul ((const smpl_t * const *)mf->dct_coeffs->data, bands,
+        mf->history->data[mf->history_pos], mf->history->length,
+        mf->n_filters);
+    aubio_mfcc_do_deltas (mf, out);
+  } else {
+    /* compute only the first n_coefs mfccs, directly into out */
+    AUBIO_SIMD()->mvmul ((const smpl_t * const *)mf->dct_coeffs->data, bands,
+        out->data, n_coefs, mf->n_filters);
+  }
 
+  AUBIO_STATS_END ();
   return;
 }
 
+/* compute the coefficients of in, and their deltas, into a view of
+   mf->coefs of the length of the quantized output */
+static void
+aubio_mfcc_do_coefs (aubio_mfcc_t * mf, const cvec_t * in, fvec_t * coefs)
+{
+  coefs->data = mf->coefs->data;
+  coefs->length = (mf->delta_order + 1) * MIN (mf->n_coefs, mf->n_filters);
+  aubio_mfcc_do (mf, in, coefs);
+}
+
+void
+aubio_mfcc_do_s8 (aubio_mfcc_t * mf, const cvec_t * in, smpl_t step,
+    s8_t * out)
+{
+  fvec_t coefs;
+  aubio_mfcc_do_coefs (mf, in, &coefs);
+  aubio_quantize_s8 (&coefs, step, out);
+}
+
+void
+aubio_mfcc_do_f16 (aubio_mfcc_t * mf, const cvec_t * in, f16_t * out)
+{
+  fvec_t coefs;
+  aubio_mfcc_do_coefs (mf, in, &coefs);
+  aubio_quantize_f16 (&coefs, out);
+}
+
+/* read the whole batch first, then compute all its frames on mf->gpu */
+static uint_t
+aubio_mfcc_do_batch_gpu (aubio_mfcc_t * mf, aubio_source_t * source,
+    uint_t hop_size, fmat_t * out, uint_t * n_frames)
+{
+  uint_t read = hop_size, frames = 0, keep = mf->win_s - hop_size, i;
+  fvec_t coefs;
+
+  if (!mf->grains || mf->grains->height != out->height) {
+    if (mf->grains) del_fmat (mf->grains);
+    mf->grains = new_fmat (out->height, mf->win_s);
+  }
+  if (!mf->ring) mf->ring = new_fvec (mf->win_s);
+  if (!mf->window) mf->window = aubio_window_acquire ("hanningz", mf->win_s);
+  if (!mf->grains || !mf->ring || !mf->window) return AUBIO_FAIL;
+
+  while (frames < out->height) {
+    smpl_t *ring = mf->ring->data;
+    aubio_source_do (source, mf->hop, &read);
+    /* same grains as the phase vocoder, its circular shift leaving the norms
+       unchanged */
+    memmove (ring, ring + hop_size, keep * sizeof (smpl_t));
+    memcpy (ring + keep, mf->hop->data, hop_size * sizeof (smpl_t));
+    memcpy (mf->grains->data[frames++], ring, mf->win_s * sizeof (smpl_t));
+    if (read < hop_size) {
+      mf->finished = 1;
+      break;
+    }
+  }
+  *n_frames = frames;
+  if (aubio_gpu_mfcc_batch (mf->gpu, mf->grains, frames, mf->window,
+        aubio_filterbank_peek_coeffs (mf->fb),
+        aubio_filterbank_get_power (mf->fb), mf->dct_coeffs, mf->scale,
+        out) == AUBIO_OK) {
+    return AUBIO_OK;
+  }
+
+  /* the device failed, compute the grains on the processor */
+  if (!mf->fft) mf->fft = new_aubio_fft (mf->win_s);
+  if (!mf->fft) return AUBIO_FAIL;
+  coefs.length = out->length;
+  for (i = 0; i < frames; i++) {
+    fvec_t grain = { mf->win_s, mf->grains->data[i] };
+    fvec_weight (&grain, mf->window);
+    aubio_fft_do (mf->fft, &grain, mf->fftgrain);
+    coefs.data = out->data[i];
+    aubio_mfcc_do (mf, mf->fftgrain, &coefs);
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_mfcc_do_batch (aubio_mfcc_t * mf, aubio_source_t * source,
+    uint_t hop_size, fmat_t * out, uint_t * n_frames)
+{
+  uint_t read = hop_size, frames = 0;
+  fvec_t coefs;
+
+  *n_frames = 0;
+  if (!mf->hop || mf->hop->length != hop_size) {
+    /* (re)create the phase vocoder for this hop size */
+    if (mf->pv) del_aubio_pvoc (mf->pv);
+    if (mf->hop) del_fvec (mf->hop);
+    mf->pv = new_aubio_pvoc (mf->win_s, hop_size);
+    mf->hop = mf->pv ? new_fvec (hop_size) : NULL;
+    if (!mf->pv || !mf->hop) {
+      AUBIO_ERR("mfcc: failed creating phase vocoder with buf_size %d"
+          " and hop_size %d\n", mf->win_s, hop_size);
+      return AUBIO_FAIL;
+    }
+    if (!mf->fftgrain) mf->fftgrain = new_cvec (mf->win_s);
+    if (!mf->fftgrain) return AUBIO_FAIL;
+    if (mf->ring) fvec_zeros (mf->ring);
+    mf->finished = 0;
+  }
+  if (mf->finished) return AUBIO_OK;
+  if (mf->gpu && !mf->delta_order) {
+    return aubio_mfcc_do_batch_gpu (mf, source, hop_size, out, n_frames);
+  }
+
+  coefs.length = out->length;
+  while (frames < out->height) {
+    aubio_source_do (source, mf->hop, &read);
+    aubio_pvoc_do (mf->pv, mf->hop, mf->fftgrain);
+    coefs.data = out->data[frames++];
+    aubio_mfcc_do (mf, mf->fftgrain, &coefs);
+    if (read < hop_size) {
+      mf->finished = 1;
+      break;
+    }
+  }
+  *n_frames = frames;
+  return AUBIO_OK;
+}
+
+uint_t aubio_mfcc_set_gpu (aubio_mfcc_t *mf, aubio_gpu_t *gpu)
+{
+  mf->gpu = gpu;
+  /* restart the stream, the phase vocoder and the ring holding apart */
+  if (mf->hop) {
+    del_fvec (mf->hop);
+    mf->hop = NULL;
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_mfcc_set_deltas (aubio_mfcc_t *mf, uint_t order, uint_t width)
+{
+  fmat_t *history = NULL, *kernels = NULL;
+  uint_t n, j, taps;
+  smpl_t norm = 0.;
+  if (order > 2 || (order > 0 && width < 1)) {
+    AUBIO_ERR("mfcc: deltas of order %d over %d frames are not supported\n",
+        order, width);
+    return AUBIO_FAIL;
+  }
+  if (order > 0) {
+    taps = 2 * order * width + 1;
+    history = new_fmat (taps, MIN (mf->n_coefs, mf->n_filters));
+    kernels = new_fmat (order + 1, taps);
+    if (!history || !kernels) {
+      if (history) del_fmat (history);
+      if (kernels) del_fmat (kernels);
+      return AUBIO_FAIL;
+    }
+    /* identity, then the regression over 2 * width + 1 frames, then its
+       convolution with itself */
+    kernels->data[0][0] = 1.;
+    for (n = 1; n <= width; n++) norm += 2. * n * n;
+    for (j = 0; j < 2 * width + 1; j++) {
+      kernels->data[1][j] = ((smpl_t)j - (smpl_t)width) / norm;
+    }
+    if (order > 1) {
+      uint_t k;
+      for (j = 0; j < 2 * width + 1; j++) {
+        for (k = 0; k < 2 * width + 1; k++) {
+          kernels->data[2][j + k] += kernels->data[1][j]
+            * kernels->data[1][k];
+        }
+      }
+    }
+  }
+  if (mf->history) del_fmat (mf->history);
+  if (mf->delta_kernels) del_fmat (mf->delta_kernels);
+  mf->history = history;
+  mf->delta_kernels = kernels;
+  mf->delta_order = order;
+  mf->delta_width = order > 0 ? width : 0;
+  mf->history_pos = 0;
+  mf->history_filled = 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_mfcc_get_delta_order (const aubio_mfcc_t *mf)
+{
+  return mf->delta_order;
+}
+
+uint_t aubio_mfcc_get_delay (const aubio_mfcc_t *mf)
+{
+  return mf->delta_order * mf->delta_width;
+}
+
 uint_t aubio_mfcc_set_power (aubio_mfcc_t *mf, smpl_t power)
 {
   return aubio_filterbank_set_power(mf->fb, power);
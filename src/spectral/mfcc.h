@@ -57,6 +57,19 @@ typedef struct _aubio_mfcc_t aubio_mfcc_t;
 aubio_mfcc_t *new_aubio_mfcc (uint_t buf_size,
     uint_t n_filters, uint_t n_coeffs, uint_t samplerate);
 
+/** get the memory used by an mfcc object
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  The mel coefficients of the filterbank, shared with the other mfcc objects
+  of the same parameters, are not counted.
+
+*/
+uint_t aubio_mfcc_get_memory_usage (const aubio_mfcc_t * mf);
+
 /** delete mfcc object
 
   \param mf mfcc object as returned by new_aubio_mfcc
@@ -73,6 +86,121 @@ void del_aubio_mfcc (aubio_mfcc_t * mf);
 */
 void aubio_mfcc_do (aubio_mfcc_t * mf, const cvec_t * in, fvec_t * out);
 
+/** compute mfcc coefficients and encode them as signed bytes
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+  \param in input spectrum (buf_size long)
+  \param step value of a code of 1, see aubio_quantize_s8()
+  \param out one byte per coefficient, `n_coeffs` of them, or
+  `(order + 1) * n_coeffs` with the deltas of aubio_mfcc_set_deltas()
+
+  The first coefficient, the log-energy of the frame, usually spans a wider
+  range than the others, and may be clamped with a small `step`.
+
+*/
+void aubio_mfcc_do_s8 (aubio_mfcc_t * mf, const cvec_t * in, smpl_t step,
+    s8_t * out);
+
+/** compute mfcc coefficients and encode them as half-precision floats
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+  \param in input spectrum (buf_size long)
+  \param out coefficients, and their deltas, as in aubio_mfcc_do_s8()
+
+*/
+void aubio_mfcc_do_f16 (aubio_mfcc_t * mf, const cvec_t * in, f16_t * out);
+
+/** compute the mfcc coefficients of consecutive blocks read from a source
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+  \param source source to read from, as returned by new_aubio_source
+  \param hop_size number of samples to read at each step, should be the
+  `hop_size` the source was created with
+  \param out output matrix, filled with one row of coefficients per block
+  \param n_frames number of rows of `out` that were filled
+
+  \return 0 if successful, non-zero otherwise
+
+  This function is equivalent to a loop reading blocks of `hop_size` samples
+  from `source`, computing their spectrum with a phase vocoder of size
+  `buf_size` and calling aubio_mfcc_do() on each spectrum, but runs without
+  any intermediate call from the caller.
+
+  The loop stops when `out->height` rows have been filled, or after the last
+  block of `source` was read, in which case `n_frames` is less than
+  `out->height`. Further calls continue where the previous one stopped, the
+  phase vocoder memory being kept between calls using the same `hop_size`.
+
+*/
+uint_t aubio_mfcc_do_batch (aubio_mfcc_t * mf, aubio_source_t * source,
+    uint_t hop_size, fmat_t * out, uint_t * n_frames);
+
+/** compute aubio_mfcc_do_batch() on a GPU
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+  \param gpu device, as returned by new_aubio_gpu(), or `NULL` to go back to
+  the processor
+
+  \return 0 on success
+
+  The blocks of each batch are read first, and their spectra, bands and
+  coefficients then computed on the device in a few launches. The object
+  does not own the device, which must be deleted after it.
+
+  The memory of the previous blocks is cleared, so that the next call to
+  aubio_mfcc_do_batch() starts from silence, as after a change of
+  `hop_size`.
+
+*/
+uint_t aubio_mfcc_set_gpu (aubio_mfcc_t * mf, aubio_gpu_t * gpu);
+
+/** compute the deltas and delta-deltas of the coefficients
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+  \param order 0 to only compute the coefficients (default), 1 to add their
+  deltas, 2 to add their deltas and delta-deltas
+  \param width half length of the regression window, in frames, usually 2
+
+  \return 0 if successful, non-zero otherwise
+
+  Once enabled, aubio_mfcc_do() keeps the coefficients of the last
+  `2 * order * width + 1` frames, and `out` should be `(order + 1) * n_coeffs`
+  long: the coefficients of a frame are followed by their deltas, and then
+  by their delta-deltas, as in HTK:
+
+  \f$ d_t = \sum_{n=1}^{N} n (c_{t+n} - c_{t-n}) / (2 \sum_{n=1}^{N} n^2) \f$
+
+  The delta-deltas are the deltas of the deltas, computed from the
+  coefficients in the same pass. Since they need the frames following it,
+  each output is the one of the frame aubio_mfcc_get_delay() calls before
+  the current one. The first frame is repeated before the start of the
+  stream.
+
+  Calling this function clears the past frames. With deltas,
+  aubio_mfcc_do_batch() does not use the device set by aubio_mfcc_set_gpu().
+
+*/
+uint_t aubio_mfcc_set_deltas (aubio_mfcc_t * mf, uint_t order, uint_t width);
+
+/** get the order of the derivatives computed by aubio_mfcc_do()
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+
+  \return 0, 1 or 2, as set by aubio_mfcc_set_deltas()
+
+*/
+uint_t aubio_mfcc_get_delta_order (const aubio_mfcc_t * mf);
+
+/** get the delay of the output of aubio_mfcc_do(), in frames
+
+  \param mf mfcc object as returned by new_aubio_mfcc
+
+  \return `order * width`, as set by aubio_mfcc_set_deltas(), 0 without
+  deltas
+
+*/
+uint_t aubio_mfcc_get_delay (const aubio_mfcc_t * mf);
+
 /** set power parameter
 
   \param mf mfcc object, as returned by new_aubio_mfcc()
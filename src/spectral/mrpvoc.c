@@ -0,0 +1,250 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "mathutils.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "mathutils_priv.h"
+#include "spectral/mrpvoc.h"
+
+typedef struct {
+  uint_t win_s;                 /**< window size */
+  uint_t hop_s;                 /**< step between two spectra */
+  uint_t every;                 /**< calls between two spectra */
+  uint_t countdown;             /**< calls left before the next spectrum */
+  uint_t updated;               /**< 1 if computed on the last call */
+  uint_t magnitude_only;        /**< if non-zero, phases are left out */
+  aubio_fft_t *fft;             /**< fft of win_s points */
+  fvec_t *compspec;             /**< real/imag spectrum of the grain */
+  const fvec_t *w;              /**< window of win_s points, shared */
+  cvec_t *grain;                /**< last spectrum */
+} aubio_mrpvoc_res_t;
+
+struct _aubio_mrpvoc_t {
+  uint_t hop_s;                 /**< samples given to each call */
+  uint_t length;                /**< longest window, size of the ring */
+  fvec_t *ring;                 /**< last samples, [2*length], mirrored */
+  uint_t pos;                   /**< where the next samples are written */
+  uint_t started;               /**< 1 once aubio_mrpvoc_do was called */
+  aubio_mrpvoc_res_t *res;      /**< resolutions */
+  uint_t n_res;                 /**< number of resolutions */
+};
+
+static void aubio_mrpvoc_del_res (aubio_mrpvoc_res_t *r);
+
+aubio_mrpvoc_t *new_aubio_mrpvoc (uint_t hop_s)
+{
+  aubio_mrpvoc_t *o;
+  if ((sint_t)hop_s < 1) {
+    AUBIO_ERR("mrpvoc: got hop_size %d, but can not be < 1\n", hop_s);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_mrpvoc_t);
+  if (!o) return NULL;
+  o->hop_s = hop_s;
+  return o;
+}
+
+sint_t aubio_mrpvoc_add (aubio_mrpvoc_t *o, uint_t win_s, uint_t hop_s)
+{
+  aubio_mrpvoc_res_t *res, *r;
+  if (o->started) {
+    AUBIO_ERR("mrpvoc: resolutions can not be added once started\n");
+    return -1;
+  }
+  if ((sint_t)win_s < 2 || win_s < o->hop_s) {
+    AUBIO_ERR("mrpvoc: got buffer_size %d, expected at least 2 and the"
+        " hop size of the input (%d)\n", win_s, o->hop_s);
+    return -1;
+  }
+  if ((sint_t)hop_s < 1 || hop_s % o->hop_s != 0 || hop_s > win_s) {
+    AUBIO_ERR("mrpvoc: got hop_size %d, expected a multiple of %d up to"
+        " the buffer size (%d)\n", hop_s, o->hop_s, win_s);
+    return -1;
+  }
+  // all resolutions read from one ring, as long as the longest window
+  if (win_s > o->length) {
+    fvec_t *ring = new_fvec(2 * win_s);
+    if (!ring) return -1;
+    if (o->ring) del_fvec(o->ring);
+    o->ring = ring;
+    o->length = win_s;
+    o->pos = 0;
+  }
+  res = (aubio_mrpvoc_res_t *)AUBIO_REALLOC(o->res,
+      (o->n_res + 1) * sizeof(aubio_mrpvoc_res_t));
+  if (!res) return -1;
+  o->res = res;
+  r = &o->res[o->n_res];
+  AUBIO_MEMSET(r, 0, sizeof(aubio_mrpvoc_res_t));
+  r->win_s = win_s;
+  r->hop_s = hop_s;
+  r->every = hop_s / o->hop_s;
+  r->countdown = r->every;
+  r->fft = new_aubio_fft(win_s);
+  r->compspec = new_fvec(win_s);
+  r->w = aubio_window_acquire("hanningz", win_s);
+  r->grain = new_cvec(win_s);
+  if (!r->fft || !r->compspec || !r->w || !r->grain) {
+    aubio_mrpvoc_del_res(r);
+    return -1;
+  }
+  return o->n_res++;
+}
+
+uint_t aubio_mrpvoc_get_n_spectra (const aubio_mrpvoc_t *o)
+{
+  return o->n_res;
+}
+
+/* write the new samples at pos, and again length samples further, so that
+ * the last samples of any window are contiguous in the ring */
+static void aubio_mrpvoc_fill_ring (aubio_mrpvoc_t *o, const smpl_t *in)
+{
+  smpl_t *ring = o->ring->data;
+  uint_t first = MIN(o->hop_s, o->length - o->pos);
+  uint_t rest = o->hop_s - first;
+  AUBIO_MEMCPY(ring + o->pos, in, first * sizeof(smpl_t));
+  AUBIO_MEMCPY(ring + o->pos + o->length, in, first * sizeof(smpl_t));
+  if (rest) {
+    AUBIO_MEMCPY(ring, in + first, rest * sizeof(smpl_t));
+    AUBIO_MEMCPY(ring + o->length, in + first, rest * sizeof(smpl_t));
+  }
+  o->pos += o->hop_s;
+  if (o->pos >= o->length) o->pos -= o->length;
+}
+
+uint_t aubio_mrpvoc_do (aubio_mrpvoc_t *o, const fvec_t *in)
+{
+  uint_t i, n = 0;
+  if (in->length != o->hop_s) {
+    AUBIO_ERR("mrpvoc: got %d input samples, expected %d\n", in->length,
+        o->hop_s);
+    return 0;
+  }
+  o->started = 1;
+  if (o->n_res == 0) return 0;
+  AUBIO_STATS_BEGIN ("mrpvoc");
+  aubio_mrpvoc_fill_ring(o, in->data);
+  for (i = 0; i < o->n_res; i++) {
+    aubio_mrpvoc_res_t *r = &o->res[i];
+    fvec_t grain;
+    r->updated = 0;
+    if (--r->countdown > 0) continue;
+    r->countdown = r->every;
+    // the last win_s samples, ending just before pos
+    grain.data = o->ring->data + (o->pos + o->length - r->win_s) % o->length;
+    grain.length = r->win_s;
+    aubio_fft_do_complex_windowed(r->fft, &grain, r->w, r->compspec);
+    if (r->magnitude_only) {
+      aubio_fft_get_norm(r->compspec, r->grain);
+    } else {
+      aubio_fft_get_spectrum(r->compspec, r->grain);
+    }
+    r->updated = 1;
+    n++;
+  }
+  AUBIO_STATS_END ();
+  return n;
+}
+
+const cvec_t *aubio_mrpvoc_get_spectrum (const aubio_mrpvoc_t *o,
+    uint_t index)
+{
+  if (index >= o->n_res) return NULL;
+  return o->res[index].grain;
+}
+
+uint_t aubio_mrpvoc_is_updated (const aubio_mrpvoc_t *o, uint_t index)
+{
+  if (index >= o->n_res) return 0;
+  return o->res[index].updated;
+}
+
+uint_t aubio_mrpvoc_set_window (aubio_mrpvoc_t *o, uint_t index,
+    const char_t *window)
+{
+  const fvec_t *w;
+  if (index >= o->n_res) {
+    AUBIO_ERR("mrpvoc: no resolution %d, only %d\n", index, o->n_res);
+    return AUBIO_FAIL;
+  }
+  w = aubio_window_acquire(window, o->res[index].win_s);
+  if (!w) return AUBIO_FAIL;
+  aubio_window_release(o->res[index].w);
+  o->res[index].w = w;
+  return AUBIO_OK;
+}
+
+uint_t aubio_mrpvoc_set_magnitude_only (aubio_mrpvoc_t *o, uint_t index,
+    uint_t magnitude_only)
+{
+  if (index >= o->n_res) {
+    AUBIO_ERR("mrpvoc: no resolution %d, only %d\n", index, o->n_res);
+    return AUBIO_FAIL;
+  }
+  o->res[index].magnitude_only = magnitude_only ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_mrpvoc_get_win (const aubio_mrpvoc_t *o, uint_t index)
+{
+  return index < o->n_res ? o->res[index].win_s : 0;
+}
+
+uint_t aubio_mrpvoc_get_hop (const aubio_mrpvoc_t *o, uint_t index)
+{
+  return index < o->n_res ? o->res[index].hop_s : 0;
+}
+
+uint_t aubio_mrpvoc_get_memory_usage (const aubio_mrpvoc_t *o)
+{
+  uint_t i, n = aubio_malloc_size(o) + aubio_malloc_size(o->ring)
+    + aubio_malloc_size(o->res);
+  for (i = 0; i < o->n_res; i++) {
+    const aubio_mrpvoc_res_t *r = &o->res[i];
+    n += aubio_fft_get_memory_usage(r->fft) + aubio_malloc_size(r->compspec)
+      + aubio_malloc_size(r->grain);
+  }
+  return n;
+}
+
+static void aubio_mrpvoc_del_res (aubio_mrpvoc_res_t *r)
+{
+  if (r->fft) del_aubio_fft(r->fft);
+  if (r->compspec) del_fvec(r->compspec);
+  if (r->w) aubio_window_release(r->w);
+  if (r->grain) del_cvec(r->grain);
+}
+
+void del_aubio_mrpvoc (aubio_mrpvoc_t *o)
+{
+  uint_t i;
+  for (i = 0; i < o->n_res; i++) {
+    aubio_mrpvoc_del_res(&o->res[i]);
+  }
+  if (o->res) AUBIO_FREE(o->res);
+  if (o->ring) del_fvec(o->ring);
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,191 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Multi-resolution phase vocoder
+
+  This object computes the spectra of the same input at several window
+  sizes, for instance 512 samples for the timing of onsets, and 2048 or
+  4096 samples for tempo and pitch. Unlike one ::aubio_pvoc_t per size, each
+  keeping its own copy of the recent input, the resolutions read their
+  grains from a single ring holding the last samples of the longest window.
+
+  Each resolution has its own hop size, a multiple of the number of samples
+  given to each call of aubio_mrpvoc_do(), and computes its spectrum once
+  every so many calls. Its grains, windows and spectra are the ones an
+  ::aubio_pvoc_t of the same window and hop sizes would compute, given the
+  same input by blocks of its hop size.
+
+  \example spectral/test-mrpvoc.c
+
+*/
+
+#ifndef AUBIO_MRPVOC_H
+#define AUBIO_MRPVOC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** multi-resolution phase vocoder object */
+typedef struct _aubio_mrpvoc_t aubio_mrpvoc_t;
+
+/** create multi-resolution phase vocoder
+
+  \param hop_s number of new samples given to each call of aubio_mrpvoc_do()
+
+  \return newly created ::aubio_mrpvoc_t, without any resolution, or NULL on
+  failure
+
+*/
+aubio_mrpvoc_t *new_aubio_mrpvoc (uint_t hop_s);
+
+/** add a resolution
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param win_s window size of the resolution, at least the `hop_s` of `o`
+  \param hop_s step between two spectra of the resolution, a multiple of the
+  `hop_s` of `o`, and at most `win_s`
+
+  \return index of the new resolution, or -1 if it could not be created
+
+  Resolutions can only be added before the first call to aubio_mrpvoc_do().
+
+*/
+sint_t aubio_mrpvoc_add (aubio_mrpvoc_t *o, uint_t win_s, uint_t hop_s);
+
+/** get number of resolutions
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+
+  \return number of resolutions added with aubio_mrpvoc_add()
+
+*/
+uint_t aubio_mrpvoc_get_n_spectra (const aubio_mrpvoc_t *o);
+
+/** analyse new samples
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param in new samples, `hop_s` of them
+
+  \return number of spectra computed on this call
+
+  The samples are added to the shared ring once, then each resolution due
+  on this call computes the spectrum of its last `win_s` samples.
+
+*/
+uint_t aubio_mrpvoc_do (aubio_mrpvoc_t *o, const fvec_t *in);
+
+/** get the spectrum of a resolution
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param index index of the resolution, as returned by aubio_mrpvoc_add()
+
+  \return last spectrum computed by the resolution, of `win_s / 2 + 1`
+  bins, or NULL if `index` is out of range; the spectrum belongs to `o` and
+  is overwritten when the resolution computes the next one
+
+*/
+const cvec_t *aubio_mrpvoc_get_spectrum (const aubio_mrpvoc_t *o,
+    uint_t index);
+
+/** check whether a resolution computed its spectrum on the last call
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param index index of the resolution
+
+  \return 1 if aubio_mrpvoc_do() computed a new spectrum for this resolution
+  on its last call, 0 otherwise, or if `index` is out of range
+
+*/
+uint_t aubio_mrpvoc_is_updated (const aubio_mrpvoc_t *o, uint_t index);
+
+/** set the window of a resolution
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param index index of the resolution
+  \param window window type, see ::new_aubio_window; `hanningz` by default
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_mrpvoc_set_window (aubio_mrpvoc_t *o, uint_t index,
+    const char_t *window);
+
+/** compute only the magnitude of a resolution
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param index index of the resolution
+  \param magnitude_only 1 to leave the phases of its spectra out, 0 to
+  compute them (default)
+
+  \return 0 if successful, non-zero if `index` is out of range
+
+  See aubio_pvoc_set_magnitude_only().
+
+*/
+uint_t aubio_mrpvoc_set_magnitude_only (aubio_mrpvoc_t *o, uint_t index,
+    uint_t magnitude_only);
+
+/** get the window size of a resolution
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param index index of the resolution
+
+  \return window size given to aubio_mrpvoc_add(), or 0 if `index` is out
+  of range
+
+*/
+uint_t aubio_mrpvoc_get_win (const aubio_mrpvoc_t *o, uint_t index);
+
+/** get the hop size of a resolution
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+  \param index index of the resolution
+
+  \return hop size given to aubio_mrpvoc_add(), or 0 if `index` is out of
+  range
+
+*/
+uint_t aubio_mrpvoc_get_hop (const aubio_mrpvoc_t *o, uint_t index);
+
+/** get the memory used by the multi-resolution phase vocoder
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h; the windows, shared, are not counted
+
+*/
+uint_t aubio_mrpvoc_get_memory_usage (const aubio_mrpvoc_t *o);
+
+/** delete multi-resolution phase vocoder
+
+  \param o multi-resolution phase vocoder, created by ::new_aubio_mrpvoc
+
+*/
+void del_aubio_mrpvoc (aubio_mrpvoc_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_MRPVOC_H */
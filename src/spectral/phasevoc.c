@@ -22,56 +22,320 @@
 #include "fvec.h"
 #include "cvec.h"
 #include "mathutils.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
+#include "mathutils_priv.h"
 #include "spectral/phasevoc.h"
+#include "io/iothread_priv.h"
+
+typedef struct _aubio_pvoc_worker_t aubio_pvoc_worker_t;
 
 /** phasevocoder internal object */
 struct _aubio_pvoc_t {
   uint_t win_s;       /** grain length */
   uint_t hop_s;       /** overlap step */
   aubio_fft_t * fft;  /** fft object */
-  fvec_t * data;      /** current input grain, [win_s] frames */
-  fvec_t * dataold;   /** memory of past grain, [win_s-hop_s] frames */
+  fvec_t * ring;      /** past input, [2*win_s] frames, second half mirrors the first */
+  uint_t ring_pos;    /** start of the current grain in ring */
   fvec_t * synth;     /** current output grain, [win_s] frames */
   fvec_t * synthold;  /** memory of past grain, [win_s-hop_s] frames */
-  fvec_t * w;         /** grain window [win_s] */
+  const fvec_t * w;   /** grain window [win_s], shared */
+  fvec_t * compspec;  /** real/imag spectrum of the current grain [win_s] */
+  uint_t magnitude_only; /** if non-zero, phase is only computed on request */
   uint_t start;       /** where to start additive synthesis */
   uint_t end;         /** where to end it */
   smpl_t scale;       /** scaling factor for synthesis */
-  uint_t end_datasize;  /** size of memory to end */
-  uint_t hop_datasize;  /** size of memory to hop_s */
+  fmat_t * rings;     /** past input of channels 1 and up, one ring per row */
+  fmat_t * grains;    /** grains of aubio_pvoc_rdo_batch, one per row */
+  uint_t rings_pos;   /** start of the current grain in rings */
+  uint_t threads;     /** number of threads of aubio_pvoc_do_multi */
+  aubio_pvoc_worker_t * workers; /** threads - 1 workers */
+  /* jobs given to the workers, protected by mutex */
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  uint_t job;         /** incremented for each new job */
+  uint_t pending;     /** number of workers still running the job */
+  uint_t quit;        /** 1 to stop the workers */
+  const fmat_t * job_in;
+  cvec_t ** job_out;
+};
+
+/** a thread of aubio_pvoc_do_multi, with its own fft */
+struct _aubio_pvoc_worker_t {
+  aubio_pvoc_t * pv;
+  uint_t index;       /** from 1 to threads - 1, 0 being the caller */
+  aubio_fft_t * fft;
+  fvec_t * compspec;
+  uint_t running;     /** 1 if the thread was started */
+  aubio_io_thread_t thread;
 };
 
 
-/** returns data and dataold slided by hop_s */
-static void aubio_pvoc_swapbuffers(aubio_pvoc_t *pv, const fvec_t *new);
+/** writes the new hop_s samples into a ring, at pos */
+static void aubio_pvoc_fill_ring(const aubio_pvoc_t *pv, smpl_t *ring,
+    uint_t pos, const smpl_t *new);
+
+/** same as aubio_pvoc_fill_ring, converting 16 bit samples */
+static void aubio_pvoc_fill_ring_s16(const aubio_pvoc_t *pv, smpl_t *ring,
+    uint_t pos, const s16_t *new);
+
+/** returns the start of the grain following the one at pos */
+static uint_t aubio_pvoc_next_pos(const aubio_pvoc_t *pv, uint_t pos);
+
+/** windowing, shift and fft of the grain starting at ring */
+static void aubio_pvoc_analyse(const aubio_pvoc_t *pv, aubio_fft_t *fft,
+    fvec_t *compspec, smpl_t *ring, cvec_t *fftgrain);
+
+/** runs aubio_pvoc_do_multi on the share of the channels of thread index */
+static void aubio_pvoc_do_share(aubio_pvoc_t *pv, uint_t index,
+    aubio_fft_t *fft, fvec_t *compspec);
+
+/** stops the workers and frees them */
+static void aubio_pvoc_del_workers(aubio_pvoc_t *pv);
+
+/** returns sample i of the last synthesised grain, unshifted and windowed */
+static smpl_t aubio_pvoc_synth_at(const aubio_pvoc_t *pv,
+    const smpl_t *synth, uint_t i);
 
 /** do additive synthesis from 'old' and 'cur' */
 static void aubio_pvoc_addsynth(aubio_pvoc_t *pv, fvec_t * synthnew);
 
 void aubio_pvoc_do(aubio_pvoc_t *pv, const fvec_t * datanew, cvec_t *fftgrain) {
+  AUBIO_STATS_BEGIN ("pvoc");
   /* slide  */
-  aubio_pvoc_swapbuffers(pv, datanew);
-  /* windowing */
-  fvec_weight(pv->data, pv->w);
-  /* shift */
-  fvec_shift(pv->data);
-  /* calculate fft */
-  aubio_fft_do (pv->fft,pv->data,fftgrain);
+  aubio_pvoc_fill_ring(pv, pv->ring->data, pv->ring_pos, datanew->data);
+  pv->ring_pos = aubio_pvoc_next_pos(pv, pv->ring_pos);
+  aubio_pvoc_analyse(pv, pv->fft, pv->compspec, pv->ring->data + pv->ring_pos,
+      fftgrain);
+  AUBIO_STATS_END ();
+}
+
+void aubio_pvoc_do_s16(aubio_pvoc_t *pv, const s16_t * datanew,
+    cvec_t *fftgrain) {
+  AUBIO_STATS_BEGIN ("pvoc");
+  aubio_pvoc_fill_ring_s16(pv, pv->ring->data, pv->ring_pos, datanew);
+  pv->ring_pos = aubio_pvoc_next_pos(pv, pv->ring_pos);
+  aubio_pvoc_analyse(pv, pv->fft, pv->compspec, pv->ring->data + pv->ring_pos,
+      fftgrain);
+  AUBIO_STATS_END ();
+}
+
+void aubio_pvoc_skip(aubio_pvoc_t *pv, const fvec_t * datanew) {
+  aubio_pvoc_fill_ring(pv, pv->ring->data, pv->ring_pos, datanew->data);
+  pv->ring_pos = aubio_pvoc_next_pos(pv, pv->ring_pos);
+}
+
+void aubio_pvoc_do_multi(aubio_pvoc_t *pv, const fmat_t * in,
+    cvec_t ** fftgrains) {
+  uint_t ch;
+  if (in->length != pv->hop_s) {
+    AUBIO_ERR("pvoc: expected input frames of length %d, got %d\n",
+        pv->hop_s, in->length);
+    return;
+  }
+  for (ch = 0; ch < in->height; ch++) {
+    if (fftgrains[ch]->length != pv->win_s / 2 + 1) {
+      AUBIO_ERR("pvoc: expected spectra of length %d, got %d\n",
+          pv->win_s / 2 + 1, fftgrains[ch]->length);
+      return;
+    }
+  }
+  if (in->height == 0) return;
+  if (!pv->rings || pv->rings->height < in->height - 1) {
+    /* channels 1 and up start from silence */
+    fmat_t *rings = new_fmat(in->height - 1 ? in->height - 1 : 1,
+        2 * pv->win_s);
+    if (!rings) return;
+    if (pv->rings) del_fmat(pv->rings);
+    pv->rings = rings;
+  }
+  AUBIO_STATS_BEGIN ("pvoc");
+  pv->job_in = in;
+  pv->job_out = fftgrains;
+  if (pv->workers) {
+    AUBIO_IO_LOCK(pv);
+    pv->job++;
+    pv->pending = pv->threads - 1;
+    AUBIO_IO_WAKE(pv);
+    AUBIO_IO_UNLOCK(pv);
+  }
+  aubio_pvoc_do_share(pv, 0, pv->fft, pv->compspec);
+  if (pv->workers) {
+    AUBIO_IO_LOCK(pv);
+    while (pv->pending > 0) AUBIO_IO_WAIT(pv);
+    AUBIO_IO_UNLOCK(pv);
+  }
+  pv->ring_pos = aubio_pvoc_next_pos(pv, pv->ring_pos);
+  pv->rings_pos = aubio_pvoc_next_pos(pv, pv->rings_pos);
+  AUBIO_STATS_END ();
+}
+
+static void aubio_pvoc_do_share(aubio_pvoc_t *pv, uint_t index,
+    aubio_fft_t *fft, fvec_t *compspec) {
+  const fmat_t *in = pv->job_in;
+  /* contiguous shares, the caller taking the first one */
+  uint_t ch = in->height * index / pv->threads;
+  uint_t end = in->height * (index + 1) / pv->threads;
+  for (; ch < end; ch++) {
+    smpl_t *ring = ch ? pv->rings->data[ch - 1] : pv->ring->data;
+    uint_t pos = ch ? pv->rings_pos : pv->ring_pos;
+    aubio_pvoc_fill_ring(pv, ring, pos, in->data[ch]);
+    aubio_pvoc_analyse(pv, fft, compspec, ring + aubio_pvoc_next_pos(pv, pos),
+        pv->job_out[ch]);
+  }
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_pvoc_worker)
+{
+  aubio_pvoc_worker_t *w = (aubio_pvoc_worker_t *)arg;
+  aubio_pvoc_t *pv = w->pv;
+  uint_t done = 0;
+  AUBIO_IO_LOCK(pv);
+  for (;;) {
+    while (pv->job == done && !pv->quit) AUBIO_IO_WAIT(pv);
+    if (pv->quit) break;
+    done = pv->job;
+    AUBIO_IO_UNLOCK(pv);
+    aubio_pvoc_do_share(pv, w->index, w->fft, w->compspec);
+    AUBIO_IO_LOCK(pv);
+    if (--pv->pending == 0) AUBIO_IO_WAKE(pv);
+  }
+  AUBIO_IO_UNLOCK(pv);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+uint_t aubio_pvoc_set_threads(aubio_pvoc_t *pv, uint_t threads) {
+  uint_t i;
+  if (threads < 1) {
+    AUBIO_ERR("pvoc: got %d threads, but can not be < 1\n", threads);
+    return AUBIO_FAIL;
+  }
+  aubio_pvoc_del_workers(pv);
+  pv->threads = threads;
+  if (threads == 1) return AUBIO_OK;
+  pv->workers = AUBIO_ARRAY(aubio_pvoc_worker_t, threads - 1);
+  if (!pv->workers) goto beach;
+  pv->quit = 0;
+  pv->job = 0;
+  AUBIO_IO_THREAD_INIT(pv);
+  for (i = 0; i < threads - 1; i++) {
+    aubio_pvoc_worker_t *w = &pv->workers[i];
+    w->pv = pv;
+    w->index = i + 1;
+    w->fft = new_aubio_fft(pv->win_s);
+    w->compspec = new_fvec(pv->win_s);
+    if (!w->fft || !w->compspec) goto beach;
+  }
+  for (i = 0; i < threads - 1; i++) {
+    aubio_pvoc_worker_t *w = &pv->workers[i];
+    w->running = AUBIO_IO_THREAD_START(w, aubio_pvoc_worker,
+        AUBIO_THREAD_WORKER);
+    if (!w->running) {
+      AUBIO_ERR("pvoc: failed starting thread %d\n", i + 1);
+      goto beach;
+    }
+  }
+  return AUBIO_OK;
+beach:
+  aubio_pvoc_del_workers(pv);
+  return AUBIO_FAIL;
+}
+
+uint_t aubio_pvoc_get_threads(const aubio_pvoc_t *pv) {
+  return pv->threads;
+}
+
+static void aubio_pvoc_del_workers(aubio_pvoc_t *pv) {
+  uint_t i;
+  if (!pv->workers) {
+    pv->threads = 1;
+    return;
+  }
+  AUBIO_IO_LOCK(pv);
+  pv->quit = 1;
+  AUBIO_IO_WAKE(pv);
+  AUBIO_IO_UNLOCK(pv);
+  for (i = 0; i < pv->threads - 1; i++) {
+    aubio_pvoc_worker_t *w = &pv->workers[i];
+    if (w->running) AUBIO_IO_THREAD_JOIN(w);
+    if (w->fft) del_aubio_fft(w->fft);
+    if (w->compspec) del_fvec(w->compspec);
+  }
+  AUBIO_IO_THREAD_DESTROY(pv);
+  AUBIO_FREE(pv->workers);
+  pv->workers = NULL;
+  pv->threads = 1;
+}
+
+static void aubio_pvoc_analyse(const aubio_pvoc_t *pv, aubio_fft_t *fft,
+    fvec_t *compspec, smpl_t *ring, cvec_t *fftgrain) {
+  fvec_t grain;
+  /* windowing, shift and fft, reading the current grain from the ring */
+  grain.data = ring;
+  grain.length = pv->win_s;
+  aubio_fft_do_complex_windowed (fft, &grain, pv->w, compspec);
+  if (pv->magnitude_only) {
+    aubio_fft_get_norm (compspec, fftgrain);
+  } else {
+    aubio_fft_get_spectrum (compspec, fftgrain);
+  }
 }
 
 void aubio_pvoc_rdo(aubio_pvoc_t *pv,cvec_t * fftgrain, fvec_t * synthnew) {
+  AUBIO_STATS_BEGIN ("pvoc inverse");
   /* calculate rfft */
   aubio_fft_rdo(pv->fft,fftgrain,pv->synth);
-  /* unshift */
-  fvec_ishift(pv->synth);
-  /* windowing */
-  // if overlap = 50%, do not apply window (identity)
-  if (pv->hop_s * 2 < pv->win_s) {
-    fvec_weight(pv->synth, pv->w);
-  }
-  /* additive synthesis */
+  /* unshift, windowing and additive synthesis */
   aubio_pvoc_addsynth(pv, synthnew);
+  AUBIO_STATS_END ();
+}
+
+uint_t aubio_pvoc_rdo_batch(aubio_pvoc_t *pv, const fmat_t * norms,
+    const fmat_t * phases, fvec_t * out) {
+  uint_t n_frames = norms->height, total = n_frames * pv->hop_s;
+  uint_t f, i, pos, carry = pv->end;
+  smpl_t *synthold = pv->synthold->data, *grain;
+  if (out->length < total) {
+    AUBIO_ERR("pvoc: %d frames need an output of %d samples, got %d\n",
+        n_frames, total, out->length);
+    return AUBIO_FAIL;
+  }
+  if (n_frames == 0) return AUBIO_OK;
+  if (!pv->grains || pv->grains->height < n_frames) {
+    fmat_t *grains = new_fmat(n_frames, pv->win_s);
+    if (!grains) return AUBIO_FAIL;
+    if (pv->grains) del_fmat(pv->grains);
+    pv->grains = grains;
+  }
+  AUBIO_STATS_BEGIN ("pvoc inverse");
+  if (aubio_fft_rdo_batch(pv->fft, norms, phases, pv->grains) != AUBIO_OK) {
+    AUBIO_STATS_END ();
+    return AUBIO_FAIL;
+  }
+  /* the trail of the previous grains starts the output, and synthold keeps
+   * what the last grains add past its end */
+  for (i = 0; i < total; i++) {
+    out->data[i] = i < carry ? synthold[i] : 0.;
+  }
+  for (i = 0; i < carry; i++) {
+    synthold[i] = i + total < carry ? synthold[i + total] : 0.;
+  }
+  /* a single overlap-add pass, adding the grains in the order
+   * aubio_pvoc_rdo() would */
+  for (f = 0; f < n_frames; f++) {
+    grain = pv->grains->data[f];
+    pos = f * pv->hop_s;
+    for (i = 0; i < pv->win_s && pos + i < total; i++) {
+      out->data[pos + i] += aubio_pvoc_synth_at(pv, grain, i) * pv->scale;
+    }
+    for (; i < pv->win_s; i++) {
+      synthold[pos + i - total] += aubio_pvoc_synth_at(pv, grain, i)
+        * pv->scale;
+    }
+  }
+  AUBIO_STATS_END ();
+  return AUBIO_OK;
 }
 
 aubio_pvoc_t * new_aubio_pvoc (uint_t win_s, uint_t hop_s) {
@@ -103,18 +367,20 @@ aubio_pvoc_t * new_aubio_pvoc (uint_t win_s, uint_t hop_s) {
   }
 
   /* remember old */
-  pv->data     = new_fvec (win_s);
   pv->synth    = new_fvec (win_s);
+  pv->ring     = new_fvec (2 * win_s);
+  pv->ring_pos = 0;
 
   /* new input output */
   if (win_s > hop_s) {
-    pv->dataold  = new_fvec  (win_s-hop_s);
     pv->synthold = new_fvec (win_s-hop_s);
   } else {
-    pv->dataold  = new_fvec  (1);
     pv->synthold = new_fvec (1);
   }
-  pv->w        = new_aubio_window ("hanningz", win_s);
+  pv->w        = aubio_window_acquire ("hanningz", win_s);
+  pv->compspec = new_fvec (win_s);
+  pv->magnitude_only = 0;
+  pv->threads = 1;
 
   pv->hop_s    = hop_s;
   pv->win_s    = win_s;
@@ -127,9 +393,6 @@ aubio_pvoc_t * new_aubio_pvoc (uint_t win_s, uint_t hop_s) {
   if (win_s > hop_s) pv->end = win_s - hop_s;
   else pv->end = 0;
 
-  pv->end_datasize = pv->end * sizeof(smpl_t);
-  pv->hop_datasize = pv->hop_s * sizeof(smpl_t);
-
   // for reconstruction with 75% overlap
   if (win_s == hop_s * 4) {
     pv->scale = 2./3.;
@@ -149,60 +412,145 @@ beach:
 }
 
 uint_t aubio_pvoc_set_window(aubio_pvoc_t *pv, const char_t *window) {
-  return fvec_set_window(pv->w, (char_t*)window);
+  const fvec_t *w = aubio_window_acquire(window, pv->win_s);
+  if (!w) return AUBIO_FAIL;
+  aubio_window_release(pv->w);
+  pv->w = w;
+  return AUBIO_OK;
+}
+
+uint_t aubio_pvoc_set_magnitude_only(aubio_pvoc_t *pv, uint_t magnitude_only)
+{
+  pv->magnitude_only = magnitude_only ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_pvoc_get_magnitude_only(const aubio_pvoc_t *pv)
+{
+  return pv->magnitude_only;
+}
+
+void aubio_pvoc_get_input(const aubio_pvoc_t *pv, fvec_t *view)
+{
+  /* the last hop_s samples end the current grain */
+  fvec_view(view, pv->ring, pv->ring_pos + pv->win_s - pv->hop_s, pv->hop_s);
+}
+
+void aubio_pvoc_get_phase(const aubio_pvoc_t *pv, cvec_t *fftgrain)
+{
+  aubio_fft_get_phas(pv->compspec, fftgrain);
 }
 
 void del_aubio_pvoc(aubio_pvoc_t *pv) {
-  del_fvec(pv->data);
+  aubio_pvoc_del_workers(pv);
+  if (pv->rings) del_fmat(pv->rings);
+  if (pv->grains) del_fmat(pv->grains);
   del_fvec(pv->synth);
-  del_fvec(pv->dataold);
+  del_fvec(pv->ring);
   del_fvec(pv->synthold);
-  del_fvec(pv->w);
+  aubio_window_release(pv->w);
+  del_fvec(pv->compspec);
   del_aubio_fft(pv->fft);
   AUBIO_FREE(pv);
 }
 
-static void aubio_pvoc_swapbuffers(aubio_pvoc_t *pv, const fvec_t *new)
+uint_t aubio_pvoc_get_memory_usage(const aubio_pvoc_t *pv) {
+  uint_t i, n = aubio_malloc_size(pv) + aubio_fft_get_memory_usage(pv->fft)
+    + aubio_malloc_size(pv->ring) + aubio_malloc_size(pv->synth)
+    + aubio_malloc_size(pv->synthold) + aubio_malloc_size(pv->compspec)
+    + aubio_malloc_size(pv->rings) + aubio_malloc_size(pv->grains)
+    + aubio_malloc_size(pv->workers);
+  // the window is shared
+  for (i = 0; pv->workers && i < pv->threads - 1; i++) {
+    const aubio_pvoc_worker_t *w = &pv->workers[i];
+    if (w->fft) n += aubio_fft_get_memory_usage(w->fft);
+    n += aubio_malloc_size(w->compspec);
+  }
+  return n;
+}
+
+static void aubio_pvoc_fill_ring(const aubio_pvoc_t *pv, smpl_t *ring,
+    uint_t pos, const smpl_t *datanew)
 {
-  /* some convenience pointers */
-  smpl_t * data = pv->data->data;
-  smpl_t * dataold = pv->dataold->data;
-  smpl_t * datanew = new->data;
+  /* the new samples replace the oldest hop_s ones, at pos, and are
+   * written twice so that the grain is always contiguous in ring */
+  uint_t first = MIN(pv->hop_s, pv->win_s - pos);
 #ifndef HAVE_MEMCPY_HACKS
   uint_t i;
-  for (i = 0; i < pv->end; i++)
-    data[i] = dataold[i];
-  for (i = 0; i < pv->hop_s; i++)
-    data[pv->end + i] = datanew[i];
-  for (i = 0; i < pv->end; i++)
-    dataold[i] = data[i + pv->hop_s];
+  for (i = 0; i < first; i++) {
+    ring[pos + i] = datanew[i];
+    ring[pos + i + pv->win_s] = datanew[i];
+  }
+  for (i = first; i < pv->hop_s; i++) {
+    ring[pos + i - pv->win_s] = datanew[i];
+    ring[pos + i] = datanew[i];
+  }
 #else
-  memcpy(data, dataold, pv->end_datasize);
-  data += pv->end;
-  memcpy(data, datanew, pv->hop_datasize);
-  data -= pv->end;
-  data += pv->hop_s;
-  memcpy(dataold, data, pv->end_datasize);
+  memcpy(ring + pos, datanew, first * sizeof(smpl_t));
+  memcpy(ring + pos + pv->win_s, datanew, first * sizeof(smpl_t));
+  if (first < pv->hop_s) {
+    uint_t rest = (pv->hop_s - first) * sizeof(smpl_t);
+    memcpy(ring, datanew + first, rest);
+    memcpy(ring + pv->win_s, datanew + first, rest);
+  }
 #endif
 }
 
+static void aubio_pvoc_fill_ring_s16(const aubio_pvoc_t *pv, smpl_t *ring,
+    uint_t pos, const s16_t *new)
+{
+  uint_t first = MIN(pv->hop_s, pv->win_s - pos), i;
+  /* each sample is converted once, then written twice */
+  for (i = 0; i < first; i++) {
+    smpl_t x = new[i] * AUBIO_S16_SCALE;
+    ring[pos + i] = x;
+    ring[pos + i + pv->win_s] = x;
+  }
+  for (i = first; i < pv->hop_s; i++) {
+    smpl_t x = new[i] * AUBIO_S16_SCALE;
+    ring[pos + i - pv->win_s] = x;
+    ring[pos + i] = x;
+  }
+}
+
+static uint_t aubio_pvoc_next_pos(const aubio_pvoc_t *pv, uint_t pos)
+{
+  pos += pv->hop_s;
+  if (pos >= pv->win_s) pos -= pv->win_s;
+  return pos;
+}
+
+static smpl_t aubio_pvoc_synth_at(const aubio_pvoc_t *pv,
+    const smpl_t *synth, uint_t i)
+{
+  /* same rotation as fvec_ishift */
+  uint_t k = i + pv->win_s / 2;
+  smpl_t sample;
+  if (k >= pv->win_s) k -= pv->win_s;
+  sample = synth[k];
+  // if overlap = 50%, do not apply window (identity)
+  if (pv->hop_s * 2 < pv->win_s) {
+    sample *= pv->w->data[i];
+  }
+  return sample;
+}
+
 static void aubio_pvoc_addsynth(aubio_pvoc_t *pv, fvec_t *synth_new)
 {
   uint_t i;
   /* some convenience pointers */
-  smpl_t * synth    = pv->synth->data;
   smpl_t * synthold = pv->synthold->data;
   smpl_t * synthnew = synth_new->data;
 
   /* put new result in synthnew */
   for (i = 0; i < pv->hop_s; i++)
-    synthnew[i] = synth[i] * pv->scale;
+    synthnew[i] = aubio_pvoc_synth_at(pv, pv->synth->data, i) * pv->scale;
 
   /* no overlap, nothing else to do */
   if (pv->end == 0) return;
 
-  /* add new synth to old one */
-  for (i = 0; i < pv->hop_s; i++)
+  /* add new synth to old one, shorter than hop_s past 50% overlap */
+  for (i = 0; i < MIN(pv->hop_s, pv->end); i++)
     synthnew[i] += synthold[i];
 
   /* shift synthold */
@@ -215,7 +563,8 @@ static void aubio_pvoc_addsynth(aubio_pvoc_t *pv, fvec_t *synth_new)
 
   /* additive synth */
   for (i = 0; i < pv->end; i++)
-    synthold[i] += synth[i + pv->hop_s] * pv->scale;
+    synthold[i] += aubio_pvoc_synth_at(pv, pv->synth->data, i + pv->hop_s)
+      * pv->scale;
 }
 
 uint_t aubio_pvoc_get_win(aubio_pvoc_t* pv)
@@ -48,6 +48,20 @@ typedef struct _aubio_pvoc_t aubio_pvoc_t;
 
 */
 aubio_pvoc_t * new_aubio_pvoc (uint_t win_s, uint_t hop_s);
+
+/** get the memory used by a phase vocoder
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  The window, shared with the other phase vocoders of the same size, is not
+  counted.
+
+*/
+uint_t aubio_pvoc_get_memory_usage (const aubio_pvoc_t * pv);
+
 /** delete phase vocoder object
 
   \param pv phase vocoder object as returned by new_aubio_pvoc
@@ -68,6 +82,44 @@ void del_aubio_pvoc(aubio_pvoc_t *pv);
 
 */
 void aubio_pvoc_do(aubio_pvoc_t *pv, const fvec_t *in, cvec_t * fftgrain);
+/** compute spectral frame from 16 bit integer samples
+
+  Same as aubio_pvoc_do(), with the samples scaled by 1 / 32768 as they are
+  written to the past input of the phase vocoder, without an intermediate
+  ::fvec_t.
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param in new input signal, hop_s samples
+  \param fftgrain output spectral frame
+
+*/
+void aubio_pvoc_do_s16(aubio_pvoc_t *pv, const s16_t *in, cvec_t * fftgrain);
+/** compute spectral frames of several channels
+
+  Same as calling aubio_pvoc_do() on one phase vocoder per channel, sharing
+  the window and, unless aubio_pvoc_set_threads() was called, the Fourier
+  transform. The first channel is the one of aubio_pvoc_do(), the other ones
+  have their own past input, which starts from silence when the number of
+  channels grows.
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param in new input signal, one row of hop_s samples per channel
+  \param fftgrains output spectral frames, one per row of in
+
+*/
+void aubio_pvoc_do_multi(aubio_pvoc_t *pv, const fmat_t *in,
+    cvec_t ** fftgrains);
+
+/** feed new input without computing its spectrum
+
+  Only stores the new samples, so that the next call to aubio_pvoc_do()
+  returns the spectrum it would have returned had this hop been analysed.
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param in new input signal (hop_s long)
+
+*/
+void aubio_pvoc_skip(aubio_pvoc_t *pv, const fvec_t *in);
 /** compute signal from spectral frame
 
   This function takes an input spectral frame fftgrain of size
@@ -82,6 +134,29 @@ void aubio_pvoc_do(aubio_pvoc_t *pv, const fvec_t *in, cvec_t * fftgrain);
 */
 void aubio_pvoc_rdo(aubio_pvoc_t *pv, cvec_t * fftgrain, fvec_t *out);
 
+/** compute signal from a sequence of spectral frames
+
+  Offline counterpart of aubio_pvoc_rdo(): the inverse Fourier transforms of
+  all the frames are computed together with aubio_fft_rdo_batch(), then
+  overlap-added in a single pass into out. The result is the one of calling
+  aubio_pvoc_rdo() on each frame in turn, and the synthesis continues from
+  and into the same state, so that both functions can be mixed.
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param norms input norms, one frame of `win_s / 2 + 1` bins per row
+  \param phases input phases, with the same size as norms
+  \param out output signal, at least `hop_s` samples per row of norms, of
+  which the first `hop_s * norms->height` are written
+
+  \return 0 on success, non-zero if the sizes do not match
+
+  The inverse transforms are kept in a matrix of the phase vocoder, grown to
+  the largest number of frames given so far.
+
+*/
+uint_t aubio_pvoc_rdo_batch(aubio_pvoc_t *pv, const fmat_t * norms,
+    const fmat_t * phases, fvec_t *out);
+
 /** get window size
 
   \param pv phase vocoder to get the window size from
@@ -106,6 +181,72 @@ uint_t aubio_pvoc_get_hop(aubio_pvoc_t* pv);
  */
 uint_t aubio_pvoc_set_window(aubio_pvoc_t *pv, const char_t *window_type);
 
+/** enable or disable magnitude-only analysis
+
+  When enabled, aubio_pvoc_do() only computes the norm of each spectral frame
+  and leaves its phas array untouched, saving one atan2 per bin. The phase of
+  the last analysed frame can still be obtained with aubio_pvoc_get_phase().
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param magnitude_only 1 to skip phase computation, 0 to compute it (default)
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_pvoc_set_magnitude_only(aubio_pvoc_t *pv, uint_t magnitude_only);
+
+/** get magnitude-only mode
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+
+  \return 1 if aubio_pvoc_do() skips phase computation, 0 otherwise
+
+*/
+uint_t aubio_pvoc_get_magnitude_only(const aubio_pvoc_t *pv);
+
+/** get the last input samples
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param view vector set to view the last hop_s samples given to
+  aubio_pvoc_do() or aubio_pvoc_do_s16(), valid until the next call
+
+  This is mostly useful after aubio_pvoc_do_s16(), to get the converted
+  samples.
+
+*/
+void aubio_pvoc_get_input(const aubio_pvoc_t *pv, fvec_t *view);
+
+/** compute the phase of the last analysed frame
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param fftgrain spectral frame in which to store the phase
+
+*/
+void aubio_pvoc_get_phase(const aubio_pvoc_t *pv, cvec_t *fftgrain);
+
+/** set the number of threads used by aubio_pvoc_do_multi()
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+  \param threads number of threads, including the caller, 1 by default
+
+  \return 0 if successful, non-zero otherwise
+
+  The channels are split in contiguous shares, the caller computing the
+  first one. Each additional thread owns a Fourier transform object. This is
+  only worth it for large numbers of channels or long windows.
+
+*/
+uint_t aubio_pvoc_set_threads(aubio_pvoc_t *pv, uint_t threads);
+
+/** get the number of threads used by aubio_pvoc_do_multi()
+
+  \param pv phase vocoder object as returned by new_aubio_pvoc
+
+  \return number of threads, including the caller
+
+*/
+uint_t aubio_pvoc_get_threads(const aubio_pvoc_t *pv);
+
 #ifdef __cplusplus
 }
 #endif
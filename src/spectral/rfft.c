@@ -0,0 +1,629 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "mathutils.h"
+#include "spectral/rfft_priv.h"
+
+#if !HAVE_AUBIO_DOUBLE
+/* webassembly first, emscripten also defines __SSE2__ with -msse2 */
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define RFFT_VEC         v128_t
+#define RFFT_W           4
+#define RFFT_LOAD(p)     wasm_v128_load(p)
+#define RFFT_STORE(p,v)  wasm_v128_store(p, v)
+#define RFFT_SET1(x)     wasm_f32x4_splat(x)
+#define RFFT_ADD(a,b)    wasm_f32x4_add(a, b)
+#define RFFT_SUB(a,b)    wasm_f32x4_sub(a, b)
+#define RFFT_MUL(a,b)    wasm_f32x4_mul(a, b)
+#define RFFT_REVERSE(a)  wasm_i32x4_shuffle(a, a, 3, 2, 1, 0)
+#define RFFT_TRANSPOSE4(a,b,c,d) { \
+  v128_t t0 = wasm_i32x4_shuffle(a, b, 0, 4, 1, 5); \
+  v128_t t1 = wasm_i32x4_shuffle(a, b, 2, 6, 3, 7); \
+  v128_t t2 = wasm_i32x4_shuffle(c, d, 0, 4, 1, 5); \
+  v128_t t3 = wasm_i32x4_shuffle(c, d, 2, 6, 3, 7); \
+  a = wasm_i32x4_shuffle(t0, t2, 0, 1, 4, 5); \
+  b = wasm_i32x4_shuffle(t0, t2, 2, 3, 6, 7); \
+  c = wasm_i32x4_shuffle(t1, t3, 0, 1, 4, 5); \
+  d = wasm_i32x4_shuffle(t1, t3, 2, 3, 6, 7); }
+#define RFFT_DEINTERLEAVE(p,ev,od) { \
+  v128_t lo = wasm_v128_load(p), hi = wasm_v128_load((p) + 4); \
+  ev = wasm_i32x4_shuffle(lo, hi, 0, 2, 4, 6); \
+  od = wasm_i32x4_shuffle(lo, hi, 1, 3, 5, 7); }
+#define RFFT_INTERLEAVE(p,ev,od) { \
+  wasm_v128_store(p, wasm_i32x4_shuffle(ev, od, 0, 4, 1, 5)); \
+  wasm_v128_store((p) + 4, wasm_i32x4_shuffle(ev, od, 2, 6, 3, 7)); }
+#elif defined(__SSE2__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RFFT_VEC         __m128
+#define RFFT_W           4
+#define RFFT_LOAD(p)     _mm_loadu_ps(p)
+#define RFFT_STORE(p,v)  _mm_storeu_ps(p, v)
+#define RFFT_SET1(x)     _mm_set1_ps(x)
+#define RFFT_ADD(a,b)    _mm_add_ps(a, b)
+#define RFFT_SUB(a,b)    _mm_sub_ps(a, b)
+#define RFFT_MUL(a,b)    _mm_mul_ps(a, b)
+#define RFFT_REVERSE(a)  _mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 1, 2, 3))
+#define RFFT_TRANSPOSE4(a,b,c,d) _MM_TRANSPOSE4_PS(a, b, c, d)
+#define RFFT_DEINTERLEAVE(p,ev,od) { \
+  __m128 lo = _mm_loadu_ps(p), hi = _mm_loadu_ps((p) + 4); \
+  ev = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)); \
+  od = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)); }
+#define RFFT_INTERLEAVE(p,ev,od) { \
+  _mm_storeu_ps(p, _mm_unpacklo_ps(ev, od)); \
+  _mm_storeu_ps((p) + 4, _mm_unpackhi_ps(ev, od)); }
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define RFFT_VEC         float32x4_t
+#define RFFT_W           4
+#define RFFT_LOAD(p)     vld1q_f32(p)
+#define RFFT_STORE(p,v)  vst1q_f32(p, v)
+#define RFFT_SET1(x)     vdupq_n_f32(x)
+#define RFFT_ADD(a,b)    vaddq_f32(a, b)
+#define RFFT_SUB(a,b)    vsubq_f32(a, b)
+#define RFFT_MUL(a,b)    vmulq_f32(a, b)
+#define RFFT_REVERSE(a)  vcombine_f32(vget_high_f32(vrev64q_f32(a)), \
+    vget_low_f32(vrev64q_f32(a)))
+#define RFFT_TRANSPOSE4(a,b,c,d) { \
+  float32x4x2_t t0 = vtrnq_f32(a, b), t1 = vtrnq_f32(c, d); \
+  a = vcombine_f32(vget_low_f32(t0.val[0]), vget_low_f32(t1.val[0])); \
+  b = vcombine_f32(vget_low_f32(t0.val[1]), vget_low_f32(t1.val[1])); \
+  c = vcombine_f32(vget_high_f32(t0.val[0]), vget_high_f32(t1.val[0])); \
+  d = vcombine_f32(vget_high_f32(t0.val[1]), vget_high_f32(t1.val[1])); }
+#define RFFT_DEINTERLEAVE(p,ev,od) { \
+  float32x4x2_t t = vld2q_f32(p); ev = t.val[0]; od = t.val[1]; }
+#define RFFT_INTERLEAVE(p,ev,od) { \
+  float32x4x2_t t; t.val[0] = ev; t.val[1] = od; vst2q_f32(p, t); }
+#endif
+#else /* HAVE_AUBIO_DOUBLE */
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define RFFT_VEC         v128_t
+#define RFFT_W           2
+#define RFFT_LOAD(p)     wasm_v128_load(p)
+#define RFFT_STORE(p,v)  wasm_v128_store(p, v)
+#define RFFT_SET1(x)     wasm_f64x2_splat(x)
+#define RFFT_ADD(a,b)    wasm_f64x2_add(a, b)
+#define RFFT_SUB(a,b)    wasm_f64x2_sub(a, b)
+#define RFFT_MUL(a,b)    wasm_f64x2_mul(a, b)
+#define RFFT_REVERSE(a)  wasm_i64x2_shuffle(a, a, 1, 0)
+#elif defined(__SSE2__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RFFT_VEC         __m128d
+#define RFFT_W           2
+#define RFFT_LOAD(p)     _mm_loadu_pd(p)
+#define RFFT_STORE(p,v)  _mm_storeu_pd(p, v)
+#define RFFT_SET1(x)     _mm_set1_pd(x)
+#define RFFT_ADD(a,b)    _mm_add_pd(a, b)
+#define RFFT_SUB(a,b)    _mm_sub_pd(a, b)
+#define RFFT_MUL(a,b)    _mm_mul_pd(a, b)
+#define RFFT_REVERSE(a)  _mm_shuffle_pd(a, a, 1)
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define RFFT_VEC         float64x2_t
+#define RFFT_W           2
+#define RFFT_LOAD(p)     vld1q_f64(p)
+#define RFFT_STORE(p,v)  vst1q_f64(p, v)
+#define RFFT_SET1(x)     vdupq_n_f64(x)
+#define RFFT_ADD(a,b)    vaddq_f64(a, b)
+#define RFFT_SUB(a,b)    vsubq_f64(a, b)
+#define RFFT_MUL(a,b)    vmulq_f64(a, b)
+#define RFFT_REVERSE(a)  vextq_f64(a, a, 1)
+#endif
+#endif /* HAVE_AUBIO_DOUBLE */
+
+/* scalar versions of the vector operations, used for short strides */
+#define RFFT_S_LOAD(p)     (*(p))
+#define RFFT_S_STORE(p,v)  (*(p) = (v))
+#define RFFT_S_SET1(x)     (x)
+#define RFFT_S_ADD(a,b)    ((a) + (b))
+#define RFFT_S_SUB(a,b)    ((a) - (b))
+#define RFFT_S_MUL(a,b)    ((a) * (b))
+
+#ifdef RFFT_VEC
+#define RFFT_V_LOAD        RFFT_LOAD
+#define RFFT_V_STORE       RFFT_STORE
+#define RFFT_V_SET1        RFFT_SET1
+#define RFFT_V_ADD         RFFT_ADD
+#define RFFT_V_SUB         RFFT_SUB
+#define RFFT_V_MUL         RFFT_MUL
+#endif
+
+/* The macros below take the prefix P of the operations to use, RFFT_S_ for
+ * scalars or RFFT_V_ for vectors, and the matching type T. */
+
+/* load element k of x into v */
+#define RFFT_LD(P, T, v, k) T v##r = P##LOAD(xr + (k)), v##i = P##LOAD(xi + (k));
+/* store v into element k of y */
+#define RFFT_ST(P, v, k) P##STORE(yr + (k), v##r); P##STORE(yi + (k), v##i);
+/* y = t * w */
+#define RFFT_CMUL(P, T, y, t, w) \
+  T y##r = P##SUB(P##MUL(t##r, w##r), P##MUL(t##i, w##i)); \
+  T y##i = P##ADD(P##MUL(t##r, w##i), P##MUL(t##i, w##r));
+
+/* radix-2 butterfly on a, b */
+#define RFFT_BUTTERFLY2(P, T) \
+  T y0r = P##ADD(ar, br), y0i = P##ADD(ai, bi); \
+  T t1r = P##SUB(ar, br), t1i = P##SUB(ai, bi); \
+  RFFT_CMUL(P, T, y1, t1, w1)
+
+/* radix-3 butterfly on a, b, c, with vk3 = sgn * sin(2 pi / 3) */
+#define RFFT_BUTTERFLY3(P, T) \
+  T t1r = P##ADD(br, cr), t1i = P##ADD(bi, ci); \
+  T t2r = P##SUB(ar, P##MUL(vhalf, t1r)), t2i = P##SUB(ai, P##MUL(vhalf, t1i)); \
+  T ur = P##MUL(vk3, P##SUB(bi, ci)), ui = P##MUL(vk3, P##SUB(cr, br)); \
+  T y0r = P##ADD(ar, t1r), y0i = P##ADD(ai, t1i); \
+  T t3r = P##ADD(t2r, ur), t3i = P##ADD(t2i, ui); \
+  T t4r = P##SUB(t2r, ur), t4i = P##SUB(t2i, ui); \
+  RFFT_CMUL(P, T, y1, t3, w1) \
+  RFFT_CMUL(P, T, y2, t4, w2)
+
+/* radix-4 butterfly on a, b, c, d, with u = -sgn * i * (b - d) */
+#define RFFT_BUTTERFLY4(P, T) \
+  T apcr = P##ADD(ar, cr), apci = P##ADD(ai, ci); \
+  T amcr = P##SUB(ar, cr), amci = P##SUB(ai, ci); \
+  T bpdr = P##ADD(br, dr), bpdi = P##ADD(bi, di); \
+  T ur = P##MUL(vsgn, P##SUB(bi, di)), ui = P##MUL(vsgn, P##SUB(dr, br)); \
+  T y0r = P##ADD(apcr, bpdr), y0i = P##ADD(apci, bpdi); \
+  T t1r = P##ADD(amcr, ur), t1i = P##ADD(amci, ui); \
+  T t2r = P##SUB(apcr, bpdr), t2i = P##SUB(apci, bpdi); \
+  T t3r = P##SUB(amcr, ur), t3i = P##SUB(amci, ui); \
+  RFFT_CMUL(P, T, y1, t1, w1) \
+  RFFT_CMUL(P, T, y2, t2, w2) \
+  RFFT_CMUL(P, T, y3, t3, w3)
+
+/* radix-5 butterfly on a, b, c, d, e, with vc1 = cos(2 pi / 5),
+ * vc2 = cos(4 pi / 5), vs1 = sgn * sin(2 pi / 5), vs2 = sgn * sin(4 pi / 5) */
+#define RFFT_BUTTERFLY5(P, T) \
+  T t1r = P##ADD(br, er), t1i = P##ADD(bi, ei); \
+  T t2r = P##ADD(cr, dr), t2i = P##ADD(ci, di); \
+  T t3r = P##SUB(br, er), t3i = P##SUB(bi, ei); \
+  T t4r = P##SUB(cr, dr), t4i = P##SUB(ci, di); \
+  T y0r = P##ADD(ar, P##ADD(t1r, t2r)), y0i = P##ADD(ai, P##ADD(t1i, t2i)); \
+  T m1r = P##ADD(ar, P##ADD(P##MUL(vc1, t1r), P##MUL(vc2, t2r))); \
+  T m1i = P##ADD(ai, P##ADD(P##MUL(vc1, t1i), P##MUL(vc2, t2i))); \
+  T m2r = P##ADD(ar, P##ADD(P##MUL(vc2, t1r), P##MUL(vc1, t2r))); \
+  T m2i = P##ADD(ai, P##ADD(P##MUL(vc2, t1i), P##MUL(vc1, t2i))); \
+  T n1r = P##ADD(P##MUL(vs1, t3r), P##MUL(vs2, t4r)); \
+  T n1i = P##ADD(P##MUL(vs1, t3i), P##MUL(vs2, t4i)); \
+  T n2r = P##SUB(P##MUL(vs2, t3r), P##MUL(vs1, t4r)); \
+  T n2i = P##SUB(P##MUL(vs2, t3i), P##MUL(vs1, t4i)); \
+  T x1r = P##ADD(m1r, n1i), x1i = P##SUB(m1i, n1r); \
+  T x4r = P##SUB(m1r, n1i), x4i = P##ADD(m1i, n1r); \
+  T x2r = P##ADD(m2r, n2i), x2i = P##SUB(m2i, n2r); \
+  T x3r = P##SUB(m2r, n2i), x3i = P##ADD(m2i, n2r); \
+  RFFT_CMUL(P, T, y1, x1, w1) \
+  RFFT_CMUL(P, T, y2, x2, w2) \
+  RFFT_CMUL(P, T, y3, x3, w3) \
+  RFFT_CMUL(P, T, y4, x4, w4)
+
+/* twiddle j of butterfly p, conjugated for the inverse transform */
+#define RFFT_TW(P, T, j) \
+  T w##j##r = P##SET1(tw[2 * (j - 1) * m + p]); \
+  T w##j##i = P##SET1(sgn * tw[(2 * j - 1) * m + p]);
+
+/* Loop over the butterflies of one pass of radix R, length n and stride s,
+ * from x to y. BODY(P, T, q) computes the butterfly on element q of each
+ * input group. Strides of at least RFFT_W elements use vectors. */
+#ifdef RFFT_VEC
+#define RFFT_PASS(R, BODY) { \
+  uint_t m = n / R, p, q; \
+  for (p = 0; p < m; p++) { \
+    q = 0; \
+    if (s >= RFFT_W) { \
+      for (; q + RFFT_W <= s; q += RFFT_W) { \
+        BODY(RFFT_V_, RFFT_VEC, q) \
+      } \
+    } \
+    for (; q < s; q++) { \
+      BODY(RFFT_S_, smpl_t, q) \
+    } \
+  } \
+}
+#else
+#define RFFT_PASS(R, BODY) { \
+  uint_t m = n / R, p, q; \
+  for (p = 0; p < m; p++) { \
+    for (q = 0; q < s; q++) { \
+      BODY(RFFT_S_, smpl_t, q) \
+    } \
+  } \
+}
+#endif
+
+#define RFFT_BODY2(P, T, q) { \
+  T vsgn = P##SET1(sgn); \
+  RFFT_TW(P, T, 1) \
+  RFFT_LD(P, T, a, q + s * p) \
+  RFFT_LD(P, T, b, q + s * (p + m)) \
+  RFFT_BUTTERFLY2(P, T) \
+  RFFT_ST(P, y0, q + s * 2 * p) \
+  RFFT_ST(P, y1, q + s * (2 * p + 1)) \
+  (void)vsgn; \
+}
+
+#define RFFT_BODY3(P, T, q) { \
+  T vhalf = P##SET1(.5), vk3 = P##SET1(sgn * .86602540378443864676); \
+  RFFT_TW(P, T, 1) RFFT_TW(P, T, 2) \
+  RFFT_LD(P, T, a, q + s * p) \
+  RFFT_LD(P, T, b, q + s * (p + m)) \
+  RFFT_LD(P, T, c, q + s * (p + 2 * m)) \
+  RFFT_BUTTERFLY3(P, T) \
+  RFFT_ST(P, y0, q + s * 3 * p) \
+  RFFT_ST(P, y1, q + s * (3 * p + 1)) \
+  RFFT_ST(P, y2, q + s * (3 * p + 2)) \
+}
+
+#define RFFT_BODY4(P, T, q) { \
+  T vsgn = P##SET1(sgn); \
+  RFFT_TW(P, T, 1) RFFT_TW(P, T, 2) RFFT_TW(P, T, 3) \
+  RFFT_LD(P, T, a, q + s * p) \
+  RFFT_LD(P, T, b, q + s * (p + m)) \
+  RFFT_LD(P, T, c, q + s * (p + 2 * m)) \
+  RFFT_LD(P, T, d, q + s * (p + 3 * m)) \
+  RFFT_BUTTERFLY4(P, T) \
+  RFFT_ST(P, y0, q + s * 4 * p) \
+  RFFT_ST(P, y1, q + s * (4 * p + 1)) \
+  RFFT_ST(P, y2, q + s * (4 * p + 2)) \
+  RFFT_ST(P, y3, q + s * (4 * p + 3)) \
+}
+
+#define RFFT_BODY5(P, T, q) { \
+  T vc1 = P##SET1(.30901699437494742410); \
+  T vc2 = P##SET1(-.80901699437494742410); \
+  T vs1 = P##SET1(sgn * .95105651629515357212); \
+  T vs2 = P##SET1(sgn * .58778525229247312917); \
+  RFFT_TW(P, T, 1) RFFT_TW(P, T, 2) RFFT_TW(P, T, 3) RFFT_TW(P, T, 4) \
+  RFFT_LD(P, T, a, q + s * p) \
+  RFFT_LD(P, T, b, q + s * (p + m)) \
+  RFFT_LD(P, T, c, q + s * (p + 2 * m)) \
+  RFFT_LD(P, T, d, q + s * (p + 3 * m)) \
+  RFFT_LD(P, T, e, q + s * (p + 4 * m)) \
+  RFFT_BUTTERFLY5(P, T) \
+  RFFT_ST(P, y0, q + s * 5 * p) \
+  RFFT_ST(P, y1, q + s * (5 * p + 1)) \
+  RFFT_ST(P, y2, q + s * (5 * p + 2)) \
+  RFFT_ST(P, y3, q + s * (5 * p + 3)) \
+  RFFT_ST(P, y4, q + s * (5 * p + 4)) \
+}
+
+/** maximum number of passes, enough for any 32 bit size */
+#define RFFT_MAX_PASSES 32
+
+struct _aubio_rfft_t {
+  uint_t size;        /**< size of the real transform */
+  uint_t half;        /**< size of the complex transform */
+  uint_t split_mode;  /**< 1 if size is even and the even/odd split is used */
+  uint_t n_passes;    /**< number of passes of the complex transform */
+  uint_t radix[RFFT_MAX_PASSES]; /**< radix of each pass, 2, 3, 4 or 5 */
+  smpl_t *re[2];      /**< real parts of the two work buffers */
+  smpl_t *im[2];      /**< imaginary parts of the two work buffers */
+  smpl_t *tw;         /**< real and imaginary parts of w^jp, 0 < j < radix,
+                           for each pass */
+  smpl_t *split;      /**< cos, then sin, of 2 pi k / size, for the split
+                           step */
+};
+
+aubio_rfft_t *new_aubio_rfft (uint_t size)
+{
+  aubio_rfft_t *s;
+  uint_t n, p, j, k, r, n_tw = 0, n_passes = 0, rest;
+  uint_t radix[RFFT_MAX_PASSES];
+  if (size < 2) {
+    AUBIO_ERR ("rfft: can not create with size %d < 2\n", size);
+    return NULL;
+  }
+  // factorize the size of the complex transform, into 4, at most one 2, 3, 5
+  rest = (size % 2 == 0) ? size / 2 : size;
+  while (rest % 4 == 0) { radix[n_passes++] = 4; rest /= 4; }
+  if (rest % 2 == 0) { radix[n_passes++] = 2; rest /= 2; }
+  while (rest % 3 == 0) { radix[n_passes++] = 3; rest /= 3; }
+  while (rest % 5 == 0) { radix[n_passes++] = 5; rest /= 5; }
+  if (rest != 1) {
+    AUBIO_ERR ("rfft: can only create with sizes of the form "
+        "2^a * 3^b * 5^c, requested %d\n", size);
+    return NULL;
+  }
+  s = AUBIO_NEW (aubio_rfft_t);
+  s->size = size;
+  s->split_mode = (size % 2 == 0);
+  s->half = s->split_mode ? size / 2 : size;
+  s->n_passes = n_passes;
+  s->re[0] = AUBIO_ARRAY (smpl_t, s->half);
+  s->im[0] = AUBIO_ARRAY (smpl_t, s->half);
+  s->re[1] = AUBIO_ARRAY (smpl_t, s->half);
+  s->im[1] = AUBIO_ARRAY (smpl_t, s->half);
+  n = s->half;
+  for (k = 0; k < n_passes; k++) {
+    s->radix[k] = radix[k];
+    n_tw += 2 * (radix[k] - 1) * (n / radix[k]);
+    n /= radix[k];
+  }
+  s->tw = AUBIO_ARRAY (smpl_t, MAX(n_tw, 1));
+  n_tw = 0;
+  n = s->half;
+  for (k = 0; k < n_passes; k++) {
+    uint_t m;
+    r = radix[k];
+    m = n / r;
+    for (j = 1; j < r; j++) {
+      for (p = 0; p < m; p++) {
+        double phase = TWO_PI * (double)(j * p) / (double)n;
+        s->tw[n_tw + 2 * (j - 1) * m + p] = (smpl_t)cos (phase);
+        s->tw[n_tw + (2 * j - 1) * m + p] = (smpl_t)-sin (phase);
+      }
+    }
+    n_tw += 2 * (r - 1) * m;
+    n = m;
+  }
+  if (s->split_mode) {
+    s->split = AUBIO_ARRAY (smpl_t, 2 * s->half);
+    for (k = 0; k < s->half; k++) {
+      double phase = TWO_PI * (double)k / (double)size;
+      s->split[k] = (smpl_t)cos (phase);
+      s->split[s->half + k] = (smpl_t)sin (phase);
+    }
+  }
+  return s;
+}
+
+void del_aubio_rfft (aubio_rfft_t *s)
+{
+  AUBIO_FREE (s->re[0]);
+  AUBIO_FREE (s->im[0]);
+  AUBIO_FREE (s->re[1]);
+  AUBIO_FREE (s->im[1]);
+  AUBIO_FREE (s->tw);
+  if (s->split) AUBIO_FREE (s->split);
+  AUBIO_FREE (s);
+}
+
+uint_t aubio_rfft_get_memory_usage (const aubio_rfft_t *s)
+{
+  return aubio_malloc_size (s) + aubio_malloc_size (s->re[0])
+    + aubio_malloc_size (s->im[0]) + aubio_malloc_size (s->re[1])
+    + aubio_malloc_size (s->im[1]) + aubio_malloc_size (s->tw)
+    + aubio_malloc_size (s->split);
+}
+
+static void aubio_rfft_pass2 (uint_t n, uint_t s, const smpl_t *tw,
+    smpl_t sgn, const smpl_t *xr, const smpl_t *xi, smpl_t *yr, smpl_t *yi)
+RFFT_PASS(2, RFFT_BODY2)
+
+static void aubio_rfft_pass3 (uint_t n, uint_t s, const smpl_t *tw,
+    smpl_t sgn, const smpl_t *xr, const smpl_t *xi, smpl_t *yr, smpl_t *yi)
+RFFT_PASS(3, RFFT_BODY3)
+
+static void aubio_rfft_pass5 (uint_t n, uint_t s, const smpl_t *tw,
+    smpl_t sgn, const smpl_t *xr, const smpl_t *xi, smpl_t *yr, smpl_t *yi)
+RFFT_PASS(5, RFFT_BODY5)
+
+static void aubio_rfft_pass4 (uint_t n, uint_t s, const smpl_t *tw,
+    smpl_t sgn, const smpl_t *xr, const smpl_t *xi, smpl_t *yr, smpl_t *yi)
+{
+#ifdef RFFT_TRANSPOSE4
+  uint_t m = n / 4, p;
+  // first pass: vectorize over p, then transpose the results into place
+  if (s == 1 && m % RFFT_W == 0) {
+    RFFT_VEC vsgn = RFFT_SET1(sgn);
+    for (p = 0; p < m; p += RFFT_W) {
+      RFFT_VEC w1r = RFFT_LOAD(tw + p);
+      RFFT_VEC w1i = RFFT_MUL(vsgn, RFFT_LOAD(tw + m + p));
+      RFFT_VEC w2r = RFFT_LOAD(tw + 2 * m + p);
+      RFFT_VEC w2i = RFFT_MUL(vsgn, RFFT_LOAD(tw + 3 * m + p));
+      RFFT_VEC w3r = RFFT_LOAD(tw + 4 * m + p);
+      RFFT_VEC w3i = RFFT_MUL(vsgn, RFFT_LOAD(tw + 5 * m + p));
+      RFFT_LD(RFFT_V_, RFFT_VEC, a, p)
+      RFFT_LD(RFFT_V_, RFFT_VEC, b, p + m)
+      RFFT_LD(RFFT_V_, RFFT_VEC, c, p + 2 * m)
+      RFFT_LD(RFFT_V_, RFFT_VEC, d, p + 3 * m)
+      RFFT_BUTTERFLY4(RFFT_V_, RFFT_VEC)
+      RFFT_TRANSPOSE4(y0r, y1r, y2r, y3r);
+      RFFT_TRANSPOSE4(y0i, y1i, y2i, y3i);
+      RFFT_ST(RFFT_V_, y0, 4 * p)
+      RFFT_ST(RFFT_V_, y1, 4 * p + 4)
+      RFFT_ST(RFFT_V_, y2, 4 * p + 8)
+      RFFT_ST(RFFT_V_, y3, 4 * p + 12)
+    }
+    return;
+  }
+#endif
+  RFFT_PASS(4, RFFT_BODY4)
+}
+
+/* complex transform of the data in buffer 0, returns the index of the buffer
+ * holding the result; sgn is 1 for the forward transform, -1 for the inverse */
+static uint_t aubio_rfft_complex (aubio_rfft_t *s, smpl_t sgn)
+{
+  uint_t k, n = s->half, stride = 1, cur = 0;
+  const smpl_t *tw = s->tw;
+  for (k = 0; k < s->n_passes; k++) {
+    uint_t r = s->radix[k];
+    const smpl_t *xr = s->re[cur], *xi = s->im[cur];
+    smpl_t *yr = s->re[1 - cur], *yi = s->im[1 - cur];
+    switch (r) {
+      case 2:
+        aubio_rfft_pass2 (n, stride, tw, sgn, xr, xi, yr, yi);
+        break;
+      case 3:
+        aubio_rfft_pass3 (n, stride, tw, sgn, xr, xi, yr, yi);
+        break;
+      case 4:
+        aubio_rfft_pass4 (n, stride, tw, sgn, xr, xi, yr, yi);
+        break;
+      default:
+        aubio_rfft_pass5 (n, stride, tw, sgn, xr, xi, yr, yi);
+        break;
+    }
+    tw += 2 * (r - 1) * (n / r);
+    n /= r;
+    stride *= r;
+    cur = 1 - cur;
+  }
+  return cur;
+}
+
+void aubio_rfft_forward (aubio_rfft_t *s, const smpl_t *input,
+    smpl_t *compspec)
+{
+  uint_t k, cur, half = s->half, size = s->size;
+  const smpl_t *zr, *zi;
+  if (!s->split_mode) {
+    // odd size, transform the real signal directly
+    for (k = 0; k < size; k++) {
+      s->re[0][k] = input[k];
+      s->im[0][k] = 0.;
+    }
+    cur = aubio_rfft_complex (s, 1.);
+    zr = s->re[cur];
+    zi = s->im[cur];
+    compspec[0] = zr[0];
+    for (k = 1; k <= size / 2; k++) {
+      compspec[k] = zr[k];
+      compspec[size - k] = zi[k];
+    }
+    return;
+  }
+  // pack even and odd samples as real and imaginary parts
+  k = 0;
+#ifdef RFFT_DEINTERLEAVE
+  for (; k + RFFT_W <= half; k += RFFT_W) {
+    RFFT_VEC ev, od;
+    RFFT_DEINTERLEAVE(input + 2 * k, ev, od);
+    RFFT_STORE(s->re[0] + k, ev);
+    RFFT_STORE(s->im[0] + k, od);
+  }
+#endif
+  for (; k < half; k++) {
+    s->re[0][k] = input[2 * k];
+    s->im[0][k] = input[2 * k + 1];
+  }
+  cur = aubio_rfft_complex (s, 1.);
+  zr = s->re[cur];
+  zi = s->im[cur];
+  // split the spectra of even and odd samples, X = Fe + W^k Fo
+  compspec[0] = zr[0] + zi[0];
+  compspec[half] = zr[0] - zi[0];
+  k = 1;
+#ifdef RFFT_VEC
+  {
+    RFFT_VEC vhalf = RFFT_SET1(.5);
+    for (; k + RFFT_W <= half; k += RFFT_W) {
+      uint_t mk = half - k - (RFFT_W - 1);
+      RFFT_VEC c = RFFT_LOAD(s->split + k), sn = RFFT_LOAD(s->split + half + k);
+      RFFT_VEC ar = RFFT_LOAD(zr + k), ai = RFFT_LOAD(zi + k);
+      RFFT_VEC br = RFFT_REVERSE(RFFT_LOAD(zr + mk));
+      RFFT_VEC bi = RFFT_REVERSE(RFFT_LOAD(zi + mk));
+      RFFT_VEC fe_r = RFFT_MUL(vhalf, RFFT_ADD(ar, br));
+      RFFT_VEC fe_i = RFFT_MUL(vhalf, RFFT_SUB(ai, bi));
+      RFFT_VEC fo_r = RFFT_MUL(vhalf, RFFT_ADD(ai, bi));
+      RFFT_VEC fo_i = RFFT_MUL(vhalf, RFFT_SUB(br, ar));
+      RFFT_VEC xi = RFFT_SUB(RFFT_ADD(fe_i, RFFT_MUL(c, fo_i)),
+          RFFT_MUL(sn, fo_r));
+      RFFT_STORE(compspec + k, RFFT_ADD(RFFT_ADD(fe_r, RFFT_MUL(c, fo_r)),
+            RFFT_MUL(sn, fo_i)));
+      RFFT_STORE(compspec + size - k - (RFFT_W - 1), RFFT_REVERSE(xi));
+    }
+  }
+#endif
+  for (; k < half; k++) {
+    smpl_t c = s->split[k], sn = s->split[half + k];
+    smpl_t fe_r = .5 * (zr[k] + zr[half - k]);
+    smpl_t fe_i = .5 * (zi[k] - zi[half - k]);
+    smpl_t fo_r = .5 * (zi[k] + zi[half - k]);
+    smpl_t fo_i = -.5 * (zr[k] - zr[half - k]);
+    compspec[k] = fe_r + c * fo_r + sn * fo_i;
+    compspec[size - k] = fe_i + c * fo_i - sn * fo_r;
+  }
+}
+
+void aubio_rfft_backward (aubio_rfft_t *s, const smpl_t *compspec,
+    smpl_t *output)
+{
+  uint_t k, cur, half = s->half, size = s->size;
+  smpl_t scale = 1. / size;
+  const smpl_t *zr, *zi;
+  if (!s->split_mode) {
+    // odd size, rebuild the hermitian spectrum
+    s->re[0][0] = compspec[0];
+    s->im[0][0] = 0.;
+    for (k = 1; k <= size / 2; k++) {
+      s->re[0][k] = s->re[0][size - k] = compspec[k];
+      s->im[0][k] = compspec[size - k];
+      s->im[0][size - k] = -compspec[size - k];
+    }
+    cur = aubio_rfft_complex (s, -1.);
+    zr = s->re[cur];
+    for (k = 0; k < size; k++) {
+      output[k] = zr[k] * scale;
+    }
+    return;
+  }
+  // merge the spectra of even and odd samples, Z = Fe + i Fo
+  s->re[0][0] = compspec[0] + compspec[half];
+  s->im[0][0] = compspec[0] - compspec[half];
+  k = 1;
+#ifdef RFFT_VEC
+  for (; k + RFFT_W <= half; k += RFFT_W) {
+    RFFT_VEC c = RFFT_LOAD(s->split + k), sn = RFFT_LOAD(s->split + half + k);
+    RFFT_VEC xr = RFFT_LOAD(compspec + k);
+    RFFT_VEC xi = RFFT_REVERSE(RFFT_LOAD(compspec + size - k - (RFFT_W - 1)));
+    RFFT_VEC yr = RFFT_REVERSE(RFFT_LOAD(compspec + half - k - (RFFT_W - 1)));
+    RFFT_VEC nyi = RFFT_LOAD(compspec + half + k);
+    RFFT_VEC fe_r = RFFT_ADD(xr, yr), fe_i = RFFT_SUB(xi, nyi);
+    RFFT_VEC dr = RFFT_SUB(xr, yr), di = RFFT_ADD(xi, nyi);
+    RFFT_VEC fo_r = RFFT_SUB(RFFT_MUL(dr, c), RFFT_MUL(di, sn));
+    RFFT_VEC fo_i = RFFT_ADD(RFFT_MUL(dr, sn), RFFT_MUL(di, c));
+    RFFT_STORE(s->re[0] + k, RFFT_SUB(fe_r, fo_i));
+    RFFT_STORE(s->im[0] + k, RFFT_ADD(fe_i, fo_r));
+  }
+#endif
+  for (; k < half; k++) {
+    smpl_t c = s->split[k], sn = s->split[half + k];
+    smpl_t xr = compspec[k], xi = compspec[size - k];
+    smpl_t yr = compspec[half - k], yi = -compspec[half + k];
+    smpl_t fe_r = xr + yr, fe_i = xi + yi;
+    smpl_t dr = xr - yr, di = xi - yi;
+    smpl_t fo_r = dr * c - di * sn, fo_i = dr * sn + di * c;
+    s->re[0][k] = fe_r - fo_i;
+    s->im[0][k] = fe_i + fo_r;
+  }
+  cur = aubio_rfft_complex (s, -1.);
+  zr = s->re[cur];
+  zi = s->im[cur];
+  k = 0;
+#ifdef RFFT_INTERLEAVE
+  {
+    RFFT_VEC vscale = RFFT_SET1(scale);
+    for (; k + RFFT_W <= half; k += RFFT_W) {
+      RFFT_VEC ev = RFFT_MUL(RFFT_LOAD(zr + k), vscale);
+      RFFT_VEC od = RFFT_MUL(RFFT_LOAD(zi + k), vscale);
+      RFFT_INTERLEAVE(output + 2 * k, ev, od);
+    }
+  }
+#endif
+  for (; k < half; k++) {
+    output[2 * k] = zr[k] * scale;
+    output[2 * k + 1] = zi[k] * scale;
+  }
+}
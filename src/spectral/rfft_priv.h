@@ -0,0 +1,57 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Built-in real FFT, used by spectral/fft.c when HAVE_AUBIO_RFFT is defined,
+   and for the sizes the other backends do not support.
+
+   A real transform of even size N is computed as a complex transform of size
+   N/2 on the even/odd samples, followed by a split step; odd sizes use a
+   complex transform of size N. The complex transform is a mixed radix 4, 2,
+   3 and 5 Stockham transform working on separate real and imaginary arrays,
+   so that its butterflies run on SSE2 or NEON vectors once the stride of a
+   pass is large enough.
+
+   Sizes of the form 2^a * 3^b * 5^c are supported, for instance 1920.
+*/
+
+#ifndef AUBIO_RFFT_PRIV_H
+#define AUBIO_RFFT_PRIV_H
+
+/** built-in real fft object */
+typedef struct _aubio_rfft_t aubio_rfft_t;
+
+/** create a real fft object of size 2^a * 3^b * 5^c, or return NULL */
+aubio_rfft_t *new_aubio_rfft (uint_t size);
+
+/** delete a real fft object */
+void del_aubio_rfft (aubio_rfft_t *s);
+
+/** get the number of bytes allocated by a real fft object */
+uint_t aubio_rfft_get_memory_usage (const aubio_rfft_t *s);
+
+/** forward transform of size samples into [ r0, r1, ..., rN, iN-1, .., i1] */
+void aubio_rfft_forward (aubio_rfft_t *s, const smpl_t *input,
+    smpl_t *compspec);
+
+/** inverse transform of compspec, scaled so that it inverts the forward one */
+void aubio_rfft_backward (aubio_rfft_t *s, const smpl_t *compspec,
+    smpl_t *output);
+
+#endif /* AUBIO_RFFT_PRIV_H */
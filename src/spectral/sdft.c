@@ -0,0 +1,241 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "spectral/sdft.h"
+#include "utils/simd_priv.h"
+
+/** the bins are computed again from the past window after this many
+ * windows, before rounding errors add up */
+#define AUBIO_SDFT_RESYNC 4
+
+struct _aubio_sdft_t
+{
+  uint_t n_bins;        /**< number of bins */
+  uint_t n_lanes;       /**< n_bins rounded to the simd block */
+  uint_t win_s;         /**< length of the window */
+  uint_t samplerate;
+  fvec_t *freqs;        /**< frequency of each bin */
+  fvec_t *coefs;        /**< real and imaginary parts of w, then of c, see
+                             aubio_simd_ops_t.sdft */
+  fvec_t *state;        /**< real then imaginary parts of each bin */
+  fvec_t *ring;         /**< last win_s samples */
+  uint_t pos;           /**< oldest sample of ring, replaced by the next one */
+  uint_t elapsed;       /**< samples since the bins were last computed
+                             from ring */
+  smpl_t **rows;        /**< output rows given to the kernel */
+  fvec_t *scratch;      /**< output of the padding lanes */
+};
+
+/* value of a bin over the past window, the sum of w^m x[-m] from the newest
+   sample, computed directly */
+static void
+aubio_sdft_sync_bin (aubio_sdft_t * o, uint_t bin)
+{
+  uint_t m, l = o->n_lanes, n = o->win_s;
+  lsmp_t omega = 2. * PI * o->freqs->data[bin] / o->samplerate;
+  lsmp_t wr = COS (omega), wi = - SIN (omega);
+  lsmp_t re = 0., im = 0., pr = 1., pi = 0., tmp;
+  for (m = 0; m < n; m++) {
+    smpl_t x = o->ring->data[(o->pos + n - 1 - m) % n];
+    re += pr * x;
+    im += pi * x;
+    tmp = pr * wr - pi * wi;
+    pi = pr * wi + pi * wr;
+    pr = tmp;
+  }
+  o->state->data[bin] = re;
+  o->state->data[l + bin] = im;
+}
+
+/* coefficients of a bin, w = e^(-i omega) and c = e^(-i omega n) */
+static void
+aubio_sdft_init_bin (aubio_sdft_t * o, uint_t bin)
+{
+  uint_t l = o->n_lanes, n = o->win_s;
+  lsmp_t omega = 2. * PI * o->freqs->data[bin] / o->samplerate;
+  o->coefs->data[bin] = COS (omega);
+  o->coefs->data[l + bin] = - SIN (omega);
+  o->coefs->data[2 * l + bin] = COS (omega * n);
+  o->coefs->data[3 * l + bin] = - SIN (omega * n);
+  aubio_sdft_sync_bin (o, bin);
+}
+
+aubio_sdft_t *
+new_aubio_sdft (uint_t n_bins, uint_t win_s, uint_t samplerate)
+{
+  aubio_sdft_t *o = AUBIO_NEW (aubio_sdft_t);
+  uint_t k;
+  if (!o) return NULL;
+  if ((sint_t)n_bins < 1) {
+    AUBIO_ERR ("sdft: got %d bins, but can not be < 1\n", n_bins);
+    goto beach;
+  }
+  if ((sint_t)win_s < 2) {
+    AUBIO_ERR ("sdft: got win_s %d, but can not be < 2\n", win_s);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 1) {
+    AUBIO_ERR ("sdft: samplerate (%d) can not be < 1\n", samplerate);
+    goto beach;
+  }
+  o->n_bins = n_bins;
+  o->n_lanes = (n_bins + AUBIO_SIMD_SDFT_BLOCK - 1)
+    / AUBIO_SIMD_SDFT_BLOCK * AUBIO_SIMD_SDFT_BLOCK;
+  o->win_s = win_s;
+  o->samplerate = samplerate;
+  o->freqs = new_fvec (n_bins);
+  o->coefs = new_fvec (4 * o->n_lanes);
+  o->state = new_fvec (2 * o->n_lanes);
+  o->ring = new_fvec (win_s);
+  o->rows = AUBIO_ARRAY (smpl_t *, o->n_lanes);
+  o->scratch = new_fvec (win_s);
+  if (!o->freqs || !o->coefs || !o->state || !o->ring || !o->rows
+      || !o->scratch) goto beach;
+  for (k = 0; k < n_bins; k++) {
+    o->freqs->data[k] = MIN ((k + 1.) * samplerate / win_s, samplerate / 2.);
+    aubio_sdft_init_bin (o, k);
+  }
+  // the padding lanes stay at 0
+  for (k = n_bins; k < o->n_lanes; k++) {
+    o->rows[k] = o->scratch->data;
+  }
+  return o;
+beach:
+  del_aubio_sdft (o);
+  return NULL;
+}
+
+/* run the kernel on the input, in runs of contiguous past samples, writing
+   the power of each bin to the rows of output if it is not NULL */
+static void
+aubio_sdft_run (aubio_sdft_t * o, const fvec_t * input, fmat_t * output)
+{
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  uint_t k, done = 0;
+  while (done < input->length) {
+    uint_t len = MIN (input->length - done, o->win_s - o->pos);
+    const smpl_t *x = input->data + done;
+    if (o->elapsed >= AUBIO_SDFT_RESYNC * o->win_s) {
+      for (k = 0; k < o->n_bins; k++) {
+        aubio_sdft_sync_bin (o, k);
+      }
+      o->elapsed = 0;
+    }
+    if (output) {
+      for (k = 0; k < o->n_bins; k++) {
+        o->rows[k] = output->data[k] + done;
+      }
+    }
+    ops->sdft (x, o->ring->data + o->pos, len, o->coefs->data,
+        o->state->data, o->n_lanes, output ? o->rows : NULL);
+    AUBIO_MEMCPY (o->ring->data + o->pos, x, len * sizeof(smpl_t));
+    o->pos = (o->pos + len) % o->win_s;
+    done += len;
+    o->elapsed += len;
+  }
+}
+
+void
+aubio_sdft_do (aubio_sdft_t * o, const fvec_t * input, fvec_t * output)
+{
+  uint_t k, l = o->n_lanes;
+  smpl_t scale = 2. / o->win_s;
+  if (output->length != o->n_bins) {
+    AUBIO_ERR ("sdft: expected an output of %d bins, got %d\n", o->n_bins,
+        output->length);
+    return;
+  }
+  aubio_sdft_run (o, input, NULL);
+  for (k = 0; k < o->n_bins; k++) {
+    smpl_t re = o->state->data[k], im = o->state->data[l + k];
+    output->data[k] = scale * SQRT (re * re + im * im);
+  }
+}
+
+void
+aubio_sdft_do_all (aubio_sdft_t * o, const fvec_t * input, fmat_t * output)
+{
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  uint_t k;
+  if (output->height != o->n_bins || output->length != input->length) {
+    AUBIO_ERR ("sdft: expected an output of %d rows of %d samples, got %d"
+        " rows of %d\n", o->n_bins, input->length, output->height,
+        output->length);
+    return;
+  }
+  aubio_sdft_run (o, input, output);
+  for (k = 0; k < o->n_bins; k++) {
+    ops->vsqrt (output->data[k], output->length);
+    ops->mul (output->data[k], 2. / o->win_s, output->length);
+  }
+}
+
+uint_t
+aubio_sdft_set_freq (aubio_sdft_t * o, uint_t bin, smpl_t freq)
+{
+  if (bin >= o->n_bins) {
+    AUBIO_ERR ("sdft: bin %d out of range\n", bin);
+    return AUBIO_FAIL;
+  }
+  if (!(freq >= 0. && freq <= o->samplerate / 2.)) {
+    AUBIO_ERR ("sdft: frequency %f out of range\n", freq);
+    return AUBIO_FAIL;
+  }
+  o->freqs->data[bin] = freq;
+  aubio_sdft_init_bin (o, bin);
+  return AUBIO_OK;
+}
+
+smpl_t
+aubio_sdft_get_freq (const aubio_sdft_t * o, uint_t bin)
+{
+  if (bin >= o->n_bins) return 0.;
+  return o->freqs->data[bin];
+}
+
+uint_t
+aubio_sdft_get_n_bins (const aubio_sdft_t * o)
+{
+  return o->n_bins;
+}
+
+void
+aubio_sdft_reset (aubio_sdft_t * o)
+{
+  fvec_zeros (o->state);
+  fvec_zeros (o->ring);
+  o->pos = 0;
+  o->elapsed = 0;
+}
+
+void
+del_aubio_sdft (aubio_sdft_t * o)
+{
+  if (o->freqs) del_fvec (o->freqs);
+  if (o->coefs) del_fvec (o->coefs);
+  if (o->state) del_fvec (o->state);
+  if (o->ring) del_fvec (o->ring);
+  if (o->rows) AUBIO_FREE (o->rows);
+  if (o->scratch) del_fvec (o->scratch);
+  AUBIO_FREE (o);
+}
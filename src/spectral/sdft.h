@@ -0,0 +1,140 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Sliding DFT bank
+
+  This object tracks the magnitude of a few frequencies, updated at every
+  sample, for instance the bands of a kick and a snare, at a fraction of the
+  cost of a full aubio_pvoc_t at each hop.
+
+  Each bin is the discrete Fourier transform, at its own frequency, of the
+  last `win_s` samples, without window. It is updated recursively with each
+  new sample, for a few multiplications per bin. So that rounding errors can
+  not add up, the bins are computed again directly from the past samples
+  every few windows, for about one more multiplication per bin every four
+  samples.
+
+  The bins are computed in parallel on the lanes of the vector units.
+
+  \example spectral/test-sdft.c
+
+*/
+
+#ifndef AUBIO_SDFT_H
+#define AUBIO_SDFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** sliding DFT bank object */
+typedef struct _aubio_sdft_t aubio_sdft_t;
+
+/** create a sliding DFT bank
+
+  \param n_bins number of bins
+  \param win_s length of the window, in samples
+  \param samplerate samplerate of the signal
+
+  \return the newly created object, or NULL on failure
+
+  Bin `k` starts at `(k + 1) * samplerate / win_s`, see aubio_sdft_set_freq().
+
+*/
+aubio_sdft_t *new_aubio_sdft (uint_t n_bins, uint_t win_s, uint_t samplerate);
+
+/** update the bins with new samples
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+  \param input new samples, of any length
+  \param output magnitude of each bin after the last sample, of length
+  `n_bins`
+
+  A sine of amplitude 1, with a whole number of periods in the window, gives
+  a magnitude of 1 in the bin at its frequency.
+
+*/
+void aubio_sdft_do (aubio_sdft_t * o, const fvec_t * input, fvec_t * output);
+
+/** update the bins with new samples, and get their magnitude at each sample
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+  \param input new samples, of any length
+  \param output magnitude of each bin, one row per bin, after each sample of
+  `input`, with `n_bins` rows of `input->length` samples
+
+*/
+void aubio_sdft_do_all (aubio_sdft_t * o, const fvec_t * input,
+    fmat_t * output);
+
+/** set the frequency of a bin
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+  \param bin index of the bin
+  \param freq frequency, in Hz, between 0 and half the samplerate
+
+  \return 0 if successful, non-zero otherwise
+
+  The bin is computed again over the past window, so that the next output is
+  exact.
+
+*/
+uint_t aubio_sdft_set_freq (aubio_sdft_t * o, uint_t bin, smpl_t freq);
+
+/** get the frequency of a bin
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+  \param bin index of the bin
+
+  \return frequency of the bin, in Hz, or 0 if bin is out of range
+
+*/
+smpl_t aubio_sdft_get_freq (const aubio_sdft_t * o, uint_t bin);
+
+/** get the number of bins
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+
+  \return number of bins
+
+*/
+uint_t aubio_sdft_get_n_bins (const aubio_sdft_t * o);
+
+/** clear the past input of the bank
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+
+*/
+void aubio_sdft_reset (aubio_sdft_t * o);
+
+/** delete a sliding DFT bank
+
+  \param o sliding DFT bank as returned by new_aubio_sdft()
+
+*/
+void del_aubio_sdft (aubio_sdft_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_SDFT_H */
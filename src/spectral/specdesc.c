@@ -21,10 +21,13 @@
 #include "aubio_priv.h"
 #include "fvec.h"
 #include "cvec.h"
+#include "fmat.h"
+#include "spectral/gpu.h"
 #include "spectral/fft.h"
 #include "spectral/specdesc.h"
 #include "mathutils.h"
 #include "utils/hist.h"
+#include "utils/simd_priv.h"
 
 void aubio_specdesc_energy(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset);
 void aubio_specdesc_hfc(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset);
@@ -35,6 +38,7 @@ void aubio_specdesc_specdiff(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_
 void aubio_specdesc_kl(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset);
 void aubio_specdesc_mkl(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset);
 void aubio_specdesc_specflux(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset);
+void aubio_specdesc_superflux(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset);
 
 extern void aubio_specdesc_centroid (aubio_specdesc_t * o, const cvec_t * spec,
     fvec_t * desc);
@@ -62,6 +66,8 @@ typedef enum {
         aubio_onset_kl,             /**< Kullback Liebler */
         aubio_onset_mkl,            /**< modified Kullback Liebler */
         aubio_onset_specflux,       /**< spectral flux */
+        aubio_onset_superflux,      /**< spectral flux with vibrato
+                                         suppression */
         aubio_specmethod_centroid,  /**< spectral centroid */
         aubio_specmethod_spread,    /**< spectral spread */
         aubio_specmethod_skewness,  /**< spectral skewness */
@@ -84,27 +90,30 @@ struct _aubio_specdesc_t {
   fvec_t *theta1;        /**< previous phase vector, one frame behind */
   fvec_t *theta2;        /**< previous phase vector, two frames behind */
   aubio_hist_t * histog; /**< histogram */
+  uint_t n_bands;        /**< number of log bands, for superflux */
+  uint_t *band;          /**< lower band of each bin */
+  fvec_t *band_weight;   /**< weight of each bin in the band above */
+  fvec_t *band_scale;    /**< inverse of the total weight of each band */
+  fvec_t *maxfilt;       /**< buffer of the maximum filter */
 };
 
+/** bands per octave of the superflux filterbank */
+#define AUBIO_SUPERFLUX_BANDS_PER_OCTAVE 24
+/** half width of the superflux maximum filter, in bands */
+#define AUBIO_SUPERFLUX_RADIUS 1
+
 
 /* Energy based onset detection function */
 void aubio_specdesc_energy  (aubio_specdesc_t *o UNUSED,
     const cvec_t * fftgrain, fvec_t * onset) {
-  uint_t j;
-  onset->data[0] = 0.;
-  for (j=0;j<fftgrain->length;j++) {
-    onset->data[0] += SQR(fftgrain->norm[j]);
-  }
+  onset->data[0] = AUBIO_SIMD()->dot(fftgrain->norm, fftgrain->norm,
+      fftgrain->length);
 }
 
 /* High Frequency Content onset detection function */
 void aubio_specdesc_hfc(aubio_specdesc_t *o UNUSED,
     const cvec_t * fftgrain, fvec_t * onset){
-  uint_t j;
-  onset->data[0] = 0.;
-  for (j=0;j<fftgrain->length;j++) {
-    onset->data[0] += (j+1)*fftgrain->norm[j];
-  }
+  onset->data[0] = AUBIO_SIMD()->ramp_dot(fftgrain->norm, fftgrain->length);
 }
 
 
@@ -181,19 +190,10 @@ aubio_specdesc_wphase(aubio_specdesc_t *o,
 /* Spectral difference method onset detection function */
 void aubio_specdesc_specdiff(aubio_specdesc_t *o,
     const cvec_t * fftgrain, fvec_t * onset){
-  uint_t j;
-  uint_t nbins = fftgrain->length;
     onset->data[0] = 0.0;
-    for (j=0;j<nbins; j++)  {
-      o->dev1->data[j] = SQRT(
-          ABS(SQR( fftgrain->norm[j])
-            - SQR(o->oldmag->data[j])));
-      if (o->threshold < fftgrain->norm[j] )
-        o->dev1->data[j] = ABS(o->dev1->data[j]);
-      else 
-        o->dev1->data[j] = 0.0;
-      o->oldmag->data[j] = fftgrain->norm[j];
-    }
+    /* sqrt(|norm^2 - oldmag^2|) on the bins above threshold */
+    AUBIO_SIMD()->sqdev(fftgrain->norm, o->oldmag->data, o->dev1->data,
+        o->threshold, fftgrain->length);
 
     /* apply o->histogram (act somewhat as a low pass on the
      * overall function)*/
@@ -206,15 +206,11 @@ void aubio_specdesc_specdiff(aubio_specdesc_t *o,
 
 /* Kullback Liebler onset detection function
  * note we use ln(1+Xn/(Xn-1+0.0001)) to avoid 
- * negative (1.+) and infinite values (+1.e-10) */
+ * negative (1.+) and infinite values (+1.e-10)
+ * the log is approximated, see aubio_simd_ops_t.vlog */
 void aubio_specdesc_kl(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset){
-  uint_t j;
-    onset->data[0] = 0.;
-    for (j=0;j<fftgrain->length;j++) {
-      onset->data[0] += fftgrain->norm[j]
-        *LOG(1.+fftgrain->norm[j]/(o->oldmag->data[j]+1.e-1));
-      o->oldmag->data[j] = fftgrain->norm[j];
-    }
+    onset->data[0] = AUBIO_SIMD()->kl(fftgrain->norm, o->oldmag->data, 1,
+        fftgrain->length);
     if (isnan(onset->data[0])) onset->data[0] = 0.;
 }
 
@@ -222,85 +218,160 @@ void aubio_specdesc_kl(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * on
  * note we use ln(1+Xn/(Xn-1+0.0001)) to avoid 
  * negative (1.+) and infinite values (+1.e-10) */
 void aubio_specdesc_mkl(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset){
-  uint_t j;
-    onset->data[0] = 0.;
-    for (j=0;j<fftgrain->length;j++) {
-      onset->data[0] += LOG(1.+fftgrain->norm[j]/(o->oldmag->data[j]+1.e-1));
-      o->oldmag->data[j] = fftgrain->norm[j];
-    }
+    onset->data[0] = AUBIO_SIMD()->kl(fftgrain->norm, o->oldmag->data, 0,
+        fftgrain->length);
     if (isnan(onset->data[0])) onset->data[0] = 0.;
 }
 
 /* Spectral flux */
 void aubio_specdesc_specflux(aubio_specdesc_t *o, const cvec_t * fftgrain, fvec_t * onset){ 
-  uint_t j;
-  onset->data[0] = 0.;
-  for (j=0;j<fftgrain->length;j++) {
-    if (fftgrain->norm[j] > o->oldmag->data[j])
-      onset->data[0] += fftgrain->norm[j] - o->oldmag->data[j];
-    o->oldmag->data[j] = fftgrain->norm[j];
+  onset->data[0] = AUBIO_SIMD()->flux(fftgrain->norm, o->oldmag->data,
+      fftgrain->length);
+}
+
+/* SuperFlux (Boeck and Widmer, DAFx 2013): flux of the log magnitudes of
+ * bands spaced by a quarter tone, against the previous frame widened by a
+ * maximum filter across the bands, so that partials moving by less than a
+ * band, as with vibrato, cancel out */
+void aubio_specdesc_superflux(aubio_specdesc_t *o, const cvec_t * fftgrain,
+    fvec_t * onset) {
+  smpl_t *bands = o->dev1->data, *weight = o->band_weight->data;
+  uint_t j, length = MIN (fftgrain->length, o->band_weight->length);
+  fvec_zeros (o->dev1);
+  for (j = 1; j < length; j++) {
+    smpl_t x = fftgrain->norm[j];
+    bands[o->band[j]] += x - weight[j] * x;
+    bands[o->band[j] + 1] += weight[j] * x;
+  }
+  /* log(1 + mean magnitude) of each band */
+  AUBIO_SIMD()->weight (bands, o->band_scale->data, o->n_bands);
+  AUBIO_SIMD()->add (bands, 1., o->n_bands);
+  AUBIO_SIMD()->vlog (bands, o->n_bands);
+  onset->data[0] = AUBIO_SIMD()->flux (bands, o->oldmag->data, o->n_bands);
+  AUBIO_SIMD()->maxfilt (o->oldmag->data, o->oldmag->data, o->maxfilt->data,
+      AUBIO_SUPERFLUX_RADIUS, o->n_bands);
+}
+
+/* one band per bin up to the bin where the bands of a quarter tone get wider
+ * than a bin, then logarithmically spaced bands; each bin is shared between
+ * the two bands around it, with triangular weights. Only the lower band and
+ * the weight of each bin are stored, rather than a full filterbank. */
+static uint_t
+aubio_specdesc_superflux_init (aubio_specdesc_t *o, uint_t rsize)
+{
+  smpl_t ratio = POW (2., 1. / AUBIO_SUPERFLUX_BANDS_PER_OCTAVE);
+  smpl_t center = 1., next;
+  uint_t j, b = 0;
+  /* count the bands, each center at least one bin above the previous one */
+  o->n_bands = 1;
+  for (next = 1.; ; o->n_bands++) {
+    next = MAX (next + 1., FLOOR (next * ratio + .5));
+    if (next > rsize - 1) break;
+  }
+  o->band = AUBIO_ARRAY (uint_t, rsize);
+  o->band_weight = new_fvec (rsize);
+  /* the highest bins only weigh in the last band, the one above is unused */
+  o->band_scale = new_fvec (o->n_bands + 1);
+  o->maxfilt = new_fvec (2 * (o->n_bands + 2 * AUBIO_SUPERFLUX_RADIUS));
+  o->oldmag = new_fvec (o->n_bands);
+  o->dev1 = new_fvec (o->n_bands + 1);
+  if (!o->band || !o->band_weight || !o->band_scale || !o->maxfilt
+      || !o->oldmag || !o->dev1) {
+    return AUBIO_FAIL;
   }
+  next = MAX (center + 1., FLOOR (center * ratio + .5));
+  for (j = 1; j < rsize; j++) {
+    while (j >= next && b + 1 < o->n_bands) {
+      b++;
+      center = next;
+      next = MAX (center + 1., FLOOR (center * ratio + .5));
+    }
+    o->band[j] = b;
+    o->band_weight->data[j] = (b + 1 < o->n_bands) ?
+      (j - center) / (next - center) : 0.;
+    o->band_scale->data[b] += 1. - o->band_weight->data[j];
+    o->band_scale->data[b + 1] += o->band_weight->data[j];
+  }
+  for (b = 0; b < o->n_bands; b++) {
+    o->band_scale->data[b] = 1. / o->band_scale->data[b];
+  }
+  return AUBIO_OK;
 }
 
 /* Generic function pointing to the choosen one */
 void 
 aubio_specdesc_do (aubio_specdesc_t *o, const cvec_t * fftgrain, 
     fvec_t * onset) {
+  AUBIO_STATS_BEGIN ("specdesc");
   o->funcpointer(o,fftgrain,onset);
+  AUBIO_STATS_END ();
 }
 
-/* Allocate memory for an onset detection 
- * depending on the choosen type, allocate memory as needed
- */
-aubio_specdesc_t * 
-new_aubio_specdesc (const char_t * onset_mode, uint_t size){
-  aubio_specdesc_t * o = AUBIO_NEW(aubio_specdesc_t);
-  uint_t rsize = size/2+1;
-  aubio_specdesc_type onset_type;
-  
-  if (!o) {
-    return NULL;
-  }
-  
+/* Find the type of a spectral description method, returns AUBIO_FAIL if
+ * onset_mode is unknown */
+static uint_t
+aubio_specdesc_get_type (const char_t * onset_mode,
+    aubio_specdesc_type * onset_type)
+{
   if (strcmp (onset_mode, "energy") == 0)
-      onset_type = aubio_onset_energy;
+      *onset_type = aubio_onset_energy;
   else if (strcmp (onset_mode, "specdiff") == 0)
-      onset_type = aubio_onset_specdiff;
+      *onset_type = aubio_onset_specdiff;
   else if (strcmp (onset_mode, "hfc") == 0)
-      onset_type = aubio_onset_hfc;
+      *onset_type = aubio_onset_hfc;
   else if (strcmp (onset_mode, "complexdomain") == 0)
-      onset_type = aubio_onset_complex;
+      *onset_type = aubio_onset_complex;
   else if (strcmp (onset_mode, "complex") == 0)
-      onset_type = aubio_onset_complex;
+      *onset_type = aubio_onset_complex;
   else if (strcmp (onset_mode, "phase") == 0)
-      onset_type = aubio_onset_phase;
+      *onset_type = aubio_onset_phase;
   else if (strcmp (onset_mode, "wphase") == 0)
-      onset_type = aubio_onset_wphase;
+      *onset_type = aubio_onset_wphase;
   else if (strcmp (onset_mode, "mkl") == 0)
-      onset_type = aubio_onset_mkl;
+      *onset_type = aubio_onset_mkl;
   else if (strcmp (onset_mode, "kl") == 0)
-      onset_type = aubio_onset_kl;
+      *onset_type = aubio_onset_kl;
   else if (strcmp (onset_mode, "specflux") == 0)
-      onset_type = aubio_onset_specflux;
+      *onset_type = aubio_onset_specflux;
+  else if (strcmp (onset_mode, "superflux") == 0)
+      *onset_type = aubio_onset_superflux;
   else if (strcmp (onset_mode, "centroid") == 0)
-      onset_type = aubio_specmethod_centroid;
+      *onset_type = aubio_specmethod_centroid;
   else if (strcmp (onset_mode, "spread") == 0)
-      onset_type = aubio_specmethod_spread;
+      *onset_type = aubio_specmethod_spread;
   else if (strcmp (onset_mode, "skewness") == 0)
-      onset_type = aubio_specmethod_skewness;
+      *onset_type = aubio_specmethod_skewness;
   else if (strcmp (onset_mode, "kurtosis") == 0)
-      onset_type = aubio_specmethod_kurtosis;
+      *onset_type = aubio_specmethod_kurtosis;
   else if (strcmp (onset_mode, "slope") == 0)
-      onset_type = aubio_specmethod_slope;
+      *onset_type = aubio_specmethod_slope;
   else if (strcmp (onset_mode, "decrease") == 0)
-      onset_type = aubio_specmethod_decrease;
+      *onset_type = aubio_specmethod_decrease;
   else if (strcmp (onset_mode, "rolloff") == 0)
-      onset_type = aubio_specmethod_rolloff;
+      *onset_type = aubio_specmethod_rolloff;
   else if (strcmp (onset_mode, "old_default") == 0)
-      onset_type = aubio_onset_default;
+      *onset_type = aubio_onset_default;
   else if (strcmp (onset_mode, "default") == 0)
-      onset_type = aubio_onset_default;
-  else {
+      *onset_type = aubio_onset_default;
+  else
+      return AUBIO_FAIL;
+  return AUBIO_OK;
+}
+
+/* Allocate memory for an onset detection 
+ * depending on the choosen type, allocate memory as needed
+ */
+aubio_specdesc_t * 
+new_aubio_specdesc (const char_t * onset_mode, uint_t size){
+  aubio_specdesc_t * o = AUBIO_NEW(aubio_specdesc_t);
+  uint_t rsize = size/2+1;
+  aubio_specdesc_type onset_type;
+  
+  if (!o) {
+    return NULL;
+  }
+  
+  if (aubio_specdesc_get_type (onset_mode, &onset_type) != AUBIO_OK) {
       AUBIO_ERR("specdesc: unknown spectral descriptor type '%s'\n",
           onset_mode);
       AUBIO_FREE(o);
@@ -313,6 +384,10 @@ new_aubio_specdesc (const char_t * onset_mode, uint_t size){
   o->theta1 = NULL;
   o->theta2 = NULL;
   o->histog = NULL;
+  o->band = NULL;
+  o->band_weight = NULL;
+  o->band_scale = NULL;
+  o->maxfilt = NULL;
   
   switch(onset_type) {
     /* for both energy and hfc, only fftgrain->norm is required */
@@ -358,6 +433,13 @@ new_aubio_specdesc (const char_t * onset_mode, uint_t size){
       o->oldmag = new_fvec(rsize);
       if (!o->oldmag) goto beach;
       break;
+    case aubio_onset_superflux:
+      if (rsize < 2) {
+        AUBIO_ERR("specdesc: superflux needs buf_size >= 2, got %d\n", size);
+        goto beach;
+      }
+      if (aubio_specdesc_superflux_init (o, rsize) != AUBIO_OK) goto beach;
+      break;
     default:
       break;
   }
@@ -390,6 +472,9 @@ new_aubio_specdesc (const char_t * onset_mode, uint_t size){
     case aubio_onset_specflux:
       o->funcpointer = aubio_specdesc_specflux;
       break;
+    case aubio_onset_superflux:
+      o->funcpointer = aubio_specdesc_superflux;
+      break;
     case aubio_specmethod_centroid:
       o->funcpointer = aubio_specdesc_centroid;
       break;
@@ -424,10 +509,26 @@ beach:
   if (o->theta1) del_fvec(o->theta1);
   if (o->theta2) del_fvec(o->theta2);
   if (o->histog) del_aubio_hist(o->histog);
+  if (o->band) AUBIO_FREE(o->band);
+  if (o->band_weight) del_fvec(o->band_weight);
+  if (o->band_scale) del_fvec(o->band_scale);
+  if (o->maxfilt) del_fvec(o->maxfilt);
   AUBIO_FREE(o);
   return NULL;
 }
 
+uint_t aubio_specdesc_uses_phase (const aubio_specdesc_t * o)
+{
+  switch (o->onset_type) {
+    case aubio_onset_complex:
+    case aubio_onset_phase:
+    case aubio_onset_wphase:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
 void del_aubio_specdesc (aubio_specdesc_t *o){
   switch(o->onset_type) {
     case aubio_onset_energy:
@@ -457,8 +558,247 @@ void del_aubio_specdesc (aubio_specdesc_t *o){
     case aubio_onset_specflux:
       del_fvec(o->oldmag);
       break;
+    case aubio_onset_superflux:
+      del_fvec(o->oldmag);
+      del_fvec(o->dev1);
+      AUBIO_FREE(o->band);
+      del_fvec(o->band_weight);
+      del_fvec(o->band_scale);
+      del_fvec(o->maxfilt);
+      break;
     default:
       break;
   }
   AUBIO_FREE(o);
 }
+
+uint_t aubio_specdesc_get_memory_usage (const aubio_specdesc_t *o) {
+  /* the vectors the method does not use are NULL */
+  uint_t n = aubio_malloc_size(o) + aubio_malloc_size(o->oldmag)
+    + aubio_malloc_size(o->dev1) + aubio_malloc_size(o->theta1)
+    + aubio_malloc_size(o->theta2) + aubio_malloc_size(o->band)
+    + aubio_malloc_size(o->band_weight) + aubio_malloc_size(o->band_scale)
+    + aubio_malloc_size(o->maxfilt);
+  if (o->histog) n += aubio_hist_get_memory_usage(o->histog);
+  return n;
+}
+
+/* maximum length of a method name in new_aubio_specdesc_multi */
+#define AUBIO_SPECDESC_NAME_MAX 32
+
+/** several spectral descriptions computed on the same spectrum */
+struct _aubio_specdesc_multi_t {
+  uint_t n_methods;              /**< number of methods, length of the output */
+  aubio_specdesc_type *types;    /**< type of each method */
+  aubio_specdesc_t **others;     /**< objects of the methods not fused */
+  uint_t fused;                  /**< bit (1 << type) set for each fused type */
+  fvec_t *oldmag;                /**< previous norm vector */
+  fvec_t *theta1;                /**< previous phase vector */
+  fvec_t *theta2;                /**< phase vector two frames behind */
+  fvec_t *desc;                  /**< output of the methods not fused */
+};
+
+/* returns 1 if the method is computed in the fused loop */
+static uint_t
+aubio_specdesc_multi_is_fused (aubio_specdesc_type type)
+{
+  switch (type) {
+    case aubio_onset_energy:
+    case aubio_onset_hfc:
+    case aubio_onset_complex:
+    case aubio_onset_kl:
+    case aubio_onset_mkl:
+    case aubio_onset_specflux:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/* copy the method name starting at methods[*pos] to name, skipping the
+ * separators before it, returns 0 when the end of methods is reached */
+static uint_t
+aubio_specdesc_multi_next (const char_t * methods, uint_t * pos,
+    char_t * name)
+{
+  uint_t i = *pos, len = 0;
+  while (methods[i] == ' ' || methods[i] == ',') i++;
+  if (methods[i] == '\0') return 0;
+  while (methods[i] != '\0' && methods[i] != ' ' && methods[i] != ',') {
+    if (len < AUBIO_SPECDESC_NAME_MAX - 1) name[len++] = methods[i];
+    i++;
+  }
+  name[len] = '\0';
+  *pos = i;
+  return 1;
+}
+
+aubio_specdesc_multi_t *
+new_aubio_specdesc_multi (const char_t * methods, uint_t size)
+{
+  aubio_specdesc_multi_t *o = NULL;
+  char_t name[AUBIO_SPECDESC_NAME_MAX];
+  uint_t pos = 0, i = 0, n = 0, rsize = size / 2 + 1;
+  aubio_specdesc_type type;
+
+  if (!methods) {
+    AUBIO_ERR("specdesc: no methods given\n");
+    return NULL;
+  }
+  while (aubio_specdesc_multi_next (methods, &pos, name)) {
+    if (aubio_specdesc_get_type (name, &type) != AUBIO_OK) {
+      AUBIO_ERR("specdesc: unknown spectral descriptor type '%s'\n", name);
+      return NULL;
+    }
+    n++;
+  }
+  if (n == 0) {
+    AUBIO_ERR("specdesc: no methods given in '%s'\n", methods);
+    return NULL;
+  }
+
+  o = AUBIO_NEW(aubio_specdesc_multi_t);
+  if (!o) return NULL;
+  o->n_methods = n;
+  o->types = AUBIO_ARRAY(aubio_specdesc_type, n);
+  o->others = AUBIO_ARRAY(aubio_specdesc_t *, n);
+  o->desc = new_fvec(1);
+  if (!o->types || !o->others || !o->desc) goto beach;
+
+  pos = 0;
+  while (aubio_specdesc_multi_next (methods, &pos, name)) {
+    aubio_specdesc_get_type (name, &type);
+    o->types[i] = type;
+    o->others[i] = NULL;
+    if (aubio_specdesc_multi_is_fused (type)) {
+      o->fused |= 1 << type;
+    } else {
+      o->others[i] = new_aubio_specdesc (name, size);
+      if (!o->others[i]) goto beach;
+    }
+    i++;
+  }
+  if (o->fused & ~(1 << aubio_onset_energy | 1 << aubio_onset_hfc)) {
+    o->oldmag = new_fvec(rsize);
+    if (!o->oldmag) goto beach;
+  }
+  if (o->fused & 1 << aubio_onset_complex) {
+    o->theta1 = new_fvec(rsize);
+    o->theta2 = new_fvec(rsize);
+    if (!o->theta1 || !o->theta2) goto beach;
+  }
+  return o;
+
+beach:
+  del_aubio_specdesc_multi (o);
+  return NULL;
+}
+
+void
+aubio_specdesc_multi_do (aubio_specdesc_multi_t * o, const cvec_t * fftgrain,
+    fvec_t * desc)
+{
+  uint_t i, j, nbins = fftgrain->length;
+  smpl_t energy = 0., hfc = 0., cplx = 0., flux = 0., kl = 0., mkl = 0.;
+  const smpl_t *norm = fftgrain->norm, *phas = fftgrain->phas;
+  smpl_t *oldmag = o->oldmag ? o->oldmag->data : NULL;
+  smpl_t *theta1 = o->theta1 ? o->theta1->data : NULL;
+  smpl_t *theta2 = o->theta2 ? o->theta2->data : NULL;
+  uint_t do_energy = o->fused & 1 << aubio_onset_energy;
+  uint_t do_hfc = o->fused & 1 << aubio_onset_hfc;
+  uint_t do_flux = o->fused & 1 << aubio_onset_specflux;
+  uint_t do_kl = o->fused & (1 << aubio_onset_kl | 1 << aubio_onset_mkl);
+  if (desc->length < o->n_methods) {
+    AUBIO_ERR("specdesc: expected an output of length %d, got %d\n",
+        o->n_methods, desc->length);
+    return;
+  }
+  // a single pass over the bins for all the fused methods
+  for (j = 0; o->fused && j < nbins; j++) {
+    smpl_t n = norm[j], old, l;
+    if (do_energy) energy += SQR(n);
+    if (do_hfc) hfc += (j + 1) * n;
+    if (!oldmag) continue;
+    old = oldmag[j];
+    if (theta1) {
+      // distance to the predicted point, as in aubio_specdesc_complex
+      smpl_t dev = 2. * theta1[j] - theta2[j];
+      cplx += SQRT (ABS (SQR (old) + SQR (n)
+            - 2 * old * n * COS (dev - phas[j])));
+      theta2[j] = theta1[j];
+      theta1[j] = phas[j];
+    }
+    if (do_flux && n > old) flux += n - old;
+    if (do_kl) {
+      l = LOG (1. + n / (old + 1.e-1));
+      kl += n * l;
+      mkl += l;
+    }
+    oldmag[j] = n;
+  }
+  if (isnan(kl)) kl = 0.;
+  if (isnan(mkl)) mkl = 0.;
+  for (i = 0; i < o->n_methods; i++) {
+    switch (o->types[i]) {
+      case aubio_onset_energy:
+        desc->data[i] = energy;
+        break;
+      case aubio_onset_hfc:
+        desc->data[i] = hfc;
+        break;
+      case aubio_onset_complex:
+        desc->data[i] = cplx;
+        break;
+      case aubio_onset_kl:
+        desc->data[i] = kl;
+        break;
+      case aubio_onset_mkl:
+        desc->data[i] = mkl;
+        break;
+      case aubio_onset_specflux:
+        desc->data[i] = flux;
+        break;
+      default:
+        aubio_specdesc_do (o->others[i], fftgrain, o->desc);
+        desc->data[i] = o->desc->data[0];
+        break;
+    }
+  }
+}
+
+uint_t
+aubio_specdesc_multi_get_count (const aubio_specdesc_multi_t * o)
+{
+  return o->n_methods;
+}
+
+void
+del_aubio_specdesc_multi (aubio_specdesc_multi_t * o)
+{
+  uint_t i;
+  if (o->others) {
+    for (i = 0; i < o->n_methods; i++) {
+      if (o->others[i]) del_aubio_specdesc (o->others[i]);
+    }
+    AUBIO_FREE(o->others);
+  }
+  if (o->types) AUBIO_FREE(o->types);
+  if (o->desc) del_fvec(o->desc);
+  if (o->oldmag) del_fvec(o->oldmag);
+  if (o->theta1) del_fvec(o->theta1);
+  if (o->theta2) del_fvec(o->theta2);
+  AUBIO_FREE(o);
+}
+
+uint_t
+aubio_specdesc_multi_get_memory_usage (const aubio_specdesc_multi_t * o)
+{
+  uint_t i, n = aubio_malloc_size(o) + aubio_malloc_size(o->types)
+    + aubio_malloc_size(o->others) + aubio_malloc_size(o->oldmag)
+    + aubio_malloc_size(o->theta1) + aubio_malloc_size(o->theta2)
+    + aubio_malloc_size(o->desc);
+  for (i = 0; o->others && i < o->n_methods; i++) {
+    if (o->others[i]) n += aubio_specdesc_get_memory_usage(o->others[i]);
+  }
+  return n;
+}
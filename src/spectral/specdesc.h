@@ -90,6 +90,17 @@
   International Conference on Digital Audio Effects'' (DAFx-06), Montreal,
   Canada, 2006.
 
+  \b \p superflux : Spectral flux with vibrato suppression
+
+  The magnitudes are summed into bands a quarter of a tone apart, and their
+  logarithm is compared to the maximum of the neighbouring bands of the
+  previous spectrum, so that the partials moving by less than a band from one
+  spectrum to the next, as in a vibrato, do not raise the function.
+
+  Sebastian B&ouml;ck and Gerhard Widmer, Maximum filter vibrato suppression
+  for onset detection, in ``Proceedings of the 16th International Conference
+  on Digital Audio Effects'' (DAFx-13), Maynooth, Ireland, 2013.
+
   \subsection shapedesc Spectral shape descriptors
 
   The following descriptors are described in:
@@ -182,7 +193,7 @@ void aubio_specdesc_do (aubio_specdesc_t * o, const cvec_t * fftgrain,
   The parameter \p method is a string that can be any of:
 
     - onset novelty functions: `complex`, `energy`, `hfc`, `kl`, `mkl`,
-    `phase`, `specdiff`, `specflux`, `wphase`,
+    `phase`, `specdiff`, `specflux`, `superflux`, `wphase`,
 
     - spectral descriptors: `centroid`, `decrease`, `kurtosis`, `rolloff`,
     `skewness`, `slope`, `spread`.
@@ -190,6 +201,25 @@ void aubio_specdesc_do (aubio_specdesc_t * o, const cvec_t * fftgrain,
 */
 aubio_specdesc_t *new_aubio_specdesc (const char_t * method, uint_t buf_size);
 
+/** check whether a spectral descriptor reads the phase of its input
+
+  \param o spectral descriptor object as returned by new_aubio_specdesc()
+
+  \return 1 if the phas array of the input spectrum is used, 0 otherwise
+
+*/
+uint_t aubio_specdesc_uses_phase (const aubio_specdesc_t * o);
+
+/** get the memory used by a spectral descriptor
+
+  \param o spectral descriptor object as returned by new_aubio_specdesc()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_specdesc_get_memory_usage (const aubio_specdesc_t * o);
+
 /** deletion of a spectral descriptor
 
   \param o spectral descriptor object as returned by new_aubio_specdesc()
@@ -197,6 +227,88 @@ aubio_specdesc_t *new_aubio_specdesc (const char_t * method, uint_t buf_size);
 */
 void del_aubio_specdesc (aubio_specdesc_t * o);
 
+/** several spectral descriptions of the same spectrum */
+typedef struct _aubio_specdesc_multi_t aubio_specdesc_multi_t;
+
+/** creation of a multiple spectral description object
+
+  \param methods list of the methods to compute, separated by spaces or
+  commas, for instance `"hfc complex specflux kl"`; each can be any of the
+  methods of new_aubio_specdesc()
+  \param buf_size length of the input spectrum frame
+
+  The `energy`, `hfc`, `complex`, `kl`, `mkl` and `specflux` methods are
+  computed together in a single pass over the bins, and share the previous
+  magnitudes and phases. The other methods are computed one by one, as they
+  would be by aubio_specdesc_do().
+
+  \return newly created object, or NULL if a method is unknown
+
+*/
+aubio_specdesc_multi_t *new_aubio_specdesc_multi (const char_t * methods,
+    uint_t buf_size);
+
+/** compute all the spectral descriptions on a spectral frame
+
+  \param o multiple spectral description object as returned by
+  new_aubio_specdesc_multi()
+  \param fftgrain input signal spectrum as computed by aubio_pvoc_do
+  \param desc output vector, of length at least
+  aubio_specdesc_multi_get_count(); `desc->data[i]` gets the result of the
+  i-th method given to new_aubio_specdesc_multi()
+
+*/
+void aubio_specdesc_multi_do (aubio_specdesc_multi_t * o,
+    const cvec_t * fftgrain, fvec_t * desc);
+
+/** get the number of methods of a multiple spectral description object
+
+  \param o multiple spectral description object as returned by
+  new_aubio_specdesc_multi()
+
+  \return number of methods, length of the output of
+  aubio_specdesc_multi_do()
+
+*/
+uint_t aubio_specdesc_multi_get_count (const aubio_specdesc_multi_t * o);
+
+/** get the memory used by a multiple spectral description object
+
+  \param o multiple spectral description object as returned by
+  new_aubio_specdesc_multi()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_specdesc_multi_get_memory_usage (
+    const aubio_specdesc_multi_t * o);
+
+/** deletion of a multiple spectral description object
+
+  \param o multiple spectral description object as returned by
+  new_aubio_specdesc_multi()
+
+*/
+void del_aubio_specdesc_multi (aubio_specdesc_multi_t * o);
+
+/** number of values computed by aubio_spectral_shape_do() */
+#define AUBIO_SPECTRAL_SHAPE_LENGTH 7
+
+/** compute all the spectral shape descriptors of a spectral frame
+
+  \param spec input signal spectrum as computed by aubio_pvoc_do
+  \param shape output vector of length at least ::AUBIO_SPECTRAL_SHAPE_LENGTH,
+  receiving in this order the `centroid`, `spread`, `skewness`, `kurtosis`,
+  `slope`, `decrease` and `rolloff` of `spec`
+
+  The results are those of the spectral shape descriptors of the same name,
+  obtained in two passes over the bins instead of about fifteen when each
+  descriptor is computed on its own.
+
+*/
+void aubio_spectral_shape_do (const cvec_t * spec, fvec_t * shape);
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,6 +19,7 @@
 */
 
 #include "aubio_priv.h"
+#include "fvec.h"
 #include "cvec.h"
 #include "spectral/specdesc.h"
 
@@ -46,12 +47,23 @@ smpl_t cvec_moment (const cvec_t * s, uint_t moment);
 smpl_t
 cvec_sum (const cvec_t * s)
 {
+#if (defined(HAVE_INTEL_IPP) || defined(HAVE_ACCELERATE)) \
+  && !defined(HAVE_AUBIO_DOUBLE_ACCUMULATORS)
+  smpl_t tmp = 0.;
+#if defined(HAVE_INTEL_IPP)
+  aubio_ippsSum(s->norm, (int)s->length, &tmp);
+#else
+  aubio_vDSP_sve(s->norm, 1, &tmp, s->length);
+#endif
+  return tmp;
+#else
   uint_t j;
-  smpl_t tmp = 0.0;
+  asmp_t tmp = 0.0;
   for (j = 0; j < s->length; j++) {
     tmp += s->norm[j];
   }
   return tmp;
+#endif
 }
 
 smpl_t
@@ -63,14 +75,15 @@ cvec_mean (const cvec_t * s)
 smpl_t
 cvec_centroid (const cvec_t * spec)
 {
-  smpl_t sum = 0., sc = 0.;
+  smpl_t sum = 0.;
+  asmp_t sc = 0.;
   uint_t j;
   sum = cvec_sum (spec); 
   if (sum == 0.) {
     return 0.;
   } else {
     for (j = 0; j < spec->length; j++) {
-      sc += (smpl_t) j *spec->norm[j];
+      sc += (asmp_t) j *spec->norm[j];
     }
     return sc / sum;
   }
@@ -79,7 +92,8 @@ cvec_centroid (const cvec_t * spec)
 smpl_t
 cvec_moment (const cvec_t * spec, uint_t order)
 {
-  smpl_t sum = 0., centroid = 0., sc = 0.;
+  smpl_t sum = 0., centroid = 0.;
+  asmp_t sc = 0.;
   uint_t j;
   sum = cvec_sum (spec); 
   if (sum == 0.) {
@@ -87,7 +101,7 @@ cvec_moment (const cvec_t * spec, uint_t order)
   } else {
     centroid = cvec_centroid (spec);
     for (j = 0; j < spec->length; j++) {
-      sc += (smpl_t) POW(j - centroid, order) * spec->norm[j];
+      sc += (asmp_t) POW(j - centroid, order) * spec->norm[j];
     }
     return sc / sum;
   }
@@ -140,10 +154,10 @@ aubio_specdesc_slope (aubio_specdesc_t * o UNUSED, const cvec_t * spec,
     fvec_t * desc)
 {
   uint_t j;
-  smpl_t norm = 0, sum = 0.; 
+  asmp_t norm = 0, sum = 0., slope = 0.;
   // compute N * sum(j**2) - sum(j)**2
   for (j = 0; j < spec->length; j++) {
-    norm += j*j;
+    norm += (asmp_t) j * j;
   }
   norm *= spec->length;
   // sum_0^N(j) = length * (length + 1) / 2
@@ -154,12 +168,11 @@ aubio_specdesc_slope (aubio_specdesc_t * o UNUSED, const cvec_t * spec,
     return; 
   } else {
     for (j = 0; j < spec->length; j++) {
-      desc->data[0] += j * spec->norm[j]; 
+      slope += j * spec->norm[j]; 
     }
-    desc->data[0] *= spec->length;
-    desc->data[0] -= sum * spec->length * (spec->length - 1) / 2.;
-    desc->data[0] /= norm;
-    desc->data[0] /= sum;
+    slope *= spec->length;
+    slope -= sum * spec->length * (spec->length - 1) / 2.;
+    desc->data[0] = slope / norm / sum;
   }
 }
 
@@ -167,7 +180,7 @@ void
 aubio_specdesc_decrease (aubio_specdesc_t *o UNUSED, const cvec_t * spec,
     fvec_t * desc)
 {
-  uint_t j; smpl_t sum;
+  uint_t j; asmp_t sum, decrease = 0.;
   sum = cvec_sum (spec); 
   desc->data[0] = 0;
   if (sum == 0.) {
@@ -175,9 +188,9 @@ aubio_specdesc_decrease (aubio_specdesc_t *o UNUSED, const cvec_t * spec,
   } else {
     sum -= spec->norm[0];
     for (j = 1; j < spec->length; j++) {
-      desc->data[0] += (spec->norm[j] - spec->norm[0]) / j;
+      decrease += (spec->norm[j] - spec->norm[0]) / j;
     }
-    desc->data[0] /= sum;
+    desc->data[0] = decrease / sum;
   }
 }
 
@@ -185,7 +198,7 @@ void
 aubio_specdesc_rolloff (aubio_specdesc_t *o UNUSED, const cvec_t * spec,
     fvec_t *desc)
 {
-  uint_t j; smpl_t cumsum, rollsum;
+  uint_t j; asmp_t cumsum, rollsum;
   cumsum = 0.; rollsum = 0.;
   for (j = 0; j < spec->length; j++) {
     cumsum += SQR (spec->norm[j]);
@@ -203,3 +216,58 @@ aubio_specdesc_rolloff (aubio_specdesc_t *o UNUSED, const cvec_t * spec,
     desc->data[0] = j;
   }
 }
+
+void
+aubio_spectral_shape_do (const cvec_t * spec, fvec_t * shape)
+{
+  uint_t j, n = spec->length, rolloff = 0;
+  const smpl_t *norm = spec->norm;
+  asmp_t sum = 0., sc = 0., energy = 0., decrease = 0.;
+  asmp_t centroid, m2 = 0., m3 = 0., m4 = 0., roll = 0., d, d2, ramp;
+  if (shape->length < AUBIO_SPECTRAL_SHAPE_LENGTH) {
+    AUBIO_ERR("spectral_shape: expected an output of length %d, got %d\n",
+        AUBIO_SPECTRAL_SHAPE_LENGTH, shape->length);
+    return;
+  }
+  fvec_zeros (shape);
+  if (n == 0) return;
+  // first pass: sum, centroid, energy and decrease
+  sum = norm[0];
+  energy = SQR (norm[0]);
+  for (j = 1; j < n; j++) {
+    sum += norm[j];
+    sc += (asmp_t) j * norm[j];
+    energy += SQR (norm[j]);
+    decrease += (norm[j] - norm[0]) / j;
+  }
+  if (sum == 0.) return;
+  centroid = sc / sum;
+  // second pass: central moments and rolloff
+  energy *= 0.95;
+  for (j = 0; j < n; j++) {
+    d = j - centroid;
+    d2 = d * d;
+    m2 += d2 * norm[j];
+    m3 += d2 * d * norm[j];
+    m4 += d2 * d2 * norm[j];
+    if (roll < energy) {
+      roll += SQR (norm[j]);
+      rolloff = j;
+    }
+  }
+  m2 /= sum;
+  m3 /= sum;
+  m4 /= sum;
+  shape->data[0] = centroid;
+  shape->data[1] = m2;
+  if (m2 != 0.) {
+    shape->data[2] = m3 / POW (SQRT (m2), 3);
+    shape->data[3] = m4 / SQR (m2);
+  }
+  // N * sum(j**2) - sum(j)**2
+  ramp = (asmp_t) n * (n - 1.) * (2. * n - 1.) / 6. * n
+    - SQR (n * (n - 1.) / 2.);
+  shape->data[4] = (sc * n - sum * n * (n - 1) / 2.) / ramp / sum;
+  shape->data[5] = decrease / (sum - norm[0]);
+  shape->data[6] = rolloff;
+}
@@ -25,6 +25,8 @@
 #include "cvec.h"
 #include "mathutils.h"
 #include "spectral/tss.h"
+#include "utils/simd_priv.h"
+#include "utils/denormal_priv.h"
 
 struct _aubio_tss_t
 {
@@ -33,60 +35,46 @@ struct _aubio_tss_t
   smpl_t beta;
   smpl_t parm;
   smpl_t thrsfact;
-  fvec_t *theta1;
-  fvec_t *theta2;
-  fvec_t *oft1;
-  fvec_t *oft2;
-  fvec_t *dev;
+  uint_t nbins;
+  fvec_t *state;    /**< phases and probabilities, in blocks of bins */
+  fvec_t *tmask;
+  fvec_t *smask;
 };
 
+void aubio_tss_do_masks(aubio_tss_t *o, const cvec_t * input,
+    fvec_t * trans_mask, fvec_t * stead_mask)
+{
+  /* probability of a bin whose mask was set in the previous frame */
+  smpl_t hi = o->alpha + ((o->alpha > 1.) ? o->beta : 0.);
+  aubio_denormal_guard_t guard;
+  if (input->length != o->nbins || trans_mask->length < o->nbins
+      || stead_mask->length < o->nbins) {
+    AUBIO_ERR("tss: expected %d bins, got an input of %d bins and masks of"
+        " %d and %d bins\n", o->nbins, input->length, trans_mask->length,
+        stead_mask->length);
+    return;
+  }
+  aubio_denormal_enter(&guard);
+  AUBIO_SIMD()->tss(input->norm, input->phas, o->state->data,
+      trans_mask->data, stead_mask->data, o->parm, hi, o->nbins);
+  aubio_denormal_leave(&guard);
+}
+
 void aubio_tss_do(aubio_tss_t *o, const cvec_t * input,
     cvec_t * trans, cvec_t * stead)
 {
-  uint_t j;
-  uint_t test;
-  uint_t nbins     = input->length;
-  smpl_t alpha     = o->alpha;
-  smpl_t beta      = o->beta;
-  smpl_t parm      = o->parm;
-  smpl_t * dev    = (smpl_t *)o->dev->data;
-  smpl_t * oft1   = (smpl_t *)o->oft1->data;
-  smpl_t * oft2   = (smpl_t *)o->oft2->data;
-  smpl_t * theta1 = (smpl_t *)o->theta1->data;
-  smpl_t * theta2 = (smpl_t *)o->theta2->data;
-  /* second phase derivative */
-  for (j=0;j<nbins; j++){
-    dev[j] = aubio_unwrap2pi(input->phas[j]
-        -2.0*theta1[j]+theta2[j]);
-    theta2[j] = theta1[j];
-    theta1[j] = input->phas[j];
-
-    /* transient analysis */
-    test = (ABS(dev[j]) > parm*oft1[j]);
-    trans->norm[j] = input->norm[j] * test;
-    trans->phas[j] = input->phas[j] * test;
-
-    /* steady state analysis */
-    test = (ABS(dev[j]) < parm*oft2[j]);
-    stead->norm[j] = input->norm[j] * test;
-    stead->phas[j] = input->phas[j] * test;
-
-    /*increase probability for transient */
-    test = (trans->norm[j]==0.);
-    oft1[j]  = test;
-    test = (trans->norm[j]>0.);
-    oft1[j] += alpha*test;
-    test = (oft1[j]>1. && trans->norm[j]>0.);
-    oft1[j] += beta*test;
-
-    /*increase probability for steady states */
-    test = (stead->norm[j]==0.);
-    oft2[j]  = test;
-    test = (stead->norm[j]>0.);
-    oft2[j] += alpha*test;
-    test = (oft2[j]>1. && stead->norm[j]>0.);
-    oft2[j] += beta*test;
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  uint_t nbins = o->nbins;
+  if (trans->length != nbins || stead->length != nbins) {
+    AUBIO_ERR("tss: expected outputs of %d bins, got %d and %d bins\n",
+        nbins, trans->length, stead->length);
+    return;
   }
+  aubio_tss_do_masks(o, input, o->tmask, o->smask);
+  ops->weighted_copy(input->norm, o->tmask->data, trans->norm, nbins);
+  ops->weighted_copy(input->phas, o->tmask->data, trans->phas, nbins);
+  ops->weighted_copy(input->norm, o->smask->data, stead->norm, nbins);
+  ops->weighted_copy(input->phas, o->smask->data, stead->phas, nbins);
 }
 
 uint_t aubio_tss_set_threshold(aubio_tss_t *o, smpl_t threshold){
@@ -109,24 +97,29 @@ aubio_tss_t * new_aubio_tss(uint_t buf_size, uint_t hop_size)
   o->alpha = 3.;
   o->beta = 4.;
   o->parm = o->threshold*o->thrsfact;
-  o->theta1 = new_fvec(rsize);
-  o->theta2 = new_fvec(rsize);
-  o->oft1 = new_fvec(rsize);
-  o->oft2 = new_fvec(rsize);
-  o->dev = new_fvec(rsize);
+  o->nbins = rsize;
+  /* 4 values per bin, the last block padded to AUBIO_SIMD_TSS_BLOCK bins */
+  o->state = new_fvec(4 * AUBIO_SIMD_TSS_BLOCK
+      * ((rsize + AUBIO_SIMD_TSS_BLOCK - 1) / AUBIO_SIMD_TSS_BLOCK));
+  o->tmask = new_fvec(rsize);
+  o->smask = new_fvec(rsize);
   return o;
 }
 
 void del_aubio_tss(aubio_tss_t *s)
 {
-  del_fvec(s->theta1);
-  del_fvec(s->theta2);
-  del_fvec(s->oft1);
-  del_fvec(s->oft2);
-  del_fvec(s->dev);
+  del_fvec(s->state);
+  del_fvec(s->tmask);
+  del_fvec(s->smask);
   AUBIO_FREE(s);
 }
 
+uint_t aubio_tss_get_memory_usage(const aubio_tss_t *s)
+{
+  return aubio_malloc_size(s) + aubio_malloc_size(s->state)
+    + aubio_malloc_size(s->tmask) + aubio_malloc_size(s->smask);
+}
+
 uint_t aubio_tss_set_alpha(aubio_tss_t *o, smpl_t alpha){
   o->alpha = alpha;
   return AUBIO_OK;
@@ -54,6 +54,16 @@ typedef struct _aubio_tss_t aubio_tss_t;
 */
 aubio_tss_t *new_aubio_tss (uint_t buf_size, uint_t hop_size);
 
+/** get the memory used by a tss object
+
+  \param o tss object as returned by new_aubio_tss()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_tss_get_memory_usage (const aubio_tss_t * o);
+
 /** delete tss object
 
   \param o tss object as returned by new_aubio_tss()
@@ -72,6 +82,23 @@ void del_aubio_tss (aubio_tss_t * o);
 void aubio_tss_do (aubio_tss_t * o, const cvec_t * input, cvec_t * trans,
     cvec_t * stead);
 
+/** compute the transient and steady state masks of a spectral frame
+
+  \param o tss object as returned by new_aubio_tss()
+  \param input input spectral frame
+  \param trans_mask output, 1 for the bins of the transient components, 0
+  elsewhere
+  \param stead_mask output, 1 for the bins of the steady state components, 0
+  elsewhere
+
+  This function updates `o` like aubio_tss_do(), which multiplies the norm and
+  phase of `input` by these masks. The masks should be at least as long as
+  `input`.
+
+*/
+void aubio_tss_do_masks (aubio_tss_t * o, const cvec_t * input,
+    fvec_t * trans_mask, fvec_t * stead_mask);
+
 /** set transient / steady state separation threshold
 
   \param o tss object as returned by new_aubio_tss()
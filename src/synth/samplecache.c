@@ -0,0 +1,436 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+/* mkstemp() */
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "aubio_priv.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "utils/allocator.h"
+#include "synth/samplecache.h"
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_samplecache_lock = SRWLOCK_INIT;
+#define AUBIO_SAMPLECACHE_LOCK()   AcquireSRWLockExclusive(&aubio_samplecache_lock)
+#define AUBIO_SAMPLECACHE_UNLOCK() ReleaseSRWLockExclusive(&aubio_samplecache_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t aubio_samplecache_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_SAMPLECACHE_LOCK()   pthread_mutex_lock(&aubio_samplecache_mutex)
+#define AUBIO_SAMPLECACHE_UNLOCK() pthread_mutex_unlock(&aubio_samplecache_mutex)
+#endif
+
+/** number of frames decoded at once */
+#define AUBIO_CLIP_BLOCK 4096
+
+struct _aubio_clip_t {
+  char_t *uri;
+  uint_t requested;             /**< samplerate asked for, 0 for the one of
+                                     the file */
+  uint_t samplerate;            /**< samplerate of the decoded frames */
+  uint_t channels;
+  uint_t length;
+  smpl_t *data;                 /**< channels blocks of length frames */
+  void *map;                    /**< mapped cache file holding data, or NULL */
+  size_t map_size;
+  uint_t refcount;              /**< number of users of the sample */
+  struct _aubio_clip_t *next;
+};
+
+/** list of samples, protected by aubio_samplecache_lock */
+static aubio_clip_t *aubio_samplecache_clips = NULL;
+
+/** cache directory, empty if not set, protected by aubio_samplecache_lock */
+static char_t aubio_samplecache_dir[PATH_MAX] = "";
+
+static void del_aubio_clip (aubio_clip_t *c)
+{
+#ifdef HAVE_MMAP
+  if (c->map) {
+    munmap(c->map, c->map_size);
+  } else
+#endif
+  if (c->data) {
+    AUBIO_FREE(c->data);
+  }
+  if (c->uri) AUBIO_FREE(c->uri);
+  AUBIO_FREE(c);
+}
+
+static aubio_clip_t *new_aubio_clip (const char_t *uri, uint_t requested)
+{
+  aubio_clip_t *c = AUBIO_NEW(aubio_clip_t);
+  uint_t len = strlen(uri);
+  if (!c) return NULL;
+  c->uri = AUBIO_ARRAY(char_t, len + 1);
+  if (!c->uri) {
+    AUBIO_FREE(c);
+    return NULL;
+  }
+  memcpy(c->uri, uri, len + 1);
+  c->requested = requested;
+  return c;
+}
+
+/* decode the whole file, growing the buffer when its duration was wrong */
+static aubio_clip_t *aubio_clip_decode (const char_t *uri, uint_t samplerate)
+{
+  aubio_source_t *src = new_aubio_source(uri, samplerate, AUBIO_CLIP_BLOCK);
+  aubio_clip_t *c = NULL;
+  fmat_t *block = NULL;
+  uint_t capacity, read = 0, i;
+  if (!src) return NULL;
+  c = new_aubio_clip(uri, samplerate);
+  if (!c) goto beach;
+  c->samplerate = aubio_source_get_samplerate(src);
+  c->channels = aubio_source_get_channels(src);
+  capacity = aubio_source_get_duration(src) + AUBIO_CLIP_BLOCK;
+  block = new_fmat(c->channels, AUBIO_CLIP_BLOCK);
+  if (!block || c->channels == 0 || capacity < AUBIO_CLIP_BLOCK
+      || capacity > UINT_MAX / c->channels / 2) goto beach;
+  c->data = AUBIO_ARRAY(smpl_t, c->channels * capacity);
+  if (!c->data) goto beach;
+  do {
+    aubio_source_do_multi(src, block, &read);
+    if (c->length + read > capacity) {
+      smpl_t *data;
+      if (capacity > UINT_MAX / c->channels / 4) goto beach;
+      data = AUBIO_ARRAY(smpl_t, c->channels * 2 * capacity);
+      if (!data) goto beach;
+      for (i = 0; i < c->channels; i++) {
+        memcpy(data + i * 2 * capacity, c->data + i * capacity,
+            c->length * sizeof(smpl_t));
+      }
+      AUBIO_FREE(c->data);
+      c->data = data;
+      capacity *= 2;
+    }
+    for (i = 0; i < c->channels; i++) {
+      memcpy(c->data + i * capacity + c->length, block->data[i],
+          read * sizeof(smpl_t));
+    }
+    c->length += read;
+  } while (read == AUBIO_CLIP_BLOCK);
+  // put the channels next to each other
+  for (i = 1; i < c->channels; i++) {
+    memmove(c->data + i * c->length, c->data + i * capacity,
+        c->length * sizeof(smpl_t));
+  }
+  del_fmat(block);
+  del_aubio_source(src);
+  return c;
+beach:
+  if (block) del_fmat(block);
+  if (c) del_aubio_clip(c);
+  del_aubio_source(src);
+  return NULL;
+}
+
+#ifdef HAVE_MMAP
+/** header of the files of the cache directory, followed by the uri of the
+ * sample, padded to a multiple of 64 bytes, and by its channels */
+typedef struct {
+  char_t magic[8];
+  uint_t version;
+  uint_t smpl_size;
+  uint_t samplerate;
+  uint_t channels;
+  uint_t length;
+  uint_t uri_length;
+  long long src_size;           /**< size of the source file */
+  long long src_mtime;          /**< modification time of the source file */
+} aubio_clip_header_t;
+
+#define AUBIO_CLIP_MAGIC "aubioclp"
+#define AUBIO_CLIP_VERSION 1
+
+/* offset of the frames in a cache file */
+static size_t aubio_clip_offset (uint_t uri_length)
+{
+  size_t offset = sizeof(aubio_clip_header_t) + uri_length;
+  return (offset + 63) / 64 * 64;
+}
+
+/* path of the cache file of uri at samplerate, with a hash of the uri */
+static uint_t aubio_clip_cache_path (char_t *path, const char_t *dir,
+    const char_t *uri, uint_t samplerate)
+{
+  unsigned long long hash = 14695981039346656037ULL;
+  const unsigned char *c;
+  for (c = (const unsigned char *)uri; *c; c++) {
+    hash = (hash ^ *c) * 1099511628211ULL;
+  }
+  if (snprintf(path, PATH_MAX, "%s/%016llx-%u.clip", dir, hash, samplerate)
+      >= PATH_MAX) return AUBIO_FAIL;
+  return AUBIO_OK;
+}
+
+/* map the cache file at path if it matches the source file */
+static aubio_clip_t *aubio_clip_map (const char_t *path, const char_t *uri,
+    uint_t requested, const struct stat *src)
+{
+  aubio_clip_header_t h;
+  aubio_clip_t *c;
+  struct stat st;
+  size_t offset, size;
+  void *map;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return NULL;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(h)) {
+    close(fd);
+    return NULL;
+  }
+  map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) return NULL;
+  memcpy(&h, map, sizeof(h));
+  offset = aubio_clip_offset(h.uri_length);
+  size = offset + (size_t)h.channels * h.length * sizeof(smpl_t);
+  if (memcmp(h.magic, AUBIO_CLIP_MAGIC, 8) != 0
+      || h.version != AUBIO_CLIP_VERSION || h.smpl_size != sizeof(smpl_t)
+      || h.channels == 0 || h.uri_length != strlen(uri)
+      || h.src_size != (long long)src->st_size
+      || h.src_mtime != (long long)src->st_mtime
+      || size != (size_t)st.st_size
+      || strncmp((const char_t *)map + sizeof(h), uri, h.uri_length) != 0) {
+    munmap(map, (size_t)st.st_size);
+    return NULL;
+  }
+  c = new_aubio_clip(uri, requested);
+  if (!c) {
+    munmap(map, (size_t)st.st_size);
+    return NULL;
+  }
+  c->samplerate = h.samplerate;
+  c->channels = h.channels;
+  c->length = h.length;
+  c->map = map;
+  c->map_size = (size_t)st.st_size;
+  c->data = (smpl_t *)((char_t *)map + offset);
+  return c;
+}
+
+/* write a decoded sample to path, through a temporary file so that other
+ * processes never map a partial file */
+static void aubio_clip_store (const aubio_clip_t *c, const char_t *path,
+    const struct stat *src)
+{
+  aubio_clip_header_t h;
+  char_t tmp[PATH_MAX];
+  char_t zeros[64] = { 0 };
+  size_t pad, frames = (size_t)c->channels * c->length;
+  FILE *f;
+  int fd;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, AUBIO_CLIP_MAGIC, 8);
+  h.version = AUBIO_CLIP_VERSION;
+  h.smpl_size = sizeof(smpl_t);
+  h.samplerate = c->samplerate;
+  h.channels = c->channels;
+  h.length = c->length;
+  h.uri_length = strlen(c->uri);
+  h.src_size = (long long)src->st_size;
+  h.src_mtime = (long long)src->st_mtime;
+  pad = aubio_clip_offset(h.uri_length) - sizeof(h) - h.uri_length;
+  if (snprintf(tmp, PATH_MAX, "%s.XXXXXX", path) >= PATH_MAX) return;
+  fd = mkstemp(tmp);
+  if (fd < 0) goto fail;
+  f = fdopen(fd, "wb");
+  if (!f) {
+    close(fd);
+    unlink(tmp);
+    goto fail;
+  }
+  if (fwrite(&h, sizeof(h), 1, f) != 1
+      || fwrite(c->uri, 1, h.uri_length, f) != h.uri_length
+      || fwrite(zeros, 1, pad, f) != pad
+      || fwrite(c->data, sizeof(smpl_t), frames, f) != frames) {
+    fclose(f);
+    unlink(tmp);
+    goto fail;
+  }
+  if (fclose(f) != 0 || rename(tmp, path) != 0) {
+    unlink(tmp);
+    goto fail;
+  }
+  return;
+fail:
+  AUBIO_WRN("samplecache: failed writing %s\n", path);
+}
+#endif /* HAVE_MMAP */
+
+/* find a sample in the list, with the lock held */
+static aubio_clip_t *aubio_samplecache_find (const char_t *uri,
+    uint_t samplerate)
+{
+  aubio_clip_t *c;
+  for (c = aubio_samplecache_clips; c; c = c->next) {
+    if (c->requested == samplerate && strcmp(c->uri, uri) == 0) break;
+  }
+  return c;
+}
+
+const aubio_clip_t *aubio_samplecache_load (const char_t *uri,
+    uint_t samplerate)
+{
+  aubio_clip_t *c, *found;
+  const aubio_allocator_t *previous;
+  char_t dir[PATH_MAX];
+#ifdef HAVE_MMAP
+  char_t path[PATH_MAX];
+  struct stat st;
+#endif
+  if (!uri) {
+    AUBIO_ERR("samplecache: can not load a sample without uri\n");
+    return NULL;
+  }
+  AUBIO_SAMPLECACHE_LOCK();
+  c = aubio_samplecache_find(uri, samplerate);
+  if (c) c->refcount++;
+  strncpy(dir, aubio_samplecache_dir, PATH_MAX);
+  AUBIO_SAMPLECACHE_UNLOCK();
+  if (c) return c;
+  // decode without holding the lock, other samples can be loaded meanwhile
+  // the samples outlive the objects loading them, allocate them with the C
+  // library rather than with an allocator that may be gone by then
+  previous = aubio_set_allocator(NULL);
+#ifdef HAVE_MMAP
+  if (dir[0] != '\0' && stat(uri, &st) == 0
+      && aubio_clip_cache_path(path, dir, uri, samplerate) == AUBIO_OK) {
+    c = aubio_clip_map(path, uri, samplerate, &st);
+    if (!c) {
+      c = aubio_clip_decode(uri, samplerate);
+      if (c) aubio_clip_store(c, path, &st);
+    }
+  } else
+#endif
+  c = aubio_clip_decode(uri, samplerate);
+  aubio_set_allocator(previous);
+  if (!c) {
+    AUBIO_ERR("samplecache: failed loading %s\n", uri);
+    return NULL;
+  }
+  AUBIO_SAMPLECACHE_LOCK();
+  // the same sample may have been loaded by another thread
+  found = aubio_samplecache_find(uri, samplerate);
+  if (found) {
+    found->refcount++;
+  } else {
+    c->refcount = 1;
+    c->next = aubio_samplecache_clips;
+    aubio_samplecache_clips = c;
+  }
+  AUBIO_SAMPLECACHE_UNLOCK();
+  if (found) {
+    del_aubio_clip(c);
+    return found;
+  }
+  return c;
+}
+
+void aubio_samplecache_release (const aubio_clip_t *clip)
+{
+  aubio_clip_t *c = (aubio_clip_t *)clip;
+  if (!c) return;
+  AUBIO_SAMPLECACHE_LOCK();
+  if (c->refcount > 0) c->refcount--;
+  AUBIO_SAMPLECACHE_UNLOCK();
+}
+
+uint_t aubio_samplecache_set_dir (const char_t *path)
+{
+#ifdef HAVE_MMAP
+  struct stat st;
+#endif
+  if (!path) {
+    AUBIO_SAMPLECACHE_LOCK();
+    aubio_samplecache_dir[0] = '\0';
+    AUBIO_SAMPLECACHE_UNLOCK();
+    return AUBIO_OK;
+  }
+#ifdef HAVE_MMAP
+  // leave room for the names of the files
+  if (strlen(path) + 32 >= PATH_MAX) {
+    AUBIO_ERR("samplecache: path of the cache directory is too long\n");
+    return AUBIO_FAIL;
+  }
+  if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+    AUBIO_ERR("samplecache: %s is not a directory\n", path);
+    return AUBIO_FAIL;
+  }
+  AUBIO_SAMPLECACHE_LOCK();
+  strncpy(aubio_samplecache_dir, path, PATH_MAX - 1);
+  AUBIO_SAMPLECACHE_UNLOCK();
+  return AUBIO_OK;
+#else
+  AUBIO_ERR("samplecache: cache directories are not supported on this "
+      "platform\n");
+  return AUBIO_FAIL;
+#endif
+}
+
+void aubio_samplecache_clear (void)
+{
+  aubio_clip_t **p, *c;
+  AUBIO_SAMPLECACHE_LOCK();
+  p = &aubio_samplecache_clips;
+  while (*p) {
+    c = *p;
+    if (c->refcount == 0) {
+      *p = c->next;
+      del_aubio_clip(c);
+    } else {
+      p = &c->next;
+    }
+  }
+  AUBIO_SAMPLECACHE_UNLOCK();
+}
+
+uint_t aubio_clip_get_length (const aubio_clip_t *clip)
+{
+  return clip->length;
+}
+
+uint_t aubio_clip_get_channels (const aubio_clip_t *clip)
+{
+  return clip->channels;
+}
+
+uint_t aubio_clip_get_samplerate (const aubio_clip_t *clip)
+{
+  return clip->samplerate;
+}
+
+const smpl_t *aubio_clip_get_data (const aubio_clip_t *clip, uint_t channel)
+{
+  if (channel >= clip->channels) return NULL;
+  return clip->data + (size_t)channel * clip->length;
+}
@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_SAMPLECACHE_H
+#define AUBIO_SAMPLECACHE_H
+
+/** \file
+
+  Process-wide cache of decoded samples
+
+  Samples are decoded once, the first time they are loaded, and shared by all
+  the objects using them, for instance several ::aubio_sampler_t playing the
+  same file. Loading a sample that is already in the cache only increments
+  its reference count, and costs no input / output.
+
+  Samples stay in the cache when they are released, so that loading them
+  again is immediate, until ::aubio_samplecache_clear or aubio_cleanup() is
+  called.
+
+  When a cache directory is set, decoded samples are also written there as
+  raw samples, and mapped in memory by the next processes loading them,
+  without decoding them again. A cached file is decoded again if its source
+  was modified since.
+
+  \code
+  // preload a clip before the audio thread starts
+  const aubio_clip_t *clip = aubio_samplecache_load ("click.wav", 44100);
+  // ... new_aubio_sampler, aubio_sampler_load ("click.wav") share it
+  aubio_samplecache_release (clip);
+  \endcode
+
+  \example synth/test-samplecache.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** decoded sample, shared through the cache */
+typedef struct _aubio_clip_t aubio_clip_t;
+
+/** load a sample, decoding it if it is not in the cache yet
+
+  \param uri path of the file to load
+  \param samplerate samplerate to decode the file at, or 0 to use its own
+
+  \return the decoded sample, to release with ::aubio_samplecache_release,
+  or NULL if the file could not be read
+
+*/
+const aubio_clip_t *aubio_samplecache_load (const char_t *uri,
+    uint_t samplerate);
+
+/** release a sample returned by ::aubio_samplecache_load
+
+  \param clip sample to release
+
+*/
+void aubio_samplecache_release (const aubio_clip_t *clip);
+
+/** set the directory where decoded samples are stored
+
+  \param path directory to store the decoded samples in, which must exist,
+  or NULL to keep them in memory only
+
+  \return 0 if successful, non-zero if the directory can not be used or if
+  files can not be mapped in memory on this platform
+
+*/
+uint_t aubio_samplecache_set_dir (const char_t *path);
+
+/** remove the samples no longer used from the cache
+
+  The samples still loaded are kept.
+
+*/
+void aubio_samplecache_clear (void);
+
+/** get the number of frames of a sample
+
+  \param clip sample, returned by ::aubio_samplecache_load
+
+  \return number of frames in each channel
+
+*/
+uint_t aubio_clip_get_length (const aubio_clip_t *clip);
+
+/** get the number of channels of a sample
+
+  \param clip sample, returned by ::aubio_samplecache_load
+
+  \return number of channels
+
+*/
+uint_t aubio_clip_get_channels (const aubio_clip_t *clip);
+
+/** get the samplerate of a sample
+
+  \param clip sample, returned by ::aubio_samplecache_load
+
+  \return samplerate the sample was decoded at
+
+*/
+uint_t aubio_clip_get_samplerate (const aubio_clip_t *clip);
+
+/** get the frames of a channel of a sample
+
+  \param clip sample, returned by ::aubio_samplecache_load
+  \param channel index of the channel
+
+  \return aubio_clip_get_length() frames, shared with the other users of the
+  sample and not to be modified, or NULL if the channel does not exist
+
+*/
+const smpl_t *aubio_clip_get_data (const aubio_clip_t *clip, uint_t channel);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_SAMPLECACHE_H */
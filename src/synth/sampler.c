@@ -22,17 +22,18 @@
 #include "aubio_priv.h"
 #include "fvec.h"
 #include "fmat.h"
-#include "io/source.h"
+#include "synth/samplecache.h"
 #include "synth/sampler.h"
 
 struct _aubio_sampler_t {
   uint_t samplerate;
   uint_t blocksize;
-  aubio_source_t *source;
-  fvec_t *source_output;
-  fmat_t *source_output_multi;
+  const aubio_clip_t *clip;     /**< loaded sample, shared with the cache */
   char_t *uri;
   uint_t playing;
+  uint_t max_voices;            /**< number of voices that can play at once */
+  uint_t *voice_pos;            /**< next frame of each voice */
+  uint_t *voice_active;         /**< 1 if the voice is playing */
 };
 
 aubio_sampler_t *new_aubio_sampler(uint_t samplerate, uint_t blocksize)
@@ -48,10 +49,9 @@ aubio_sampler_t *new_aubio_sampler(uint_t samplerate, uint_t blocksize)
   }
   s->samplerate = samplerate;
   s->blocksize = blocksize;
-  s->source_output = new_fvec(blocksize);
-  s->source_output_multi = new_fmat(4, blocksize);
-  s->source = NULL;
+  s->clip = NULL;
   s->playing = 0;
+  if (aubio_sampler_set_voices(s, 1)) goto beach;
   return s;
 beach:
   AUBIO_FREE(s);
@@ -60,28 +60,67 @@ beach:
 
 uint_t aubio_sampler_load( aubio_sampler_t * o, const char_t * uri )
 {
-  if (o->source) del_aubio_source(o->source);
+  uint_t i;
+  if (o->clip) aubio_samplecache_release(o->clip);
+  for (i = 0; i < o->max_voices; i++) {
+    o->voice_active[i] = 0;
+  }
+  o->playing = 0;
 
   if (o->uri) AUBIO_FREE(o->uri);
   o->uri = AUBIO_ARRAY(char_t, strnlen(uri, PATH_MAX) + 1);
   strncpy(o->uri, uri, strnlen(uri, PATH_MAX));
   o->uri[strnlen(uri, PATH_MAX)] = '\0';
 
-  o->source = new_aubio_source(uri, o->samplerate, o->blocksize);
-  if (o->source) return 0;
+  // decoded once, then shared with the other samplers loading the same file
+  o->clip = aubio_samplecache_load(uri, o->samplerate);
+  if (o->clip) return 0;
   AUBIO_ERR("sampler: failed loading %s", uri);
   return 1;
 }
 
+/* number of frames voice v adds to a block of length frames, stopping it at
+ * the end of the sample */
+static uint_t aubio_sampler_voice_frames ( aubio_sampler_t * o, uint_t v,
+    uint_t length )
+{
+  uint_t left = aubio_clip_get_length(o->clip) - o->voice_pos[v];
+  if (left <= length) {
+    o->voice_active[v] = 0;
+    return left;
+  }
+  return length;
+}
+
+/* stop playing once all the voices reached the end of the sample */
+static void aubio_sampler_update_playing ( aubio_sampler_t * o )
+{
+  uint_t v;
+  for (v = 0; v < o->max_voices; v++) {
+    if (o->voice_active[v]) return;
+  }
+  o->playing = 0;
+}
+
 void aubio_sampler_do ( aubio_sampler_t * o, const fvec_t * input, fvec_t * output)
 {
-  uint_t read = 0, i;
-  if (o->playing) {
-    aubio_source_do (o->source, o->source_output, &read);
-    for (i = 0; i < output->length; i++) {
-      output->data[i] += o->source_output->data[i];
+  uint_t i, c, v, n;
+  if (o->playing && o->clip) {
+    uint_t channels = aubio_clip_get_channels(o->clip);
+    smpl_t scale = 1. / channels;
+    for (v = 0; v < o->max_voices; v++) {
+      if (!o->voice_active[v]) continue;
+      n = aubio_sampler_voice_frames(o, v, output->length);
+      // down-mixed to mono, as read by aubio_source_do
+      for (c = 0; c < channels; c++) {
+        const smpl_t *data = aubio_clip_get_data(o->clip, c) + o->voice_pos[v];
+        for (i = 0; i < n; i++) {
+          output->data[i] += scale * data[i];
+        }
+      }
+      o->voice_pos[v] += n;
     }
-    if (read < o->blocksize) o->playing = 0;
+    aubio_sampler_update_playing(o);
   }
   if (input && input != output) {
     for (i = 0; i < output->length; i++) {
@@ -92,15 +131,25 @@ void aubio_sampler_do ( aubio_sampler_t * o, const fvec_t * input, fvec_t * outp
 
 void aubio_sampler_do_multi ( aubio_sampler_t * o, const fmat_t * input, fmat_t * output)
 {
-  uint_t read = 0, i, j;
-  if (o->playing) {
-    aubio_source_do_multi (o->source, o->source_output_multi, &read);
-    for (i = 0; i < output->height; i++) {
-      for (j = 0; j < output->length; j++) {
-        output->data[i][j] += o->source_output_multi->data[i][j];
+  uint_t i, j, v, n;
+  if (o->playing && o->clip) {
+    uint_t channels = aubio_clip_get_channels(o->clip);
+    for (v = 0; v < o->max_voices; v++) {
+      if (!o->voice_active[v]) continue;
+      n = aubio_sampler_voice_frames(o, v, output->length);
+      // a mono sample is played on all the channels
+      for (i = 0; i < output->height; i++) {
+        const smpl_t *data;
+        if (i >= channels && channels > 1) break;
+        data = aubio_clip_get_data(o->clip, MIN(i, channels - 1))
+          + o->voice_pos[v];
+        for (j = 0; j < n; j++) {
+          output->data[i][j] += data[j];
+        }
       }
+      o->voice_pos[v] += n;
     }
-    if ( read < o->blocksize ) o->playing = 0;
+    aubio_sampler_update_playing(o);
   }
   if (input && input != output) {
     for (i = 0; i < output->height; i++) {
@@ -124,22 +173,69 @@ uint_t aubio_sampler_set_playing ( aubio_sampler_t * o, uint_t playing )
 
 uint_t aubio_sampler_play ( aubio_sampler_t * o )
 {
-  aubio_source_seek (o->source, 0);
+  uint_t v, voice = 0;
+  if (!o->clip) {
+    AUBIO_ERR("sampler: no sample loaded\n");
+    return AUBIO_FAIL;
+  }
+  // a free voice, or else the one that played the longest
+  for (v = 0; v < o->max_voices; v++) {
+    if (!o->voice_active[v]) {
+      voice = v;
+      break;
+    }
+    if (o->voice_pos[v] > o->voice_pos[voice]) voice = v;
+  }
+  o->voice_pos[voice] = 0;
+  o->voice_active[voice] = 1;
   return aubio_sampler_set_playing (o, 1);
 }
 
 uint_t aubio_sampler_stop ( aubio_sampler_t * o )
 {
+  uint_t v;
+  for (v = 0; v < o->max_voices; v++) {
+    o->voice_active[v] = 0;
+  }
   return aubio_sampler_set_playing (o, 0);
 }
 
+uint_t aubio_sampler_set_voices ( aubio_sampler_t * o, uint_t voices )
+{
+  uint_t *pos, *active;
+  if ((sint_t)voices < 1) {
+    AUBIO_ERR("sampler: got %d voices, but can not be < 1\n", voices);
+    return AUBIO_FAIL;
+  }
+  pos = AUBIO_ARRAY(uint_t, voices);
+  active = AUBIO_ARRAY(uint_t, voices);
+  if (!pos || !active) {
+    if (pos) AUBIO_FREE(pos);
+    if (active) AUBIO_FREE(active);
+    return AUBIO_FAIL;
+  }
+  // the voices playing are stopped
+  if (o->voice_pos) AUBIO_FREE(o->voice_pos);
+  if (o->voice_active) AUBIO_FREE(o->voice_active);
+  o->voice_pos = pos;
+  o->voice_active = active;
+  o->max_voices = voices;
+  o->playing = 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_sampler_get_voices ( const aubio_sampler_t * o )
+{
+  return o->max_voices;
+}
+
 void del_aubio_sampler( aubio_sampler_t * o )
 {
-  if (o->source) {
-    del_aubio_source(o->source);
+  if (o->clip) {
+    aubio_samplecache_release(o->clip);
   }
   if (o->uri) AUBIO_FREE(o->uri);
-  del_fvec(o->source_output);
-  del_fmat(o->source_output_multi);
+  if (o->voice_pos) AUBIO_FREE(o->voice_pos);
+  if (o->voice_active) AUBIO_FREE(o->voice_active);
   AUBIO_FREE(o);
 }
@@ -27,6 +27,11 @@
 
   This file loads a sample and gets ready to play it.
 
+  Samples are decoded once into the cache of synth/samplecache.h, and shared
+  by all the samplers loading the same file, so that starting to play them
+  reads no file. A sampler can play several overlapping copies of its sample,
+  see aubio_sampler_set_voices().
+
   The `_do` function adds the new samples to the input, and write the result as
   the output.
 
@@ -114,6 +119,9 @@ uint_t aubio_sampler_set_playing ( aubio_sampler_t * o, uint_t playing );
 
   \return 0 if successful, 1 otherwise
 
+  The sample starts on a free voice. If all the voices are playing, the one
+  that started first is restarted.
+
 */
 uint_t aubio_sampler_play ( aubio_sampler_t * o );
 
@@ -123,9 +131,33 @@ uint_t aubio_sampler_play ( aubio_sampler_t * o );
 
   \return 0 if successful, 1 otherwise
 
+  All the voices are stopped.
+
 */
 uint_t aubio_sampler_stop ( aubio_sampler_t * o );
 
+/** set the number of voices of a sampler
+
+  \param o sampler, created by new_aubio_sampler()
+  \param voices number of copies of the sample that can play at once, 1 by
+  default
+
+  \return 0 if successful, 1 otherwise
+
+  The voices playing are stopped.
+
+*/
+uint_t aubio_sampler_set_voices ( aubio_sampler_t * o, uint_t voices );
+
+/** get the number of voices of a sampler
+
+  \param o sampler, created by new_aubio_sampler()
+
+  \return number of copies of the sample that can play at once
+
+*/
+uint_t aubio_sampler_get_voices ( const aubio_sampler_t * o );
+
 /** destroy ::aubio_sampler_t object
 
   \param o sampler, created by new_aubio_sampler()
@@ -22,10 +22,16 @@
 #include "aubio_priv.h"
 #include "fvec.h"
 #include "fmat.h"
+#include "cvec.h"
 #include "utils/parameter.h"
+#include "utils/simd_priv.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
 #include "synth/wavetable.h"
 
 #define WAVETABLE_LEN 4096
+/* number of parameter values computed at once */
+#define WAVETABLE_CHUNK 64
 
 struct _aubio_wavetable_t {
   uint_t samplerate;
@@ -79,27 +85,41 @@ static smpl_t interp_2(const fvec_t *input, smpl_t pos) {
   return a + frac * ( b - a );
 }
 
-void aubio_wavetable_do ( aubio_wavetable_t * s, const fvec_t * input, fvec_t * output)
+/* render the playing wavetable, a chunk of parameter values at a time */
+static void aubio_wavetable_render ( aubio_wavetable_t * s, fvec_t * output)
 {
-  uint_t i;
-  if (s->playing) {
-    smpl_t pos = s->last_pos;
-    for (i = 0; i < output->length; i++) {
-      smpl_t inc = aubio_parameter_get_next_value( s->freq );
-      inc *= (smpl_t)(s->wavetable_length) / (smpl_t) (s->samplerate);
-      pos += inc;
+  smpl_t buf[WAVETABLE_CHUNK];
+  smpl_t scale = (smpl_t)(s->wavetable_length) / (smpl_t)(s->samplerate);
+  smpl_t pos = s->last_pos;
+  fvec_t freqs, amps;
+  uint_t i, j, n;
+  for (j = 0; j < output->length; j += n) {
+    n = MIN(WAVETABLE_CHUNK, output->length - j);
+    freqs.data = buf;
+    freqs.length = n;
+    fvec_view (&amps, output, j, n);
+    aubio_parameter_fill_ramp ( s->freq, &freqs );
+    aubio_parameter_fill_ramp ( s->amp, &amps );
+    for (i = 0; i < n; i++) {
+      pos += freqs.data[i] * scale;
       while (pos > s->wavetable_length) {
         pos -= s->wavetable_length;
       }
-      output->data[i] = aubio_parameter_get_next_value ( s->amp );
-      output->data[i] *= interp_2(s->wavetable, pos);
+      amps.data[i] *= interp_2(s->wavetable, pos);
     }
-    s->last_pos = pos;
+  }
+  s->last_pos = pos;
+}
+
+void aubio_wavetable_do ( aubio_wavetable_t * s, const fvec_t * input, fvec_t * output)
+{
+  uint_t i;
+  if (s->playing) {
+    aubio_wavetable_render (s, output);
   } else {
-    for (i = 0; i < output->length; i++) {
-      aubio_parameter_get_next_value ( s->freq );
-      aubio_parameter_get_next_value ( s->amp );
-    }
+    // move the parameters forward, then silence the output
+    aubio_parameter_fill_ramp ( s->freq, output );
+    aubio_parameter_fill_ramp ( s->amp, output );
     fvec_zeros (output);
   }
   // add input to output if needed
@@ -114,26 +134,20 @@ void aubio_wavetable_do ( aubio_wavetable_t * s, const fvec_t * input, fvec_t *
 void aubio_wavetable_do_multi ( aubio_wavetable_t * s, const fmat_t * input, fmat_t * output)
 {
   uint_t i, j;
+  fvec_t row;
+  if (output->height == 0) return;
+  fmat_get_channel (output, 0, &row);
   if (s->playing) {
-    smpl_t pos = s->last_pos;
-    for (j = 0; j < output->length; j++) {
-      smpl_t inc = aubio_parameter_get_next_value( s->freq );
-      smpl_t amp = aubio_parameter_get_next_value ( s->amp );
-      inc *= (smpl_t)(s->wavetable_length) / (smpl_t) (s->samplerate);
-      pos += inc;
-      while (pos > s->wavetable_length) {
-        pos -= s->wavetable_length;
-      }
-      for (i = 0; i < output->height; i++) {
-        output->data[i][j] = amp * interp_2(s->wavetable, pos);
+    // render the first channel, then copy it to the others
+    aubio_wavetable_render (s, &row);
+    for (i = 1; i < output->height; i++) {
+      for (j = 0; j < output->length; j++) {
+        output->data[i][j] = output->data[0][j];
       }
     }
-    s->last_pos = pos;
   } else {
-    for (j = 0; j < output->length; j++) {
-      aubio_parameter_get_next_value ( s->freq );
-      aubio_parameter_get_next_value ( s->amp );
-    }
+    aubio_parameter_fill_ramp ( s->freq, &row );
+    aubio_parameter_fill_ramp ( s->amp, &row );
     fmat_zeros (output);
   }
   // add output to input if needed
@@ -203,3 +217,244 @@ void del_aubio_wavetable( aubio_wavetable_t * s )
   del_fvec(s->wavetable);
   AUBIO_FREE(s);
 }
+
+/* length of the tables of a wavetable bank, and number of harmonics in its
+ * first table; each following table holds half as many */
+#define WAVETABLE_BANK_LEN WAVETABLE_LEN
+#define WAVETABLE_BANK_HARMONICS (WAVETABLE_BANK_LEN / 8u)
+
+struct _aubio_wavetable_bank_t {
+  uint_t samplerate;
+  uint_t n_voices;              /**< number of voices */
+  uint_t n_lanes;               /**< n_voices rounded to the simd block */
+  uint_t n_tables;              /**< one per octave, the last one a sine */
+  fvec_t *tables;               /**< n_tables of WAVETABLE_BANK_LEN + 2 */
+  fvec_t *offset;               /**< start of the table of each voice */
+  fvec_t *pos;                  /**< position of each voice in its table */
+  fvec_t *inc;                  /**< increment of each voice */
+  fvec_t *dinc;                 /**< ramp of the increments */
+  fvec_t *amp;                  /**< amplitude of each voice */
+  fvec_t *damp;                 /**< ramp of the amplitudes */
+  fvec_t *freq_target;          /**< frequency set for each voice */
+  fvec_t *amp_target;           /**< amplitude set for each voice */
+};
+
+/* amplitude of the harmonic h of a shape, with sine phases */
+static smpl_t aubio_wavetable_bank_harmonic (uint_t shape, uint_t h)
+{
+  switch (shape) {
+    case 1: // saw
+      return ((h % 2) ? 2. : -2.) / (PI * h);
+    case 2: // square
+      return (h % 2) ? 4. / (PI * h) : 0.;
+    case 3: // triangle
+      return (h % 2) ? (((h / 2) % 2) ? -8. : 8.) / (PI * PI * h * h) : 0.;
+    default: // sine
+      return (h == 1) ? 1. : 0.;
+  }
+}
+
+/* fill the tables with an inverse fft of the harmonics of each octave */
+static uint_t aubio_wavetable_bank_fill (aubio_wavetable_bank_t *s,
+    uint_t shape)
+{
+  uint_t len = WAVETABLE_BANK_LEN, stride = len + 2, t, h, i;
+  aubio_fft_t *fft = new_aubio_fft(len);
+  cvec_t *spec = new_cvec(len);
+  fvec_t *table = new_fvec(len);
+  smpl_t peak = 0.;
+  if (!fft || !spec || !table) goto beach;
+  for (t = 0; t < s->n_tables; t++) {
+    smpl_t *dst = s->tables->data + t * stride;
+    cvec_zeros(spec);
+    for (h = 1; h <= (WAVETABLE_BANK_HARMONICS >> t); h++) {
+      smpl_t a = aubio_wavetable_bank_harmonic(shape, h);
+      // cos(x - pi / 2) = sin(x)
+      spec->norm[h] = ABS(a);
+      spec->phas[h] = (a < 0) ? PI / 2. : - PI / 2.;
+    }
+    aubio_fft_rdo(fft, spec, table);
+    for (i = 0; i < len; i++) {
+      dst[i] = table->data[i];
+    }
+    dst[len] = dst[0];
+    dst[len + 1] = dst[1];
+  }
+  // the same scale for all tables, so that the peaks stay within [-1, 1]
+  peak = MAX(fvec_max(s->tables), -fvec_min(s->tables));
+  if (peak > 0.) fvec_mul(s->tables, 1. / peak);
+  del_aubio_fft(fft);
+  del_cvec(spec);
+  del_fvec(table);
+  return AUBIO_OK;
+beach:
+  if (fft) del_aubio_fft(fft);
+  if (spec) del_cvec(spec);
+  if (table) del_fvec(table);
+  return AUBIO_FAIL;
+}
+
+aubio_wavetable_bank_t *new_aubio_wavetable_bank(const char_t *shape,
+    uint_t n_voices, uint_t samplerate)
+{
+  aubio_wavetable_bank_t *s = AUBIO_NEW(aubio_wavetable_bank_t);
+  uint_t shape_id;
+  if (!s) return NULL;
+  if (shape == NULL || strcmp(shape, "sine") == 0) {
+    shape_id = 0;
+  } else if (strcmp(shape, "saw") == 0) {
+    shape_id = 1;
+  } else if (strcmp(shape, "square") == 0) {
+    shape_id = 2;
+  } else if (strcmp(shape, "triangle") == 0) {
+    shape_id = 3;
+  } else {
+    AUBIO_ERR("wavetable_bank: unknown shape \"%s\"\n", shape);
+    goto beach;
+  }
+  if ((sint_t)n_voices < 1) {
+    AUBIO_ERR("wavetable_bank: can not create with %d voices\n", n_voices);
+    goto beach;
+  }
+  if ((sint_t)samplerate <= 0) {
+    AUBIO_ERR("wavetable_bank: can not create with samplerate %d\n",
+        samplerate);
+    goto beach;
+  }
+  s->samplerate = samplerate;
+  s->n_voices = n_voices;
+  s->n_lanes = (n_voices + AUBIO_SIMD_OSC_BLOCK - 1)
+    / AUBIO_SIMD_OSC_BLOCK * AUBIO_SIMD_OSC_BLOCK;
+  // a sine needs a single table, other shapes one per octave
+  s->n_tables = 1;
+  if (shape_id != 0) {
+    while ((WAVETABLE_BANK_HARMONICS >> (s->n_tables - 1)) > 1) {
+      s->n_tables++;
+    }
+  }
+  s->tables = new_fvec(s->n_tables * (WAVETABLE_BANK_LEN + 2));
+  s->offset = new_fvec(s->n_lanes);
+  s->pos = new_fvec(s->n_lanes);
+  s->inc = new_fvec(s->n_lanes);
+  s->dinc = new_fvec(s->n_lanes);
+  s->amp = new_fvec(s->n_lanes);
+  s->damp = new_fvec(s->n_lanes);
+  s->freq_target = new_fvec(s->n_lanes);
+  s->amp_target = new_fvec(s->n_lanes);
+  if (!s->tables || !s->offset || !s->pos || !s->inc || !s->dinc || !s->amp
+      || !s->damp || !s->freq_target || !s->amp_target) goto beach;
+  if (aubio_wavetable_bank_fill(s, shape_id) != AUBIO_OK) goto beach;
+  return s;
+beach:
+  del_aubio_wavetable_bank(s);
+  return NULL;
+}
+
+/* index of the table with the most harmonics below nyquist at freq */
+static uint_t aubio_wavetable_bank_table (const aubio_wavetable_bank_t *s,
+    smpl_t freq)
+{
+  uint_t t = 0;
+  smpl_t max_harmonic = (freq > 0.) ? s->samplerate / (2. * freq)
+    : WAVETABLE_BANK_HARMONICS;
+  while (t + 1 < s->n_tables
+      && (WAVETABLE_BANK_HARMONICS >> t) > max_harmonic) {
+    t++;
+  }
+  return t;
+}
+
+void aubio_wavetable_bank_do (aubio_wavetable_bank_t *s,
+    const fvec_t *input, fvec_t *output)
+{
+  uint_t v, n = output->length, stride = WAVETABLE_BANK_LEN + 2;
+  smpl_t scale = (smpl_t)WAVETABLE_BANK_LEN / s->samplerate;
+  fvec_zeros(output);
+  if (n == 0) return;
+  for (v = 0; v < s->n_voices; v++) {
+    smpl_t freq = s->inc->data[v] / scale, target = s->freq_target->data[v];
+    // the table of the highest frequency reached in this block
+    uint_t t = aubio_wavetable_bank_table(s, MAX(freq, target));
+    s->offset->data[v] = (smpl_t)(t * stride);
+    s->dinc->data[v] = (target * scale - s->inc->data[v]) / n;
+    s->damp->data[v] = (s->amp_target->data[v] - s->amp->data[v]) / n;
+  }
+  AUBIO_SIMD()->osc(s->tables->data, WAVETABLE_BANK_LEN, s->offset->data,
+      s->pos->data, s->inc->data, s->dinc->data, s->amp->data, s->damp->data,
+      s->n_lanes, output->data, n);
+  // land exactly on the targets, without the rounding errors of the ramps
+  for (v = 0; v < s->n_voices; v++) {
+    s->inc->data[v] = s->freq_target->data[v] * scale;
+    s->amp->data[v] = s->amp_target->data[v];
+  }
+  // add input to output if needed
+  if (input && input != output) {
+    for (v = 0; v < n; v++) {
+      output->data[v] += input->data[v];
+    }
+    fvec_clamp(output, 1.);
+  }
+}
+
+uint_t aubio_wavetable_bank_set_freq (aubio_wavetable_bank_t *s,
+    uint_t voice, smpl_t freq)
+{
+  if (voice >= s->n_voices) {
+    AUBIO_ERR("wavetable_bank: voice %d out of range\n", voice);
+    return AUBIO_FAIL;
+  }
+  if (!(freq >= 0. && freq <= s->samplerate / 2.)) {
+    AUBIO_ERR("wavetable_bank: frequency %f out of range\n", freq);
+    return AUBIO_FAIL;
+  }
+  s->freq_target->data[voice] = freq;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_wavetable_bank_get_freq (const aubio_wavetable_bank_t *s,
+    uint_t voice)
+{
+  if (voice >= s->n_voices) return 0.;
+  return s->freq_target->data[voice];
+}
+
+uint_t aubio_wavetable_bank_set_amp (aubio_wavetable_bank_t *s,
+    uint_t voice, smpl_t amp)
+{
+  if (voice >= s->n_voices) {
+    AUBIO_ERR("wavetable_bank: voice %d out of range\n", voice);
+    return AUBIO_FAIL;
+  }
+  if (isnan(amp)) {
+    AUBIO_ERR("wavetable_bank: invalid amplitude\n");
+    return AUBIO_FAIL;
+  }
+  s->amp_target->data[voice] = amp;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_wavetable_bank_get_amp (const aubio_wavetable_bank_t *s,
+    uint_t voice)
+{
+  if (voice >= s->n_voices) return 0.;
+  return s->amp_target->data[voice];
+}
+
+uint_t aubio_wavetable_bank_get_voices (const aubio_wavetable_bank_t *s)
+{
+  return s->n_voices;
+}
+
+void del_aubio_wavetable_bank (aubio_wavetable_bank_t *s)
+{
+  if (s->tables) del_fvec(s->tables);
+  if (s->offset) del_fvec(s->offset);
+  if (s->pos) del_fvec(s->pos);
+  if (s->inc) del_fvec(s->inc);
+  if (s->dinc) del_fvec(s->dinc);
+  if (s->amp) del_fvec(s->amp);
+  if (s->damp) del_fvec(s->damp);
+  if (s->freq_target) del_fvec(s->freq_target);
+  if (s->amp_target) del_fvec(s->amp_target);
+  AUBIO_FREE(s);
+}
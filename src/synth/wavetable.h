@@ -31,6 +31,7 @@
   the output.
 
   \example synth/test-wavetable.c
+  \example synth/test-wavetable_bank.c
 
 */
 
@@ -173,6 +174,110 @@ smpl_t aubio_wavetable_get_amp ( const aubio_wavetable_t * o);
 */
 void del_aubio_wavetable( aubio_wavetable_t * o );
 
+/** bank of wavetable oscillators
+
+  A bank renders many voices at once, each with its own frequency and
+  amplitude, summed into a single output. The voices are computed side by side
+  with the vector instructions of the running CPU.
+
+  The harmonic shapes are read from a set of band-limited tables, one per
+  octave, computed once when the bank is created. Each voice reads from the
+  table with the most harmonics that stay below the Nyquist frequency.
+
+*/
+typedef struct _aubio_wavetable_bank_t aubio_wavetable_bank_t;
+
+/** create new wavetable bank
+
+  \param shape shape of the waveform, `sine`, `saw`, `square` or `triangle`
+  \param n_voices number of voices
+  \param samplerate the sampling rate of the bank
+
+  \return the newly created ::aubio_wavetable_bank_t, or NULL on failure
+
+  All voices start silent, at 0 Hz.
+
+*/
+aubio_wavetable_bank_t * new_aubio_wavetable_bank(const char_t * shape,
+    uint_t n_voices, uint_t samplerate);
+
+/** process wavetable bank
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+  \param input input of the bank, to be added to the output
+  \param output output of the bank
+
+This function writes the sum of all voices to the output. The frequency and
+the amplitude of each voice move linearly to their new values over the length
+of the output. If `input` is not NULL and different from `output`, then the
+samples from `input` are added to the output.
+
+*/
+void aubio_wavetable_bank_do ( aubio_wavetable_bank_t * o,
+    const fvec_t * input, fvec_t * output);
+
+/** set the frequency of a voice
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+  \param voice index of the voice
+  \param freq new frequency, in Hz, between 0 and half the samplerate
+
+  \return 0 if successful, 1 otherwise
+
+*/
+uint_t aubio_wavetable_bank_set_freq ( aubio_wavetable_bank_t * o,
+    uint_t voice, smpl_t freq );
+
+/** get the frequency of a voice
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+  \param voice index of the voice
+
+  \return frequency reached at the end of the next block, in Hz
+
+*/
+smpl_t aubio_wavetable_bank_get_freq ( const aubio_wavetable_bank_t * o,
+    uint_t voice );
+
+/** set the amplitude of a voice
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+  \param voice index of the voice
+  \param amp new amplitude, 0 to silence the voice
+
+  \return 0 if successful, 1 otherwise
+
+*/
+uint_t aubio_wavetable_bank_set_amp ( aubio_wavetable_bank_t * o,
+    uint_t voice, smpl_t amp );
+
+/** get the amplitude of a voice
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+  \param voice index of the voice
+
+  \return amplitude reached at the end of the next block
+
+*/
+smpl_t aubio_wavetable_bank_get_amp ( const aubio_wavetable_bank_t * o,
+    uint_t voice );
+
+/** get the number of voices
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+
+  \return number of voices of the bank
+
+*/
+uint_t aubio_wavetable_bank_get_voices ( const aubio_wavetable_bank_t * o );
+
+/** destroy aubio_wavetable_bank_t object
+
+  \param o wavetable bank, created by new_aubio_wavetable_bank()
+
+*/
+void del_aubio_wavetable_bank( aubio_wavetable_bank_t * o );
+
 #ifdef __cplusplus
 }
 #endif
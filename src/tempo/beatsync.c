@@ -0,0 +1,169 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "musicutils.h"
+#include "utils/events.h"
+#include "tempo/tempo.h"
+#include "tempo/beatsync.h"
+
+struct _aubio_beatsync_t {
+  uint_t length;                /**< number of features */
+  fvec_t *sum;                  /**< sums over the current beat */
+  fvec_t *peak;                 /**< maxima over the current beat */
+  uint_t hops;                  /**< hops accumulated in the current beat */
+  fvec_t *mean;                 /**< means of the last closed beat */
+  fvec_t *max;                  /**< maxima of the last closed beat */
+  uint_t last_hops;             /**< hops of the last closed beat */
+  uint_t count;                 /**< beats closed since the last reset */
+  uint_t started;               /**< whether a beat was found since then */
+  uint_t last;                  /**< aubio_tempo_get_last on the last hop */
+  uint_t has_last;              /**< whether last was read since the reset */
+};
+
+aubio_beatsync_t *new_aubio_beatsync (uint_t length)
+{
+  aubio_beatsync_t *o;
+  if ((sint_t)length < 1) {
+    AUBIO_ERR("beatsync: got length %d, expected > 0\n", length);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_beatsync_t);
+  if (!o) return NULL;
+  o->length = length;
+  o->sum = new_fvec(length);
+  o->peak = new_fvec(length);
+  o->mean = new_fvec(length);
+  o->max = new_fvec(length);
+  if (!o->sum || !o->peak || !o->mean || !o->max) {
+    del_aubio_beatsync(o);
+    return NULL;
+  }
+  return o;
+}
+
+/* move the aggregates of the current beat to mean and max, and start a new
+ * one; returns 1 if the current beat had any hop */
+static uint_t aubio_beatsync_close (aubio_beatsync_t *o)
+{
+  uint_t i;
+  if (o->hops == 0) return 0;
+  for (i = 0; i < o->length; i++) {
+    o->mean->data[i] = o->sum->data[i] / (smpl_t)o->hops;
+  }
+  fvec_copy(o->peak, o->max);
+  o->last_hops = o->hops;
+  o->count++;
+  o->hops = 0;
+  return 1;
+}
+
+uint_t aubio_beatsync_do (aubio_beatsync_t *o, const fvec_t *features,
+    uint_t beat)
+{
+  uint_t i, closed = 0;
+  if (features->length != o->length) {
+    AUBIO_ERR("beatsync: got %d features, expected %d\n",
+        features->length, o->length);
+    return 0;
+  }
+  if (beat) {
+    closed = aubio_beatsync_close(o);
+    o->started = 1;
+  }
+  // the hops before the first beat are only part of one
+  if (!o->started) return 0;
+  if (o->hops == 0) {
+    fvec_copy(features, o->sum);
+    fvec_copy(features, o->peak);
+  } else {
+    for (i = 0; i < o->length; i++) {
+      smpl_t v = features->data[i];
+      o->sum->data[i] += v;
+      if (v > o->peak->data[i]) o->peak->data[i] = v;
+    }
+  }
+  o->hops++;
+  return closed;
+}
+
+uint_t aubio_beatsync_do_tempo (aubio_beatsync_t *o, const fvec_t *features,
+    aubio_tempo_t *tempo)
+{
+  uint_t last = aubio_tempo_get_last(tempo);
+  uint_t beat = o->has_last && last != o->last;
+  o->last = last;
+  o->has_last = 1;
+  return aubio_beatsync_do(o, features, beat);
+}
+
+const fvec_t *aubio_beatsync_get_mean (const aubio_beatsync_t *o)
+{
+  return o->mean;
+}
+
+const fvec_t *aubio_beatsync_get_max (const aubio_beatsync_t *o)
+{
+  return o->max;
+}
+
+uint_t aubio_beatsync_get_hops (const aubio_beatsync_t *o)
+{
+  return o->last_hops;
+}
+
+uint_t aubio_beatsync_get_count (const aubio_beatsync_t *o)
+{
+  return o->count;
+}
+
+void aubio_beatsync_reset (aubio_beatsync_t *o)
+{
+  fvec_zeros(o->mean);
+  fvec_zeros(o->max);
+  o->hops = 0;
+  o->last_hops = 0;
+  o->count = 0;
+  o->started = 0;
+  o->has_last = 0;
+}
+
+uint_t aubio_beatsync_get_memory_usage (const aubio_beatsync_t *o)
+{
+  return aubio_malloc_size(o) + fvec_get_memory_usage(o->sum)
+    + fvec_get_memory_usage(o->peak) + fvec_get_memory_usage(o->mean)
+    + fvec_get_memory_usage(o->max);
+}
+
+void del_aubio_beatsync (aubio_beatsync_t *o)
+{
+  if (o->sum)
+    del_fvec(o->sum);
+  if (o->peak)
+    del_fvec(o->peak);
+  if (o->mean)
+    del_fvec(o->mean);
+  if (o->max)
+    del_fvec(o->max);
+  AUBIO_FREE(o);
+}
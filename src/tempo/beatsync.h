@@ -0,0 +1,165 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_BEATSYNC_H
+#define AUBIO_BEATSYNC_H
+
+/** \file
+
+  Beat-synchronous aggregation of features
+
+  An ::aubio_beatsync_t accumulates a vector of features at each hop, for
+  instance mel energies followed by a centroid and a loudness, and computes
+  their mean and maximum over each beat, from the hop in which the beat
+  falls to the hop before the next one.
+
+  The sums are kept in the object, allocated once: accumulating a hop or
+  closing a beat never allocates memory.
+
+  Beats are given either as a flag, with aubio_beatsync_do(), or read from
+  the ::aubio_tempo_t analysing the same hops, with aubio_beatsync_do_tempo().
+
+  \example tempo/test-beatsync.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** beat-synchronous aggregator */
+typedef struct _aubio_beatsync_t aubio_beatsync_t;
+
+/** create beat-synchronous aggregator
+
+  \param length number of features accumulated at each hop
+
+  \return newly created ::aubio_beatsync_t, or NULL on failure
+
+*/
+aubio_beatsync_t *new_aubio_beatsync (uint_t length);
+
+/** accumulate the features of a hop
+
+  \param o aggregator, created by ::new_aubio_beatsync
+  \param features features of the hop, of `length` values
+  \param beat non-zero if a beat falls in this hop
+
+  \return 1 if the hop started a new beat after at least one hop of the
+  previous one; the aggregates of this previous beat can then be read with
+  aubio_beatsync_get_mean() and aubio_beatsync_get_max(). 0 otherwise, or if
+  `features` does not hold `length` values, in which case it is ignored.
+
+  The features of a hop starting a beat are accumulated into this new beat,
+  once the previous one is closed. The hops before the first beat, which
+  may only hold the end of a beat, are not accumulated.
+
+*/
+uint_t aubio_beatsync_do (aubio_beatsync_t *o, const fvec_t *features,
+    uint_t beat);
+
+/** accumulate the features of a hop, at the beats of a tempo object
+
+  \param o aggregator, created by ::new_aubio_beatsync
+  \param features features of the hop, of `length` values
+  \param tempo tempo object, after aubio_tempo_do() was called on the hop
+
+  \return same as aubio_beatsync_do()
+
+  A beat is found when aubio_tempo_get_last() changes, so that beats found
+  in silent hops, not reported in the output of aubio_tempo_do(), still
+  close the current beat.
+
+*/
+uint_t aubio_beatsync_do_tempo (aubio_beatsync_t *o, const fvec_t *features,
+    aubio_tempo_t *tempo);
+
+/** get the means of the last beat
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+  \return mean of each feature over the hops of the last closed beat, zeros
+  until one was closed; the vector belongs to `o`, and is overwritten when
+  the next beat is closed
+
+*/
+const fvec_t *aubio_beatsync_get_mean (const aubio_beatsync_t *o);
+
+/** get the maxima of the last beat
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+  \return maximum of each feature over the hops of the last closed beat,
+  see aubio_beatsync_get_mean()
+
+*/
+const fvec_t *aubio_beatsync_get_max (const aubio_beatsync_t *o);
+
+/** get the length of the last beat
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+  \return number of hops aggregated in the last closed beat, 0 if none was
+  closed
+
+*/
+uint_t aubio_beatsync_get_hops (const aubio_beatsync_t *o);
+
+/** get the number of beats closed
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+  \return beats closed since the creation or the last reset
+
+*/
+uint_t aubio_beatsync_get_count (const aubio_beatsync_t *o);
+
+/** discard the current beat and the aggregates of the last one
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+  As after the creation, the hops are then ignored until the next beat. With
+  aubio_beatsync_do_tempo(), the next hop only reads the position of the
+  last beat, and can not start one.
+
+*/
+void aubio_beatsync_reset (aubio_beatsync_t *o);
+
+/** get memory used by the aggregator
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+  \return number of bytes allocated by `o`
+
+*/
+uint_t aubio_beatsync_get_memory_usage (const aubio_beatsync_t *o);
+
+/** delete beat-synchronous aggregator
+
+  \param o aggregator, created by ::new_aubio_beatsync
+
+*/
+void del_aubio_beatsync (aubio_beatsync_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_BEATSYNC_H */
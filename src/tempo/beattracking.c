@@ -20,7 +20,15 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
 #include "mathutils.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "mathutils_priv.h"
+#include "utils/simd_priv.h"
+#include "utils/denormal_priv.h"
+#include "utils/workspace_priv.h"
 #include "tempo/beattracking.h"
 
 /** define to 1 to print out tracking difficulties */
@@ -29,18 +37,73 @@
 uint_t fvec_gettimesig (fvec_t * acf, uint_t acflen, uint_t gp);
 void aubio_beattracking_checkstate (aubio_beattracking_t * bt);
 
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_beattracking_lock = SRWLOCK_INIT;
+#define AUBIO_BEATTRACKING_LOCK() do { AUBIO_RT_CHECK("beattracking lock"); \
+  AcquireSRWLockExclusive(&aubio_beattracking_lock); } while (0)
+#define AUBIO_BEATTRACKING_UNLOCK() \
+  ReleaseSRWLockExclusive(&aubio_beattracking_lock)
+#else
+#include <pthread.h>
+static pthread_mutex_t aubio_beattracking_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_BEATTRACKING_LOCK() do { AUBIO_RT_CHECK("beattracking lock"); \
+  pthread_mutex_lock(&aubio_beattracking_mutex); } while (0)
+#define AUBIO_BEATTRACKING_UNLOCK() \
+  pthread_mutex_unlock(&aubio_beattracking_mutex)
+#endif
+
+/** weighting tables, which only depend on the sizes and the rayleigh
+  parameter of a tracker */
+typedef enum {
+  aubio_beattracking_rayleigh,  /**< weighting of the beat periods */
+  aubio_beattracking_alignment, /**< weighting of the detection function */
+} aubio_beattracking_table_type;
+
+/** one table shared by all the trackers using the same parameters */
+typedef struct _aubio_beattracking_table_t {
+  aubio_beattracking_table_type type;
+  smpl_t rayparam;
+  fvec_t *table;                /**< read-only weights */
+  uint_t refcount;              /**< number of trackers using table */
+  struct _aubio_beattracking_table_t *next;
+} aubio_beattracking_table_t;
+
+/** buffers only used during aubio_beattracking_do, owned by each tracker or,
+  in compact mode, borrowed from a pool for the duration of a call */
+typedef struct _aubio_beattracking_scratch_t {
+  uint_t winlen;
+  fvec_t *dfrev;         /** reversed onset detection function */
+  fvec_t *acf;           /** vector for autocorrelation function (of current detection function frame) */
+  fvec_t *acfout;        /** store result of passing acf through s.i.c.f.b. */
+  fvec_t *phwv;          /** gaussian weighting for beat alignment in context dependant model */
+  fvec_t *phout;
+  fvec_t *frame_salience; /** autocorrelation of the end of the last frame */
+  fvec_t *dfcentered;    /** detection function minus its mean */
+  double *acf_prefix;    /** prefix sums of acf, used by the comb filterbanks */
+  aubio_fft_t *acf_fft;  /** fft of the autocorrelation, NULL for direct sums */
+  fvec_t *acf_padded;    /** zero padded frame, input of acf_fft */
+  fvec_t *acf_spec;      /** power spectrum of acf_padded */
+  struct _aubio_beattracking_scratch_t *next;
+} aubio_beattracking_scratch_t;
+
+/** list of shared tables, protected by aubio_beattracking_lock */
+static aubio_beattracking_table_t *aubio_beattracking_tables = NULL;
+/** buffers not used by any call, protected by aubio_beattracking_lock */
+static aubio_beattracking_scratch_t *aubio_beattracking_pool = NULL;
+/** number of trackers in compact mode, protected by aubio_beattracking_lock */
+static uint_t aubio_beattracking_n_compact = 0;
+
 struct _aubio_beattracking_t
 {
   uint_t hop_size;       /** length of one tempo detection function sample, in audio samples */
   uint_t samplerate;     /** samplerate of the original signal */
-  fvec_t *rwv;           /** rayleigh weighting for beat period in general model */
-  fvec_t *dfwv;          /** exponential weighting for beat alignment in general model */
+  const fvec_t *rwv;     /** rayleigh weighting for beat period in general model, shared */
+  const fvec_t *dfwv;    /** exponential weighting for beat alignment in general model, shared */
   fvec_t *gwv;           /** gaussian weighting for beat period in context dependant model */
-  fvec_t *phwv;          /** gaussian weighting for beat alignment in context dependant model */
-  fvec_t *dfrev;         /** reversed onset detection function */
-  fvec_t *acf;           /** vector for autocorrelation function (of current detection function frame) */
-  fvec_t *acfout;        /** store result of passing acf through s.i.c.f.b. */
-  fvec_t *phout;
+  aubio_beattracking_scratch_t *s; /** buffers of the current call */
+  uint_t compact;        /** 1 if s is borrowed from the pool by each call */
+  smpl_t confidence;     /** confidence of the last period found */
   uint_t timesig;        /** time signature of input, set to zero until context dependent model activated */
   uint_t step;
   uint_t rayparam;       /** Rayleigh parameter */
@@ -53,8 +116,43 @@ struct _aubio_beattracking_t
   smpl_t rp;
   smpl_t rp1;
   smpl_t rp2;
+  uint_t incremental;    /** 1 if the autocorrelation is computed hop by hop */
+  double *acf_sum;       /** unnormalized autocorrelation of the next frame */
+  uint_t *acf_lags;      /** first lag of the overlap to compute at each hop */
+  uint_t acf_next;       /** next expected position in the block */
+  fvec_t *salience;      /** decaying average of the recent autocorrelation */
+  smpl_t salience_decay; /** weight of the past frames in salience */
+  smpl_t stability;      /** correlation of the last frame with salience */
+  smpl_t relock;         /** stability below which the model restarts */
+  smpl_t prior;          /** tempo favoured by the rayleigh weighting, in bpm */
+  uint_t lag_min;        /** shortest beat period searched */
+  uint_t lag_max;        /** longest beat period searched */
+  smpl_t min_bp;         /** shorter beat periods are doubled */
+  smpl_t min_bpm;        /** slowest tempo searched */
+  smpl_t max_bpm;        /** fastest tempo searched */
 };
 
+static void aubio_beattracking_comb (const aubio_beattracking_t * bt,
+    uint_t numelem, uint_t normalize, fvec_t * acfout);
+
+static void aubio_beattracking_salience (aubio_beattracking_t * bt,
+    const fvec_t * dfframe);
+
+static uint_t aubio_beattracking_set_rayleigh (aubio_beattracking_t * bt,
+    smpl_t rayparam);
+
+static const fvec_t *aubio_beattracking_table_acquire (
+    aubio_beattracking_table_type type, uint_t length, smpl_t rayparam);
+
+static void aubio_beattracking_table_release (const fvec_t * table);
+
+static aubio_beattracking_scratch_t *new_aubio_beattracking_scratch (
+    uint_t winlen, uint_t pooled);
+
+static void del_aubio_beattracking_scratch (aubio_beattracking_scratch_t * s);
+
+static void aubio_beattracking_count_compact (uint_t compact);
+
 aubio_beattracking_t *
 new_aubio_beattracking (uint_t winlen, uint_t hop_size, uint_t samplerate)
 {
@@ -65,10 +163,8 @@ new_aubio_beattracking (uint_t winlen, uint_t hop_size, uint_t samplerate)
     return NULL;
   }
 
-  uint_t i = 0;
   /* default value for rayleigh weighting - sets preferred tempo to 120bpm */
   smpl_t rayparam = 60. * samplerate / 120. / hop_size;
-  smpl_t dfwvnorm = EXP ((LOG (2.0) / rayparam) * (winlen + 2));
   /* length over which beat period is found [128] */
   uint_t laglen = winlen / 4;
   /* step increment - both in detection function samples -i.e. 11.6ms or
@@ -86,26 +182,29 @@ new_aubio_beattracking (uint_t winlen, uint_t hop_size, uint_t samplerate)
 
   p->rayparam = rayparam;
   p->step = step;
-  p->rwv = new_fvec (laglen);
   p->gwv = new_fvec (laglen);
-  p->dfwv = new_fvec (winlen);
-  p->dfrev = new_fvec (winlen);
-  p->acf = new_fvec (winlen);
-  p->acfout = new_fvec (laglen);
-  p->phwv = new_fvec (2 * laglen);
-  p->phout = new_fvec (winlen);
+  p->salience = new_fvec (laglen);
+  p->salience_decay = .75;
+  p->stability = 0.;
+  p->relock = 0.;
+  p->prior = 120.;
+  p->lag_min = 1;
+  p->lag_max = laglen > 2 ? laglen - 2 : 0;
+  /* tempi above 206 bpm at 44100 Hz with 512 hops are doubled */
+  p->min_bp = 25.;
+  p->min_bpm = 60. * samplerate / hop_size / MAX (1, p->lag_max);
+  p->max_bpm = 60. * samplerate / hop_size / p->lag_min;
 
   p->timesig = 0;
 
+  p->s = new_aubio_beattracking_scratch (winlen, 0);
   /* exponential weighting, dfwv = 0.5 when i =  43 */
-  for (i = 0; i < winlen; i++) {
-    p->dfwv->data[i] = (EXP ((LOG (2.0) / rayparam) * (i + 1)))
-        / dfwvnorm;
-  }
-
-  for (i = 0; i < (laglen); i++) {
-    p->rwv->data[i] = ((smpl_t) (i + 1.) / SQR ((smpl_t) rayparam)) *
-        EXP ((-SQR ((smpl_t) (i + 1.)) / (2. * SQR ((smpl_t) rayparam))));
+  p->dfwv = aubio_beattracking_table_acquire (aubio_beattracking_alignment,
+      winlen, rayparam);
+  if (!p->gwv || !p->salience || !p->s || !p->dfwv
+      || aubio_beattracking_set_rayleigh (p, rayparam)) {
+    del_aubio_beattracking (p);
+    return NULL;
   }
 
   return p;
@@ -115,26 +214,266 @@ new_aubio_beattracking (uint_t winlen, uint_t hop_size, uint_t samplerate)
 void
 del_aubio_beattracking (aubio_beattracking_t * p)
 {
-  del_fvec (p->rwv);
-  del_fvec (p->gwv);
-  del_fvec (p->dfwv);
-  del_fvec (p->dfrev);
-  del_fvec (p->acf);
-  del_fvec (p->acfout);
-  del_fvec (p->phwv);
-  del_fvec (p->phout);
+  if (p->compact) aubio_beattracking_count_compact (0);
+  if (p->s) del_aubio_beattracking_scratch (p->s);
+  aubio_beattracking_table_release (p->rwv);
+  aubio_beattracking_table_release (p->dfwv);
+  if (p->gwv) del_fvec (p->gwv);
+  if (p->salience) del_fvec (p->salience);
+  if (p->acf_sum) AUBIO_FREE (p->acf_sum);
+  if (p->acf_lags) AUBIO_FREE (p->acf_lags);
   AUBIO_FREE (p);
 }
 
+uint_t
+aubio_beattracking_get_memory_usage (const aubio_beattracking_t * bt)
+{
+  /* the weighting tables are shared, and so are the buffers in compact mode */
+  uint_t n = aubio_malloc_size (bt) + aubio_malloc_size (bt->gwv)
+    + aubio_malloc_size (bt->salience) + aubio_malloc_size (bt->acf_sum)
+    + aubio_malloc_size (bt->acf_lags);
+  if (bt->s && !bt->compact) {
+    const aubio_beattracking_scratch_t *s = bt->s;
+    n += aubio_malloc_size (s) + aubio_malloc_size (s->dfrev)
+      + aubio_malloc_size (s->acf) + aubio_malloc_size (s->acfout)
+      + aubio_malloc_size (s->phwv) + aubio_malloc_size (s->phout)
+      + aubio_malloc_size (s->frame_salience)
+      + aubio_malloc_size (s->dfcentered) + aubio_malloc_size (s->acf_prefix)
+      + aubio_malloc_size (s->acf_padded) + aubio_malloc_size (s->acf_spec);
+    if (s->acf_fft) n += aubio_fft_get_memory_usage (s->acf_fft);
+  }
+  return n;
+}
+
+static aubio_beattracking_scratch_t *
+new_aubio_beattracking_scratch (uint_t winlen, uint_t pooled)
+{
+  uint_t laglen = winlen / 4;
+  /* the buffers of the pool are borrowed by any thread, not from a workspace */
+  size_t where = 0, *offset = pooled ? NULL : &where;
+  aubio_beattracking_scratch_t *s = AUBIO_NEW (aubio_beattracking_scratch_t);
+  if (!s) return NULL;
+  s->winlen = winlen;
+  s->dfrev = new_aubio_scratch (winlen, offset);
+  s->acf = new_aubio_scratch (winlen, offset);
+  s->acfout = new_aubio_scratch (laglen, offset);
+  s->phwv = new_aubio_scratch (2 * laglen, offset);
+  s->phout = new_aubio_scratch (winlen, offset);
+  s->frame_salience = new_aubio_scratch (laglen, offset);
+  s->dfcentered = new_aubio_scratch (winlen, offset);
+  s->acf_prefix = AUBIO_ARRAY (double, winlen + 1);
+  if (!s->dfrev || !s->acf || !s->acfout || !s->phwv || !s->phout
+      || !s->frame_salience || !s->dfcentered || !s->acf_prefix) {
+    goto beach;
+  }
+  /* allocated here rather than by each call to aubio_autocorr */
+  if (winlen >= AUBIO_AUTOCORR_FFT_MIN) {
+    uint_t size = aubio_next_power_of_two (2 * winlen);
+    s->acf_fft = new_aubio_fft (size);
+    s->acf_padded = new_aubio_scratch (size, offset);
+    s->acf_spec = new_aubio_scratch (size, offset);
+  }
+  return s;
+
+beach:
+  del_aubio_beattracking_scratch (s);
+  return NULL;
+}
+
+static void
+del_aubio_beattracking_scratch (aubio_beattracking_scratch_t * s)
+{
+  if (s->dfrev) del_fvec (s->dfrev);
+  if (s->acf) del_fvec (s->acf);
+  if (s->acfout) del_fvec (s->acfout);
+  if (s->phwv) del_fvec (s->phwv);
+  if (s->phout) del_fvec (s->phout);
+  if (s->frame_salience) del_fvec (s->frame_salience);
+  if (s->dfcentered) del_fvec (s->dfcentered);
+  if (s->acf_prefix) AUBIO_FREE (s->acf_prefix);
+  if (s->acf_fft) del_aubio_fft (s->acf_fft);
+  if (s->acf_padded) del_fvec (s->acf_padded);
+  if (s->acf_spec) del_fvec (s->acf_spec);
+  AUBIO_FREE (s);
+}
+
+/* borrow buffers of winlen from the pool, or create them */
+static aubio_beattracking_scratch_t *
+aubio_beattracking_scratch_acquire (uint_t winlen)
+{
+  aubio_beattracking_scratch_t **p, *s = NULL;
+  AUBIO_BEATTRACKING_LOCK ();
+  for (p = &aubio_beattracking_pool; *p; p = &(*p)->next) {
+    if ((*p)->winlen == winlen) {
+      s = *p;
+      *p = s->next;
+      break;
+    }
+  }
+  AUBIO_BEATTRACKING_UNLOCK ();
+  if (!s) {
+    s = new_aubio_beattracking_scratch (winlen, 1);
+  }
+  return s;
+}
+
+/* give buffers back to the pool, for the next call of any tracker */
+static void
+aubio_beattracking_scratch_release (aubio_beattracking_scratch_t * s)
+{
+  AUBIO_BEATTRACKING_LOCK ();
+  if (aubio_beattracking_n_compact > 0) {
+    s->next = aubio_beattracking_pool;
+    aubio_beattracking_pool = s;
+    s = NULL;
+  }
+  AUBIO_BEATTRACKING_UNLOCK ();
+  if (s) del_aubio_beattracking_scratch (s);
+}
+
+/* count a tracker entering or leaving compact mode, and free the pool once
+ * no tracker uses it */
+static void
+aubio_beattracking_count_compact (uint_t compact)
+{
+  aubio_beattracking_scratch_t *pool = NULL, *s;
+  AUBIO_BEATTRACKING_LOCK ();
+  if (compact) {
+    aubio_beattracking_n_compact++;
+  } else if (--aubio_beattracking_n_compact == 0) {
+    pool = aubio_beattracking_pool;
+    aubio_beattracking_pool = NULL;
+  }
+  AUBIO_BEATTRACKING_UNLOCK ();
+  while (pool) {
+    s = pool;
+    pool = s->next;
+    del_aubio_beattracking_scratch (s);
+  }
+}
+
+uint_t
+aubio_beattracking_set_compact (aubio_beattracking_t * bt, uint_t compact)
+{
+  compact = compact ? 1 : 0;
+  if (compact == bt->compact) return AUBIO_OK;
+  if (compact) {
+    del_aubio_beattracking_scratch (bt->s);
+    bt->s = NULL;
+  } else {
+    bt->s = new_aubio_beattracking_scratch (bt->dfwv->length, 0);
+    if (!bt->s) return AUBIO_FAIL;
+  }
+  aubio_beattracking_count_compact (compact);
+  bt->compact = compact;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_beattracking_get_compact (const aubio_beattracking_t * bt)
+{
+  return bt->compact;
+}
+
+static const fvec_t *
+aubio_beattracking_table_acquire (aubio_beattracking_table_type type,
+    uint_t length, smpl_t rayparam)
+{
+  aubio_beattracking_table_t *shared;
+  fvec_t *table;
+  uint_t i;
+  AUBIO_BEATTRACKING_LOCK ();
+  for (shared = aubio_beattracking_tables; shared; shared = shared->next) {
+    if (shared->type == type && shared->table->length == length
+        && shared->rayparam == rayparam) {
+      shared->refcount++;
+      AUBIO_BEATTRACKING_UNLOCK ();
+      return shared->table;
+    }
+  }
+  /* computed while holding the lock, the tables are short */
+  table = new_fvec (length);
+  shared = AUBIO_NEW (aubio_beattracking_table_t);
+  if (!table || !shared) {
+    AUBIO_BEATTRACKING_UNLOCK ();
+    if (table) del_fvec (table);
+    if (shared) AUBIO_FREE (shared);
+    return NULL;
+  }
+  if (type == aubio_beattracking_rayleigh) {
+    for (i = 0; i < length; i++) {
+      table->data[i] = ((smpl_t) (i + 1.) / SQR ((smpl_t) rayparam)) *
+          EXP ((-SQR ((smpl_t) (i + 1.)) / (2. * SQR ((smpl_t) rayparam))));
+    }
+  } else {
+    smpl_t dfwvnorm = EXP ((LOG (2.0) / rayparam) * (length + 2));
+    for (i = 0; i < length; i++) {
+      table->data[i] = (EXP ((LOG (2.0) / rayparam) * (i + 1))) / dfwvnorm;
+    }
+  }
+  shared->type = type;
+  shared->rayparam = rayparam;
+  shared->table = table;
+  shared->refcount = 1;
+  shared->next = aubio_beattracking_tables;
+  aubio_beattracking_tables = shared;
+  AUBIO_BEATTRACKING_UNLOCK ();
+  return table;
+}
+
+static void
+aubio_beattracking_table_release (const fvec_t * table)
+{
+  aubio_beattracking_table_t **p, *shared;
+  if (!table) return;
+  AUBIO_BEATTRACKING_LOCK ();
+  for (p = &aubio_beattracking_tables; *p; p = &(*p)->next) {
+    if ((*p)->table == table) {
+      shared = *p;
+      if (--shared->refcount == 0) {
+        *p = shared->next;
+        del_fvec (shared->table);
+        AUBIO_FREE (shared);
+      }
+      break;
+    }
+  }
+  AUBIO_BEATTRACKING_UNLOCK ();
+}
+
+/* track beats with the buffers of bt->s */
+static void
+aubio_beattracking_do_frame (aubio_beattracking_t * bt,
+    const fvec_t * dfframe, fvec_t * output);
 
 void
 aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframe,
     fvec_t * output)
 {
+  aubio_denormal_guard_t guard;
+  if (bt->compact) {
+    bt->s = aubio_beattracking_scratch_acquire (bt->dfwv->length);
+    if (!bt->s) {
+      fvec_zeros (output);
+      return;
+    }
+  }
+  aubio_denormal_enter (&guard);
+  aubio_beattracking_do_frame (bt, dfframe, output);
+  aubio_denormal_leave (&guard);
+  if (bt->compact) {
+    aubio_beattracking_scratch_release (bt->s);
+    bt->s = NULL;
+  }
+}
+
+static void
+aubio_beattracking_do_frame (aubio_beattracking_t * bt,
+    const fvec_t * dfframe, fvec_t * output)
+{
 
   uint_t i, k;
   uint_t step = bt->step;
-  uint_t laglen = bt->rwv->length;
   uint_t winlen = bt->dfwv->length;
   uint_t maxindex = 0;
   //number of harmonics in shift invariant comb filterbank
@@ -145,14 +484,39 @@ aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframe,
   smpl_t bp;                    // beat period
   uint_t a, b;                  // used to build shift invariant comb filterbank
   uint_t kmax;                  // number of elements used to find beat phase
+  AUBIO_STATS_BEGIN ("beattracking");
+
+  /* update the tempo salience, restart the model if it changed */
+  aubio_beattracking_salience (bt, dfframe);
 
   /* copy dfframe, apply detection function weighting, and revert */
-  fvec_copy (dfframe, bt->dfrev);
-  fvec_weight (bt->dfrev, bt->dfwv);
-  fvec_rev (bt->dfrev);
+  fvec_copy (dfframe, bt->s->dfrev);
+  fvec_weight (bt->s->dfrev, bt->dfwv);
+  fvec_rev (bt->s->dfrev);
 
   /* compute autocorrelation function */
-  aubio_autocorr (dfframe, bt->acf);
+  if (bt->incremental && bt->acf_next == step) {
+    /* all the products were accumulated by aubio_beattracking_update */
+    for (i = 0; i < winlen; i++) {
+      bt->s->acf->data[i] = bt->acf_sum[i] / (smpl_t) (winlen - i);
+    }
+  } else if (bt->s->acf_fft && bt->s->acf_padded && bt->s->acf_spec) {
+    aubio_autocorr_fft_do (bt->s->acf_fft, bt->s->acf_padded, bt->s->acf_spec,
+        dfframe, bt->s->acf);
+  } else {
+    aubio_autocorr (dfframe, bt->s->acf);
+  }
+  if (bt->incremental) {
+    for (i = 0; i < winlen; i++) {
+      bt->acf_sum[i] = 0.;
+    }
+    bt->acf_next = 0;
+    /* prefix sums, reused by the filterbank of checkstate */
+    bt->s->acf_prefix[0] = 0.;
+    for (i = 0; i < winlen; i++) {
+      bt->s->acf_prefix[i + 1] = bt->s->acf_prefix[i] + bt->s->acf->data[i];
+    }
+  }
 
   /* if timesig is unknown, use metrically unbiased version of filterbank */
   if (!bt->timesig) {
@@ -162,30 +526,42 @@ aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframe,
   }
 
   /* first and last output values are left intentionally as zero */
-  fvec_zeros (bt->acfout);
+  fvec_zeros (bt->s->acfout);
 
   /* compute shift invariant comb filterbank */
-  for (i = 1; i < laglen - 1; i++) {
-    for (a = 1; a <= numelem; a++) {
-      for (b = 1; b < 2 * a; b++) {
-        bt->acfout->data[i] += bt->acf->data[i * a + b - 1]
-            * 1. / (2. * a - 1.);
+  if (bt->incremental) {
+    aubio_beattracking_comb (bt, numelem, 1, bt->s->acfout);
+  } else {
+    for (i = bt->lag_min; i <= bt->lag_max; i++) {
+      for (a = 1; a <= numelem; a++) {
+        for (b = 1; b < 2 * a; b++) {
+          bt->s->acfout->data[i] += bt->s->acf->data[i * a + b - 1]
+              * 1. / (2. * a - 1.);
+        }
       }
     }
   }
   /* apply Rayleigh weight */
-  fvec_weight (bt->acfout, bt->rwv);
+  fvec_weight (bt->s->acfout, bt->rwv);
 
   /* find non-zero Rayleigh period */
-  maxindex = fvec_max_elem (bt->acfout);
-  if (maxindex > 0 && maxindex < bt->acfout->length - 1) {
-    bt->rp = fvec_quadratic_peak_pos (bt->acfout, maxindex);
+  maxindex = fvec_max_elem (bt->s->acfout);
+  if (maxindex > 0 && maxindex < bt->s->acfout->length - 1) {
+    bt->rp = fvec_quadratic_peak_pos (bt->s->acfout, maxindex);
   } else {
     bt->rp = bt->rayparam;
   }
 
   /* activate biased filterbank */
   aubio_beattracking_checkstate (bt);
+  bt->confidence = 0.;
+  if (bt->gp) {
+    smpl_t acf_sum = fvec_sum (bt->s->acfout);
+    if (acf_sum != 0.) {
+      bt->confidence = fvec_quadratic_peak_mag (bt->s->acfout, bt->gp)
+        / acf_sum;
+    }
+  }
 #if 0                           // debug metronome mode
   bt->bp = 36.9142;
 #endif
@@ -194,6 +570,7 @@ aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframe,
 
   if (bp == 0) {
     fvec_zeros(output);
+    AUBIO_STATS_END ();
     return;
   }
 
@@ -201,29 +578,29 @@ aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframe,
   kmax = FLOOR (winlen / bp);
 
   /* initialize output */
-  fvec_zeros (bt->phout);
+  fvec_zeros (bt->s->phout);
   for (i = 0; i < bp; i++) {
     for (k = 0; k < kmax; k++) {
       uint_t idx = i + (uint_t) ROUND (bp * k);
-      if (idx < bt->dfrev->length)
-        bt->phout->data[i] += bt->dfrev->data[idx];
+      if (idx < bt->s->dfrev->length)
+        bt->s->phout->data[i] += bt->s->dfrev->data[idx];
 #if AUBIO_BEAT_WARNINGS
       else
         AUBIO_WRN ("[tempo] out of bounds index %d", idx);
 #endif
     }
   }
-  fvec_weight (bt->phout, bt->phwv);
+  fvec_weight (bt->s->phout, bt->s->phwv);
 
   /* find Rayleigh period */
-  maxindex = fvec_max_elem (bt->phout);
+  maxindex = fvec_max_elem (bt->s->phout);
   if (maxindex >= winlen - 1) {
 #if AUBIO_BEAT_WARNINGS
     AUBIO_WRN ("no idea what this groove's phase is\n");
 #endif /* AUBIO_BEAT_WARNINGS */
     phase = step - bt->lastbeat;
   } else {
-    phase = fvec_quadratic_peak_pos (bt->phout, maxindex);
+    phase = fvec_quadratic_peak_pos (bt->s->phout, maxindex);
   }
   /* take back one frame delay */
   phase += 1.;
@@ -270,6 +647,290 @@ aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframe,
   bt->lastbeat = beat;
   /* store the number of beats in this frame as the first element */
   output->data[0] = i;
+  AUBIO_STATS_END ();
+}
+
+/* shift invariant comb filterbank, using the prefix sums of acf: each
+ * harmonic a sums the 2a - 1 lags starting at i * a, optionally weighted by
+ * 1 / (2a - 1) */
+static void
+aubio_beattracking_comb (const aubio_beattracking_t * bt, uint_t numelem,
+    uint_t normalize, fvec_t * acfout)
+{
+  uint_t i, a, acflen = bt->s->acf->length;
+  const double *prefix = bt->s->acf_prefix;
+  for (i = bt->lag_min; i <= bt->lag_max; i++) {
+    double sum = 0.;
+    for (a = 1; a <= numelem; a++) {
+      uint_t start = i * a, end = i * a + 2 * a - 1;
+      if (end > acflen) end = acflen;
+      if (start >= end) break;
+      sum += (prefix[end] - prefix[start]) / (normalize ? 2. * a - 1. : 1.);
+    }
+    acfout->data[i] = (smpl_t) sum;
+  }
+}
+
+/* autocorrelation of the last two steps of the frame, compared to the
+ * average of the previous ones, then added to that average. Unlike acf,
+ * which spans the whole frame, it reflects a change of tempo within a step. */
+static void
+aubio_beattracking_salience (aubio_beattracking_t * bt,
+    const fvec_t * dfframe)
+{
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  fvec_t *frame = bt->s->frame_salience, *salience = bt->salience;
+  uint_t i, n = frame->length, winlen = dfframe->length;
+  uint_t len = MIN (2 * bt->step, winlen - n), start = winlen - len;
+  smpl_t *x = bt->s->dfcentered->data;
+  smpl_t past = fvec_sum (salience), sum;
+  smpl_t mf, ms;
+  asmp_t cov = 0., vf = 0., vs = 0.;
+  /* remove the mean so that the noise floor does not correlate */
+  fvec_copy (dfframe, bt->s->dfcentered);
+  ops->add (x, -fvec_mean (bt->s->dfcentered), winlen);
+  fvec_zeros (frame);
+  for (i = bt->lag_min; i <= bt->lag_max; i++) {
+    frame->data[i] = MAX (0., ops->dot (x + start, x + start - i, len));
+  }
+  sum = fvec_sum (frame);
+  if (sum > 0.) fvec_mul (frame, 1. / sum);
+  bt->stability = 0.;
+  if (past > 0. && sum > 0.) {
+    /* pearson correlation of the two vectors */
+    mf = fvec_mean (frame);
+    ms = fvec_mean (salience);
+    for (i = 0; i < n; i++) {
+      smpl_t df = frame->data[i] - mf, ds = salience->data[i] - ms;
+      cov += df * ds;
+      vf += df * df;
+      vs += ds * ds;
+    }
+    if (vf > 0. && vs > 0.) bt->stability = cov / SQRT (vf * vs);
+  }
+  if (past > 0. && sum > 0. && bt->stability < bt->relock) {
+    /* the tempo changed: forget the context dependant model and the past
+     * frames, so that the general model follows the new period at once */
+    bt->gp = 0;
+    bt->timesig = 0;
+    bt->counter = 0;
+    bt->flagstep = 0;
+    past = 0.;
+  }
+  if (past > 0.) {
+    for (i = 0; i < n; i++) {
+      salience->data[i] = bt->salience_decay * salience->data[i]
+        + (1. - bt->salience_decay) * frame->data[i];
+    }
+  } else {
+    fvec_copy (frame, salience);
+  }
+}
+
+void
+aubio_beattracking_update (aubio_beattracking_t * bt, const fvec_t * dfframe,
+    uint_t pos)
+{
+  uint_t i, j, winlen = bt->dfwv->length, step = bt->step;
+  uint_t overlap = winlen - step, last = overlap + pos;
+  const smpl_t *data = dfframe->data;
+  double *sum = bt->acf_sum;
+  if (!bt->incremental) return;
+  if (pos >= step || pos != bt->acf_next || dfframe->length != winlen) {
+    /* out of sequence, use the full computation on the next frame */
+    bt->acf_next = step + 1;
+    return;
+  }
+  /* products of the new value with all the previous ones */
+  for (i = 0; i <= last; i++) {
+    sum[i] += data[last - i] * data[last];
+  }
+  /* products within the overlap with the previous frame, for a few lags */
+  for (i = bt->acf_lags[pos]; i < bt->acf_lags[pos + 1]; i++) {
+    double tmp = 0.;
+    for (j = i; j < overlap; j++) {
+      tmp += data[j - i] * data[j];
+    }
+    sum[i] += tmp;
+  }
+  bt->acf_next++;
+}
+
+/* split the lags of the overlap between two frames so that each hop
+ * computes about the same number of products */
+static void
+aubio_beattracking_split_lags (aubio_beattracking_t * bt)
+{
+  uint_t step = bt->step, overlap = bt->dfwv->length - step, lag = 0, pos;
+  double total = .5 * overlap * (overlap + 1.), cost = 0.;
+  for (pos = 0; pos < step; pos++) {
+    while (lag < overlap && cost < total * pos / step) {
+      cost += overlap - lag;
+      lag++;
+    }
+    bt->acf_lags[pos] = lag;
+  }
+  bt->acf_lags[step] = overlap;
+}
+
+uint_t
+aubio_beattracking_set_incremental (aubio_beattracking_t * bt,
+    uint_t incremental)
+{
+  uint_t i, winlen = bt->dfwv->length, step = bt->step;
+  if (incremental && !bt->acf_sum) {
+    /* only allocated by the trackers using them */
+    bt->acf_sum = AUBIO_ARRAY (double, winlen);
+    bt->acf_lags = AUBIO_ARRAY (uint_t, step + 1);
+    if (!bt->acf_sum || !bt->acf_lags) {
+      if (bt->acf_sum) AUBIO_FREE (bt->acf_sum);
+      if (bt->acf_lags) AUBIO_FREE (bt->acf_lags);
+      bt->acf_sum = NULL;
+      bt->acf_lags = NULL;
+      return AUBIO_FAIL;
+    }
+    aubio_beattracking_split_lags (bt);
+  }
+  bt->incremental = incremental ? 1 : 0;
+  if (bt->acf_sum) {
+    for (i = 0; i < winlen; i++) {
+      bt->acf_sum[i] = 0.;
+    }
+  }
+  /* wait for the start of the next block */
+  bt->acf_next = step + 1;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_beattracking_get_incremental (const aubio_beattracking_t * bt)
+{
+  return bt->incremental;
+}
+
+/* rayleigh weighting of the beat periods, peaking at rayparam */
+static uint_t
+aubio_beattracking_set_rayleigh (aubio_beattracking_t * bt, smpl_t rayparam)
+{
+  const fvec_t *rwv = aubio_beattracking_table_acquire (
+      aubio_beattracking_rayleigh, bt->gwv->length, rayparam);
+  if (!rwv) return AUBIO_FAIL;
+  aubio_beattracking_table_release (bt->rwv);
+  bt->rwv = rwv;
+  bt->rayparam = rayparam;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_beattracking_set_bpm_range (aubio_beattracking_t * bt, smpl_t min_bpm,
+    smpl_t max_bpm)
+{
+  uint_t laglen = bt->rwv->length;
+  /* beat period, in detection function samples, of one beat per minute */
+  smpl_t one_bpm = 60. * bt->samplerate / bt->hop_size;
+  smpl_t lag_min, lag_max;
+  if (!(min_bpm > 0. && max_bpm > min_bpm)) {
+    AUBIO_ERR ("beattracking: invalid bpm range %f - %f\n", min_bpm, max_bpm);
+    return AUBIO_FAIL;
+  }
+  lag_min = FLOOR (one_bpm / max_bpm);
+  lag_max = CEIL (one_bpm / min_bpm);
+  if (lag_min < 1. || lag_max > laglen - 2. || lag_min >= lag_max) {
+    AUBIO_ERR ("beattracking: bpm range %f - %f is outside %f - %f\n",
+        min_bpm, max_bpm, one_bpm / (laglen - 2.), one_bpm);
+    return AUBIO_FAIL;
+  }
+  bt->lag_min = (uint_t) lag_min;
+  bt->lag_max = (uint_t) lag_max;
+  /* only double the periods found below the range, for instance by the
+   * quadratic interpolation of the peak */
+  bt->min_bp = MIN (25., lag_min - 1.);
+  bt->min_bpm = min_bpm;
+  bt->max_bpm = max_bpm;
+  return AUBIO_OK;
+}
+
+smpl_t
+aubio_beattracking_get_min_bpm (const aubio_beattracking_t * bt)
+{
+  return bt->min_bpm;
+}
+
+smpl_t
+aubio_beattracking_get_max_bpm (const aubio_beattracking_t * bt)
+{
+  return bt->max_bpm;
+}
+
+uint_t
+aubio_beattracking_set_prior (aubio_beattracking_t * bt, smpl_t bpm)
+{
+  if (!(bpm > 0.)) {
+    AUBIO_ERR ("beattracking: prior should be a positive tempo, got %f\n",
+        bpm);
+    return AUBIO_FAIL;
+  }
+  if (aubio_beattracking_set_rayleigh (bt,
+        60. * bt->samplerate / bpm / bt->hop_size)) {
+    return AUBIO_FAIL;
+  }
+  bt->prior = bpm;
+  return AUBIO_OK;
+}
+
+smpl_t
+aubio_beattracking_get_prior (const aubio_beattracking_t * bt)
+{
+  return bt->prior;
+}
+
+const fvec_t *
+aubio_beattracking_get_salience (const aubio_beattracking_t * bt)
+{
+  return bt->salience;
+}
+
+smpl_t
+aubio_beattracking_get_stability (const aubio_beattracking_t * bt)
+{
+  return bt->stability;
+}
+
+uint_t
+aubio_beattracking_set_salience_decay (aubio_beattracking_t * bt,
+    smpl_t decay)
+{
+  if (!(decay >= 0. && decay < 1.)) {
+    AUBIO_ERR ("beattracking: salience decay should be in [0, 1[, got %f\n",
+        decay);
+    return AUBIO_FAIL;
+  }
+  bt->salience_decay = decay;
+  return AUBIO_OK;
+}
+
+smpl_t
+aubio_beattracking_get_salience_decay (const aubio_beattracking_t * bt)
+{
+  return bt->salience_decay;
+}
+
+uint_t
+aubio_beattracking_set_relock (aubio_beattracking_t * bt, smpl_t threshold)
+{
+  if (!(threshold >= 0. && threshold <= 1.)) {
+    AUBIO_ERR ("beattracking: relock threshold should be in [0, 1], got %f\n",
+        threshold);
+    return AUBIO_FAIL;
+  }
+  bt->relock = threshold;
+  return AUBIO_OK;
+}
+
+smpl_t
+aubio_beattracking_get_relock (const aubio_beattracking_t * bt)
+{
+  return bt->relock;
 }
 
 uint_t
@@ -306,18 +967,22 @@ aubio_beattracking_checkstate (aubio_beattracking_t * bt)
   smpl_t rp1 = bt->rp1;
   smpl_t rp2 = bt->rp2;
   uint_t laglen = bt->rwv->length;
-  uint_t acflen = bt->acf->length;
+  uint_t acflen = bt->s->acf->length;
   uint_t step = bt->step;
-  fvec_t *acf = bt->acf;
-  fvec_t *acfout = bt->acfout;
+  fvec_t *acf = bt->s->acf;
+  fvec_t *acfout = bt->s->acfout;
 
   if (gp) {
     // compute shift invariant comb filterbank
     fvec_zeros (acfout);
-    for (i = 1; i < laglen - 1; i++) {
-      for (a = 1; a <= bt->timesig; a++) {
-        for (b = 1; b < 2 * a; b++) {
-          acfout->data[i] += acf->data[i * a + b - 1];
+    if (bt->incremental) {
+      aubio_beattracking_comb (bt, bt->timesig, 0, acfout);
+    } else {
+      for (i = bt->lag_min; i <= bt->lag_max; i++) {
+        for (a = 1; a <= bt->timesig; a++) {
+          for (b = 1; b < 2 * a; b++) {
+            acfout->data[i] += acf->data[i * a + b - 1];
+          }
         }
       }
     }
@@ -369,33 +1034,33 @@ aubio_beattracking_checkstate (aubio_beattracking_t * bt)
     flagconst = 0;
     bp = gp;
     /* flat phase weighting */
-    fvec_ones (bt->phwv);
+    fvec_ones (bt->s->phwv);
   } else if (bt->timesig) {
     /* context dependant model */
     bp = gp;
     /* gaussian phase weighting */
     if (step > bt->lastbeat) {
       for (j = 0; j < 2 * laglen; j++) {
-        bt->phwv->data[j] =
+        bt->s->phwv->data[j] =
             EXP (-.5 * SQR ((smpl_t) (1. + j - step +
                     bt->lastbeat)) / (bp / 8.));
       }
     } else {
       //AUBIO_DBG("NOT using phase weighting as step is %d and lastbeat %d \n",
       //                step,bt->lastbeat);
-      fvec_ones (bt->phwv);
+      fvec_ones (bt->s->phwv);
     }
   } else {
     /* initial state */
     bp = rp;
     /* flat phase weighting */
-    fvec_ones (bt->phwv);
+    fvec_ones (bt->s->phwv);
   }
 
   /* do some further checks on the final bp value */
 
   /* if tempo is > 206 bpm, half it */
-  while (0 < bp && bp < 25) {
+  while (0 < bp && bp < bt->min_bp) {
 #if AUBIO_BEAT_WARNINGS
     AUBIO_WRN ("doubling from %f (%f bpm) to %f (%f bpm)\n",
         bp, 60.*44100./512./bp, bp/2., 60.*44100./512./bp/2. );
@@ -444,11 +1109,5 @@ aubio_beattracking_get_bpm (const aubio_beattracking_t * bt)
 smpl_t
 aubio_beattracking_get_confidence (const aubio_beattracking_t * bt)
 {
-  if (bt->gp) {
-    smpl_t acf_sum = fvec_sum(bt->acfout);
-    if (acf_sum != 0.) {
-      return fvec_quadratic_peak_mag (bt->acfout, bt->gp) / acf_sum;
-    }
-  }
-  return 0.;
+  return bt->confidence;
 }
@@ -67,6 +67,200 @@ aubio_beattracking_t * new_aubio_beattracking(uint_t winlen, uint_t hop_size,
 void aubio_beattracking_do (aubio_beattracking_t * bt, const fvec_t * dfframes,
     fvec_t * out);
 
+/** update the autocorrelation with a new detection function value
+
+  \param bt beat tracking object
+  \param dfframes detection function frame, as passed to
+  aubio_beattracking_do()
+  \param pos position of the new value in the current block, which was
+  written at `dfframes[winlen - winlen / 4 + pos]`
+
+  In incremental mode, this function should be called after each new value
+  of the detection function, so that the autocorrelation of the next frame
+  is computed over the hops of the block instead of all at once in
+  aubio_beattracking_do(). It does nothing otherwise.
+
+*/
+void aubio_beattracking_update (aubio_beattracking_t * bt,
+    const fvec_t * dfframes, uint_t pos);
+
+/** enable or disable incremental autocorrelation
+
+  \param bt beat tracking object
+  \param incremental 1 to enable, 0 to disable [0]
+  \return 0 if successful, non-zero otherwise
+
+  When enabled, the autocorrelation accumulated by
+  aubio_beattracking_update() is used for each complete block, and the comb
+  filterbanks are computed from its prefix sums.
+
+*/
+uint_t aubio_beattracking_set_incremental (aubio_beattracking_t * bt,
+    uint_t incremental);
+
+/** get incremental mode, 1 if enabled, 0 otherwise
+
+  \param bt beat tracking object
+
+*/
+uint_t aubio_beattracking_get_incremental (const aubio_beattracking_t * bt);
+
+/** enable or disable compact mode
+
+  \param bt beat tracking object
+  \param compact 1 to enable, 0 to disable [0]
+  \return 0 if successful, non-zero otherwise
+
+  The weighting tables only depend on the window size and the rayleigh
+  parameter, and are always shared by the trackers using the same values. In
+  compact mode, the tracker also drops its scratch buffers, the largest part
+  of its memory, and borrows buffers of the same size from a pool for the
+  duration of each call to aubio_beattracking_do(). The pool holds one set of
+  buffers per call running at the same time, so that many trackers processed
+  by a few threads share a few sets of buffers.
+
+  Borrowing the buffers takes a lock and may allocate, so that compact mode
+  should not be used in a real-time callback.
+
+*/
+uint_t aubio_beattracking_set_compact (aubio_beattracking_t * bt,
+    uint_t compact);
+
+/** get compact mode, 1 if enabled, 0 otherwise
+
+  \param bt beat tracking object
+
+*/
+uint_t aubio_beattracking_get_compact (const aubio_beattracking_t * bt);
+
+/** set the range of tempi searched
+
+  \param bt beat tracking object
+  \param min_bpm slowest tempo, in beats per minute
+  \param max_bpm fastest tempo, in beats per minute
+
+  \return 0 if successful, non-zero if the range is empty or does not fit
+  within the beat periods of `winlen / 4` detection function samples
+
+  Only the beat periods within the range go through the comb filterbanks,
+  which saves computations and avoids picking an octave of the tempo outside
+  the range. By default, all periods from 1 to `winlen / 4 - 2` are searched.
+
+*/
+uint_t aubio_beattracking_set_bpm_range (aubio_beattracking_t * bt,
+    smpl_t min_bpm, smpl_t max_bpm);
+
+/** get the slowest tempo searched
+
+  \param bt beat tracking object
+
+  \return slowest tempo, in beats per minute
+
+*/
+smpl_t aubio_beattracking_get_min_bpm (const aubio_beattracking_t * bt);
+
+/** get the fastest tempo searched
+
+  \param bt beat tracking object
+
+  \return fastest tempo, in beats per minute
+
+*/
+smpl_t aubio_beattracking_get_max_bpm (const aubio_beattracking_t * bt);
+
+/** set the most likely tempo
+
+  \param bt beat tracking object
+  \param bpm tempo at which the rayleigh weighting of the beat periods
+  peaks, in beats per minute [120]
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_beattracking_set_prior (aubio_beattracking_t * bt, smpl_t bpm);
+
+/** get the most likely tempo
+
+  \param bt beat tracking object
+
+  \return tempo at which the rayleigh weighting peaks, in beats per minute
+
+*/
+smpl_t aubio_beattracking_get_prior (const aubio_beattracking_t * bt);
+
+/** get the tempo salience
+
+  \param bt beat tracking object
+
+  \return vector of `winlen / 4` elements, where element `i` is the salience
+  of a beat period of `i` detection function samples
+
+  The salience is the output of the shift invariant comb filterbank of each
+  block, normalized to sum to 1, and averaged over the previous blocks with
+  an exponential decay. It is updated by each call to
+  aubio_beattracking_do().
+
+*/
+const fvec_t * aubio_beattracking_get_salience (const aubio_beattracking_t * bt);
+
+/** get the tempo stability of the last block
+
+  \param bt beat tracking object
+
+  \return correlation between the comb filterbank output of the last block
+  and the salience of the previous ones, between -1 and 1
+
+  The stability stays close to 1 while the tempo is steady, and drops as
+  soon as a block with a different periodicity is processed.
+
+*/
+smpl_t aubio_beattracking_get_stability (const aubio_beattracking_t * bt);
+
+/** set the decay of the tempo salience
+
+  \param bt beat tracking object
+  \param decay weight of the past blocks, between 0 and 1 [0.75]
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_beattracking_set_salience_decay (aubio_beattracking_t * bt,
+    smpl_t decay);
+
+/** get the decay of the tempo salience
+
+  \param bt beat tracking object
+
+  \return current decay
+
+*/
+smpl_t aubio_beattracking_get_salience_decay (const aubio_beattracking_t * bt);
+
+/** set the stability threshold below which the tracker restarts
+
+  \param bt beat tracking object
+  \param threshold stability below which the tracker forgets its current
+  tempo, between 0 and 1, or 0 to never restart [0]
+
+  \return 0 if successful, non-zero otherwise
+
+  After a restart, the confidence drops to 0 and the beat period follows the
+  new tempo from the next block, instead of waiting for the context
+  dependant model to notice the change.
+
+*/
+uint_t aubio_beattracking_set_relock (aubio_beattracking_t * bt,
+    smpl_t threshold);
+
+/** get the stability threshold below which the tracker restarts
+
+  \param bt beat tracking object
+
+  \return current threshold, 0 if disabled
+
+*/
+smpl_t aubio_beattracking_get_relock (const aubio_beattracking_t * bt);
+
 /** get current beat period in samples
 
   \param bt beat tracking object
@@ -107,6 +301,20 @@ smpl_t aubio_beattracking_get_bpm(const aubio_beattracking_t * bt);
 */
 smpl_t aubio_beattracking_get_confidence(const aubio_beattracking_t * bt);
 
+/** get the memory used by a beat tracking object
+
+  \param bt beat tracking object
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  The weighting tables are shared with the other trackers of the same
+  parameters and are not counted, nor are the scratch buffers in compact
+  mode, see aubio_beattracking_set_compact().
+
+*/
+uint_t aubio_beattracking_get_memory_usage (const aubio_beattracking_t * bt);
+
 /** delete beat tracking object
 
   \param p beat tracking object
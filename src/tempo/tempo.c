@@ -20,12 +20,19 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "lvec.h"
 #include "cvec.h"
+#include "fmat.h"
 #include "spectral/specdesc.h"
 #include "tempo/beattracking.h"
 #include "spectral/phasevoc.h"
 #include "onset/peakpicker.h"
+#include "temporal/filterbank_iir.h"
+#include "temporal/halfband.h"
 #include "mathutils.h"
+#include "utils/pending_priv.h"
+#include "utils/events.h"
+#include "utils/history.h"
 #include "tempo/tempo.h"
 
 /* structure to store object state */
@@ -51,17 +58,343 @@ struct _aubio_tempo_t {
   sint_t delay;                  /** delay to remove to last beat, in samples */
   uint_t last_tatum;             /** time of latest detected tatum, in samples */
   uint_t tatum_signature;        /** number of tatum between each beats */
+  char_t *method;                /** tempo method, to create channel objects */
+  uint_t buf_size;               /** buffer size, to create channel objects */
+  aubio_tempo_t **channels;      /** objects tracking channels 1 and up */
+  uint_t n_channels;             /** number of objects in channels */
+  uint_t gating;                 /** skip the spectral analysis of silent hops */
+  uint_t gated;                  /** number of silent hops skipped in a row */
+  uint_t deferred;               /** post parameters to pending */
+  aubio_pending_t pending;       /** parameters posted by other threads */
+  aubio_events_t *events;        /** queue receiving the beats, or NULL */
+  uint_t events_channel;         /** channel of the pushed events */
+  u64_t frames;                  /** total_frames, without wrapping around */
+  aubio_history_t *of_history;   /** last values of of, or NULL */
+  aubio_history_t *bpm_history;  /** last tempo estimates */
+  aubio_history_t *confidence_history; /** last tempo confidences */
+  aubio_decimator_t *decimator;  /** decimator of the envelope mode, or NULL */
+  aubio_filterbank_iir_t *bands; /** band filters of the envelope mode */
+  fvec_t *decimated;             /** decimated hop of the envelope mode */
+  fvec_t *env;                   /** envelope of each band */
+  fvec_t *env_old;               /** compressed envelopes of the last hop */
 };
 
+/** ids of the parameters posted when deferred */
+enum {
+  AUBIO_TEMPO_THRESHOLD,
+  AUBIO_TEMPO_SILENCE,
+  AUBIO_TEMPO_DELAY
+};
+
+/** number of silent hops given to the descriptor as empty spectra when
+  gating, so that its past spectra are those of a silence */
+#define AUBIO_TEMPO_GATED_HOPS 2
+
+/** number of bands of the envelope mode, and their lowest and highest
+  center frequencies, in Hz */
+#define AUBIO_TEMPO_ENV_BANDS 6
+#define AUBIO_TEMPO_ENV_LOW 80.
+#define AUBIO_TEMPO_ENV_HIGH 4000.
+/** lowest samplerate the envelope mode decimates to, in Hz */
+#define AUBIO_TEMPO_ENV_RATE 8000
+/** compression of the envelopes, as log(1 + lambda * env) */
+#define AUBIO_TEMPO_ENV_LAMBDA 100.
+
+/* create the decimator and the band filters of the envelope mode */
+static uint_t aubio_tempo_new_envelope (aubio_tempo_t *o);
+
+/* compute o->of from the envelopes of the bands of input */
+static void aubio_tempo_do_envelope (aubio_tempo_t *o, const fvec_t * input);
+
+/* clear the filters of the envelope mode */
+static void aubio_tempo_reset_envelope (aubio_tempo_t *o);
+
+/* make sure o->channels holds at least n_channels - 1 objects */
+static uint_t aubio_tempo_alloc_channels (aubio_tempo_t *o, uint_t n_channels);
+
+/* copy the parameters of o to the channel object c */
+static void aubio_tempo_sync_channel (aubio_tempo_t *o, aubio_tempo_t *c);
+
+/* track beats from the onset detection function stored in o->of, reading
+   the level of input from stats if it is not NULL */
+static void aubio_tempo_do_of (aubio_tempo_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * tempo);
+
+/* apply the parameters posted since the last hop */
+static void aubio_tempo_apply_pending (aubio_tempo_t *o);
+
 /* execute tempo detection function on iput buffer */
 void aubio_tempo_do(aubio_tempo_t *o, const fvec_t * input, fvec_t * tempo)
+{
+  aubio_tempo_do_stats (o, input, NULL, tempo);
+}
+
+void aubio_tempo_do_stats (aubio_tempo_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * tempo)
+{
+  aubio_frame_stats_t level;
+  AUBIO_STATS_BEGIN ("tempo");
+  aubio_tempo_apply_pending (o);
+  if (o->gating && !stats) {
+    aubio_frame_stats_do (input, o->silence, &level);
+    stats = &level;
+  }
+  if (o->gating && stats->db_spl < o->silence) {
+    // the detection function of a silent hop is taken as 0
+    if (o->bands) {
+      // the followers start from a silence on the next loud hop
+      if (o->gated == 0) aubio_tempo_reset_envelope (o);
+      o->gated = 1;
+    } else {
+      aubio_pvoc_skip (o->pv, input);
+      if (o->gated < AUBIO_TEMPO_GATED_HOPS) {
+        cvec_zeros (o->fftgrain);
+        aubio_specdesc_do (o->od, o->fftgrain, o->of);
+        o->gated++;
+      }
+    }
+    o->of->data[0] = 0.;
+  } else if (o->bands) {
+    aubio_tempo_do_envelope (o, input);
+    o->gated = 0;
+  } else {
+    aubio_pvoc_do (o->pv, input, o->fftgrain);
+    aubio_specdesc_do (o->od, o->fftgrain, o->of);
+    o->gated = 0;
+  }
+  aubio_tempo_do_of (o, input, stats, tempo);
+  AUBIO_STATS_END ();
+}
+
+void aubio_tempo_do_spectrum (aubio_tempo_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, fvec_t * tempo)
+{
+  aubio_tempo_do_spectrum_stats (o, input, fftgrain, NULL, tempo);
+}
+
+void aubio_tempo_do_spectrum_stats (aubio_tempo_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, const aubio_frame_stats_t * stats,
+    fvec_t * tempo)
+{
+  if (o->bands) {
+    // the envelope mode reads the samples only
+    aubio_tempo_do_stats (o, input, stats, tempo);
+    return;
+  }
+  if (fftgrain->length != o->fftgrain->length) {
+    AUBIO_ERR ("tempo: expected a spectrum of length %d, got %d\n",
+        o->fftgrain->length, fftgrain->length);
+    aubio_tempo_do_stats (o, input, stats, tempo);
+    return;
+  }
+  aubio_tempo_apply_pending (o);
+  aubio_specdesc_do (o->od, fftgrain, o->of);
+  aubio_tempo_do_of (o, input, stats, tempo);
+}
+
+void aubio_tempo_do_multi (aubio_tempo_t *o, const fmat_t * input,
+    fvec_t * tempo)
+{
+  uint_t ch;
+  fvec_t input_ch, tempo_ch;
+  if (input->length != o->hop_size) {
+    AUBIO_ERR ("tempo: expected input frames of length %d, got %d\n",
+        o->hop_size, input->length);
+    return;
+  }
+  if (tempo->length < input->height) {
+    AUBIO_ERR ("tempo: output of length %d is too short for %d channels\n",
+        tempo->length, input->height);
+    return;
+  }
+  if (aubio_tempo_alloc_channels (o, input->height) != AUBIO_OK) {
+    return;
+  }
+  for (ch = 0; ch < input->height; ch++) {
+    aubio_tempo_t *c = o;
+    fmat_get_channel (input, ch, &input_ch);
+    fvec_view (&tempo_ch, tempo, ch, 1);
+    if (ch > 0) {
+      c = o->channels[ch - 1];
+      aubio_tempo_sync_channel (o, c);
+      c->events_channel = ch;
+    }
+    aubio_tempo_do (c, &input_ch, &tempo_ch);
+  }
+}
+
+void aubio_tempo_do_block (aubio_tempo_t *o, const fvec_t * input)
+{
+  uint_t i;
+  smpl_t out[2];
+  fvec_t hop, tempo;
+  if (input->length % o->hop_size != 0) {
+    AUBIO_ERR ("tempo: expected a block of a multiple of %d frames, got %d\n",
+        o->hop_size, input->length);
+    return;
+  }
+  hop.length = o->hop_size;
+  tempo.length = 2;
+  tempo.data = out;
+  for (i = 0; i < input->length; i += o->hop_size) {
+    hop.data = input->data + i;
+    aubio_tempo_do (o, &hop, &tempo);
+  }
+}
+
+uint_t aubio_tempo_set_events (aubio_tempo_t *o, aubio_events_t *events)
+{
+  o->events = events;
+  o->events_channel = 0;
+  return AUBIO_OK;
+}
+
+aubio_events_t *aubio_tempo_get_events (const aubio_tempo_t *o)
+{
+  return o->events;
+}
+
+static uint_t aubio_tempo_alloc_channels (aubio_tempo_t *o, uint_t n_channels)
 {
   uint_t i;
+  aubio_tempo_t **channels;
+  if (n_channels <= o->n_channels + 1) {
+    return AUBIO_OK;
+  }
+  channels = AUBIO_ARRAY(aubio_tempo_t *, n_channels - 1);
+  for (i = 0; i < o->n_channels; i++) {
+    channels[i] = o->channels[i];
+  }
+  if (o->channels) {
+    AUBIO_FREE(o->channels);
+  }
+  o->channels = channels;
+  for (i = o->n_channels; i < n_channels - 1; i++) {
+    channels[i] = new_aubio_tempo (o->method, o->buf_size, o->hop_size,
+        o->samplerate);
+    if (!channels[i]) {
+      AUBIO_ERR ("tempo: failed creating the object of channel %d\n", i + 1);
+      return AUBIO_FAIL;
+    }
+    // start counting frames along with the first channel
+    channels[i]->total_frames = o->total_frames;
+    channels[i]->frames = o->frames;
+    o->n_channels = i + 1;
+  }
+  return AUBIO_OK;
+}
+
+static void aubio_tempo_apply_pending (aubio_tempo_t *o)
+{
+  smpl_t values[AUBIO_PENDING_MAX];
+  uint_t posted = aubio_pending_take (&o->pending, values);
+  if (!posted) return;
+  if (posted & (1u << AUBIO_TEMPO_THRESHOLD)) {
+    o->threshold = values[AUBIO_TEMPO_THRESHOLD];
+    aubio_peakpicker_set_threshold (o->pp, o->threshold);
+  }
+  if (posted & (1u << AUBIO_TEMPO_SILENCE))
+    o->silence = values[AUBIO_TEMPO_SILENCE];
+  if (posted & (1u << AUBIO_TEMPO_DELAY))
+    o->delay = (sint_t)values[AUBIO_TEMPO_DELAY];
+}
+
+static void aubio_tempo_sync_channel (aubio_tempo_t *o, aubio_tempo_t *c)
+{
+  c->silence = o->silence;
+  c->gating = o->gating;
+  c->delay = o->delay;
+  c->tatum_signature = o->tatum_signature;
+  c->events = o->events;
+  if (c->threshold != o->threshold) {
+    aubio_tempo_set_threshold (c, o->threshold);
+  }
+  if (aubio_tempo_get_incremental (c) != aubio_tempo_get_incremental (o)) {
+    aubio_tempo_set_incremental (c, aubio_tempo_get_incremental (o));
+  }
+  if (aubio_tempo_get_compact (c) != aubio_tempo_get_compact (o)) {
+    aubio_tempo_set_compact (c, aubio_tempo_get_compact (o));
+  }
+  aubio_beattracking_set_relock (c->bt, aubio_beattracking_get_relock (o->bt));
+  if (aubio_tempo_get_latency (c) != aubio_tempo_get_latency (o)) {
+    aubio_tempo_set_latency (c, aubio_tempo_get_latency (o));
+  }
+  if (aubio_tempo_get_prior (c) != aubio_tempo_get_prior (o)) {
+    aubio_tempo_set_prior (c, aubio_tempo_get_prior (o));
+  }
+  if (aubio_tempo_get_min_bpm (c) != aubio_tempo_get_min_bpm (o)
+      || aubio_tempo_get_max_bpm (c) != aubio_tempo_get_max_bpm (o)) {
+    aubio_tempo_set_bpm_range (c, aubio_tempo_get_min_bpm (o),
+        aubio_tempo_get_max_bpm (o));
+  }
+}
+
+static uint_t aubio_tempo_new_envelope (aubio_tempo_t *o)
+{
+  uint_t factor = 8, k, rate;
+  smpl_t high, ratio;
+  // the largest factor dividing the hop, keeping AUBIO_TEMPO_ENV_RATE
+  while (factor > 1 && (o->hop_size % factor != 0
+        || o->samplerate / factor < AUBIO_TEMPO_ENV_RATE)) {
+    factor /= 2;
+  }
+  rate = o->samplerate / factor;
+  if (factor > 1) {
+    o->decimator = new_aubio_decimator (factor);
+    if (!o->decimator || aubio_decimator_set_max_length (o->decimator,
+          o->hop_size) != AUBIO_OK) return AUBIO_FAIL;
+  }
+  o->decimated = new_fvec (o->hop_size / factor);
+  o->env = new_fvec (AUBIO_TEMPO_ENV_BANDS);
+  o->env_old = new_fvec (AUBIO_TEMPO_ENV_BANDS);
+  o->bands = new_aubio_filterbank_iir (AUBIO_TEMPO_ENV_BANDS, rate);
+  if (!o->decimated || !o->env || !o->env_old || !o->bands) {
+    return AUBIO_FAIL;
+  }
+  // bands spaced evenly on a log scale, about an octave wide each
+  high = MIN (AUBIO_TEMPO_ENV_HIGH, .4 * rate);
+  ratio = POW (high / AUBIO_TEMPO_ENV_LOW, 1. / (AUBIO_TEMPO_ENV_BANDS - 1));
+  for (k = 0; k < AUBIO_TEMPO_ENV_BANDS; k++) {
+    aubio_filterbank_iir_set_bandpass (o->bands, k,
+        AUBIO_TEMPO_ENV_LOW * POW (ratio, k), 1.4);
+  }
+  aubio_filterbank_iir_set_envelope (o->bands, .005, .05);
+  return AUBIO_OK;
+}
+
+static void aubio_tempo_do_envelope (aubio_tempo_t *o, const fvec_t * input)
+{
+  uint_t k;
+  smpl_t flux = 0.;
+  const fvec_t *in = input;
+  if (o->decimator) {
+    aubio_decimator_do (o->decimator, input, o->decimated);
+    in = o->decimated;
+  }
+  aubio_filterbank_iir_do_envelope (o->bands, in, o->env);
+  // sum of the rises of the compressed envelopes, as specflux does on bins
+  for (k = 0; k < AUBIO_TEMPO_ENV_BANDS; k++) {
+    smpl_t e = LOG (1. + AUBIO_TEMPO_ENV_LAMBDA * o->env->data[k]);
+    if (e > o->env_old->data[k]) flux += e - o->env_old->data[k];
+    o->env_old->data[k] = e;
+  }
+  o->of->data[0] = flux;
+}
+
+static void aubio_tempo_reset_envelope (aubio_tempo_t *o)
+{
+  if (o->decimator) aubio_decimator_reset (o->decimator);
+  aubio_filterbank_iir_reset (o->bands);
+  fvec_zeros (o->env_old);
+}
+
+static void aubio_tempo_do_of (aubio_tempo_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * tempo)
+{
+  uint_t i, silent = 0;
   uint_t winlen = o->winlen;
   uint_t step   = o->step;
   fvec_t * thresholded;
-  aubio_pvoc_do (o->pv, input, o->fftgrain);
-  aubio_specdesc_do (o->od, o->fftgrain, o->of);
   /*if (usedoubled) {
     aubio_specdesc_do(o2,fftgrain, onset2);
     onset->data[0] *= onset2->data[0];
@@ -83,6 +416,7 @@ void aubio_tempo_do(aubio_tempo_t *o, const fvec_t * input, fvec_t * tempo)
   //tempo->data[1] = o->onset->data[0];
   thresholded = aubio_peakpicker_get_thresholded_input(o->pp);
   o->dfframe->data[winlen - step + o->blockpos] = thresholded->data[0];
+  aubio_beattracking_update (o->bt, o->dfframe, o->blockpos);
   /* end of second level loop */
   tempo->data[0] = 0; /* reset tactus */
   //i=0;
@@ -91,14 +425,33 @@ void aubio_tempo_do(aubio_tempo_t *o, const fvec_t * input, fvec_t * tempo)
     if (o->blockpos == FLOOR(o->out->data[i])) {
       tempo->data[0] = o->out->data[i] - FLOOR(o->out->data[i]); /* set tactus */
       /* test for silence */
-      if (aubio_silence_detection(input, o->silence)==1) {
+      if (stats ? stats->db_spl < o->silence
+          : aubio_silence_detection(input, o->silence)) {
         tempo->data[0] = 0; // unset beat if silent
+        silent = 1;
       }
       o->last_beat = o->total_frames + (uint_t)ROUND(tempo->data[0] * o->hop_size);
       o->last_tatum = o->last_beat;
+      if (o->events && !silent) {
+        aubio_event_t event;
+        event.type = aubio_event_beat;
+        event.channel = o->events_channel;
+        // last_beat is within a hop of total_frames, even once wrapped
+        event.position = (u64_t)((long long)o->frames
+            + (sint_t)(aubio_tempo_get_last (o) - o->total_frames));
+        event.strength = aubio_tempo_get_confidence (o);
+        aubio_events_push (o->events, &event);
+      }
     }
   }
+  if (o->of_history) {
+    aubio_history_push_value (o->of_history, o->of->data[0]);
+    aubio_history_push_value (o->bpm_history, aubio_tempo_get_bpm (o));
+    aubio_history_push_value (o->confidence_history,
+        aubio_tempo_get_confidence (o));
+  }
   o->total_frames += o->hop_size;
+  o->frames += o->hop_size;
   return;
 }
 
@@ -117,14 +470,77 @@ smpl_t aubio_tempo_get_last_ms (aubio_tempo_t *o)
   return aubio_tempo_get_last_s (o) * 1000.;
 }
 
+/* time of the next predicted beat, in samples, without the delay */
+static smpl_t aubio_tempo_next_beat (aubio_tempo_t *o)
+{
+  smpl_t period = aubio_tempo_get_period (o);
+  smpl_t now = o->total_frames, beat = o->last_beat;
+  uint_t i;
+  if (period <= 0.) return 0.;
+  /* beats placed by the tracker in the current step, in blocks: the block at
+   * blockpos ended at total_frames */
+  for (i = 1; i < o->out->data[0]; i++) {
+    beat = now + (o->out->data[i] - o->blockpos - 1) * o->hop_size;
+    if (beat >= now) return beat;
+  }
+  /* past the end of the step, extrapolate with the current period */
+  if (beat < now) beat += CEIL ((now - beat) / period) * period;
+  return beat;
+}
+
+uint_t aubio_tempo_get_next (aubio_tempo_t *o)
+{
+  return (uint_t)ROUND (aubio_tempo_next_beat (o)) + o->delay;
+}
+
+smpl_t aubio_tempo_get_next_s (aubio_tempo_t *o)
+{
+  return aubio_tempo_get_next (o) / (smpl_t) (o->samplerate);
+}
+
+smpl_t aubio_tempo_get_next_ms (aubio_tempo_t *o)
+{
+  return aubio_tempo_get_next_s (o) * 1000.;
+}
+
+smpl_t aubio_tempo_get_phase (aubio_tempo_t *o)
+{
+  smpl_t period = aubio_tempo_get_period (o), phase;
+  if (period <= 0.) return 0.;
+  phase = (o->total_frames - aubio_tempo_next_beat (o) - o->delay) / period;
+  phase -= FLOOR (phase);
+  return phase;
+}
+
+uint_t aubio_tempo_get_latency(aubio_tempo_t * o) {
+  // the thresholded value lags win_pre hops behind the last input
+  return o->buf_size / 2 + aubio_peakpicker_get_win_pre (o->pp) * o->hop_size;
+}
+
+uint_t aubio_tempo_set_latency(aubio_tempo_t * o, uint_t latency) {
+  uint_t win_pre;
+  if (latency < o->buf_size / 2) {
+    AUBIO_ERR ("tempo: latency should be at least %d samples, got %d\n",
+        o->buf_size / 2, latency);
+    return AUBIO_FAIL;
+  }
+  win_pre = (latency - o->buf_size / 2) / o->hop_size;
+  if (win_pre == aubio_peakpicker_get_win_pre (o->pp)) return AUBIO_OK;
+  return aubio_peakpicker_set_window (o->pp, win_pre,
+      aubio_peakpicker_get_win_post (o->pp));
+}
+
 uint_t aubio_tempo_set_delay(aubio_tempo_t * o, sint_t delay) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_TEMPO_DELAY, delay);
+    return AUBIO_OK;
+  }
   o->delay = delay;
   return AUBIO_OK;
 }
 
 uint_t aubio_tempo_set_delay_s(aubio_tempo_t * o, smpl_t delay) {
-  o->delay = delay * o->samplerate;
-  return AUBIO_OK;
+  return aubio_tempo_set_delay(o, delay * o->samplerate);
 }
 
 uint_t aubio_tempo_set_delay_ms(aubio_tempo_t * o, smpl_t delay) {
@@ -144,6 +560,10 @@ smpl_t aubio_tempo_get_delay_ms(aubio_tempo_t * o) {
 }
 
 uint_t aubio_tempo_set_silence(aubio_tempo_t * o, smpl_t silence) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_TEMPO_SILENCE, silence);
+    return AUBIO_OK;
+  }
   o->silence = silence;
   return AUBIO_OK;
 }
@@ -152,7 +572,29 @@ smpl_t aubio_tempo_get_silence(aubio_tempo_t * o) {
   return o->silence;
 }
 
+uint_t aubio_tempo_set_gating(aubio_tempo_t * o, uint_t gating) {
+  o->gating = gating ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_tempo_get_gating(const aubio_tempo_t * o) {
+  return o->gating;
+}
+
+uint_t aubio_tempo_set_deferred(aubio_tempo_t * o, uint_t deferred) {
+  o->deferred = deferred ? 1 : 0;
+  return AUBIO_OK;
+}
+
+uint_t aubio_tempo_get_deferred(const aubio_tempo_t * o) {
+  return o->deferred;
+}
+
 uint_t aubio_tempo_set_threshold(aubio_tempo_t * o, smpl_t threshold) {
+  if (o->deferred) {
+    aubio_pending_post (&o->pending, AUBIO_TEMPO_THRESHOLD, threshold);
+    return AUBIO_OK;
+  }
   o->threshold = threshold;
   aubio_peakpicker_set_threshold(o->pp, o->threshold);
   return AUBIO_OK;
@@ -200,20 +642,35 @@ aubio_tempo_t * new_aubio_tempo (const char_t * tempo_mode,
   o->last_beat = 0;
   o->delay = 0;
   o->hop_size = hop_size;
+  o->buf_size = buf_size;
+  o->method = AUBIO_ARRAY(char_t, strnlen(tempo_mode, PATH_MAX) + 1);
+  strncpy(o->method, tempo_mode, strnlen(tempo_mode, PATH_MAX));
   o->dfframe  = new_fvec(o->winlen);
-  o->fftgrain = new_cvec(buf_size);
   o->out      = new_fvec(o->step);
-  o->pv       = new_aubio_pvoc(buf_size, hop_size);
   o->pp       = new_aubio_peakpicker();
   aubio_peakpicker_set_threshold (o->pp, o->threshold);
-  if ( strcmp(tempo_mode, "default") == 0 ) {
-    strncpy(specdesc_func, "specflux", PATH_MAX - 1);
-    specdesc_func[PATH_MAX - 1] = '\0';
+  if (strcmp(tempo_mode, "envelope") == 0) {
+    // no spectrum, the detection function comes from band envelopes
+    if (aubio_tempo_new_envelope (o) != AUBIO_OK) goto beach;
   } else {
-    strncpy(specdesc_func, tempo_mode, PATH_MAX - 1);
-    specdesc_func[PATH_MAX - 1] = '\0';
+    if ( strcmp(tempo_mode, "default") == 0 ) {
+      strncpy(specdesc_func, "specflux", PATH_MAX - 1);
+      specdesc_func[PATH_MAX - 1] = '\0';
+    } else {
+      strncpy(specdesc_func, tempo_mode, PATH_MAX - 1);
+      specdesc_func[PATH_MAX - 1] = '\0';
+    }
+    o->fftgrain = new_cvec(buf_size);
+    o->pv       = new_aubio_pvoc(buf_size, hop_size);
+    o->od       = new_aubio_specdesc(specdesc_func,buf_size);
+    if (!o->fftgrain || !o->pv || !o->od) {
+      AUBIO_ERR("tempo: failed creating tempo object\n");
+      goto beach;
+    }
+    /* only compute the phase if the onset function needs it */
+    aubio_pvoc_set_magnitude_only (o->pv,
+        !aubio_specdesc_uses_phase (o->od));
   }
-  o->od       = new_aubio_specdesc(specdesc_func,buf_size);
   o->of       = new_fvec(1);
   o->bt       = new_aubio_beattracking(o->winlen, o->hop_size, o->samplerate);
   o->onset    = new_fvec(1);
@@ -221,8 +678,7 @@ aubio_tempo_t * new_aubio_tempo (const char_t * tempo_mode,
     o2 = new_aubio_specdesc(type_onset2,buffer_size);
     onset2 = new_fvec(1);
   }*/
-  if (!o->dfframe || !o->fftgrain || !o->out || !o->pv ||
-      !o->pp || !o->od || !o->of || !o->bt || !o->onset) {
+  if (!o->dfframe || !o->out || !o->pp || !o->of || !o->bt || !o->onset) {
     AUBIO_ERR("tempo: failed creating tempo object\n");
     goto beach;
   }
@@ -253,6 +709,52 @@ smpl_t aubio_tempo_get_confidence(aubio_tempo_t *o) {
   return aubio_beattracking_get_confidence(o->bt);
 }
 
+static void aubio_tempo_del_history (aubio_tempo_t *o)
+{
+  if (o->of_history) del_aubio_history (o->of_history);
+  if (o->bpm_history) del_aubio_history (o->bpm_history);
+  if (o->confidence_history) del_aubio_history (o->confidence_history);
+  o->of_history = NULL;
+  o->bpm_history = NULL;
+  o->confidence_history = NULL;
+}
+
+uint_t aubio_tempo_set_history (aubio_tempo_t *o, uint_t length)
+{
+  aubio_tempo_del_history (o);
+  if (length == 0) return AUBIO_OK;
+  o->of_history = new_aubio_history (length, 1);
+  o->bpm_history = new_aubio_history (length, 1);
+  o->confidence_history = new_aubio_history (length, 1);
+  if (!o->of_history || !o->bpm_history || !o->confidence_history) {
+    aubio_tempo_del_history (o);
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_tempo_get_history (const aubio_tempo_t *o)
+{
+  if (!o->of_history) return 0;
+  return aubio_history_get_frames (o->of_history)->height;
+}
+
+const fvec_t *aubio_tempo_get_descriptor_history (const aubio_tempo_t *o)
+{
+  return o->of_history ? aubio_history_get_data (o->of_history) : NULL;
+}
+
+const fvec_t *aubio_tempo_get_bpm_history (const aubio_tempo_t *o)
+{
+  return o->bpm_history ? aubio_history_get_data (o->bpm_history) : NULL;
+}
+
+const fvec_t *aubio_tempo_get_confidence_history (const aubio_tempo_t *o)
+{
+  return o->confidence_history ?
+    aubio_history_get_data (o->confidence_history) : NULL;
+}
+
 uint_t aubio_tempo_was_tatum (aubio_tempo_t *o)
 {
   uint_t last_tatum_distance = o->total_frames - o->last_tatum;
@@ -286,8 +788,114 @@ uint_t aubio_tempo_set_tatum_signature (aubio_tempo_t *o, uint_t signature) {
   }
 }
 
+uint_t aubio_tempo_set_incremental (aubio_tempo_t *o, uint_t incremental) {
+  return aubio_beattracking_set_incremental (o->bt, incremental);
+}
+
+uint_t aubio_tempo_get_incremental (aubio_tempo_t *o) {
+  return aubio_beattracking_get_incremental (o->bt);
+}
+
+uint_t aubio_tempo_set_compact (aubio_tempo_t *o, uint_t compact) {
+  return aubio_beattracking_set_compact (o->bt, compact);
+}
+
+uint_t aubio_tempo_get_compact (aubio_tempo_t *o) {
+  return aubio_beattracking_get_compact (o->bt);
+}
+
+uint_t aubio_tempo_set_bpm_range (aubio_tempo_t *o, smpl_t min_bpm,
+    smpl_t max_bpm) {
+  return aubio_beattracking_set_bpm_range (o->bt, min_bpm, max_bpm);
+}
+
+smpl_t aubio_tempo_get_min_bpm (aubio_tempo_t *o) {
+  return aubio_beattracking_get_min_bpm (o->bt);
+}
+
+smpl_t aubio_tempo_get_max_bpm (aubio_tempo_t *o) {
+  return aubio_beattracking_get_max_bpm (o->bt);
+}
+
+uint_t aubio_tempo_set_prior (aubio_tempo_t *o, smpl_t bpm) {
+  return aubio_beattracking_set_prior (o->bt, bpm);
+}
+
+smpl_t aubio_tempo_get_prior (aubio_tempo_t *o) {
+  return aubio_beattracking_get_prior (o->bt);
+}
+
+smpl_t aubio_tempo_get_stability (aubio_tempo_t *o) {
+  return aubio_beattracking_get_stability (o->bt);
+}
+
+uint_t aubio_tempo_set_relock (aubio_tempo_t *o, smpl_t threshold) {
+  return aubio_beattracking_set_relock (o->bt, threshold);
+}
+
+smpl_t aubio_tempo_get_relock (aubio_tempo_t *o) {
+  return aubio_beattracking_get_relock (o->bt);
+}
+
+aubio_tempo_t * aubio_tempo_clone (aubio_tempo_t *o)
+{
+  // created while o holds the windows and plans, so found in their caches
+  aubio_tempo_t *c = new_aubio_tempo (o->method, o->buf_size, o->hop_size,
+      o->samplerate);
+  if (!c) {
+    return NULL;
+  }
+  aubio_tempo_sync_channel (o, c);
+  c->deferred = o->deferred;
+  // a queue is only fed from a single thread
+  c->events = NULL;
+  if (aubio_tempo_set_history (c, aubio_tempo_get_history (o)) != AUBIO_OK) {
+    del_aubio_tempo (c);
+    return NULL;
+  }
+  return c;
+}
+
+uint_t aubio_tempo_reconfigure (aubio_tempo_t *o, const char_t * tempo_mode,
+    uint_t buf_size, uint_t hop_size)
+{
+  aubio_tempo_t *n = new_aubio_tempo (tempo_mode, buf_size, hop_size,
+      o->samplerate);
+  aubio_tempo_t previous;
+  if (!n) {
+    return AUBIO_FAIL;
+  }
+  // move the new objects to o, and delete the previous ones with n
+  previous = *o;
+  *o = *n;
+  *n = previous;
+  // keep the queue and the histories of o, cleared
+  o->events = previous.events;
+  o->of_history = previous.of_history;
+  o->bpm_history = previous.bpm_history;
+  o->confidence_history = previous.confidence_history;
+  n->of_history = NULL;
+  n->bpm_history = NULL;
+  n->confidence_history = NULL;
+  if (o->of_history) {
+    aubio_history_reset (o->of_history);
+    aubio_history_reset (o->bpm_history);
+    aubio_history_reset (o->confidence_history);
+  }
+  del_aubio_tempo (n);
+  return AUBIO_OK;
+}
+
 void del_aubio_tempo (aubio_tempo_t *o)
 {
+  uint_t i;
+  for (i = 0; i < o->n_channels; i++) {
+    del_aubio_tempo(o->channels[i]);
+  }
+  if (o->channels)
+    AUBIO_FREE(o->channels);
+  if (o->method)
+    AUBIO_FREE(o->method);
   if (o->od)
     del_aubio_specdesc(o->od);
   if (o->bt)
@@ -306,5 +914,211 @@ void del_aubio_tempo (aubio_tempo_t *o)
     del_fvec(o->dfframe);
   if (o->onset)
     del_fvec(o->onset);
+  if (o->decimator)
+    del_aubio_decimator(o->decimator);
+  if (o->bands)
+    del_aubio_filterbank_iir(o->bands);
+  if (o->decimated)
+    del_fvec(o->decimated);
+  if (o->env)
+    del_fvec(o->env);
+  if (o->env_old)
+    del_fvec(o->env_old);
+  aubio_tempo_del_history(o);
   AUBIO_FREE(o);
 }
+
+uint_t aubio_tempo_get_memory_usage (const aubio_tempo_t *o)
+{
+  uint_t i, n = aubio_malloc_size(o) + aubio_malloc_size(o->method)
+    + aubio_malloc_size(o->channels) + aubio_malloc_size(o->out)
+    + aubio_malloc_size(o->of) + aubio_malloc_size(o->fftgrain)
+    + aubio_malloc_size(o->dfframe) + aubio_malloc_size(o->onset)
+    + aubio_malloc_size(o->decimated) + aubio_malloc_size(o->env)
+    + aubio_malloc_size(o->env_old);
+  for (i = 0; i < o->n_channels; i++) {
+    n += aubio_tempo_get_memory_usage(o->channels[i]);
+  }
+  if (o->od) n += aubio_specdesc_get_memory_usage(o->od);
+  if (o->bt) n += aubio_beattracking_get_memory_usage(o->bt);
+  if (o->pp) n += aubio_peakpicker_get_memory_usage(o->pp);
+  if (o->pv) n += aubio_pvoc_get_memory_usage(o->pv);
+  if (o->decimator) n += aubio_decimator_get_memory_usage(o->decimator);
+  if (o->bands) n += aubio_filterbank_iir_get_memory_usage(o->bands);
+  if (o->of_history) {
+    n += aubio_history_get_memory_usage(o->of_history)
+      + aubio_history_get_memory_usage(o->bpm_history)
+      + aubio_history_get_memory_usage(o->confidence_history);
+  }
+  return n;
+}
+
+/* tempi searched by aubio_tempo_analyze, in bpm */
+#define AUBIO_TEMPO_ANALYZE_MIN_BPM 30.
+#define AUBIO_TEMPO_ANALYZE_MAX_BPM 300.
+/* tempo at which the autocorrelation weighting peaks, in bpm */
+#define AUBIO_TEMPO_ANALYZE_PRIOR 120.
+/* width of the weighting, in octaves */
+#define AUBIO_TEMPO_ANALYZE_SPREAD 1.
+/* cost of beat intervals departing from the period */
+#define AUBIO_TEMPO_ANALYZE_TIGHTNESS 100.
+
+/* best beat period of the detection function, in hops, or 0 */
+static smpl_t
+aubio_tempo_analyze_period (const fvec_t * env, smpl_t fps)
+{
+  uint_t i, n = env->length, best = 0;
+  uint_t lag_min = (uint_t) FLOOR (60. * fps / AUBIO_TEMPO_ANALYZE_MAX_BPM);
+  uint_t lag_max = (uint_t) CEIL (60. * fps / AUBIO_TEMPO_ANALYZE_MIN_BPM);
+  smpl_t prior = 60. * fps / AUBIO_TEMPO_ANALYZE_PRIOR;
+  fvec_t *acf = new_fvec (n), *score;
+  smpl_t period = 0.;
+  if (!acf) return 0.;
+  lag_min = MAX (lag_min, 1);
+  lag_max = MIN (lag_max, n / 2 - 2);
+  score = new_fvec (lag_max + 2);
+  if (!score) goto beach;
+  /* the average of the autocorrelation tempogram over the whole signal */
+  aubio_autocorr (env, acf);
+  for (i = lag_min; i <= lag_max; i++) {
+    smpl_t octaves = LOG (i / prior) / LOG (2.);
+    smpl_t weight = EXP (-.5 * SQR (octaves / AUBIO_TEMPO_ANALYZE_SPREAD));
+    score->data[i] = MAX (0., acf->data[i]) * weight;
+    if (score->data[i] > score->data[best]) best = i;
+  }
+  if (best > lag_min && best < lag_max) {
+    period = fvec_quadratic_peak_pos (score, best);
+  } else if (best > 0) {
+    period = best;
+  }
+  del_fvec (score);
+beach:
+  del_fvec (acf);
+  return period;
+}
+
+uint_t
+aubio_tempo_analyze (const fvec_t * df, uint_t hop_size, uint_t samplerate,
+    smpl_t * bpm, fvec_t * beats)
+{
+  uint_t i, n = df->length, n_beats = 0;
+  smpl_t fps = samplerate / (smpl_t) hop_size, period, mean, dev, sum;
+  sint_t t, d, d_min, d_max, last;
+  fvec_t *env = NULL, *local = NULL, *cum = NULL, *penalty = NULL;
+  lvec_t *back = NULL;
+  *bpm = 0.;
+  if ((sint_t)hop_size < 1 || (sint_t)samplerate < 1) {
+    AUBIO_ERR ("tempo: got hop_size %d and samplerate %d for analyze\n",
+        hop_size, samplerate);
+    return 0;
+  }
+  if (n < 4 * 60. * fps / AUBIO_TEMPO_ANALYZE_MIN_BPM) {
+    AUBIO_ERR ("tempo: %d values are too short to analyze, need at least"
+        " %.0f seconds\n", n, 4 * 60. / AUBIO_TEMPO_ANALYZE_MIN_BPM);
+    return 0;
+  }
+  env = new_fvec (n);
+  local = new_fvec (n);
+  cum = new_fvec (n);
+  back = new_lvec (n);
+  if (!env || !local || !cum || !back) goto beach;
+
+  /* normalized detection function */
+  fvec_copy (df, env);
+  mean = fvec_mean (env);
+  fvec_add (env, -mean);
+  dev = SQRT (aubio_level_lin (env));
+  if (dev <= 0.) goto beach;
+  fvec_mul (env, 1. / dev);
+
+  period = aubio_tempo_analyze_period (env, fps);
+  if (period <= 0.) goto beach;
+  *bpm = 60. * fps / period;
+
+  /* onset strength around each position, smoothed over period / 32 */
+  {
+    sint_t half = (sint_t) CEIL (period / 16.), k;
+    smpl_t sigma = MAX (period / 32., .5);
+    for (t = 0; t < (sint_t) n; t++) {
+      smpl_t acc = 0.;
+      for (k = -half; k <= half; k++) {
+        if (t + k < 0 || t + k >= (sint_t) n) continue;
+        acc += env->data[t + k] * EXP (-.5 * SQR (k / sigma));
+      }
+      local->data[t] = acc;
+    }
+  }
+
+  /* penalty of each interval between two beats */
+  d_min = (sint_t) ROUND (period / 2.);
+  d_max = (sint_t) ROUND (2. * period);
+  penalty = new_fvec (d_max + 1);
+  if (!penalty) goto beach;
+  for (d = d_min; d <= d_max; d++) {
+    penalty->data[d] = AUBIO_TEMPO_ANALYZE_TIGHTNESS
+      * SQR (LOG (d / period));
+  }
+
+  /* best score of a sequence of beats ending at each position */
+  for (t = 0; t < (sint_t) n; t++) {
+    smpl_t best = 0.;
+    sint_t from = -1;
+    for (d = d_min; d <= d_max && d <= t; d++) {
+      smpl_t score = cum->data[t - d] - penalty->data[d];
+      if (from < 0 || score > best) {
+        best = score;
+        from = t - d;
+      }
+    }
+    /* a sequence may also start here */
+    if (from >= 0 && best > 0.) {
+      cum->data[t] = local->data[t] + best;
+      back->data[t] = from;
+    } else {
+      cum->data[t] = local->data[t];
+      back->data[t] = -1;
+    }
+  }
+
+  /* end on the best score of the last period, then follow the links back */
+  last = (sint_t) n - 1;
+  for (t = (sint_t) n - 1; t >= (sint_t) n - d_max && t >= 0; t--) {
+    if (cum->data[t] > cum->data[last]) last = t;
+  }
+  for (t = last; t >= 0; t = (sint_t) back->data[t]) {
+    n_beats++;
+  }
+
+  /* drop the beats of the silences at the start and at the end */
+  sum = 0.;
+  for (t = last; t >= 0; t = (sint_t) back->data[t]) {
+    sum += SQR (MAX (local->data[t], 0.));
+  }
+  {
+    smpl_t threshold = .5 * SQRT (sum / n_beats);
+    uint_t first = 0, end = n_beats;
+    /* store the positions of the beats in order, in cum, no longer used */
+    i = n_beats;
+    for (t = last; t >= 0; t = (sint_t) back->data[t]) {
+      cum->data[--i] = t;
+    }
+    while (first < end && local->data[(uint_t) cum->data[first]] < threshold)
+      first++;
+    while (end > first && local->data[(uint_t) cum->data[end - 1]] < threshold)
+      end--;
+    n_beats = end - first;
+    if (beats) {
+      for (i = 0; i < n_beats && i < beats->length; i++) {
+        beats->data[i] = cum->data[first + i] * hop_size / (smpl_t) samplerate;
+      }
+    }
+  }
+
+beach:
+  if (env) del_fvec (env);
+  if (local) del_fvec (local);
+  if (cum) del_fvec (cum);
+  if (back) del_lvec (back);
+  if (penalty) del_fvec (penalty);
+  return n_beats;
+}
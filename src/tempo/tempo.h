@@ -42,8 +42,11 @@ typedef struct _aubio_tempo_t aubio_tempo_t;
 
 /** create tempo detection object
 
-  \param method beat tracking method, unused for now (use "default")
-  \param buf_size length of FFT
+  \param method onset detection function of the beat tracking: `default`
+  for `specflux`, one of the spectral descriptors of specdesc.h, or
+  `envelope`, which follows the envelopes of a few bands of a decimated
+  input instead of computing a spectrum, at a fraction of the cost
+  \param buf_size length of FFT, unused by `envelope`
   \param hop_size number of frames between two consecutive runs
   \param samplerate sampling rate of the signal to analyze
 
@@ -62,6 +65,109 @@ aubio_tempo_t * new_aubio_tempo (const char_t * method,
 */
 void aubio_tempo_do (aubio_tempo_t *o, const fvec_t * input, fvec_t * tempo);
 
+/** execute tempo detection with the level of the input already computed
+
+  Same as aubio_tempo_do(), but the silence test reads the level from
+  `stats`, so that the detectors running on the same input can share it.
+
+  \param o beat tracking object
+  \param input new samples
+  \param stats statistics of `input`, as computed by aubio_frame_stats_do(),
+  or NULL to compute the level of `input`
+  \param tempo output beats
+
+*/
+void aubio_tempo_do_stats (aubio_tempo_t *o, const fvec_t * input,
+    const aubio_frame_stats_t * stats, fvec_t * tempo);
+
+/** execute tempo detection on a precomputed spectrum
+
+  Same as aubio_tempo_do(), but the spectrum of the current frame is read
+  from `fftgrain`, so that several analysis objects can share a single phase
+  vocoder.
+
+  \param o beat tracking object
+  \param input new samples
+  \param fftgrain spectrum of the current frame, as computed by
+  aubio_pvoc_do() on a phase vocoder of the same buffer and hop sizes, with
+  its default window
+  \param tempo output beats
+
+*/
+void aubio_tempo_do_spectrum (aubio_tempo_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, fvec_t * tempo);
+
+/** execute tempo detection on a precomputed spectrum and level
+
+  Same as aubio_tempo_do_spectrum(), with the level of `input` read from
+  `stats` as in aubio_tempo_do_stats().
+
+  \param o beat tracking object
+  \param input new samples
+  \param fftgrain spectrum of the current frame, see
+  aubio_tempo_do_spectrum()
+  \param stats statistics of `input`, as computed by aubio_frame_stats_do(),
+  or NULL to compute the level of `input`
+  \param tempo output beats
+
+*/
+void aubio_tempo_do_spectrum_stats (aubio_tempo_t *o, const fvec_t * input,
+    const cvec_t * fftgrain, const aubio_frame_stats_t * stats,
+    fvec_t * tempo);
+
+/** execute tempo detection on several channels
+
+  \param o beat tracking object
+  \param input new samples, one row of length hop_size per channel
+  \param tempo output beats, of length at least `input->height`
+
+  Each channel is tracked as if it was given to its own tempo object: the
+  value written in `tempo->data[ch]` is the one aubio_tempo_do() would have
+  returned for channel `ch`. Channel 0 is tracked by `o` itself, so that
+  aubio_tempo_get_bpm() and the other getters report on it. The objects of
+  the other channels are created on the first call that needs them, and use
+  the parameters of `o` as set at the time of each call.
+
+*/
+void aubio_tempo_do_multi (aubio_tempo_t *o, const fmat_t * input,
+    fvec_t * tempo);
+
+/** execute tempo detection on a block of several hops
+
+  \param o beat tracking object
+  \param input new samples, a multiple of hop_size long
+
+  Each hop of the block goes through aubio_tempo_do(). The beats are only
+  reported to the queue attached with aubio_tempo_set_events().
+
+*/
+void aubio_tempo_do_block (aubio_tempo_t *o, const fvec_t * input);
+
+/** attach an event queue
+
+  \param o beat tracking object
+  \param events queue receiving an ::aubio_event_beat for each beat, or
+  NULL to detach it
+
+  \return 0 if successful, non-zero otherwise
+
+  Beats found on silent hops, which aubio_tempo_do() reports as 0, are not
+  pushed. Each event holds the position of aubio_tempo_get_last(), on 64
+  bits, and the confidence of aubio_tempo_get_confidence() as its strength.
+  See utils/events.h.
+
+*/
+uint_t aubio_tempo_set_events (aubio_tempo_t *o, aubio_events_t *events);
+
+/** get the attached event queue
+
+  \param o beat tracking object
+
+  \return the queue set with aubio_tempo_set_events(), or NULL
+
+*/
+aubio_events_t *aubio_tempo_get_events (const aubio_tempo_t *o);
+
 /** get the time of the latest beat detected, in samples
 
   \param o tempo detection object as returned by ::new_aubio_tempo
@@ -83,6 +189,47 @@ smpl_t aubio_tempo_get_last_s (aubio_tempo_t *o);
 */
 smpl_t aubio_tempo_get_last_ms (aubio_tempo_t *o);
 
+/** get the time of the next predicted beat, in samples
+
+  \param o tempo detection object as returned by ::new_aubio_tempo
+
+  The prediction follows the beats placed by the tracker for the coming
+  blocks, then extends them with the current period. As for
+  aubio_tempo_get_last(), the delay set with aubio_tempo_set_delay() is
+  added, so that clients can schedule events ahead of the next beat rather
+  than polling aubio_tempo_do() at short intervals.
+
+  \return time of the next beat, in samples, or `0` if no consistent period
+  is found
+
+*/
+uint_t aubio_tempo_get_next (aubio_tempo_t *o);
+
+/** get the time of the next predicted beat, in seconds
+
+  \param o tempo detection object as returned by ::new_aubio_tempo
+
+*/
+smpl_t aubio_tempo_get_next_s (aubio_tempo_t *o);
+
+/** get the time of the next predicted beat, in milliseconds
+
+  \param o tempo detection object as returned by ::new_aubio_tempo
+
+*/
+smpl_t aubio_tempo_get_next_ms (aubio_tempo_t *o);
+
+/** get the position within the current beat period
+
+  \param o tempo detection object as returned by ::new_aubio_tempo
+
+  \return elapsed fraction of the current period at the end of the last
+  block, between `0` (on a beat) and `1` (just before the next one), or `0`
+  if no consistent period is found
+
+*/
+smpl_t aubio_tempo_get_phase (aubio_tempo_t *o);
+
 /** set tempo detection silence threshold
 
   \param o beat tracking object
@@ -102,6 +249,58 @@ uint_t aubio_tempo_set_silence(aubio_tempo_t * o, smpl_t silence);
 */
 smpl_t aubio_tempo_get_silence(aubio_tempo_t * o);
 
+/** enable or disable silence gating
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+  \param gating 1 to enable, 0 to disable [0]
+
+  \return `0` if successful, non-zero otherwise
+
+  When enabled, the level of each hop is checked first. Hops under the
+  silence threshold are stored without computing their spectrum, and their
+  onset detection function is taken as 0, which lets the beat tracker follow
+  the silence at a fraction of the cost of aubio_tempo_do().
+
+*/
+uint_t aubio_tempo_set_gating(aubio_tempo_t * o, uint_t gating);
+
+/** get silence gating mode
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+
+  \return 1 if silence gating is enabled, 0 otherwise
+
+*/
+uint_t aubio_tempo_get_gating(const aubio_tempo_t * o);
+
+/** enable or disable deferred parameter updates
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+  \param deferred 1 to enable, 0 to disable [0]
+
+  \return 0 if successful, non-zero otherwise
+
+  When enabled, aubio_tempo_set_threshold(), aubio_tempo_set_silence() and
+  aubio_tempo_set_delay(), in samples, seconds or milliseconds, only post
+  their value, and may be called from a user interface thread while the
+  audio thread runs aubio_tempo_do(). The values are applied, without any
+  lock, when the next hop is processed. Enable this mode before sharing the
+  object between threads.
+
+  \sa aubio_onset_set_deferred()
+
+*/
+uint_t aubio_tempo_set_deferred(aubio_tempo_t * o, uint_t deferred);
+
+/** get deferred parameter updates mode
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+
+  \return 1 if parameter updates are deferred, 0 otherwise
+
+*/
+uint_t aubio_tempo_get_deferred(const aubio_tempo_t * o);
+
 /** set tempo detection peak picking threshold
 
   \param o beat tracking object
@@ -160,6 +359,61 @@ smpl_t aubio_tempo_get_bpm(aubio_tempo_t * o);
 */
 smpl_t aubio_tempo_get_confidence(aubio_tempo_t * o);
 
+/** keep the last values of the detection function and tempo estimates
+
+  \param o beat tracking object
+  \param length number of hops to keep, or 0 to stop keeping them
+
+  \return 0 if successful, non-zero otherwise
+
+  After each hop, the onset detection function, the tempo of
+  aubio_tempo_get_bpm() and its confidence are pushed to three histories of
+  `length` values, see utils/history.h. With aubio_tempo_do_multi(), only
+  the first channel is kept.
+
+*/
+uint_t aubio_tempo_set_history(aubio_tempo_t * o, uint_t length);
+
+/** get the number of hops kept by the histories
+
+  \param o beat tracking object
+
+  \return length given to aubio_tempo_set_history(), 0 if none are kept
+
+*/
+uint_t aubio_tempo_get_history(const aubio_tempo_t * o);
+
+/** get the last values of the onset detection function
+
+  \param o beat tracking object
+
+  \return view of the last values, oldest first, or NULL if no history is
+  kept. The view is not a copy, and is only valid until the next hop.
+
+*/
+const fvec_t * aubio_tempo_get_descriptor_history(const aubio_tempo_t * o);
+
+/** get the last tempo estimates
+
+  \param o beat tracking object
+
+  \return view of the tempo, in beats per minute, after each of the last
+  hops, oldest first, or NULL if no history is kept; valid until the next
+  hop
+
+*/
+const fvec_t * aubio_tempo_get_bpm_history(const aubio_tempo_t * o);
+
+/** get the last tempo confidences
+
+  \param o beat tracking object
+
+  \return view of the confidence after each of the last hops, oldest
+  first, or NULL if no history is kept; valid until the next hop
+
+*/
+const fvec_t * aubio_tempo_get_confidence_history(const aubio_tempo_t * o);
+
 /** set number of tatum per beat
 
    \param o beat tracking object
@@ -168,6 +422,131 @@ smpl_t aubio_tempo_get_confidence(aubio_tempo_t * o);
 */
 uint_t aubio_tempo_set_tatum_signature(aubio_tempo_t *o, uint_t signature);
 
+/** enable or disable incremental beat tracking
+
+   \param o beat tracking object
+   \param incremental 1 to enable, 0 to disable [0]
+   \return 0 if successful, non-zero otherwise
+
+   When enabled, the autocorrelation of the detection function is updated at
+   each hop instead of being computed once per block of `winlen / 4` hops,
+   so that the cost of aubio_tempo_do() stays about the same on every hop.
+   See aubio_beattracking_set_incremental().
+
+*/
+uint_t aubio_tempo_set_incremental(aubio_tempo_t *o, uint_t incremental);
+
+/** get incremental beat tracking mode
+
+   \param o beat tracking object
+   \return 1 if enabled, 0 otherwise
+
+*/
+uint_t aubio_tempo_get_incremental(aubio_tempo_t *o);
+
+/** enable or disable compact beat tracking
+
+   \param o beat tracking object
+   \param compact 1 to enable, 0 to disable [0]
+   \return 0 if successful, non-zero otherwise
+
+   When enabled, the beat tracker borrows its scratch buffers from a pool
+   shared by all the compact trackers, which reduces the memory used by many
+   instances, at the cost of a lock in each call. See
+   aubio_beattracking_set_compact().
+
+*/
+uint_t aubio_tempo_set_compact(aubio_tempo_t *o, uint_t compact);
+
+/** get compact beat tracking mode
+
+   \param o beat tracking object
+   \return 1 if enabled, 0 otherwise
+
+*/
+uint_t aubio_tempo_get_compact(aubio_tempo_t *o);
+
+/** set the range of tempi searched
+
+   \param o beat tracking object
+   \param min_bpm slowest tempo, in beats per minute
+   \param max_bpm fastest tempo, in beats per minute
+   \return 0 if successful, non-zero otherwise
+
+   Narrowing the range, for instance to 70 - 180 bpm, reduces the cost of
+   each block and the octave errors. See aubio_beattracking_set_bpm_range().
+
+*/
+uint_t aubio_tempo_set_bpm_range(aubio_tempo_t *o, smpl_t min_bpm,
+    smpl_t max_bpm);
+
+/** get the slowest tempo searched
+
+   \param o beat tracking object
+   \return slowest tempo, in beats per minute
+
+*/
+smpl_t aubio_tempo_get_min_bpm(aubio_tempo_t *o);
+
+/** get the fastest tempo searched
+
+   \param o beat tracking object
+   \return fastest tempo, in beats per minute
+
+*/
+smpl_t aubio_tempo_get_max_bpm(aubio_tempo_t *o);
+
+/** set the most likely tempo
+
+   \param o beat tracking object
+   \param bpm tempo favoured by the tracker, in beats per minute [120]
+   \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_tempo_set_prior(aubio_tempo_t *o, smpl_t bpm);
+
+/** get the most likely tempo
+
+   \param o beat tracking object
+   \return tempo favoured by the tracker, in beats per minute
+
+*/
+smpl_t aubio_tempo_get_prior(aubio_tempo_t *o);
+
+/** get the tempo stability
+
+   \param o beat tracking object
+   \return correlation of the last block with the tempo salience, close to 1
+   while the tempo is steady
+
+   The stability drops within a block of a change of tempo, for instance
+   when a new track starts, without running a second tracker. See
+   aubio_beattracking_get_salience() for the vector it is computed from.
+
+*/
+smpl_t aubio_tempo_get_stability(aubio_tempo_t *o);
+
+/** set the stability below which the tempo is tracked again from scratch
+
+   \param o beat tracking object
+   \param threshold stability threshold, between 0 and 1, 0 to disable [0]
+   \return 0 if successful, non-zero otherwise
+
+   When the stability falls below `threshold`, the confidence drops to 0 and
+   the tempo follows the new periodicity from the next block, a few seconds
+   earlier than it would otherwise. A threshold of 0.5 suits most music.
+
+*/
+uint_t aubio_tempo_set_relock(aubio_tempo_t *o, smpl_t threshold);
+
+/** get the stability below which the tempo is tracked again from scratch
+
+   \param o beat tracking object
+   \return current threshold, 0 if disabled
+
+*/
+smpl_t aubio_tempo_get_relock(aubio_tempo_t *o);
+
 /** check whether a tatum was detected in the current frame
 
    \param o beat tracking object
@@ -184,6 +563,35 @@ uint_t aubio_tempo_was_tatum(aubio_tempo_t *o);
 */
 smpl_t aubio_tempo_get_last_tatum(aubio_tempo_t *o);
 
+/** get the latency of the detection function, in samples
+
+  \param o beat tracking object
+
+  \return time between an onset at the centre of the analysis window and the
+  block where its peak picked detection function is passed to the beat
+  tracker, in samples
+
+  The beats are predicted from the period and the phase found in the past
+  values of the detection function, so that they are reported close to their
+  actual time once the tracker is locked. This latency is how long a change
+  in the input takes to reach the tracker.
+
+*/
+uint_t aubio_tempo_get_latency(aubio_tempo_t * o);
+
+/** set the maximum latency of the detection function, in samples
+
+  \param o beat tracking object
+  \param latency target latency, at least half the buffer size
+
+  \return `0` if successful, non-zero otherwise
+
+  The peak picker looks ahead of each value by as many hops as fit in the
+  target. The delay set with aubio_tempo_set_delay() is not changed.
+
+*/
+uint_t aubio_tempo_set_latency(aubio_tempo_t * o, uint_t latency);
+
 /** get current delay
 
   \param o beat tracking object
@@ -241,6 +649,55 @@ uint_t aubio_tempo_set_delay_s(aubio_tempo_t * o, smpl_t delay);
  */
 uint_t aubio_tempo_set_delay_ms(aubio_tempo_t * o, smpl_t delay);
 
+/** create a copy of a tempo detection object
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+
+  \return new tempo detection object, with the method, sizes and parameters
+  of `o`, or `NULL` on failure
+
+  The copy starts from the state of a new object, without the beats tracked
+  by `o`. Its windows and FFT plans are taken from the caches holding those
+  of `o`.
+
+*/
+aubio_tempo_t * aubio_tempo_clone (aubio_tempo_t * o);
+
+/** change the method and sizes of a tempo detection object
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+  \param method new beat tracking method
+  \param buf_size new length of FFT
+  \param hop_size new number of frames between two consecutive runs
+
+  \return `0` if successful, non-zero otherwise, in which case `o` is left
+  unchanged
+
+  `o` then tracks beats as the object created by new_aubio_tempo() with
+  these arguments and the samplerate of `o`, from its default parameters.
+  The new objects are created before the previous ones are deleted, which
+  lets them reuse the windows and FFT plans of the sizes left unchanged. The
+  objects of the other channels of aubio_tempo_do_multi() are created again
+  on its next call. The queue of aubio_tempo_set_events() and the histories
+  of aubio_tempo_set_history() are kept, the histories cleared.
+
+*/
+uint_t aubio_tempo_reconfigure (aubio_tempo_t * o, const char_t * method,
+    uint_t buf_size, uint_t hop_size);
+
+/** get the memory used by a tempo detection object
+
+  \param o tempo detection object as returned by new_aubio_tempo()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+  This includes the objects tracking the channels of aubio_tempo_do_multi(),
+  and the beat tracker, see aubio_beattracking_get_memory_usage().
+
+*/
+uint_t aubio_tempo_get_memory_usage (const aubio_tempo_t * o);
+
 /** delete tempo detection object
 
   \param o beat tracking object
@@ -248,6 +705,33 @@ uint_t aubio_tempo_set_delay_ms(aubio_tempo_t * o, smpl_t delay);
 */
 void del_aubio_tempo(aubio_tempo_t * o);
 
+/** estimate the tempo and the beats of a whole detection function
+
+  \param df onset detection function of a complete signal, one value per hop,
+  for instance the output of aubio_specdesc_do() with the `specflux` method
+  \param hop_size number of samples between two values of `df`
+  \param samplerate sampling rate of the signal, in Hz
+  \param bpm where to store the tempo found, in beats per minute
+  \param beats where to store the time of each beat, in seconds, or NULL
+
+  \return number of beats found, which may be larger than the length of
+  `beats`; only the first beats are stored then
+
+  Unlike aubio_tempo_do(), which works hop by hop and can only look at the
+  past, this function looks at the whole signal at once. The tempo is the
+  strongest period, between 30 and 300 bpm, of the autocorrelation of the
+  detection function, computed with an FFT and weighted around 120 bpm. The
+  beats are then placed by dynamic programming, choosing the sequence that
+  best matches the onsets while keeping the intervals close to that period.
+
+  The time of a beat is the index of its value in `df` times `hop_size`
+  divided by `samplerate`; the delay of the detection function, if any,
+  is not removed.
+
+*/
+uint_t aubio_tempo_analyze (const fvec_t * df, uint_t hop_size,
+    uint_t samplerate, smpl_t * bpm, fvec_t * beats);
+
 #ifdef __cplusplus
 }
 #endif
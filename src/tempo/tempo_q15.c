@@ -0,0 +1,594 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "spectral/fft_q15_priv.h"
+#include "tempo/tempo_q15.h"
+
+/* window of the peak picker, as in onset/peakpicker.c */
+#define AUBIO_TEMPO_Q15_PRE 1
+#define AUBIO_TEMPO_Q15_POST 5
+#define AUBIO_TEMPO_Q15_PEAK (AUBIO_TEMPO_Q15_PRE + AUBIO_TEMPO_Q15_POST + 1)
+
+/* beat periods and positions are counted in hops, in Q8 */
+#define AUBIO_TEMPO_Q15_HOP 256
+
+/* resolution of the gaussian weighting, in steps per hop */
+#define AUBIO_TEMPO_Q15_GAUSS_STEPS 16
+
+/* onset detection functions */
+typedef enum {
+  aubio_tempo_q15_energy,
+  aubio_tempo_q15_hfc,
+  aubio_tempo_q15_specflux,
+} aubio_tempo_q15_method_t;
+
+struct _aubio_tempo_q15_t {
+  aubio_tempo_q15_method_t method;
+  uint_t buf_size;
+  uint_t hop_size;
+  uint_t samplerate;
+
+  s16_t *frame;                 /**< last samples [buf_size] */
+  aubio_fft_q15_t *fft;         /**< fixed-point fft */
+  uint_t *norm;                 /**< magnitudes, in Q15 [buf_size / 2 + 1] */
+  uint_t *oldnorm;              /**< previous magnitudes, for specflux */
+  uint_t desc_shift;            /**< right shift keeping the descriptor
+                                  below 2^30 */
+  sint_t desc;                  /**< last onset detection function value */
+
+  sint_t threshold;             /**< peak picker threshold, in Q15 */
+  sint_t x1, x2, y1;            /**< state of the smoothing filter */
+  sint_t ring[AUBIO_TEMPO_Q15_PEAK]; /**< smoothed detection function */
+  uint_t ring_pos;              /**< next position to overwrite in ring */
+  long long ring_sum;           /**< sum of the elements of ring */
+  sint_t peek[3];               /**< last thresholded values */
+  uint_t onset;                 /**< whether peek[1] is a peak */
+
+  sint_t silence;               /**< silence threshold, in dB */
+  unsigned long long silence_energy; /**< sum of squares of a silent hop */
+
+  uint_t winlen;                /**< length of the detection function window */
+  uint_t step;                  /**< hops between two beat tracking runs */
+  uint_t laglen;                /**< number of beat periods searched */
+  sint_t blockpos;              /**< hop within the current step */
+  sint_t *dfframe;              /**< thresholded detection function [winlen] */
+  sint_t *dfrev;                /**< weighted and reversed dfframe [winlen] */
+  sint_t *acf;                  /**< autocorrelation of dfframe [winlen] */
+  long long *acfout;            /**< comb filterbank output [laglen] */
+  long long *phout;             /**< phase comb output [2 * laglen] */
+  s16_t *rwv;                   /**< rayleigh weighting, in Q15 [laglen] */
+  s16_t *dfwv;                  /**< exponential weighting, in Q15 [winlen] */
+  s16_t *gwv;                   /**< gaussian weighting of the distance to
+                                  the period of the context model [gauss_len] */
+  uint_t gauss_len;             /**< length of gwv */
+  sint_t g_var;                 /**< width of the context model, in Q8 */
+  sint_t min_bp;                /**< shorter beat periods are doubled */
+  sint_t rp, rp1, rp2;          /**< last three periods of the general model */
+  sint_t gp;                    /**< period of the context model */
+  sint_t bp;                    /**< beat period */
+  sint_t counter;               /**< steps left before checking the model */
+  uint_t flagstep;              /**< whether a change of period was seen */
+  uint_t context;               /**< whether the context model is active */
+  sint_t lastbeat;              /**< last beat, from the start of the step */
+  sint_t *beats;                /**< beats of the current step [step + 2] */
+  uint_t n_beats;               /**< number of beats in the current step */
+
+  uint_t total_frames;          /**< samples processed so far */
+  uint_t last_beat;             /**< position of the last beat, in samples */
+};
+
+static void aubio_tempo_q15_track (aubio_tempo_q15_t *o);
+
+aubio_tempo_q15_t *new_aubio_tempo_q15 (const char_t *method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate)
+{
+  aubio_tempo_q15_t *o = AUBIO_NEW (aubio_tempo_q15_t);
+  uint_t i, half = buf_size / 2;
+  smpl_t rayparam, bound, max_rwv = 0., dfwvnorm;
+  if (!o) return NULL;
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR ("tempo_q15: got hop size %d, but can not be < 1\n", hop_size);
+    goto beach;
+  } else if (buf_size < hop_size) {
+    AUBIO_ERR ("tempo_q15: hop size (%d) is larger than window size (%d)\n",
+        hop_size, buf_size);
+    goto beach;
+  } else if ((sint_t)samplerate < 1) {
+    AUBIO_ERR ("tempo_q15: samplerate (%d) can not be < 1\n", samplerate);
+    goto beach;
+  }
+  if (method == NULL || strcmp (method, "default") == 0
+      || strcmp (method, "specflux") == 0) {
+    o->method = aubio_tempo_q15_specflux;
+  } else if (strcmp (method, "energy") == 0) {
+    o->method = aubio_tempo_q15_energy;
+  } else if (strcmp (method, "hfc") == 0) {
+    o->method = aubio_tempo_q15_hfc;
+  } else {
+    AUBIO_ERR ("tempo_q15: unknown method %s, expected energy, hfc or "
+        "specflux\n", method);
+    goto beach;
+  }
+  o->buf_size = buf_size;
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+
+  // the transform checks buf_size
+  o->fft = new_aubio_fft_q15 (buf_size);
+  if (!o->fft) goto beach;
+  o->frame = AUBIO_ARRAY (s16_t, buf_size);
+  o->norm = AUBIO_ARRAY (uint_t, half + 1);
+  o->oldnorm = AUBIO_ARRAY (uint_t, half + 1);
+  if (!o->frame || !o->norm || !o->oldnorm) goto beach;
+
+  // bound of the descriptor of a full scale frame, from Parseval's theorem
+  if (o->method == aubio_tempo_q15_energy) {
+    bound = (smpl_t) buf_size * buf_size * 1073741824.;
+  } else if (o->method == aubio_tempo_q15_hfc) {
+    bound = SQRT ((half + 1.) * (half + 1.) * (half + 1.) / 3.)
+      * buf_size * 32768.;
+  } else {
+    bound = SQRT (half + 1.) * buf_size * 32768.;
+  }
+  while (bound >= 1073741824.) {
+    bound /= 2.;
+    o->desc_shift++;
+  }
+
+  // same lengths as aubio_tempo_t, about 6 seconds of hops
+  o->winlen = 4;
+  while (o->winlen < 5.8 * samplerate / hop_size) o->winlen <<= 1;
+  o->step = o->winlen / 4;
+  o->laglen = o->winlen / 4;
+  o->dfframe = AUBIO_ARRAY (sint_t, o->winlen);
+  o->dfrev = AUBIO_ARRAY (sint_t, o->winlen);
+  o->acf = AUBIO_ARRAY (sint_t, o->winlen);
+  o->acfout = AUBIO_ARRAY (long long, o->laglen);
+  o->phout = AUBIO_ARRAY (long long, 2 * o->laglen);
+  o->rwv = AUBIO_ARRAY (s16_t, o->laglen);
+  o->dfwv = AUBIO_ARRAY (s16_t, o->winlen);
+  o->beats = AUBIO_ARRAY (sint_t, o->step + 2);
+  if (!o->dfframe || !o->dfrev || !o->acf || !o->acfout || !o->phout
+      || !o->rwv || !o->dfwv || !o->beats) {
+    goto beach;
+  }
+
+  // weightings of tempo/beattracking.c, rayleigh normalised to its maximum
+  rayparam = 60. * samplerate / 120. / hop_size;
+  for (i = 0; i < o->laglen; i++) {
+    smpl_t w = (i + 1.) * EXP (-SQR (i + 1.) / (2. * SQR (rayparam)));
+    if (w > max_rwv) max_rwv = w;
+  }
+  for (i = 0; i < o->laglen; i++) {
+    smpl_t w = (i + 1.) * EXP (-SQR (i + 1.) / (2. * SQR (rayparam)));
+    o->rwv[i] = (s16_t) ROUND (32767. * w / max_rwv);
+  }
+  dfwvnorm = EXP ((LOG (2.0) / rayparam) * (o->winlen + 2));
+  for (i = 0; i < o->winlen; i++) {
+    o->dfwv[i] = (s16_t) ROUND (32767. *
+        EXP ((LOG (2.0) / rayparam) * (i + 1)) / dfwvnorm);
+  }
+  // gaussian of the context model, down to exp(-8)
+  o->g_var = (sint_t) ROUND (3.901 * AUBIO_TEMPO_Q15_HOP);
+  o->gauss_len = (uint_t) CEIL (4. * 3.901 * AUBIO_TEMPO_Q15_GAUSS_STEPS);
+  o->gwv = AUBIO_ARRAY (s16_t, o->gauss_len);
+  if (!o->gwv) goto beach;
+  for (i = 0; i < o->gauss_len; i++) {
+    smpl_t d = i / (smpl_t) AUBIO_TEMPO_Q15_GAUSS_STEPS;
+    o->gwv[i] = (s16_t) ROUND (32767. * EXP (-.5 * SQR (d) / SQR (3.901)));
+  }
+  o->min_bp = 25 * AUBIO_TEMPO_Q15_HOP;
+
+  o->threshold = 9830;
+  if (aubio_tempo_q15_set_silence (o, -90)) goto beach;
+  return o;
+
+beach:
+  del_aubio_tempo_q15 (o);
+  return NULL;
+}
+
+/* onset detection function of the magnitudes, updating oldnorm */
+static sint_t aubio_tempo_q15_descriptor (aubio_tempo_q15_t *o)
+{
+  uint_t k, length = o->buf_size / 2 + 1;
+  unsigned long long acc = 0;
+  const uint_t *norm = o->norm;
+  switch (o->method) {
+    case aubio_tempo_q15_energy:
+      for (k = 0; k < length; k++) {
+        acc += (unsigned long long) norm[k] * norm[k];
+      }
+      break;
+    case aubio_tempo_q15_hfc:
+      for (k = 0; k < length; k++) {
+        acc += (unsigned long long) (k + 1) * norm[k];
+      }
+      break;
+    case aubio_tempo_q15_specflux:
+      for (k = 0; k < length; k++) {
+        if (norm[k] > o->oldnorm[k]) acc += norm[k] - o->oldnorm[k];
+        o->oldnorm[k] = norm[k];
+      }
+      break;
+  }
+  acc >>= o->desc_shift;
+  return acc > 0x7fffffff ? 0x7fffffff : (sint_t) acc;
+}
+
+/* causal peak picker of onset/peakpicker.c: smooth the new value, replace
+ * the oldest one of the window, and threshold the middle of the window with
+ * its median and mean */
+static sint_t aubio_tempo_q15_peakpick (aubio_tempo_q15_t *o, sint_t input)
+{
+  sint_t sorted[AUBIO_TEMPO_Q15_PEAK], value;
+  long long y, mean, thresholded;
+  uint_t i, j;
+  // biquad of new_aubio_peakpicker, in Q15
+  y = (5242LL * input + 10485LL * o->x1 + 5242LL * o->x2
+      - 7695LL * o->y1) >> 15;
+  o->x2 = o->x1;
+  o->x1 = input;
+  o->y1 = (sint_t) y;
+
+  o->ring_sum += y - o->ring[o->ring_pos];
+  o->ring[o->ring_pos] = (sint_t) y;
+  o->ring_pos = (o->ring_pos + 1) % AUBIO_TEMPO_Q15_PEAK;
+
+  // insertion sort of the window, for its median
+  for (i = 0; i < AUBIO_TEMPO_Q15_PEAK; i++) {
+    value = o->ring[i];
+    for (j = i; j > 0 && sorted[j - 1] > value; j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = value;
+  }
+  mean = o->ring_sum / AUBIO_TEMPO_Q15_PEAK;
+  thresholded = (long long) o->ring[(o->ring_pos + AUBIO_TEMPO_Q15_POST)
+      % AUBIO_TEMPO_Q15_PEAK] - sorted[AUBIO_TEMPO_Q15_PEAK / 2]
+    - ((mean * o->threshold) >> 15);
+  if (thresholded > 0x7fffffff) thresholded = 0x7fffffff;
+  if (thresholded < -0x7fffffff) thresholded = -0x7fffffff;
+
+  o->peek[0] = o->peek[1];
+  o->peek[1] = o->peek[2];
+  o->peek[2] = (sint_t) thresholded;
+  o->onset = o->peek[1] > o->peek[0] && o->peek[1] > o->peek[2]
+    && o->peek[1] > 0;
+  return o->peek[2];
+}
+
+uint_t aubio_tempo_q15_do (aubio_tempo_q15_t *o, const s16_t *input)
+{
+  uint_t i, beat = 0, keep = o->buf_size - o->hop_size;
+  unsigned long long energy = 0;
+  for (i = 0; i < keep; i++) {
+    o->frame[i] = o->frame[i + o->hop_size];
+  }
+  for (i = 0; i < o->hop_size; i++) {
+    o->frame[keep + i] = input[i];
+    energy += (unsigned long long) ((sint_t) input[i] * input[i]);
+  }
+  aubio_fft_q15_norm (o->fft, o->frame, o->norm);
+  o->desc = aubio_tempo_q15_descriptor (o);
+
+  // run the beat tracker once per step, as in aubio_tempo_do
+  if (o->blockpos == (sint_t) o->step - 1) {
+    aubio_tempo_q15_track (o);
+    for (i = 0; i < o->winlen - o->step; i++) {
+      o->dfframe[i] = o->dfframe[i + o->step];
+    }
+    for (i = o->winlen - o->step; i < o->winlen; i++) {
+      o->dfframe[i] = 0;
+    }
+    o->blockpos = -1;
+  }
+  o->blockpos++;
+  o->dfframe[o->winlen - o->step + o->blockpos] =
+    aubio_tempo_q15_peakpick (o, o->desc);
+
+  for (i = 0; i < o->n_beats; i++) {
+    if (o->blockpos == o->beats[i] / AUBIO_TEMPO_Q15_HOP) {
+      sint_t frac = o->beats[i] % AUBIO_TEMPO_Q15_HOP;
+      o->last_beat = o->total_frames
+        + (frac * o->hop_size + AUBIO_TEMPO_Q15_HOP / 2) / AUBIO_TEMPO_Q15_HOP;
+      // drop the beats of silent hops
+      beat = energy >= o->silence_energy;
+    }
+  }
+  o->total_frames += o->hop_size;
+  return beat;
+}
+
+/* position of the peak of x around pos, in Q8, from a quadratic fit */
+static sint_t aubio_tempo_q15_peak_pos (const long long *x, uint_t length,
+    uint_t pos)
+{
+  long long den;
+  if (pos == 0 || pos + 1 >= length) return pos * AUBIO_TEMPO_Q15_HOP;
+  den = x[pos - 1] - 2 * x[pos] + x[pos + 1];
+  if (den == 0) return pos * AUBIO_TEMPO_Q15_HOP;
+  return pos * AUBIO_TEMPO_Q15_HOP
+    + (sint_t) ((AUBIO_TEMPO_Q15_HOP / 2) * (x[pos - 1] - x[pos + 1]) / den);
+}
+
+/* index of the first maximum of x */
+static uint_t aubio_tempo_q15_max_elem (const long long *x, uint_t length)
+{
+  uint_t j, pos = 0;
+  for (j = 1; j < length; j++) {
+    if (x[j] > x[pos]) pos = j;
+  }
+  return pos;
+}
+
+/* shift invariant comb filterbank of the autocorrelation, with 4 elements
+ * and the gaussian weighting of the context model or the rayleigh one */
+static void aubio_tempo_q15_comb (aubio_tempo_q15_t *o, uint_t gaussian)
+{
+  uint_t i, a, b;
+  for (i = 0; i < o->laglen; i++) {
+    long long sum = 0, w;
+    if (i < 1 || i + 2 > o->laglen) {
+      o->acfout[i] = 0;
+      continue;
+    }
+    for (a = 1; a <= 4; a++) {
+      long long part = 0;
+      for (b = 1; b < 2 * a; b++) {
+        part += o->acf[i * a + b - 1];
+      }
+      sum += part * 32768 / (2 * a - 1);
+    }
+    sum >>= 15;
+    if (gaussian) {
+      sint_t d = (sint_t) (i + 1) * AUBIO_TEMPO_Q15_HOP - o->gp;
+      uint_t index = (uint_t) ((d < 0 ? -d : d) * AUBIO_TEMPO_Q15_GAUSS_STEPS
+          / AUBIO_TEMPO_Q15_HOP);
+      w = index < o->gauss_len ? o->gwv[index] : 0;
+    } else {
+      w = o->rwv[i];
+    }
+    o->acfout[i] = (sum * w) >> 15;
+  }
+}
+
+/* the two state model of tempo/beattracking.c */
+static void aubio_tempo_q15_checkstate (aubio_tempo_q15_t *o)
+{
+  uint_t flagconst = 0;
+  sint_t gp = 0, d;
+  if (o->gp) {
+    aubio_tempo_q15_comb (o, 1);
+    gp = aubio_tempo_q15_peak_pos (o->acfout, o->laglen,
+        aubio_tempo_q15_max_elem (o->acfout, o->laglen));
+  }
+  if (o->counter == 0) {
+    d = gp - o->rp;
+    if ((d < 0 ? -d : d) > 2 * o->g_var) {
+      o->flagstep = 1;
+      o->counter = 3;
+    } else {
+      o->flagstep = 0;
+    }
+  }
+  if (o->counter == 1 && o->flagstep == 1) {
+    d = 2 * o->rp - o->rp1 - o->rp2;
+    if ((d < 0 ? -d : d) < o->g_var) {
+      flagconst = 1;
+      o->counter = 0;
+    } else {
+      o->counter = 2;
+    }
+  } else if (o->counter > 0) {
+    o->counter--;
+  }
+  o->rp2 = o->rp1;
+  o->rp1 = o->rp;
+
+  if (flagconst) {
+    gp = o->rp;
+    o->context = 1;
+    o->bp = gp;
+  } else if (o->context) {
+    o->bp = gp;
+  } else {
+    o->bp = o->rp;
+  }
+  o->gp = gp;
+  while (0 < o->bp && o->bp < o->min_bp) {
+    o->bp *= 2;
+  }
+}
+
+/* find the beat period and phase of the detection function window, and the
+ * beats of the next step */
+static void aubio_tempo_q15_track (aubio_tempo_q15_t *o)
+{
+  uint_t i, k, kmax, winlen = o->winlen, maxindex, shift = 0;
+  sint_t max = 0, phase, beat, bp, step = o->step * AUBIO_TEMPO_Q15_HOP;
+
+  // scale the window to 15 bits, so that the sums of products fit 64 bits
+  for (i = 0; i < winlen; i++) {
+    sint_t v = o->dfframe[i] < 0 ? -o->dfframe[i] : o->dfframe[i];
+    if (v > max) max = v;
+  }
+  while ((max >> shift) >= 32768) shift++;
+  for (i = 0; i < winlen; i++) {
+    o->dfrev[i] = o->dfframe[i] >> shift;
+  }
+  for (i = 0; i < winlen; i++) {
+    long long sum = 0;
+    for (k = i; k < winlen; k++) {
+      sum += (long long) o->dfrev[k - i] * o->dfrev[k];
+    }
+    o->acf[i] = (sint_t) (sum / (sint_t) (winlen - i));
+  }
+  // weighted and reversed window, for the phase
+  for (i = 0; i < winlen; i++) {
+    o->dfrev[winlen - 1 - i] =
+      (sint_t) (((long long) o->dfframe[i] * o->dfwv[i]) >> 15);
+  }
+
+  // period of the general model
+  aubio_tempo_q15_comb (o, 0);
+  maxindex = aubio_tempo_q15_max_elem (o->acfout, o->laglen);
+  if (maxindex > 0 && maxindex < o->laglen - 1) {
+    o->rp = aubio_tempo_q15_peak_pos (o->acfout, o->laglen, maxindex);
+  } else {
+    o->rp = (sint_t) (60 * o->samplerate / 120 * AUBIO_TEMPO_Q15_HOP
+        / o->hop_size);
+  }
+  aubio_tempo_q15_checkstate (o);
+
+  bp = o->bp;
+  o->n_beats = 0;
+  if (bp <= 0) return;
+
+  // phase of the beats
+  kmax = winlen * AUBIO_TEMPO_Q15_HOP / bp;
+  for (i = 0; i < 2 * o->laglen; i++) {
+    o->phout[i] = 0;
+    if ((sint_t) (i * AUBIO_TEMPO_Q15_HOP) >= bp) continue;
+    for (k = 0; k < kmax; k++) {
+      uint_t idx = i + (bp * k + AUBIO_TEMPO_Q15_HOP / 2) / AUBIO_TEMPO_Q15_HOP;
+      if (idx < winlen) o->phout[i] += o->dfrev[idx];
+    }
+  }
+  maxindex = aubio_tempo_q15_max_elem (o->phout, 2 * o->laglen);
+  if (maxindex >= winlen - 1) {
+    phase = step - o->lastbeat;
+  } else {
+    phase = aubio_tempo_q15_peak_pos (o->phout, 2 * o->laglen, maxindex);
+  }
+  // take back one hop of delay
+  phase += AUBIO_TEMPO_Q15_HOP;
+
+  beat = bp - phase;
+  // the next beat is earlier than 60% of the period, skip it
+  if ((step - o->lastbeat - phase) * 10 < -4 * bp) {
+    beat += bp;
+  }
+  while (beat + bp < 0) {
+    beat += bp;
+  }
+  if (beat >= 0) {
+    o->beats[o->n_beats++] = beat;
+  }
+  while (beat + bp <= step && o->n_beats < o->step + 2) {
+    beat += bp;
+    o->beats[o->n_beats++] = beat;
+  }
+  o->lastbeat = beat;
+}
+
+uint_t aubio_tempo_q15_get_last (const aubio_tempo_q15_t *o)
+{
+  return o->last_beat;
+}
+
+uint_t aubio_tempo_q15_get_bpm (const aubio_tempo_q15_t *o)
+{
+  if (o->bp <= 0) return 0;
+  // 60 * samplerate / hop_size / (bp / 256), times 256
+  return (uint_t) (60ULL * o->samplerate * AUBIO_TEMPO_Q15_HOP
+      * AUBIO_TEMPO_Q15_HOP / ((unsigned long long) o->bp * o->hop_size));
+}
+
+uint_t aubio_tempo_q15_get_period (const aubio_tempo_q15_t *o)
+{
+  if (o->bp <= 0) return 0;
+  return (uint_t) (((unsigned long long) o->bp * o->hop_size
+        + AUBIO_TEMPO_Q15_HOP / 2) / AUBIO_TEMPO_Q15_HOP);
+}
+
+uint_t aubio_tempo_q15_get_onset (const aubio_tempo_q15_t *o)
+{
+  return o->onset;
+}
+
+sint_t aubio_tempo_q15_get_descriptor (const aubio_tempo_q15_t *o)
+{
+  return o->desc;
+}
+
+uint_t aubio_tempo_q15_set_threshold (aubio_tempo_q15_t *o, sint_t threshold)
+{
+  if (threshold < 0) {
+    AUBIO_ERR ("tempo_q15: got threshold %d, expected >= 0\n", threshold);
+    return AUBIO_FAIL;
+  }
+  o->threshold = threshold;
+  return AUBIO_OK;
+}
+
+sint_t aubio_tempo_q15_get_threshold (const aubio_tempo_q15_t *o)
+{
+  return o->threshold;
+}
+
+uint_t aubio_tempo_q15_set_silence (aubio_tempo_q15_t *o, sint_t silence)
+{
+  if (silence > 0) {
+    AUBIO_ERR ("tempo_q15: got silence %d dB, expected <= 0\n", silence);
+    return AUBIO_FAIL;
+  }
+  o->silence = silence;
+  // sum of the squares of a hop at this level, for samples in Q15
+  o->silence_energy = (unsigned long long) (o->hop_size * 1073741824.
+      * POW (10., silence / 10.));
+  return AUBIO_OK;
+}
+
+sint_t aubio_tempo_q15_get_silence (const aubio_tempo_q15_t *o)
+{
+  return o->silence;
+}
+
+uint_t aubio_tempo_q15_get_memory_usage (const aubio_tempo_q15_t *o)
+{
+  return aubio_malloc_size (o) + aubio_fft_q15_get_memory_usage (o->fft)
+    + aubio_malloc_size (o->frame) + aubio_malloc_size (o->norm)
+    + aubio_malloc_size (o->oldnorm) + aubio_malloc_size (o->dfframe)
+    + aubio_malloc_size (o->dfrev) + aubio_malloc_size (o->acf)
+    + aubio_malloc_size (o->acfout) + aubio_malloc_size (o->phout)
+    + aubio_malloc_size (o->rwv) + aubio_malloc_size (o->dfwv)
+    + aubio_malloc_size (o->gwv) + aubio_malloc_size (o->beats);
+}
+
+void del_aubio_tempo_q15 (aubio_tempo_q15_t *o)
+{
+  AUBIO_ASSERT (o);
+  if (o->fft) del_aubio_fft_q15 (o->fft);
+  if (o->frame) AUBIO_FREE (o->frame);
+  if (o->norm) AUBIO_FREE (o->norm);
+  if (o->oldnorm) AUBIO_FREE (o->oldnorm);
+  if (o->dfframe) AUBIO_FREE (o->dfframe);
+  if (o->dfrev) AUBIO_FREE (o->dfrev);
+  if (o->acf) AUBIO_FREE (o->acf);
+  if (o->acfout) AUBIO_FREE (o->acfout);
+  if (o->phout) AUBIO_FREE (o->phout);
+  if (o->rwv) AUBIO_FREE (o->rwv);
+  if (o->dfwv) AUBIO_FREE (o->dfwv);
+  if (o->gwv) AUBIO_FREE (o->gwv);
+  if (o->beats) AUBIO_FREE (o->beats);
+  AUBIO_FREE (o);
+}
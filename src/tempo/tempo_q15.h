@@ -0,0 +1,195 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Fixed-point beat tracking, for processors without a floating point unit
+
+  This object runs the same chain as ::aubio_tempo_t, a phase vocoder, an
+  onset detection function, a peak picker and a beat tracker, on 16 bit
+  samples, with integer operations only. It is meant for microcontrollers
+  such as the Cortex-M0 or M3, or the ESP32 cores, which can then follow the
+  beats of their own microphone:
+
+  \code
+  aubio_tempo_q15_t *o = new_aubio_tempo_q15 ("default", 1024, 512, 44100);
+  while (read_microphone (samples, 512)) {
+    if (aubio_tempo_q15_do (o, samples)) {
+      flash_leds (aubio_tempo_q15_get_bpm (o) >> 8);
+    }
+  }
+  \endcode
+
+  Floating point operations are only used by ::new_aubio_tempo_q15 and the
+  setters, to compute the tables of the object, so that a soft float library
+  is enough. The files needed are tempo/tempo_q15.c, spectral/fft_q15.c,
+  utils/allocator.c and utils/log.c.
+
+  Compared to ::aubio_tempo_t, the peak picker runs in the causal mode of
+  ::aubio_peakpicker_set_incremental, the time signature is not estimated,
+  and the phase of the beats is searched without weighting. Only the
+  `energy`, `hfc` and `specflux` onset detection functions are available.
+
+  \example tempo/test-tempo_q15.c
+
+*/
+
+#ifndef AUBIO_TEMPO_Q15_H
+#define AUBIO_TEMPO_Q15_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** fixed-point beat tracking object */
+typedef struct _aubio_tempo_q15_t aubio_tempo_q15_t;
+
+/** create fixed-point beat tracking object
+
+  \param method onset detection function, `energy`, `hfc`, `specflux`, or
+  `default`, the same as `specflux`
+  \param buf_size length of the FFT, a power of 2 from 16 to 8192
+  \param hop_size number of samples between two consecutive runs
+  \param samplerate sampling rate of the signal to analyze
+
+  \return newly created ::aubio_tempo_q15_t if successful, `NULL` otherwise
+
+*/
+aubio_tempo_q15_t *new_aubio_tempo_q15 (const char_t *method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate);
+
+/** execute beat tracking on a new hop of samples
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+  \param input `hop_size` new samples
+
+  \return 1 when a beat was found in this hop, 0 otherwise
+
+*/
+uint_t aubio_tempo_q15_do (aubio_tempo_q15_t *o, const s16_t *input);
+
+/** get the position of the last beat, in samples
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return position of the last beat, counted from the first sample
+
+*/
+uint_t aubio_tempo_q15_get_last (const aubio_tempo_q15_t *o);
+
+/** get the current tempo, in Q8
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return number of beats per minute, times 256, or 0 if no tempo was found
+
+*/
+uint_t aubio_tempo_q15_get_bpm (const aubio_tempo_q15_t *o);
+
+/** get the current beat period, in samples
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return number of samples between two beats, or 0 if no tempo was found
+
+*/
+uint_t aubio_tempo_q15_get_period (const aubio_tempo_q15_t *o);
+
+/** check whether the peak picker found an onset
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return 1 if the previous hop held an onset, 0 otherwise
+
+  As with ::aubio_onset_t, the onsets are found one hop after theirs.
+
+*/
+uint_t aubio_tempo_q15_get_onset (const aubio_tempo_q15_t *o);
+
+/** get the value of the onset detection function for the last hop
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return onset detection function, in a fixed scale for a given method and
+  `buf_size`, with full scale signals below 2^30
+
+*/
+sint_t aubio_tempo_q15_get_descriptor (const aubio_tempo_q15_t *o);
+
+/** set the threshold of the peak picker
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+  \param threshold threshold, in Q15, defaults to 9830, that is 0.3
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_tempo_q15_set_threshold (aubio_tempo_q15_t *o, sint_t threshold);
+
+/** get the threshold of the peak picker
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return threshold, in Q15
+
+*/
+sint_t aubio_tempo_q15_get_threshold (const aubio_tempo_q15_t *o);
+
+/** set the silence threshold
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+  \param silence level under which the beats are dropped, in dB, defaults to
+  -90
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_tempo_q15_set_silence (aubio_tempo_q15_t *o, sint_t silence);
+
+/** get the silence threshold
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return silence threshold, in dB
+
+*/
+sint_t aubio_tempo_q15_get_silence (const aubio_tempo_q15_t *o);
+
+/** get the memory used by a fixed-point beat tracking object
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+  \return number of bytes allocated by the object, see utils/allocator.h
+
+*/
+uint_t aubio_tempo_q15_get_memory_usage (const aubio_tempo_q15_t *o);
+
+/** delete fixed-point beat tracking object
+
+  \param o beat tracking object, created by ::new_aubio_tempo_q15
+
+*/
+void del_aubio_tempo_q15 (aubio_tempo_q15_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_TEMPO_Q15_H */
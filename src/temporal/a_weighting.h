@@ -43,14 +43,15 @@
     - <a href="http://www.mathworks.com/matlabcentral/fileexchange/69">Christophe
   Couvreur's 'octave' toolbox</a>
 
-  The coefficients in this file have been computed using Christophe Couvreur's
-  scripts in octave 3.0 (debian package 1:3.0.5-6+b2 with octave-signal
-  1.0.9-1+b1 on i386), with <pre> [b, a] = adsign(1/Fs) </pre> for various
-  sampling frequencies (8000, 11025, 16000, 22050, 24000, 32000, 44100, 48000,
-  88200, 96000, and 192000 Hz).
+  The filter is computed for any sampling frequency with the bilinear
+  transform of the analog filter, as done by Christophe Couvreur's <pre> [b, a]
+  = adsign(1/Fs) </pre>, and run as a cascade of second order sections, which
+  remains accurate at high sampling frequencies, where the poles get close to
+  the unit circle. The coefficients returned by aubio_filter_get_feedforward()
+  and aubio_filter_get_feedback() are those of the equivalent direct form.
 
-  The sampling frequency should normally be higher than 20kHz, but most common
-  file sampling rates have been included for completeness.
+  The sampling frequency should normally be higher than 20kHz, so that the
+  whole range of the weighting is represented.
 
   \example temporal/test-a_weighting.c
 
@@ -62,9 +63,7 @@ extern "C" {
 
 /** create new A-design filter
 
-  \param samplerate sampling frequency of the signal to filter. Should be one of
-  8000, 11025, 16000, 22050, 24000, 32000, 44100, 48000, 88200, 96000, and
-  192000 Hz
+  \param samplerate sampling frequency of the signal to filter, in Hz
 
   \return a new filter object
 
@@ -74,9 +73,7 @@ aubio_filter_t *new_aubio_filter_a_weighting (uint_t samplerate);
 /** set feedback and feedforward coefficients of a A-weighting filter
 
   \param f filter object to get coefficients from
-  \param samplerate sampling frequency of the signal to filter. Should be one of
-  8000, 11025, 16000, 22050, 24000, 32000, 44100, 48000, 88200, 96000, and
-  192000 Hz
+  \param samplerate sampling frequency of the signal to filter, in Hz
 
 */
 uint_t aubio_filter_set_a_weighting (aubio_filter_t * f, uint_t samplerate);
@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "mathutils.h"
+#include "spectral/gpu.h"
+#include "spectral/fft.h"
+#include "temporal/convolver.h"
+#include "utils/simd_priv.h"
+
+struct _aubio_convolver_t
+{
+  uint_t block_size;    /**< samples of each input block */
+  uint_t bins;          /**< bins of each spectrum, block_size + 1 */
+  uint_t max_parts;     /**< partitions of the longest impulse response */
+  uint_t n_parts;       /**< partitions of the current impulse response */
+  uint_t pos;           /**< row of the newest block in past */
+  aubio_fft_t *fft;     /**< transforms of 2 * block_size samples */
+  fmat_t *parts;        /**< spectra of the partitions, one per row */
+  fmat_t *past;         /**< spectra of the past input blocks, one per row */
+  fvec_t *frame;        /**< last two input blocks */
+  fvec_t *compspec;     /**< spectrum in the layout of aubio_fft_t */
+  fvec_t *acc;          /**< sum of the products of the spectra */
+  fvec_t *out;          /**< inverse transform of acc */
+};
+
+/* from the layout of aubio_fft_t, the imaginary parts reversed after the real
+   ones, to bins real parts followed by bins imaginary parts */
+static void
+aubio_convolver_split (const aubio_convolver_t * o, const smpl_t * compspec,
+    smpl_t * spec)
+{
+  uint_t i, size = 2 * o->block_size;
+  smpl_t *imag = spec + o->bins;
+  AUBIO_MEMCPY (spec, compspec, o->bins * sizeof(smpl_t));
+  imag[0] = 0.;
+  imag[o->block_size] = 0.;
+  for (i = 1; i < o->block_size; i++) {
+    imag[i] = compspec[size - i];
+  }
+}
+
+/* the reverse of aubio_convolver_split, the imaginary parts of the first and
+   last bins being dropped */
+static void
+aubio_convolver_join (const aubio_convolver_t * o, const smpl_t * spec,
+    smpl_t * compspec)
+{
+  uint_t i, size = 2 * o->block_size;
+  const smpl_t *imag = spec + o->bins;
+  AUBIO_MEMCPY (compspec, spec, o->bins * sizeof(smpl_t));
+  for (i = 1; i < o->block_size; i++) {
+    compspec[size - i] = imag[i];
+  }
+}
+
+aubio_convolver_t *
+new_aubio_convolver (const fvec_t * impulse, uint_t block_size)
+{
+  aubio_convolver_t *o = AUBIO_NEW (aubio_convolver_t);
+  if (!o) return NULL;
+  if ((sint_t)block_size < 1 || !aubio_is_power_of_two (block_size)) {
+    AUBIO_ERR ("convolver: block size should be a power of 2, got %d\n",
+        block_size);
+    goto beach;
+  }
+  if (impulse->length < 1) {
+    AUBIO_ERR ("convolver: got an empty impulse response\n");
+    goto beach;
+  }
+  o->block_size = block_size;
+  o->bins = block_size + 1;
+  o->max_parts = (impulse->length + block_size - 1) / block_size;
+  o->fft = new_aubio_fft (2 * block_size);
+  o->parts = new_fmat (o->max_parts, 2 * o->bins);
+  o->past = new_fmat (o->max_parts, 2 * o->bins);
+  o->frame = new_fvec (2 * block_size);
+  o->compspec = new_fvec (2 * block_size);
+  o->acc = new_fvec (2 * o->bins);
+  o->out = new_fvec (2 * block_size);
+  if (!o->fft || !o->parts || !o->past || !o->frame || !o->compspec
+      || !o->acc || !o->out) goto beach;
+  if (aubio_convolver_set_impulse (o, impulse)) goto beach;
+  return o;
+beach:
+  del_aubio_convolver (o);
+  return NULL;
+}
+
+uint_t
+aubio_convolver_set_impulse (aubio_convolver_t * o, const fvec_t * impulse)
+{
+  uint_t p, n_parts = (impulse->length + o->block_size - 1) / o->block_size;
+  if (impulse->length < 1 || n_parts > o->max_parts) {
+    AUBIO_ERR ("convolver: expected an impulse response of 1 to %d samples,"
+        " got %d\n", o->max_parts * o->block_size, impulse->length);
+    return AUBIO_FAIL;
+  }
+  // each partition padded with as many zeros, out used as scratch
+  for (p = 0; p < n_parts; p++) {
+    uint_t start = p * o->block_size;
+    uint_t len = MIN(o->block_size, impulse->length - start);
+    fvec_zeros (o->out);
+    AUBIO_MEMCPY (o->out->data, impulse->data + start, len * sizeof(smpl_t));
+    aubio_fft_do_complex (o->fft, o->out, o->compspec);
+    aubio_convolver_split (o, o->compspec->data, o->parts->data[p]);
+  }
+  o->n_parts = n_parts;
+  return AUBIO_OK;
+}
+
+void
+aubio_convolver_do (aubio_convolver_t * o, const fvec_t * input,
+    fvec_t * output)
+{
+  uint_t p, row, b = o->block_size;
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  if (input->length != b || output->length != b) {
+    AUBIO_ERR ("convolver: expected blocks of %d samples, got %d and %d\n",
+        b, input->length, output->length);
+    return;
+  }
+  // slide the frame, and keep the spectrum of the new one
+  AUBIO_MEMCPY (o->frame->data, o->frame->data + b, b * sizeof(smpl_t));
+  AUBIO_MEMCPY (o->frame->data + b, input->data, b * sizeof(smpl_t));
+  aubio_fft_do_complex (o->fft, o->frame, o->compspec);
+  o->pos = (o->pos + 1) % o->max_parts;
+  aubio_convolver_split (o, o->compspec->data, o->past->data[o->pos]);
+  // partition p meets the block received p blocks ago
+  fvec_zeros (o->acc);
+  row = o->pos;
+  for (p = 0; p < o->n_parts; p++) {
+    ops->cmac (o->past->data[row], o->parts->data[p], o->acc->data, o->bins);
+    row = row ? row - 1 : o->max_parts - 1;
+  }
+  aubio_convolver_join (o, o->acc->data, o->compspec->data);
+  aubio_fft_rdo_complex (o->fft, o->compspec, o->out);
+  // the first half is wrapped around, the second one is exact
+  AUBIO_MEMCPY (output->data, o->out->data + b, b * sizeof(smpl_t));
+}
+
+uint_t
+aubio_convolver_get_block_size (const aubio_convolver_t * o)
+{
+  return o->block_size;
+}
+
+void
+aubio_convolver_reset (aubio_convolver_t * o)
+{
+  fmat_zeros (o->past);
+  fvec_zeros (o->frame);
+}
+
+void
+del_aubio_convolver (aubio_convolver_t * o)
+{
+  if (o->fft) del_aubio_fft (o->fft);
+  if (o->parts) del_fmat (o->parts);
+  if (o->past) del_fmat (o->past);
+  if (o->frame) del_fvec (o->frame);
+  if (o->compspec) del_fvec (o->compspec);
+  if (o->acc) del_fvec (o->acc);
+  if (o->out) del_fvec (o->out);
+  AUBIO_FREE (o);
+}
@@ -0,0 +1,117 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_CONVOLVER_H
+#define AUBIO_CONVOLVER_H
+
+/** \file
+
+  FIR filtering by partitioned fast convolution
+
+  This object filters a signal with a finite impulse response, for instance
+  a room correction filter or a custom crossover, in blocks of a fixed size.
+
+  The impulse response is cut into partitions of the block size, and the
+  spectrum of each partition, computed with aubio_fft_t over twice the block
+  size, is kept. Each block of input is then transformed once, multiplied
+  with the spectra of the partitions and of the past input blocks, and
+  transformed back (uniformly partitioned overlap-save). The cost per sample
+  grows with the number of partitions, that is with the length of the
+  impulse response divided by the block size, instead of the length of the
+  impulse response.
+
+  The output is the exact convolution of the input with the impulse response,
+  without added latency, and no memory is allocated after creation.
+
+  \example temporal/test-convolver.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** partitioned convolution object */
+typedef struct _aubio_convolver_t aubio_convolver_t;
+
+/** create a partitioned convolution object
+
+  \param impulse impulse response of the filter
+  \param block_size number of samples of each input block, a power of 2
+
+  \return the newly created object, or NULL on failure
+
+*/
+aubio_convolver_t *new_aubio_convolver (const fvec_t * impulse,
+    uint_t block_size);
+
+/** filter a block of input
+
+  \param o convolver object as returned by new_aubio_convolver()
+  \param input input block, of `block_size` samples
+  \param output output block, of `block_size` samples, may be `input`
+
+*/
+void aubio_convolver_do (aubio_convolver_t * o, const fvec_t * input,
+    fvec_t * output);
+
+/** change the impulse response of the filter
+
+  \param o convolver object as returned by new_aubio_convolver()
+  \param impulse new impulse response, not longer than the one given to
+  new_aubio_convolver()
+
+  \return 0 if successful, non-zero otherwise
+
+  The past input is kept, so that the output switches to the new filter at
+  the next block.
+
+*/
+uint_t aubio_convolver_set_impulse (aubio_convolver_t * o,
+    const fvec_t * impulse);
+
+/** get the block size of the convolver
+
+  \param o convolver object as returned by new_aubio_convolver()
+
+  \return number of samples of each input block
+
+*/
+uint_t aubio_convolver_get_block_size (const aubio_convolver_t * o);
+
+/** clear the past input of the convolver
+
+  \param o convolver object as returned by new_aubio_convolver()
+
+*/
+void aubio_convolver_reset (aubio_convolver_t * o);
+
+/** delete a convolver
+
+  \param o convolver object as returned by new_aubio_convolver()
+
+*/
+void del_aubio_convolver (aubio_convolver_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_CONVOLVER_H */
@@ -27,6 +27,7 @@
 #include "lvec.h"
 #include "mathutils.h"
 #include "temporal/filter.h"
+#include "utils/denormal_priv.h"
 
 struct _aubio_filter_t
 {
@@ -34,10 +35,140 @@ struct _aubio_filter_t
   uint_t samplerate;
   lvec_t *a;
   lvec_t *b;
-  lvec_t *y;
-  lvec_t *x;
+  lvec_t *z;                    /**< state of the transposed direct form II */
+  uint_t n_sections;            /**< number of second order sections, 0 to
+                                  run the direct form */
+  lvec_t *sos;                  /**< b0, b1, b2, a1, a2 of each section */
+  lvec_t *sos_z;                /**< 2 state values per section */
+  lvec_t *sos_a;                /**< feedback of the expanded sections */
+  lvec_t *sos_b;                /**< feedforward of the expanded sections */
 };
 
+/* transposed direct form II, with the filter state kept in z[0..order-2]:
+
+     y[n]     = b[0] x[n] + z[0]
+     z[l-1]   = b[l] x[n] - a[l] y[n] + z[l]    for l in 1 .. order-2
+     z[order-2] = b[order-1] x[n] - a[order-1] y[n]
+
+   which computes the same difference equation as the direct form, without
+   shifting the history of x and y on each sample. */
+
+/* filter kernel of a fixed order, with coefficients and state held in local
+   variables for the whole block; the loops on l are unrolled by the compiler
+   for the orders of the biquad, c-weighting and a-weighting filters. INPUT
+   is applied to each sample read, KILL_DENORMAL or nothing when the block
+   runs with the flush-to-zero flags set, see utils/denormal_priv.h */
+#define AUBIO_FILTER_KERNEL(ORDER, NAME, INPUT) \
+static void \
+aubio_filter_do_ ## NAME (aubio_filter_t * f, smpl_t * data, \
+    uint_t length) \
+{ \
+  uint_t j, l; \
+  lsmp_t a[ORDER], b[ORDER], z[ORDER - 1], x, y; \
+  for (l = 0; l < ORDER; l++) { \
+    a[l] = f->a->data[l]; \
+    b[l] = f->b->data[l]; \
+  } \
+  for (l = 0; l < ORDER - 1; l++) { \
+    z[l] = f->z->data[l]; \
+  } \
+  for (j = 0; j < length; j++) { \
+    x = INPUT (data[j]); \
+    y = b[0] * x + z[0]; \
+    for (l = 1; l < ORDER - 1; l++) { \
+      z[l - 1] = b[l] * x - a[l] * y + z[l]; \
+    } \
+    z[ORDER - 2] = b[ORDER - 1] * x - a[ORDER - 1] * y; \
+    data[j] = y; \
+  } \
+  for (l = 0; l < ORDER - 1; l++) { \
+    f->z->data[l] = z[l]; \
+  } \
+}
+
+AUBIO_FILTER_KERNEL(3, order3, KILL_DENORMAL)
+AUBIO_FILTER_KERNEL(5, order5, KILL_DENORMAL)
+AUBIO_FILTER_KERNEL(7, order7, KILL_DENORMAL)
+AUBIO_FILTER_KERNEL(3, order3_ftz, )
+AUBIO_FILTER_KERNEL(5, order5_ftz, )
+AUBIO_FILTER_KERNEL(7, order7_ftz, )
+
+/* cascade of N second order sections, each in transposed direct form II.
+   The sections are run one sample at a time, so that the output of a section
+   stays in lsmp_t until the next one, and the processor can overlap the
+   recursions of consecutive sections. */
+#define AUBIO_FILTER_SOS_KERNEL(N, NAME, INPUT) \
+static void \
+aubio_filter_do_ ## NAME (aubio_filter_t * f, smpl_t * data, uint_t length) \
+{ \
+  uint_t j, s; \
+  lsmp_t c[5 * N], z[2 * N], y; \
+  for (s = 0; s < 5 * N; s++) { \
+    c[s] = f->sos->data[s]; \
+  } \
+  for (s = 0; s < 2 * N; s++) { \
+    z[s] = f->sos_z->data[s]; \
+  } \
+  for (j = 0; j < length; j++) { \
+    lsmp_t x = INPUT (data[j]); \
+    for (s = 0; s < N; s++) { \
+      const lsmp_t *k = c + 5 * s; \
+      y = k[0] * x + z[2 * s]; \
+      z[2 * s] = k[1] * x - k[3] * y + z[2 * s + 1]; \
+      z[2 * s + 1] = k[2] * x - k[4] * y; \
+      x = y; \
+    } \
+    data[j] = x; \
+  } \
+  for (s = 0; s < 2 * N; s++) { \
+    f->sos_z->data[s] = z[s]; \
+  } \
+}
+
+AUBIO_FILTER_SOS_KERNEL(1, sos1, KILL_DENORMAL)
+AUBIO_FILTER_SOS_KERNEL(2, sos2, KILL_DENORMAL)
+AUBIO_FILTER_SOS_KERNEL(3, sos3, KILL_DENORMAL)
+AUBIO_FILTER_SOS_KERNEL(1, sos1_ftz, )
+AUBIO_FILTER_SOS_KERNEL(2, sos2_ftz, )
+AUBIO_FILTER_SOS_KERNEL(3, sos3_ftz, )
+
+/* any number of sections, one section at a time over the whole block */
+static void
+aubio_filter_do_sos (aubio_filter_t * f, smpl_t * data, uint_t length,
+    uint_t flush)
+{
+  uint_t j, s;
+  for (s = 0; s < f->n_sections; s++) {
+    const lsmp_t *k = f->sos->data + 5 * s;
+    lsmp_t z0 = f->sos_z->data[2 * s], z1 = f->sos_z->data[2 * s + 1], x, y;
+    for (j = 0; j < length; j++) {
+      x = (s || flush) ? data[j] : KILL_DENORMAL (data[j]);
+      y = k[0] * x + z0;
+      z0 = k[1] * x - k[3] * y + z1;
+      z1 = k[2] * x - k[4] * y;
+      data[j] = y;
+    }
+    f->sos_z->data[2 * s] = z0;
+    f->sos_z->data[2 * s + 1] = z1;
+  }
+}
+
+/* the coefficients can be modified through aubio_filter_get_feedback() and
+   aubio_filter_get_feedforward() at any time, in which case the sections do
+   not describe the filter anymore */
+static uint_t
+aubio_filter_sos_changed (const aubio_filter_t * f)
+{
+  uint_t l;
+  for (l = 0; l < f->order; l++) {
+    if (f->a->data[l] != f->sos_a->data[l]
+        || f->b->data[l] != f->sos_b->data[l]) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
 void
 aubio_filter_do_outplace (aubio_filter_t * f, const fvec_t * in, fvec_t * out)
 {
@@ -45,33 +176,89 @@ aubio_filter_do_outplace (aubio_filter_t * f, const fvec_t * in, fvec_t * out)
   aubio_filter_do (f, out);
 }
 
-void
-aubio_filter_do (aubio_filter_t * f, fvec_t * in)
+/* filter a block, without the per-sample checks if flush is set */
+static void
+aubio_filter_do_block (aubio_filter_t * f, fvec_t * in, uint_t flush)
 {
   uint_t j, l, order = f->order;
-  lsmp_t *x = f->x->data;
-  lsmp_t *y = f->y->data;
+  lsmp_t *z = f->z->data;
   lsmp_t *a = f->a->data;
   lsmp_t *b = f->b->data;
+  lsmp_t x, y;
+
+  if (f->n_sections) {
+    if (!aubio_filter_sos_changed (f)) {
+      switch (f->n_sections) {
+        case 1:
+          (flush ? aubio_filter_do_sos1_ftz : aubio_filter_do_sos1) (f,
+              in->data, in->length);
+          break;
+        case 2:
+          (flush ? aubio_filter_do_sos2_ftz : aubio_filter_do_sos2) (f,
+              in->data, in->length);
+          break;
+        case 3:
+          (flush ? aubio_filter_do_sos3_ftz : aubio_filter_do_sos3) (f,
+              in->data, in->length);
+          break;
+        default:
+          aubio_filter_do_sos (f, in->data, in->length, flush);
+          break;
+      }
+      return;
+    }
+    /* back to the direct form, from a clean state */
+    f->n_sections = 0;
+    lvec_zeros (f->z);
+  }
+
+  switch (order) {
+    case 3:
+      (flush ? aubio_filter_do_order3_ftz : aubio_filter_do_order3) (f,
+          in->data, in->length);
+      return;
+    case 5:
+      (flush ? aubio_filter_do_order5_ftz : aubio_filter_do_order5) (f,
+          in->data, in->length);
+      return;
+    case 7:
+      (flush ? aubio_filter_do_order7_ftz : aubio_filter_do_order7) (f,
+          in->data, in->length);
+      return;
+    default:
+      break;
+  }
+
+  if (order == 1) {
+    for (j = 0; j < in->length; j++) {
+      in->data[j] = b[0] * (flush ? in->data[j] : KILL_DENORMAL (in->data[j]));
+    }
+    return;
+  }
 
   for (j = 0; j < in->length; j++) {
     /* new input */
-    x[0] = KILL_DENORMAL (in->data[j]);
-    y[0] = b[0] * x[0];
-    for (l = 1; l < order; l++) {
-      y[0] += b[l] * x[l];
-      y[0] -= a[l] * y[l];
+    x = flush ? in->data[j] : KILL_DENORMAL (in->data[j]);
+    y = b[0] * x + z[0];
+    /* update the state for the next sample */
+    for (l = 1; l < order - 1; l++) {
+      z[l - 1] = b[l] * x - a[l] * y + z[l];
     }
+    z[order - 2] = b[order - 1] * x - a[order - 1] * y;
     /* new output */
-    in->data[j] = y[0];
-    /* store for next sample */
-    for (l = order - 1; l > 0; l--) {
-      x[l] = x[l - 1];
-      y[l] = y[l - 1];
-    }
+    in->data[j] = y;
   }
 }
 
+void
+aubio_filter_do (aubio_filter_t * f, fvec_t * in)
+{
+  aubio_denormal_guard_t guard;
+  aubio_denormal_enter (&guard);
+  aubio_filter_do_block (f, in, guard.flush);
+  aubio_denormal_leave (&guard);
+}
+
 /* The rough way: reset memory of filter between each run to avoid end effects. */
 void
 aubio_filter_do_filtfilt (aubio_filter_t * f, fvec_t * in, fvec_t * tmp)
@@ -104,6 +291,57 @@ aubio_filter_get_feedforward (const aubio_filter_t * f)
   return f->b;
 }
 
+uint_t
+aubio_filter_set_sos (aubio_filter_t * f, const lvec_t * sos)
+{
+  uint_t s, l, n_sections;
+  lsmp_t *a, *b;
+  if (f == NULL || sos == NULL) {
+    AUBIO_ERR ("filter: failed setting sections, filter or sections NULL\n");
+    return AUBIO_FAIL;
+  }
+  n_sections = sos->length / 5;
+  if (n_sections == 0 || sos->length != 5 * n_sections
+      || f->order != 2 * n_sections + 1) {
+    AUBIO_ERR ("filter: %d coefficients can not set a filter of order %d,"
+        " expected 5 * (order - 1) / 2\n", sos->length, f->order);
+    return AUBIO_FAIL;
+  }
+  if (!f->sos) {
+    f->sos = new_lvec (sos->length);
+    f->sos_z = new_lvec (2 * n_sections);
+    f->sos_a = new_lvec (f->order);
+    f->sos_b = new_lvec (f->order);
+    if (!f->sos || !f->sos_z || !f->sos_a || !f->sos_b) {
+      AUBIO_ERR ("filter: failed allocating sections\n");
+      return AUBIO_FAIL;
+    }
+  }
+  AUBIO_MEMCPY (f->sos->data, sos->data, sos->length * sizeof(lsmp_t));
+  /* expand the product of the sections into the direct form */
+  a = f->a->data;
+  b = f->b->data;
+  lvec_zeros (f->a);
+  lvec_zeros (f->b);
+  a[0] = 1.;
+  b[0] = 1.;
+  for (s = 0; s < n_sections; s++) {
+    const lsmp_t *k = sos->data + 5 * s;
+    for (l = 2 * s + 2; l > 0; l--) {
+      b[l] = k[0] * b[l] + k[1] * b[l - 1] + (l > 1 ? k[2] * b[l - 2] : 0.);
+      a[l] = a[l] + k[3] * a[l - 1] + (l > 1 ? k[4] * a[l - 2] : 0.);
+    }
+    b[0] *= k[0];
+  }
+  AUBIO_MEMCPY (f->sos_a->data, a, f->order * sizeof(lsmp_t));
+  AUBIO_MEMCPY (f->sos_b->data, b, f->order * sizeof(lsmp_t));
+  if (!f->n_sections) {
+    lvec_zeros (f->sos_z);
+  }
+  f->n_sections = n_sections;
+  return AUBIO_OK;
+}
+
 uint_t
 aubio_filter_get_order (const aubio_filter_t * f)
 {
@@ -126,8 +364,8 @@ aubio_filter_set_samplerate (aubio_filter_t * f, uint_t samplerate)
 void
 aubio_filter_do_reset (aubio_filter_t * f)
 {
-  lvec_zeros (f->x);
-  lvec_zeros (f->y);
+  lvec_zeros (f->z);
+  if (f->sos_z) lvec_zeros (f->sos_z);
 }
 
 aubio_filter_t *
@@ -152,10 +390,8 @@ new_aubio_filter (uint_t order)
     return NULL;
   }
   /* allocate filter buffers and check each allocation */
-  f->x = new_lvec (order);
-  if (!f->x) goto beach;
-  f->y = new_lvec (order);
-  if (!f->y) goto beach;
+  f->z = new_lvec (order);
+  if (!f->z) goto beach;
   f->a = new_lvec (order);
   if (!f->a) goto beach;
   f->b = new_lvec (order);
@@ -172,8 +408,7 @@ beach:
   /* cleanup on allocation failure */
   if (f->a) del_lvec(f->a);
   if (f->b) del_lvec(f->b);
-  if (f->x) del_lvec(f->x);
-  if (f->y) del_lvec(f->y);
+  if (f->z) del_lvec(f->z);
   AUBIO_FREE(f);
   return NULL;
 }
@@ -183,8 +418,20 @@ del_aubio_filter (aubio_filter_t * f)
 {
   del_lvec (f->a);
   del_lvec (f->b);
-  del_lvec (f->x);
-  del_lvec (f->y);
+  del_lvec (f->z);
+  if (f->sos) del_lvec (f->sos);
+  if (f->sos_z) del_lvec (f->sos_z);
+  if (f->sos_a) del_lvec (f->sos_a);
+  if (f->sos_b) del_lvec (f->sos_b);
   AUBIO_FREE (f);
   return;
 }
+
+uint_t
+aubio_filter_get_memory_usage (const aubio_filter_t * f)
+{
+  return aubio_malloc_size (f) + aubio_malloc_size (f->a)
+    + aubio_malloc_size (f->b) + aubio_malloc_size (f->z)
+    + aubio_malloc_size (f->sos) + aubio_malloc_size (f->sos_z)
+    + aubio_malloc_size (f->sos_a) + aubio_malloc_size (f->sos_b);
+}
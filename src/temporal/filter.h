@@ -29,8 +29,7 @@
   It contains the following data:
     - \f$ n*1 b_i \f$ feedforward coefficients
     - \f$ n*1 a_i \f$ feedback coefficients
-    - \f$ n*c x_i \f$ input signal
-    - \f$ n*c y_i \f$ output signal
+    - \f$ (n-1)*1 z_i \f$ filter state
 
   For convenience, the samplerate of the input signal is also stored in the
   object.
@@ -47,7 +46,14 @@
   \f}
 
   The function aubio_filter_do() executes the same computation but modifies
-  directly the input signal (in-place).
+  directly the input signal (in-place). The filter is run in transposed
+  direct form II, with dedicated code for the orders 3, 5 and 7 used by the
+  biquad, C-weighting and A-weighting filters.
+
+  A filter of odd order can also be set as a cascade of second order sections
+  with aubio_filter_set_sos(). The sections are then run instead of the direct
+  form, which is more accurate for high orders and for poles close to the unit
+  circle. The A-weighting and C-weighting filters are set this way.
 
   The function aubio_filter_do_filtfilt() version runs the filter twice, first
   forward then backward, to compensate with the phase shifting of the forward
@@ -115,6 +121,22 @@ lvec_t *aubio_filter_get_feedback (const aubio_filter_t * f);
 */
 lvec_t *aubio_filter_get_feedforward (const aubio_filter_t * f);
 
+/** set the filter to a cascade of second order sections
+
+  \param f filter object, of order `2 * n + 1` for `n` sections
+  \param sos coefficients `b0, b1, b2, a1, a2` of each section, `a0` being 1,
+  so that `sos` holds `5 * n` values
+
+  \return 0 on success, non-zero otherwise
+
+  The feedforward and feedback coefficients of the filter are set to the
+  product of the sections, and aubio_filter_do() runs the sections in cascade.
+  Modifying the coefficients returned by aubio_filter_get_feedforward() or
+  aubio_filter_get_feedback() afterwards runs the filter in direct form again.
+
+*/
+uint_t aubio_filter_set_sos (aubio_filter_t * f, const lvec_t * sos);
+
 /** get order of the filter
 
   \param f filter to get order from
@@ -162,6 +184,16 @@ void aubio_filter_do_reset (aubio_filter_t * f);
 */
 aubio_filter_t *new_aubio_filter (uint_t order);
 
+/** get the memory used by a filter
+
+  \param f filter object as returned by new_aubio_filter()
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_filter_get_memory_usage (const aubio_filter_t * f);
+
 /** delete a filter object
 
   \param f filter object to delete
@@ -0,0 +1,331 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "temporal/filterbank_iir.h"
+#include "utils/denormal_priv.h"
+
+/* The bands are filtered by groups of FBIIR_GROUP, in transposed direct form
+ * II. Within a group, the state of each band is independent of the others,
+ * so the bands are computed side by side on vectors of FBIIR_W lanes, which
+ * also hides the latency of the recursion of each single band. Filters are
+ * computed with lsmp_t, so vectors are only used when lsmp_t is a double. */
+
+#if !HAVE_AUBIO_DOUBLE
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define FBIIR_VEC           v128_t
+#define FBIIR_W             2
+#define FBIIR_LOAD(p)       wasm_v128_load(p)
+#define FBIIR_STORE(p,v)    wasm_v128_store(p, v)
+#define FBIIR_SET1(x)       wasm_f64x2_splat(x)
+#define FBIIR_ADD(a,b)      wasm_f64x2_add(a, b)
+#define FBIIR_SUB(a,b)      wasm_f64x2_sub(a, b)
+#define FBIIR_MUL(a,b)      wasm_f64x2_mul(a, b)
+#define FBIIR_ABS(a)        wasm_f64x2_abs(a)
+#define FBIIR_SELECT_GT(a,b,t,e) wasm_v128_bitselect(t, e, wasm_f64x2_gt(a, b))
+#elif defined(__SSE2__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FBIIR_VEC           __m128d
+#define FBIIR_W             2
+#define FBIIR_LOAD(p)       _mm_loadu_pd(p)
+#define FBIIR_STORE(p,v)    _mm_storeu_pd(p, v)
+#define FBIIR_SET1(x)       _mm_set1_pd(x)
+#define FBIIR_ADD(a,b)      _mm_add_pd(a, b)
+#define FBIIR_SUB(a,b)      _mm_sub_pd(a, b)
+#define FBIIR_MUL(a,b)      _mm_mul_pd(a, b)
+#define FBIIR_ABS(a)        _mm_andnot_pd(_mm_set1_pd(-0.), a)
+#define FBIIR_SELECT_GT(a,b,t,e) _mm_or_pd( \
+    _mm_and_pd(_mm_cmpgt_pd(a, b), t), _mm_andnot_pd(_mm_cmpgt_pd(a, b), e))
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FBIIR_VEC           float64x2_t
+#define FBIIR_W             2
+#define FBIIR_LOAD(p)       vld1q_f64(p)
+#define FBIIR_STORE(p,v)    vst1q_f64(p, v)
+#define FBIIR_SET1(x)       vdupq_n_f64(x)
+#define FBIIR_ADD(a,b)      vaddq_f64(a, b)
+#define FBIIR_SUB(a,b)      vsubq_f64(a, b)
+#define FBIIR_MUL(a,b)      vmulq_f64(a, b)
+#define FBIIR_ABS(a)        vabsq_f64(a)
+#define FBIIR_SELECT_GT(a,b,t,e) vbslq_f64(vcgtq_f64(a, b), t, e)
+#endif
+#endif /* !HAVE_AUBIO_DOUBLE */
+
+#ifndef FBIIR_VEC
+#define FBIIR_VEC           lsmp_t
+#define FBIIR_W             1
+#define FBIIR_LOAD(p)       (*(p))
+#define FBIIR_STORE(p,v)    (*(p) = (v))
+#define FBIIR_SET1(x)       (x)
+#define FBIIR_ADD(a,b)      ((a) + (b))
+#define FBIIR_SUB(a,b)      ((a) - (b))
+#define FBIIR_MUL(a,b)      ((a) * (b))
+#define FBIIR_ABS(a)        ((a) < 0. ? -(a) : (a))
+#define FBIIR_SELECT_GT(a,b,t,e) ((a) > (b) ? (t) : (e))
+#endif
+
+/* number of bands computed together */
+#define FBIIR_GROUP 4
+/* number of vectors per group */
+#define FBIIR_NV (FBIIR_GROUP / FBIIR_W)
+
+/* indices of the arrays stored in f->data */
+enum {
+  FBIIR_B0, FBIIR_B1, FBIIR_B2, FBIIR_A1, FBIIR_A2, /* coefficients */
+  FBIIR_Z0, FBIIR_Z1,                             /* filter state */
+  FBIIR_ENV,                                      /* envelope state */
+  FBIIR_N_ARRAYS
+};
+
+struct _aubio_filterbank_iir_t
+{
+  uint_t n_bands;        /**< number of bands */
+  uint_t n_padded;       /**< number of bands, rounded up to FBIIR_GROUP */
+  uint_t samplerate;     /**< sampling rate of the input */
+  lsmp_t *data;          /**< FBIIR_N_ARRAYS arrays of n_padded elements */
+  lsmp_t attack;         /**< envelope coefficient for rising values */
+  lsmp_t release;        /**< envelope coefficient for falling values */
+};
+
+/* filter in through the bands of group g, writing the output of each band
+ * to out if do_out is set, and updating the envelopes if do_env is set; the
+ * input samples are only checked for denormals if flush is not set */
+static inline void
+aubio_filterbank_iir_do_group (aubio_filterbank_iir_t * f, uint_t g,
+    const fvec_t * in, fmat_t * out, uint_t do_out, uint_t do_env,
+    uint_t flush)
+{
+  uint_t j, l, v, k0 = g * FBIIR_GROUP;
+  lsmp_t *d = f->data + k0;
+  uint_t n = f->n_padded;
+  lsmp_t y_lanes[FBIIR_GROUP];
+  FBIIR_VEC b0[FBIIR_NV], b1[FBIIR_NV], b2[FBIIR_NV],
+            a1[FBIIR_NV], a2[FBIIR_NV], z0[FBIIR_NV], z1[FBIIR_NV],
+            env[FBIIR_NV];
+  FBIIR_VEC x, y, r;
+  FBIIR_VEC attack = FBIIR_SET1(f->attack);
+  FBIIR_VEC release = FBIIR_SET1(f->release);
+  uint_t n_lanes = MIN(FBIIR_GROUP, f->n_bands - k0);
+
+  for (v = 0; v < FBIIR_NV; v++) {
+    b0[v] = FBIIR_LOAD(d + FBIIR_B0 * n + v * FBIIR_W);
+    b1[v] = FBIIR_LOAD(d + FBIIR_B1 * n + v * FBIIR_W);
+    b2[v] = FBIIR_LOAD(d + FBIIR_B2 * n + v * FBIIR_W);
+    a1[v] = FBIIR_LOAD(d + FBIIR_A1 * n + v * FBIIR_W);
+    a2[v] = FBIIR_LOAD(d + FBIIR_A2 * n + v * FBIIR_W);
+    z0[v] = FBIIR_LOAD(d + FBIIR_Z0 * n + v * FBIIR_W);
+    z1[v] = FBIIR_LOAD(d + FBIIR_Z1 * n + v * FBIIR_W);
+    env[v] = FBIIR_LOAD(d + FBIIR_ENV * n + v * FBIIR_W);
+  }
+
+  for (j = 0; j < in->length; j++) {
+    x = FBIIR_SET1((lsmp_t)(flush ? in->data[j]
+          : KILL_DENORMAL (in->data[j])));
+    for (v = 0; v < FBIIR_NV; v++) {
+      y = FBIIR_ADD(FBIIR_MUL(b0[v], x), z0[v]);
+      z0[v] = FBIIR_ADD(FBIIR_SUB(FBIIR_MUL(b1[v], x), FBIIR_MUL(a1[v], y)),
+          z1[v]);
+      z1[v] = FBIIR_SUB(FBIIR_MUL(b2[v], x), FBIIR_MUL(a2[v], y));
+      if (do_env) {
+        /* env + coeff * (env - |y|), with the attack or release coeff */
+        r = FBIIR_ABS(y);
+        env[v] = FBIIR_ADD(r, FBIIR_MUL(FBIIR_SELECT_GT(r, env[v], attack,
+                release), FBIIR_SUB(env[v], r)));
+      }
+      if (do_out) {
+        FBIIR_STORE(y_lanes + v * FBIIR_W, y);
+      }
+    }
+    if (do_out) {
+      for (l = 0; l < n_lanes; l++) {
+        out->data[k0 + l][j] = y_lanes[l];
+      }
+    }
+  }
+
+  for (v = 0; v < FBIIR_NV; v++) {
+    FBIIR_STORE(d + FBIIR_Z0 * n + v * FBIIR_W, z0[v]);
+    FBIIR_STORE(d + FBIIR_Z1 * n + v * FBIIR_W, z1[v]);
+    FBIIR_STORE(d + FBIIR_ENV * n + v * FBIIR_W, env[v]);
+  }
+}
+
+void
+aubio_filterbank_iir_do (aubio_filterbank_iir_t * f, const fvec_t * in,
+    fmat_t * out)
+{
+  uint_t g;
+  aubio_denormal_guard_t guard;
+  if (out->height < f->n_bands || out->length < in->length) {
+    AUBIO_ERR ("filterbank_iir: expected an output of %dx%d, got %dx%d\n",
+        f->n_bands, in->length, out->height, out->length);
+    return;
+  }
+  aubio_denormal_enter (&guard);
+  for (g = 0; g < f->n_padded / FBIIR_GROUP; g++) {
+    aubio_filterbank_iir_do_group (f, g, in, out, 1, 0, guard.flush);
+  }
+  aubio_denormal_leave (&guard);
+}
+
+void
+aubio_filterbank_iir_do_envelope (aubio_filterbank_iir_t * f,
+    const fvec_t * in, fvec_t * env)
+{
+  uint_t g, k;
+  aubio_denormal_guard_t guard;
+  if (env->length < f->n_bands) {
+    AUBIO_ERR ("filterbank_iir: expected an output of length %d, got %d\n",
+        f->n_bands, env->length);
+    return;
+  }
+  aubio_denormal_enter (&guard);
+  for (g = 0; g < f->n_padded / FBIIR_GROUP; g++) {
+    aubio_filterbank_iir_do_group (f, g, in, NULL, 0, 1, guard.flush);
+  }
+  aubio_denormal_leave (&guard);
+  for (k = 0; k < f->n_bands; k++) {
+    env->data[k] = f->data[FBIIR_ENV * f->n_padded + k];
+  }
+}
+
+uint_t
+aubio_filterbank_iir_set_biquad (aubio_filterbank_iir_t * f, uint_t band,
+    lsmp_t b0, lsmp_t b1, lsmp_t b2, lsmp_t a1, lsmp_t a2)
+{
+  uint_t n = f->n_padded;
+  if (band >= f->n_bands) {
+    AUBIO_ERR ("filterbank_iir: band %d is out of range, should be < %d\n",
+        band, f->n_bands);
+    return AUBIO_FAIL;
+  }
+  f->data[FBIIR_B0 * n + band] = b0;
+  f->data[FBIIR_B1 * n + band] = b1;
+  f->data[FBIIR_B2 * n + band] = b2;
+  f->data[FBIIR_A1 * n + band] = a1;
+  f->data[FBIIR_A2 * n + band] = a2;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_filterbank_iir_set_bandpass (aubio_filterbank_iir_t * f, uint_t band,
+    smpl_t freq, smpl_t q)
+{
+  lsmp_t w0, alpha, a0;
+  if (freq <= 0. || freq >= f->samplerate / 2.) {
+    AUBIO_ERR ("filterbank_iir: frequency %.2f should be in ]0, %.2f[\n",
+        freq, f->samplerate / 2.);
+    return AUBIO_FAIL;
+  }
+  if (q <= 0.) {
+    AUBIO_ERR ("filterbank_iir: quality factor %.2f should be > 0\n", q);
+    return AUBIO_FAIL;
+  }
+  /* band-pass with 0 dB peak gain, from Robert Bristow-Johnson's cookbook */
+  w0 = TWO_PI * freq / f->samplerate;
+  alpha = SIN(w0) / (2. * q);
+  a0 = 1. + alpha;
+  return aubio_filterbank_iir_set_biquad (f, band, alpha / a0, 0.,
+      - alpha / a0, -2. * COS(w0) / a0, (1. - alpha) / a0);
+}
+
+uint_t
+aubio_filterbank_iir_set_envelope (aubio_filterbank_iir_t * f,
+    smpl_t attack, smpl_t release)
+{
+  if (attack < 0. || release < 0.) {
+    AUBIO_ERR ("filterbank_iir: envelope times should be >= 0, got attack"
+        " %.4f and release %.4f\n", attack, release);
+    return AUBIO_FAIL;
+  }
+  f->attack = attack > 0. ? EXP(-1. / (attack * f->samplerate)) : 0.;
+  f->release = release > 0. ? EXP(-1. / (release * f->samplerate)) : 0.;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_filterbank_iir_get_n_bands (const aubio_filterbank_iir_t * f)
+{
+  return f->n_bands;
+}
+
+uint_t
+aubio_filterbank_iir_get_samplerate (const aubio_filterbank_iir_t * f)
+{
+  return f->samplerate;
+}
+
+void
+aubio_filterbank_iir_reset (aubio_filterbank_iir_t * f)
+{
+  uint_t k;
+  for (k = FBIIR_Z0 * f->n_padded; k < FBIIR_N_ARRAYS * f->n_padded; k++) {
+    f->data[k] = 0.;
+  }
+}
+
+aubio_filterbank_iir_t *
+new_aubio_filterbank_iir (uint_t n_bands, uint_t samplerate)
+{
+  uint_t k;
+  aubio_filterbank_iir_t *f = AUBIO_NEW (aubio_filterbank_iir_t);
+
+  if ((sint_t)n_bands < 1) {
+    AUBIO_ERR ("filterbank_iir: got n_bands %d, but can not be < 1\n",
+        n_bands);
+    goto beach;
+  } else if ((sint_t)samplerate < 1) {
+    AUBIO_ERR ("filterbank_iir: samplerate (%d) can not be < 1\n",
+        samplerate);
+    goto beach;
+  }
+  f->n_bands = n_bands;
+  f->n_padded = (n_bands + FBIIR_GROUP - 1) / FBIIR_GROUP * FBIIR_GROUP;
+  f->samplerate = samplerate;
+  f->data = AUBIO_ARRAY (lsmp_t, FBIIR_N_ARRAYS * f->n_padded);
+  if (!f->data) goto beach;
+  /* identity filters; padding bands stay at 0 */
+  for (k = 0; k < n_bands; k++) {
+    f->data[FBIIR_B0 * f->n_padded + k] = 1.;
+  }
+  return f;
+
+beach:
+  AUBIO_FREE (f);
+  return NULL;
+}
+
+uint_t
+aubio_filterbank_iir_get_memory_usage (const aubio_filterbank_iir_t * f)
+{
+  return aubio_malloc_size (f) + aubio_malloc_size (f->data);
+}
+
+void
+del_aubio_filterbank_iir (aubio_filterbank_iir_t * f)
+{
+  if (f->data)
+    AUBIO_FREE (f->data);
+  AUBIO_FREE (f);
+}
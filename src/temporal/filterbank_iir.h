@@ -0,0 +1,182 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_FILTERBANK_IIR_H
+#define AUBIO_FILTERBANK_IIR_H
+
+/** \file
+
+  Bank of biquad filters
+
+  This object holds one biquad filter per band, all fed with the same input
+  signal. Each band computes:
+
+  \f$ y_k[n] = b_{0,k} x[n] + b_{1,k} x[n-1] + b_{2,k} x[n-2]
+             - a_{1,k} y_k[n-1] - a_{2,k} y_k[n-2] \f$
+
+  The bands are processed together, several at a time on SIMD units when
+  available, so that filtering the input into many bands costs a single pass
+  over it.
+
+  An envelope follower can be run on the output of each band, for instance
+  to drive a multi-band level meter, with aubio_filterbank_iir_do_envelope().
+
+  \example temporal/test-filterbank_iir.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** bank of biquad filters */
+typedef struct _aubio_filterbank_iir_t aubio_filterbank_iir_t;
+
+/** create a bank of biquad filters
+
+  \param n_bands number of bands
+  \param samplerate sampling rate of the input signal, in Hz
+
+  \return the newly created object, or NULL on failure
+
+  All the bands are initialised to identity filters.
+
+*/
+aubio_filterbank_iir_t *new_aubio_filterbank_iir (uint_t n_bands,
+    uint_t samplerate);
+
+/** filter an input vector into each band
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+  \param in input vector to filter
+  \param out output matrix of `n_bands` rows of length `in->length`
+
+*/
+void aubio_filterbank_iir_do (aubio_filterbank_iir_t * f, const fvec_t * in,
+    fmat_t * out);
+
+/** filter an input vector and update the envelope of each band
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+  \param in input vector to filter
+  \param env output vector of length `n_bands`, filled with the value of the
+  envelope of each band at the end of `in`
+
+  The envelope follows the absolute value of the output of each band, with
+  the attack and release times set by aubio_filterbank_iir_set_envelope().
+
+*/
+void aubio_filterbank_iir_do_envelope (aubio_filterbank_iir_t * f,
+    const fvec_t * in, fvec_t * env);
+
+/** set the coefficients of one band
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+  \param band index of the band, in `0 .. n_bands - 1`
+  \param b0 forward filter coefficient
+  \param b1 forward filter coefficient
+  \param b2 forward filter coefficient
+  \param a1 feedback filter coefficient
+  \param a2 feedback filter coefficient
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_filterbank_iir_set_biquad (aubio_filterbank_iir_t * f,
+    uint_t band, lsmp_t b0, lsmp_t b1, lsmp_t b2, lsmp_t a1, lsmp_t a2);
+
+/** set one band to a band-pass filter
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+  \param band index of the band, in `0 .. n_bands - 1`
+  \param freq center frequency of the band, in Hz
+  \param q quality factor of the band
+
+  \return 0 if successful, non-zero otherwise
+
+  The filter has a gain of 0 dB at its center frequency.
+
+*/
+uint_t aubio_filterbank_iir_set_bandpass (aubio_filterbank_iir_t * f,
+    uint_t band, smpl_t freq, smpl_t q);
+
+/** set the attack and release times of the envelope followers
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+  \param attack time constant for rising envelopes, in seconds
+  \param release time constant for falling envelopes, in seconds
+
+  \return 0 if successful, non-zero otherwise
+
+  A time of 0 makes the envelope follow the signal instantly. By default,
+  both times are set to 0.
+
+*/
+uint_t aubio_filterbank_iir_set_envelope (aubio_filterbank_iir_t * f,
+    smpl_t attack, smpl_t release);
+
+/** get the number of bands
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+
+  \return the number of bands of the filterbank
+
+*/
+uint_t aubio_filterbank_iir_get_n_bands (const aubio_filterbank_iir_t * f);
+
+/** get the memory used by a bank of biquad filters
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+
+  \return number of bytes allocated by the object, its coefficients and the
+  state of its filters, see utils/allocator.h
+
+*/
+uint_t aubio_filterbank_iir_get_memory_usage (
+    const aubio_filterbank_iir_t * f);
+
+/** get the sampling rate of the filterbank
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+
+  \return the sampling rate, in Hz
+
+*/
+uint_t aubio_filterbank_iir_get_samplerate (const aubio_filterbank_iir_t * f);
+
+/** reset the memory of the filters and of the envelope followers
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+
+*/
+void aubio_filterbank_iir_reset (aubio_filterbank_iir_t * f);
+
+/** delete a bank of biquad filters
+
+  \param f filterbank object as returned by new_aubio_filterbank_iir()
+
+*/
+void del_aubio_filterbank_iir (aubio_filterbank_iir_t * f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_FILTERBANK_IIR_H */
@@ -0,0 +1,394 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "temporal/halfband.h"
+#include "utils/simd_priv.h"
+
+/** most stages of a decimator or interpolator, for a factor of 8 */
+#define AUBIO_HALFBAND_MAX_STAGES 3
+
+/** non-zero coefficients on each side of the filter at the lowest rate */
+#define AUBIO_HALFBAND_SHARP 16
+/** non-zero coefficients on each side of the other filters */
+#define AUBIO_HALFBAND_COARSE 6
+/** Kaiser window parameter of the filters */
+#define AUBIO_HALFBAND_BETA 8.
+
+/** one half-band filter, and the past input it needs */
+typedef struct
+{
+  uint_t half;          /**< non-zero coefficients on each side */
+  smpl_t *coeffs;       /**< these coefficients, the outermost first */
+  smpl_t *hist;         /**< input, after 2 * half - 1 past samples */
+  smpl_t *center;       /**< decimators only, samples on the center
+                             coefficient, after half past samples */
+  smpl_t *out;          /**< output of the stage, before the next one */
+  uint_t size;          /**< input samples the buffers can hold */
+} aubio_halfband_stage_t;
+
+struct _aubio_decimator_t
+{
+  uint_t factor;
+  uint_t n_stages;
+  aubio_halfband_stage_t stages[AUBIO_HALFBAND_MAX_STAGES];
+};
+
+struct _aubio_interpolator_t
+{
+  uint_t factor;
+  uint_t n_stages;
+  aubio_halfband_stage_t stages[AUBIO_HALFBAND_MAX_STAGES];
+};
+
+/* zeroth order modified Bessel function of the first kind */
+static lsmp_t
+aubio_halfband_bessel_i0 (lsmp_t x)
+{
+  lsmp_t sum = 1., term = 1., y = x * x / 4.;
+  uint_t k;
+  for (k = 1; k < 64 && term > sum * 1.e-16; k++) {
+    term *= y / ((lsmp_t)k * k);
+    sum += term;
+  }
+  return sum;
+}
+
+static uint_t
+aubio_halfband_get_stages (uint_t factor)
+{
+  switch (factor) {
+    case 2: return 1;
+    case 4: return 2;
+    case 8: return 3;
+    default: return 0;
+  }
+}
+
+/* design a Kaiser-windowed half-band filter, scaled by gain; the center
+   coefficient is gain / 2 */
+static uint_t
+aubio_halfband_stage_init (aubio_halfband_stage_t * st, uint_t half,
+    lsmp_t gain)
+{
+  lsmp_t sum = 0., i0 = aubio_halfband_bessel_i0 (AUBIO_HALFBAND_BETA);
+  uint_t k;
+  st->half = half;
+  st->coeffs = AUBIO_ARRAY (smpl_t, half);
+  if (!st->coeffs) return AUBIO_FAIL;
+  for (k = 1; k <= half; k++) {
+    lsmp_t n = 2. * k - 1., r = n / (2. * half);
+    lsmp_t c = ((k % 2) ? 1. : -1.) / (PI * n);
+    c *= aubio_halfband_bessel_i0 (AUBIO_HALFBAND_BETA * SQRT(1. - r * r))
+      / i0;
+    st->coeffs[half - k] = c;
+    sum += 2. * c;
+  }
+  // unit gain at DC, the center coefficient bringing the other half
+  for (k = 0; k < half; k++) {
+    st->coeffs[k] *= .5 * gain / sum;
+  }
+  return AUBIO_OK;
+}
+
+static void
+aubio_halfband_stage_free (aubio_halfband_stage_t * st)
+{
+  if (st->coeffs) AUBIO_FREE (st->coeffs);
+  if (st->hist) AUBIO_FREE (st->hist);
+  if (st->center) AUBIO_FREE (st->center);
+  if (st->out) AUBIO_FREE (st->out);
+}
+
+static uint_t
+aubio_halfband_stage_get_memory_usage (const aubio_halfband_stage_t * st)
+{
+  return aubio_malloc_size (st->coeffs) + aubio_malloc_size (st->hist)
+    + aubio_malloc_size (st->center) + aubio_malloc_size (st->out);
+}
+
+static void
+aubio_halfband_stage_reset (aubio_halfband_stage_t * st)
+{
+  if (st->hist) AUBIO_MEMSET (st->hist, 0, (2 * st->half - 1) * sizeof(smpl_t));
+  if (st->center) AUBIO_MEMSET (st->center, 0, st->half * sizeof(smpl_t));
+}
+
+/* make room for n samples of filter input and out_size of output */
+static uint_t
+aubio_halfband_stage_grow (aubio_halfband_stage_t * st, uint_t n,
+    uint_t out_size, uint_t decimate)
+{
+  uint_t past = 2 * st->half - 1;
+  smpl_t *hist, *center = NULL, *out;
+  if (n <= st->size) return AUBIO_OK;
+  hist = AUBIO_ARRAY (smpl_t, past + n);
+  out = AUBIO_ARRAY (smpl_t, out_size);
+  if (decimate) center = AUBIO_ARRAY (smpl_t, st->half + n);
+  if (!hist || !out || (decimate && !center)) {
+    if (hist) AUBIO_FREE (hist);
+    if (out) AUBIO_FREE (out);
+    if (center) AUBIO_FREE (center);
+    return AUBIO_FAIL;
+  }
+  if (st->hist) {
+    AUBIO_MEMCPY (hist, st->hist, past * sizeof(smpl_t));
+    AUBIO_FREE (st->hist);
+  }
+  if (st->center) {
+    AUBIO_MEMCPY (center, st->center, st->half * sizeof(smpl_t));
+    AUBIO_FREE (st->center);
+  }
+  if (st->out) AUBIO_FREE (st->out);
+  st->hist = hist;
+  st->center = center;
+  st->out = out;
+  st->size = n;
+  return AUBIO_OK;
+}
+
+/* y[m] is centered on x[2 * m - (2 * half - 1)], for m < n */
+static void
+aubio_halfband_stage_decimate (aubio_halfband_stage_t * st, const smpl_t * x,
+    smpl_t * y, uint_t n)
+{
+  uint_t m, past = 2 * st->half - 1;
+  // the even samples meet the symmetric coefficients, the odd ones the center
+  for (m = 0; m < n; m++) {
+    st->hist[past + m] = x[2 * m];
+    st->center[st->half + m] = x[2 * m + 1];
+  }
+  AUBIO_SIMD()->sym_fir (st->hist, st->coeffs, st->half, y, n);
+  for (m = 0; m < n; m++) {
+    y[m] += .5 * st->center[m];
+  }
+  memmove (st->hist, st->hist + n, past * sizeof(smpl_t));
+  memmove (st->center, st->center + n, st->half * sizeof(smpl_t));
+}
+
+/* y[2 * m + 1] is x[m - half + 1], y[2 * m] lies halfway before it */
+static void
+aubio_halfband_stage_interpolate (aubio_halfband_stage_t * st,
+    const smpl_t * x, smpl_t * y, uint_t n)
+{
+  uint_t m, past = 2 * st->half - 1;
+  AUBIO_MEMCPY (st->hist + past, x, n * sizeof(smpl_t));
+  // the even outputs, written to the odd ones before spreading them
+  AUBIO_SIMD()->sym_fir (st->hist, st->coeffs, st->half, y + n, n);
+  for (m = 0; m < n; m++) {
+    y[2 * m] = y[n + m];
+    y[2 * m + 1] = st->hist[m + st->half];
+  }
+  memmove (st->hist, st->hist + n, past * sizeof(smpl_t));
+}
+
+aubio_decimator_t *
+new_aubio_decimator (uint_t factor)
+{
+  aubio_decimator_t *o = AUBIO_NEW (aubio_decimator_t);
+  uint_t s;
+  if (!o) return NULL;
+  o->n_stages = aubio_halfband_get_stages (factor);
+  if (!o->n_stages) {
+    AUBIO_ERR ("decimator: factor should be 2, 4 or 8, got %d\n", factor);
+    goto beach;
+  }
+  o->factor = factor;
+  // the last stage, at the lowest rate, has the sharpest filter
+  for (s = 0; s < o->n_stages; s++) {
+    uint_t half = (s + 1 == o->n_stages) ? AUBIO_HALFBAND_SHARP
+      : AUBIO_HALFBAND_COARSE;
+    if (aubio_halfband_stage_init (&o->stages[s], half, 1.)) goto beach;
+  }
+  return o;
+beach:
+  del_aubio_decimator (o);
+  return NULL;
+}
+
+void
+aubio_decimator_do (aubio_decimator_t * o, const fvec_t * input,
+    fvec_t * output)
+{
+  uint_t s, n = input->length;
+  const smpl_t *x = input->data;
+  if (n % o->factor != 0 || output->length != n / o->factor) {
+    AUBIO_ERR ("decimator: expected an input of a length multiple of %d and"
+        " an output %d times shorter, got %d and %d\n", o->factor, o->factor,
+        n, output->length);
+    return;
+  }
+  for (s = 0; s < o->n_stages; s++) {
+    aubio_halfband_stage_t *st = &o->stages[s];
+    smpl_t *y;
+    n /= 2;
+    if (aubio_halfband_stage_grow (st, n, n, 1)) return;
+    // the last stage writes to output directly
+    y = (s + 1 == o->n_stages) ? output->data : st->out;
+    aubio_halfband_stage_decimate (st, x, y, n);
+    x = y;
+  }
+}
+
+uint_t
+aubio_decimator_set_max_length (aubio_decimator_t * o, uint_t length)
+{
+  uint_t s, n = length;
+  if (length % o->factor != 0) {
+    AUBIO_ERR ("decimator: expected a length multiple of %d, got %d\n",
+        o->factor, length);
+    return AUBIO_FAIL;
+  }
+  for (s = 0; s < o->n_stages; s++) {
+    n /= 2;
+    if (aubio_halfband_stage_grow (&o->stages[s], n, n, 1)) return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_decimator_get_delay (const aubio_decimator_t * o)
+{
+  uint_t s, delay = 0;
+  for (s = 0; s < o->n_stages; s++) {
+    delay += (2 * o->stages[s].half - 1) << s;
+  }
+  return delay;
+}
+
+uint_t
+aubio_decimator_get_memory_usage (const aubio_decimator_t * o)
+{
+  uint_t s, n = aubio_malloc_size (o);
+  for (s = 0; s < o->n_stages; s++) {
+    n += aubio_halfband_stage_get_memory_usage (&o->stages[s]);
+  }
+  return n;
+}
+
+void
+aubio_decimator_reset (aubio_decimator_t * o)
+{
+  uint_t s;
+  for (s = 0; s < o->n_stages; s++) {
+    aubio_halfband_stage_reset (&o->stages[s]);
+  }
+}
+
+void
+del_aubio_decimator (aubio_decimator_t * o)
+{
+  uint_t s;
+  for (s = 0; s < AUBIO_HALFBAND_MAX_STAGES; s++) {
+    aubio_halfband_stage_free (&o->stages[s]);
+  }
+  AUBIO_FREE (o);
+}
+
+aubio_interpolator_t *
+new_aubio_interpolator (uint_t factor)
+{
+  aubio_interpolator_t *o = AUBIO_NEW (aubio_interpolator_t);
+  uint_t s;
+  if (!o) return NULL;
+  o->n_stages = aubio_halfband_get_stages (factor);
+  if (!o->n_stages) {
+    AUBIO_ERR ("interpolator: factor should be 2, 4 or 8, got %d\n", factor);
+    goto beach;
+  }
+  o->factor = factor;
+  // the first stage, at the lowest rate, has the sharpest filter; each stage
+  // has a gain of 2, to make up for the samples it inserts
+  for (s = 0; s < o->n_stages; s++) {
+    uint_t half = (s == 0) ? AUBIO_HALFBAND_SHARP : AUBIO_HALFBAND_COARSE;
+    if (aubio_halfband_stage_init (&o->stages[s], half, 2.)) goto beach;
+  }
+  return o;
+beach:
+  del_aubio_interpolator (o);
+  return NULL;
+}
+
+void
+aubio_interpolator_do (aubio_interpolator_t * o, const fvec_t * input,
+    fvec_t * output)
+{
+  uint_t s, n = input->length;
+  const smpl_t *x = input->data;
+  if (output->length != n * o->factor) {
+    AUBIO_ERR ("interpolator: expected an output %d times longer than the"
+        " input, got %d and %d\n", o->factor, n, output->length);
+    return;
+  }
+  for (s = 0; s < o->n_stages; s++) {
+    aubio_halfband_stage_t *st = &o->stages[s];
+    smpl_t *y;
+    if (aubio_halfband_stage_grow (st, n, 2 * n, 0)) return;
+    // the last stage writes to output directly
+    y = (s + 1 == o->n_stages) ? output->data : st->out;
+    aubio_halfband_stage_interpolate (st, x, y, n);
+    x = y;
+    n *= 2;
+  }
+}
+
+uint_t
+aubio_interpolator_set_max_length (aubio_interpolator_t * o, uint_t length)
+{
+  uint_t s, n = length;
+  for (s = 0; s < o->n_stages; s++) {
+    if (aubio_halfband_stage_grow (&o->stages[s], n, 2 * n, 0)) {
+      return AUBIO_FAIL;
+    }
+    n *= 2;
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_interpolator_get_delay (const aubio_interpolator_t * o)
+{
+  uint_t s, delay = 0;
+  // the delay of each stage, in samples of its output
+  for (s = 0; s < o->n_stages; s++) {
+    delay += (2 * o->stages[s].half - 1) << (o->n_stages - 1 - s);
+  }
+  return delay;
+}
+
+void
+aubio_interpolator_reset (aubio_interpolator_t * o)
+{
+  uint_t s;
+  for (s = 0; s < o->n_stages; s++) {
+    aubio_halfband_stage_reset (&o->stages[s]);
+  }
+}
+
+void
+del_aubio_interpolator (aubio_interpolator_t * o)
+{
+  uint_t s;
+  for (s = 0; s < AUBIO_HALFBAND_MAX_STAGES; s++) {
+    aubio_halfband_stage_free (&o->stages[s]);
+  }
+  AUBIO_FREE (o);
+}
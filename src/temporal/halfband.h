@@ -0,0 +1,187 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_HALFBAND_H
+#define AUBIO_HALFBAND_H
+
+/** \file
+
+  Half-band decimators and interpolators
+
+  These objects change the samplerate of a signal by a factor of 2, 4 or 8,
+  with one stage of half-band FIR filter for each factor of 2. Every other
+  coefficient of a half-band filter is zero, and the others are symmetric, so
+  that each output sample costs about a quarter of the multiplications of a
+  plain FIR filter of the same length.
+
+  The last stage of a decimator, and the first stage of an interpolator, run
+  at the lowest samplerate and use a filter of 63 coefficients, flat up to
+  0.42 times the Nyquist frequency of that samplerate, and attenuating by about
+  80 dB above it. The other stages use shorter filters, which only need to cut
+  the frequencies folded onto that band.
+
+  Decimating the input of an analysis can reduce its cost, for instance to
+  run aubio_tempo_t at 12 kHz on a 48 kHz signal, when the higher frequencies
+  are not needed.
+
+  The state of the filters is kept across calls, so that a stream can be
+  processed in consecutive blocks.
+
+  \example temporal/test-halfband.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** half-band decimator */
+typedef struct _aubio_decimator_t aubio_decimator_t;
+
+/** create a half-band decimator
+
+  \param factor decimation factor, 2, 4 or 8
+
+  \return the newly created object, or NULL on failure
+
+*/
+aubio_decimator_t *new_aubio_decimator (uint_t factor);
+
+/** decimate an input vector
+
+  \param o decimator object as returned by new_aubio_decimator()
+  \param input input vector, of a length multiple of the factor
+  \param output output vector, of length `input->length / factor`
+
+*/
+void aubio_decimator_do (aubio_decimator_t * o, const fvec_t * input,
+    fvec_t * output);
+
+/** get the delay of the decimator
+
+  \param o decimator object as returned by new_aubio_decimator()
+
+  \return the group delay of the filters, in samples of the input
+
+*/
+uint_t aubio_decimator_get_delay (const aubio_decimator_t * o);
+
+/** get the memory used by a decimator
+
+  \param o decimator object as returned by new_aubio_decimator()
+
+  \return number of bytes allocated by the object and its filter stages,
+  see utils/allocator.h
+
+*/
+uint_t aubio_decimator_get_memory_usage (const aubio_decimator_t * o);
+
+/** allocate the buffers of the decimator for inputs of up to `length` samples
+
+  \param o decimator object as returned by new_aubio_decimator()
+  \param length longest input that will be passed to aubio_decimator_do()
+
+  \return 0 if successful, non-zero otherwise
+
+  Otherwise, the buffers are allocated by the first call to
+  aubio_decimator_do() with a longer input, which should not happen in a
+  real-time thread.
+
+*/
+uint_t aubio_decimator_set_max_length (aubio_decimator_t * o, uint_t length);
+
+/** clear the past input of the decimator
+
+  \param o decimator object as returned by new_aubio_decimator()
+
+*/
+void aubio_decimator_reset (aubio_decimator_t * o);
+
+/** delete a decimator
+
+  \param o decimator object as returned by new_aubio_decimator()
+
+*/
+void del_aubio_decimator (aubio_decimator_t * o);
+
+/** half-band interpolator */
+typedef struct _aubio_interpolator_t aubio_interpolator_t;
+
+/** create a half-band interpolator
+
+  \param factor interpolation factor, 2, 4 or 8
+
+  \return the newly created object, or NULL on failure
+
+*/
+aubio_interpolator_t *new_aubio_interpolator (uint_t factor);
+
+/** interpolate an input vector
+
+  \param o interpolator object as returned by new_aubio_interpolator()
+  \param input input vector
+  \param output output vector, of length `input->length * factor`
+
+*/
+void aubio_interpolator_do (aubio_interpolator_t * o, const fvec_t * input,
+    fvec_t * output);
+
+/** get the delay of the interpolator
+
+  \param o interpolator object as returned by new_aubio_interpolator()
+
+  \return the group delay of the filters, in samples of the output
+
+*/
+uint_t aubio_interpolator_get_delay (const aubio_interpolator_t * o);
+
+/** allocate the buffers of the interpolator for inputs of up to `length` samples
+
+  \param o interpolator object as returned by new_aubio_interpolator()
+  \param length longest input that will be passed to aubio_interpolator_do()
+
+  \return 0 if successful, non-zero otherwise
+
+  Otherwise, the buffers are allocated by the first call to
+  aubio_interpolator_do() with a longer input, which should not happen in a
+  real-time thread.
+
+*/
+uint_t aubio_interpolator_set_max_length (aubio_interpolator_t * o, uint_t length);
+
+/** clear the past input of the interpolator
+
+  \param o interpolator object as returned by new_aubio_interpolator()
+
+*/
+void aubio_interpolator_reset (aubio_interpolator_t * o);
+
+/** delete an interpolator
+
+  \param o interpolator object as returned by new_aubio_interpolator()
+
+*/
+void del_aubio_interpolator (aubio_interpolator_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_HALFBAND_H */
@@ -0,0 +1,97 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "types.h"
+#include "fvec.h"
+#include "lvec.h"
+#include "temporal/filter.h"
+#include "temporal/k_weighting.h"
+
+/* analog prototype of the high shelf: frequency in Hz, gain in dB, quality
+   factor, and exponent of its gain at the band edge */
+#define SHELF_F 1681.974450955533
+#define SHELF_G 3.999843853973347
+#define SHELF_Q 0.7071752369554196
+#define SHELF_VB 0.4996667741545416
+/* analog prototype of the RLB highpass: frequency in Hz, quality factor */
+#define RLB_F 38.13547087602444
+#define RLB_Q 0.5003270373238773
+
+/* both sections are designed with the bilinear transform, with the
+   frequency prewarped by tan (pi f / fs) */
+uint_t
+aubio_filter_set_k_weighting (aubio_filter_t * f, uint_t samplerate)
+{
+  uint_t order;
+  lsmp_t c[10], k, vh, vb, a0;
+  lvec_t sos;
+
+  if ((sint_t)samplerate <= 0) {
+    AUBIO_ERROR("aubio_filter: failed setting K-weighting with samplerate %d\n", samplerate);
+    return AUBIO_FAIL;
+  }
+  if (f == NULL) {
+    AUBIO_ERROR("aubio_filter: failed setting K-weighting with filter NULL\n");
+    return AUBIO_FAIL;
+  }
+
+  order = aubio_filter_get_order (f);
+  if ( order != 5 ) {
+    AUBIO_ERROR ("aubio_filter: order of K-weighting filter must be 5, not %d\n", order);
+    return AUBIO_FAIL;
+  }
+
+  /* high shelf */
+  k = tan (PI * SHELF_F / samplerate);
+  vh = pow (10., SHELF_G / 20.);
+  vb = pow (vh, SHELF_VB);
+  a0 = 1. + k / SHELF_Q + k * k;
+  c[0] = (vh + vb * k / SHELF_Q + k * k) / a0;
+  c[1] = 2. * (k * k - vh) / a0;
+  c[2] = (vh - vb * k / SHELF_Q + k * k) / a0;
+  c[3] = 2. * (k * k - 1.) / a0;
+  c[4] = (1. - k / SHELF_Q + k * k) / a0;
+
+  /* highpass, with its two zeros at z = 1 and a unit gain at fs / 2 */
+  k = tan (PI * RLB_F / samplerate);
+  a0 = 1. + k / RLB_Q + k * k;
+  c[5] = 1.; c[6] = -2.; c[7] = 1.;
+  c[8] = 2. * (k * k - 1.) / a0;
+  c[9] = (1. - k / RLB_Q + k * k) / a0;
+
+  sos.length = 10;
+  sos.data = c;
+  if (aubio_filter_set_sos (f, &sos) != AUBIO_OK) {
+    return AUBIO_FAIL;
+  }
+  aubio_filter_set_samplerate (f, samplerate);
+  return AUBIO_OK;
+}
+
+aubio_filter_t * new_aubio_filter_k_weighting (uint_t samplerate) {
+  aubio_filter_t * f = new_aubio_filter(5);
+  if (!f) return NULL;
+  if (aubio_filter_set_k_weighting(f,samplerate) != AUBIO_OK) {
+    del_aubio_filter(f);
+    return NULL;
+  }
+  return f;
+}
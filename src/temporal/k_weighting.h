@@ -0,0 +1,77 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_FILTER_K_WEIGHTING_H
+#define AUBIO_FILTER_K_WEIGHTING_H
+
+/** \file
+
+  K-weighting filter coefficients
+
+  This file creates the K-weighting filter of loudness measurements, the
+  cascade of a high shelf raising frequencies above 2kHz by about 4dB, which
+  models the acoustic effect of the head, and of a highpass filter below
+  about 60Hz, the revised low-frequency B-weighting curve (RLB).
+
+  The implementation is based on the following standard:
+
+    - ITU-R BS.1770-4: Algorithms to measure audio programme loudness and
+  true-peak audio level, ITU, Geneva, Oct. 2015.
+
+  The standard gives the coefficients at 48kHz only. For other sampling
+  frequencies, the two sections are designed from the frequency, quality
+  factor and gain of the analog prototypes that match the coefficients of the
+  standard, so that the 48kHz filter is reproduced to within rounding errors.
+
+  See also ::aubio_loudness_t, which measures the loudness of a signal with
+  this filter.
+
+  \example temporal/test-k_weighting.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** create new K-weighting filter
+
+  \param samplerate sampling frequency of the signal to filter, in Hz
+
+  \return a new filter object, or NULL if the sampling frequency is invalid
+
+*/
+aubio_filter_t *new_aubio_filter_k_weighting (uint_t samplerate);
+
+/** set the sections of a K-weighting filter
+
+  \param f filter object of order 5, as created with new_aubio_filter()
+  \param samplerate sampling frequency of the signal to filter, in Hz
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_filter_set_k_weighting (aubio_filter_t * f, uint_t samplerate);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_FILTER_K_WEIGHTING_H */
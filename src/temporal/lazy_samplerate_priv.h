@@ -0,0 +1,59 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Functions of libsamplerate used by temporal/resampler.c, loaded on first
+   use with -Dlazy_backends=true, see utils/lazyload_priv.h.
+
+   To be included after <samplerate.h>. */
+
+#ifndef AUBIO_LAZY_SAMPLERATE_PRIV_H
+#define AUBIO_LAZY_SAMPLERATE_PRIV_H
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#define AUBIO_SAMPLERATE_SYMBOLS(X) \
+  X(src_new) X(src_delete) X(src_process) X(src_reset) X(src_strerror)
+
+static const char_t *aubio_samplerate_files[] = {
+  AUBIO_LAZY_LIB("samplerate", "0"),
+#ifdef _WIN32
+  "samplerate.dll",
+#endif
+  NULL
+};
+
+AUBIO_LAZY_DEFINE(aubio_samplerate, AUBIO_SAMPLERATE_SYMBOLS,
+    "libsamplerate", aubio_samplerate_files)
+
+#define src_new aubio_samplerate.src_new
+#define src_delete aubio_samplerate.src_delete
+#define src_process aubio_samplerate.src_process
+#define src_reset aubio_samplerate.src_reset
+#define src_strerror aubio_samplerate.src_strerror
+
+#else /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#define aubio_samplerate_load() AUBIO_OK
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
+
+#endif /* AUBIO_LAZY_SAMPLERATE_PRIV_H */
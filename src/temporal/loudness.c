@@ -0,0 +1,345 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "lvec.h"
+#include "temporal/filter.h"
+#include "temporal/k_weighting.h"
+#include "temporal/loudness.h"
+#include "utils/simd_priv.h"
+
+/* number of steps of 100ms in the momentary and short-term windows */
+#define LOUDNESS_MOMENTARY_STEPS 4
+#define LOUDNESS_SHORT_TERM_STEPS 30
+/* gates, in LUFS and LU, and histogram of the blocks above the absolute
+   gate, from -70 LUFS to +30 LUFS */
+#define LOUDNESS_ABS_GATE -70.
+#define LOUDNESS_REL_GATE -10.
+#define LOUDNESS_BINS_PER_LU 10
+#define LOUDNESS_BINS 1000
+
+struct _aubio_loudness_t
+{
+  uint_t hop_size;       /**< number of frames per call */
+  uint_t samplerate;     /**< sampling rate of the input */
+  uint_t channels;       /**< number of channels */
+  aubio_filter_t **filters; /**< one K-weighting filter per channel */
+  fmat_t *weighted;      /**< filtered channels, channels * hop_size */
+
+  uint_t step_size;      /**< number of frames in a step of 100ms */
+  uint_t step_pos;       /**< number of frames already in this step */
+  lsmp_t step_sum;       /**< sum of squares of all channels, in this step */
+  lsmp_t steps[LOUDNESS_SHORT_TERM_STEPS]; /**< mean squares of last steps */
+  uint_t ring_pos;       /**< index of the next step in steps */
+  uint_t n_steps;        /**< number of steps since the last reset */
+  lsmp_t short_term_sum; /**< sum of steps */
+
+  uint_t counts[LOUDNESS_BINS]; /**< number of gated blocks in each bin */
+  lsmp_t energies[LOUDNESS_BINS]; /**< sum of the mean squares of each bin */
+  uint_t gated_count;    /**< number of blocks above the absolute gate */
+  lsmp_t gated_sum;      /**< sum of their mean squares */
+
+  smpl_t momentary;      /**< last momentary loudness */
+  smpl_t short_term;     /**< last short-term loudness */
+  smpl_t integrated;     /**< integrated loudness, if integrated_ok */
+  uint_t integrated_ok;  /**< set if integrated is up to date */
+};
+
+static uint_t aubio_loudness_alloc_channels (aubio_loudness_t * o,
+    uint_t channels);
+static void aubio_loudness_free_channels (aubio_loudness_t * o);
+
+/* loudness of a mean square, with the offset of BS.1770 */
+static smpl_t
+aubio_loudness_lufs (lsmp_t z)
+{
+  if (z <= 0.) return -INFINITY;
+  return (smpl_t)(-0.691 + 10. * log10 (z));
+}
+
+aubio_loudness_t *
+new_aubio_loudness (uint_t hop_size, uint_t samplerate)
+{
+  aubio_loudness_t *o = AUBIO_NEW (aubio_loudness_t);
+  if (!o) return NULL;
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR ("loudness: hop_size should be >= 1, got %d\n", hop_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 10) {
+    AUBIO_ERR ("loudness: samplerate should be >= 10, got %d\n", samplerate);
+    goto beach;
+  }
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+  o->step_size = (uint_t)ROUND (samplerate / 10.);
+  if (aubio_loudness_alloc_channels (o, 1) != AUBIO_OK) goto beach;
+  aubio_loudness_reset (o);
+  return o;
+
+beach:
+  del_aubio_loudness (o);
+  return NULL;
+}
+
+static uint_t
+aubio_loudness_alloc_channels (aubio_loudness_t * o, uint_t channels)
+{
+  uint_t i;
+  o->filters = AUBIO_ARRAY (aubio_filter_t *, channels);
+  o->weighted = new_fmat (channels, o->hop_size);
+  if (!o->filters || !o->weighted) goto failure;
+  o->channels = channels;
+  for (i = 0; i < channels; i++) {
+    o->filters[i] = new_aubio_filter_k_weighting (o->samplerate);
+    if (!o->filters[i]) goto failure;
+  }
+  return AUBIO_OK;
+
+failure:
+  aubio_loudness_free_channels (o);
+  return AUBIO_FAIL;
+}
+
+static void
+aubio_loudness_free_channels (aubio_loudness_t * o)
+{
+  uint_t i;
+  if (o->filters) {
+    for (i = 0; i < o->channels; i++) {
+      if (o->filters[i]) del_aubio_filter (o->filters[i]);
+    }
+    AUBIO_FREE (o->filters);
+    o->filters = NULL;
+  }
+  if (o->weighted) {
+    del_fmat (o->weighted);
+    o->weighted = NULL;
+  }
+  o->channels = 0;
+}
+
+uint_t
+aubio_loudness_set_channels (aubio_loudness_t * o, uint_t channels)
+{
+  if ((sint_t)channels < 1) {
+    AUBIO_ERR ("loudness: channels should be >= 1, got %d\n", channels);
+    return AUBIO_FAIL;
+  }
+  if (channels != o->channels) {
+    aubio_loudness_free_channels (o);
+    if (aubio_loudness_alloc_channels (o, channels) != AUBIO_OK) {
+      AUBIO_ERR ("loudness: failed allocating %d channels\n", channels);
+      // fall back to a mono meter
+      aubio_loudness_alloc_channels (o, 1);
+      aubio_loudness_reset (o);
+      return AUBIO_FAIL;
+    }
+  }
+  aubio_loudness_reset (o);
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_loudness_get_channels (const aubio_loudness_t * o)
+{
+  return o->channels;
+}
+
+void
+aubio_loudness_reset (aubio_loudness_t * o)
+{
+  uint_t i;
+  for (i = 0; i < o->channels; i++) {
+    aubio_filter_do_reset (o->filters[i]);
+  }
+  o->step_pos = 0;
+  o->step_sum = 0.;
+  for (i = 0; i < LOUDNESS_SHORT_TERM_STEPS; i++) {
+    o->steps[i] = 0.;
+  }
+  o->ring_pos = 0;
+  o->n_steps = 0;
+  o->short_term_sum = 0.;
+  for (i = 0; i < LOUDNESS_BINS; i++) {
+    o->counts[i] = 0;
+    o->energies[i] = 0.;
+  }
+  o->gated_count = 0;
+  o->gated_sum = 0.;
+  o->momentary = -INFINITY;
+  o->short_term = -INFINITY;
+  o->integrated = -INFINITY;
+  o->integrated_ok = 1;
+}
+
+/* close a step of 100ms, and count the block of 400ms ending with it */
+static void
+aubio_loudness_push_step (aubio_loudness_t * o)
+{
+  uint_t i, pos = o->ring_pos;
+  lsmp_t z = o->step_sum / o->step_size, block = 0.;
+  o->step_sum = 0.;
+
+  o->short_term_sum += z - o->steps[pos];
+  o->steps[pos] = z;
+  o->ring_pos = (pos + 1) % LOUDNESS_SHORT_TERM_STEPS;
+  if (o->ring_pos == 0) {
+    // sum the ring again every 3s, so that rounding errors do not add up
+    o->short_term_sum = 0.;
+    for (i = 0; i < LOUDNESS_SHORT_TERM_STEPS; i++) {
+      o->short_term_sum += o->steps[i];
+    }
+  }
+  for (i = 0; i < LOUDNESS_MOMENTARY_STEPS; i++) {
+    block += o->steps[(pos + LOUDNESS_SHORT_TERM_STEPS - i)
+      % LOUDNESS_SHORT_TERM_STEPS];
+  }
+  block /= LOUDNESS_MOMENTARY_STEPS;
+  o->n_steps++;
+
+  o->momentary = aubio_loudness_lufs (block);
+  o->short_term = aubio_loudness_lufs (o->short_term_sum
+      / LOUDNESS_SHORT_TERM_STEPS);
+
+  if (o->n_steps >= LOUDNESS_MOMENTARY_STEPS
+      && o->momentary > LOUDNESS_ABS_GATE) {
+    uint_t bin = (uint_t)FLOOR ((o->momentary - LOUDNESS_ABS_GATE)
+        * LOUDNESS_BINS_PER_LU);
+    bin = MIN (bin, LOUDNESS_BINS - 1);
+    o->counts[bin]++;
+    o->energies[bin] += block;
+    o->gated_count++;
+    o->gated_sum += block;
+    o->integrated_ok = 0;
+  }
+}
+
+static void
+aubio_loudness_write (aubio_loudness_t * o, fvec_t * out)
+{
+  if (out->length > 0) out->data[0] = o->momentary;
+  if (out->length > 1) out->data[1] = o->short_term;
+  if (out->length > 2) out->data[2] = aubio_loudness_get_integrated (o);
+}
+
+/* filter each channel, then sum the squares of the filtered frames step by
+   step, across all channels */
+static void
+aubio_loudness_do_channels (aubio_loudness_t * o, smpl_t ** in,
+    uint_t length, fvec_t * out)
+{
+  uint_t c, start = 0, len;
+  fvec_t channel, weighted;
+  if (length > o->hop_size) {
+    AUBIO_WRN ("loudness: got %d frames, only the first %d are measured\n",
+        length, o->hop_size);
+    length = o->hop_size;
+  }
+  channel.length = weighted.length = length;
+  for (c = 0; c < o->channels; c++) {
+    channel.data = in[c];
+    weighted.data = o->weighted->data[c];
+    aubio_filter_do_outplace (o->filters[c], &channel, &weighted);
+  }
+  while (start < length) {
+    len = MIN (length - start, o->step_size - o->step_pos);
+    for (c = 0; c < o->channels; c++) {
+      const smpl_t *x = o->weighted->data[c] + start;
+      o->step_sum += AUBIO_SIMD ()->dot (x, x, len);
+    }
+    start += len;
+    o->step_pos += len;
+    if (o->step_pos == o->step_size) {
+      aubio_loudness_push_step (o);
+      o->step_pos = 0;
+    }
+  }
+  aubio_loudness_write (o, out);
+}
+
+void
+aubio_loudness_do (aubio_loudness_t * o, const fvec_t * in, fvec_t * out)
+{
+  smpl_t *data = in->data;
+  if (o->channels != 1) {
+    AUBIO_WRN ("loudness: aubio_loudness_do measures one channel, but %d "
+        "were set, use aubio_loudness_do_multi\n", o->channels);
+    return;
+  }
+  aubio_loudness_do_channels (o, &data, in->length, out);
+}
+
+void
+aubio_loudness_do_multi (aubio_loudness_t * o, const fmat_t * in,
+    fvec_t * out)
+{
+  if (in->height != o->channels) {
+    AUBIO_WRN ("loudness: got %d channels, expected %d\n", in->height,
+        o->channels);
+    return;
+  }
+  aubio_loudness_do_channels (o, in->data, in->length, out);
+}
+
+smpl_t
+aubio_loudness_get_momentary (const aubio_loudness_t * o)
+{
+  return o->momentary;
+}
+
+smpl_t
+aubio_loudness_get_short_term (const aubio_loudness_t * o)
+{
+  return o->short_term;
+}
+
+/* apply the relative gate to the histogram, only when new blocks were
+   counted since the last call */
+smpl_t
+aubio_loudness_get_integrated (aubio_loudness_t * o)
+{
+  uint_t i, count = 0;
+  sint_t first;
+  lsmp_t sum = 0.;
+  smpl_t threshold;
+  if (o->integrated_ok) return o->integrated;
+  threshold = aubio_loudness_lufs (o->gated_sum / o->gated_count)
+    + LOUDNESS_REL_GATE;
+  first = (sint_t)FLOOR ((threshold - LOUDNESS_ABS_GATE)
+      * LOUDNESS_BINS_PER_LU);
+  first = MAX (first, 0);
+  for (i = (uint_t)first; i < LOUDNESS_BINS; i++) {
+    count += o->counts[i];
+    sum += o->energies[i];
+  }
+  o->integrated = count ? aubio_loudness_lufs (sum / count) : -INFINITY;
+  o->integrated_ok = 1;
+  return o->integrated;
+}
+
+void
+del_aubio_loudness (aubio_loudness_t * o)
+{
+  aubio_loudness_free_channels (o);
+  AUBIO_FREE (o);
+}
@@ -0,0 +1,168 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_LOUDNESS_H
+#define AUBIO_LOUDNESS_H
+
+/** \file
+
+  Loudness meter
+
+  This object measures the loudness of a stream as done by ITU-R BS.1770-4
+  and EBU R 128, in LUFS, which is to say in dB relative to a full scale
+  sine wave of 997Hz, read as -3.01 LUFS. Each channel is filtered with a
+  K-weighting filter, see new_aubio_filter_k_weighting(), and the mean
+  squares of the channels are summed with equal weights.
+
+  The mean square of the filtered signal is accumulated over steps of 100ms,
+  and three values are computed from the last steps:
+
+    - the momentary loudness, over the last 400ms
+    - the short-term loudness, over the last 3s
+    - the integrated loudness, over the whole stream since the object was
+      created or reset, gated as done by the standard: blocks of 400ms
+      quieter than -70 LUFS are ignored, then the blocks more than 10 LU below
+      the mean of the remaining ones
+
+  Each block of 400ms is counted in a histogram of 0.1 LU bins, so that
+  the integrated loudness is measured with a memory and a cost per step that
+  do not depend on the length of the stream. The relative gate is applied
+  at the resolution of the histogram.
+
+  The values are updated at the end of each step of 100ms, independently of
+  the hop size. Before the first 400ms and 3s, the momentary and short-term
+  loudness are computed as if the stream was preceded by silence. Silence
+  reads as minus infinity.
+
+  \example temporal/test-loudness.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** loudness meter object */
+typedef struct _aubio_loudness_t aubio_loudness_t;
+
+/** create a loudness meter
+
+  \param hop_size number of frames per call to aubio_loudness_do()
+  \param samplerate sampling rate of the signal, in Hz
+
+  \return newly created ::aubio_loudness_t, or NULL on failure
+
+*/
+aubio_loudness_t *new_aubio_loudness (uint_t hop_size, uint_t samplerate);
+
+/** measure the loudness of a new block of a mono signal
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+  \param in `hop_size` new frames
+  \param out the momentary, short-term and integrated loudness, in LUFS;
+  only the first `out->length` of these three values are written
+
+*/
+void aubio_loudness_do (aubio_loudness_t * o, const fvec_t * in,
+    fvec_t * out);
+
+/** measure the loudness of a new block of several channels
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+  \param in `channels` rows of `hop_size` new frames, with `channels` as
+  set with aubio_loudness_set_channels()
+  \param out the momentary, short-term and integrated loudness, in LUFS;
+  only the first `out->length` of these three values are written
+
+*/
+void aubio_loudness_do_multi (aubio_loudness_t * o, const fmat_t * in,
+    fvec_t * out);
+
+/** set the number of channels of a loudness meter
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+  \param channels number of channels measured together, 1 by default
+
+  \return 0 if successful, non-zero otherwise
+
+  The meter is reset.
+
+*/
+uint_t aubio_loudness_set_channels (aubio_loudness_t * o, uint_t channels);
+
+/** get the number of channels of a loudness meter
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+
+  \return number of channels, as set with aubio_loudness_set_channels()
+
+*/
+uint_t aubio_loudness_get_channels (const aubio_loudness_t * o);
+
+/** get the momentary loudness
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+
+  \return loudness of the last 400ms, in LUFS
+
+*/
+smpl_t aubio_loudness_get_momentary (const aubio_loudness_t * o);
+
+/** get the short-term loudness
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+
+  \return loudness of the last 3s, in LUFS
+
+*/
+smpl_t aubio_loudness_get_short_term (const aubio_loudness_t * o);
+
+/** get the integrated loudness
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+
+  \return gated loudness of the whole stream, in LUFS, or minus infinity if
+  no block of 400ms was louder than -70 LUFS
+
+*/
+smpl_t aubio_loudness_get_integrated (aubio_loudness_t * o);
+
+/** forget the past of a loudness meter
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+
+  The filters, the last steps and the histogram of the integrated loudness
+  are cleared.
+
+*/
+void aubio_loudness_reset (aubio_loudness_t * o);
+
+/** delete a loudness meter
+
+  \param o loudness meter, as returned by new_aubio_loudness()
+
+*/
+void del_aubio_loudness (aubio_loudness_t * o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_LOUDNESS_H */
@@ -20,7 +20,9 @@
 
 #include "aubio_priv.h"
 #include "fvec.h"
+#include "fmat.h"
 #include "temporal/resampler.h"
+#include "temporal/resampler_priv.h"
 
 #ifdef HAVE_SAMPLERATE
 
@@ -29,6 +31,7 @@
 #endif
 
 #include <samplerate.h>         /* from libsamplerate */
+#include "temporal/lazy_samplerate_priv.h"
 
 struct _aubio_resampler_t
 {
@@ -36,6 +39,11 @@ struct _aubio_resampler_t
   SRC_STATE *stat;
   smpl_t ratio;
   uint_t type;
+  uint_t channels;              /**< number of channels of stat */
+  float *in;                    /**< interleaved input of do_multi */
+  float *out;                   /**< interleaved output of do_multi */
+  uint_t in_size;
+  uint_t out_size;
 };
 
 aubio_resampler_t *
@@ -46,8 +54,12 @@ new_aubio_resampler (smpl_t ratio, uint_t type)
   if (!s) {
     return NULL;
   }
+  if (aubio_samplerate_load()) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
   int error = 0;
-  s->stat = src_new (type, 1, &error);  /* only one channel */
+  s->stat = src_new (type, 1, &error);  /* one channel, until do_multi */
   if (error) {
     AUBIO_ERR ("Failed creating resampler: %s\n", src_strerror (error));
     del_aubio_resampler(s);
@@ -55,6 +67,8 @@ new_aubio_resampler (smpl_t ratio, uint_t type)
   }
   s->proc = AUBIO_NEW (SRC_DATA);
   s->ratio = ratio;
+  s->type = type;
+  s->channels = 1;
   return s;
 }
 
@@ -63,42 +77,469 @@ del_aubio_resampler (aubio_resampler_t * s)
 {
   if (s->stat) src_delete (s->stat);
   AUBIO_FREE (s->proc);
+  if (s->in) AUBIO_FREE (s->in);
+  if (s->out) AUBIO_FREE (s->out);
   AUBIO_FREE (s);
 }
 
-void
-aubio_resampler_do (aubio_resampler_t * s, const fvec_t * input, fvec_t * output)
+/* create a new converter if the number of channels changed */
+static uint_t
+aubio_resampler_set_channels (aubio_resampler_t * s, uint_t channels)
 {
-  s->proc->input_frames = input->length;
-  s->proc->output_frames = output->length;
+  int error = 0;
+  if (channels == s->channels) return AUBIO_OK;
+  if (s->stat) src_delete (s->stat);
+  s->stat = src_new (s->type, channels, &error);
+  if (error) {
+    AUBIO_ERR ("Failed creating resampler: %s\n", src_strerror (error));
+    s->stat = NULL;
+    s->channels = 0;
+    return AUBIO_FAIL;
+  }
+  s->channels = channels;
+  return AUBIO_OK;
+}
+
+static void
+aubio_resampler_process (aubio_resampler_t * s, float * in, uint_t in_frames,
+    float * out, uint_t out_frames)
+{
+  s->proc->input_frames = in_frames;
+  s->proc->output_frames = out_frames;
   s->proc->src_ratio = (double) s->ratio;
   /* make SRC_PROC data point to input outputs */
-  s->proc->data_in = (float *) input->data;
-  s->proc->data_out = (float *) output->data;
+  s->proc->data_in = in;
+  s->proc->data_out = out;
   /* do resampling */
   src_process (s->stat, s->proc);
 }
 
+void
+aubio_resampler_do (aubio_resampler_t * s, const fvec_t * input, fvec_t * output)
+{
+  AUBIO_STATS_BEGIN ("resampler");
+  if (aubio_resampler_set_channels (s, 1) == AUBIO_OK) {
+    aubio_resampler_process (s, (float *) input->data, input->length,
+        (float *) output->data, output->length);
+  }
+  AUBIO_STATS_END ();
+}
+
+void
+aubio_resampler_do_multi (aubio_resampler_t * s, const fmat_t * input,
+    fmat_t * output)
+{
+  uint_t i, j, channels = input->height;
+  if (output->height != channels) {
+    AUBIO_ERR ("resampler: input has %d channels, but output has %d\n",
+        channels, output->height);
+    return;
+  }
+  if (aubio_resampler_set_channels (s, channels)) return;
+  if (s->in_size < input->length * channels) {
+    if (s->in) AUBIO_FREE (s->in);
+    s->in_size = input->length * channels;
+    s->in = AUBIO_ARRAY (float, s->in_size);
+  }
+  if (s->out_size < output->length * channels) {
+    if (s->out) AUBIO_FREE (s->out);
+    s->out_size = output->length * channels;
+    s->out = AUBIO_ARRAY (float, s->out_size);
+  }
+  for (i = 0; i < channels; i++) {
+    for (j = 0; j < input->length; j++) {
+      s->in[j * channels + i] = input->data[i][j];
+    }
+  }
+  aubio_resampler_process (s, s->in, input->length, s->out, output->length);
+  for (i = 0; i < channels; i++) {
+    for (j = 0; j < output->length; j++) {
+      output->data[i][j] = s->out[j * channels + i];
+    }
+  }
+}
+
+uint_t
+aubio_resampler_get_latency (const aubio_resampler_t * s UNUSED)
+{
+  return 0;
+}
+
+uint_t
+aubio_resampler_reset (aubio_resampler_t * s)
+{
+  if (s->stat && src_reset (s->stat)) return AUBIO_FAIL;
+  return AUBIO_OK;
+}
+
+void
+aubio_resampler_cleanup (void)
+{
+}
+
+#else /* HAVE_SAMPLERATE */
+
+#if defined(_WIN32)
+#include <windows.h>
+static SRWLOCK aubio_resampler_lock = SRWLOCK_INIT;
+#define AUBIO_RESAMPLER_LOCK()   AcquireSRWLockExclusive(&aubio_resampler_lock)
+#define AUBIO_RESAMPLER_UNLOCK() ReleaseSRWLockExclusive(&aubio_resampler_lock)
 #else
+#include <pthread.h>
+static pthread_mutex_t aubio_resampler_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_RESAMPLER_LOCK()   pthread_mutex_lock(&aubio_resampler_mutex)
+#define AUBIO_RESAMPLER_UNLOCK() pthread_mutex_unlock(&aubio_resampler_mutex)
+#endif
+
+#include "utils/simd_priv.h"
+
+/** maximum number of phases of a filter table */
+#define AUBIO_RESAMPLER_MAX_PHASES 1024
+
+/** polyphase filter table, shared by all the resamplers using it */
+typedef struct _aubio_resampler_table_t
+{
+  uint_t up;                    /**< interpolation factor, number of phases */
+  uint_t down;                  /**< decimation factor */
+  uint_t quality;               /**< index in aubio_resampler_qualities */
+  uint_t taps;                  /**< number of coefficients of each phase */
+  smpl_t *coeffs;               /**< up phases of taps coefficients, each
+                                     reversed to run forward on the input */
+  uint_t refcount;              /**< number of resamplers using the table */
+  uint_t common;                /**< 1 to keep the table until
+                                     aubio_cleanup() */
+  struct _aubio_resampler_table_t *next;
+} aubio_resampler_table_t;
+
+/** list of filter tables, protected by aubio_resampler_lock */
+static aubio_resampler_table_t *aubio_resampler_tables = NULL;
+
+/** parameters of the Kaiser-windowed sinc filter of each quality */
+static const struct {
+  uint_t zero_crossings;        /**< zero crossings on each side */
+  smpl_t beta;                  /**< Kaiser window parameter */
+  smpl_t rolloff;               /**< cutoff, relative to the Nyquist rate */
+} aubio_resampler_qualities[] = {
+  { 32, 10., .95 },             /* 0, best */
+  { 16, 8., .92 },              /* 1, medium */
+  { 8, 6., .88 },               /* 2, fast */
+  { 4, 5., .8 },                /* 3 and 4, fastest */
+};
+
+/** ratios whose tables are kept once computed: 44100 <-> 48000, 2x, 4x */
+static const uint_t aubio_resampler_common[][2] = {
+  { 160, 147 }, { 147, 160 }, { 2, 1 }, { 1, 2 }, { 4, 1 }, { 1, 4 },
+};
+
 struct _aubio_resampler_t
 {
-  void *dummy;
+  smpl_t ratio;
+  uint_t type;
+  aubio_resampler_table_t *table;
+  uint_t channels;              /**< number of rows of history */
+  fmat_t *history;              /**< past input, taps - 1 frames before the
+                                     first frame still needed */
+  uint_t length;                /**< number of frames in history */
+  uint_t pos;                   /**< last frame of the next output window */
+  uint_t phase;                 /**< phase of the next output */
 };
 
+/* zeroth order modified Bessel function of the first kind */
+static lsmp_t
+aubio_resampler_bessel_i0 (lsmp_t x)
+{
+  lsmp_t sum = 1., term = 1., y = x * x / 4.;
+  uint_t k;
+  for (k = 1; k < 64 && term > sum * 1.e-16; k++) {
+    term *= y / ((lsmp_t)k * k);
+    sum += term;
+  }
+  return sum;
+}
+
+/* approximate ratio with the fraction up / down, up being at most
+   AUBIO_RESAMPLER_MAX_PHASES */
+static void
+aubio_resampler_get_fraction (smpl_t ratio, uint_t * up, uint_t * down)
+{
+  lsmp_t x = ratio, h0 = 0., h1 = 1., k0 = 1., k1 = 0.;
+  uint_t i;
+  for (i = 0; i < 32; i++) {
+    lsmp_t a = FLOOR(x), h2 = a * h1 + h0, k2 = a * k1 + k0;
+    if (h2 > AUBIO_RESAMPLER_MAX_PHASES) break;
+    h0 = h1; h1 = h2;
+    k0 = k1; k1 = k2;
+    if (ABS((smpl_t)(h1 / k1) - ratio) <= 1.e-6 * ratio || x - a < 1.e-9) {
+      break;
+    }
+    x = 1. / (x - a);
+  }
+  *up = (uint_t)h1;
+  *down = (uint_t)k1;
+}
+
+static aubio_resampler_table_t *
+new_aubio_resampler_table (uint_t up, uint_t down, uint_t quality)
+{
+  aubio_resampler_table_t *t = AUBIO_NEW (aubio_resampler_table_t);
+  lsmp_t scale = MIN(1., (lsmp_t)up / down), center, cutoff, sum = 0.;
+  lsmp_t beta = aubio_resampler_qualities[quality].beta;
+  lsmp_t *h;
+  uint_t i, j, n, half;
+  if (!t) return NULL;
+  // the cutoff gets below the nyquist rate of the output when downsampling
+  half = (uint_t)CEIL(aubio_resampler_qualities[quality].zero_crossings
+      / scale);
+  t->up = up;
+  t->down = down;
+  t->quality = quality;
+  t->taps = 2 * half;
+  n = up * t->taps;
+  t->coeffs = AUBIO_ARRAY (smpl_t, n);
+  h = AUBIO_ARRAY (lsmp_t, n);
+  if (!t->coeffs || !h) goto beach;
+  // prototype filter, at up times the input samplerate
+  center = (n - 1) / 2.;
+  cutoff = .5 * aubio_resampler_qualities[quality].rolloff * scale / up;
+  for (i = 0; i < n; i++) {
+    lsmp_t x = i - center, r = x / (center + 1.);
+    h[i] = (x == 0.) ? 2. * cutoff : SIN(TWO_PI * cutoff * x) / (PI * x);
+    h[i] *= aubio_resampler_bessel_i0 (beta * SQRT(1. - r * r))
+      / aubio_resampler_bessel_i0 (beta);
+    sum += h[i];
+  }
+  // unit gain at DC, for each of the phases taken as a whole
+  for (i = 0; i < up; i++) {
+    for (j = 0; j < t->taps; j++) {
+      t->coeffs[i * t->taps + t->taps - 1 - j] = h[i + j * up] * up / sum;
+    }
+  }
+  AUBIO_FREE (h);
+  return t;
+beach:
+  if (h) AUBIO_FREE (h);
+  if (t->coeffs) AUBIO_FREE (t->coeffs);
+  AUBIO_FREE (t);
+  return NULL;
+}
+
+static void
+del_aubio_resampler_table (aubio_resampler_table_t * t)
+{
+  AUBIO_FREE (t->coeffs);
+  AUBIO_FREE (t);
+}
+
+/* get the table of up, down and quality, computing it if needed */
+static aubio_resampler_table_t *
+aubio_resampler_get_table (uint_t up, uint_t down, uint_t quality)
+{
+  aubio_resampler_table_t *t;
+  uint_t i, n_common = sizeof(aubio_resampler_common)
+    / sizeof(aubio_resampler_common[0]);
+  AUBIO_RESAMPLER_LOCK();
+  for (t = aubio_resampler_tables; t; t = t->next) {
+    if (t->up == up && t->down == down && t->quality == quality) break;
+  }
+  if (!t) {
+    t = new_aubio_resampler_table (up, down, quality);
+    if (t) {
+      for (i = 0; i < n_common; i++) {
+        if (aubio_resampler_common[i][0] == up
+            && aubio_resampler_common[i][1] == down) {
+          t->common = 1;
+        }
+      }
+      t->next = aubio_resampler_tables;
+      aubio_resampler_tables = t;
+    }
+  }
+  if (t) t->refcount++;
+  AUBIO_RESAMPLER_UNLOCK();
+  return t;
+}
+
+static void
+aubio_resampler_release_table (aubio_resampler_table_t * t)
+{
+  aubio_resampler_table_t **p;
+  AUBIO_RESAMPLER_LOCK();
+  if (--t->refcount == 0 && !t->common) {
+    for (p = &aubio_resampler_tables; *p; p = &(*p)->next) {
+      if (*p == t) {
+        *p = t->next;
+        break;
+      }
+    }
+    del_aubio_resampler_table (t);
+  }
+  AUBIO_RESAMPLER_UNLOCK();
+}
+
+void
+aubio_resampler_cleanup (void)
+{
+  aubio_resampler_table_t **p, *t;
+  AUBIO_RESAMPLER_LOCK();
+  p = &aubio_resampler_tables;
+  while (*p) {
+    t = *p;
+    if (t->refcount == 0) {
+      *p = t->next;
+      del_aubio_resampler_table (t);
+    } else {
+      p = &t->next;
+    }
+  }
+  AUBIO_RESAMPLER_UNLOCK();
+}
+
 aubio_resampler_t *
-new_aubio_resampler (smpl_t ratio UNUSED, uint_t type UNUSED)
+new_aubio_resampler (smpl_t ratio, uint_t type)
 {
-  AUBIO_ERR ("aubio was not compiled with libsamplerate\n");
+  aubio_resampler_t *s = AUBIO_NEW (aubio_resampler_t);
+  uint_t up, down;
+  if (!s) {
+    return NULL;
+  }
+  if (!(ratio >= 1. / 256. && ratio <= 256.)) {
+    AUBIO_ERR ("resampler: ratio should be in [1/256, 256], got %f\n", ratio);
+    goto beach;
+  }
+  if (type > 4) {
+    AUBIO_ERR ("resampler: unknown type %d, should be in [0, 4]\n", type);
+    goto beach;
+  }
+  aubio_resampler_get_fraction (ratio, &up, &down);
+  s->table = aubio_resampler_get_table (up, down, MIN(type, 3));
+  if (!s->table) goto beach;
+  s->ratio = ratio;
+  s->type = type;
+  if (aubio_resampler_reset (s)) goto beach;
+  return s;
+beach:
+  del_aubio_resampler (s);
   return NULL;
 }
 
 void
-del_aubio_resampler (aubio_resampler_t * s UNUSED)
+del_aubio_resampler (aubio_resampler_t * s)
 {
+  if (s->table) aubio_resampler_release_table (s->table);
+  if (s->history) del_fmat (s->history);
+  AUBIO_FREE (s);
+}
+
+/* resize the history to hold at least length frames of channels */
+static uint_t
+aubio_resampler_grow (aubio_resampler_t * s, uint_t channels, uint_t length)
+{
+  fmat_t *history;
+  uint_t i;
+  if (s->history && s->history->height == channels
+      && s->history->length >= length) {
+    return AUBIO_OK;
+  }
+  history = new_fmat (channels, MAX(length, 2 * s->table->taps));
+  if (!history) return AUBIO_FAIL;
+  if (s->history) {
+    for (i = 0; i < MIN(channels, s->history->height); i++) {
+      AUBIO_MEMCPY (history->data[i], s->history->data[i],
+          s->length * sizeof(smpl_t));
+    }
+    del_fmat (s->history);
+  }
+  s->history = history;
+  return AUBIO_OK;
+}
+
+uint_t
+aubio_resampler_get_latency (const aubio_resampler_t * s)
+{
+  return s->table->taps / 2;
+}
+
+uint_t
+aubio_resampler_reset (aubio_resampler_t * s)
+{
+  uint_t i, channels = s->history ? s->history->height : 1;
+  if (aubio_resampler_grow (s, channels, 0)) return AUBIO_FAIL;
+  for (i = 0; i < channels; i++) {
+    AUBIO_MEMSET (s->history->data[i], 0, s->table->taps * sizeof(smpl_t));
+  }
+  // start with taps - 1 frames of silence before the first input
+  s->length = s->table->taps - 1;
+  s->pos = s->length;
+  s->phase = 0;
+  return AUBIO_OK;
+}
+
+void
+aubio_resampler_do_multi (aubio_resampler_t * s, const fmat_t * input,
+    fmat_t * output)
+{
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  const aubio_resampler_table_t *t = s->table;
+  uint_t i, k, start, ahead, channels = input->height;
+  if (output->height != channels) {
+    AUBIO_ERR ("resampler: input has %d channels, but output has %d\n",
+        channels, output->height);
+    return;
+  }
+  if (channels != s->history->height) {
+    // start again from silence on the new channels
+    if (aubio_resampler_grow (s, channels, 0)) return;
+    aubio_resampler_reset (s);
+  }
+  if (aubio_resampler_grow (s, channels, s->length + input->length)) return;
+  for (i = 0; i < channels; i++) {
+    AUBIO_MEMCPY (s->history->data[i] + s->length, input->data[i],
+        input->length * sizeof(smpl_t));
+  }
+  s->length += input->length;
+  for (k = 0; k < output->length && s->pos < s->length; k++) {
+    const smpl_t *coeffs = t->coeffs + s->phase * t->taps;
+    for (i = 0; i < channels; i++) {
+      output->data[i][k] = ops->dot (coeffs,
+          s->history->data[i] + s->pos + 1 - t->taps, t->taps);
+    }
+    s->phase += t->down;
+    s->pos += s->phase / t->up;
+    s->phase %= t->up;
+  }
+  // not enough input for the remaining output frames
+  for (; k < output->length; k++) {
+    for (i = 0; i < channels; i++) {
+      output->data[i][k] = 0.;
+    }
+  }
+  // skip the input that could not be used by the next output frames
+  ahead = (s->length > s->pos) ? s->length - s->pos : 0;
+  if (ahead > input->length + t->taps) {
+    s->pos += ahead - input->length - t->taps;
+  }
+  // drop the frames before the next output window
+  start = MIN(s->pos + 1 - t->taps, s->length);
+  if (start > 0) {
+    for (i = 0; i < channels; i++) {
+      memmove (s->history->data[i], s->history->data[i] + start,
+          (s->length - start) * sizeof(smpl_t));
+    }
+    s->length -= start;
+    s->pos -= start;
+  }
 }
 
 void
-aubio_resampler_do (aubio_resampler_t * s UNUSED, const fvec_t * input UNUSED, fvec_t * output UNUSED)
+aubio_resampler_do (aubio_resampler_t * s, const fvec_t * input,
+    fvec_t * output)
 {
+  smpl_t *in_data = input->data, *out_data = output->data;
+  fmat_t in = { input->length, 1, &in_data };
+  fmat_t out = { output->length, 1, &out_data };
+  AUBIO_STATS_BEGIN ("resampler");
+  aubio_resampler_do_multi (s, &in, &out);
+  AUBIO_STATS_END ();
 }
+
 #endif /* HAVE_SAMPLERATE */
@@ -28,6 +28,22 @@
  This object resamples an input vector into an output vector using
  libsamplerate. See http://www.mega-nerd.com/SRC/
 
+ When aubio is compiled without libsamplerate, a built-in polyphase resampler
+ is used instead. The ratio is then approximated by a fraction of at most 1024
+ phases, and each phase is a Kaiser-windowed sinc filter, whose length depends
+ on the type:
+
+  - 0: best quality, 32 zero crossings on each side
+  - 1: medium quality, 16 zero crossings
+  - 2: fast, 8 zero crossings
+  - 3 and 4: fastest, 4 zero crossings
+
+ The filters get longer when downsampling, to cut below the Nyquist frequency
+ of the output. The output is delayed by half the length of the filter. The
+ filter tables are shared by the resamplers using the same ratio and type, and
+ those of the ratios from 44100 to 48000Hz and back, 2, 4, 1/2 and 1/4 are kept
+ until aubio_cleanup() is called.
+
 */
 
 #ifdef __cplusplus
@@ -39,7 +55,7 @@ typedef struct _aubio_resampler_t aubio_resampler_t;
 
 /** create resampler object
 
-  \param ratio output_sample_rate / input_sample_rate
+  \param ratio output_sample_rate / input_sample_rate, in [1/256, 256]
   \param type libsamplerate resampling type, see http://www.mega-nerd.com/SRC/api_misc.html#Converters
 
 */
@@ -58,6 +74,44 @@ void del_aubio_resampler (aubio_resampler_t * s);
 void aubio_resampler_do (aubio_resampler_t * s, const fvec_t * input,
     fvec_t * output);
 
+/** resample each channel of input in output
+
+  \param s resampler object
+  \param input input buffer of height C and of size N
+  \param output output buffer of height C and of size N*ratio
+
+  The channels are resampled together, with the same filters. The resampler
+  starts again from silence when the number of channels changes.
+
+  With the built-in resampler, the frames of output that would need more input
+  than given so far are set to 0, and input that is not used in time by the
+  following frames of output is skipped. Input and output sizes should thus
+  keep the ratio over successive calls.
+
+*/
+void aubio_resampler_do_multi (aubio_resampler_t * s, const fmat_t * input,
+    fmat_t * output);
+
+/** get the latency of the resampler
+
+  \param s resampler object
+
+  \return delay of the output, in samples of the input: half the length of
+  the filter for the built-in resampler, 0 with libsamplerate, which does not
+  report it
+
+*/
+uint_t aubio_resampler_get_latency (const aubio_resampler_t * s);
+
+/** clear the past input of the resampler, for instance after seeking
+
+  \param s resampler object
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_resampler_reset (aubio_resampler_t * s);
+
 #ifdef __cplusplus
 }
 #endif
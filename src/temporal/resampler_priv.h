@@ -0,0 +1,33 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Filter tables of the built-in resampler, used by mathutils.c.
+
+   The polyphase tables of the most common ratios are kept once computed, so
+   that opening sources at these ratios does not compute them again.
+*/
+
+#ifndef AUBIO_RESAMPLER_PRIV_H
+#define AUBIO_RESAMPLER_PRIV_H
+
+/** delete the filter tables no longer used by any resampler */
+void aubio_resampler_cleanup (void);
+
+#endif /* AUBIO_RESAMPLER_PRIV_H */
@@ -62,6 +62,17 @@ typedef unsigned int uint_t;
 typedef int          sint_t;
 /** character */
 typedef char         char_t;
+/** signed 16 bit integer sample, as delivered by most capture devices */
+typedef short        s16_t;
+/** signed 8 bit integer, for quantized features, see utils/quantize.h */
+typedef signed char  s8_t;
+/** unsigned 8 bit integer, for quantized features */
+typedef unsigned char u8_t;
+/** half-precision float, the 16 bits of an IEEE 754 binary16 value */
+typedef unsigned short f16_t;
+/** unsigned 64 bit integer, for positions in long streams, see
+  utils/events.h */
+typedef unsigned long long u64_t;
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,341 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "utils/allocator.h"
+#include "utils/workspace_priv.h"
+
+/* Each allocation is preceded by a header, right before the aligned address
+   returned to the caller, telling which allocator to free it with. */
+typedef struct {
+  const aubio_allocator_t *allocator;   /**< NULL for the C library */
+  void *raw;                            /**< address returned by allocator */
+  size_t size;                          /**< size asked by the caller */
+} aubio_alloc_header_t;
+
+#define AUBIO_ALLOC_HEADER sizeof(aubio_alloc_header_t)
+
+/* offset of the first aligned address after raw + AUBIO_ALLOC_HEADER */
+#define AUBIO_ALLOC_OFFSET(raw) (AUBIO_ALIGN_SIZE((size_t)(raw) \
+      + AUBIO_ALLOC_HEADER) - (size_t)(raw))
+
+typedef struct _aubio_arena_block_t {
+  struct _aubio_arena_block_t *next;
+  size_t size;
+  size_t used;
+} aubio_arena_block_t;
+
+struct _aubio_arena_t {
+  aubio_allocator_t allocator;
+  aubio_arena_block_t *blocks;          /**< last block first */
+  size_t block_size;
+  size_t used;
+  uint_t n_blocks;
+};
+
+typedef struct _aubio_workspace_block_t {
+  struct _aubio_workspace_block_t *next;
+  unsigned char *data;                  /**< aligned start of the block */
+  size_t size;
+  size_t used;                          /**< end of the last buffer taken */
+} aubio_workspace_block_t;
+
+struct _aubio_workspace_t {
+  aubio_workspace_block_t *blocks;      /**< last block first */
+  size_t block_size;
+  uint_t n_blocks;
+};
+
+static AUBIO_THREAD_LOCAL const aubio_allocator_t *aubio_allocator = NULL;
+static AUBIO_THREAD_LOCAL aubio_workspace_t *aubio_workspace = NULL;
+
+static void *aubio_arena_alloc (void *data, uint_t size);
+static void *aubio_arena_take (aubio_arena_t *o, size_t size, size_t offset);
+
+uint_t aubio_get_alignment (void)
+{
+  return AUBIO_ALIGNMENT;
+}
+
+const aubio_allocator_t *aubio_set_allocator (
+    const aubio_allocator_t *allocator)
+{
+  const aubio_allocator_t *previous = aubio_allocator;
+  aubio_allocator = allocator;
+  return previous;
+}
+
+static void *aubio_malloc_with (const aubio_allocator_t *a, size_t size,
+    uint_t zero)
+{
+  size_t total = size + AUBIO_ALLOC_HEADER + AUBIO_ALIGNMENT;
+  unsigned char *raw, *ptr;
+  aubio_alloc_header_t *h;
+  if (total < size) return NULL;
+  if (!a) {
+    raw = (unsigned char *)(zero ? calloc(total, 1) : malloc(total));
+  } else if (a->alloc == aubio_arena_alloc) {
+    // no need to leave room for the alignment, the arena places the header
+    raw = (unsigned char *)aubio_arena_take((aubio_arena_t *)a->data,
+        size + AUBIO_ALLOC_HEADER, AUBIO_ALLOC_HEADER);
+  } else if (total <= UINT_MAX) {
+    raw = (unsigned char *)a->alloc(a->data, (uint_t)total);
+  } else {
+    raw = NULL;
+  }
+  if (!raw) return NULL;
+  ptr = raw + AUBIO_ALLOC_OFFSET(raw);
+  if (a && zero) memset(ptr, 0, size);
+  h = (aubio_alloc_header_t *)ptr - 1;
+  h->allocator = a;
+  h->raw = raw;
+  h->size = size;
+  return ptr;
+}
+
+void *aubio_malloc (size_t size, uint_t zero)
+{
+  return aubio_malloc_with(aubio_allocator, size, zero);
+}
+
+void *aubio_realloc (void *ptr, size_t size)
+{
+  aubio_alloc_header_t *h;
+  void *out;
+  if (!ptr) return aubio_malloc(size, 0);
+  h = (aubio_alloc_header_t *)ptr - 1;
+  // keep the memory with the allocator it came from
+  out = aubio_malloc_with(h->allocator, size, 0);
+  if (!out) return NULL;
+  memcpy(out, ptr, MIN(size, h->size));
+  aubio_free(ptr);
+  return out;
+}
+
+void aubio_free (void *ptr)
+{
+  aubio_alloc_header_t *h;
+  if (!ptr) return;
+  h = (aubio_alloc_header_t *)ptr - 1;
+  if (!h->allocator) {
+    free(h->raw);
+  } else {
+    h->allocator->release(h->allocator->data, h->raw);
+  }
+}
+
+uint_t aubio_malloc_size (const void *ptr)
+{
+  const aubio_alloc_header_t *h;
+  if (!ptr) return 0;
+  h = (const aubio_alloc_header_t *)ptr - 1;
+  return (uint_t)MIN(h->size, UINT_MAX);
+}
+
+/* return `size` bytes of the arena, such that the address `offset` bytes
+   after them is aligned */
+static void *aubio_arena_take (aubio_arena_t *o, size_t size, size_t offset)
+{
+  aubio_arena_block_t *b = o->blocks;
+  unsigned char *data, *ptr = NULL;
+  size_t start = 0;
+  if (b) {
+    data = (unsigned char *)(b + 1);
+    start = AUBIO_ALIGN_SIZE((size_t)data + b->used + offset)
+      - offset - (size_t)data;
+    if (start + size <= b->size) ptr = data + start;
+  }
+  if (!ptr) {
+    size_t block_size = MAX(o->block_size, size + AUBIO_ALIGNMENT);
+    // from the C library, the allocator of the calling thread may be this one
+    b = (aubio_arena_block_t *)malloc(sizeof(aubio_arena_block_t)
+        + block_size);
+    if (!b) return NULL;
+    b->next = o->blocks;
+    b->size = block_size;
+    b->used = 0;
+    o->blocks = b;
+    o->n_blocks++;
+    data = (unsigned char *)(b + 1);
+    start = AUBIO_ALIGN_SIZE((size_t)data + offset) - offset - (size_t)data;
+    ptr = data + start;
+  }
+  o->used += start + size - b->used;
+  b->used = start + size;
+  return ptr;
+}
+
+static void *aubio_arena_alloc (void *data, uint_t size)
+{
+  return aubio_arena_take((aubio_arena_t *)data, size, 0);
+}
+
+static void aubio_arena_release (void *data UNUSED, void *ptr UNUSED)
+{
+  // given back by del_aubio_arena
+}
+
+aubio_arena_t *new_aubio_arena (uint_t size)
+{
+  aubio_arena_t *o;
+  if ((sint_t)size < 1) {
+    AUBIO_ERR("arena: got size %d, expected > 0\n", size);
+    return NULL;
+  }
+  // from the C library, not from the allocator of the calling thread
+  o = (aubio_arena_t *)calloc(1, sizeof(aubio_arena_t));
+  if (!o) return NULL;
+  o->allocator.alloc = aubio_arena_alloc;
+  o->allocator.release = aubio_arena_release;
+  o->allocator.data = o;
+  o->block_size = size;
+  if (!aubio_arena_take(o, 0, 0)) {
+    free(o);
+    return NULL;
+  }
+  return o;
+}
+
+const aubio_allocator_t *aubio_arena_get_allocator (aubio_arena_t *o)
+{
+  return &o->allocator;
+}
+
+uint_t aubio_arena_get_used (const aubio_arena_t *o)
+{
+  return (uint_t)MIN(o->used, UINT_MAX);
+}
+
+uint_t aubio_arena_get_blocks (const aubio_arena_t *o)
+{
+  return o->n_blocks;
+}
+
+void del_aubio_arena (aubio_arena_t *o)
+{
+  aubio_arena_block_t *b = o->blocks, *next;
+  AUBIO_ASSERT(o);
+  while (b) {
+    next = b->next;
+    free(b);
+    b = next;
+  }
+  free(o);
+}
+
+/* return `size` bytes of the last block of the workspace, `*offset` bytes
+   into it, or of a new block if they do not fit, and move `*offset` after
+   them */
+static void *aubio_workspace_take (aubio_workspace_t *o, size_t size,
+    size_t *offset)
+{
+  aubio_workspace_block_t *b = o->blocks;
+  unsigned char *ptr;
+  size = AUBIO_ALIGN_SIZE(size);
+  if (!b || *offset + size > b->size) {
+    size_t block_size = MAX(o->block_size, size);
+    // from the C library, like the arenas
+    b = (aubio_workspace_block_t *)calloc(1, sizeof(aubio_workspace_block_t)
+        + block_size + AUBIO_ALIGNMENT);
+    if (!b) return NULL;
+    b->data = (unsigned char *)AUBIO_ALIGN_SIZE((size_t)(b + 1));
+    b->size = block_size;
+    b->next = o->blocks;
+    o->blocks = b;
+    o->n_blocks++;
+    // the buffers already taken by the object are in another block
+    *offset = 0;
+  }
+  ptr = b->data + *offset;
+  *offset += size;
+  b->used = MAX(b->used, *offset);
+  return ptr;
+}
+
+fvec_t *new_aubio_scratch (uint_t length, size_t *offset)
+{
+  fvec_t *s;
+  if (!aubio_workspace || !offset) {
+    return new_fvec(length);
+  }
+  if ((sint_t)length <= 0) {
+    return NULL;
+  }
+  // the structure is the object's own, only its samples are shared
+  s = AUBIO_NEW(fvec_t);
+  if (!s) return NULL;
+  s->data = (smpl_t *)aubio_workspace_take(aubio_workspace,
+      length * sizeof(smpl_t), offset);
+  if (!s->data) {
+    AUBIO_FREE(s);
+    return NULL;
+  }
+  s->length = length;
+  return s;
+}
+
+aubio_workspace_t *new_aubio_workspace (uint_t size)
+{
+  aubio_workspace_t *o;
+  if ((sint_t)size < 1) {
+    AUBIO_ERR("workspace: got size %d, expected > 0\n", size);
+    return NULL;
+  }
+  o = (aubio_workspace_t *)calloc(1, sizeof(aubio_workspace_t));
+  if (!o) return NULL;
+  o->block_size = AUBIO_ALIGN_SIZE((size_t)size);
+  return o;
+}
+
+aubio_workspace_t *aubio_set_workspace (aubio_workspace_t *workspace)
+{
+  aubio_workspace_t *previous = aubio_workspace;
+  aubio_workspace = workspace;
+  return previous;
+}
+
+uint_t aubio_workspace_get_used (const aubio_workspace_t *o)
+{
+  const aubio_workspace_block_t *b;
+  size_t used = 0;
+  for (b = o->blocks; b; b = b->next) {
+    used += b->used;
+  }
+  return (uint_t)MIN(used, UINT_MAX);
+}
+
+uint_t aubio_workspace_get_blocks (const aubio_workspace_t *o)
+{
+  return o->n_blocks;
+}
+
+void del_aubio_workspace (aubio_workspace_t *o)
+{
+  aubio_workspace_block_t *b = o->blocks, *next;
+  AUBIO_ASSERT(o);
+  if (aubio_workspace == o) aubio_workspace = NULL;
+  while (b) {
+    next = b->next;
+    free(b);
+    b = next;
+  }
+  free(o);
+}
@@ -0,0 +1,242 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_ALLOCATOR_H
+#define AUBIO_ALLOCATOR_H
+
+/** \file
+
+  Memory allocators
+
+  All the memory of aubio objects and vectors is allocated by the allocator
+  of the calling thread, aligned to 64 bytes. By default, it is the one of
+  the C library. ::aubio_set_allocator replaces it with another one, for
+  instance to use a memory pool, until it is called again.
+
+  Memory is always freed by the allocator it was allocated with, even if
+  another allocator was set in the meantime, or if it is freed by another
+  thread. An allocator should thus remain valid until all the objects
+  created with it were deleted.
+
+  An arena is an allocator that takes memory from one contiguous block.
+  Creating an analysis, for instance an ::aubio_onset_t and its phase
+  vocoder, spectral descriptor and peak picker, while an arena is set,
+  keeps all of its buffers next to each other. Deleting its objects costs
+  nothing, and the memory is given back at once by ::del_aubio_arena.
+
+  \code
+  aubio_arena_t *arena = new_aubio_arena (1 << 20);
+  const aubio_allocator_t *previous =
+    aubio_set_allocator (aubio_arena_get_allocator (arena));
+  aubio_onset_t *onset = new_aubio_onset ("default", 1024, 256, 44100);
+  aubio_set_allocator (previous);
+  // ... analyse
+  del_aubio_onset (onset);
+  del_aubio_arena (arena);
+  \endcode
+
+  Besides their state, many objects keep buffers they only use while
+  computing a frame, such as the autocorrelation of ::aubio_beattracking_t.
+  A workspace lets the objects run by a single thread share these buffers.
+  The objects created once it was passed to ::aubio_set_workspace all take
+  them from the same memory, so that the working set of hundreds of analyses
+  stays the one of the largest.
+
+  \code
+  aubio_workspace_t *workspace = new_aubio_workspace (1 << 16);
+  aubio_workspace_t *previous = aubio_set_workspace (workspace);
+  aubio_tempo_t *tempo = new_aubio_tempo ("default", 1024, 256, 44100);
+  aubio_pitch_t *pitch = new_aubio_pitch ("yinfast", 2048, 256, 44100);
+  aubio_set_workspace (previous);
+  // ... analyse, from one thread at a time
+  del_aubio_tempo (tempo);
+  del_aubio_pitch (pitch);
+  del_aubio_workspace (workspace);
+  \endcode
+
+  The `aubio_*_get_memory_usage` functions, for instance
+  ::aubio_tempo_get_memory_usage, return the number of bytes an object
+  allocated for itself and the objects it owns, such as the phase vocoder of
+  an ::aubio_onset_t, without the few bytes each allocation adds for its
+  alignment. The tables
+  shared by several objects, such as the windows or the FFTW plans, the
+  buffers taken from a workspace, and the state of external libraries, are
+  not counted.
+
+  \example utils/test-allocator.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** allocator of memory */
+typedef struct {
+  /** allocate `size` bytes, aligned as by malloc, or return NULL */
+  void *(*alloc) (void *data, uint_t size);
+  /** free memory returned by `alloc` */
+  void (*release) (void *data, void *ptr);
+  /** user data passed to `alloc` and `release` */
+  void *data;
+} aubio_allocator_t;
+
+/** get the alignment of the memory allocated by aubio
+
+  \return alignment in bytes, a power of 2 of at least 32
+
+  The data of the vectors created by ::new_fvec, ::new_cvec, ::new_fmat
+  and ::new_lvec starts at a multiple of this alignment, and is padded with
+  zeros to a whole number of it, so that SIMD code may load and store full
+  registers up to the end of their data. Vectors that point to memory of
+  their own, for instance views of another buffer, have no such guarantee.
+
+*/
+uint_t aubio_get_alignment (void);
+
+/** set the allocator of the calling thread
+
+  \param allocator allocator to use for the objects created by the calling
+  thread, or NULL to use the one of the C library
+
+  \return the previous allocator of the calling thread, or NULL if it was the
+  one of the C library
+
+*/
+const aubio_allocator_t *aubio_set_allocator (
+    const aubio_allocator_t *allocator);
+
+/** arena allocator */
+typedef struct _aubio_arena_t aubio_arena_t;
+
+/** create an arena
+
+  \param size size of the block of the arena, in bytes; once it is full,
+  more blocks of at least the same size are allocated
+
+  \return newly created ::aubio_arena_t, or NULL on failure
+
+*/
+aubio_arena_t *new_aubio_arena (uint_t size);
+
+/** get the allocator of an arena
+
+  \param o arena, created by ::new_aubio_arena
+
+  \return allocator to pass to ::aubio_set_allocator, valid until the arena
+  is deleted
+
+*/
+const aubio_allocator_t *aubio_arena_get_allocator (aubio_arena_t *o);
+
+/** get number of bytes used in an arena
+
+  \param o arena, created by ::new_aubio_arena
+
+  \return number of bytes allocated from the arena, including alignment;
+  memory freed by objects is not reused before the arena is deleted
+
+*/
+uint_t aubio_arena_get_used (const aubio_arena_t *o);
+
+/** get number of blocks of an arena
+
+  \param o arena, created by ::new_aubio_arena
+
+  \return 1 if all the allocations fitted in the first block, more otherwise
+
+*/
+uint_t aubio_arena_get_blocks (const aubio_arena_t *o);
+
+/** delete an arena and give back all its memory
+
+  \param o arena, created by ::new_aubio_arena
+
+  The objects created with the allocator of the arena can not be used once
+  it was deleted.
+
+*/
+void del_aubio_arena (aubio_arena_t *o);
+
+/** workspace of scratch buffers */
+typedef struct _aubio_workspace_t aubio_workspace_t;
+
+/** create a workspace
+
+  \param size size of the block of the workspace, in bytes; an object whose
+  buffers do not fit in it gets a new block of at least the same size, shared
+  with the objects created after it
+
+  \return newly created ::aubio_workspace_t, or NULL on failure
+
+*/
+aubio_workspace_t *new_aubio_workspace (uint_t size);
+
+/** set the workspace of the calling thread
+
+  \param workspace workspace to take the scratch buffers of the objects
+  created by the calling thread from, or NULL to give each object buffers of
+  its own
+
+  \return the previous workspace of the calling thread, or NULL
+
+  The objects sharing a workspace overwrite each other's scratch buffers, and
+  must not run at the same time: they should all be used by the same thread,
+  or by threads that never run them concurrently. Which allocator their own
+  memory comes from is still set by ::aubio_set_allocator.
+
+*/
+aubio_workspace_t *aubio_set_workspace (aubio_workspace_t *workspace);
+
+/** get number of bytes used in a workspace
+
+  \param o workspace, created by ::new_aubio_workspace
+
+  \return number of bytes taken from the blocks of the workspace, the
+  buffers of the objects overlapping
+
+*/
+uint_t aubio_workspace_get_used (const aubio_workspace_t *o);
+
+/** get number of blocks of a workspace
+
+  \param o workspace, created by ::new_aubio_workspace
+
+  \return 1 if the buffers of all the objects fitted in the first block,
+  more otherwise
+
+*/
+uint_t aubio_workspace_get_blocks (const aubio_workspace_t *o);
+
+/** delete a workspace
+
+  \param o workspace, created by ::new_aubio_workspace
+
+  The objects created with the workspace can not be used once it was
+  deleted, but may still be deleted.
+
+*/
+void del_aubio_workspace (aubio_workspace_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_ALLOCATOR_H */
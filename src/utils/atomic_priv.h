@@ -0,0 +1,121 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Atomic operations (private)
+
+  This file is for inclusion from _within_ the library only.
+
+  Loads have acquire semantics and stores release semantics, so that a
+  counter stored by a single writer publishes the data written before it.
+  AUBIO_ATOMIC_ADD() only counts, with relaxed semantics. AUBIO_ATOMIC_OR()
+  releases and AUBIO_ATOMIC_TAKE(), which returns the value and clears it,
+  acquires. AUBIO_ATOMIC_CAS() stores `v` if `x` still holds `old`, and
+  returns 1, otherwise it loads the current value of `x` into `old` and
+  returns 0.
+
+  The operations without suffix act on ::uint_t, the ones with `64` on
+  `unsigned long long`, the ones with `_PTR` on pointers. gcc and clang use
+  their `__atomic` builtins, msvc its `Interlocked` functions.
+
+*/
+
+#ifndef AUBIO_ATOMIC_PRIV_H
+#define AUBIO_ATOMIC_PRIV_H
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <windows.h>
+
+static inline int aubio_atomic_cas (volatile LONG *x, LONG *old, LONG v)
+{
+  LONG prev = InterlockedCompareExchange(x, v, *old);
+  if (prev == *old) return 1;
+  *old = prev;
+  return 0;
+}
+
+static inline int aubio_atomic_cas64 (volatile LONG64 *x, LONG64 *old,
+    LONG64 v)
+{
+  LONG64 prev = InterlockedCompareExchange64(x, v, *old);
+  if (prev == *old) return 1;
+  *old = prev;
+  return 0;
+}
+
+static inline int aubio_atomic_cas_ptr (PVOID volatile *x, PVOID *old,
+    PVOID v)
+{
+  PVOID prev = InterlockedCompareExchangePointer(x, v, *old);
+  if (prev == *old) return 1;
+  *old = prev;
+  return 0;
+}
+
+#define AUBIO_ATOMIC_LOAD(x) ((uint_t)InterlockedOr((volatile LONG *)&(x), 0))
+#define AUBIO_ATOMIC_STORE(x, v) \
+  InterlockedExchange((volatile LONG *)&(x), (LONG)(v))
+#define AUBIO_ATOMIC_ADD(x, v) \
+  InterlockedExchangeAdd((volatile LONG *)&(x), (LONG)(v))
+#define AUBIO_ATOMIC_OR(x, v) InterlockedOr((volatile LONG *)&(x), (LONG)(v))
+#define AUBIO_ATOMIC_TAKE(x) \
+  ((uint_t)InterlockedExchange((volatile LONG *)&(x), 0))
+#define AUBIO_ATOMIC_CAS(x, old, v) \
+  aubio_atomic_cas((volatile LONG *)&(x), (LONG *)&(old), (LONG)(v))
+
+#define AUBIO_ATOMIC_LOAD64(x) ((unsigned long long) \
+  InterlockedCompareExchange64((volatile LONG64 *)&(x), 0, 0))
+#define AUBIO_ATOMIC_STORE64(x, v) \
+  InterlockedExchange64((volatile LONG64 *)&(x), (LONG64)(v))
+#define AUBIO_ATOMIC_ADD64(x, v) \
+  InterlockedExchangeAdd64((volatile LONG64 *)&(x), (LONG64)(v))
+#define AUBIO_ATOMIC_CAS64(x, old, v) \
+  aubio_atomic_cas64((volatile LONG64 *)&(x), (LONG64 *)&(old), (LONG64)(v))
+
+#define AUBIO_ATOMIC_LOAD_PTR(x) \
+  InterlockedCompareExchangePointer((PVOID volatile *)&(x), NULL, NULL)
+#define AUBIO_ATOMIC_STORE_PTR(x, v) \
+  InterlockedExchangePointer((PVOID volatile *)&(x), (PVOID)(v))
+#define AUBIO_ATOMIC_CAS_PTR(x, old, v) \
+  aubio_atomic_cas_ptr((PVOID volatile *)&(x), (PVOID *)&(old), (PVOID)(v))
+
+#else
+
+#define AUBIO_ATOMIC_LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define AUBIO_ATOMIC_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define AUBIO_ATOMIC_ADD(x, v) __atomic_add_fetch(&(x), (v), __ATOMIC_RELAXED)
+#define AUBIO_ATOMIC_OR(x, v) __atomic_fetch_or(&(x), (v), __ATOMIC_RELEASE)
+#define AUBIO_ATOMIC_TAKE(x) __atomic_exchange_n(&(x), 0, __ATOMIC_ACQUIRE)
+#define AUBIO_ATOMIC_CAS(x, old, v) __atomic_compare_exchange_n(&(x), \
+    &(old), (v), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+#define AUBIO_ATOMIC_LOAD64(x) AUBIO_ATOMIC_LOAD(x)
+#define AUBIO_ATOMIC_STORE64(x, v) AUBIO_ATOMIC_STORE(x, v)
+#define AUBIO_ATOMIC_ADD64(x, v) AUBIO_ATOMIC_ADD(x, v)
+#define AUBIO_ATOMIC_CAS64(x, old, v) AUBIO_ATOMIC_CAS(x, old, v)
+
+#define AUBIO_ATOMIC_LOAD_PTR(x) AUBIO_ATOMIC_LOAD(x)
+#define AUBIO_ATOMIC_STORE_PTR(x, v) AUBIO_ATOMIC_STORE(x, v)
+#define AUBIO_ATOMIC_CAS_PTR(x, old, v) AUBIO_ATOMIC_CAS(x, old, v)
+
+#endif
+
+#endif /* AUBIO_ATOMIC_PRIV_H */
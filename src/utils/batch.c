@@ -0,0 +1,640 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+/* mkstemp() */
+#define _XOPEN_SOURCE 700
+#endif
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "utils/events.h"
+#include "onset/onset.h"
+#include "tempo/tempo.h"
+#include "notes/notes.h"
+#include "pitch/pitch.h"
+#include "utils/batch.h"
+#include "io/iothread_priv.h"
+
+#ifdef HAVE_UNISTD_H
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef enum {
+  aubio_batch_onset,
+  aubio_batch_beat,
+  aubio_batch_tempo,
+  aubio_batch_notes,
+  aubio_batch_pitch,
+} aubio_batch_analysis_t;
+
+/* share of the list of files, from begin to end, taken from the front by its
+   own thread and from the back by the others */
+typedef struct {
+  aubio_batch_t *batch;
+  uint_t id;
+  uint_t begin;                 /**< protected by mutex */
+  uint_t end;                   /**< protected by mutex */
+  uint_t running;               /**< 1 if the thread was started */
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  aubio_io_thread_t thread;
+} aubio_batch_worker_t;
+
+/* rows of results of a single file */
+typedef struct {
+  smpl_t *data;
+  uint_t width;                 /**< number of values in each row */
+  uint_t rows;
+  uint_t size;                  /**< number of rows allocated */
+} aubio_batch_results_t;
+
+struct _aubio_batch_t {
+  aubio_batch_analysis_t analysis;
+  char_t *method;
+  uint_t buf_size;
+  uint_t hop_size;
+  uint_t samplerate;
+  uint_t threads;
+  smpl_t threshold;             /**< only set if has_threshold */
+  uint_t has_threshold;
+  smpl_t silence;               /**< only set if has_silence */
+  uint_t has_silence;
+  char_t *cache;                /**< cache directory, or NULL */
+
+  /* the fields below are only set during aubio_batch_run */
+  const char_t **uris;
+  aubio_batch_worker_t *workers;
+  uint_t n_workers;
+  aubio_batch_callback_t callback;
+  void *data;
+  uint_t failed;                /**< protected by mutex */
+  aubio_io_mutex_t mutex;       /**< serialises calls to callback */
+  aubio_io_cond_t cond;
+};
+
+aubio_batch_t *new_aubio_batch (const char_t *analysis, const char_t *method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate)
+{
+  aubio_batch_t *o = AUBIO_NEW(aubio_batch_t);
+  if (!analysis) {
+    AUBIO_ERR("batch: analysis should not be NULL\n");
+    goto beach;
+  } else if (strcmp(analysis, "onset") == 0) {
+    o->analysis = aubio_batch_onset;
+  } else if (strcmp(analysis, "beat") == 0) {
+    o->analysis = aubio_batch_beat;
+  } else if (strcmp(analysis, "tempo") == 0) {
+    o->analysis = aubio_batch_tempo;
+  } else if (strcmp(analysis, "notes") == 0) {
+    o->analysis = aubio_batch_notes;
+  } else if (strcmp(analysis, "pitch") == 0) {
+    o->analysis = aubio_batch_pitch;
+  } else {
+    AUBIO_ERR("batch: unknown analysis %s\n", analysis);
+    goto beach;
+  }
+  if ((sint_t)hop_size < 1 || (sint_t)buf_size < (sint_t)hop_size) {
+    AUBIO_ERR("batch: got buf_size %d and hop_size %d, expected"
+        " buf_size >= hop_size > 0\n", buf_size, hop_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 0) {
+    AUBIO_ERR("batch: got samplerate %d, expected >= 0\n", samplerate);
+    goto beach;
+  }
+  if (!method) method = "default";
+  o->method = AUBIO_ARRAY(char_t, strnlen(method, PATH_MAX) + 1);
+  strncpy(o->method, method, strnlen(method, PATH_MAX) + 1);
+  o->buf_size = buf_size;
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+  o->threads = aubio_threads_get_pool_size();
+  return o;
+
+beach:
+  del_aubio_batch(o);
+  return NULL;
+}
+
+uint_t aubio_batch_set_threads (aubio_batch_t *o, uint_t threads)
+{
+  o->threads = threads ? threads : aubio_threads_get_pool_size();
+  return AUBIO_OK;
+}
+
+uint_t aubio_batch_get_threads (const aubio_batch_t *o)
+{
+  return o->threads;
+}
+
+uint_t aubio_batch_set_threshold (aubio_batch_t *o, smpl_t threshold)
+{
+  if (o->analysis == aubio_batch_notes) {
+    AUBIO_ERR("batch: notes have no threshold\n");
+    return AUBIO_FAIL;
+  }
+  o->threshold = threshold;
+  o->has_threshold = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_batch_set_silence (aubio_batch_t *o, smpl_t silence)
+{
+  o->silence = silence;
+  o->has_silence = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_batch_set_cache (aubio_batch_t *o, const char_t *path)
+{
+#ifdef HAVE_UNISTD_H
+  struct stat st;
+#endif
+  if (o->cache) AUBIO_FREE(o->cache);
+  o->cache = NULL;
+  if (!path || !path[0]) return AUBIO_OK;
+#ifdef HAVE_UNISTD_H
+  // leave room for the names of the files
+  if (strnlen(path, PATH_MAX) + 48 >= PATH_MAX) {
+    AUBIO_ERR("batch: path of the cache directory is too long\n");
+    return AUBIO_FAIL;
+  }
+  if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+    AUBIO_ERR("batch: %s is not a directory\n", path);
+    return AUBIO_FAIL;
+  }
+  o->cache = AUBIO_ARRAY(char_t, strlen(path) + 1);
+  if (!o->cache) return AUBIO_FAIL;
+  memcpy(o->cache, path, strlen(path) + 1);
+  return AUBIO_OK;
+#else
+  AUBIO_ERR("batch: cache directories are not supported on this platform\n");
+  return AUBIO_FAIL;
+#endif
+}
+
+/* append a row of r->width values, or return NULL if it failed */
+static smpl_t *aubio_batch_results_add (aubio_batch_results_t *r)
+{
+  if (r->rows == r->size) {
+    uint_t size = MAX(16, 2 * r->size);
+    smpl_t *data = (smpl_t *)AUBIO_REALLOC(r->data,
+        size * r->width * sizeof(smpl_t));
+    if (!data) return NULL;
+    r->data = data;
+    r->size = size;
+  }
+  return r->data + r->width * r->rows++;
+}
+
+/* number of values in each row of results */
+static uint_t aubio_batch_width (const aubio_batch_t *o)
+{
+  switch (o->analysis) {
+    case aubio_batch_tempo:
+      return 2;
+    case aubio_batch_notes:
+      return 4;
+    case aubio_batch_pitch:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+/* run the analysis on uri, filling r */
+static uint_t aubio_batch_analyse (aubio_batch_t *o, const char_t *uri,
+    aubio_batch_results_t *r)
+{
+  aubio_source_t *source = new_aubio_source(uri, o->samplerate, o->hop_size);
+  fvec_t *in = NULL, *out = NULL;
+  aubio_onset_t *onset = NULL;
+  aubio_tempo_t *tempo = NULL;
+  aubio_notes_t *notes = NULL;
+  aubio_pitch_t *pitch = NULL;
+  uint_t read = 0, total = 0, samplerate, err = AUBIO_FAIL;
+  sint_t note = -1;             /**< row of the note being played, if any */
+  smpl_t *row;
+
+  if (!source) goto beach;
+  samplerate = aubio_source_get_samplerate(source);
+  in = new_fvec(o->hop_size);
+  out = new_fvec(o->analysis == aubio_batch_notes ? 3 : 1);
+  if (!in || !out) goto beach;
+  r->width = aubio_batch_width(o);
+
+  switch (o->analysis) {
+    case aubio_batch_onset:
+      onset = new_aubio_onset(o->method, o->buf_size, o->hop_size,
+          samplerate);
+      if (!onset) goto beach;
+      if (o->has_threshold) aubio_onset_set_threshold(onset, o->threshold);
+      if (o->has_silence) aubio_onset_set_silence(onset, o->silence);
+      break;
+    case aubio_batch_beat:
+    case aubio_batch_tempo:
+      tempo = new_aubio_tempo(o->method, o->buf_size, o->hop_size,
+          samplerate);
+      if (!tempo) goto beach;
+      if (o->has_threshold) aubio_tempo_set_threshold(tempo, o->threshold);
+      if (o->has_silence) aubio_tempo_set_silence(tempo, o->silence);
+      break;
+    case aubio_batch_notes:
+      notes = new_aubio_notes(o->method, o->buf_size, o->hop_size,
+          samplerate);
+      if (!notes) goto beach;
+      if (o->has_silence) aubio_notes_set_silence(notes, o->silence);
+      break;
+    case aubio_batch_pitch:
+      pitch = new_aubio_pitch(o->method, o->buf_size, o->hop_size,
+          samplerate);
+      if (!pitch) goto beach;
+      if (o->has_threshold) aubio_pitch_set_tolerance(pitch, o->threshold);
+      if (o->has_silence) aubio_pitch_set_silence(pitch, o->silence);
+      break;
+  }
+
+  do {
+    aubio_source_do(source, in, &read);
+    switch (o->analysis) {
+      case aubio_batch_onset:
+        aubio_onset_do(onset, in, out);
+        if (out->data[0] != 0) {
+          if (!(row = aubio_batch_results_add(r))) goto beach;
+          row[0] = aubio_onset_get_last_s(onset);
+        }
+        break;
+      case aubio_batch_beat:
+      case aubio_batch_tempo:
+        aubio_tempo_do(tempo, in, out);
+        if (out->data[0] != 0 && o->analysis == aubio_batch_beat) {
+          if (!(row = aubio_batch_results_add(r))) goto beach;
+          row[0] = aubio_tempo_get_last_s(tempo);
+        }
+        break;
+      case aubio_batch_notes:
+        aubio_notes_do(notes, in, out);
+        if (out->data[2] != 0 && note >= 0) {
+          // end of the current note
+          r->data[r->width * note + 3] = total / (smpl_t)samplerate;
+          note = -1;
+        }
+        if (out->data[0] != 0) {
+          if (!(row = aubio_batch_results_add(r))) goto beach;
+          row[0] = out->data[0];
+          row[1] = out->data[1];
+          row[2] = total / (smpl_t)samplerate;
+          row[3] = row[2];
+          note = r->rows - 1;
+        }
+        break;
+      case aubio_batch_pitch:
+        aubio_pitch_do(pitch, in, out);
+        if (!(row = aubio_batch_results_add(r))) goto beach;
+        row[0] = total / (smpl_t)samplerate;
+        row[1] = out->data[0];
+        row[2] = aubio_pitch_get_confidence(pitch);
+        break;
+    }
+    total += read;
+  } while (read == o->hop_size);
+
+  if (note >= 0) {
+    r->data[r->width * note + 3] = total / (smpl_t)samplerate;
+  }
+  if (o->analysis == aubio_batch_tempo) {
+    if (!(row = aubio_batch_results_add(r))) goto beach;
+    row[0] = aubio_tempo_get_bpm(tempo);
+    row[1] = aubio_tempo_get_confidence(tempo);
+  }
+  err = AUBIO_OK;
+
+beach:
+  if (onset) del_aubio_onset(onset);
+  if (tempo) del_aubio_tempo(tempo);
+  if (notes) del_aubio_notes(notes);
+  if (pitch) del_aubio_pitch(pitch);
+  if (in) del_fvec(in);
+  if (out) del_fvec(out);
+  if (source) del_aubio_source(source);
+  return err;
+}
+
+#ifdef HAVE_UNISTD_H
+/** header of the files of the cache directory, followed by the rows */
+typedef struct {
+  char_t magic[8];
+  uint_t version;
+  uint_t smpl_size;
+  uint_t width;
+  uint_t rows;
+  long long src_size;           /**< size of the analysed file */
+} aubio_batch_cache_header_t;
+
+#define AUBIO_BATCH_CACHE_MAGIC "aubiorow"
+#define AUBIO_BATCH_CACHE_VERSION 1
+
+#define AUBIO_FNV_OFFSET 14695981039346656037ULL
+#define AUBIO_FNV_PRIME 1099511628211ULL
+
+/* fnv-1a hash of n bytes, continuing from hash */
+static unsigned long long aubio_batch_hash (unsigned long long hash,
+    const unsigned char *bytes, size_t n)
+{
+  size_t i;
+  for (i = 0; i < n; i++) {
+    hash = (hash ^ bytes[i]) * AUBIO_FNV_PRIME;
+  }
+  return hash;
+}
+
+/* path of the cache file of uri, from a hash of its content and one of the
+   parameters of the analysis; the files are found again after being copied,
+   moved or renamed, and never after their content changed */
+static uint_t aubio_batch_cache_path (const aubio_batch_t *o,
+    const char_t *uri, char_t *path, long long *size)
+{
+  unsigned char block[65536];
+  char_t params[PATH_MAX];
+  unsigned long long content = AUBIO_FNV_OFFSET, hash = AUBIO_FNV_OFFSET;
+  size_t n;
+  FILE *f = fopen(uri, "rb");
+  if (!f) return AUBIO_FAIL;
+  *size = 0;
+  while ((n = fread(block, 1, sizeof(block), f)) > 0) {
+    content = aubio_batch_hash(content, block, n);
+    *size += n;
+  }
+  n = ferror(f);
+  fclose(f);
+  if (n) return AUBIO_FAIL;
+  n = snprintf(params, PATH_MAX, "%d %s %d %d %d %d %.9g %d %.9g %d",
+      o->analysis, o->method, o->buf_size, o->hop_size, o->samplerate,
+      o->has_threshold, o->threshold, o->has_silence, o->silence,
+      (int)sizeof(smpl_t));
+  if (n >= PATH_MAX) return AUBIO_FAIL;
+  hash = aubio_batch_hash(hash, (const unsigned char *)params, n);
+  if (snprintf(path, PATH_MAX, "%s/%016llx-%016llx.rows", o->cache, content,
+        hash) >= PATH_MAX) return AUBIO_FAIL;
+  return AUBIO_OK;
+}
+
+/* read the rows of the cache file at path into r, if it is valid */
+static uint_t aubio_batch_cache_load (const char_t *path, long long size,
+    aubio_batch_results_t *r)
+{
+  aubio_batch_cache_header_t h;
+  size_t n;
+  FILE *f = fopen(path, "rb");
+  if (!f) return AUBIO_FAIL;
+  if (fread(&h, sizeof(h), 1, f) != 1
+      || memcmp(h.magic, AUBIO_BATCH_CACHE_MAGIC, 8) != 0
+      || h.version != AUBIO_BATCH_CACHE_VERSION
+      || h.smpl_size != sizeof(smpl_t) || h.width != r->width
+      || h.src_size != size) {
+    fclose(f);
+    return AUBIO_FAIL;
+  }
+  n = (size_t)h.rows * h.width;
+  if (h.rows > 0) {
+    r->data = AUBIO_ARRAY(smpl_t, n);
+    if (!r->data || fread(r->data, sizeof(smpl_t), n, f) != n) {
+      fclose(f);
+      if (r->data) AUBIO_FREE(r->data);
+      r->data = NULL;
+      return AUBIO_FAIL;
+    }
+  }
+  fclose(f);
+  r->rows = r->size = h.rows;
+  return AUBIO_OK;
+}
+
+/* write the rows of r to path, through a temporary file so that other
+   processes never read a partial file */
+static void aubio_batch_cache_store (const char_t *path, long long size,
+    const aubio_batch_results_t *r)
+{
+  aubio_batch_cache_header_t h;
+  char_t tmp[PATH_MAX];
+  size_t n = (size_t)r->rows * r->width;
+  FILE *f;
+  int fd;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, AUBIO_BATCH_CACHE_MAGIC, 8);
+  h.version = AUBIO_BATCH_CACHE_VERSION;
+  h.smpl_size = sizeof(smpl_t);
+  h.width = r->width;
+  h.rows = r->rows;
+  h.src_size = size;
+  if (snprintf(tmp, PATH_MAX, "%s.XXXXXX", path) >= PATH_MAX) return;
+  fd = mkstemp(tmp);
+  if (fd < 0) goto fail;
+  f = fdopen(fd, "wb");
+  if (!f) {
+    close(fd);
+    unlink(tmp);
+    goto fail;
+  }
+  if (fwrite(&h, sizeof(h), 1, f) != 1
+      || (n > 0 && fwrite(r->data, sizeof(smpl_t), n, f) != n)) {
+    fclose(f);
+    unlink(tmp);
+    goto fail;
+  }
+  if (fclose(f) != 0 || rename(tmp, path) != 0) {
+    unlink(tmp);
+    goto fail;
+  }
+  return;
+fail:
+  AUBIO_WRN("batch: failed writing %s\n", path);
+}
+#endif /* HAVE_UNISTD_H */
+
+/* run the analysis on uri, or read its results from the cache directory */
+static uint_t aubio_batch_analyse_cached (aubio_batch_t *o, const char_t *uri,
+    aubio_batch_results_t *r)
+{
+#ifdef HAVE_UNISTD_H
+  char_t path[PATH_MAX];
+  long long size;
+  uint_t err;
+  // files which can not be read fail in aubio_batch_analyse
+  if (!o->cache || aubio_batch_cache_path(o, uri, path, &size)) {
+    return aubio_batch_analyse(o, uri, r);
+  }
+  r->width = aubio_batch_width(o);
+  if (aubio_batch_cache_load(path, size, r) == AUBIO_OK) return AUBIO_OK;
+  err = aubio_batch_analyse(o, uri, r);
+  if (!err) aubio_batch_cache_store(path, size, r);
+  return err;
+#else
+  return aubio_batch_analyse(o, uri, r);
+#endif
+}
+
+/* take the next file from the front of the own share of w, or steal the back
+   half of the share of another thread; return 0 once all files were taken */
+static uint_t aubio_batch_next (aubio_batch_worker_t *w, uint_t *index)
+{
+  aubio_batch_t *o = w->batch;
+  aubio_batch_worker_t *v;
+  uint_t i, begin, end;
+  AUBIO_IO_LOCK(w);
+  if (w->begin < w->end) {
+    *index = w->begin++;
+    AUBIO_IO_UNLOCK(w);
+    return 1;
+  }
+  AUBIO_IO_UNLOCK(w);
+  // files are never added back, a single pass over the others is enough
+  for (i = 1; i < o->n_workers; i++) {
+    v = &o->workers[(w->id + i) % o->n_workers];
+    AUBIO_IO_LOCK(v);
+    end = v->end;
+    begin = v->end - (v->end - v->begin) / 2;
+    v->end = begin;
+    AUBIO_IO_UNLOCK(v);
+    if (begin < end) {
+      *index = begin;
+      AUBIO_IO_LOCK(w);
+      w->begin = begin + 1;
+      w->end = end;
+      AUBIO_IO_UNLOCK(w);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void aubio_batch_work (aubio_batch_worker_t *w)
+{
+  aubio_batch_t *o = w->batch;
+  aubio_batch_results_t r;
+  fmat_t results;
+  uint_t index, err, j;
+  smpl_t **rows = NULL;
+  uint_t n_rows = 0;
+  while (aubio_batch_next(w, &index)) {
+    AUBIO_MEMSET(&r, 0, sizeof(r));
+    err = aubio_batch_analyse_cached(o, o->uris[index], &r);
+    if (!err && r.rows > n_rows) {
+      AUBIO_FREE(rows);
+      n_rows = r.rows;
+      rows = AUBIO_ARRAY(smpl_t *, n_rows);
+      if (!rows) {
+        n_rows = 0;
+        err = AUBIO_FAIL;
+      }
+    }
+    results.height = err ? 0 : r.rows;
+    results.length = r.width;
+    results.data = rows;
+    for (j = 0; j < results.height; j++) {
+      rows[j] = r.data + j * r.width;
+    }
+    AUBIO_IO_LOCK(o);
+    if (err) o->failed++;
+    if (o->callback) {
+      o->callback(o->data, index, o->uris[index], err ? NULL : &results);
+    }
+    AUBIO_IO_UNLOCK(o);
+    if (r.data) AUBIO_FREE(r.data);
+  }
+  if (rows) AUBIO_FREE(rows);
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_batch_thread)
+{
+  aubio_batch_work((aubio_batch_worker_t *)arg);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+uint_t aubio_batch_run (aubio_batch_t *o, const char_t **uris, uint_t n_uris,
+    aubio_batch_callback_t callback, void *data)
+{
+  uint_t i, failed;
+  aubio_batch_worker_t *w;
+  if (n_uris == 0) return 0;
+  o->n_workers = MIN(o->threads, n_uris);
+  o->workers = AUBIO_ARRAY(aubio_batch_worker_t, o->n_workers);
+  if (!o->workers) {
+    AUBIO_ERR("batch: failed allocating %d threads\n", o->n_workers);
+    return n_uris;
+  }
+  o->uris = uris;
+  o->callback = callback;
+  o->data = data;
+  o->failed = 0;
+  AUBIO_IO_THREAD_INIT(o);
+  for (i = 0; i < o->n_workers; i++) {
+    w = &o->workers[i];
+    w->batch = o;
+    w->id = i;
+    // contiguous shares, so that stealing takes neighbouring files
+    w->begin = (uint_t)((unsigned long long)n_uris * i / o->n_workers);
+    w->end = (uint_t)((unsigned long long)n_uris * (i + 1) / o->n_workers);
+    AUBIO_IO_THREAD_INIT(w);
+  }
+  // the calling thread takes the first share, the others are stolen from
+  // if their thread could not be started
+  for (i = 1; i < o->n_workers; i++) {
+    w = &o->workers[i];
+    w->running = AUBIO_IO_THREAD_START(w, aubio_batch_thread,
+        AUBIO_THREAD_WORKER);
+    if (!w->running) {
+      AUBIO_WRN("batch: failed starting thread %d\n", i);
+    }
+  }
+  aubio_batch_work(&o->workers[0]);
+  // running threads may still lock the share of any other one
+  for (i = 1; i < o->n_workers; i++) {
+    w = &o->workers[i];
+    if (w->running) AUBIO_IO_THREAD_JOIN(w);
+  }
+  for (i = 0; i < o->n_workers; i++) {
+    AUBIO_IO_THREAD_DESTROY(&o->workers[i]);
+  }
+  AUBIO_IO_THREAD_DESTROY(o);
+  failed = o->failed;
+  AUBIO_FREE(o->workers);
+  o->workers = NULL;
+  o->n_workers = 0;
+  o->uris = NULL;
+  o->callback = NULL;
+  o->data = NULL;
+  return failed;
+}
+
+void del_aubio_batch (aubio_batch_t *o)
+{
+  AUBIO_ASSERT(o);
+  if (o->method)
+    AUBIO_FREE(o->method);
+  if (o->cache)
+    AUBIO_FREE(o->cache);
+  AUBIO_FREE(o);
+}
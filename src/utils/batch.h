@@ -0,0 +1,176 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_BATCH_H
+#define AUBIO_BATCH_H
+
+/** \file
+
+  Analysis of many files on a pool of threads
+
+  This object runs the same analysis, for instance onset detection, on a
+  list of files. Each file is read and analysed by a single thread, and the
+  files are spread over a pool of threads, of aubio_threads_get_pool_size()
+  threads by default.
+  Each thread starts with its own share of the list, and takes files from the
+  share of another thread once its own share is done.
+
+  The results of each file are passed to a callback as soon as the file was
+  analysed, and can be kept in a cache directory, see
+  ::aubio_batch_set_cache. The callback is never called by two threads at
+  once, but the files may complete in any order.
+
+  The following analysis are available:
+
+    - `onset`: one row per onset, holding its time in seconds
+    - `beat`: one row per beat, holding its time in seconds
+    - `tempo`: a single row, holding the tempo in beats per minute and its
+      confidence
+    - `notes`: one row per note, holding its midi value, velocity, start and
+      end time in seconds
+    - `pitch`: one row per hop, holding its time in seconds, the fundamental
+      frequency in Hz, and its confidence
+
+  \example utils/test-batch.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** batch analysis object */
+typedef struct _aubio_batch_t aubio_batch_t;
+
+/** function called with the results of each file
+
+  \param data user data, as passed to ::aubio_batch_run
+  \param index index of the file in the list passed to ::aubio_batch_run
+  \param uri path of the file
+  \param results one row per event, or NULL if the file could not be
+  analysed; `results->height` is 0 if no event was found
+
+*/
+typedef void (*aubio_batch_callback_t)(void *data, uint_t index,
+    const char_t *uri, const fmat_t *results);
+
+/** create batch analysis object
+
+  \param analysis analysis to run on each file, `onset`, `beat`, `tempo`,
+  `notes` or `pitch`
+  \param method method of the analysis, for instance `hfc` for `onset` or
+  `yinfft` for `pitch`, or `default`
+  \param buf_size buffer size of the analysis
+  \param hop_size hop size of the analysis
+  \param samplerate samplerate to read the files at, or 0 to read each file
+  at its own samplerate
+
+  \return newly created ::aubio_batch_t, or NULL if `analysis` is unknown
+
+*/
+aubio_batch_t *new_aubio_batch (const char_t *analysis, const char_t *method,
+    uint_t buf_size, uint_t hop_size, uint_t samplerate);
+
+/** set number of threads
+
+  \param o batch object, created by ::new_aubio_batch
+  \param threads number of threads, or 0 for aubio_threads_get_pool_size()
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_batch_set_threads (aubio_batch_t *o, uint_t threads);
+
+/** get number of threads
+
+  \param o batch object, created by ::new_aubio_batch
+
+  \return number of threads used by ::aubio_batch_run
+
+*/
+uint_t aubio_batch_get_threads (const aubio_batch_t *o);
+
+/** set threshold of the analysis
+
+  \param o batch object, created by ::new_aubio_batch
+  \param threshold peak-picking threshold for `onset`, `beat` and `tempo`,
+  or tolerance for `pitch`
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_batch_set_threshold (aubio_batch_t *o, smpl_t threshold);
+
+/** set silence threshold of the analysis
+
+  \param o batch object, created by ::new_aubio_batch
+  \param silence silence threshold, in dB
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_batch_set_silence (aubio_batch_t *o, smpl_t silence);
+
+/** set directory to cache the results in
+
+  \param o batch object, created by ::new_aubio_batch
+  \param path existing directory, or NULL to disable the cache
+
+  \return 0 if successful, non-zero otherwise
+
+  The results of each file are stored in `path`, under a hash of the content
+  of the file and of the parameters of the analysis. A file analysed again
+  with the same parameters, even after being copied or renamed, is then read
+  from the cache instead of being decoded and analysed. The file is still
+  read once to compute its hash.
+
+  Cache directories are only supported on POSIX platforms.
+
+*/
+uint_t aubio_batch_set_cache (aubio_batch_t *o, const char_t *path);
+
+/** analyse a list of files
+
+  \param o batch object, created by ::new_aubio_batch
+  \param uris paths of the files to analyse
+  \param n_uris number of files in `uris`
+  \param callback function called with the results of each file
+  \param data user data passed to `callback`
+
+  \return number of files that could not be analysed
+
+  This function returns once all the files were analysed.
+
+*/
+uint_t aubio_batch_run (aubio_batch_t *o, const char_t **uris, uint_t n_uris,
+    aubio_batch_callback_t callback, void *data);
+
+/** delete batch analysis object
+
+  \param o batch object, created by ::new_aubio_batch
+
+*/
+void del_aubio_batch (aubio_batch_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_BATCH_H */
@@ -0,0 +1,62 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "utils/denormal_priv.h"
+
+uint_t aubio_denormal_mode = AUBIO_DENORMAL_SOFTWARE;
+
+uint_t aubio_set_denormal_mode (uint_t mode)
+{
+  if (mode != AUBIO_DENORMAL_SOFTWARE && mode != AUBIO_DENORMAL_FLUSH) {
+    AUBIO_ERR("denormal: unknown mode %d\n", mode);
+    return AUBIO_FAIL;
+  }
+#ifndef AUBIO_DENORMAL_HW
+  // without the flags, skipping the per-sample checks would not be safe
+  if (mode == AUBIO_DENORMAL_FLUSH) {
+    AUBIO_ERR("denormal: no flush-to-zero flags on this platform\n");
+    return AUBIO_FAIL;
+  }
+#endif
+  aubio_denormal_mode = mode;
+  return AUBIO_OK;
+}
+
+uint_t aubio_get_denormal_mode (void)
+{
+  return aubio_denormal_mode;
+}
+
+uint_t aubio_denormal_flush_thread (uint_t enable)
+{
+#ifdef AUBIO_DENORMAL_HW
+  uint_t csr = aubio_denormal_get_csr ();
+  aubio_denormal_set_csr (enable ? csr | AUBIO_DENORMAL_BITS
+      : csr & ~AUBIO_DENORMAL_BITS);
+  return AUBIO_OK;
+#else
+  if (enable) {
+    AUBIO_ERR("denormal: no flush-to-zero flags on this platform\n");
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+#endif
+}
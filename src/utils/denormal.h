@@ -0,0 +1,102 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_DENORMAL_H
+#define AUBIO_DENORMAL_H
+
+/** \file
+
+  Handling of denormal numbers
+
+  The state of recursive filters, and of the other objects smoothing their
+  input over time, decays towards zero during silence, until it reaches
+  denormal numbers. On most processors, each operation on a denormal is
+  many times slower than on a normal number.
+
+  By default, aubio leaves the floating point environment of the calling
+  thread untouched, and the recursive filters flush tiny input samples to
+  zero, one sample at a time.
+
+  In the ::AUBIO_DENORMAL_FLUSH mode, the processing functions of these
+  objects, such as ::aubio_filter_do, ::aubio_filterbank_iir_do,
+  ::aubio_spectral_whitening_do, ::aubio_tss_do and ::aubio_beattracking_do,
+  instead set the flush-to-zero and denormals-are-zero flags of the calling
+  thread (MXCSR on x86, FPCR or FPSCR on ARM) for the duration of the call,
+  and skip the per-sample checks. The flags of the thread are restored before
+  returning, so that the code of the caller is not affected.
+
+  A thread running only analysis code can also keep the flags set for its
+  whole life with ::aubio_denormal_flush_thread, in which case the objects
+  find them already set and do not touch them.
+
+  \example utils/test-denormal.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** modes of ::aubio_set_denormal_mode */
+enum {
+  AUBIO_DENORMAL_SOFTWARE = 0, /**< flush tiny inputs in software (default) */
+  AUBIO_DENORMAL_FLUSH = 1,    /**< set the flush-to-zero flags in `_do` */
+};
+
+/** select how denormal numbers are avoided
+
+  \param mode ::AUBIO_DENORMAL_SOFTWARE or ::AUBIO_DENORMAL_FLUSH
+
+  \return 0 if successful, 1 if the mode is unknown, or if the processor or
+  compiler has no flush-to-zero flags, in which case the mode is unchanged
+
+  The setting applies to all the threads, from the next call to a
+  processing function.
+
+*/
+uint_t aubio_set_denormal_mode (uint_t mode);
+
+/** get the current denormal mode
+
+  \return ::AUBIO_DENORMAL_SOFTWARE or ::AUBIO_DENORMAL_FLUSH
+
+*/
+uint_t aubio_get_denormal_mode (void);
+
+/** set or clear the flush-to-zero flags of the calling thread
+
+  \param enable 1 to flush denormals to zero in the calling thread until
+  this function is called again with 0, 0 to clear the flags
+
+  \return 0 if successful, 1 if the processor or compiler has no
+  flush-to-zero flags
+
+  The flags apply to all the floating point code run by the thread,
+  including the code of the caller, and are not inherited by threads it
+  creates.
+
+*/
+uint_t aubio_denormal_flush_thread (uint_t enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_DENORMAL_H */
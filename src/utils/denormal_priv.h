@@ -0,0 +1,127 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Guards setting the flush-to-zero flags around the processing functions,
+   see utils/denormal.h.
+
+   aubio_denormal_enter() is called on entry to the `_do` function, and
+   aubio_denormal_leave() before each of its returns:
+
+     aubio_denormal_guard_t guard;
+     aubio_denormal_enter (&guard);
+     ... if guard.flush is set, the per-sample checks can be skipped ...
+     aubio_denormal_leave (&guard);
+
+   In the default mode, the guard costs one load of a global. Otherwise, the
+   control register is read once, and only written when the flags are not
+   already set. */
+
+#ifndef AUBIO_DENORMAL_PRIV_H
+#define AUBIO_DENORMAL_PRIV_H
+
+#include "utils/denormal.h"
+
+/* emscripten emulates the SSE intrinsics, but has no control register */
+#if (defined(__SSE__) || defined(_M_X64) \
+  || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)) && !defined(__EMSCRIPTEN__)
+#include <xmmintrin.h>
+#define AUBIO_DENORMAL_HW 1
+#if defined(__x86_64__) || defined(_M_X64)
+/* FTZ and DAZ; the first SSE processors lacked DAZ, all x86_64 have it */
+#define AUBIO_DENORMAL_BITS 0x8040u
+#else
+#define AUBIO_DENORMAL_BITS 0x8000u
+#endif
+#define aubio_denormal_get_csr() ((uint_t)_mm_getcsr ())
+#define aubio_denormal_set_csr(c) _mm_setcsr ((unsigned int)(c))
+
+#elif defined(__aarch64__) && defined(__GNUC__)
+#define AUBIO_DENORMAL_HW 1
+/* FZ flag of FPCR, flushing both the inputs and the results */
+#define AUBIO_DENORMAL_BITS (1u << 24)
+static inline uint_t aubio_denormal_get_csr (void)
+{
+  unsigned long c;
+  __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (c));
+  return (uint_t) c;
+}
+static inline void aubio_denormal_set_csr (uint_t c)
+{
+  unsigned long v = c;
+  __asm__ __volatile__ ("msr fpcr, %0" : : "r" (v));
+}
+
+#elif defined(__arm__) && defined(__ARM_FP) && defined(__GNUC__)
+#define AUBIO_DENORMAL_HW 1
+/* FZ flag of FPSCR */
+#define AUBIO_DENORMAL_BITS (1u << 24)
+static inline uint_t aubio_denormal_get_csr (void)
+{
+  unsigned int c;
+  __asm__ __volatile__ ("vmrs %0, fpscr" : "=r" (c));
+  return c;
+}
+static inline void aubio_denormal_set_csr (uint_t c)
+{
+  unsigned int v = c;
+  __asm__ __volatile__ ("vmsr fpscr, %0" : : "r" (v));
+}
+#endif
+
+/** current mode, see aubio_set_denormal_mode() */
+extern uint_t aubio_denormal_mode;
+
+typedef struct {
+  uint_t flush;    /**< 1 if the flags are set until aubio_denormal_leave() */
+  uint_t saved;    /**< flags to restore, if changed */
+  uint_t changed;  /**< 1 if aubio_denormal_enter() set the flags */
+} aubio_denormal_guard_t;
+
+static inline void aubio_denormal_enter (aubio_denormal_guard_t *g)
+{
+  g->flush = 0;
+  g->changed = 0;
+#ifdef AUBIO_DENORMAL_HW
+  if (aubio_denormal_mode == AUBIO_DENORMAL_FLUSH) {
+    uint_t csr = aubio_denormal_get_csr ();
+    g->saved = csr & AUBIO_DENORMAL_BITS;
+    if (g->saved != AUBIO_DENORMAL_BITS) {
+      aubio_denormal_set_csr (csr | AUBIO_DENORMAL_BITS);
+      g->changed = 1;
+    }
+    g->flush = 1;
+  }
+#endif
+}
+
+static inline void aubio_denormal_leave (const aubio_denormal_guard_t *g)
+{
+#ifdef AUBIO_DENORMAL_HW
+  if (g->changed) {
+    /* only restore the flags, keeping the exceptions raised meanwhile */
+    aubio_denormal_set_csr ((aubio_denormal_get_csr () & ~AUBIO_DENORMAL_BITS)
+        | g->saved);
+  }
+#else
+  (void) g;
+#endif
+}
+
+#endif /* AUBIO_DENORMAL_PRIV_H */
@@ -0,0 +1,98 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "utils/events.h"
+#include "utils/atomic_priv.h"
+
+/* The difference of the two counters, which may wrap around, is the number
+   of events in the queue. Each side keeps its own position in the ring. The
+   producer only writes `written`, the consumer only writes `read`; the
+   release stores publish the slots they are done with to the other one. */
+struct _aubio_events_t {
+  uint_t capacity;
+  aubio_event_t *slots;
+  uint_t written;               /**< events pushed, by the producer */
+  uint_t read;                  /**< events drained, by the consumer */
+  uint_t dropped;               /**< events dropped, by the producer */
+  uint_t write_pos;             /**< next slot to fill, producer only */
+  uint_t read_pos;              /**< next slot to read, consumer only */
+};
+
+aubio_events_t *new_aubio_events (uint_t capacity)
+{
+  aubio_events_t *o;
+  if ((sint_t)capacity < 1) {
+    AUBIO_ERR("events: got capacity %d, expected > 0\n", capacity);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_events_t);
+  if (!o) return NULL;
+  o->capacity = capacity;
+  o->slots = AUBIO_ARRAY(aubio_event_t, capacity);
+  if (!o->slots) {
+    del_aubio_events(o);
+    return NULL;
+  }
+  return o;
+}
+
+uint_t aubio_events_push (aubio_events_t *o, const aubio_event_t *event)
+{
+  uint_t written = o->written;
+  if (written - AUBIO_ATOMIC_LOAD(o->read) >= o->capacity) {
+    AUBIO_ATOMIC_STORE(o->dropped, o->dropped + 1);
+    return AUBIO_FAIL;
+  }
+  o->slots[o->write_pos] = *event;
+  o->write_pos = (o->write_pos + 1) % o->capacity;
+  AUBIO_ATOMIC_STORE(o->written, written + 1);
+  return AUBIO_OK;
+}
+
+uint_t aubio_events_drain (aubio_events_t *o, aubio_event_t *events,
+    uint_t max)
+{
+  uint_t read = o->read, n = AUBIO_ATOMIC_LOAD(o->written) - read, i;
+  n = MIN(n, max);
+  for (i = 0; i < n; i++) {
+    events[i] = o->slots[o->read_pos];
+    o->read_pos = (o->read_pos + 1) % o->capacity;
+  }
+  AUBIO_ATOMIC_STORE(o->read, read + n);
+  return n;
+}
+
+uint_t aubio_events_get_count (const aubio_events_t *o)
+{
+  return AUBIO_ATOMIC_LOAD(o->written) - AUBIO_ATOMIC_LOAD(o->read);
+}
+
+uint_t aubio_events_get_dropped (const aubio_events_t *o)
+{
+  return AUBIO_ATOMIC_LOAD(o->dropped);
+}
+
+void del_aubio_events (aubio_events_t *o)
+{
+  if (o->slots)
+    AUBIO_FREE(o->slots);
+  AUBIO_FREE(o);
+}
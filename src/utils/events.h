@@ -0,0 +1,149 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_EVENTS_H
+#define AUBIO_EVENTS_H
+
+/** \file
+
+  Queue of detected events
+
+  Instead of checking the output of aubio_onset_do() or aubio_tempo_do()
+  after each hop, a client can attach a queue to the detectors, with
+  aubio_onset_set_events() and aubio_tempo_set_events(). Each onset or beat
+  found is then pushed to the queue, and the client reads all the events of
+  many hops at once:
+
+  \code
+  aubio_events_t *events = new_aubio_events (256);
+  aubio_event_t batch[64];
+  uint_t i, n;
+  aubio_onset_set_events (onset, events);
+  aubio_tempo_set_events (tempo, events);
+  // process a block of several hops
+  aubio_onset_do_block (onset, block);
+  aubio_tempo_do_block (tempo, block);
+  while ((n = aubio_events_drain (events, batch, 64)) > 0) {
+    for (i = 0; i < n; i++) {
+      // batch[i].type, batch[i].position, batch[i].strength
+    }
+  }
+  \endcode
+
+  The queue is allocated once, and pushing an event never allocates memory
+  nor blocks. Events pushed while the queue is full are dropped and counted.
+  The queue is lock-free: the detectors and the client may run in two
+  different threads, as long as all the detectors sharing a queue run in the
+  same one.
+
+  \example utils/test-events.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** kinds of events */
+typedef enum {
+  aubio_event_onset = 0,   /**< onset, from ::aubio_onset_t */
+  aubio_event_beat = 1     /**< beat, from ::aubio_tempo_t */
+} aubio_event_type_t;
+
+/** detected event */
+typedef struct {
+  uint_t type;             /**< kind of event, see ::aubio_event_type_t */
+  uint_t channel;          /**< channel, with aubio_onset_do_multi() or
+                             aubio_tempo_do_multi(), 0 otherwise */
+  u64_t position;          /**< time of the event, in samples since the
+                             start of the stream, delay removed */
+  smpl_t strength;         /**< value of the onset descriptor, or
+                             confidence of the beat tracker */
+} aubio_event_t;
+
+/** event queue object */
+typedef struct _aubio_events_t aubio_events_t;
+
+/** create event queue
+
+  \param capacity largest number of events waiting to be read
+
+  \return newly created ::aubio_events_t, or NULL on failure
+
+*/
+aubio_events_t *new_aubio_events (uint_t capacity);
+
+/** push an event
+
+  \param o event queue, created by ::new_aubio_events
+  \param event event to copy into the queue
+
+  \return 0 if the event was queued, non-zero if the queue was full
+
+  This function is called by the detectors. Custom events may be pushed
+  too, from the thread running them.
+
+*/
+uint_t aubio_events_push (aubio_events_t *o, const aubio_event_t *event);
+
+/** read the oldest events
+
+  \param o event queue, created by ::new_aubio_events
+  \param events array receiving up to `max` events, oldest first
+  \param max size of `events`
+
+  \return number of events copied to `events` and removed from the queue
+
+*/
+uint_t aubio_events_drain (aubio_events_t *o, aubio_event_t *events,
+    uint_t max);
+
+/** get number of events waiting to be read
+
+  \param o event queue, created by ::new_aubio_events
+
+  \return number of events in the queue
+
+*/
+uint_t aubio_events_get_count (const aubio_events_t *o);
+
+/** get number of events dropped because the queue was full
+
+  \param o event queue, created by ::new_aubio_events
+
+  \return number of events dropped since the creation of the queue
+
+*/
+uint_t aubio_events_get_dropped (const aubio_events_t *o);
+
+/** delete event queue
+
+  \param o event queue, created by ::new_aubio_events
+
+  The detectors using the queue should be detached or deleted first.
+
+*/
+void del_aubio_events (aubio_events_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_EVENTS_H */
@@ -0,0 +1,151 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "utils/framerate.h"
+
+typedef enum {
+  aubio_framerate_mean,
+  aubio_framerate_max,
+} aubio_framerate_method_t;
+
+struct _aubio_framerate_t {
+  aubio_framerate_method_t method;
+  uint_t size;
+  uint_t hop_size;
+  uint_t samplerate;
+  smpl_t rate;
+  fvec_t *pool;                 /**< sum or maximum of the frames so far */
+  uint_t n_pooled;              /**< number of frames in pool */
+  lsmp_t phase;                 /**< rate * samples since the last tick */
+  uint_t ready;                 /**< whether the last call wrote a frame */
+};
+
+aubio_framerate_t *new_aubio_framerate (const char_t *method, uint_t size,
+    uint_t hop_size, uint_t samplerate, smpl_t rate)
+{
+  aubio_framerate_t *o = AUBIO_NEW(aubio_framerate_t);
+  if (!o) return NULL;
+  if ((sint_t)size < 1) {
+    AUBIO_ERR("framerate: got size %d, expected > 0\n", size);
+    goto beach;
+  }
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR("framerate: got hop_size %d, expected > 0\n", hop_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 1) {
+    AUBIO_ERR("framerate: got samplerate %d, expected > 0\n", samplerate);
+    goto beach;
+  }
+  if (method == NULL || strcmp(method, "default") == 0
+      || strcmp(method, "mean") == 0) {
+    o->method = aubio_framerate_mean;
+  } else if (strcmp(method, "max") == 0) {
+    o->method = aubio_framerate_max;
+  } else {
+    AUBIO_ERR("framerate: unknown method %s\n", method);
+    goto beach;
+  }
+  o->size = size;
+  o->hop_size = hop_size;
+  o->samplerate = samplerate;
+  if (aubio_framerate_set_rate(o, rate)) goto beach;
+  o->pool = new_fvec(size);
+  if (!o->pool) goto beach;
+  return o;
+
+beach:
+  del_aubio_framerate(o);
+  return NULL;
+}
+
+uint_t aubio_framerate_do (aubio_framerate_t *o, const fvec_t *input,
+    fvec_t *output)
+{
+  uint_t j;
+  if (o->n_pooled == 0) {
+    fvec_copy(input, o->pool);
+  } else if (o->method == aubio_framerate_max) {
+    for (j = 0; j < o->size; j++) {
+      o->pool->data[j] = MAX(o->pool->data[j], input->data[j]);
+    }
+  } else {
+    for (j = 0; j < o->size; j++) {
+      o->pool->data[j] += input->data[j];
+    }
+  }
+  o->n_pooled++;
+  // one tick every samplerate / rate samples, without accumulating the error
+  o->phase += (lsmp_t)o->rate * o->hop_size;
+  o->ready = o->phase >= o->samplerate;
+  if (!o->ready) return 0;
+  o->phase -= o->samplerate;
+  if (o->method == aubio_framerate_mean) {
+    for (j = 0; j < o->size; j++) {
+      output->data[j] = o->pool->data[j] / o->n_pooled;
+    }
+  } else {
+    fvec_copy(o->pool, output);
+  }
+  o->n_pooled = 0;
+  return 1;
+}
+
+uint_t aubio_framerate_get_ready (const aubio_framerate_t *o)
+{
+  return o->ready;
+}
+
+uint_t aubio_framerate_set_rate (aubio_framerate_t *o, smpl_t rate)
+{
+  if (!(rate > 0) || rate * o->hop_size > o->samplerate) {
+    AUBIO_ERR("framerate: got rate %f, expected > 0 and <= %f\n", rate,
+        o->samplerate / (smpl_t)o->hop_size);
+    return AUBIO_FAIL;
+  }
+  o->rate = rate;
+  return AUBIO_OK;
+}
+
+smpl_t aubio_framerate_get_rate (const aubio_framerate_t *o)
+{
+  return o->rate;
+}
+
+void aubio_framerate_reset (aubio_framerate_t *o)
+{
+  o->n_pooled = 0;
+  o->phase = 0.;
+  o->ready = 0;
+}
+
+void del_aubio_framerate (aubio_framerate_t *o)
+{
+  AUBIO_ASSERT(o);
+  if (o->pool) del_fvec(o->pool);
+  AUBIO_FREE(o);
+}
+
+uint_t aubio_framerate_get_memory_usage (const aubio_framerate_t *o)
+{
+  return aubio_malloc_size(o) + aubio_malloc_size(o->pool);
+}
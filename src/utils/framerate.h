@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_FRAMERATE_H
+#define AUBIO_FRAMERATE_H
+
+/** \file
+
+  Pool the features of consecutive hops to a lower frame rate
+
+  Features such as the energies of ::aubio_filterbank_t or the coefficients
+  of ::aubio_mfcc_t are computed once per hop, for instance about 172 times
+  per second with hops of 256 samples at 44100 Hz, while a display may only
+  need them 60 times per second. This object pools the frames of the hops,
+  taking their mean or their maximum, and outputs a frame at the chosen rate:
+
+  \code
+  aubio_filterbank_do (fb, spectrum, energies);
+  if (aubio_framerate_do (rate, energies, frame)) {
+    // a new frame is ready, at most 60 times per second
+  }
+  \endcode
+
+  The frames are output at the hop following each tick of the chosen rate,
+  so that their rate is exact on average, with a jitter of one hop.
+
+  \example utils/test-framerate.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** frame rate object */
+typedef struct _aubio_framerate_t aubio_framerate_t;
+
+/** create frame rate object
+
+  \param method pooling of the frames, `mean` (or `default`) or `max`
+  \param size length of the frames
+  \param hop_size number of samples between consecutive input frames
+  \param samplerate sampling rate of the signal
+  \param rate number of output frames per second, at most
+  `samplerate / hop_size`
+
+  \return newly created ::aubio_framerate_t, or NULL on failure
+
+*/
+aubio_framerate_t *new_aubio_framerate (const char_t *method, uint_t size,
+    uint_t hop_size, uint_t samplerate, smpl_t rate);
+
+/** pool a frame
+
+  \param o frame rate object, created by ::new_aubio_framerate
+  \param input frame of a hop, of length `size`
+  \param output frame of length `size`, written when a new frame is ready,
+  and left unchanged otherwise
+
+  \return 1 when `output` was written, 0 otherwise
+
+*/
+uint_t aubio_framerate_do (aubio_framerate_t *o, const fvec_t *input,
+    fvec_t *output);
+
+/** check whether the last call output a frame
+
+  \param o frame rate object, created by ::new_aubio_framerate
+
+  \return 1 when the last call to ::aubio_framerate_do wrote its output,
+  0 otherwise
+
+*/
+uint_t aubio_framerate_get_ready (const aubio_framerate_t *o);
+
+/** set output frame rate
+
+  \param o frame rate object, created by ::new_aubio_framerate
+  \param rate number of output frames per second, at most
+  `samplerate / hop_size`
+
+  \return 0 if successful, non-zero otherwise
+
+  The frames pooled so far are kept, and output at the next tick.
+
+*/
+uint_t aubio_framerate_set_rate (aubio_framerate_t *o, smpl_t rate);
+
+/** get output frame rate
+
+  \param o frame rate object, created by ::new_aubio_framerate
+
+  \return number of output frames per second
+
+*/
+smpl_t aubio_framerate_get_rate (const aubio_framerate_t *o);
+
+/** drop the frames pooled so far
+
+  \param o frame rate object, created by ::new_aubio_framerate
+
+*/
+void aubio_framerate_reset (aubio_framerate_t *o);
+
+/** get the memory used by a frame rate object
+
+  \param o frame rate object, created by ::new_aubio_framerate
+
+  \return number of bytes allocated by the object and the objects it owns,
+  see utils/allocator.h
+
+*/
+uint_t aubio_framerate_get_memory_usage (const aubio_framerate_t *o);
+
+/** delete frame rate object
+
+  \param o frame rate object, created by ::new_aubio_framerate
+
+*/
+void del_aubio_framerate (aubio_framerate_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_FRAMERATE_H */
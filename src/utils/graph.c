@@ -0,0 +1,521 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "musicutils.h"
+#include "io/source.h"
+#include "spectral/gpu.h"
+#include "spectral/phasevoc.h"
+#include "spectral/filterbank.h"
+#include "spectral/filterbank_mel.h"
+#include "spectral/mfcc.h"
+#include "spectral/specdesc.h"
+#include "utils/events.h"
+#include "utils/allocator.h"
+#include "onset/onset.h"
+#include "tempo/tempo.h"
+#include "pitch/pitch.h"
+#include "utils/graph.h"
+#include "io/iothread_priv.h"
+
+#define AUBIO_GRAPH_MELBANDS 40
+#define AUBIO_GRAPH_MFCC 13
+
+typedef enum {
+  aubio_graph_level,
+  aubio_graph_onset,
+  aubio_graph_tempo,
+  aubio_graph_pitch,
+  aubio_graph_melbands,
+  aubio_graph_mfcc,
+} aubio_graph_kind_t;
+
+/* a phase vocoder, shared by all the outputs of the same buffer size */
+typedef struct {
+  uint_t buf_size;
+  aubio_pvoc_t *pv;
+  cvec_t *grain;
+} aubio_graph_spectrum_t;
+
+typedef struct {
+  aubio_graph_kind_t kind;
+  void *object;                 /**< onset, tempo, pitch, filterbank or mfcc */
+  sint_t spectrum;              /**< index in spectra, or -1 if none is read */
+  fvec_t *out;
+} aubio_graph_node_t;
+
+typedef struct {
+  aubio_graph_t *graph;
+  uint_t index;                 /**< from 1 to threads - 1, 0 being the caller */
+  uint_t running;               /**< 1 if the thread was started */
+  aubio_io_thread_t thread;
+} aubio_graph_worker_t;
+
+struct _aubio_graph_t {
+  uint_t hop_size;
+  uint_t samplerate;
+  aubio_graph_spectrum_t *spectra;
+  uint_t n_spectra;
+  aubio_graph_node_t *nodes;
+  uint_t n_nodes;
+  aubio_frame_stats_t stats;    /**< level of the current hop */
+  uint_t started;               /**< 1 once aubio_graph_do was called */
+  const fvec_t *input;          /**< current hop, during aubio_graph_do */
+  uint_t stage;                 /**< 0 for the spectra, 1 for the outputs */
+  uint_t threads;
+  aubio_graph_worker_t *workers; /**< threads - 1 workers */
+  /* stages given to the workers, protected by mutex */
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  uint_t job;                   /**< incremented for each new stage */
+  uint_t pending;               /**< number of workers still running it */
+  uint_t quit;                  /**< 1 to stop the workers */
+};
+
+static void aubio_graph_del_workers (aubio_graph_t *g);
+
+aubio_graph_t *new_aubio_graph (uint_t hop_size, uint_t samplerate)
+{
+  aubio_graph_t *g;
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR ("graph: got hop_size %d, but can not be < 1\n", hop_size);
+    return NULL;
+  }
+  if ((sint_t)samplerate < 1) {
+    AUBIO_ERR ("graph: got samplerate %d, but can not be < 1\n", samplerate);
+    return NULL;
+  }
+  g = AUBIO_NEW (aubio_graph_t);
+  if (!g) return NULL;
+  g->hop_size = hop_size;
+  g->samplerate = samplerate;
+  g->threads = 1;
+  return g;
+}
+
+/* 1 if the spectral description method reads the phase of the spectrum */
+static uint_t aubio_graph_uses_phase (const char_t *method, uint_t buf_size)
+{
+  aubio_specdesc_t *od = new_aubio_specdesc (method, buf_size);
+  uint_t uses_phase = od ? aubio_specdesc_uses_phase (od) : 1;
+  if (od) del_aubio_specdesc (od);
+  return uses_phase;
+}
+
+/* index of the spectrum of buf_size, created if needed, or -1 on failure */
+static sint_t aubio_graph_get_spectrum (aubio_graph_t *g, uint_t buf_size,
+    uint_t uses_phase)
+{
+  aubio_graph_spectrum_t *spectra, *s;
+  uint_t i;
+  for (i = 0; i < g->n_spectra; i++) {
+    if (g->spectra[i].buf_size == buf_size) {
+      if (uses_phase) aubio_pvoc_set_magnitude_only (g->spectra[i].pv, 0);
+      return i;
+    }
+  }
+  spectra = (aubio_graph_spectrum_t *)AUBIO_REALLOC (g->spectra,
+      (g->n_spectra + 1) * sizeof (aubio_graph_spectrum_t));
+  if (!spectra) return -1;
+  g->spectra = spectra;
+  s = &g->spectra[g->n_spectra];
+  s->buf_size = buf_size;
+  s->pv = new_aubio_pvoc (buf_size, g->hop_size);
+  s->grain = new_cvec (buf_size);
+  if (!s->pv || !s->grain) {
+    if (s->pv) del_aubio_pvoc (s->pv);
+    if (s->grain) del_cvec (s->grain);
+    return -1;
+  }
+  // the phase is only computed once an output reads it
+  aubio_pvoc_set_magnitude_only (s->pv, !uses_phase);
+  return g->n_spectra++;
+}
+
+static void aubio_graph_del_node (aubio_graph_node_t *n)
+{
+  if (n->object) {
+    switch (n->kind) {
+      case aubio_graph_onset:
+        del_aubio_onset ((aubio_onset_t *)n->object);
+        break;
+      case aubio_graph_tempo:
+        del_aubio_tempo ((aubio_tempo_t *)n->object);
+        break;
+      case aubio_graph_pitch:
+        del_aubio_pitch ((aubio_pitch_t *)n->object);
+        break;
+      case aubio_graph_melbands:
+        del_aubio_filterbank ((aubio_filterbank_t *)n->object);
+        break;
+      case aubio_graph_mfcc:
+        del_aubio_mfcc ((aubio_mfcc_t *)n->object);
+        break;
+      default:
+        break;
+    }
+  }
+  if (n->out) del_fvec (n->out);
+}
+
+static sint_t aubio_graph_create_node (aubio_graph_t *g,
+    const char_t *output, const char_t *method, uint_t buf_size)
+{
+  aubio_graph_node_t node, *nodes;
+  uint_t length = 0, uses_spectrum = 1, uses_phase = 0;
+  if (g->started) {
+    AUBIO_ERR ("graph: outputs can not be added once the analysis started\n");
+    return -1;
+  }
+  if (!method) method = "default";
+  AUBIO_MEMSET (&node, 0, sizeof (node));
+  node.spectrum = -1;
+  if (strcmp (output, "level") == 0) {
+    node.kind = aubio_graph_level;
+    length = 4;
+    uses_spectrum = 0;
+  } else if (strcmp (output, "onset") == 0) {
+    node.kind = aubio_graph_onset;
+    node.object = new_aubio_onset (method, buf_size, g->hop_size,
+        g->samplerate);
+    length = 2;
+    uses_phase = node.object && aubio_graph_uses_phase (
+        strcmp (method, "default") ? method : "hfc", buf_size);
+  } else if (strcmp (output, "tempo") == 0) {
+    node.kind = aubio_graph_tempo;
+    node.object = new_aubio_tempo (method, buf_size, g->hop_size,
+        g->samplerate);
+    length = 3;
+    // the envelope mode filters the samples, without reading a spectrum
+    uses_spectrum = strcmp (method, "envelope") != 0;
+    uses_phase = node.object && uses_spectrum && aubio_graph_uses_phase (
+        strcmp (method, "default") ? method : "specflux", buf_size);
+  } else if (strcmp (output, "pitch") == 0) {
+    node.kind = aubio_graph_pitch;
+    node.object = new_aubio_pitch (method, buf_size, g->hop_size,
+        g->samplerate);
+    length = 2;
+    // only these methods read the spectrum given to aubio_pitch_do_spectrum
+    uses_phase = strcmp (method, "mcomb") == 0
+      || strcmp (method, "fcomb") == 0;
+    uses_spectrum = uses_phase || strcmp (method, "yinfft") == 0
+      || strcmp (method, "default") == 0;
+    if (node.object) aubio_pitch_set_unit (node.object, "Hz");
+  } else if (strcmp (output, "melbands") == 0
+      || strcmp (output, "mfcc") == 0) {
+    if (strcmp (method, "default") != 0) {
+      AUBIO_ERR ("graph: unknown method %s for %s\n", method, output);
+      return -1;
+    }
+    if (strcmp (output, "melbands") == 0) {
+      node.kind = aubio_graph_melbands;
+      node.object = new_aubio_filterbank (AUBIO_GRAPH_MELBANDS, buf_size);
+      if (node.object && aubio_filterbank_set_mel_coeffs_slaney (node.object,
+            g->samplerate) != AUBIO_OK) {
+        aubio_graph_del_node (&node);
+        node.object = NULL;
+      }
+      length = AUBIO_GRAPH_MELBANDS;
+    } else {
+      node.kind = aubio_graph_mfcc;
+      node.object = new_aubio_mfcc (buf_size, AUBIO_GRAPH_MELBANDS,
+          AUBIO_GRAPH_MFCC, g->samplerate);
+      length = AUBIO_GRAPH_MFCC;
+    }
+  } else {
+    AUBIO_ERR ("graph: unknown output %s\n", output);
+    return -1;
+  }
+  if (node.kind != aubio_graph_level && !node.object) {
+    AUBIO_ERR ("graph: failed creating %s with method %s and buffer size"
+        " %d\n", output, method, buf_size);
+    return -1;
+  }
+  node.out = new_fvec (length);
+  if (uses_spectrum) {
+    node.spectrum = aubio_graph_get_spectrum (g, buf_size, uses_phase);
+  }
+  nodes = (aubio_graph_node_t *)AUBIO_REALLOC (g->nodes,
+      (g->n_nodes + 1) * sizeof (aubio_graph_node_t));
+  if (!node.out || (uses_spectrum && node.spectrum < 0) || !nodes) {
+    if (nodes) g->nodes = nodes;
+    aubio_graph_del_node (&node);
+    return -1;
+  }
+  g->nodes = nodes;
+  g->nodes[g->n_nodes] = node;
+  return g->n_nodes++;
+}
+
+sint_t aubio_graph_add (aubio_graph_t *g, const char_t *output,
+    const char_t *method, uint_t buf_size)
+{
+  // the nodes may run on several threads at once, so they can not share the
+  // scratch buffers of a workspace
+  aubio_workspace_t *workspace = aubio_set_workspace (NULL);
+  sint_t index = aubio_graph_create_node (g, output, method, buf_size);
+  aubio_set_workspace (workspace);
+  return index;
+}
+
+uint_t aubio_graph_get_n_outputs (const aubio_graph_t *g)
+{
+  return g->n_nodes;
+}
+
+uint_t aubio_graph_get_n_spectra (const aubio_graph_t *g)
+{
+  return g->n_spectra;
+}
+
+static void aubio_graph_do_node (aubio_graph_t *g, aubio_graph_node_t *n)
+{
+  const fvec_t *input = g->input;
+  const cvec_t *grain = n->spectrum >= 0 ? g->spectra[n->spectrum].grain
+    : NULL;
+  fvec_t first;
+  fvec_view (&first, n->out, 0, 1);
+  switch (n->kind) {
+    case aubio_graph_level:
+      n->out->data[0] = g->stats.db_spl;
+      n->out->data[1] = g->stats.rms;
+      n->out->data[2] = g->stats.peak;
+      n->out->data[3] = g->stats.zcr;
+      break;
+    case aubio_graph_onset:
+      aubio_onset_do_spectrum_stats ((aubio_onset_t *)n->object, input, grain,
+          &g->stats, &first);
+      n->out->data[1] = aubio_onset_get_descriptor (n->object);
+      break;
+    case aubio_graph_tempo:
+      if (grain) {
+        aubio_tempo_do_spectrum_stats ((aubio_tempo_t *)n->object, input,
+            grain, &g->stats, &first);
+      } else {
+        aubio_tempo_do_stats ((aubio_tempo_t *)n->object, input, &g->stats,
+            &first);
+      }
+      n->out->data[1] = aubio_tempo_get_bpm (n->object);
+      n->out->data[2] = aubio_tempo_get_confidence (n->object);
+      break;
+    case aubio_graph_pitch:
+      if (grain) {
+        aubio_pitch_do_spectrum_stats ((aubio_pitch_t *)n->object, input,
+            grain, &g->stats, &first);
+      } else {
+        aubio_pitch_do_stats ((aubio_pitch_t *)n->object, input, &g->stats,
+            &first);
+      }
+      n->out->data[1] = aubio_pitch_get_confidence (n->object);
+      break;
+    case aubio_graph_melbands:
+      aubio_filterbank_do ((aubio_filterbank_t *)n->object, grain, n->out);
+      break;
+    case aubio_graph_mfcc:
+      aubio_mfcc_do ((aubio_mfcc_t *)n->object, grain, n->out);
+      break;
+  }
+}
+
+/* the items of the current stage, spread over the threads */
+static void aubio_graph_do_share (aubio_graph_t *g, uint_t index)
+{
+  uint_t i;
+  if (g->stage == 0) {
+    for (i = index; i < g->n_spectra; i += g->threads) {
+      aubio_graph_spectrum_t *s = &g->spectra[i];
+      aubio_pvoc_do (s->pv, g->input, s->grain);
+    }
+  } else {
+    for (i = index; i < g->n_nodes; i += g->threads) {
+      aubio_graph_do_node (g, &g->nodes[i]);
+    }
+  }
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_graph_worker)
+{
+  aubio_graph_worker_t *w = (aubio_graph_worker_t *)arg;
+  aubio_graph_t *g = w->graph;
+  uint_t done = 0;
+  AUBIO_IO_LOCK(g);
+  for (;;) {
+    while (g->job == done && !g->quit) AUBIO_IO_WAIT(g);
+    if (g->quit) break;
+    done = g->job;
+    AUBIO_IO_UNLOCK(g);
+    aubio_graph_do_share (g, w->index);
+    AUBIO_IO_LOCK(g);
+    if (--g->pending == 0) AUBIO_IO_WAKE(g);
+  }
+  AUBIO_IO_UNLOCK(g);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+static void aubio_graph_run_stage (aubio_graph_t *g, uint_t stage)
+{
+  g->stage = stage;
+  if (g->workers) {
+    AUBIO_IO_LOCK(g);
+    g->job++;
+    g->pending = g->threads - 1;
+    AUBIO_IO_WAKE(g);
+    AUBIO_IO_UNLOCK(g);
+  }
+  aubio_graph_do_share (g, 0);
+  if (g->workers) {
+    AUBIO_IO_LOCK(g);
+    while (g->pending > 0) AUBIO_IO_WAIT(g);
+    AUBIO_IO_UNLOCK(g);
+  }
+}
+
+void aubio_graph_do (aubio_graph_t *g, const fvec_t *input)
+{
+  if (input->length != g->hop_size) {
+    AUBIO_ERR ("graph: expected an input of length %d, got %d\n",
+        g->hop_size, input->length);
+    return;
+  }
+  AUBIO_STATS_BEGIN ("graph");
+  g->started = 1;
+  g->input = input;
+  // the level is computed once for all the detectors
+  aubio_frame_stats_do (input, -90., &g->stats);
+  // all the spectra, then all the outputs reading them
+  aubio_graph_run_stage (g, 0);
+  aubio_graph_run_stage (g, 1);
+  g->input = NULL;
+  AUBIO_STATS_END ();
+}
+
+uint_t aubio_graph_get_output (const aubio_graph_t *g, uint_t output,
+    fvec_t *view)
+{
+  if (output >= g->n_nodes) {
+    AUBIO_ERR ("graph: output %d out of range, only %d outputs\n", output,
+        g->n_nodes);
+    return AUBIO_FAIL;
+  }
+  return fvec_view (view, g->nodes[output].out, 0,
+      g->nodes[output].out->length);
+}
+
+static void *aubio_graph_get_object (const aubio_graph_t *g, uint_t output,
+    aubio_graph_kind_t kind)
+{
+  if (output >= g->n_nodes || g->nodes[output].kind != kind) return NULL;
+  return g->nodes[output].object;
+}
+
+aubio_onset_t *aubio_graph_get_onset (const aubio_graph_t *g, uint_t output)
+{
+  return (aubio_onset_t *)aubio_graph_get_object (g, output,
+      aubio_graph_onset);
+}
+
+aubio_tempo_t *aubio_graph_get_tempo (const aubio_graph_t *g, uint_t output)
+{
+  return (aubio_tempo_t *)aubio_graph_get_object (g, output,
+      aubio_graph_tempo);
+}
+
+aubio_pitch_t *aubio_graph_get_pitch (const aubio_graph_t *g, uint_t output)
+{
+  return (aubio_pitch_t *)aubio_graph_get_object (g, output,
+      aubio_graph_pitch);
+}
+
+uint_t aubio_graph_set_threads (aubio_graph_t *g, uint_t threads)
+{
+  uint_t i;
+  if (threads < 1) {
+    AUBIO_ERR ("graph: got %d threads, but can not be < 1\n", threads);
+    return AUBIO_FAIL;
+  }
+  aubio_graph_del_workers (g);
+  g->threads = threads;
+  if (threads == 1) return AUBIO_OK;
+  g->workers = AUBIO_ARRAY (aubio_graph_worker_t, threads - 1);
+  if (!g->workers) goto beach;
+  g->quit = 0;
+  g->job = 0;
+  AUBIO_IO_THREAD_INIT(g);
+  for (i = 0; i < threads - 1; i++) {
+    aubio_graph_worker_t *w = &g->workers[i];
+    w->graph = g;
+    w->index = i + 1;
+    w->running = AUBIO_IO_THREAD_START(w, aubio_graph_worker,
+        AUBIO_THREAD_WORKER);
+    if (!w->running) {
+      AUBIO_ERR ("graph: failed starting thread %d\n", i + 1);
+      goto beach;
+    }
+  }
+  return AUBIO_OK;
+beach:
+  aubio_graph_del_workers (g);
+  return AUBIO_FAIL;
+}
+
+uint_t aubio_graph_get_threads (const aubio_graph_t *g)
+{
+  return g->threads;
+}
+
+static void aubio_graph_del_workers (aubio_graph_t *g)
+{
+  uint_t i;
+  if (!g->workers) {
+    g->threads = 1;
+    return;
+  }
+  AUBIO_IO_LOCK(g);
+  g->quit = 1;
+  AUBIO_IO_WAKE(g);
+  AUBIO_IO_UNLOCK(g);
+  for (i = 0; i < g->threads - 1; i++) {
+    aubio_graph_worker_t *w = &g->workers[i];
+    if (w->running) AUBIO_IO_THREAD_JOIN(w);
+  }
+  AUBIO_IO_THREAD_DESTROY(g);
+  AUBIO_FREE (g->workers);
+  g->workers = NULL;
+  g->threads = 1;
+}
+
+void del_aubio_graph (aubio_graph_t *g)
+{
+  uint_t i;
+  aubio_graph_del_workers (g);
+  for (i = 0; i < g->n_nodes; i++) {
+    aubio_graph_del_node (&g->nodes[i]);
+  }
+  for (i = 0; i < g->n_spectra; i++) {
+    del_aubio_pvoc (g->spectra[i].pv);
+    del_cvec (g->spectra[i].grain);
+  }
+  if (g->nodes) AUBIO_FREE (g->nodes);
+  if (g->spectra) AUBIO_FREE (g->spectra);
+  AUBIO_FREE (g);
+}
@@ -0,0 +1,195 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_GRAPH_H
+#define AUBIO_GRAPH_H
+
+/** \file
+
+  Several analyses of the same signal, sharing their common stages
+
+  Instead of creating a phase vocoder, an onset, a tempo and a pitch object
+  and passing the spectrum of one to the others by hand, the outputs are
+  requested from an analysis graph, which works out the stages they need.
+  Each hop, the level of the input is computed once for all the detectors,
+  and a single phase vocoder runs for each buffer size, computing the phase
+  only when one of its readers needs it. The other buffers are allocated as
+  the outputs are added, so that ::aubio_graph_do does not allocate.
+
+  The following outputs are available:
+
+    - `level`: level in dB SPL, root mean square, peak and zero-crossing
+      rate of the hop, see ::aubio_frame_stats_t
+    - `onset`: output of aubio_onset_do(), and the value of the onset
+      detection function, the method being one of ::new_aubio_onset
+    - `tempo`: output of aubio_tempo_do(), the tempo in beats per minute and
+      its confidence, the method being one of ::new_aubio_tempo
+    - `pitch`: fundamental frequency in Hz and its confidence, the method
+      being one of ::new_aubio_pitch
+    - `melbands`: energy in 40 mel bands, as in ::aubio_mfcc_t
+    - `mfcc`: 13 mel-frequency cepstrum coefficients
+
+  With ::aubio_graph_set_threads, the phase vocoders, then the detectors,
+  are spread over a pool of threads on each hop.
+
+  \example utils/test-graph.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** analysis graph object */
+typedef struct _aubio_graph_t aubio_graph_t;
+
+/** create analysis graph
+
+  \param hop_size number of new samples given to each call of
+  ::aubio_graph_do
+  \param samplerate samplerate of the input
+
+  \return newly created ::aubio_graph_t, or NULL on failure
+
+*/
+aubio_graph_t *new_aubio_graph (uint_t hop_size, uint_t samplerate);
+
+/** request an output
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param output name of the output, see graph.h
+  \param method method of the analysis, or `default`
+  \param buf_size buffer size of the analysis, the outputs of the same buffer
+  size sharing their phase vocoder
+
+  \return index of the new output, or -1 if it could not be created
+
+  Outputs can only be added before the first call to ::aubio_graph_do. Their
+  objects keep buffers of their own, even if a workspace was set with
+  ::aubio_set_workspace, since they may run on several threads at once.
+
+*/
+sint_t aubio_graph_add (aubio_graph_t *g, const char_t *output,
+    const char_t *method, uint_t buf_size);
+
+/** get number of outputs
+
+  \param g analysis graph, created by ::new_aubio_graph
+
+  \return number of outputs added with ::aubio_graph_add
+
+*/
+uint_t aubio_graph_get_n_outputs (const aubio_graph_t *g);
+
+/** get number of phase vocoders
+
+  \param g analysis graph, created by ::new_aubio_graph
+
+  \return number of spectra computed on each hop, one per buffer size
+
+*/
+uint_t aubio_graph_get_n_spectra (const aubio_graph_t *g);
+
+/** set number of threads
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param threads number of threads, including the one calling
+  ::aubio_graph_do, 1 to run all the stages on the calling thread (default)
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_graph_set_threads (aubio_graph_t *g, uint_t threads);
+
+/** get number of threads
+
+  \param g analysis graph, created by ::new_aubio_graph
+
+  \return number of threads running ::aubio_graph_do
+
+*/
+uint_t aubio_graph_get_threads (const aubio_graph_t *g);
+
+/** analyse a new hop
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param input new samples, hop_size of them
+
+*/
+void aubio_graph_do (aubio_graph_t *g, const fvec_t *input);
+
+/** get values of an output
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param output index of the output, as returned by ::aubio_graph_add
+  \param view vector set to view the values of the output on the last hop,
+  valid until the next call to ::aubio_graph_do
+
+  \return 0 if successful, non-zero if `output` is out of range
+
+*/
+uint_t aubio_graph_get_output (const aubio_graph_t *g, uint_t output,
+    fvec_t *view);
+
+/** get onset object of an output
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param output index of an `onset` output
+
+  \return the object computing the output, for instance to change its
+  threshold, or NULL if `output` is not an `onset` output
+
+*/
+aubio_onset_t *aubio_graph_get_onset (const aubio_graph_t *g, uint_t output);
+
+/** get tempo object of an output
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param output index of a `tempo` output
+
+  \return the object computing the output, or NULL if `output` is not a
+  `tempo` output
+
+*/
+aubio_tempo_t *aubio_graph_get_tempo (const aubio_graph_t *g, uint_t output);
+
+/** get pitch object of an output
+
+  \param g analysis graph, created by ::new_aubio_graph
+  \param output index of a `pitch` output
+
+  \return the object computing the output, or NULL if `output` is not a
+  `pitch` output
+
+*/
+aubio_pitch_t *aubio_graph_get_pitch (const aubio_graph_t *g, uint_t output);
+
+/** delete analysis graph
+
+  \param g analysis graph, created by ::new_aubio_graph
+
+*/
+void del_aubio_graph (aubio_graph_t *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_GRAPH_H */
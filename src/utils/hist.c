@@ -22,6 +22,7 @@
 #include "fvec.h"
 #include "utils/scale.h"
 #include "mathutils.h" //fvec_min fvec_max
+#include "utils/simd_priv.h"
 #include "utils/hist.h"
 
 /********
@@ -33,6 +34,9 @@ struct _aubio_hist_t {
   uint_t nelems;
   fvec_t * cent;
   aubio_scale_t *scaler;
+  smpl_t flow;                  /**< lower edge of the first column */
+  smpl_t fhig;                  /**< upper edge of the last column */
+  smpl_t decay;                 /**< applied before each accumulation */
 };
 
 /**
@@ -52,6 +56,9 @@ aubio_hist_t * new_aubio_hist (smpl_t flow, smpl_t fhig, uint_t nelems){
     return NULL;
   }
   s->nelems = nelems;
+  s->flow = flow;
+  s->fhig = fhig;
+  s->decay = 1.;
   s->hist = new_fvec(nelems);
   s->cent = new_fvec(nelems);
 
@@ -72,6 +79,11 @@ void del_aubio_hist(aubio_hist_t *s) {
   AUBIO_FREE(s);
 }
 
+uint_t aubio_hist_get_memory_usage (const aubio_hist_t *s) {
+  return aubio_malloc_size(s) + aubio_malloc_size(s->hist)
+    + aubio_malloc_size(s->cent) + aubio_malloc_size(s->scaler);
+}
+
 /***
  * do it
  */
@@ -117,6 +129,8 @@ void aubio_hist_dyn_notnull (aubio_hist_t *s, fvec_t *input) {
 
   /* readapt */
   aubio_scale_set_limits (s->scaler, ilow, ihig, 0, s->nelems);
+  s->flow = ilow;
+  s->fhig = ihig;
 
   /* recalculate centers */
   s->cent->data[0] = ilow + 0.5f * step;
@@ -153,3 +167,320 @@ smpl_t aubio_hist_mean (const aubio_hist_t *s) {
   return tmp/(smpl_t)(s->nelems);
 }
 
+
+/* number of elements converted to column indices at once */
+#define AUBIO_HIST_BLOCK 64
+
+void aubio_hist_accumulate (aubio_hist_t *s, const fvec_t *input) {
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  smpl_t idx[AUBIO_HIST_BLOCK];
+  smpl_t scale = (s->fhig != s->flow) ? s->nelems / (s->fhig - s->flow) : 0.;
+  smpl_t last = s->nelems - 1;
+  uint_t j, k, n;
+  if (s->decay < 1.) fvec_mul(s->hist, s->decay);
+  for (j = 0; j < input->length; j += n) {
+    n = MIN(AUBIO_HIST_BLOCK, input->length - j);
+    /* map the block to column indices with the vector kernels */
+    memcpy(idx, input->data + j, n * sizeof(smpl_t));
+    ops->add(idx, -s->flow, n);
+    ops->mul(idx, scale, n);
+    for (k = 0; k < n; k++) {
+      smpl_t i = idx[k];
+      /* out of range, including nans, go to the edges */
+      if (!(i >= 0.)) i = 0.;
+      if (i > last) i = last;
+      s->hist->data[(uint_t)i] += 1.;
+    }
+  }
+}
+
+uint_t aubio_hist_merge (aubio_hist_t *s, const aubio_hist_t *other) {
+  uint_t j;
+  if (other->nelems != s->nelems || other->flow != s->flow
+      || other->fhig != s->fhig) {
+    AUBIO_ERR("hist: can not merge histograms with different columns\n");
+    return AUBIO_FAIL;
+  }
+  for (j = 0; j < s->nelems; j++) {
+    s->hist->data[j] += other->hist->data[j];
+  }
+  return AUBIO_OK;
+}
+
+smpl_t aubio_hist_quantile (const aubio_hist_t *s, smpl_t q) {
+  smpl_t total = aubio_hist_get_count(s), target, sum = 0.;
+  smpl_t step = (s->fhig - s->flow) / s->nelems;
+  uint_t j;
+  if (total <= 0.) return 0.;
+  target = MIN(MAX(q, 0.), 1.) * total;
+  for (j = 0; j < s->nelems; j++) {
+    smpl_t count = s->hist->data[j];
+    if (count > 0. && sum + count >= target) {
+      return s->flow + step * (j + (target - sum) / count);
+    }
+    sum += count;
+  }
+  return s->fhig;
+}
+
+smpl_t aubio_hist_get_count (const aubio_hist_t *s) {
+  return fvec_sum(s->hist);
+}
+
+uint_t aubio_hist_set_decay (aubio_hist_t *s, smpl_t decay) {
+  if (!(decay > 0. && decay <= 1.)) {
+    AUBIO_ERR("hist: decay should be in ]0, 1], got %f\n", decay);
+    return AUBIO_FAIL;
+  }
+  s->decay = decay;
+  return AUBIO_OK;
+}
+
+void aubio_hist_reset (aubio_hist_t *s) {
+  fvec_zeros(s->hist);
+}
+
+/********
+ * t-digest, merging variant
+ *
+ * The centroids are kept sorted by mean. New elements are appended to a
+ * buffer, which is sorted and merged with the centroids once full. Two
+ * neighbours are merged as long as they fit within one unit of the scale
+ * function k(q) = compression / (2 pi) * asin(2 q - 1), which is steep near
+ * q = 0 and q = 1, keeping the centroids of the tails small.
+ */
+
+struct _aubio_digest_t {
+  smpl_t compression;
+  uint_t size;                  /**< number of centroids */
+  uint_t max_size;              /**< capacity of the centroids */
+  fvec_t *mean;                 /**< means of the centroids */
+  fvec_t *weight;               /**< weights of the centroids */
+  uint_t buffered;              /**< number of buffered elements */
+  uint_t max_buffered;          /**< capacity of the buffer */
+  fvec_t *buf_mean;             /**< buffered elements, then merge output */
+  fvec_t *buf_weight;
+  smpl_t total;                 /**< sum of all the weights */
+  smpl_t min;                   /**< smallest element added */
+  smpl_t max;                   /**< largest element added */
+  smpl_t decay;
+};
+
+aubio_digest_t *new_aubio_digest (smpl_t compression) {
+  aubio_digest_t *d = AUBIO_NEW(aubio_digest_t);
+  if (!d) return NULL;
+  if (!(compression >= 10. && compression <= 10000.)) {
+    AUBIO_ERR("digest: compression should be in [10, 10000], got %f\n",
+        compression);
+    goto beach;
+  }
+  d->compression = compression;
+  // a centroid and its neighbour span more than one unit of k, which spans
+  // compression / 2 units over [0, 1]
+  d->max_size = (uint_t)CEIL(compression) + 2;
+  d->max_buffered = 4 * d->max_size;
+  d->mean = new_fvec(d->max_size);
+  d->weight = new_fvec(d->max_size);
+  // the merge writes its output here, before copying it to the centroids
+  d->buf_mean = new_fvec(d->max_size + d->max_buffered);
+  d->buf_weight = new_fvec(d->max_size + d->max_buffered);
+  if (!d->mean || !d->weight || !d->buf_mean || !d->buf_weight) goto beach;
+  d->decay = 1.;
+  aubio_digest_reset(d);
+  return d;
+beach:
+  del_aubio_digest(d);
+  return NULL;
+}
+
+void del_aubio_digest (aubio_digest_t *d) {
+  if (d->mean) del_fvec(d->mean);
+  if (d->weight) del_fvec(d->weight);
+  if (d->buf_mean) del_fvec(d->buf_mean);
+  if (d->buf_weight) del_fvec(d->buf_weight);
+  AUBIO_FREE(d);
+}
+
+void aubio_digest_reset (aubio_digest_t *d) {
+  d->size = 0;
+  d->buffered = 0;
+  d->total = 0.;
+  d->min = 0.;
+  d->max = 0.;
+}
+
+/* sift element i down the max-heap of n elements */
+static void aubio_digest_sift (smpl_t *m, smpl_t *w, uint_t i, uint_t n) {
+  smpl_t tm, tw;
+  uint_t c;
+  while ((c = 2 * i + 1) < n) {
+    if (c + 1 < n && m[c + 1] > m[c]) c++;
+    if (m[i] >= m[c]) break;
+    tm = m[i]; m[i] = m[c]; m[c] = tm;
+    tw = w[i]; w[i] = w[c]; w[c] = tw;
+    i = c;
+  }
+}
+
+/* heap sort of the buffer by mean, in place and without allocating */
+static void aubio_digest_sort (smpl_t *m, smpl_t *w, uint_t n) {
+  smpl_t tm, tw;
+  uint_t i;
+  if (n < 2) return;
+  for (i = n / 2; i-- > 0;) {
+    aubio_digest_sift(m, w, i, n);
+  }
+  for (i = n - 1; i > 0; i--) {
+    tm = m[0]; m[0] = m[i]; m[i] = tm;
+    tw = w[0]; w[0] = w[i]; w[i] = tw;
+    aubio_digest_sift(m, w, 0, i);
+  }
+}
+
+/* largest q that a centroid starting at k(q0) may reach */
+static smpl_t aubio_digest_limit (const aubio_digest_t *d, smpl_t q0) {
+  smpl_t k = d->compression / TWO_PI * ASIN(2. * q0 - 1.) + 1.;
+  if (k >= d->compression / 4.) return 1.;
+  return (SIN(k * TWO_PI / d->compression) + 1.) / 2.;
+}
+
+/* sort the buffer and merge it with the centroids */
+static void aubio_digest_flush (aubio_digest_t *d) {
+  smpl_t *bm = d->buf_mean->data, *bw = d->buf_weight->data;
+  smpl_t *cm = d->mean->data, *cw = d->weight->data;
+  smpl_t sum = 0., limit, m, w;
+  uint_t n = d->buffered, i = 0, j = 0, out = 0;
+  if (n == 0) return;
+  aubio_digest_sort(bm, bw, n);
+  // merge the two sorted lists from the end of the output array, which
+  // leaves room for the centroids before the buffered elements
+  memmove(bm + d->max_size, bm, n * sizeof(smpl_t));
+  memmove(bw + d->max_size, bw, n * sizeof(smpl_t));
+  bm += d->max_size;
+  bw += d->max_size;
+  limit = aubio_digest_limit(d, 0.);
+  m = 0.;
+  w = 0.;
+  while (i < d->size || j < n) {
+    smpl_t nm, nw;
+    if (j >= n || (i < d->size && cm[i] <= bm[j])) {
+      nm = cm[i];
+      nw = cw[i++];
+    } else {
+      nm = bm[j];
+      nw = bw[j++];
+    }
+    if (w > 0. && (sum + w + nw) / d->total > limit) {
+      // close the current centroid
+      d->buf_mean->data[out] = m;
+      d->buf_weight->data[out++] = w;
+      sum += w;
+      limit = aubio_digest_limit(d, sum / d->total);
+      w = 0.;
+    }
+    if (w == 0.) {
+      m = nm;
+      w = nw;
+    } else {
+      w += nw;
+      m += (nm - m) * nw / w;
+    }
+  }
+  if (w > 0.) {
+    d->buf_mean->data[out] = m;
+    d->buf_weight->data[out++] = w;
+  }
+  d->size = MIN(out, d->max_size);
+  memcpy(cm, d->buf_mean->data, d->size * sizeof(smpl_t));
+  memcpy(cw, d->buf_weight->data, d->size * sizeof(smpl_t));
+  d->buffered = 0;
+}
+
+/* append an element to the buffer, merging it first if full */
+static void aubio_digest_add (aubio_digest_t *d, smpl_t x, smpl_t w) {
+  if (d->buffered == d->max_buffered) aubio_digest_flush(d);
+  if (d->total == 0.) {
+    d->min = x;
+    d->max = x;
+  } else {
+    d->min = MIN(d->min, x);
+    d->max = MAX(d->max, x);
+  }
+  d->buf_mean->data[d->buffered] = x;
+  d->buf_weight->data[d->buffered++] = w;
+  d->total += w;
+}
+
+void aubio_digest_do (aubio_digest_t *d, const fvec_t *input) {
+  uint_t j;
+  if (d->decay < 1.) {
+    fvec_t w;
+    w.data = d->weight->data;
+    w.length = d->size;
+    fvec_mul(&w, d->decay);
+    w.data = d->buf_weight->data;
+    w.length = d->buffered;
+    fvec_mul(&w, d->decay);
+    d->total *= d->decay;
+  }
+  for (j = 0; j < input->length; j++) {
+    // nans can not be ordered
+    if (isnan(input->data[j])) continue;
+    aubio_digest_add(d, input->data[j], 1.);
+  }
+}
+
+void aubio_digest_merge (aubio_digest_t *d, const aubio_digest_t *other) {
+  uint_t j;
+  for (j = 0; j < other->size; j++) {
+    aubio_digest_add(d, other->mean->data[j], other->weight->data[j]);
+  }
+  for (j = 0; j < other->buffered; j++) {
+    aubio_digest_add(d, other->buf_mean->data[j],
+        other->buf_weight->data[j]);
+  }
+  if (other->total > 0.) {
+    d->min = MIN(d->min, other->min);
+    d->max = MAX(d->max, other->max);
+  }
+}
+
+smpl_t aubio_digest_quantile (aubio_digest_t *d, smpl_t q) {
+  smpl_t *m = d->mean->data, *w = d->weight->data;
+  smpl_t target, sum, center, next;
+  uint_t i;
+  aubio_digest_flush(d);
+  if (d->size == 0 || d->total <= 0.) return 0.;
+  if (d->size == 1) return m[0];
+  target = MIN(MAX(q, 0.), 1.) * d->total;
+  // before the center of the first centroid, towards the minimum
+  if (target < w[0] / 2.) {
+    return d->min + (m[0] - d->min) * target / (w[0] / 2.);
+  }
+  sum = 0.;
+  for (i = 0; i + 1 < d->size; i++) {
+    center = sum + w[i] / 2.;
+    next = sum + w[i] + w[i + 1] / 2.;
+    if (target < next) {
+      return m[i] + (m[i + 1] - m[i]) * (target - center) / (next - center);
+    }
+    sum += w[i];
+  }
+  // after the center of the last centroid, towards the maximum
+  center = d->total - w[i] / 2.;
+  if (target <= center) return m[i];
+  return m[i] + (d->max - m[i]) * (target - center) / (w[i] / 2.);
+}
+
+smpl_t aubio_digest_get_count (const aubio_digest_t *d) {
+  return d->total;
+}
+
+uint_t aubio_digest_set_decay (aubio_digest_t *d, smpl_t decay) {
+  if (!(decay > 0. && decay <= 1.)) {
+    AUBIO_ERR("digest: decay should be in ]0, 1], got %f\n", decay);
+    return AUBIO_FAIL;
+  }
+  d->decay = decay;
+  return AUBIO_OK;
+}
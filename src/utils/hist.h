@@ -23,6 +23,21 @@
  * Histogram function
  *
  * Big hacks to implement an histogram
+ *
+ * Besides the histograms of a single vector, this file provides two
+ * streaming summaries of a distribution, updated one vector at a time
+ * without storing past values, and that can be merged:
+ *
+ * - ::aubio_hist_accumulate counts values into fixed bins; the quantiles are
+ *   exact up to the width of a bin
+ * - ::aubio_digest_t keeps a t-digest, a few weighted centroids that are
+ *   denser towards the tails, so that extreme quantiles stay accurate over an
+ *   unknown range
+ *
+ * Both can forget old values with an exponential decay, for instance to
+ * follow the loudness of a long stream for auto-gain.
+ *
+ * \example utils/test-hist.c
  */
 
 #ifndef AUBIO_HIST_H
@@ -45,6 +60,8 @@ typedef struct _aubio_hist_t aubio_hist_t;
 aubio_hist_t * new_aubio_hist(smpl_t flow, smpl_t fhig, uint_t nelems);
 /** histogram deletion */
 void del_aubio_hist(aubio_hist_t *s);
+/** get the number of bytes allocated by a histogram, see utils/allocator.h */
+uint_t aubio_hist_get_memory_usage(const aubio_hist_t *s);
 /** compute the histogram */
 void aubio_hist_do(aubio_hist_t *s, fvec_t * input);
 /** compute the histogram ignoring null elements */
@@ -56,6 +73,140 @@ void aubio_hist_weight(aubio_hist_t *s);
 /** compute dynamic histogram for non-null elements */
 void aubio_hist_dyn_notnull (aubio_hist_t *s, fvec_t *input);
 
+/** add elements to the counts of the histogram
+
+  \param s histogram, created by new_aubio_hist()
+  \param input elements to count, left unchanged
+
+  Unlike aubio_hist_do(), the counts are not reset first. Elements below the
+  minimum or above the maximum are counted in the first or last column.
+
+*/
+void aubio_hist_accumulate (aubio_hist_t *s, const fvec_t *input);
+
+/** add the counts of another histogram
+
+  \param s histogram, created by new_aubio_hist()
+  \param other histogram with the same limits and number of columns
+
+  \return 0 on success, non-zero if the columns differ
+
+*/
+uint_t aubio_hist_merge (aubio_hist_t *s, const aubio_hist_t *other);
+
+/** get a quantile of the elements counted
+
+  \param s histogram, created by new_aubio_hist()
+  \param q quantile, between 0 and 1, for instance 0.5 for the median
+
+  \return value below which a fraction q of the elements fall, interpolated
+  within its column, or 0 if nothing was counted
+
+*/
+smpl_t aubio_hist_quantile (const aubio_hist_t *s, smpl_t q);
+
+/** get the sum of the counts
+
+  \param s histogram, created by new_aubio_hist()
+
+  \return number of elements counted, weighted by the decay
+
+*/
+smpl_t aubio_hist_get_count (const aubio_hist_t *s);
+
+/** set the decay of the counts
+
+  \param s histogram, created by new_aubio_hist()
+  \param decay factor applied to the counts before each call to
+  aubio_hist_accumulate(), between 0 and 1; 1, the default, never forgets
+
+  \return 0 on success, non-zero if decay is out of range
+
+*/
+uint_t aubio_hist_set_decay (aubio_hist_t *s, smpl_t decay);
+
+/** reset the counts of the histogram
+
+  \param s histogram, created by new_aubio_hist()
+
+*/
+void aubio_hist_reset (aubio_hist_t *s);
+
+/** t-digest object */
+typedef struct _aubio_digest_t aubio_digest_t;
+
+/** create a t-digest
+
+  \param compression bound on the number of centroids kept, at least 10;
+  with 100, quantiles are off by about 1% of the elements near the median,
+  and by much less in the tails
+
+  \return newly created ::aubio_digest_t, or NULL on failure
+
+*/
+aubio_digest_t *new_aubio_digest (smpl_t compression);
+
+/** add elements to a t-digest
+
+  \param d t-digest, created by new_aubio_digest()
+  \param input elements to add
+
+*/
+void aubio_digest_do (aubio_digest_t *d, const fvec_t *input);
+
+/** add the elements of another t-digest
+
+  \param d t-digest, created by new_aubio_digest()
+  \param other t-digest to merge into d, left unchanged
+
+*/
+void aubio_digest_merge (aubio_digest_t *d, const aubio_digest_t *other);
+
+/** get a quantile of the elements added
+
+  \param d t-digest, created by new_aubio_digest()
+  \param q quantile, between 0 and 1, for instance 0.5 for the median
+
+  \return estimate of the value below which a fraction q of the elements
+  fall, or 0 if nothing was added
+
+*/
+smpl_t aubio_digest_quantile (aubio_digest_t *d, smpl_t q);
+
+/** get the sum of the weights of the elements added
+
+  \param d t-digest, created by new_aubio_digest()
+
+  \return number of elements added, weighted by the decay
+
+*/
+smpl_t aubio_digest_get_count (const aubio_digest_t *d);
+
+/** set the decay of the weights
+
+  \param d t-digest, created by new_aubio_digest()
+  \param decay factor applied to the weights before each call to
+  aubio_digest_do(), between 0 and 1; 1, the default, never forgets
+
+  \return 0 on success, non-zero if decay is out of range
+
+*/
+uint_t aubio_digest_set_decay (aubio_digest_t *d, smpl_t decay);
+
+/** remove all the elements of a t-digest
+
+  \param d t-digest, created by new_aubio_digest()
+
+*/
+void aubio_digest_reset (aubio_digest_t *d);
+
+/** delete a t-digest
+
+  \param d t-digest, created by new_aubio_digest()
+
+*/
+void del_aubio_digest (aubio_digest_t *d);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "utils/history.h"
+
+/* Each frame is written at two places, `pos` and `pos + length`, in a buffer
+   of 2 * length frames. After the write, `pos` moves to the oldest frame, so
+   that the `length` frames from `pos` are the whole history, oldest first. */
+struct _aubio_history_t {
+  uint_t length;                /**< number of frames kept */
+  uint_t size;                  /**< number of values in each frame */
+  uint_t pos;                   /**< index of the oldest frame */
+  uint_t count;                 /**< frames pushed since the last reset */
+  smpl_t *values;               /**< 2 * length frames of size values */
+  smpl_t **rows;                /**< 2 * length pointers to the frames */
+  fmat_t frames;                /**< view of the frames from pos */
+  fvec_t data;                  /**< view of the values from pos */
+};
+
+static void aubio_history_update_views (aubio_history_t *o)
+{
+  o->frames.data = o->rows + o->pos;
+  o->data.data = o->rows[o->pos];
+}
+
+aubio_history_t *new_aubio_history (uint_t length, uint_t size)
+{
+  aubio_history_t *o;
+  uint_t i;
+  if ((sint_t)length < 1 || (sint_t)size < 1) {
+    AUBIO_ERR("history: got length %d and size %d, expected > 0\n",
+        length, size);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_history_t);
+  if (!o) return NULL;
+  o->length = length;
+  o->size = size;
+  o->values = AUBIO_ARRAY(smpl_t, 2 * length * size);
+  o->rows = AUBIO_ARRAY(smpl_t *, 2 * length);
+  if (!o->values || !o->rows) {
+    del_aubio_history(o);
+    return NULL;
+  }
+  for (i = 0; i < 2 * length; i++) {
+    o->rows[i] = o->values + i * size;
+  }
+  o->frames.height = length;
+  o->frames.length = size;
+  o->data.length = length * size;
+  aubio_history_update_views(o);
+  return o;
+}
+
+uint_t aubio_history_push (aubio_history_t *o, const fvec_t *frame)
+{
+  if (frame->length != o->size) {
+    AUBIO_ERR("history: got a frame of %d values, expected %d\n",
+        frame->length, o->size);
+    return AUBIO_FAIL;
+  }
+  AUBIO_MEMCPY(o->rows[o->pos], frame->data, o->size * sizeof(smpl_t));
+  AUBIO_MEMCPY(o->rows[o->pos + o->length], frame->data,
+      o->size * sizeof(smpl_t));
+  o->pos = (o->pos + 1) % o->length;
+  o->count++;
+  aubio_history_update_views(o);
+  return AUBIO_OK;
+}
+
+void aubio_history_push_value (aubio_history_t *o, smpl_t value)
+{
+  fvec_t frame;
+  frame.length = 1;
+  frame.data = &value;
+  aubio_history_push(o, &frame);
+}
+
+const fmat_t *aubio_history_get_frames (const aubio_history_t *o)
+{
+  return &o->frames;
+}
+
+const fvec_t *aubio_history_get_data (const aubio_history_t *o)
+{
+  return &o->data;
+}
+
+uint_t aubio_history_get_count (const aubio_history_t *o)
+{
+  return o->count;
+}
+
+void aubio_history_reset (aubio_history_t *o)
+{
+  AUBIO_MEMSET(o->values, 0, 2 * o->length * o->size * sizeof(smpl_t));
+  o->pos = 0;
+  o->count = 0;
+  aubio_history_update_views(o);
+}
+
+uint_t aubio_history_get_memory_usage (const aubio_history_t *o)
+{
+  return aubio_malloc_size(o) + aubio_malloc_size(o->values)
+    + aubio_malloc_size(o->rows);
+}
+
+void del_aubio_history (aubio_history_t *o)
+{
+  if (o->values)
+    AUBIO_FREE(o->values);
+  if (o->rows)
+    AUBIO_FREE(o->rows);
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef AUBIO_HISTORY_H
+#define AUBIO_HISTORY_H
+
+/** \file
+
+  Fixed-size history of analysis frames
+
+  A history keeps the last `length` frames of `size` values pushed to it,
+  for instance the onset descriptor of the last few seconds, or the mel
+  energies of the last few hundred hops. It is allocated once, and pushing
+  a frame never allocates memory.
+
+  The frames are stored twice, so that the last `length` of them always
+  follow each other in memory, oldest first. Reading the history does not
+  copy it: ::aubio_history_get_frames and ::aubio_history_get_data return
+  views of this memory. These views move forward by one frame at each push,
+  and should be read again after each one.
+
+  Until `length` frames were pushed, the oldest frames of the views are
+  zeros.
+
+  Histories can be kept by ::aubio_onset_t, ::aubio_tempo_t and
+  ::aubio_filterbank_t, see aubio_onset_set_history(),
+  aubio_tempo_set_history() and aubio_filterbank_set_history().
+
+  \example utils/test-history.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** history object */
+typedef struct _aubio_history_t aubio_history_t;
+
+/** create history
+
+  \param length number of frames kept
+  \param size number of values in each frame
+
+  \return newly created ::aubio_history_t, or NULL on failure
+
+*/
+aubio_history_t *new_aubio_history (uint_t length, uint_t size);
+
+/** push a frame
+
+  \param o history, created by ::new_aubio_history
+  \param frame new frame, of `size` values; the oldest one is discarded
+
+  \return 0 if successful, non-zero if `frame` does not hold `size` values
+
+*/
+uint_t aubio_history_push (aubio_history_t *o, const fvec_t *frame);
+
+/** push a frame of a single value
+
+  \param o history, created by ::new_aubio_history with a `size` of 1
+  \param value new value
+
+*/
+void aubio_history_push_value (aubio_history_t *o, smpl_t value);
+
+/** get the frames
+
+  \param o history, created by ::new_aubio_history
+
+  \return view of `length` rows of `size` values, oldest first; the rows
+  are contiguous in memory. The view belongs to `o`, and is valid until the
+  next push.
+
+*/
+const fmat_t *aubio_history_get_frames (const aubio_history_t *o);
+
+/** get all the values
+
+  \param o history, created by ::new_aubio_history
+
+  \return view of `length * size` values, the frames one after the other,
+  oldest first. The view belongs to `o`, and is valid until the next push.
+
+*/
+const fvec_t *aubio_history_get_data (const aubio_history_t *o);
+
+/** get number of frames pushed
+
+  \param o history, created by ::new_aubio_history
+
+  \return number of frames pushed since the creation or the last reset,
+  which may exceed the length of the history
+
+*/
+uint_t aubio_history_get_count (const aubio_history_t *o);
+
+/** clear the history
+
+  \param o history, created by ::new_aubio_history
+
+*/
+void aubio_history_reset (aubio_history_t *o);
+
+/** get memory used by the history
+
+  \param o history, created by ::new_aubio_history
+
+  \return number of bytes allocated by `o`
+
+*/
+uint_t aubio_history_get_memory_usage (const aubio_history_t *o);
+
+/** delete history
+
+  \param o history, created by ::new_aubio_history
+
+*/
+void del_aubio_history (aubio_history_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_HISTORY_H */
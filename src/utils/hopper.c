@@ -0,0 +1,100 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "utils/hopper.h"
+
+struct _aubio_hopper_t {
+  uint_t hop_size;
+  fvec_t *pending;              /**< hop being filled */
+  uint_t n_pending;             /**< number of samples in pending */
+};
+
+aubio_hopper_t *new_aubio_hopper (uint_t hop_size)
+{
+  aubio_hopper_t *o;
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR("hopper: got hop_size %d, expected > 0\n", hop_size);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_hopper_t);
+  if (!o) return NULL;
+  o->hop_size = hop_size;
+  o->pending = new_fvec(hop_size);
+  if (!o->pending) goto beach;
+  return o;
+
+beach:
+  del_aubio_hopper(o);
+  return NULL;
+}
+
+uint_t aubio_hopper_do (aubio_hopper_t *o, const fvec_t *input,
+    aubio_hopper_func_t func, void *data)
+{
+  uint_t pos = 0, n, hops = 0;
+  fvec_t hop;
+  // complete the hop left by the previous blocks
+  if (o->n_pending > 0) {
+    n = MIN(o->hop_size - o->n_pending, input->length);
+    memcpy(o->pending->data + o->n_pending, input->data, n * sizeof(smpl_t));
+    o->n_pending += n;
+    pos = n;
+    if (o->n_pending < o->hop_size) return 0;
+    func(data, o->pending);
+    o->n_pending = 0;
+    hops++;
+  }
+  // pass the hops within the block in place
+  hop.length = o->hop_size;
+  while (input->length - pos >= o->hop_size) {
+    hop.data = input->data + pos;
+    func(data, &hop);
+    pos += o->hop_size;
+    hops++;
+  }
+  // keep the rest for the next block
+  o->n_pending = input->length - pos;
+  memcpy(o->pending->data, input->data + pos, o->n_pending * sizeof(smpl_t));
+  return hops;
+}
+
+uint_t aubio_hopper_get_hops (const aubio_hopper_t *o, uint_t length)
+{
+  return (o->n_pending + length) / o->hop_size;
+}
+
+uint_t aubio_hopper_get_pending (const aubio_hopper_t *o)
+{
+  return o->n_pending;
+}
+
+void aubio_hopper_reset (aubio_hopper_t *o)
+{
+  o->n_pending = 0;
+}
+
+void del_aubio_hopper (aubio_hopper_t *o)
+{
+  AUBIO_ASSERT(o);
+  if (o->pending) del_fvec(o->pending);
+  AUBIO_FREE(o);
+}
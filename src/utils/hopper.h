@@ -0,0 +1,129 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_HOPPER_H
+#define AUBIO_HOPPER_H
+
+/** \file
+
+  Cut blocks of any length into hops
+
+  The objects of aubio, such as ::aubio_onset_t or ::aubio_pvoc_t, read
+  exactly `hop_size` samples at each call, while audio devices often give
+  blocks of another, or of a varying, length. This object keeps the samples
+  left from the previous blocks, and calls a function on each hop completed
+  by a new block:
+
+  \code
+  static void do_onset (void *data, const fvec_t *hop)
+  {
+    aubio_onset_do (onset, hop, onset_out);
+    if (onset_out->data[0] != 0) {
+      // an onset was detected
+    }
+  }
+
+  // in the callback of the audio device, with blocks of any length
+  aubio_hopper_do (hopper, device_block, do_onset, NULL);
+  \endcode
+
+  The hops lying entirely within a block are passed in place, only the
+  samples of the hops spanning two blocks are copied.
+
+  \example utils/test-hopper.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** hopper object */
+typedef struct _aubio_hopper_t aubio_hopper_t;
+
+/** function called on each hop
+
+  \param data user data, as passed to ::aubio_hopper_do
+  \param hop `hop_size` samples, only valid during the call
+
+*/
+typedef void (*aubio_hopper_func_t)(void *data, const fvec_t *hop);
+
+/** create hopper
+
+  \param hop_size number of samples of each hop
+
+  \return newly created ::aubio_hopper_t, or NULL on failure
+
+*/
+aubio_hopper_t *new_aubio_hopper (uint_t hop_size);
+
+/** pass a block of samples
+
+  \param o hopper, created by ::new_aubio_hopper
+  \param input samples, of any length
+  \param func function to call on each completed hop
+  \param data user data passed to `func`
+
+  \return number of hops passed to `func`
+
+*/
+uint_t aubio_hopper_do (aubio_hopper_t *o, const fvec_t *input,
+    aubio_hopper_func_t func, void *data);
+
+/** get number of hops the next block would complete
+
+  \param o hopper, created by ::new_aubio_hopper
+  \param length length of the next block
+
+  \return number of hops ::aubio_hopper_do would pass to its function,
+  for instance to size an output for each of them
+
+*/
+uint_t aubio_hopper_get_hops (const aubio_hopper_t *o, uint_t length);
+
+/** get number of samples kept for the next hop
+
+  \param o hopper, created by ::new_aubio_hopper
+
+  \return number of samples, less than `hop_size`
+
+*/
+uint_t aubio_hopper_get_pending (const aubio_hopper_t *o);
+
+/** drop the samples kept for the next hop
+
+  \param o hopper, created by ::new_aubio_hopper
+
+*/
+void aubio_hopper_reset (aubio_hopper_t *o);
+
+/** delete hopper
+
+  \param o hopper, created by ::new_aubio_hopper
+
+*/
+void del_aubio_hopper (aubio_hopper_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_HOPPER_H */
@@ -0,0 +1,90 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+
+#ifdef HAVE_AUBIO_LAZY_BACKENDS
+
+#include "utils/lazyload_priv.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef HMODULE aubio_lazyload_handle_t;
+#define AUBIO_LAZY_OPEN(file) LoadLibraryA(file)
+#define AUBIO_LAZY_SYM(handle, name) ((void *)GetProcAddress(handle, name))
+static SRWLOCK aubio_lazyload_mutex = SRWLOCK_INIT;
+#define AUBIO_LAZY_LOCK() AcquireSRWLockExclusive(&aubio_lazyload_mutex)
+#define AUBIO_LAZY_UNLOCK() ReleaseSRWLockExclusive(&aubio_lazyload_mutex)
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+typedef void *aubio_lazyload_handle_t;
+#define AUBIO_LAZY_OPEN(file) dlopen(file, RTLD_NOW | RTLD_LOCAL)
+#define AUBIO_LAZY_SYM(handle, name) dlsym(handle, name)
+static pthread_mutex_t aubio_lazyload_mutex = PTHREAD_MUTEX_INITIALIZER;
+#define AUBIO_LAZY_LOCK() pthread_mutex_lock(&aubio_lazyload_mutex)
+#define AUBIO_LAZY_UNLOCK() pthread_mutex_unlock(&aubio_lazyload_mutex)
+#endif
+
+/** largest number of files opened for one library */
+#define AUBIO_LAZYLOAD_MAX_FILES 8
+
+void aubio_lazyload_lock (void)
+{
+  AUBIO_LAZY_LOCK();
+}
+
+void aubio_lazyload_unlock (void)
+{
+  AUBIO_LAZY_UNLOCK();
+}
+
+uint_t aubio_lazyload (const char_t * what, const char_t * const * files,
+    const char_t * const * names, void ** syms, uint_t n_syms)
+{
+  aubio_lazyload_handle_t handles[AUBIO_LAZYLOAD_MAX_FILES];
+  uint_t i, j, n_handles = 0;
+  for (i = 0; files[i] && n_handles < AUBIO_LAZYLOAD_MAX_FILES; i++) {
+    aubio_lazyload_handle_t handle = AUBIO_LAZY_OPEN(files[i]);
+    if (handle) {
+      handles[n_handles++] = handle;
+    }
+  }
+  if (n_handles == 0) {
+    AUBIO_ERR("lazyload: failed loading %s (%s not found)\n", what,
+        files[0]);
+    return AUBIO_FAIL;
+  }
+  // the handles are kept open, the symbols are used until the process exits
+  for (i = 0; i < n_syms; i++) {
+    syms[i] = NULL;
+    for (j = 0; j < n_handles && !syms[i]; j++) {
+      syms[i] = AUBIO_LAZY_SYM(handles[j], names[i]);
+    }
+    if (!syms[i]) {
+      AUBIO_ERR("lazyload: failed loading %s (%s not found)\n", what,
+          names[i]);
+      return AUBIO_FAIL;
+    }
+  }
+  return AUBIO_OK;
+}
+
+#endif /* HAVE_AUBIO_LAZY_BACKENDS */
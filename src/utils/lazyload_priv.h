@@ -0,0 +1,120 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Loading of optional libraries on first use (private)
+
+  This file is for inclusion from _within_ the library only.
+
+  When aubio is configured with `-Dlazy_backends=true`, the codec and effect
+  libraries (libavcodec, libsndfile, libvorbisenc, libFLAC, libsamplerate
+  and librubberband) are not linked to libaubio. Each backend opens its
+  library with dlopen() or LoadLibrary() the first time one of its objects is
+  created, so that programs which never read, write or stretch a file do not
+  map them at all.
+
+  A backend lists the functions it calls in an X-macro, then uses
+  AUBIO_LAZY_DEFINE() to declare a table of pointers to them, and a function
+  `<prefix>_load()` filling it. The functions are then redirected to the
+  table with one `#define` each, for instance:
+
+  \code
+  #define AUBIO_SNDFILE_SYMBOLS(X) X(sf_open) X(sf_close)
+  static const char_t *aubio_sndfile_files[] = {
+    AUBIO_LAZY_LIB("sndfile", "1"), NULL };
+  AUBIO_LAZY_DEFINE(aubio_sndfile, AUBIO_SNDFILE_SYMBOLS, "libsndfile",
+      aubio_sndfile_files)
+  #define sf_open aubio_sndfile.sf_open
+  #define sf_close aubio_sndfile.sf_close
+  \endcode
+
+  Libraries are never unloaded, and a library which failed loading is not
+  tried again.
+
+*/
+
+#ifndef AUBIO_LAZYLOAD_PRIV_H
+#define AUBIO_LAZYLOAD_PRIV_H
+
+/** file name of a shared library, from its name without prefix and the major
+  version of its ABI */
+#if defined(_WIN32)
+#define AUBIO_LAZY_LIB(name, version) name "-" version ".dll"
+#elif defined(__APPLE__)
+#define AUBIO_LAZY_LIB(name, version) "lib" name "." version ".dylib"
+#else
+#define AUBIO_LAZY_LIB(name, version) "lib" name ".so." version
+#endif
+
+/** open libraries and look up symbols in them
+
+  \param what name of the library, for error messages
+  \param files NULL terminated list of file names; each file found is opened,
+  the others are skipped
+  \param names names of the symbols to look up
+  \param syms addresses of the symbols, in the order of names
+  \param n_syms number of symbols
+
+  \return 0 if all the symbols were found in the opened files, 1 otherwise
+
+  Should be called between aubio_lazyload_lock() and aubio_lazyload_unlock().
+
+*/
+uint_t aubio_lazyload (const char_t * what, const char_t * const * files,
+    const char_t * const * names, void ** syms, uint_t n_syms);
+
+/** lock the mutex protecting the tables of symbols */
+void aubio_lazyload_lock (void);
+
+/** unlock the mutex protecting the tables of symbols */
+void aubio_lazyload_unlock (void);
+
+#define AUBIO_LAZY_FIELD(name) __typeof__(name) *name;
+#define AUBIO_LAZY_NAME(name) #name,
+#define AUBIO_LAZY_SET(name) t->name = (__typeof__(name) *)syms[i++];
+
+/** declare the table `prefix` of the symbols in `list`, and a function
+  `prefix_load()` returning 0 once they were found in `files` */
+#define AUBIO_LAZY_DEFINE(prefix, list, what, files) \
+  static struct prefix ## _table { \
+    sint_t state; /* 0 untried, 1 loaded, -1 failed */ \
+    list(AUBIO_LAZY_FIELD) \
+  } prefix; \
+  static const char_t *prefix ## _names[] = { list(AUBIO_LAZY_NAME) }; \
+  static uint_t prefix ## _load (void) { \
+    const uint_t n = sizeof(prefix ## _names) / sizeof(prefix ## _names[0]); \
+    void *syms[sizeof(prefix ## _names) / sizeof(prefix ## _names[0])]; \
+    struct prefix ## _table *t = &prefix; \
+    uint_t i = 0; \
+    aubio_lazyload_lock(); \
+    if (t->state == 0) { \
+      if (aubio_lazyload(what, files, prefix ## _names, syms, n)) { \
+        t->state = -1; \
+      } else { \
+        list(AUBIO_LAZY_SET) \
+        t->state = 1; \
+      } \
+    } \
+    aubio_lazyload_unlock(); \
+    return t->state == 1 ? AUBIO_OK : AUBIO_FAIL; \
+  }
+
+#endif /* AUBIO_LAZYLOAD_PRIV_H */
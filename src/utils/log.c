@@ -25,8 +25,9 @@
 static aubio_log_function_t aubio_log_function[AUBIO_LOG_LAST_LEVEL];
 /** array of pointers to closure passed to logging functions, one per level */
 static void* aubio_log_user_data[AUBIO_LOG_LAST_LEVEL];
-/** buffer for logging messages */
-static char aubio_log_buffer[512];
+/** buffer for logging messages, one per thread since objects can log from
+  any thread */
+static AUBIO_THREAD_LOCAL char aubio_log_buffer[512];
 
 /** private function used by default by logging functions */
 void
@@ -0,0 +1,241 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "utils/offline_priv.h"
+#include "io/iothread_priv.h"
+
+typedef struct {
+  aubio_offline_t *offline;
+  uint_t running;               /**< 1 if the thread was started */
+  aubio_io_thread_t thread;
+} aubio_offline_worker_t;
+
+struct _aubio_offline_t {
+  const char_t *what;
+  const char_t *uri;
+  uint_t samplerate;            /**< samplerate the file is read at */
+  uint_t hop_size;
+  uint_t width;
+  unsigned long long duration;  /**< in samples at samplerate, 0 if unknown */
+
+  /* the fields below are only set during aubio_offline_run */
+  aubio_offline_analyse_t analyse;
+  void *data;
+  aubio_offline_chunk_t *chunks;
+  uint_t n_chunks;
+  uint_t next_chunk;            /**< protected by mutex */
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+};
+
+aubio_offline_t *new_aubio_offline (const char_t *what, const char_t *uri,
+    uint_t samplerate, uint_t hop_size, uint_t width)
+{
+  aubio_offline_t *o;
+  aubio_source_t *source;
+  uint_t file_samplerate;
+  if (!uri) {
+    AUBIO_ERR("%s: uri should not be NULL\n", what);
+    return NULL;
+  }
+  source = new_aubio_source(uri, 0, hop_size);
+  if (!source) return NULL;
+  o = AUBIO_NEW(aubio_offline_t);
+  if (!o) {
+    del_aubio_source(source);
+    return NULL;
+  }
+  o->what = what;
+  o->uri = uri;
+  o->hop_size = hop_size;
+  o->width = width;
+  file_samplerate = aubio_source_get_samplerate(source);
+  o->samplerate = samplerate ? samplerate : file_samplerate;
+  // the duration is counted at the samplerate of the file
+  o->duration = (unsigned long long)aubio_source_get_duration(source)
+    * o->samplerate / file_samplerate;
+  del_aubio_source(source);
+  return o;
+}
+
+uint_t aubio_offline_get_samplerate (const aubio_offline_t *o)
+{
+  return o->samplerate;
+}
+
+uint_t aubio_offline_get_n_chunks (const aubio_offline_t *o)
+{
+  return o->n_chunks;
+}
+
+const aubio_offline_chunk_t *aubio_offline_get_chunk (const aubio_offline_t *o,
+    uint_t k)
+{
+  return &o->chunks[k];
+}
+
+lsmp_t *aubio_offline_chunk_add (aubio_offline_chunk_t *c)
+{
+  if (c->n_rows == c->size) {
+    uint_t size = MAX(16, 2 * c->size);
+    lsmp_t *rows = (lsmp_t *)AUBIO_REALLOC(c->rows,
+        size * c->width * sizeof(lsmp_t));
+    if (!rows) return NULL;
+    c->rows = rows;
+    c->size = size;
+  }
+  return c->rows + c->width * c->n_rows++;
+}
+
+/* take the next chunk to analyse; return 0 once all chunks were taken */
+static uint_t aubio_offline_next (aubio_offline_t *o, uint_t *k)
+{
+  uint_t found;
+  AUBIO_IO_LOCK(o);
+  found = o->next_chunk < o->n_chunks;
+  if (found) *k = o->next_chunk++;
+  AUBIO_IO_UNLOCK(o);
+  return found;
+}
+
+static void aubio_offline_work (aubio_offline_worker_t *w)
+{
+  aubio_offline_t *o = w->offline;
+  aubio_source_t *source = NULL;
+  fvec_t *in = new_fvec(o->hop_size);
+  aubio_offline_chunk_t *c;
+  uint_t k;
+  while (aubio_offline_next(o, &k)) {
+    c = &o->chunks[k];
+    // each thread reads the file on its own, seeking to each of its chunks
+    if (!source && in) {
+      source = new_aubio_source(o->uri, o->samplerate, o->hop_size);
+    }
+    if (!source) {
+      c->failed = 1;
+    } else if (aubio_source_seek(source, c->pos)) {
+      AUBIO_ERR("%s: failed seeking %s to %d\n", o->what, o->uri, c->pos);
+      c->failed = 1;
+    } else {
+      c->total = c->pos;
+      c->failed = o->analyse(o->data, source, in, c);
+    }
+  }
+  if (source) del_aubio_source(source);
+  if (in) del_fvec(in);
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_offline_thread)
+{
+  aubio_offline_work((aubio_offline_worker_t *)arg);
+  AUBIO_IO_THREAD_RETURN;
+}
+
+/* delete the results of the chunks of the last run */
+static void aubio_offline_clear (aubio_offline_t *o)
+{
+  uint_t k;
+  if (o->chunks) {
+    for (k = 0; k < o->n_chunks; k++) {
+      if (o->chunks[k].rows) AUBIO_FREE(o->chunks[k].rows);
+    }
+    AUBIO_FREE(o->chunks);
+  }
+  o->chunks = NULL;
+  o->n_chunks = 0;
+}
+
+uint_t aubio_offline_run (aubio_offline_t *o, smpl_t chunk_s, uint_t threads,
+    uint_t warmup, uint_t tail, aubio_offline_analyse_t analyse, void *data)
+{
+  aubio_offline_worker_t *workers = NULL;
+  uint_t k, i, n_workers, hop = o->hop_size, chunk_size, err = AUBIO_FAIL;
+  unsigned long long size;
+  aubio_offline_clear(o);
+  // chunks start on the hops of a single pass, so that both analyse the
+  // same frames
+  warmup = (uint_t)MIN(((unsigned long long)warmup + hop - 1) / hop * hop,
+      UINT_MAX / 2 / hop * hop);
+  size = (unsigned long long)CEIL(chunk_s * o->samplerate / hop) * hop;
+  chunk_size = (uint_t)MIN(MAX(size, hop), UINT_MAX / 2 / hop * hop);
+  // files of unknown duration are analysed in a single chunk
+  o->n_chunks = (uint_t)MAX(1, (o->duration + chunk_size - 1) / chunk_size);
+  o->chunks = AUBIO_ARRAY(aubio_offline_chunk_t, o->n_chunks);
+  n_workers = MIN(MAX(threads, 1), o->n_chunks);
+  workers = AUBIO_ARRAY(aubio_offline_worker_t, n_workers);
+  if (!o->chunks || !workers) {
+    AUBIO_ERR("%s: failed allocating %d chunks\n", o->what, o->n_chunks);
+    goto beach;
+  }
+  for (k = 0; k < o->n_chunks; k++) {
+    aubio_offline_chunk_t *c = &o->chunks[k];
+    c->start = k * chunk_size;
+    // the last chunk is read until the end of file, whatever its duration
+    c->end = k + 1 < o->n_chunks ? c->start + chunk_size : UINT_MAX;
+    c->stop = c->end == UINT_MAX ? UINT_MAX : c->end + tail;
+    c->pos = c->start - MIN(c->start, warmup);
+    c->width = o->width;
+  }
+  o->analyse = analyse;
+  o->data = data;
+  o->next_chunk = 0;
+  AUBIO_IO_THREAD_INIT(o);
+  for (i = 0; i < n_workers; i++) {
+    workers[i].offline = o;
+  }
+  // the calling thread works too, the chunks of a thread which could not be
+  // started are taken by the others
+  for (i = 1; i < n_workers; i++) {
+    workers[i].running = AUBIO_IO_THREAD_START(&workers[i],
+        aubio_offline_thread, AUBIO_THREAD_WORKER);
+    if (!workers[i].running) {
+      AUBIO_WRN("%s: failed starting thread %d\n", o->what, i);
+    }
+  }
+  aubio_offline_work(&workers[0]);
+  for (i = 1; i < n_workers; i++) {
+    if (workers[i].running) AUBIO_IO_THREAD_JOIN(&workers[i]);
+  }
+  AUBIO_IO_THREAD_DESTROY(o);
+
+  for (k = 0; k < o->n_chunks; k++) {
+    if (o->chunks[k].failed) {
+      AUBIO_ERR("%s: failed analysing chunk %d of %s\n", o->what, k, o->uri);
+      goto beach;
+    }
+  }
+  err = AUBIO_OK;
+
+beach:
+  if (workers) AUBIO_FREE(workers);
+  return err;
+}
+
+void del_aubio_offline (aubio_offline_t *o)
+{
+  AUBIO_ASSERT(o);
+  aubio_offline_clear(o);
+  AUBIO_FREE(o);
+}
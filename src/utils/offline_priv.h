@@ -0,0 +1,130 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Analysis of a whole file in chunks, on a pool of threads (private)
+
+  This file is for inclusion from _within_ the library only.
+
+  The file is split into chunks of equal length, starting on hop boundaries.
+  The chunks are taken in order by the threads, each thread reading the file
+  with its own ::aubio_source_t. The analysis of a chunk is done by a
+  callback, which reads the source from `pos`, a little before the start of
+  the chunk, so that its objects reach the state they would have in a single
+  pass, until `stop`, a little after its end, and appends rows of results to
+  the chunk. The caller then joins the rows of the chunks, in order.
+
+  The chunks only depend on the file, the hop size and the length of the
+  chunks, not on the number of threads.
+
+*/
+
+#ifndef AUBIO_OFFLINE_PRIV_H
+#define AUBIO_OFFLINE_PRIV_H
+
+/** results of the analysis of a chunk */
+typedef struct {
+  uint_t start;                 /**< first sample of the chunk */
+  uint_t end;                   /**< first sample after the chunk, UINT_MAX
+                                  for the last chunk */
+  uint_t pos;                   /**< first sample to analyse */
+  uint_t stop;                  /**< the analysis stops once it read this
+                                  sample, UINT_MAX for the last chunk */
+  uint_t total;                 /**< samples read from the start of the file
+                                  once the analysis stopped, set by the
+                                  callback */
+  lsmp_t *rows;                 /**< rows of results, width values each */
+  uint_t width;                 /**< number of values in each row */
+  uint_t n_rows;
+  uint_t size;                  /**< number of rows allocated */
+  uint_t failed;
+} aubio_offline_chunk_t;
+
+/** analysis of a chunk, called from any of the threads
+
+  \param data user data, as passed to ::aubio_offline_run
+  \param source source of the file, seeked to `c->pos`
+  \param in vector of hop_size samples to read the source into
+  \param c chunk to analyse
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+typedef uint_t (*aubio_offline_analyse_t) (void *data,
+    aubio_source_t *source, fvec_t *in, aubio_offline_chunk_t *c);
+
+/** offline analysis of a file */
+typedef struct _aubio_offline_t aubio_offline_t;
+
+/** open a file to analyse
+
+  \param what name of the calling object, for error messages
+  \param uri path of the file
+  \param samplerate samplerate to read the file at, or 0 to read it at its
+  own samplerate
+  \param hop_size hop size of the analysis
+  \param width number of values in each row of results
+
+  \return newly created ::aubio_offline_t, or NULL if the file could not be
+  opened
+
+*/
+aubio_offline_t *new_aubio_offline (const char_t *what, const char_t *uri,
+    uint_t samplerate, uint_t hop_size, uint_t width);
+
+/** samplerate the file is read at */
+uint_t aubio_offline_get_samplerate (const aubio_offline_t *o);
+
+/** analyse all the chunks of the file
+
+  \param o offline analysis, created by ::new_aubio_offline
+  \param chunk_s length of the chunks, in seconds
+  \param threads number of threads, including the calling one
+  \param warmup number of samples to analyse before each chunk, rounded up to
+  a multiple of the hop size
+  \param tail number of samples to analyse after each chunk
+  \param analyse callback analysing a chunk
+  \param data user data passed to `analyse`
+
+  \return 0 if all the chunks were analysed, non-zero otherwise
+
+*/
+uint_t aubio_offline_run (aubio_offline_t *o, smpl_t chunk_s, uint_t threads,
+    uint_t warmup, uint_t tail, aubio_offline_analyse_t analyse, void *data);
+
+/** number of chunks analysed by ::aubio_offline_run */
+uint_t aubio_offline_get_n_chunks (const aubio_offline_t *o);
+
+/** chunk k, once analysed by ::aubio_offline_run */
+const aubio_offline_chunk_t *aubio_offline_get_chunk (const aubio_offline_t *o,
+    uint_t k);
+
+/** append a row to a chunk
+
+  \return pointer to the `width` values of the new row, or NULL on failure
+
+*/
+lsmp_t *aubio_offline_chunk_add (aubio_offline_chunk_t *c);
+
+/** close the file and delete the results of its chunks */
+void del_aubio_offline (aubio_offline_t *o);
+
+#endif /* AUBIO_OFFLINE_PRIV_H */
@@ -19,6 +19,7 @@
 */
 
 #include "aubio_priv.h"
+#include "fvec.h"
 #include "parameter.h"
 
 #define AUBIO_PARAM_MAX_STEPS 2000
@@ -102,6 +103,27 @@ smpl_t aubio_parameter_get_next_value ( aubio_parameter_t * s )
   return s->current_value;
 }
 
+void aubio_parameter_fill_ramp ( aubio_parameter_t * s, fvec_t * out )
+{
+  smpl_t start = s->current_value, inc = s->increment, steps;
+  uint_t j, n;
+  if (start == s->target_value || inc == 0.) {
+    // nothing left to interpolate
+    fvec_set_all (out, start);
+    return;
+  }
+  // number of increments before the target is reached
+  steps = CEIL( (s->target_value - start) / inc ) - 1.;
+  n = steps > 0. ? (uint_t)MIN(steps, (smpl_t)out->length) : 0;
+  for (j = 0; j < n; j++) {
+    out->data[j] = start + (j + 1) * inc;
+  }
+  for (j = n; j < out->length; j++) {
+    out->data[j] = s->target_value;
+  }
+  s->current_value = out->length ? out->data[out->length - 1] : start;
+}
+
 uint_t aubio_parameter_set_steps ( aubio_parameter_t * param, uint_t steps )
 {
   if (steps < AUBIO_PARAM_MIN_STEPS || steps > AUBIO_PARAM_MAX_STEPS) {
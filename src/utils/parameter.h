@@ -69,6 +69,17 @@ uint_t aubio_parameter_set_target_value ( aubio_parameter_t * param, smpl_t valu
 */
 smpl_t aubio_parameter_get_next_value ( aubio_parameter_t * param );
 
+/** fill a vector with the next parameter values
+
+  \param param parameter, created by ::new_aubio_parameter
+  \param out vector to fill with the next `out->length` values
+
+  This function is equivalent to calling aubio_parameter_get_next_value()
+  once for each element of `out`, but computes the whole block at once.
+
+*/
+void aubio_parameter_fill_ramp ( aubio_parameter_t * param, fvec_t * out );
+
 /** get current parameter value, without interpolation
 
   \param param parameter, created by ::new_aubio_parameter
@@ -0,0 +1,91 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Parameter values posted by one thread and applied by the thread running
+   the `_do` function of an object, at the start of its next hop.
+
+   Each parameter has an id, below AUBIO_PENDING_MAX, and a slot holding its
+   last posted value. aubio_pending_post() stores the value, then sets the
+   bit of the id in `dirty` with release semantics. aubio_pending_take()
+   clears `dirty` with acquire semantics, and reads the slots of the bits it
+   found set:
+
+     smpl_t values[AUBIO_PENDING_MAX];
+     uint_t posted = aubio_pending_take (&o->pending, values);
+     if (posted & (1u << MY_PARAM)) o->param = values[MY_PARAM];
+
+   Neither function locks nor waits. A value posted while the slots are read
+   sets its bit again, and is applied at the following hop, so that the last
+   posted value of each parameter always ends up applied. When nothing was
+   posted, aubio_pending_take() costs a single load. */
+
+#ifndef AUBIO_PENDING_PRIV_H
+#define AUBIO_PENDING_PRIV_H
+
+#include <stdint.h>
+#include "utils/atomic_priv.h"
+
+/* largest number of parameters of an object */
+#define AUBIO_PENDING_MAX 32
+
+/* values are copied through integers of the size of smpl_t */
+#if !HAVE_AUBIO_DOUBLE
+typedef uint32_t aubio_pending_bits_t;
+#define AUBIO_PENDING_STORE_BITS(x, v) AUBIO_ATOMIC_STORE(x, v)
+#define AUBIO_PENDING_LOAD_BITS(x) AUBIO_ATOMIC_LOAD(x)
+#else
+typedef uint64_t aubio_pending_bits_t;
+#define AUBIO_PENDING_STORE_BITS(x, v) AUBIO_ATOMIC_STORE64(x, v)
+#define AUBIO_PENDING_LOAD_BITS(x) AUBIO_ATOMIC_LOAD64(x)
+#endif
+
+typedef struct {
+  uint_t dirty;                 /**< one bit per parameter posted */
+  aubio_pending_bits_t slots[AUBIO_PENDING_MAX]; /**< last posted values */
+} aubio_pending_t;
+
+/* post the value of parameter id, from any thread */
+static inline void aubio_pending_post (aubio_pending_t *p, uint_t id,
+    smpl_t value)
+{
+  aubio_pending_bits_t bits;
+  memcpy (&bits, &value, sizeof (bits));
+  AUBIO_PENDING_STORE_BITS (p->slots[id], bits);
+  AUBIO_ATOMIC_OR (p->dirty, 1u << id);
+}
+
+/* read the values posted since the last call into values, and return the
+   bits of their ids; only called by the thread processing the object */
+static inline uint_t aubio_pending_take (aubio_pending_t *p, smpl_t *values)
+{
+  uint_t posted, id;
+  aubio_pending_bits_t bits;
+  if (!AUBIO_ATOMIC_LOAD (p->dirty)) return 0;
+  posted = AUBIO_ATOMIC_TAKE (p->dirty);
+  for (id = 0; id < AUBIO_PENDING_MAX; id++) {
+    if (posted & (1u << id)) {
+      bits = AUBIO_PENDING_LOAD_BITS (p->slots[id]);
+      memcpy (values + id, &bits, sizeof (bits));
+    }
+  }
+  return posted;
+}
+
+#endif /* AUBIO_PENDING_PRIV_H */
@@ -0,0 +1,133 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include <stdint.h>
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "utils/quantize.h"
+
+void
+aubio_quantize_u8 (const fvec_t *in, smpl_t min, smpl_t max, u8_t *out)
+{
+  uint_t i;
+  smpl_t steps = 255. / (max - min);
+  for (i = 0; i < in->length; i++) {
+    smpl_t q = (in->data[i] - min) * steps;
+    // written so that NaN is clamped to 0
+    if (!(q > 0.)) out[i] = 0;
+    else if (q >= 255.) out[i] = 255;
+    else out[i] = (u8_t)(q + .5);
+  }
+}
+
+void
+aubio_dequantize_u8 (const u8_t *in, smpl_t min, smpl_t max, fvec_t *out)
+{
+  uint_t i;
+  smpl_t step = (max - min) / 255.;
+  for (i = 0; i < out->length; i++) {
+    out->data[i] = min + in[i] * step;
+  }
+}
+
+void
+aubio_quantize_s8 (const fvec_t *in, smpl_t step, s8_t *out)
+{
+  uint_t i;
+  smpl_t inv = 1. / step;
+  for (i = 0; i < in->length; i++) {
+    smpl_t q = in->data[i] * inv;
+    if (isnan (q) || q <= -127.) out[i] = -127;
+    else if (q >= 127.) out[i] = 127;
+    else out[i] = (s8_t)ROUND (q);
+  }
+}
+
+void
+aubio_dequantize_s8 (const s8_t *in, smpl_t step, fvec_t *out)
+{
+  uint_t i;
+  for (i = 0; i < out->length; i++) {
+    out->data[i] = in[i] * step;
+  }
+}
+
+/* round a float to the nearest half, ties to even */
+static f16_t
+aubio_float_to_f16 (float v)
+{
+  union { float f; uint32_t u; } x;
+  uint32_t sign, mant, half, rem, halfway, shift;
+  sint_t e;
+  x.f = v;
+  sign = (x.u >> 16) & 0x8000;
+  mant = x.u & 0x7fffff;
+  e = (sint_t)((x.u >> 23) & 0xff) - 127 + 15;
+  if (e == 0xff - 127 + 15) {
+    // infinity, or a quiet NaN
+    return (f16_t)(sign | 0x7c00 | (mant ? 0x200 : 0));
+  }
+  if (e >= 31) return (f16_t)(sign | 0x7c00);
+  if (e <= 0) {
+    // subnormal half, or zero
+    if (e < -10) return (f16_t)sign;
+    mant |= 0x800000;
+    shift = (uint32_t)(14 - e);
+    half = mant >> shift;
+    rem = mant & ((1u << shift) - 1);
+    halfway = 1u << (shift - 1);
+  } else {
+    half = ((uint32_t)e << 10) | (mant >> 13);
+    rem = mant & 0x1fff;
+    halfway = 0x1000;
+  }
+  // a carry out of the significand moves to the next exponent, or infinity
+  if (rem > halfway || (rem == halfway && (half & 1))) half++;
+  return (f16_t)(sign | half);
+}
+
+static smpl_t
+aubio_f16_to_smpl (f16_t h)
+{
+  uint_t e = (h >> 10) & 0x1f, m = h & 0x3ff;
+  smpl_t v;
+  if (e == 0) v = ldexp (m, -24);
+  else if (e == 31) v = m ? NAN : INFINITY;
+  else v = ldexp (m | 0x400, (sint_t)e - 25);
+  return (h & 0x8000) ? -v : v;
+}
+
+void
+aubio_quantize_f16 (const fvec_t *in, f16_t *out)
+{
+  uint_t i;
+  for (i = 0; i < in->length; i++) {
+    out[i] = aubio_float_to_f16 ((float)in->data[i]);
+  }
+}
+
+void
+aubio_dequantize_f16 (const f16_t *in, fvec_t *out)
+{
+  uint_t i;
+  for (i = 0; i < out->length; i++) {
+    out->data[i] = aubio_f16_to_smpl (in[i]);
+  }
+}
@@ -0,0 +1,114 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_QUANTIZE_H
+#define AUBIO_QUANTIZE_H
+
+/** \file
+
+  Compact encodings of feature vectors
+
+  Features sent over a network or stored for a classifier rarely need the
+  precision of ::smpl_t. These functions encode a vector in 1 or 2 bytes per
+  value, and decode it back:
+
+    - ::u8_t, 256 steps between a lower and an upper bound, for instance
+      band energies in dB, see aubio_filterbank_do_log_u8()
+    - ::s8_t, a multiple of a fixed step between -127 and 127, for instance
+      mel-frequency cepstral coefficients, see aubio_mfcc_do_s8()
+    - ::f16_t, IEEE 754 half-precision floats, 11 significant bits over a
+      range of 2^-24 to 65504, rounded to the nearest value
+
+  Values out of range are clamped to the nearest code, and NaN is encoded as
+  the lowest one, except in half precision, which has its own NaN.
+
+  The encoded arrays hold as many elements as the vectors given to the
+  functions.
+
+  \example utils/test-quantize.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** encode a vector as unsigned bytes
+
+  \param in values to encode
+  \param min value encoded as 0
+  \param max value encoded as 255, greater than `min`
+  \param out `in->length` codes
+
+*/
+void aubio_quantize_u8 (const fvec_t *in, smpl_t min, smpl_t max,
+    u8_t *out);
+
+/** decode unsigned bytes
+
+  \param in `out->length` codes, as encoded by aubio_quantize_u8()
+  \param min value encoded as 0
+  \param max value encoded as 255
+  \param out decoded values
+
+*/
+void aubio_dequantize_u8 (const u8_t *in, smpl_t min, smpl_t max,
+    fvec_t *out);
+
+/** encode a vector as signed bytes
+
+  \param in values to encode
+  \param step value of a code of 1, so that values from `-127 * step` to
+  `127 * step` can be told apart
+  \param out `in->length` codes
+
+*/
+void aubio_quantize_s8 (const fvec_t *in, smpl_t step, s8_t *out);
+
+/** decode signed bytes
+
+  \param in `out->length` codes, as encoded by aubio_quantize_s8()
+  \param step value of a code of 1
+  \param out decoded values
+
+*/
+void aubio_dequantize_s8 (const s8_t *in, smpl_t step, fvec_t *out);
+
+/** encode a vector as half-precision floats
+
+  \param in values to encode
+  \param out `in->length` half-precision floats
+
+*/
+void aubio_quantize_f16 (const fvec_t *in, f16_t *out);
+
+/** decode half-precision floats
+
+  \param in `out->length` half-precision floats
+  \param out decoded values
+
+*/
+void aubio_dequantize_f16 (const f16_t *in, fvec_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_QUANTIZE_H */
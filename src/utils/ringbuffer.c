@@ -0,0 +1,227 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "utils/ringbuffer.h"
+#include "utils/atomic_priv.h"
+
+/** bytes between the fields of each side, at least a cache line */
+#define AUBIO_RINGBUFFER_PAD 64
+
+/* The counters wrap around, their difference is the number of frames in the
+   ring. Each side also keeps the last value it loaded from the other side,
+   and only loads it again when this value does not leave enough frames, or
+   enough room, so that the cache line of the other side is rarely read.
+   `written` is only stored by the producer, `read` only by the consumer;
+   the release stores publish the frames, or the room, to the other side. */
+struct _aubio_ringbuffer_t {
+  uint_t channels;
+  uint_t length;
+  smpl_t *data;                 /**< channels rows of length samples */
+  char pad0[AUBIO_RINGBUFFER_PAD];
+  // producer side
+  uint_t written;               /**< frames written */
+  uint_t write_pos;             /**< next frame to write */
+  uint_t read_cache;            /**< last value of read seen */
+  char pad1[AUBIO_RINGBUFFER_PAD];
+  // consumer side
+  uint_t read;                  /**< frames read */
+  uint_t read_pos;              /**< next frame to read */
+  uint_t written_cache;         /**< last value of written seen */
+  char pad2[AUBIO_RINGBUFFER_PAD];
+};
+
+aubio_ringbuffer_t *new_aubio_ringbuffer (uint_t channels, uint_t length)
+{
+  aubio_ringbuffer_t *o;
+  if ((sint_t)channels < 1 || (sint_t)length < 1) {
+    AUBIO_ERR("ringbuffer: got %d channels and length %d, expected > 0\n",
+        channels, length);
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_ringbuffer_t);
+  if (!o) return NULL;
+  o->channels = channels;
+  o->length = length;
+  o->data = AUBIO_ARRAY(smpl_t, channels * length);
+  if (!o->data) {
+    del_aubio_ringbuffer(o);
+    return NULL;
+  }
+  return o;
+}
+
+/* producer: number of frames, at most length, that can be written */
+static uint_t aubio_ringbuffer_room (aubio_ringbuffer_t *o, uint_t length)
+{
+  uint_t room = o->length - (o->written - o->read_cache);
+  if (room < length) {
+    o->read_cache = AUBIO_ATOMIC_LOAD(o->read);
+    room = o->length - (o->written - o->read_cache);
+  }
+  return MIN(room, length);
+}
+
+/* consumer: number of frames, at most length, that can be read */
+static uint_t aubio_ringbuffer_available (aubio_ringbuffer_t *o,
+    uint_t length)
+{
+  uint_t available = o->written_cache - o->read;
+  if (available < length) {
+    o->written_cache = AUBIO_ATOMIC_LOAD(o->written);
+    available = o->written_cache - o->read;
+  }
+  return MIN(available, length);
+}
+
+/* copy n frames of a channel from input, or zeros if input is NULL, to the
+   write position */
+static void aubio_ringbuffer_copy_in (aubio_ringbuffer_t *o, uint_t channel,
+    const smpl_t *input, uint_t n)
+{
+  smpl_t *row = o->data + channel * o->length;
+  uint_t first = MIN(n, o->length - o->write_pos);
+  if (input) {
+    memcpy(row + o->write_pos, input, first * sizeof(smpl_t));
+    memcpy(row, input + first, (n - first) * sizeof(smpl_t));
+  } else {
+    memset(row + o->write_pos, 0, first * sizeof(smpl_t));
+    memset(row, 0, (n - first) * sizeof(smpl_t));
+  }
+}
+
+/* copy n frames of a channel from the read position to output */
+static void aubio_ringbuffer_copy_out (const aubio_ringbuffer_t *o,
+    uint_t channel, smpl_t *output, uint_t n)
+{
+  const smpl_t *row = o->data + channel * o->length;
+  uint_t first = MIN(n, o->length - o->read_pos);
+  memcpy(output, row + o->read_pos, first * sizeof(smpl_t));
+  memcpy(output + first, row, (n - first) * sizeof(smpl_t));
+}
+
+static void aubio_ringbuffer_commit_write (aubio_ringbuffer_t *o, uint_t n)
+{
+  o->write_pos = (o->write_pos + n) % o->length;
+  AUBIO_ATOMIC_STORE(o->written, o->written + n);
+}
+
+static void aubio_ringbuffer_commit_read (aubio_ringbuffer_t *o, uint_t n)
+{
+  o->read_pos = (o->read_pos + n) % o->length;
+  AUBIO_ATOMIC_STORE(o->read, o->read + n);
+}
+
+uint_t aubio_ringbuffer_write (aubio_ringbuffer_t *o, const fvec_t *input,
+    uint_t length)
+{
+  uint_t c, n = aubio_ringbuffer_room(o, MIN(length, input->length));
+  for (c = 0; c < o->channels; c++) {
+    aubio_ringbuffer_copy_in(o, c, input->data, n);
+  }
+  aubio_ringbuffer_commit_write(o, n);
+  return n;
+}
+
+uint_t aubio_ringbuffer_write_multi (aubio_ringbuffer_t *o,
+    const fmat_t *input, uint_t length)
+{
+  uint_t c, n = aubio_ringbuffer_room(o, MIN(length, input->length));
+  for (c = 0; c < o->channels; c++) {
+    aubio_ringbuffer_copy_in(o, c, c < input->height ? input->data[c] : NULL,
+        n);
+  }
+  aubio_ringbuffer_commit_write(o, n);
+  return n;
+}
+
+uint_t aubio_ringbuffer_read (aubio_ringbuffer_t *o, fvec_t *output,
+    uint_t length)
+{
+  uint_t n = aubio_ringbuffer_available(o, MIN(length, output->length));
+  aubio_ringbuffer_copy_out(o, 0, output->data, n);
+  aubio_ringbuffer_commit_read(o, n);
+  return n;
+}
+
+uint_t aubio_ringbuffer_read_multi (aubio_ringbuffer_t *o, fmat_t *output,
+    uint_t length)
+{
+  uint_t c, n = aubio_ringbuffer_available(o, MIN(length, output->length));
+  for (c = 0; c < output->height; c++) {
+    if (c < o->channels) {
+      aubio_ringbuffer_copy_out(o, c, output->data[c], n);
+    } else {
+      memset(output->data[c], 0, n * sizeof(smpl_t));
+    }
+  }
+  aubio_ringbuffer_commit_read(o, n);
+  return n;
+}
+
+/* frames in the ring, as seen from a third thread: read is loaded first, so
+   that written can not be behind it, but both sides may move in between */
+static uint_t aubio_ringbuffer_count (const aubio_ringbuffer_t *o)
+{
+  uint_t read = AUBIO_ATOMIC_LOAD(o->read);
+  return MIN(AUBIO_ATOMIC_LOAD(o->written) - read, o->length);
+}
+
+uint_t aubio_ringbuffer_get_read_space (const aubio_ringbuffer_t *o)
+{
+  return aubio_ringbuffer_count(o);
+}
+
+uint_t aubio_ringbuffer_get_write_space (const aubio_ringbuffer_t *o)
+{
+  return o->length - aubio_ringbuffer_count(o);
+}
+
+uint_t aubio_ringbuffer_get_length (const aubio_ringbuffer_t *o)
+{
+  return o->length;
+}
+
+uint_t aubio_ringbuffer_get_channels (const aubio_ringbuffer_t *o)
+{
+  return o->channels;
+}
+
+void aubio_ringbuffer_reset (aubio_ringbuffer_t *o)
+{
+  o->write_pos = o->read_pos = 0;
+  o->read_cache = o->written_cache = 0;
+  AUBIO_ATOMIC_STORE(o->read, 0);
+  AUBIO_ATOMIC_STORE(o->written, 0);
+}
+
+uint_t aubio_ringbuffer_get_memory_usage (const aubio_ringbuffer_t *o)
+{
+  return aubio_malloc_size(o) + aubio_malloc_size(o->data);
+}
+
+void del_aubio_ringbuffer (aubio_ringbuffer_t *o)
+{
+  if (o->data)
+    AUBIO_FREE(o->data);
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,181 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_RINGBUFFER_H
+#define AUBIO_RINGBUFFER_H
+
+/** \file
+
+  Wait-free ring of frames between two threads
+
+  A ring buffer passes frames of `channels` samples from one producer
+  thread to one consumer thread, for instance from the process callback of
+  an audio device to an analysis thread, or back. It is allocated once, and
+  neither side ever locks, waits, or allocates memory: a write stores as
+  many frames as there is room for, and a read takes as many frames as were
+  written, both returning the number of frames they moved.
+
+  Only one thread may write, and only one thread may read, at a time. The
+  positions of the two sides are kept on separate cache lines, so that they
+  do not slow each other down.
+
+  \example utils/test-ringbuffer.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** ring buffer object */
+typedef struct _aubio_ringbuffer_t aubio_ringbuffer_t;
+
+/** create ring buffer
+
+  \param channels number of samples in each frame
+  \param length maximum number of frames held
+
+  \return newly created ::aubio_ringbuffer_t, or NULL on failure
+
+*/
+aubio_ringbuffer_t *new_aubio_ringbuffer (uint_t channels, uint_t length);
+
+/** write frames, from the producer thread
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+  \param input frames to write; on rings of several channels, each sample
+  is written to all the channels
+  \param length number of frames to write, at most the length of `input`
+
+  \return number of frames written, less than `length` if the ring is full
+
+*/
+uint_t aubio_ringbuffer_write (aubio_ringbuffer_t *o, const fvec_t *input,
+    uint_t length);
+
+/** write frames of several channels, from the producer thread
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+  \param input frames to write, one channel per row; the channels of the
+  ring missing from `input` are written as zeros, the extra rows are ignored
+  \param length number of frames to write, at most the length of `input`
+
+  \return number of frames written, less than `length` if the ring is full
+
+*/
+uint_t aubio_ringbuffer_write_multi (aubio_ringbuffer_t *o,
+    const fmat_t *input, uint_t length);
+
+/** read frames, from the consumer thread
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+  \param output vector to read to; on rings of several channels, only the
+  first channel is read, and the others are discarded
+  \param length number of frames to read, at most the length of `output`
+
+  \return number of frames read, less than `length` if fewer were written;
+  the following samples of `output` are left unchanged
+
+*/
+uint_t aubio_ringbuffer_read (aubio_ringbuffer_t *o, fvec_t *output,
+    uint_t length);
+
+/** read frames of several channels, from the consumer thread
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+  \param output matrix to read to, one channel per row; its rows beyond the
+  channels of the ring are set to zero
+  \param length number of frames to read, at most the length of `output`
+
+  \return number of frames read, less than `length` if fewer were written
+
+*/
+uint_t aubio_ringbuffer_read_multi (aubio_ringbuffer_t *o, fmat_t *output,
+    uint_t length);
+
+/** get number of frames that can be read
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+  \return number of frames written and not read yet; when called from the
+  consumer thread, at least this number of frames can be read
+
+*/
+uint_t aubio_ringbuffer_get_read_space (const aubio_ringbuffer_t *o);
+
+/** get number of frames that can be written
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+  \return number of free frames; when called from the producer thread, at
+  least this number of frames can be written
+
+*/
+uint_t aubio_ringbuffer_get_write_space (const aubio_ringbuffer_t *o);
+
+/** get maximum number of frames held
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+  \return `length`, as passed to ::new_aubio_ringbuffer
+
+*/
+uint_t aubio_ringbuffer_get_length (const aubio_ringbuffer_t *o);
+
+/** get number of channels
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+  \return `channels`, as passed to ::new_aubio_ringbuffer
+
+*/
+uint_t aubio_ringbuffer_get_channels (const aubio_ringbuffer_t *o);
+
+/** discard all the frames
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+  Neither the producer nor the consumer should use the ring during this
+  call.
+
+*/
+void aubio_ringbuffer_reset (aubio_ringbuffer_t *o);
+
+/** get memory used by the ring buffer
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+  \return number of bytes allocated by `o`
+
+*/
+uint_t aubio_ringbuffer_get_memory_usage (const aubio_ringbuffer_t *o);
+
+/** delete ring buffer
+
+  \param o ring buffer, created by ::new_aubio_ringbuffer
+
+*/
+void del_aubio_ringbuffer (aubio_ringbuffer_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_RINGBUFFER_H */
@@ -0,0 +1,100 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "utils/rtcheck.h"
+
+#ifdef HAVE_RT_CHECKS
+
+#include "utils/atomic_priv.h"
+
+// depth of the real-time sections of each thread
+static AUBIO_THREAD_LOCAL uint_t aubio_rtcheck_depth = 0;
+static uint_t aubio_rtcheck_violations = 0;
+static uint_t aubio_rtcheck_abort = 0;
+
+void aubio_rtcheck_report (const char_t *what)
+{
+  uint_t depth = aubio_rtcheck_depth;
+  if (!depth) return;
+  AUBIO_ATOMIC_ADD(aubio_rtcheck_violations, 1);
+  // leave the section while logging, the log function may allocate
+  aubio_rtcheck_depth = 0;
+  AUBIO_ERR("rtcheck: %s called in a real-time section\n", what);
+  aubio_rtcheck_depth = depth;
+  if (aubio_rtcheck_abort) {
+    abort();
+  }
+}
+
+uint_t aubio_rtcheck_enabled (void)
+{
+  return 1;
+}
+
+void aubio_rtcheck_enter (void)
+{
+  aubio_rtcheck_depth++;
+}
+
+void aubio_rtcheck_leave (void)
+{
+  if (aubio_rtcheck_depth) {
+    aubio_rtcheck_depth--;
+  } else {
+    AUBIO_WRN("rtcheck: leaving a real-time section never entered\n");
+  }
+}
+
+uint_t aubio_rtcheck_get_violations (void)
+{
+  return AUBIO_ATOMIC_LOAD(aubio_rtcheck_violations);
+}
+
+void aubio_rtcheck_set_abort (uint_t enable)
+{
+  aubio_rtcheck_abort = enable;
+}
+
+#else /* HAVE_RT_CHECKS */
+
+uint_t aubio_rtcheck_enabled (void)
+{
+  return 0;
+}
+
+void aubio_rtcheck_enter (void)
+{
+}
+
+void aubio_rtcheck_leave (void)
+{
+}
+
+uint_t aubio_rtcheck_get_violations (void)
+{
+  return 0;
+}
+
+void aubio_rtcheck_set_abort (uint_t enable UNUSED)
+{
+}
+
+#endif /* HAVE_RT_CHECKS */
@@ -0,0 +1,87 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_RTCHECK_H
+#define AUBIO_RTCHECK_H
+
+/** \file
+
+  Checks of real-time safety
+
+  A real-time thread, for instance the one running a JACK process callback,
+  should never allocate or free memory, nor wait for a lock. When aubio is
+  built with the `rt_checks` option, the calling thread can mark a section
+  of its code as real-time, and any allocation or lock taken by aubio in
+  that section is reported, once per call, through the error log. It can
+  also abort the program instead, so that a debugger shows where the call
+  was made.
+
+  Typically, the section covers the `_do` functions of the objects used by
+  the real-time thread, which were created outside of it.
+
+  Without the `rt_checks` option, these functions do nothing, and
+  ::aubio_rtcheck_enabled returns 0.
+
+  \example utils/test-rtcheck.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** check whether aubio was built with real-time checks
+
+  \return 1 if aubio was built with the `rt_checks` option, 0 otherwise
+
+*/
+uint_t aubio_rtcheck_enabled (void);
+
+/** start a real-time section in the calling thread
+
+  Sections can be nested; the calling thread stays in a real-time section
+  until ::aubio_rtcheck_leave was called as many times as this function.
+
+*/
+void aubio_rtcheck_enter (void);
+
+/** end a real-time section in the calling thread */
+void aubio_rtcheck_leave (void);
+
+/** get number of allocations and locks made in real-time sections
+
+  \return number of calls reported so far, by all threads
+
+*/
+uint_t aubio_rtcheck_get_violations (void);
+
+/** abort when an allocation or a lock is made in a real-time section
+
+  \param enable 1 to call abort() after reporting a call, 0 to only report
+  it
+
+*/
+void aubio_rtcheck_set_abort (uint_t enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_RTCHECK_H */
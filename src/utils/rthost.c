@@ -0,0 +1,253 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "utils/rthost.h"
+#include "io/iothread_priv.h"
+#include "utils/atomic_priv.h"
+
+/* Counters shared by the real-time thread and the worker. Each of them has a
+   single writer, so loads with acquire and stores with release semantics are
+   enough to hand the slots over between the two threads without locks.
+
+   The slots form a ring of hops. Hop `k` goes to slot `k % n_slots`: the
+   real-time thread fills its input and publishes it by incrementing
+   `written`, the worker writes its output and increments `processed`, and
+   the real-time thread plays it once `latency` more hops were written, then
+   increments `played`. A slot is filled again only once both the worker and
+   the real-time thread are done with it. */
+struct _aubio_rthost_t {
+  uint_t hop_size;
+  uint_t latency;
+  uint_t n_slots;
+  fvec_t **inputs;
+  fvec_t **outputs;
+  aubio_rthost_func_t func;
+  void *data;
+
+  // written by the real-time thread
+  uint_t written;               /**< hops passed to the worker */
+  uint_t dropped;               /**< input hops dropped */
+  uint_t late;                  /**< output hops played as silence */
+  // written by the worker
+  uint_t processed;             /**< hops processed by the worker */
+
+  // only used by the real-time thread
+  uint_t played;                /**< hops played or skipped */
+  uint_t pos;                   /**< position in the current hop */
+  fvec_t *cur_in;               /**< input slot, NULL if dropped */
+  smpl_t *cur_out;              /**< output slot, NULL to play silence */
+  uint_t wake_pending;          /**< 1 if the worker was not woken up yet */
+
+  aubio_io_mutex_t mutex;
+  aubio_io_cond_t cond;
+  aubio_io_thread_t thread;
+  uint_t quit;
+  uint_t running;
+};
+
+AUBIO_IO_THREAD_FUNC(aubio_rthost_thread)
+{
+  aubio_rthost_t *o = (aubio_rthost_t *)arg;
+  uint_t processed = 0, quit = 0, slot;
+  while (!quit) {
+    AUBIO_IO_LOCK(o);
+    while (!o->quit && AUBIO_ATOMIC_LOAD(o->written) == processed) {
+      AUBIO_IO_WAIT(o);
+    }
+    quit = o->quit;
+    AUBIO_IO_UNLOCK(o);
+    // process all the pending hops before sleeping or stopping
+    while (AUBIO_ATOMIC_LOAD(o->written) != processed) {
+      slot = processed % o->n_slots;
+      fvec_zeros(o->outputs[slot]);
+      o->func(o->data, o->inputs[slot], o->outputs[slot]);
+      processed++;
+      AUBIO_ATOMIC_STORE(o->processed, processed);
+    }
+  }
+  AUBIO_IO_THREAD_RETURN;
+}
+
+aubio_rthost_t *new_aubio_rthost (uint_t hop_size, uint_t latency,
+    aubio_rthost_func_t func, void *data)
+{
+  aubio_rthost_t *o;
+  uint_t i;
+  if ((sint_t)hop_size < 1) {
+    AUBIO_ERR("rthost: got hop_size %d, expected > 0\n", hop_size);
+    return NULL;
+  }
+  if ((sint_t)latency < 1) {
+    AUBIO_ERR("rthost: got latency %d, expected > 0\n", latency);
+    return NULL;
+  }
+  if (!func) {
+    AUBIO_ERR("rthost: func should not be NULL\n");
+    return NULL;
+  }
+  o = AUBIO_NEW(aubio_rthost_t);
+  if (!o) return NULL;
+  o->hop_size = hop_size;
+  o->latency = latency;
+  // the hop being played, the `latency` hops waiting for it, and the one
+  // being filled
+  o->n_slots = latency + 2;
+  o->func = func;
+  o->data = data;
+  o->inputs = AUBIO_ARRAY(fvec_t *, o->n_slots);
+  o->outputs = AUBIO_ARRAY(fvec_t *, o->n_slots);
+  if (!o->inputs || !o->outputs) goto beach;
+  for (i = 0; i < o->n_slots; i++) {
+    o->inputs[i] = new_fvec(hop_size);
+    o->outputs[i] = new_fvec(hop_size);
+    if (!o->inputs[i] || !o->outputs[i]) goto beach;
+  }
+  AUBIO_IO_THREAD_INIT(o);
+  o->running = AUBIO_IO_THREAD_START(o, aubio_rthost_thread,
+      AUBIO_THREAD_STREAM);
+  if (!o->running) {
+    AUBIO_ERR("rthost: failed starting worker thread\n");
+    AUBIO_IO_THREAD_DESTROY(o);
+    goto beach;
+  }
+  return o;
+
+beach:
+  del_aubio_rthost(o);
+  return NULL;
+}
+
+static void aubio_rthost_wake (aubio_rthost_t *o)
+{
+  // never wait for the worker; if it holds the mutex, it is about to check
+  // for new hops or to sleep, and the next call will try again
+  if (AUBIO_IO_TRYLOCK(o)) {
+    AUBIO_IO_WAKE(o);
+    AUBIO_IO_UNLOCK(o);
+    o->wake_pending = 0;
+  } else {
+    o->wake_pending = 1;
+  }
+}
+
+static void aubio_rthost_start_hop (aubio_rthost_t *o)
+{
+  uint_t processed = AUBIO_ATOMIC_LOAD(o->processed);
+  o->cur_out = NULL;
+  if (o->written - o->played > o->latency) {
+    if ((sint_t)(processed - o->played) > 0) {
+      o->cur_out = o->outputs[o->played % o->n_slots]->data;
+    } else {
+      // skip it, its slot is reused once the worker is done with it
+      o->played++;
+      AUBIO_ATOMIC_STORE(o->late, o->late + 1);
+    }
+  }
+  if (o->written - o->played < o->n_slots
+      && o->written - processed < o->n_slots) {
+    o->cur_in = o->inputs[o->written % o->n_slots];
+  } else {
+    o->cur_in = NULL;
+    AUBIO_ATOMIC_STORE(o->dropped, o->dropped + 1);
+  }
+}
+
+static void aubio_rthost_end_hop (aubio_rthost_t *o)
+{
+  if (o->cur_out) {
+    o->played++;
+  }
+  if (o->cur_in) {
+    AUBIO_ATOMIC_STORE(o->written, o->written + 1);
+    aubio_rthost_wake(o);
+  }
+}
+
+void aubio_rthost_do (aubio_rthost_t *o, const fvec_t *input,
+    fvec_t *output)
+{
+  uint_t j = 0, n;
+  if (o->wake_pending) {
+    aubio_rthost_wake(o);
+  }
+  while (j < input->length) {
+    if (o->pos == 0) {
+      aubio_rthost_start_hop(o);
+    }
+    n = MIN(input->length - j, o->hop_size - o->pos);
+    if (o->cur_in) {
+      memcpy(o->cur_in->data + o->pos, input->data + j, n * sizeof(smpl_t));
+    }
+    if (output && o->cur_out) {
+      memcpy(output->data + j, o->cur_out + o->pos, n * sizeof(smpl_t));
+    } else if (output) {
+      memset(output->data + j, 0, n * sizeof(smpl_t));
+    }
+    o->pos += n;
+    j += n;
+    if (o->pos == o->hop_size) {
+      aubio_rthost_end_hop(o);
+      o->pos = 0;
+    }
+  }
+}
+
+uint_t aubio_rthost_get_delay (const aubio_rthost_t *o)
+{
+  return o->latency * o->hop_size;
+}
+
+uint_t aubio_rthost_get_dropped (const aubio_rthost_t *o)
+{
+  return AUBIO_ATOMIC_LOAD(o->dropped);
+}
+
+uint_t aubio_rthost_get_late (const aubio_rthost_t *o)
+{
+  return AUBIO_ATOMIC_LOAD(o->late);
+}
+
+uint_t aubio_rthost_get_processed (const aubio_rthost_t *o)
+{
+  return AUBIO_ATOMIC_LOAD(o->processed);
+}
+
+void del_aubio_rthost (aubio_rthost_t *o)
+{
+  uint_t i;
+  AUBIO_ASSERT(o);
+  if (o->running) {
+    AUBIO_IO_LOCK(o);
+    o->quit = 1;
+    AUBIO_IO_WAKE(o);
+    AUBIO_IO_UNLOCK(o);
+    AUBIO_IO_THREAD_JOIN(o);
+    AUBIO_IO_THREAD_DESTROY(o);
+  }
+  for (i = 0; i < o->n_slots; i++) {
+    if (o->inputs && o->inputs[i]) del_fvec(o->inputs[i]);
+    if (o->outputs && o->outputs[i]) del_fvec(o->outputs[i]);
+  }
+  if (o->inputs) AUBIO_FREE(o->inputs);
+  if (o->outputs) AUBIO_FREE(o->outputs);
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,137 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_RTHOST_H
+#define AUBIO_RTHOST_H
+
+/** \file
+
+  Analysis of a real-time stream on a worker thread
+
+  This object moves the analysis of an audio stream, for instance the one of
+  a JACK process callback, out of the real-time thread. The real-time thread
+  passes its frames to ::aubio_rthost_do, which cuts them into hops, and
+  hands each hop to a worker thread through a lock-free ring. The worker
+  calls the analysis function on each hop, and the output it writes is
+  played `latency` hops later than it would be if the function was called
+  directly.
+
+  ::aubio_rthost_do never blocks, allocates memory, or waits for the worker.
+  When the ring is full, the input hop is dropped; when the output of a hop
+  is not ready in time, silence is played instead. Both cases are counted,
+  and the counters can be read from any thread.
+
+  \example utils/test-rthost.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** real-time host object */
+typedef struct _aubio_rthost_t aubio_rthost_t;
+
+/** function called by the worker thread on each hop
+
+  \param data user data, as passed to ::new_aubio_rthost
+  \param input hop of input frames
+  \param output hop of output frames, set to zero before each call
+
+*/
+typedef void (*aubio_rthost_func_t)(void *data, fvec_t *input,
+    fvec_t *output);
+
+/** create real-time host and start its worker thread
+
+  \param hop_size number of frames passed to `func` at once
+  \param latency number of hops the worker has to process each hop, at
+  least 1
+  \param func function to run on each hop
+  \param data user data passed to `func`
+
+  \return newly created ::aubio_rthost_t, or NULL on failure
+
+*/
+aubio_rthost_t *new_aubio_rthost (uint_t hop_size, uint_t latency,
+    aubio_rthost_func_t func, void *data);
+
+/** pass frames from the real-time thread
+
+  \param o real-time host, created by ::new_aubio_rthost
+  \param input input frames, of any length
+  \param output output frames, same length as `input`, or NULL
+
+  This function should always be called from the same thread.
+
+*/
+void aubio_rthost_do (aubio_rthost_t *o, const fvec_t *input,
+    fvec_t *output);
+
+/** get the delay added to the output, in frames
+
+  \param o real-time host, created by ::new_aubio_rthost
+
+  \return `latency` times `hop_size`
+
+*/
+uint_t aubio_rthost_get_delay (const aubio_rthost_t *o);
+
+/** get number of input hops dropped because the worker was behind
+
+  \param o real-time host, created by ::new_aubio_rthost
+
+  \return number of dropped hops
+
+*/
+uint_t aubio_rthost_get_dropped (const aubio_rthost_t *o);
+
+/** get number of output hops not ready in time
+
+  \param o real-time host, created by ::new_aubio_rthost
+
+  \return number of late hops, each of which was played as silence
+
+*/
+uint_t aubio_rthost_get_late (const aubio_rthost_t *o);
+
+/** get number of hops processed by the worker thread
+
+  \param o real-time host, created by ::new_aubio_rthost
+
+  \return number of hops processed
+
+*/
+uint_t aubio_rthost_get_processed (const aubio_rthost_t *o);
+
+/** stop worker thread and delete real-time host
+
+  \param o real-time host, created by ::new_aubio_rthost
+
+  The hops already passed to the worker are processed before it stops.
+
+*/
+void del_aubio_rthost (aubio_rthost_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_RTHOST_H */
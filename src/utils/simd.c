@@ -0,0 +1,629 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+
+/* webassembly first, emscripten may also define the x86 macros when
+ * emulating the sse intrinsics */
+#if defined(__wasm_simd128__)
+#define AUBIO_SIMD_WASM 1
+#include <wasm_simd128.h>
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AUBIO_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUBIO_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+/* function attributes are only needed with gcc and clang, msvc exposes all
+ * intrinsics without specific flags */
+#if defined(__GNUC__) || defined(__clang__)
+#define AUBIO_SIMD_ATTR(isa) __attribute__((target(isa)))
+#else
+#define AUBIO_SIMD_ATTR(isa)
+#endif
+
+const aubio_simd_ops_t *aubio_simd_ops = NULL;
+
+uint_t aubio_simd_fast_math = 0;
+
+/* number of terms of the series used by the log approximation, enough to
+ * reach the precision of smpl_t, and the power of two bringing subnormal
+ * numbers back to normal ones */
+#if !HAVE_AUBIO_DOUBLE
+#define AUBIO_SIMD_LOG_TERMS 6
+#define AUBIO_SIMD_LOG_SUBNORMAL 24.
+#define FREXP frexpf
+#else
+#define AUBIO_SIMD_LOG_TERMS 16
+#define AUBIO_SIMD_LOG_SUBNORMAL 54.
+#define FREXP frexp
+#endif
+#define AUBIO_SIMD_LN2 0.69314718055994530942
+
+/* number of terms of the series used by the exp, atan2 and sin / cos
+ * approximations, the largest argument of exp, with log(2) and pi / 2 split
+ * in a part exact in smpl_t and the rest, and the smallest normal number */
+#if !HAVE_AUBIO_DOUBLE
+#define AUBIO_SIMD_EXP_TERMS 8
+#define AUBIO_SIMD_ATAN_TERMS 5
+#define AUBIO_SIMD_SINCOS_TERMS 6
+#define AUBIO_SIMD_EXP_MAX 87.
+#define AUBIO_SIMD_LN2_HI 0.693359375
+#define AUBIO_SIMD_LN2_LO -2.12194440e-4
+#define AUBIO_SIMD_PIO2_HI 1.5703125
+#define AUBIO_SIMD_PIO2_LO 4.83826794897e-4
+#define AUBIO_SIMD_TINY 1.17549435e-38
+#define LDEXP ldexpf
+#else
+#define AUBIO_SIMD_EXP_TERMS 14
+#define AUBIO_SIMD_ATAN_TERMS 11
+#define AUBIO_SIMD_SINCOS_TERMS 9
+#define AUBIO_SIMD_EXP_MAX 708.
+#define AUBIO_SIMD_LN2_HI 6.93147180369123816490e-01
+#define AUBIO_SIMD_LN2_LO 1.90821492927058770002e-10
+#define AUBIO_SIMD_PIO2_HI 1.57079632673412561417e+00
+#define AUBIO_SIMD_PIO2_LO 6.07710050650619224932e-11
+#define AUBIO_SIMD_TINY 2.2250738585072014e-308
+#define LDEXP ldexp
+#endif
+#define AUBIO_SIMD_LOG2E 1.44269504088896340736
+
+static smpl_t aubio_simd_scalar_exponent (smpl_t x)
+{
+  int e;
+  FREXP(x, &e);
+  return (smpl_t)(e - 1);
+}
+
+static smpl_t aubio_simd_scalar_mantissa (smpl_t x)
+{
+  int e;
+  return 2. * FREXP(x, &e);
+}
+
+static smpl_t aubio_simd_scalar_pow2 (smpl_t e)
+{
+  return LDEXP(1., (int)e);
+}
+
+/* scalar reference kernels */
+#define SIMD_FN(f)        aubio_simd_scalar_ ## f
+#define SIMD_NAME         "scalar"
+#define SIMD_TARGET
+#define SIMD_VEC          smpl_t
+#define SIMD_W            1
+#define SIMD_LOAD(p)      (*(p))
+#define SIMD_STORE(p,v)   (*(p) = (v))
+#define SIMD_SET1(x)      (x)
+#define SIMD_ADD(a,b)     ((a) + (b))
+#define SIMD_SUB(a,b)     ((a) - (b))
+#define SIMD_MUL(a,b)     ((a) * (b))
+#define SIMD_MAX(a,b)     (((a) > (b)) ? (a) : (b))
+#define SIMD_MIN(a,b)     (((a) < (b)) ? (a) : (b))
+#define SIMD_SQRT(a)      SQRT(a)
+#define SIMD_DIV(a,b)     ((a) / (b))
+#define SIMD_ROUND(a)     FLOOR((a) + .5)
+#define SIMD_SELECT_GT(a,b,c) (((a) > (b)) ? (c) : 0.)
+#define SIMD_EXPONENT(a)  aubio_simd_scalar_exponent(a)
+#define SIMD_MANTISSA(a)  aubio_simd_scalar_mantissa(a)
+#define SIMD_POW2(a)      aubio_simd_scalar_pow2(a)
+#define SIMD_GATHER(p,i)  ((p)[(uint_t)(i)])
+#include "utils/simd_kernels_priv.h"
+#undef SIMD_FN
+#undef SIMD_NAME
+#undef SIMD_TARGET
+#undef SIMD_VEC
+#undef SIMD_W
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_SET1
+#undef SIMD_ADD
+#undef SIMD_SUB
+#undef SIMD_MUL
+#undef SIMD_MAX
+#undef SIMD_MIN
+#undef SIMD_SQRT
+#undef SIMD_DIV
+#undef SIMD_ROUND
+#undef SIMD_SELECT_GT
+#undef SIMD_EXPONENT
+#undef SIMD_MANTISSA
+#undef SIMD_POW2
+#undef SIMD_GATHER
+
+#if defined(AUBIO_SIMD_X86)
+
+/* sse2 kernels */
+#define SIMD_FN(f)        aubio_simd_sse2_ ## f
+#define SIMD_NAME         "sse2"
+#define SIMD_TARGET       AUBIO_SIMD_ATTR("sse2")
+#if !HAVE_AUBIO_DOUBLE
+#define SIMD_VEC          __m128
+#define SIMD_W            4
+#define SIMD_LOAD(p)      _mm_loadu_ps(p)
+#define SIMD_STORE(p,v)   _mm_storeu_ps(p, v)
+#define SIMD_SET1(x)      _mm_set1_ps(x)
+#define SIMD_ADD(a,b)     _mm_add_ps(a, b)
+#define SIMD_SUB(a,b)     _mm_sub_ps(a, b)
+#define SIMD_MUL(a,b)     _mm_mul_ps(a, b)
+#define SIMD_MAX(a,b)     _mm_max_ps(a, b)
+#define SIMD_MIN(a,b)     _mm_min_ps(a, b)
+#define SIMD_SQRT(a)      _mm_sqrt_ps(a)
+#define SIMD_DIV(a,b)     _mm_div_ps(a, b)
+/* adding and removing 1.5 * 2^23 rounds to the nearest integer */
+#define SIMD_ROUND(a)     _mm_sub_ps(_mm_add_ps(a, _mm_set1_ps(12582912.f)), \
+      _mm_set1_ps(12582912.f))
+#define SIMD_SELECT_GT(a,b,c) _mm_and_ps(_mm_cmpgt_ps(a, b), c)
+#define SIMD_EXPONENT(a)  _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128( \
+      _mm_srli_epi32(_mm_castps_si128(a), 23), _mm_set1_epi32(0x4b000000))), \
+      _mm_set1_ps(8388608.f + 127.f))
+#define SIMD_MANTISSA(a)  _mm_castsi128_ps(_mm_or_si128(_mm_and_si128( \
+      _mm_castps_si128(a), _mm_set1_epi32(0x007fffff)), \
+      _mm_set1_epi32(0x3f800000)))
+#define SIMD_POW2(a)      _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128( \
+      _mm_add_ps(a, _mm_set1_ps(8388608.f + 127.f))), 23))
+#else
+#define SIMD_VEC          __m128d
+#define SIMD_W            2
+#define SIMD_LOAD(p)      _mm_loadu_pd(p)
+#define SIMD_STORE(p,v)   _mm_storeu_pd(p, v)
+#define SIMD_SET1(x)      _mm_set1_pd(x)
+#define SIMD_ADD(a,b)     _mm_add_pd(a, b)
+#define SIMD_SUB(a,b)     _mm_sub_pd(a, b)
+#define SIMD_MUL(a,b)     _mm_mul_pd(a, b)
+#define SIMD_MAX(a,b)     _mm_max_pd(a, b)
+#define SIMD_MIN(a,b)     _mm_min_pd(a, b)
+#define SIMD_SQRT(a)      _mm_sqrt_pd(a)
+#define SIMD_DIV(a,b)     _mm_div_pd(a, b)
+/* adding and removing 1.5 * 2^52 rounds to the nearest integer */
+#define SIMD_ROUND(a)     _mm_sub_pd(_mm_add_pd(a, \
+      _mm_set1_pd(6755399441055744.)), _mm_set1_pd(6755399441055744.))
+#define SIMD_SELECT_GT(a,b,c) _mm_and_pd(_mm_cmpgt_pd(a, b), c)
+#define SIMD_EXPONENT(a)  _mm_sub_pd(_mm_castsi128_pd(_mm_or_si128( \
+      _mm_srli_epi64(_mm_castpd_si128(a), 52), \
+      _mm_set1_epi64x(0x4330000000000000LL))), \
+      _mm_set1_pd(4503599627370496. + 1023.))
+#define SIMD_MANTISSA(a)  _mm_castsi128_pd(_mm_or_si128(_mm_and_si128( \
+      _mm_castpd_si128(a), _mm_set1_epi64x(0x000fffffffffffffLL)), \
+      _mm_set1_epi64x(0x3ff0000000000000LL)))
+#define SIMD_POW2(a)      _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128( \
+      _mm_add_pd(a, _mm_set1_pd(4503599627370496. + 1023.))), 52))
+#endif
+#include "utils/simd_kernels_priv.h"
+#undef SIMD_FN
+#undef SIMD_NAME
+#undef SIMD_TARGET
+#undef SIMD_VEC
+#undef SIMD_W
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_SET1
+#undef SIMD_ADD
+#undef SIMD_SUB
+#undef SIMD_MUL
+#undef SIMD_MAX
+#undef SIMD_MIN
+#undef SIMD_SQRT
+#undef SIMD_DIV
+#undef SIMD_ROUND
+#undef SIMD_SELECT_GT
+#undef SIMD_EXPONENT
+#undef SIMD_MANTISSA
+#undef SIMD_POW2
+
+/* avx2 kernels */
+#define SIMD_FN(f)        aubio_simd_avx2_ ## f
+#define SIMD_NAME         "avx2"
+#define SIMD_TARGET       AUBIO_SIMD_ATTR("avx2")
+#if !HAVE_AUBIO_DOUBLE
+#define SIMD_VEC          __m256
+#define SIMD_W            8
+#define SIMD_LOAD(p)      _mm256_loadu_ps(p)
+#define SIMD_STORE(p,v)   _mm256_storeu_ps(p, v)
+#define SIMD_SET1(x)      _mm256_set1_ps(x)
+#define SIMD_ADD(a,b)     _mm256_add_ps(a, b)
+#define SIMD_SUB(a,b)     _mm256_sub_ps(a, b)
+#define SIMD_MUL(a,b)     _mm256_mul_ps(a, b)
+#define SIMD_MAX(a,b)     _mm256_max_ps(a, b)
+#define SIMD_MIN(a,b)     _mm256_min_ps(a, b)
+#define SIMD_SQRT(a)      _mm256_sqrt_ps(a)
+#define SIMD_DIV(a,b)     _mm256_div_ps(a, b)
+#define SIMD_ROUND(a)     _mm256_round_ps(a, \
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define SIMD_SELECT_GT(a,b,c) _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ), c)
+#define SIMD_EXPONENT(a)  _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256( \
+      _mm256_srli_epi32(_mm256_castps_si256(a), 23), \
+      _mm256_set1_epi32(0x4b000000))), _mm256_set1_ps(8388608.f + 127.f))
+#define SIMD_MANTISSA(a)  _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256( \
+      _mm256_castps_si256(a), _mm256_set1_epi32(0x007fffff)), \
+      _mm256_set1_epi32(0x3f800000)))
+#define SIMD_POW2(a)      _mm256_castsi256_ps(_mm256_slli_epi32( \
+      _mm256_castps_si256(_mm256_add_ps(a, _mm256_set1_ps(8388608.f + 127.f))), \
+      23))
+#define SIMD_GATHER(p,i)  _mm256_i32gather_ps(p, _mm256_cvttps_epi32(i), 4)
+#else
+#define SIMD_VEC          __m256d
+#define SIMD_W            4
+#define SIMD_LOAD(p)      _mm256_loadu_pd(p)
+#define SIMD_STORE(p,v)   _mm256_storeu_pd(p, v)
+#define SIMD_SET1(x)      _mm256_set1_pd(x)
+#define SIMD_ADD(a,b)     _mm256_add_pd(a, b)
+#define SIMD_SUB(a,b)     _mm256_sub_pd(a, b)
+#define SIMD_MUL(a,b)     _mm256_mul_pd(a, b)
+#define SIMD_MAX(a,b)     _mm256_max_pd(a, b)
+#define SIMD_MIN(a,b)     _mm256_min_pd(a, b)
+#define SIMD_SQRT(a)      _mm256_sqrt_pd(a)
+#define SIMD_DIV(a,b)     _mm256_div_pd(a, b)
+#define SIMD_ROUND(a)     _mm256_round_pd(a, \
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define SIMD_SELECT_GT(a,b,c) _mm256_and_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ), c)
+#define SIMD_EXPONENT(a)  _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256( \
+      _mm256_srli_epi64(_mm256_castpd_si256(a), 52), \
+      _mm256_set1_epi64x(0x4330000000000000LL))), \
+      _mm256_set1_pd(4503599627370496. + 1023.))
+#define SIMD_MANTISSA(a)  _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256( \
+      _mm256_castpd_si256(a), _mm256_set1_epi64x(0x000fffffffffffffLL)), \
+      _mm256_set1_epi64x(0x3ff0000000000000LL)))
+#define SIMD_POW2(a)      _mm256_castsi256_pd(_mm256_slli_epi64( \
+      _mm256_castpd_si256(_mm256_add_pd(a, \
+      _mm256_set1_pd(4503599627370496. + 1023.))), 52))
+#define SIMD_GATHER(p,i)  _mm256_i32gather_pd(p, _mm256_cvttpd_epi32(i), 8)
+#endif
+#include "utils/simd_kernels_priv.h"
+#undef SIMD_FN
+#undef SIMD_NAME
+#undef SIMD_TARGET
+#undef SIMD_VEC
+#undef SIMD_W
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_SET1
+#undef SIMD_ADD
+#undef SIMD_SUB
+#undef SIMD_MUL
+#undef SIMD_MAX
+#undef SIMD_MIN
+#undef SIMD_SQRT
+#undef SIMD_DIV
+#undef SIMD_ROUND
+#undef SIMD_SELECT_GT
+#undef SIMD_EXPONENT
+#undef SIMD_MANTISSA
+#undef SIMD_POW2
+#undef SIMD_GATHER
+
+/* avx-512 kernels */
+#define SIMD_FN(f)        aubio_simd_avx512_ ## f
+#define SIMD_NAME         "avx512"
+#define SIMD_TARGET       AUBIO_SIMD_ATTR("avx512f")
+#if !HAVE_AUBIO_DOUBLE
+#define SIMD_VEC          __m512
+#define SIMD_W            16
+#define SIMD_LOAD(p)      _mm512_loadu_ps(p)
+#define SIMD_STORE(p,v)   _mm512_storeu_ps(p, v)
+#define SIMD_SET1(x)      _mm512_set1_ps(x)
+#define SIMD_ADD(a,b)     _mm512_add_ps(a, b)
+#define SIMD_SUB(a,b)     _mm512_sub_ps(a, b)
+#define SIMD_MUL(a,b)     _mm512_mul_ps(a, b)
+#define SIMD_MAX(a,b)     _mm512_max_ps(a, b)
+#define SIMD_MIN(a,b)     _mm512_min_ps(a, b)
+#define SIMD_SQRT(a)      _mm512_sqrt_ps(a)
+#define SIMD_DIV(a,b)     _mm512_div_ps(a, b)
+#define SIMD_ROUND(a)     _mm512_roundscale_ps(a, \
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define SIMD_SELECT_GT(a,b,c) \
+      _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(a, b, _CMP_GT_OQ), c)
+#define SIMD_EXPONENT(a)  _mm512_sub_ps(_mm512_castsi512_ps(_mm512_or_si512( \
+      _mm512_srli_epi32(_mm512_castps_si512(a), 23), \
+      _mm512_set1_epi32(0x4b000000))), _mm512_set1_ps(8388608.f + 127.f))
+#define SIMD_MANTISSA(a)  _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512( \
+      _mm512_castps_si512(a), _mm512_set1_epi32(0x007fffff)), \
+      _mm512_set1_epi32(0x3f800000)))
+#define SIMD_POW2(a)      _mm512_castsi512_ps(_mm512_slli_epi32( \
+      _mm512_castps_si512(_mm512_add_ps(a, _mm512_set1_ps(8388608.f + 127.f))), \
+      23))
+#define SIMD_GATHER(p,i)  _mm512_i32gather_ps(_mm512_cvttps_epi32(i), p, 4)
+#else
+#define SIMD_VEC          __m512d
+#define SIMD_W            8
+#define SIMD_LOAD(p)      _mm512_loadu_pd(p)
+#define SIMD_STORE(p,v)   _mm512_storeu_pd(p, v)
+#define SIMD_SET1(x)      _mm512_set1_pd(x)
+#define SIMD_ADD(a,b)     _mm512_add_pd(a, b)
+#define SIMD_SUB(a,b)     _mm512_sub_pd(a, b)
+#define SIMD_MUL(a,b)     _mm512_mul_pd(a, b)
+#define SIMD_MAX(a,b)     _mm512_max_pd(a, b)
+#define SIMD_MIN(a,b)     _mm512_min_pd(a, b)
+#define SIMD_SQRT(a)      _mm512_sqrt_pd(a)
+#define SIMD_DIV(a,b)     _mm512_div_pd(a, b)
+#define SIMD_ROUND(a)     _mm512_roundscale_pd(a, \
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)
+#define SIMD_SELECT_GT(a,b,c) \
+      _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(a, b, _CMP_GT_OQ), c)
+#define SIMD_EXPONENT(a)  _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512( \
+      _mm512_srli_epi64(_mm512_castpd_si512(a), 52), \
+      _mm512_set1_epi64(0x4330000000000000LL))), \
+      _mm512_set1_pd(4503599627370496. + 1023.))
+#define SIMD_MANTISSA(a)  _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512( \
+      _mm512_castpd_si512(a), _mm512_set1_epi64(0x000fffffffffffffLL)), \
+      _mm512_set1_epi64(0x3ff0000000000000LL)))
+#define SIMD_POW2(a)      _mm512_castsi512_pd(_mm512_slli_epi64( \
+      _mm512_castpd_si512(_mm512_add_pd(a, \
+      _mm512_set1_pd(4503599627370496. + 1023.))), 52))
+#define SIMD_GATHER(p,i)  _mm512_i32gather_pd(_mm512_cvttpd_epi32(i), p, 8)
+#endif
+#include "utils/simd_kernels_priv.h"
+#undef SIMD_FN
+#undef SIMD_NAME
+#undef SIMD_TARGET
+#undef SIMD_VEC
+#undef SIMD_W
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_SET1
+#undef SIMD_ADD
+#undef SIMD_SUB
+#undef SIMD_MUL
+#undef SIMD_MAX
+#undef SIMD_MIN
+#undef SIMD_SQRT
+#undef SIMD_DIV
+#undef SIMD_ROUND
+#undef SIMD_SELECT_GT
+#undef SIMD_EXPONENT
+#undef SIMD_MANTISSA
+#undef SIMD_POW2
+#undef SIMD_GATHER
+
+#elif defined(AUBIO_SIMD_NEON)
+
+/* neon kernels, always available on aarch64 */
+#define SIMD_FN(f)        aubio_simd_neon_ ## f
+#define SIMD_NAME         "neon"
+#define SIMD_TARGET
+#if !HAVE_AUBIO_DOUBLE
+#define SIMD_VEC          float32x4_t
+#define SIMD_W            4
+#define SIMD_LOAD(p)      vld1q_f32(p)
+#define SIMD_STORE(p,v)   vst1q_f32(p, v)
+#define SIMD_SET1(x)      vdupq_n_f32(x)
+#define SIMD_ADD(a,b)     vaddq_f32(a, b)
+#define SIMD_SUB(a,b)     vsubq_f32(a, b)
+#define SIMD_MUL(a,b)     vmulq_f32(a, b)
+/* vmaxq propagates NaNs from either side, use a compare and select instead */
+#define SIMD_MAX(a,b)     vbslq_f32(vcgtq_f32(a, b), a, b)
+#define SIMD_MIN(a,b)     vbslq_f32(vcltq_f32(a, b), a, b)
+#define SIMD_SQRT(a)      vsqrtq_f32(a)
+#define SIMD_DIV(a,b)     vdivq_f32(a, b)
+#define SIMD_ROUND(a)     vrndnq_f32(a)
+#define SIMD_SELECT_GT(a,b,c) vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(a, b), \
+      vreinterpretq_u32_f32(c)))
+#define SIMD_EXPONENT(a)  vsubq_f32(vreinterpretq_f32_u32(vorrq_u32( \
+      vshrq_n_u32(vreinterpretq_u32_f32(a), 23), vdupq_n_u32(0x4b000000))), \
+      vdupq_n_f32(8388608.f + 127.f))
+#define SIMD_MANTISSA(a)  vreinterpretq_f32_u32(vorrq_u32(vandq_u32( \
+      vreinterpretq_u32_f32(a), vdupq_n_u32(0x007fffff)), \
+      vdupq_n_u32(0x3f800000)))
+#define SIMD_POW2(a)      vreinterpretq_f32_u32(vshlq_n_u32(vreinterpretq_u32_f32( \
+      vaddq_f32(a, vdupq_n_f32(8388608.f + 127.f))), 23))
+#else
+#define SIMD_VEC          float64x2_t
+#define SIMD_W            2
+#define SIMD_LOAD(p)      vld1q_f64(p)
+#define SIMD_STORE(p,v)   vst1q_f64(p, v)
+#define SIMD_SET1(x)      vdupq_n_f64(x)
+#define SIMD_ADD(a,b)     vaddq_f64(a, b)
+#define SIMD_SUB(a,b)     vsubq_f64(a, b)
+#define SIMD_MUL(a,b)     vmulq_f64(a, b)
+#define SIMD_MAX(a,b)     vbslq_f64(vcgtq_f64(a, b), a, b)
+#define SIMD_MIN(a,b)     vbslq_f64(vcltq_f64(a, b), a, b)
+#define SIMD_SQRT(a)      vsqrtq_f64(a)
+#define SIMD_DIV(a,b)     vdivq_f64(a, b)
+#define SIMD_ROUND(a)     vrndnq_f64(a)
+#define SIMD_SELECT_GT(a,b,c) vreinterpretq_f64_u64(vandq_u64(vcgtq_f64(a, b), \
+      vreinterpretq_u64_f64(c)))
+#define SIMD_EXPONENT(a)  vsubq_f64(vreinterpretq_f64_u64(vorrq_u64( \
+      vshrq_n_u64(vreinterpretq_u64_f64(a), 52), \
+      vdupq_n_u64(0x4330000000000000ULL))), \
+      vdupq_n_f64(4503599627370496. + 1023.))
+#define SIMD_MANTISSA(a)  vreinterpretq_f64_u64(vorrq_u64(vandq_u64( \
+      vreinterpretq_u64_f64(a), vdupq_n_u64(0x000fffffffffffffULL)), \
+      vdupq_n_u64(0x3ff0000000000000ULL)))
+#define SIMD_POW2(a)      vreinterpretq_f64_u64(vshlq_n_u64(vreinterpretq_u64_f64( \
+      vaddq_f64(a, vdupq_n_f64(4503599627370496. + 1023.))), 52))
+#endif
+#include "utils/simd_kernels_priv.h"
+#undef SIMD_FN
+#undef SIMD_NAME
+#undef SIMD_TARGET
+#undef SIMD_VEC
+#undef SIMD_W
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_SET1
+#undef SIMD_ADD
+#undef SIMD_SUB
+#undef SIMD_MUL
+#undef SIMD_MAX
+#undef SIMD_MIN
+#undef SIMD_SQRT
+#undef SIMD_DIV
+#undef SIMD_ROUND
+#undef SIMD_SELECT_GT
+#undef SIMD_EXPONENT
+#undef SIMD_MANTISSA
+#undef SIMD_POW2
+
+#elif defined(AUBIO_SIMD_WASM)
+
+/* webassembly simd128 kernels; the module is built with -msimd128 and a
+ * runtime without simd support refuses to load it, so no detection is needed */
+#define SIMD_FN(f)        aubio_simd_wasm_ ## f
+#define SIMD_NAME         "wasm"
+#define SIMD_TARGET
+#define SIMD_VEC          v128_t
+#define SIMD_LOAD(p)      wasm_v128_load(p)
+#define SIMD_STORE(p,v)   wasm_v128_store(p, v)
+#if !HAVE_AUBIO_DOUBLE
+#define SIMD_W            4
+#define SIMD_SET1(x)      wasm_f32x4_splat(x)
+#define SIMD_ADD(a,b)     wasm_f32x4_add(a, b)
+#define SIMD_SUB(a,b)     wasm_f32x4_sub(a, b)
+#define SIMD_MUL(a,b)     wasm_f32x4_mul(a, b)
+/* f32x4.max propagates NaNs too, select on the comparison as with neon */
+#define SIMD_MAX(a,b)     wasm_v128_bitselect(a, b, wasm_f32x4_gt(a, b))
+#define SIMD_MIN(a,b)     wasm_v128_bitselect(a, b, wasm_f32x4_lt(a, b))
+#define SIMD_SQRT(a)      wasm_f32x4_sqrt(a)
+#define SIMD_DIV(a,b)     wasm_f32x4_div(a, b)
+#define SIMD_ROUND(a)     wasm_f32x4_nearest(a)
+#define SIMD_SELECT_GT(a,b,c) wasm_v128_and(wasm_f32x4_gt(a, b), c)
+#define SIMD_EXPONENT(a)  wasm_f32x4_sub(wasm_v128_or(wasm_u32x4_shr(a, 23), \
+      wasm_i32x4_splat(0x4b000000)), wasm_f32x4_splat(8388608.f + 127.f))
+#define SIMD_MANTISSA(a)  wasm_v128_or(wasm_v128_and(a, \
+      wasm_i32x4_splat(0x007fffff)), wasm_i32x4_splat(0x3f800000))
+#define SIMD_POW2(a)      wasm_i32x4_shl(wasm_f32x4_add(a, \
+      wasm_f32x4_splat(8388608.f + 127.f)), 23)
+#else
+#define SIMD_W            2
+#define SIMD_SET1(x)      wasm_f64x2_splat(x)
+#define SIMD_ADD(a,b)     wasm_f64x2_add(a, b)
+#define SIMD_SUB(a,b)     wasm_f64x2_sub(a, b)
+#define SIMD_MUL(a,b)     wasm_f64x2_mul(a, b)
+#define SIMD_MAX(a,b)     wasm_v128_bitselect(a, b, wasm_f64x2_gt(a, b))
+#define SIMD_MIN(a,b)     wasm_v128_bitselect(a, b, wasm_f64x2_lt(a, b))
+#define SIMD_SQRT(a)      wasm_f64x2_sqrt(a)
+#define SIMD_DIV(a,b)     wasm_f64x2_div(a, b)
+#define SIMD_ROUND(a)     wasm_f64x2_nearest(a)
+#define SIMD_SELECT_GT(a,b,c) wasm_v128_and(wasm_f64x2_gt(a, b), c)
+#define SIMD_EXPONENT(a)  wasm_f64x2_sub(wasm_v128_or(wasm_u64x2_shr(a, 52), \
+      wasm_i64x2_splat(0x4330000000000000LL)), \
+      wasm_f64x2_splat(4503599627370496. + 1023.))
+#define SIMD_MANTISSA(a)  wasm_v128_or(wasm_v128_and(a, \
+      wasm_i64x2_splat(0x000fffffffffffffLL)), \
+      wasm_i64x2_splat(0x3ff0000000000000LL))
+#define SIMD_POW2(a)      wasm_i64x2_shl(wasm_f64x2_add(a, \
+      wasm_f64x2_splat(4503599627370496. + 1023.)), 52)
+#endif
+#include "utils/simd_kernels_priv.h"
+#undef SIMD_FN
+#undef SIMD_NAME
+#undef SIMD_TARGET
+#undef SIMD_VEC
+#undef SIMD_W
+#undef SIMD_LOAD
+#undef SIMD_STORE
+#undef SIMD_SET1
+#undef SIMD_ADD
+#undef SIMD_SUB
+#undef SIMD_MUL
+#undef SIMD_MAX
+#undef SIMD_MIN
+#undef SIMD_SQRT
+#undef SIMD_DIV
+#undef SIMD_ROUND
+#undef SIMD_SELECT_GT
+#undef SIMD_EXPONENT
+#undef SIMD_MANTISSA
+#undef SIMD_POW2
+
+#endif /* AUBIO_SIMD_WASM */
+
+#if defined(AUBIO_SIMD_X86)
+/** returns 1 if the cpu and the os support the given instruction set */
+static uint_t aubio_simd_x86_has (const char_t *isa)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_cpu_init();
+  if (strcmp(isa, "sse2") == 0) return __builtin_cpu_supports("sse2");
+  if (strcmp(isa, "avx2") == 0) return __builtin_cpu_supports("avx2");
+  if (strcmp(isa, "avx512") == 0) return __builtin_cpu_supports("avx512f");
+  return 0;
+#elif defined(_MSC_VER)
+  int regs[4];
+  unsigned long long xcr0 = 0;
+  __cpuid(regs, 1);
+  if (strcmp(isa, "sse2") == 0) return (regs[3] >> 26) & 1;
+  /* osxsave must be set before querying xcr0 */
+  if (!((regs[2] >> 27) & 1)) return 0;
+  xcr0 = _xgetbv(0);
+  __cpuidex(regs, 7, 0);
+  if (strcmp(isa, "avx2") == 0) {
+    return ((xcr0 & 0x6) == 0x6) && ((regs[1] >> 5) & 1);
+  }
+  if (strcmp(isa, "avx512") == 0) {
+    return ((xcr0 & 0xe6) == 0xe6) && ((regs[1] >> 16) & 1);
+  }
+  return 0;
+#else
+  return 0;
+#endif
+}
+#endif /* AUBIO_SIMD_X86 */
+
+/** returns the kernel table for isa, or NULL if not supported here */
+static const aubio_simd_ops_t *aubio_simd_lookup (const char_t *isa)
+{
+  if (strcmp(isa, "scalar") == 0) return &aubio_simd_scalar_table;
+#if defined(AUBIO_SIMD_X86)
+  if (!aubio_simd_x86_has(isa)) return NULL;
+  if (strcmp(isa, "sse2") == 0) return &aubio_simd_sse2_table;
+  if (strcmp(isa, "avx2") == 0) return &aubio_simd_avx2_table;
+  if (strcmp(isa, "avx512") == 0) return &aubio_simd_avx512_table;
+#elif defined(AUBIO_SIMD_NEON)
+  if (strcmp(isa, "neon") == 0) return &aubio_simd_neon_table;
+#elif defined(AUBIO_SIMD_WASM)
+  if (strcmp(isa, "wasm") == 0) return &aubio_simd_wasm_table;
+#endif
+  return NULL;
+}
+
+const aubio_simd_ops_t *aubio_simd_init (void)
+{
+  /* best first */
+  static const char_t *candidates[] = { "avx512", "avx2", "sse2", "neon",
+    "wasm" };
+  const aubio_simd_ops_t *ops = NULL;
+  const char_t *forced = getenv("AUBIO_SIMD");
+  uint_t i;
+  if (forced && forced[0] != '\0') {
+    ops = aubio_simd_lookup(forced);
+    if (!ops) {
+      AUBIO_WRN("simd: AUBIO_SIMD=%s not supported, using default\n", forced);
+    }
+  }
+  for (i = 0; !ops && i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+    ops = aubio_simd_lookup(candidates[i]);
+  }
+  if (!ops) ops = &aubio_simd_scalar_table;
+  /* concurrent first calls all select the same table */
+  AUBIO_ATOMIC_STORE_PTR(aubio_simd_ops, ops);
+  return ops;
+}
+
+const aubio_simd_ops_t *aubio_simd_scalar_ops (void)
+{
+  return &aubio_simd_scalar_table;
+}
@@ -0,0 +1,1064 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Kernel template, included once per instruction set from utils/simd.c.
+
+   Before including this file, the following macros must be defined:
+
+    - SIMD_FN(f)       name of the generated function f
+    - SIMD_NAME        name of the instruction set, as a string
+    - SIMD_TARGET      function attribute enabling the instruction set
+    - SIMD_VEC         vector type
+    - SIMD_W           number of smpl_t in SIMD_VEC
+    - SIMD_LOAD(p)     unaligned load
+    - SIMD_STORE(p,v)  unaligned store
+    - SIMD_SET1(x)     broadcast
+    - SIMD_ADD(a,b), SIMD_SUB(a,b), SIMD_MUL(a,b), SIMD_DIV(a,b), SIMD_MAX(a,b),
+      SIMD_MIN(a,b), SIMD_SQRT(a)
+    - SIMD_SELECT_GT(a,b,c)  c where a > b, 0 elsewhere
+    - SIMD_ROUND(a)          a rounded to the nearest integer
+    - SIMD_EXPONENT(a)       e, as a smpl_t, with a = 2^e * m and m in [1, 2)
+    - SIMD_MANTISSA(a)       m, for finite and normal a > 0
+    - SIMD_POW2(a)           2^a, for integers a stored as smpl_t, within the
+                             exponent range of normal numbers
+
+   SIMD_GATHER(p,i), loading p[i] in each lane where i holds integers stored as
+   smpl_t, may also be defined; otherwise the lanes are loaded one by one.
+
+   SIMD_MAX(a,b) and SIMD_MIN(a,b) must return b when comparing with a NaN, to
+   match the scalar loops. Reductions store the vector accumulator and sum its
+   lanes in order; the remaining n % SIMD_W elements are processed one by one.
+*/
+
+#ifndef SIMD_GATHER
+static SIMD_VEC SIMD_TARGET
+SIMD_FN(gather) (const smpl_t *p, SIMD_VEC i)
+{
+  smpl_t idx[SIMD_W], v[SIMD_W];
+  uint_t k;
+  SIMD_STORE(idx, i);
+  for (k = 0; k < SIMD_W; k++) {
+    v[k] = p[(uint_t)idx[k]];
+  }
+  return SIMD_LOAD(v);
+}
+#define SIMD_GATHER(p,i)  SIMD_FN(gather)(p, i)
+#define SIMD_GATHER_LANES 1
+#endif
+
+static void SIMD_TARGET
+SIMD_FN(weight) (smpl_t *s, const smpl_t *w, uint_t n)
+{
+  uint_t j = 0;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(s + j, SIMD_MUL(SIMD_LOAD(s + j), SIMD_LOAD(w + j)));
+  }
+  for (; j < n; j++) {
+    s[j] *= w[j];
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(weighted_copy) (const smpl_t *in, const smpl_t *w, smpl_t *out,
+    uint_t n)
+{
+  uint_t j = 0;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(out + j, SIMD_MUL(SIMD_LOAD(in + j), SIMD_LOAD(w + j)));
+  }
+  for (; j < n; j++) {
+    out[j] = in[j] * w[j];
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(mul) (smpl_t *s, smpl_t val, uint_t n)
+{
+  uint_t j = 0;
+  SIMD_VEC v = SIMD_SET1(val);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(s + j, SIMD_MUL(SIMD_LOAD(s + j), v));
+  }
+  for (; j < n; j++) {
+    s[j] *= val;
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(add) (smpl_t *s, smpl_t val, uint_t n)
+{
+  uint_t j = 0;
+  SIMD_VEC v = SIMD_SET1(val);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(s + j, SIMD_ADD(SIMD_LOAD(s + j), v));
+  }
+  for (; j < n; j++) {
+    s[j] += val;
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(vsqrt) (smpl_t *s, uint_t n)
+{
+  uint_t j = 0;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(s + j, SIMD_SQRT(SIMD_LOAD(s + j)));
+  }
+  for (; j < n; j++) {
+    s[j] = SQRT(s[j]);
+  }
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(sum) (const smpl_t *s, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], tmp = 0.;
+  SIMD_VEC acc = SIMD_SET1(0.);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    acc = SIMD_ADD(acc, SIMD_LOAD(s + j));
+  }
+  SIMD_STORE(lanes, acc);
+  for (k = 0; k < SIMD_W; k++) {
+    tmp += lanes[k];
+  }
+  for (; j < n; j++) {
+    tmp += s[j];
+  }
+  return tmp;
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(vmax) (const smpl_t *s, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], tmp = s[0];
+  if (n >= SIMD_W) {
+    SIMD_VEC acc = SIMD_SET1(s[0]);
+    for (; j + SIMD_W <= n; j += SIMD_W) {
+      acc = SIMD_MAX(acc, SIMD_LOAD(s + j));
+    }
+    SIMD_STORE(lanes, acc);
+    for (k = 0; k < SIMD_W; k++) {
+      tmp = (tmp > lanes[k]) ? tmp : lanes[k];
+    }
+  }
+  for (; j < n; j++) {
+    tmp = (tmp > s[j]) ? tmp : s[j];
+  }
+  return tmp;
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(vmin) (const smpl_t *s, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], tmp = s[0];
+  if (n >= SIMD_W) {
+    SIMD_VEC acc = SIMD_SET1(s[0]);
+    for (; j + SIMD_W <= n; j += SIMD_W) {
+      acc = SIMD_MIN(acc, SIMD_LOAD(s + j));
+    }
+    SIMD_STORE(lanes, acc);
+    for (k = 0; k < SIMD_W; k++) {
+      tmp = (tmp < lanes[k]) ? tmp : lanes[k];
+    }
+  }
+  for (; j < n; j++) {
+    tmp = (tmp < s[j]) ? tmp : s[j];
+  }
+  return tmp;
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(dot) (const smpl_t *a, const smpl_t *b, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], tmp = 0.;
+  SIMD_VEC acc = SIMD_SET1(0.);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    acc = SIMD_ADD(acc, SIMD_MUL(SIMD_LOAD(a + j), SIMD_LOAD(b + j)));
+  }
+  SIMD_STORE(lanes, acc);
+  for (k = 0; k < SIMD_W; k++) {
+    tmp += lanes[k];
+  }
+  for (; j < n; j++) {
+    tmp += a[j] * b[j];
+  }
+  return tmp;
+}
+
+static void SIMD_TARGET
+SIMD_FN(mvmul) (const smpl_t * const *rows, const smpl_t *x, smpl_t *y,
+    uint_t n_rows, uint_t n)
+{
+  uint_t k = 0, j, l;
+  smpl_t lanes[4][SIMD_W];
+  /* four rows at a time, so that each load of x feeds four accumulators */
+  for (; k + 4 <= n_rows; k += 4) {
+    const smpl_t *r0 = rows[k], *r1 = rows[k + 1];
+    const smpl_t *r2 = rows[k + 2], *r3 = rows[k + 3];
+    smpl_t t0 = 0., t1 = 0., t2 = 0., t3 = 0.;
+    SIMD_VEC a0 = SIMD_SET1(0.), a1 = SIMD_SET1(0.);
+    SIMD_VEC a2 = SIMD_SET1(0.), a3 = SIMD_SET1(0.);
+    for (j = 0; j + SIMD_W <= n; j += SIMD_W) {
+      SIMD_VEC v = SIMD_LOAD(x + j);
+      a0 = SIMD_ADD(a0, SIMD_MUL(SIMD_LOAD(r0 + j), v));
+      a1 = SIMD_ADD(a1, SIMD_MUL(SIMD_LOAD(r1 + j), v));
+      a2 = SIMD_ADD(a2, SIMD_MUL(SIMD_LOAD(r2 + j), v));
+      a3 = SIMD_ADD(a3, SIMD_MUL(SIMD_LOAD(r3 + j), v));
+    }
+    SIMD_STORE(lanes[0], a0);
+    SIMD_STORE(lanes[1], a1);
+    SIMD_STORE(lanes[2], a2);
+    SIMD_STORE(lanes[3], a3);
+    for (l = 0; l < SIMD_W; l++) {
+      t0 += lanes[0][l];
+      t1 += lanes[1][l];
+      t2 += lanes[2][l];
+      t3 += lanes[3][l];
+    }
+    for (; j < n; j++) {
+      t0 += r0[j] * x[j];
+      t1 += r1[j] * x[j];
+      t2 += r2[j] * x[j];
+      t3 += r3[j] * x[j];
+    }
+    y[k] = t0;
+    y[k + 1] = t1;
+    y[k + 2] = t2;
+    y[k + 3] = t3;
+  }
+  for (; k < n_rows; k++) {
+    y[k] = SIMD_FN(dot) (rows[k], x, n);
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(mmul) (const smpl_t * const *a, const smpl_t * const *b,
+    smpl_t * const *c, uint_t n_a, uint_t n_b, uint_t n)
+{
+  uint_t i = 0, k, j, l;
+  smpl_t lanes[8][SIMD_W], y[4];
+  /* tiles of four rows of a by two rows of b, so that each load feeds two
+     or four accumulators */
+  for (; i + 4 <= n_a; i += 4) {
+    const smpl_t *a0 = a[i], *a1 = a[i + 1], *a2 = a[i + 2], *a3 = a[i + 3];
+    for (k = 0; k + 2 <= n_b; k += 2) {
+      const smpl_t *b0 = b[k], *b1 = b[k + 1];
+      smpl_t t00 = 0., t01 = 0., t10 = 0., t11 = 0.;
+      smpl_t t20 = 0., t21 = 0., t30 = 0., t31 = 0.;
+      SIMD_VEC s00 = SIMD_SET1(0.), s01 = SIMD_SET1(0.);
+      SIMD_VEC s10 = SIMD_SET1(0.), s11 = SIMD_SET1(0.);
+      SIMD_VEC s20 = SIMD_SET1(0.), s21 = SIMD_SET1(0.);
+      SIMD_VEC s30 = SIMD_SET1(0.), s31 = SIMD_SET1(0.);
+      for (j = 0; j + SIMD_W <= n; j += SIMD_W) {
+        SIMD_VEC v0 = SIMD_LOAD(b0 + j), v1 = SIMD_LOAD(b1 + j), u;
+        u = SIMD_LOAD(a0 + j);
+        s00 = SIMD_ADD(s00, SIMD_MUL(u, v0));
+        s01 = SIMD_ADD(s01, SIMD_MUL(u, v1));
+        u = SIMD_LOAD(a1 + j);
+        s10 = SIMD_ADD(s10, SIMD_MUL(u, v0));
+        s11 = SIMD_ADD(s11, SIMD_MUL(u, v1));
+        u = SIMD_LOAD(a2 + j);
+        s20 = SIMD_ADD(s20, SIMD_MUL(u, v0));
+        s21 = SIMD_ADD(s21, SIMD_MUL(u, v1));
+        u = SIMD_LOAD(a3 + j);
+        s30 = SIMD_ADD(s30, SIMD_MUL(u, v0));
+        s31 = SIMD_ADD(s31, SIMD_MUL(u, v1));
+      }
+      SIMD_STORE(lanes[0], s00);
+      SIMD_STORE(lanes[1], s01);
+      SIMD_STORE(lanes[2], s10);
+      SIMD_STORE(lanes[3], s11);
+      SIMD_STORE(lanes[4], s20);
+      SIMD_STORE(lanes[5], s21);
+      SIMD_STORE(lanes[6], s30);
+      SIMD_STORE(lanes[7], s31);
+      for (l = 0; l < SIMD_W; l++) {
+        t00 += lanes[0][l];
+        t01 += lanes[1][l];
+        t10 += lanes[2][l];
+        t11 += lanes[3][l];
+        t20 += lanes[4][l];
+        t21 += lanes[5][l];
+        t30 += lanes[6][l];
+        t31 += lanes[7][l];
+      }
+      for (; j < n; j++) {
+        t00 += a0[j] * b0[j];
+        t01 += a0[j] * b1[j];
+        t10 += a1[j] * b0[j];
+        t11 += a1[j] * b1[j];
+        t20 += a2[j] * b0[j];
+        t21 += a2[j] * b1[j];
+        t30 += a3[j] * b0[j];
+        t31 += a3[j] * b1[j];
+      }
+      c[i][k] = t00;
+      c[i][k + 1] = t01;
+      c[i + 1][k] = t10;
+      c[i + 1][k + 1] = t11;
+      c[i + 2][k] = t20;
+      c[i + 2][k + 1] = t21;
+      c[i + 3][k] = t30;
+      c[i + 3][k + 1] = t31;
+    }
+    if (k < n_b) {
+      SIMD_FN(mvmul) (a + i, b[k], y, 4, n);
+      c[i][k] = y[0];
+      c[i + 1][k] = y[1];
+      c[i + 2][k] = y[2];
+      c[i + 3][k] = y[3];
+    }
+  }
+  for (; i < n_a; i++) {
+    for (k = 0; k < n_b; k++) {
+      c[i][k] = SIMD_FN(dot) (a[i], b[k], n);
+    }
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(sqdiff) (const smpl_t *x, smpl_t *y, uint_t lag, uint_t n_lags,
+    uint_t n)
+{
+  uint_t k = 0, j, l;
+  smpl_t lanes[4][SIMD_W], d;
+  /* four lags at a time, so that each load of x feeds four accumulators */
+  for (; k + 4 <= n_lags; k += 4) {
+    const smpl_t *x0 = x + lag + k, *x1 = x0 + 1, *x2 = x0 + 2, *x3 = x0 + 3;
+    smpl_t t0 = 0., t1 = 0., t2 = 0., t3 = 0.;
+    SIMD_VEC a0 = SIMD_SET1(0.), a1 = SIMD_SET1(0.);
+    SIMD_VEC a2 = SIMD_SET1(0.), a3 = SIMD_SET1(0.);
+    for (j = 0; j + SIMD_W <= n; j += SIMD_W) {
+      SIMD_VEC v = SIMD_LOAD(x + j), d0, d1, d2, d3;
+      d0 = SIMD_SUB(v, SIMD_LOAD(x0 + j));
+      d1 = SIMD_SUB(v, SIMD_LOAD(x1 + j));
+      d2 = SIMD_SUB(v, SIMD_LOAD(x2 + j));
+      d3 = SIMD_SUB(v, SIMD_LOAD(x3 + j));
+      a0 = SIMD_ADD(a0, SIMD_MUL(d0, d0));
+      a1 = SIMD_ADD(a1, SIMD_MUL(d1, d1));
+      a2 = SIMD_ADD(a2, SIMD_MUL(d2, d2));
+      a3 = SIMD_ADD(a3, SIMD_MUL(d3, d3));
+    }
+    SIMD_STORE(lanes[0], a0);
+    SIMD_STORE(lanes[1], a1);
+    SIMD_STORE(lanes[2], a2);
+    SIMD_STORE(lanes[3], a3);
+    for (l = 0; l < SIMD_W; l++) {
+      t0 += lanes[0][l];
+      t1 += lanes[1][l];
+      t2 += lanes[2][l];
+      t3 += lanes[3][l];
+    }
+    for (; j < n; j++) {
+      d = x[j] - x0[j]; t0 += d * d;
+      d = x[j] - x1[j]; t1 += d * d;
+      d = x[j] - x2[j]; t2 += d * d;
+      d = x[j] - x3[j]; t3 += d * d;
+    }
+    y[k] = t0;
+    y[k + 1] = t1;
+    y[k + 2] = t2;
+    y[k + 3] = t3;
+  }
+  for (; k < n_lags; k++) {
+    const smpl_t *xk = x + lag + k;
+    smpl_t tmp = 0.;
+    SIMD_VEC acc = SIMD_SET1(0.);
+    for (j = 0; j + SIMD_W <= n; j += SIMD_W) {
+      SIMD_VEC dk = SIMD_SUB(SIMD_LOAD(x + j), SIMD_LOAD(xk + j));
+      acc = SIMD_ADD(acc, SIMD_MUL(dk, dk));
+    }
+    SIMD_STORE(lanes[0], acc);
+    for (l = 0; l < SIMD_W; l++) {
+      tmp += lanes[0][l];
+    }
+    for (; j < n; j++) {
+      d = x[j] - xk[j];
+      tmp += d * d;
+    }
+    y[k] = tmp;
+  }
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(ramp_dot) (const smpl_t *s, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], tmp = 0.;
+  SIMD_VEC acc = SIMD_SET1(0.), idx, step = SIMD_SET1(SIMD_W);
+  for (k = 0; k < SIMD_W; k++) {
+    lanes[k] = k + 1;
+  }
+  idx = SIMD_LOAD(lanes);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    acc = SIMD_ADD(acc, SIMD_MUL(idx, SIMD_LOAD(s + j)));
+    idx = SIMD_ADD(idx, step);
+  }
+  SIMD_STORE(lanes, acc);
+  for (k = 0; k < SIMD_W; k++) {
+    tmp += lanes[k];
+  }
+  for (; j < n; j++) {
+    tmp += (j + 1) * s[j];
+  }
+  return tmp;
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(flux) (const smpl_t *x, smpl_t *old, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], tmp = 0.;
+  SIMD_VEC acc = SIMD_SET1(0.), zero = SIMD_SET1(0.);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_VEC v = SIMD_LOAD(x + j);
+    acc = SIMD_ADD(acc, SIMD_MAX(SIMD_SUB(v, SIMD_LOAD(old + j)), zero));
+    SIMD_STORE(old + j, v);
+  }
+  SIMD_STORE(lanes, acc);
+  for (k = 0; k < SIMD_W; k++) {
+    tmp += lanes[k];
+  }
+  for (; j < n; j++) {
+    if (x[j] > old[j]) tmp += x[j] - old[j];
+    old[j] = x[j];
+  }
+  return tmp;
+}
+
+static void SIMD_TARGET
+SIMD_FN(sqdev) (const smpl_t *x, smpl_t *old, smpl_t *dev, smpl_t thres,
+    uint_t n)
+{
+  uint_t j = 0;
+  SIMD_VEC zero = SIMD_SET1(0.), t = SIMD_SET1(thres);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_VEC v = SIMD_LOAD(x + j), o = SIMD_LOAD(old + j), d;
+    d = SIMD_SUB(SIMD_MUL(v, v), SIMD_MUL(o, o));
+    d = SIMD_MAX(d, SIMD_SUB(zero, d));
+    SIMD_STORE(dev + j, SIMD_SELECT_GT(v, t, SIMD_SQRT(d)));
+    SIMD_STORE(old + j, v);
+  }
+  for (; j < n; j++) {
+    dev[j] = (x[j] > thres) ? SQRT(ABS(SQR(x[j]) - SQR(old[j]))) : 0.;
+    old[j] = x[j];
+  }
+}
+
+/* log(x) = e log(2) + log(m), with x = 2^e m and m in [1, 2), where
+ * log(m) = 2 atanh(s) = 2 (s + s^3 / 3 + s^5 / 5 + ...), s = (m - 1) / (m + 1)
+ * being at most 1/3, is truncated after AUBIO_SIMD_LOG_TERMS terms */
+static SIMD_VEC SIMD_TARGET
+SIMD_FN(log_approx) (SIMD_VEC x)
+{
+  sint_t k;
+  SIMD_VEC one = SIMD_SET1(1.), m, s, s2, p, up;
+  /* the exponent field of a subnormal number is 0, scale it up first */
+  up = SIMD_SELECT_GT(SIMD_SET1(AUBIO_SIMD_TINY), x,
+      SIMD_SET1(AUBIO_SIMD_LOG_SUBNORMAL));
+  x = SIMD_MUL(x, SIMD_POW2(up));
+  m = SIMD_MANTISSA(x);
+  s = SIMD_DIV(SIMD_SUB(m, one), SIMD_ADD(m, one));
+  s2 = SIMD_MUL(s, s);
+  p = SIMD_SET1(1. / (2 * AUBIO_SIMD_LOG_TERMS - 1));
+  for (k = AUBIO_SIMD_LOG_TERMS - 2; k >= 0; k--) {
+    p = SIMD_ADD(SIMD_MUL(p, s2), SIMD_SET1(1. / (2 * k + 1)));
+  }
+  return SIMD_ADD(SIMD_MUL(SIMD_SUB(SIMD_EXPONENT(x), up),
+        SIMD_SET1(AUBIO_SIMD_LN2)), SIMD_MUL(SIMD_ADD(s, s), p));
+}
+
+static smpl_t SIMD_TARGET
+SIMD_FN(kl) (const smpl_t *x, smpl_t *old, uint_t weighted, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], pad[SIMD_W], tmp = 0.;
+  SIMD_VEC acc = SIMD_SET1(0.), one = SIMD_SET1(1.), eps = SIMD_SET1(.1);
+  SIMD_VEC v, l;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    v = SIMD_LOAD(x + j);
+    l = SIMD_FN(log_approx) (SIMD_ADD(one,
+          SIMD_DIV(v, SIMD_ADD(SIMD_LOAD(old + j), eps))));
+    acc = SIMD_ADD(acc, weighted ? SIMD_MUL(v, l) : l);
+    SIMD_STORE(old + j, v);
+  }
+  if (j < n) {
+    /* padding with zeros, whose terms are exactly 0 */
+    for (k = 0; k < SIMD_W; k++) {
+      lanes[k] = (j + k < n) ? x[j + k] : 0.;
+      pad[k] = (j + k < n) ? old[j + k] : 0.;
+    }
+    v = SIMD_LOAD(lanes);
+    l = SIMD_FN(log_approx) (SIMD_ADD(one,
+          SIMD_DIV(v, SIMD_ADD(SIMD_LOAD(pad), eps))));
+    acc = SIMD_ADD(acc, weighted ? SIMD_MUL(v, l) : l);
+    for (; j < n; j++) {
+      old[j] = x[j];
+    }
+  }
+  SIMD_STORE(lanes, acc);
+  for (k = 0; k < SIMD_W; k++) {
+    tmp += lanes[k];
+  }
+  return tmp;
+}
+
+static void SIMD_TARGET
+SIMD_FN(vlog) (smpl_t *s, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W];
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(s + j, SIMD_FN(log_approx) (SIMD_LOAD(s + j)));
+  }
+  if (j < n) {
+    for (k = 0; k < SIMD_W; k++) {
+      lanes[k] = (j + k < n) ? s[j + k] : 1.;
+    }
+    SIMD_STORE(lanes, SIMD_FN(log_approx) (SIMD_LOAD(lanes)));
+    for (k = 0; j < n; j++, k++) {
+      s[j] = lanes[k];
+    }
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(whiten) (smpl_t *s, smpl_t *peak, smpl_t decay, smpl_t floor,
+    smpl_t lambda, uint_t n)
+{
+  uint_t j = 0, tail;
+  SIMD_VEC d = SIMD_SET1(decay), f = SIMD_SET1(floor);
+  SIMD_VEC l = SIMD_SET1(lambda), one = SIMD_SET1(1.);
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_VEC v = SIMD_LOAD(s + j), p;
+    p = SIMD_MAX(v, SIMD_MAX(SIMD_MUL(d, SIMD_LOAD(peak + j)), f));
+    SIMD_STORE(peak + j, p);
+    v = SIMD_DIV(v, p);
+    if (lambda > 0.) {
+      v = SIMD_FN(log_approx) (SIMD_ADD(one, SIMD_MUL(l, v)));
+    }
+    SIMD_STORE(s + j, v);
+  }
+  for (tail = j; j < n; j++) {
+    smpl_t tmp = MAX(decay * peak[j], floor);
+    peak[j] = MAX(s[j], tmp);
+    s[j] /= peak[j];
+    if (lambda > 0.) s[j] = 1. + lambda * s[j];
+  }
+  if (lambda > 0. && tail < n) {
+    SIMD_FN(vlog) (s + tail, n - tail);
+  }
+}
+
+/* exp(x) = 2^e exp(r), with e = round(x / log(2)) and r = x - e log(2) in
+ * [-log(2) / 2, log(2) / 2], where exp(r) = 1 + r + r^2 / 2! + ... is
+ * truncated after AUBIO_SIMD_EXP_TERMS terms; x is clamped to +/-
+ * AUBIO_SIMD_EXP_MAX, so that 2^e stays a normal number */
+static SIMD_VEC SIMD_TARGET
+SIMD_FN(exp_approx) (SIMD_VEC x)
+{
+  sint_t k;
+  SIMD_VEC one = SIMD_SET1(1.), e, r, p;
+  x = SIMD_MAX(SIMD_MIN(x, SIMD_SET1(AUBIO_SIMD_EXP_MAX)),
+      SIMD_SET1(-AUBIO_SIMD_EXP_MAX));
+  e = SIMD_ROUND(SIMD_MUL(x, SIMD_SET1(AUBIO_SIMD_LOG2E)));
+  r = SIMD_SUB(SIMD_SUB(x, SIMD_MUL(e, SIMD_SET1(AUBIO_SIMD_LN2_HI))),
+      SIMD_MUL(e, SIMD_SET1(AUBIO_SIMD_LN2_LO)));
+  p = one;
+  for (k = AUBIO_SIMD_EXP_TERMS - 1; k > 0; k--) {
+    p = SIMD_ADD(one, SIMD_MUL(p, SIMD_MUL(r, SIMD_SET1(1. / k))));
+  }
+  return SIMD_MUL(p, SIMD_POW2(e));
+}
+
+static void SIMD_TARGET
+SIMD_FN(vexp) (smpl_t *s, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W];
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(s + j, SIMD_FN(exp_approx) (SIMD_LOAD(s + j)));
+  }
+  if (j < n) {
+    for (k = 0; k < SIMD_W; k++) {
+      lanes[k] = (j + k < n) ? s[j + k] : 0.;
+    }
+    SIMD_STORE(lanes, SIMD_FN(exp_approx) (SIMD_LOAD(lanes)));
+    for (k = 0; j < n; j++, k++) {
+      s[j] = lanes[k];
+    }
+  }
+}
+
+/* atan2(y, x) from t = min(|x|, |y|) / max(|x|, |y|) in [0, 1]: two steps of
+ * atan(t) = 2 atan(t / (1 + sqrt(1 + t^2))) bring t below tan(pi / 16), where
+ * atan(t) = t - t^3 / 3 + t^5 / 5 - ... is truncated after
+ * AUBIO_SIMD_ATAN_TERMS terms, then the octant of (x, y) is restored */
+static SIMD_VEC SIMD_TARGET
+SIMD_FN(atan2_approx) (SIMD_VEC y, SIMD_VEC x)
+{
+  sint_t k;
+  SIMD_VEC zero = SIMD_SET1(0.), one = SIMD_SET1(1.), two = SIMD_SET1(2.);
+  SIMD_VEC ax = SIMD_MAX(x, SIMD_SUB(zero, x));
+  SIMD_VEC ay = SIMD_MAX(y, SIMD_SUB(zero, y));
+  SIMD_VEC t, t2, p, r;
+  // 0 / 0 gives 0, as atan2(0, 0)
+  t = SIMD_DIV(SIMD_MIN(ax, ay),
+      SIMD_MAX(SIMD_MAX(ax, ay), SIMD_SET1(AUBIO_SIMD_TINY)));
+  for (k = 0; k < 2; k++) {
+    t = SIMD_DIV(t, SIMD_ADD(one, SIMD_SQRT(SIMD_ADD(one, SIMD_MUL(t, t)))));
+  }
+  t2 = SIMD_MUL(t, t);
+  k = AUBIO_SIMD_ATAN_TERMS - 1;
+  p = SIMD_SET1((k % 2 ? -1. : 1.) / (2 * k + 1));
+  for (k = k - 1; k >= 0; k--) {
+    p = SIMD_ADD(SIMD_MUL(p, t2), SIMD_SET1((k % 2 ? -1. : 1.) / (2 * k + 1)));
+  }
+  r = SIMD_MUL(SIMD_SET1(4.), SIMD_MUL(t, p));
+  // pi / 2 - r above the diagonal, pi - r left of the y axis, -r below
+  r = SIMD_ADD(r, SIMD_SELECT_GT(ay, ax,
+        SIMD_SUB(SIMD_SET1(PI / 2.), SIMD_MUL(two, r))));
+  r = SIMD_ADD(r, SIMD_SELECT_GT(zero, x,
+        SIMD_SUB(SIMD_SET1(PI), SIMD_MUL(two, r))));
+  r = SIMD_SUB(r, SIMD_SELECT_GT(zero, y, SIMD_MUL(two, r)));
+  return r;
+}
+
+static void SIMD_TARGET
+SIMD_FN(vatan2) (const smpl_t *y, const smpl_t *x, smpl_t *out, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t ly[SIMD_W], lx[SIMD_W];
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(out + j, SIMD_FN(atan2_approx) (SIMD_LOAD(y + j),
+          SIMD_LOAD(x + j)));
+  }
+  if (j < n) {
+    for (k = 0; k < SIMD_W; k++) {
+      ly[k] = (j + k < n) ? y[j + k] : 0.;
+      lx[k] = (j + k < n) ? x[j + k] : 1.;
+    }
+    SIMD_STORE(ly, SIMD_FN(atan2_approx) (SIMD_LOAD(ly), SIMD_LOAD(lx)));
+    for (k = 0; j < n; j++, k++) {
+      out[j] = ly[k];
+    }
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(vhypot) (const smpl_t *x, const smpl_t *y, smpl_t *out, uint_t n)
+{
+  uint_t j = 0;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_VEC a = SIMD_LOAD(x + j), b = SIMD_LOAD(y + j);
+    SIMD_STORE(out + j, SIMD_SQRT(SIMD_ADD(SIMD_MUL(a, a), SIMD_MUL(b, b))));
+  }
+  for (; j < n; j++) {
+    out[j] = SQRT(SQR(x[j]) + SQR(y[j]));
+  }
+}
+
+/* sin(x) and cos(x) from r = x - k pi / 2 in [-pi / 4, pi / 4], where k =
+ * round(2 x / pi): the series sin(r) = r - r^3 / 3! + ... and cos(r) = 1 -
+ * r^2 / 2! + ... are truncated after AUBIO_SIMD_SINCOS_TERMS terms, then
+ * swapped and negated according to the quadrant q = k mod 4 */
+static void SIMD_TARGET
+SIMD_FN(sincos_approx) (SIMD_VEC x, SIMD_VEC *sin_x, SIMD_VEC *cos_x)
+{
+  sint_t k;
+  SIMD_VEC zero = SIMD_SET1(0.), one = SIMD_SET1(1.), half = SIMD_SET1(.5);
+  SIMD_VEC two = SIMD_SET1(2.), q, r, r2, s, c, odd, a, b, d;
+  q = SIMD_ROUND(SIMD_MUL(x, SIMD_SET1(2. / PI)));
+  r = SIMD_SUB(SIMD_SUB(x, SIMD_MUL(q, SIMD_SET1(AUBIO_SIMD_PIO2_HI))),
+      SIMD_MUL(q, SIMD_SET1(AUBIO_SIMD_PIO2_LO)));
+  r2 = SIMD_MUL(r, r);
+  s = one;
+  c = one;
+  for (k = AUBIO_SIMD_SINCOS_TERMS - 1; k > 0; k--) {
+    s = SIMD_SUB(one, SIMD_MUL(s, SIMD_MUL(r2,
+            SIMD_SET1(1. / ((2. * k) * (2. * k + 1.))))));
+    c = SIMD_SUB(one, SIMD_MUL(c, SIMD_MUL(r2,
+            SIMD_SET1(1. / ((2. * k - 1.) * (2. * k))))));
+  }
+  s = SIMD_MUL(r, s);
+  // q and q mod 2, without ties to round
+  q = SIMD_SUB(q, SIMD_MUL(SIMD_SET1(4.),
+        SIMD_ROUND(SIMD_SUB(SIMD_MUL(q, SIMD_SET1(.25)), SIMD_SET1(.375)))));
+  odd = SIMD_SUB(q, SIMD_MUL(two,
+        SIMD_ROUND(SIMD_SUB(SIMD_MUL(q, half), SIMD_SET1(.25)))));
+  a = SIMD_ADD(SIMD_SELECT_GT(odd, half, c), SIMD_SELECT_GT(half, odd, s));
+  b = SIMD_ADD(SIMD_SELECT_GT(odd, half, s), SIMD_SELECT_GT(half, odd, c));
+  // sin is negative in quadrants 2 and 3, cos in quadrants 1 and 2
+  *sin_x = SIMD_SUB(a, SIMD_SELECT_GT(q, SIMD_SET1(1.5), SIMD_MUL(two, a)));
+  d = SIMD_SUB(q, SIMD_SET1(1.5));
+  d = SIMD_MAX(d, SIMD_SUB(zero, d));
+  *cos_x = SIMD_SUB(b, SIMD_SELECT_GT(one, d, SIMD_MUL(two, b)));
+}
+
+static void SIMD_TARGET
+SIMD_FN(rect) (const smpl_t *norm, const smpl_t *phas, smpl_t *re,
+    smpl_t *im, uint_t n)
+{
+  uint_t j = 0, k;
+  smpl_t ln[SIMD_W], lp[SIMD_W];
+  SIMD_VEC s, c, v;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_FN(sincos_approx) (SIMD_LOAD(phas + j), &s, &c);
+    v = SIMD_LOAD(norm + j);
+    SIMD_STORE(re + j, SIMD_MUL(v, c));
+    SIMD_STORE(im + j, SIMD_MUL(v, s));
+  }
+  if (j < n) {
+    for (k = 0; k < SIMD_W; k++) {
+      ln[k] = (j + k < n) ? norm[j + k] : 0.;
+      lp[k] = (j + k < n) ? phas[j + k] : 0.;
+    }
+    SIMD_FN(sincos_approx) (SIMD_LOAD(lp), &s, &c);
+    v = SIMD_LOAD(ln);
+    SIMD_STORE(lp, SIMD_MUL(v, s));
+    SIMD_STORE(ln, SIMD_MUL(v, c));
+    for (k = 0; j < n; j++, k++) {
+      re[j] = ln[k];
+      im[j] = lp[k];
+    }
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(tss) (const smpl_t *norm, const smpl_t *phas, smpl_t *state,
+    smpl_t *tmask, smpl_t *smask, smpl_t parm, smpl_t hi, uint_t n)
+{
+  uint_t b, k, j;
+  SIMD_VEC zero = SIMD_SET1(0.), one = SIMD_SET1(1.), two = SIMD_SET1(2.);
+  SIMD_VEC p = SIMD_SET1(parm), h = SIMD_SET1(hi - 1.);
+  SIMD_VEC tpi = SIMD_SET1(TWO_PI), itpi = SIMD_SET1(1. / TWO_PI);
+  for (b = 0; b < n; b += AUBIO_SIMD_TSS_BLOCK) {
+    smpl_t *t1 = state + 4 * b, *t2 = t1 + AUBIO_SIMD_TSS_BLOCK;
+    smpl_t *o1 = t2 + AUBIO_SIMD_TSS_BLOCK, *o2 = o1 + AUBIO_SIMD_TSS_BLOCK;
+    if (b + AUBIO_SIMD_TSS_BLOCK <= n) {
+      for (k = 0; k < AUBIO_SIMD_TSS_BLOCK; k += SIMD_W) {
+        SIMD_VEC ph, th1, d, a, tm, sm, v;
+        j = b + k;
+        ph = SIMD_LOAD(phas + j);
+        th1 = SIMD_LOAD(t1 + k);
+        // second phase derivative, unwrapped to [-pi, pi]
+        d = SIMD_ADD(SIMD_SUB(ph, SIMD_MUL(two, th1)), SIMD_LOAD(t2 + k));
+        d = SIMD_SUB(d, SIMD_MUL(tpi, SIMD_ROUND(SIMD_MUL(d, itpi))));
+        a = SIMD_MAX(d, SIMD_SUB(zero, d));
+        SIMD_STORE(t2 + k, th1);
+        SIMD_STORE(t1 + k, ph);
+        tm = SIMD_SELECT_GT(a, SIMD_MUL(p, SIMD_LOAD(o1 + k)), one);
+        sm = SIMD_SELECT_GT(SIMD_MUL(p, SIMD_LOAD(o2 + k)), a, one);
+        v = SIMD_LOAD(norm + j);
+        SIMD_STORE(o1 + k, SIMD_ADD(one,
+              SIMD_SELECT_GT(SIMD_MUL(v, tm), zero, h)));
+        SIMD_STORE(o2 + k, SIMD_ADD(one,
+              SIMD_SELECT_GT(SIMD_MUL(v, sm), zero, h)));
+        SIMD_STORE(tmask + j, tm);
+        SIMD_STORE(smask + j, sm);
+      }
+    } else {
+      for (k = 0; b + k < n; k++) {
+        smpl_t d, a;
+        j = b + k;
+        d = phas[j] - 2. * t1[k] + t2[k];
+        d -= TWO_PI * FLOOR(d / TWO_PI + .5);
+        a = ABS(d);
+        t2[k] = t1[k];
+        t1[k] = phas[j];
+        tmask[j] = (a > parm * o1[k]) ? 1. : 0.;
+        smask[j] = (parm * o2[k] > a) ? 1. : 0.;
+        o1[k] = (norm[j] * tmask[j] > 0.) ? hi : 1.;
+        o2[k] = (norm[j] * smask[j] > 0.) ? hi : 1.;
+      }
+    }
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(sym_fir) (const smpl_t *x, const smpl_t *h, uint_t half, smpl_t *y,
+    uint_t n)
+{
+  uint_t i = 0, k, last = 2 * half - 1;
+  // SIMD_W outputs at a time, each coefficient applied to a pair of inputs
+  for (; i + SIMD_W <= n; i += SIMD_W) {
+    SIMD_VEC acc = SIMD_SET1(0.);
+    for (k = 0; k < half; k++) {
+      acc = SIMD_ADD(acc, SIMD_MUL(SIMD_SET1(h[k]),
+            SIMD_ADD(SIMD_LOAD(x + i + k), SIMD_LOAD(x + i + last - k))));
+    }
+    SIMD_STORE(y + i, acc);
+  }
+  for (; i < n; i++) {
+    smpl_t acc = 0.;
+    for (k = 0; k < half; k++) {
+      acc += h[k] * (x[i + k] + x[i + last - k]);
+    }
+    y[i] = acc;
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(osc) (const smpl_t *table, smpl_t len, const smpl_t *offset,
+    smpl_t *pos, smpl_t *inc, const smpl_t *dinc, smpl_t *amp,
+    const smpl_t *damp, uint_t n_voices, smpl_t *out, uint_t n)
+{
+  uint_t i, v, k;
+  SIMD_VEC one = SIMD_SET1(1.), l = SIMD_SET1(len);
+  smpl_t lanes[SIMD_W];
+  // one voice per lane, all voices summed into each output sample
+  for (i = 0; i < n; i++) {
+    SIMD_VEC acc = SIMD_SET1(0.);
+    smpl_t sum = 0.;
+    for (v = 0; v < n_voices; v += SIMD_W) {
+      SIMD_VEC p = SIMD_LOAD(pos + v), a = SIMD_LOAD(amp + v);
+      SIMD_VEC d = SIMD_LOAD(inc + v), fl, x0, x1;
+      // floor of the position, then linear interpolation
+      fl = SIMD_ROUND(p);
+      fl = SIMD_SUB(fl, SIMD_SELECT_GT(fl, p, one));
+      x0 = SIMD_ADD(fl, SIMD_LOAD(offset + v));
+      x1 = SIMD_GATHER(table + 1, x0);
+      x0 = SIMD_GATHER(table, x0);
+      x0 = SIMD_ADD(x0, SIMD_MUL(SIMD_SUB(p, fl), SIMD_SUB(x1, x0)));
+      acc = SIMD_ADD(acc, SIMD_MUL(a, x0));
+      p = SIMD_ADD(p, d);
+      p = SIMD_SUB(p, SIMD_SELECT_GT(p, l, l));
+      SIMD_STORE(pos + v, p);
+      SIMD_STORE(inc + v, SIMD_ADD(d, SIMD_LOAD(dinc + v)));
+      SIMD_STORE(amp + v, SIMD_ADD(a, SIMD_LOAD(damp + v)));
+    }
+    SIMD_STORE(lanes, acc);
+    for (k = 0; k < SIMD_W; k++) {
+      sum += lanes[k];
+    }
+    out[i] += sum;
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(cmac) (const smpl_t *a, const smpl_t *b, smpl_t *acc, uint_t n)
+{
+  const smpl_t *ai = a + n, *bi = b + n;
+  smpl_t *acci = acc + n;
+  uint_t i = 0;
+  for (; i + SIMD_W <= n; i += SIMD_W) {
+    SIMD_VEC xr = SIMD_LOAD(a + i), xi = SIMD_LOAD(ai + i);
+    SIMD_VEC yr = SIMD_LOAD(b + i), yi = SIMD_LOAD(bi + i);
+    SIMD_STORE(acc + i, SIMD_ADD(SIMD_LOAD(acc + i),
+          SIMD_SUB(SIMD_MUL(xr, yr), SIMD_MUL(xi, yi))));
+    SIMD_STORE(acci + i, SIMD_ADD(SIMD_LOAD(acci + i),
+          SIMD_ADD(SIMD_MUL(xr, yi), SIMD_MUL(xi, yr))));
+  }
+  for (; i < n; i++) {
+    acc[i] += a[i] * b[i] - ai[i] * bi[i];
+    acci[i] += a[i] * bi[i] + ai[i] * b[i];
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(sdft) (const smpl_t *x, const smpl_t *old, uint_t n,
+    const smpl_t *coefs, smpl_t *state, uint_t n_bins,
+    smpl_t * const *power)
+{
+  const smpl_t *wr = coefs, *wi = coefs + n_bins;
+  const smpl_t *cr = coefs + 2 * n_bins, *ci = coefs + 3 * n_bins;
+  smpl_t *sr = state, *si = state + n_bins;
+  smpl_t lanes[SIMD_W];
+  uint_t i, k, l;
+  // one bin per lane, its state kept in registers over all samples
+  for (k = 0; k < n_bins; k += SIMD_W) {
+    SIMD_VEC vwr = SIMD_LOAD(wr + k), vwi = SIMD_LOAD(wi + k);
+    SIMD_VEC vcr = SIMD_LOAD(cr + k), vci = SIMD_LOAD(ci + k);
+    SIMD_VEC re = SIMD_LOAD(sr + k), im = SIMD_LOAD(si + k);
+    for (i = 0; i < n; i++) {
+      SIMD_VEC xn = SIMD_SET1(x[i]), xo = SIMD_SET1(old[i]);
+      SIMD_VEC nr = SIMD_ADD(SIMD_SUB(xn, SIMD_MUL(vcr, xo)),
+          SIMD_SUB(SIMD_MUL(vwr, re), SIMD_MUL(vwi, im)));
+      SIMD_VEC ni = SIMD_SUB(SIMD_ADD(SIMD_MUL(vwr, im), SIMD_MUL(vwi, re)),
+          SIMD_MUL(vci, xo));
+      re = nr;
+      im = ni;
+      if (power) {
+        SIMD_STORE(lanes, SIMD_ADD(SIMD_MUL(re, re), SIMD_MUL(im, im)));
+        for (l = 0; l < SIMD_W; l++) {
+          power[k + l][i] = lanes[l];
+        }
+      }
+    }
+    SIMD_STORE(sr + k, re);
+    SIMD_STORE(si + k, im);
+  }
+}
+
+static void SIMD_TARGET
+SIMD_FN(stats) (const smpl_t *s, uint_t n, smpl_t *energy, smpl_t *peak,
+    uint_t *crossings)
+{
+  uint_t j = 0, k;
+  smpl_t lanes[SIMD_W], e = 0., p = 0., c = 0.;
+  SIMD_VEC zero = SIMD_SET1(0.), one = SIMD_SET1(1.);
+  SIMD_VEC acc = zero, top = zero, cross = zero;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_VEC v = SIMD_LOAD(s + j);
+    acc = SIMD_ADD(acc, SIMD_MUL(v, v));
+    top = SIMD_MAX(top, SIMD_MAX(v, SIMD_SUB(zero, v)));
+    /* 1 where the sign differs from the previous sample, 0 elsewhere */
+    if (j > 0) {
+      SIMD_VEC d = SIMD_SUB(SIMD_SELECT_GT(zero, SIMD_LOAD(s + j - 1), one),
+          SIMD_SELECT_GT(zero, v, one));
+      cross = SIMD_ADD(cross, SIMD_MUL(d, d));
+    }
+  }
+  SIMD_STORE(lanes, acc);
+  for (k = 0; k < SIMD_W; k++) {
+    e += lanes[k];
+  }
+  SIMD_STORE(lanes, top);
+  for (k = 0; k < SIMD_W; k++) {
+    p = (p > lanes[k]) ? p : lanes[k];
+  }
+  SIMD_STORE(lanes, cross);
+  for (k = 0; k < SIMD_W; k++) {
+    c += lanes[k];
+  }
+  /* pairs within the first block, then the tail */
+  for (k = 1; k < SIMD_W && k < j; k++) {
+    c += (s[k - 1] < 0.) != (s[k] < 0.);
+  }
+  for (; j < n; j++) {
+    e += s[j] * s[j];
+    p = (p > ABS(s[j])) ? p : ABS(s[j]);
+    if (j > 0) c += (s[j - 1] < 0.) != (s[j] < 0.);
+  }
+  *energy = e;
+  *peak = p;
+  *crossings = (uint_t)c;
+}
+
+static uint_t SIMD_TARGET
+SIMD_FN(peaks) (const smpl_t *x, uint_t start, uint_t n, smpl_t threshold,
+    smpl_t *pos, uint_t max)
+{
+  uint_t j = (start > 1) ? start : 1, k, count = 0;
+  smpl_t lanes[SIMD_W];
+  SIMD_VEC thres = SIMD_SET1(threshold), one = SIMD_SET1(1.);
+  for (; j + SIMD_W < n && count + SIMD_W <= max; j += SIMD_W) {
+    SIMD_VEC v = SIMD_LOAD(x + j);
+    /* 1 where v is above both neighbours and the threshold, 0 elsewhere */
+    SIMD_VEC m = SIMD_SELECT_GT(v, SIMD_LOAD(x + j - 1),
+        SIMD_SELECT_GT(v, SIMD_LOAD(x + j + 1), SIMD_SELECT_GT(v, thres, one)));
+    SIMD_STORE(lanes, m);
+    /* append the positions of the block without branching */
+    for (k = 0; k < SIMD_W; k++) {
+      pos[count] = (smpl_t)(j + k);
+      count += (uint_t)lanes[k];
+    }
+  }
+  for (; j + 1 < n && count < max; j++) {
+    if (x[j] > x[j - 1] && x[j] > x[j + 1] && x[j] > threshold) {
+      pos[count++] = (smpl_t)j;
+    }
+  }
+  return count;
+}
+
+/* the input, padded with r copies of its first and last elements, is cut in
+ * blocks of w = 2 r + 1; g holds the running maximum of each block from its
+ * start, h from its end. The window of output i spans the end of a block and
+ * the start of the next one, so that its maximum is max(h[i], g[i + 2 r]).
+ * Only this last step is vectorized, the scans running along the blocks */
+static void SIMD_TARGET
+SIMD_FN(maxfilt) (const smpl_t *x, smpl_t *y, smpl_t *tmp, uint_t r,
+    uint_t n)
+{
+  uint_t w = 2 * r + 1, len = n + 2 * r, start, j = 0;
+  smpl_t *g = tmp, *h = tmp + len;
+  if (n == 0) return;
+  for (; j < r; j++) {
+    h[j] = x[0];
+    h[len - 1 - j] = x[n - 1];
+  }
+  for (j = 0; j < n; j++) {
+    h[r + j] = x[j];
+  }
+  for (start = 0; start < len; start += w) {
+    uint_t end = (start + w < len) ? start + w : len;
+    smpl_t acc = h[start];
+    for (j = start; j < end; j++) {
+      acc = (acc > h[j]) ? acc : h[j];
+      g[j] = acc;
+    }
+    acc = h[end - 1];
+    for (j = end; j-- > start;) {
+      acc = (acc > h[j]) ? acc : h[j];
+      h[j] = acc;
+    }
+  }
+  j = 0;
+  for (; j + SIMD_W <= n; j += SIMD_W) {
+    SIMD_STORE(y + j, SIMD_MAX(SIMD_LOAD(h + j), SIMD_LOAD(g + j + 2 * r)));
+  }
+  for (; j < n; j++) {
+    y[j] = (h[j] > g[j + 2 * r]) ? h[j] : g[j + 2 * r];
+  }
+}
+
+static const aubio_simd_ops_t SIMD_FN(table) = {
+  SIMD_NAME,
+  SIMD_FN(weight),
+  SIMD_FN(weighted_copy),
+  SIMD_FN(mul),
+  SIMD_FN(add),
+  SIMD_FN(vsqrt),
+  SIMD_FN(sum),
+  SIMD_FN(vmax),
+  SIMD_FN(vmin),
+  SIMD_FN(dot),
+  SIMD_FN(mvmul),
+  SIMD_FN(mmul),
+  SIMD_FN(sqdiff),
+  SIMD_FN(ramp_dot),
+  SIMD_FN(flux),
+  SIMD_FN(sqdev),
+  SIMD_FN(kl),
+  SIMD_FN(vlog),
+  SIMD_FN(whiten),
+  SIMD_FN(vexp),
+  SIMD_FN(vatan2),
+  SIMD_FN(vhypot),
+  SIMD_FN(rect),
+  SIMD_FN(tss),
+  SIMD_FN(sym_fir),
+  SIMD_FN(osc),
+  SIMD_FN(cmac),
+  SIMD_FN(sdft),
+  SIMD_FN(stats),
+  SIMD_FN(peaks),
+  SIMD_FN(maxfilt),
+};
+
+#ifdef SIMD_GATHER_LANES
+#undef SIMD_GATHER
+#undef SIMD_GATHER_LANES
+#endif
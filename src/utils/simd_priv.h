@@ -0,0 +1,214 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/** \file
+
+  Runtime dispatched SIMD kernels (private)
+
+  This file is for inclusion from _within_ the library only.
+
+  The elementwise kernels used by ::fvec_t and ::cvec_t helpers are collected
+  in a table of function pointers. The table matching the best instruction set
+  supported by the running CPU (SSE2, AVX2, AVX-512 or NEON) is selected the
+  first time it is requested, so that a single binary can run at vector speed
+  on any x86-64 or ARM64 machine. WebAssembly modules built with `-msimd128`
+  use the SIMD128 kernels.
+
+  The choice can be forced with the `AUBIO_SIMD` environment variable, set to
+  one of `scalar`, `sse2`, `avx2`, `avx512`, `neon` or `wasm`. Unsupported
+  values fall back to automatic detection.
+
+*/
+
+#ifndef AUBIO_SIMD_PRIV_H
+#define AUBIO_SIMD_PRIV_H
+
+#include "utils/atomic_priv.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** table of vector kernels operating on raw sample arrays */
+typedef struct {
+  /** name of the instruction set, for instance "avx2" */
+  const char_t *name;
+  /** s[i] *= w[i] */
+  void (*weight) (smpl_t *s, const smpl_t *w, uint_t n);
+  /** out[i] = in[i] * w[i] */
+  void (*weighted_copy) (const smpl_t *in, const smpl_t *w, smpl_t *out,
+      uint_t n);
+  /** s[i] *= val */
+  void (*mul) (smpl_t *s, smpl_t val, uint_t n);
+  /** s[i] += val */
+  void (*add) (smpl_t *s, smpl_t val, uint_t n);
+  /** s[i] = sqrt(s[i]) */
+  void (*vsqrt) (smpl_t *s, uint_t n);
+  /** returns sum of s[i] */
+  smpl_t (*sum) (const smpl_t *s, uint_t n);
+  /** returns max of s[i], n > 0 */
+  smpl_t (*vmax) (const smpl_t *s, uint_t n);
+  /** returns min of s[i], n > 0 */
+  smpl_t (*vmin) (const smpl_t *s, uint_t n);
+  /** returns sum of a[i] * b[i] */
+  smpl_t (*dot) (const smpl_t *a, const smpl_t *b, uint_t n);
+  /** y[k] = sum of rows[k][i] * x[i], for k < n_rows and i < n */
+  void (*mvmul) (const smpl_t * const *rows, const smpl_t *x, smpl_t *y,
+      uint_t n_rows, uint_t n);
+  /** c[i][k] = sum of a[i][j] * b[k][j], for i < n_a, k < n_b and j < n */
+  void (*mmul) (const smpl_t * const *a, const smpl_t * const *b,
+      smpl_t * const *c, uint_t n_a, uint_t n_b, uint_t n);
+  /** y[k] = sum of (x[i] - x[i + lag + k])^2, for k < n_lags and i < n */
+  void (*sqdiff) (const smpl_t *x, smpl_t *y, uint_t lag, uint_t n_lags,
+      uint_t n);
+  /** returns sum of (i + 1) * s[i] */
+  smpl_t (*ramp_dot) (const smpl_t *s, uint_t n);
+  /** returns sum of max(x[i] - old[i], 0), then copies x to old */
+  smpl_t (*flux) (const smpl_t *x, smpl_t *old, uint_t n);
+  /** dev[i] = sqrt(|x[i]^2 - old[i]^2|) if x[i] > thres, 0 otherwise, then
+   * copies x to old */
+  void (*sqdev) (const smpl_t *x, smpl_t *old, smpl_t *dev, smpl_t thres,
+      uint_t n);
+  /** returns sum of w[i] * log(1 + x[i] / (old[i] + .1)), where w[i] is x[i]
+   * if weighted is 1 and 1 otherwise, then copies x to old; uses the log
+   * approximation of vlog */
+  smpl_t (*kl) (const smpl_t *x, smpl_t *old, uint_t weighted, uint_t n);
+  /** s[i] = log(s[i]), approximated for finite s[i] > 0, with an absolute
+   * error below 1.e-6 * (1 + |log(s[i])|) in single precision */
+  void (*vlog) (smpl_t *s, uint_t n);
+  /** peak[i] = max(s[i], max(decay * peak[i], floor)), s[i] /= peak[i], then
+   * if lambda > 0, s[i] = log(1 + lambda * s[i]), approximated as in vlog */
+  void (*whiten) (smpl_t *s, smpl_t *peak, smpl_t decay, smpl_t floor,
+      smpl_t lambda, uint_t n);
+  /** s[i] = exp(s[i]), approximated with a relative error below 1.e-6 in
+   * single precision, for s[i] within +/- 87; s[i] is clamped to this range
+   * first, to +/- 708 in double precision */
+  void (*vexp) (smpl_t *s, uint_t n);
+  /** out[i] = atan2(y[i], x[i]), approximated with an absolute error below
+   * 1.e-6 in single precision, taking signed zeros as +0; out may be y */
+  void (*vatan2) (const smpl_t *y, const smpl_t *x, smpl_t *out, uint_t n);
+  /** out[i] = sqrt(x[i]^2 + y[i]^2), rounded as the scalar expression */
+  void (*vhypot) (const smpl_t *x, const smpl_t *y, smpl_t *out, uint_t n);
+  /** re[i] = norm[i] * cos(phas[i]) and im[i] = norm[i] * sin(phas[i]), with
+   * sin and cos approximated with an absolute error below 1.e-6 in single
+   * precision, for |phas[i]| < 1.e4 */
+  void (*rect) (const smpl_t *norm, const smpl_t *phas, smpl_t *re,
+      smpl_t *im, uint_t n);
+  /** transient / steady state masks of n bins, tmask[i] = 1 if the phase
+   * deviation of bin i is above parm times its transient probability, smask[i]
+   * = 1 if it is below parm times its steady probability, 0 otherwise; the
+   * probabilities are then set to hi if the masked norm is positive, to 1
+   * otherwise; state holds blocks of ::AUBIO_SIMD_TSS_BLOCK bins, each made of
+   * the last phases, the phases before, the transient and the steady
+   * probabilities of these bins */
+  void (*tss) (const smpl_t *norm, const smpl_t *phas, smpl_t *state,
+      smpl_t *tmask, smpl_t *smask, smpl_t parm, smpl_t hi, uint_t n);
+  /** y[i] = sum of h[k] * (x[i + k] + x[i + 2 * half - 1 - k]), for k < half
+   * and i < n, a symmetric filter of 2 * half coefficients; x holds
+   * n + 2 * half - 1 samples */
+  void (*sym_fir) (const smpl_t *x, const smpl_t *h, uint_t half, smpl_t *y,
+      uint_t n);
+  /** bank of wavetable oscillators, one per voice v < n_voices: for each of
+   * the n samples, out[i] += amp[v] * table[offset[v] + pos[v]], linearly
+   * interpolated, then pos[v] += inc[v], wrapped to [0, len], inc[v] +=
+   * dinc[v] and amp[v] += damp[v]; n_voices is a multiple of
+   * ::AUBIO_SIMD_OSC_BLOCK, each table holds len + 2 samples, the last two
+   * repeating its first two, and 0 <= inc[v] < len */
+  void (*osc) (const smpl_t *table, smpl_t len, const smpl_t *offset,
+      smpl_t *pos, smpl_t *inc, const smpl_t *dinc, smpl_t *amp,
+      const smpl_t *damp, uint_t n_voices, smpl_t *out, uint_t n);
+  /** acc += a * b, complex multiply-accumulate of n bins; a, b and acc each
+   * hold n real parts followed by n imaginary parts */
+  void (*cmac) (const smpl_t *a, const smpl_t *b, smpl_t *acc, uint_t n);
+  /** bank of sliding DFT bins, one per lane k < n_bins: for each of the n
+   * samples, X[k] = x[i] - c[k] * old[i] + w[k] * X[k], with complex w, c
+   * and X; coefs holds the real parts of w, its imaginary parts, then those
+   * of c, state the real then the imaginary parts of X, each n_bins long;
+   * if power is not NULL, power[k][i] = |X[k]|^2 after sample i; n_bins is
+   * a multiple of ::AUBIO_SIMD_SDFT_BLOCK */
+  void (*sdft) (const smpl_t *x, const smpl_t *old, uint_t n,
+      const smpl_t *coefs, smpl_t *state, uint_t n_bins,
+      smpl_t * const *power);
+  /** in a single pass, energy = sum of s[i]^2, summed as in dot, peak = max
+   * of |s[i]|, and crossings = number of i > 0 where s[i - 1] < 0 and
+   * s[i] < 0 differ */
+  void (*stats) (const smpl_t *s, uint_t n, smpl_t *energy, smpl_t *peak,
+      uint_t *crossings);
+  /** positions j, in increasing order, from max(start, 1) to n - 2, where
+   * x[j] > x[j - 1], x[j] > x[j + 1] and x[j] > threshold; at most max of
+   * them are written to pos, the first ones, and their number is returned */
+  uint_t (*peaks) (const smpl_t *x, uint_t start, uint_t n, smpl_t threshold,
+      smpl_t *pos, uint_t max);
+  /** y[i] = max of x[j] for |j - i| <= r, x[0] and x[n - 1] being repeated
+   * beyond the ends, with 3 comparisons per element whatever r (van Herk,
+   * Gil and Werman); tmp holds 2 * (n + 2 * r) elements, y may be x */
+  void (*maxfilt) (const smpl_t *x, smpl_t *y, smpl_t *tmp, uint_t r,
+      uint_t n);
+} aubio_simd_ops_t;
+
+/** number of bins in each block of the state of aubio_simd_ops_t.tss, a
+ * multiple of the width of all instruction sets */
+#define AUBIO_SIMD_TSS_BLOCK 16
+
+/** number of voices of aubio_simd_ops_t.osc must be a multiple of this, the
+ * width of the widest instruction set */
+#define AUBIO_SIMD_OSC_BLOCK 16
+
+/** number of bins of aubio_simd_ops_t.sdft must be a multiple of this, the
+ * width of the widest instruction set */
+#define AUBIO_SIMD_SDFT_BLOCK 16
+
+/** currently selected kernel table, NULL until aubio_simd_init was called */
+extern const aubio_simd_ops_t *aubio_simd_ops;
+
+/** 1 to replace the log, exp, pow and atan2 of the hot loops with the
+ * approximations of the kernels, see aubio_set_fast_math() */
+extern uint_t aubio_simd_fast_math;
+
+/** detect the CPU features and select the kernel table
+
+  \return the selected kernel table, never NULL
+
+*/
+const aubio_simd_ops_t *aubio_simd_init (void);
+
+/** scalar reference kernel table, always available */
+const aubio_simd_ops_t *aubio_simd_scalar_ops (void);
+
+/** current kernel table, selected on the first call
+
+  The table is published with a release store, so that threads calling it
+  for the first time at once can all select it.
+
+*/
+static inline const aubio_simd_ops_t *aubio_simd_get (void)
+{
+  const aubio_simd_ops_t *ops = AUBIO_ATOMIC_LOAD_PTR(aubio_simd_ops);
+  return ops ? ops : aubio_simd_init();
+}
+
+/** shortcut to get the current kernel table */
+#define AUBIO_SIMD() aubio_simd_get()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_SIMD_PRIV_H */
@@ -0,0 +1,285 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "utils/quantize.h"
+#include "utils/specenc.h"
+#include "utils/simd_priv.h"
+
+struct _aubio_specenc_t {
+  uint_t input_size;
+  uint_t n_bins;
+  uint_t *edges;                /**< first input bin of each band, n_bins + 1 */
+  fvec_t *db;                   /**< level of each band */
+  u8_t *codes;                  /**< level of each band, encoded */
+  u8_t *levels;                 /**< codes held by clients */
+  smpl_t min_db;
+  smpl_t max_db;
+  uint_t tolerance;             /**< largest change left out */
+  uint_t interval;              /**< frames between key frames, or 0 */
+  uint_t since_key;             /**< delta frames since the last key frame */
+  uint_t key;                   /**< 1 to send a key frame next */
+  uint_t count;                 /**< frame counter */
+};
+
+static void aubio_specenc_set_edges (aubio_specenc_t *o, uint_t log_bins)
+{
+  uint_t k, n = o->input_size, b = o->n_bins;
+  o->edges[0] = 0;
+  for (k = 1; k < b; k++) {
+    uint_t e;
+    if (log_bins) {
+      // bin n^(k/b), at least one bin after the last edge, leaving one bin
+      // to each of the bands left
+      e = (uint_t)ROUND(POW((smpl_t)n, (smpl_t)k / b));
+      e = MIN(MAX(e, o->edges[k - 1] + 1), n - (b - k));
+    } else {
+      e = (uint_t)((u64_t)k * n / b);
+    }
+    o->edges[k] = e;
+  }
+  o->edges[b] = n;
+}
+
+aubio_specenc_t *new_aubio_specenc (uint_t input_size, uint_t n_bins)
+{
+  aubio_specenc_t *o = AUBIO_NEW(aubio_specenc_t);
+  if (!o) return NULL;
+  if ((sint_t)n_bins < 1 || (sint_t)input_size < (sint_t)n_bins) {
+    AUBIO_ERR("specenc: n_bins should be between 1 and input_size (%d),"
+        " got %d\n", input_size, n_bins);
+    goto beach;
+  }
+  o->input_size = input_size;
+  o->n_bins = n_bins;
+  o->edges = AUBIO_ARRAY(uint_t, n_bins + 1);
+  o->db = new_fvec(n_bins);
+  o->codes = AUBIO_ARRAY(u8_t, n_bins);
+  o->levels = AUBIO_ARRAY(u8_t, n_bins);
+  if (!o->edges || !o->db || !o->codes || !o->levels) goto beach;
+  aubio_specenc_set_edges(o, 0);
+  o->min_db = -100.;
+  o->max_db = 20.;
+  aubio_specenc_reset(o);
+  return o;
+
+beach:
+  del_aubio_specenc(o);
+  return NULL;
+}
+
+/* number of nibbles coding a difference d, modulo 256, in delta frames */
+#define AUBIO_SPECENC_NIBBLES(d) (((d) <= 7 || (d) >= 249) ? 1 : 3)
+
+/* differences of o->codes to the codes held by clients, or the codes
+ * themselves if not shorter */
+static uint_t aubio_specenc_write (aubio_specenc_t *o, u8_t *out)
+{
+  uint_t i, n = o->n_bins, nibbles = 0, size, last = 0;
+  u8_t *body = out + AUBIO_SPECENC_HEADER;
+  uint_t key = o->key || (o->interval && o->since_key + 1 >= o->interval);
+  if (!key) {
+    // leave out the changes within the tolerance, and the unchanged bands
+    // after the last changed one
+    for (i = 0; i < n; i++) {
+      sint_t d = (sint_t)o->codes[i] - (sint_t)o->levels[i];
+      if ((uint_t)(d < 0 ? -d : d) <= o->tolerance) o->codes[i] = o->levels[i];
+      else last = i + 1;
+    }
+    for (i = 0; i < last; i++) {
+      nibbles += AUBIO_SPECENC_NIBBLES((u8_t)(o->codes[i] - o->levels[i]));
+    }
+    // a delta frame must be shorter than a key frame
+    if ((nibbles + 1) / 2 >= n) key = 1;
+  }
+  if (key) {
+    out[0] = AUBIO_SPECENC_KEY;
+    memcpy(body, o->codes, n);
+    size = AUBIO_SPECENC_HEADER + n;
+    o->since_key = 0;
+  } else {
+    out[0] = AUBIO_SPECENC_DELTA;
+    size = AUBIO_SPECENC_HEADER + (nibbles + 1) / 2;
+    memset(body, 0, (nibbles + 1) / 2);
+    for (i = 0, nibbles = 0; i < last; i++) {
+      u8_t d = (u8_t)(o->codes[i] - o->levels[i]), k;
+      u8_t code[3] = { d, 0, 0 };
+      uint_t m = AUBIO_SPECENC_NIBBLES(d);
+      if (m == 3) {
+        code[0] = 8;
+        code[1] = d >> 4;
+        code[2] = d & 0xf;
+      }
+      for (k = 0; k < m; k++, nibbles++) {
+        body[nibbles / 2] |= (nibbles % 2) ? (code[k] & 0xf)
+          : (u8_t)((code[k] & 0xf) << 4);
+      }
+    }
+    o->since_key++;
+  }
+  out[1] = (u8_t)(o->count & 0xff);
+  out[2] = (u8_t)((o->count >> 8) & 0xff);
+  o->count++;
+  o->key = 0;
+  memcpy(o->levels, o->codes, n);
+  return size;
+}
+
+/* largest of the bins of each band, in dB, encoded to o->levels */
+static uint_t aubio_specenc_encode (aubio_specenc_t *o, const smpl_t *data,
+    smpl_t scale, u8_t *out)
+{
+  uint_t k;
+  const aubio_simd_ops_t *ops = AUBIO_SIMD();
+  for (k = 0; k < o->n_bins; k++) {
+    smpl_t v = ops->vmax(data + o->edges[k], o->edges[k + 1] - o->edges[k]);
+    o->db->data[k] = scale * SAFE_LOG10(v);
+  }
+  aubio_quantize_u8(o->db, o->min_db, o->max_db, o->codes);
+  return aubio_specenc_write(o, out);
+}
+
+uint_t aubio_specenc_do (aubio_specenc_t *o, const fvec_t *in, u8_t *out)
+{
+  if (in->length != o->input_size) {
+    AUBIO_ERR("specenc: expected %d values, got %d\n", o->input_size,
+        in->length);
+    return 0;
+  }
+  return aubio_specenc_encode(o, in->data, 10., out);
+}
+
+uint_t aubio_specenc_do_spectrum (aubio_specenc_t *o, const cvec_t *in,
+    u8_t *out)
+{
+  if (in->length != o->input_size) {
+    AUBIO_ERR("specenc: expected %d bins, got %d\n", o->input_size,
+        in->length);
+    return 0;
+  }
+  return aubio_specenc_encode(o, in->norm, 20., out);
+}
+
+uint_t aubio_specenc_set_range (aubio_specenc_t *o, smpl_t min_db,
+    smpl_t max_db)
+{
+  if (!(max_db > min_db)) {
+    AUBIO_ERR("specenc: max_db (%.2f) should be greater than min_db"
+        " (%.2f)\n", max_db, min_db);
+    return AUBIO_FAIL;
+  }
+  o->min_db = min_db;
+  o->max_db = max_db;
+  o->key = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_specenc_set_log_bins (aubio_specenc_t *o, uint_t enable)
+{
+  if (enable > 1) {
+    AUBIO_ERR("specenc: log_bins should be 0 or 1, got %d\n", enable);
+    return AUBIO_FAIL;
+  }
+  aubio_specenc_set_edges(o, enable);
+  o->key = 1;
+  return AUBIO_OK;
+}
+
+uint_t aubio_specenc_set_keyframe_interval (aubio_specenc_t *o,
+    uint_t interval)
+{
+  o->interval = interval;
+  return AUBIO_OK;
+}
+
+uint_t aubio_specenc_set_tolerance (aubio_specenc_t *o, uint_t steps)
+{
+  if (steps > 255) {
+    AUBIO_ERR("specenc: tolerance should be <= 255, got %d\n", steps);
+    return AUBIO_FAIL;
+  }
+  o->tolerance = steps;
+  return AUBIO_OK;
+}
+
+uint_t aubio_specenc_get_max_size (const aubio_specenc_t *o)
+{
+  return AUBIO_SPECENC_HEADER + o->n_bins;
+}
+
+const u8_t *aubio_specenc_get_levels (const aubio_specenc_t *o)
+{
+  return o->levels;
+}
+
+void aubio_specenc_reset (aubio_specenc_t *o)
+{
+  memset(o->codes, 0, o->n_bins);
+  memset(o->levels, 0, o->n_bins);
+  o->since_key = 0;
+  o->count = 0;
+  o->key = 1;
+}
+
+uint_t aubio_specenc_decode (const u8_t *frame, uint_t size, u8_t *levels,
+    uint_t n_bins)
+{
+  const u8_t *body = frame + AUBIO_SPECENC_HEADER;
+  uint_t i, p = 0, n_nibbles;
+  if (size < AUBIO_SPECENC_HEADER) return AUBIO_FAIL;
+  if (frame[0] == AUBIO_SPECENC_KEY) {
+    if (size != AUBIO_SPECENC_HEADER + n_bins) return AUBIO_FAIL;
+    memcpy(levels, body, n_bins);
+    return AUBIO_OK;
+  }
+  if (frame[0] != AUBIO_SPECENC_DELTA) return AUBIO_FAIL;
+  n_nibbles = 2 * (size - AUBIO_SPECENC_HEADER);
+#define AUBIO_SPECENC_NIBBLE(j) \
+  (((j) % 2) ? (body[(j) / 2] & 0xf) : (body[(j) / 2] >> 4))
+  // the bands after the last nibble are unchanged
+  for (i = 0; i < n_bins && p < n_nibbles; i++) {
+    u8_t d = AUBIO_SPECENC_NIBBLE(p);
+    p++;
+    if (d == 8) {
+      if (p + 2 > n_nibbles) return AUBIO_FAIL;
+      d = (u8_t)((AUBIO_SPECENC_NIBBLE(p) << 4) | AUBIO_SPECENC_NIBBLE(p + 1));
+      p += 2;
+    } else if (d > 8) {
+      d = (u8_t)(d + 240);
+    }
+    levels[i] = (u8_t)(levels[i] + d);
+  }
+  // at most one padding nibble, set to 0
+  if (n_nibbles - p > 1 || (p < n_nibbles && AUBIO_SPECENC_NIBBLE(p) != 0))
+    return AUBIO_FAIL;
+#undef AUBIO_SPECENC_NIBBLE
+  return AUBIO_OK;
+}
+
+void del_aubio_specenc (aubio_specenc_t *o)
+{
+  if (o->edges) AUBIO_FREE(o->edges);
+  if (o->db) del_fvec(o->db);
+  if (o->codes) AUBIO_FREE(o->codes);
+  if (o->levels) AUBIO_FREE(o->levels);
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,234 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_SPECENC_H
+#define AUBIO_SPECENC_H
+
+/** \file
+
+  Compact frames of spectra for streaming to visualisations
+
+  This object turns each spectrum, or each output of a filterbank, into a
+  short byte frame ready to be sent over a network, in a single pass:
+
+    - the input bins are grouped into `n_bins` bands, each band keeping the
+      largest of its bins; bands are equally wide, or wider towards the high
+      frequencies with ::aubio_specenc_set_log_bins
+    - the level of each band is converted to dB and encoded as one byte,
+      with 0 at `min_db` and 255 at `max_db`, see aubio_quantize_u8()
+    - the codes are sent as differences to those of the previous frame,
+      most of them fitting in 4 bits
+
+  Each frame starts with a header of ::AUBIO_SPECENC_HEADER bytes: its type,
+  then a frame counter modulo 65536, least significant byte first, so that
+  a client can tell when frames were lost. A frame of type
+  ::AUBIO_SPECENC_KEY then holds the `n_bins` codes as is.
+
+  A frame of type ::AUBIO_SPECENC_DELTA holds one nibble per band, the high
+  nibble of each byte first: 0 if the code of the band is unchanged, 1 to 7
+  if it increased by as much, 9 to 15 if it decreased by 7 to 1, and 8 if
+  two more nibbles follow, holding the difference modulo 256, high nibble
+  first. The nibbles stop after the last band that changed, the last byte
+  being padded with a 0 nibble; a delta frame without any byte after its
+  header thus leaves all the codes unchanged.
+
+  A key frame is sent first, after ::aubio_specenc_reset, every
+  `interval` frames if set with ::aubio_specenc_set_keyframe_interval, and
+  whenever the differences would not be shorter. A frame is thus never
+  longer than ::aubio_specenc_get_max_size bytes.
+
+  Changes of a few codes, often only noise, can be left out with
+  ::aubio_specenc_set_tolerance, so that more bands are unchanged.
+
+  Frames can be decoded with ::aubio_specenc_decode, then converted back to
+  dB with aubio_dequantize_u8().
+
+  \example utils/test-specenc.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** number of bytes in the header of each frame */
+#define AUBIO_SPECENC_HEADER 3
+
+/** types of frames, the first byte of their header */
+enum {
+  AUBIO_SPECENC_KEY = 0,     /**< codes of all bands */
+  AUBIO_SPECENC_DELTA = 1    /**< differences to the previous frame */
+};
+
+/** spectrum encoder object */
+typedef struct _aubio_specenc_t aubio_specenc_t;
+
+/** create spectrum encoder
+
+  \param input_size number of bins of each input, for instance `win_s / 2 +
+  1` for a spectrum, or the number of filters of a filterbank
+  \param n_bins number of bands of each frame, from 1 to `input_size`
+
+  \return newly created ::aubio_specenc_t, or NULL on failure
+
+  The levels are encoded between -100 and 20 dB until
+  ::aubio_specenc_set_range is called.
+
+*/
+aubio_specenc_t *new_aubio_specenc (uint_t input_size, uint_t n_bins);
+
+/** encode energies, for instance the output of a filterbank
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+  \param in `input_size` energies, converted to `10 * log10(energy)`
+  \param out frame, at least ::aubio_specenc_get_max_size bytes
+
+  \return number of bytes written to `out`, 0 if `in` has the wrong length
+
+*/
+uint_t aubio_specenc_do (aubio_specenc_t *o, const fvec_t *in, u8_t *out);
+
+/** encode magnitudes of a spectrum
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+  \param in spectrum of `input_size` bins, its norms converted to `20 *
+  log10(norm)`; the phases are not read
+  \param out frame, at least ::aubio_specenc_get_max_size bytes
+
+  \return number of bytes written to `out`, 0 if `in` has the wrong length
+
+*/
+uint_t aubio_specenc_do_spectrum (aubio_specenc_t *o, const cvec_t *in,
+    u8_t *out);
+
+/** set the levels encoded as 0 and 255
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+  \param min_db level encoded as 0, and below
+  \param max_db level encoded as 255, and above, greater than `min_db`
+
+  \return 0 if successful, non-zero otherwise
+
+  A key frame is sent next.
+
+*/
+uint_t aubio_specenc_set_range (aubio_specenc_t *o, smpl_t min_db,
+    smpl_t max_db);
+
+/** group bins on a logarithmic frequency scale
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+  \param enable 1 for bands of increasing width, each spanning about the
+  same ratio of frequencies, at least one bin wide; 0 for bands of equal
+  width
+
+  \return 0 if successful, non-zero otherwise
+
+  Filterbanks already on a perceptual scale, such as mel bands, should be
+  grouped linearly. A key frame is sent next.
+
+*/
+uint_t aubio_specenc_set_log_bins (aubio_specenc_t *o, uint_t enable);
+
+/** set the largest number of frames between two key frames
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+  \param interval a key frame is sent at least every `interval` frames, so
+  that clients joining late or losing frames catch up; 0, the default, to
+  send key frames only when needed
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_specenc_set_keyframe_interval (aubio_specenc_t *o,
+    uint_t interval);
+
+/** set the smallest change of code sent in delta frames
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+  \param steps largest difference, in codes, between the level of a band
+  and the code held by clients that is not sent; 0, the default, to send
+  every change
+
+  \return 0 if successful, non-zero otherwise
+
+  The codes held by clients may then differ from the levels by up to
+  `steps` codes, until the next key frame.
+
+*/
+uint_t aubio_specenc_set_tolerance (aubio_specenc_t *o, uint_t steps);
+
+/** get the largest size of a frame
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+
+  \return `n_bins + AUBIO_SPECENC_HEADER`, in bytes
+
+*/
+uint_t aubio_specenc_get_max_size (const aubio_specenc_t *o);
+
+/** get the codes of the last frame
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+
+  \return `n_bins` codes, those a client holds once it decoded the last
+  frame
+
+*/
+const u8_t *aubio_specenc_get_levels (const aubio_specenc_t *o);
+
+/** send a key frame next, and restart the frame counter
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+
+*/
+void aubio_specenc_reset (aubio_specenc_t *o);
+
+/** decode a frame
+
+  \param frame frame written by ::aubio_specenc_do or
+  ::aubio_specenc_do_spectrum
+  \param size number of bytes of `frame`
+  \param levels `n_bins` codes, those of the previous frame, updated in
+  place
+  \param n_bins number of bands of the encoder
+
+  \return 0 if successful, non-zero if the frame is malformed, in which case
+  `levels` should be discarded until the next key frame
+
+  A delta frame can only be decoded after the frame preceding it; the
+  counters of the headers can be compared to check none was lost.
+
+*/
+uint_t aubio_specenc_decode (const u8_t *frame, uint_t size, u8_t *levels,
+    uint_t n_bins);
+
+/** delete spectrum encoder
+
+  \param o spectrum encoder, created by ::new_aubio_specenc
+
+*/
+void del_aubio_specenc (aubio_specenc_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_SPECENC_H */
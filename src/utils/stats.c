@@ -0,0 +1,127 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "utils/stats.h"
+#include "utils/atomic_priv.h"
+
+#ifdef HAVE_AUBIO_PROFILING
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#include <intrin.h>
+#else
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <time.h>
+#endif
+
+// counters of the functions called at least once, most recent first
+static aubio_stats_counter_t *aubio_stats_head = NULL;
+
+// add a counter to the list, once, from the first thread calling it
+static void aubio_stats_register (aubio_stats_counter_t *c)
+{
+  uint_t registered = 0;
+  if (!AUBIO_ATOMIC_CAS(c->registered, registered, 1)) {
+    return;
+  }
+  c->next = AUBIO_ATOMIC_LOAD_PTR(aubio_stats_head);
+  while (!AUBIO_ATOMIC_CAS_PTR(aubio_stats_head, c->next, c));
+}
+
+unsigned long long aubio_stats_clock (void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  unsigned long long count;
+  __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (count));
+  return count;
+#elif defined(_WIN32)
+  LARGE_INTEGER count;
+  QueryPerformanceCounter (&count);
+  return (unsigned long long)count.QuadPart;
+#else
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return (unsigned long long)t.tv_sec * 1000000000ULL + t.tv_nsec;
+#endif
+}
+
+void aubio_stats_add (aubio_stats_counter_t *c, unsigned long long start)
+{
+  unsigned long long cycles = aubio_stats_clock() - start;
+  unsigned long long max = AUBIO_ATOMIC_LOAD64(c->max_cycles);
+  if (!AUBIO_ATOMIC_LOAD(c->registered)) aubio_stats_register (c);
+  AUBIO_ATOMIC_ADD64(c->calls, 1);
+  AUBIO_ATOMIC_ADD64(c->cycles, cycles);
+  while (cycles > max && !AUBIO_ATOMIC_CAS64(c->max_cycles, max, cycles));
+}
+
+uint_t aubio_stats_enabled (void)
+{
+  return 1;
+}
+
+uint_t aubio_stats_get (aubio_stats_t *stats, uint_t n)
+{
+  aubio_stats_counter_t *c = AUBIO_ATOMIC_LOAD_PTR(aubio_stats_head);
+  uint_t count = 0;
+  for (; c; c = c->next, count++) {
+    if (count >= n) continue;
+    stats[count].name = c->name;
+    stats[count].calls = AUBIO_ATOMIC_LOAD64(c->calls);
+    stats[count].cycles = AUBIO_ATOMIC_LOAD64(c->cycles);
+    stats[count].max_cycles = AUBIO_ATOMIC_LOAD64(c->max_cycles);
+  }
+  return count;
+}
+
+void aubio_stats_reset (void)
+{
+  aubio_stats_counter_t *c = AUBIO_ATOMIC_LOAD_PTR(aubio_stats_head);
+  for (; c; c = c->next) {
+    AUBIO_ATOMIC_STORE64(c->calls, 0);
+    AUBIO_ATOMIC_STORE64(c->cycles, 0);
+    AUBIO_ATOMIC_STORE64(c->max_cycles, 0);
+  }
+}
+
+#else /* HAVE_AUBIO_PROFILING */
+
+uint_t aubio_stats_enabled (void)
+{
+  return 0;
+}
+
+uint_t aubio_stats_get (aubio_stats_t *stats UNUSED, uint_t n UNUSED)
+{
+  return 0;
+}
+
+void aubio_stats_reset (void)
+{
+}
+
+#endif /* HAVE_AUBIO_PROFILING */
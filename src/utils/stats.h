@@ -0,0 +1,86 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_STATS_H
+#define AUBIO_STATS_H
+
+/** \file
+
+  Timing of the processing functions
+
+  When aubio is built with the `profiling` option, the `_do` functions of the
+  main objects, and the transforms of the FFT backend, count their calls and
+  the time spent in them, so that an application can find which of its
+  objects takes most of its time budget.
+
+  The times are measured in cycles of the time-stamp counter of the processor
+  where one is available, and in nanoseconds otherwise. They include the
+  functions called by each function: the time of `onset` includes that of
+  `pvoc`, which includes the time of `fft forward`.
+
+  Without the `profiling` option, nothing is measured, ::aubio_stats_enabled
+  returns 0 and ::aubio_stats_get finds no function.
+
+  \example utils/test-stats.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** timing of a processing function, see ::aubio_stats_get */
+typedef struct {
+  const char_t *name;             /**< object and operation, e.g. `onset` */
+  unsigned long long calls;       /**< number of calls */
+  unsigned long long cycles;      /**< time spent in all calls */
+  unsigned long long max_cycles;  /**< time spent in the longest call */
+} aubio_stats_t;
+
+/** check whether aubio was built with profiling
+
+  \return 1 if aubio was built with the `profiling` option, 0 otherwise
+
+*/
+uint_t aubio_stats_enabled (void);
+
+/** get the timings of the functions called so far
+
+  \param stats array to fill, may be NULL if `n` is 0
+  \param n number of elements of `stats`
+
+  \return number of functions called so far, which may be more than `n`;
+  only the first `n` are then written to `stats`
+
+  The functions are listed in no particular order, and called functions are
+  never removed from the list, so that calling this function with the size
+  returned by a previous call always finds at least as many functions.
+
+*/
+uint_t aubio_stats_get (aubio_stats_t *stats, uint_t n);
+
+/** reset the counters of all functions to 0 */
+void aubio_stats_reset (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_STATS_H */
@@ -0,0 +1,218 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+/* pthread_setaffinity_np() and cpu_set_t */
+#define _GNU_SOURCE
+#endif
+
+#include "aubio_priv.h"
+#include "utils/threads.h"
+#include "io/iothread_priv.h"
+#if !defined(_WIN32)
+#include <sched.h>
+#endif
+
+#if defined(_WIN32) || defined(HAVE_PTHREAD_SETAFFINITY_NP)
+#define AUBIO_THREADS_AFFINITY 1
+#endif
+
+/** settings of the threads of a role */
+typedef struct {
+  u64_t affinity;               /**< processors allowed, 0 for any */
+  uint_t priority;              /**< real-time priority, 0 to inherit */
+} aubio_thread_settings_t;
+
+/* process-wide, read when a thread is started */
+static aubio_thread_settings_t aubio_thread_settings[AUBIO_THREAD_N_ROLES];
+static uint_t aubio_thread_pool_size = 0;
+
+/** function and argument of a thread started with settings */
+typedef struct {
+  aubio_io_thread_func_t func;
+  void *arg;
+  aubio_thread_settings_t settings;
+} aubio_thread_start_t;
+
+uint_t aubio_threads_set_affinity (uint_t role, u64_t mask)
+{
+  if (role >= AUBIO_THREAD_N_ROLES) {
+    AUBIO_ERR("threads: unknown role %d\n", role);
+    return AUBIO_FAIL;
+  }
+#if !defined(AUBIO_THREADS_AFFINITY)
+  if (mask != 0) {
+    AUBIO_ERR("threads: can not set the affinity of threads on this"
+        " system\n");
+    return AUBIO_FAIL;
+  }
+#endif
+  aubio_thread_settings[role].affinity = mask;
+  return AUBIO_OK;
+}
+
+u64_t aubio_threads_get_affinity (uint_t role)
+{
+  if (role >= AUBIO_THREAD_N_ROLES) return 0;
+  return aubio_thread_settings[role].affinity;
+}
+
+uint_t aubio_threads_set_priority (uint_t role, uint_t priority)
+{
+  if (role >= AUBIO_THREAD_N_ROLES) {
+    AUBIO_ERR("threads: unknown role %d\n", role);
+    return AUBIO_FAIL;
+  }
+  if (priority > 99) {
+    AUBIO_ERR("threads: got priority %d, expected <= 99\n", priority);
+    return AUBIO_FAIL;
+  }
+  aubio_thread_settings[role].priority = priority;
+  return AUBIO_OK;
+}
+
+uint_t aubio_threads_get_priority (uint_t role)
+{
+  if (role >= AUBIO_THREAD_N_ROLES) return 0;
+  return aubio_thread_settings[role].priority;
+}
+
+uint_t aubio_threads_set_pool_size (uint_t size)
+{
+  aubio_thread_pool_size = size;
+  return AUBIO_OK;
+}
+
+uint_t aubio_threads_get_pool_size (void)
+{
+  u64_t mask = aubio_thread_settings[AUBIO_THREAD_WORKER].affinity;
+  uint_t n = 0;
+  if (aubio_thread_pool_size) return aubio_thread_pool_size;
+  if (!mask) return aubio_io_get_processors();
+  for (; mask; mask >>= 1) n += (uint_t)(mask & 1);
+  return n;
+}
+
+#if defined(_WIN32)
+typedef HANDLE (WINAPI *aubio_avset_t) (LPCSTR task, LPDWORD index);
+typedef BOOL (WINAPI *aubio_avrevert_t) (HANDLE task);
+#endif
+
+/* apply the settings to the calling thread, a new one */
+static void aubio_thread_apply (const aubio_thread_settings_t *s)
+{
+#if defined(_WIN32)
+  if (s->affinity && !SetThreadAffinityMask (GetCurrentThread (),
+        (DWORD_PTR)s->affinity)) {
+    AUBIO_WRN("threads: failed setting the affinity of a thread\n");
+  }
+  // without the scheduler service, the highest priority of the class
+  if (s->priority && !SetThreadPriority (GetCurrentThread (),
+        THREAD_PRIORITY_TIME_CRITICAL)) {
+    AUBIO_WRN("threads: failed raising the priority of a thread\n");
+  }
+#else
+#if defined(HAVE_PTHREAD_SETAFFINITY_NP)
+  if (s->affinity) {
+    cpu_set_t set;
+    uint_t i;
+    CPU_ZERO (&set);
+    for (i = 0; i < 64 && i < CPU_SETSIZE; i++) {
+      if ((s->affinity >> i) & 1) CPU_SET (i, &set);
+    }
+    if (pthread_setaffinity_np (pthread_self (), sizeof (set), &set) != 0) {
+      AUBIO_WRN("threads: failed setting the affinity of a thread\n");
+    }
+  }
+#endif
+  if (s->priority) {
+    struct sched_param param;
+    int lo = sched_get_priority_min (SCHED_FIFO);
+    int hi = sched_get_priority_max (SCHED_FIFO);
+    param.sched_priority = MIN (MAX ((int)s->priority, lo), hi);
+    if (pthread_setschedparam (pthread_self (), SCHED_FIFO, &param) != 0) {
+      AUBIO_WRN("threads: failed setting the real-time priority %d of a"
+          " thread\n", param.sched_priority);
+    }
+  }
+#endif
+}
+
+AUBIO_IO_THREAD_FUNC(aubio_thread_entry)
+{
+  aubio_thread_start_t start = *(aubio_thread_start_t *)arg;
+#if defined(_WIN32)
+  HMODULE avrt = NULL;
+  HANDLE task = NULL;
+  DWORD ret, index = 0;
+#endif
+  AUBIO_FREE(arg);
+  aubio_thread_apply (&start.settings);
+#if defined(_WIN32)
+  if (start.settings.priority && (avrt = LoadLibraryA ("avrt.dll"))) {
+    aubio_avset_t avset = (aubio_avset_t)(void (*)(void))
+      GetProcAddress (avrt, "AvSetMmThreadCharacteristicsA");
+    if (avset) task = avset ("Pro Audio", &index);
+  }
+  ret = start.func (start.arg);
+  if (task) {
+    aubio_avrevert_t avrevert = (aubio_avrevert_t)(void (*)(void))
+      GetProcAddress (avrt, "AvRevertMmThreadCharacteristics");
+    if (avrevert) avrevert (task);
+  }
+  if (avrt) FreeLibrary (avrt);
+  return ret;
+#else
+  return start.func (start.arg);
+#endif
+}
+
+static uint_t aubio_thread_spawn (aubio_io_thread_t *thread,
+    aubio_io_thread_func_t func, void *arg)
+{
+#if defined(_WIN32)
+  *thread = CreateThread (NULL, 0, func, arg, 0, NULL);
+  return *thread != NULL ? AUBIO_OK : AUBIO_FAIL;
+#else
+  return pthread_create (thread, NULL, func, arg) == 0 ? AUBIO_OK : AUBIO_FAIL;
+#endif
+}
+
+uint_t aubio_io_thread_create (aubio_io_thread_t *thread, uint_t role,
+    aubio_io_thread_func_t func, void *arg)
+{
+  aubio_thread_start_t *start;
+  aubio_thread_settings_t s = aubio_thread_settings[MIN(role,
+      AUBIO_THREAD_N_ROLES - 1)];
+  // threads with the default settings are started directly
+  if (s.affinity == 0 && s.priority == 0) {
+    return aubio_thread_spawn (thread, func, arg);
+  }
+  start = AUBIO_NEW(aubio_thread_start_t);
+  if (!start) return AUBIO_FAIL;
+  start->func = func;
+  start->arg = arg;
+  start->settings = s;
+  if (aubio_thread_spawn (thread, aubio_thread_entry, start) != AUBIO_OK) {
+    AUBIO_FREE(start);
+    return AUBIO_FAIL;
+  }
+  return AUBIO_OK;
+}
@@ -0,0 +1,154 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+#ifndef AUBIO_THREADS_H
+#define AUBIO_THREADS_H
+
+/** \file
+
+  Placement and priority of the threads started by aubio
+
+  Several objects run part of their work on threads of their own: the
+  sources reading ahead and the sinks writing asynchronously, the workers of
+  ::aubio_batch_t, ::aubio_graph_t, the offline analyses and the phase
+  vocoder, and the worker of ::aubio_rthost_t. These threads are sorted in
+  three roles, each with its own settings:
+
+  - ::AUBIO_THREAD_IO, the threads reading and writing files;
+  - ::AUBIO_THREAD_WORKER, the threads sharing a computation;
+  - ::AUBIO_THREAD_STREAM, the worker analysing a live stream.
+
+  For each role, the threads can be restricted to a set of processors, with
+  ::aubio_threads_set_affinity, and given a real-time priority, with
+  ::aubio_threads_set_priority. The number of workers started by the objects
+  which were not given one is set with ::aubio_threads_set_pool_size. For
+  instance, to keep the heavy analyses away from the two first cores, left
+  to the threads driving the outputs:
+
+  \code
+  aubio_threads_set_affinity (AUBIO_THREAD_WORKER, ~(u64_t)3);
+  aubio_threads_set_pool_size (6);
+  aubio_threads_set_priority (AUBIO_THREAD_STREAM, 70);
+  \endcode
+
+  The settings are process-wide. They are read when a thread is started, and
+  do not move the threads already running: they should be made before
+  creating the objects. A setting which can not be applied to a new thread,
+  for instance a real-time priority without the permission to use it, is
+  reported as a warning, and the thread runs with the default settings.
+
+  Affinities are supported on Linux and Windows, real-time priorities on
+  POSIX systems, with `SCHED_FIFO`, and on Windows, through the Multimedia
+  Class Scheduler Service.
+
+  \example utils/test-threads.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** roles of the threads, see ::aubio_threads_set_affinity */
+enum {
+  AUBIO_THREAD_IO = 0,      /**< reading and writing files */
+  AUBIO_THREAD_WORKER = 1,  /**< sharing a computation */
+  AUBIO_THREAD_STREAM = 2,  /**< analysing a live stream */
+  AUBIO_THREAD_N_ROLES = 3  /**< number of roles */
+};
+
+/** restrict the threads of a role to some processors
+
+  \param role ::AUBIO_THREAD_IO, ::AUBIO_THREAD_WORKER or
+  ::AUBIO_THREAD_STREAM
+  \param mask bit `i` set to run on processor `i`, or 0 to run on any of
+  them (default)
+
+  \return 0 if successful, non-zero if `role` is unknown or if the
+  affinity of threads can not be set on this system
+
+*/
+uint_t aubio_threads_set_affinity (uint_t role, u64_t mask);
+
+/** get the processors of a role
+
+  \param role ::AUBIO_THREAD_IO, ::AUBIO_THREAD_WORKER or
+  ::AUBIO_THREAD_STREAM
+
+  \return mask set with ::aubio_threads_set_affinity, 0 if any processor
+  can be used
+
+*/
+u64_t aubio_threads_get_affinity (uint_t role);
+
+/** run the threads of a role with a real-time priority
+
+  \param role ::AUBIO_THREAD_IO, ::AUBIO_THREAD_WORKER or
+  ::AUBIO_THREAD_STREAM
+  \param priority 0 to inherit the scheduling of the creating thread
+  (default), or a real-time priority from 1 to 99, clamped to the range of
+  the system
+
+  \return 0 if successful, non-zero if `role` or `priority` is out of
+  range
+
+  On Windows, any priority above 0 registers the threads with the "Pro
+  Audio" task of the Multimedia Class Scheduler Service.
+
+*/
+uint_t aubio_threads_set_priority (uint_t role, uint_t priority);
+
+/** get the priority of a role
+
+  \param role ::AUBIO_THREAD_IO, ::AUBIO_THREAD_WORKER or
+  ::AUBIO_THREAD_STREAM
+
+  \return priority set with ::aubio_threads_set_priority
+
+*/
+uint_t aubio_threads_get_priority (uint_t role);
+
+/** set the default number of workers
+
+  \param size number of threads, or 0 for the number of processors allowed
+  to the workers (default)
+
+  \return 0 if successful
+
+  The number of threads of ::aubio_batch_t, ::aubio_onset_offline_t and
+  ::aubio_pitch_offline_t defaults to this size, when they are created or
+  when they are given 0 threads.
+
+*/
+uint_t aubio_threads_set_pool_size (uint_t size);
+
+/** get the default number of workers
+
+  \return size set with ::aubio_threads_set_pool_size, or, if 0, the
+  number of processors of the affinity of ::AUBIO_THREAD_WORKER, or of the
+  system
+
+*/
+uint_t aubio_threads_get_pool_size (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_THREADS_H */
@@ -0,0 +1,371 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "fmat.h"
+#include "io/source.h"
+#include "io/features.h"
+#include "utils/waveform.h"
+#include "utils/simd_priv.h"
+
+/* enough levels for 2^40 blocks */
+#define AUBIO_WAVEFORM_MAX_LEVELS 41
+/* number of frames read at once by aubio_waveform_do_source */
+#define AUBIO_WAVEFORM_HOP 4096
+
+enum { WF_MIN, WF_MAX, WF_RMS, WF_ROWS };
+
+typedef struct {
+  fmat_t view;                  /**< 3 rows of count values */
+  smpl_t *rows[WF_ROWS];        /**< min, max, rms of each block */
+  lsmp_t *ms;                   /**< mean square of each block */
+  uint_t capacity;              /**< number of blocks allocated */
+} aubio_waveform_level_t;
+
+struct _aubio_waveform_t {
+  uint_t block_size;
+  uint_t samplerate;
+  aubio_waveform_level_t levels[AUBIO_WAVEFORM_MAX_LEVELS];
+  uint_t n_levels;
+  uint_t n_blocks;              /**< number of complete blocks of level 0 */
+  unsigned long long frames;    /**< number of frames in level 0 */
+  /* block of level 0 being accumulated */
+  smpl_t min;
+  smpl_t max;
+  lsmp_t sum;                   /**< sum of squares of its samples */
+  uint_t n_frames;              /**< number of frames in the block */
+  uint_t n_samples;             /**< number of samples, over all channels */
+};
+
+aubio_waveform_t *new_aubio_waveform (uint_t block_size, uint_t samplerate)
+{
+  aubio_waveform_t *o = AUBIO_NEW(aubio_waveform_t);
+  if (!o) return NULL;
+  if ((sint_t)block_size < 1) {
+    AUBIO_ERR("waveform: block_size should be >= 1, got %d\n", block_size);
+    goto beach;
+  }
+  if ((sint_t)samplerate < 0) {
+    AUBIO_ERR("waveform: samplerate should be >= 0, got %d\n", samplerate);
+    goto beach;
+  }
+  o->block_size = block_size;
+  o->samplerate = samplerate;
+  return o;
+
+beach:
+  del_aubio_waveform(o);
+  return NULL;
+}
+
+static uint_t aubio_waveform_grow (aubio_waveform_level_t *l, uint_t count)
+{
+  uint_t i, capacity = l->capacity ? l->capacity : 64;
+  void *p;
+  if (count <= l->capacity) return AUBIO_OK;
+  while (capacity < count) capacity *= 2;
+  for (i = 0; i < WF_ROWS; i++) {
+    p = AUBIO_REALLOC(l->rows[i], capacity * sizeof(smpl_t));
+    if (!p) return AUBIO_FAIL;
+    l->rows[i] = (smpl_t *)p;
+  }
+  p = AUBIO_REALLOC(l->ms, capacity * sizeof(lsmp_t));
+  if (!p) return AUBIO_FAIL;
+  l->ms = (lsmp_t *)p;
+  l->capacity = capacity;
+  l->view.height = WF_ROWS;
+  l->view.data = l->rows;
+  return AUBIO_OK;
+}
+
+/* number of frames covered by block i of level k */
+static unsigned long long aubio_waveform_frames (const aubio_waveform_t *o,
+    uint_t k, uint_t i)
+{
+  unsigned long long span = (unsigned long long)o->block_size << k;
+  if (i + 1 < o->levels[k].view.length) return span;
+  return o->frames - i * span;
+}
+
+/* write block i of level 0, the last one or a new one, then update its
+   parent in each of the levels above */
+static uint_t aubio_waveform_put (aubio_waveform_t *o, uint_t i,
+    smpl_t min, smpl_t max, lsmp_t ms)
+{
+  uint_t k;
+  for (k = 0; k < AUBIO_WAVEFORM_MAX_LEVELS; k++) {
+    aubio_waveform_level_t *l = &o->levels[k];
+    uint_t c;
+    if (k == o->n_levels) o->n_levels++;
+    if (i == l->view.length) {
+      if (aubio_waveform_grow(l, i + 1) != AUBIO_OK) {
+        AUBIO_ERR("waveform: failed growing level %d to %d blocks\n", k,
+            i + 1);
+        return AUBIO_FAIL;
+      }
+      l->view.length = i + 1;
+    }
+    l->rows[WF_MIN][i] = min;
+    l->rows[WF_MAX][i] = max;
+    l->rows[WF_RMS][i] = SQRT(ms);
+    l->ms[i] = ms;
+    // the top level holds a single block
+    if (k + 1 == o->n_levels && l->view.length == 1) return AUBIO_OK;
+    // parent of the pair of blocks, or of the last one
+    c = i & ~1u;
+    min = l->rows[WF_MIN][c];
+    max = l->rows[WF_MAX][c];
+    ms = l->ms[c];
+    if (c + 1 < l->view.length) {
+      lsmp_t n0 = aubio_waveform_frames(o, k, c);
+      lsmp_t n1 = aubio_waveform_frames(o, k, c + 1);
+      min = MIN(min, l->rows[WF_MIN][c + 1]);
+      max = MAX(max, l->rows[WF_MAX][c + 1]);
+      ms = (ms * n0 + l->ms[c + 1] * n1) / (n0 + n1);
+    }
+    i /= 2;
+  }
+  AUBIO_ERR("waveform: more than %d levels\n", AUBIO_WAVEFORM_MAX_LEVELS);
+  return AUBIO_FAIL;
+}
+
+/* add frames start to start + n of each row of in to the current block */
+static void aubio_waveform_add (aubio_waveform_t *o, smpl_t **in,
+    uint_t channels, uint_t start, uint_t n)
+{
+  uint_t c;
+  for (c = 0; c < channels; c++) {
+    const smpl_t *x = in[c] + start;
+    smpl_t min = AUBIO_SIMD()->vmin(x, n);
+    smpl_t max = AUBIO_SIMD()->vmax(x, n);
+    if (o->n_samples == 0 || min < o->min) o->min = min;
+    if (o->n_samples == 0 || max > o->max) o->max = max;
+    o->sum += AUBIO_SIMD()->dot(x, x, n);
+    o->n_samples += n;
+  }
+  o->n_frames += n;
+}
+
+static uint_t aubio_waveform_do_channels (aubio_waveform_t *o, smpl_t **in,
+    uint_t channels, uint_t length)
+{
+  uint_t start = 0, n;
+  while (start < length) {
+    n = MIN(length - start, o->block_size - o->n_frames);
+    aubio_waveform_add(o, in, channels, start, n);
+    start += n;
+    if (o->n_frames == o->block_size) {
+      o->frames = (unsigned long long)(o->n_blocks + 1) * o->block_size;
+      if (aubio_waveform_put(o, o->n_blocks, o->min, o->max,
+            o->sum / o->n_samples) != AUBIO_OK) return AUBIO_FAIL;
+      o->n_blocks++;
+      o->n_frames = 0;
+      o->n_samples = 0;
+      o->sum = 0.;
+    }
+  }
+  return AUBIO_OK;
+}
+
+uint_t aubio_waveform_do (aubio_waveform_t *o, const fvec_t *in)
+{
+  smpl_t *data = in->data;
+  return aubio_waveform_do_channels(o, &data, 1, in->length);
+}
+
+uint_t aubio_waveform_do_multi (aubio_waveform_t *o, const fmat_t *in)
+{
+  if (in->height < 1) {
+    AUBIO_ERR("waveform: got a matrix of %d channels\n", in->height);
+    return AUBIO_FAIL;
+  }
+  return aubio_waveform_do_channels(o, in->data, in->height, in->length);
+}
+
+void aubio_waveform_flush (aubio_waveform_t *o)
+{
+  if (o->n_frames == 0) return;
+  o->frames = (unsigned long long)o->n_blocks * o->block_size + o->n_frames;
+  // the block is kept, and written again once complete
+  aubio_waveform_put(o, o->n_blocks, o->min, o->max, o->sum / o->n_samples);
+}
+
+uint_t aubio_waveform_do_source (aubio_waveform_t *o, const char_t *uri)
+{
+  uint_t read = 0, err = AUBIO_OK;
+  aubio_source_t *s = new_aubio_source(uri, 0, AUBIO_WAVEFORM_HOP);
+  fmat_t *frames = NULL;
+  if (!s) return AUBIO_FAIL;
+  frames = new_fmat(aubio_source_get_channels(s), AUBIO_WAVEFORM_HOP);
+  if (!frames) {
+    err = AUBIO_FAIL;
+    goto beach;
+  }
+  if (o->samplerate == 0) o->samplerate = aubio_source_get_samplerate(s);
+  do {
+    aubio_source_do_multi(s, frames, &read);
+    if (aubio_waveform_do_channels(o, frames->data, frames->height,
+          read) != AUBIO_OK) {
+      err = AUBIO_FAIL;
+      goto beach;
+    }
+  } while (read == AUBIO_WAVEFORM_HOP);
+  aubio_waveform_flush(o);
+
+beach:
+  if (frames) del_fmat(frames);
+  del_aubio_source(s);
+  return err;
+}
+
+uint_t aubio_waveform_get_n_levels (const aubio_waveform_t *o)
+{
+  return o->n_levels;
+}
+
+const fmat_t *aubio_waveform_get_level (const aubio_waveform_t *o,
+    uint_t level)
+{
+  if (level >= o->n_levels) return NULL;
+  return &o->levels[level].view;
+}
+
+uint_t aubio_waveform_get_block_size (const aubio_waveform_t *o)
+{
+  return o->block_size;
+}
+
+uint_t aubio_waveform_get_samplerate (const aubio_waveform_t *o)
+{
+  return o->samplerate;
+}
+
+static const char_t *aubio_waveform_names[WF_ROWS] = { "min", "max", "rms" };
+
+uint_t aubio_waveform_save (const aubio_waveform_t *o, const char_t *uri)
+{
+  uint_t i, j, k, err = AUBIO_OK;
+  aubio_feature_sink_t *s = new_aubio_feature_sink(uri, WF_ROWS);
+  fvec_t *row = new_fvec(WF_ROWS);
+  if (!s || !row) {
+    err = AUBIO_FAIL;
+    goto beach;
+  }
+  for (j = 0; j < WF_ROWS; j++) {
+    err |= aubio_feature_sink_set_name(s, j, aubio_waveform_names[j]);
+  }
+  err |= aubio_feature_sink_set_timing(s, o->samplerate, o->block_size);
+  for (k = 0; k < o->n_levels && !err; k++) {
+    const aubio_waveform_level_t *l = &o->levels[k];
+    for (i = 0; i < l->view.length && !err; i++) {
+      for (j = 0; j < WF_ROWS; j++) {
+        row->data[j] = l->rows[j][i];
+      }
+      err = aubio_feature_sink_do(s, row);
+    }
+  }
+  if (!err) err = aubio_feature_sink_close(s);
+
+beach:
+  if (s) del_aubio_feature_sink(s);
+  if (row) del_fvec(row);
+  return err ? AUBIO_FAIL : AUBIO_OK;
+}
+
+/* number of rows of a pyramid of n blocks of level 0 */
+static unsigned long long aubio_waveform_n_rows (unsigned long long n)
+{
+  unsigned long long rows = n;
+  while (n > 1) {
+    n = (n + 1) / 2;
+    rows += n;
+  }
+  return rows;
+}
+
+aubio_waveform_t *new_aubio_waveform_from_file (const char_t *uri)
+{
+  aubio_waveform_t *o = NULL;
+  aubio_feature_source_t *s = new_aubio_feature_source(uri);
+  const float *columns[WF_ROWS];
+  unsigned long long lo = 0, hi, n_rows;
+  uint_t i, j, k, row = 0;
+  if (!s) return NULL;
+  for (j = 0; j < WF_ROWS; j++) {
+    sint_t c = aubio_feature_source_find(s, aubio_waveform_names[j]);
+    columns[j] = c < 0 ? NULL : aubio_feature_source_get_column(s, c);
+    if (!columns[j]) {
+      AUBIO_ERR("waveform: %s has no column %s\n", uri,
+          aubio_waveform_names[j]);
+      goto beach;
+    }
+  }
+  o = new_aubio_waveform(aubio_feature_source_get_hop_size(s),
+      aubio_feature_source_get_samplerate(s));
+  if (!o) goto beach;
+  // the number of rows grows with the number of blocks of level 0
+  n_rows = aubio_feature_source_get_n_rows(s);
+  hi = n_rows;
+  while (lo < hi) {
+    unsigned long long mid = lo + (hi - lo) / 2;
+    if (aubio_waveform_n_rows(mid) < n_rows) lo = mid + 1;
+    else hi = mid;
+  }
+  if (aubio_waveform_n_rows(lo) != n_rows) {
+    AUBIO_ERR("waveform: %s holds %llu rows, not a whole overview\n", uri,
+        n_rows);
+    goto beach;
+  }
+  o->n_blocks = (uint_t)lo;
+  o->frames = lo * o->block_size;
+  for (k = 0; row < n_rows; k++) {
+    aubio_waveform_level_t *l = &o->levels[k];
+    uint_t count = k == 0 ? o->n_blocks : (o->levels[k - 1].view.length + 1) / 2;
+    if (aubio_waveform_grow(l, count) != AUBIO_OK) goto beach;
+    for (i = 0; i < count; i++, row++) {
+      for (j = 0; j < WF_ROWS; j++) {
+        l->rows[j][i] = columns[j][row];
+      }
+      l->ms[i] = (lsmp_t)l->rows[WF_RMS][i] * l->rows[WF_RMS][i];
+    }
+    l->view.length = count;
+    o->n_levels++;
+  }
+  del_aubio_feature_source(s);
+  return o;
+
+beach:
+  if (o) del_aubio_waveform(o);
+  del_aubio_feature_source(s);
+  return NULL;
+}
+
+void del_aubio_waveform (aubio_waveform_t *o)
+{
+  uint_t i, k;
+  for (k = 0; k < AUBIO_WAVEFORM_MAX_LEVELS; k++) {
+    for (i = 0; i < WF_ROWS; i++) {
+      if (o->levels[k].rows[i]) AUBIO_FREE(o->levels[k].rows[i]);
+    }
+    if (o->levels[k].ms) AUBIO_FREE(o->levels[k].ms);
+  }
+  AUBIO_FREE(o);
+}
@@ -0,0 +1,190 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef AUBIO_WAVEFORM_H
+#define AUBIO_WAVEFORM_H
+
+/** \file
+
+  Waveform overviews at several resolutions
+
+  To draw the waveform of a long file at any zoom level, this object keeps
+  the minimum, maximum and root mean square of the signal over blocks of
+  `block_size` frames, then over pairs of blocks, pairs of pairs, and so
+  on, up to a single value for the whole signal. Level `k` holds one value
+  per `block_size * 2^k` frames, so that a view of any width can be drawn
+  from the level with the closest resolution, without reading the signal
+  again.
+
+  The levels are updated as the frames are added, with
+  ::aubio_waveform_do or ::aubio_waveform_do_multi, or read from a file in a
+  single pass with ::aubio_waveform_do_source. The last block of a level
+  may cover fewer frames than the others: it is updated as new frames
+  arrive. The frames of the last incomplete block of level 0 are only
+  counted once ::aubio_waveform_flush is called.
+
+  With several channels, the minimum and maximum are taken over all the
+  channels, and the root mean square over all their frames.
+
+  An overview can be stored in a feature file, see ::aubio_feature_sink_t,
+  with ::aubio_waveform_save, and read back with
+  ::new_aubio_waveform_from_file. The file holds three columns, `min`,
+  `max` and `rms`, with the rows of level 0 first, then those of level 1,
+  and so on; the hop size of its header is `block_size`.
+
+  \example utils/test-waveform.c
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** waveform overview object */
+typedef struct _aubio_waveform_t aubio_waveform_t;
+
+/** create waveform overview
+
+  \param block_size number of frames summarised by each value of level 0
+  \param samplerate samplerate of the signal, stored with the overview, or 0
+  if unknown
+
+  \return newly created ::aubio_waveform_t, or NULL on failure
+
+*/
+aubio_waveform_t *new_aubio_waveform (uint_t block_size, uint_t samplerate);
+
+/** read waveform overview from a file
+
+  \param uri path of a feature file written by ::aubio_waveform_save
+
+  \return newly created ::aubio_waveform_t, or NULL if the file could not be
+  read
+
+*/
+aubio_waveform_t *new_aubio_waveform_from_file (const char_t *uri);
+
+/** add frames of a single channel
+
+  \param o waveform overview, created by ::new_aubio_waveform
+  \param in new frames
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_waveform_do (aubio_waveform_t *o, const fvec_t *in);
+
+/** add frames of several channels
+
+  \param o waveform overview, created by ::new_aubio_waveform
+  \param in new frames, one row per channel
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_waveform_do_multi (aubio_waveform_t *o, const fmat_t *in);
+
+/** add all the frames of a sound file
+
+  \param o waveform overview, created by ::new_aubio_waveform
+  \param uri path of the file to read, at its own samplerate
+
+  \return 0 if successful, non-zero otherwise
+
+  The file is read in a single pass, with all its channels, then
+  ::aubio_waveform_flush is called. If the samplerate of `o` is 0, it is set
+  to that of the file.
+
+*/
+uint_t aubio_waveform_do_source (aubio_waveform_t *o, const char_t *uri);
+
+/** count the last incomplete block
+
+  \param o waveform overview, created by ::new_aubio_waveform
+
+  The frames added since the end of the last complete block of level 0 are
+  counted as a shorter block. Frames added afterwards start a new block.
+
+*/
+void aubio_waveform_flush (aubio_waveform_t *o);
+
+/** get number of levels
+
+  \param o waveform overview, created by ::new_aubio_waveform
+
+  \return number of levels, 0 until a first block was completed; the last
+  level holds a single value
+
+*/
+uint_t aubio_waveform_get_n_levels (const aubio_waveform_t *o);
+
+/** get values of a level
+
+  \param o waveform overview, created by ::new_aubio_waveform
+  \param level index of the level, 0 for the finest one
+
+  \return matrix of 3 rows, the minimum, maximum and root mean square of
+  each block of `block_size * 2^level` frames, or NULL if `level` is out of
+  range. The matrix belongs to `o`, and is valid until frames are added.
+
+*/
+const fmat_t *aubio_waveform_get_level (const aubio_waveform_t *o,
+    uint_t level);
+
+/** get number of frames summarised by each value of level 0
+
+  \param o waveform overview, created by ::new_aubio_waveform
+
+  \return block size, as passed to ::new_aubio_waveform
+
+*/
+uint_t aubio_waveform_get_block_size (const aubio_waveform_t *o);
+
+/** get samplerate of the signal
+
+  \param o waveform overview, created by ::new_aubio_waveform
+
+  \return samplerate, or 0 if unknown
+
+*/
+uint_t aubio_waveform_get_samplerate (const aubio_waveform_t *o);
+
+/** write waveform overview to a feature file
+
+  \param o waveform overview, created by ::new_aubio_waveform
+  \param uri path of the file to write
+
+  \return 0 if successful, non-zero otherwise
+
+*/
+uint_t aubio_waveform_save (const aubio_waveform_t *o, const char_t *uri);
+
+/** delete waveform overview
+
+  \param o waveform overview, created by ::new_aubio_waveform
+
+*/
+void del_aubio_waveform (aubio_waveform_t *o);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_WAVEFORM_H */
@@ -0,0 +1,54 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Scratch buffers of the objects, shared through the workspace of the
+   calling thread, see utils/allocator.h.
+
+   A buffer can be shared if its object only reads it after writing it in the
+   same call of its `_do` function, and does not keep it while calling the
+   `_do` function of another object with such buffers. The buffers of an
+   object are created with the same offset, so that they do not overlap:
+
+     size_t offset = 0;
+     o->acf = new_aubio_scratch (winlen, &offset);
+     o->phout = new_aubio_scratch (winlen, &offset);
+
+   Without a workspace, or with a NULL offset, new_aubio_scratch() is
+   new_fvec(). Otherwise, only the structure of the vector belongs to the
+   object: del_fvec() leaves the workspace alone, and aubio_malloc_size()
+   does not count the samples. These are not cleared, another object may
+   have left anything in them, including in the padding after `length`. */
+
+#ifndef AUBIO_WORKSPACE_PRIV_H
+#define AUBIO_WORKSPACE_PRIV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* create a vector of `length` samples, taken `*offset` bytes into the
+   workspace of the calling thread, and move `*offset` after them */
+fvec_t *new_aubio_scratch (uint_t length, size_t *offset);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AUBIO_WORKSPACE_PRIV_H */
@@ -3,6 +3,7 @@
 #include "fvec.h"
 #include "cvec.h"
 #include "vecutils.h"
+#include "utils/simd_priv.h"
 
 #define AUBIO_OP(OPNAME, OP, TYPE, OBJ) \
 void TYPE ## _ ## OPNAME (TYPE ## _t *o) \
@@ -16,13 +17,68 @@ void TYPE ## _ ## OPNAME (TYPE ## _t *o) \
 #define AUBIO_OP_C(OPNAME, OP) \
   AUBIO_OP(OPNAME, OP, fvec, data)
 
-AUBIO_OP_C(exp, EXP)
+void fvec_exp (fvec_t *s)
+{
+#if defined(HAVE_INTEL_IPP)
+  aubio_ippsExp(s->data, s->data, (int)s->length);
+#elif defined(HAVE_ACCELERATE)
+  int n = (int)s->length;
+  aubio_vvexp(s->data, s->data, &n);
+#else
+  uint_t j;
+  if (aubio_simd_fast_math) {
+    AUBIO_SIMD()->vexp(s->data, s->length);
+    return;
+  }
+  for (j = 0; j < s->length; j++) {
+    s->data[j] = EXP(s->data[j]);
+  }
+#endif
+}
+
 AUBIO_OP_C(cos, COS)
 AUBIO_OP_C(sin, SIN)
 AUBIO_OP_C(abs, ABS)
+#if !defined(HAVE_AUBIO_SIMD)
 AUBIO_OP_C(sqrt, SQRT)
+#else
+void fvec_sqrt (fvec_t *s)
+{
+  AUBIO_SIMD()->vsqrt(s->data, s->length);
+}
+#endif
+#if defined(HAVE_INTEL_IPP)
+void fvec_log10 (fvec_t *s)
+{
+  aubio_ippsThreshold_LT(s->data, (int)s->length, VERY_SMALL_NUMBER);
+  aubio_ippsLog10(s->data, s->data, (int)s->length);
+}
+
+void fvec_log (fvec_t *s)
+{
+  aubio_ippsThreshold_LT(s->data, (int)s->length, VERY_SMALL_NUMBER);
+  aubio_ippsLn(s->data, s->data, (int)s->length);
+}
+#elif defined(HAVE_ACCELERATE)
+void fvec_log10 (fvec_t *s)
+{
+  smpl_t floor = VERY_SMALL_NUMBER;
+  int n = (int)s->length;
+  aubio_vDSP_vthr(s->data, 1, &floor, s->data, 1, s->length);
+  aubio_vvlog10(s->data, s->data, &n);
+}
+
+void fvec_log (fvec_t *s)
+{
+  smpl_t floor = VERY_SMALL_NUMBER;
+  int n = (int)s->length;
+  aubio_vDSP_vthr(s->data, 1, &floor, s->data, 1, s->length);
+  aubio_vvlog(s->data, s->data, &n);
+}
+#else
 AUBIO_OP_C(log10, SAFE_LOG10)
 AUBIO_OP_C(log, SAFE_LOG)
+#endif
 AUBIO_OP_C(floor, FLOOR)
 AUBIO_OP_C(ceil, CEIL)
 AUBIO_OP_C(round, ROUND)
@@ -30,7 +86,42 @@ AUBIO_OP_C(round, ROUND)
 void fvec_pow (fvec_t *s, smpl_t power)
 {
   uint_t j;
+#if defined(HAVE_AUBIO_SIMD)
+  // exact shortcuts for the powers used by specdesc and filterbank
+  if (power == 2.) {
+    AUBIO_SIMD()->weight(s->data, s->data, s->length);
+    return;
+  } else if (power == .5) {
+    AUBIO_SIMD()->vsqrt(s->data, s->length);
+    return;
+  } else if (power == 1.) {
+    return;
+  }
+#endif
+  // x^p = exp(p log(x)) only holds for x > 0
+  if (aubio_simd_fast_math && s->length > 0
+      && AUBIO_SIMD()->vmin(s->data, s->length) > 0.) {
+    AUBIO_SIMD()->vlog(s->data, s->length);
+    AUBIO_SIMD()->mul(s->data, power, s->length);
+    AUBIO_SIMD()->vexp(s->data, s->length);
+    return;
+  }
   for (j = 0; j < s->length; j++) {
     s->data[j] = POW(s->data[j], power);
   }
 }
+
+uint_t aubio_set_fast_math (uint_t enable)
+{
+  if (enable > 1) {
+    AUBIO_ERR("vecutils: fast math should be 0 or 1, got %d\n", enable);
+    return AUBIO_FAIL;
+  }
+  aubio_simd_fast_math = enable;
+  return AUBIO_OK;
+}
+
+uint_t aubio_get_fast_math (void)
+{
+  return aubio_simd_fast_math;
+}
@@ -109,6 +109,29 @@ void fvec_round (fvec_t *s);
 */
 void fvec_pow (fvec_t *s, smpl_t pow);
 
+/** enable or disable fast approximations of log, exp, pow, atan2, sin and cos
+
+  \param enable 1 to enable the approximations, 0 to use the C library
+
+  \return 0 if successful, 1 otherwise
+
+  When enabled, fvec_exp(), fvec_pow() with positive elements, cvec_logmag(),
+  aubio_fft_get_phas(), aubio_fft_get_realimag() and aubio_mfcc_do() use
+  vector approximations instead of the functions of the C library. In single
+  precision, exp has a relative error below 1.e-6, log, atan2, sin and cos an
+  absolute error below 1.e-6 (and below 1.e-6 times the result for large
+  logs). The setting is global and disabled by default.
+
+*/
+uint_t aubio_set_fast_math (uint_t enable);
+
+/** get the fast approximation mode
+
+  \return 1 if the approximations are enabled, 0 otherwise
+
+*/
+uint_t aubio_get_fast_math (void);
+
 #ifdef __cplusplus
 }
 #endif
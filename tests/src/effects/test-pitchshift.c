@@ -3,6 +3,8 @@
 #include "utils_tests.h"
 
 int test_wrong_params(void);
+int test_sine(void);
+int test_multi(void);
 
 int main (int argc, char **argv)
 {
@@ -19,7 +21,6 @@ int main (int argc, char **argv)
     return err;
   }
 
-#ifdef HAVE_RUBBERBAND
   uint_t samplerate = 0;
   uint_t hop_size = 64;
   smpl_t transpose = 0.;
@@ -76,10 +77,6 @@ beach_source:
   del_fvec(out);
 beach_fvec:
   aubio_cleanup();
-#else
-  err = 0;
-  PRINT_ERR("aubio was not compiled with rubberband\n");
-#endif
   return err;
 }
 
@@ -97,14 +94,98 @@ int test_wrong_params(void)
 
   aubio_pitchshift_t *p = new_aubio_pitchshift(mode, transpose,
       hop_size, samplerate);
-#ifdef HAVE_RUBBERBAND
   if (!p) return 1;
   if (!aubio_pitchshift_set_pitchscale(p, 0.1)) return 1;
   if (!aubio_pitchshift_set_transpose(p, -30)) return 1;
   del_aubio_pitchshift(p);
-#else
-  if (p) return 1;
-#endif
+
+  if (test_sine()) return 1;
+  if (test_multi()) return 1;
 
   return run_on_default_source_and_sink(main);
 }
+
+// transpose a sine by an octave: the output should have twice its frequency
+int test_sine(void)
+{
+  uint_t samplerate = 44100, hop_size = 256, i, j, crossings = 0;
+  uint_t n_hops = 200, latency, pos = 0;
+  smpl_t freq = 441., last = 0.;
+  fvec_t *in = new_fvec(hop_size), *out = new_fvec(hop_size);
+  aubio_pitchshift_t *p = new_aubio_pitchshift("default", 12., hop_size,
+      samplerate);
+  uint_t err = 0;
+  if (!in || !out || !p) return 1;
+  latency = aubio_pitchshift_get_latency(p);
+  for (j = 0; j < n_hops; j++) {
+    for (i = 0; i < hop_size; i++) {
+      in->data[i] = .5 * sin(2. * M_PI * freq * (j * hop_size + i)
+          / samplerate);
+    }
+    aubio_pitchshift_do(p, in, out);
+    // count upward zero crossings over 100 ms, after the latency
+    for (i = 0; i < hop_size; i++, pos++) {
+      if (pos > latency && pos <= latency + samplerate / 10
+          && last < 0 && out->data[i] >= 0) crossings++;
+      last = out->data[i];
+    }
+  }
+  PRINT_MSG("pitchshift: %d crossings in 100 ms, latency %d\n", crossings,
+      latency);
+  // 882 Hz, or 88.2 crossings in 100 ms
+  if (crossings < 86 || crossings > 91) err = 1;
+  del_aubio_pitchshift(p);
+  del_fvec(in);
+  del_fvec(out);
+  return err;
+}
+
+// transpose two channels in blocks of various sizes: the channels given the
+// same input should get the same output, the same as a mono object
+int test_multi(void)
+{
+  uint_t samplerate = 44100, hop_size = 256, i, j, n = 0, err = 0;
+  uint_t sizes[] = { 256, 100, 512, 1, 300, 256 };
+  fmat_t *in = new_fmat(2, 512), *out = new_fmat(2, 512);
+  fvec_t *mono_in = new_fvec(512), *mono_out = new_fvec(512);
+  aubio_pitchshift_t *p = new_aubio_pitchshift("default", 5., hop_size,
+      samplerate);
+  aubio_pitchshift_t *mono = new_aubio_pitchshift("default", 5., hop_size,
+      samplerate);
+  fmat_t in_block, out_block;
+  fvec_t mono_in_block, mono_out_block;
+  if (!in || !out || !mono_in || !mono_out || !p || !mono) return 1;
+  if (aubio_pitchshift_set_channels(p, 0) == 0) err = 1;
+  if (aubio_pitchshift_set_channels(p, 2)
+      || aubio_pitchshift_get_channels(p) != 2) err = 1;
+  // a mono vector given to a stereo object
+  aubio_pitchshift_do(p, mono_in, mono_out);
+  aubio_pitchshift_set_channels(p, 1);
+  aubio_pitchshift_set_channels(p, 2);
+  for (j = 0; j < 40; j++) {
+    uint_t length = sizes[j % 6];
+    for (i = 0; i < length; i++, n++) {
+      in->data[0][i] = in->data[1][i] = mono_in->data[i] =
+        .5 * sin(2. * M_PI * 441. * n / samplerate);
+    }
+    in_block = *in; out_block = *out;
+    in_block.length = out_block.length = length;
+    mono_in_block = *mono_in; mono_out_block = *mono_out;
+    mono_in_block.length = mono_out_block.length = length;
+    aubio_pitchshift_do_multi(p, &in_block, &out_block);
+    aubio_pitchshift_do(mono, &mono_in_block, &mono_out_block);
+    for (i = 0; i < length; i++) {
+      if (out->data[0][i] != out->data[1][i]
+          || out->data[0][i] != mono_out->data[i]) err = 1;
+    }
+  }
+  if (aubio_pitchshift_get_latency(p) != aubio_pitchshift_get_latency(mono))
+    err = 1;
+  del_aubio_pitchshift(p);
+  del_aubio_pitchshift(mono);
+  del_fmat(in);
+  del_fmat(out);
+  del_fvec(mono_in);
+  del_fvec(mono_out);
+  return err;
+}
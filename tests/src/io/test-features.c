@@ -0,0 +1,140 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// write a few columns to a feature file, read them back, and check broken
+// files are refused
+
+#define PATH "tmp_aubio_features.feat"
+#define N_ROWS 1000
+
+static const char_t *names[] = { "time", "pitch", "" };
+
+static uint_t write_features (const char_t *path)
+{
+  uint_t i, err = 0;
+  aubio_feature_sink_t *s = new_aubio_feature_sink (path, 3);
+  fvec_t *row = new_fvec (3);
+  fmat_t *rows = new_fmat (10, 3);
+  if (!s || !row || !rows) return 1;
+  if (aubio_feature_sink_set_name (s, 0, names[0])) err = 1;
+  if (aubio_feature_sink_set_name (s, 1, names[1])) err = 1;
+  if (aubio_feature_sink_set_timing (s, 44100, 512)) err = 1;
+  // one row at a time, then ten at once
+  for (i = 0; i < N_ROWS - 10; i++) {
+    row->data[0] = i;
+    row->data[1] = 2. * i;
+    row->data[2] = -(smpl_t)i;
+    if (aubio_feature_sink_do (s, row)) err = 1;
+  }
+  for (i = 0; i < 10; i++) {
+    rows->data[i][0] = N_ROWS - 10 + i;
+    rows->data[i][1] = 2. * (N_ROWS - 10 + i);
+    rows->data[i][2] = -(smpl_t)(N_ROWS - 10 + i);
+  }
+  if (aubio_feature_sink_do_multi (s, rows)) err = 1;
+  if (aubio_feature_sink_close (s)) err = 1;
+  // closed sinks refuse new rows
+  if (!aubio_feature_sink_do (s, row)) err = 1;
+  del_aubio_feature_sink (s);
+  del_fvec (row);
+  del_fmat (rows);
+  return err;
+}
+
+static uint_t read_features (const char_t *path)
+{
+  uint_t i, j, err = 0;
+  const float *column;
+  aubio_feature_source_t *s = new_aubio_feature_source (path);
+  fvec_t *row = new_fvec (3);
+  if (!s || !row) return 1;
+  if (aubio_feature_source_get_n_columns (s) != 3) err = 1;
+  if (aubio_feature_source_get_n_rows (s) != N_ROWS) err = 1;
+  if (aubio_feature_source_get_samplerate (s) != 44100) err = 1;
+  if (aubio_feature_source_get_hop_size (s) != 512) err = 1;
+  for (i = 0; i < 3; i++) {
+    if (strcmp (aubio_feature_source_get_name (s, i), names[i])) err = 1;
+  }
+  if (aubio_feature_source_get_name (s, 3)) err = 1;
+  if (aubio_feature_source_find (s, "pitch") != 1) err = 1;
+  if (aubio_feature_source_find (s, "mfcc") != -1) err = 1;
+  for (i = 0; i < 3; i++) {
+    column = aubio_feature_source_get_column (s, i);
+    if (!column) err = 1;
+    for (j = 0; column && j < N_ROWS; j++) {
+      if (column[j] != (i == 2 ? -(float)j : (float)((i + 1) * j))) err = 1;
+    }
+  }
+  if (aubio_feature_source_get_column (s, 3)) err = 1;
+  if (aubio_feature_source_do (s, 7, row)) err = 1;
+  if (row->data[0] != 7 || row->data[1] != 14 || row->data[2] != -7) err = 1;
+  if (!aubio_feature_source_do (s, N_ROWS, row)) err = 1;
+  PRINT_MSG ("read %d rows of %d columns from %s\n",
+      aubio_feature_source_get_n_rows (s),
+      aubio_feature_source_get_n_columns (s), path);
+  del_aubio_feature_source (s);
+  del_fvec (row);
+  return err;
+}
+
+// truncate the file at path to length bytes
+static uint_t truncate_file (const char_t *path, long length)
+{
+  char_t data[512];
+  size_t read;
+  FILE *f = fopen (path, "rb");
+  if (!f) return 1;
+  read = fread (data, 1, length, f);
+  fclose (f);
+  f = fopen (path, "wb");
+  if (!f) return 1;
+  fwrite (data, 1, read, f);
+  fclose (f);
+  return 0;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_feature_sink_t *s;
+  FILE *f;
+
+  if (write_features (PATH)) err = 1;
+  if (read_features (PATH)) err = 1;
+
+  // an empty table
+  s = new_aubio_feature_sink (PATH, 1);
+  if (!s) return 1;
+  del_aubio_feature_sink (s);
+  {
+    aubio_feature_source_t *e = new_aubio_feature_source (PATH);
+    if (!e || aubio_feature_source_get_n_rows (e) != 0
+        || strcmp (aubio_feature_source_get_name (e, 0), "")) err = 1;
+    if (e) del_aubio_feature_source (e);
+  }
+
+  // wrong parameters
+  if (new_aubio_feature_sink (NULL, 2)) err = 1;
+  if (new_aubio_feature_sink (PATH, 0)) err = 1;
+  s = new_aubio_feature_sink (PATH, 2);
+  if (!s) return 1;
+  if (!aubio_feature_sink_set_name (s, 2, "pitch")) err = 1;
+  {
+    fvec_t *row = new_fvec (1);
+    if (!aubio_feature_sink_do (s, row)) err = 1;
+    del_fvec (row);
+  }
+  del_aubio_feature_sink (s);
+
+  // broken files
+  if (new_aubio_feature_source ("/this/file/does/not/exist")) err = 1;
+  if (write_features (PATH) || truncate_file (PATH, 300)) err = 1;
+  if (new_aubio_feature_source (PATH)) err = 1;
+  f = fopen (PATH, "wb");
+  if (!f) return 1;
+  fputs ("not a feature file", f);
+  fclose (f);
+  if (new_aubio_feature_source (PATH)) err = 1;
+  remove (PATH);
+  return err;
+}
@@ -0,0 +1,136 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "io/ioutils_priv.h"
+#include "utils_tests.h"
+
+// check the sample conversion routines shared by sources and sinks: every
+// format should survive an interleave / deinterleave round trip, for mono,
+// stereo, and other channel counts
+
+#define LENGTH 301
+
+static smpl_t test_sample (uint_t frame, uint_t channel)
+{
+  // multiples of 1/64, exactly represented in all formats
+  return (smpl_t)((sint_t)((frame * 5 + channel * 11) % 129) - 64) / 64.;
+}
+
+static int check_format (aubio_io_format_t format, uint_t channels)
+{
+  uint_t i, c;
+  // 1. is clipped to the largest integer, one step below it
+  smpl_t tol = (format == aubio_io_u8) ? 1. / 128. + 1.e-6
+    : (format == aubio_io_s16) ? 1. / 32768. + 1.e-6 : 1.e-6;
+  fmat_t *in = new_fmat(channels, LENGTH);
+  fmat_t *out = new_fmat(channels + 1, LENGTH + 3);
+  fvec_t *mix = new_fvec(LENGTH);
+  void *buf = AUBIO_ARRAY(char, aubio_io_format_size(format) * channels
+      * LENGTH);
+  int err = 0;
+
+  for (c = 0; c < channels; c++) {
+    for (i = 0; i < LENGTH; i++) {
+      in->data[c][i] = test_sample(i, c);
+    }
+  }
+  // add out of range values, clipped for integer formats
+  in->data[0][0] = 1.5;
+  in->data[channels - 1][1] = -3.;
+
+  aubio_io_interleave(format, in, buf, channels, LENGTH);
+  fmat_ones(out);
+  aubio_io_deinterleave(format, buf, channels, out, 3, LENGTH);
+  for (c = 0; c < channels; c++) {
+    for (i = 0; i < LENGTH; i++) {
+      smpl_t expected = in->data[c][i];
+      if (format != aubio_io_f32 && format != aubio_io_f64
+          && format != aubio_io_smpl) {
+        expected = MAX(-1., MIN(1., expected));
+      }
+      if (ABS(out->data[c][i + 3] - expected) > tol) err = 1;
+    }
+    // columns before offset are left untouched
+    if (out->data[c][0] != 1.) err = 1;
+  }
+  // rows beyond in_channels are left untouched
+  if (out->data[channels][5] != 1.) err = 1;
+
+  aubio_io_downmix(format, buf, channels, mix->data, LENGTH);
+  for (i = 0; i < LENGTH; i++) {
+    smpl_t sum = 0.;
+    for (c = 0; c < channels; c++) {
+      sum += out->data[c][i + 3];
+    }
+    if (ABS(mix->data[i] - sum / channels) > 1.e-5) err = 1;
+  }
+
+  del_fmat(in);
+  del_fmat(out);
+  del_fvec(mix);
+  AUBIO_FREE(buf);
+  return err;
+}
+
+static int check_mono_to_all (void)
+{
+  // a single row is copied to every channel
+  uint_t i, c, channels = 3;
+  fmat_t *in = new_fmat(1, LENGTH);
+  fmat_t *out = new_fmat(channels, LENGTH);
+  smpl_t *buf = AUBIO_ARRAY(smpl_t, channels * LENGTH);
+  int err = 0;
+  for (i = 0; i < LENGTH; i++) in->data[0][i] = test_sample(i, 0);
+  aubio_io_interleave(aubio_io_smpl, in, buf, channels, LENGTH);
+  aubio_io_deinterleave(aubio_io_smpl, buf, channels, out, 0, LENGTH);
+  for (c = 0; c < channels; c++) {
+    for (i = 0; i < LENGTH; i++) {
+      if (out->data[c][i] != in->data[0][i]) err = 1;
+    }
+  }
+  del_fmat(in);
+  del_fmat(out);
+  AUBIO_FREE(buf);
+  return err;
+}
+
+static int check_missing_channels (void)
+{
+  // channels without a matching row are set to zero
+  uint_t i, channels = 3;
+  fmat_t *in = new_fmat(2, LENGTH);
+  fmat_t *out = new_fmat(channels, LENGTH);
+  smpl_t *buf = AUBIO_ARRAY(smpl_t, channels * LENGTH);
+  int err = 0;
+  fmat_ones(in);
+  aubio_io_interleave(aubio_io_smpl, in, buf, channels, LENGTH);
+  aubio_io_deinterleave(aubio_io_smpl, buf, channels, out, 0, LENGTH);
+  for (i = 0; i < LENGTH; i++) {
+    if (out->data[1][i] != 1. || out->data[2][i] != 0.) err = 1;
+  }
+  del_fmat(in);
+  del_fmat(out);
+  AUBIO_FREE(buf);
+  return err;
+}
+
+int main (void)
+{
+  aubio_io_format_t formats[] = { aubio_io_u8, aubio_io_s16, aubio_io_s24,
+    aubio_io_s32, aubio_io_f32, aubio_io_f64, aubio_io_smpl };
+  uint_t channels[] = { 1, 2, 3, 6 };
+  uint_t f, c;
+  for (f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+    for (c = 0; c < sizeof(channels) / sizeof(channels[0]); c++) {
+      if (check_format(formats[f], channels[c])) {
+        PRINT_ERR("conversion failed for format %d with %d channels\n",
+            formats[f], channels[c]);
+        return 1;
+      }
+    }
+  }
+  if (check_mono_to_all() || check_missing_channels()) {
+    PRINT_ERR("interleaving failed\n");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// write the same blocks with and without a background thread, and check
+// that both files are identical once read back
+
+static int write_blocks (aubio_sink_t *snk, const char_t *source_path,
+    uint_t channels, uint_t multi)
+{
+  uint_t hop_sizes[] = { 256, 64, 1024, 512 };
+  uint_t k = 0, read = 0, hop_size = 1024;
+  aubio_source_t *src = new_aubio_source(source_path, 0, hop_size);
+  fmat_t *mat = new_fmat(channels, hop_size);
+  fvec_t *vec = new_fvec(hop_size);
+  if (!src) return 1;
+  do {
+    // change the block size to grow the queued blocks
+    uint_t write = hop_sizes[k++ % 4];
+    fmat_t mat_view;
+    fvec_t vec_view;
+    aubio_source_do_multi(src, mat, &read);
+    if (write > read) write = read;
+    if (multi) {
+      mat_view = *mat;
+      mat_view.length = write;
+      aubio_sink_do_multi(snk, &mat_view, write);
+    } else {
+      fmat_get_channel(mat, 0, &vec_view);
+      fvec_copy(&vec_view, vec);
+      vec_view = *vec;
+      vec_view.length = write;
+      aubio_sink_do(snk, &vec_view, write);
+    }
+  } while (read == hop_size);
+  del_aubio_source(src);
+  del_fmat(mat);
+  del_fvec(vec);
+  return 0;
+}
+
+static int compare_files (const char_t *path, const char_t *expected_path)
+{
+  uint_t i, j, read = 0, expected_read = 0, hop_size = 512, err = 0;
+  aubio_source_t *s = new_aubio_source(path, 0, hop_size);
+  aubio_source_t *e = new_aubio_source(expected_path, 0, hop_size);
+  uint_t channels;
+  fmat_t *mat, *expected_mat;
+  if (!s || !e) return 1;
+  channels = aubio_source_get_channels(e);
+  if (aubio_source_get_channels(s) != channels
+      || aubio_source_get_duration(s) != aubio_source_get_duration(e)
+      || aubio_source_get_duration(s) == 0) {
+    return 1;
+  }
+  mat = new_fmat(channels, hop_size);
+  expected_mat = new_fmat(channels, hop_size);
+  do {
+    aubio_source_do_multi(s, mat, &read);
+    aubio_source_do_multi(e, expected_mat, &expected_read);
+    if (read != expected_read) err = 1;
+    for (j = 0; j < channels; j++) {
+      for (i = 0; i < read; i++) {
+        if (mat->data[j][i] != expected_mat->data[j][i]) err = 1;
+      }
+    }
+  } while (read == hop_size && !err);
+  del_aubio_source(s);
+  del_aubio_source(e);
+  del_fmat(mat);
+  del_fmat(expected_mat);
+  return err;
+}
+
+static int check_sink (const char_t *source_path, uint_t multi,
+    uint_t queue_frames)
+{
+  char_t path[PATH_MAX] = "tmp_aubio_XXXXXX";
+  char_t expected_path[PATH_MAX] = "tmp_aubio_XXXXXX";
+  int fd = create_temp_sink(path);
+  int expected_fd = create_temp_sink(expected_path);
+  aubio_source_t *src = new_aubio_source(source_path, 0, 256);
+  uint_t samplerate, channels, err = 0;
+  aubio_sink_t *snk, *expected_snk;
+  if (!fd || !expected_fd || !src) return 1;
+  samplerate = aubio_source_get_samplerate(src);
+  channels = multi ? aubio_source_get_channels(src) : 1;
+  del_aubio_source(src);
+
+  expected_snk = new_aubio_sink(expected_path, 0);
+  snk = new_aubio_sink_async(path, 0, queue_frames);
+  if (!snk || !expected_snk) return 1;
+  if (aubio_sink_preset_samplerate(snk, samplerate)
+      || aubio_sink_preset_channels(snk, channels)
+      || aubio_sink_preset_samplerate(expected_snk, samplerate)
+      || aubio_sink_preset_channels(expected_snk, channels)) {
+    return 1;
+  }
+  if (aubio_sink_get_samplerate(snk) != samplerate
+      || aubio_sink_get_channels(snk) != channels) {
+    return 1;
+  }
+  err |= write_blocks(snk, source_path, channels, multi);
+  err |= write_blocks(expected_snk, source_path, channels, multi);
+  // the queued blocks are written before closing
+  if (aubio_sink_close(snk)) err = 1;
+  aubio_sink_close(expected_snk);
+  err |= compare_files(path, expected_path);
+  del_aubio_sink(snk);
+  del_aubio_sink(expected_snk);
+
+  // deleting the sink writes the queued blocks too
+  snk = new_aubio_sink_async(path, samplerate, queue_frames);
+  if (!snk) return 1;
+  err |= write_blocks(snk, source_path, 1, 0);
+  del_aubio_sink(snk);
+  if (multi == 0) err |= compare_files(path, expected_path);
+
+  close_temp_sink(path, fd);
+  close_temp_sink(expected_path, expected_fd);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  // default queue and smallest queue, mono and multi-channel blocks
+  if (check_sink(argv[1], 0, 0) || check_sink(argv[1], 0, 1)
+      || check_sink(argv[1], 1, 0) || check_sink(argv[1], 1, 1)) {
+    PRINT_ERR("blocks written asynchronously differ\n");
+    return 1;
+  }
+  // failing to open the file
+  if (new_aubio_sink_async("/nonexistent/dir/file.wav", 44100, 0)) {
+    return 1;
+  }
+  return 0;
+}
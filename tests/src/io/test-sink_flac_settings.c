@@ -0,0 +1,75 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// write the same signal to flac files through the background thread of
+// new_aubio_sink_async, at the fastest and at the highest compression level,
+// and with several encoder threads when libFLAC supports them
+
+#define N_BLOCKS 200
+#define HOP 512
+#define N_CHANNELS 2
+
+static smpl_t sample_at (uint_t frame, uint_t channel)
+{
+  return .5 * sin (2. * M_PI * (frame + 100 * channel) / 441.)
+    + .01 * ((frame * 7919 + channel) % 201 - 100.) / 100.;
+}
+
+// write a file, and return its size in bytes, or 0 on failure
+static long write_flac (const char_t *path, uint_t level, uint_t threads)
+{
+  aubio_sink_t *s = new_aubio_sink_async (path, 0, 0);
+  fmat_t *block = new_fmat (N_CHANNELS, HOP);
+  uint_t n, j, c, err = 0;
+  long size = 0;
+  FILE *f;
+  if (!s || !block) return 0;
+  if (aubio_sink_preset_compression (s, level)) err = 1;
+  if (aubio_sink_preset_threads (s, threads)) {
+    PRINT_MSG ("%d encoder threads not supported, using one\n", threads);
+  }
+  if (aubio_sink_preset_samplerate (s, 44100)
+      || aubio_sink_preset_channels (s, N_CHANNELS)) err = 1;
+  // the settings can not change once the file is open
+  if (!aubio_sink_preset_compression (s, 0)) err = 1;
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (c = 0; c < N_CHANNELS; c++) {
+      for (j = 0; j < HOP; j++) {
+        block->data[c][j] = sample_at (n * HOP + j, c);
+      }
+    }
+    aubio_sink_do_multi (s, block, HOP);
+  }
+  if (aubio_sink_close (s)) err = 1;
+  del_aubio_sink (s);
+  del_fmat (block);
+  if (err) return 0;
+  f = fopen (path, "rb");
+  if (!f) return 0;
+  if (fseek (f, 0, SEEK_END) == 0) size = ftell (f);
+  fclose (f);
+  remove (path);
+  PRINT_MSG ("level %d, %d threads: %ld bytes\n", level, threads, size);
+  return size;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  long fastest, smallest, threaded;
+  aubio_sink_t *s = new_aubio_sink ("tmp_aubio_settings.flac", 0);
+  if (!s) return 1;
+  if (!aubio_sink_preset_compression (s, 9)) err = 1;
+  if (!aubio_sink_preset_threads (s, 0)) err = 1;
+  del_aubio_sink (s);
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+
+  fastest = write_flac ("tmp_aubio_settings_0.flac", 0, 1);
+  smallest = write_flac ("tmp_aubio_settings_8.flac", 8, 1);
+  threaded = write_flac ("tmp_aubio_settings_threads.flac", 8, 4);
+  if (!fastest || !smallest || !threaded || smallest > fastest) {
+    PRINT_ERR ("failed writing the files\n");
+    err = 1;
+  }
+  return err;
+}
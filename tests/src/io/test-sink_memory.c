@@ -0,0 +1,121 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// write samples to memory and through callbacks, then read the bytes back
+
+#define HOP 256
+#define N_BLOCKS 50
+#define N_CHANNELS 2
+
+typedef struct {
+  unsigned char data[100000];
+  uint_t size;
+} buffer_t;
+
+static sint_t write_buffer (void *user_data, const void *buf, uint_t size)
+{
+  buffer_t *b = (buffer_t *)user_data;
+  // a short write, to check the sink writes the rest
+  if (size > 1000) size = 1000;
+  if (b->size + size > sizeof (b->data)) return -1;
+  memcpy (b->data + b->size, buf, size);
+  b->size += size;
+  return size;
+}
+
+static smpl_t sample_at (uint_t frame, uint_t channel)
+{
+  return .8 * sin (2. * M_PI * (frame + 50 * channel) / 100.);
+}
+
+static void write_blocks (aubio_sink_t *s, fmat_t *block)
+{
+  uint_t n, c, j;
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (c = 0; c < N_CHANNELS; c++) {
+      for (j = 0; j < HOP; j++) {
+        block->data[c][j] = sample_at (n * HOP + j, c);
+      }
+    }
+    aubio_sink_do_multi (s, block, HOP);
+  }
+}
+
+int main (void)
+{
+  aubio_sink_callbacks_t callbacks = { write_buffer, NULL };
+  buffer_t *stream = (buffer_t *)calloc (1, sizeof (buffer_t));
+  fmat_t *block = new_fmat (N_CHANNELS, HOP);
+  aubio_sink_t *s;
+  aubio_source_t *src;
+  const unsigned char *bytes;
+  unsigned char small[1000];
+  uint_t size = 0, read = 0, total = 0, c, j, err = 0;
+  if (!stream || !block) return 1;
+
+  // 32 bit float wav, in a buffer allocated by the sink
+  s = new_aubio_sink_memory (NULL, 0, "f32", 0);
+  if (!s || aubio_sink_preset_samplerate (s, 22050)
+      || aubio_sink_preset_channels (s, N_CHANNELS)) return 1;
+  write_blocks (s, block);
+  if (aubio_sink_close (s)) err = 1;
+  bytes = (const unsigned char *)aubio_sink_get_memory (s, &size);
+  PRINT_MSG ("wrote %d bytes to memory\n", size);
+  if (!bytes || size != 44 + N_BLOCKS * HOP * N_CHANNELS * 4) return 1;
+  src = new_aubio_source_memory (bytes, size, 0, HOP);
+  if (!src || aubio_source_get_samplerate (src) != 22050
+      || aubio_source_get_channels (src) != N_CHANNELS
+      || aubio_source_get_duration (src) != N_BLOCKS * HOP) return 1;
+  do {
+    aubio_source_do_multi (src, block, &read);
+    for (c = 0; c < N_CHANNELS; c++) {
+      for (j = 0; j < read; j++) {
+        if (fabs (block->data[c][j] - sample_at (total + j, c)) > 1.e-7) {
+          err = 1;
+        }
+      }
+    }
+    total += read;
+  } while (read == HOP);
+  if (total != N_BLOCKS * HOP) err = 1;
+  del_aubio_source (src);
+  del_aubio_sink (s);
+
+  // raw samples, through callbacks which can not seek
+  s = new_aubio_sink_callbacks (&callbacks, stream, "raw", 22050);
+  if (!s || aubio_sink_get_memory (s, NULL)) return 1;
+  write_blocks (s, block);
+  aubio_sink_close (s);
+  del_aubio_sink (s);
+  if (stream->size != N_BLOCKS * HOP * 4) err = 1;
+  if (fabs (((float *)stream->data)[1] - sample_at (1, 0)) > 1.e-7) err = 1;
+
+  // a wav header with unknown sizes
+  stream->size = 0;
+  s = new_aubio_sink_callbacks (&callbacks, stream, "wav", 22050);
+  if (!s) return 1;
+  write_blocks (s, block);
+  aubio_sink_close (s);
+  del_aubio_sink (s);
+  if (stream->size != 44 + N_BLOCKS * HOP * 2
+      || memcmp (stream->data, "RIFF\xff\xff\xff\xff", 8) != 0) err = 1;
+
+  // a buffer too small for the samples, filled up to its end
+  s = new_aubio_sink_memory (small, sizeof (small), NULL, 22050);
+  if (!s) return 1;
+  write_blocks (s, block);
+  aubio_sink_close (s);
+  if (aubio_sink_get_memory (s, &size) != small || size != sizeof (small)
+      || memcmp (small, "RIFF", 4) != 0) err = 1;
+  del_aubio_sink (s);
+
+  // wrong format and missing callbacks
+  if (new_aubio_sink_memory (NULL, 0, "s8", 22050)) err = 1;
+  callbacks.write = NULL;
+  if (new_aubio_sink_callbacks (&callbacks, stream, NULL, 22050)) err = 1;
+
+  free (stream);
+  del_fmat (block);
+  if (err) PRINT_ERR ("samples written to memory differ\n");
+  return err;
+}
@@ -0,0 +1,102 @@
+#define AUBIO_UNSTABLE 1
+#include <aubio.h>
+#include "utils_tests.h"
+
+// write wav files in each sample format, over enough blocks to fill the write
+// buffer several times, and read them back
+
+#define N_BLOCKS 100
+#define HOP 1000
+#define N_CHANNELS 2
+
+static smpl_t sample_at (uint_t frame, uint_t channel)
+{
+  return .9 * sin (2. * M_PI * (frame + 100 * channel) / 441.);
+}
+
+static uint_t check_format (const char_t *fmt, uint_t dither, smpl_t tol)
+{
+#ifdef HAVE_WAVWRITE
+  char_t path[PATH_MAX] = "tmp_aubio_XXXXXX";
+  int fd = create_temp_sink(path);
+  aubio_sink_wavwrite_t *s;
+  aubio_source_wavread_t *src;
+  fmat_t *block = new_fmat (N_CHANNELS, HOP);
+  uint_t n, j, c, read = 0, total = 0, err = 0;
+  smpl_t max_err = 0., bias = 0.;
+  if (!fd) return 1;
+  s = new_aubio_sink_wavwrite (path, 0);
+  if (!s || aubio_sink_wavwrite_preset_format (s, fmt)
+      || aubio_sink_wavwrite_set_dither (s, dither)
+      || aubio_sink_wavwrite_preset_samplerate (s, 44100)
+      || aubio_sink_wavwrite_preset_channels (s, N_CHANNELS)) return 1;
+  // the format can not change once the file is open
+  if (!aubio_sink_wavwrite_preset_format (s, "s16")) err = 1;
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (c = 0; c < N_CHANNELS; c++) {
+      for (j = 0; j < HOP; j++) {
+        block->data[c][j] = sample_at (n * HOP + j, c);
+      }
+    }
+    aubio_sink_wavwrite_do_multi (s, block, HOP);
+  }
+  // a last short block, and samples beyond 1 in f32 files
+  block->data[0][0] = 1.5;
+  aubio_sink_wavwrite_do_multi (s, block, 7);
+  if (aubio_sink_wavwrite_close (s)) err = 1;
+  del_aubio_sink_wavwrite (s);
+
+  src = new_aubio_source_wavread (path, 0, HOP);
+  if (!src) return 1;
+  if (aubio_source_wavread_get_channels (src) != N_CHANNELS
+      || aubio_source_wavread_get_duration (src) != N_BLOCKS * HOP + 7) {
+    err = 1;
+  }
+  do {
+    aubio_source_wavread_do_multi (src, block, &read);
+    for (c = 0; c < N_CHANNELS; c++) {
+      for (j = 0; j < read && total + j < N_BLOCKS * HOP; j++) {
+        smpl_t d = block->data[c][j] - sample_at (total + j, c);
+        if (fabs (d) > max_err) max_err = fabs (d);
+        bias += d;
+      }
+    }
+    if (total == N_BLOCKS * HOP && read > 0) {
+      smpl_t last = strcmp (fmt, "f32") == 0 ? 1.5 : 1.;
+      if (fabs (block->data[0][0] - last) > tol) err = 1;
+    }
+    total += read;
+  } while (read == HOP);
+  del_aubio_source_wavread (src);
+  bias /= N_BLOCKS * HOP * N_CHANNELS;
+  PRINT_MSG ("%s%s: %d frames, max error %g, mean error %g\n", fmt,
+      dither ? " with dither" : "", total, max_err, bias);
+  if (total != N_BLOCKS * HOP + 7 || max_err > tol || fabs (bias) > tol / 10.) {
+    err = 1;
+  }
+  del_fmat (block);
+  close_temp_sink (path, fd);
+  return err;
+#else
+  (void)fmt; (void)dither; (void)tol;
+  return 0;
+#endif /* HAVE_WAVWRITE */
+}
+
+int main (void)
+{
+  uint_t err = 0;
+#ifdef HAVE_WAVWRITE
+  aubio_sink_wavwrite_t *s = new_aubio_sink_wavwrite ("tmp.wav", 0);
+  if (!s) return 1;
+  if (!aubio_sink_wavwrite_preset_format (s, "s8")) err = 1;
+  if (!aubio_sink_wavwrite_set_dither (s, 2)) err = 1;
+  del_aubio_sink_wavwrite (s);
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+#endif /* HAVE_WAVWRITE */
+  err |= check_format ("s16", 0, 1. / 32768.);
+  err |= check_format ("s16", 1, 2. / 32768.);
+  err |= check_format ("s24", 0, 1. / 8388608. + 1.e-7);
+  err |= check_format ("f32", 0, 1.e-7);
+  return err;
+}
@@ -0,0 +1,96 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// slice the default source, including overlapping, empty and out of range
+// slices, and check each slice holds the frames of the source
+
+#define N_SLICES 6
+
+static int check_slice (const char_t *source_path, const char_t *path,
+    uint_t start, uint_t end)
+{
+  uint_t i, j, read = 0, expected_read = 0, length, err = 0;
+  aubio_source_t *s = new_aubio_source(path, 0, 256);
+  aubio_source_t *e = new_aubio_source(source_path, 0, 256);
+  uint_t channels, duration;
+  fmat_t *mat, *expected_mat;
+  if (!s || !e) return 1;
+  channels = aubio_source_get_channels(e);
+  duration = aubio_source_get_duration(e);
+  if (end > duration) end = duration;
+  length = end > start ? end - start : 0;
+  PRINT_MSG("%s: %d frames, expected %d\n", path,
+      aubio_source_get_duration(s), length);
+  if (aubio_source_get_channels(s) != channels
+      || aubio_source_get_duration(s) != length) {
+    return 1;
+  }
+  if (length) {
+    mat = new_fmat(channels, length);
+    expected_mat = new_fmat(channels, length);
+    aubio_source_read_into(s, mat, length, &read);
+    aubio_source_seek(e, start);
+    aubio_source_read_into(e, expected_mat, length, &expected_read);
+    if (read != length || expected_read != length) err = 1;
+    for (j = 0; j < channels; j++) {
+      for (i = 0; i < read; i++) {
+        if (fabs(mat->data[j][i] - expected_mat->data[j][i]) > 1. / 32768.) {
+          err = 1;
+        }
+      }
+    }
+    del_fmat(mat);
+    del_fmat(expected_mat);
+  }
+  del_aubio_source(s);
+  del_aubio_source(e);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  // overlapping, across blocks, empty, until the end, out of range, and
+  // unsorted
+  uint_t starts[N_SLICES] = { 0, 500, 9000, 12000, 1000000, 100 };
+  uint_t ends[N_SLICES] = { 1000, 9100, 9000, (uint_t)-1, (uint_t)-1, 200 };
+  char_t paths[N_SLICES][PATH_MAX];
+  const char_t *uris[N_SLICES];
+  int fds[N_SLICES];
+  uint_t i, err = 0;
+  aubio_slicer_t *o;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  for (i = 0; i < N_SLICES; i++) {
+    strcpy(paths[i], "tmp_aubio_XXXXXX");
+    fds[i] = create_temp_sink(paths[i]);
+    if (!fds[i]) return 1;
+    uris[i] = paths[i];
+  }
+  o = new_aubio_slicer(argv[1], 0, 256);
+  if (!o) return 1;
+  if (aubio_slicer_get_channels(o) == 0
+      || aubio_slicer_get_samplerate(o) == 0) {
+    err = 1;
+  }
+  if (aubio_slicer_do(o, starts, ends, uris, N_SLICES) != 0) err = 1;
+  for (i = 0; i < N_SLICES; i++) {
+    // slices starting after the end of the source are not written
+    if (i == 4) continue;
+    if (check_slice(argv[1], paths[i], starts[i], ends[i])) {
+      PRINT_ERR("slice %d from %d to %d differs\n", i, starts[i], ends[i]);
+      err = 1;
+    }
+  }
+  // slicing again, with a slice that can not be written
+  uris[1] = "/nonexistent/dir/file.wav";
+  if (aubio_slicer_do(o, starts, ends, uris, 2) != 1) err = 1;
+  if (check_slice(argv[1], paths[0], starts[0], ends[0])) err = 1;
+  del_aubio_slicer(o);
+  for (i = 0; i < N_SLICES; i++) {
+    close_temp_sink(paths[i], fds[i]);
+  }
+  if (new_aubio_slicer("/nonexistent/dir/file.wav", 0, 256)) err = 1;
+  return err;
+}
@@ -24,7 +24,74 @@
 // this file uses the unstable aubio api, please use aubio_source instead
 // see src/io/source.h and tests/src/source/test-source.c
 
+#ifdef HAVE_LIBAV
+// check the resampling filter can be changed while reading
+static int test_filter_size (void)
+{
+  uint_t read = 0, hop_size = 256;
+  fvec_t *vec = new_fvec(hop_size);
+  aubio_source_avcodec_t *s =
+    new_aubio_source_avcodec(DEFINEDSTRING(AUBIO_TESTS_SOURCE), 22050,
+        hop_size);
+  if (!s || !vec) return 1;
+  if (aubio_source_avcodec_get_filter_size(s) != 32) return 1;
+  aubio_source_avcodec_do(s, vec, &read);
+  if (aubio_source_avcodec_set_filter_size(s, 8) != 0) return 1;
+  if (aubio_source_avcodec_get_filter_size(s) != 8) return 1;
+  aubio_source_avcodec_do(s, vec, &read);
+  if (read != hop_size) return 1;
+  if (aubio_source_avcodec_set_filter_size(s, 0) != 0) return 1;
+  if (aubio_source_avcodec_get_filter_size(s) != 32) return 1;
+  del_aubio_source_avcodec(s);
+  del_fvec(vec);
+  return 0;
+}
+
+// check seeking with an index lands on the same frames as reading through
+static int check_seek_index (const char_t *index_path, uint_t pos)
+{
+  uint_t i, read = 0, expected_read = 0, hop_size = 256, err = 0;
+  fvec_t *vec = new_fvec(hop_size), *expected_vec = new_fvec(hop_size);
+  const char_t *path = DEFINEDSTRING(AUBIO_TESTS_SOURCE);
+  aubio_source_avcodec_t *s = new_aubio_source_avcodec(path, 0, hop_size);
+  aubio_source_avcodec_t *e = new_aubio_source_avcodec(path, 0, hop_size);
+  if (!s || !e || !vec || !expected_vec) return 1;
+  if (aubio_source_avcodec_build_seek_index(s, index_path) != 0) return 1;
+  for (i = 0; i < pos / hop_size; i++) {
+    aubio_source_avcodec_do(e, expected_vec, &expected_read);
+  }
+  aubio_source_avcodec_do(e, expected_vec, &expected_read);
+  if (aubio_source_avcodec_seek(s, pos) != 0) return 1;
+  aubio_source_avcodec_do(s, vec, &read);
+  if (read != expected_read) err = 1;
+  for (i = 0; i < read; i++) {
+    if (fabs(vec->data[i] - expected_vec->data[i]) > 1.e-6) err = 1;
+  }
+  del_aubio_source_avcodec(s);
+  del_aubio_source_avcodec(e);
+  del_fvec(vec);
+  del_fvec(expected_vec);
+  return err;
+}
+
+static int test_seek_index (void)
+{
+  char_t index_path[PATH_MAX] = "tmp_aubio_XXXXXX";
+  int fd = create_temp_sink(index_path), err = 0;
+  if (!fd) return 1;
+  // the empty file is replaced with a new index, then loaded
+  err |= check_seek_index(index_path, 256 * 35);
+  err |= check_seek_index(index_path, 256 * 3);
+  err |= check_seek_index(NULL, 0);
+  close_temp_sink(index_path, fd);
+  return err;
+}
+#endif /* HAVE_LIBAV */
+
 int main (int argc, char **argv)
 {
+#ifdef HAVE_LIBAV
+  if (argc < 2 && (test_filter_size() || test_seek_index())) return 1;
+#endif /* HAVE_LIBAV */
   return base_main(argc, argv);
 }
@@ -0,0 +1,37 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// open a file with the backend chosen from its header, and with a given
+// backend, and check that unknown backends and wrong files are refused
+
+int main (int argc, char **argv)
+{
+  uint_t hop_size = 256, err = 0;
+  aubio_source_t *s, *e;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  s = new_aubio_source_with_backend(argv[1], 0, hop_size, "auto");
+  e = new_aubio_source(argv[1], 0, hop_size);
+  if (!s || !e) return 1;
+  if (aubio_source_get_duration(s) != aubio_source_get_duration(e)
+      || aubio_source_get_channels(s) != aubio_source_get_channels(e)) {
+    err = 1;
+  }
+  del_aubio_source(s);
+  del_aubio_source(e);
+
+#ifdef HAVE_WAVREAD
+  // the default source is a wav file
+  s = new_aubio_source_with_backend(argv[1], 0, hop_size, "wavread");
+  if (!s) err = 1;
+  else del_aubio_source(s);
+  // this program is not
+  if (new_aubio_source_with_backend(argv[0], 0, hop_size, "wavread")) err = 1;
+#endif /* HAVE_WAVREAD */
+  if (new_aubio_source_with_backend(argv[1], 0, hop_size, "unknown")) err = 1;
+
+  if (err) PRINT_ERR("wrong backends were accepted or refused\n");
+  return err;
+}
@@ -0,0 +1,63 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// capture a few hops from a device, by default the default ALSA device;
+// machines without sound card or without the backend only check the
+// device uris are not opened as files
+
+#define HOP 256
+#define N_HOPS 20
+
+int main (int argc, char **argv)
+{
+  const char_t *uri = argc > 1 ? argv[1] : "alsa:default";
+  aubio_source_t *s;
+  fvec_t *block = new_fvec (HOP);
+  fmat_t *blocks;
+  uint_t n, read = 0, total = 0, err = 0;
+  if (!block) return 1;
+
+  // wrong hop sizes and unknown schemes fail before opening a device
+  if (new_aubio_source (uri, 0, 0) || new_aubio_source ("alsa", 0, HOP))
+    err = 1;
+
+  s = new_aubio_source (uri, 0, HOP);
+  if (!s) {
+    PRINT_MSG ("could not open %s, skipping capture\n", uri);
+    del_fvec (block);
+    aubio_cleanup ();
+    return err;
+  }
+  blocks = new_fmat (aubio_source_get_channels (s), HOP);
+  if (!blocks) return 1;
+  if (aubio_source_get_samplerate (s) != 44100
+      || aubio_source_get_duration (s) != 0
+      || aubio_source_seek (s, 0) == 0) err = 1;
+
+  // a hop is returned as soon as it was captured
+  for (n = 0; n < N_HOPS; n++) {
+    if (n % 2) {
+      aubio_source_do_multi (s, blocks, &read);
+    } else {
+      aubio_source_do (s, block, &read);
+    }
+    if (read != HOP) err = 1;
+    total += read;
+  }
+  PRINT_MSG ("captured %d frames from %s, %d channels at %dHz\n", total, uri,
+      aubio_source_get_channels (s), aubio_source_get_samplerate (s));
+
+  // once closed, only the frames already captured are left
+  aubio_source_close (s);
+  do {
+    aubio_source_do (s, block, &read);
+  } while (read == HOP);
+  aubio_source_do (s, block, &read);
+  if (read != 0) err = 1;
+
+  del_aubio_source (s);
+  del_fmat (blocks);
+  del_fvec (block);
+  aubio_cleanup ();
+  return err;
+}
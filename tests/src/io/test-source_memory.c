@@ -0,0 +1,92 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// read a file from memory and through callbacks, and check the frames are
+// the same as when reading it from its path
+
+static sint_t read_file (void *user_data, void *buf, uint_t size)
+{
+  return fread(buf, 1, size, (FILE *)user_data);
+}
+
+static long long seek_file (void *user_data, long long offset, sint_t whence)
+{
+  if (fseek((FILE *)user_data, (long)offset, whence) != 0) return -1;
+  return ftell((FILE *)user_data);
+}
+
+static int compare_sources (aubio_source_t *s, const char_t *path)
+{
+  uint_t i, j, read = 0, expected_read = 0, hop_size = 256, err = 0;
+  aubio_source_t *e = new_aubio_source(path, 0, hop_size);
+  uint_t channels;
+  fmat_t *mat, *expected_mat;
+  if (!s || !e) return 1;
+  channels = aubio_source_get_channels(e);
+  if (aubio_source_get_channels(s) != channels
+      || aubio_source_get_samplerate(s) != aubio_source_get_samplerate(e)
+      || aubio_source_get_duration(s) != aubio_source_get_duration(e)) {
+    return 1;
+  }
+  mat = new_fmat(channels, hop_size);
+  expected_mat = new_fmat(channels, hop_size);
+  // read the end of the file, then all of it again
+  if (aubio_source_seek(s, aubio_source_get_duration(e) / 2)
+      || aubio_source_seek(e, aubio_source_get_duration(e) / 2)) {
+    return 1;
+  }
+  for (i = 0; i < 2; i++) {
+    do {
+      aubio_source_do_multi(s, mat, &read);
+      aubio_source_do_multi(e, expected_mat, &expected_read);
+      if (read != expected_read) err = 1;
+      for (j = 0; j < channels * read; j++) {
+        if (mat->data[j / read][j % read]
+            != expected_mat->data[j / read][j % read]) err = 1;
+      }
+    } while (read == hop_size && !err);
+    aubio_source_seek(s, 0);
+    aubio_source_seek(e, 0);
+  }
+  del_aubio_source(e);
+  del_fmat(mat);
+  del_fmat(expected_mat);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  aubio_source_callbacks_t callbacks = { read_file, seek_file };
+  aubio_source_t *s;
+  unsigned char *data;
+  long size;
+  FILE *f;
+  int err = 0;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  f = fopen(argv[1], "rb");
+  if (!f || fseek(f, 0, SEEK_END) != 0 || (size = ftell(f)) <= 0) return 1;
+  data = (unsigned char *)malloc(size);
+  rewind(f);
+  if (!data || fread(data, 1, size, f) != (size_t)size) return 1;
+
+  s = new_aubio_source_memory(data, size, 0, 256);
+  err |= compare_sources(s, argv[1]);
+  del_aubio_source(s);
+
+  s = new_aubio_source_callbacks(&callbacks, f, 0, 256);
+  err |= compare_sources(s, argv[1]);
+  del_aubio_source(s);
+
+  // truncated buffer and missing callbacks
+  if (new_aubio_source_memory(data, 12, 0, 256)) err = 1;
+  callbacks.read = NULL;
+  if (new_aubio_source_callbacks(&callbacks, f, 0, 256)) err = 1;
+
+  free(data);
+  fclose(f);
+  if (err) PRINT_ERR("sources read from memory differ\n");
+  return err;
+}
@@ -0,0 +1,99 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// read a file with and without reading ahead, and check that both sources
+// return the same blocks, before and after seeking
+
+static int compare_sources (const char_t *path, uint_t hop_size,
+    uint_t queue_frames)
+{
+  uint_t i, j, read = 0, prefetch_read = 0, total = 0, err = 0;
+  aubio_source_t *s = new_aubio_source(path, 0, hop_size);
+  aubio_source_t *p = new_aubio_source_prefetch(path, 0, hop_size,
+      queue_frames);
+  uint_t channels;
+  fmat_t *mat, *prefetch_mat;
+  fvec_t *vec, *prefetch_vec;
+  if (!s || !p) return 1;
+  channels = aubio_source_get_channels(s);
+  if (aubio_source_get_channels(p) != channels
+      || aubio_source_get_samplerate(p) != aubio_source_get_samplerate(s)
+      || aubio_source_get_duration(p) != aubio_source_get_duration(s)) {
+    return 1;
+  }
+  mat = new_fmat(channels, hop_size);
+  prefetch_mat = new_fmat(channels, hop_size);
+  vec = new_fvec(hop_size);
+  prefetch_vec = new_fvec(hop_size);
+
+  do {
+    aubio_source_do_multi(s, mat, &read);
+    aubio_source_do_multi(p, prefetch_mat, &prefetch_read);
+    if (read != prefetch_read) err = 1;
+    for (j = 0; j < channels; j++) {
+      for (i = 0; i < hop_size; i++) {
+        if (mat->data[j][i] != prefetch_mat->data[j][i]) err = 1;
+      }
+    }
+    total += read;
+  } while (read == hop_size && !err);
+  if (total != aubio_source_get_duration(s)) err = 1;
+
+  // past the end, no more frames are read
+  aubio_source_do_multi(p, prefetch_mat, &prefetch_read);
+  if (prefetch_read != 0) err = 1;
+
+  // seek back and read the down-mixed signal
+  if (aubio_source_seek(s, hop_size / 3) || aubio_source_seek(p, hop_size / 3))
+    err = 1;
+  for (j = 0; j < 3 && !err; j++) {
+    aubio_source_do(s, vec, &read);
+    aubio_source_do(p, prefetch_vec, &prefetch_read);
+    if (read != prefetch_read) err = 1;
+    for (i = 0; i < hop_size; i++) {
+      if (fabs(vec->data[i] - prefetch_vec->data[i]) > 1.e-6) err = 1;
+    }
+  }
+
+  // once closed, the source returns no more frames
+  aubio_source_close(p);
+  aubio_source_do(p, prefetch_vec, &prefetch_read);
+  if (prefetch_read != 0) err = 1;
+
+  del_aubio_source(s);
+  del_aubio_source(p);
+  del_fmat(mat);
+  del_fmat(prefetch_mat);
+  del_fvec(vec);
+  del_fvec(prefetch_vec);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t hop_size = 256;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  if (argc >= 3) hop_size = atoi(argv[2]);
+
+  // default queue, smallest queue, and a queue larger than the file
+  if (compare_sources(argv[1], hop_size, 0)
+      || compare_sources(argv[1], hop_size, 1)
+      || compare_sources(argv[1], hop_size, 1 << 24)) {
+    PRINT_ERR("prefetched source differs from %s\n", argv[1]);
+    return 1;
+  }
+
+  // deleting the source while the thread is still reading ahead
+  aubio_source_t *p = new_aubio_source_prefetch(argv[1], 0, hop_size, 0);
+  if (!p) return 1;
+  del_aubio_source(p);
+
+  // failing to open the file
+  if (new_aubio_source_prefetch("/nonexistent/file.wav", 0, hop_size, 0)) {
+    return 1;
+  }
+  return 0;
+}
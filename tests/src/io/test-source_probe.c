@@ -0,0 +1,70 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// read the header of a file, and check it gives the same properties as a
+// source opened at the samplerate of the file
+
+#define HOP 256
+#define N_BLOCKS 40
+
+static uint_t compare_source (const char_t *path)
+{
+  aubio_source_info_t info;
+  aubio_source_t *s = new_aubio_source (path, 0, HOP);
+  uint_t err = 0;
+  if (!s) return 1;
+  if (aubio_source_probe (path, &info) != 0
+      || info.samplerate != aubio_source_get_samplerate (s)
+      || info.channels != aubio_source_get_channels (s)
+      || info.duration != aubio_source_get_duration (s)) err = 1;
+  PRINT_MSG ("%s: %dHz, %d channels, %d frames\n", path, info.samplerate,
+      info.channels, info.duration);
+  del_aubio_source (s);
+  return err;
+}
+
+static uint_t write_file (const char_t *path, uint_t samplerate,
+    uint_t channels)
+{
+  aubio_sink_t *s = new_aubio_sink (path, 0);
+  fmat_t *block = new_fmat (channels, HOP);
+  uint_t n;
+  if (!s || !block || aubio_sink_preset_samplerate (s, samplerate)
+      || aubio_sink_preset_channels (s, channels)) return 1;
+  for (n = 0; n < N_BLOCKS; n++) {
+    fmat_set (block, .1 * (n % 3));
+    aubio_sink_do_multi (s, block, HOP);
+  }
+  // a last, shorter block
+  aubio_sink_do_multi (s, block, HOP / 2);
+  del_aubio_sink (s);
+  del_fmat (block);
+  return 0;
+}
+
+int main (int argc, char **argv)
+{
+  aubio_source_info_t info;
+  uint_t err = 0;
+  if (argc < 3) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source_and_sink(main);
+  }
+  err |= compare_source (argv[1]);
+
+  if (write_file (argv[2], 22050, 3)) return 1;
+  if (aubio_source_probe (argv[2], &info) != 0 || info.samplerate != 22050
+      || info.channels != 3 || info.duration != N_BLOCKS * HOP + HOP / 2)
+    err = 1;
+  err |= compare_source (argv[2]);
+
+  // missing files are refused, and info cleared
+  if (aubio_source_probe ("/missing/file.wav", &info) == 0
+      || info.samplerate != 0 || info.channels != 0 || info.duration != 0)
+    err = 1;
+  if (aubio_source_probe (NULL, &info) == 0) err = 1;
+
+  if (err) PRINT_ERR ("probed properties differ from the source ones\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,110 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// read a region of a file, and check the frames are the ones read from the
+// whole file, stopping exactly at the end of the region
+
+#define HOP 256
+
+static uint_t check_do (const char_t *path, const fvec_t *all, uint_t start,
+    uint_t end)
+{
+  aubio_source_t *s = new_aubio_source (path, 0, HOP);
+  fvec_t *block = new_fvec (HOP);
+  uint_t i, read = 0, total = 0, err = 0;
+  if (!s || !block) return 1;
+  if (aubio_source_set_range (s, start, end) != 0
+      || aubio_source_get_position (s) != start) err = 1;
+  do {
+    aubio_source_do (s, block, &read);
+    for (i = 0; i < HOP; i++) {
+      // the frames after the end of the region are silent
+      smpl_t expected = i < read ? all->data[start + total + i] : 0.;
+      if (block->data[i] != expected) err = 1;
+    }
+    total += read;
+  } while (read == HOP);
+  if (total != end - start || aubio_source_get_position (s) != end) err = 1;
+  // nothing more is read
+  aubio_source_do (s, block, &read);
+  if (read != 0 || block->data[0] != 0.) err = 1;
+  del_aubio_source (s);
+  del_fvec (block);
+  return err;
+}
+
+static uint_t check_multi (const char_t *path, const fvec_t *all,
+    uint_t start, uint_t end)
+{
+  aubio_source_t *s = new_aubio_source (path, 0, HOP);
+  fmat_t *block, *large;
+  uint_t i, read = 0, total = 0, err = 0;
+  if (!s) return 1;
+  block = new_fmat (aubio_source_get_channels (s), HOP);
+  large = new_fmat (aubio_source_get_channels (s), 10 * HOP);
+  aubio_source_set_range (s, start, end);
+  // a block, then the rest of the region at once
+  aubio_source_do_multi (s, block, &read);
+  total += read;
+  aubio_source_read_into (s, large, large->length, &read);
+  if (total + read != end - start || read >= large->length) err = 1;
+  // the first channel matches the downmixed frames of mono files only
+  if (aubio_source_get_channels (s) == 1) {
+    for (i = 0; i < read; i++) {
+      if (large->data[0][i] != all->data[start + total + i]) err = 1;
+    }
+  }
+  for (i = read; i < large->length; i++) {
+    if (large->data[0][i] != 0.) err = 1;
+  }
+  // seeking back within the file reads up to the end of the region again
+  if (aubio_source_seek (s, end - 10) != 0) err = 1;
+  aubio_source_read_into (s, large, large->length, &read);
+  if (read != 10) err = 1;
+  // and the range can be cleared
+  if (aubio_source_set_range (s, end - 10, 0) != 0) err = 1;
+  aubio_source_read_into (s, large, large->length, &read);
+  if (read != large->length) err = 1;
+  del_aubio_source (s);
+  del_fmat (block);
+  del_fmat (large);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  aubio_source_t *s;
+  fvec_t *all;
+  uint_t duration, read = 0, total = 0, err = 0;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  s = new_aubio_source (argv[1], 0, HOP);
+  if (!s) return 1;
+  duration = aubio_source_get_duration (s);
+  all = new_fvec (duration + HOP);
+  if (!all || duration < 20 * HOP) return 1;
+  do {
+    fvec_t block;
+    block.data = all->data + total;
+    block.length = HOP;
+    aubio_source_do (s, &block, &read);
+    total += read;
+  } while (read == HOP && total + HOP <= all->length);
+
+  err |= check_do (argv[1], all, duration / 3, duration / 3 + 5 * HOP + 17);
+  err |= check_do (argv[1], all, 0, HOP);
+  err |= check_multi (argv[1], all, duration / 2, duration / 2 + 3 * HOP + 5);
+
+  // empty and reversed regions are refused, and leave the source as it was
+  if (aubio_source_set_range (s, 100, 100) == 0
+      || aubio_source_set_range (s, 200, 100) == 0) err = 1;
+  if (aubio_source_get_position (s) != total) err = 1;
+
+  if (err) PRINT_ERR ("frames read from the region differ\n");
+  del_aubio_source (s);
+  del_fvec (all);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,81 @@
+#include <aubio.h>
+#include "utils_tests.h"
+#include <stdint.h> // int16_t
+
+// write interleaved 16-bit samples to a file without header, then read them
+// back from its path and from the standard input
+
+#define CHANNELS 2
+#define N_FRAMES 20000
+#define HOP 256
+
+static smpl_t expected (uint_t frame, uint_t channel)
+{
+  return (smpl_t)((sint_t)((frame * 37 + channel * 1000) % 60000) - 30000)
+    / 32768.;
+}
+
+static uint_t check_raw (const char_t *path)
+{
+  aubio_source_t *s = new_aubio_source_raw (path, "s16", 44100, CHANNELS, HOP);
+  fmat_t *mat = new_fmat (CHANNELS, HOP);
+  fvec_t *vec = new_fvec (HOP);
+  uint_t c, j, read = 0, total = 0, err = 0;
+  if (!s || !mat || !vec) return 1;
+  if (aubio_source_get_samplerate (s) != 44100
+      || aubio_source_get_channels (s) != CHANNELS) err = 1;
+  do {
+    aubio_source_do_multi (s, mat, &read);
+    for (c = 0; c < CHANNELS; c++) {
+      for (j = 0; j < read; j++) {
+        if (mat->data[c][j] != expected (total + j, c)) err = 1;
+      }
+    }
+    total += read;
+  } while (read == HOP);
+  if (total != N_FRAMES) err = 1;
+  // down-mixed, after seeking back
+  if (aubio_source_seek (s, 100)) err = 1;
+  aubio_source_do (s, vec, &read);
+  for (j = 0; j < read; j++) {
+    if (fabs (vec->data[j] - (expected (100 + j, 0) + expected (100 + j, 1))
+          / 2.) > 1.e-6) err = 1;
+  }
+  PRINT_MSG ("read %d frames from %s\n", total, path);
+  del_aubio_source (s);
+  del_fmat (mat);
+  del_fvec (vec);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t c, j, err = 0;
+  FILE *f;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_sink(main);
+  }
+  f = fopen (argv[1], "wb");
+  if (!f) return 1;
+  for (j = 0; j < N_FRAMES; j++) {
+    for (c = 0; c < CHANNELS; c++) {
+      int16_t v = (int16_t)(expected (j, c) * 32768.);
+      unsigned char b[2] = { (unsigned char)v, (unsigned char)(v >> 8) };
+      fwrite (b, 1, 2, f);
+    }
+  }
+  fclose (f);
+
+  err |= check_raw (argv[1]);
+  if (!freopen (argv[1], "rb", stdin)) return 1;
+  err |= check_raw ("-");
+
+  // unknown format, no channels
+  if (new_aubio_source_raw (argv[1], "s12", 44100, 1, HOP)) err = 1;
+  if (new_aubio_source_raw (argv[1], "f32", 44100, 0, HOP)) err = 1;
+
+  if (err) PRINT_ERR ("raw samples differ from the ones written\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,69 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// read long blocks with aubio_source_read_into, and check they hold the same
+// frames as the hops read with aubio_source_do_multi
+
+static int check_read_into (aubio_source_t *s, const char_t *path,
+    uint_t max_frames, uint_t mix)
+{
+  uint_t hop_size = 256, channels, i, j, k = 0, read = 0, hop_read = 0;
+  uint_t total = 0, err = 0, hop_pos = hop_size;
+  aubio_source_t *e = new_aubio_source(path, 0, hop_size);
+  fmat_t *block, *hop, *mixed;
+  if (!s || !e) return 1;
+  channels = aubio_source_get_channels(e);
+  block = new_fmat(channels, max_frames);
+  mixed = new_fmat(channels, hop_size);
+  hop = new_fmat(channels, hop_size);
+  do {
+    if (mix && (k++ % 2)) {
+      // hops and long blocks can be read in turn
+      aubio_source_do_multi(s, mixed, &read);
+      for (i = 0; i < read; i++) {
+        for (j = 0; j < channels; j++) {
+          fmat_set_sample(block, fmat_get_sample(mixed, j, i), j, i);
+        }
+      }
+      max_frames = hop_size;
+    } else {
+      aubio_source_read_into(s, block, block->length, &read);
+      max_frames = block->length;
+    }
+    for (i = 0; i < read; i++) {
+      if (hop_pos == hop_size) {
+        aubio_source_do_multi(e, hop, &hop_read);
+        hop_pos = 0;
+      }
+      for (j = 0; j < channels; j++) {
+        if (block->data[j][i] != hop->data[j][hop_pos]) err = 1;
+      }
+      hop_pos++;
+    }
+    total += read;
+  } while (read == max_frames && !err);
+  if (total != aubio_source_get_duration(e)) err = 1;
+  del_aubio_source(s);
+  del_aubio_source(e);
+  del_fmat(block);
+  del_fmat(mixed);
+  del_fmat(hop);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t err = 0;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  err |= check_read_into(new_aubio_source(argv[1], 0, 256), argv[1], 44100, 0);
+  err |= check_read_into(new_aubio_source(argv[1], 0, 256), argv[1], 1000, 1);
+  err |= check_read_into(new_aubio_source_prefetch(argv[1], 0, 256, 0),
+      argv[1], 44100, 0);
+  err |= check_read_into(new_aubio_source_prefetch(argv[1], 0, 256, 0),
+      argv[1], 300, 1);
+  if (err) PRINT_ERR("blocks read with aubio_source_read_into differ\n");
+  return err;
+}
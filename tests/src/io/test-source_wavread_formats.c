@@ -0,0 +1,139 @@
+#define AUBIO_UNSTABLE 1
+#include <aubio.h>
+#include "utils_tests.h"
+
+// read wav files encoded with each supported sample format, and check the
+// decoded samples against the values they were written from
+
+#define N_FRAMES 1500
+#define N_CHANNELS 3
+
+static smpl_t expected_sample (uint_t frame, uint_t channel)
+{
+  // multiples of 1/16, exactly represented in all formats
+  return (smpl_t)((sint_t)((frame * 7 + channel * 3) % 17) - 8) / 16.;
+}
+
+static void write_le (FILE *f, unsigned long long value, uint_t bytes)
+{
+  uint_t b;
+  for (b = 0; b < bytes; b++) {
+    fputc((int)((value >> (8 * b)) & 0xff), f);
+  }
+}
+
+static int write_wav (const char *path, uint_t format, uint_t bits,
+    uint_t extensible)
+{
+  uint_t i, c, bytes = bits / 8, fmt_size = extensible ? 40 : 16;
+  uint_t data_size = N_FRAMES * N_CHANNELS * bytes;
+  FILE *f = fopen(path, "wb");
+  if (!f) return 1;
+  fwrite("RIFF", 1, 4, f);
+  write_le(f, 4 + 8 + fmt_size + 8 + data_size, 4);
+  fwrite("WAVEfmt ", 1, 8, f);
+  write_le(f, fmt_size, 4);
+  write_le(f, extensible ? 0xFFFE : format, 2);
+  write_le(f, N_CHANNELS, 2);
+  write_le(f, 44100, 4);
+  write_le(f, 44100 * N_CHANNELS * bytes, 4);
+  write_le(f, N_CHANNELS * bytes, 2);
+  write_le(f, bits, 2);
+  if (extensible) {
+    write_le(f, 22, 2);
+    write_le(f, bits, 2);
+    write_le(f, 0, 4);
+    // SubFormat GUID
+    write_le(f, format, 2);
+    fwrite("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xaa\x00\x38\x9b\x71",
+        1, 14, f);
+  }
+  fwrite("data", 1, 4, f);
+  write_le(f, data_size, 4);
+  for (i = 0; i < N_FRAMES; i++) {
+    for (c = 0; c < N_CHANNELS; c++) {
+      double v = expected_sample(i, c);
+      if (format == 3 && bits == 32) {
+        float fv = (float)v;
+        unsigned int u;
+        memcpy(&u, &fv, 4);
+        write_le(f, u, 4);
+      } else if (format == 3) {
+        unsigned long long u;
+        memcpy(&u, &v, 8);
+        write_le(f, u, 8);
+      } else if (bits == 8) {
+        write_le(f, (unsigned long long)(v * 128. + 128.), 1);
+      } else {
+        long long iv = (long long)(v * (double)(1ULL << (bits - 1)));
+        write_le(f, (unsigned long long)iv, bytes);
+      }
+    }
+  }
+  fclose(f);
+  return 0;
+}
+
+static int check_wav (const char *path)
+{
+  uint_t hop_size = 256, read = 0, total = 0, i, c;
+  aubio_source_wavread_t *s = new_aubio_source_wavread(path, 0, hop_size);
+  fmat_t *mat = new_fmat(N_CHANNELS, hop_size);
+  fvec_t *vec = new_fvec(hop_size);
+  if (!s) return 1;
+  assert(aubio_source_wavread_get_channels(s) == N_CHANNELS);
+  assert(aubio_source_wavread_get_duration(s) == N_FRAMES);
+  do {
+    aubio_source_wavread_do_multi(s, mat, &read);
+    for (i = 0; i < read; i++) {
+      for (c = 0; c < N_CHANNELS; c++) {
+        assert(mat->data[c][i] == expected_sample(total + i, c));
+      }
+    }
+    total += read;
+  } while (read == hop_size);
+  assert(total == N_FRAMES);
+
+  // seek back and read the down-mixed signal
+  assert(aubio_source_wavread_seek(s, 1000) == 0);
+  aubio_source_wavread_do(s, vec, &read);
+  assert(read == hop_size);
+  for (i = 0; i < read; i++) {
+    smpl_t sum = 0.;
+    for (c = 0; c < N_CHANNELS; c++) {
+      sum += expected_sample(1000 + i, c);
+    }
+    assert(fabs(vec->data[i] - sum / N_CHANNELS) < 1.e-6);
+  }
+
+  del_aubio_source_wavread(s);
+  del_fmat(mat);
+  del_fvec(vec);
+  return 0;
+}
+
+int main (void)
+{
+#ifdef HAVE_WAVREAD
+  uint_t formats[][3] = {
+    // AudioFormat, BitsPerSample, WAVE_FORMAT_EXTENSIBLE
+    { 1, 8, 0 }, { 1, 16, 0 }, { 1, 24, 0 }, { 1, 32, 0 },
+    { 3, 32, 0 }, { 3, 64, 0 }, { 1, 24, 1 }, { 3, 32, 1 },
+  };
+  uint_t k;
+  for (k = 0; k < sizeof(formats) / sizeof(formats[0]); k++) {
+    char path[PATH_MAX] = "tmp_aubio_XXXXXX";
+    int fd = create_temp_sink(path);
+    if (!fd) return 1;
+    if (write_wav(path, formats[k][0], formats[k][1], formats[k][2])
+        || check_wav(path)) {
+      PRINT_ERR("failed reading %d-bit file with format %d\n",
+          formats[k][1], formats[k][0]);
+      close_temp_sink(path, fd);
+      return 1;
+    }
+    close_temp_sink(path, fd);
+  }
+#endif /* HAVE_WAVREAD */
+  return 0;
+}
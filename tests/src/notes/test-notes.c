@@ -1,4 +1,75 @@
 #include <aubio.h>
+#include "utils_tests.h"
+
+// play a few tones separated by silences, and check each gets its note
+static uint_t test_tones (void)
+{
+  uint_t hop_size = 256, samplerate = 44100;
+  smpl_t midi[3] = { 57., 64., 69. };
+  uint_t i, j, t = 0, found = 0, err = 0;
+  fvec_t *in = new_fvec(hop_size), *out = new_fvec(3);
+  aubio_notes_t *o = new_aubio_notes("default", 512, hop_size, samplerate);
+  if (!o || !in || !out) return 1;
+  for (i = 0; i < 3; i++) {
+    smpl_t freq = 440. * pow(2., (midi[i] - 69.) / 12.);
+    for (j = 0; j < 200; j++) {
+      uint_t k;
+      for (k = 0; k < hop_size; k++, t++) {
+        // 120 hops of tone, then 80 of silence
+        in->data[k] = j < 120 ? .5 * sin(2. * M_PI * freq * t / samplerate) : 0.;
+      }
+      aubio_notes_do(o, in, out);
+      if (out->data[0] != 0.) {
+        if (found >= 3 || out->data[0] != midi[found]) err = 1;
+        found++;
+      }
+    }
+  }
+  if (found != 3) err = 1;
+  del_aubio_notes(o);
+  del_fvec(in);
+  del_fvec(out);
+  return err;
+}
+
+// glide from one note to another without onset: the notes after the first
+// one are only found when the held notes are checked
+static uint_t test_legato (smpl_t interval_ms)
+{
+  uint_t hop_size = 256, samplerate = 44100;
+  smpl_t midi[2] = { 60., 67. }, phase = 0., last = 0.;
+  uint_t j, k, found = 0, err = 0;
+  fvec_t *in = new_fvec(hop_size), *out = new_fvec(3);
+  aubio_notes_t *o = new_aubio_notes("default", 512, hop_size, samplerate);
+  if (!o || !in || !out) return 1;
+  if (aubio_notes_set_sustain_interval_ms(o, interval_ms)
+      || aubio_notes_get_sustain_interval_ms(o) != interval_ms) err = 1;
+  for (j = 0; j < 400; j++) {
+    // a glide of 100 hops, at a constant level, so that no onset is detected
+    smpl_t pos = j < 150 ? 0. : j < 250 ? (j - 150) / 100. : 1.;
+    smpl_t note = midi[0] + pos * (midi[1] - midi[0]);
+    smpl_t freq = 440. * pow(2., (note - 69.) / 12.);
+    for (k = 0; k < hop_size; k++) {
+      in->data[k] = .5 * sin(phase);
+      phase += 2. * M_PI * freq / samplerate;
+    }
+    aubio_notes_do(o, in, out);
+    if (out->data[0] != 0.) {
+      // each note moves up from the previous one
+      if (out->data[0] <= last) err = 1;
+      last = out->data[0];
+      found++;
+    }
+  }
+  PRINT_MSG("sustain interval %.0fms: %d notes, last %.0f\n", interval_ms,
+      found, last);
+  if (interval_ms == 0. && (found != 1 || last != midi[0])) err = 1;
+  if (interval_ms > 0. && (found < 2 || last != midi[1])) err = 1;
+  del_aubio_notes(o);
+  del_fvec(in);
+  del_fvec(out);
+  return err;
+}
 
 int main (void)
 {
@@ -14,11 +85,13 @@ int main (void)
   if (aubio_notes_set_silence(o, silence)) return 1;
   if (aubio_notes_set_minioi_ms(o, minioi_ms)) return 1;
   if (aubio_notes_set_release_drop(o, release_drop)) return 1;
+  if (aubio_notes_set_sustain_interval_ms(o, -1.) == 0) return 1;
   del_aubio_notes(o);
   // test wrong arguments
   if (new_aubio_notes("unknown", buf_size, hop_size, samplerate)) return 1;
   if (new_aubio_notes("default",        0, hop_size, samplerate)) return 1;
   if (new_aubio_notes("default", buf_size,        0, samplerate)) return 1;
   if (new_aubio_notes("default", buf_size, hop_size,          0)) return 1;
-  return 0;
+  if (test_legato(0.) || test_legato(50.)) return 1;
+  return test_tones();
 }
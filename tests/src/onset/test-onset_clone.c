@@ -0,0 +1,86 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// a clone detects the onsets of an object created with the same parameters,
+// and a reconfigured object those of a new object of the same method and
+// sizes
+
+static void noise_bursts (fvec_t *in, uint_t n)
+{
+  uint_t i;
+  smpl_t gain = (n % 17 < 3) ? 1. : 0.01;
+  for (i = 0; i < in->length; i++) {
+    in->data[i] = gain * (2. * random() / (smpl_t)RAND_MAX - 1.);
+  }
+}
+
+// run a and b on the same n_frames hops, check their onsets match
+static void check_same (aubio_onset_t *a, aubio_onset_t *b, uint_t hop_s,
+    uint_t n_frames)
+{
+  uint_t n;
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *a_out = new_fvec (1), *b_out = new_fvec (1);
+  for (n = 0; n < n_frames; n++) {
+    noise_bursts (in, n);
+    aubio_onset_do (a, in, a_out);
+    aubio_onset_do (b, in, b_out);
+    assert(a_out->data[0] == b_out->data[0]);
+    assert(aubio_onset_get_last (a) == aubio_onset_get_last (b));
+  }
+  del_fvec (in);
+  del_fvec (a_out);
+  del_fvec (b_out);
+}
+
+static void set_parameters (aubio_onset_t *o)
+{
+  aubio_onset_set_threshold (o, 0.4);
+  aubio_onset_set_minioi_ms (o, 80.);
+  aubio_onset_set_lowlatency (o, 1);
+  aubio_onset_set_delay (o, 512);
+}
+
+int main (void)
+{
+  uint_t samplerate = 44100, n_frames = 200;
+  aubio_onset_t *o = new_aubio_onset ("default", 1024, 256, samplerate);
+  aubio_onset_t *ref = new_aubio_onset ("default", 1024, 256, samplerate);
+  aubio_onset_t *c;
+
+  if (!o || !ref) return 1;
+  utils_init_random();
+  set_parameters (o);
+  set_parameters (ref);
+  check_same (o, ref, 256, n_frames);
+
+  // the clone has the parameters of o, and the state of a new object
+  c = aubio_onset_clone (o);
+  assert(c);
+  assert(aubio_onset_get_threshold (c) == aubio_onset_get_threshold (o));
+  assert(aubio_onset_get_delay (c) == aubio_onset_get_delay (o));
+  del_aubio_onset (ref);
+  ref = new_aubio_onset ("default", 1024, 256, samplerate);
+  assert(ref);
+  set_parameters (ref);
+  check_same (c, ref, 256, n_frames);
+  del_aubio_onset (c);
+  del_aubio_onset (ref);
+
+  // a reconfigured object is a new one, with the default parameters
+  assert(aubio_onset_reconfigure (o, "specflux", 512, 128) == 0);
+  ref = new_aubio_onset ("specflux", 512, 128, samplerate);
+  assert(aubio_onset_get_threshold (o) == aubio_onset_get_threshold (ref));
+  assert(aubio_onset_get_lowlatency (o) == 0);
+  check_same (o, ref, 128, n_frames);
+
+  // a failed reconfiguration leaves the object unchanged
+  assert(aubio_onset_reconfigure (o, "unknown", 512, 128) != 0);
+  assert(aubio_onset_reconfigure (o, "hfc", 128, 512) != 0);
+  check_same (o, ref, 128, n_frames);
+
+  del_aubio_onset (o);
+  del_aubio_onset (ref);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,142 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// in deferred mode, the setters of onset, tempo and pitch only post their
+// values, which are applied when the next hop is processed; the last value
+// posted for a parameter wins, and the detections then match the ones of an
+// object set directly
+
+#define WIN_S 1024
+#define HOP_S 256
+#define RATE 44100
+
+static void fill_hop (fvec_t *in, uint_t n)
+{
+  uint_t i;
+  smpl_t gain = (n % 20 < 4) ? ((n % 20 == 0) ? 1. : .3) : .01;
+  for (i = 0; i < in->length; i++) {
+    in->data[i] = gain * (2. * random() / (smpl_t)RAND_MAX - 1.);
+  }
+}
+
+static uint_t check_onset (void)
+{
+  aubio_onset_t *o = new_aubio_onset ("default", WIN_S, HOP_S, RATE);
+  aubio_onset_t *ref = new_aubio_onset ("default", WIN_S, HOP_S, RATE);
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (1), *ref_out = new_fvec (1);
+  uint_t n, err = 0, n_onsets = 0;
+  if (!o || !ref || !in || !out || !ref_out) return 1;
+  if (aubio_onset_get_deferred (o) != 0 || aubio_onset_set_deferred (o, 1)
+      || aubio_onset_get_deferred (o) != 1) err = 1;
+
+  aubio_onset_set_threshold (o, .9);
+  aubio_onset_set_threshold (o, .5);
+  aubio_onset_set_silence (o, -50.);
+  aubio_onset_set_minioi_ms (o, 120.);
+  aubio_onset_set_delay (o, 3 * HOP_S);
+  aubio_onset_set_compression (o, 2.);
+  // nothing is applied before the next hop
+  if (aubio_onset_get_threshold (o) != aubio_onset_get_threshold (ref)
+      || aubio_onset_get_silence (o) != aubio_onset_get_silence (ref)
+      || aubio_onset_get_minioi (o) != aubio_onset_get_minioi (ref)
+      || aubio_onset_get_delay (o) != aubio_onset_get_delay (ref)
+      || aubio_onset_get_compression (o) != aubio_onset_get_compression (ref))
+    err = 1;
+  // invalid values are still refused
+  if (aubio_onset_set_compression (o, -1.) == 0) err = 1;
+
+  aubio_onset_set_threshold (ref, .5);
+  aubio_onset_set_silence (ref, -50.);
+  aubio_onset_set_minioi_ms (ref, 120.);
+  aubio_onset_set_delay (ref, 3 * HOP_S);
+  aubio_onset_set_compression (ref, 2.);
+
+  utils_init_random();
+  for (n = 0; n < 200; n++) {
+    fill_hop (in, n);
+    aubio_onset_do (o, in, out);
+    aubio_onset_do (ref, in, ref_out);
+    if (out->data[0] != ref_out->data[0]) err = 1;
+    if (out->data[0] != 0.) n_onsets++;
+  }
+  if (aubio_onset_get_threshold (o) != .5
+      || aubio_onset_get_silence (o) != -50.
+      || aubio_onset_get_minioi (o) != aubio_onset_get_minioi (ref)
+      || aubio_onset_get_delay (o) != 3 * HOP_S
+      || aubio_onset_get_compression (o) != 2.) err = 1;
+  PRINT_MSG ("onset: %d onsets after the deferred updates\n", n_onsets);
+  if (n_onsets == 0) err = 1;
+
+  // the clone keeps the mode
+  {
+    aubio_onset_t *c = aubio_onset_clone (o);
+    if (!c || aubio_onset_get_deferred (c) != 1) err = 1;
+    if (c) del_aubio_onset (c);
+  }
+  del_aubio_onset (o);
+  del_aubio_onset (ref);
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (ref_out);
+  return err;
+}
+
+static uint_t check_tempo (void)
+{
+  aubio_tempo_t *o = new_aubio_tempo ("default", WIN_S, HOP_S, RATE);
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (2);
+  uint_t err = 0;
+  smpl_t threshold;
+  if (!o || !in || !out) return 1;
+  threshold = aubio_tempo_get_threshold (o);
+  aubio_tempo_set_deferred (o, 1);
+  aubio_tempo_set_threshold (o, .7);
+  aubio_tempo_set_silence (o, -60.);
+  aubio_tempo_set_delay_ms (o, 10.);
+  if (aubio_tempo_get_threshold (o) != threshold) err = 1;
+  fill_hop (in, 0);
+  aubio_tempo_do (o, in, out);
+  if (fabs (aubio_tempo_get_threshold (o) - .7) > 1.e-6
+      || aubio_tempo_get_silence (o) != -60.
+      || aubio_tempo_get_delay (o) != (uint_t)(.01 * RATE)) err = 1;
+  del_aubio_tempo (o);
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+static uint_t check_pitch (void)
+{
+  aubio_pitch_t *o = new_aubio_pitch ("yinfft", WIN_S, HOP_S, RATE);
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (1);
+  uint_t err = 0;
+  smpl_t tolerance;
+  if (!o || !in || !out) return 1;
+  tolerance = aubio_pitch_get_tolerance (o);
+  aubio_pitch_set_deferred (o, 1);
+  aubio_pitch_set_tolerance (o, .3);
+  if (aubio_pitch_set_silence (o, -40.) != 0) err = 1;
+  // checked before being posted
+  if (aubio_pitch_set_silence (o, 10.) == 0) err = 1;
+  if (aubio_pitch_get_tolerance (o) != tolerance
+      || aubio_pitch_get_silence (o) == -40.) err = 1;
+  fill_hop (in, 0);
+  aubio_pitch_do (o, in, out);
+  if (fabs (aubio_pitch_get_tolerance (o) - .3) > 1.e-6
+      || aubio_pitch_get_silence (o) != -40.) err = 1;
+  del_aubio_pitch (o);
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  if (check_onset ()) err = 1;
+  if (check_tempo ()) err = 1;
+  if (check_pitch ()) err = 1;
+  if (err) PRINT_ERR ("deferred parameters were not applied as expected\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,166 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// measure how long after a click its onset is reported, before and after
+// lowering the latency of the detector, in low latency mode, and check the
+// other getters
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define CLICK 22050
+#define N_BLOCKS (20 * SR / HOP)
+
+// mean time between each click and the end of the block reporting its onset,
+// and mean distance between the clicks and the onset times; onsets reported
+// long after a click are counted as wrong
+static uint_t measure (aubio_onset_t *o, uint_t hop, smpl_t noise,
+    smpl_t *lag, smpl_t *offset, uint_t *wrong)
+{
+  fvec_t *in = new_fvec(hop), *out = new_fvec(1);
+  uint_t n, j, count = 0;
+  double sum_lag = 0., sum_offset = 0.;
+  if (!in || !out) return 0;
+  srandom(1);
+  *wrong = 0;
+  for (n = 0; n < N_BLOCKS * HOP / hop; n++) {
+    for (j = 0; j < hop; j++) {
+      // decaying noise bursts, starting 1000 samples into each period
+      double pos = fmod(n * hop + j + CLICK - 1000., CLICK);
+      in->data[j] = (exp(-pos / 2000.) + noise)
+        * (random() % 2001 - 1000) / 1000.;
+    }
+    aubio_onset_do(o, in, out);
+    if (out->data[0] != 0. && n * hop > 2 * CLICK) {
+      double end = (n + 1.) * hop;
+      double click = floor((end - 1000.) / CLICK) * CLICK + 1000.;
+      if (end - click > 3000.) {
+        (*wrong)++;
+        continue;
+      }
+      sum_lag += end - click;
+      sum_offset += aubio_onset_get_last(o) - click;
+      count++;
+    }
+  }
+  if (count) {
+    *lag = sum_lag / count;
+    *offset = sum_offset / count;
+  }
+  del_fvec(in);
+  del_fvec(out);
+  return count;
+}
+
+static uint_t check_onset (void)
+{
+  aubio_onset_t *o = new_aubio_onset("default", WIN, HOP, SR);
+  smpl_t lag = 0., offset = 0., short_lag = 0., short_offset = 0.;
+  uint_t latency, delay, count, wrong, err = 0;
+  if (!o) return 1;
+  latency = aubio_onset_get_latency(o);
+  delay = aubio_onset_get_delay(o);
+  count = measure(o, HOP, 0., &lag, &offset, &wrong);
+  PRINT_MSG("latency %d: %d onsets, lag %.0f, offset %.0f\n", latency, count,
+      lag, offset);
+  if (latency != WIN / 2 + 2 * HOP || count < 15
+      || fabs(lag - latency) > HOP) {
+    PRINT_ERR("onsets are not reported after %d samples\n", latency);
+    err = 1;
+  }
+  // below half the window and one hop
+  if (!aubio_onset_set_latency(o, WIN / 2 + HOP - 1)) err = 1;
+  if (aubio_onset_set_latency(o, WIN / 2 + HOP + HOP / 2)) err = 1;
+  if (aubio_onset_get_latency(o) != WIN / 2 + HOP
+      || aubio_onset_get_delay(o) != delay - HOP) {
+    PRINT_ERR("latency %d and delay %d after lowering the latency\n",
+        aubio_onset_get_latency(o), aubio_onset_get_delay(o));
+    err = 1;
+  }
+  aubio_onset_reset(o);
+  count = measure(o, HOP, 0., &short_lag, &short_offset, &wrong);
+  PRINT_MSG("latency %d: %d onsets, lag %.0f, offset %.0f\n",
+      aubio_onset_get_latency(o), count, short_lag, short_offset);
+  if (count < 15 || fabs(lag - short_lag - HOP) > HOP / 2
+      || fabs(offset - short_offset) > HOP / 2) {
+    PRINT_ERR("onsets are not reported one hop earlier at the same time\n");
+    err = 1;
+  }
+  del_aubio_onset(o);
+  return err;
+}
+
+// a short window, with and without background noise
+static uint_t check_lowlatency (void)
+{
+  aubio_onset_t *o = new_aubio_onset("default", WIN / 2, HOP / 2, SR);
+  smpl_t lag = 0., offset = 0., noise;
+  uint_t delay, count, wrong, err = 0;
+  if (!o) return 1;
+  delay = aubio_onset_get_delay(o);
+  if (aubio_onset_set_lowlatency(o, 1) || !aubio_onset_get_lowlatency(o)
+      || aubio_onset_get_latency(o) != WIN / 8 / 2 + HOP / 2
+      || aubio_onset_get_delay(o) + WIN / 4 + HOP
+        != delay + aubio_onset_get_latency(o)) {
+    PRINT_ERR("low latency mode: latency %d, delay %d\n",
+        aubio_onset_get_latency(o), aubio_onset_get_delay(o));
+    err = 1;
+  }
+  for (noise = 0.; noise < .4; noise += .3) {
+    aubio_onset_reset(o);
+    count = measure(o, HOP / 2, noise, &lag, &offset, &wrong);
+    PRINT_MSG("low latency, noise %.1f: %d onsets, %d wrong, lag %.0f, "
+        "offset %.0f\n", noise, count, wrong, lag, offset);
+    // under 10 ms at 48 kHz
+    if (count < 15 || wrong > 0 || lag > 480. || fabs(offset) > HOP) {
+      err = 1;
+    }
+  }
+  if (aubio_onset_set_lowlatency(o, 0) || aubio_onset_get_delay(o) != delay) {
+    PRINT_ERR("delay not restored after disabling the low latency mode\n");
+    err = 1;
+  }
+  del_aubio_onset(o);
+  return err;
+}
+
+static uint_t check_others (void)
+{
+  aubio_tempo_t *t = new_aubio_tempo("default", WIN, HOP, SR);
+  aubio_notes_t *notes = new_aubio_notes("default", WIN, HOP, SR);
+  aubio_pitch_t *p = new_aubio_pitch("yin", WIN, HOP, SR);
+  aubio_resampler_t *r = new_aubio_resampler(.5, 2);
+  uint_t err = 0;
+  if (!t || !notes || !p) return 1;
+  if (aubio_tempo_get_latency(t) != WIN / 2 + HOP) err = 1;
+  if (!aubio_tempo_set_latency(t, WIN / 2 - 1)) err = 1;
+  if (aubio_tempo_set_latency(t, WIN / 2)
+      || aubio_tempo_get_latency(t) != WIN / 2) err = 1;
+  if (aubio_notes_get_latency(notes) <= WIN / 2 + HOP) err = 1;
+  if (aubio_notes_set_latency(notes, aubio_notes_get_latency(notes) - HOP)
+      || aubio_notes_set_latency(notes, 0) == 0) err = 1;
+  if (aubio_pitch_get_latency(p) != WIN / 2) err = 1;
+  if (aubio_pitch_set_decimation(p, 2) == 0
+      && aubio_pitch_get_latency(p) <= WIN / 2) err = 1;
+  // no latency reported with libsamplerate
+  if (r) {
+    PRINT_MSG("resampler latency %d\n", aubio_resampler_get_latency(r));
+    del_aubio_resampler(r);
+  }
+  del_aubio_tempo(t);
+  del_aubio_notes(notes);
+  del_aubio_pitch(p);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  if (check_onset()) err = 1;
+  if (check_lowlatency()) err = 1;
+  if (check_others()) {
+    PRINT_ERR("wrong latency of tempo, notes or pitch\n");
+    err = 1;
+  }
+  return err;
+}
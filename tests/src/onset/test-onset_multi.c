@@ -0,0 +1,64 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// each channel of aubio_onset_do_multi matches a separate onset object
+int main (void)
+{
+  uint_t i, ch, n, n_channels = 3, n_frames = 200;
+  uint_t win_s = 1024, hop_s = 256, samplerate = 44100;
+  aubio_onset_t *o = new_aubio_onset ("default", win_s, hop_s, samplerate);
+  aubio_onset_t *refs[3];
+  fmat_t *in = new_fmat (n_channels, hop_s);
+  fvec_t *out = new_fvec (n_channels);
+  fvec_t *ref_out = new_fvec (1);
+  fvec_t *short_out = new_fvec (1);
+  fvec_t in_ch;
+
+  if (!o) return 1;
+  for (ch = 0; ch < n_channels; ch++) {
+    refs[ch] = new_aubio_onset ("default", win_s, hop_s, samplerate);
+  }
+
+  utils_init_random();
+  for (n = 0; n < n_frames; n++) {
+    // noise bursts starting at a different frame on each channel
+    for (ch = 0; ch < n_channels; ch++) {
+      smpl_t gain = ((n + 5 * ch) % 17 < 3) ? 1. : 0.01;
+      for (i = 0; i < hop_s; i++) {
+        in->data[ch][i] = gain * (2. * random() / (smpl_t)RAND_MAX - 1.);
+      }
+    }
+    // parameters changed on o apply to all its channels
+    if (n == n_frames / 2) {
+      aubio_onset_set_threshold (o, 0.5);
+      aubio_onset_set_minioi_ms (o, 100.);
+      for (ch = 0; ch < n_channels; ch++) {
+        aubio_onset_set_threshold (refs[ch], 0.5);
+        aubio_onset_set_minioi_ms (refs[ch], 100.);
+      }
+    }
+    aubio_onset_do_multi (o, in, out);
+    for (ch = 0; ch < n_channels; ch++) {
+      fmat_get_channel (in, ch, &in_ch);
+      aubio_onset_do (refs[ch], &in_ch, ref_out);
+      assert(out->data[ch] == ref_out->data[0]);
+    }
+    assert(aubio_onset_get_last (o) == aubio_onset_get_last (refs[0]));
+  }
+
+  // an output shorter than the number of channels is rejected
+  out->data[1] = -1.;
+  aubio_onset_do_multi (o, in, short_out);
+  assert(out->data[1] == -1.);
+
+  for (ch = 0; ch < n_channels; ch++) {
+    del_aubio_onset (refs[ch]);
+  }
+  del_aubio_onset (o);
+  del_fmat (in);
+  del_fvec (out);
+  del_fvec (ref_out);
+  del_fvec (short_out);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// detect the onsets of a file in short chunks, on one and on several
+// threads, and check both find the onsets of a single pass over the file,
+// then pick them again from the stored descriptor with other thresholds
+
+#define MAX_ONSETS 1024
+
+// onsets of a single pass, in seconds, and its number of hops
+static uint_t single_pass (const char_t *uri, const char_t *method,
+    smpl_t threshold, smpl_t *onsets, uint_t *n_hops)
+{
+  uint_t hop_s = 256, read = 0, n = 0;
+  aubio_source_t *s = new_aubio_source (uri, 0, hop_s);
+  aubio_onset_t *o;
+  fvec_t *in = new_fvec (hop_s), *out = new_fvec (1);
+  if (!s || !in || !out) return 0;
+  o = new_aubio_onset (method, 1024, hop_s, aubio_source_get_samplerate (s));
+  if (!o) return 0;
+  if (threshold > 0) aubio_onset_set_threshold (o, threshold);
+  *n_hops = 0;
+  do {
+    aubio_source_do (s, in, &read);
+    (*n_hops)++;
+    aubio_onset_do (o, in, out);
+    if (out->data[0] != 0 && n < MAX_ONSETS) {
+      onsets[n++] = aubio_onset_get_last_s (o);
+    }
+  } while (read == hop_s);
+  del_aubio_onset (o);
+  del_aubio_source (s);
+  del_fvec (in);
+  del_fvec (out);
+  return n;
+}
+
+static uint_t same_onsets (const char_t *method, const fvec_t *onsets,
+    const smpl_t *expected, uint_t n_expected)
+{
+  uint_t i, err = 0;
+  if (onsets->length != n_expected) return 1;
+  for (i = 0; i < n_expected; i++) {
+    if (onsets->data[i] != expected[i]) {
+      PRINT_ERR ("%s: onset %d at %f, expected %f\n", method, i,
+          onsets->data[i], expected[i]);
+      err = 1;
+    }
+  }
+  return err;
+}
+
+// pick the onsets of the last analysis again, with other thresholds
+static uint_t check_pick (const char_t *uri, const char_t *method,
+    aubio_onset_offline_t *o, uint_t n_hops)
+{
+  smpl_t expected[MAX_ONSETS], threshold;
+  uint_t n_expected, err = 0;
+  const fmat_t *desc = aubio_onset_offline_get_descriptor (o);
+  if (desc->height != 2 || desc->length != n_hops) {
+    PRINT_ERR ("%s: %d hops stored, expected %d\n", method, desc->length,
+        n_hops);
+    return 1;
+  }
+  for (threshold = .1; threshold < 1.; threshold += .4) {
+    n_expected = single_pass (uri, method, threshold, expected, &n_hops);
+    aubio_onset_offline_set_threshold (o, threshold);
+    if (aubio_onset_offline_pick (o)) return 1;
+    PRINT_MSG ("%s, threshold %.1f: picked %d onsets, %d in a single pass\n",
+        method, threshold, aubio_onset_offline_get_onsets (o)->length,
+        n_expected);
+    if (same_onsets (method, aubio_onset_offline_get_onsets (o), expected,
+          n_expected)) err = 1;
+  }
+  return err;
+}
+
+static uint_t check_method (const char_t *uri, const char_t *method)
+{
+  smpl_t expected[MAX_ONSETS];
+  uint_t threads, n_expected, n_hops, err = 0;
+  const fvec_t *onsets;
+  aubio_onset_offline_t *o = new_aubio_onset_offline (method, 1024, 256, 0);
+  if (!o) return 1;
+  n_expected = single_pass (uri, method, 0., expected, &n_hops);
+  if (aubio_onset_offline_set_chunk_s (o, .5)
+      || aubio_onset_offline_get_chunk_s (o) != .5) err = 1;
+  for (threads = 1; threads <= 3; threads += 2) {
+    aubio_onset_offline_set_threads (o, threads);
+    if (aubio_onset_offline_get_threads (o) != threads) err = 1;
+    if (aubio_onset_offline_do (o, uri)) {
+      PRINT_ERR ("%s: failed analysing %s\n", method, uri);
+      err = 1;
+      continue;
+    }
+    onsets = aubio_onset_offline_get_onsets (o);
+    PRINT_MSG ("%s, %d threads: %d onsets, %d in a single pass\n", method,
+        threads, onsets->length, n_expected);
+    if (same_onsets (method, onsets, expected, n_expected)) err = 1;
+  }
+  if (check_pick (uri, method, o, n_hops)) err = 1;
+  del_aubio_onset_offline (o);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t err = 0;
+  aubio_onset_offline_t *o;
+  if (argc < 2) {
+    PRINT_ERR ("not enough arguments, running tests\n");
+    return run_on_default_source (main);
+  }
+  if (check_method (argv[1], "default")) err = 1;
+  if (check_method (argv[1], "specdiff")) err = 1;
+
+  // wrong parameters
+  if (new_aubio_onset_offline ("default", 256, 1024, 0)) err = 1;
+  o = new_aubio_onset_offline ("default", 1024, 256, 0);
+  if (!o) return 1;
+  if (!aubio_onset_offline_set_chunk_s (o, 0.)) err = 1;
+  if (!aubio_onset_offline_set_minioi_s (o, -1.)) err = 1;
+  if (!aubio_onset_offline_do (o, "/this/file/does/not/exist")) err = 1;
+  if (aubio_onset_offline_get_onsets (o)->length != 0) err = 1;
+  if (aubio_onset_offline_get_descriptor (o)->height != 0) err = 1;
+  if (aubio_onset_offline_pick (o)) err = 1;
+  del_aubio_onset_offline (o);
+  return err;
+}
@@ -0,0 +1,86 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// each variant of aubio_onset_do_variants matches a separate onset object
+// with its threshold and minimum inter-onset interval
+
+#define N_VARIANTS 4
+
+static uint_t check (const char_t *method, uint_t lowlatency)
+{
+  uint_t i, v, n, n_frames = 300, n_onsets = 0;
+  uint_t win_s = 1024, hop_s = 256, samplerate = 44100;
+  smpl_t thresholds[N_VARIANTS] = { 0.01, 0.1, 0.5, 2. };
+  uint_t minioi[N_VARIANTS] = { 0, 2048, 11025, 4410 };
+  aubio_onset_t *o = new_aubio_onset (method, win_s, hop_s, samplerate);
+  aubio_onset_t *refs[N_VARIANTS];
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *out = new_fvec (N_VARIANTS + 1);
+  fvec_t *ref_out = new_fvec (1);
+  fvec_t *short_out = new_fvec (N_VARIANTS);
+
+  if (!o || !in || !out || !ref_out || !short_out) return 1;
+  aubio_onset_set_lowlatency (o, lowlatency);
+  // the silent hops are not analysed, but still go through the variants
+  aubio_onset_set_gating (o, 1);
+  for (v = 0; v < N_VARIANTS; v++) {
+    refs[v] = aubio_onset_clone (o);
+    if (!refs[v]) return 1;
+    aubio_onset_set_threshold (refs[v], thresholds[v]);
+    aubio_onset_set_minioi (refs[v], minioi[v]);
+    if (aubio_onset_add_variant (o, thresholds[v], minioi[v]) != 0) return 1;
+  }
+  if (aubio_onset_get_n_variants (o) != N_VARIANTS) return 1;
+
+  utils_init_random();
+  for (n = 0; n < n_frames; n++) {
+    // noise bursts of various levels, and some silence
+    smpl_t gain = (n % 23 < 3) ? 1. : (n % 11 < 2) ? .2 : .01;
+    if (n > 200 && n < 230) gain = 0.;
+    for (i = 0; i < hop_s; i++) {
+      in->data[i] = gain * (2. * random() / (smpl_t)RAND_MAX - 1.);
+    }
+    aubio_onset_do_variants (o, in, out);
+    for (v = 0; v < N_VARIANTS; v++) {
+      aubio_onset_do (refs[v], in, ref_out);
+      // the thresholds are applied in another order, allow for rounding
+      if ((out->data[v + 1] > 0.) != (ref_out->data[0] > 0.)
+          || fabs (out->data[v + 1] - ref_out->data[0]) > 1.e-3
+          || aubio_onset_get_variant_last (o, v)
+          != aubio_onset_get_last (refs[v])) {
+        PRINT_ERR ("%s: variant %d differs at frame %d, %f != %f\n", method,
+            v, n, out->data[v + 1], ref_out->data[0]);
+        return 1;
+      }
+      if (out->data[v + 1] > 0.) n_onsets++;
+    }
+  }
+  PRINT_MSG ("%s%s: %d onsets in all the variants\n", method,
+      lowlatency ? " (low latency)" : "", n_onsets);
+
+  // an output too short for the variants is rejected
+  short_out->data[0] = -1.;
+  aubio_onset_do_variants (o, in, short_out);
+  if (short_out->data[0] != -1.) return 1;
+  if (aubio_onset_get_variant_last (o, N_VARIANTS) != 0) return 1;
+
+  for (v = 0; v < N_VARIANTS; v++) {
+    del_aubio_onset (refs[v]);
+  }
+  del_aubio_onset (o);
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (ref_out);
+  del_fvec (short_out);
+  return n_onsets == 0;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  err |= check ("default", 0);
+  err |= check ("specflux", 0);
+  err |= check ("hfc", 1);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,70 @@
+#define AUBIO_UNSTABLE 1
+
+#include <aubio.h>
+#include "utils_tests.h"
+
+// check the running median and mean of the incremental mode against a full
+// computation on the same causally smoothed window
+static int check_window (uint_t win_pre, uint_t win_post)
+{
+  uint_t i, j, n_hops = 2000, length = win_pre + win_post + 1;
+  smpl_t threshold = 0.3;
+  fvec_t *in = new_fvec (1);
+  fvec_t *out = new_fvec (1);
+  fvec_t *smoothed = new_fvec (1);
+  fvec_t *window = new_fvec (length);
+  fvec_t *scratch = new_fvec (length);
+  aubio_peakpicker_t *o = new_aubio_peakpicker ();
+  aubio_filter_t *f = new_aubio_filter_biquad (0.15998789, 0.31997577,
+      0.15998789, 0.23484048, 0);
+
+  assert(o && f);
+  assert(aubio_peakpicker_set_window (o, win_pre, win_post) == 0);
+  assert(aubio_peakpicker_get_win_pre (o) == win_pre);
+  assert(aubio_peakpicker_get_win_post (o) == win_post);
+  assert(aubio_peakpicker_set_incremental (o, 1) == 0);
+  assert(aubio_peakpicker_get_incremental (o) == 1);
+  aubio_peakpicker_set_threshold (o, threshold);
+
+  for (i = 0; i < n_hops; i++) {
+    smpl_t expected, mean, median;
+    // random values with repetitions, and long runs of zeros
+    in->data[0] = (i % 300 < 100) ? 0. : (smpl_t)(random() % 16) / 4.;
+    aubio_peakpicker_do (o, in, out);
+
+    smoothed->data[0] = in->data[0];
+    aubio_filter_do (f, smoothed);
+    fvec_push (window, smoothed->data[0]);
+    mean = fvec_mean (window);
+    fvec_copy (window, scratch);
+    median = fvec_median (scratch);
+    expected = window->data[win_post] - median - mean * threshold;
+    assert(fabs(aubio_peakpicker_get_thresholded_input (o)->data[0]
+          - expected) < 1.e-4);
+  }
+
+  // back to the default mode
+  assert(aubio_peakpicker_set_incremental (o, 0) == 0);
+  for (j = 0; j < 10; j++) {
+    aubio_peakpicker_do (o, in, out);
+  }
+
+  del_aubio_peakpicker (o);
+  del_aubio_filter (f);
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (smoothed);
+  del_fvec (window);
+  del_fvec (scratch);
+  return 0;
+}
+
+int main (void)
+{
+  utils_init_random ();
+  check_window (1, 5);
+  check_window (0, 0);
+  check_window (2, 5);
+  check_window (10, 100);
+  return 0;
+}
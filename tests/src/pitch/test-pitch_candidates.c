@@ -0,0 +1,72 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// analyse a 220Hz tone with each yin variant and check the first candidate
+// is close to the pitch returned by aubio_pitch_do
+
+static uint_t check_method (const char_t *method)
+{
+  uint_t n, i, n_cand = 0, win_s = 2048, hop_s = 512, samplerate = 44100;
+  smpl_t freq = 220., pitch;
+  fvec_t *input = new_fvec (hop_s);
+  fvec_t *out = new_fvec (1);
+  fmat_t *candidates = new_fmat (2, 5);
+  aubio_pitch_t *o = new_aubio_pitch (method, win_s, hop_s, samplerate);
+  uint_t err = 0;
+  if (!o) return 1;
+  for (n = 0; n < 10; n++) {
+    for (i = 0; i < hop_s; i++) {
+      input->data[i] = .5 * sin (2. * M_PI * freq * (n * hop_s + i) / samplerate)
+        + .3 * sin (4. * M_PI * freq * (n * hop_s + i) / samplerate);
+    }
+    aubio_pitch_do (o, input, out);
+  }
+  pitch = out->data[0];
+  n_cand = aubio_pitch_get_candidates (o, candidates);
+  PRINT_MSG("%s: pitch %.3f, %d candidates\n", method, pitch, n_cand);
+  for (i = 0; i < n_cand; i++) {
+    PRINT_MSG("  %.3f (%.3f)\n", candidates->data[0][i],
+        candidates->data[1][i]);
+    if (i > 0 && candidates->data[1][i] > candidates->data[1][i - 1]) err = 1;
+    if (candidates->data[1][i] < 0. || candidates->data[1][i] > 1.) err = 1;
+  }
+  if (n_cand < 1 || n_cand > 5) err = 1;
+  else if (fabs (candidates->data[0][0] - freq) > 2.) err = 1;
+  if (fabs (pitch - freq) > 2.) err = 1;
+
+  // in midi too
+  aubio_pitch_set_unit (o, "midi");
+  if (aubio_pitch_get_candidates (o, candidates) != n_cand) err = 1;
+  else if (fabs (candidates->data[0][0] - 57.) > .1) err = 1;
+
+  del_aubio_pitch (o);
+  del_fmat (candidates);
+  del_fvec (out);
+  del_fvec (input);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_pitch_t *o;
+  fmat_t *candidates;
+  err |= check_method ("yin");
+  err |= check_method ("yinfast");
+  err |= check_method ("yinfft");
+
+  // no candidates for other methods, and a single row is too small
+  o = new_aubio_pitch ("mcomb", 2048, 512, 44100);
+  candidates = new_fmat (2, 5);
+  if (aubio_pitch_get_candidates (o, candidates) != 0) err = 1;
+  del_aubio_pitch (o);
+  del_fmat (candidates);
+  o = new_aubio_pitch ("yin", 2048, 512, 44100);
+  candidates = new_fmat (1, 5);
+  if (aubio_pitch_get_candidates (o, candidates) != 0) err = 1;
+  del_aubio_pitch (o);
+  del_fmat (candidates);
+
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,90 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// a clone finds the pitches of an object created with the same parameters,
+// and a reconfigured object those of a new object of the same method and
+// sizes
+
+// a sine sweeping from 200 to 800 Hz over n_frames hops, with some noise
+static void sweep (fvec_t *in, uint_t n, uint_t n_frames, uint_t samplerate,
+    smpl_t *phase)
+{
+  uint_t i;
+  smpl_t freq = 200. + 600. * n / n_frames;
+  for (i = 0; i < in->length; i++) {
+    *phase += 2. * M_PI * freq / samplerate;
+    in->data[i] = .5 * sin (*phase)
+      + .01 * (2. * random() / (smpl_t)RAND_MAX - 1.);
+  }
+}
+
+// run a and b on the same n_frames hops, check their pitches match
+static void check_same (aubio_pitch_t *a, aubio_pitch_t *b, uint_t hop_s,
+    uint_t samplerate, uint_t n_frames)
+{
+  uint_t n;
+  smpl_t phase = 0.;
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *a_out = new_fvec (1), *b_out = new_fvec (1);
+  for (n = 0; n < n_frames; n++) {
+    sweep (in, n, n_frames, samplerate, &phase);
+    aubio_pitch_do (a, in, a_out);
+    aubio_pitch_do (b, in, b_out);
+    assert(a_out->data[0] == b_out->data[0]);
+    assert(aubio_pitch_get_confidence (a) == aubio_pitch_get_confidence (b));
+  }
+  del_fvec (in);
+  del_fvec (a_out);
+  del_fvec (b_out);
+}
+
+static void set_parameters (aubio_pitch_t *o)
+{
+  aubio_pitch_set_unit (o, "midi");
+  aubio_pitch_set_tolerance (o, 0.2);
+  aubio_pitch_set_silence (o, -60.);
+  aubio_pitch_set_tracking (o, 1.);
+}
+
+int main (void)
+{
+  uint_t samplerate = 44100, n_frames = 200;
+  aubio_pitch_t *o = new_aubio_pitch ("yin", 2048, 512, samplerate);
+  aubio_pitch_t *ref = new_aubio_pitch ("yin", 2048, 512, samplerate);
+  aubio_pitch_t *c;
+
+  if (!o || !ref) return 1;
+  utils_init_random();
+  set_parameters (o);
+  set_parameters (ref);
+  check_same (o, ref, 512, samplerate, n_frames);
+
+  // the clone has the parameters of o, and starts from a new state
+  c = aubio_pitch_clone (o);
+  assert(c);
+  assert(aubio_pitch_get_tolerance (c) == aubio_pitch_get_tolerance (o));
+  assert(aubio_pitch_get_tracking (c) == aubio_pitch_get_tracking (o));
+  del_aubio_pitch (ref);
+  ref = new_aubio_pitch ("yin", 2048, 512, samplerate);
+  set_parameters (ref);
+  check_same (c, ref, 512, samplerate, n_frames);
+  del_aubio_pitch (c);
+  del_aubio_pitch (ref);
+
+  // a reconfigured object is a new one, with the default parameters
+  assert(aubio_pitch_reconfigure (o, "yinfft", 1024, 256) == 0);
+  ref = new_aubio_pitch ("yinfft", 1024, 256, samplerate);
+  assert(aubio_pitch_get_tolerance (o) == aubio_pitch_get_tolerance (ref));
+  assert(aubio_pitch_get_tracking (o) == 0.);
+  check_same (o, ref, 256, samplerate, n_frames);
+
+  // a failed reconfiguration leaves the object unchanged
+  assert(aubio_pitch_reconfigure (o, "unknown", 1024, 256) != 0);
+  assert(aubio_pitch_reconfigure (o, "yin", 256, 1024) != 0);
+  check_same (o, ref, 256, samplerate, n_frames);
+
+  del_aubio_pitch (o);
+  del_aubio_pitch (ref);
+  aubio_cleanup ();
+  return 0;
+}
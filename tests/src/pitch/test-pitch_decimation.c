@@ -0,0 +1,64 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// track a low tone at full rate and decimated, and check both agree
+
+static smpl_t run_pitch (const char_t *method, uint_t factor, smpl_t freq)
+{
+  uint_t n, i, win_s = 4096, hop_s = 512, samplerate = 48000;
+  smpl_t pitch = 0.;
+  fvec_t *input = new_fvec (hop_s);
+  fvec_t *out = new_fvec (1);
+  aubio_pitch_t *o = new_aubio_pitch (method, win_s, hop_s, samplerate);
+  if (!o || aubio_pitch_set_decimation (o, factor)) return -1.;
+  for (n = 0; n < 20; n++) {
+    for (i = 0; i < hop_s; i++) {
+      smpl_t t = (smpl_t)(n * hop_s + i) / samplerate;
+      input->data[i] = .5 * sin (2. * M_PI * freq * t)
+        + .2 * sin (6. * M_PI * freq * t);
+    }
+    aubio_pitch_do (o, input, out);
+  }
+  pitch = out->data[0];
+  del_aubio_pitch (o);
+  del_fvec (out);
+  del_fvec (input);
+  return pitch;
+}
+
+int main (void)
+{
+  uint_t err = 0, m, factor;
+  const char_t *methods[] = { "yin", "yinfast", "yinfft" };
+  smpl_t freq = 61.7, full, dec;
+  aubio_pitch_t *o;
+
+  for (m = 0; m < 3; m++) {
+    full = run_pitch (methods[m], 1, freq);
+    for (factor = 2; factor <= 4; factor *= 2) {
+      dec = run_pitch (methods[m], factor, freq);
+      PRINT_MSG ("%s: full rate %.4f, decimated by %d %.4f\n", methods[m],
+          full, factor, dec);
+      if (fabs (full - freq) > 1. || fabs (dec - full) > .1) err = 1;
+    }
+  }
+
+  o = new_aubio_pitch ("yin", 4096, 512, 48000);
+  if (aubio_pitch_get_decimation (o) != 1) err = 1;
+  if (aubio_pitch_set_decimation (o, 3) == 0) err = 1; // 512 % 3 != 0
+  if (aubio_pitch_set_decimation (o, 5) == 0) err = 1;
+  if (aubio_pitch_set_decimation (o, 0) == 0) err = 1;
+  aubio_pitch_set_tolerance (o, .2);
+  if (aubio_pitch_set_decimation (o, 4)) err = 1;
+  if (aubio_pitch_get_decimation (o) != 4) err = 1;
+  if (aubio_pitch_get_tolerance (o) != (smpl_t).2) err = 1;
+  if (aubio_pitch_set_decimation (o, 1)) err = 1;
+  del_aubio_pitch (o);
+
+  o = new_aubio_pitch ("mcomb", 4096, 512, 48000);
+  if (aubio_pitch_set_decimation (o, 2) == 0) err = 1;
+  del_aubio_pitch (o);
+
+  aubio_cleanup ();
+  return err;
+}
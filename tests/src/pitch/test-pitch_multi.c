@@ -0,0 +1,61 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// each channel of aubio_pitch_do_multi matches a separate pitch object
+int main (void)
+{
+  uint_t i, ch, n, n_channels = 3, n_frames = 50;
+  uint_t win_s = 2048, hop_s = 512, samplerate = 44100;
+  smpl_t freqs[3] = { 220., 330., 440. };
+  uint_t t = 0;
+  aubio_pitch_t *o = new_aubio_pitch ("yinfft", win_s, hop_s, samplerate);
+  aubio_pitch_t *refs[3];
+  fmat_t *in = new_fmat (n_channels, hop_s);
+  fvec_t *out = new_fvec (n_channels);
+  fvec_t *ref_out = new_fvec (1);
+  fvec_t in_ch;
+
+  if (!o) return 1;
+  for (ch = 0; ch < n_channels; ch++) {
+    refs[ch] = new_aubio_pitch ("yinfft", win_s, hop_s, samplerate);
+  }
+
+  for (n = 0; n < n_frames; n++) {
+    for (ch = 0; ch < n_channels; ch++) {
+      for (i = 0; i < hop_s; i++) {
+        in->data[ch][i] = 0.5 * sin(2. * M_PI * freqs[ch] * (t + i)
+            / samplerate);
+      }
+    }
+    t += hop_s;
+    // the unit and tolerance of o apply to all its channels
+    if (n == n_frames / 2) {
+      aubio_pitch_set_unit (o, "midi");
+      aubio_pitch_set_tolerance (o, 0.7);
+      for (ch = 0; ch < n_channels; ch++) {
+        aubio_pitch_set_unit (refs[ch], "midi");
+        aubio_pitch_set_tolerance (refs[ch], 0.7);
+      }
+    }
+    aubio_pitch_do_multi (o, in, out);
+    for (ch = 0; ch < n_channels; ch++) {
+      fmat_get_channel (in, ch, &in_ch);
+      aubio_pitch_do (refs[ch], &in_ch, ref_out);
+      assert(out->data[ch] == ref_out->data[0]);
+    }
+  }
+  // the last frames detected the frequency of each channel
+  for (ch = 0; ch < n_channels; ch++) {
+    assert(fabs(out->data[ch] - aubio_freqtomidi(freqs[ch])) < 0.5);
+  }
+
+  for (ch = 0; ch < n_channels; ch++) {
+    del_aubio_pitch (refs[ch]);
+  }
+  del_aubio_pitch (o);
+  del_fmat (in);
+  del_fvec (out);
+  del_fvec (ref_out);
+  aubio_cleanup ();
+  return 0;
+}
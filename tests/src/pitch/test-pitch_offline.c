@@ -0,0 +1,152 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// extract the pitch track and the notes of a file in short chunks, on one
+// and on several threads, and compare them to those of a single pass
+
+#define MAX_ROWS 4096
+#define HOP_S 256
+#define MELODY "tmp_aubio_pitch_offline.wav"
+
+// write a melody of decaying tones, 40 notes of .3s each
+static uint_t write_melody (const char_t *path)
+{
+  uint_t samplerate = 22050, note_len = 6615, n, j, i;
+  aubio_sink_t *s = new_aubio_sink (path, samplerate);
+  fvec_t *vec = new_fvec (HOP_S);
+  smpl_t freq;
+  if (!s || !vec) return 1;
+  for (n = 0; n < 40 * note_len / HOP_S; n++) {
+    for (j = 0; j < HOP_S; j++) {
+      i = n * HOP_S + j;
+      freq = 220. * pow (2., ((i / note_len) * 7 % 19) / 12.);
+      vec->data[j] = .5 * exp (-4. * (i % note_len) / note_len)
+        * sin (2. * M_PI * freq * (i % note_len) / samplerate);
+    }
+    aubio_sink_do (s, vec, HOP_S);
+  }
+  del_aubio_sink (s);
+  del_fvec (vec);
+  return 0;
+}
+
+// rows of a single pass, as returned by aubio_pitch_offline_get_results
+static uint_t single_pass (const char_t *uri, const char_t *analysis,
+    const char_t *method, smpl_t rows[][4])
+{
+  uint_t read = 0, total = 0, n = 0, samplerate;
+  sint_t note = -1;
+  aubio_source_t *s = new_aubio_source (uri, 0, HOP_S);
+  aubio_pitch_t *pitch = NULL;
+  aubio_notes_t *notes = NULL;
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (3);
+  if (!s || !in || !out) return 0;
+  samplerate = aubio_source_get_samplerate (s);
+  if (strcmp (analysis, "notes") == 0) {
+    notes = new_aubio_notes (method, 1024, HOP_S, samplerate);
+    if (!notes) return 0;
+  } else {
+    pitch = new_aubio_pitch (method, 1024, HOP_S, samplerate);
+    if (!pitch) return 0;
+  }
+  do {
+    aubio_source_do (s, in, &read);
+    if (notes) {
+      aubio_notes_do (notes, in, out);
+      if (out->data[2] != 0 && note >= 0) {
+        rows[note][3] = total / (smpl_t)samplerate;
+        note = -1;
+      }
+      if (out->data[0] != 0 && n < MAX_ROWS) {
+        rows[n][0] = out->data[0];
+        rows[n][1] = out->data[1];
+        rows[n][2] = rows[n][3] = total / (smpl_t)samplerate;
+        note = n++;
+      }
+    } else if (n < MAX_ROWS) {
+      aubio_pitch_do (pitch, in, out);
+      rows[n][0] = total / (smpl_t)samplerate;
+      rows[n][1] = out->data[0];
+      rows[n][2] = aubio_pitch_get_confidence (pitch);
+      n++;
+    }
+    total += read;
+  } while (read == HOP_S);
+  if (note >= 0) rows[note][3] = total / (smpl_t)samplerate;
+  if (pitch) del_aubio_pitch (pitch);
+  if (notes) del_aubio_notes (notes);
+  del_aubio_source (s);
+  del_fvec (in);
+  del_fvec (out);
+  return n;
+}
+
+static uint_t check_method (const char_t *uri, const char_t *analysis,
+    const char_t *method)
+{
+  static smpl_t expected[MAX_ROWS][4];
+  uint_t i, j, threads, n_expected, err = 0;
+  const fmat_t *results;
+  aubio_pitch_offline_t *o = new_aubio_pitch_offline (analysis, method, 1024,
+      HOP_S, 0);
+  if (!o) return 1;
+  n_expected = single_pass (uri, analysis, method, expected);
+  if (aubio_pitch_offline_set_chunk_s (o, .5)
+      || aubio_pitch_offline_get_chunk_s (o) != .5) err = 1;
+  for (threads = 1; threads <= 3; threads += 2) {
+    aubio_pitch_offline_set_threads (o, threads);
+    if (aubio_pitch_offline_get_threads (o) != threads) err = 1;
+    if (aubio_pitch_offline_do (o, uri)) {
+      PRINT_ERR ("%s %s: failed analysing %s\n", analysis, method, uri);
+      err = 1;
+      continue;
+    }
+    results = aubio_pitch_offline_get_results (o);
+    PRINT_MSG ("%s %s, %d threads: %d rows, %d in a single pass\n", analysis,
+        method, threads, results->height, n_expected);
+    if (results->height != n_expected) {
+      err = 1;
+      continue;
+    }
+    for (i = 0; i < n_expected; i++) {
+      for (j = 0; j < results->length; j++) {
+        if (results->data[i][j] != expected[i][j]) {
+          PRINT_ERR ("%s %s: row %d, value %d is %f, expected %f\n", analysis,
+              method, i, j, results->data[i][j], expected[i][j]);
+          err = 1;
+        }
+      }
+    }
+  }
+  del_aubio_pitch_offline (o);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t err = 0;
+  aubio_pitch_offline_t *o;
+  if (argc < 2) {
+    PRINT_ERR ("not enough arguments, running tests\n");
+    return run_on_default_source (main);
+  }
+  if (check_method (argv[1], "pitch", "yinfft")) err = 1;
+  if (check_method (argv[1], "pitch", "yin")) err = 1;
+  if (check_method (argv[1], "notes", "default")) err = 1;
+  if (write_melody (MELODY)) return 1;
+  if (check_method (MELODY, "pitch", "yinfast")) err = 1;
+  if (check_method (MELODY, "notes", "default")) err = 1;
+  remove (MELODY);
+
+  // wrong parameters
+  if (new_aubio_pitch_offline ("tempo", "default", 1024, 256, 0)) err = 1;
+  if (new_aubio_pitch_offline ("pitch", "default", 256, 1024, 0)) err = 1;
+  o = new_aubio_pitch_offline ("notes", "default", 1024, 256, 0);
+  if (!o) return 1;
+  if (!aubio_pitch_offline_set_chunk_s (o, 0.)) err = 1;
+  if (!aubio_pitch_offline_set_tolerance (o, .2)) err = 1;
+  if (!aubio_pitch_offline_do (o, "/this/file/does/not/exist")) err = 1;
+  if (aubio_pitch_offline_get_results (o)->height != 0) err = 1;
+  del_aubio_pitch_offline (o);
+  return err;
+}
@@ -0,0 +1,62 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// follow a noisy tone rising by semitones, with and without the tracker, and
+// count the frames off by more than half a semitone
+
+static uint_t count_errors (const char_t *method, smpl_t cost, smpl_t noise,
+    uint_t seed)
+{
+  uint_t n, i, win_s = 1024, hop_s = 256, samplerate = 44100, errors = 0;
+  smpl_t freq, t, midi;
+  fvec_t *input = new_fvec (hop_s);
+  fvec_t *out = new_fvec (1);
+  aubio_pitch_t *o = new_aubio_pitch (method, win_s, hop_s, samplerate);
+  if (aubio_pitch_set_tracking (o, cost)) return win_s;
+  if (aubio_pitch_get_tracking (o) != cost) return win_s;
+  aubio_pitch_set_unit (o, "midi");
+  srandom (seed);
+  for (n = 0; n < 500; n++) {
+    midi = 57. + n / 100;
+    freq = aubio_miditofreq (midi);
+    for (i = 0; i < hop_s; i++) {
+      t = (smpl_t)(n * hop_s + i) / samplerate;
+      input->data[i] = .3 * sin (2. * M_PI * freq * t)
+        + .2 * sin (4. * M_PI * freq * t) + .1 * sin (6. * M_PI * freq * t)
+        + noise * ((smpl_t)random () / RAND_MAX - .5);
+    }
+    aubio_pitch_do (o, input, out);
+    // skip the first frames after each change
+    if (n % 100 > 4 && fabs (out->data[0] - midi) > .5) errors++;
+  }
+  del_aubio_pitch (o);
+  del_fvec (out);
+  del_fvec (input);
+  return errors;
+}
+
+int main (void)
+{
+  uint_t err = 0, seed = 1, untracked, tracked;
+  aubio_pitch_t *o;
+
+  untracked = count_errors ("yinfft", 0., 1., seed);
+  tracked = count_errors ("yinfft", .05, 1., seed);
+  PRINT_MSG ("yinfft: %d errors, %d when tracked\n", untracked, tracked);
+  if (tracked > untracked) err = 1;
+
+  // a clean tone is tracked without errors
+  if (count_errors ("yin", .05, .2, seed) != 0) err = 1;
+  if (count_errors ("yinfast", .05, .2, seed) != 0) err = 1;
+
+  o = new_aubio_pitch ("mcomb", 1024, 256, 44100);
+  if (aubio_pitch_set_tracking (o, .05) == 0) err = 1;
+  if (aubio_pitch_set_tracking (o, 0.)) err = 1;
+  del_aubio_pitch (o);
+  o = new_aubio_pitch ("yin", 1024, 256, 44100);
+  if (aubio_pitch_set_tracking (o, -1.) == 0) err = 1;
+  del_aubio_pitch (o);
+
+  aubio_cleanup ();
+  return err;
+}
@@ -4,10 +4,11 @@
 // see src/pitch/pitch.h and tests/src/pitch/test-pitch.c
 
 #include <aubio.h>
+#include "utils_tests.h"
 
 int main (void)
 {
-  uint_t i = 0;
+  uint_t i = 0, j;
   uint_t win_s = 1024; // window size
   uint_t hop_s = win_s/4; // hop size
   // create some vectors
@@ -24,6 +25,44 @@ int main (void)
   del_aubio_pitchfcomb(o);
   del_fvec(out);
   del_fvec(in);
+
+  // the spectrum of a phase vocoder with the same window gives the same
+  // candidates as the spectrum computed by the object itself
+  {
+    fvec_t * buf = new_fvec (win_s); // sliding input buffer
+    fvec_t * ref = new_fvec (1);
+    cvec_t * fftgrain = new_cvec (win_s);
+    aubio_pvoc_t * pv = new_aubio_pvoc (win_s, hop_s);
+    aubio_pitchfcomb_t * p = new_aubio_pitchfcomb (win_s, hop_s);
+    in = new_fvec (hop_s);
+    out = new_fvec (1);
+    o = new_aubio_pitchfcomb (win_s, hop_s);
+    aubio_pvoc_set_window (pv, "hanning");
+    for (i = 0; i < 20; i++) {
+      for (j = 0; j < hop_s; j++) {
+        in->data[j] = sin (2. * M_PI * 440. * (i * hop_s + j) / 44100.);
+      }
+      for (j = 0; j < win_s - hop_s; j++) {
+        buf->data[j] = buf->data[j + hop_s];
+      }
+      for (j = 0; j < hop_s; j++) {
+        buf->data[win_s - hop_s + j] = in->data[j];
+      }
+      aubio_pitchfcomb_do (o, buf, ref);
+      aubio_pvoc_do (pv, in, fftgrain);
+      aubio_pitchfcomb_do_spectrum (p, fftgrain, out);
+      if (i > 4 && fabs (out->data[0] - ref->data[0]) > 1.e-3) return 1;
+    }
+    PRINT_MSG("last candidate: %.3f bins\n", out->data[0]);
+    del_aubio_pitchfcomb (p);
+    del_aubio_pitchfcomb (o);
+    del_aubio_pvoc (pv);
+    del_cvec (fftgrain);
+    del_fvec (ref);
+    del_fvec (buf);
+    del_fvec (out);
+    del_fvec (in);
+  }
   aubio_cleanup();
   return 0;
 }
@@ -4,6 +4,7 @@
 // see src/pitch/pitch.h and tests/src/pitch/test-pitch.c
 
 #include <aubio.h>
+#include "utils_tests.h"
 
 int main (void)
 {
@@ -22,6 +23,30 @@ int main (void)
   del_aubio_pitchschmitt(o);
   del_fvec(in);
   del_fvec(out);
+
+  // stream a tone in short hops, the period of each complete block is held
+  // until the next one
+  {
+    uint_t i, j, hop_s = 100;
+    smpl_t period = 44100. / 441.;
+    in = new_fvec (hop_s);
+    out = new_fvec (1);
+    o = new_aubio_pitchschmitt(win_s);
+    for (i = 0; i < 50; i++) {
+      for (j = 0; j < hop_s; j++) {
+        in->data[j] = .8 * sin (2. * M_PI * (i * hop_s + j) / period);
+      }
+      aubio_pitchschmitt_do (o, in, out);
+      // no block is complete yet
+      if ((i + 1) * hop_s < win_s && out->data[0] != 0.) return 1;
+      if ((i + 1) * hop_s >= win_s && fabs (out->data[0] - period) > 1.)
+        return 1;
+    }
+    PRINT_MSG("period %.3f, expected %.3f\n", out->data[0], period);
+    del_aubio_pitchschmitt(o);
+    del_fvec(in);
+    del_fvec(out);
+  }
   aubio_cleanup();
 
   return 0;
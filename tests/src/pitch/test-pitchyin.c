@@ -4,6 +4,57 @@
 // see src/pitch/pitch.h and tests/src/pitch/test-pitch.c
 
 #include <aubio.h>
+#include "utils_tests.h"
+
+// plain yin, with the difference function computed one lag at a time
+static smpl_t reference_yin (const fvec_t *input, fvec_t *yin, smpl_t tol)
+{
+  uint_t j, tau, length = yin->length;
+  smpl_t tmp, cum = 0.;
+  yin->data[0] = 1.;
+  for (tau = 1; tau < length; tau++) {
+    yin->data[tau] = 0.;
+    for (j = 0; j < length; j++) {
+      tmp = input->data[j] - input->data[j + tau];
+      yin->data[tau] += tmp * tmp;
+    }
+    cum += yin->data[tau];
+    yin->data[tau] = cum != 0 ? yin->data[tau] * tau / cum : 1.;
+    if (tau > 4 && yin->data[tau - 3] < tol
+        && yin->data[tau - 3] < yin->data[tau - 2]) {
+      return fvec_quadratic_peak_pos (yin, tau - 3);
+    }
+  }
+  return fvec_quadratic_peak_pos (yin, fvec_min_elem (yin));
+}
+
+// compare with the reference on signals stopping early, or not at all
+static int check_yin (uint_t win_s)
+{
+  uint_t i, k, err = 0;
+  fvec_t *in = new_fvec (win_s);
+  fvec_t *out = new_fvec (1);
+  fvec_t *yin = new_fvec (win_s / 2);
+  aubio_pitchyin_t *p = new_aubio_pitchyin (win_s);
+  for (k = 0; k < 3; k++) {
+    smpl_t expected;
+    for (i = 0; i < win_s; i++) {
+      in->data[i] = k == 2 ? (smpl_t)((i * 7919) % 13) / 13. - 0.5
+        : sin (2. * M_PI * i * (k ? 97.3 : 440.) / 44100.);
+    }
+    aubio_pitchyin_do (p, in, out);
+    expected = reference_yin (in, yin, aubio_pitchyin_get_tolerance (p));
+    if (fabs (out->data[0] - expected) > 1.e-2) {
+      PRINT_ERR("yin %d: got %f, expected %f\n", k, out->data[0], expected);
+      err = 1;
+    }
+  }
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (yin);
+  del_aubio_pitchyin (p);
+  return err;
+}
 
 int main (void)
 {
@@ -20,6 +71,7 @@ int main (void)
   };
 
   fvec_print(output_cands);
+  if (check_yin (1023) || check_yin (2048)) return 1;
 
   del_fvec(input_signal);
   del_fvec(output_cands);
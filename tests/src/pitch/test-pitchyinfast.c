@@ -0,0 +1,50 @@
+#define AUBIO_UNSTABLE 1
+
+// this file uses the unstable aubio api, please use aubio_pitch instead
+// see src/pitch/pitch.h and tests/src/pitch/test-pitch.c
+
+#include <aubio.h>
+#include "utils_tests.h"
+
+// slide a tone by half a window, so that the spectrum of the second half of
+// each frame gets reused, and compare with an object analysing each frame
+// from scratch
+
+int main (void)
+{
+  uint_t n, i, err = 0;
+  uint_t win_s = 1024; // window size
+  uint_t hop_s = win_s / 2; // hop size
+  smpl_t freq = 440.;
+  // create some vectors
+  fvec_t * in = new_fvec (win_s); // input buffer
+  fvec_t * out = new_fvec (1); // output candidates
+  fvec_t * ref = new_fvec (1); // output of the reference object
+  // create pitch objects
+  aubio_pitchyinfast_t *p = new_aubio_pitchyinfast(win_s);
+  aubio_pitchyinfast_t *q;
+  aubio_pitchyinfast_set_tolerance (p, 0.2);
+
+  for (n = 0; n < 10; n++) {
+    for (i = 0; i < win_s; i++) {
+      in->data[i] = sin (2. * M_PI * freq * (n * hop_s + i) / 44100.)
+        + .3 * sin (4. * M_PI * freq * (n * hop_s + i) / 44100.);
+    }
+    aubio_pitchyinfast_do (p, in, out);
+    q = new_aubio_pitchyinfast(win_s);
+    aubio_pitchyinfast_set_tolerance (q, 0.2);
+    aubio_pitchyinfast_do (q, in, ref);
+    del_aubio_pitchyinfast(q);
+    if (fabs (out->data[0] - ref->data[0]) > 1.e-2) err = 1;
+  }
+  PRINT_MSG("period %.3f, expected %.3f\n", out->data[0], 44100. / freq);
+  if (fabs (out->data[0] - 44100. / freq) > .1) err = 1;
+
+  del_fvec(in);
+  del_fvec(out);
+  del_fvec(ref);
+  del_aubio_pitchyinfast(p);
+  aubio_cleanup();
+
+  return err;
+}
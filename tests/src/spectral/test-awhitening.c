@@ -2,6 +2,7 @@
 #include "utils_tests.h"
 
 int test_wrong_params(void);
+int test_logmag(void);
 
 int main (int argc, char **argv)
 {
@@ -107,5 +108,39 @@ int test_wrong_params(void)
 
   del_aubio_spectral_whitening(o);
 
+  if (test_logmag()) return 1;
+
   return run_on_default_source_and_sink(main);
 }
+
+// whitening and compressing in one pass should match whitening, then
+// compressing, within the accuracy of the approximated log
+int test_logmag(void)
+{
+  uint_t buf_size = 512, hop_size = 256, samplerate = 44100;
+  uint_t frame, j, err = 0;
+  smpl_t lambda = 10.;
+  cvec_t *a = new_cvec(buf_size), *b = new_cvec(buf_size);
+  aubio_spectral_whitening_t *w1 =
+    new_aubio_spectral_whitening(buf_size, hop_size, samplerate);
+  aubio_spectral_whitening_t *w2 =
+    new_aubio_spectral_whitening(buf_size, hop_size, samplerate);
+  utils_init_random();
+  for (frame = 0; frame < 10; frame++) {
+    for (j = 0; j < a->length; j++) {
+      a->norm[j] = (smpl_t)random() / RAND_MAX * (frame % 3);
+    }
+    cvec_copy(a, b);
+    aubio_spectral_whitening_do(w1, a);
+    cvec_logmag(a, lambda);
+    aubio_spectral_whitening_do_logmag(w2, b, lambda);
+    for (j = 0; j < a->length; j++) {
+      if (fabs(a->norm[j] - b->norm[j]) > 1.e-5 * (1. + a->norm[j])) err = 1;
+    }
+  }
+  del_aubio_spectral_whitening(w1);
+  del_aubio_spectral_whitening(w2);
+  del_cvec(a);
+  del_cvec(b);
+  return err;
+}
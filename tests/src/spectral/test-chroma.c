@@ -0,0 +1,117 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// analyse notes and chords, in tune and a third of a semitone sharp, and
+// check their pitch classes, with and without the estimation of the tuning
+
+#define SR 44100
+#define WIN 4096
+#define HOP 1024
+#define N_BLOCKS 60
+
+// run the sum of sines at freqs, detuned by cents, through pvoc and chroma
+static void analyse (aubio_chroma_t *o, const smpl_t *freqs, uint_t n_freqs,
+    smpl_t cents, fvec_t *out)
+{
+  aubio_pvoc_t *pv = new_aubio_pvoc (WIN, HOP);
+  fvec_t *in = new_fvec (HOP);
+  cvec_t *grain = new_cvec (WIN);
+  smpl_t ratio = pow (2., cents / 1200.);
+  uint_t n, j, f;
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (j = 0; j < HOP; j++) {
+      in->data[j] = 0.;
+      for (f = 0; f < n_freqs; f++) {
+        in->data[j] += .2 * sin (2. * M_PI * freqs[f] * ratio
+            * (n * HOP + j) / SR);
+      }
+    }
+    aubio_pvoc_do (pv, in, grain);
+    aubio_chroma_do (o, grain, out);
+  }
+  del_aubio_pvoc (pv);
+  del_fvec (in);
+  del_cvec (grain);
+}
+
+static uint_t argmax (const fvec_t *v)
+{
+  uint_t j, best = 0;
+  for (j = 1; j < v->length; j++) {
+    if (v->data[j] > v->data[best]) best = j;
+  }
+  return best;
+}
+
+int main (void)
+{
+  // A3 and A4, then a C major chord over three octaves
+  smpl_t a[] = { 220., 440. };
+  smpl_t c_major[] = { 130.81, 164.81, 196., 261.63, 329.63, 392., 523.25 };
+  uint_t j, err = 0;
+  fvec_t *out = new_fvec (AUBIO_CHROMA_N_CLASSES);
+  aubio_chroma_t *o;
+  smpl_t in_tune, detuned;
+
+  // wrong parameters
+  if (new_aubio_chroma (WIN, 10., 4000., SR)) err = 1;
+  if (new_aubio_chroma (WIN, 400., 300., SR)) err = 1;
+  if (new_aubio_chroma (WIN, 100., 30000., SR)) err = 1;
+  if (new_aubio_chroma (WIN, 450., 460., SR)) err = 1;
+  if (new_aubio_chroma (0, 55., 4000., SR)) err = 1;
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+
+  o = new_aubio_chroma (WIN, 55., 4000., SR);
+  if (!o || !out) return 1;
+  if (aubio_chroma_set_tuning (o, 60.) == 0) err = 1;
+
+  analyse (o, a, 2, 0., out);
+  fvec_print (out);
+  if (argmax (out) != 9 || out->data[9] != 1.) err = 1;
+  for (j = 0; j < out->length; j++) {
+    if (j != 9 && j != 8 && j != 10 && out->data[j] > .01) err = 1;
+  }
+
+  analyse (o, c_major, 7, 0., out);
+  fvec_print (out);
+  for (j = 0; j < out->length; j++) {
+    uint_t in_chord = j == 0 || j == 4 || j == 7;
+    if (in_chord && out->data[j] < .5) err = 1;
+    if (!in_chord && out->data[j] > .2) err = 1;
+  }
+
+  // the main lobe of the window spreads A3 over G# and A#, and 33 cents
+  // sharp, more of the energy of A goes to A#, less once the tuning is
+  // estimated
+  aubio_chroma_set_normalize (o, 0);
+  analyse (o, a, 2, 0., out);
+  in_tune = out->data[10] / out->data[9];
+  analyse (o, a, 2, 33., out);
+  detuned = out->data[10] / out->data[9];
+  PRINT_MSG ("A# / A: %f in tune, %f detuned\n", in_tune, detuned);
+  if (detuned < 1.5 * in_tune) err = 1;
+  aubio_chroma_set_tuning_estimation (o, 1);
+  analyse (o, a, 2, 33., out);
+  PRINT_MSG ("estimated tuning: %.0f cents, A# / A: %f\n",
+      aubio_chroma_get_tuning (o), out->data[10] / out->data[9]);
+  if (fabs (aubio_chroma_get_tuning (o) - 33.) > 3.) err = 1;
+  if (out->data[10] / out->data[9] > in_tune) err = 1;
+  analyse (o, c_major, 7, 33., out);
+  fvec_print (out);
+  if (argmax (out) != 0) err = 1;
+
+  // back in tune, and flat
+  if (aubio_chroma_set_tuning (o, 0.) != 0) err = 1;
+  aubio_chroma_set_tuning_estimation (o, 0);
+  if (aubio_chroma_get_tuning (o) != 0.) err = 1;
+  aubio_chroma_set_tuning_estimation (o, 1);
+  analyse (o, a, 2, -20., out);
+  PRINT_MSG ("estimated tuning: %.0f cents\n", aubio_chroma_get_tuning (o));
+  if (fabs (aubio_chroma_get_tuning (o) + 20.) > 3.) err = 1;
+
+  if (err) PRINT_ERR ("wrong chroma vectors\n");
+  del_aubio_chroma (o);
+  del_fvec (out);
+  aubio_cleanup ();
+  return err;
+}
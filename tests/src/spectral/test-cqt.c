@@ -0,0 +1,81 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// feed sines at the frequency of some bins, from the lowest to the highest
+// octave, and check they peak in the right bin with the right magnitude
+
+#define SR 44100
+#define HOP 512
+#define N_BLOCKS 80
+
+static uint_t argmax (const fvec_t *v)
+{
+  uint_t j, best = 0;
+  for (j = 1; j < v->length; j++) {
+    if (v->data[j] > v->data[best]) best = j;
+  }
+  return best;
+}
+
+static uint_t check_sine (aubio_cqt_t *o, uint_t bin, smpl_t amp)
+{
+  uint_t n, j, err = 0, n_bins = aubio_cqt_get_n_bins (o);
+  smpl_t freq = aubio_cqt_get_freq (o, bin);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (n_bins);
+  if (!in || !out) return 1;
+  aubio_cqt_reset (o);
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (j = 0; j < HOP; j++) {
+      in->data[j] = amp * sin (2. * M_PI * freq * (n * HOP + j) / SR);
+    }
+    aubio_cqt_do (o, in, out);
+  }
+  PRINT_MSG ("%8.2fHz: bin %d, magnitude %f, neighbours %f %f\n", freq,
+      argmax (out), out->data[bin],
+      bin > 0 ? out->data[bin - 1] : 0., bin + 1 < n_bins ?
+      out->data[bin + 1] : 0.);
+  if (argmax (out) != bin || fabs (out->data[bin] / amp - 1.) > .1) {
+    PRINT_ERR ("sine at %.2fHz not found in bin %d\n", freq, bin);
+    err = 1;
+  }
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t bins[] = { 0, 7, 12, 30, 47, 60, 71, 83, 84 };
+  uint_t i, err = 0;
+  aubio_cqt_t *o;
+  // wrong parameters
+  if (new_aubio_cqt (0., 1000., 12, HOP, SR)) err = 1;
+  if (new_aubio_cqt (100., 50., 12, HOP, SR)) err = 1;
+  if (new_aubio_cqt (100., SR / 2, 12, HOP, SR)) err = 1;
+  if (new_aubio_cqt (100., 1000., 0, HOP, SR)) err = 1;
+  if (new_aubio_cqt (55., 7040., 12, 100, SR)) err = 1;
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+  // seven octaves, from A1 to A8
+  o = new_aubio_cqt (55., 7040., 12, HOP, SR);
+  if (!o) return 1;
+  if (aubio_cqt_get_n_bins (o) != 85
+      || fabs (aubio_cqt_get_freq (o, 84) - 7040.) > .01
+      || aubio_cqt_get_freq (o, 85) != 0.) {
+    PRINT_ERR ("got %d bins, the last at %f\n", aubio_cqt_get_n_bins (o),
+        aubio_cqt_get_freq (o, 84));
+    err = 1;
+  }
+  for (i = 0; i < sizeof(bins) / sizeof(bins[0]); i++) {
+    if (check_sine (o, bins[i], .5)) err = 1;
+  }
+  del_aubio_cqt (o);
+  // up to the highest frequencies, on fewer bins per octave
+  o = new_aubio_cqt (100., 16000., 3, HOP, SR);
+  if (!o) return 1;
+  for (i = 0; i < aubio_cqt_get_n_bins (o); i += 4) {
+    if (check_sine (o, i, .25)) err = 1;
+  }
+  del_aubio_cqt (o);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,69 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// transform batches of frames forward and back, and compare them to the
+// output of aubio_dct_do on each frame of a second object of the same size
+
+#define N_FRAMES 25
+
+static uint_t check_batch (uint_t size)
+{
+  aubio_dct_t *dct = new_aubio_dct (size);
+  aubio_dct_t *ref = new_aubio_dct (size);
+  fmat_t *in = new_fmat (N_FRAMES, size), *coeffs = new_fmat (N_FRAMES, size);
+  fmat_t *out = new_fmat (N_FRAMES, size);
+  fvec_t *expected = new_fvec (size), frame;
+  uint_t i, j, err = 0;
+  smpl_t max_err = 0.;
+  if (!dct || !ref || !in || !coeffs || !out || !expected) return 1;
+  for (i = 0; i < N_FRAMES; i++) {
+    for (j = 0; j < size; j++) {
+      in->data[i][j] = (random () % 2001 - 1000) / 100.;
+    }
+  }
+  if (aubio_dct_do_batch (dct, in, coeffs)) return 1;
+  if (aubio_dct_rdo_batch (dct, coeffs, out)) return 1;
+  frame.length = size;
+  for (i = 0; i < N_FRAMES; i++) {
+    frame.data = in->data[i];
+    aubio_dct_do (ref, &frame, expected);
+    for (j = 0; j < size; j++) {
+      smpl_t e = fabs (coeffs->data[i][j] - expected->data[j]);
+      if (e > max_err) max_err = e;
+      if (fabs (out->data[i][j] - in->data[i][j]) > 1.e-3) err = 1;
+    }
+  }
+  PRINT_MSG ("size %d: largest error %g\n", size, max_err);
+  if (max_err > 1.e-4) err = 1;
+
+  // a matrix of frames of the wrong size, an output too short
+  in->length = size + 1;
+  if (aubio_dct_do_batch (dct, in, coeffs) == 0) err = 1;
+  in->length = size;
+  out->height = N_FRAMES - 1;
+  if (aubio_dct_rdo_batch (dct, coeffs, out) == 0) err = 1;
+  out->height = N_FRAMES;
+
+  del_aubio_dct (dct);
+  // the tables are still used by ref
+  aubio_dct_do (ref, &frame, expected);
+  del_aubio_dct (ref);
+  del_fmat (in);
+  del_fmat (coeffs);
+  del_fmat (out);
+  del_fvec (expected);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  err |= check_batch (32);
+  err |= check_batch (256);
+  err |= check_batch (40);
+  err |= check_batch (13);
+  err |= check_batch (1);
+  if (err) PRINT_ERR ("batch dct differs from aubio_dct_do\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,53 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compare the forward transform against a direct dft, and check that the
+// backward transform inverts it, on the power of two sizes of all backends
+int main (void)
+{
+  uint_t i, j, k, win_s;
+  utils_init_random();
+  for (win_s = 4; win_s <= 4096; win_s *= 2) {
+    fvec_t *in = new_fvec (win_s);
+    fvec_t *compspec = new_fvec (win_s);
+    fvec_t *out = new_fvec (win_s);
+    aubio_fft_t *fft = new_aubio_fft (win_s);
+    double err = 0., peak = 0.;
+    if (!fft) return 1;
+
+    for (i = 0; i < win_s; i++) {
+      in->data[i] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+    aubio_fft_do_complex (fft, in, compspec);
+
+    // direct dft of a few bins, including the first, middle and last ones
+    for (k = 0; k <= win_s / 2; k += (k < 8 || k > win_s / 2 - 8) ? 1 : 37) {
+      double re = 0., im = 0.;
+      for (j = 0; j < win_s; j++) {
+        double phase = 2. * M_PI * (double)((j * k) % win_s) / win_s;
+        re += in->data[j] * cos(phase);
+        im -= in->data[j] * sin(phase);
+      }
+      err = fabs(re - compspec->data[k]);
+      if (err > peak) peak = err;
+      if (k > 0 && k < win_s / 2) {
+        err = fabs(im - compspec->data[win_s - k]);
+        if (err > peak) peak = err;
+      }
+    }
+    // single precision error grows with log(win_s)
+    assert(peak < 1.e-3 * sqrt(win_s));
+
+    aubio_fft_rdo_complex (fft, compspec, out);
+    for (i = 0; i < win_s; i++) {
+      assert(fabs(out->data[i] - in->data[i]) < 1.e-4);
+    }
+
+    del_aubio_fft (fft);
+    del_fvec (in);
+    del_fvec (compspec);
+    del_fvec (out);
+  }
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,58 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+int main (void)
+{
+  uint_t i, j, n_frames = 16, win_s = 512;
+  fmat_t *frames = new_fmat (n_frames, win_s);
+  fmat_t *compspecs = new_fmat (n_frames, win_s);
+  fmat_t *norms = new_fmat (n_frames, win_s / 2 + 1);
+  fmat_t *phases = new_fmat (n_frames, win_s / 2 + 1);
+  fmat_t *wrong = new_fmat (n_frames, win_s / 2);
+  fvec_t frame;
+  fvec_t *compspec = new_fvec (win_s);
+  cvec_t *spectrum = new_cvec (win_s);
+  aubio_fft_t *fft = new_aubio_fft (win_s);
+
+  if (!fft) return 1;
+
+  utils_init_random();
+  for (i = 0; i < n_frames; i++) {
+    for (j = 0; j < win_s; j++) {
+      frames->data[i][j] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+  }
+
+  assert(aubio_fft_do_complex_batch (fft, frames, compspecs) == 0);
+  assert(aubio_fft_do_batch (fft, frames, norms, phases) == 0);
+
+  // each batched frame matches the single frame transform
+  for (i = 0; i < n_frames; i++) {
+    // frame points to the i-th row of frames
+    fmat_get_channel (frames, i, &frame);
+    aubio_fft_do_complex (fft, &frame, compspec);
+    for (j = 0; j < win_s; j++) {
+      assert(fabs(compspec->data[j] - compspecs->data[i][j]) < 1.e-4);
+    }
+    aubio_fft_do (fft, &frame, spectrum);
+    for (j = 0; j < spectrum->length; j++) {
+      assert(fabs(spectrum->norm[j] - norms->data[i][j]) < 1.e-4);
+      assert(fabs(spectrum->phas[j] - phases->data[i][j]) < 1.e-4);
+    }
+  }
+
+  // mismatched sizes are rejected
+  assert(aubio_fft_do_complex_batch (fft, frames, wrong) != 0);
+  assert(aubio_fft_do_batch (fft, frames, wrong, wrong) != 0);
+
+  del_aubio_fft (fft);
+  del_fmat (frames);
+  del_fmat (compspecs);
+  del_fmat (norms);
+  del_fmat (phases);
+  del_fmat (wrong);
+  del_fvec (compspec);
+  del_cvec (spectrum);
+  aubio_cleanup ();
+  return 0;
+}
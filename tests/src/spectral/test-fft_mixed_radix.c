@@ -0,0 +1,84 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compare the forward transform against a direct dft, and check that the
+// backward transform inverts it, on sizes that are not powers of two
+int main (void)
+{
+  uint_t sizes[] = { 3, 5, 6, 12, 15, 30, 45, 96, 120, 250, 480, 960, 1000,
+    1536, 1920, 2880 };
+  uint_t n, i, j, k, win_s, hop_s = 480;
+  aubio_pvoc_t *pv;
+  fvec_t *frame;
+  cvec_t *grain;
+
+  utils_init_random();
+  for (n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+    fvec_t *in, *compspec, *out;
+    aubio_fft_t *fft;
+    double err = 0., peak = 0.;
+    win_s = sizes[n];
+    in = new_fvec (win_s);
+    compspec = new_fvec (win_s);
+    out = new_fvec (win_s);
+    fft = new_aubio_fft (win_s);
+    if (!fft) return 1;
+
+    for (i = 0; i < win_s; i++) {
+      in->data[i] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+    aubio_fft_do_complex (fft, in, compspec);
+
+    for (k = 0; k <= win_s / 2; k++) {
+      double re = 0., im = 0.;
+      for (j = 0; j < win_s; j++) {
+        double phase = 2. * M_PI * (double)((j * k) % win_s) / win_s;
+        re += in->data[j] * cos(phase);
+        im -= in->data[j] * sin(phase);
+      }
+      err = fabs(re - compspec->data[k]);
+      if (err > peak) peak = err;
+      // the last bin of even sizes has no imaginary part
+      if (k > 0 && 2 * k != win_s) {
+        err = fabs(im - compspec->data[win_s - k]);
+        if (err > peak) peak = err;
+      }
+    }
+    assert(peak < 1.e-3 * sqrt(win_s));
+
+    aubio_fft_rdo_complex (fft, compspec, out);
+    for (i = 0; i < win_s; i++) {
+      assert(fabs(out->data[i] - in->data[i]) < 1.e-4);
+    }
+
+    del_aubio_fft (fft);
+    del_fvec (in);
+    del_fvec (compspec);
+    del_fvec (out);
+  }
+
+  // a phase vocoder on 40ms frames at 48kHz, with 75% overlap
+  win_s = 1920;
+  pv = new_aubio_pvoc (win_s, hop_s);
+  frame = new_fvec (hop_s);
+  grain = new_cvec (win_s);
+  assert(pv);
+  for (n = 0; n < 8; n++) {
+    for (i = 0; i < hop_s; i++) {
+      frame->data[i] = sin(2. * M_PI * 440. * (n * hop_s + i) / 48000.);
+    }
+    aubio_pvoc_do (pv, frame, grain);
+  }
+  // 440Hz falls on bin 17.6 of a 1920 points fft at 48kHz
+  k = 0;
+  for (i = 1; i < grain->length; i++) {
+    if (grain->norm[i] > grain->norm[k]) k = i;
+  }
+  assert(k == 17 || k == 18);
+  del_aubio_pvoc (pv);
+  del_fvec (frame);
+  del_cvec (grain);
+
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,56 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// several fft objects of the same size share their plans, and can be created
+// and deleted in any order
+int main (void)
+{
+  uint_t i, j, n_ffts = 4, win_s = 1024;
+  aubio_fft_t *ffts[4];
+  fvec_t *in = new_fvec (win_s);
+  cvec_t *ref = new_cvec (win_s);
+  cvec_t *spec = new_cvec (win_s);
+
+  assert(aubio_fft_set_planner ("estimate") == 0);
+  assert(aubio_fft_set_planner ("unknown") != 0);
+  assert(aubio_fft_set_planner (NULL) != 0);
+  assert(aubio_fft_set_threads (1) == 0);
+  assert(aubio_fft_set_threads (0) != 0);
+  assert(aubio_fft_get_threads () >= 1);
+
+  for (i = 0; i < win_s; i++) {
+    in->data[i] = sin(2. * M_PI * 7. * i / win_s);
+  }
+
+  for (i = 0; i < n_ffts; i++) {
+    ffts[i] = new_aubio_fft (win_s);
+    assert(ffts[i]);
+  }
+  aubio_fft_do (ffts[0], in, ref);
+  // release one in the middle of the list
+  del_aubio_fft (ffts[1]);
+  ffts[1] = new_aubio_fft (win_s);
+  for (i = 0; i < n_ffts; i++) {
+    aubio_fft_do (ffts[i], in, spec);
+    for (j = 0; j < spec->length; j++) {
+      assert(spec->norm[j] == ref->norm[j]);
+    }
+  }
+  for (i = 0; i < n_ffts; i++) {
+    del_aubio_fft (ffts[i]);
+  }
+
+  // a new object can be created once all plans were released
+  ffts[0] = new_aubio_fft (win_s);
+  assert(ffts[0]);
+  del_aubio_fft (ffts[0]);
+
+  // without a readable wisdom file, loading fails
+  assert(aubio_fft_load_wisdom ("/nonexistent/aubio.wisdom") != 0);
+
+  del_fvec (in);
+  del_cvec (ref);
+  del_cvec (spec);
+  aubio_cleanup ();
+  return 0;
+}
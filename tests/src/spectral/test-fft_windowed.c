@@ -0,0 +1,41 @@
+#define AUBIO_UNSTABLE 1
+#include <aubio.h>
+#include "utils_tests.h"
+
+// the fused windowed transform matches weighting, shifting and transforming
+int main (void)
+{
+  uint_t i, j, win_s, sizes[] = {16, 512};
+  utils_init_random();
+  for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    win_s = sizes[i];
+    fvec_t *in = new_fvec (win_s);
+    fvec_t *grain = new_fvec (win_s);
+    fvec_t *window = new_aubio_window ("hanningz", win_s);
+    fvec_t *ref = new_fvec (win_s);
+    fvec_t *compspec = new_fvec (win_s);
+    aubio_fft_t *fft = new_aubio_fft (win_s);
+    if (!fft) return 1;
+
+    for (j = 0; j < win_s; j++) {
+      in->data[j] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+    fvec_weighted_copy (in, window, grain);
+    fvec_shift (grain);
+    aubio_fft_do_complex (fft, grain, ref);
+
+    aubio_fft_do_complex_windowed (fft, in, window, compspec);
+    for (j = 0; j < win_s; j++) {
+      assert(compspec->data[j] == ref->data[j]);
+    }
+
+    del_aubio_fft (fft);
+    del_fvec (in);
+    del_fvec (grain);
+    del_fvec (window);
+    del_fvec (ref);
+    del_fvec (compspec);
+  }
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compare the bands of a batch of spectra to the ones computed frame by frame
+
+#define N_FRAMES 150
+
+static void
+assert_batch_matches (aubio_filterbank_t * f, const fmat_t * spectra,
+    fmat_t * out)
+{
+  uint_t i, j, t;
+  cvec_t *in = new_cvec ((spectra->length - 1) * 2);
+  fvec_t *ref = new_fvec (out->length);
+  assert(aubio_filterbank_do_batch (f, spectra, out) == 0);
+  for (t = 0; t < spectra->height; t++) {
+    for (j = 0; j < spectra->length; j++) {
+      in->norm[j] = spectra->data[t][j];
+    }
+    aubio_filterbank_do (f, in, ref);
+    for (i = 0; i < ref->length; i++) {
+      assert(fabs(out->data[t][i] - ref->data[i])
+          <= 1.e-5 * (1. + fabs(ref->data[i])));
+    }
+  }
+  del_cvec (in);
+  del_fvec (ref);
+}
+
+int main (void)
+{
+  uint_t i, j, n_filters = 40, win_s = 1024;
+  aubio_filterbank_t *f = new_aubio_filterbank (n_filters, win_s);
+  fmat_t *spectra = new_fmat (N_FRAMES, win_s / 2 + 1);
+  fmat_t *copy = new_fmat (N_FRAMES, win_s / 2 + 1);
+  fmat_t *out = new_fmat (N_FRAMES, n_filters);
+  fmat_t *coeffs = new_fmat (n_filters, win_s / 2 + 1);
+  fmat_t *wrong = new_fmat (N_FRAMES, n_filters + 1);
+  fmat_t view;
+  smpl_t *rows[N_FRAMES];
+
+  utils_init_random();
+  for (i = 0; i < spectra->height; i++) {
+    for (j = 0; j < spectra->length; j++) {
+      spectra->data[i][j] = random() / (smpl_t)RAND_MAX;
+    }
+  }
+  fmat_copy (spectra, copy);
+
+  // sparse mel filters
+  assert(aubio_filterbank_set_mel_coeffs (f, 44100, 0., 16000.) == 0);
+  assert_batch_matches (f, spectra, out);
+
+  // dense filters
+  for (i = 0; i < n_filters; i++) {
+    for (j = 0; j < coeffs->length; j++) {
+      coeffs->data[i][j] = random() / (smpl_t)RAND_MAX / coeffs->length;
+    }
+  }
+  assert(aubio_filterbank_set_coeffs (f, coeffs) == 0);
+  assert_batch_matches (f, spectra, out);
+
+  // rows that are not evenly spaced, here in reverse order
+  for (i = 0; i < N_FRAMES; i++) {
+    rows[i] = spectra->data[N_FRAMES - 1 - i];
+  }
+  view.height = N_FRAMES;
+  view.length = spectra->length;
+  view.data = rows;
+  assert_batch_matches (f, &view, out);
+
+  // with a power, the spectra are left untouched
+  assert(aubio_filterbank_set_power (f, 2.) == 0);
+  assert(aubio_filterbank_do_batch (f, spectra, out) == 0);
+  for (i = 0; i < spectra->height; i++) {
+    for (j = 0; j < spectra->length; j++) {
+      assert(spectra->data[i][j] == copy->data[i][j]);
+    }
+  }
+  assert_batch_matches (f, spectra, out);
+
+  // matrices that do not fit the filterbank
+  assert(aubio_filterbank_do_batch (f, spectra, wrong) != 0);
+  assert(aubio_filterbank_do_batch (f, out, out) != 0);
+
+  del_fmat (spectra);
+  del_fmat (copy);
+  del_fmat (out);
+  del_fmat (coeffs);
+  del_fmat (wrong);
+  del_aubio_filterbank (f);
+  aubio_cleanup ();
+  return 0;
+}
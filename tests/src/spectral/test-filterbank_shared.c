@@ -0,0 +1,66 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// filterbanks with the same mel coefficients share them, and still behave
+// as if each had its own copy
+int main (void)
+{
+  uint_t i, j, n, n_fbs = 8, n_filters = 40, win_s = 1024;
+  aubio_filterbank_t *fbs[8], *other;
+  cvec_t *in = new_cvec (win_s);
+  fvec_t *ref = new_fvec (n_filters);
+  fvec_t *out = new_fvec (n_filters);
+  fmat_t *coeffs;
+
+  utils_init_random();
+  for (i = 0; i < in->length; i++) {
+    in->norm[i] = random() / (smpl_t)RAND_MAX;
+  }
+
+  for (n = 0; n < n_fbs; n++) {
+    fbs[n] = new_aubio_filterbank (n_filters, win_s);
+    assert(aubio_filterbank_set_mel_coeffs (fbs[n], 44100, 0., 16000.) == 0);
+  }
+  aubio_filterbank_do (fbs[0], in, ref);
+  for (n = 1; n < n_fbs; n++) {
+    aubio_filterbank_do (fbs[n], in, out);
+    for (i = 0; i < n_filters; i++) {
+      assert(out->data[i] == ref->data[i]);
+    }
+  }
+
+  // changing the coefficients of one filterbank does not affect the others
+  coeffs = aubio_filterbank_get_coeffs (fbs[1]);
+  for (j = 0; j < coeffs->length; j++) {
+    coeffs->data[0][j] = 1.;
+  }
+  aubio_filterbank_do (fbs[1], in, out);
+  assert(out->data[0] != ref->data[0]);
+  aubio_filterbank_do (fbs[2], in, out);
+  assert(out->data[0] == ref->data[0]);
+
+  // without normalisation, the coefficients differ
+  other = new_aubio_filterbank (n_filters, win_s);
+  assert(aubio_filterbank_set_norm (other, 0) == 0);
+  assert(aubio_filterbank_set_mel_coeffs (other, 44100, 0., 16000.) == 0);
+  aubio_filterbank_do (other, in, out);
+  assert(out->data[0] != ref->data[0]);
+  del_aubio_filterbank (other);
+
+  // delete in any order, then compute the same coefficients again
+  for (n = 0; n < n_fbs; n += 2) del_aubio_filterbank (fbs[n]);
+  for (n = 1; n < n_fbs; n += 2) del_aubio_filterbank (fbs[n]);
+  other = new_aubio_filterbank (n_filters, win_s);
+  assert(aubio_filterbank_set_mel_coeffs (other, 44100, 0., 16000.) == 0);
+  aubio_filterbank_do (other, in, out);
+  for (i = 0; i < n_filters; i++) {
+    assert(out->data[i] == ref->data[i]);
+  }
+  del_aubio_filterbank (other);
+
+  del_cvec (in);
+  del_fvec (ref);
+  del_fvec (out);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// dense reference of the filterbank product
+static void
+filterbank_reference (const fmat_t * coeffs, const cvec_t * in, fvec_t * out)
+{
+  uint_t i, j;
+  for (i = 0; i < coeffs->height; i++) {
+    out->data[i] = 0.;
+    for (j = 0; j < coeffs->length; j++) {
+      out->data[i] += coeffs->data[i][j] * in->norm[j];
+    }
+  }
+}
+
+static void
+assert_matches (aubio_filterbank_t * f, const cvec_t * in, fvec_t * out,
+    fvec_t * ref)
+{
+  uint_t i;
+  aubio_filterbank_do (f, in, out);
+  filterbank_reference (aubio_filterbank_get_coeffs (f), in, ref);
+  for (i = 0; i < out->length; i++) {
+    assert(fabs(out->data[i] - ref->data[i]) <= 1.e-5 * (1. + ref->data[i]));
+  }
+}
+
+int main (void)
+{
+  uint_t i, j, n_filters = 40, win_s = 2048;
+  aubio_filterbank_t *f = new_aubio_filterbank (n_filters, win_s);
+  cvec_t *in = new_cvec (win_s);
+  fvec_t *out = new_fvec (n_filters);
+  fvec_t *ref = new_fvec (n_filters);
+  fmat_t *coeffs;
+
+  utils_init_random();
+  for (i = 0; i < in->length; i++) {
+    in->norm[i] = random() / (smpl_t)RAND_MAX;
+  }
+
+  // mel bands only use a small part of the spectrum
+  assert(aubio_filterbank_set_mel_coeffs (f, 44100, 0., 16000.) == 0);
+  assert_matches (f, in, out, ref);
+
+  // coefficients changed through get_coeffs are used by the next call
+  coeffs = aubio_filterbank_get_coeffs (f);
+  coeffs->data[0][win_s / 2] = 1.;
+  coeffs->data[n_filters - 1][0] = 1.;
+  assert_matches (f, in, out, ref);
+
+  // and so are the ones copied with set_coeffs, here dense filters
+  coeffs = new_fmat (n_filters, win_s / 2 + 1);
+  for (i = 0; i < n_filters; i++) {
+    for (j = 0; j < coeffs->length; j++) {
+      coeffs->data[i][j] = random() / (smpl_t)RAND_MAX / coeffs->length;
+    }
+  }
+  assert(aubio_filterbank_set_coeffs (f, coeffs) == 0);
+  assert_matches (f, in, out, ref);
+
+  // empty filters give zero bands
+  fmat_zeros (coeffs);
+  assert(aubio_filterbank_set_coeffs (f, coeffs) == 0);
+  aubio_filterbank_do (f, in, out);
+  for (i = 0; i < n_filters; i++) {
+    assert(out->data[i] == 0.);
+  }
+
+  del_fmat (coeffs);
+  del_aubio_filterbank (f);
+  del_cvec (in);
+  del_fvec (out);
+  del_fvec (ref);
+  aubio_cleanup ();
+  return 0;
+}
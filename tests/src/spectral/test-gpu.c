@@ -0,0 +1,143 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// the batch functions give the same results on a GPU as on the processor, up
+// to single precision rounding; without a device, only the fallback to the
+// processor is checked
+
+#define N_FRAMES 300
+
+static void
+assert_close (const fmat_t * a, const fmat_t * b, uint_t n_frames,
+    smpl_t tolerance)
+{
+  uint_t i, j;
+  for (i = 0; i < n_frames; i++) {
+    for (j = 0; j < a->length; j++) {
+      assert(fabs(a->data[i][j] - b->data[i][j])
+          <= tolerance * (1. + fabs(b->data[i][j])));
+    }
+  }
+}
+
+int main (int argc, char **argv)
+{
+  uint_t win_s = 1024, hop_s = 256, n_filters = 40, n_coefs = 13;
+  uint_t bins = win_s / 2 + 1, samplerate = 0, i, j;
+  uint_t n_ref = 0, n_frames = 0, total = 0;
+  aubio_gpu_t *gpu;
+  aubio_fft_t *fft = new_aubio_fft (win_s);
+  aubio_filterbank_t *fb = new_aubio_filterbank (n_filters, win_s);
+  fmat_t *frames = new_fmat (N_FRAMES, win_s);
+  fmat_t *norms = new_fmat (N_FRAMES, bins);
+  fmat_t *phases = new_fmat (N_FRAMES, bins);
+  fmat_t *ref_norms = new_fmat (N_FRAMES, bins);
+  fmat_t *ref_phases = new_fmat (N_FRAMES, bins);
+  fmat_t *bands = new_fmat (N_FRAMES, n_filters);
+  fmat_t *ref_bands = new_fmat (N_FRAMES, n_filters);
+  aubio_source_t *source;
+  aubio_mfcc_t *mfcc, *ref_mfcc;
+  fmat_t *coefs, *ref_coefs;
+
+  if (argc < 2) {
+    del_aubio_fft (fft);
+    del_aubio_filterbank (fb);
+    del_fmat (frames);
+    del_fmat (norms);
+    del_fmat (phases);
+    del_fmat (ref_norms);
+    del_fmat (ref_phases);
+    del_fmat (bands);
+    del_fmat (ref_bands);
+    return run_on_default_source(main);
+  }
+  gpu = new_aubio_gpu (NULL);
+  if (gpu) {
+    PRINT_MSG("running on %s\n", aubio_gpu_get_name (gpu));
+  } else {
+    PRINT_MSG("no gpu found, only checking the processor\n");
+  }
+
+  utils_init_random();
+  for (i = 0; i < frames->height; i++) {
+    for (j = 0; j < frames->length; j++) {
+      frames->data[i][j] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+  }
+
+  // fft
+  assert(aubio_fft_do_batch (fft, frames, ref_norms, ref_phases) == 0);
+  assert(aubio_fft_set_gpu (fft, gpu) == 0);
+  assert(aubio_fft_do_batch (fft, frames, norms, phases) == 0);
+  assert_close (norms, ref_norms, N_FRAMES, 1.e-4);
+  for (i = 0; i < N_FRAMES; i++) {
+    for (j = 0; j < bins; j++) {
+      // phases are only compared where the bin is well above rounding
+      smpl_t d = fabs(phases->data[i][j] - ref_phases->data[i][j]);
+      if (ref_norms->data[i][j] < 1.e-2) continue;
+      assert(d < 1.e-2 || fabs(d - 2. * M_PI) < 1.e-2);
+    }
+  }
+
+  // filterbank, with and without power
+  assert(aubio_filterbank_set_mel_coeffs (fb, 44100, 0., 16000.) == 0);
+  assert(aubio_filterbank_do_batch (fb, ref_norms, ref_bands) == 0);
+  assert(aubio_filterbank_set_gpu (fb, gpu) == 0);
+  assert(aubio_filterbank_do_batch (fb, ref_norms, bands) == 0);
+  assert_close (bands, ref_bands, N_FRAMES, 1.e-4);
+  assert(aubio_filterbank_set_power (fb, 2.) == 0);
+  assert(aubio_filterbank_do_batch (fb, ref_norms, bands) == 0);
+  assert(aubio_filterbank_set_gpu (fb, NULL) == 0);
+  assert(aubio_filterbank_do_batch (fb, ref_norms, ref_bands) == 0);
+  assert_close (bands, ref_bands, N_FRAMES, 1.e-4);
+
+  // mfcc of a whole file, in a single batch on the processor
+  source = new_aubio_source (argv[1], samplerate, hop_s);
+  assert(source);
+  samplerate = aubio_source_get_samplerate (source);
+  ref_coefs = new_fmat (aubio_source_get_duration (source) / hop_s + 2,
+      n_coefs);
+  ref_mfcc = new_aubio_mfcc (win_s, n_filters, n_coefs, samplerate);
+  assert(ref_coefs && ref_mfcc);
+  assert(aubio_mfcc_do_batch (ref_mfcc, source, hop_s, ref_coefs, &n_ref)
+      == 0);
+  assert(n_ref < ref_coefs->height);
+  del_aubio_source (source);
+
+  // then in batches of N_FRAMES, on the device
+  source = new_aubio_source (argv[1], samplerate, hop_s);
+  mfcc = new_aubio_mfcc (win_s, n_filters, n_coefs, samplerate);
+  coefs = new_fmat (N_FRAMES, n_coefs);
+  assert(source && mfcc && coefs);
+  assert(aubio_mfcc_set_gpu (mfcc, gpu) == 0);
+  do {
+    fmat_t rows;
+    assert(aubio_mfcc_do_batch (mfcc, source, hop_s, coefs, &n_frames) == 0);
+    assert(total + n_frames <= n_ref);
+    rows.length = n_coefs;
+    rows.height = n_frames;
+    rows.data = ref_coefs->data + total;
+    assert_close (coefs, &rows, n_frames, 1.e-3);
+    total += n_frames;
+  } while (n_frames == N_FRAMES);
+  assert(total == n_ref);
+
+  del_aubio_source (source);
+  del_aubio_mfcc (mfcc);
+  del_aubio_mfcc (ref_mfcc);
+  del_fmat (coefs);
+  del_fmat (ref_coefs);
+  del_aubio_fft (fft);
+  del_aubio_filterbank (fb);
+  // the device is deleted after the objects it was attached to
+  if (gpu) del_aubio_gpu (gpu);
+  del_fmat (frames);
+  del_fmat (norms);
+  del_fmat (phases);
+  del_fmat (ref_norms);
+  del_fmat (ref_phases);
+  del_fmat (bands);
+  del_fmat (ref_bands);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,157 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// the percussive part of a steady sine and a few clicks should hold the
+// clicks, its harmonic part the sine
+
+#define WIN_S 1024
+#define HOP_S 256
+#define RATE 44100
+#define N_HOPS 160
+#define CLICKS 32   // hops between two clicks
+
+static int cmp_smpl (const void *a, const void *b)
+{
+  smpl_t x = *(const smpl_t *)a, y = *(const smpl_t *)b;
+  return (x > y) - (x < y);
+}
+
+static smpl_t ref_median (smpl_t *values, uint_t n)
+{
+  qsort (values, n, sizeof (smpl_t), cmp_smpl);
+  return values[n / 2];
+}
+
+// compare the masks to medians sorted from scratch, on random frames
+static uint_t test_masks (uint_t win_s, uint_t time_width, uint_t freq_width)
+{
+  uint_t nbins = win_s / 2 + 1, i, j, k, err = 0;
+  aubio_hpss_t *o = new_aubio_hpss (win_s, win_s / 4);
+  cvec_t *in = new_cvec (win_s);
+  fvec_t *hm = new_fvec (nbins), *pm = new_fvec (nbins);
+  fmat_t *past = new_fmat (time_width, nbins);
+  smpl_t values[64];
+  if (!o || !in || !hm || !pm || !past) return 1;
+  if (aubio_hpss_set_time_width (o, time_width)
+      || aubio_hpss_set_freq_width (o, freq_width)) return 1;
+  for (i = 0; i < 3 * time_width; i++) {
+    for (k = 0; k < nbins; k++) {
+      // repeated values, to check the removal of equal norms
+      in->norm[k] = (rand () % 4) ? (rand () % 8) / 8. : 0.;
+    }
+    aubio_hpss_do_masks (o, in, hm, pm);
+    for (k = 0; k < nbins; k++) past->data[i % time_width][k] = in->norm[k];
+    for (k = 0; k < nbins; k++) {
+      uint_t n = (i + 1 < time_width) ? i + 1 : time_width;
+      smpl_t h, p, expected;
+      for (j = 0; j < n; j++) values[j] = past->data[j][k];
+      h = ref_median (values, n);
+      for (j = 0; j < freq_width; j++) {
+        sint_t b = (sint_t)(k + j) - (sint_t)(freq_width / 2);
+        if (b < 0) b = 0;
+        if (b > (sint_t)nbins - 1) b = nbins - 1;
+        values[j] = in->norm[b];
+      }
+      p = ref_median (values, freq_width);
+      expected = (h + p > 0.) ? h * h / (h * h + p * p) : .5;
+      if (fabs (hm->data[k] - expected) > 1.e-6
+          || fabs (hm->data[k] + pm->data[k] - 1.) > 1.e-6) {
+        err = 1;
+      }
+    }
+  }
+  if (err) PRINT_ERR ("hpss: masks differ from the reference medians\n");
+  del_aubio_hpss (o);
+  del_cvec (in);
+  del_fvec (hm);
+  del_fvec (pm);
+  del_fmat (past);
+  return err;
+}
+
+static smpl_t energy (const cvec_t *s)
+{
+  uint_t k;
+  smpl_t e = 0.;
+  for (k = 0; k < s->length; k++) e += s->norm[k] * s->norm[k];
+  return e;
+}
+
+int main (void)
+{
+  uint_t err = 0, n, i, onsets = 0;
+  smpl_t phase = 0., freq = 50. * RATE / WIN_S;
+  smpl_t click_perc = 0., click_harm = 0., steady_perc = 0., steady_harm = 0.;
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (1);
+  cvec_t *fftgrain = new_cvec (WIN_S);
+  cvec_t *harm = new_cvec (WIN_S), *perc = new_cvec (WIN_S);
+  aubio_pvoc_t *pv = new_aubio_pvoc (WIN_S, HOP_S);
+  aubio_hpss_t *o = new_aubio_hpss (WIN_S, HOP_S);
+  aubio_onset_t *onset = new_aubio_onset ("hfc", WIN_S, HOP_S, RATE);
+  utils_init_random ();
+  if (!in || !out || !fftgrain || !harm || !perc || !pv || !o || !onset) {
+    return 1;
+  }
+
+  // only peaks well above the floor of noise
+  aubio_onset_set_threshold (onset, 1.);
+
+  if (new_aubio_hpss (1, HOP_S) || new_aubio_hpss (WIN_S, 0)) err = 1;
+  if (aubio_hpss_get_time_width (o) != 17
+      || aubio_hpss_get_freq_width (o) != 17
+      || aubio_hpss_get_power (o) != 2.) err = 1;
+  if (aubio_hpss_set_time_width (o, 4) == 0
+      || aubio_hpss_set_freq_width (o, 0) == 0
+      || aubio_hpss_set_power (o, 0.) == 0) err = 1;
+
+  for (n = 0; n < N_HOPS; n++) {
+    for (i = 0; i < HOP_S; i++) {
+      // a faint noise, the floor of the percussive part
+      in->data[i] = .3 * sin (phase) + 1.e-3 * (2. * rand () / RAND_MAX - 1.);
+      phase += 2. * M_PI * freq / RATE;
+    }
+    if (n % CLICKS == CLICKS / 2) in->data[HOP_S / 2] += 1.;
+    aubio_pvoc_do (pv, in, fftgrain);
+    aubio_hpss_do (o, fftgrain, harm, perc);
+    aubio_onset_do_spectrum (onset, in, perc, out);
+    // skip the first frames, while the median along time fills up
+    if (n < CLICKS) continue;
+    if (out->data[0] != 0.) {
+      // onsets are reported a few hops after the click
+      if (n % CLICKS < CLICKS / 2 || n % CLICKS > CLICKS / 2 + 4) err = 1;
+      onsets++;
+    }
+    // a click stays in the window of the phase vocoder for 4 hops
+    if (n % CLICKS >= CLICKS / 2 && n % CLICKS < CLICKS / 2 + WIN_S / HOP_S) {
+      click_perc += energy (perc);
+      click_harm += energy (harm);
+    } else {
+      steady_perc += energy (perc);
+      steady_harm += energy (harm);
+    }
+  }
+  PRINT_MSG ("steady frames: harmonic %.2f, percussive %.4f\n",
+      steady_harm, steady_perc);
+  PRINT_MSG ("click frames: harmonic %.2f, percussive %.2f\n",
+      click_harm, click_perc);
+  PRINT_MSG ("%d onsets found in the percussive part, for %d clicks\n",
+      onsets, N_HOPS / CLICKS - 1);
+  if (steady_perc > .01 * steady_harm) err = 1;
+  if (click_perc < 100. * steady_perc) err = 1;
+  if (onsets != N_HOPS / CLICKS - 1) err = 1;
+
+  if (test_masks (64, 5, 3) || test_masks (30, 7, 9) || test_masks (8, 1, 1)) {
+    err = 1;
+  }
+
+  del_aubio_onset (onset);
+  del_aubio_hpss (o);
+  del_aubio_pvoc (pv);
+  del_fvec (in);
+  del_fvec (out);
+  del_cvec (fftgrain);
+  del_cvec (harm);
+  del_cvec (perc);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,78 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// aubio_mfcc_do_batch computes the same coefficients as a loop calling
+// aubio_pvoc_do and aubio_mfcc_do on each block read from a source
+int main (int argc, char **argv)
+{
+  uint_t win_s = 512, hop_s = 256, n_filters = 40, n_coefs = 13;
+  uint_t samplerate = 0, read = 0, n_ref = 0, n_frames = 0, total = 0;
+  uint_t i, j, chunk = 7, max_frames;
+  aubio_source_t *source;
+  aubio_pvoc_t *pv;
+  aubio_mfcc_t *mfcc, *batch;
+  fvec_t *in = new_fvec (hop_s);
+  cvec_t *fftgrain = new_cvec (win_s);
+  fvec_t *out = new_fvec (n_coefs);
+  fmat_t *ref, *frames = new_fmat (chunk, n_coefs);
+
+  if (argc < 2) {
+    del_fvec (in);
+    del_cvec (fftgrain);
+    del_fvec (out);
+    del_fmat (frames);
+    return run_on_default_source(main);
+  }
+
+  // reference, one block at a time
+  source = new_aubio_source (argv[1], samplerate, hop_s);
+  assert(source);
+  samplerate = aubio_source_get_samplerate (source);
+  max_frames = aubio_source_get_duration (source) / hop_s + 2;
+  ref = new_fmat (max_frames, n_coefs);
+  pv = new_aubio_pvoc (win_s, hop_s);
+  mfcc = new_aubio_mfcc (win_s, n_filters, n_coefs, samplerate);
+  assert(pv && mfcc && ref);
+  do {
+    aubio_source_do (source, in, &read);
+    aubio_pvoc_do (pv, in, fftgrain);
+    aubio_mfcc_do (mfcc, fftgrain, out);
+    assert(n_ref < max_frames);
+    for (j = 0; j < n_coefs; j++) {
+      ref->data[n_ref][j] = out->data[j];
+    }
+    n_ref++;
+  } while (read == hop_s);
+  del_aubio_source (source);
+
+  // batch, a few frames at a time
+  source = new_aubio_source (argv[1], samplerate, hop_s);
+  batch = new_aubio_mfcc (win_s, n_filters, n_coefs, samplerate);
+  assert(source && batch);
+  do {
+    assert(aubio_mfcc_do_batch (batch, source, hop_s, frames, &n_frames) == 0);
+    for (i = 0; i < n_frames; i++) {
+      for (j = 0; j < n_coefs; j++) {
+        assert(frames->data[i][j] == ref->data[total + i][j]);
+      }
+    }
+    total += n_frames;
+  } while (n_frames == chunk);
+  assert(total == n_ref);
+
+  // once the source is exhausted, no more frames are computed
+  assert(aubio_mfcc_do_batch (batch, source, hop_s, frames, &n_frames) == 0);
+  assert(n_frames == 0);
+
+  del_aubio_source (source);
+  del_aubio_mfcc (batch);
+  del_aubio_mfcc (mfcc);
+  del_aubio_pvoc (pv);
+  del_fvec (in);
+  del_cvec (fftgrain);
+  del_fvec (out);
+  del_fmat (ref);
+  del_fmat (frames);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,63 @@
+#define AUBIO_UNSTABLE 1
+#include <aubio.h>
+#include "utils_tests.h"
+
+// mfcc coefficients match the output of a filterbank followed by log10 and a
+// dct, for both plain and power of two numbers of filters
+int main (void)
+{
+  uint_t i, k, n_filters, win_s = 1024, samplerate = 44100;
+  uint_t filters[3] = { 40, 32, 13 };
+  smpl_t scale;
+
+  utils_init_random();
+  for (k = 0; k < 3; k++) {
+    n_filters = filters[k];
+    for (scale = 1.; scale < 3.; scale += 1.5) {
+      uint_t n_coefs = n_filters < 13 ? n_filters : 13;
+      aubio_mfcc_t *mfcc = new_aubio_mfcc (win_s, n_filters, n_coefs,
+          samplerate);
+      aubio_filterbank_t *fb = new_aubio_filterbank (n_filters, win_s);
+      aubio_dct_t *dct = new_aubio_dct (n_filters);
+      cvec_t *in = new_cvec (win_s);
+      cvec_t *copy = new_cvec (win_s);
+      fvec_t *bands = new_fvec (n_filters);
+      fvec_t *ref = new_fvec (n_filters);
+      fvec_t *out = new_fvec (n_coefs);
+      assert(mfcc && fb && dct && in && copy && bands && ref && out);
+
+      if (n_filters == 40)
+        aubio_filterbank_set_mel_coeffs_slaney (fb, samplerate);
+      else
+        aubio_filterbank_set_mel_coeffs (fb, samplerate, 0, samplerate/2.);
+      aubio_mfcc_set_scale (mfcc, scale);
+
+      for (i = 0; i < in->length; i++) {
+        in->norm[i] = random() / (smpl_t)RAND_MAX;
+      }
+      // the filterbank may modify its input, give each side its own copy
+      cvec_copy (in, copy);
+      aubio_mfcc_do (mfcc, in, out);
+
+      aubio_filterbank_do (fb, copy, bands);
+      fvec_log10 (bands);
+      fvec_mul (bands, scale);
+      aubio_dct_do (dct, bands, ref);
+
+      for (i = 0; i < n_coefs; i++) {
+        assert(fabs(out->data[i] - ref->data[i]) < 1.e-4);
+      }
+
+      del_aubio_mfcc (mfcc);
+      del_aubio_filterbank (fb);
+      del_aubio_dct (dct);
+      del_cvec (in);
+      del_cvec (copy);
+      del_fvec (bands);
+      del_fvec (ref);
+      del_fvec (out);
+    }
+  }
+  aubio_cleanup();
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compute the deltas and delta-deltas of a stream of coefficients, and
+// compare them to the regression formula applied to all the frames at once
+
+#define WIN 512
+#define N_COEFFS 13
+#define N_FRAMES 40
+#define WIDTH 2
+
+// coefficient i of frame t, the first frame being repeated before the start
+static smpl_t coef (fmat_t *c, sint_t t, uint_t i)
+{
+  return c->data[t < 0 ? 0 : t][i];
+}
+
+static smpl_t delta (fmat_t *c, sint_t t, uint_t i)
+{
+  smpl_t sum = 0., norm = 0.;
+  sint_t n;
+  for (n = 1; n <= WIDTH; n++) {
+    sum += n * (coef (c, t + n, i) - coef (c, t - n, i));
+    norm += 2 * n * n;
+  }
+  return sum / norm;
+}
+
+static smpl_t delta_delta (fmat_t *c, sint_t t, uint_t i)
+{
+  smpl_t sum = 0., norm = 0.;
+  sint_t n;
+  for (n = 1; n <= WIDTH; n++) {
+    sum += n * (delta (c, t + n, i) - delta (c, t - n, i));
+    norm += 2 * n * n;
+  }
+  return sum / norm;
+}
+
+int main (void)
+{
+  uint_t err = 0, t, i, j;
+  aubio_mfcc_t *plain = new_aubio_mfcc (WIN, 40, N_COEFFS, 44100);
+  aubio_mfcc_t *o = new_aubio_mfcc (WIN, 40, N_COEFFS, 44100);
+  cvec_t *in = new_cvec (WIN);
+  fvec_t *out = new_fvec (3 * N_COEFFS), *short_out = new_fvec (N_COEFFS);
+  fmat_t *coeffs = new_fmat (N_FRAMES, N_COEFFS);
+  fvec_t row;
+  smpl_t max_err = 0.;
+
+  if (!plain || !o || !in || !out || !short_out || !coeffs) return 1;
+
+  if (aubio_mfcc_set_deltas (o, 3, 2) == 0) err = 1;
+  if (aubio_mfcc_set_deltas (o, 1, 0) == 0) err = 1;
+  if (aubio_mfcc_get_delay (o) != 0) err = 1;
+  if (aubio_mfcc_set_deltas (o, 2, WIDTH) != 0) return 1;
+  if (aubio_mfcc_get_delta_order (o) != 2
+      || aubio_mfcc_get_delay (o) != 2 * WIDTH) err = 1;
+
+  row.length = N_COEFFS;
+  for (t = 0; t < N_FRAMES; t++) {
+    sint_t c = (sint_t)t - 2 * WIDTH;
+    // spectra changing from one frame to the next
+    for (j = 0; j < in->length; j++) {
+      in->norm[j] = 1. + .5 * sin (.05 * j * (1. + .1 * t)) + .01 * t;
+    }
+    row.data = coeffs->data[t];
+    aubio_mfcc_do (plain, in, &row);
+    aubio_mfcc_do (o, in, out);
+    if (c < 0) continue;
+    // the frame 2 * WIDTH hops before, and its derivatives, once the
+    // following frames were computed
+    for (i = 0; i < N_COEFFS; i++) {
+      smpl_t expected[3];
+      expected[0] = coef (coeffs, c, i);
+      expected[1] = delta (coeffs, c, i);
+      expected[2] = delta_delta (coeffs, c, i);
+      for (j = 0; j < 3; j++) {
+        smpl_t e = fabs (out->data[j * N_COEFFS + i] - expected[j]);
+        if (e > max_err) max_err = e;
+      }
+    }
+  }
+  PRINT_MSG ("largest error: %g\n", max_err);
+  if (max_err > 1.e-4) err = 1;
+
+  // deltas only, and an output too short for them
+  if (aubio_mfcc_set_deltas (o, 1, 1) != 0) err = 1;
+  fvec_zeros (short_out);
+  for (t = 0; t < 3; t++) {
+    aubio_mfcc_do (o, in, short_out);
+  }
+  for (i = 0; i < N_COEFFS; i++) {
+    if (fabs (short_out->data[i] - coeffs->data[N_FRAMES - 1][i]) > 1.e-4) {
+      err = 1;
+    }
+  }
+  // back to the coefficients alone
+  if (aubio_mfcc_set_deltas (o, 0, 0) != 0) err = 1;
+  aubio_mfcc_do (o, in, short_out);
+  for (i = 0; i < N_COEFFS; i++) {
+    if (short_out->data[i] != coeffs->data[N_FRAMES - 1][i]) err = 1;
+  }
+
+  if (err) PRINT_ERR ("wrong deltas\n");
+  del_aubio_mfcc (plain);
+  del_aubio_mfcc (o);
+  del_cvec (in);
+  del_fvec (out);
+  del_fvec (short_out);
+  del_fmat (coeffs);
+  aubio_cleanup ();
+  return err;
+}
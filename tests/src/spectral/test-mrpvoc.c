@@ -0,0 +1,99 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// the spectra of a multi-resolution phase vocoder are the ones of separate
+// phase vocoders of the same sizes, each given the input by its own hops
+
+#define HOP 256
+#define N_RES 3
+#define N_HOPS 64
+
+static const uint_t wins[N_RES] = { 512, 2048, 4096 };
+static const uint_t hops[N_RES] = { 256, 512, 1024 };
+
+static uint_t check_args (void)
+{
+  aubio_mrpvoc_t *o = new_aubio_mrpvoc (HOP);
+  fvec_t *in = new_fvec (HOP);
+  uint_t err = 0;
+  if (!o || !in) return 1;
+  if (new_aubio_mrpvoc (0)) err = 1;
+  // windows shorter than the input, hops not a multiple of it
+  if (aubio_mrpvoc_add (o, 128, 256) != -1
+      || aubio_mrpvoc_add (o, 1024, 384) != -1
+      || aubio_mrpvoc_add (o, 1024, 2048) != -1) err = 1;
+  if (aubio_mrpvoc_do (o, in) != 0) err = 1;
+  if (aubio_mrpvoc_add (o, 1024, 256) != -1) err = 1;
+  if (aubio_mrpvoc_get_spectrum (o, 0) != NULL
+      || aubio_mrpvoc_set_magnitude_only (o, 0, 1) == 0
+      || aubio_mrpvoc_set_window (o, 0, "hanning") == 0) err = 1;
+  del_aubio_mrpvoc (o);
+  del_fvec (in);
+  return err;
+}
+
+int main (void)
+{
+  aubio_mrpvoc_t *o = new_aubio_mrpvoc (HOP);
+  aubio_pvoc_t *pv[N_RES];
+  cvec_t *grain[N_RES];
+  fvec_t *signal = new_fvec (N_HOPS * HOP), in, block;
+  uint_t i, n, k, bin, computed, mem = 0, err = 0;
+  if (!o || !signal) return 1;
+  utils_init_random ();
+  for (i = 0; i < signal->length; i++) {
+    signal->data[i] = 2. * random () / (smpl_t)RAND_MAX - 1.;
+  }
+  for (k = 0; k < N_RES; k++) {
+    if (aubio_mrpvoc_add (o, wins[k], hops[k]) != (sint_t)k) return 1;
+    pv[k] = new_aubio_pvoc (wins[k], hops[k]);
+    grain[k] = new_cvec (wins[k]);
+    if (!pv[k] || !grain[k]) return 1;
+    mem += aubio_pvoc_get_memory_usage (pv[k]);
+  }
+  aubio_mrpvoc_set_magnitude_only (o, 1, 1);
+  aubio_pvoc_set_magnitude_only (pv[1], 1);
+  aubio_mrpvoc_set_window (o, 2, "blackman");
+  aubio_pvoc_set_window (pv[2], "blackman");
+  if (aubio_mrpvoc_get_n_spectra (o) != N_RES
+      || aubio_mrpvoc_get_win (o, 2) != 4096
+      || aubio_mrpvoc_get_hop (o, 2) != 1024) err = 1;
+
+  in.length = HOP;
+  for (n = 0; n < N_HOPS; n++) {
+    in.data = signal->data + n * HOP;
+    computed = aubio_mrpvoc_do (o, &in);
+    for (k = 0; k < N_RES; k++) {
+      const cvec_t *spec = aubio_mrpvoc_get_spectrum (o, k);
+      uint_t due = (n + 1) % (hops[k] / HOP) == 0;
+      if (aubio_mrpvoc_is_updated (o, k) != due) err = 1;
+      if (!due) continue;
+      computed--;
+      block.length = hops[k];
+      block.data = signal->data + (n + 1) * HOP - hops[k];
+      aubio_pvoc_do (pv[k], &block, grain[k]);
+      for (bin = 0; bin < spec->length; bin++) {
+        if (spec->norm[bin] != grain[k]->norm[bin]
+            || (k != 1 && spec->phas[bin] != grain[k]->phas[bin])) {
+          PRINT_ERR ("resolution %d differs at hop %d, bin %d\n", k, n, bin);
+          err = 1;
+          break;
+        }
+      }
+    }
+    if (computed != 0) err = 1;
+  }
+  PRINT_MSG ("%d bytes, %d for separate phase vocoders\n",
+      aubio_mrpvoc_get_memory_usage (o), mem);
+  if (aubio_mrpvoc_get_memory_usage (o) >= mem) err = 1;
+
+  if (check_args ()) err = 1;
+  for (k = 0; k < N_RES; k++) {
+    del_aubio_pvoc (pv[k]);
+    del_cvec (grain[k]);
+  }
+  del_aubio_mrpvoc (o);
+  del_fvec (signal);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,47 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// a magnitude-only phase vocoder gives the same norms as the full analysis,
+// and the phase can still be computed on request
+int main (void)
+{
+  uint_t i, j, n_iters = 20, win_s = 1024, hop_s = 256;
+  fvec_t *in = new_fvec (hop_s);
+  cvec_t *full = new_cvec (win_s);
+  cvec_t *mag = new_cvec (win_s);
+  aubio_pvoc_t *pv_full = new_aubio_pvoc (win_s, hop_s);
+  aubio_pvoc_t *pv_mag = new_aubio_pvoc (win_s, hop_s);
+
+  if (!pv_full || !pv_mag) return 1;
+
+  assert(aubio_pvoc_get_magnitude_only (pv_mag) == 0);
+  assert(aubio_pvoc_set_magnitude_only (pv_mag, 1) == 0);
+  assert(aubio_pvoc_get_magnitude_only (pv_mag) == 1);
+
+  utils_init_random();
+  for (i = 0; i < n_iters; i++) {
+    for (j = 0; j < hop_s; j++) {
+      in->data[j] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+    aubio_pvoc_do (pv_full, in, full);
+    cvec_phas_zeros (mag);
+    aubio_pvoc_do (pv_mag, in, mag);
+    for (j = 0; j < mag->length; j++) {
+      assert(mag->norm[j] == full->norm[j]);
+      // phase was not computed
+      assert(mag->phas[j] == 0.);
+    }
+    aubio_pvoc_get_phase (pv_mag, mag);
+    for (j = 0; j < mag->length; j++) {
+      assert(mag->phas[j] == full->phas[j]);
+    }
+  }
+
+  del_aubio_pvoc (pv_full);
+  del_aubio_pvoc (pv_mag);
+  del_fvec (in);
+  del_cvec (full);
+  del_cvec (mag);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compute the spectra of several channels at once, serially and with a few
+// threads, and check they are identical to the ones of one phase vocoder per
+// channel
+
+#define WIN 1024
+#define HOP 256
+#define CHANNELS 8
+#define N_BLOCKS 20
+
+static uint_t check_multi (uint_t threads, uint_t channels)
+{
+  aubio_pvoc_t *pv = new_aubio_pvoc (WIN, HOP), *refs[CHANNELS];
+  fmat_t *in = new_fmat (channels, HOP);
+  fvec_t row;
+  cvec_t *grains[CHANNELS], *ref = new_cvec (WIN);
+  uint_t n, ch, j, err = 0;
+  if (!pv || !in || !ref) return 1;
+  if (aubio_pvoc_set_threads (pv, threads)
+      || aubio_pvoc_get_threads (pv) != threads) {
+    PRINT_ERR ("failed setting %d threads\n", threads);
+    return 1;
+  }
+  for (ch = 0; ch < channels; ch++) {
+    refs[ch] = new_aubio_pvoc (WIN, HOP);
+    grains[ch] = new_cvec (WIN);
+    if (!refs[ch] || !grains[ch]) return 1;
+  }
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (ch = 0; ch < channels; ch++) {
+      for (j = 0; j < HOP; j++) {
+        in->data[ch][j] = sin (.01 * (ch + 1) * (n * HOP + j))
+          * (random () % 2001 - 1000) / 1000.;
+      }
+    }
+    aubio_pvoc_do_multi (pv, in, grains);
+    for (ch = 0; ch < channels; ch++) {
+      row.data = in->data[ch];
+      row.length = HOP;
+      aubio_pvoc_do (refs[ch], &row, ref);
+      for (j = 0; j < ref->length; j++) {
+        if (ref->norm[j] != grains[ch]->norm[j]
+            || ref->phas[j] != grains[ch]->phas[j]) err = 1;
+      }
+    }
+  }
+  PRINT_MSG ("%d channels, %d threads: %s\n", channels, threads,
+      err ? "spectra differ" : "identical spectra");
+  for (ch = 0; ch < channels; ch++) {
+    del_aubio_pvoc (refs[ch]);
+    del_cvec (grains[ch]);
+  }
+  del_aubio_pvoc (pv);
+  del_fmat (in);
+  del_cvec (ref);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_pvoc_t *pv = new_aubio_pvoc (WIN, HOP);
+  fmat_t *in = new_fmat (2, HOP / 2);
+  cvec_t *grains[2];
+  if (!pv || !in) return 1;
+  grains[0] = grains[1] = new_cvec (WIN);
+  if (!aubio_pvoc_set_threads (pv, 0)) err = 1;
+  if (aubio_pvoc_get_threads (pv) != 1) err = 1;
+  // wrong input length, nothing is computed
+  aubio_pvoc_do_multi (pv, in, grains);
+  del_cvec (grains[0]);
+  del_fmat (in);
+  del_aubio_pvoc (pv);
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+  srandom (1);
+  if (check_multi (1, CHANNELS)) err = 1;
+  if (check_multi (3, CHANNELS)) err = 1;
+  // fewer channels than threads
+  if (check_multi (4, 2)) err = 1;
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,127 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// resynthesise the spectra of a signal in batches of various sizes, and
+// compare the output to the one of aubio_pvoc_rdo called on each frame
+
+#define N_FRAMES 40
+
+static uint_t check_batch (uint_t win, uint_t hop)
+{
+  aubio_pvoc_t *ana = new_aubio_pvoc (win, hop);
+  aubio_pvoc_t *ref = new_aubio_pvoc (win, hop);
+  aubio_pvoc_t *pv = new_aubio_pvoc (win, hop);
+  fmat_t *norms = new_fmat (N_FRAMES, win / 2 + 1);
+  fmat_t *phases = new_fmat (N_FRAMES, win / 2 + 1);
+  fvec_t *in = new_fvec (hop), *expected = new_fvec (N_FRAMES * hop);
+  fvec_t *out = new_fvec (N_FRAMES * hop), chunk, view;
+  cvec_t *grain = new_cvec (win);
+  fmat_t part_norms, part_phases;
+  // batches of 1, 2, ..., the last frames being given to aubio_pvoc_rdo
+  uint_t sizes[] = { 1, 2, 3, 5, 7, 11, 0 };
+  uint_t n, j, f, done = 0;
+  smpl_t max_err = 0.;
+  if (!ana || !ref || !pv || !norms || !phases || !in || !expected || !out
+      || !grain) return 1;
+  for (n = 0; n < N_FRAMES; n++) {
+    for (j = 0; j < hop; j++) {
+      in->data[j] = sin (.03 * (n * hop + j)) * (1. + .3 * sin (.001 * j))
+        + (random () % 2001 - 1000) / 10000.;
+    }
+    aubio_pvoc_do (ana, in, grain);
+    for (j = 0; j < grain->length; j++) {
+      norms->data[n][j] = grain->norm[j];
+      phases->data[n][j] = grain->phas[j];
+    }
+    chunk.data = expected->data + n * hop;
+    chunk.length = hop;
+    aubio_pvoc_rdo (ref, grain, &chunk);
+  }
+  part_norms.length = part_phases.length = norms->length;
+  for (n = 0; sizes[n] && done + sizes[n] <= N_FRAMES; n++) {
+    part_norms.height = part_phases.height = sizes[n];
+    part_norms.data = norms->data + done;
+    part_phases.data = phases->data + done;
+    view.data = out->data + done * hop;
+    view.length = sizes[n] * hop;
+    if (aubio_pvoc_rdo_batch (pv, &part_norms, &part_phases, &view)) return 1;
+    done += sizes[n];
+  }
+  for (f = done; f < N_FRAMES; f++) {
+    for (j = 0; j < grain->length; j++) {
+      grain->norm[j] = norms->data[f][j];
+      grain->phas[j] = phases->data[f][j];
+    }
+    chunk.data = out->data + f * hop;
+    chunk.length = hop;
+    aubio_pvoc_rdo (pv, grain, &chunk);
+  }
+  for (j = 0; j < out->length; j++) {
+    smpl_t e = fabs (out->data[j] - expected->data[j]);
+    if (e > max_err) max_err = e;
+  }
+  PRINT_MSG ("win %d, hop %d: largest error %g\n", win, hop, max_err);
+
+  // an output too short for the frames
+  part_norms.height = part_phases.height = 2;
+  view.length = hop;
+  if (aubio_pvoc_rdo_batch (pv, &part_norms, &part_phases, &view) == 0) {
+    max_err = 1.;
+  }
+
+  del_aubio_pvoc (ana);
+  del_aubio_pvoc (ref);
+  del_aubio_pvoc (pv);
+  del_fmat (norms);
+  del_fmat (phases);
+  del_fvec (in);
+  del_fvec (expected);
+  del_fvec (out);
+  del_cvec (grain);
+  return max_err > 1.e-5;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_fft_t *fft = new_aubio_fft (512);
+  fmat_t *specs = new_fmat (4, 512), *frames = new_fmat (4, 512);
+  fvec_t spec, *ref = new_fvec (512);
+  uint_t i, j;
+
+  err |= check_batch (1024, 256);
+  err |= check_batch (1024, 128);
+  err |= check_batch (512, 256);
+  err |= check_batch (512, 384);
+  err |= check_batch (512, 512);
+
+  // inverse transforms of complex spectra
+  if (!fft || !specs || !frames || !ref) return 1;
+  for (i = 0; i < specs->height; i++) {
+    for (j = 0; j < specs->length; j++) {
+      specs->data[i][j] = (random () % 2001 - 1000) / 1000.;
+    }
+  }
+  if (aubio_fft_rdo_complex_batch (fft, specs, frames)) err = 1;
+  spec.length = 512;
+  for (i = 0; i < specs->height; i++) {
+    spec.data = specs->data[i];
+    aubio_fft_rdo_complex (fft, &spec, ref);
+    for (j = 0; j < ref->length; j++) {
+      if (fabs (ref->data[j] - frames->data[i][j]) > 1.e-5) err = 1;
+    }
+  }
+  // matrices of the wrong size
+  specs->length = 256;
+  if (aubio_fft_rdo_complex_batch (fft, specs, frames) == 0) err = 1;
+
+  specs->length = 512;
+
+  if (err) PRINT_ERR ("batch resynthesis differs from aubio_pvoc_rdo\n");
+  del_aubio_fft (fft);
+  del_fmat (specs);
+  del_fmat (frames);
+  del_fvec (ref);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,129 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// feed the same 16 bit samples to the integer entry points and, converted,
+// to the float ones, and check the results are identical
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define N_BLOCKS 200
+
+// decaying noise bursts over a sine, with a few clipped samples
+static void fill (s16_t *s16, fvec_t *in, uint_t n)
+{
+  uint_t j;
+  for (j = 0; j < HOP; j++) {
+    uint_t pos = (n * HOP + j) % 11025;
+    double x = .3 * sin (2. * M_PI * 220. * (n * HOP + j) / SR)
+      + exp (-(double) pos / 1500.) * (random () % 2001 - 1000) / 1000.;
+    x = x * 32768.;
+    if (x > 32767.) x = 32767.;
+    if (x < -32768.) x = -32768.;
+    s16[j] = (s16_t) x;
+    in->data[j] = s16[j] / 32768.;
+  }
+}
+
+static uint_t check_pvoc (void)
+{
+  aubio_pvoc_t *a = new_aubio_pvoc (WIN, HOP), *b = new_aubio_pvoc (WIN, HOP);
+  cvec_t *ga = new_cvec (WIN), *gb = new_cvec (WIN);
+  fvec_t *in = new_fvec (HOP), last;
+  s16_t s16[HOP];
+  uint_t n, j, err = 0;
+  if (!a || !b || !ga || !gb || !in) return 1;
+  for (n = 0; n < 10; n++) {
+    fill (s16, in, n);
+    aubio_pvoc_do (a, in, ga);
+    aubio_pvoc_do_s16 (b, s16, gb);
+    for (j = 0; j < ga->length; j++) {
+      if (ga->norm[j] != gb->norm[j] || ga->phas[j] != gb->phas[j]) err = 1;
+    }
+    aubio_pvoc_get_input (b, &last);
+    for (j = 0; j < HOP; j++) {
+      if (last.length != HOP || last.data[j] != in->data[j]) err = 1;
+    }
+  }
+  if (err) PRINT_ERR ("pvoc: spectra or input differ\n");
+  del_aubio_pvoc (a);
+  del_aubio_pvoc (b);
+  del_cvec (ga);
+  del_cvec (gb);
+  del_fvec (in);
+  return err;
+}
+
+static uint_t check_onset (const char_t *method, uint_t lowlatency)
+{
+  aubio_onset_t *a = new_aubio_onset (method, WIN, HOP, SR);
+  aubio_onset_t *b = new_aubio_onset (method, WIN, HOP, SR);
+  fvec_t *in = new_fvec (HOP), *oa = new_fvec (1), *ob = new_fvec (1);
+  s16_t s16[HOP];
+  uint_t n, count = 0, err = 0;
+  if (!a || !b || !in || !oa || !ob) return 1;
+  aubio_onset_set_lowlatency (a, lowlatency);
+  aubio_onset_set_lowlatency (b, lowlatency);
+  srandom (1);
+  for (n = 0; n < N_BLOCKS; n++) {
+    fill (s16, in, n);
+    aubio_onset_do (a, in, oa);
+    aubio_onset_do_s16 (b, s16, ob);
+    if (oa->data[0] != ob->data[0]
+        || aubio_onset_get_descriptor (a) != aubio_onset_get_descriptor (b)) {
+      err = 1;
+    }
+    if (oa->data[0] != 0.) count++;
+  }
+  PRINT_MSG ("onset %s, low latency %d: %d onsets\n", method, lowlatency,
+      count);
+  if (err || count < 3) {
+    PRINT_ERR ("onset %s: results differ\n", method);
+    err = 1;
+  }
+  del_aubio_onset (a);
+  del_aubio_onset (b);
+  del_fvec (in);
+  del_fvec (oa);
+  del_fvec (ob);
+  return err;
+}
+
+static uint_t check_pitch (const char_t *method)
+{
+  aubio_pitch_t *a = new_aubio_pitch (method, WIN, HOP, SR);
+  aubio_pitch_t *b = new_aubio_pitch (method, WIN, HOP, SR);
+  fvec_t *in = new_fvec (HOP), *pa = new_fvec (1), *pb = new_fvec (1);
+  s16_t s16[HOP];
+  uint_t n, err = 0;
+  if (!a || !b || !in || !pa || !pb) return 1;
+  srandom (1);
+  for (n = 0; n < 40; n++) {
+    fill (s16, in, n);
+    aubio_pitch_do (a, in, pa);
+    aubio_pitch_do_s16 (b, s16, pb);
+    if (pa->data[0] != pb->data[0]) err = 1;
+  }
+  PRINT_MSG ("pitch %s: last estimate %f\n", method, pb->data[0]);
+  if (err) PRINT_ERR ("pitch %s: results differ\n", method);
+  del_aubio_pitch (a);
+  del_aubio_pitch (b);
+  del_fvec (in);
+  del_fvec (pa);
+  del_fvec (pb);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  srandom (1);
+  if (check_pvoc ()) err = 1;
+  if (check_onset ("default", 0)) err = 1;
+  if (check_onset ("complex", 0)) err = 1;
+  if (check_onset ("default", 1)) err = 1;
+  if (check_pitch ("yinfft")) err = 1;
+  if (check_pitch ("mcomb")) err = 1;
+  aubio_cleanup ();
+  return err;
+}
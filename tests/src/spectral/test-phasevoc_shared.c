@@ -0,0 +1,76 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// onset, tempo, pitch and mfcc objects share the spectrum of one phase vocoder
+// and give the same results as when computing their own
+int main (void)
+{
+  uint_t i, j, n_iters = 200, samplerate = 44100;
+  uint_t win_s = 1024, hop_s = 256;
+  fvec_t *in = new_fvec (hop_s);
+  cvec_t *fftgrain = new_cvec (win_s);
+  fvec_t *out = new_fvec (1);
+  fvec_t *ref = new_fvec (1);
+  fvec_t *coeffs = new_fvec (13);
+  aubio_pvoc_t *pv = new_aubio_pvoc (win_s, hop_s);
+  aubio_onset_t *onset = new_aubio_onset ("complex", win_s, hop_s, samplerate);
+  aubio_onset_t *onset_ref = new_aubio_onset ("complex", win_s, hop_s,
+      samplerate);
+  aubio_tempo_t *tempo = new_aubio_tempo ("default", win_s, hop_s, samplerate);
+  aubio_tempo_t *tempo_ref = new_aubio_tempo ("default", win_s, hop_s,
+      samplerate);
+  aubio_pitch_t *pitch = new_aubio_pitch ("yinfft", win_s, hop_s, samplerate);
+  aubio_pitch_t *pitch_ref = new_aubio_pitch ("yinfft", win_s, hop_s,
+      samplerate);
+  aubio_mfcc_t *mfcc = new_aubio_mfcc (win_s, 40, 13, samplerate);
+
+  if (!pv || !onset || !onset_ref || !tempo || !tempo_ref
+      || !pitch || !pitch_ref || !mfcc) return 1;
+
+  utils_init_random();
+  for (i = 0; i < n_iters; i++) {
+    for (j = 0; j < hop_s; j++) {
+      // a 440 Hz tone with clicks and some noise
+      in->data[j] = 0.5 * sin(2. * M_PI * 440. * (i * hop_s + j) / samplerate)
+        + 0.01 * random() / (smpl_t)RAND_MAX;
+    }
+    if (i % 20 == 0) in->data[0] = 1.;
+    aubio_pvoc_do (pv, in, fftgrain);
+
+    aubio_onset_do_spectrum (onset, in, fftgrain, out);
+    aubio_onset_do (onset_ref, in, ref);
+    assert(out->data[0] == ref->data[0]);
+
+    aubio_tempo_do_spectrum (tempo, in, fftgrain, out);
+    aubio_tempo_do (tempo_ref, in, ref);
+    if (ref->data[0] == 0) {
+      assert(out->data[0] == 0);
+    } else {
+      assert(fabs(out->data[0] - ref->data[0]) < 1.e-3);
+    }
+
+    aubio_pitch_do_spectrum (pitch, in, fftgrain, out);
+    aubio_pitch_do (pitch_ref, in, ref);
+    assert(fabs(out->data[0] - ref->data[0]) < 1.);
+
+    aubio_mfcc_do (mfcc, fftgrain, coeffs);
+  }
+  assert(aubio_onset_get_last (onset) == aubio_onset_get_last (onset_ref));
+  assert(aubio_tempo_get_last (tempo) == aubio_tempo_get_last (tempo_ref));
+
+  del_aubio_pvoc (pv);
+  del_aubio_onset (onset);
+  del_aubio_onset (onset_ref);
+  del_aubio_tempo (tempo);
+  del_aubio_tempo (tempo_ref);
+  del_aubio_pitch (pitch);
+  del_aubio_pitch (pitch_ref);
+  del_aubio_mfcc (mfcc);
+  del_fvec (in);
+  del_cvec (fftgrain);
+  del_fvec (out);
+  del_fvec (ref);
+  del_fvec (coeffs);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+#include "utils_tests.h"
+
+// compare the bins of the sliding DFT bank to a direct DFT of the last
+// window, after a long signal and after changing a frequency, and the kernels
+// of each instruction set to the scalar ones
+
+#define SR 44100
+#define WIN 1024
+#define N_BINS 12
+#define HOP 300
+
+#if !HAVE_AUBIO_DOUBLE
+#define MAX_ERR 1.e-3
+#else
+#define MAX_ERR 1.e-6
+#endif
+
+static smpl_t signal_at (uint_t i)
+{
+  return .3 * SIN (2. * PI * 86.1328125 * i / SR)
+    + .2 * SIN (2. * PI * 1234.5 * i / SR) + .1 * ((i * 7919) % 201 - 100.)
+    / 100.;
+}
+
+// largest difference between the bins and a direct DFT of the last window,
+// relative to the largest bin
+static smpl_t compare (const aubio_sdft_t *o, const fvec_t *out, uint_t end)
+{
+  uint_t k, m;
+  smpl_t max_err = 0., max_mag = 0.;
+  for (k = 0; k < aubio_sdft_get_n_bins (o); k++) {
+    double omega = 2. * M_PI * aubio_sdft_get_freq (o, k) / SR;
+    double re = 0., im = 0.;
+    for (m = 0; m < WIN; m++) {
+      double x = signal_at (end - 1 - m);
+      re += x * cos (omega * m);
+      im -= x * sin (omega * m);
+    }
+    max_err = MAX (max_err, fabs (out->data[k] - 2. / WIN * sqrt (re * re
+            + im * im)));
+    max_mag = MAX (max_mag, out->data[k]);
+  }
+  return max_err / max_mag;
+}
+
+static uint_t check_bank (void)
+{
+  aubio_sdft_t *o = new_aubio_sdft (N_BINS, WIN, SR);
+  aubio_sdft_t *all = new_aubio_sdft (N_BINS, WIN, SR);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (N_BINS);
+  fmat_t *mags = new_fmat (N_BINS, HOP);
+  uint_t n, j, k, err = 0, n_blocks = 10 * SR / HOP;
+  smpl_t diff = 0., max_err;
+  if (!o || !all || !in || !out || !mags) return 1;
+  // on the bins, and in between
+  for (k = 0; k < N_BINS; k++) {
+    smpl_t freq = (k % 2) ? 60. + 37.3 * k : 86.1328125 * (k + 1);
+    if (aubio_sdft_set_freq (o, k, freq)) err = 1;
+    if (aubio_sdft_set_freq (all, k, freq)) err = 1;
+  }
+  // ten seconds
+  for (n = 0; n < n_blocks; n++) {
+    for (j = 0; j < HOP; j++) in->data[j] = signal_at (n * HOP + j);
+    aubio_sdft_do (o, in, out);
+    aubio_sdft_do_all (all, in, mags);
+    for (k = 0; k < N_BINS; k++) {
+      diff = MAX (diff, fabs (mags->data[k][HOP - 1] - out->data[k]));
+    }
+  }
+  max_err = compare (o, out, n_blocks * HOP);
+  PRINT_MSG ("after %d samples: error %g, bin 0 at %f, do_all difference %g\n",
+      n_blocks * HOP, max_err, out->data[0], diff);
+  if (max_err > MAX_ERR || diff > 0. || fabs (out->data[0] - .3) > .01) err = 1;
+  // a new frequency is exact at once
+  if (aubio_sdft_set_freq (o, 3, 1234.5)) err = 1;
+  for (j = 0; j < HOP; j++) in->data[j] = signal_at (n_blocks * HOP + j);
+  aubio_sdft_do (o, in, out);
+  max_err = compare (o, out, (n_blocks + 1) * HOP);
+  PRINT_MSG ("after changing a frequency: error %g, bin 3 at %f\n", max_err,
+      out->data[3]);
+  if (max_err > MAX_ERR || fabs (out->data[3] - .2) > .02) err = 1;
+  del_aubio_sdft (o);
+  del_aubio_sdft (all);
+  del_fvec (in);
+  del_fvec (out);
+  del_fmat (mags);
+  return err;
+}
+
+// an empty value selects the default table
+static void set_isa (const char_t *isa)
+{
+#ifdef _WIN32
+  _putenv_s("AUBIO_SIMD", isa);
+#else
+  setenv("AUBIO_SIMD", isa, 1);
+#endif
+}
+
+// the output of a bank with an instruction set
+static fmat_t *render (const char_t *isa)
+{
+  aubio_sdft_t *o = new_aubio_sdft (N_BINS + 7, WIN, SR);
+  fvec_t *in = new_fvec (HOP);
+  fmat_t *mags = new_fmat (N_BINS + 7, HOP);
+  uint_t n, j;
+  set_isa (isa);
+  aubio_simd_init ();
+  for (n = 0; n < 20; n++) {
+    for (j = 0; j < HOP; j++) in->data[j] = signal_at (n * HOP + j);
+    aubio_sdft_do_all (o, in, mags);
+  }
+  del_aubio_sdft (o);
+  del_fvec (in);
+  return mags;
+}
+
+static uint_t check_kernels (void)
+{
+  const char_t *isas[] = { "sse2", "avx2", "avx512", "neon" };
+  fmat_t *ref = render ("scalar");
+  uint_t i, j, k, err = 0;
+  for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+    fmat_t *mags = render (isas[i]);
+    smpl_t max_err = 0.;
+    if (strcmp (AUBIO_SIMD()->name, isas[i]) == 0) {
+      for (k = 0; k < ref->height; k++) {
+        for (j = 0; j < ref->length; j++) {
+          max_err = MAX (max_err, fabs (mags->data[k][j] - ref->data[k][j]));
+        }
+      }
+      PRINT_MSG ("%s: max difference %g\n", isas[i], max_err);
+      if (max_err > 1.e-5) err = 1;
+    }
+    del_fmat (mags);
+  }
+  del_fmat (ref);
+  set_isa ("");
+  aubio_simd_init ();
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_sdft_t *o;
+  if (new_aubio_sdft (0, WIN, SR)) err = 1;
+  if (new_aubio_sdft (N_BINS, 1, SR)) err = 1;
+  if (new_aubio_sdft (N_BINS, WIN, 0)) err = 1;
+  o = new_aubio_sdft (N_BINS, WIN, SR);
+  if (!o) return 1;
+  if (!aubio_sdft_set_freq (o, N_BINS, 100.)) err = 1;
+  if (!aubio_sdft_set_freq (o, 0, SR)) err = 1;
+  if (aubio_sdft_get_n_bins (o) != N_BINS
+      || aubio_sdft_get_freq (o, 1) != 2. * SR / WIN) err = 1;
+  del_aubio_sdft (o);
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+  if (check_bank ()) err = 1;
+  if (check_kernels ()) {
+    PRINT_ERR ("kernels do not match the scalar ones\n");
+    err = 1;
+  }
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,127 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+#include "utils_tests.h"
+
+// check the kernels of the onset functions of each available instruction set
+// against plain loops in double precision. The kl and mkl kernels use an
+// approximation of the log, whose absolute error should stay below
+// 1.e-6 * (1 + |log(x)|) in single precision, and 1.e-12 * (1 + |log(x)|) in
+// double precision.
+
+#if !HAVE_AUBIO_DOUBLE
+#define LOG_TOL 1.e-6
+#define SUM_TOL 1.e-5
+#else
+#define LOG_TOL 1.e-12
+#define SUM_TOL 1.e-10
+#endif
+
+static uint_t check_log (const aubio_simd_ops_t *ops)
+{
+  uint_t j, n = 4001, err = 0;
+  fvec_t *x = new_fvec(n), *y = new_fvec(n);
+  double max_err = 0.;
+  // from 1.e-30 to 1.e30, then around 1
+  for (j = 0; j < n; j++) {
+    x->data[j] = (j < n / 2) ? pow(10., -30. + 60. * j / (n / 2))
+      : 1. + (j - n / 2.) / n;
+  }
+  fvec_copy(x, y);
+  ops->vlog(y->data, n);
+  for (j = 0; j < n; j++) {
+    double ref = log((double)x->data[j]);
+    double e = fabs(y->data[j] - ref) / (1. + fabs(ref));
+    if (e > max_err) max_err = e;
+  }
+  PRINT_MSG("%s: log error %g\n", ops->name, max_err);
+  if (max_err > LOG_TOL) err = 1;
+  del_fvec(x);
+  del_fvec(y);
+  return err;
+}
+
+static uint_t check_kernels (const aubio_simd_ops_t *ops)
+{
+  uint_t length, j, w, err = 0;
+  for (length = 1; length < 70; length++) {
+    fvec_t *x = new_fvec(length), *old = new_fvec(length);
+    fvec_t *dev = new_fvec(length);
+    smpl_t thres = .1;
+    double hfc = 0., flux = 0., kl[2] = { 0., 0. }, scale = 0.;
+    for (j = 0; j < length; j++) {
+      x->data[j] = .05 * (j % 11) + .01 * (j % 3);
+      old->data[j] = .07 * ((j + 4) % 9);
+      hfc += (j + 1.) * x->data[j];
+      scale += (j + 1.) * x->data[j] + x->data[j];
+      if (x->data[j] > old->data[j]) flux += x->data[j] - old->data[j];
+    }
+    if (fabs(ops->ramp_dot(x->data, length) - hfc) > SUM_TOL * scale) err = 1;
+    if (fabs(ops->flux(x->data, old->data, length) - flux) > SUM_TOL * scale)
+      err = 1;
+    for (j = 0; j < length; j++) {
+      if (old->data[j] != x->data[j]) err = 1;
+      old->data[j] = .07 * ((j + 4) % 9);
+    }
+    ops->sqdev(x->data, old->data, dev->data, thres, length);
+    for (j = 0; j < length; j++) {
+      double o = .07 * ((j + 4) % 9), d = 0.;
+      if (x->data[j] > thres) {
+        d = sqrt(fabs((double)x->data[j] * x->data[j] - o * o));
+      }
+      if (fabs(dev->data[j] - d) > SUM_TOL) err = 1;
+      if (old->data[j] != x->data[j]) err = 1;
+    }
+    for (w = 0; w < 2; w++) {
+      double l;
+      for (j = 0; j < length; j++) {
+        old->data[j] = .07 * ((j + 4) % 9);
+        l = log(1. + x->data[j] / (old->data[j] + .1));
+        kl[w] += w ? x->data[j] * l : l;
+      }
+      l = ops->kl(x->data, old->data, w, length);
+      if (fabs(l - kl[w]) > SUM_TOL * (1. + fabs(kl[w]))) err = 1;
+      for (j = 0; j < length; j++) {
+        if (old->data[j] != x->data[j]) err = 1;
+      }
+    }
+    del_fvec(x);
+    del_fvec(old);
+    del_fvec(dev);
+  }
+  return err;
+}
+
+// an empty value selects the default table
+static void set_isa (const char_t *isa)
+{
+#ifdef _WIN32
+  _putenv_s("AUBIO_SIMD", isa);
+#else
+  setenv("AUBIO_SIMD", isa, 1);
+#endif
+}
+
+int main (void)
+{
+  const char_t *isas[] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+  const aubio_simd_ops_t *ops;
+  uint_t i, err = 0;
+  for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+    set_isa(isas[i]);
+    // unsupported instruction sets fall back to the default table
+    ops = aubio_simd_init();
+    if (strcmp(ops->name, isas[i]) != 0) continue;
+    if (check_log(ops)) {
+      PRINT_ERR("%s: log approximation out of bounds\n", ops->name);
+      err = 1;
+    }
+    if (check_kernels(ops)) {
+      PRINT_ERR("%s: onset kernels do not match\n", ops->name);
+      err = 1;
+    }
+  }
+  set_isa("");
+  aubio_simd_init();
+  return err;
+}
@@ -0,0 +1,63 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compute several descriptors at once, and check each matches the result of
+// its own specdesc object over a few frames
+
+#define N_METHODS 8
+
+int main (void)
+{
+  const char_t *methods = "hfc, complex specflux kl mkl energy specdiff centroid";
+  const char_t *names[N_METHODS] = { "hfc", "complex", "specflux", "kl", "mkl",
+    "energy", "specdiff", "centroid" };
+  uint_t win_s = 1024, i, j, frame, err = 0;
+  cvec_t *in = new_cvec (win_s);
+  fvec_t *out = new_fvec (N_METHODS), *single = new_fvec (1);
+  aubio_specdesc_t *o[N_METHODS];
+  aubio_specdesc_multi_t *m = new_aubio_specdesc_multi (methods, win_s);
+  if (!m || !in || !out || !single) return 1;
+  if (aubio_specdesc_multi_get_count (m) != N_METHODS) return 1;
+  for (i = 0; i < N_METHODS; i++) {
+    o[i] = new_aubio_specdesc (names[i], win_s);
+    if (!o[i]) return 1;
+  }
+  utils_init_random();
+  for (frame = 0; frame < 10; frame++) {
+    for (j = 0; j < in->length; j++) {
+      in->norm[j] = (smpl_t)random() / RAND_MAX;
+      in->phas[j] = (smpl_t)random() / RAND_MAX * 2. * M_PI - M_PI;
+    }
+    aubio_specdesc_multi_do (m, in, out);
+    for (i = 0; i < N_METHODS; i++) {
+      aubio_specdesc_do (o[i], in, single);
+      // the kl methods of single objects approximate the log
+      if (fabs(out->data[i] - single->data[0])
+          > 1.e-4 * (1. + fabs(single->data[0]))) {
+        PRINT_ERR("frame %d, %s: got %f, expected %f\n", frame, names[i],
+            out->data[i], single->data[0]);
+        err = 1;
+      }
+    }
+  }
+  for (i = 0; i < N_METHODS; i++) {
+    del_aubio_specdesc (o[i]);
+  }
+  del_aubio_specdesc_multi (m);
+
+  // wrong arguments
+  if (new_aubio_specdesc_multi ("hfc unknown", win_s)) err = 1;
+  if (new_aubio_specdesc_multi (" , ", win_s)) err = 1;
+  // too short output
+  m = new_aubio_specdesc_multi ("hfc kl", win_s);
+  fvec_zeros (single);
+  aubio_specdesc_multi_do (m, in, single);
+  if (single->data[0] != 0.) err = 1;
+  del_aubio_specdesc_multi (m);
+
+  del_cvec (in);
+  del_fvec (out);
+  del_fvec (single);
+  aubio_cleanup ();
+  return err;
+}
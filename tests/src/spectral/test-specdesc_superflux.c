@@ -0,0 +1,85 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// play a note with a wide vibrato, then a new note, and compare the response
+// of specflux and superflux to the vibrato, relative to the onset
+
+#define SR 44100
+#define WIN 1024
+#define HOP 256
+#define N_BLOCKS 160
+
+// largest descriptor value during the vibrato, over the one at the onset
+static smpl_t vibrato_ratio (const char_t *method)
+{
+  aubio_pvoc_t *pv = new_aubio_pvoc (WIN, HOP);
+  aubio_specdesc_t *o = new_aubio_specdesc (method, WIN);
+  fvec_t *in = new_fvec (HOP), *desc = new_fvec (1);
+  cvec_t *grain = new_cvec (WIN);
+  double phase[5] = { 0. };
+  smpl_t steady = 0., onset = 0.;
+  uint_t n, j, k;
+  if (!pv || !o || !in || !desc || !grain) return 1.;
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (j = 0; j < HOP; j++) {
+      double t = (double)(n * HOP + j) / SR;
+      // a semitone of vibrato at 6Hz around A3, then C4 from block 120
+      double f0 = n < 120 ? 220. * pow (2., sin (2. * M_PI * 6. * t) / 12.)
+        : 261.63;
+      in->data[j] = 0.;
+      for (k = 0; k < 5; k++) {
+        phase[k] += 2. * M_PI * f0 * (k + 1) / SR;
+        in->data[j] += .2 * sin (phase[k]) / (k + 1);
+      }
+    }
+    aubio_pvoc_do (pv, in, grain);
+    aubio_specdesc_do (o, grain, desc);
+    // skip the start of the first note
+    if (n >= 20 && n < 120 && desc->data[0] > steady) steady = desc->data[0];
+    if (n >= 120 && desc->data[0] > onset) onset = desc->data[0];
+  }
+  del_aubio_pvoc (pv);
+  del_aubio_specdesc (o);
+  del_fvec (in);
+  del_fvec (desc);
+  del_cvec (grain);
+  PRINT_MSG ("%s: %f during the vibrato, %f at the onset\n", method, steady,
+      onset);
+  return onset > 0. ? steady / onset : 1.;
+}
+
+int main (void)
+{
+  uint_t err = 0, j;
+  smpl_t flux = vibrato_ratio ("specflux");
+  smpl_t superflux = vibrato_ratio ("superflux");
+  aubio_specdesc_t *o;
+  cvec_t *in;
+  fvec_t *out;
+
+  // the vibrato is mostly suppressed
+  if (superflux > .5 * flux || superflux > .1) err = 1;
+
+  // zero on silence and on a constant spectrum, positive when it rises
+  o = new_aubio_specdesc ("superflux", 512);
+  in = new_cvec (512);
+  out = new_fvec (1);
+  if (!o || !in || !out) return 1;
+  aubio_specdesc_do (o, in, out);
+  if (out->data[0] != 0.) err = 1;
+  for (j = 0; j < in->length; j++) in->norm[j] = 1. + j % 7;
+  aubio_specdesc_do (o, in, out);
+  if (!(out->data[0] > 0.)) err = 1;
+  aubio_specdesc_do (o, in, out);
+  if (out->data[0] != 0.) err = 1;
+  if (aubio_specdesc_uses_phase (o)) err = 1;
+  del_aubio_specdesc (o);
+  del_cvec (in);
+  del_fvec (out);
+
+  if (new_aubio_specdesc ("superflux", 1)) err = 1;
+
+  if (err) PRINT_ERR ("superflux does not suppress the vibrato\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,80 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compute all the spectral shape descriptors at once, and check they match
+// those of the individual specdesc objects
+
+// centroid and spread of a long spectrum, against sums in double precision
+static uint_t check_long_sums (void)
+{
+  uint_t j, err = 0;
+  cvec_t *in = new_cvec (16384);
+  fvec_t *shape = new_fvec (AUBIO_SPECTRAL_SHAPE_LENGTH);
+  double sum = 0., sc = 0., m2 = 0., centroid;
+  if (!in || !shape) return 1;
+  for (j = 0; j < in->length; j++) {
+    in->norm[j] = 1. + .5 * sin (.01 * j) + 1.e-3 * j;
+    sum += in->norm[j];
+    sc += (double) j * in->norm[j];
+  }
+  centroid = sc / sum;
+  for (j = 0; j < in->length; j++) {
+    m2 += (j - centroid) * (j - centroid) * in->norm[j];
+  }
+  m2 /= sum;
+  aubio_spectral_shape_do (in, shape);
+  PRINT_MSG ("long spectrum: centroid error %g, spread error %g\n",
+      fabs (shape->data[0] / centroid - 1.), fabs (shape->data[1] / m2 - 1.));
+  if (fabs (shape->data[0] / centroid - 1.) > 1.e-5
+      || fabs (shape->data[1] / m2 - 1.) > 1.e-5) {
+    PRINT_ERR ("centroid %f and spread %f, expected %f and %f\n",
+        shape->data[0], shape->data[1], centroid, m2);
+    err = 1;
+  }
+  del_cvec (in);
+  del_fvec (shape);
+  return err;
+}
+
+int main (void)
+{
+  const char_t *names[AUBIO_SPECTRAL_SHAPE_LENGTH] = { "centroid", "spread",
+    "skewness", "kurtosis", "slope", "decrease", "rolloff" };
+  uint_t win_s = 1024, i, j, frame, err = 0;
+  cvec_t *in = new_cvec (win_s);
+  fvec_t *shape = new_fvec (AUBIO_SPECTRAL_SHAPE_LENGTH);
+  fvec_t *single = new_fvec (1);
+  aubio_specdesc_t *o[AUBIO_SPECTRAL_SHAPE_LENGTH];
+  for (i = 0; i < AUBIO_SPECTRAL_SHAPE_LENGTH; i++) {
+    o[i] = new_aubio_specdesc (names[i], win_s);
+    if (!o[i]) return 1;
+  }
+  utils_init_random();
+  for (frame = 0; frame < 6; frame++) {
+    for (j = 0; j < in->length; j++) {
+      // a decreasing spectrum, silent on the first frame
+      in->norm[j] = frame ? (smpl_t)random() / RAND_MAX / (1. + .01 * j) : 0.;
+    }
+    aubio_spectral_shape_do (in, shape);
+    for (i = 0; i < AUBIO_SPECTRAL_SHAPE_LENGTH; i++) {
+      aubio_specdesc_do (o[i], in, single);
+      if (fabs(shape->data[i] - single->data[0])
+          > 1.e-3 * (1. + fabs(single->data[0]))) {
+        PRINT_ERR("frame %d, %s: got %f, expected %f\n", frame, names[i],
+            shape->data[i], single->data[0]);
+        err = 1;
+      }
+    }
+  }
+  for (i = 0; i < AUBIO_SPECTRAL_SHAPE_LENGTH; i++) {
+    del_aubio_specdesc (o[i]);
+  }
+  // too short output
+  aubio_spectral_shape_do (in, single);
+  if (check_long_sums ()) err = 1;
+  del_cvec (in);
+  del_fvec (shape);
+  del_fvec (single);
+  aubio_cleanup ();
+  return err;
+}
@@ -1,4 +1,92 @@
 #include <aubio.h>
+#include "utils_tests.h"
+
+// reference implementation, the loop of the original aubio_tss_do
+typedef struct {
+  fvec_t *theta1, *theta2, *oft1, *oft2;
+} ref_tss_t;
+
+static void ref_tss_do (ref_tss_t *r, const cvec_t *in, smpl_t parm,
+    smpl_t alpha, smpl_t beta, fvec_t *tm, fvec_t *sm)
+{
+  uint_t j;
+  for (j = 0; j < in->length; j++) {
+    double dev = in->phas[j] - 2. * r->theta1->data[j] + r->theta2->data[j];
+    double t, s;
+    dev = fmod(dev + M_PI, 2. * M_PI);
+    if (dev < 0) dev += 2. * M_PI;
+    dev -= M_PI;
+    r->theta2->data[j] = r->theta1->data[j];
+    r->theta1->data[j] = in->phas[j];
+    tm->data[j] = fabs(dev) > parm * r->oft1->data[j];
+    sm->data[j] = fabs(dev) < parm * r->oft2->data[j];
+    t = in->norm[j] * tm->data[j];
+    s = in->norm[j] * sm->data[j];
+    r->oft1->data[j] = (t == 0.) + alpha * (t > 0.);
+    r->oft1->data[j] += beta * (r->oft1->data[j] > 1. && t > 0.);
+    r->oft2->data[j] = (s == 0.) + alpha * (s > 0.);
+    r->oft2->data[j] += beta * (r->oft2->data[j] > 1. && s > 0.);
+  }
+}
+
+// compare the masks to the reference on random frames, with bins close to the
+// thresholds set apart: allow a few mismatches, and only if they are isolated
+static uint_t test_masks (uint_t win_s, uint_t hop_s)
+{
+  uint_t i, j, nbins = win_s / 2 + 1, err = 0, mismatches = 0;
+  smpl_t thrsfact = 2. * M_PI * hop_s / nbins, parm = .25 * thrsfact;
+  cvec_t *in = new_cvec(win_s), *ctrans = new_cvec(win_s);
+  cvec_t *cstead = new_cvec(win_s);
+  fvec_t *tm = new_fvec(nbins), *sm = new_fvec(nbins);
+  fvec_t *rtm = new_fvec(nbins), *rsm = new_fvec(nbins);
+  ref_tss_t r = { new_fvec(nbins), new_fvec(nbins), new_fvec(nbins),
+    new_fvec(nbins) };
+  aubio_tss_t *o = new_aubio_tss(win_s, hop_s);
+  aubio_tss_t *p = new_aubio_tss(win_s, hop_s);
+  for (i = 0; i < 20; i++) {
+    for (j = 0; j < nbins; j++) {
+      // some silent bins, and some bins with a steady phase increment
+      in->norm[j] = (rand() % 5) ? (smpl_t)rand() / RAND_MAX : 0.;
+      in->phas[j] = (j % 3) ? M_PI * (2. * rand() / RAND_MAX - 1.)
+        : fmod(j * i * .1, 2. * M_PI) - M_PI;
+    }
+    aubio_tss_do_masks(o, in, tm, sm);
+    aubio_tss_do(p, in, ctrans, cstead);
+    ref_tss_do(&r, in, parm, 3., 4., rtm, rsm);
+    for (j = 0; j < nbins; j++) {
+      if (tm->data[j] != rtm->data[j] || sm->data[j] != rsm->data[j]) {
+        mismatches++;
+        // realign the reference state on the tested one
+        r.oft1->data[j] = (in->norm[j] * tm->data[j] > 0.) ? 7. : 1.;
+        r.oft2->data[j] = (in->norm[j] * sm->data[j] > 0.) ? 7. : 1.;
+      }
+      if (ctrans->norm[j] != in->norm[j] * tm->data[j]
+          || ctrans->phas[j] != in->phas[j] * tm->data[j]
+          || cstead->norm[j] != in->norm[j] * sm->data[j]
+          || cstead->phas[j] != in->phas[j] * sm->data[j]) {
+        err = 1;
+      }
+    }
+  }
+  if (mismatches > 2) {
+    PRINT_ERR("tss: %d bins differ from the reference\n", mismatches);
+    err = 1;
+  }
+  del_aubio_tss(o);
+  del_aubio_tss(p);
+  del_cvec(in);
+  del_cvec(ctrans);
+  del_cvec(cstead);
+  del_fvec(tm);
+  del_fvec(sm);
+  del_fvec(rtm);
+  del_fvec(rsm);
+  del_fvec(r.theta1);
+  del_fvec(r.theta2);
+  del_fvec(r.oft1);
+  del_fvec(r.oft2);
+  return err;
+}
 
 int main (void)
 {
@@ -22,6 +110,11 @@ int main (void)
   aubio_pvoc_t * pvt = new_aubio_pvoc(win_s,hop_s);
   aubio_pvoc_t * pvs = new_aubio_pvoc(win_s,hop_s);
 
+  // check the masks, on bins of several sizes
+  if (test_masks(win_s, hop_s) || test_masks(64, 16) || test_masks(30, 15)) {
+    return 1;
+  }
+
   /* execute stft */
   while ( n-- ) {
     // fftgrain = pv(in)
@@ -0,0 +1,165 @@
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+/* mkdtemp() */
+#define _XOPEN_SOURCE 700
+#endif
+
+#include <aubio.h>
+#include "utils_tests.h"
+
+// decode a sample once, share it between several polyphonic samplers, and
+// map it from a cache directory
+
+#define SR 44100
+#define HOP 256
+#define N_FRAMES 1000
+
+// write a stereo ramp, left channel positive, right channel negative
+static int write_sample (const char_t *path)
+{
+  aubio_sink_t *sink = new_aubio_sink(path, 0);
+  fmat_t *frames = new_fmat(2, N_FRAMES);
+  uint_t i;
+  if (!sink || !frames) return 1;
+  aubio_sink_preset_samplerate(sink, SR);
+  aubio_sink_preset_channels(sink, 2);
+  for (i = 0; i < N_FRAMES; i++) {
+    frames->data[0][i] = i / (smpl_t)N_FRAMES / 2.;
+    frames->data[1][i] = - (smpl_t)i / N_FRAMES / 4.;
+  }
+  aubio_sink_do_multi(sink, frames, N_FRAMES);
+  del_aubio_sink(sink);
+  del_fmat(frames);
+  return 0;
+}
+
+static uint_t check_clip (const aubio_clip_t *clip)
+{
+  uint_t i;
+  if (aubio_clip_get_length(clip) != N_FRAMES
+      || aubio_clip_get_channels(clip) != 2
+      || aubio_clip_get_samplerate(clip) != SR
+      || aubio_clip_get_data(clip, 2) != NULL) {
+    PRINT_ERR("wrong clip: %d frames, %d channels at %dHz\n",
+        aubio_clip_get_length(clip), aubio_clip_get_channels(clip),
+        aubio_clip_get_samplerate(clip));
+    return 1;
+  }
+  for (i = 0; i < N_FRAMES; i++) {
+    if (fabs(aubio_clip_get_data(clip, 0)[i] - i / (smpl_t)N_FRAMES / 2.)
+        > 1.e-4) return 1;
+    if (fabs(aubio_clip_get_data(clip, 1)[i] + i / (smpl_t)N_FRAMES / 4.)
+        > 1.e-4) return 1;
+  }
+  return 0;
+}
+
+// two voices started 2 blocks apart, the mono mix of the sample is
+// i / N_FRAMES / 8
+static uint_t check_sampler (const char_t *path)
+{
+  aubio_sampler_t *sampler = new_aubio_sampler(SR, HOP);
+  fvec_t *out = new_fvec(HOP);
+  uint_t b, i, err = 0;
+  if (!sampler || !out) return 1;
+  if (aubio_sampler_play(sampler) == 0) err = 1;
+  if (aubio_sampler_set_voices(sampler, 0) == 0) err = 1;
+  if (aubio_sampler_load(sampler, path)) return 1;
+  if (aubio_sampler_set_voices(sampler, 2)) return 1;
+  if (aubio_sampler_get_voices(sampler) != 2) err = 1;
+  for (b = 0; b < 8; b++) {
+    if (b == 0 || b == 2) aubio_sampler_play(sampler);
+    fvec_zeros(out);
+    aubio_sampler_do(sampler, NULL, out);
+    for (i = 0; i < HOP; i++) {
+      uint_t t = b * HOP + i;
+      smpl_t expected = 0.;
+      if (t < N_FRAMES) expected += t / (smpl_t)N_FRAMES / 8.;
+      if (t >= 2 * HOP && t - 2 * HOP < N_FRAMES) {
+        expected += (t - 2 * HOP) / (smpl_t)N_FRAMES / 8.;
+      }
+      if (fabs(out->data[i] - expected) > 1.e-4) {
+        PRINT_ERR("frame %d: got %f, expected %f\n", t, out->data[i],
+            expected);
+        err = 1;
+        break;
+      }
+    }
+  }
+  if (aubio_sampler_get_playing(sampler)) {
+    PRINT_ERR("sampler still playing after the end of its voices\n");
+    err = 1;
+  }
+  del_aubio_sampler(sampler);
+  del_fvec(out);
+  return err;
+}
+
+#ifdef HAVE_MMAP
+#include <dirent.h>
+
+// remove the cached files, then the directory
+static void remove_dir (const char_t *dir)
+{
+  char_t path[PATH_MAX];
+  struct dirent *e;
+  DIR *d = opendir(dir);
+  while (d && (e = readdir(d)) != NULL) {
+    if (e->d_name[0] == '.') continue;
+    if (snprintf(path, PATH_MAX, "%s/%s", dir, e->d_name) < PATH_MAX) {
+      unlink(path);
+    }
+  }
+  if (d) closedir(d);
+  rmdir(dir);
+}
+#endif
+
+int main (void)
+{
+  uint_t err = 0;
+  char_t path[PATH_MAX] = "tmp_aubio_XXXXXX";
+  char_t dir[PATH_MAX] = "tmp_aubio_cache_XXXXXX";
+  const aubio_clip_t *clip, *again;
+  int fd = create_temp_sink(path);
+  if (!fd) return 1;
+  if (write_sample(path)) return 1;
+
+  if (aubio_samplecache_load("/nonexistent/sample.wav", 0)) err = 1;
+  clip = aubio_samplecache_load(path, 0);
+  again = aubio_samplecache_load(path, 0);
+  if (!clip || clip != again) {
+    PRINT_ERR("the sample was not shared\n");
+    return 1;
+  }
+  err |= check_clip(clip);
+  err |= check_sampler(path);
+  aubio_samplecache_release(again);
+  aubio_samplecache_release(clip);
+  aubio_samplecache_clear();
+
+#ifdef HAVE_MMAP
+  // decoded once and written to the directory, then mapped from it
+  if (mkdtemp(dir)) {
+    if (aubio_samplecache_set_dir(path) == 0) err = 1;
+    if (aubio_samplecache_set_dir(dir)) err = 1;
+    clip = aubio_samplecache_load(path, 0);
+    if (!clip || check_clip(clip)) err = 1;
+    aubio_samplecache_release(clip);
+    aubio_samplecache_clear();
+    clip = aubio_samplecache_load(path, 0);
+    if (!clip || check_clip(clip)) {
+      PRINT_ERR("failed mapping the cached sample\n");
+      err = 1;
+    }
+    err |= check_sampler(path);
+    aubio_samplecache_release(clip);
+    aubio_samplecache_clear();
+    aubio_samplecache_set_dir(NULL);
+    remove_dir(dir);
+  }
+#endif
+
+  close_temp_sink(path, fd);
+  aubio_cleanup();
+  return err;
+}
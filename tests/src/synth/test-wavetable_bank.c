@@ -0,0 +1,158 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+#include "utils_tests.h"
+
+// render banks of wavetable voices, check the frequency and amplitude of the
+// output, and compare the kernels of each instruction set to the scalar ones
+
+#define SR 44100
+#define HOP 256
+
+// number of sign changes in a vector
+static uint_t crossings (const fvec_t *out)
+{
+  uint_t j, n = 0;
+  for (j = 1; j < out->length; j++) {
+    if ((out->data[j - 1] < 0.) != (out->data[j] < 0.)) n++;
+  }
+  return n;
+}
+
+static uint_t check_sine (void)
+{
+  aubio_wavetable_bank_t *bank = new_aubio_wavetable_bank("sine", 3, SR);
+  fvec_t *out = new_fvec(SR / 10);
+  uint_t n, err = 0;
+  if (!bank || !out) return 1;
+  aubio_wavetable_bank_set_freq(bank, 1, 441.);
+  aubio_wavetable_bank_set_amp(bank, 1, .5);
+  // first block ramps to the targets
+  aubio_wavetable_bank_do(bank, NULL, out);
+  aubio_wavetable_bank_do(bank, NULL, out);
+  n = crossings(out);
+  if (n < 87 || n > 89) {
+    PRINT_ERR("sine: %d crossings in 100ms at 441Hz\n", n);
+    err = 1;
+  }
+  if (fabs(fvec_max(out) - .5) > 1.e-3 || fabs(fvec_min(out) + .5) > 1.e-3) {
+    PRINT_ERR("sine: amplitude %f %f, expected .5\n", fvec_max(out),
+        fvec_min(out));
+    err = 1;
+  }
+  del_fvec(out);
+  del_aubio_wavetable_bank(bank);
+  return err;
+}
+
+static uint_t check_shapes (void)
+{
+  const char_t *shapes[] = { "saw", "square", "triangle" };
+  uint_t i, n, err = 0;
+  for (i = 0; i < sizeof(shapes) / sizeof(shapes[0]); i++) {
+    aubio_wavetable_bank_t *bank = new_aubio_wavetable_bank(shapes[i], 1, SR);
+    fvec_t *out = new_fvec(SR / 10);
+    smpl_t freq;
+    if (!bank || !out) return 1;
+    // from the lowest to the highest table
+    for (freq = 55.; freq < SR / 2.; freq *= 4.) {
+      aubio_wavetable_bank_set_freq(bank, 0, freq);
+      aubio_wavetable_bank_set_amp(bank, 0, 1.);
+      aubio_wavetable_bank_do(bank, NULL, out);
+      aubio_wavetable_bank_do(bank, NULL, out);
+      n = crossings(out);
+      if (fvec_max(out) > 1.01 || fvec_min(out) < -1.01
+          || fvec_max(out) < .5) {
+        PRINT_ERR("%s at %.0fHz: peaks %f %f\n", shapes[i], freq,
+            fvec_max(out), fvec_min(out));
+        err = 1;
+      }
+      if (fabs(n - freq / 5.) > 3.) {
+        PRINT_ERR("%s at %.0fHz: %d crossings in 100ms\n", shapes[i], freq, n);
+        err = 1;
+      }
+    }
+    del_fvec(out);
+    del_aubio_wavetable_bank(bank);
+  }
+  return err;
+}
+
+// an empty value selects the default table
+static void set_isa (const char_t *isa)
+{
+#ifdef _WIN32
+  _putenv_s("AUBIO_SIMD", isa);
+#else
+  setenv("AUBIO_SIMD", isa, 1);
+#endif
+}
+
+// many voices with ramps, rendered with an instruction set
+static fvec_t *render (const char_t *isa)
+{
+  aubio_wavetable_bank_t *bank = new_aubio_wavetable_bank("saw", 37, SR);
+  fvec_t *out = new_fvec(HOP), *all = new_fvec(HOP * 8);
+  uint_t b, v, j;
+  set_isa(isa);
+  aubio_simd_init();
+  for (b = 0; b < 8; b++) {
+    for (v = 0; v < aubio_wavetable_bank_get_voices(bank); v++) {
+      aubio_wavetable_bank_set_freq(bank, v, 50. + 311. * v + 97. * b);
+      aubio_wavetable_bank_set_amp(bank, v, .02 * ((v + b) % 5));
+    }
+    aubio_wavetable_bank_do(bank, NULL, out);
+    for (j = 0; j < HOP; j++) all->data[b * HOP + j] = out->data[j];
+  }
+  del_fvec(out);
+  del_aubio_wavetable_bank(bank);
+  return all;
+}
+
+static uint_t check_kernels (void)
+{
+  const char_t *isas[] = { "sse2", "avx2", "avx512", "neon" };
+  fvec_t *ref = render("scalar");
+  uint_t i, j, err = 0;
+  for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+    fvec_t *out = render(isas[i]);
+    smpl_t max_err = 0.;
+    if (strcmp(AUBIO_SIMD()->name, isas[i]) == 0) {
+      for (j = 0; j < ref->length; j++) {
+        max_err = MAX(max_err, fabs(out->data[j] - ref->data[j]));
+      }
+      PRINT_MSG("%s: max difference %g\n", isas[i], max_err);
+      if (max_err > 1.e-4) err = 1;
+    }
+    del_fvec(out);
+  }
+  del_fvec(ref);
+  set_isa("");
+  aubio_simd_init();
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_wavetable_bank_t *bank;
+  if (new_aubio_wavetable_bank("noise", 1, SR)) err = 1;
+  if (new_aubio_wavetable_bank("sine", 0, SR)) err = 1;
+  if (new_aubio_wavetable_bank("sine", 1, 0)) err = 1;
+  bank = new_aubio_wavetable_bank("sine", 4, SR);
+  if (!bank) return 1;
+  if (!aubio_wavetable_bank_set_freq(bank, 4, 440.)) err = 1;
+  if (!aubio_wavetable_bank_set_freq(bank, 0, SR)) err = 1;
+  if (!aubio_wavetable_bank_set_amp(bank, 4, 1.)) err = 1;
+  if (aubio_wavetable_bank_set_freq(bank, 3, 440.)) err = 1;
+  if (aubio_wavetable_bank_get_freq(bank, 3) != 440.) err = 1;
+  del_aubio_wavetable_bank(bank);
+  if (err) PRINT_ERR("wrong parameters were accepted\n");
+  if (check_sine()) err = 1;
+  if (check_shapes()) err = 1;
+  if (check_kernels()) {
+    PRINT_ERR("kernels do not match the scalar ones\n");
+    err = 1;
+  }
+  return err;
+}
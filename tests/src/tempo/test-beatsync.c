@@ -0,0 +1,135 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// features aggregated per beat are the means and maxima of the hops found
+// between two changes of aubio_tempo_get_last
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define BPM 120.
+#define N_HOPS 3000
+#define N_FEATURES 3
+
+static uint_t check_flags (void)
+{
+  aubio_beatsync_t *o = new_aubio_beatsync (2);
+  fvec_t *f = new_fvec (2), *wrong = new_fvec (3);
+  const fvec_t *mean, *max;
+  uint_t i, err = 0;
+  if (!o || !f || !wrong) return 1;
+  if (new_aubio_beatsync (0)) err = 1;
+  // hops before the first beat are ignored, and the first beat has nothing
+  // to close
+  f->data[0] = 100.;
+  if (aubio_beatsync_do (o, f, 0) != 0) err = 1;
+  for (i = 0; i < 4; i++) {
+    f->data[0] = i;
+    f->data[1] = -(smpl_t)i;
+    if (aubio_beatsync_do (o, f, i == 0) != 0) err = 1;
+  }
+  if (aubio_beatsync_do (o, wrong, 1) != 0) err = 1;
+  f->data[0] = 10.;
+  f->data[1] = -10.;
+  if (aubio_beatsync_do (o, f, 1) != 1) err = 1;
+  mean = aubio_beatsync_get_mean (o);
+  max = aubio_beatsync_get_max (o);
+  // hops 0 to 3, the hop with the beat starting the next one
+  if (mean->data[0] != 1.5 || mean->data[1] != -1.5 || max->data[0] != 3.
+      || max->data[1] != 0. || aubio_beatsync_get_hops (o) != 4
+      || aubio_beatsync_get_count (o) != 1) err = 1;
+  f->data[0] = 20.;
+  aubio_beatsync_do (o, f, 0);
+  if (aubio_beatsync_do (o, f, 1) != 1) err = 1;
+  if (mean->data[0] != 15. || max->data[0] != 20. || max->data[1] != -10.
+      || aubio_beatsync_get_hops (o) != 2) err = 1;
+  aubio_beatsync_reset (o);
+  if (mean->data[0] != 0. || aubio_beatsync_get_hops (o) != 0
+      || aubio_beatsync_get_count (o) != 0) err = 1;
+  if (aubio_beatsync_do (o, f, 1) != 0) err = 1;
+  del_aubio_beatsync (o);
+  del_fvec (f);
+  del_fvec (wrong);
+  return err;
+}
+
+static void fill_hop (fvec_t *in, uint_t n)
+{
+  smpl_t click = 60. * SR / BPM;
+  uint_t j;
+  for (j = 0; j < HOP; j++) {
+    smpl_t pos = fmod (n * HOP + j, click);
+    in->data[j] = (pos < 441) ? 2. * random () / (smpl_t)RAND_MAX - 1. : 0.;
+  }
+}
+
+static void get_features (const fvec_t *in, uint_t n, fvec_t *features)
+{
+  features->data[0] = aubio_level_lin (in);
+  features->data[1] = aubio_db_spl (in);
+  features->data[2] = n % 7;
+}
+
+static uint_t check_tempo (void)
+{
+  aubio_tempo_t *t = new_aubio_tempo ("default", WIN, HOP, SR);
+  aubio_beatsync_t *o = new_aubio_beatsync (N_FEATURES);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (2);
+  fmat_t *features = new_fmat (N_HOPS, N_FEATURES);
+  fvec_t row;
+  uint_t starts[N_HOPS], n_starts = 0, n_closed = 0, last = 0, n, i, k, err = 0;
+  if (!t || !o || !in || !out || !features) return 1;
+  row.length = N_FEATURES;
+  for (n = 0; n < N_HOPS; n++) {
+    fill_hop (in, n);
+    aubio_tempo_do (t, in, out);
+    row.data = features->data[n];
+    get_features (in, n, &row);
+    if (aubio_tempo_get_last (t) != last) {
+      last = aubio_tempo_get_last (t);
+      starts[n_starts++] = n;
+    }
+    if (aubio_beatsync_do_tempo (o, &row, t)) {
+      // the beat from the previous start to this hop, excluded
+      const fvec_t *mean = aubio_beatsync_get_mean (o);
+      const fvec_t *max = aubio_beatsync_get_max (o);
+      uint_t from, hops;
+      if (n_starts < 2 || starts[n_starts - 1] != n) {
+        err = 1;
+        break;
+      }
+      from = starts[n_starts - 2];
+      hops = n - from;
+      if (aubio_beatsync_get_hops (o) != hops) err = 1;
+      for (k = 0; k < N_FEATURES; k++) {
+        smpl_t sum = 0., peak = features->data[from][k];
+        for (i = from; i < n; i++) {
+          sum += features->data[i][k];
+          if (features->data[i][k] > peak) peak = features->data[i][k];
+        }
+        if (fabs (mean->data[k] - sum / hops) > 1.e-4 * (1. + fabs (sum))
+            || max->data[k] != peak) err = 1;
+      }
+      n_closed++;
+    }
+  }
+  PRINT_MSG ("%d beats found, %d closed\n", n_starts, n_closed);
+  if (n_starts < 10 || n_closed + 1 != n_starts) err = 1;
+  del_aubio_tempo (t);
+  del_aubio_beatsync (o);
+  del_fvec (in);
+  del_fvec (out);
+  del_fmat (features);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  utils_init_random ();
+  if (check_flags ()) err = 1;
+  if (check_tempo ()) err = 1;
+  if (err) PRINT_ERR ("beat aggregates differ from the hops of each beat\n");
+  aubio_cleanup ();
+  return err;
+}
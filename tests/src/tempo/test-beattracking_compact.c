@@ -0,0 +1,78 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// compact trackers, which share their weighting tables and borrow their
+// scratch buffers from a pool, find the same beats as the default ones, in
+// both the block and the incremental modes
+
+#define N_TRACKERS 4
+
+// clicks at 120 bpm, over some noise
+static void clicks (fvec_t *in, uint_t *pos, uint_t samplerate)
+{
+  uint_t i, period = samplerate / 2;
+  for (i = 0; i < in->length; i++, (*pos)++) {
+    in->data[i] = (*pos % period < 64) ? 1. :
+      .01 * (2. * random() / (smpl_t)RAND_MAX - 1.);
+  }
+}
+
+static uint_t check_mode (uint_t incremental)
+{
+  uint_t samplerate = 44100, hop_s = 256, n_frames = 2000;
+  uint_t n, t, pos = 0, n_beats = 0;
+  aubio_tempo_t *ref = new_aubio_tempo ("default", 1024, hop_s, samplerate);
+  aubio_tempo_t *o[N_TRACKERS];
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *ref_out = new_fvec (2), *out = new_fvec (2);
+
+  if (!ref || !in || !ref_out || !out) return 1;
+  assert(aubio_tempo_set_incremental (ref, incremental) == 0);
+  for (t = 0; t < N_TRACKERS; t++) {
+    o[t] = new_aubio_tempo ("default", 1024, hop_s, samplerate);
+    assert(o[t]);
+    assert(aubio_tempo_set_incremental (o[t], incremental) == 0);
+    assert(aubio_tempo_set_compact (o[t], 1) == 0);
+    assert(aubio_tempo_get_compact (o[t]) == 1);
+  }
+  assert(aubio_tempo_get_compact (ref) == 0);
+
+  for (n = 0; n < n_frames; n++) {
+    clicks (in, &pos, samplerate);
+    aubio_tempo_do (ref, in, ref_out);
+    for (t = 0; t < N_TRACKERS; t++) {
+      aubio_tempo_do (o[t], in, out);
+      assert(out->data[0] == ref_out->data[0]);
+      assert(aubio_tempo_get_bpm (o[t]) == aubio_tempo_get_bpm (ref));
+      assert(aubio_tempo_get_confidence (o[t])
+          == aubio_tempo_get_confidence (ref));
+    }
+    if (ref_out->data[0]) n_beats++;
+    // leaving and entering compact mode keeps the state of the tracker
+    if (n == n_frames / 2) {
+      assert(aubio_tempo_set_compact (o[0], 0) == 0);
+      assert(aubio_tempo_get_compact (o[0]) == 0);
+    }
+  }
+  PRINT_MSG ("incremental %d: %d beats at %.2f bpm\n", incremental, n_beats,
+      aubio_tempo_get_bpm (ref));
+
+  for (t = 0; t < N_TRACKERS; t++) {
+    del_aubio_tempo (o[t]);
+  }
+  del_aubio_tempo (ref);
+  del_fvec (in);
+  del_fvec (ref_out);
+  del_fvec (out);
+  return n_beats == 0;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  utils_init_random();
+  err |= check_mode (0);
+  err |= check_mode (1);
+  aubio_cleanup ();
+  return err;
+}
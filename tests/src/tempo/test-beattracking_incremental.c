@@ -0,0 +1,76 @@
+#define AUBIO_UNSTABLE 1
+
+#include <aubio.h>
+#include "utils_tests.h"
+
+// feed the same detection function to two beat trackers, one of them
+// updating its autocorrelation at each hop, and compare their results
+int main (void)
+{
+  uint_t i, j, n, winlen = 512, step = winlen / 4, hop_s = 512;
+  uint_t n_blocks = 40;
+  fvec_t *dfframe = new_fvec (winlen);
+  fvec_t *out_ref = new_fvec (step);
+  fvec_t *out_inc = new_fvec (step);
+  aubio_beattracking_t *ref = new_aubio_beattracking (winlen, hop_s, 44100);
+  aubio_beattracking_t *inc = new_aubio_beattracking (winlen, hop_s, 44100);
+  aubio_tempo_t *tempo;
+  fvec_t *in, *beat;
+  smpl_t period = 60. * 44100. / 128. / hop_s;
+
+  assert(ref && inc);
+  assert(aubio_beattracking_set_incremental (inc, 1) == 0);
+  assert(aubio_beattracking_get_incremental (inc) == 1);
+  assert(aubio_beattracking_get_incremental (ref) == 0);
+
+  utils_init_random ();
+  n = 0;
+  for (i = 0; i < n_blocks; i++) {
+    // fill a block, as aubio_tempo_do does
+    for (j = 0; j < step; j++, n++) {
+      smpl_t phase = fmod (n, period);
+      dfframe->data[winlen - step + j] = (phase < 1. ? 1. : 0.)
+        + .05 * random() / (smpl_t)RAND_MAX;
+      aubio_beattracking_update (inc, dfframe, j);
+    }
+    aubio_beattracking_do (ref, dfframe, out_ref);
+    aubio_beattracking_do (inc, dfframe, out_inc);
+    assert(fabs(aubio_beattracking_get_period (ref)
+          - aubio_beattracking_get_period (inc)) < 1.e-2);
+    assert(out_ref->data[0] == out_inc->data[0]);
+    for (j = 1; j < out_ref->data[0]; j++) {
+      assert(fabs(out_ref->data[j] - out_inc->data[j]) < 1.e-2);
+    }
+    // rotate
+    for (j = 0; j < winlen - step; j++) {
+      dfframe->data[j] = dfframe->data[j + step];
+    }
+    for (j = winlen - step; j < winlen; j++) {
+      dfframe->data[j] = 0.;
+    }
+  }
+  // about 128 bpm
+  assert(fabs(aubio_beattracking_get_bpm (inc) - 128.) < 4.);
+
+  // the mode can be toggled on a tempo object while running
+  tempo = new_aubio_tempo ("default", 1024, hop_s, 44100);
+  in = new_fvec (hop_s);
+  beat = new_fvec (2);
+  assert(tempo);
+  for (i = 0; i < 1000; i++) {
+    if (i == 333) assert(aubio_tempo_set_incremental (tempo, 1) == 0);
+    aubio_tempo_do (tempo, in, beat);
+  }
+  assert(aubio_tempo_get_incremental (tempo) == 1);
+
+  del_aubio_tempo (tempo);
+  del_fvec (in);
+  del_fvec (beat);
+  del_aubio_beattracking (ref);
+  del_aubio_beattracking (inc);
+  del_fvec (dfframe);
+  del_fvec (out_ref);
+  del_fvec (out_inc);
+  aubio_cleanup ();
+  return 0;
+}
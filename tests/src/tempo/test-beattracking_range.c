@@ -0,0 +1,92 @@
+#define AUBIO_UNSTABLE 1
+
+#include <aubio.h>
+#include "utils_tests.h"
+
+// restrict the tempo range of a beat tracker and move its prior, and check
+// the tempo found stays within the range
+
+#define N_BLOCKS 12
+
+// run a tracker on a click train at bpm, return the tempo found
+static smpl_t track (aubio_beattracking_t *bt, smpl_t bpm)
+{
+  uint_t i, j, winlen = 512, step = winlen / 4, hop_s = 512;
+  fvec_t *dfframe = new_fvec (winlen);
+  fvec_t *out = new_fvec (step);
+  smpl_t phase = 0., period = 60. * 44100. / bpm / hop_s;
+  for (i = 0; i < N_BLOCKS; i++) {
+    for (j = 0; j < winlen - step; j++) {
+      dfframe->data[j] = dfframe->data[j + step];
+    }
+    for (j = winlen - step; j < winlen; j++) {
+      phase += 1.;
+      if (phase >= period) phase -= period;
+      dfframe->data[j] = (phase < 1. ? 1. : 0.)
+        + .1 * random() / (smpl_t)RAND_MAX;
+    }
+    aubio_beattracking_do (bt, dfframe, out);
+  }
+  del_fvec (dfframe);
+  del_fvec (out);
+  return aubio_beattracking_get_bpm (bt);
+}
+
+int main (void)
+{
+  uint_t winlen = 512, hop_s = 512;
+  aubio_beattracking_t *bt = new_aubio_beattracking (winlen, hop_s, 44100);
+  aubio_tempo_t *tempo;
+  smpl_t bpm;
+
+  assert(bt);
+  assert(aubio_beattracking_get_prior (bt) == 120.);
+  assert(aubio_beattracking_set_prior (bt, 0.) != 0);
+  assert(aubio_beattracking_set_bpm_range (bt, 0., 100.) != 0);
+  assert(aubio_beattracking_set_bpm_range (bt, 120., 100.) != 0);
+  // periods longer than the filterbank, or shorter than one hop
+  assert(aubio_beattracking_set_bpm_range (bt, 10., 100.) != 0);
+  assert(aubio_beattracking_set_bpm_range (bt, 60., 10000.) != 0);
+  del_aubio_beattracking (bt);
+
+  utils_init_random ();
+
+  // within the range, the tempo is found as without a range
+  bt = new_aubio_beattracking (winlen, hop_s, 44100);
+  assert(aubio_beattracking_set_bpm_range (bt, 70., 180.) == 0);
+  assert(aubio_beattracking_get_min_bpm (bt) == 70.);
+  assert(aubio_beattracking_get_max_bpm (bt) == 180.);
+  bpm = track (bt, 128.);
+  PRINT_MSG("128 bpm in 70 - 180: %.2f\n", bpm);
+  assert(fabs (bpm - 128.) < 4.);
+  del_aubio_beattracking (bt);
+
+  // outside the range, an octave within it is found
+  bt = new_aubio_beattracking (winlen, hop_s, 44100);
+  assert(aubio_beattracking_set_bpm_range (bt, 60., 110.) == 0);
+  bpm = track (bt, 160.);
+  PRINT_MSG("160 bpm in 60 - 110: %.2f\n", bpm);
+  assert(fabs (bpm - 80.) < 3.);
+  del_aubio_beattracking (bt);
+
+  // a slow prior picks the slower octave of an ambiguous tempo
+  bt = new_aubio_beattracking (winlen, hop_s, 44100);
+  assert(aubio_beattracking_set_prior (bt, 70.) == 0);
+  assert(aubio_beattracking_get_prior (bt) == 70.);
+  bpm = track (bt, 140.);
+  PRINT_MSG("140 bpm with a prior at 70: %.2f\n", bpm);
+  assert(fabs (bpm - 70.) < 3.);
+  del_aubio_beattracking (bt);
+
+  // the range can be set on a tempo object
+  tempo = new_aubio_tempo ("default", 1024, hop_s, 44100);
+  assert(tempo);
+  assert(aubio_tempo_set_bpm_range (tempo, 70., 180.) == 0);
+  assert(aubio_tempo_get_max_bpm (tempo) == 180.);
+  assert(aubio_tempo_set_prior (tempo, 100.) == 0);
+  assert(aubio_tempo_get_prior (tempo) == 100.);
+  del_aubio_tempo (tempo);
+
+  aubio_cleanup ();
+  return 0;
+}
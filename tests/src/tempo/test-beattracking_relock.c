@@ -0,0 +1,83 @@
+#define AUBIO_UNSTABLE 1
+
+#include <aubio.h>
+#include "utils_tests.h"
+
+// feed a detection function whose tempo changes twice to two beat trackers,
+// one of them restarting when the stability drops, and check the stability
+// falls at each change and the restarting tracker finds the new tempo early
+
+#define N_BLOCKS 40
+
+static smpl_t block_bpm (uint_t i)
+{
+  return i < 20 ? 128. : (i < 30 ? 93. : 141.);
+}
+
+// first block from start where the tempo was found
+static uint_t first_found (const uint_t *found, uint_t start)
+{
+  uint_t i;
+  for (i = start; i < N_BLOCKS; i++) {
+    if (found[i]) break;
+  }
+  return i;
+}
+
+int main (void)
+{
+  uint_t i, j, winlen = 512, step = winlen / 4, hop_s = 512;
+  fvec_t *dfframe = new_fvec (winlen);
+  fvec_t *out = new_fvec (step);
+  aubio_beattracking_t *ref = new_aubio_beattracking (winlen, hop_s, 44100);
+  aubio_beattracking_t *bt = new_aubio_beattracking (winlen, hop_s, 44100);
+  uint_t found_ref[N_BLOCKS], found_bt[N_BLOCKS];
+  smpl_t phase = 0., stability[N_BLOCKS];
+
+  assert(ref && bt);
+  assert(aubio_beattracking_get_relock (bt) == 0.);
+  assert(aubio_beattracking_set_relock (bt, 1.5) != 0);
+  assert(aubio_beattracking_set_salience_decay (bt, 1.) != 0);
+  assert(aubio_beattracking_set_relock (bt, .5) == 0);
+  assert(aubio_beattracking_get_salience (bt)->length == step);
+
+  utils_init_random ();
+  for (i = 0; i < N_BLOCKS; i++) {
+    smpl_t period = 60. * 44100. / block_bpm (i) / hop_s;
+    for (j = 0; j < winlen - step; j++) {
+      dfframe->data[j] = dfframe->data[j + step];
+    }
+    for (j = winlen - step; j < winlen; j++) {
+      phase += 1.;
+      if (phase >= period) phase -= period;
+      dfframe->data[j] = (phase < 1. ? 1. : 0.)
+        + .3 * random() / (smpl_t)RAND_MAX;
+    }
+    aubio_beattracking_do (ref, dfframe, out);
+    aubio_beattracking_do (bt, dfframe, out);
+    stability[i] = aubio_beattracking_get_stability (bt);
+    found_ref[i] = fabs (aubio_beattracking_get_bpm (ref) - block_bpm (i)) < 4.;
+    found_bt[i] = fabs (aubio_beattracking_get_bpm (bt) - block_bpm (i)) < 4.;
+    PRINT_MSG("%2d: %.1f bpm, found %.1f and %.1f, stability %.3f\n", i,
+        block_bpm (i), aubio_beattracking_get_bpm (ref),
+        aubio_beattracking_get_bpm (bt), stability[i]);
+  }
+  // steady before each change, dropping right after it
+  assert(stability[19] > .8 && stability[29] > .8);
+  assert(stability[20] < .5 || stability[21] < .5);
+  assert(stability[30] < .5 || stability[31] < .5);
+  // the restarting tracker finds the new tempo within three blocks, and never
+  // after the other one
+  assert(first_found (found_bt, 20) <= 23);
+  assert(first_found (found_bt, 30) <= 33);
+  assert(first_found (found_bt, 20) <= first_found (found_ref, 20));
+  assert(first_found (found_bt, 30) <= first_found (found_ref, 30));
+  assert(found_bt[N_BLOCKS - 1]);
+
+  del_aubio_beattracking (ref);
+  del_aubio_beattracking (bt);
+  del_fvec (dfframe);
+  del_fvec (out);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// analyze a detection function with clicks at a known tempo, some of them
+// missing, some off-beats and noise, between two silences, and check the
+// tempo and the beats found
+
+#define HOP 512
+#define SR 44100
+#define BPM 123.
+
+int main (void)
+{
+  smpl_t fps = SR / (smpl_t)HOP, period = 60. * fps / BPM, bpm, t;
+  uint_t start = (uint_t)(3 * fps), end = (uint_t)(63 * fps);
+  uint_t n = end + start, i, j, n_beats, n_clicks = 0, n_kept = 0;
+  uint_t matched = 0;
+  fvec_t *df = new_fvec (n), *beats = new_fvec (n), *clicks = new_fvec (n);
+  fvec_t *empty = new_fvec (10);
+
+  assert(df && beats && clicks && empty);
+  // too short, and wrong parameters
+  assert(aubio_tempo_analyze (empty, HOP, SR, &bpm, beats) == 0);
+  assert(bpm == 0.);
+  assert(aubio_tempo_analyze (df, 0, SR, &bpm, beats) == 0);
+  // no onsets
+  assert(aubio_tempo_analyze (df, HOP, SR, &bpm, beats) == 0);
+
+  utils_init_random ();
+  for (t = start; t < end; t += period) {
+    i = (uint_t)floor(t + .5);
+    n_clicks++;
+    // drop one beat in 8
+    if (random() % 8 == 0) continue;
+    clicks->data[n_kept++] = i;
+    df->data[i] += 1. + .5 * random() / (smpl_t)RAND_MAX;
+    // and add an off-beat to one in 3
+    if (random() % 3 == 0) df->data[i + (uint_t)(period / 2)] += .6;
+  }
+  for (i = start; i < end; i++) {
+    df->data[i] += .2 * random() / (smpl_t)RAND_MAX;
+  }
+
+  n_beats = aubio_tempo_analyze (df, HOP, SR, &bpm, beats);
+  PRINT_MSG("found %.2f bpm and %d beats for %d clicks\n", bpm, n_beats,
+      n_clicks);
+  assert(fabs (bpm - BPM) < 1.);
+  // the first or the last clicks may have been dropped
+  assert(n_beats <= n_clicks);
+  // a beat on each remaining click, within a hop
+  for (i = 0, j = 0; i < n_beats; i++) {
+    smpl_t pos = beats->data[i] * fps;
+    assert(pos >= start - 1 && pos <= end + 1);
+    while (j + 1 < n_kept && clicks->data[j] < pos - 1.5) j++;
+    if (fabs (clicks->data[j] - pos) <= 1.) matched++;
+  }
+  PRINT_MSG("%d of %d clicks found\n", matched, n_kept);
+  assert(matched + 2 >= n_kept);
+
+  // only the first beats are stored in a short vector
+  assert(aubio_tempo_analyze (df, HOP, SR, &bpm, empty) == n_beats);
+  assert(empty->data[9] == beats->data[9]);
+
+  del_fvec (df);
+  del_fvec (beats);
+  del_fvec (clicks);
+  del_fvec (empty);
+  aubio_cleanup ();
+  return 0;
+}
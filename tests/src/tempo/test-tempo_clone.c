@@ -0,0 +1,86 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// a clone tracks the beats of an object created with the same parameters,
+// and a reconfigured object those of a new object of the same method and
+// sizes
+
+// clicks at 120 bpm, over some noise
+static void clicks (fvec_t *in, uint_t *pos, uint_t samplerate)
+{
+  uint_t i, period = samplerate / 2;
+  for (i = 0; i < in->length; i++, (*pos)++) {
+    in->data[i] = (*pos % period < 64) ? 1. :
+      .01 * (2. * random() / (smpl_t)RAND_MAX - 1.);
+  }
+}
+
+// run a and b on the same n_frames hops, check their beats match
+static void check_same (aubio_tempo_t *a, aubio_tempo_t *b, uint_t hop_s,
+    uint_t samplerate, uint_t n_frames)
+{
+  uint_t n, pos = 0;
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *a_out = new_fvec (2), *b_out = new_fvec (2);
+  for (n = 0; n < n_frames; n++) {
+    clicks (in, &pos, samplerate);
+    aubio_tempo_do (a, in, a_out);
+    aubio_tempo_do (b, in, b_out);
+    assert(a_out->data[0] == b_out->data[0]);
+    assert(aubio_tempo_get_last (a) == aubio_tempo_get_last (b));
+    assert(aubio_tempo_get_bpm (a) == aubio_tempo_get_bpm (b));
+  }
+  del_fvec (in);
+  del_fvec (a_out);
+  del_fvec (b_out);
+}
+
+static void set_parameters (aubio_tempo_t *o)
+{
+  aubio_tempo_set_threshold (o, 0.2);
+  aubio_tempo_set_delay (o, 256);
+  aubio_tempo_set_bpm_range (o, 80., 160.);
+}
+
+int main (void)
+{
+  uint_t samplerate = 44100, n_frames = 1000;
+  aubio_tempo_t *o = new_aubio_tempo ("default", 1024, 512, samplerate);
+  aubio_tempo_t *ref = new_aubio_tempo ("default", 1024, 512, samplerate);
+  aubio_tempo_t *c;
+
+  if (!o || !ref) return 1;
+  utils_init_random();
+  set_parameters (o);
+  set_parameters (ref);
+  check_same (o, ref, 512, samplerate, n_frames);
+
+  // the clone has the parameters of o, and starts from a new state
+  c = aubio_tempo_clone (o);
+  assert(c);
+  assert(aubio_tempo_get_threshold (c) == aubio_tempo_get_threshold (o));
+  assert(aubio_tempo_get_max_bpm (c) == aubio_tempo_get_max_bpm (o));
+  del_aubio_tempo (ref);
+  ref = new_aubio_tempo ("default", 1024, 512, samplerate);
+  set_parameters (ref);
+  check_same (c, ref, 512, samplerate, n_frames);
+  PRINT_MSG ("clone found %.2f bpm\n", aubio_tempo_get_bpm (c));
+  del_aubio_tempo (c);
+  del_aubio_tempo (ref);
+
+  // a reconfigured object is a new one, with the default parameters
+  assert(aubio_tempo_reconfigure (o, "hfc", 512, 256) == 0);
+  ref = new_aubio_tempo ("hfc", 512, 256, samplerate);
+  assert(aubio_tempo_get_threshold (o) == aubio_tempo_get_threshold (ref));
+  check_same (o, ref, 256, samplerate, n_frames);
+
+  // a failed reconfiguration leaves the object unchanged
+  assert(aubio_tempo_reconfigure (o, "unknown", 512, 256) != 0);
+  assert(aubio_tempo_reconfigure (o, "hfc", 256, 512) != 0);
+  check_same (o, ref, 256, samplerate, n_frames);
+
+  del_aubio_tempo (o);
+  del_aubio_tempo (ref);
+  aubio_cleanup ();
+  return 0;
+}
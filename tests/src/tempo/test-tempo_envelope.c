@@ -0,0 +1,97 @@
+#include <aubio.h>
+#include <time.h>
+#include "utils_tests.h"
+
+// the envelope mode, without any spectrum, finds the tempo of a click track
+// as the default mode does
+
+#define WIN 1024
+#define HOP 512
+#define SR 44100
+#define N_HOPS 2000
+
+static void fill_hop (fvec_t *in, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < HOP; i++) {
+    // a short burst every half second, over a faint noise
+    uint_t t = (n * HOP + i) % (SR / 2);
+    smpl_t noise = .01 * (2. * random () / (smpl_t)RAND_MAX - 1.);
+    in->data[i] = noise + ((t < 2048) ? .5 * sin (2. * M_PI * 200. * t / SR)
+      : 0.);
+  }
+}
+
+static uint_t run (const char_t *method, uint_t gating, smpl_t *bpm,
+    uint_t *n_beats, uint_t *memory)
+{
+  aubio_tempo_t *o = new_aubio_tempo (method, WIN, HOP, SR);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (1);
+  uint_t n, last = 0;
+  clock_t start, elapsed = 0;
+  if (!o || !in || !out) return 1;
+  aubio_tempo_set_gating (o, gating);
+  *n_beats = 0;
+  for (n = 0; n < N_HOPS; n++) {
+    fill_hop (in, n);
+    start = clock ();
+    aubio_tempo_do (o, in, out);
+    elapsed += clock () - start;
+    if (aubio_tempo_get_last (o) != last) {
+      last = aubio_tempo_get_last (o);
+      (*n_beats)++;
+    }
+  }
+  *bpm = aubio_tempo_get_bpm (o);
+  *memory = aubio_tempo_get_memory_usage (o);
+  PRINT_MSG ("%s%s: %.2f bpm, %d beats, %d bytes, %.1f ms\n", method,
+      gating ? " (gated)" : "", *bpm, *n_beats, *memory,
+      1000. * elapsed / CLOCKS_PER_SEC);
+  del_aubio_tempo (o);
+  del_fvec (in);
+  del_fvec (out);
+  return 0;
+}
+
+static uint_t check_graph (void)
+{
+  aubio_graph_t *g = new_aubio_graph (HOP, SR);
+  fvec_t *in = new_fvec (HOP), view;
+  uint_t n, err = 0;
+  if (!g || !in) return 1;
+  if (aubio_graph_add (g, "tempo", "envelope", WIN) != 0) err = 1;
+  // no phase vocoder is needed
+  if (aubio_graph_get_n_spectra (g) != 0) err = 1;
+  for (n = 0; n < N_HOPS; n++) {
+    fill_hop (in, n);
+    aubio_graph_do (g, in);
+  }
+  aubio_graph_get_output (g, 0, &view);
+  if (fabs (view.data[1] - 120.) > 3.) err = 1;
+  del_aubio_graph (g);
+  del_fvec (in);
+  return err;
+}
+
+int main (void)
+{
+  aubio_tempo_t *o;
+  smpl_t bpm, ref_bpm;
+  uint_t beats, ref_beats, memory, ref_memory, err = 0;
+  utils_init_random ();
+  if (run ("default", 0, &ref_bpm, &ref_beats, &ref_memory)) return 1;
+  if (run ("envelope", 0, &bpm, &beats, &memory)) return 1;
+  if (fabs (bpm - 120.) > 3. || fabs (ref_bpm - 120.) > 3.
+      || beats + 3 < ref_beats || ref_beats + 3 < beats) err = 1;
+  if (memory >= ref_memory) err = 1;
+  if (run ("envelope", 1, &bpm, &beats, &memory)) return 1;
+  if (fabs (bpm - 120.) > 3.) err = 1;
+  // samplerates and hops which can not be decimated
+  o = new_aubio_tempo ("envelope", 256, 100, 8000);
+  if (!o) err = 1;
+  else del_aubio_tempo (o);
+  if (check_graph ()) err = 1;
+  if (err) PRINT_ERR ("the envelope mode missed the tempo of the clicks\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,49 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils_tests.h"
+
+// with silence gating, clicks at 120 bpm separated by silences give the same
+// tempo as without, and the pitch of silent hops stays 0
+int main (void)
+{
+  uint_t i, n, n_frames = 2000, err = 0, n_beats = 0, n_gated = 0;
+  uint_t win_s = 1024, hop_s = 512, samplerate = 44100;
+  aubio_tempo_t *o = new_aubio_tempo ("default", win_s, hop_s, samplerate);
+  aubio_tempo_t *g = new_aubio_tempo ("default", win_s, hop_s, samplerate);
+  aubio_pitch_t *p = new_aubio_pitch ("yinfft", 2048, hop_s, samplerate);
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *out = new_fvec (1), *gated_out = new_fvec (1);
+  if (!o || !g || !p || !in || !out || !gated_out) return 1;
+  if (aubio_tempo_get_gating (g) != 0 || aubio_tempo_set_gating (g, 1)
+      || aubio_tempo_get_gating (g) != 1) err = 1;
+  if (aubio_pitch_set_gating (p, 1) || aubio_pitch_get_gating (p) != 1) err = 1;
+  for (n = 0; n < n_frames; n++) {
+    // a short burst every half second
+    for (i = 0; i < hop_s; i++) {
+      uint_t t = (n * hop_s + i) % (samplerate / 2);
+      in->data[i] = (t < 2048) ? .5 * SIN (2. * PI * 1000. * t / samplerate)
+        : 0.;
+    }
+    aubio_tempo_do (o, in, out);
+    aubio_tempo_do (g, in, gated_out);
+    if (out->data[0] != 0.) n_beats++;
+    if (gated_out->data[0] != 0.) n_gated++;
+    aubio_pitch_do (p, in, out);
+    if (aubio_db_spl (in) < aubio_pitch_get_silence (p) && out->data[0] != 0.)
+      err = 1;
+  }
+  PRINT_MSG ("%.2f bpm, %d beats, with gating %.2f bpm, %d beats\n",
+      aubio_tempo_get_bpm (o), n_beats, aubio_tempo_get_bpm (g), n_gated);
+  if (fabs (aubio_tempo_get_bpm (o) - 120.) > 3.
+      || fabs (aubio_tempo_get_bpm (g) - aubio_tempo_get_bpm (o)) > 1.
+      || n_gated + 3 < n_beats || n_beats + 3 < n_gated) err = 1;
+  if (err) PRINT_ERR ("gating changed the tempo or the pitch\n");
+  del_aubio_tempo (o);
+  del_aubio_tempo (g);
+  del_aubio_pitch (p);
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (gated_out);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,94 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// follow a click track, predict each beat from the blocks that precede it,
+// and check the predictions against the beats reported by aubio_tempo_do
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define BPM 120.
+#define N_FRAMES 6000
+
+int main (void)
+{
+  aubio_tempo_t *o = new_aubio_tempo ("default", WIN, HOP, SR);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (1);
+  smpl_t click = 60. * SR / BPM, phase, last_phase = 0.;
+  uint_t n, j, next = 0, early = 0, last = 0, n_beats = 0, n_checked = 0, err = 0;
+  sint_t diff;
+
+  if (!o || !in || !out) return 1;
+  // no prediction before a period is found
+  if (aubio_tempo_get_next (o) != 0 || aubio_tempo_get_phase (o) != 0.) {
+    PRINT_ERR("a beat was predicted before any input\n");
+    err = 1;
+  }
+
+  utils_init_random ();
+  for (n = 0; n < N_FRAMES; n++) {
+    for (j = 0; j < HOP; j++) {
+      smpl_t pos = fmod (n * HOP + j, click);
+      in->data[j] = (pos < 441) ? 2. * random () / (smpl_t)RAND_MAX - 1. : 0.;
+    }
+    aubio_tempo_do (o, in, out);
+    phase = aubio_tempo_get_phase (o);
+    if (phase < 0. || phase >= 1.) {
+      PRINT_ERR("phase %f out of range\n", phase);
+      err = 1;
+    }
+    // beats on silent blocks are not reported in out, but still tracked
+    if (aubio_tempo_get_last (o) != last) {
+      last = aubio_tempo_get_last (o);
+      n_beats++;
+      // compare with the prediction of the previous block, once locked
+      if (n > N_FRAMES / 2 && next != 0) {
+        diff = (sint_t)last - (sint_t)next;
+        if (abs (diff) > HOP) {
+          PRINT_ERR("beat at %d, predicted at %d\n", last, next);
+          err = 1;
+        }
+        // and with the one made half a period ahead, which may miss the
+        // corrections of the tracker by a few blocks
+        diff = (sint_t)last - (sint_t)early;
+        if (abs (diff) > 3 * HOP) {
+          PRINT_ERR("beat at %d, predicted at %d\n", last, early);
+          err = 1;
+        }
+        n_checked++;
+      }
+      early = 0;
+    } else if (n > N_FRAMES / 2 && phase + .05 < last_phase) {
+      // the phase only wraps on beats
+      PRINT_ERR("phase went back from %f to %f at frame %d\n", last_phase,
+          phase, n);
+      err = 1;
+    }
+    last_phase = phase;
+    next = aubio_tempo_get_next (o);
+    if (early == 0 && phase >= .5) early = next;
+    if (n > N_FRAMES / 2 && next + HOP < last) {
+      PRINT_ERR("next beat %d before the last one %d\n", next, last);
+      err = 1;
+    }
+  }
+  PRINT_MSG("%d beats at %.2f bpm, %d predictions checked\n", n_beats,
+      aubio_tempo_get_bpm (o), n_checked);
+  if (n_checked < 30) err = 1;
+
+  // the prediction includes the delay
+  next = aubio_tempo_get_next (o);
+  aubio_tempo_set_delay (o, -HOP);
+  if (aubio_tempo_get_next (o) + HOP != next) {
+    PRINT_ERR("delay not applied to the predicted beat\n");
+    err = 1;
+  }
+  if (fabs (aubio_tempo_get_next_ms (o) - 1000. * aubio_tempo_get_next_s (o))
+      > 1.e-2) err = 1;
+
+  del_aubio_tempo (o);
+  del_fvec (in);
+  del_fvec (out);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,138 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "spectral/fft_q15_priv.h"
+#include "utils_tests.h"
+
+// the fixed-point transform matches the floating point one, and the fixed
+// point tracker finds the same tempo as aubio_tempo_t on clicks at 120 bpm
+
+static uint_t test_fft (uint_t size)
+{
+  aubio_fft_q15_t *q = new_aubio_fft_q15 (size);
+  aubio_fft_t *f = new_aubio_fft (size);
+  fvec_t *in = new_fvec (size);
+  fvec_t *w = new_aubio_window ("hanningz", size);
+  cvec_t *spec = new_cvec (size);
+  s16_t *frame = AUBIO_ARRAY (s16_t, size);
+  uint_t *norm = AUBIO_ARRAY (uint_t, size / 2 + 1);
+  uint_t i, amp, err = 0;
+  if (!q || !f || !in || !w || !spec || !frame || !norm) return 1;
+  // a loud and a quiet frame, a sine and some noise
+  for (amp = 30000; amp > 10; amp /= 1000) {
+    smpl_t max_err = 0., max_norm = 0.;
+    for (i = 0; i < size; i++) {
+      frame[i] = (s16_t) (amp * (.7 * sin (2. * M_PI * 17.3 * i / size)
+            + .3 * ((i * 7919) % 101 / 50. - 1.)));
+      in->data[i] = frame[i] / 32768. * w->data[i];
+    }
+    aubio_fft_q15_norm (q, frame, norm);
+    aubio_fft_do (f, in, spec);
+    for (i = 0; i < size / 2 + 1; i++) {
+      smpl_t d = fabs (norm[i] / 32768. - spec->norm[i]);
+      if (d > max_err) max_err = d;
+      if (spec->norm[i] > max_norm) max_norm = spec->norm[i];
+    }
+    PRINT_MSG ("fft_q15 %d, amplitude %d: error %g of %g\n", size, amp,
+        max_err, max_norm);
+    // the magnitudes are rounded to 1 / 32768
+    if (max_err > 1e-3 * max_norm + 2. / 32768.) err = 1;
+  }
+  del_aubio_fft_q15 (q);
+  del_aubio_fft (f);
+  del_fvec (in);
+  del_fvec (w);
+  del_cvec (spec);
+  AUBIO_FREE (frame);
+  AUBIO_FREE (norm);
+  return err;
+}
+
+static uint_t test_tempo (const char_t *method)
+{
+  uint_t i, n, n_frames = 2000, err = 0, n_beats = 0, n_onsets = 0;
+  uint_t win_s = 1024, hop_s = 512, samplerate = 44100, last = 0;
+  aubio_tempo_q15_t *q = new_aubio_tempo_q15 (method, win_s, hop_s,
+      samplerate);
+  aubio_tempo_t *o = new_aubio_tempo (method, win_s, hop_s, samplerate);
+  fvec_t *in = new_fvec (hop_s), *out = new_fvec (1);
+  s16_t *samples = AUBIO_ARRAY (s16_t, hop_s);
+  smpl_t bpm;
+  if (!q || !o || !in || !out || !samples) return 1;
+  for (n = 0; n < n_frames; n++) {
+    // a short burst every half second
+    for (i = 0; i < hop_s; i++) {
+      uint_t t = (n * hop_s + i) % (samplerate / 2);
+      samples[i] = (t < 2048) ? (s16_t) (16384. * sin (2. * M_PI * 1000. * t
+            / samplerate)) : 0;
+      in->data[i] = samples[i] / 32768.;
+    }
+    aubio_tempo_do (o, in, out);
+    if (aubio_tempo_q15_do (q, samples)) {
+      // beats are half a second apart, within two hops, once the tempo is
+      // found
+      uint_t beat = aubio_tempo_q15_get_last (q);
+      if (n > n_frames / 2 && (beat + 2 * hop_s < last + samplerate / 2
+            || beat > last + samplerate / 2 + 2 * hop_s)) {
+        PRINT_MSG ("%s: beat at %d, %d after the previous one\n", method,
+            beat, beat - last);
+        err = 1;
+      }
+      last = beat;
+      n_beats++;
+    }
+    n_onsets += aubio_tempo_q15_get_onset (q);
+  }
+  bpm = aubio_tempo_q15_get_bpm (q) / 256.;
+  PRINT_MSG ("%s: %.2f bpm, float %.2f bpm, period %d, %d beats, "
+      "%d onsets\n", method, bpm, aubio_tempo_get_bpm (o),
+      aubio_tempo_q15_get_period (q), n_beats, n_onsets);
+  if (fabs (bpm - 120.) > 3. || fabs (bpm - aubio_tempo_get_bpm (o)) > 1.
+      || n_beats + 10 < n_frames * hop_s / (samplerate / 2)
+      || n_onsets + 10 < n_frames * hop_s / (samplerate / 2)) {
+    err = 1;
+  }
+  del_aubio_tempo_q15 (q);
+  del_aubio_tempo (o);
+  del_fvec (in);
+  del_fvec (out);
+  AUBIO_FREE (samples);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_tempo_q15_t *q;
+  err |= test_fft (16);
+  err |= test_fft (1024);
+  err |= test_fft (8192);
+  err |= test_tempo ("default");
+  err |= test_tempo ("energy");
+  err |= test_tempo ("hfc");
+
+  q = new_aubio_tempo_q15 ("default", 1024, 512, 44100);
+  if (!q || aubio_tempo_q15_get_threshold (q) != 9830
+      || aubio_tempo_q15_set_threshold (q, 16384)
+      || aubio_tempo_q15_get_threshold (q) != 16384
+      || aubio_tempo_q15_set_threshold (q, -1) == 0
+      || aubio_tempo_q15_get_silence (q) != -90
+      || aubio_tempo_q15_set_silence (q, -70)
+      || aubio_tempo_q15_get_silence (q) != -70
+      || aubio_tempo_q15_set_silence (q, 1) == 0
+      || aubio_tempo_q15_get_bpm (q) != 0
+      || aubio_tempo_q15_get_memory_usage (q) == 0) {
+    err = 1;
+  }
+  if (q) del_aubio_tempo_q15 (q);
+  // wrong parameters
+  if (new_aubio_tempo_q15 ("default", 1000, 512, 44100)
+      || new_aubio_tempo_q15 ("default", 1024, 2048, 44100)
+      || new_aubio_tempo_q15 ("default", 1024, 0, 44100)
+      || new_aubio_tempo_q15 ("default", 1024, 512, 0)
+      || new_aubio_tempo_q15 ("complex", 1024, 512, 44100)) {
+    err = 1;
+  }
+  if (err) PRINT_ERR ("fixed-point tempo did not match\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -1,43 +1,140 @@
 #include <aubio.h>
+#include "utils_tests.h"
 
-int main (void)
+// direct form coefficients of the A-weighting at 44100Hz, as computed with
+// adsign(1/44100) in octave
+static const lsmp_t b_44100[7] = {
+  2.557411252042575133813784304948057979345321655273437500e-01,
+ -5.114822504085150267627568609896115958690643310546875000e-01,
+ -2.557411252042575133813784304948057979345321655273437500e-01,
+  1.022964500817030053525513721979223191738128662109375000e+00,
+ -2.557411252042575133813784304948057979345321655273437500e-01,
+ -5.114822504085150267627568609896115958690643310546875000e-01,
+  2.557411252042575133813784304948057979345321655273437500e-01,
+};
+static const lsmp_t a_44100[7] = {
+  1.000000000000000000000000000000000000000000000000000000e+00,
+ -4.019576181115832369528106937650591135025024414062500000e+00,
+  6.189406442920693862674852425698190927505493164062500000e+00,
+ -4.453198903544116404873420833609998226165771484375000000e+00,
+  1.420842949621876627475103305187076330184936523437500000e+00,
+ -1.418254738303044160119270600262098014354705810546875000e-01,
+  4.351177233495117681327801761881346465088427066802978516e-03,
+};
+
+// gain of the filter at freq, in dB, measured on the second half of one
+// second of a sine wave
+static double gain_at (aubio_filter_t *f, uint_t samplerate, double freq)
 {
-  
-  aubio_filter_t * f;
+  uint_t j, n = samplerate;
+  fvec_t *v = new_fvec (n);
+  double in = 0., out = 0., x;
+  for (j = 0; j < n; j++) {
+    v->data[j] = sin (2. * M_PI * freq * j / samplerate);
+  }
+  aubio_filter_do_reset (f);
+  aubio_filter_do (f, v);
+  for (j = n / 2; j < n; j++) {
+    x = sin (2. * M_PI * freq * j / samplerate);
+    in += x * x;
+    out += v->data[j] * v->data[j];
+  }
+  del_fvec (v);
+  return 10. * log10 (out / in);
+}
 
-  uint_t rates[] = { 8000, 16000, 22050, 44100, 96000, 192000};
-  uint_t nrates = 6;
-  uint_t samplerate, i = 0;
+int main (void)
+{
+  aubio_filter_t * f, * g;
+  uint_t rates[] = { 8000, 11025, 16000, 22050, 44100, 48000, 96000, 192000,
+    12345, 384000 };
+  uint_t nrates = sizeof(rates) / sizeof(rates[0]);
+  uint_t samplerate = 44100, i, j;
+  lvec_t *fa, *fb, *ga, *gb;
+  fvec_t *x, *y;
+  double g1000, g100, g10000;
 
-  for ( samplerate = rates[i]; i < nrates ; i++ ) {
+  for (i = 0; i < nrates; i++) {
+    samplerate = rates[i];
     f = new_aubio_filter_a_weighting (samplerate);
+    if (!f) return 1;
+    // 0dB at 1kHz, -19.1dB at 100Hz, and -2.5dB at 10kHz, in the range of
+    // frequencies where the bilinear transform does not warp too much
+    g1000 = gain_at (f, samplerate, 1000.);
+    g100 = gain_at (f, samplerate, 100.);
+    PRINT_MSG ("%6dHz: %+.3fdB at 1kHz, %+.3fdB at 100Hz\n", samplerate,
+        g1000, g100);
+    if (fabs(g1000) > (samplerate < 16000 ? .3 : .05)) return 1;
+    if (fabs(g100 + 19.1) > .1) return 1;
+    if (samplerate >= 192000) {
+      g10000 = gain_at (f, samplerate, 10000.);
+      if (fabs(g10000 + 2.5) > .1) return 1;
+    }
     del_aubio_filter (f);
 
     f = new_aubio_filter (7);
-    aubio_filter_set_a_weighting (f, samplerate);
+    if (aubio_filter_set_a_weighting (f, samplerate)) return 1;
     del_aubio_filter (f);
   }
 
-  // samplerate unknown
-  f = new_aubio_filter_a_weighting (4200);
-  if (!f) {
-    //PRINT_MSG ("failed creating A-weighting filter with samplerate=4200Hz\n");
+  // same coefficients as adsign
+  f = new_aubio_filter_a_weighting (44100);
+  fb = aubio_filter_get_feedforward (f);
+  fa = aubio_filter_get_feedback (f);
+  for (j = 0; j < 7; j++) {
+    if (fabs(fb->data[j] - b_44100[j]) > 1.e-12) return 1;
+    if (fabs(fa->data[j] - a_44100[j]) > 1.e-12) return 1;
   }
 
+  // the sections give the same output as the direct form
+  g = new_aubio_filter (7);
+  gb = aubio_filter_get_feedforward (g);
+  ga = aubio_filter_get_feedback (g);
+  for (j = 0; j < 7; j++) {
+    gb->data[j] = fb->data[j];
+    ga->data[j] = fa->data[j];
+  }
+  x = new_fvec (1024);
+  y = new_fvec (1024);
+  for (j = 0; j < x->length; j++) {
+    x->data[j] = (smpl_t)((j * 7919) % 1021) / 1021. - .5;
+  }
+  aubio_filter_do_outplace (f, x, y);
+  aubio_filter_do (g, x);
+  for (j = 0; j < x->length; j++) {
+    if (fabs(x->data[j] - y->data[j]) > 1.e-5) return 1;
+  }
+
+  // changing the coefficients runs the direct form again
+  for (j = 0; j < 7; j++) {
+    fb->data[j] *= 2.;
+    gb->data[j] *= 2.;
+  }
+  aubio_filter_do_reset (f);
+  aubio_filter_do_reset (g);
+  aubio_filter_do_outplace (f, x, y);
+  aubio_filter_do (g, x);
+  for (j = 0; j < x->length; j++) {
+    if (x->data[j] != y->data[j]) return 1;
+  }
+  del_fvec (x);
+  del_fvec (y);
+  del_aubio_filter (f);
+  del_aubio_filter (g);
+
+  // samplerate too low
+  f = new_aubio_filter_a_weighting (0);
+  if (f) return 1;
+
   // order to small
   f = new_aubio_filter (2);
-  if (aubio_filter_set_a_weighting (f, samplerate) != 0) {
-    //PRINT_MSG ("failed setting filter to A-weighting\n");
-  }
+  if (aubio_filter_set_a_weighting (f, samplerate) == 0) return 1;
   del_aubio_filter (f);
 
   // order to big
   f = new_aubio_filter (12);
-  if (aubio_filter_set_a_weighting (f, samplerate) != 0) {
-    //PRINT_MSG ("failed setting filter to A-weighting\n");
-  }
+  if (aubio_filter_set_a_weighting (f, samplerate) == 0) return 1;
   del_aubio_filter (f);
 
   return 0;
 }
-
@@ -1,42 +1,95 @@
 #include <aubio.h>
+#include "utils_tests.h"
+
+// direct form coefficients of the C-weighting at 44100Hz, as computed with
+// cdsign(1/44100) in octave
+static const lsmp_t b_44100[5] = {
+  2.170085619492190254220531642204150557518005371093750000e-01,
+  0.000000000000000000000000000000000000000000000000000000e+00,
+ -4.340171238984380508441063284408301115036010742187500000e-01,
+  0.000000000000000000000000000000000000000000000000000000e+00,
+  2.170085619492190254220531642204150557518005371093750000e-01,
+};
+static const lsmp_t a_44100[5] = {
+  1.000000000000000000000000000000000000000000000000000000e+00,
+ -2.134674963687040794013682898366823792457580566406250000e+00,
+  1.279333533236062692139967111870646476745605468750000000e+00,
+ -1.495598460893957093453821016737492755055427551269531250e-01,
+  4.908700174624683852664386307651511742733418941497802734e-03,
+};
+
+// gain of the filter at freq, in dB, measured on the second half of one
+// second of a sine wave
+static double gain_at (aubio_filter_t *f, uint_t samplerate, double freq)
+{
+  uint_t j, n = samplerate;
+  fvec_t *v = new_fvec (n);
+  double in = 0., out = 0., x;
+  for (j = 0; j < n; j++) {
+    v->data[j] = sin (2. * M_PI * freq * j / samplerate);
+  }
+  aubio_filter_do_reset (f);
+  aubio_filter_do (f, v);
+  for (j = n / 2; j < n; j++) {
+    x = sin (2. * M_PI * freq * j / samplerate);
+    in += x * x;
+    out += v->data[j] * v->data[j];
+  }
+  del_fvec (v);
+  return 10. * log10 (out / in);
+}
 
 int main (void)
 {
   aubio_filter_t * f;
+  uint_t rates[] = { 8000, 11025, 16000, 22050, 44100, 48000, 96000, 192000,
+    12345, 384000 };
+  uint_t nrates = sizeof(rates) / sizeof(rates[0]);
+  uint_t samplerate = 44100, i, j;
+  lvec_t *fa, *fb;
+  double g1000, g50;
 
-  uint_t rates[] = { 8000, 16000, 22050, 44100, 96000, 192000};
-  uint_t nrates = 6;
-  uint_t samplerate, i = 0;
-
-  for ( samplerate = rates[i]; i < nrates ; i++ ) {
+  for (i = 0; i < nrates; i++) {
+    samplerate = rates[i];
     f = new_aubio_filter_c_weighting (samplerate);
+    if (!f) return 1;
+    // 0dB at 1kHz and -1.3dB at 50Hz
+    g1000 = gain_at (f, samplerate, 1000.);
+    g50 = gain_at (f, samplerate, 50.);
+    PRINT_MSG ("%6dHz: %+.3fdB at 1kHz, %+.3fdB at 50Hz\n", samplerate,
+        g1000, g50);
+    if (fabs(g1000) > (samplerate < 16000 ? .3 : .05)) return 1;
+    if (fabs(g50 + 1.3) > .1) return 1;
     del_aubio_filter (f);
 
     f = new_aubio_filter (5);
-    aubio_filter_set_c_weighting (f, samplerate);
+    if (aubio_filter_set_c_weighting (f, samplerate)) return 1;
     del_aubio_filter (f);
   }
 
-  // samplerate unknown
-  f = new_aubio_filter_c_weighting (4200);
-  if (!f) {
-    //PRINT_WRN ("failed creating C-weighting filter with samplerate=4200Hz");
+  // same coefficients as cdsign
+  f = new_aubio_filter_c_weighting (44100);
+  fb = aubio_filter_get_feedforward (f);
+  fa = aubio_filter_get_feedback (f);
+  for (j = 0; j < 5; j++) {
+    if (fabs(fb->data[j] - b_44100[j]) > 1.e-12) return 1;
+    if (fabs(fa->data[j] - a_44100[j]) > 1.e-12) return 1;
   }
+  del_aubio_filter (f);
+
+  // samplerate too low
+  f = new_aubio_filter_c_weighting (0);
+  if (f) return 1;
 
   // order to small
   f = new_aubio_filter (2);
-  if (aubio_filter_set_c_weighting (f, samplerate) != 0) {
-    //PRINT_WRN ("failed setting filter to C-weighting");
-  }
+  if (aubio_filter_set_c_weighting (f, samplerate) == 0) return 1;
   del_aubio_filter (f);
 
   // order to big
   f = new_aubio_filter (12);
-  if (aubio_filter_set_c_weighting (f, samplerate) != 0) {
-    //PRINT_WRN ("failed setting filter to C-weighting");
-  }
+  if (aubio_filter_set_c_weighting (f, samplerate) == 0) return 1;
   del_aubio_filter (f);
 
   return 0;
 }
-
@@ -0,0 +1,161 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+#include "utils_tests.h"
+
+// compare the output of the partitioned convolution to a direct convolution,
+// for several block sizes and impulse lengths, and the complex
+// multiply-accumulate kernels of each instruction set to the scalar ones
+
+#define N_BLOCKS 24
+
+#if !HAVE_AUBIO_DOUBLE
+#define MAX_ERR 1.e-4
+#else
+#define MAX_ERR 1.e-10
+#endif
+
+// largest difference between the convolver and a direct form, the impulse
+// response being changed halfway if shorter is not NULL
+static smpl_t check_convolver (uint_t block_size, uint_t length,
+    const fvec_t *shorter)
+{
+  fvec_t *h = new_fvec (length), *x = new_fvec (N_BLOCKS * block_size);
+  fvec_t *block = new_fvec (block_size);
+  aubio_convolver_t *c;
+  smpl_t max_err = 0.;
+  uint_t n, j, k;
+  if (!h || !x || !block) return 1.;
+  for (j = 0; j < length; j++) {
+    h->data[j] = EXP(-(smpl_t)j / (length / 4. + 1.))
+      * (random () % 2001 - 1000) / 1000.;
+  }
+  for (j = 0; j < x->length; j++) {
+    x->data[j] = (random () % 2001 - 1000) / 1000.;
+  }
+  c = new_aubio_convolver (h, block_size);
+  if (!c) return 1.;
+  for (n = 0; n < N_BLOCKS; n++) {
+    const fvec_t *cur = h;
+    if (shorter && n == N_BLOCKS / 2) {
+      if (aubio_convolver_set_impulse (c, shorter)) return 1.;
+    }
+    if (shorter && n >= N_BLOCKS / 2) cur = shorter;
+    // in place
+    for (j = 0; j < block_size; j++) {
+      block->data[j] = x->data[n * block_size + j];
+    }
+    aubio_convolver_do (c, block, block);
+    for (j = 0; j < block_size; j++) {
+      uint_t i = n * block_size + j;
+      smpl_t ref = 0.;
+      for (k = 0; k < cur->length && k <= i; k++) {
+        ref += cur->data[k] * x->data[i - k];
+      }
+      max_err = MAX(max_err, ABS(block->data[j] - ref));
+    }
+  }
+  del_aubio_convolver (c);
+  del_fvec (h);
+  del_fvec (x);
+  del_fvec (block);
+  return max_err;
+}
+
+// an empty value selects the default table
+static void set_isa (const char_t *isa)
+{
+#ifdef _WIN32
+  _putenv_s("AUBIO_SIMD", isa);
+#else
+  setenv("AUBIO_SIMD", isa, 1);
+#endif
+}
+
+static uint_t check_kernels (void)
+{
+  const char_t *isas[] = { "sse2", "avx2", "avx512", "neon" };
+  const aubio_simd_ops_t *ref = aubio_simd_scalar_ops (), *ops;
+  uint_t n = 37, i, j, err = 0;
+  fvec_t *a = new_fvec (2 * n), *b = new_fvec (2 * n);
+  fvec_t *acc = new_fvec (2 * n), *acc_ref = new_fvec (2 * n);
+  if (!a || !b || !acc || !acc_ref) return 1;
+  for (j = 0; j < 2 * n; j++) {
+    a->data[j] = (random () % 2001 - 1000) / 1000.;
+    b->data[j] = (random () % 2001 - 1000) / 1000.;
+    acc_ref->data[j] = (random () % 2001 - 1000) / 1000.;
+  }
+  fvec_copy (acc_ref, acc);
+  // odd length, to go through the tail of each instruction set
+  ref->cmac (a->data, b->data, acc_ref->data, n);
+  for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+    smpl_t max_err = 0.;
+    fvec_t *out = new_fvec (2 * n);
+    set_isa (isas[i]);
+    ops = aubio_simd_init ();
+    if (out && strcmp (ops->name, isas[i]) == 0) {
+      fvec_copy (acc, out);
+      ops->cmac (a->data, b->data, out->data, n);
+      for (j = 0; j < 2 * n; j++) {
+        max_err = MAX(max_err, ABS(out->data[j] - acc_ref->data[j]));
+      }
+      PRINT_MSG ("%s: max difference %g\n", isas[i], max_err);
+      if (max_err > 1.e-6) err = 1;
+    }
+    if (out) del_fvec (out);
+  }
+  set_isa ("");
+  aubio_simd_init ();
+  del_fvec (a);
+  del_fvec (b);
+  del_fvec (acc);
+  del_fvec (acc_ref);
+  return err;
+}
+
+int main (void)
+{
+  uint_t sizes[][2] = { {64, 1}, {64, 64}, {64, 1000}, {256, 300},
+    {16, 4097}, {1024, 1024} };
+  uint_t i, err = 0;
+  fvec_t *h = new_fvec (100), *longer = new_fvec (300), *shorter;
+  aubio_convolver_t *c;
+  fvec_t *in = new_fvec (64);
+  if (!h || !longer || !in) return 1;
+  // wrong parameters
+  if (new_aubio_convolver (h, 100)) err = 1;
+  if (new_aubio_convolver (h, 0)) err = 1;
+  c = new_aubio_convolver (h, 64);
+  if (!c || aubio_convolver_get_block_size (c) != 64) return 1;
+  if (!aubio_convolver_set_impulse (c, longer)) err = 1;
+  aubio_convolver_do (c, h, in);
+  del_aubio_convolver (c);
+  del_fvec (in);
+  del_fvec (h);
+  del_fvec (longer);
+  if (err) PRINT_ERR ("wrong parameters were accepted\n");
+  srandom (1);
+  for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    smpl_t max_err = check_convolver (sizes[i][0], sizes[i][1], NULL);
+    PRINT_MSG ("block size %d, %d taps: max error %g\n", sizes[i][0],
+        sizes[i][1], max_err);
+    if (max_err > MAX_ERR) err = 1;
+  }
+  // switching to a shorter impulse response halfway
+  shorter = new_fvec (150);
+  if (!shorter) return 1;
+  for (i = 0; i < shorter->length; i++) {
+    shorter->data[i] = (random () % 2001 - 1000) / 1000. / (i + 1.);
+  }
+  if (check_convolver (64, 500, shorter) > MAX_ERR) {
+    PRINT_ERR ("wrong output after changing the impulse response\n");
+    err = 1;
+  }
+  del_fvec (shorter);
+  if (check_kernels ()) {
+    PRINT_ERR ("kernels do not match the scalar ones\n");
+    err = 1;
+  }
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,82 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// direct form reference of the difference equation computed by aubio_filter,
+// keeping the past outputs in double precision as the filter does
+static void
+filter_reference (const lvec_t * a, const lvec_t * b, const fvec_t * in,
+    fvec_t * out)
+{
+  uint_t j, l;
+  lvec_t *y = new_lvec (in->length);
+  for (j = 0; j < in->length; j++) {
+    for (l = 0; l < b->length && l <= j; l++) {
+      y->data[j] += b->data[l] * in->data[j - l];
+      if (l > 0) y->data[j] -= a->data[l] * y->data[j - l];
+    }
+    out->data[j] = y->data[j];
+  }
+  del_lvec (y);
+}
+
+int main (void)
+{
+  uint_t i, j, k, n, win_s = 1024;
+  uint_t orders[] = { 1, 2, 3, 4, 5, 7, 9 };
+  uint_t blocks[] = { 1, 7, 64, 200 };
+  fvec_t *in = new_fvec (win_s);
+  fvec_t *ref = new_fvec (win_s);
+  fvec_t block;
+
+  utils_init_random();
+  for (j = 0; j < win_s; j++) {
+    in->data[j] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+  }
+
+  for (i = 0; i < sizeof(orders) / sizeof(orders[0]); i++) {
+    aubio_filter_t *f = new_aubio_filter (orders[i]);
+    lvec_t *a = aubio_filter_get_feedback (f);
+    lvec_t *b = aubio_filter_get_feedforward (f);
+    // a stable filter: feedback taps small enough to keep poles inside
+    for (j = 0; j < orders[i]; j++) {
+      b->data[j] = 1. / (j + 1.);
+      if (j > 0) a->data[j] = 0.4 / (orders[i] * (j + 1.));
+    }
+    filter_reference (a, b, in, ref);
+    // feeding the signal in blocks of any size gives the same output
+    for (k = 0; k < sizeof(blocks) / sizeof(blocks[0]); k++) {
+      fvec_t *out = new_fvec (win_s);
+      fvec_copy (in, out);
+      aubio_filter_do_reset (f);
+      for (n = 0; n < win_s; n += block.length) {
+        block.data = out->data + n;
+        block.length = blocks[k] < win_s - n ? blocks[k] : win_s - n;
+        aubio_filter_do (f, &block);
+      }
+      for (j = 0; j < win_s; j++) {
+        assert(fabs(out->data[j] - ref->data[j]) < 1.e-5);
+      }
+      del_fvec (out);
+    }
+    del_aubio_filter (f);
+  }
+
+  // the weighting filters run on the same kernels
+  {
+    aubio_filter_t *f = new_aubio_filter_a_weighting (44100);
+    fvec_t *out = new_fvec (win_s);
+    filter_reference (aubio_filter_get_feedback (f),
+        aubio_filter_get_feedforward (f), in, ref);
+    aubio_filter_do_outplace (f, in, out);
+    for (j = 0; j < win_s; j++) {
+      assert(fabs(out->data[j] - ref->data[j]) < 1.e-4);
+    }
+    del_fvec (out);
+    del_aubio_filter (f);
+  }
+
+  del_fvec (in);
+  del_fvec (ref);
+  aubio_cleanup ();
+  return 0;
+}
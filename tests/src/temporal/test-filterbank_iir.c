@@ -0,0 +1,73 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+int main (void)
+{
+  uint_t i, j, k, n_bands = 7, hop_s = 256, samplerate = 44100;
+  smpl_t freqs[7] = { 60., 150., 400., 1000., 2500., 6000., 12000. };
+  aubio_filterbank_iir_t *fb = new_aubio_filterbank_iir (n_bands, samplerate);
+  aubio_filter_t *refs[7];
+  fvec_t *in = new_fvec (hop_s);
+  fvec_t *ref_out = new_fvec (hop_s);
+  fvec_t *env = new_fvec (n_bands);
+  fmat_t *bands = new_fmat (n_bands, hop_s);
+  fvec_t band;
+
+  if (!fb) return 1;
+  assert(new_aubio_filterbank_iir (0, samplerate) == NULL);
+  assert(aubio_filterbank_iir_get_n_bands (fb) == n_bands);
+  assert(aubio_filterbank_iir_get_samplerate (fb) == samplerate);
+  assert(aubio_filterbank_iir_set_bandpass (fb, n_bands, 100., 1.) != 0);
+  assert(aubio_filterbank_iir_set_bandpass (fb, 0, samplerate, 1.) != 0);
+  assert(aubio_filterbank_iir_set_bandpass (fb, 0, 100., 0.) != 0);
+  assert(aubio_filterbank_iir_set_envelope (fb, -1., 0.1) != 0);
+
+  // each band matches a single biquad with the same coefficients
+  for (k = 0; k < n_bands; k++) {
+    smpl_t w0 = 2. * M_PI * freqs[k] / samplerate;
+    smpl_t alpha = sin(w0) / (2. * 2.), a0 = 1. + alpha;
+    assert(aubio_filterbank_iir_set_bandpass (fb, k, freqs[k], 2.) == 0);
+    refs[k] = new_aubio_filter_biquad (alpha / a0, 0., -alpha / a0,
+        -2. * cos(w0) / a0, (1. - alpha) / a0);
+  }
+  utils_init_random();
+  for (i = 0; i < 20; i++) {
+    for (j = 0; j < hop_s; j++) {
+      in->data[j] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+    }
+    aubio_filterbank_iir_do (fb, in, bands);
+    for (k = 0; k < n_bands; k++) {
+      aubio_filter_do_outplace (refs[k], in, ref_out);
+      fmat_get_channel (bands, k, &band);
+      for (j = 0; j < hop_s; j++) {
+        assert(fabs(band.data[j] - ref_out->data[j]) < 1.e-4);
+      }
+    }
+  }
+
+  // the envelope of a sine is highest in the band of its frequency
+  aubio_filterbank_iir_reset (fb);
+  assert(aubio_filterbank_iir_set_envelope (fb, 0.001, 0.2) == 0);
+  for (i = 0; i < 100; i++) {
+    for (j = 0; j < hop_s; j++) {
+      in->data[j] = sin(2. * M_PI * freqs[3] * (i * hop_s + j) / samplerate);
+    }
+    aubio_filterbank_iir_do_envelope (fb, in, env);
+  }
+  for (k = 0; k < n_bands; k++) {
+    if (k != 3) assert(env->data[k] < env->data[3]);
+  }
+  // the band-pass filters have a gain of 0 dB at their center frequency
+  assert(fabs(env->data[3] - 1.) < 0.05);
+
+  for (k = 0; k < n_bands; k++) {
+    del_aubio_filter (refs[k]);
+  }
+  del_aubio_filterbank_iir (fb);
+  del_fvec (in);
+  del_fvec (ref_out);
+  del_fvec (env);
+  del_fmat (bands);
+  aubio_cleanup ();
+  return 0;
+}
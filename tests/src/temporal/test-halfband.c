@@ -0,0 +1,122 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// decimate a sine of freq cycles per input sample, return the largest
+// difference to the same sine sampled at the lower rate, after the delay
+static smpl_t test_decimator (uint_t factor, smpl_t freq, smpl_t gain)
+{
+  uint_t i, j, hop_s = 256, n_hops = 40;
+  aubio_decimator_t *o = new_aubio_decimator (factor);
+  uint_t delay = aubio_decimator_get_delay (o);
+  fvec_t *in = new_fvec (hop_s), *out = new_fvec (hop_s / factor);
+  smpl_t err = 0.;
+  for (i = 0; i < n_hops; i++) {
+    for (j = 0; j < hop_s; j++) {
+      in->data[j] = sin (2. * M_PI * freq * (i * hop_s + j));
+    }
+    aubio_decimator_do (o, in, out);
+    // skip the first hops, until the filters are filled
+    if (i < 4) continue;
+    for (j = 0; j < out->length; j++) {
+      double t = (i * hop_s + j * factor) - (double)delay;
+      double e = fabs (out->data[j] - gain * sin (2. * M_PI * freq * t));
+      if (e > err) err = e;
+    }
+  }
+  del_aubio_decimator (o);
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+// same as above, interpolating a sine of freq cycles per output sample
+static smpl_t test_interpolator (uint_t factor, smpl_t freq)
+{
+  uint_t i, j, hop_s = 64, n_hops = 40;
+  aubio_interpolator_t *o = new_aubio_interpolator (factor);
+  uint_t delay = aubio_interpolator_get_delay (o);
+  fvec_t *in = new_fvec (hop_s), *out = new_fvec (hop_s * factor);
+  smpl_t err = 0.;
+  for (i = 0; i < n_hops; i++) {
+    for (j = 0; j < hop_s; j++) {
+      in->data[j] = sin (2. * M_PI * freq * factor * (i * hop_s + j));
+    }
+    aubio_interpolator_do (o, in, out);
+    if (i < 4) continue;
+    for (j = 0; j < out->length; j++) {
+      double t = (i * hop_s * factor + j) - (double)delay;
+      double e = fabs (out->data[j] - sin (2. * M_PI * freq * t));
+      if (e > err) err = e;
+    }
+  }
+  del_aubio_interpolator (o);
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t factors[3] = { 2, 4, 8 };
+  uint_t f, i, j;
+  fvec_t *in = new_fvec (512), *out = new_fvec (64), *ref = new_fvec (64);
+  aubio_decimator_t *d, *blocks;
+
+  assert (new_aubio_decimator (3) == NULL);
+  assert (new_aubio_interpolator (16) == NULL);
+
+  for (f = 0; f < 3; f++) {
+    uint_t factor = factors[f];
+    // flat up to 0.84 times the output nyquist frequency, cut from its
+    // mirror image, which would fold onto that band
+    smpl_t pass = .42 / factor, stop = .58 / factor;
+    smpl_t e_low = test_decimator (factor, .1 * pass, 1.);
+    smpl_t e_pass = test_decimator (factor, pass, 1.);
+    smpl_t e_stop = test_decimator (factor, stop, 0.);
+    smpl_t e_alias = test_decimator (factor, .5 - pass, 0.);
+    smpl_t e_up = test_interpolator (factor, .1 * pass);
+    smpl_t e_up_pass = test_interpolator (factor, pass);
+    PRINT_MSG ("factor %d: %g %g %g %g, up %g %g\n", factor, e_low, e_pass,
+        e_stop, e_alias, e_up, e_up_pass);
+    assert (e_low < 1.e-4);
+    assert (e_pass < 1.e-3);
+    // about -80 dB in the stop band
+    assert (e_stop < 2.e-4);
+    assert (e_alias < 2.e-4);
+    assert (e_up < 1.e-4);
+    assert (e_up_pass < 1.e-3);
+  }
+
+  // decimating in blocks gives the same output as in a single call
+  d = new_aubio_decimator (8);
+  blocks = new_aubio_decimator (8);
+  for (i = 0; i < 3; i++) {
+    for (j = 0; j < in->length; j++) {
+      in->data[j] = sin (.01 * (i * in->length + j) * j);
+    }
+    aubio_decimator_do (d, in, ref);
+    for (j = 0; j < 4; j++) {
+      fvec_t in_block = { 128, in->data + j * 128 };
+      fvec_t out_block = { 16, out->data + j * 16 };
+      aubio_decimator_do (blocks, &in_block, &out_block);
+    }
+    for (j = 0; j < ref->length; j++) {
+      assert (fabs (out->data[j] - ref->data[j]) < 1.e-6);
+    }
+  }
+  // the same input after a reset gives the same output
+  aubio_decimator_reset (d);
+  aubio_decimator_reset (blocks);
+  aubio_decimator_do (d, in, ref);
+  aubio_decimator_do (blocks, in, out);
+  for (j = 0; j < ref->length; j++) {
+    assert (out->data[j] == ref->data[j]);
+  }
+  del_aubio_decimator (d);
+  del_aubio_decimator (blocks);
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (ref);
+
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// sections of the K-weighting at 48kHz, as given in ITU-R BS.1770-4
+static const double shelf_b[3] = { 1.53512485958697, -2.69169618940638,
+  1.19839281085285 };
+static const double shelf_a[3] = { 1., -1.69065929318241, 0.73248077421585 };
+static const double rlb_b[3] = { 1., -2., 1. };
+static const double rlb_a[3] = { 1., -1.99004745483398, 0.99007225036621 };
+
+// gain of the filter at freq, in dB, measured on the second half of one
+// second of a sine wave
+static double gain_at (aubio_filter_t *f, uint_t samplerate, double freq)
+{
+  uint_t j, n = samplerate;
+  fvec_t *v = new_fvec (n);
+  double in = 0., out = 0., x;
+  for (j = 0; j < n; j++) {
+    v->data[j] = sin (2. * M_PI * freq * j / samplerate);
+  }
+  aubio_filter_do_reset (f);
+  aubio_filter_do (f, v);
+  for (j = n / 2; j < n; j++) {
+    x = sin (2. * M_PI * freq * j / samplerate);
+    in += x * x;
+    out += v->data[j] * v->data[j];
+  }
+  del_fvec (v);
+  return 10. * log10 (out / in);
+}
+
+int main (void)
+{
+  aubio_filter_t * f;
+  uint_t rates[] = { 16000, 22050, 44100, 48000, 96000, 192000 };
+  uint_t nrates = sizeof(rates) / sizeof(rates[0]);
+  uint_t i, j, k, err = 0;
+  double b[5] = { 0. }, a[5] = { 0. }, g997, g20, g8000, high;
+  lvec_t *fb, *fa;
+
+  // the direct form of the two sections of the standard
+  for (j = 0; j < 3; j++) {
+    for (k = 0; k < 3; k++) {
+      b[j + k] += shelf_b[j] * rlb_b[k];
+      a[j + k] += shelf_a[j] * rlb_a[k];
+    }
+  }
+  f = new_aubio_filter_k_weighting (48000);
+  if (!f) return 1;
+  fb = aubio_filter_get_feedforward (f);
+  fa = aubio_filter_get_feedback (f);
+  for (j = 0; j < 5; j++) {
+    if (fabs (fb->data[j] - b[j]) > 1.e-8 || fabs (fa->data[j] - a[j]) > 1.e-8)
+    {
+      PRINT_MSG ("coefficient %d: b = %.14f, a = %.14f, expected %.14f %.14f\n",
+          j, (double)fb->data[j], (double)fa->data[j], b[j], a[j]);
+      err = 1;
+    }
+  }
+  del_aubio_filter (f);
+
+  for (i = 0; i < nrates; i++) {
+    f = new_aubio_filter_k_weighting (rates[i]);
+    if (!f) return 1;
+    // about +0.691dB at 997Hz, the offset of BS.1770, exactly at 48kHz,
+    // +4dB well above the shelf, and a steep slope below the highpass
+    g997 = gain_at (f, rates[i], 997.);
+    g20 = gain_at (f, rates[i], 20.);
+    high = rates[i] < 32000 ? rates[i] / 4. : 8000.;
+    g8000 = gain_at (f, rates[i], high);
+    PRINT_MSG ("%6dHz: %+.3fdB at 997Hz, %+.3fdB at 20Hz, %+.3fdB at %.0fHz\n",
+        rates[i], g997, g20, g8000, high);
+    if (fabs (g997 - 0.691) > 0.05) err = 1;
+    if (g20 > -10. || g20 < -20.) err = 1;
+    if (fabs (g8000 - 4.) > 0.3) err = 1;
+    del_aubio_filter (f);
+  }
+
+  // wrong order, wrong samplerate
+  f = new_aubio_filter (7);
+  if (aubio_filter_set_k_weighting (f, 44100) == 0) err = 1;
+  del_aubio_filter (f);
+  if (new_aubio_filter_k_weighting (0) != NULL) err = 1;
+
+  if (err) PRINT_ERR ("K-weighting differs from the one expected\n");
+  aubio_cleanup ();
+  return err;
+}
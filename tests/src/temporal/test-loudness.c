@@ -0,0 +1,96 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// measure sine waves of 997Hz, the reference of BS.1770, and the gating
+// cases of EBU Tech 3341
+
+// feed seconds of a sine of 997Hz with a peak of db dBFS to all channels
+static void feed (aubio_loudness_t *o, fmat_t *in, fvec_t *out,
+    uint_t samplerate, double seconds, double db, uint_t *t)
+{
+  uint_t n, j, c, hop = in->length;
+  uint_t frames = (uint_t)(seconds * samplerate);
+  double amp = db > -200. ? pow (10., db / 20.) : 0.;
+  fvec_t mono;
+  for (n = 0; n < frames; n += hop) {
+    for (j = 0; j < hop; j++) {
+      in->data[0][j] = amp * sin (2. * M_PI * 997. * (*t + j) / samplerate);
+      for (c = 1; c < in->height; c++) {
+        in->data[c][j] = in->data[0][j];
+      }
+    }
+    *t += hop;
+    if (in->height == 1) {
+      mono.length = hop;
+      mono.data = in->data[0];
+      aubio_loudness_do (o, &mono, out);
+    } else {
+      aubio_loudness_do_multi (o, in, out);
+    }
+  }
+}
+
+static uint_t check (uint_t channels, uint_t hop_size, uint_t samplerate)
+{
+  aubio_loudness_t *o = new_aubio_loudness (hop_size, samplerate);
+  fmat_t *in = new_fmat (channels, hop_size);
+  fvec_t *out = new_fvec (3);
+  // peak level of each channel for a loudness of -23 LUFS
+  double ref = -20. - 10. * log10 (channels);
+  uint_t t = 0, err = 0;
+  if (!o || !in || !out) return 1;
+  if (aubio_loudness_set_channels (o, channels)) return 1;
+  if (aubio_loudness_get_channels (o) != channels) return 1;
+
+  feed (o, in, out, samplerate, 10., ref, &t);
+  PRINT_MSG ("%d channels, hop %d, %dHz: %.3f %.3f %.3f LUFS\n", channels,
+      hop_size, samplerate, out->data[0], out->data[1], out->data[2]);
+  if (fabs (out->data[0] + 23.) > .1 || fabs (out->data[1] + 23.) > .1
+      || fabs (out->data[2] + 23.) > .1) err = 1;
+  if (out->data[0] != aubio_loudness_get_momentary (o)
+      || out->data[1] != aubio_loudness_get_short_term (o)
+      || out->data[2] != aubio_loudness_get_integrated (o)) err = 1;
+
+  // silence is below the absolute gate, 3s empty the short-term window, the
+  // decay of the last blocks lowers the integrated loudness slightly
+  feed (o, in, out, samplerate, 4., -300., &t);
+  if (out->data[0] > -100. || out->data[1] > -100.
+      || fabs (out->data[2] + 23.) > .15) err = 1;
+
+  // 10s at -36, 60s at -23 and 10s at -36 LUFS read as -23 LUFS, the quiet
+  // parts being below the relative gate; here with half of each
+  aubio_loudness_reset (o);
+  if (!isinf (aubio_loudness_get_integrated (o))) err = 1;
+  feed (o, in, out, samplerate, 5., ref - 13., &t);
+  feed (o, in, out, samplerate, 30., ref, &t);
+  feed (o, in, out, samplerate, 5., ref - 13., &t);
+  PRINT_MSG ("gated: %.3f LUFS\n", out->data[2]);
+  if (fabs (out->data[2] + 23.) > .1) err = 1;
+
+  // -72 and -69 LUFS, the first one below the absolute gate
+  aubio_loudness_reset (o);
+  feed (o, in, out, samplerate, 5., ref - 49., &t);
+  if (!isinf (out->data[2])) err = 1;
+  feed (o, in, out, samplerate, 5., ref - 46., &t);
+  PRINT_MSG ("quiet: %.3f LUFS\n", out->data[2]);
+  if (fabs (out->data[2] + 69.) > .1) err = 1;
+
+  del_aubio_loudness (o);
+  del_fmat (in);
+  del_fvec (out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  err |= check (1, 512, 48000);
+  err |= check (2, 256, 44100);
+  err |= check (1, 4800, 48000);
+  err |= check (3, 1000, 22050);
+  if (new_aubio_loudness (0, 44100) != NULL) err = 1;
+  if (new_aubio_loudness (512, 0) != NULL) err = 1;
+  if (err) PRINT_ERR ("loudness differs from the one expected\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -1,4 +1,61 @@
 #include <aubio.h>
+#include "utils_tests.h"
+
+// resample a sine, then fit a sine of the same frequency to the output, after
+// the first frames: return the largest difference to the fitted sine. Each
+// block of hop_out frames is computed from the input frames it needs.
+static smpl_t test_sine (smpl_t ratio, uint_t type, uint_t hop_out,
+    uint_t channels)
+{
+  uint_t hop_in = (uint_t) ceil (hop_out / ratio) + 1, n_hops = 64, skip = 8;
+  uint_t i, j, k, n = (n_hops - skip) * hop_out, read = 0;
+  double freq = 997. / 44100., a, b, err = 0.;
+  double ss = 0., sc = 0., cc = 0., ys = 0., yc = 0.;
+  fmat_t *in = new_fmat (channels, hop_in);
+  fmat_t *out = new_fmat (channels, hop_out);
+  fvec_t *res = new_fvec (n);
+  aubio_resampler_t *o = new_aubio_resampler (ratio, type);
+  if (!o) return 1.;
+  for (i = 0; i < n_hops; i++) {
+    fmat_t block = *in;
+    block.length = (uint_t) ceil ((i + 1.) * hop_out / ratio) - read;
+    for (j = 0; j < block.length; j++) {
+      for (k = 0; k < channels; k++) {
+        // the channels have opposite signs
+        in->data[k][j] = (k % 2 ? -.5 : .5)
+          * sin (2. * M_PI * freq * (read + j));
+      }
+    }
+    read += block.length;
+    aubio_resampler_do_multi (o, &block, out);
+    for (j = 0; j < hop_out; j++) {
+      for (k = 1; k < channels; k++) {
+        smpl_t other = (k % 2 ? -1. : 1.) * out->data[k][j];
+        if (other != out->data[0][j]) err = 1.;
+      }
+      if (i >= skip) res->data[(i - skip) * hop_out + j] = out->data[0][j];
+    }
+  }
+  // least squares fit of a sine and cosine at the output frequency
+  for (j = 0; j < n; j++) {
+    double sn = sin (2. * M_PI * freq / ratio * j);
+    double cs = cos (2. * M_PI * freq / ratio * j);
+    ss += sn * sn; sc += sn * cs; cc += cs * cs;
+    ys += res->data[j] * sn; yc += res->data[j] * cs;
+  }
+  a = (ys * cc - yc * sc) / (ss * cc - sc * sc);
+  b = (yc * ss - ys * sc) / (ss * cc - sc * sc);
+  for (j = 0; j < n; j++) {
+    double fit = a * sin (2. * M_PI * freq / ratio * j)
+      + b * cos (2. * M_PI * freq / ratio * j);
+    if (fabs (res->data[j] - fit) > err) err = fabs (res->data[j] - fit);
+  }
+  del_aubio_resampler (o);
+  del_fmat (in);
+  del_fmat (out);
+  del_fvec (res);
+  return err;
+}
 
 int main (void)
 {
@@ -7,16 +64,42 @@ int main (void)
   fvec_t *in = new_fvec (win_s); // input buffer
   fvec_t *out = new_fvec ((uint_t) (win_s * ratio)); // output buffer
   aubio_resampler_t *o = new_aubio_resampler (0.5, 0);
-  uint_t i = 0;
+  smpl_t ratios[] = { 48000. / 44100., 44100. / 48000., 2., 4., .5, .25,
+    22050. / 44100., 32000. / 44100., 3.3 };
+  smpl_t tolerances[] = { 1.e-4, 1.e-4, 1.e-3, 5.e-3 };
+#ifdef HAVE_SAMPLERATE
+  // types 3 and 4 of libsamplerate are a zero order hold and a linear filter
+  uint_t n_types = 3;
+#else
+  uint_t n_types = 4;
+#endif
+  uint_t i = 0, r, t, err = 0;
+
+  if (!o) return 1;
 
   while (i < 10) {
     aubio_resampler_do (o, in, out);
     i++;
   };
+  if (aubio_resampler_reset (o)) return 1;
 
   del_aubio_resampler (o);
   del_fvec (in);
   del_fvec (out);
 
-  return 0;
+  for (r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++) {
+    for (t = 0; t < n_types; t++) {
+      // up to 3 channels, each checked against the first one
+      smpl_t e = test_sine (ratios[r], t, 256, 1 + (r + t) % 3);
+      PRINT_MSG ("ratio %f, type %d: error %g\n", ratios[r], t, e);
+      if (e > tolerances[t]) {
+        PRINT_ERR ("ratio %f, type %d: error %f\n", ratios[r], t, e);
+        err = 1;
+      }
+    }
+  }
+
+  aubio_cleanup ();
+
+  return err;
 }
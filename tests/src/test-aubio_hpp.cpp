@@ -0,0 +1,98 @@
+#include "config.h"
+#include <aubio.hpp>
+#include <cmath>
+#include <cstdio>
+#include <type_traits>
+
+// the C++ classes own their objects, and read spans of samples in place
+
+#define REDEFINESTRING(x) #x
+#define DEFINEDSTRING(x) REDEFINESTRING(x)
+
+#define WIN_S 1024
+#define HOP_S 256
+
+static_assert (!std::is_copy_constructible_v<aubio::onset>
+    && std::is_nothrow_move_constructible_v<aubio::onset>
+    && std::is_nothrow_move_assignable_v<aubio::source>,
+    "aubio objects are moved, never copied");
+
+// spans of a fixed length only accept arrays of that length
+static_assert (std::is_invocable_v<aubio::fixed_onset<WIN_S, HOP_S>,
+    std::array<smpl_t, HOP_S> &>
+    && !std::is_invocable_v<aubio::fixed_onset<WIN_S, HOP_S>,
+    std::array<smpl_t, HOP_S / 2> &>);
+
+static int check_vectors (void)
+{
+  aubio::fvec v (4);
+  aubio::cvec c (WIN_S);
+  int err = 0;
+  v[2] = 1.;
+  aubio::span<const smpl_t> view = v;
+  if (view.size () != 4 || view.data () != v.get ()->data || view[2] != 1.)
+    err = 1;
+  if (c.norm ().size () != WIN_S / 2 + 1) err = 1;
+  aubio::fvec moved (std::move (v));
+  if (moved.size () != 4 || moved[2] != 1.) err = 1;
+  return err;
+}
+
+static int check_errors (void)
+{
+  int err = 1;
+  std::vector<smpl_t> hop (HOP_S / 2);
+  try {
+    aubio::source s ("/nonexistent/file.wav", 0, HOP_S);
+  } catch (const std::runtime_error &) {
+    err = 0;
+  }
+  try {
+    aubio::onset o ("default", WIN_S, HOP_S, 44100);
+    o (hop);
+    err = 1;
+  } catch (const std::length_error &) {
+  }
+  return err;
+}
+
+static int check_analysis (const char *path)
+{
+  aubio::source s (path, 0, HOP_S);
+  uint_t samplerate = s.samplerate ();
+  aubio::onset o ("default", WIN_S, HOP_S, samplerate);
+  aubio::tempo t ("default", WIN_S, HOP_S, samplerate);
+  aubio::fixed_pitch<WIN_S, HOP_S> p ("yinfft", samplerate);
+  aubio::pvoc pv (WIN_S, HOP_S);
+  aubio::mfcc m (WIN_S, 40, 13, samplerate);
+  aubio::cvec spectrum (WIN_S);
+  std::array<smpl_t, HOP_S> hop {};
+  std::vector<smpl_t> coeffs (13), resynth (HOP_S);
+  uint_t read, n_onsets = 0, n_beats = 0, total = 0;
+  smpl_t freq = 0.;
+  do {
+    read = s (hop);
+    if (o (hop)) n_onsets++;
+    if (t (hop)) n_beats++;
+    if (read == HOP_S) freq = p (hop);
+    pv (hop, spectrum);
+    m (spectrum, coeffs);
+    pv.inverse (spectrum, resynth);
+    total += read;
+  } while (read == HOP_S);
+  std::printf ("read %d frames, %d onsets, %d beats, last pitch %.2fHz\n",
+      total, n_onsets, n_beats, freq);
+  // the default source is a 441Hz sine
+  if (total != s.duration () || std::fabs (freq - 441.) > 5.) return 1;
+  return 0;
+}
+
+int main (void)
+{
+  int err = 0;
+  err |= check_vectors ();
+  err |= check_errors ();
+  err |= check_analysis (DEFINEDSTRING (AUBIO_TESTS_SOURCE));
+  aubio_cleanup ();
+  return err;
+}
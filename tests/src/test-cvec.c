@@ -56,6 +56,13 @@ int main (void)
     assert( complex_vector->phas[i] == 0. );
   }
 
+  // norm and phas are aligned, phas right after the padding of norm
+  assert((size_t)complex_vector->norm % aubio_get_alignment() == 0);
+  assert((size_t)complex_vector->phas % aubio_get_alignment() == 0);
+  assert(complex_vector->phas > complex_vector->norm);
+  assert((size_t)(complex_vector->phas - complex_vector->norm) * sizeof(smpl_t)
+      < complex_vector->length * sizeof(smpl_t) + aubio_get_alignment());
+
   cvec_copy(complex_vector, other_cvector);
   // copy to self
   cvec_copy(complex_vector, complex_vector);
@@ -67,6 +67,22 @@ int main (void)
   fmat_get_channel(mat, 1, channel);
   assert(channel->data == mat->data[1]);
 
+  // views of some columns, sharing the data of mat
+  fmat_t view;
+  smpl_t *rows[3];
+  assert(height <= 3);
+  assert(fmat_view(&view, rows, mat, 1, length - 2) == 0);
+  assert(view.height == mat->height && view.length == length - 2);
+  assert(view.data[height - 1] == mat->data[height - 1] + 1);
+  assert(fmat_view(&view, rows, mat, 1, length) != 0);
+
+  // rows of a new matrix are evenly spaced
+  uint_t stride = fmat_get_stride(mat);
+  assert(stride >= mat->length);
+  for (i = 1; i < mat->height; i++) {
+    assert(mat->data[i] == mat->data[0] + i * stride);
+  }
+
   // copy of the same size
   fmat_copy(mat, other_mat);
   del_fmat(other_mat);
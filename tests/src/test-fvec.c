@@ -48,9 +48,22 @@ int main (void)
 
   assert(fvec_get_data(vec) == vec->data);
 
+  // views share the data of the vector
+  fvec_t view;
+  assert(fvec_view(&view, vec, 2, length - 2) == 0);
+  assert(view.data == vec->data + 2 && view.length == length - 2);
+  assert(fvec_view(&view, vec, length, 0) == 0);
+  assert(fvec_view(&view, vec, 2, length - 1) != 0);
+
   // wrong parameters
   assert(new_fvec(-1) == NULL);
 
+  // data is aligned, and padded with zeros to a whole number of alignments
+  assert((size_t)vec->data % aubio_get_alignment() == 0);
+  for (i = vec->length; (i * sizeof(smpl_t)) % aubio_get_alignment(); i++) {
+    assert(vec->data[i] == 0.);
+  }
+
   // copy to an identical size works
   fvec_copy(vec, other_vec);
   del_fvec(other_vec);
@@ -1,6 +1,33 @@
 #include "aubio.h"
+#include "aubio_priv.h"
+#include "mathutils_priv.h"
 #include "utils_tests.h"
 
+// shared windows are computed once per type and length
+static void check_shared (void)
+{
+  uint_t j;
+  fvec_t *ref = new_aubio_window ("hanningz", 16);
+  const fvec_t *a = aubio_window_acquire ("hanningz", 16);
+  const fvec_t *b = aubio_window_acquire ("default", 16);
+  const fvec_t *c = aubio_window_acquire ("hanningz", 32);
+  const fvec_t *d = aubio_window_acquire ("hanning", 16);
+  assert (a && a == b && c && c != a && d && d != a);
+  for (j = 0; j < ref->length; j++) {
+    assert (a->data[j] == ref->data[j]);
+  }
+  aubio_window_release (a);
+  aubio_window_release (c);
+  aubio_window_release (d);
+  // still held by b
+  assert (aubio_window_acquire ("hanningz", 16) == b);
+  aubio_window_release (b);
+  aubio_window_release (b);
+  assert (aubio_window_acquire ("unknown", 16) == NULL);
+  aubio_window_release (NULL);
+  del_fvec (ref);
+}
+
 int main (void)
 {
   uint_t length = 0;
@@ -30,6 +57,7 @@ int main (void)
   assert (new_aubio_window("parzen", -1) == NULL);
   assert (new_aubio_window(NULL, length) == NULL);
   assert (new_aubio_window("\0", length) == NULL);
+  check_shared ();
   return 0;
 }
 
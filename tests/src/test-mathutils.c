@@ -7,6 +7,10 @@ int test_miditofreq (void);
 int test_freqtomidi (void);
 int test_aubio_window (void);
 int test_quadratic_peak_mag_boundary (void);
+int test_autocorr (void);
+int test_vector_conversions (void);
+int test_adapt_thres (void);
+int test_find_peaks (void);
 
 int test_next_power_of_two (void)
 {
@@ -173,6 +177,145 @@ int test_quadratic_peak_mag_boundary (void)
   return 0;
 }
 
+// compare aubio_autocorr, which switches to an fft for long inputs, with
+// the direct sums, on lengths below and above the switch
+int test_autocorr (void)
+{
+  uint_t lengths[] = { 1, 2, 7, 64, 127, 128, 300, 512, 1500, 4096 };
+  uint_t n, i, j;
+  utils_init_random();
+  for (n = 0; n < sizeof(lengths) / sizeof(lengths[0]); n++) {
+    uint_t length = lengths[n];
+    fvec_t *x = new_fvec(length);
+    fvec_t *acf = new_fvec(length);
+    double energy = 0.;
+    for (i = 0; i < length; i++) {
+      x->data[i] = 2. * random() / (smpl_t)RAND_MAX - 1.;
+      energy += x->data[i] * x->data[i];
+    }
+    aubio_autocorr(x, acf);
+    for (i = 0; i < length; i++) {
+      double expected = 0.;
+      for (j = i; j < length; j++) {
+        expected += x->data[j - i] * x->data[j];
+      }
+      // the error of the fft grows with the energy of the input
+      assert(fabs(acf->data[i] * (length - i) - expected)
+          < 1.e-5 * (energy + 1.));
+    }
+    del_fvec(x);
+    del_fvec(acf);
+  }
+  fprintf(stdout, "test_autocorr passed\n");
+  return 0;
+}
+
+// the vector conversions should give the same values as the scalar ones
+int test_vector_conversions (void)
+{
+  uint_t length = 1000, i;
+  fvec_t *x = new_fvec(length);
+  fvec_t *y = new_fvec(length);
+  for (i = 0; i < length; i++) {
+    // covers the out of range values of each conversion
+    x->data[i] = -2000. + 25. * i + .5 * (i % 7);
+  }
+  fvec_copy(x, y);
+  fvec_freqtomidi(y);
+  for (i = 0; i < length; i++) {
+    assert(y->data[i] == aubio_freqtomidi(x->data[i]));
+  }
+  fvec_copy(x, y);
+  fvec_miditofreq(y);
+  for (i = 0; i < length; i++) {
+    assert(y->data[i] == aubio_miditofreq(x->data[i]));
+  }
+  fvec_copy(x, y);
+  fvec_unwrap2pi(y);
+  for (i = 0; i < length; i++) {
+    assert(y->data[i] == aubio_unwrap2pi(x->data[i]));
+  }
+  del_fvec(x);
+  del_fvec(y);
+  fprintf(stdout, "test_vector_conversions passed\n");
+  return 0;
+}
+
+// fvec_adapt_thres, which slides a running median, should give the same
+// values as fvec_moving_thres at each position, with odd and even windows,
+// repeated values, and windows longer than 64
+int test_adapt_thres (void)
+{
+  uint_t windows[][2] = { {1, 0}, {0, 9}, {9, 0}, {4, 3}, {8, 7}, {5, 5},
+    {40, 60} };
+  uint_t length = 300, n, i;
+  utils_init_random();
+  for (n = 0; n < sizeof(windows) / sizeof(windows[0]); n++) {
+    uint_t post = windows[n][0], pre = windows[n][1];
+    fvec_t *x = new_fvec(length);
+    fvec_t *y = new_fvec(length);
+    fvec_t *tmp = new_fvec(post + pre + 1);
+    for (i = 0; i < length; i++) {
+      x->data[i] = (smpl_t)(random() % 17) / 4. - 1.;
+    }
+    fvec_copy(x, y);
+    fvec_adapt_thres(x, tmp, post, pre);
+    for (i = 0; i < length; i++) {
+      y->data[i] -= fvec_moving_thres(y, tmp, post, pre, i);
+      assert(x->data[i] == y->data[i]);
+    }
+    del_fvec(x);
+    del_fvec(y);
+    del_fvec(tmp);
+  }
+  fprintf(stdout, "test_adapt_thres passed\n");
+  return 0;
+}
+
+// fvec_find_peaks should find the same peaks as fvec_peakpick at each
+// position, on lengths that exercise the vector body and the tail, with
+// outputs too short for all the peaks, and with a minimum distance
+int test_find_peaks (void)
+{
+  uint_t length, n_out, min_distance, i, n;
+  utils_init_random();
+  for (length = 0; length < 70; length++) {
+    fvec_t *x = new_fvec(length + 1);
+    fvec_t *expected = new_fvec(length + 1);
+    x->length = length;
+    for (i = 0; i < length; i++) {
+      x->data[i] = (smpl_t)(random() % 9) - 2.;
+    }
+    for (min_distance = 0; min_distance < 5; min_distance++) {
+      uint_t count = 0, last = 0;
+      for (i = 1; i + 1 < length; i++) {
+        if (!fvec_peakpick(x, i)) continue;
+        if (count > 0 && i - last < min_distance) {
+          if (x->data[i] <= x->data[last]) continue;
+          count--;
+        }
+        expected->data[count++] = i;
+        last = i;
+      }
+      for (n_out = 0; n_out <= count + 1; n_out++) {
+        fvec_t *peaks = new_fvec(n_out + 1);
+        peaks->length = n_out;
+        n = fvec_find_peaks(x, 0., min_distance, peaks);
+        assert(n == ((n_out < count) ? n_out : count));
+        for (i = 0; i < n; i++) {
+          assert(peaks->data[i] == fvec_quadratic_peak_pos(x,
+                (uint_t)expected->data[i]));
+        }
+        del_fvec(peaks);
+      }
+    }
+    del_fvec(x);
+    del_fvec(expected);
+  }
+  fprintf(stdout, "test_find_peaks passed\n");
+  return 0;
+}
+
 int main (void)
 {
   test_next_power_of_two();
@@ -180,5 +323,9 @@ int main (void)
   test_freqtomidi();
   test_aubio_window();
   test_quadratic_peak_mag_boundary();
+  test_autocorr();
+  test_vector_conversions();
+  test_adapt_thres();
+  test_find_peaks();
   return 0;
 }
@@ -0,0 +1,137 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// create objects with a counting allocator and in an arena, check their
+// memory is aligned and freed by the allocator it came from
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+
+typedef struct {
+  uint_t allocs;
+  uint_t releases;
+} counts_t;
+
+static void *count_alloc (void *data, uint_t size)
+{
+  ((counts_t *)data)->allocs++;
+  return malloc(size);
+}
+
+static void count_release (void *data, void *ptr)
+{
+  ((counts_t *)data)->releases++;
+  free(ptr);
+}
+
+static uint_t check_aligned (const void *ptr, const char_t *what)
+{
+  if ((size_t)ptr % 64 != 0) {
+    PRINT_ERR("%s is not aligned to 64 bytes\n", what);
+    return 1;
+  }
+  return 0;
+}
+
+// run an onset detector on a few hops of noise
+static uint_t run_onset (aubio_onset_t *onset)
+{
+  fvec_t *in = new_fvec(HOP), *out = new_fvec(1);
+  uint_t j, i;
+  if (!in || !out) return 1;
+  for (i = 0; i < 20; i++) {
+    for (j = 0; j < HOP; j++) {
+      in->data[j] = ((i * HOP + j) * 7919 % 101 - 50) / 100.;
+    }
+    aubio_onset_do(onset, in, out);
+  }
+  del_fvec(in);
+  del_fvec(out);
+  return 0;
+}
+
+static uint_t check_counting (void)
+{
+  counts_t counts = { 0, 0 };
+  aubio_allocator_t counter = { count_alloc, count_release, &counts };
+  const aubio_allocator_t *previous = aubio_set_allocator(&counter);
+  fvec_t *vec = new_fvec(3);
+  cvec_t *spec = new_cvec(WIN);
+  fmat_t *mat = new_fmat(3, 5);
+  lvec_t *lvec = new_lvec(7);
+  uint_t err = 0, i;
+  // back to the C library, the objects are still freed with the counter
+  if (aubio_set_allocator(previous) != &counter) err = 1;
+  if (!vec || !spec || !mat || !lvec) return 1;
+  if (counts.allocs != 4) {
+    PRINT_ERR("expected 4 allocations, got %d\n", counts.allocs);
+    err = 1;
+  }
+  err |= check_aligned(vec->data, "fvec data");
+  err |= check_aligned(spec->norm, "cvec norm");
+  err |= check_aligned(spec->phas, "cvec phas");
+  err |= check_aligned(lvec->data, "lvec data");
+  for (i = 0; i < mat->height; i++) {
+    err |= check_aligned(mat->data[i], "fmat row");
+  }
+  for (i = 0; i < vec->length; i++) {
+    if (vec->data[i] != 0.) err = 1;
+  }
+  del_fvec(vec);
+  del_cvec(spec);
+  del_fmat(mat);
+  del_lvec(lvec);
+  if (counts.releases != counts.allocs) {
+    PRINT_ERR("%d allocations but %d releases\n", counts.allocs,
+        counts.releases);
+    err = 1;
+  }
+  return err;
+}
+
+static uint_t check_arena (void)
+{
+  // too small for the detector, to check more blocks get allocated
+  aubio_arena_t *arena = new_aubio_arena(1 << 12);
+  const aubio_allocator_t *previous;
+  aubio_onset_t *onset;
+  fvec_t *vec;
+  uint_t used, err = 0;
+  if (!arena) return 1;
+  previous = aubio_set_allocator(aubio_arena_get_allocator(arena));
+  onset = new_aubio_onset("default", WIN, HOP, SR);
+  vec = new_fvec(HOP);
+  aubio_set_allocator(previous);
+  if (!onset || !vec) return 1;
+  used = aubio_arena_get_used(arena);
+  PRINT_MSG("arena: %d bytes in %d block(s)\n", used,
+      aubio_arena_get_blocks(arena));
+  if (used == 0 || aubio_arena_get_blocks(arena) < 2) err = 1;
+  err |= check_aligned(vec->data, "fvec data in arena");
+  // objects created after resetting the allocator are not in the arena
+  err |= run_onset(onset);
+  if (aubio_arena_get_used(arena) != used) {
+    PRINT_ERR("memory was taken from the arena after it was unset\n");
+    err = 1;
+  }
+  del_fvec(vec);
+  del_aubio_onset(onset);
+  del_aubio_arena(arena);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  if (new_aubio_arena(0)) err = 1;
+  if (check_counting()) {
+    PRINT_ERR("counting allocator failed\n");
+    err = 1;
+  }
+  if (check_arena()) {
+    PRINT_ERR("arena allocator failed\n");
+    err = 1;
+  }
+  return err;
+}
@@ -0,0 +1,104 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// analyse the same file several times on a few threads, and check each copy
+// gets the same results as the first one. Then give all the files to be
+// analysed to a single share, so that the other threads steal from it.
+
+#define N_FILES 9
+#define N_STEAL 32
+#define STEAL_THREADS 4
+
+typedef struct {
+  uint_t calls[N_STEAL];
+  uint_t rows[N_STEAL];
+  smpl_t first[N_STEAL];
+  uint_t failed_index;
+} results_t;
+
+static void on_results (void *data, uint_t index, const char_t *uri,
+    const fmat_t *results)
+{
+  results_t *r = (results_t *)data;
+  r->calls[index]++;
+  if (!results) {
+    r->failed_index = index;
+    return;
+  }
+  r->rows[index] = results->height;
+  r->first[index] = results->height ? results->data[0][0] : -1.;
+  PRINT_MSG("%d %s: %d rows\n", index, uri, results->height);
+}
+
+// put the file in the share of thread `share` only, the others get files
+// that fail at once
+static uint_t run_stealing (const char_t *uri, uint_t share)
+{
+  uint_t i, failed, err = 0;
+  const char_t *uris[N_STEAL];
+  uint_t size = N_STEAL / STEAL_THREADS;
+  results_t r;
+  aubio_batch_t *o = new_aubio_batch("onset", "default", 1024, 256, 0);
+  if (!o) return 1;
+  aubio_batch_set_threads(o, STEAL_THREADS);
+  for (i = 0; i < N_STEAL; i++) {
+    uris[i] = i / size == share ? uri : "/this/file/does/not/exist";
+  }
+  memset(&r, 0, sizeof(r));
+  failed = aubio_batch_run(o, uris, N_STEAL, on_results, &r);
+  if (failed != N_STEAL - size) err = 1;
+  for (i = 0; i < N_STEAL; i++) {
+    if (r.calls[i] != 1) err = 1;
+    if (i / size != share) continue;
+    if (r.rows[i] != r.rows[share * size]) err = 1;
+  }
+  del_aubio_batch(o);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t i, failed, err = 0;
+  const char_t *uris[N_FILES];
+  results_t r;
+  aubio_batch_t *o;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  for (i = 0; i < N_FILES; i++) {
+    uris[i] = argv[1];
+  }
+  uris[4] = "/this/file/does/not/exist";
+
+  o = new_aubio_batch("onset", "default", 1024, 256, 0);
+  if (!o) return 1;
+  aubio_batch_set_threads(o, 3);
+  if (aubio_batch_get_threads(o) != 3) err = 1;
+  memset(&r, 0, sizeof(r));
+  failed = aubio_batch_run(o, uris, N_FILES, on_results, &r);
+  if (failed != 1 || r.failed_index != 4) err = 1;
+  for (i = 0; i < N_FILES; i++) {
+    if (r.calls[i] != 1) err = 1;
+    if (i == 4) continue;
+    if (r.rows[i] != r.rows[0] || r.first[i] != r.first[0]) err = 1;
+  }
+  del_aubio_batch(o);
+
+  // one row with the tempo
+  o = new_aubio_batch("tempo", "default", 1024, 512, 0);
+  if (!o) return 1;
+  memset(&r, 0, sizeof(r));
+  if (aubio_batch_run(o, uris, 2, on_results, &r) != 0) err = 1;
+  if (r.rows[0] != 1 || r.rows[1] != 1) err = 1;
+  del_aubio_batch(o);
+
+  // more files than threads, in the share of the calling thread or of the
+  // last one
+  if (run_stealing(argv[1], 0)) err = 1;
+  if (run_stealing(argv[1], STEAL_THREADS - 1)) err = 1;
+
+  if (new_aubio_batch("unknown", "default", 1024, 256, 0)) err = 1;
+  if (new_aubio_batch("onset", "default", 256, 1024, 0)) err = 1;
+  return err;
+}
@@ -0,0 +1,123 @@
+#if !defined(_WIN32) && !defined(_XOPEN_SOURCE)
+/* mkdtemp() */
+#define _XOPEN_SOURCE 700
+#endif
+
+#include <aubio.h>
+#include <dirent.h>
+#include "utils_tests.h"
+
+// analyse a file with a cache directory, and check the results read back
+// from the cache are those of the analysis, and that broken cache files are
+// replaced
+
+#define MAX_ROWS 1024
+
+typedef struct {
+  uint_t rows;
+  smpl_t data[MAX_ROWS];
+  uint_t failed;
+} results_t;
+
+static void on_results (void *data, uint_t index, const char_t *uri,
+    const fmat_t *results)
+{
+  results_t *r = (results_t *)data;
+  uint_t i;
+  (void)index; (void)uri;
+  if (!results) {
+    r->failed = 1;
+    return;
+  }
+  r->rows = results->height;
+  for (i = 0; i < results->height && i < MAX_ROWS; i++) {
+    r->data[i] = results->data[i][0];
+  }
+}
+
+// number of files in dir, and path of the last one
+static uint_t list_cache (const char_t *dir, char_t *path)
+{
+  DIR *d = opendir (dir);
+  struct dirent *e;
+  uint_t n = 0;
+  if (!d) return 0;
+  while ((e = readdir (d)) != NULL) {
+    if (e->d_name[0] == '.') continue;
+    snprintf (path, PATH_MAX, "%s/%s", dir, e->d_name);
+    n++;
+  }
+  closedir (d);
+  return n;
+}
+
+static uint_t run (aubio_batch_t *o, const char_t *uri, results_t *r)
+{
+  memset (r, 0, sizeof(*r));
+  if (aubio_batch_run (o, &uri, 1, on_results, r) != 0 || r->failed) {
+    return 1;
+  }
+  return 0;
+}
+
+static uint_t same_results (const results_t *a, const results_t *b)
+{
+  uint_t i;
+  if (a->rows != b->rows) return 0;
+  for (i = 0; i < a->rows && i < MAX_ROWS; i++) {
+    if (a->data[i] != b->data[i]) return 0;
+  }
+  return 1;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t err = 0;
+  char_t dir[PATH_MAX] = "tmp_aubio_cache_XXXXXX", path[PATH_MAX];
+  results_t expected, r;
+  aubio_batch_t *o;
+  FILE *f;
+  if (argc < 2) {
+    PRINT_ERR("not enough arguments, running tests\n");
+    return run_on_default_source(main);
+  }
+  if (!mkdtemp (dir)) return 1;
+
+  o = new_aubio_batch("onset", "default", 1024, 256, 0);
+  if (!o) return 1;
+  if (!aubio_batch_set_cache (o, "/this/directory/does/not/exist")) err = 1;
+  if (run (o, argv[1], &expected)) err = 1;
+  if (aubio_batch_set_cache (o, dir)) err = 1;
+
+  // the first run fills the cache, the second one reads it
+  if (run (o, argv[1], &r) || !same_results (&r, &expected)) err = 1;
+  if (list_cache (dir, path) != 1) err = 1;
+  if (run (o, argv[1], &r) || !same_results (&r, &expected)) err = 1;
+  PRINT_MSG("%d onsets, cached in %s\n", r.rows, path);
+
+  // a broken file is analysed again, and replaced
+  f = fopen (path, "wb");
+  if (!f) return 1;
+  fputs ("not a cache file", f);
+  fclose (f);
+  if (run (o, argv[1], &r) || !same_results (&r, &expected)) err = 1;
+  if (list_cache (dir, path) != 1) err = 1;
+  if (run (o, argv[1], &r) || !same_results (&r, &expected)) err = 1;
+
+  // other parameters get their own file
+  aubio_batch_set_threshold (o, 0.1);
+  if (run (o, argv[1], &r)) err = 1;
+  if (list_cache (dir, path) != 2) err = 1;
+
+  // without cache
+  if (aubio_batch_set_cache (o, NULL)) err = 1;
+  if (run (o, argv[1], &r)) err = 1;
+  if (list_cache (dir, path) != 2) err = 1;
+  del_aubio_batch(o);
+
+  while (list_cache (dir, path) > 0) {
+    if (remove (path)) break;
+  }
+  rmdir (dir);
+  return err;
+}
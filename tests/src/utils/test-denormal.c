@@ -0,0 +1,111 @@
+#include <aubio.h>
+#include "utils_tests.h"
+#include <float.h>
+
+// the filters give the same output in both denormal modes, the flags of the
+// calling thread are restored after each call, and in the flush mode the
+// state of a filter reaches zero during silence
+
+#define HOP 512
+
+// a product whose result is a denormal, computed at run time
+static volatile float tiny_a = 1.e-30f, tiny_b = 1.e-10f;
+
+static uint_t flushing (void)
+{
+  return tiny_a * tiny_b == 0.f;
+}
+
+static void fill (fvec_t *in, uint_t hop)
+{
+  uint_t j;
+  for (j = 0; j < in->length; j++) {
+    in->data[j] = sin(.01 * (hop * in->length + j)) * .5
+      + ((hop * in->length + j) * 7919 % 101 - 50) / 500.;
+  }
+}
+
+// run the same blocks through two copies of a filter, one in each mode
+static void compare_modes (aubio_filter_t *soft, aubio_filter_t *flush)
+{
+  fvec_t *a = new_fvec (HOP), *b = new_fvec (HOP);
+  uint_t hop, j;
+  for (hop = 0; hop < 50; hop++) {
+    fill (a, hop);
+    fvec_copy (a, b);
+    assert(aubio_set_denormal_mode (AUBIO_DENORMAL_SOFTWARE) == 0);
+    aubio_filter_do (soft, a);
+    assert(aubio_set_denormal_mode (AUBIO_DENORMAL_FLUSH) == 0);
+    aubio_filter_do (flush, b);
+    assert(!flushing ());
+    for (j = 0; j < HOP; j++) {
+      assert(a->data[j] == b->data[j]);
+    }
+  }
+  del_fvec (a);
+  del_fvec (b);
+}
+
+int main (void)
+{
+  aubio_filter_t *soft, *flush;
+  fvec_t *in = new_fvec (HOP);
+  uint_t hop, j;
+  double smallest = sizeof(smpl_t) == sizeof(float) ? FLT_MIN : DBL_MIN;
+
+  assert(aubio_get_denormal_mode () == AUBIO_DENORMAL_SOFTWARE);
+  assert(aubio_set_denormal_mode (2) != 0);
+  assert(!flushing ());
+
+  if (aubio_set_denormal_mode (AUBIO_DENORMAL_FLUSH) != 0) {
+    PRINT_MSG("no flush-to-zero flags, only checking the default mode\n");
+    assert(aubio_get_denormal_mode () == AUBIO_DENORMAL_SOFTWARE);
+    assert(aubio_denormal_flush_thread (1) != 0);
+    del_fvec (in);
+    return 0;
+  }
+  assert(aubio_get_denormal_mode () == AUBIO_DENORMAL_FLUSH);
+
+  // the flags of the thread are only set while the filter runs
+  soft = new_aubio_filter_a_weighting (44100);
+  flush = new_aubio_filter_a_weighting (44100);
+  compare_modes (soft, flush);
+  del_aubio_filter (soft);
+  del_aubio_filter (flush);
+  soft = new_aubio_filter_biquad (.0675, .135, .0675, -1.143, .413);
+  flush = new_aubio_filter_biquad (.0675, .135, .0675, -1.143, .413);
+  compare_modes (soft, flush);
+
+  // an impulse, then silence: the output decays below the smallest normal
+  // number, and is flushed to zero instead of going through denormals. The
+  // flags only apply to SSE and NEON, lsmp_t must be a double.
+  if (sizeof(lsmp_t) == sizeof(double)) {
+    fvec_zeros (in);
+    in->data[0] = 1.;
+    for (hop = 0; hop < 10; hop++) {
+      aubio_filter_do (flush, in);
+      for (j = 0; j < HOP; j++) {
+        assert(in->data[j] == 0. || fabs(in->data[j]) >= smallest);
+      }
+      fvec_zeros (in);
+    }
+  }
+  del_aubio_filter (soft);
+  del_aubio_filter (flush);
+
+  // flags set for the whole thread stay set after a call
+  assert(aubio_denormal_flush_thread (1) == 0);
+  assert(flushing ());
+  flush = new_aubio_filter_a_weighting (44100);
+  fill (in, 0);
+  aubio_filter_do (flush, in);
+  assert(flushing ());
+  assert(aubio_denormal_flush_thread (0) == 0);
+  assert(!flushing ());
+
+  assert(aubio_set_denormal_mode (AUBIO_DENORMAL_SOFTWARE) == 0);
+  del_aubio_filter (flush);
+  del_fvec (in);
+  aubio_cleanup ();
+  return 0;
+}
@@ -0,0 +1,177 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// onsets and beats pushed to an event queue by blocks of hops are the ones
+// found by polling the detectors after each hop
+
+#define HOP_S 256
+#define WIN_S 1024
+#define RATE 44100
+#define N_HOPS 800
+#define BLOCK_HOPS 16
+
+static uint_t check_queue (void)
+{
+  aubio_events_t *q = new_aubio_events (4);
+  aubio_event_t e, out[8];
+  uint_t i, n, err = 0;
+  if (!q) return 1;
+  if (new_aubio_events (0)) err = 1;
+  memset (&e, 0, sizeof (e));
+  for (i = 0; i < 6; i++) {
+    e.position = 10000000000ULL + i;
+    if (aubio_events_push (q, &e) != (i < 4 ? 0 : 1)) err = 1;
+  }
+  if (aubio_events_get_count (q) != 4 || aubio_events_get_dropped (q) != 2)
+    err = 1;
+  n = aubio_events_drain (q, out, 3);
+  if (n != 3 || out[0].position != 10000000000ULL || out[2].position
+      != 10000000002ULL) err = 1;
+  // wrap around the end of the ring
+  for (i = 0; i < 3; i++) {
+    e.position = 20 + i;
+    if (aubio_events_push (q, &e) != 0) err = 1;
+  }
+  n = aubio_events_drain (q, out, 8);
+  if (n != 4 || out[0].position != 10000000003ULL || out[3].position != 22)
+    err = 1;
+  if (aubio_events_drain (q, out, 8) != 0) err = 1;
+  del_aubio_events (q);
+  return err;
+}
+
+static void fill_signal (fvec_t *signal)
+{
+  uint_t i;
+  for (i = 0; i < signal->length; i++) {
+    // clicks every 21 hops, over a little noise
+    uint_t k = i % (21 * HOP_S);
+    smpl_t noise = (2. * random() / (smpl_t)RAND_MAX - 1.);
+    signal->data[i] = (k < 400 ? .8 : .02) * noise;
+  }
+}
+
+static uint_t check_onsets (const fvec_t *signal)
+{
+  aubio_onset_t *polled = new_aubio_onset ("default", WIN_S, HOP_S, RATE);
+  aubio_onset_t *o = new_aubio_onset ("default", WIN_S, HOP_S, RATE);
+  aubio_events_t *q = new_aubio_events (64);
+  fvec_t hop, block, *out = new_fvec (1);
+  aubio_event_t events[64];
+  uint_t expected[N_HOPS], n_expected = 0, n_events = 0, b, i, n, err = 0;
+  if (!polled || !o || !q || !out) return 1;
+  hop.length = HOP_S;
+  for (i = 0; i < N_HOPS; i++) {
+    hop.data = signal->data + i * HOP_S;
+    aubio_onset_do (polled, &hop, out);
+    if (out->data[0] != 0.) expected[n_expected++] = aubio_onset_get_last (polled);
+  }
+
+  if (aubio_onset_set_events (o, q) != 0 || aubio_onset_get_events (o) != q)
+    err = 1;
+  block.length = BLOCK_HOPS * HOP_S;
+  for (b = 0; b < N_HOPS / BLOCK_HOPS; b++) {
+    block.data = signal->data + b * block.length;
+    aubio_onset_do_block (o, &block);
+    n = aubio_events_drain (q, events, 64);
+    for (i = 0; i < n; i++, n_events++) {
+      if (events[i].type != aubio_event_onset || events[i].channel != 0
+          || n_events >= n_expected
+          || events[i].position != expected[n_events]
+          || events[i].strength <= 0.) err = 1;
+    }
+  }
+  PRINT_MSG ("%d onsets polled, %d events\n", n_expected, n_events);
+  if (n_events != n_expected || n_events == 0) err = 1;
+  // a block which is not a multiple of the hop size is refused
+  block.length = HOP_S + 1;
+  aubio_onset_do_block (o, &block);
+  if (aubio_events_get_count (q) != 0) err = 1;
+  del_aubio_onset (polled);
+  del_aubio_onset (o);
+  del_aubio_events (q);
+  del_fvec (out);
+  return err;
+}
+
+static uint_t check_beats (const fvec_t *signal)
+{
+  aubio_tempo_t *polled = new_aubio_tempo ("default", WIN_S, HOP_S, RATE);
+  aubio_tempo_t *t = new_aubio_tempo ("default", WIN_S, HOP_S, RATE);
+  aubio_events_t *q = new_aubio_events (N_HOPS);
+  fvec_t hop, block, *out = new_fvec (2);
+  aubio_event_t events[N_HOPS];
+  uint_t expected[N_HOPS], n_expected = 0, n, i, j, err = 0;
+  if (!polled || !t || !q || !out) return 1;
+  hop.length = HOP_S;
+  for (i = 0; i < N_HOPS; i++) {
+    hop.data = signal->data + i * HOP_S;
+    aubio_tempo_do (polled, &hop, out);
+    if (out->data[0] != 0.) expected[n_expected++] = aubio_tempo_get_last (polled);
+  }
+  aubio_tempo_set_events (t, q);
+  block.length = signal->length;
+  block.data = signal->data;
+  aubio_tempo_do_block (t, &block);
+  n = aubio_events_drain (q, events, N_HOPS);
+  // a beat falling exactly on a hop boundary is pushed, but reads as 0
+  for (i = 0, j = 0; i < n && j < n_expected; i++) {
+    if (events[i].type != aubio_event_beat) err = 1;
+    if (events[i].position == expected[j]) j++;
+  }
+  PRINT_MSG ("%d beats polled, %d events\n", n_expected, n);
+  if (j != n_expected || n_expected == 0 || n > n_expected + 2) err = 1;
+  del_aubio_tempo (polled);
+  del_aubio_tempo (t);
+  del_aubio_events (q);
+  del_fvec (out);
+  return err;
+}
+
+static uint_t check_channels (const fvec_t *signal)
+{
+  aubio_onset_t *o = new_aubio_onset ("default", WIN_S, HOP_S, RATE);
+  aubio_events_t *q = new_aubio_events (256);
+  fmat_t *in = new_fmat (2, HOP_S);
+  fvec_t *out = new_fvec (2);
+  aubio_event_t events[256];
+  uint_t i, h, n, count[2] = { 0, 0 }, err = 0;
+  if (!o || !q || !in || !out) return 1;
+  aubio_onset_set_events (o, q);
+  for (h = 0; h < N_HOPS; h++) {
+    for (i = 0; i < HOP_S; i++) {
+      in->data[0][i] = signal->data[h * HOP_S + i];
+      // the second channel is silent
+      in->data[1][i] = 0.;
+    }
+    aubio_onset_do_multi (o, in, out);
+  }
+  n = aubio_events_drain (q, events, 256);
+  for (i = 0; i < n; i++) {
+    if (events[i].channel > 1) err = 1;
+    else count[events[i].channel]++;
+  }
+  if (count[0] == 0 || count[1] != 0) err = 1;
+  del_aubio_onset (o);
+  del_aubio_events (q);
+  del_fmat (in);
+  del_fvec (out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  fvec_t *signal = new_fvec (N_HOPS * HOP_S);
+  if (!signal) return 1;
+  utils_init_random ();
+  fill_signal (signal);
+  if (check_queue ()) err = 1;
+  if (check_onsets (signal)) err = 1;
+  if (check_beats (signal)) err = 1;
+  if (check_channels (signal)) err = 1;
+  if (err) PRINT_ERR ("events differ from the polled detections\n");
+  del_fvec (signal);
+  aubio_cleanup ();
+  return err;
+}
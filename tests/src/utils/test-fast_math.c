@@ -0,0 +1,232 @@
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+#include "utils_tests.h"
+
+// compare the exp, atan2, sin and cos approximations of each instruction set
+// to the C library, then the onsets and mfccs computed with and without them
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define N_BLOCKS 400
+
+#if !HAVE_AUBIO_DOUBLE
+#define MAX_ERR 1.e-6
+#else
+#define MAX_ERR 1.e-12
+#endif
+
+// an empty value selects the default table
+static void set_isa (const char_t *isa)
+{
+#ifdef _WIN32
+  _putenv_s("AUBIO_SIMD", isa);
+#else
+  setenv("AUBIO_SIMD", isa, 1);
+#endif
+}
+
+static uint_t check_kernels (const char_t *isa)
+{
+  const aubio_simd_ops_t *ops;
+  fvec_t *x = new_fvec(1001), *y = new_fvec(1001), *out = new_fvec(1001);
+  fvec_t *im = new_fvec(1001);
+  smpl_t exp_err = 0., atan_err = 0., sincos_err = 0.;
+  uint_t j, k, err = 0;
+  if (!x || !y || !out || !im) return 1;
+  set_isa(isa);
+  ops = aubio_simd_init();
+  if (strcmp(ops->name, isa) != 0) goto beach;
+  // odd length, to go through the tail of each instruction set
+  for (j = 0; j < x->length; j++) {
+    x->data[j] = -85. + 170. * j / (x->length - 1.);
+    out->data[j] = x->data[j];
+  }
+  ops->vexp(out->data, out->length);
+  for (j = 0; j < x->length; j++) {
+    exp_err = MAX(exp_err, fabs(out->data[j] / EXP(x->data[j]) - 1.));
+  }
+  // all quadrants, the axes and the origin
+  for (k = 0; k < 5; k++) {
+    for (j = 0; j < x->length; j++) {
+      smpl_t angle = 2. * PI * j / (x->length - 1.) - PI;
+      smpl_t radius = (k == 4) ? (j % 4) * .5 : POW(10., 4. * k - 8.);
+      x->data[j] = radius * COS(angle);
+      y->data[j] = radius * SIN(angle);
+      if (j % 50 == 0) x->data[j] = 0.;
+      if (j % 70 == 0) y->data[j] = 0.;
+    }
+    ops->vatan2(y->data, x->data, out->data, out->length);
+    for (j = 0; j < x->length; j++) {
+      // signed zeros are taken as +0, and atan2(0, -x) may be pi or -pi
+      smpl_t ref = ATAN2(y->data[j] + 0., x->data[j] + 0.);
+      smpl_t diff = fabs(out->data[j] - ref);
+      atan_err = MAX(atan_err, MIN(diff, fabs(diff - 2. * PI)));
+    }
+  }
+  // several turns either way, through each quadrant and its edges
+  for (j = 0; j < x->length; j++) {
+    y->data[j] = 1. + j % 3;
+    x->data[j] = 10. * PI * j / (x->length - 1.) - 5. * PI;
+  }
+  ops->rect(y->data, x->data, out->data, im->data, out->length);
+  for (j = 0; j < x->length; j++) {
+    smpl_t norm = y->data[j];
+    sincos_err = MAX(sincos_err, fabs(out->data[j] / norm - COS(x->data[j])));
+    sincos_err = MAX(sincos_err, fabs(im->data[j] / norm - SIN(x->data[j])));
+  }
+  PRINT_MSG("%s: exp relative error %g, atan2 error %g, sin/cos error %g\n",
+      isa, exp_err, atan_err, sincos_err);
+  if (exp_err > MAX_ERR || atan_err > MAX_ERR || sincos_err > MAX_ERR)
+    err = 1;
+beach:
+  del_fvec(x);
+  del_fvec(y);
+  del_fvec(out);
+  del_fvec(im);
+  return err;
+}
+
+static uint_t check_vecutils (void)
+{
+  fvec_t *a = new_fvec(37), *b = new_fvec(37);
+  smpl_t max_err = 0.;
+  uint_t j, err = 0;
+  if (!a || !b) return 1;
+  for (j = 0; j < a->length; j++) {
+    a->data[j] = b->data[j] = .01 + j * .37;
+  }
+  aubio_set_fast_math(1);
+  fvec_pow(a, 1.7);
+  aubio_set_fast_math(0);
+  fvec_pow(b, 1.7);
+  for (j = 0; j < a->length; j++) {
+    max_err = MAX(max_err, fabs(a->data[j] / b->data[j] - 1.));
+  }
+  // negative elements are left to the C library
+  a->data[3] = b->data[3] = -2.;
+  aubio_set_fast_math(1);
+  fvec_pow(a, 3.);
+  fvec_exp(a);
+  aubio_set_fast_math(0);
+  fvec_pow(b, 3.);
+  fvec_exp(b);
+  for (j = 0; j < a->length; j++) {
+    if (b->data[j] > 1.e30) continue;
+    max_err = MAX(max_err, fabs(a->data[j] / b->data[j] - 1.));
+  }
+  PRINT_MSG("fvec_pow and fvec_exp: relative error %g\n", max_err);
+  if (max_err > 100. * MAX_ERR) err = 1;
+  del_fvec(a);
+  del_fvec(b);
+  return err;
+}
+
+// onset times of decaying noise bursts, every 11025 samples
+static uint_t detect (const char_t *method, uint_t fast, smpl_t *times,
+    uint_t max)
+{
+  aubio_onset_t *o = new_aubio_onset(method, WIN, HOP, SR);
+  fvec_t *in = new_fvec(HOP), *out = new_fvec(1);
+  uint_t n, j, count = 0;
+  if (!o || !in || !out) return 0;
+  aubio_set_fast_math(fast);
+  srandom(1);
+  for (n = 0; n < N_BLOCKS; n++) {
+    for (j = 0; j < HOP; j++) {
+      smpl_t pos = (n * HOP + j) % 11025;
+      in->data[j] = (EXP(-pos / 1500.) + .05) * (random() % 2001 - 1000)
+        / 1000.;
+    }
+    aubio_onset_do(o, in, out);
+    if (out->data[0] != 0. && count < max) {
+      times[count++] = aubio_onset_get_last(o);
+    }
+  }
+  aubio_set_fast_math(0);
+  del_aubio_onset(o);
+  del_fvec(in);
+  del_fvec(out);
+  return count;
+}
+
+static uint_t check_onset (void)
+{
+  const char_t *methods[] = { "default", "complex", "mkl" };
+  smpl_t exact[64], fast[64];
+  uint_t i, j, count, err = 0;
+  for (i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+    smpl_t max_diff = 0.;
+    count = detect(methods[i], 0, exact, 64);
+    if (detect(methods[i], 1, fast, 64) != count) {
+      PRINT_ERR("%s: not the same number of onsets\n", methods[i]);
+      err = 1;
+      continue;
+    }
+    for (j = 0; j < count; j++) {
+      max_diff = MAX(max_diff, fabs(fast[j] - exact[j]));
+    }
+    PRINT_MSG("%s: %d onsets, largest difference %.0f samples\n", methods[i],
+        count, max_diff);
+    if (count < 5 || max_diff > HOP) err = 1;
+  }
+  return err;
+}
+
+static uint_t check_mfcc (void)
+{
+  aubio_pvoc_t *pv = new_aubio_pvoc(WIN, HOP);
+  aubio_mfcc_t *mfcc = new_aubio_mfcc(WIN, 40, 13, SR);
+  fvec_t *in = new_fvec(HOP), *exact = new_fvec(13), *fast = new_fvec(13);
+  cvec_t *grain = new_cvec(WIN);
+  smpl_t max_diff = 0.;
+  uint_t n, j;
+  if (!pv || !mfcc || !in || !exact || !fast || !grain) return 1;
+  srandom(1);
+  for (n = 0; n < 20; n++) {
+    for (j = 0; j < HOP; j++) {
+      in->data[j] = SIN(.05 * (n * HOP + j)) * (random() % 2001 - 1000)
+        / 1000.;
+    }
+    aubio_pvoc_do(pv, in, grain);
+    aubio_mfcc_do(mfcc, grain, exact);
+    aubio_set_fast_math(1);
+    aubio_mfcc_do(mfcc, grain, fast);
+    aubio_set_fast_math(0);
+    for (j = 0; j < exact->length; j++) {
+      max_diff = MAX(max_diff, fabs(fast->data[j] - exact->data[j]));
+    }
+  }
+  PRINT_MSG("mfcc: largest difference %g\n", max_diff);
+  del_aubio_pvoc(pv);
+  del_aubio_mfcc(mfcc);
+  del_fvec(in);
+  del_fvec(exact);
+  del_fvec(fast);
+  del_cvec(grain);
+  return max_diff > 1.e3 * MAX_ERR;
+}
+
+int main (void)
+{
+  const char_t *isas[] = { "scalar", "sse2", "avx2", "avx512", "neon" };
+  uint_t i, err = 0;
+  if (aubio_get_fast_math() != 0) err = 1;
+  if (!aubio_set_fast_math(2)) err = 1;
+  if (aubio_set_fast_math(1) || aubio_get_fast_math() != 1) err = 1;
+  aubio_set_fast_math(0);
+  if (err) PRINT_ERR("wrong fast math setting\n");
+  for (i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+    if (check_kernels(isas[i])) {
+      PRINT_ERR("%s: approximations are not accurate enough\n", isas[i]);
+      err = 1;
+    }
+  }
+  set_isa("");
+  aubio_simd_init();
+  if (check_vecutils()) err = 1;
+  if (check_onset()) err = 1;
+  if (check_mfcc()) err = 1;
+  return err;
+}
@@ -0,0 +1,76 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// pool the frames of one second of hops down to 60 frames per second, check
+// the number of frames output and their values, with both methods.
+
+#define SIZE 40
+#define HOP 256
+#define SAMPLERATE 44100
+#define RATE 60.
+
+static uint_t check_method (const char_t *method)
+{
+  aubio_framerate_t *o = new_aubio_framerate(method, SIZE, HOP, SAMPLERATE,
+      RATE);
+  fvec_t *in = new_fvec(SIZE), *out = new_fvec(SIZE);
+  uint_t i, j, n_hops = SAMPLERATE / HOP, n_frames = 0, first = 0, err = 0;
+  smpl_t expected;
+
+  if (!o || !in || !out) return 1;
+  for (i = 0; i < n_hops; i++) {
+    // band j of hop i holds i + j
+    for (j = 0; j < SIZE; j++) in->data[j] = i + j;
+    if (!aubio_framerate_do(o, in, out)) {
+      if (aubio_framerate_get_ready(o)) err = 1;
+      continue;
+    }
+    if (!aubio_framerate_get_ready(o)) err = 1;
+    // mean or max of the hops first .. i
+    expected = strcmp(method, "max") == 0 ? i : (first + i) / 2.;
+    for (j = 0; j < SIZE; j++) {
+      if (out->data[j] != expected + j) {
+        PRINT_MSG("%s: got %f at band %d of frame %d, expected %f\n",
+            method, out->data[j], j, n_frames, expected + j);
+        err = 1;
+        break;
+      }
+    }
+    first = i + 1;
+    n_frames++;
+  }
+  PRINT_MSG("%s: %d hops pooled to %d frames\n", method, n_hops, n_frames);
+  // 172 hops of 256 samples last 0.998 second
+  if (n_frames != 59) err = 1;
+
+  aubio_framerate_reset(o);
+  if (aubio_framerate_set_rate(o, SAMPLERATE / (smpl_t)HOP) != 0
+      || aubio_framerate_set_rate(o, SAMPLERATE / (smpl_t)HOP + 1.) == 0
+      || aubio_framerate_get_rate(o) != SAMPLERATE / (smpl_t)HOP) {
+    err = 1;
+  }
+  // at the hop rate, each frame is output as is
+  for (i = 0; i < 10; i++) {
+    in->data[0] = i;
+    if (!aubio_framerate_do(o, in, out) || out->data[0] != i) err = 1;
+  }
+
+  del_aubio_framerate(o);
+  del_fvec(in);
+  del_fvec(out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  err |= check_method("default");
+  err |= check_method("max");
+  if (new_aubio_framerate("median", SIZE, HOP, SAMPLERATE, RATE) != NULL
+      || new_aubio_framerate("mean", SIZE, HOP, SAMPLERATE, 0.) != NULL
+      || new_aubio_framerate("mean", SIZE, HOP, SAMPLERATE, 200.) != NULL) {
+    err = 1;
+  }
+  aubio_cleanup();
+  return err;
+}
@@ -0,0 +1,120 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// request several outputs from an analysis graph, check the stages of the
+// same buffer size are shared, and compare the outputs to the ones of the
+// objects wired by hand, on one thread and on a few
+
+#define SR 44100
+#define HOP 256
+#define N_BLOCKS 200
+
+static void fill (fvec_t *in, uint_t n)
+{
+  uint_t j;
+  for (j = 0; j < HOP; j++) {
+    smpl_t t = (smpl_t)(n * HOP + j) / SR;
+    // notes starting every 50 blocks, over some noise
+    in->data[j] = .5 * sin (2. * M_PI * 220. * (1 + n / 50) * t)
+      * exp (-5. * ((n % 50) * HOP + j) / SR)
+      + (random () % 2001 - 1000) / 100000.;
+  }
+}
+
+static uint_t check_graph (uint_t threads)
+{
+  aubio_graph_t *g = new_aubio_graph (HOP, SR);
+  aubio_pvoc_t *pv = new_aubio_pvoc (1024, HOP);
+  aubio_onset_t *onset = new_aubio_onset ("specflux", 1024, HOP, SR);
+  aubio_pitch_t *yin = new_aubio_pitch ("yin", 2048, HOP, SR);
+  aubio_mfcc_t *mfcc = new_aubio_mfcc (1024, 40, 13, SR);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (1), *coeffs = new_fvec (13);
+  cvec_t *grain = new_cvec (1024);
+  fvec_t view;
+  sint_t o_level, o_onset, o_tempo, o_yinfft, o_yin, o_mfcc, o_mel;
+  uint_t n, j, err = 0;
+  if (!g || !pv || !onset || !yin || !mfcc || !in || !out || !coeffs
+      || !grain) return 1;
+  aubio_pitch_set_unit (yin, "Hz");
+
+  o_level = aubio_graph_add (g, "level", "default", 0);
+  o_onset = aubio_graph_add (g, "onset", "specflux", 1024);
+  o_tempo = aubio_graph_add (g, "tempo", "default", 1024);
+  o_yinfft = aubio_graph_add (g, "pitch", "yinfft", 2048);
+  o_yin = aubio_graph_add (g, "pitch", "yin", 2048);
+  o_mfcc = aubio_graph_add (g, "mfcc", "default", 1024);
+  o_mel = aubio_graph_add (g, "melbands", "default", 2048);
+  if (o_level < 0 || o_onset < 0 || o_tempo < 0 || o_yinfft < 0 || o_yin < 0
+      || o_mfcc < 0 || o_mel < 0) return 1;
+  if (aubio_graph_get_n_outputs (g) != 7) err = 1;
+  // one phase vocoder of 1024 and one of 2048 points
+  if (aubio_graph_get_n_spectra (g) != 2) err = 1;
+  if (!aubio_graph_get_onset (g, o_onset) || aubio_graph_get_onset (g, o_yin)
+      || !aubio_graph_get_tempo (g, o_tempo)
+      || !aubio_graph_get_pitch (g, o_yin)) err = 1;
+  if (aubio_graph_set_threads (g, threads)
+      || aubio_graph_get_threads (g) != threads) err = 1;
+
+  for (n = 0; n < N_BLOCKS; n++) {
+    fill (in, n);
+    aubio_graph_do (g, in);
+    // the same analysis, wired by hand
+    aubio_pvoc_do (pv, in, grain);
+    aubio_onset_do_spectrum (onset, in, grain, out);
+    if (aubio_graph_get_output (g, o_onset, &view) || view.length != 2
+        || view.data[0] != out->data[0]
+        || view.data[1] != aubio_onset_get_descriptor (onset)) err = 1;
+    aubio_mfcc_do (mfcc, grain, coeffs);
+    aubio_graph_get_output (g, o_mfcc, &view);
+    for (j = 0; j < coeffs->length; j++) {
+      if (view.data[j] != coeffs->data[j]) err = 1;
+    }
+    aubio_pitch_do (yin, in, out);
+    aubio_graph_get_output (g, o_yin, &view);
+    if (view.data[0] != out->data[0]) err = 1;
+    aubio_graph_get_output (g, o_level, &view);
+    if (fabs (view.data[0] - aubio_db_spl (in)) > 1.e-3) err = 1;
+  }
+  aubio_graph_get_output (g, o_tempo, &view);
+  PRINT_MSG ("%d threads: %.2f bpm\n", threads, view.data[1]);
+  aubio_graph_get_output (g, o_yinfft, &view);
+  PRINT_MSG ("%d threads: yinfft at %.2fHz\n", threads, view.data[0]);
+  if (fabs (view.data[0] - 880.) > 10.) err = 1;
+  aubio_graph_get_output (g, o_mel, &view);
+  if (view.length != 40) err = 1;
+
+  // too late to add outputs, out of range
+  if (aubio_graph_add (g, "onset", "hfc", 512) != -1) err = 1;
+  if (aubio_graph_get_output (g, 7, &view) == 0) err = 1;
+
+  del_aubio_graph (g);
+  del_aubio_pvoc (pv);
+  del_aubio_onset (onset);
+  del_aubio_pitch (yin);
+  del_aubio_mfcc (mfcc);
+  del_fvec (in);
+  del_fvec (out);
+  del_fvec (coeffs);
+  del_cvec (grain);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  aubio_graph_t *g = new_aubio_graph (HOP, SR);
+  if (!g) return 1;
+  if (aubio_graph_add (g, "spectrogram", "default", 1024) != -1) err = 1;
+  if (aubio_graph_add (g, "onset", "unknown", 1024) != -1) err = 1;
+  if (aubio_graph_add (g, "mfcc", "htk", 1024) != -1) err = 1;
+  if (aubio_graph_get_n_outputs (g) != 0) err = 1;
+  del_aubio_graph (g);
+  if (new_aubio_graph (0, SR)) err = 1;
+
+  err |= check_graph (1);
+  err |= check_graph (3);
+
+  if (err) PRINT_ERR ("graph outputs differ from the objects wired by hand\n");
+  aubio_cleanup ();
+  return err;
+}
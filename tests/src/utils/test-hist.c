@@ -1,10 +1,142 @@
 #define AUBIO_UNSTABLE 1
 
 #include <aubio.h>
+#include "utils_tests.h"
+
+#define N 10000
+
+// fill a vector with a shuffled ramp from 0 to 1
+static void fill_ramp (fvec_t *v, uint_t offset, uint_t total)
+{
+  uint_t j;
+  for (j = 0; j < v->length; j++) {
+    v->data[j] = ((offset + j) * 7919 % total) / (smpl_t)(total - 1);
+  }
+}
+
+static uint_t check_quantiles (const char_t *what, smpl_t *found,
+    smpl_t tolerance)
+{
+  const smpl_t qs[] = { 0.01, .1, .5, .9, .99 };
+  uint_t i, err = 0;
+  for (i = 0; i < sizeof(qs) / sizeof(qs[0]); i++) {
+    if (fabs(found[i] - qs[i]) > tolerance) {
+      PRINT_ERR("%s: quantile %.2f is %f\n", what, qs[i], found[i]);
+      err = 1;
+    }
+  }
+  return err;
+}
+
+static uint_t check_accumulate (void)
+{
+  const smpl_t qs[] = { 0.01, .1, .5, .9, .99 };
+  aubio_hist_t *a = new_aubio_hist(0, 1, 100);
+  aubio_hist_t *b = new_aubio_hist(0, 1, 100);
+  aubio_hist_t *c = new_aubio_hist(0, 2, 100);
+  fvec_t *v = new_fvec(N / 10);
+  smpl_t found[5];
+  uint_t i, err = 0;
+  if (!a || !b || !c || !v) return 1;
+  if (aubio_hist_quantile(a, .5) != 0.) err = 1;
+  // half of the ramp in each histogram
+  for (i = 0; i < 10; i++) {
+    fill_ramp(v, i * v->length, N);
+    aubio_hist_accumulate(i % 2 ? a : b, v);
+  }
+  if (aubio_hist_merge(a, b) != 0) err = 1;
+  if (aubio_hist_merge(a, c) == 0) err = 1;
+  if (aubio_hist_get_count(a) != N) {
+    PRINT_ERR("hist: counted %f elements\n", aubio_hist_get_count(a));
+    err = 1;
+  }
+  for (i = 0; i < 5; i++) found[i] = aubio_hist_quantile(a, qs[i]);
+  err |= check_quantiles("hist", found, 2.e-3);
+  // out of range elements go to the edges
+  aubio_hist_reset(a);
+  fvec_set_all(v, 5.);
+  aubio_hist_accumulate(a, v);
+  if (aubio_hist_quantile(a, .5) < .99 || aubio_hist_quantile(a, .5) > 1.) {
+    PRINT_ERR("hist: large elements at %f\n", aubio_hist_quantile(a, .5));
+    err = 1;
+  }
+  del_aubio_hist(a);
+  del_aubio_hist(b);
+  del_aubio_hist(c);
+  del_fvec(v);
+  return err;
+}
+
+static uint_t check_digest (void)
+{
+  const smpl_t qs[] = { 0.01, .1, .5, .9, .99 };
+  aubio_digest_t *a = new_aubio_digest(100);
+  aubio_digest_t *b = new_aubio_digest(100);
+  fvec_t *v = new_fvec(N / 10);
+  smpl_t found[5];
+  uint_t i, err = 0;
+  if (!a || !b || !v) return 1;
+  if (aubio_digest_quantile(a, .5) != 0.) err = 1;
+  for (i = 0; i < 10; i++) {
+    fill_ramp(v, i * v->length, N);
+    aubio_digest_do(i % 2 ? a : b, v);
+  }
+  aubio_digest_merge(a, b);
+  if (aubio_digest_get_count(a) != N) {
+    PRINT_ERR("digest: counted %f elements\n", aubio_digest_get_count(a));
+    err = 1;
+  }
+  for (i = 0; i < 5; i++) found[i] = aubio_digest_quantile(a, qs[i]);
+  err |= check_quantiles("digest", found, 1.e-2);
+  if (aubio_digest_quantile(a, 0.) != 0. || aubio_digest_quantile(a, 1.) != 1.) {
+    PRINT_ERR("digest: extremes %f %f\n", aubio_digest_quantile(a, 0.),
+        aubio_digest_quantile(a, 1.));
+    err = 1;
+  }
+  del_aubio_digest(a);
+  del_aubio_digest(b);
+  del_fvec(v);
+  return err;
+}
+
+// after a change of level, a decaying summary follows the new values
+static uint_t check_decay (void)
+{
+  aubio_hist_t *h = new_aubio_hist(0, 1, 100);
+  aubio_digest_t *d = new_aubio_digest(50);
+  fvec_t *v = new_fvec(64);
+  uint_t i, err = 0;
+  if (!h || !d || !v) return 1;
+  if (aubio_hist_set_decay(h, .9) || aubio_digest_set_decay(d, .9)) err = 1;
+  fvec_set_all(v, .2);
+  for (i = 0; i < 100; i++) {
+    aubio_hist_accumulate(h, v);
+    aubio_digest_do(d, v);
+  }
+  fvec_set_all(v, .8);
+  for (i = 0; i < 100; i++) {
+    aubio_hist_accumulate(h, v);
+    aubio_digest_do(d, v);
+  }
+  if (fabs(aubio_hist_quantile(h, .1) - .8) > .01
+      || fabs(aubio_digest_quantile(d, .1) - .8) > .01) {
+    PRINT_ERR("decay: old elements remain, %f %f\n",
+        aubio_hist_quantile(h, .1), aubio_digest_quantile(d, .1));
+    err = 1;
+  }
+  // the counts converge to 64 / (1 - .9)
+  if (fabs(aubio_digest_get_count(d) - 640.) > 1.) err = 1;
+  del_aubio_hist(h);
+  del_aubio_digest(d);
+  del_fvec(v);
+  return err;
+}
 
 int main (void)
 {
-  uint_t length;
+  uint_t length, err = 0;
+  aubio_hist_t *h;
+  aubio_digest_t *d;
   for (length = 1; length < 10; length ++ ) {
     aubio_hist_t *o = new_aubio_hist(0, 1, length);
     fvec_t *t = new_aubio_window("hanning", length);
@@ -26,6 +158,17 @@ int main (void)
     del_fvec(t);
   }
   if (new_aubio_hist(0, 1, 0)) return 1;
-  return 0;
+  if (new_aubio_digest(0.) || new_aubio_digest(1.e6)) return 1;
+  h = new_aubio_hist(0, 1, 10);
+  d = new_aubio_digest(100);
+  if (!h || !d) return 1;
+  if (!aubio_hist_set_decay(h, 0.) || !aubio_hist_set_decay(h, 1.5)) err = 1;
+  if (!aubio_digest_set_decay(d, 0.) || !aubio_digest_set_decay(d, -1.)) err = 1;
+  del_aubio_hist(h);
+  del_aubio_digest(d);
+  if (err) PRINT_ERR("wrong parameters were accepted\n");
+  if (check_accumulate()) err = 1;
+  if (check_digest()) err = 1;
+  if (check_decay()) err = 1;
+  return err;
 }
-
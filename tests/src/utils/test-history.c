@@ -0,0 +1,182 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// histories keep the last frames pushed, oldest first, in a contiguous view
+// read without copies
+
+#define WIN_S 1024
+#define HOP_S 256
+#define RATE 44100
+#define LENGTH 16
+
+static uint_t check_history (void)
+{
+  aubio_history_t *h = new_aubio_history (3, 2);
+  fvec_t *frame = new_fvec (2), *wrong = new_fvec (3);
+  const fmat_t *frames;
+  const fvec_t *data;
+  uint_t i, err = 0;
+  if (!h || !frame || !wrong) return 1;
+  if (new_aubio_history (0, 2) || new_aubio_history (3, 0)) err = 1;
+  for (i = 0; i < 5; i++) {
+    frame->data[0] = i;
+    frame->data[1] = 10 * i;
+    if (aubio_history_push (h, frame) != 0) err = 1;
+  }
+  if (aubio_history_push (h, wrong) == 0) err = 1;
+  frames = aubio_history_get_frames (h);
+  data = aubio_history_get_data (h);
+  if (frames->height != 3 || frames->length != 2 || data->length != 6)
+    err = 1;
+  for (i = 0; i < 3; i++) {
+    // frames 2, 3 and 4, the rows following each other in memory
+    if (frames->data[i][0] != i + 2 || frames->data[i][1] != 10 * (i + 2)
+        || frames->data[i] != data->data + 2 * i) err = 1;
+  }
+  if (aubio_history_get_count (h) != 5) err = 1;
+  aubio_history_reset (h);
+  data = aubio_history_get_data (h);
+  for (i = 0; i < data->length; i++) {
+    if (data->data[i] != 0.) err = 1;
+  }
+  del_aubio_history (h);
+  h = new_aubio_history (2, 1);
+  if (!h) return 1;
+  for (i = 0; i < 3; i++) aubio_history_push_value (h, i);
+  data = aubio_history_get_data (h);
+  if (data->data[0] != 1. || data->data[1] != 2.) err = 1;
+  del_aubio_history (h);
+  del_fvec (frame);
+  del_fvec (wrong);
+  return err;
+}
+
+static void fill_hop (fvec_t *in, uint_t n)
+{
+  uint_t i;
+  smpl_t gain = (n % 20 < 3) ? .8 : .02;
+  for (i = 0; i < in->length; i++) {
+    in->data[i] = gain * (2. * random() / (smpl_t)RAND_MAX - 1.);
+  }
+}
+
+static uint_t check_onset (void)
+{
+  aubio_onset_t *o = new_aubio_onset ("default", WIN_S, HOP_S, RATE);
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (1);
+  smpl_t desc[LENGTH + 40], thresholded[LENGTH + 40];
+  const fvec_t *view;
+  uint_t n, i, err = 0;
+  if (!o || !in || !out) return 1;
+  if (aubio_onset_get_descriptor_history (o) != NULL
+      || aubio_onset_get_history (o) != 0) err = 1;
+  if (aubio_onset_set_history (o, LENGTH) != 0
+      || aubio_onset_get_history (o) != LENGTH) err = 1;
+  for (n = 0; n < LENGTH + 40; n++) {
+    fill_hop (in, n);
+    aubio_onset_do (o, in, out);
+    desc[n] = aubio_onset_get_descriptor (o);
+    thresholded[n] = aubio_onset_get_thresholded_descriptor (o);
+  }
+  view = aubio_onset_get_descriptor_history (o);
+  for (i = 0; i < LENGTH; i++) {
+    if (view->data[i] != desc[40 + i]) err = 1;
+  }
+  view = aubio_onset_get_thresholded_history (o);
+  for (i = 0; i < LENGTH; i++) {
+    if (view->data[i] != thresholded[40 + i]) err = 1;
+  }
+  // kept, and cleared, when changing the method
+  if (aubio_onset_reconfigure (o, "hfc", WIN_S, HOP_S) != 0
+      || aubio_onset_get_history (o) != LENGTH) err = 1;
+  view = aubio_onset_get_descriptor_history (o);
+  if (view->data[LENGTH - 1] != 0.) err = 1;
+  aubio_onset_set_history (o, 0);
+  if (aubio_onset_get_descriptor_history (o) != NULL) err = 1;
+  del_aubio_onset (o);
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+static uint_t check_tempo (void)
+{
+  aubio_tempo_t *o = new_aubio_tempo ("default", WIN_S, HOP_S, RATE);
+  fvec_t *in = new_fvec (HOP_S), *out = new_fvec (2);
+  smpl_t bpm[LENGTH + 400], confidence[LENGTH + 400];
+  const fvec_t *bpm_view, *confidence_view;
+  uint_t n, i, err = 0;
+  if (!o || !in || !out) return 1;
+  aubio_tempo_set_history (o, LENGTH);
+  for (n = 0; n < LENGTH + 400; n++) {
+    fill_hop (in, n);
+    aubio_tempo_do (o, in, out);
+    bpm[n] = aubio_tempo_get_bpm (o);
+    confidence[n] = aubio_tempo_get_confidence (o);
+  }
+  bpm_view = aubio_tempo_get_bpm_history (o);
+  confidence_view = aubio_tempo_get_confidence_history (o);
+  if (!aubio_tempo_get_descriptor_history (o) || !bpm_view
+      || !confidence_view) return 1;
+  for (i = 0; i < LENGTH; i++) {
+    if (bpm_view->data[i] != bpm[400 + i]
+        || confidence_view->data[i] != confidence[400 + i]) err = 1;
+  }
+  PRINT_MSG ("tempo: %.2f bpm after %d hops\n", bpm_view->data[LENGTH - 1],
+      LENGTH + 400);
+  del_aubio_tempo (o);
+  del_fvec (in);
+  del_fvec (out);
+  return err;
+}
+
+static uint_t check_filterbank (void)
+{
+  aubio_filterbank_t *f = new_aubio_filterbank (40, WIN_S);
+  cvec_t *spectrum = new_cvec (WIN_S);
+  fmat_t *spectra = new_fmat (3, WIN_S / 2 + 1), *bands = new_fmat (3, 40);
+  fvec_t *out = new_fvec (40);
+  const fmat_t *view;
+  uint_t i, j, err = 0;
+  if (!f || !spectrum || !spectra || !bands || !out) return 1;
+  aubio_filterbank_set_mel_coeffs (f, RATE, 0., RATE / 2.);
+  if (aubio_filterbank_set_history (f, 4) != 0
+      || aubio_filterbank_get_history (f) != 4) err = 1;
+  for (i = 0; i < spectrum->length; i++) {
+    spectrum->norm[i] = 1. / (i + 1.);
+  }
+  aubio_filterbank_do (f, spectrum, out);
+  for (j = 0; j < spectra->height; j++) {
+    for (i = 0; i < spectra->length; i++) {
+      spectra->data[j][i] = (j + 1.) / (i + 1.);
+    }
+  }
+  aubio_filterbank_do_batch (f, spectra, bands);
+  view = aubio_filterbank_get_bands_history (f);
+  if (view->height != 4 || view->length != 40) err = 1;
+  for (i = 0; i < 40; i++) {
+    if (view->data[0][i] != out->data[i]) err = 1;
+    for (j = 0; j < 3; j++) {
+      if (view->data[j + 1][i] != bands->data[j][i]) err = 1;
+    }
+  }
+  del_aubio_filterbank (f);
+  del_cvec (spectrum);
+  del_fmat (spectra);
+  del_fmat (bands);
+  del_fvec (out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  utils_init_random ();
+  if (check_history ()) err = 1;
+  if (check_onset ()) err = 1;
+  if (check_tempo ()) err = 1;
+  if (check_filterbank ()) err = 1;
+  if (err) PRINT_ERR ("histories differ from the values of each hop\n");
+  aubio_cleanup ();
+  return err;
+}
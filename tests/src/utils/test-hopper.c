@@ -0,0 +1,119 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// cut a ramp into blocks of varying length, check the hopper passes it on
+// hop after hop, then check an onset detector run through the hopper finds
+// the same onsets as when reading hops directly.
+
+#define HOP 256
+#define LENGTH (HOP * 200)
+
+static uint_t block_length (uint_t size, uint_t pos)
+{
+  return size < LENGTH - pos ? size : LENGTH - pos;
+}
+
+typedef struct {
+  const fvec_t *signal;
+  uint_t pos;
+  uint_t err;
+} check_t;
+
+static void check_hop (void *data, const fvec_t *hop)
+{
+  check_t *c = (check_t *)data;
+  uint_t j;
+  if (hop->length != HOP) c->err = 1;
+  for (j = 0; j < hop->length; j++) {
+    if (hop->data[j] != c->signal->data[c->pos + j]) c->err = 1;
+  }
+  c->pos += hop->length;
+}
+
+typedef struct {
+  aubio_onset_t *onset;
+  fvec_t *out;
+  uint_t n_onsets;
+  uint_t last;
+} onsets_t;
+
+static void do_onset (void *data, const fvec_t *hop)
+{
+  onsets_t *d = (onsets_t *)data;
+  aubio_onset_do(d->onset, hop, d->out);
+  if (d->out->data[0] != 0) {
+    d->n_onsets++;
+    d->last = aubio_onset_get_last(d->onset);
+  }
+}
+
+int main (void)
+{
+  const uint_t sizes[] = { 480, 441, 1, 0, 1024, 255, 257, 64 };
+  const uint_t n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+  fvec_t *signal = new_fvec(LENGTH);
+  aubio_hopper_t *o = new_aubio_hopper(HOP);
+  onsets_t direct = { NULL, NULL, 0, 0 }, hopped = { NULL, NULL, 0, 0 };
+  check_t c = { NULL, 0, 0 };
+  fvec_t block, hop;
+  uint_t i, pos = 0, expected, hops = 0, err = 0;
+
+  if (!signal || !o) return 1;
+  for (i = 0; i < LENGTH; i++) {
+    // a ramp, with a click every 50 hops
+    signal->data[i] = (i % (50 * HOP) < 16) ? 1. : i / (smpl_t)LENGTH * .01;
+  }
+  c.signal = signal;
+
+  for (i = 0; pos < LENGTH; i++) {
+    block.length = block_length(sizes[i % n_sizes], pos);
+    block.data = signal->data + pos;
+    expected = aubio_hopper_get_hops(o, block.length);
+    hops += aubio_hopper_do(o, &block, check_hop, &c);
+    pos += block.length;
+    if (hops * HOP != c.pos || hops != (pos / HOP)
+        || aubio_hopper_get_pending(o) != pos % HOP
+        || expected != hops - (pos - block.length) / HOP) {
+      PRINT_MSG("wrong count of hops after %d samples\n", pos);
+      err = 1;
+    }
+  }
+  if (c.err || hops != LENGTH / HOP) {
+    PRINT_MSG("got %d hops, expected %d\n", hops, LENGTH / HOP);
+    err = 1;
+  }
+
+  aubio_hopper_reset(o);
+  direct.onset = new_aubio_onset("default", 2 * HOP, HOP, 44100);
+  hopped.onset = new_aubio_onset("default", 2 * HOP, HOP, 44100);
+  direct.out = new_fvec(1);
+  hopped.out = new_fvec(1);
+  if (!direct.onset || !hopped.onset || !direct.out || !hopped.out) return 1;
+  hop.length = HOP;
+  for (pos = 0; pos < LENGTH; pos += HOP) {
+    hop.data = signal->data + pos;
+    do_onset(&direct, &hop);
+  }
+  for (i = 0, pos = 0; pos < LENGTH; i++) {
+    block.length = block_length(sizes[i % n_sizes], pos);
+    block.data = signal->data + pos;
+    aubio_hopper_do(o, &block, do_onset, &hopped);
+    pos += block.length;
+  }
+  PRINT_MSG("found %d onsets, last at %d\n", hopped.n_onsets, hopped.last);
+  if (direct.n_onsets == 0 || hopped.n_onsets != direct.n_onsets
+      || hopped.last != direct.last) {
+    PRINT_MSG("found %d onsets, expected %d\n", hopped.n_onsets,
+        direct.n_onsets);
+    err = 1;
+  }
+
+  del_aubio_onset(direct.onset);
+  del_aubio_onset(hopped.onset);
+  del_fvec(direct.out);
+  del_fvec(hopped.out);
+  del_aubio_hopper(o);
+  del_fvec(signal);
+  aubio_cleanup();
+  return err;
+}
@@ -0,0 +1,134 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// create objects with an allocator keeping track of the memory in use, and
+// check it against the memory usage they report
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+
+typedef struct {
+  size_t bytes;
+  uint_t blocks;
+} live_t;
+
+// each block starts with its size, in a prefix keeping malloc's alignment
+#define PREFIX 16
+
+static void *live_alloc (void *data, uint_t size)
+{
+  live_t *live = (live_t *)data;
+  char *raw = (char *)malloc(PREFIX + size);
+  if (!raw) return NULL;
+  *(uint_t *)raw = size;
+  live->bytes += size;
+  live->blocks++;
+  return raw + PREFIX;
+}
+
+static void live_release (void *data, void *ptr)
+{
+  live_t *live = (live_t *)data;
+  char *raw = (char *)ptr - PREFIX;
+  live->bytes -= *(uint_t *)raw;
+  live->blocks--;
+  free(raw);
+}
+
+static live_t live = { 0, 0 };
+static aubio_allocator_t counter = { live_alloc, live_release, &live };
+// bytes added to each block by aubio, for its header and alignment
+static size_t overhead = 0;
+
+// bytes asked by aubio since the live counts were reset
+static uint_t live_usage (void)
+{
+  return (uint_t)(live.bytes - live.blocks * overhead);
+}
+
+static uint_t check (const char_t *what, uint_t usage, uint_t expected)
+{
+  PRINT_MSG("%-12s %8d bytes, %8d counted\n", what, usage, expected);
+  if (usage == 0 || usage < expected) {
+    PRINT_ERR("%s reports %d bytes, expected at least %d\n", what, usage,
+        expected);
+    return 1;
+  }
+#if !defined(HAVE_FFTW3) && !defined(HAVE_INTEL_IPP)
+  // all the memory comes from the allocator
+  if (usage != expected) {
+    PRINT_ERR("%s reports %d bytes, expected %d\n", what, usage, expected);
+    return 1;
+  }
+#endif
+  return 0;
+}
+
+#define CHECK_OBJECT(name, create) do { \
+    aubio_##name##_t *warm = create, *o; \
+    const aubio_allocator_t *previous; \
+    live.bytes = 0; live.blocks = 0; \
+    previous = aubio_set_allocator(&counter); \
+    o = create; \
+    aubio_set_allocator(previous); \
+    if (!warm || !o) return 1; \
+    err |= check(#name, aubio_##name##_get_memory_usage(o), live_usage()); \
+    del_aubio_##name(warm); \
+    del_aubio_##name(o); \
+  } while (0)
+
+int main (void)
+{
+  uint_t err = 0, before, after;
+  const aubio_allocator_t *previous = aubio_set_allocator(&counter);
+  fvec_t *vec = new_fvec(3);
+  cvec_t *spec;
+  fmat_t *mat;
+  aubio_tempo_t *tempo;
+  aubio_set_allocator(previous);
+
+  // calibrate the size of the header of each block
+  if (!vec) return 1;
+  overhead = live.bytes - fvec_get_memory_usage(vec);
+  PRINT_MSG("%d bytes of header and alignment per block\n", (uint_t)overhead);
+  aubio_set_allocator(&counter);
+  del_fvec(vec);
+  live.bytes = 0; live.blocks = 0;
+  spec = new_cvec(WIN);
+  mat = new_fmat(3, WIN);
+  aubio_set_allocator(previous);
+  if (!spec || !mat) return 1;
+  err |= check("vectors", cvec_get_memory_usage(spec)
+      + fmat_get_memory_usage(mat), live_usage());
+  del_cvec(spec);
+  del_fmat(mat);
+
+  // objects sharing tables with the first one created, which only counts
+  // the memory it owns
+  CHECK_OBJECT(fft, new_aubio_fft(WIN));
+  CHECK_OBJECT(pvoc, new_aubio_pvoc(WIN, HOP));
+  CHECK_OBJECT(mfcc, new_aubio_mfcc(WIN, 40, 13, SR));
+  CHECK_OBJECT(chroma, new_aubio_chroma(WIN, 55., 4000., SR));
+  CHECK_OBJECT(onset, new_aubio_onset("default", WIN, HOP, SR));
+  CHECK_OBJECT(pitch, new_aubio_pitch("yinfft", WIN, HOP, SR));
+  CHECK_OBJECT(pitch, new_aubio_pitch("mcomb", WIN, HOP, SR));
+  CHECK_OBJECT(tempo, new_aubio_tempo("default", WIN, HOP, SR));
+  CHECK_OBJECT(tempo, new_aubio_tempo("envelope", WIN, HOP, SR));
+  CHECK_OBJECT(decimator, new_aubio_decimator(4));
+  CHECK_OBJECT(filterbank_iir, new_aubio_filterbank_iir(8, SR));
+  CHECK_OBJECT(notes, new_aubio_notes("default", WIN, HOP, SR));
+
+  // the buffers of compact trackers are not counted
+  tempo = new_aubio_tempo("default", WIN, HOP, SR);
+  if (!tempo) return 1;
+  before = aubio_tempo_get_memory_usage(tempo);
+  aubio_tempo_set_compact(tempo, 1);
+  after = aubio_tempo_get_memory_usage(tempo);
+  PRINT_MSG("tempo: %d bytes, %d in compact mode\n", before, after);
+  if (after >= before) err = 1;
+  del_aubio_tempo(tempo);
+
+  aubio_cleanup();
+  return err;
+}
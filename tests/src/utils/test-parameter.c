@@ -22,6 +22,38 @@ void get_some_steps ( aubio_parameter_t * param )
 
 }
 
+// compare blocks of ramps to the values returned one at a time
+uint_t check_fill_ramp ( uint_t steps, uint_t length );
+
+uint_t check_fill_ramp ( uint_t steps, uint_t length )
+{
+  aubio_parameter_t * a = new_aubio_parameter ( -1., 1., steps );
+  aubio_parameter_t * b = new_aubio_parameter ( -1., 1., steps );
+  fvec_t * out = new_fvec ( length );
+  const smpl_t targets[] = { 1., -.3, -.3, .7, -1. };
+  uint_t i, j, k, err = 0;
+  for (i = 0; i < sizeof(targets) / sizeof(targets[0]); i++) {
+    aubio_parameter_set_target_value ( a, targets[i] );
+    aubio_parameter_set_target_value ( b, targets[i] );
+    for (k = 0; k < 3; k++) {
+      aubio_parameter_fill_ramp ( a, out );
+      for (j = 0; j < length; j++) {
+        // the values one at a time accumulate rounding errors
+        smpl_t expected = aubio_parameter_get_next_value ( b );
+        if (fabs(out->data[j] - expected) > 1.e-4 && !err) {
+          PRINT_ERR("ramp of %d steps: got %f instead of %f\n", steps,
+              out->data[j], expected);
+          err = 1;
+        }
+      }
+    }
+  }
+  del_fvec ( out );
+  del_aubio_parameter ( a );
+  del_aubio_parameter ( b );
+  return err;
+}
+
 int main (void)
 {
   smpl_t max_value = 100.;
@@ -66,5 +98,9 @@ int main (void)
 
   del_aubio_parameter (param);
 
+  if (check_fill_ramp ( 1, 16 ) || check_fill_ramp ( 10, 7 )
+      || check_fill_ramp ( 100, 64 ) || check_fill_ramp ( 2000, 512 )) {
+    return 1;
+  }
   return 0;
 }
@@ -0,0 +1,150 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// encode vectors in 8 and 16 bits, decode them back, and compare the
+// quantized outputs of filterbank and mfcc to their float outputs
+
+#define WIN_S 1024
+#define N_FILTERS 40
+#define N_COEFS 13
+
+static uint_t check_f16 (void)
+{
+  smpl_t values[] = { 1., -2., 65504., 65520., 1. / 16777216., 1. / 33554432.,
+    1. + 1. / 2048., 1. + 3. / 2048., 0. };
+  f16_t expected[] = { 0x3c00, 0xc000, 0x7bff, 0x7c00, 0x0001, 0x0000,
+    0x3c00, 0x3c02, 0x0000 };
+  fvec_t vec = { 9, values };
+  f16_t codes[9];
+  fvec_t *in = new_fvec (1000), *out = new_fvec (1000);
+  f16_t *halves = (f16_t *)malloc (1000 * sizeof (f16_t));
+  uint_t i, err = 0;
+  aubio_quantize_f16 (&vec, codes);
+  for (i = 0; i < vec.length; i++) {
+    if (codes[i] != expected[i]) {
+      PRINT_MSG ("f16 of %g is %04x, expected %04x\n", values[i], codes[i],
+          expected[i]);
+      err = 1;
+    }
+  }
+  // from below the smallest normal half to near the largest one
+  for (i = 0; i < in->length; i++) {
+    in->data[i] = (i % 2 ? -1. : 1.) * pow (2., -14. + 29. * i / 1000.);
+  }
+  aubio_quantize_f16 (in, halves);
+  aubio_dequantize_f16 (halves, out);
+  for (i = 0; i < in->length; i++) {
+    if (fabs (out->data[i] - in->data[i]) > fabs (in->data[i]) / 2048.) err = 1;
+  }
+  values[0] = NAN;
+  vec.length = 1;
+  aubio_quantize_f16 (&vec, codes);
+  aubio_dequantize_f16 (codes, &vec);
+  if (!isnan (values[0])) err = 1;
+  del_fvec (in);
+  del_fvec (out);
+  free (halves);
+  return err;
+}
+
+static uint_t check_bytes (void)
+{
+  smpl_t values[] = { -200., -100., -40., 20., 50., NAN };
+  fvec_t vec = { 6, values }, *out = new_fvec (6);
+  u8_t u[6];
+  s8_t s[6];
+  uint_t i, err = 0;
+  aubio_quantize_u8 (&vec, -100., 20., u);
+  if (u[0] != 0 || u[1] != 0 || u[2] != 128 || u[3] != 255 || u[4] != 255
+      || u[5] != 0) err = 1;
+  out->length = 5;
+  aubio_dequantize_u8 (u, -100., 20., out);
+  if (fabs (out->data[2] + 40.) > 60. / 255. + 1.e-4) err = 1;
+  aubio_quantize_s8 (&vec, .5, s);
+  if (s[0] != -127 || s[2] != -80 || s[3] != 40 || s[4] != 100
+      || s[5] != -127) err = 1;
+  aubio_dequantize_s8 (s, .5, out);
+  for (i = 2; i < 5; i++) {
+    if (out->data[i] != values[i]) err = 1;
+  }
+  del_fvec (out);
+  return err;
+}
+
+static uint_t check_features (void)
+{
+  aubio_filterbank_t *fb = new_aubio_filterbank (N_FILTERS, WIN_S);
+  aubio_mfcc_t *mfcc = new_aubio_mfcc (WIN_S, N_FILTERS, N_COEFS, 44100);
+  aubio_mfcc_t *ref = new_aubio_mfcc (WIN_S, N_FILTERS, N_COEFS, 44100);
+  cvec_t *spec = new_cvec (WIN_S);
+  fvec_t *bands = new_fvec (N_FILTERS), *coefs = new_fvec (3 * N_COEFS);
+  fvec_t *decoded = new_fvec (3 * N_COEFS);
+  u8_t levels[N_FILTERS];
+  f16_t halves[N_FILTERS];
+  s8_t codes[3 * N_COEFS];
+  uint_t n, i, err = 0;
+  if (!fb || !mfcc || !ref || !spec || !bands || !coefs
+      || !decoded) return 1;
+  aubio_filterbank_set_mel_coeffs_slaney (fb, 44100);
+  if (aubio_mfcc_set_deltas (mfcc, 2, 2) || aubio_mfcc_set_deltas (ref, 2, 2))
+    return 1;
+
+  for (n = 0; n < 10; n++) {
+    for (i = 0; i < spec->length; i++) {
+      spec->norm[i] = (random () % 1000) / 1000. * (1. + n) / (1. + i);
+    }
+    aubio_filterbank_do_log_u8 (fb, spec, -100., 20., levels);
+    aubio_filterbank_do (fb, spec, bands);
+    for (i = 0; i < N_FILTERS; i++) {
+      smpl_t db = 10. * log10 (bands->data[i]);
+      if (fabs (-100. + levels[i] * 120. / 255. - db) > 60. / 255. + 1.e-3)
+        err = 1;
+    }
+    aubio_filterbank_do_f16 (fb, spec, halves);
+    decoded->length = N_FILTERS;
+    aubio_dequantize_f16 (halves, decoded);
+    for (i = 0; i < N_FILTERS; i++) {
+      if (fabs (decoded->data[i] - bands->data[i]) > bands->data[i] / 2048.)
+        err = 1;
+    }
+
+    // the coefficients and their deltas, each object with its own history
+    aubio_mfcc_do_s8 (mfcc, spec, .25, codes);
+    aubio_mfcc_do (ref, spec, coefs);
+    for (i = 0; i < coefs->length; i++) {
+      smpl_t q = coefs->data[i] / .25;
+      q = q < -127. ? -127. : (q > 127. ? 127. : q);
+      if (fabs (codes[i] - q) > .5 + 1.e-3) err = 1;
+    }
+  }
+  aubio_mfcc_do_f16 (mfcc, spec, halves);
+  aubio_mfcc_do (ref, spec, coefs);
+  decoded->length = coefs->length;
+  aubio_dequantize_f16 (halves, decoded);
+  for (i = 0; i < coefs->length; i++) {
+    if (fabs (decoded->data[i] - coefs->data[i])
+        > fabs (coefs->data[i]) / 2048. + 1.e-7) err = 1;
+  }
+  PRINT_MSG ("first coefficient %f, encoded as %d\n", coefs->data[0],
+      codes[0]);
+
+  del_aubio_filterbank (fb);
+  del_aubio_mfcc (mfcc);
+  del_aubio_mfcc (ref);
+  del_cvec (spec);
+  del_fvec (bands);
+  del_fvec (coefs);
+  del_fvec (decoded);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  err |= check_f16 ();
+  err |= check_bytes ();
+  err |= check_features ();
+  if (err) PRINT_ERR ("quantized values differ from the ones expected\n");
+  aubio_cleanup ();
+  return err;
+}
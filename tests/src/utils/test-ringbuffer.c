@@ -0,0 +1,157 @@
+#include <aubio.h>
+#include "utils_tests.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// a ring buffer moves frames from one thread to another without ever
+// waiting; the frames come out in the order they went in
+
+#define LENGTH 1000
+#define N_FRAMES 200000
+#define MAX_BLOCK 333
+
+static uint_t check_ring (void)
+{
+  aubio_ringbuffer_t *o = new_aubio_ringbuffer (2, 5);
+  fvec_t *in = new_fvec (4), *out = new_fvec (4);
+  fmat_t *mono = new_fmat (1, 4), *stereo = new_fmat (3, 4);
+  uint_t i, err = 0;
+  if (!o || !in || !out || !mono || !stereo) return 1;
+  if (new_aubio_ringbuffer (0, 5) || new_aubio_ringbuffer (2, 0)) err = 1;
+  for (i = 0; i < 4; i++) in->data[i] = i + 1;
+  // only 5 frames fit
+  if (aubio_ringbuffer_write (o, in, 4) != 4
+      || aubio_ringbuffer_write (o, in, 4) != 1
+      || aubio_ringbuffer_get_read_space (o) != 5
+      || aubio_ringbuffer_get_write_space (o) != 0) err = 1;
+  // each sample of a vector goes to every channel
+  if (aubio_ringbuffer_read_multi (o, stereo, 3) != 3) err = 1;
+  for (i = 0; i < 3; i++) {
+    if (stereo->data[0][i] != i + 1 || stereo->data[1][i] != i + 1
+        || stereo->data[2][i] != 0.) err = 1;
+  }
+  // wrap around the end of the ring
+  for (i = 0; i < 4; i++) mono->data[0][i] = 10 + i;
+  if (aubio_ringbuffer_write_multi (o, mono, 3) != 3) err = 1;
+  if (aubio_ringbuffer_read (o, out, 4) != 4
+      || out->data[0] != 4 || out->data[1] != 1 || out->data[2] != 10
+      || out->data[3] != 11) err = 1;
+  // the missing channels are zeros
+  if (aubio_ringbuffer_read_multi (o, stereo, 4) != 1
+      || stereo->data[0][0] != 12 || stereo->data[1][0] != 0.) err = 1;
+  if (aubio_ringbuffer_read (o, out, 4) != 0) err = 1;
+  aubio_ringbuffer_write (o, in, 2);
+  aubio_ringbuffer_reset (o);
+  if (aubio_ringbuffer_get_read_space (o) != 0
+      || aubio_ringbuffer_get_write_space (o) != 5
+      || aubio_ringbuffer_get_length (o) != 5
+      || aubio_ringbuffer_get_channels (o) != 2
+      || aubio_ringbuffer_get_memory_usage (o) == 0) err = 1;
+  del_aubio_ringbuffer (o);
+  del_fvec (in);
+  del_fvec (out);
+  del_fmat (mono);
+  del_fmat (stereo);
+  return err;
+}
+
+// let the other thread run when the ring is full, or empty
+static void yield (void)
+{
+#ifdef _WIN32
+  Sleep (0);
+#else
+  sched_yield ();
+#endif
+}
+
+typedef struct {
+  aubio_ringbuffer_t *ring;
+  uint_t errors;
+} stream_t;
+
+// writes blocks of varying sizes, each frame holding its index and its
+// opposite, as fast as the ring empties
+#ifdef _WIN32
+static DWORD WINAPI produce (LPVOID arg)
+#else
+static void *produce (void *arg)
+#endif
+{
+  stream_t *s = (stream_t *)arg;
+  fmat_t *block = new_fmat (2, MAX_BLOCK);
+  uint_t written = 0, n, i, size = 1;
+  while (written < N_FRAMES) {
+    size = size * 7 % MAX_BLOCK + 1;
+    n = size < N_FRAMES - written ? size : N_FRAMES - written;
+    for (i = 0; i < n; i++) {
+      block->data[0][i] = (written + i) % 65536;
+      block->data[1][i] = -block->data[0][i];
+    }
+    n = aubio_ringbuffer_write_multi (s->ring, block, n);
+    if (n == 0) yield ();
+    written += n;
+  }
+  del_fmat (block);
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+static uint_t check_threads (void)
+{
+  stream_t s;
+  fmat_t *block = new_fmat (2, MAX_BLOCK);
+  uint_t read = 0, n, i, size = 1;
+#ifdef _WIN32
+  HANDLE thread;
+#else
+  pthread_t thread;
+#endif
+  s.ring = new_aubio_ringbuffer (2, LENGTH);
+  s.errors = 0;
+  if (!s.ring || !block) return 1;
+#ifdef _WIN32
+  thread = CreateThread (NULL, 0, produce, &s, 0, NULL);
+  if (!thread) return 1;
+#else
+  if (pthread_create (&thread, NULL, produce, &s)) return 1;
+#endif
+  while (read < N_FRAMES) {
+    size = size * 5 % MAX_BLOCK + 1;
+    n = aubio_ringbuffer_read_multi (s.ring, block, size);
+    for (i = 0; i < n; i++) {
+      if (block->data[0][i] != (read + i) % 65536
+          || block->data[1][i] != -block->data[0][i]) s.errors++;
+    }
+    if (n == 0) yield ();
+    read += n;
+  }
+#ifdef _WIN32
+  WaitForSingleObject (thread, INFINITE);
+  CloseHandle (thread);
+#else
+  pthread_join (thread, NULL);
+#endif
+  if (aubio_ringbuffer_get_read_space (s.ring) != 0) s.errors++;
+  PRINT_MSG ("read %d frames through a ring of %d, %d errors\n", read,
+      LENGTH, s.errors);
+  del_aubio_ringbuffer (s.ring);
+  del_fmat (block);
+  return s.errors != 0;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  if (check_ring ()) err = 1;
+  if (check_threads ()) err = 1;
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,180 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// run the _do function of each detector in a real-time section, and check
+// none of them allocates memory or takes a lock. Without the rt_checks
+// build option, the checks are disabled and only the detectors are run.
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define N_HOPS 400
+
+static uint_t failed = 0, start = 0;
+
+// notes, with a bit of noise, starting every 20 hops, and some silence
+static void fill (fvec_t *in, uint_t hop)
+{
+  uint_t j, t;
+  smpl_t freq = 220. * (1 + (hop / 20) % 4), amp;
+  for (j = 0; j < in->length; j++) {
+    t = hop * in->length + j;
+    amp = (hop % 20 < 15 && hop % 100 < 80) ? .5 : 0.;
+    in->data[j] = amp * sin(2. * M_PI * freq * t / SR)
+      + .01 * ((t * 7919) % 101 - 50) / 50.;
+  }
+}
+
+static void enter (void)
+{
+  start = aubio_rtcheck_get_violations();
+  aubio_rtcheck_enter();
+}
+
+static void leave (const char_t *name)
+{
+  aubio_rtcheck_leave();
+  if (aubio_rtcheck_get_violations() != start) {
+    PRINT_ERR("%s allocates or locks in its _do function\n", name);
+    failed++;
+  } else {
+    PRINT_MSG("%s is real-time safe\n", name);
+  }
+}
+
+int main (void)
+{
+  const char_t *onset_methods[] = { "energy", "specdiff", "hfc", "complex",
+    "phase", "wphase", "mkl", "kl", "specflux" };
+  const char_t *pitch_methods[] = { "mcomb", "yinfast", "yinfft", "yin",
+    "schmitt", "fcomb", "specacf" };
+  fvec_t *in = new_fvec(HOP), *out = new_fvec(HOP), *out1 = new_fvec(1);
+  fvec_t *notes = new_fvec(3), *coeffs = new_fvec(13);
+  fvec_t *half = new_fvec(HOP / 2), *twice = new_fvec(HOP * 2);
+  fmat_t *bands = new_fmat(6, HOP);
+  cvec_t *grain = new_cvec(WIN), *trans = new_cvec(WIN),
+         *stead = new_cvec(WIN);
+  uint_t i, h;
+
+  if (!aubio_rtcheck_enabled()) {
+    PRINT_MSG("built without rt_checks, only running the detectors\n");
+  } else {
+    // check the checks
+    fvec_t *f;
+    enter();
+    f = new_fvec(HOP);
+    aubio_rtcheck_leave();
+    del_fvec(f);
+    if (aubio_rtcheck_get_violations() == start) {
+      PRINT_ERR("new_fvec was not reported\n");
+      failed++;
+    }
+  }
+
+  for (i = 0; i < sizeof(onset_methods) / sizeof(onset_methods[0]); i++) {
+    aubio_onset_t *o = new_aubio_onset(onset_methods[i], WIN, HOP, SR);
+    enter();
+    for (h = 0; h < N_HOPS; h++) {
+      fill(in, h);
+      aubio_onset_do(o, in, out1);
+    }
+    leave(onset_methods[i]);
+    del_aubio_onset(o);
+  }
+
+  for (i = 0; i < sizeof(pitch_methods) / sizeof(pitch_methods[0]); i++) {
+    aubio_pitch_t *o = new_aubio_pitch(pitch_methods[i], WIN, HOP, SR);
+    enter();
+    for (h = 0; h < N_HOPS; h++) {
+      fill(in, h);
+      aubio_pitch_do(o, in, out1);
+    }
+    leave(pitch_methods[i]);
+    del_aubio_pitch(o);
+  }
+
+  {
+    aubio_tempo_t *o = new_aubio_tempo("default", WIN, HOP, SR);
+    enter();
+    for (h = 0; h < N_HOPS * 4; h++) {
+      fill(in, h);
+      aubio_tempo_do(o, in, out1);
+    }
+    leave("tempo");
+    del_aubio_tempo(o);
+  }
+
+  {
+    aubio_notes_t *o = new_aubio_notes("default", WIN, HOP, SR);
+    enter();
+    for (h = 0; h < N_HOPS; h++) {
+      fill(in, h);
+      aubio_notes_do(o, in, notes);
+    }
+    leave("notes");
+    del_aubio_notes(o);
+  }
+
+  {
+    aubio_pvoc_t *pv = new_aubio_pvoc(WIN, HOP);
+    aubio_mfcc_t *mfcc = new_aubio_mfcc(WIN, 40, 13, SR);
+    aubio_tss_t *tss = new_aubio_tss(WIN, HOP);
+    aubio_spectral_whitening_t *w =
+      new_aubio_spectral_whitening(WIN, HOP, SR);
+    enter();
+    for (h = 0; h < N_HOPS; h++) {
+      fill(in, h);
+      aubio_pvoc_do(pv, in, grain);
+      aubio_spectral_whitening_do(w, grain);
+      aubio_mfcc_do(mfcc, grain, coeffs);
+      aubio_tss_do(tss, grain, trans, stead);
+      aubio_pvoc_rdo(pv, stead, out);
+    }
+    leave("pvoc, whitening, mfcc and tss");
+    del_aubio_pvoc(pv);
+    del_aubio_mfcc(mfcc);
+    del_aubio_tss(tss);
+    del_aubio_spectral_whitening(w);
+  }
+
+  {
+    aubio_filter_t *f = new_aubio_filter_a_weighting(SR);
+    aubio_filterbank_iir_t *fb = new_aubio_filterbank_iir(6, SR);
+    aubio_decimator_t *d = new_aubio_decimator(2);
+    aubio_interpolator_t *p = new_aubio_interpolator(2);
+    aubio_wavetable_t *wt = new_aubio_wavetable(SR, HOP);
+    aubio_wavetable_play(wt);
+    // the halfband filters can not know the length of their input earlier
+    aubio_decimator_set_max_length(d, HOP);
+    aubio_interpolator_set_max_length(p, HOP);
+    enter();
+    for (h = 0; h < N_HOPS; h++) {
+      fill(in, h);
+      aubio_filterbank_iir_do(fb, in, bands);
+      aubio_decimator_do(d, in, half);
+      aubio_interpolator_do(p, in, twice);
+      aubio_filter_do(f, in);
+      aubio_wavetable_do(wt, in, out);
+    }
+    leave("filters and wavetable");
+    del_aubio_filter(f);
+    del_aubio_filterbank_iir(fb);
+    del_aubio_decimator(d);
+    del_aubio_interpolator(p);
+    del_aubio_wavetable(wt);
+  }
+
+  del_fvec(in);
+  del_fvec(out);
+  del_fvec(out1);
+  del_fvec(notes);
+  del_fvec(coeffs);
+  del_fvec(half);
+  del_fvec(twice);
+  del_fmat(bands);
+  del_cvec(grain);
+  del_cvec(trans);
+  del_cvec(stead);
+  aubio_cleanup();
+  return failed;
+}
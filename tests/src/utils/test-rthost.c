@@ -0,0 +1,108 @@
+#include <aubio.h>
+#include "utils_tests.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h> // nanosleep
+#endif
+
+// pass a ramp through a worker doubling each hop, and check each output
+// frame is either the doubled input, `latency + 1` hops earlier, or silence
+// counted as late. Then make the worker too slow, and check the real-time
+// side drops hops instead of waiting for it.
+
+#define HOP 64
+#define LATENCY 2
+#define CHUNK 100
+#define N_CHUNKS 192 // a whole number of hops
+
+typedef struct {
+  uint_t calls;
+  uint_t sleep_ms;
+} worker_t;
+
+static void sleep_ms (uint_t ms)
+{
+#ifdef _WIN32
+  Sleep(ms);
+#else
+  struct timespec ts;
+  ts.tv_sec = ms / 1000;
+  ts.tv_nsec = (ms % 1000) * 1000000L;
+  nanosleep(&ts, NULL);
+#endif
+}
+
+static void double_hop (void *data, fvec_t *input, fvec_t *output)
+{
+  worker_t *w = (worker_t *)data;
+  uint_t j;
+  for (j = 0; j < input->length; j++) {
+    output->data[j] = 2. * input->data[j];
+  }
+  if (w->sleep_ms) sleep_ms(w->sleep_ms);
+  w->calls++;
+}
+
+static uint_t run (uint_t worker_sleep, uint_t feeder_sleep, uint_t *dropped,
+    uint_t *late, uint_t *calls, uint_t *good)
+{
+  worker_t w = { 0, worker_sleep };
+  aubio_rthost_t *o = new_aubio_rthost(HOP, LATENCY, double_hop, &w);
+  fvec_t *in = new_fvec(CHUNK), *out = new_fvec(CHUNK);
+  uint_t i, j, t, delay, err = 0;
+  if (!o) return 1;
+  delay = aubio_rthost_get_delay(o) + HOP;
+  *good = 0;
+  for (i = 0; i < N_CHUNKS; i++) {
+    for (j = 0; j < CHUNK; j++) {
+      in->data[j] = 1 + i * CHUNK + j;
+    }
+    aubio_rthost_do(o, in, out);
+    for (j = 0; j < CHUNK; j++) {
+      t = i * CHUNK + j;
+      if (out->data[j] == 0.) continue;
+      if (t < delay || out->data[j] != 2. * (1 + t - delay)) {
+        if (!err) PRINT_ERR("wrong output %f at %d\n", out->data[j], t);
+        err = 1;
+      } else {
+        (*good)++;
+      }
+    }
+    if (feeder_sleep) sleep_ms(feeder_sleep);
+  }
+  *dropped = aubio_rthost_get_dropped(o);
+  *late = aubio_rthost_get_late(o);
+  del_aubio_rthost(o);
+  // all the hops passed to the worker were processed before deleting
+  *calls = w.calls;
+  del_fvec(in);
+  del_fvec(out);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0, dropped, late, calls, good;
+  uint_t n_hops = N_CHUNKS * CHUNK / HOP;
+
+  // the feeder is slower than the worker, most hops should get through
+  err |= run(0, 1, &dropped, &late, &calls, &good);
+  PRINT_MSG("fast worker: %d dropped, %d late, %d calls, %d good frames\n",
+      dropped, late, calls, good);
+  if (calls != n_hops - dropped) err = 1;
+  if (good == 0) err = 1;
+
+  // the worker takes 5ms per hop while the feeder never waits
+  err |= run(5, 0, &dropped, &late, &calls, &good);
+  PRINT_MSG("slow worker: %d dropped, %d late, %d calls, %d good frames\n",
+      dropped, late, calls, good);
+  if (calls != n_hops - dropped) err = 1;
+  if (dropped == 0 || late == 0) err = 1;
+
+  if (new_aubio_rthost(0, 1, double_hop, NULL)) err = 1;
+  if (new_aubio_rthost(HOP, 0, double_hop, NULL)) err = 1;
+  if (new_aubio_rthost(HOP, 1, NULL, NULL)) err = 1;
+
+  return err;
+}
@@ -0,0 +1,103 @@
+#define AUBIO_UNSTABLE 1
+#include "aubio.h"
+#include "utils_tests.h"
+
+// check vector kernels against plain loops on lengths that exercise both the
+// vectorized body and the remaining tail of each instruction set
+int main (void)
+{
+  uint_t length, j;
+  for (length = 1; length < 70; length++) {
+    fvec_t *a = new_fvec(length);
+    fvec_t *w = new_fvec(length);
+    fvec_t *out = new_fvec(length);
+    smpl_t sum = 0., max, min, energy = 0., peak = 0.;
+    aubio_frame_stats_t stats;
+    assert(a && w && out);
+    for (j = 0; j < length; j++) {
+      a->data[j] = (smpl_t)(j % 7) - 3.1;
+      w->data[j] = 0.5 + (smpl_t)(j % 5) * 0.25;
+    }
+    // push the extrema at the end, in the tail loops
+    a->data[length - 1] = (length % 2) ? 12. : -12.;
+    max = a->data[0]; min = a->data[0];
+    for (j = 0; j < length; j++) {
+      sum += a->data[j];
+      energy += a->data[j] * a->data[j];
+      max = (max > a->data[j]) ? max : a->data[j];
+      min = (min < a->data[j]) ? min : a->data[j];
+      peak = (peak > fabs(a->data[j])) ? peak : fabs(a->data[j]);
+    }
+    assert(fabs(fvec_sum(a) - sum) < 1.e-4);
+    assert(fabs(fvec_mean(a) - sum / length) < 1.e-4);
+    assert(fvec_max(a) == max);
+    assert(fvec_min(a) == min);
+    assert(fabs(aubio_level_lin(a) - energy / length) < 1.e-4);
+    aubio_frame_stats_do(a, -10., &stats);
+    assert(stats.level == aubio_level_lin(a));
+    assert(stats.db_spl == aubio_db_spl(a));
+    assert(fabs(stats.rms - sqrt(energy / length)) < 1.e-4);
+    assert(stats.peak == peak);
+    assert(stats.zcr == aubio_zero_crossing_rate(a));
+    assert(stats.silent == aubio_silence_detection(a, -10.));
+
+    fvec_weighted_copy(a, w, out);
+    for (j = 0; j < length; j++) {
+      assert(out->data[j] == a->data[j] * w->data[j]);
+    }
+    fvec_weight(out, w);
+    for (j = 0; j < length; j++) {
+      assert(out->data[j] == a->data[j] * w->data[j] * w->data[j]);
+    }
+
+    fvec_copy(w, out);
+    fvec_mul(out, 3.);
+    fvec_add(out, -1.);
+    for (j = 0; j < length; j++) {
+      assert(fabs(out->data[j] - (w->data[j] * 3. - 1.)) < 1.e-6);
+    }
+
+    fvec_copy(w, out);
+    fvec_pow(out, 2.);
+    for (j = 0; j < length; j++) {
+      assert(out->data[j] == w->data[j] * w->data[j]);
+    }
+    fvec_sqrt(out);
+    for (j = 0; j < length; j++) {
+      assert(fabs(out->data[j] - w->data[j]) < 1.e-6);
+    }
+
+    del_fvec(a);
+    del_fvec(w);
+    del_fvec(out);
+  }
+
+  // matrix-vector products, on heights that exercise the blocks of rows
+  for (length = 1; length < 40; length += 3) {
+    uint_t height, k;
+    for (height = 1; height < 11; height++) {
+      fmat_t *m = new_fmat(height, length);
+      fvec_t *x = new_fvec(length);
+      fvec_t *y = new_fvec(height);
+      assert(m && x && y);
+      for (j = 0; j < length; j++) {
+        x->data[j] = 0.25 * (smpl_t)(j % 9) - 1.;
+        for (k = 0; k < height; k++) {
+          m->data[k][j] = (smpl_t)((j + 3 * k) % 11) - 5.;
+        }
+      }
+      fmat_vecmul(m, x, y);
+      for (k = 0; k < height; k++) {
+        smpl_t expected = 0.;
+        for (j = 0; j < length; j++) {
+          expected += m->data[k][j] * x->data[j];
+        }
+        assert(fabs(y->data[k] - expected) < 1.e-4);
+      }
+      del_fmat(m);
+      del_fvec(x);
+      del_fvec(y);
+    }
+  }
+  return 0;
+}
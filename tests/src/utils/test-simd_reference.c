@@ -0,0 +1,734 @@
+#include <time.h>
+#include <aubio.h>
+#include "aubio_priv.h"
+#include "utils/simd_priv.h"
+#include "utils_tests.h"
+
+// differential test of the vector kernels: each kernel of each available
+// instruction set is run on random, wide-range and edge-case inputs of many
+// lengths, and compared to the scalar table. The largest and mean errors are
+// reported with the speedup over the scalar kernel, and the test fails if an
+// error goes above the tolerance of the kernel. The public functions using
+// the approximations of aubio_set_fast_math() are then compared to the
+// functions of the C library.
+
+// largest number of elements per input, plus room for the filters
+#define N_MAX 4099
+#define PAD 64
+#define BUF (N_MAX + PAD)
+// outputs of the sliding DFT: 16 bins of N_MAX power values, and its state
+#define OUT_MAX (20 * BUF)
+
+// tolerances, relative to the largest of 1, the reference value and the
+// magnitude of the terms summed to get it; the rounding errors of a sum grow
+// with its number of terms, by up to TOL_TERM each
+#if !HAVE_AUBIO_DOUBLE
+#define TOL_TERM 1.2e-7
+#define TOL_SUM 2.e-6
+#define TOL_APPROX 2.e-6
+#define TOL_RECURSIVE 1.e-4
+#define TOL_FAST 2.e-5
+#else
+#define TOL_TERM 2.3e-16
+#define TOL_SUM 1.e-14
+#define TOL_APPROX 1.e-12
+#define TOL_RECURSIVE 1.e-12
+#define TOL_FAST 1.e-11
+#endif
+
+// a value smaller than the smallest normal number
+#if !HAVE_AUBIO_DOUBLE
+#define SUBNORMAL 1.e-40
+#else
+#define SUBNORMAL 1.e-310
+#endif
+
+static smpl_t in_x[BUF], in_y[BUF];
+static smpl_t a_buf[BUF], b_buf[BUF], c_buf[BUF], d_buf[BUF];
+
+typedef uint_t (*runner_t) (const aubio_simd_ops_t *ops, uint_t n,
+    smpl_t *out, double *scale);
+
+typedef struct {
+  const char_t *name;
+  runner_t run;
+  double tol;
+  double tol_per_term;
+} kernel_t;
+
+static void copy (smpl_t *dst, const smpl_t *src, uint_t n)
+{
+  memcpy (dst, src, n * sizeof (smpl_t));
+}
+
+static void no_scale (double *scale, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < n; i++) scale[i] = 0.;
+}
+
+static uint_t run_weight (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  copy (out, in_x, n);
+  ops->weight (out, in_y, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_weighted_copy (const aubio_simd_ops_t *ops, uint_t n,
+    smpl_t *out, double *scale)
+{
+  ops->weighted_copy (in_x, in_y, out, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_mul (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  copy (out, in_x, n);
+  ops->mul (out, 1.7, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_add (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  copy (out, in_x, n);
+  ops->add (out, -.3, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_vsqrt (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  for (i = 0; i < n; i++) out[i] = ABS (in_x[i]);
+  ops->vsqrt (out, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_sum (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  out[0] = ops->sum (in_x, n);
+  scale[0] = 0.;
+  for (i = 0; i < n; i++) scale[0] += fabs (in_x[i]);
+  return 1;
+}
+
+static uint_t run_vmax (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  out[0] = ops->vmax (in_x, n);
+  out[1] = ops->vmin (in_x, n);
+  no_scale (scale, 2);
+  return 2;
+}
+
+static uint_t run_dot (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  out[0] = ops->dot (in_x, in_y, n);
+  scale[0] = 0.;
+  for (i = 0; i < n; i++) scale[0] += fabs ((double)in_x[i] * in_y[i]);
+  return 1;
+}
+
+static uint_t run_mvmul (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  const smpl_t *rows[5];
+  uint_t r, i, n_rows = 1 + n % 5;
+  // the rows are windows of y, one after the other in a_buf
+  n = MIN (n, (BUF - 1) / 5);
+  for (r = 0; r < n_rows; r++) {
+    smpl_t *row = a_buf + r * n;
+    for (i = 0; i < n; i++) row[i] = in_y[(i + 7 * r) % n];
+    rows[r] = row;
+  }
+  ops->mvmul (rows, in_x, out, n_rows, n);
+  for (r = 0; r < n_rows; r++) {
+    scale[r] = 0.;
+    for (i = 0; i < n; i++) scale[r] += fabs ((double)rows[r][i] * in_x[i]);
+  }
+  return n_rows;
+}
+
+static uint_t run_mmul (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  const smpl_t *a[3], *b[4];
+  smpl_t *c[3];
+  uint_t i, k, j, n_a = 1 + n % 3, n_b = 1 + n % 4;
+  n = MIN (n, (BUF - 1) / 4);
+  for (i = 0; i < n_a; i++) {
+    smpl_t *row = c_buf + i * n;
+    for (j = 0; j < n; j++) row[j] = in_x[(j + 5 * i) % n];
+    a[i] = row;
+    c[i] = out + i * n_b;
+  }
+  for (k = 0; k < n_b; k++) {
+    smpl_t *row = a_buf + k * n;
+    for (j = 0; j < n; j++) row[j] = in_y[(j + 7 * k) % n];
+    b[k] = row;
+  }
+  ops->mmul (a, b, c, n_a, n_b, n);
+  for (i = 0; i < n_a; i++) {
+    for (k = 0; k < n_b; k++) {
+      double s = 0.;
+      for (j = 0; j < n; j++) s += fabs ((double)a[i][j] * b[k][j]);
+      scale[i * n_b + k] = s;
+    }
+  }
+  return n_a * n_b;
+}
+
+static uint_t run_sqdiff (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t k, i, lag = n % 5, n_lags = 1 + n % 9;
+  ops->sqdiff (in_x, out, lag, n_lags, n);
+  for (k = 0; k < n_lags; k++) {
+    scale[k] = 0.;
+    for (i = 0; i < n; i++) {
+      double d = (double)in_x[i] - in_x[i + lag + k];
+      scale[k] += d * d;
+    }
+  }
+  return n_lags;
+}
+
+static uint_t run_ramp_dot (const aubio_simd_ops_t *ops, uint_t n,
+    smpl_t *out, double *scale)
+{
+  uint_t i;
+  out[0] = ops->ramp_dot (in_x, n);
+  scale[0] = 0.;
+  for (i = 0; i < n; i++) scale[0] += (i + 1.) * fabs (in_x[i]);
+  return 1;
+}
+
+static uint_t run_flux (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  copy (a_buf, in_y, n);
+  out[0] = ops->flux (in_x, a_buf, n);
+  copy (out + 1, a_buf, n);
+  no_scale (scale, n + 1);
+  for (i = 0; i < n; i++) scale[0] += fabs ((double)in_x[i] - in_y[i]);
+  return n + 1;
+}
+
+static uint_t run_sqdev (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  copy (a_buf, in_y, n);
+  ops->sqdev (in_x, a_buf, out, .1, n);
+  copy (out + n, a_buf, n);
+  no_scale (scale, 2 * n);
+  return 2 * n;
+}
+
+// spectral magnitudes are positive
+static void magnitudes (smpl_t *dst, const smpl_t *src, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < n; i++) dst[i] = ABS (src[i]);
+}
+
+static uint_t run_kl (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i, w;
+  magnitudes (b_buf, in_x, n);
+  for (w = 0; w < 2; w++) {
+    magnitudes (a_buf, in_y, n);
+    out[w] = ops->kl (b_buf, a_buf, w, n);
+    scale[w] = 0.;
+    for (i = 0; i < n; i++) {
+      double l = fabs (log (1. + b_buf[i] / (in_y[i] * (in_y[i] < 0 ? -1 : 1)
+              + .1)));
+      scale[w] += (w ? b_buf[i] : 1.) * (1. + l);
+    }
+  }
+  return 2;
+}
+
+static uint_t run_vlog (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  // finite and positive
+  for (i = 0; i < n; i++) out[i] = in_x[i] != 0. ? ABS (in_x[i]) : 1.;
+  ops->vlog (out, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_whiten (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t w;
+  for (w = 0; w < 2; w++) {
+    magnitudes (out + w * 2 * n, in_x, n);
+    magnitudes (out + w * 2 * n + n, in_y, n);
+    ops->whiten (out + w * 2 * n, out + w * 2 * n + n, .97, 1.e-4,
+        w ? 10. : 0., n);
+  }
+  no_scale (scale, 4 * n);
+  return 4 * n;
+}
+
+static uint_t run_vexp (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  // within the range of the approximation, up to +/- 80
+  for (i = 0; i < n; i++) {
+    out[i] = ABS (in_x[i]) < 1. ? 80. * in_x[i] : 80. / in_x[i];
+  }
+  ops->vexp (out, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_vatan2 (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  ops->vatan2 (in_y, in_x, out, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_vhypot (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  ops->vhypot (in_x, in_y, out, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static uint_t run_rect (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i;
+  // phases within the range of the approximation, up to +/- 100
+  for (i = 0; i < n; i++) {
+    a_buf[i] = ABS (in_y[i]) < 1. ? 100. * in_y[i] : 100. / in_y[i];
+  }
+  ops->rect (in_x, a_buf, out, out + n, n);
+  for (i = 0; i < 2 * n; i++) scale[i] = fabs (in_x[i % n]);
+  return 2 * n;
+}
+
+static uint_t run_tss (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i, f, blocks = (n + AUBIO_SIMD_TSS_BLOCK - 1) / AUBIO_SIMD_TSS_BLOCK;
+  smpl_t *state = c_buf, *phas = a_buf;
+  if (4 * blocks * AUBIO_SIMD_TSS_BLOCK > BUF) n = BUF / 8;
+  blocks = (n + AUBIO_SIMD_TSS_BLOCK - 1) / AUBIO_SIMD_TSS_BLOCK;
+  for (i = 0; i < blocks * AUBIO_SIMD_TSS_BLOCK; i++) {
+    smpl_t *t1 = state + 4 * (i / AUBIO_SIMD_TSS_BLOCK * AUBIO_SIMD_TSS_BLOCK)
+      + i % AUBIO_SIMD_TSS_BLOCK;
+    t1[0] = i < n ? PI * in_y[i] / (1. + ABS (in_y[i])) : 0.;
+    t1[AUBIO_SIMD_TSS_BLOCK] = 0.;
+    t1[2 * AUBIO_SIMD_TSS_BLOCK] = 1.;
+    t1[3 * AUBIO_SIMD_TSS_BLOCK] = 1.;
+  }
+  // three frames of phases between -pi and pi
+  for (f = 0; f < 3; f++) {
+    for (i = 0; i < n; i++) {
+      phas[i] = PI * in_x[(i + 13 * f) % n] / (1. + ABS (in_x[(i + 13 * f) % n]));
+    }
+    magnitudes (b_buf, in_y, n);
+    ops->tss (b_buf, phas, state, out + 2 * f * n, out + (2 * f + 1) * n,
+        .5 * PI, 1.5, n);
+  }
+  no_scale (scale, 6 * n);
+  return 6 * n;
+}
+
+static uint_t run_sym_fir (const aubio_simd_ops_t *ops, uint_t n,
+    smpl_t *out, double *scale)
+{
+  uint_t i, k, half = 1 + n % 8, last = 2 * half - 1;
+  for (k = 0; k < half; k++) d_buf[k] = in_y[k % n] / (k + 1.);
+  ops->sym_fir (in_x, d_buf, half, out, n);
+  for (i = 0; i < n; i++) {
+    scale[i] = 0.;
+    for (k = 0; k < half; k++) {
+      scale[i] += fabs (d_buf[k]) * (fabs (in_x[i + k])
+          + fabs (in_x[i + last - k]));
+    }
+  }
+  return n;
+}
+
+// a bank of voices reading a table of 64 samples, with slowly changing
+// increments and amplitudes
+static uint_t run_osc (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i, v, len = 64, n_voices = AUBIO_SIMD_OSC_BLOCK * (1 + n % 2);
+  smpl_t *table = d_buf, *offset = a_buf, *pos = offset + n_voices;
+  smpl_t *inc = pos + n_voices, *dinc = inc + n_voices;
+  smpl_t *amp = dinc + n_voices, *damp = amp + n_voices;
+  for (i = 0; i < len; i++) table[i] = in_x[i % n] / (1. + ABS (in_x[i % n]));
+  table[len] = table[0];
+  table[len + 1] = table[1];
+  for (v = 0; v < n_voices; v++) {
+    smpl_t y = in_y[v % n] / (1. + ABS (in_y[v % n]));
+    offset[v] = 0.;
+    pos[v] = len * ABS (y) * .99;
+    inc[v] = 1. + 3. * ABS (y);
+    dinc[v] = 1.e-4 * y;
+    amp[v] = ABS (y);
+    damp[v] = -1.e-5 * ABS (y);
+  }
+  for (i = 0; i < n; i++) out[i] = 0.;
+  ops->osc (table, len, offset, pos, inc, dinc, amp, damp, n_voices, out, n);
+  copy (out + n, pos, n_voices);
+  no_scale (scale, n + n_voices);
+  for (i = 0; i < n; i++) scale[i] = n_voices;
+  // positions near the wrapping point may wrap on one side only
+  for (v = 0; v < n_voices; v++) scale[n + v] = len;
+  return n + n_voices;
+}
+
+static uint_t run_cmac (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i, m = (n + 1) / 2;
+  for (i = 0; i < 2 * m; i++) {
+    a_buf[i] = in_x[i % n];
+    b_buf[i] = in_y[(i + 3) % n];
+    out[i] = in_x[(i + 5) % n];
+  }
+  ops->cmac (a_buf, b_buf, out, m);
+  for (i = 0; i < m; i++) {
+    double s = fabs (a_buf[i]) + fabs (a_buf[m + i]);
+    s *= fabs (b_buf[i]) + fabs (b_buf[m + i]);
+    scale[i] = scale[m + i] = s + fabs (in_x[(i + 5) % n])
+      + fabs (in_x[(m + i + 5) % n]);
+  }
+  return 2 * m;
+}
+
+// 16 bins of a sliding DFT of 64 samples, slightly damped
+static uint_t run_sdft (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t k, i, n_bins = AUBIO_SIMD_SDFT_BLOCK;
+  smpl_t coefs[4 * AUBIO_SIMD_SDFT_BLOCK], state[2 * AUBIO_SIMD_SDFT_BLOCK];
+  smpl_t *power[AUBIO_SIMD_SDFT_BLOCK];
+  double r = .999;
+  for (k = 0; k < n_bins; k++) {
+    double w = 2. * PI * k / 64.;
+    coefs[k] = r * cos (w);
+    coefs[n_bins + k] = r * sin (w);
+    coefs[2 * n_bins + k] = pow (r, 64.);
+    coefs[3 * n_bins + k] = 0.;
+    state[k] = state[n_bins + k] = 0.;
+    power[k] = out + k * n;
+  }
+  for (i = 0; i < n; i++) a_buf[i] = i < 64 ? 0. : in_x[i - 64];
+  ops->sdft (in_x, a_buf, n, coefs, state, n_bins, power);
+  copy (out + n_bins * n, state, 2 * n_bins);
+  // the bins sum the last 64 samples
+  for (i = 0; i < n; i++) {
+    double s = 0.;
+    for (k = i < 63 ? 0 : i - 63; k <= i; k++) s += fabs (in_x[k]);
+    for (k = 0; k < n_bins; k++) scale[k * n + i] = s * s;
+    if (i == n - 1) {
+      for (k = 0; k < 2 * n_bins; k++) scale[n_bins * n + k] = s;
+    }
+  }
+  return n_bins * n + 2 * n_bins;
+}
+
+static uint_t run_stats (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t i, crossings;
+  ops->stats (in_x, n, out, out + 1, &crossings);
+  out[2] = crossings;
+  no_scale (scale, 3);
+  for (i = 0; i < n; i++) scale[0] += (double)in_x[i] * in_x[i];
+  return 3;
+}
+
+static uint_t run_peaks (const aubio_simd_ops_t *ops, uint_t n, smpl_t *out,
+    double *scale)
+{
+  uint_t count = ops->peaks (in_x, n % 3, n, 0., out + 1, BUF - 1);
+  out[0] = count;
+  no_scale (scale, count + 1);
+  return count + 1;
+}
+
+static uint_t run_maxfilt (const aubio_simd_ops_t *ops, uint_t n,
+    smpl_t *out, double *scale)
+{
+  uint_t r = 1 + n % 7;
+  ops->maxfilt (in_x, out, OUT_MAX - BUF >= 2 * (n + 2 * r) ? out + BUF
+      : a_buf, r, n);
+  no_scale (scale, n);
+  return n;
+}
+
+static const kernel_t kernels[] = {
+  { "weight", run_weight, 0., 0. },
+  { "weighted_copy", run_weighted_copy, 0., 0. },
+  { "mul", run_mul, 0., 0. },
+  { "add", run_add, 0., 0. },
+  { "vsqrt", run_vsqrt, 0., 0. },
+  { "sum", run_sum, TOL_SUM, TOL_TERM },
+  { "vmax/vmin", run_vmax, 0., 0. },
+  { "dot", run_dot, TOL_SUM, TOL_TERM },
+  { "mvmul", run_mvmul, TOL_SUM, TOL_TERM },
+  { "mmul", run_mmul, TOL_SUM, TOL_TERM },
+  { "sqdiff", run_sqdiff, TOL_SUM, TOL_TERM },
+  { "ramp_dot", run_ramp_dot, TOL_SUM, TOL_TERM },
+  { "flux", run_flux, TOL_SUM, TOL_TERM },
+  { "sqdev", run_sqdev, TOL_SUM, 0. },
+  { "kl", run_kl, TOL_APPROX, TOL_TERM },
+  { "vlog", run_vlog, TOL_APPROX, 0. },
+  { "whiten", run_whiten, TOL_APPROX, 0. },
+  { "vexp", run_vexp, TOL_APPROX, 0. },
+  { "vatan2", run_vatan2, TOL_APPROX, 0. },
+  { "vhypot", run_vhypot, 0., 0. },
+  { "rect", run_rect, TOL_APPROX, 0. },
+  { "tss", run_tss, 0., 0. },
+  { "sym_fir", run_sym_fir, TOL_SUM, TOL_TERM },
+  { "osc", run_osc, TOL_RECURSIVE, 0. },
+  { "cmac", run_cmac, TOL_SUM, TOL_TERM },
+  { "sdft", run_sdft, TOL_RECURSIVE, 0. },
+  { "stats", run_stats, TOL_SUM, TOL_TERM },
+  { "peaks", run_peaks, 0., 0. },
+  { "maxfilt", run_maxfilt, 0., 0. },
+};
+
+#define N_KERNELS (sizeof (kernels) / sizeof (kernels[0]))
+
+// inputs of each kind, with PAD more samples than n
+static void fill (uint_t kind, uint_t n)
+{
+  static const smpl_t edges[] = { 0., -0., 1., -1., SUBNORMAL, -SUBNORMAL,
+    1.e15, -1.e15, .5, .5, .5, -2., 3., 3., 1.e-15, -1.e-15 };
+  uint_t i;
+  for (i = 0; i < n + PAD; i++) {
+    smpl_t u = (random () % 20001 - 10000) / 10000.;
+    smpl_t v = (random () % 20001 - 10000) / 10000.;
+    switch (kind) {
+      case 0: // uniform between -1 and 1
+        in_x[i] = u;
+        in_y[i] = v;
+        break;
+      case 1: // from 1.e-15 to 1.e15, either sign
+        in_x[i] = (u < 0 ? -1. : 1.) * pow (10., 15. * v);
+        in_y[i] = (v < 0 ? -1. : 1.) * pow (10., 15. * u);
+        break;
+      default: // zeros, subnormals, large values and ties
+        in_x[i] = edges[(i * 7) % (sizeof (edges) / sizeof (edges[0]))];
+        in_y[i] = edges[(i * 5 + 3) % (sizeof (edges) / sizeof (edges[0]))];
+        break;
+    }
+  }
+}
+
+static double error_of (double out, double ref, double scale)
+{
+  double norm;
+  if (out == ref || (isnan (out) && isnan (ref))) return 0.;
+  if (isnan (out) || isnan (ref) || isinf (out) || isinf (ref)) return 1.e30;
+  norm = MAX (1., MAX (fabs (ref), scale));
+  return fabs (out - ref) / norm;
+}
+
+// time of one call on n samples, in seconds, repeated for at least 2ms
+static double time_of (const kernel_t *k, const aubio_simd_ops_t *ops,
+    uint_t n, smpl_t *out, double *scale)
+{
+  uint_t i, reps = 1;
+  clock_t start, elapsed;
+  for (;;) {
+    start = clock ();
+    for (i = 0; i < reps; i++) k->run (ops, n, out, scale);
+    elapsed = clock () - start;
+    if (elapsed > CLOCKS_PER_SEC / 500 || reps > (1u << 20)) break;
+    reps *= 2;
+  }
+  return (double)elapsed / CLOCKS_PER_SEC / reps;
+}
+
+static uint_t check_kernel (const kernel_t *k, const aubio_simd_ops_t *ops,
+    smpl_t *ref, smpl_t *out, double *scale)
+{
+  uint_t lengths[] = { 127, 128, 1024, N_MAX };
+  uint_t kind, n, l, i, n_ref, n_out, count = 0, err = 0;
+  double max_err = 0., sum_err = 0., t_ref, t_ops, tol;
+  for (kind = 0; kind < 3; kind++) {
+    for (l = 0; l < 69 + sizeof (lengths) / sizeof (lengths[0]); l++) {
+      n = l < 69 ? l + 1 : lengths[l - 69];
+      fill (kind, n);
+      n_ref = k->run (aubio_simd_scalar_ops (), n, ref, scale);
+      n_out = k->run (ops, n, out, scale);
+      if (n_out != n_ref) {
+        PRINT_MSG ("%s %s: %d outputs on %d samples, expected %d\n",
+            ops->name, k->name, n_out, n, n_ref);
+        return 1;
+      }
+      tol = k->tol + n * k->tol_per_term;
+      for (i = 0; i < n_out; i++) {
+        double e = error_of (out[i], ref[i], scale[i]);
+        if (e > tol && !err) {
+          PRINT_MSG ("%s %s: output %d on %d samples of kind %d is %.17g,"
+              " expected %.17g\n", ops->name, k->name, i, n, kind,
+              (double)out[i], (double)ref[i]);
+          err = 1;
+        }
+        max_err = MAX (max_err, e);
+        sum_err += e;
+        count++;
+      }
+    }
+  }
+  fill (0, N_MAX);
+  t_ref = time_of (k, aubio_simd_scalar_ops (), N_MAX, ref, scale);
+  t_ops = time_of (k, ops, N_MAX, out, scale);
+  PRINT_MSG ("%-7s %-14s max error %-10.3g mean error %-10.3g speedup %.2fx\n",
+      ops->name, k->name, max_err, sum_err / count,
+      t_ops > 0. ? t_ref / t_ops : 0.);
+  return err;
+}
+
+// an empty value selects the default table
+static void set_isa (const char_t *isa)
+{
+#ifdef _WIN32
+  _putenv_s("AUBIO_SIMD", isa);
+#else
+  setenv("AUBIO_SIMD", isa, 1);
+#endif
+}
+
+// the public functions with and without fast math, compared to the C
+// library through the scalar table
+static uint_t check_fast_math (const char_t *isa)
+{
+  uint_t n = 1023, win = 1024, i, err = 0;
+  fvec_t *x = new_fvec (n), *y = new_fvec (n), *frame = new_fvec (win);
+  cvec_t *spec = new_cvec (n), *ref_spec = new_cvec (win);
+  cvec_t *fft_out = new_cvec (win);
+  aubio_fft_t *fft = new_aubio_fft (win);
+  fvec_t *ref_frame = new_fvec (win), *fft_frame = new_fvec (win);
+  double e[5] = { 0., 0., 0., 0., 0. };
+  const char_t *names[5] = { "fvec_exp", "fvec_pow", "cvec_logmag",
+    "fft phase", "fft inverse" };
+  if (!x || !y || !frame || !spec || !ref_spec || !fft_out || !fft
+      || !ref_frame || !fft_frame) return 1;
+  fill (1, win);
+  for (i = 0; i < win; i++) frame->data[i] = in_x[i] / 1.e15;
+
+  // the references, without fast math
+  set_isa ("scalar");
+  aubio_simd_init ();
+  aubio_set_fast_math (0);
+  aubio_fft_do (fft, frame, ref_spec);
+  aubio_fft_rdo (fft, ref_spec, ref_frame);
+
+  set_isa (isa);
+  if (strcmp (aubio_simd_init ()->name, isa) != 0) goto beach;
+  aubio_set_fast_math (1);
+  for (i = 0; i < n; i++) x->data[i] = 80. * in_y[i] / 1.e15;
+  fvec_exp (x);
+  for (i = 0; i < n; i++) {
+    smpl_t ref = EXP (80. * in_y[i] / 1.e15);
+    e[0] = MAX (e[0], fabs (x->data[i] / ref - 1.));
+  }
+  for (i = 0; i < n; i++) y->data[i] = fabs (in_x[i] / 1.e10) + 1.e-3;
+  fvec_pow (y, 1.5);
+  for (i = 0; i < n; i++) {
+    smpl_t ref = POW (fabs (in_x[i] / 1.e10) + 1.e-3, 1.5);
+    e[1] = MAX (e[1], error_of (y->data[i], ref, 0.));
+  }
+  for (i = 0; i < spec->length; i++) spec->norm[i] = fabs (in_y[i] / 1.e15);
+  cvec_logmag (spec, 10.);
+  for (i = 0; i < spec->length; i++) {
+    smpl_t ref = LOG (10. * fabs (in_y[i] / 1.e15) + 1.);
+    e[2] = MAX (e[2], error_of (spec->norm[i], ref, 0.));
+  }
+  aubio_fft_do (fft, frame, fft_out);
+  for (i = 0; i < fft_out->length; i++) {
+    // the phases of bins of no energy are not defined
+    double d = fabs (fft_out->phas[i] - ref_spec->phas[i]);
+    if (ref_spec->norm[i] < 1.e-6 * win) continue;
+    e[3] = MAX (e[3], MIN (d, 2. * PI - d));
+  }
+  aubio_fft_rdo (fft, ref_spec, fft_frame);
+  for (i = 0; i < win; i++) {
+    e[4] = MAX (e[4], error_of (fft_frame->data[i], ref_frame->data[i], 0.));
+  }
+  for (i = 0; i < 5; i++) {
+    PRINT_MSG ("%-7s %-14s fast math error %.3g\n", isa, names[i], e[i]);
+    if (e[i] > TOL_FAST) err = 1;
+  }
+
+beach:
+  aubio_set_fast_math (0);
+  del_fvec (x);
+  del_fvec (y);
+  del_fvec (frame);
+  del_fvec (ref_frame);
+  del_fvec (fft_frame);
+  del_cvec (spec);
+  del_cvec (ref_spec);
+  del_cvec (fft_out);
+  del_aubio_fft (fft);
+  return err;
+}
+
+int main (void)
+{
+  const char_t *isas[] = { "scalar", "sse2", "avx2", "avx512", "neon",
+    "wasm" };
+  const aubio_simd_ops_t *ops;
+  smpl_t *ref = (smpl_t *)malloc (OUT_MAX * sizeof (smpl_t));
+  smpl_t *out = (smpl_t *)malloc (OUT_MAX * sizeof (smpl_t));
+  double *scale = (double *)malloc (OUT_MAX * sizeof (double));
+  uint_t i, k, err = 0;
+  if (!ref || !out || !scale) return 1;
+  for (i = 0; i < sizeof (isas) / sizeof (isas[0]); i++) {
+    set_isa (isas[i]);
+    // unsupported instruction sets fall back to the default table
+    ops = aubio_simd_init ();
+    if (strcmp (ops->name, isas[i]) != 0) continue;
+    for (k = 0; k < N_KERNELS; k++) {
+      if (i > 0 && check_kernel (&kernels[k], ops, ref, out, scale)) {
+        PRINT_ERR ("%s: %s differs from the scalar kernel\n", ops->name,
+            kernels[k].name);
+        err = 1;
+      }
+    }
+    if (check_fast_math (isas[i])) {
+      PRINT_ERR ("%s: fast math differs from the C library\n", isas[i]);
+      err = 1;
+    }
+  }
+  set_isa ("");
+  aubio_simd_init ();
+  free (ref);
+  free (out);
+  free (scale);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,153 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// encode the spectra of a gliding tone, decode each frame as a client
+// would, and check the codes match those of the encoder while the frames
+// stay smaller than the key frames
+
+#define WIN_S 1024
+#define HOP_S 256
+#define N_BINS 64
+#define N_FRAMES 200
+
+static uint_t stream (uint_t tolerance, uint_t *n_keys)
+{
+  aubio_pvoc_t *pv = new_aubio_pvoc (WIN_S, HOP_S);
+  aubio_specenc_t *o = new_aubio_specenc (WIN_S / 2 + 1, N_BINS);
+  fvec_t *in = new_fvec (HOP_S);
+  cvec_t *spectrum = new_cvec (WIN_S);
+  u8_t frame[N_BINS + AUBIO_SPECENC_HEADER], client[N_BINS];
+  uint_t n, i, size, total = 0;
+  double phase = 0.;
+  if (!pv || !o || !in || !spectrum) return 0;
+  if (aubio_specenc_get_max_size (o) != N_BINS + AUBIO_SPECENC_HEADER)
+    return 0;
+  aubio_specenc_set_log_bins (o, 1);
+  aubio_specenc_set_range (o, -30., 70.);
+  aubio_specenc_set_tolerance (o, tolerance);
+  srandom (1);
+  *n_keys = 0;
+  for (n = 0; n < N_FRAMES; n++) {
+    for (i = 0; i < HOP_S; i++) {
+      smpl_t noise = (random () % 2001 - 1000) / 1000.;
+      // a gliding tone over some noise, with a burst every 40 frames
+      phase += 2. * M_PI * (440. + 220. * n / N_FRAMES) / 44100.;
+      in->data[i] = .5 * sin (phase) + (n % 40 < 3 ? .3 : 1.e-4) * noise;
+    }
+    aubio_pvoc_do (pv, in, spectrum);
+    size = aubio_specenc_do_spectrum (o, spectrum, frame);
+    if (size < AUBIO_SPECENC_HEADER || size > aubio_specenc_get_max_size (o)
+        || frame[1] + 256u * frame[2] != n) return 0;
+    if (frame[0] == AUBIO_SPECENC_KEY) (*n_keys)++;
+    else if (n == 0) return 0;
+    // the client holds the codes of the encoder
+    if (aubio_specenc_decode (frame, size, client, N_BINS) != 0
+        || memcmp (client, aubio_specenc_get_levels (o), N_BINS) != 0)
+      return 0;
+    total += size;
+  }
+
+  // a key frame every 10 frames, and empty delta frames in between
+  aubio_specenc_set_keyframe_interval (o, 10);
+  aubio_specenc_reset (o);
+  for (n = 0, i = 0; n < 30; n++) {
+    size = aubio_specenc_do_spectrum (o, spectrum, frame);
+    if (frame[0] == AUBIO_SPECENC_KEY) i++;
+    else if (size != AUBIO_SPECENC_HEADER) return 0;
+  }
+  if (i != 3) return 0;
+
+  del_aubio_pvoc (pv);
+  del_aubio_specenc (o);
+  del_fvec (in);
+  del_cvec (spectrum);
+  return total;
+}
+
+static uint_t check_stream (void)
+{
+  uint_t size = N_FRAMES * (N_BINS + AUBIO_SPECENC_HEADER);
+  uint_t exact_keys, coarse_keys;
+  uint_t exact = stream (0, &exact_keys), coarse = stream (2, &coarse_keys);
+  PRINT_MSG ("%d frames of %d bytes: %d bytes, %d key frames, tolerance 0\n",
+      N_FRAMES, N_BINS + AUBIO_SPECENC_HEADER, exact, exact_keys);
+  PRINT_MSG ("%d frames of %d bytes: %d bytes, %d key frames, tolerance 2\n",
+      N_FRAMES, N_BINS + AUBIO_SPECENC_HEADER, coarse, coarse_keys);
+  if (exact == 0 || exact >= size || coarse == 0 || coarse >= exact)
+    return 1;
+  return 0;
+}
+
+static uint_t check_decode (void)
+{
+  u8_t levels[3] = { 10, 10, 10 };
+  u8_t ok[] = { AUBIO_SPECENC_DELTA, 0, 0, 0x1f, 0x84, 0x00 };
+  u8_t bad[][6] = {
+    { AUBIO_SPECENC_DELTA, 0, 0, 0x1f, 0x81, 0 },  // escape cut short
+    { AUBIO_SPECENC_DELTA, 0, 0, 0x1f, 0x01, 0 },  // nibble of a 4th band
+    { AUBIO_SPECENC_KEY, 0, 0, 1, 2, 0 },          // key frame too long
+    { 7, 0, 0, 0, 0, 0 },                          // unknown type
+  };
+  uint_t k, err = 0;
+  // +1, -1, then +64 through an escape
+  if (aubio_specenc_decode (ok, sizeof (ok), levels, 3) != 0
+      || levels[0] != 11 || levels[1] != 9 || levels[2] != 74) err = 1;
+  // the bands after the last nibble are unchanged
+  ok[3] = 0x30;
+  if (aubio_specenc_decode (ok, 4, levels, 3) != 0
+      || levels[0] != 14 || levels[1] != 9 || levels[2] != 74) err = 1;
+  if (aubio_specenc_decode (ok, sizeof (ok) - 1, levels, 3) == 0) err = 1;
+  if (aubio_specenc_decode (ok, 2, levels, 3) == 0) err = 1;
+  for (k = 0; k < sizeof (bad) / sizeof (bad[0]); k++) {
+    if (aubio_specenc_decode (bad[k], 5, levels, 3) == 0) err = 1;
+  }
+  return err;
+}
+
+static uint_t check_bands (void)
+{
+  aubio_specenc_t *o = new_aubio_specenc (40, 10);
+  fvec_t *bands = new_fvec (40), *wrong = new_fvec (39);
+  fvec_t *decoded = new_fvec (10);
+  u8_t frame[10 + AUBIO_SPECENC_HEADER];
+  uint_t k, err = 0;
+  if (!o || !bands || !wrong || !decoded) return 1;
+  if (new_aubio_specenc (40, 41) || new_aubio_specenc (40, 0)) err = 1;
+  if (aubio_specenc_set_range (o, 0., 0.) == 0) err = 1;
+  // the loudest bin of each group of 4 sets its level
+  fvec_set_all (bands, 1.e-10);
+  for (k = 0; k < 10; k++) {
+    bands->data[4 * k + k % 4] = pow (10., k - 8.);
+  }
+  if (aubio_specenc_do (o, wrong, frame) != 0) err = 1;
+  if (aubio_specenc_do (o, bands, frame) != 10 + AUBIO_SPECENC_HEADER)
+    err = 1;
+  aubio_dequantize_u8 (aubio_specenc_get_levels (o), -100., 20., decoded);
+  for (k = 0; k < 10; k++) {
+    if (fabs (decoded->data[k] - 10. * (k - 8.)) > .3) err = 1;
+  }
+  // unchanged bands only cost a header
+  if (aubio_specenc_do (o, bands, frame) != AUBIO_SPECENC_HEADER
+      || frame[0] != AUBIO_SPECENC_DELTA) err = 1;
+  // a band 3 dB louder, 6 or 7 codes, fits in a single byte
+  bands->data[0] *= 2.;
+  if (aubio_specenc_do (o, bands, frame) != 1 + AUBIO_SPECENC_HEADER
+      || (frame[3] >> 4) < 6 || (frame[3] >> 4) > 7 || (frame[3] & 0xf))
+    err = 1;
+  del_aubio_specenc (o);
+  del_fvec (bands);
+  del_fvec (wrong);
+  del_fvec (decoded);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  if (check_stream ()) err = 1;
+  if (check_bands ()) err = 1;
+  if (check_decode ()) err = 1;
+  if (err) PRINT_ERR ("decoded frames differ from the encoded levels\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,101 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// run an onset detector and a tempo tracker, and check the calls counted for
+// them and the functions they use. Without the profiling build option, no
+// function is found.
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define N_HOPS 200
+#define MAX_STATS 64
+
+static aubio_stats_t stats[MAX_STATS];
+
+static const aubio_stats_t *find (const char_t *name)
+{
+  uint_t i, n = aubio_stats_get (stats, MAX_STATS);
+  for (i = 0; i < n && i < MAX_STATS; i++) {
+    if (strcmp (stats[i].name, name) == 0) return &stats[i];
+  }
+  return NULL;
+}
+
+static uint_t check_calls (const char_t *name, unsigned long long calls)
+{
+  const aubio_stats_t *s = find (name);
+  if (!s) {
+    PRINT_ERR("%s not found\n", name);
+    return 1;
+  }
+  PRINT_MSG("%-12s %6llu calls, %10llu cycles, max %8llu\n", s->name,
+      s->calls, s->cycles, s->max_cycles);
+  if (s->calls != calls || s->max_cycles > s->cycles) {
+    PRINT_ERR("%s: %llu calls, expected %llu\n", name, s->calls, calls);
+    return 1;
+  }
+  if (calls && s->max_cycles == 0) {
+    PRINT_ERR("%s: no time was counted\n", name);
+    return 1;
+  }
+  return 0;
+}
+
+int main (void)
+{
+  aubio_onset_t *onset = new_aubio_onset ("default", WIN, HOP, SR);
+  aubio_tempo_t *tempo = new_aubio_tempo ("default", WIN, HOP, SR);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (2);
+  const aubio_stats_t *pvoc, *s;
+  uint_t i, j, err = 0;
+
+  if (!onset || !tempo || !in || !out) return 1;
+  for (i = 0; i < N_HOPS; i++) {
+    for (j = 0; j < HOP; j++) {
+      in->data[j] = ((i * HOP + j) * 7919 % 101 - 50) / 100.;
+    }
+    aubio_onset_do (onset, in, out);
+  }
+
+  if (!aubio_stats_enabled ()) {
+    PRINT_MSG("aubio was built without profiling\n");
+    if (aubio_stats_get (stats, MAX_STATS) != 0) err = 1;
+    goto beach;
+  }
+
+  err |= check_calls ("onset", N_HOPS);
+  err |= check_calls ("pvoc", N_HOPS);
+  err |= check_calls ("fft forward", N_HOPS);
+  err |= check_calls ("specdesc", N_HOPS);
+  // the onset time includes the phase vocoder
+  pvoc = find ("pvoc");
+  s = find ("onset");
+  if (pvoc && s && s->cycles < pvoc->cycles) {
+    PRINT_ERR("onset took less time than its phase vocoder\n");
+    err = 1;
+  }
+  // only the counted values are kept
+  if (aubio_stats_get (NULL, 0) < 4 || aubio_stats_get (stats, 1) < 4) {
+    err = 1;
+  }
+
+  aubio_stats_reset ();
+  err |= check_calls ("onset", 0);
+  for (i = 0; i < 3 * N_HOPS; i++) {
+    aubio_tempo_do (tempo, in, out);
+  }
+  err |= check_calls ("onset", 0);
+  err |= check_calls ("tempo", 3 * N_HOPS);
+  err |= check_calls ("pvoc", 3 * N_HOPS);
+  // at this hop size, the beats are tracked every 256 blocks
+  err |= check_calls ("beattracking", 3 * N_HOPS / 256);
+
+beach:
+  del_aubio_onset (onset);
+  del_aubio_tempo (tempo);
+  del_fvec (in);
+  del_fvec (out);
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,122 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <aubio.h>
+#include "utils_tests.h"
+#if defined(__linux__)
+#include <sched.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// the threads started by aubio take the affinity and priority of their
+// role, and the objects start as many workers as the pool size by default
+
+#define HOP 64
+
+typedef struct {
+  uint_t calls;
+  sint_t n_cpus;    // processors allowed to the worker, -1 if unknown
+} worker_t;
+
+static void sleep_ms (uint_t ms)
+{
+#ifdef _WIN32
+  Sleep(ms);
+#else
+  usleep(ms * 1000);
+#endif
+}
+
+static void count_cpus (void *data, fvec_t *input, fvec_t *output)
+{
+  worker_t *w = (worker_t *)data;
+#if defined(__linux__)
+  cpu_set_t set;
+  if (sched_getaffinity (0, sizeof (set), &set) == 0) {
+    w->n_cpus = CPU_COUNT (&set);
+  }
+#endif
+  (void)input; (void)output;
+  w->calls++;
+}
+
+static uint_t run_stream (worker_t *w)
+{
+  aubio_rthost_t *o = new_aubio_rthost (HOP, 1, count_cpus, w);
+  fvec_t *in = new_fvec (HOP), *out = new_fvec (HOP);
+  uint_t i;
+  if (!o || !in || !out) return 1;
+  w->calls = 0;
+  w->n_cpus = -1;
+  for (i = 0; i < 20; i++) {
+    aubio_rthost_do (o, in, out);
+    sleep_ms (1);
+  }
+  del_aubio_rthost (o);
+  del_fvec (in);
+  del_fvec (out);
+  return w->calls == 0;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  worker_t w;
+  aubio_batch_t *batch;
+  u64_t first = 0;
+
+  // unknown roles and priorities are refused
+  if (aubio_threads_set_affinity (AUBIO_THREAD_N_ROLES, 1) == 0) err = 1;
+  if (aubio_threads_set_priority (AUBIO_THREAD_IO, 100) == 0) err = 1;
+
+  // the default pool follows the processors given to the workers
+  aubio_threads_set_pool_size (3);
+  if (aubio_threads_get_pool_size () != 3) err = 1;
+  batch = new_aubio_batch ("onset", "default", 1024, 512, 0);
+  if (!batch || aubio_batch_get_threads (batch) != 3) err = 1;
+  aubio_batch_set_threads (batch, 2);
+  aubio_batch_set_threads (batch, 0);
+  if (aubio_batch_get_threads (batch) != 3) err = 1;
+  if (batch) del_aubio_batch (batch);
+  aubio_threads_set_pool_size (0);
+
+  if (run_stream (&w)) err = 1;
+  PRINT_MSG ("default: worker allowed on %d processors\n", w.n_cpus);
+
+#if defined(__linux__)
+  {
+    // pin the worker to the first processor allowed to this process
+    cpu_set_t set;
+    uint_t i;
+    if (sched_getaffinity (0, sizeof (set), &set) == 0) {
+      for (i = 0; i < 64 && !first; i++) {
+        if (CPU_ISSET (i, &set)) first = (u64_t)1 << i;
+      }
+    }
+  }
+#endif
+  if (first && aubio_threads_set_affinity (AUBIO_THREAD_STREAM, first) == 0) {
+    if (aubio_threads_get_affinity (AUBIO_THREAD_STREAM) != first) err = 1;
+    if (run_stream (&w)) err = 1;
+    PRINT_MSG ("pinned: worker allowed on %d processors\n", w.n_cpus);
+    if (w.n_cpus != -1 && w.n_cpus != 1) err = 1;
+    // the other roles are left alone
+    if (aubio_threads_get_affinity (AUBIO_THREAD_WORKER) != 0) err = 1;
+    aubio_threads_set_affinity (AUBIO_THREAD_STREAM, 0);
+  }
+  aubio_threads_set_affinity (AUBIO_THREAD_WORKER, 0x6);
+  if (aubio_threads_get_pool_size () != 2) err = 1;
+  aubio_threads_set_affinity (AUBIO_THREAD_WORKER, 0);
+
+  // without the permission to use it, a real-time priority is only
+  // reported, and the thread still runs
+  if (aubio_threads_set_priority (AUBIO_THREAD_STREAM, 50) != 0
+      || aubio_threads_get_priority (AUBIO_THREAD_STREAM) != 50) err = 1;
+  if (run_stream (&w)) err = 1;
+  aubio_threads_set_priority (AUBIO_THREAD_STREAM, 0);
+
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,174 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// build overviews of a signal added in hops of various sizes, compare each
+// level to the values computed from the whole signal, then save and read
+// them back
+
+#define PATH "tmp_aubio_waveform.feat"
+#define N_FRAMES 100003
+#define BLOCK 64
+
+// compare each block of each level to the signal, starting at frame 0
+static uint_t check_levels (const aubio_waveform_t *o, const fmat_t *signal,
+    uint_t n_frames, smpl_t tolerance)
+{
+  uint_t k, i, c, j, err = 0;
+  uint_t n_levels = aubio_waveform_get_n_levels (o);
+  for (k = 0; k < n_levels; k++) {
+    const fmat_t *l = aubio_waveform_get_level (o, k);
+    uint_t span = BLOCK << k;
+    if (l->height != 3 || l->length != (n_frames + span - 1) / span) {
+      PRINT_MSG ("level %d holds %d blocks\n", k, l->length);
+      return 1;
+    }
+    for (i = 0; i < l->length; i++) {
+      double min = 1.e9, max = -1.e9, sum = 0.;
+      uint_t end = (i + 1) * span < n_frames ? (i + 1) * span : n_frames;
+      for (c = 0; c < signal->height; c++) {
+        for (j = i * span; j < end; j++) {
+          smpl_t x = signal->data[c][j];
+          if (x < min) min = x;
+          if (x > max) max = x;
+          sum += x * x;
+        }
+      }
+      sum = sqrt (sum / (signal->height * (end - i * span)));
+      if (l->data[0][i] != min || l->data[1][i] != max
+          || fabs (l->data[2][i] - sum) > tolerance * sum) {
+        PRINT_MSG ("level %d block %d: %f %f %f, expected %f %f %f\n", k, i,
+            l->data[0][i], l->data[1][i], l->data[2][i], min, max, sum);
+        err = 1;
+      }
+    }
+  }
+  if (aubio_waveform_get_level (o, n_levels) != NULL) err = 1;
+  if (n_levels && aubio_waveform_get_level (o, n_levels - 1)->length != 1)
+    err = 1;
+  return err;
+}
+
+static uint_t check_channels (uint_t channels, uint_t hop_size)
+{
+  aubio_waveform_t *o = new_aubio_waveform (BLOCK, 44100), *r;
+  fmat_t *signal = new_fmat (channels, N_FRAMES), hop;
+  smpl_t *rows[4];
+  uint_t i, c, n, err = 0;
+  if (!o || !signal) return 1;
+  for (c = 0; c < channels; c++) {
+    for (i = 0; i < N_FRAMES; i++) {
+      signal->data[c][i] = (1. + c) / channels * sin (i / (3. + c))
+        * (i % 10000) / 10000. + (random () % 100) / 1000.;
+    }
+  }
+  for (n = 0; n < N_FRAMES; n += hop_size) {
+    hop.height = channels;
+    hop.length = n + hop_size < N_FRAMES ? hop_size : N_FRAMES - n;
+    for (c = 0; c < channels; c++) rows[c] = signal->data[c] + n;
+    hop.data = rows;
+    if (channels == 1) {
+      fvec_t mono = { hop.length, rows[0] };
+      if (aubio_waveform_do (o, &mono)) err = 1;
+    } else {
+      if (aubio_waveform_do_multi (o, &hop)) err = 1;
+    }
+    // the levels of the complete blocks are available at any time
+    if (n == 50 * hop_size) {
+      err |= check_levels (o, signal, (n + hop.length) / BLOCK * BLOCK, 1.e-5);
+    }
+  }
+  // the last frames are only counted once flushed
+  err |= check_levels (o, signal, N_FRAMES / BLOCK * BLOCK, 1.e-5);
+  aubio_waveform_flush (o);
+  err |= check_levels (o, signal, N_FRAMES, 1.e-5);
+  PRINT_MSG ("%d channels, hop %d: %d levels\n", channels, hop_size,
+      aubio_waveform_get_n_levels (o));
+
+  // the file stores floats
+  if (aubio_waveform_save (o, PATH)) err = 1;
+  r = new_aubio_waveform_from_file (PATH);
+  if (!r) return 1;
+  if (aubio_waveform_get_block_size (r) != BLOCK
+      || aubio_waveform_get_samplerate (r) != 44100
+      || aubio_waveform_get_n_levels (r) != aubio_waveform_get_n_levels (o))
+    err = 1;
+  for (i = 0; i < aubio_waveform_get_n_levels (r); i++) {
+    const fmat_t *a = aubio_waveform_get_level (o, i);
+    const fmat_t *b = aubio_waveform_get_level (r, i);
+    if (a->length != b->length) err = 1;
+    for (c = 0; c < 3 && !err; c++) {
+      for (n = 0; n < a->length; n++) {
+        if (fabs (a->data[c][n] - b->data[c][n]) > 1.e-6) err = 1;
+      }
+    }
+  }
+  del_aubio_waveform (r);
+  remove (PATH);
+  del_aubio_waveform (o);
+  del_fmat (signal);
+  return err;
+}
+
+// a file read in a single pass matches the same frames added by hops
+static uint_t check_file (const char_t *uri)
+{
+  aubio_waveform_t *o = new_aubio_waveform (256, 0);
+  aubio_waveform_t *ref = new_aubio_waveform (256, 0);
+  aubio_source_t *s = new_aubio_source (uri, 0, 1000);
+  fmat_t *frames;
+  uint_t read, k, i, err = 0;
+  if (!o || !ref || !s) return 1;
+  frames = new_fmat (aubio_source_get_channels (s), 1000);
+  do {
+    aubio_source_do_multi (s, frames, &read);
+    frames->length = read;
+    aubio_waveform_do_multi (ref, frames);
+    frames->length = 1000;
+  } while (read == 1000);
+  aubio_waveform_flush (ref);
+  if (aubio_waveform_do_source (o, uri)) err = 1;
+  if (aubio_waveform_get_samplerate (o) != aubio_source_get_samplerate (s))
+    err = 1;
+  if (aubio_waveform_get_n_levels (o) != aubio_waveform_get_n_levels (ref))
+    err = 1;
+  for (k = 0; k < aubio_waveform_get_n_levels (o) && !err; k++) {
+    const fmat_t *a = aubio_waveform_get_level (o, k);
+    const fmat_t *b = aubio_waveform_get_level (ref, k);
+    if (a->length != b->length) err = 1;
+    for (i = 0; i < a->length && !err; i++) {
+      if (a->data[0][i] != b->data[0][i] || a->data[1][i] != b->data[1][i]
+          || fabs (a->data[2][i] - b->data[2][i]) > 1.e-5) err = 1;
+    }
+  }
+  PRINT_MSG ("%s: %d levels\n", uri, aubio_waveform_get_n_levels (o));
+  if (!aubio_waveform_do_source (o, "/this/file/does/not/exist")) err = 1;
+  del_aubio_waveform (o);
+  del_aubio_waveform (ref);
+  del_aubio_source (s);
+  del_fmat (frames);
+  return err;
+}
+
+int main (int argc, char **argv)
+{
+  uint_t err = 0;
+  aubio_waveform_t *o;
+  err |= check_channels (1, 512);
+  err |= check_channels (1, 50);
+  err |= check_channels (2, 1000);
+  err |= check_channels (3, BLOCK);
+  if (argc > 1) err |= check_file (argv[1]);
+
+  // wrong parameters, missing and broken files
+  if (new_aubio_waveform (0, 44100) != NULL) err = 1;
+  if (new_aubio_waveform_from_file ("/this/file/does/not/exist")) err = 1;
+  o = new_aubio_waveform (BLOCK, 0);
+  if (!o) return 1;
+  if (aubio_waveform_get_n_levels (o) != 0) err = 1;
+  if (aubio_waveform_get_level (o, 0) != NULL) err = 1;
+  del_aubio_waveform (o);
+
+  if (err) PRINT_ERR ("waveform overview differs from the signal\n");
+  aubio_cleanup ();
+  return err;
+}
@@ -0,0 +1,138 @@
+#include <aubio.h>
+#include "utils_tests.h"
+
+// objects sharing the scratch buffers of a workspace, run one after the
+// other, compute the same values as objects with buffers of their own
+
+#define WIN 1024
+#define HOP 256
+#define SR 44100
+#define N_HOPS 600
+
+typedef struct {
+  aubio_tempo_t *tempo;
+  aubio_pitch_t *pitch;
+  aubio_pvoc_t *pv;
+  aubio_mfcc_t *mfcc;
+  uint_t memory;
+} analyses_t;
+
+static uint_t new_analyses (analyses_t *a)
+{
+  a->tempo = new_aubio_tempo ("default", WIN, HOP, SR);
+  a->pitch = new_aubio_pitch ("yinfast", 2 * WIN, HOP, SR);
+  a->pv = new_aubio_pvoc (WIN, HOP);
+  a->mfcc = new_aubio_mfcc (WIN, 40, 13, SR);
+  if (!a->tempo || !a->pitch || !a->pv || !a->mfcc) return 1;
+  a->memory = aubio_tempo_get_memory_usage (a->tempo)
+    + aubio_pitch_get_memory_usage (a->pitch)
+    + aubio_mfcc_get_memory_usage (a->mfcc);
+  return 0;
+}
+
+static void del_analyses (analyses_t *a)
+{
+  del_aubio_tempo (a->tempo);
+  del_aubio_pitch (a->pitch);
+  del_aubio_pvoc (a->pv);
+  del_aubio_mfcc (a->mfcc);
+}
+
+// a sine, with clicks every 24 hops
+static void fill_hop (fvec_t *in, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < HOP; i++) {
+    in->data[i] = .3 * sin (2. * M_PI * 220. * (n * HOP + i) / SR);
+  }
+  if (n % 24 == 0) in->data[0] += .9;
+}
+
+// run the analyses of each set in turn, on the same hops
+static uint_t run (analyses_t *sets, uint_t n_sets)
+{
+  fvec_t *in = new_fvec (HOP), *beat = new_fvec (2), *pitch = new_fvec (1);
+  fvec_t *coefs = new_fvec (13);
+  cvec_t *grain = new_cvec (WIN);
+  smpl_t ref_beat = 0., ref_pitch = 0., ref_coefs[13];
+  uint_t n, s, i, beats = 0, err = 0;
+  if (!in || !beat || !pitch || !coefs || !grain) return 1;
+  for (n = 0; n < N_HOPS; n++) {
+    fill_hop (in, n);
+    for (s = 0; s < n_sets; s++) {
+      aubio_tempo_do (sets[s].tempo, in, beat);
+      aubio_pitch_do (sets[s].pitch, in, pitch);
+      aubio_pvoc_do (sets[s].pv, in, grain);
+      aubio_mfcc_do (sets[s].mfcc, grain, coefs);
+      if (s == 0) {
+        ref_beat = beat->data[0];
+        ref_pitch = pitch->data[0];
+        for (i = 0; i < 13; i++) ref_coefs[i] = coefs->data[i];
+        if (beat->data[0] != 0.) beats++;
+        continue;
+      }
+      if (beat->data[0] != ref_beat || pitch->data[0] != ref_pitch) err = 1;
+      for (i = 0; i < 13; i++) {
+        if (coefs->data[i] != ref_coefs[i]) err = 1;
+      }
+    }
+  }
+  PRINT_MSG ("%d beats, at %.2f bpm, pitch %.2f Hz\n", beats,
+      aubio_tempo_get_bpm (sets[0].tempo), ref_pitch);
+  if (beats == 0) err = 1;
+  del_fvec (in);
+  del_fvec (beat);
+  del_fvec (pitch);
+  del_fvec (coefs);
+  del_cvec (grain);
+  return err;
+}
+
+int main (void)
+{
+  uint_t err = 0;
+  analyses_t sets[4];
+  aubio_workspace_t *shared = new_aubio_workspace (1 << 18);
+  // too small for any object, each one gets a block of its own
+  aubio_workspace_t *small = new_aubio_workspace (64);
+  if (new_aubio_workspace (0)) err = 1;
+  if (!shared || !small) return 1;
+
+  // the reference, with buffers of its own
+  if (new_analyses (&sets[0])) return 1;
+  // two sets in the same workspace
+  if (aubio_set_workspace (shared) != NULL) err = 1;
+  if (new_analyses (&sets[1]) || new_analyses (&sets[2])) return 1;
+  aubio_set_workspace (small);
+  if (new_analyses (&sets[3])) return 1;
+  if (aubio_set_workspace (NULL) != small) err = 1;
+
+  PRINT_MSG ("own buffers: %d bytes, in a workspace: %d bytes\n",
+      sets[0].memory, sets[1].memory);
+  PRINT_MSG ("workspace: %d bytes in %d block(s), small one: %d blocks\n",
+      aubio_workspace_get_used (shared), aubio_workspace_get_blocks (shared),
+      aubio_workspace_get_blocks (small));
+  if (sets[1].memory >= sets[0].memory
+      || sets[2].memory != sets[1].memory) err = 1;
+  if (aubio_workspace_get_blocks (shared) != 1
+      || aubio_workspace_get_used (shared) == 0
+      || aubio_workspace_get_blocks (small) < 2) err = 1;
+
+  // beat tracking also borrows its buffers from the pool in compact mode
+  aubio_tempo_set_compact (sets[2].tempo, 1);
+
+  if (run (sets, 4)) {
+    PRINT_ERR ("the analyses in a workspace differ from the reference\n");
+    err = 1;
+  }
+
+  del_analyses (&sets[0]);
+  del_analyses (&sets[1]);
+  del_analyses (&sets[2]);
+  del_aubio_workspace (shared);
+  // objects may still be deleted after their workspace
+  del_aubio_workspace (small);
+  del_analyses (&sets[3]);
+  aubio_cleanup ();
+  return err;
+}
@@ -61,10 +61,12 @@
 #define srandom srand
 #define random rand
 
-#elif defined(__STRICT_ANSI__)
+#elif defined(__STRICT_ANSI__) && !defined(_XOPEN_SOURCE) \
+  && !defined(_GNU_SOURCE) && !defined(_DEFAULT_SOURCE)
 
 // workaround to build with -std=c99 (for instance with older cygwin),
-// assuming libbc is recent enough to supports these functions.
+// assuming libbc is recent enough to supports these functions. Tests asking
+// for more than POSIX with a feature macro get them from the C library.
 extern void srandom(unsigned);
 extern int random(void);
 extern char mkstemp(const char *pat);
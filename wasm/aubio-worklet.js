@@ -0,0 +1,160 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+// AudioWorklet processor running aubio.wasm on the first channel of its
+// input, and posting a message on each onset and beat.
+//
+// The worklet scope can not fetch, so the module is compiled on the main
+// thread and passed with the processor options:
+//
+//   await context.audioWorklet.addModule('aubio-worklet.js');
+//   const module = await WebAssembly.compileStreaming(fetch('aubio.wasm'));
+//   const node = new AudioWorkletNode(context, 'aubio-processor', {
+//     numberOfOutputs: 0,
+//     processorOptions: { module, onset: 'hfc', tempo: 'default' },
+//   });
+//   node.port.onmessage = (e) => {
+//     if (e.data.type === 'beat') console.log(e.data.time, e.data.bpm);
+//   };
+//   source.connect(node);
+//
+// Options: `onset` and `tempo`, onset detection functions, or '' to disable
+// the onset or beat detection; `bufSize` and `hopSize`, 1024 and 256 by
+// default. Messages `{ threshold }` and `{ silence }` sent to the port change
+// the parameters of both detectors.
+
+const AUBIO_WASM_ONSET = 1;
+const AUBIO_WASM_BEAT = 2;
+const AUBIO_WASM_BLOCK = 128;
+
+// the module only needs a few system calls, for the messages printed by
+// AUBIO_ERR and for getenv; the others fail with ENOSYS
+function aubioImports(getMemory) {
+  const decoder = new TextDecoder();
+  let line = '';
+  const wasi = {
+    fd_write(fd, iovs, iovsLen, nwritten) {
+      const view = new DataView(getMemory().buffer);
+      let written = 0;
+      for (let i = 0; i < iovsLen; i++) {
+        const ptr = view.getUint32(iovs + 8 * i, true);
+        const len = view.getUint32(iovs + 8 * i + 4, true);
+        line += decoder.decode(new Uint8Array(getMemory().buffer, ptr, len));
+        written += len;
+      }
+      const end = line.lastIndexOf('\n');
+      if (end >= 0) {
+        (fd === 2 ? console.warn : console.log)(line.slice(0, end));
+        line = line.slice(end + 1);
+      }
+      view.setUint32(nwritten, written, true);
+      return 0;
+    },
+    environ_sizes_get(count, size) {
+      const view = new DataView(getMemory().buffer);
+      view.setUint32(count, 0, true);
+      view.setUint32(size, 0, true);
+      return 0;
+    },
+    environ_get() {
+      return 0;
+    },
+    proc_exit(code) {
+      throw new Error(`aubio: exit(${code})`);
+    },
+  };
+  const enosys = () => 52;
+  const stubs = (table) => new Proxy(table, {
+    get: (target, name) => (name in target ? target[name] : enosys),
+  });
+  return { wasi_snapshot_preview1: stubs(wasi), env: stubs({}) };
+}
+
+class AubioProcessor extends AudioWorkletProcessor {
+  constructor(options) {
+    super();
+    const opts = options.processorOptions || {};
+    const instance = new WebAssembly.Instance(opts.module,
+      aubioImports(() => this.exports.memory));
+    this.exports = instance.exports;
+    if (this.exports._initialize) this.exports._initialize();
+    const onset = this.newString(opts.onset ?? 'default');
+    const tempo = this.newString(opts.tempo ?? 'default');
+    this.o = this.exports.aubio_wasm_new(onset, tempo, opts.bufSize || 1024,
+      opts.hopSize || 256, sampleRate, AUBIO_WASM_BLOCK);
+    this.exports.free(onset);
+    this.exports.free(tempo);
+    if (!this.o) throw new Error('aubio: could not create detector');
+    // the memory never grows, this view stays valid
+    this.input = new Float32Array(this.exports.memory.buffer,
+      this.exports.aubio_wasm_get_input(this.o), AUBIO_WASM_BLOCK);
+    this.port.onmessage = (e) => this.onMessage(e.data);
+  }
+
+  newString(str) {
+    const bytes = new TextEncoder().encode(str);
+    const ptr = this.exports.malloc(bytes.length + 1);
+    const heap = new Uint8Array(this.exports.memory.buffer, ptr,
+      bytes.length + 1);
+    heap.set(bytes);
+    heap[bytes.length] = 0;
+    return ptr;
+  }
+
+  onMessage(data) {
+    if (!this.o) return;
+    if (data.threshold !== undefined) {
+      this.exports.aubio_wasm_set_threshold(this.o, data.threshold);
+    }
+    if (data.silence !== undefined) {
+      this.exports.aubio_wasm_set_silence(this.o, data.silence);
+    }
+    if (data.close) {
+      this.exports.del_aubio_wasm(this.o);
+      this.o = 0;
+    }
+  }
+
+  process(inputs) {
+    const channel = inputs[0] && inputs[0][0];
+    if (!this.o) return false;
+    // no source connected yet
+    if (!channel) return true;
+    this.input.set(channel);
+    const flags = this.exports.aubio_wasm_do(this.o, channel.length);
+    if (flags & AUBIO_WASM_ONSET) {
+      this.port.postMessage({
+        type: 'onset',
+        time: this.exports.aubio_wasm_get_last_onset(this.o),
+      });
+    }
+    if (flags & AUBIO_WASM_BEAT) {
+      this.port.postMessage({
+        type: 'beat',
+        time: this.exports.aubio_wasm_get_last_beat(this.o),
+        bpm: this.exports.aubio_wasm_get_bpm(this.o),
+        confidence: this.exports.aubio_wasm_get_confidence(this.o),
+      });
+    }
+    return true;
+  }
+}
+
+registerProcessor('aubio-processor', AubioProcessor);
@@ -0,0 +1,209 @@
+/*
+  Copyright (C) 2026 aubio-ledfx contributors
+
+  This file is part of aubio.
+
+  aubio is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  aubio is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with aubio.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+/* Streaming onset and beat detection for the browser.
+
+   An AudioWorklet receives blocks of 128 samples, while ::aubio_onset_t and
+   ::aubio_tempo_t read `hop_size` samples at a time. This object owns an
+   input buffer of `block_size` samples, into which the worklet copies each
+   block through a view of the module memory, and an ::aubio_hopper_t cutting
+   the blocks into hops. Everything is allocated by ::aubio_wasm_new, so that
+   ::aubio_wasm_do never allocates, nor calls back into JavaScript.
+
+   From JavaScript, see aubio-worklet.js:
+
+     const o = exports.aubio_wasm_new(method, method, 1024, 256, sampleRate,
+         128);
+     const input = new Float32Array(exports.memory.buffer,
+         exports.aubio_wasm_get_input(o), 128);
+     // in process()
+     input.set(inputs[0][0]);
+     if (exports.aubio_wasm_do(o, 128) & AUBIO_WASM_BEAT) {
+       port.postMessage({ bpm: exports.aubio_wasm_get_bpm(o) });
+     }
+*/
+
+#include <aubio.h>
+#include "config.h"
+#include "aubio_priv.h"
+
+#if defined(__EMSCRIPTEN__)
+#include <emscripten.h>
+#define AUBIO_WASM_EXPORT EMSCRIPTEN_KEEPALIVE
+#else
+#define AUBIO_WASM_EXPORT
+#endif
+
+/* flags returned by aubio_wasm_do */
+#define AUBIO_WASM_ONSET 1
+#define AUBIO_WASM_BEAT  2
+
+typedef struct {
+  aubio_hopper_t *hopper;  /**< cuts the blocks into hops */
+  aubio_onset_t *onset;    /**< onset detection, or NULL */
+  aubio_tempo_t *tempo;    /**< beat tracking, or NULL */
+  fvec_t *input;           /**< block written by JavaScript [block_size] */
+  fvec_t *out;             /**< output of the onset and tempo objects [1] */
+  fvec_t block;            /**< view of the first samples of input */
+  uint_t flags;            /**< events found in the current block */
+} aubio_wasm_t;
+
+static void aubio_wasm_do_hop (void *data, const fvec_t *hop)
+{
+  aubio_wasm_t *o = (aubio_wasm_t *)data;
+  if (o->onset) {
+    aubio_onset_do (o->onset, hop, o->out);
+    if (o->out->data[0] != 0.) o->flags |= AUBIO_WASM_ONSET;
+  }
+  if (o->tempo) {
+    aubio_tempo_do (o->tempo, hop, o->out);
+    if (o->out->data[0] != 0.) o->flags |= AUBIO_WASM_BEAT;
+  }
+}
+
+void del_aubio_wasm (aubio_wasm_t *o);
+
+/** create the streaming object
+
+  \param onset_method onset detection function, or NULL or "" for none
+  \param tempo_method onset detection function of the beat tracker, or NULL or
+  "" for none
+  \param buf_size, hop_size, samplerate as for ::new_aubio_onset
+  \param block_size largest number of samples passed to ::aubio_wasm_do,
+  128 for an AudioWorklet
+
+*/
+AUBIO_WASM_EXPORT
+aubio_wasm_t *aubio_wasm_new (const char_t *onset_method,
+    const char_t *tempo_method, uint_t buf_size, uint_t hop_size,
+    uint_t samplerate, uint_t block_size)
+{
+  aubio_wasm_t *o = AUBIO_NEW (aubio_wasm_t);
+  if (!o) return NULL;
+  if (block_size < 1) goto beach;
+  o->hopper = new_aubio_hopper (hop_size);
+  o->input = new_fvec (block_size);
+  o->out = new_fvec (1);
+  if (!o->hopper || !o->input || !o->out) goto beach;
+  if (onset_method && onset_method[0] != '\0') {
+    o->onset = new_aubio_onset (onset_method, buf_size, hop_size, samplerate);
+    if (!o->onset) goto beach;
+  }
+  if (tempo_method && tempo_method[0] != '\0') {
+    o->tempo = new_aubio_tempo (tempo_method, buf_size, hop_size, samplerate);
+    if (!o->tempo) goto beach;
+  }
+  o->block.data = o->input->data;
+  return o;
+
+beach:
+  del_aubio_wasm (o);
+  return NULL;
+}
+
+/** get the input buffer, to be filled before each call to ::aubio_wasm_do */
+AUBIO_WASM_EXPORT
+smpl_t *aubio_wasm_get_input (aubio_wasm_t *o)
+{
+  return o->input->data;
+}
+
+/** process the first `length` samples of the input buffer
+
+  \return AUBIO_WASM_ONSET and AUBIO_WASM_BEAT flags, set when an onset or a
+  beat was found in one of the hops completed by this block
+
+*/
+AUBIO_WASM_EXPORT
+uint_t aubio_wasm_do (aubio_wasm_t *o, uint_t length)
+{
+  o->flags = 0;
+  if (length > o->input->length) return 0;
+  o->block.length = length;
+  aubio_hopper_do (o->hopper, &o->block, aubio_wasm_do_hop, o);
+  return o->flags;
+}
+
+/** get the time of the last onset, in seconds, or 0 without onset object */
+AUBIO_WASM_EXPORT
+smpl_t aubio_wasm_get_last_onset (aubio_wasm_t *o)
+{
+  return o->onset ? aubio_onset_get_last_s (o->onset) : 0.;
+}
+
+/** get the value of the onset detection function for the last hop */
+AUBIO_WASM_EXPORT
+smpl_t aubio_wasm_get_descriptor (aubio_wasm_t *o)
+{
+  return o->onset ? aubio_onset_get_descriptor (o->onset) : 0.;
+}
+
+/** get the time of the last beat, in seconds, or 0 without tempo object */
+AUBIO_WASM_EXPORT
+smpl_t aubio_wasm_get_last_beat (aubio_wasm_t *o)
+{
+  return o->tempo ? aubio_tempo_get_last_s (o->tempo) : 0.;
+}
+
+/** get the current tempo, in beats per minute */
+AUBIO_WASM_EXPORT
+smpl_t aubio_wasm_get_bpm (aubio_wasm_t *o)
+{
+  return o->tempo ? aubio_tempo_get_bpm (o->tempo) : 0.;
+}
+
+/** get the confidence of the beat tracker, from 0 to 1 */
+AUBIO_WASM_EXPORT
+smpl_t aubio_wasm_get_confidence (aubio_wasm_t *o)
+{
+  return o->tempo ? aubio_tempo_get_confidence (o->tempo) : 0.;
+}
+
+/** set the peak picking threshold of both objects */
+AUBIO_WASM_EXPORT
+uint_t aubio_wasm_set_threshold (aubio_wasm_t *o, smpl_t threshold)
+{
+  uint_t err = 0;
+  if (o->onset) err |= aubio_onset_set_threshold (o->onset, threshold);
+  if (o->tempo) err |= aubio_tempo_set_threshold (o->tempo, threshold);
+  return err;
+}
+
+/** set the silence threshold of both objects, in dB */
+AUBIO_WASM_EXPORT
+uint_t aubio_wasm_set_silence (aubio_wasm_t *o, smpl_t silence)
+{
+  uint_t err = 0;
+  if (o->onset) err |= aubio_onset_set_silence (o->onset, silence);
+  if (o->tempo) err |= aubio_tempo_set_silence (o->tempo, silence);
+  return err;
+}
+
+/** delete the streaming object */
+AUBIO_WASM_EXPORT
+void del_aubio_wasm (aubio_wasm_t *o)
+{
+  if (o->tempo) del_aubio_tempo (o->tempo);
+  if (o->onset) del_aubio_onset (o->onset);
+  if (o->out) del_fvec (o->out);
+  if (o->input) del_fvec (o->input);
+  if (o->hopper) del_aubio_hopper (o->hopper);
+  AUBIO_FREE (o);
+}